@@ -6,6 +6,9 @@
 #  POSTGRESQL_LIBRARIES, the libraries needed to use POSTGRESQL.
 #  POSTGRESQL_FOUND, If false, do not try to use PostgreSQL.
 #  POSTGRESQL_VERSION_STRING
+#  POSTGRESQL_WITH_LLVM, whether the server was built with JIT support
+#  POSTGRESQL_CLANG, POSTGRESQL_LLVM_BINPATH, POSTGRESQL_BITCODE_CFLAGS, the
+#    tools and flags used by PGXS to emit the bitcode inlined by the JIT
 #
 # Copyright (c) 2021, Vicky Vergara <vicky@georepublic.org>
 # Copyright (c) 2006, Jaroslaw Staniek, <js@iidea.pl>
@@ -106,6 +109,33 @@ execute_process(
   OUTPUT_STRIP_TRAILING_WHITESPACE
   OUTPUT_VARIABLE POSTGRESQL_DYNLIB_DIR)
 
+# Read the LLVM settings of the server from the Makefile.global of PGXS
+set(POSTGRESQL_WITH_LLVM OFF)
+execute_process(
+  COMMAND ${POSTGRESQL_PG_CONFIG} --pgxs
+  OUTPUT_STRIP_TRAILING_WHITESPACE
+  OUTPUT_VARIABLE POSTGRESQL_PGXS)
+get_filename_component(POSTGRESQL_PGXS_DIR "${POSTGRESQL_PGXS}" DIRECTORY)
+set(POSTGRESQL_MAKEFILE_GLOBAL "${POSTGRESQL_PGXS_DIR}/../Makefile.global")
+if(EXISTS "${POSTGRESQL_MAKEFILE_GLOBAL}")
+  file(STRINGS "${POSTGRESQL_MAKEFILE_GLOBAL}" POSTGRESQL_MAKEFILE_LINES
+    REGEX "^(with_llvm|CLANG|LLVM_BINPATH|BITCODE_CFLAGS)[ \t]*=")
+  foreach(line ${POSTGRESQL_MAKEFILE_LINES})
+    string(REGEX REPLACE "^([A-Za-z_]+)[ \t]*=[ \t]*(.*)$" "\\1" key "${line}")
+    string(REGEX REPLACE "^([A-Za-z_]+)[ \t]*=[ \t]*(.*)$" "\\2" value "${line}")
+    string(STRIP "${value}" value)
+    if(key STREQUAL "with_llvm" AND value STREQUAL "yes")
+      set(POSTGRESQL_WITH_LLVM ON)
+    elseif(key STREQUAL "CLANG")
+      set(POSTGRESQL_CLANG "${value}")
+    elseif(key STREQUAL "LLVM_BINPATH")
+      set(POSTGRESQL_LLVM_BINPATH "${value}")
+    elseif(key STREQUAL "BITCODE_CFLAGS")
+      separate_arguments(POSTGRESQL_BITCODE_CFLAGS UNIX_COMMAND "${value}")
+    endif()
+  endforeach()
+endif()
+
 message(STATUS "POSTGRESQL_BIN_DIR: ${POSTGRESQL_BIN_DIR}")
 message(STATUS "POSTGRESQL_INCLUDE_DIR: ${POSTGRESQL_INCLUDE_DIR}")
 message(STATUS "POSTGRESQL_LIBRARIES: ${POSTGRESQL_LIBRARIES}")
@@ -114,6 +144,7 @@ message(STATUS "POSTGRESQL_DYNLIB_DIR: ${POSTGRESQL_DYNLIB_DIR}")
 message(STATUS "POSTGRESQL_VERSION: ${POSTGRESQL_VERSION}")
 message(STATUS "POSTGRESQL_VERSION_NUMBER: ${POSTGRESQL_VERSION_NUMBER}")
 message(STATUS "POSTGRESQL_VERSION_STRING: ${POSTGRESQL_VERSION_STRING}")
+message(STATUS "POSTGRESQL_WITH_LLVM: ${POSTGRESQL_WITH_LLVM}")
 
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(POSTGRESQL
@@ -0,0 +1,597 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Micro-benchmarks of the MEOS library
+ *
+ * The program loads the AIS observations in `ais_instants.csv` and the
+ * BerlinMOD trips in `berlinmod_trips.csv` from the data directory of the
+ * examples, runs each benchmark several times, and writes to the standard
+ * output a JSON document with, for each benchmark, the number of operations
+ * of a run and the minimum, median, and mean time of the runs in seconds.
+ *
+ * Usage
+ * @code
+ * meos_bench [-d data_directory] [-r repetitions] [-n max_trips] [-b name]
+ *   [-s]
+ * @endcode
+ * where `-b` only runs the benchmarks whose name contains the given string
+ * and `-s` adds to the output the runtime statistics of MEOS as given by
+ * #meos_stats_as_json for the benchmarks run.
+ *
+ * The program is built by the `meos_bench` target when the CMake option
+ * `MEOS_BENCH` is set.
+ */
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <meos.h>
+
+/* Maximum length in characters of a line of the input CSV files */
+#define MAX_LENGTH_LINE 170101
+/* Maximum length in characters of a path */
+#define MAX_LENGTH_PATH 1024
+/* Default number of runs of each benchmark */
+#define DEFAULT_REPETITIONS 5
+/* Maximum number of runs of each benchmark */
+#define MAX_REPETITIONS 100
+/* Number of pairs of trips used by the quadratic similarity distances */
+#define SIMILARITY_PAIRS 8
+/* Sampling interval in microseconds of the interpolation benchmark */
+#define SAMPLING_USECS 1000000
+
+/*****************************************************************************
+ * Input data
+ *****************************************************************************/
+
+/* Instants of a ship in the AIS data */
+typedef struct
+{
+  long int mmsi;
+  int count;
+  int maxcount;
+  TInstant **instants;
+} ship_instants;
+
+/* Data shared by the benchmarks */
+typedef struct
+{
+  ship_instants *ships;  /* Instants of the AIS data grouped by ship */
+  int nships;
+  Temporal **ais;        /* Sequences of the AIS data, one per ship */
+  Temporal **trips;      /* BerlinMOD trips */
+  int ntrips;
+  char **trips_text;     /* Well-known text of the BerlinMOD trips */
+  STBox *extent;         /* Extent of the BerlinMOD trips */
+  STBox *box;            /* Box at the center of the extent */
+  GSERIALIZED *geom;     /* Geometry of the same box */
+  Span *period;          /* Time span of the first day of the extent */
+} bench_data;
+
+/**
+ * Read the AIS observations and group them by ship
+ */
+static bool
+read_ais(const char *dir, bench_data *data)
+{
+  char path[MAX_LENGTH_PATH];
+  snprintf(path, MAX_LENGTH_PATH, "%s/ais_instants.csv", dir);
+  FILE *file = fopen(path, "r");
+  if (! file)
+  {
+    fprintf(stderr, "Error opening input file %s\n", path);
+    return false;
+  }
+  char line[MAX_LENGTH_LINE], tbuf[32], pbuf[64];
+  /* Skip the header */
+  if (! fgets(line, MAX_LENGTH_LINE, file))
+  {
+    fclose(file);
+    return false;
+  }
+  int maxships = 64;
+  data->ships = calloc(maxships, sizeof(ship_instants));
+  data->nships = 0;
+  while (fgets(line, MAX_LENGTH_LINE, file))
+  {
+    long int mmsi;
+    double lat, lon, sog;
+    if (sscanf(line, "%31[^,],%ld,%lf,%lf,%lf", tbuf, &mmsi, &lat, &lon,
+        &sog) != 5)
+      continue;
+    /* Find the ship, the observations of a ship are mostly consecutive */
+    int i;
+    for (i = data->nships - 1; i >= 0; i--)
+      if (data->ships[i].mmsi == mmsi)
+        break;
+    if (i < 0)
+    {
+      if (data->nships == maxships)
+      {
+        maxships *= 2;
+        data->ships = realloc(data->ships, sizeof(ship_instants) * maxships);
+      }
+      i = data->nships++;
+      memset(&data->ships[i], 0, sizeof(ship_instants));
+      data->ships[i].mmsi = mmsi;
+    }
+    ship_instants *ship = &data->ships[i];
+    TimestampTz t = pg_timestamptz_in(tbuf, -1);
+    /* Skip observations that are not in increasing time order */
+    if (ship->count > 0 &&
+        t <= temporal_end_timestamptz((Temporal *) ship->instants[ship->count - 1]))
+      continue;
+    if (ship->count == ship->maxcount)
+    {
+      ship->maxcount = ship->maxcount ? ship->maxcount * 2 : 64;
+      ship->instants = realloc(ship->instants,
+        sizeof(TInstant *) * ship->maxcount);
+    }
+    snprintf(pbuf, sizeof(pbuf), "Point(%lf %lf)", lon, lat);
+    GSERIALIZED *gs = geometry_from_text(pbuf, 4326);
+    ship->instants[ship->count++] = tpointinst_make(gs, t);
+    free(gs);
+  }
+  fclose(file);
+  data->ais = malloc(sizeof(Temporal *) * data->nships);
+  for (int i = 0; i < data->nships; i++)
+    data->ais[i] = (Temporal *) tsequence_make(
+      (const TInstant **) data->ships[i].instants, data->ships[i].count,
+      true, true, LINEAR, true);
+  return true;
+}
+
+/**
+ * Read the BerlinMOD trips
+ */
+static bool
+read_trips(const char *dir, int maxtrips, bench_data *data)
+{
+  char path[MAX_LENGTH_PATH];
+  snprintf(path, MAX_LENGTH_PATH, "%s/berlinmod_trips.csv", dir);
+  FILE *file = fopen(path, "r");
+  if (! file)
+  {
+    fprintf(stderr, "Error opening input file %s\n", path);
+    return false;
+  }
+  char *line = malloc(MAX_LENGTH_LINE);
+  char *trip = malloc(MAX_LENGTH_LINE);
+  /* Skip the header */
+  if (! fgets(line, MAX_LENGTH_LINE, file))
+  {
+    free(line); free(trip); fclose(file);
+    return false;
+  }
+  int maxcount = 64;
+  data->trips = malloc(sizeof(Temporal *) * maxcount);
+  data->ntrips = 0;
+  while (data->ntrips < maxtrips && fgets(line, MAX_LENGTH_LINE, file))
+  {
+    int tripid, vehid, seq;
+    char day[12];
+    if (sscanf(line, "%d,%d,%11[^,],%d,%170000[^\n]", &tripid, &vehid, day,
+        &seq, trip) != 5)
+      continue;
+    if (data->ntrips == maxcount)
+    {
+      maxcount *= 2;
+      data->trips = realloc(data->trips, sizeof(Temporal *) * maxcount);
+    }
+    data->trips[data->ntrips++] = temporal_from_hexwkb(trip);
+  }
+  free(line); free(trip);
+  fclose(file);
+  if (data->ntrips < 2)
+  {
+    fprintf(stderr, "The benchmarks need at least two trips\n");
+    return false;
+  }
+
+  /* Well-known text of the trips for the parsing benchmark */
+  data->trips_text = malloc(sizeof(char *) * data->ntrips);
+  for (int i = 0; i < data->ntrips; i++)
+    data->trips_text[i] = tpoint_as_ewkt(data->trips[i], 15);
+
+  /* Extent of the trips and box covering the central quarter of it */
+  data->extent = NULL;
+  for (int i = 0; i < data->ntrips; i++)
+    data->extent = tpoint_extent_transfn(data->extent, data->trips[i]);
+  STBox *e = data->extent;
+  double dx = (e->xmax - e->xmin) / 4, dy = (e->ymax - e->ymin) / 4;
+  TimestampTz tmin;
+  stbox_tmin(e, &tmin);
+  data->period = tstzspan_make(tmin, tmin + USECS_PER_DAY, true, false);
+  data->box = stbox_make(true, false, false, e->srid, e->xmin + dx,
+    e->xmax - dx, e->ymin + dy, e->ymax - dy, 0, 0, NULL);
+  data->geom = stbox_to_geo(data->box);
+  return true;
+}
+
+/*****************************************************************************
+ * Benchmarks
+ *****************************************************************************/
+
+/* A benchmark runs on the shared data and returns the number of operations */
+typedef int (*bench_fn)(const bench_data *data);
+
+static int
+bench_tsequence_make(const bench_data *data)
+{
+  int n = 0;
+  for (int i = 0; i < data->nships; i++)
+  {
+    TSequence *seq = tsequence_make(
+      (const TInstant **) data->ships[i].instants, data->ships[i].count,
+      true, true, LINEAR, true);
+    free(seq);
+    n += data->ships[i].count;
+  }
+  return n;
+}
+
+static int
+bench_temporal_in(const bench_data *data)
+{
+  for (int i = 0; i < data->ntrips; i++)
+    free(tgeompoint_in(data->trips_text[i]));
+  return data->ntrips;
+}
+
+static int
+bench_temporal_out(const bench_data *data)
+{
+  for (int i = 0; i < data->ntrips; i++)
+    free(tpoint_as_ewkt(data->trips[i], 15));
+  return data->ntrips;
+}
+
+static int
+bench_temporal_as_wkb(const bench_data *data)
+{
+  for (int i = 0; i < data->ntrips; i++)
+  {
+    size_t size;
+    free(temporal_as_wkb(data->trips[i], 0, &size));
+  }
+  return data->ntrips;
+}
+
+static int
+bench_temporal_as_mfjson(const bench_data *data)
+{
+  for (int i = 0; i < data->ntrips; i++)
+    free(temporal_as_mfjson(data->trips[i], true, 0, 6, NULL));
+  return data->ntrips;
+}
+
+static int
+bench_tpoint_speed(const bench_data *data)
+{
+  for (int i = 0; i < data->ntrips; i++)
+    free(tpoint_speed(data->trips[i]));
+  return data->ntrips;
+}
+
+static int
+bench_distance_tpoint_tpoint(const bench_data *data)
+{
+  for (int i = 0; i < data->ntrips - 1; i++)
+    free(distance_tpoint_tpoint(data->trips[i], data->trips[i + 1]));
+  return data->ntrips - 1;
+}
+
+static int
+bench_tpoint_length(const bench_data *data)
+{
+  double length = 0;
+  for (int i = 0; i < data->nships; i++)
+    length += tpoint_length(data->ais[i]);
+  return (length >= 0) ? data->nships : 0;
+}
+
+static int
+bench_tpoint_coords_at_timestamps(const bench_data *data)
+{
+  /* Sample each trip every second */
+  int n = 0;
+  for (int i = 0; i < data->ntrips; i++)
+  {
+    const Temporal *trip = data->trips[i];
+    TimestampTz start = temporal_start_timestamptz(trip);
+    int count = (int) ((temporal_end_timestamptz(trip) - start) /
+      SAMPLING_USECS) + 1;
+    TimestampTz *times = malloc(sizeof(TimestampTz) * count);
+    double *coords = malloc(sizeof(double) * 3 * count);
+    bool *found = malloc(sizeof(bool) * count);
+    for (int j = 0; j < count; j++)
+      times[j] = start + j * SAMPLING_USECS;
+    int nslopes;
+    double *slopes = temporal_segment_slopes(trip, &nslopes);
+    tpoint_coords_at_timestamps(trip, times, count, false, slopes, coords,
+      found);
+    free(times); free(coords); free(found); free(slopes);
+    n += count;
+  }
+  return n;
+}
+
+static int
+bench_tpoint_at_stbox(const bench_data *data)
+{
+  for (int i = 0; i < data->ntrips; i++)
+    free(tpoint_at_stbox(data->trips[i], data->box, true));
+  return data->ntrips;
+}
+
+static int
+bench_tpoint_at_geom_time(const bench_data *data)
+{
+  for (int i = 0; i < data->ntrips; i++)
+    free(tpoint_at_geom_time(data->trips[i], data->geom, NULL, data->period));
+  return data->ntrips;
+}
+
+static int
+bench_tpoint_space_time_split(const bench_data *data)
+{
+  Interval *duration = pg_interval_in("1 hour", -1);
+  GSERIALIZED *sorigin = geometry_from_text("Point(0 0)", data->extent->srid);
+  TimestampTz torigin = pg_timestamptz_in("2020-06-01", -1);
+  for (int i = 0; i < data->ntrips; i++)
+  {
+    GSERIALIZED **space_buckets;
+    TimestampTz *time_buckets;
+    int count;
+    Temporal **tiles = tpoint_space_time_split(data->trips[i], 1000.0, 1000.0,
+      1000.0, duration, sorigin, torigin, true, true, &space_buckets,
+      &time_buckets, &count);
+    for (int j = 0; j < count; j++)
+    {
+      free(tiles[j]);
+      free(space_buckets[j]);
+    }
+    free(tiles); free(space_buckets); free(time_buckets);
+  }
+  free(duration); free(sorigin);
+  return data->ntrips;
+}
+
+static int
+bench_temporal_tcount(const bench_data *data)
+{
+  SkipList *state = NULL;
+  for (int i = 0; i < data->ntrips; i++)
+    state = temporal_tcount_transfn(state, data->trips[i]);
+  free(temporal_tagg_finalfn(state));
+  return data->ntrips;
+}
+
+static int
+bench_tpoint_extent(const bench_data *data)
+{
+  STBox *box = NULL;
+  for (int i = 0; i < data->ntrips; i++)
+    box = tpoint_extent_transfn(box, data->trips[i]);
+  free(box);
+  return data->ntrips;
+}
+
+static int
+bench_temporal_frechet_distance(const bench_data *data)
+{
+  int n = 0;
+  for (int i = 0; i < data->ntrips - 1 && n < SIMILARITY_PAIRS; i++, n++)
+    temporal_frechet_distance(data->trips[i], data->trips[i + 1], -1);
+  return n;
+}
+
+static int
+bench_temporal_dyntimewarp_distance(const bench_data *data)
+{
+  int n = 0;
+  for (int i = 0; i < data->ntrips - 1 && n < SIMILARITY_PAIRS; i++, n++)
+    temporal_dyntimewarp_distance(data->trips[i], data->trips[i + 1], -1);
+  return n;
+}
+
+static int
+bench_temporal_hausdorff_distance(const bench_data *data)
+{
+  int n = 0;
+  for (int i = 0; i < data->ntrips - 1 && n < SIMILARITY_PAIRS; i++, n++)
+    temporal_hausdorff_distance(data->trips[i], data->trips[i + 1]);
+  return n;
+}
+
+typedef struct
+{
+  const char *name;
+  bench_fn fn;
+} bench_def;
+
+static const bench_def BENCHMARKS[] =
+{
+  {"construction/tsequence_make", &bench_tsequence_make},
+  {"inout/tgeompoint_in", &bench_temporal_in},
+  {"inout/tpoint_as_ewkt", &bench_temporal_out},
+  {"inout/temporal_as_wkb", &bench_temporal_as_wkb},
+  {"inout/temporal_as_mfjson", &bench_temporal_as_mfjson},
+  {"lifting/tpoint_speed", &bench_tpoint_speed},
+  {"lifting/distance_tpoint_tpoint", &bench_distance_tpoint_tpoint},
+  {"accessor/tpoint_length", &bench_tpoint_length},
+  {"accessor/tpoint_coords_at_timestamps", &bench_tpoint_coords_at_timestamps},
+  {"restriction/tpoint_at_stbox", &bench_tpoint_at_stbox},
+  {"restriction/tpoint_at_geom_time", &bench_tpoint_at_geom_time},
+  {"tiling/tpoint_space_time_split", &bench_tpoint_space_time_split},
+  {"aggregation/temporal_tcount", &bench_temporal_tcount},
+  {"aggregation/tpoint_extent", &bench_tpoint_extent},
+  {"similarity/temporal_frechet_distance", &bench_temporal_frechet_distance},
+  {"similarity/temporal_dyntimewarp_distance",
+    &bench_temporal_dyntimewarp_distance},
+  {"similarity/temporal_hausdorff_distance",
+    &bench_temporal_hausdorff_distance},
+};
+
+/*****************************************************************************
+ * Driver
+ *****************************************************************************/
+
+/**
+ * Return the current value of a monotonic clock in seconds
+ */
+static double
+now_seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static int
+cmp_double(const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+  return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+/* Main program */
+int main(int argc, char **argv)
+{
+  const char *dir = "data";
+  const char *filter = NULL;
+  int reps = DEFAULT_REPETITIONS;
+  int maxtrips = 1000000;
+  bool stats = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-s") == 0)
+      stats = true;
+    else if (i == argc - 1)
+      break;
+    else if (strcmp(argv[i], "-d") == 0)
+      dir = argv[++i];
+    else if (strcmp(argv[i], "-r") == 0)
+      reps = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-n") == 0)
+      maxtrips = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-b") == 0)
+      filter = argv[++i];
+  }
+  if (reps < 1)
+    reps = 1;
+  else if (reps > MAX_REPETITIONS)
+    reps = MAX_REPETITIONS;
+
+  /* Initialize MEOS */
+  meos_initialize("UTC", NULL);
+
+  bench_data data;
+  memset(&data, 0, sizeof(bench_data));
+  if (! read_ais(dir, &data) || ! read_trips(dir, maxtrips, &data))
+  {
+    meos_finalize();
+    return 1;
+  }
+
+  /* Only the benchmarks are accounted in the statistics */
+  if (stats)
+  {
+    meos_stats_reset();
+    meos_stats_enable(true);
+  }
+
+  printf("{\n  \"ais_ships\": %d,\n  \"berlinmod_trips\": %d,\n"
+    "  \"repetitions\": %d,\n  \"benchmarks\": [", data.nships, data.ntrips,
+    reps);
+  bool first = true;
+  int nbench = (int) (sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]));
+  for (int i = 0; i < nbench; i++)
+  {
+    if (filter && ! strstr(BENCHMARKS[i].name, filter))
+      continue;
+    double times[MAX_REPETITIONS];
+    int ops = 0;
+    /* Warm up the caches before timing the runs */
+    BENCHMARKS[i].fn(&data);
+    for (int j = 0; j < reps; j++)
+    {
+      double start = now_seconds();
+      ops = BENCHMARKS[i].fn(&data);
+      times[j] = now_seconds() - start;
+    }
+    double mean = 0;
+    for (int j = 0; j < reps; j++)
+      mean += times[j];
+    mean /= reps;
+    qsort(times, reps, sizeof(double), &cmp_double);
+    double median = (reps % 2) ? times[reps / 2] :
+      (times[reps / 2 - 1] + times[reps / 2]) / 2;
+    printf("%s\n    {\"name\": \"%s\", \"ops\": %d, \"min_s\": %.9f, "
+      "\"median_s\": %.9f, \"mean_s\": %.9f}", first ? "" : ",",
+      BENCHMARKS[i].name, ops, times[0], median, mean);
+    fflush(stdout);
+    first = false;
+  }
+  printf("\n  ]");
+  if (stats)
+  {
+    meos_stats_enable(false);
+    meosStats snapshot;
+    meos_stats_snapshot(&snapshot);
+    char *json = meos_stats_as_json(&snapshot);
+    printf(",\n  \"stats\": %s", json);
+    free(json);
+  }
+  printf("\n}\n");
+
+  /* Free memory */
+  for (int i = 0; i < data.nships; i++)
+  {
+    for (int j = 0; j < data.ships[i].count; j++)
+      free(data.ships[i].instants[j]);
+    free(data.ships[i].instants);
+    free(data.ais[i]);
+  }
+  free(data.ships); free(data.ais);
+  for (int i = 0; i < data.ntrips; i++)
+  {
+    free(data.trips[i]);
+    free(data.trips_text[i]);
+  }
+  free(data.trips); free(data.trips_text);
+  free(data.extent); free(data.box); free(data.geom); free(data.period);
+
+  /* Finalize MEOS */
+  meos_finalize();
+  return 0;
+}
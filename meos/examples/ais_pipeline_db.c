@@ -0,0 +1,201 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief A program that reads AIS data from a CSV file and ingests the trips
+ * of the ships into a MobilityDB database with the ingestion pipeline of the
+ * `meos_pq` library.
+ *
+ * This program is similar to `04_ais_stream_db` but the parsing of the
+ * input, the assembly of the trips, and the network sends overlap. The main
+ * thread parses the records, four assembler threads assemble the trips of
+ * the ships partitioned by MMSI with a session state, which splits the trips
+ * when there is no observation of a ship during one hour, and two writer
+ * threads send the trips to the database with a binary COPY through their
+ * own connection. The stages are connected by bounded lock-free queues.
+ *
+ * Please read the assumptions made about the input file in the file
+ * `02_ais_read.c` and the configuration of the database in the file
+ * `04_ais_stream_db.c` in the same directory.
+ *
+ * The program can be build as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -I/usr/include/postgresql -o ais_pipeline_db ais_pipeline_db.c -L/usr/local/lib -lmeos_pq -lmeos -lpq -lpthread
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <libpq-fe.h>
+#include <meos.h>
+#include <meos_pq.h>
+
+/* Maximum length in characters of a header record in the input CSV file */
+#define MAX_LENGTH_HEADER 1024
+/* Maximum length in characters of a point in the input data */
+#define MAX_LENGTH_POINT 64
+/* Memory budget in bytes of the open trips of an assembler */
+#define MEMORY_BUDGET 1048576
+
+/* Number of records read */
+static int no_records = 0;
+
+/* Read the next observation of the input file */
+static bool
+read_instant(int64_t *id, TInstant **inst, void *arg)
+{
+  FILE *file = (FILE *) arg;
+  char text_buffer[MAX_LENGTH_HEADER];
+  char point_buffer[MAX_LENGTH_POINT];
+  long int mmsi;
+  double latitude, longitude, sog;
+  if (feof(file))
+    return false;
+  int read = fscanf(file, "%32[^,],%ld,%lf,%lf,%lf\n",
+    text_buffer, &mmsi, &latitude, &longitude, &sog);
+  *inst = NULL;
+  if (read != 5)
+    /* Skip the record */
+    return ! ferror(file);
+  no_records++;
+  /* The timestamps are given in GMT time zone */
+  snprintf(point_buffer, MAX_LENGTH_POINT,
+    "SRID=4326;Point(%lf %lf)@%s+00", longitude, latitude, text_buffer);
+  *id = (int64_t) mmsi;
+  *inst = (TInstant *) tgeogpoint_in(point_buffer);
+  return true;
+}
+
+/* Function that sends a SQL command to the database */
+static int
+exec_sql(PGconn *conn, const char *sql)
+{
+  int result = 0;
+  PGresult *res = PQexec(conn, sql);
+  if (PQresultStatus(res) != PGRES_COMMAND_OK)
+  {
+    fprintf(stderr, "SQL command failed:\n%s %s", sql, PQerrorMessage(conn));
+    result = -1;
+  }
+  PQclear(res);
+  return result;
+}
+
+/* Main program */
+int
+main(int argc, char **argv)
+{
+  char text_buffer[MAX_LENGTH_HEADER];
+  FILE *file = NULL;
+  Interval *maxt = NULL;
+  /* Exit value initialized to 1 (i.e., error) to quickly exit upon error */
+  int exit_value = 1;
+
+  /* Get start time */
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  /* Use the first argument of the command line as connection string */
+  const char *conninfo = (argc > 1) ? argv[1] :
+    "host=localhost user=esteban dbname=test";
+
+  /* Create the table that will hold the data */
+  PGconn *conn = PQconnectdb(conninfo);
+  if (PQstatus(conn) != CONNECTION_OK)
+  {
+    fprintf(stderr, "%s", PQerrorMessage(conn));
+    goto cleanup;
+  }
+  if (exec_sql(conn, "DROP TABLE IF EXISTS public.AISTrips;") < 0 ||
+      exec_sql(conn, "CREATE TABLE public.AISTrips(MMSI bigint, "
+        "trip public.tgeogpoint);") < 0)
+    goto cleanup;
+
+  /* Initialize MEOS */
+  meos_initialize(NULL, NULL);
+
+  /* You may substitute the full file path in the first argument of fopen */
+  file = fopen("data/ais_instants.csv", "r");
+  if (! file)
+  {
+    printf("Error opening input file\n");
+    goto cleanup;
+  }
+  /* Read the first line of the file with the headers */
+  fscanf(file, "%1023s\n", text_buffer);
+
+  /* Run the pipeline */
+  maxt = pg_interval_in("1 hour", -1);
+  meosPipelineOptions opts = {0};
+  opts.conninfo = conninfo;
+  opts.target = "public.AISTrips(MMSI, trip)";
+  opts.nassemblers = 4;
+  opts.nwriters = 2;
+  opts.session.maxt = maxt;
+  opts.session.interp = LINEAR;
+  opts.session.memlimit = MEMORY_BUDGET;
+  opts.session.evict = TSESSION_EVICT_OLDEST;
+  int64_t no_errors;
+  int64_t no_trips = meos_pipeline_run(&read_instant, file, &opts, &no_errors);
+  if (no_trips < 0)
+  {
+    printf("Error while ingesting the trips\n");
+    goto cleanup;
+  }
+  printf("%d records read, %ld rejected, %ld trips written to the database\n",
+    no_records, (long int) no_errors, (long int) no_trips);
+
+  /* State that the program executed successfully */
+  exit_value = 0;
+
+  /* Calculate the elapsed time */
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("The program took %f seconds to execute\n",
+    (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+
+/* Clean up */
+cleanup:
+
+  /* Free memory */
+  free(maxt);
+
+  /* Close the file */
+  if (file)
+    fclose(file);
+
+  /* Finalize MEOS */
+  meos_finalize();
+
+  /* Close the connection to the database */
+  PQfinish(conn);
+
+  return exit_value;
+}
@@ -0,0 +1,159 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+
+/**
+ * @brief A simple program that reads AIS data from a CSV file and assembles
+ * the trips of the ships with a session state, which splits the trips when
+ * there is no observation of a ship during one hour and keeps the open trips
+ * within a memory budget of 1 MB.
+ *
+ * This program is similar to `03_ais_assemble` but the bookkeeping of the
+ * trips of the ships is done by MEOS, so the number of ships is not limited.
+ * The closed trips are written to an output file.
+ *
+ * The program can be build as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o ais_sessionize ais_sessionize.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <meos.h>
+
+/* Maximum length in characters of a header record in the input CSV file */
+#define MAX_LENGTH_HEADER 1024
+/* Maximum length in characters of a point in the input data */
+#define MAX_LENGTH_POINT 64
+/* Memory budget in bytes of the open trips */
+#define MEMORY_BUDGET 1048576
+
+/* Number of trips written for each reason of closing a trip */
+static int no_trips[4] = {0};
+
+/* Write a closed trip to the output file */
+static void
+write_trip(int64 id, TSequence *trip, tsessionFlush reason, void *arg)
+{
+  FILE *file_out = (FILE *) arg;
+  char *trip_out = tpoint_as_text((Temporal *) trip, 6);
+  fprintf(file_out, "%ld,%d,%s\n", (long int) id, trip->count, trip_out);
+  no_trips[reason]++;
+  free(trip_out);
+  free(trip);
+  return;
+}
+
+int
+main(void)
+{
+  char text_buffer[MAX_LENGTH_HEADER];
+  char point_buffer[MAX_LENGTH_POINT];
+  long int mmsi;
+  double latitude, longitude, sog;
+  int no_records = 0, no_errors = 0;
+  /* Exit value initialized to 1 (i.e., error) to quickly exit upon error */
+  int exit_value = 1;
+
+  /* Initialize MEOS */
+  meos_initialize(NULL, NULL);
+
+  /* You may substitute the full file path in the first argument of fopen */
+  FILE *file_in = fopen("data/ais_instants.csv", "r");
+  FILE *file_out = fopen("data/ais_sessions.csv", "w+");
+  if (! file_in || ! file_out)
+  {
+    printf("Error opening the input or the output file\n");
+    goto cleanup;
+  }
+
+  /* Create the session state */
+  Interval *maxt = pg_interval_in("1 hour", -1);
+  tsessionOptions opts = {0};
+  opts.maxt = maxt;
+  opts.interp = LINEAR;
+  opts.memlimit = MEMORY_BUDGET;
+  opts.evict = TSESSION_EVICT_OLDEST;
+  opts.flush = &write_trip;
+  opts.arg = file_out;
+  SessionState *state = tsession_state_make(&opts);
+
+  /* Read the first line of the file with the headers */
+  fscanf(file_in, "%1023s\n", text_buffer);
+  fprintf(file_out, "mmsi,count,trip\n");
+
+  /* Continue reading the file */
+  do
+  {
+    int read = fscanf(file_in, "%32[^,],%ld,%lf,%lf,%lf\n",
+      text_buffer, &mmsi, &latitude, &longitude, &sog);
+    if (read != 5)
+      continue;
+    no_records++;
+    /* The timestamps are given in GMT time zone */
+    snprintf(point_buffer, MAX_LENGTH_POINT,
+      "SRID=4326;Point(%lf %lf)@%s+00", longitude, latitude, text_buffer);
+    TInstant *inst = (TInstant *) tgeogpoint_in(point_buffer);
+    /* The observations that are not after the last one of their ship are
+     * discarded, the quiet mode avoids calling the error handler, which
+     * exits the program */
+    meos_error_quiet_set(true);
+    if (! tsession_state_push(state, (int64) mmsi, inst))
+      no_errors++;
+    meos_error_quiet_set(false);
+    free(inst);
+  } while (! feof(file_in));
+
+  /* Close the remaining trips */
+  printf("%d records read, %d errors, %d ships with an open trip\n",
+    no_records, no_errors, tsession_state_count(state));
+  tsession_state_finish(state);
+  printf("%d trips closed by a gap, %d evicted, %d at the end\n",
+    no_trips[TSESSION_GAP], no_trips[TSESSION_EVICT], no_trips[TSESSION_FINISH]);
+  free(maxt);
+
+  /* State that the program executed successfully */
+  exit_value = 0;
+
+/* Clean up */
+cleanup:
+
+  /* Finalize MEOS */
+  meos_finalize();
+
+  /* Close the files */
+  if (file_in)
+    fclose(file_in);
+  if (file_out)
+    fclose(file_out);
+
+  return exit_value;
+}
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief A simple program that uses the MEOS library for transforming
+ * geometries into network points and back using an in-memory route table.
+ *
+ * The program requires that MEOS is built with network points, i.e., with
+ * the option -DNPOINT=ON, and can be build as follows
+ * @code
+ * gcc -Wall -g -I/usr/local/include -o npoint_routes npoint_routes.c -L/usr/local/lib -lmeos
+ * @endcode
+ */
+
+#include <stdio.h>    /* for printf */
+#include <stdlib.h>   /* for free */
+/* Include the MEOS API headers */
+#include <meos.h>
+#include <meos_npoint.h>
+
+int main()
+{
+  /* Initialize MEOS */
+  meos_initialize(NULL, NULL);
+
+  /* Add two routes to the route table, their lengths are computed from the
+   * geometries. The routes can also be loaded from a CSV file with
+   * meos_route_load_csv */
+  GSERIALIZED *route1 =
+    pgis_geometry_in("SRID=5676;LINESTRING(0 0,10 0)", -1);
+  GSERIALIZED *route2 =
+    pgis_geometry_in("SRID=5676;LINESTRING(10 0,10 10)", -1);
+  meos_route_add(1, route1, -1.0);
+  meos_route_add(2, route2, -1.0);
+  printf("Number of routes: %d\n", meos_route_count());
+
+  /* Transform a geometry into a network point and back */
+  GSERIALIZED *point = pgis_geometry_in("SRID=5676;POINT(10 5)", -1);
+  Npoint *np = geom_npoint(point);
+  char *np_out = npoint_out(np, 6);
+  GSERIALIZED *geom = npoint_geom(np);
+  char *geom_out = geo_as_ewkt(geom, 6);
+  printf("Network point: %s\nGeometry: %s\n", np_out, geom_out);
+
+  /* Clean up allocated objects */
+  free(route1); free(route2); free(point);
+  free(np); free(np_out); free(geom); free(geom_out);
+  meos_route_clear();
+
+  /* Finalize MEOS */
+  meos_finalize();
+
+  /* Return */
+  return 0;
+}
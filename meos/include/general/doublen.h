@@ -93,6 +93,14 @@ extern double4 *double4_add(const double4 *d1, const double4 *d2);
 extern bool double4_eq(const double4 *d1, const double4 *d2);
 extern int double4_cmp(const double4 *d1, const double4 *d2);
 
+extern void double2arr_add(const double2 *arr1, const double2 *arr2,
+  int count, double2 *result);
+extern void double3arr_add(const double3 *arr1, const double3 *arr2,
+  int count, double3 *result);
+extern void double4arr_add(const double4 *arr1, const double4 *arr2,
+  int count, double4 *result);
+extern void double2arr_div(const double2 *arr, int count, double *result);
+
 /*****************************************************************************/
 
 #endif /* __DOUBLEN_H__ */
@@ -313,6 +313,10 @@
  * @ingroup meos_temporal_analytics
  * @brief Similarity functions for temporal types
  *
+ * @defgroup meos_temporal_analytics_cluster Clustering functions
+ * @ingroup meos_temporal_analytics
+ * @brief Clustering functions for temporal types
+ *
  * @defgroup meos_temporal_analytics_tile Tile functions
  * @ingroup meos_temporal_analytics
  * @brief Tile functions for temporal types
@@ -70,6 +70,43 @@ typedef struct
     Datum *, TimestampTz *); /**< Turning point function for two temporal types */
 } LiftedFunctionInfo;
 
+/**
+ * Structure to iterate over the pairs of synchronized segments of two
+ * temporal continuous sequences
+ *
+ * The iterator synchronizes the segments on the fly, so that the synchronized
+ * sequences are never constructed. At most one synchronization instant per
+ * bound of the current segment pair is kept, and it is freed when the
+ * iterator advances.
+ */
+typedef struct
+{
+  const TSequence *seq1;  /**< First sequence */
+  const TSequence *seq2;  /**< Second sequence */
+  interpType interp1;     /**< Interpolation of the first sequence */
+  interpType interp2;     /**< Interpolation of the second sequence */
+  int i;                  /**< Index of the next instant of the first sequence */
+  int j;                  /**< Index of the next instant of the second sequence */
+  const TInstant *start1; /**< Start instant of the first segment */
+  const TInstant *end1;   /**< End instant of the first segment */
+  const TInstant *start2; /**< Start instant of the second segment */
+  const TInstant *end2;   /**< End instant of the second segment */
+  bool free_start1;       /**< True if start1 is a synchronization instant */
+  bool free_end1;         /**< True if end1 is a synchronization instant */
+  bool free_start2;       /**< True if start2 is a synchronization instant */
+  bool free_end2;         /**< True if end2 is a synchronization instant */
+  bool lower_inc;         /**< True if the start instants are inclusive */
+  bool upper_inc;         /**< True if the end instants are inclusive */
+  bool last_upper_inc;    /**< Upper bound of the overlapping period */
+} SyncSegmIter;
+
+/*****************************************************************************/
+
+extern void syncsegm_iter_init(SyncSegmIter *iter, const TSequence *seq1,
+  const TSequence *seq2, const Span *inter);
+extern bool syncsegm_iter_next(SyncSegmIter *iter);
+extern void syncsegm_iter_free(SyncSegmIter *iter);
+
 /*****************************************************************************/
 
 extern TInstant *tfunc_tinstant(const TInstant *inst,
@@ -163,40 +163,18 @@ typedef enum
 } meosOper;
 
 /**
- * Structure to represent the temporal type cache array.
+ * Structure to represent the type cache array, which is indexed by the
+ * enumeration meosType
  */
 typedef struct
 {
-  meosType temptype;    /**< Enum value of the temporal type */
-  meosType basetype;    /**< Enum value of the base type */
-} temptype_catalog_struct;
-
-/**
- * Structure to represent the span type cache array.
- */
-typedef struct
-{
-  meosType settype;     /**< Enum value of the set type */
-  meosType basetype;    /**< Enum value of the base type */
-} settype_catalog_struct;
-
-/**
- * Structure to represent the span type cache array.
- */
-typedef struct
-{
-  meosType spantype;    /**< Enum value of the span type */
-  meosType basetype;    /**< Enum value of the base type */
-} spantype_catalog_struct;
-
-/**
- * Structure to represent the spanset type cache array.
- */
-typedef struct
-{
-  meosType spansettype;    /**< Enum value of the span type */
-  meosType spantype;       /**< Enum value of the base type */
-} spansettype_catalog_struct;
+  meosType basetype;    /**< Base type of a set, span, or temporal type */
+  meosType settype;     /**< Set type of a base type */
+  meosType spantype;    /**< Span type of a base type or a span set type */
+  meosType spansettype; /**< Span set type of a span type */
+  int16 length;         /**< Length of a base type, 0 if not a base type */
+  uint64_t flags;       /**< Bitmask of the type classes of the type */
+} meostype_catalog_struct;
 
 /*****************************************************************************/
 
@@ -0,0 +1,96 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Static tracepoints (USDT probes) in the hot paths of MEOS
+ *
+ * The probes are compiled when the build option DTRACE is set, which defines
+ * MEOS_DTRACE. They are then listed by, e.g., `bpftrace -l 'usdt:<library>:*'`
+ * under the provider `meos`. A probe that is not traced costs a single no-op
+ * instruction, and nothing at all when the option is not set.
+ *
+ * Probe                   Arguments
+ * tfunc__start            instants of the first and second argument
+ * tfunc__done             instants of the result, 0 if none
+ * eafunc__start           instants of the first and second argument
+ * eafunc__done            result (-1 if no intersection, 0 false, 1 true)
+ * skiplist__splice        elements in the skiplist, elements spliced
+ * index__gist__consistent leaf flag, strategy, result
+ * index__spgist__inner    strategy of the first key, input nodes, output nodes
+ * wkb__read               size of the input WKB in bytes
+ * wkb__write              size of the output WKB in bytes
+ * route__geom             route identifier
+ */
+
+#ifndef __MEOS_PROBES_H__
+#define __MEOS_PROBES_H__
+
+#if MEOS_DTRACE
+
+#include <sys/sdt.h>
+
+#define MEOS_PROBE_TFUNC_START(n1, n2) \
+  DTRACE_PROBE2(meos, tfunc__start, n1, n2)
+#define MEOS_PROBE_TFUNC_DONE(n) \
+  DTRACE_PROBE1(meos, tfunc__done, n)
+#define MEOS_PROBE_EAFUNC_START(n1, n2) \
+  DTRACE_PROBE2(meos, eafunc__start, n1, n2)
+#define MEOS_PROBE_EAFUNC_DONE(res) \
+  DTRACE_PROBE1(meos, eafunc__done, res)
+#define MEOS_PROBE_SKIPLIST_SPLICE(length, count) \
+  DTRACE_PROBE2(meos, skiplist__splice, length, count)
+#define MEOS_PROBE_INDEX_GIST_CONSISTENT(leaf, strategy, res) \
+  DTRACE_PROBE3(meos, index__gist__consistent, leaf, strategy, res)
+#define MEOS_PROBE_INDEX_SPGIST_INNER(strategy, nin, nout) \
+  DTRACE_PROBE3(meos, index__spgist__inner, strategy, nin, nout)
+#define MEOS_PROBE_WKB_READ(size) \
+  DTRACE_PROBE1(meos, wkb__read, size)
+#define MEOS_PROBE_WKB_WRITE(size) \
+  DTRACE_PROBE1(meos, wkb__write, size)
+#define MEOS_PROBE_ROUTE_GEOM(rid) \
+  DTRACE_PROBE1(meos, route__geom, rid)
+
+#else /* ! MEOS_DTRACE */
+
+#define MEOS_PROBE_TFUNC_START(n1, n2) do {} while (0)
+#define MEOS_PROBE_TFUNC_DONE(n) do {} while (0)
+#define MEOS_PROBE_EAFUNC_START(n1, n2) do {} while (0)
+#define MEOS_PROBE_EAFUNC_DONE(res) do {} while (0)
+#define MEOS_PROBE_SKIPLIST_SPLICE(length, count) do {} while (0)
+#define MEOS_PROBE_INDEX_GIST_CONSISTENT(leaf, strategy, res) do {} while (0)
+#define MEOS_PROBE_INDEX_SPGIST_INNER(strategy, nin, nout) do {} while (0)
+#define MEOS_PROBE_WKB_READ(size) do {} while (0)
+#define MEOS_PROBE_WKB_WRITE(size) do {} while (0)
+#define MEOS_PROBE_ROUTE_GEOM(rid) do {} while (0)
+
+#endif /* MEOS_DTRACE */
+
+/*****************************************************************************/
+
+#endif /* __MEOS_PROBES_H__ */
@@ -63,6 +63,7 @@ extern float8 pg_datan2(float8 arg1, float8 arg2);
 /* Functions adadpted from timestamp.c */
 
 extern Interval *pg_interval_justify_hours(const Interval *span);
+extern int timestamptz_to_iso8601_buf(TimestampTz t, char sep, char *buf);
 
 /* Functions adapted from hashfn.h and hashfn.c */
 
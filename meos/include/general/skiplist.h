@@ -62,6 +62,9 @@ extern void skiplist_splice(SkipList *list, void **values, int count,
 extern void **skiplist_values(SkipList *list);
 extern Temporal **skiplist_temporal_values(SkipList *list);
 extern void skiplist_free(SkipList *list);
+extern size_t skiplist_serialize_size(const SkipList *list);
+extern void skiplist_serialize(const SkipList *list, char *buf);
+extern SkipList *skiplist_deserialize(const char *buf, size_t size);
 
 /*****************************************************************************/
 
@@ -68,6 +68,20 @@
  */
 #define DIST_EPSILON    1.0e-06
 
+/**
+ * Number of doubles of the values of a temporal float or a temporal point
+ * in the functions returning raw values
+ */
+#define TEMPORAL_NDOUBLES(temp) \
+  (((temp)->temptype == T_TFLOAT) ? 1 : (MEOS_FLAGS_GET_Z((temp)->flags) ? 3 : 2))
+
+/**
+ * Byte-wise equality of two varlena values, which implies that their values
+ * are equal, although unequal bytes do not imply unequal values
+ */
+#define VARLENA_BYTES_EQ(A, B) \
+  (VARSIZE(A) == VARSIZE(B) && memcmp((A), (B), VARSIZE(A)) == 0)
+
 /** Symbolic constants for lifting */
 #define DISCONTINUOUS   true
 #define CONTINUOUS      false
@@ -199,12 +213,33 @@ enum MEOS_WKB_TSUBTYPE
 #define MEOS_WKB_ZFLAG            0x10  // 16
 #define MEOS_WKB_GEODETICFLAG     0x20  // 32
 #define MEOS_WKB_SRIDFLAG         0x40  // 64
+#define MEOS_WKB_COMPRESSEDFLAG   0x80  // 128
 
 #define MEOS_WKB_GET_INTERP(flags) (((flags) & MEOS_WKB_INTERPFLAGS) >> 2)
 #define MEOS_WKB_SET_INTERP(flags, value) ((flags) = (((flags) & ~MEOS_WKB_INTERPFLAGS) | ((value & 0x0003) << 2)))
 
 // #define MEOS_WKB_GET_LINEAR(flags)     ((bool) (((flags) & MEOS_WKB_LINEARFLAG)>>3))
 
+/* Flags of the delta of the instants appended to a temporal value */
+#define MEOS_DELTA_VALUEFLAG      0x01  // The delta has instants
+#define MEOS_DELTA_CONTINUEFLAG   0x02  // The delta continues the last sequence
+
+/**
+ * @brief Structure keeping the previous instant in the compressed WKB
+ * encoding of temporal sequences and sequence sets
+ * @details Timestamps are encoded as zigzag varints of their delta-of-delta,
+ * integer values and route identifiers as zigzag varints of their delta, and
+ * doubles and coordinates by the XOR of their bits with the previous ones
+ */
+typedef struct
+{
+  int count;              /**< Number of instants already encoded */
+  int64 t;                /**< Previous timestamp */
+  int64 dt;               /**< Previous timestamp delta */
+  int64 ival;             /**< Previous integer value or route identifier */
+  uint64 dval[3];         /**< Bits of the previous doubles or coordinates */
+} WkbDeltaState;
+
 /*****************************************************************************
  * Definitions for bucketing and tiling
  *****************************************************************************/
@@ -269,14 +304,21 @@ typedef Datum (*datum_func3) (Datum, Datum, Datum);
 
 #if MEOS
   #define DatumGetTemporalP(X)       ((Temporal *) DatumGetPointer(X))
+  #define PG_GETARG_TEMPORAL_P(X)    ((Temporal *) PG_GETARG_VARLENA_P(X))
+  #define PG_GETARG_TSEQUENCE_P(X)   ((TSequence *) PG_GETARG_VARLENA_P(X))
+  #define PG_GETARG_TSEQUENCESET_P(X) ((TSequenceSet *) PG_GETARG_VARLENA_P(X))
 #else
-  #define DatumGetTemporalP(X)       ((Temporal *) PG_DETOAST_DATUM(X))
+  /* Values in the compressed format are decompressed when detoasted */
+  extern Temporal *temporal_detoast(Datum value);
+  #define DatumGetTemporalP(X)       (temporal_detoast(X))
+  #define PG_GETARG_TEMPORAL_P(X)    (temporal_detoast(PG_GETARG_DATUM(X)))
+  #define PG_GETARG_TSEQUENCE_P(X) \
+    ((TSequence *) temporal_detoast(PG_GETARG_DATUM(X)))
+  #define PG_GETARG_TSEQUENCESET_P(X) \
+    ((TSequenceSet *) temporal_detoast(PG_GETARG_DATUM(X)))
 #endif /* MEOS */
 
-#define PG_GETARG_TEMPORAL_P(X)      ((Temporal *) PG_GETARG_VARLENA_P(X))
 #define PG_GETARG_TINSTANT_P(X)      ((TInstant *) PG_GETARG_VARLENA_P(X))
-#define PG_GETARG_TSEQUENCE_P(X)     ((TSequence *) PG_GETARG_VARLENA_P(X))
-#define PG_GETARG_TSEQUENCESET_P(X)  ((TSequenceSet *) PG_GETARG_VARLENA_P(X))
 
 #define PG_RETURN_TEMPORAL_P(X)      PG_RETURN_POINTER(X)
 #define PG_RETURN_TINSTANT_P(X)      PG_RETURN_POINTER(X)
@@ -369,6 +411,10 @@ extern char *mobilitydb_full_version(void);
 extern bool ea_eq_bbox_temp_base(const Temporal *temp, Datum value, bool ever);
 extern bool ea_lt_bbox_temp_base(const Temporal *temp, Datum value, bool ever);
 
+/* Transformation functions */
+
+extern size_t temporal_compressed_header_size(const Temporal *temp);
+
 /* Restriction functions */
 
 extern bool temporal_bbox_restrict_value(const Temporal *temp, Datum value);
@@ -81,9 +81,12 @@ extern SkipList *tdiscseq_tagg_transfn(SkipList *state, const TSequence *seq,
 
 extern SkipList *temporal_tagg_transfn(SkipList *state, const Temporal *temp,
   datum_func2, bool crossings);
+extern SkipList *temporal_tagg_transfn_batch(SkipList *state,
+  const Temporal **temps, int count, datum_func2 func, bool crossings);
 extern SkipList *temporal_tagg_combinefn(SkipList *state1, SkipList *state2,
   datum_func2 func, bool crossings);
 extern Temporal *temporal_tagg_finalfn(SkipList *state);
+extern SkipList *temporal_tagg_expire(SkipList *state, TimestampTz t);
 extern SkipList *temporal_tagg_transform_transfn(SkipList *state, const Temporal *temp,
   datum_func2 func, bool crossings, TInstant *(*transform)(const TInstant *));
 
@@ -57,9 +57,13 @@ typedef struct
 /*****************************************************************************/
 
 extern double temporal_similarity(const Temporal *temp1, const Temporal *temp2,
-  SimFunc simfunc);
+  SimFunc simfunc, int band, double bound);
+extern double temporal_similarity_lower_bound(const Temporal *temp1,
+  const Temporal *temp2, SimFunc simfunc, int band);
 extern Match *temporal_similarity_path(const Temporal *temp1,
   const Temporal *temp2, int *count, SimFunc simfunc);
+extern double temporal_hausdorff(const Temporal *temp1, const Temporal *temp2,
+  double bound);
 
 /*****************************************************************************/
 
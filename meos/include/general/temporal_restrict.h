@@ -43,6 +43,37 @@
 
 /*****************************************************************************/
 
+/**
+ * @brief Structure to represent a continuous temporal sequence restricted to
+ * a time span without copying its composing instants
+ * @details The instants of the view are @p start (if not NULL), the instants
+ * of @p seq at positions @p first to @p last, and @p end (if not NULL)
+ */
+typedef struct
+{
+  const TSequence *seq;  /**< Base sequence */
+  TInstant *start;       /**< Instant at the lower bound of the period */
+  TInstant *end;         /**< Instant at the upper bound of the period */
+  int first;             /**< Position of the first instant of the base
+                              sequence in the view */
+  int last;              /**< Position of the last instant of the base
+                              sequence in the view */
+  Span period;           /**< Time span of the view */
+} TSequenceView;
+
+/*****************************************************************************/
+
+/* Sequence view functions */
+
+extern bool tcontseq_at_tstzspan_view(const TSequence *seq, const Span *s,
+  TSequenceView *view);
+extern int tsequenceview_count(const TSequenceView *view);
+extern const TInstant *tsequenceview_inst_n(const TSequenceView *view, int n);
+extern TSequence *tsequenceview_make(const TSequenceView *view);
+extern void tsequenceview_free(TSequenceView *view);
+extern double tnumberseqview_integral(const TSequenceView *view);
+extern double tnumberseqview_twavg(const TSequenceView *view);
+
 /* Restriction Functions */
 
 extern TInstant *tdiscseq_at_timestamptz(const TSequence *seq, TimestampTz t);
@@ -74,21 +74,36 @@ typedef struct TboxGridState
 /*****************************************************************************/
 
 /**
- * Struct for storing the state that persists across multiple calls to output
- * the temporal fragments
+ * Struct for storing the state for splitting a temporal value incrementally
+ * with respect to value and/or time buckets
  */
 typedef struct ValueTimeSplitState
 {
-  bool done;           /**< True when all tiles have been processed */
-  int i;               /**< Number of current tile */
-  Datum size;
-  int64 tunits;
-  Datum *value_buckets;
-  TimestampTz *time_buckets;
-  Temporal **fragments;
-  int count;
+  bool done;             /**< True when all fragments have been output */
+  bool valuesplit;       /**< True when splitting with respect to values */
+  bool timesplit;        /**< True when splitting with respect to time */
+  const Temporal *temp;  /**< Temporal value to split */
+  int i;                 /**< Index of the current value bucket */
+  int count;             /**< Number of non-empty value buckets */
+  Datum *values;         /**< Lower bounds of the non-empty value buckets */
+  Temporal **atspans;    /**< Fragments of the temporal value in the
+                              non-empty value buckets */
+  int64 tunits;          /**< Size of the time buckets */
+  TimestampTz torigin;   /**< Origin of the time buckets */
+  TimestampTz t;         /**< Lower bound of the next time bucket */
+  TimestampTz end_time;  /**< Upper bound of the last time bucket */
 } ValueTimeSplitState;
 
+/**
+ * @brief Enumeration for the aggregate functions computed per time bucket
+ */
+typedef enum
+{
+  BUCKET_TWAVG,
+  BUCKET_MAX,
+  BUCKET_LENGTH,
+} bucketAggType;
+
 /*****************************************************************************/
 
 extern void span_bucket_set(Datum lower, Datum size, meosType basetype,
@@ -111,6 +126,8 @@ extern TBox *tbox_tile(Datum value, TimestampTz t, Datum vsize,
 extern int64 interval_units(const Interval *interval);
 extern TimestampTz timestamptz_bucket1(TimestampTz timestamp, int64 tunits,
   TimestampTz torigin);
+extern bool timestamptzarr_bucket1(const TimestampTz *times, int count,
+  int64 size, TimestampTz origin, TimestampTz *result);
 extern Datum datum_bucket(Datum value, Datum size, Datum offset,
   meosType basetype);
 
@@ -120,6 +137,16 @@ extern Temporal **tnumber_value_time_split(Temporal *temp, Datum size,
   Interval *duration, Datum vorigin, TimestampTz torigin,
   Datum **value_buckets, TimestampTz **time_buckets, int *count);
 
+extern Temporal *temporal_bucket_agg(const Temporal *temp,
+  const Interval *duration, TimestampTz torigin, bucketAggType type);
+
+extern ValueTimeSplitState *value_time_split_state_make(const Temporal *temp,
+  bool valuesplit, Datum size, Datum vorigin, const Interval *duration,
+  TimestampTz torigin);
+extern bool value_time_split_state_next(ValueTimeSplitState *state,
+  Datum *value, TimestampTz *t, Temporal **fragment);
+extern void value_time_split_state_free(ValueTimeSplitState *state);
+
 /*****************************************************************************/
 
 #endif /* __TEMPORAL_TILE_H__ */
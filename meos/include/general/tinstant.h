@@ -45,7 +45,13 @@
 /* General functions */
 
 extern void tinstant_set(TInstant *inst, Datum value, TimestampTz t);
+extern size_t tinstant_make_size(Datum value, meosType temptype);
+extern TInstant *tinstant_make_in(void *mem, Datum value, meosType temptype,
+  TimestampTz t);
 extern double tnumberinst_double(const TInstant *inst);
+extern void datum_doubles(Datum value, meosType temptype, int ndims,
+  double *result);
+extern void tinstant_doubles(const TInstant *inst, int ndims, double *result);
 
 /* Input/output functions */
 
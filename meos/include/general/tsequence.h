@@ -113,6 +113,9 @@ extern bool ensure_valid_tinstarr(const TInstant **instants, int count,
 
 extern void tsequence_compact_iter(const TSequence *seq, size_t seqsize,
   size_t insts_size, TSequence *result);
+extern size_t tsequence_pack_size(const TSequence *seq, bool *fixed);
+extern void tsequence_pack_iter(const TSequence *seq, bool fixed,
+  TSequence *result);
 extern void tnumberseq_shift_scale_value_iter(TSequence *seq, Datum origin,
   Datum delta, bool hasdelta, double scale);
 extern void tsequence_shift_scale_time_iter(TSequence *seq, TimestampTz delta,
@@ -125,9 +128,15 @@ extern TSequenceSet *tstepseq_to_linear(const TSequence *seq);
 extern int tfloatseq_spans(const TSequence *seq, Span *result);
 extern int tsequence_segments_iter(const TSequence *seq, TSequence **result);
 extern int tsequence_timestamps_iter(const TSequence *seq, TimestampTz *result);
+extern int tnumberseq_values_iter(const TSequence *seq, double *values);
 extern Datum tsegment_value_at_timestamptz(const TInstant *inst1,
   const TInstant *inst2, interpType interp, TimestampTz t);
 
+/* Synchronization functions */
+
+extern bool tsequence_same_timestamps(const TSequence *seq1,
+  const TSequence *seq2);
+
 /* Local Aggregate Functions */
 
 extern double tnumbercontseq_twavg(const TSequence *seq);
@@ -38,6 +38,8 @@
 #include <meos.h>
 #include "general/meos_catalog.h"
 
+struct pg_tm;
+
 /*****************************************************************************/
 
 extern bool ensure_end_input(const char **str, const char *type);
@@ -60,6 +62,8 @@ extern Set *set_parse(const char **str, meosType basetype);
 extern bool span_parse(const char **str, meosType spantype, bool end, Span *span);
 extern SpanSet *spanset_parse(const char **str, meosType spantype);
 extern TBox *tbox_parse(const char **str);
+extern bool timestamp_scan_iso(const char *str, int len, struct pg_tm *tm,
+  int32 *fsec, int *tz, bool *hastz);
 extern TimestampTz timestamp_parse(const char **str);
 extern bool tinstant_parse(const char **str, meosType temptype, bool end,
   TInstant **result);
@@ -78,6 +78,13 @@ extern void spanarr_sort(Span *spans, int count);
 extern void tinstarr_sort(TInstant **instants, int count);
 extern void tseqarr_sort(TSequence **sequences, int count);
 
+/* Merge functions of sorted runs */
+
+extern void tinstarr_merge_runs(const TInstant **instants, const int *counts,
+  int nruns, const TInstant **result);
+extern void tseqarr_merge_runs(const TSequence **sequences, const int *counts,
+  int nruns, const TSequence **result);
+
 /* Remove duplicate functions */
 
 extern int datumarr_remove_duplicates(Datum *values, int count,
@@ -66,6 +66,21 @@
 #define strdup _strdup
 #endif
 
+/*
+ * Storage class of the global variables that MEOS keeps per thread, such as
+ * the error number, the random generators, and the PROJ context. The
+ * PostgreSQL backends are single-threaded and do not need it.
+ */
+#ifndef MEOS_THREAD_LOCAL
+#if ! MEOS
+#define MEOS_THREAD_LOCAL
+#elif defined(_MSC_VER)
+#define MEOS_THREAD_LOCAL __declspec(thread)
+#else
+#define MEOS_THREAD_LOCAL __thread
+#endif
+#endif
+
 /*****************************************************************************
  * Type definitions
  *****************************************************************************/
@@ -75,6 +90,14 @@
  */
 #define DOUBLE_PAD(size) ( (size) + ((size) % 8 ? (8 - (size) % 8) : 0 ) )
 
+/**
+ * @brief Variant of the WKB output requesting the compressed encoding of
+ * temporal sequences and sequence sets
+ * @note The bit of the SFSQL variant of PostGIS, which does not apply to the
+ * MEOS types, is reused
+ */
+#define MEOS_WKB_COMPRESSED 0x02
+
 /**
  * Structure to represent sets of values
  */
@@ -264,10 +287,221 @@ typedef struct
   int j;
 } Match;
 
+/**
+ * Struct for specifying the layout of a CSV file of temporal point
+ * observations, where the columns are numbered from 0
+ */
+typedef struct
+{
+  int id_col;          /**< Column of the integer identifier of the object */
+  int t_col;           /**< Column of the timestamp */
+  int x_col;           /**< Column of the X coordinate or the longitude */
+  int y_col;           /**< Column of the Y coordinate or the latitude */
+  int z_col;           /**< Column of the Z coordinate, -1 if none */
+  char delimiter;      /**< Column delimiter */
+  bool header;         /**< True when the first line is a header */
+  int32 srid;          /**< SRID of the points */
+  bool geodetic;       /**< True for temporal geography points */
+  interpType interp;   /**< Interpolation of the resulting sequences */
+  int nthreads;        /**< Number of parsing threads, 0 for the default */
+} tpointCsvOptions;
+
+/**
+ * Struct for a memory block provided by the caller in which the bulk input
+ * functions store the values read
+ */
+typedef struct
+{
+  char *data;          /**< Memory block, aligned on 8 bytes */
+  size_t size;         /**< Size of the block */
+  size_t used;         /**< Number of bytes of the block already used */
+} meosArena;
+
+/**
+ * Enumeration that defines the coordinate operations of a transformation
+ * pipeline of temporal points
+ */
+typedef enum
+{
+  COORDOP_AFFINE,      /**< Affine transformation */
+  COORDOP_TRANSFORM,   /**< Transformation to another SRID */
+  COORDOP_GRID,        /**< Snapping to a grid */
+  COORDOP_ROUND,       /**< Rounding to a number of decimal places */
+} coordOpType;
+
+/**
+ * Struct for specifying a coordinate operation of a transformation pipeline
+ * of temporal points, where only the fields of the operation are used
+ */
+typedef struct
+{
+  coordOpType type;    /**< Operation */
+  AFFINE affine;       /**< Matrix of the affine transformation */
+  int32 srid;          /**< Target SRID of the transformation */
+  double ipx;          /**< X origin of the grid */
+  double ipy;          /**< Y origin of the grid */
+  double ipz;          /**< Z origin of the grid */
+  double xsize;        /**< X cell size of the grid, 0 if not snapped */
+  double ysize;        /**< Y cell size of the grid, 0 if not snapped */
+  double zsize;        /**< Z cell size of the grid, 0 if not snapped */
+  int maxdd;           /**< Maximum number of decimal digits of the rounding */
+} CoordOp;
+
+/**
+ * Opaque structure to represent an open container file of temporal values
+ */
+typedef struct TContainer TContainer;
+
+/**
+ * Opaque structure to represent an in-memory store of temporal values
+ */
+typedef struct TStore TStore;
+
+/**
+ * Opaque structure to represent the state of the online simplification of a
+ * stream of temporal instants
+ */
+typedef struct SimplifyState SimplifyState;
+
+/**
+ * Opaque structure to represent the state of the assembly of the trips of
+ * many concurrent moving objects from a stream of observations
+ */
+typedef struct SessionState SessionState;
+
+/**
+ * Opaque structure to represent the state of the assembly of a sequence from
+ * a stream of instants that may arrive out of order
+ */
+typedef struct ReorderState ReorderState;
+
+/**
+ * Opaque structure to represent the state of the incremental construction of
+ * a span set
+ */
+typedef struct SpansetState SpansetState;
+
+/**
+ * Enumeration that defines the reasons for closing a trip
+ */
+typedef enum
+{
+  TSESSION_GAP,        /**< The next observation is after a gap */
+  TSESSION_IDLE,       /**< The object has no recent observation */
+  TSESSION_EVICT,      /**< The memory budget is exceeded */
+  TSESSION_FINISH,     /**< The assembly is finished */
+} tsessionFlush;
+
+/**
+ * Enumeration that defines the open trips closed when the memory budget is
+ * exceeded
+ */
+typedef enum
+{
+  TSESSION_EVICT_LARGEST, /**< The largest trips */
+  TSESSION_EVICT_OLDEST,  /**< The trips with the earliest last observation */
+} tsessionEvict;
+
+/* Definition of the function receiving the closed trips, which takes the
+ * ownership of the trip */
+typedef void (*tsession_flush_fn)(int64 id, TSequence *trip,
+  tsessionFlush reason, void *arg);
+
+/**
+ * Structure to represent the options of the assembly of trips
+ */
+typedef struct
+{
+  double maxdist;          /**< Maximum distance defining a gap, 0 for none */
+  const Interval *maxt;    /**< Maximum time interval defining a gap, NULL
+                                for none */
+  interpType interp;       /**< Interpolation of the trips */
+  size_t memlimit;         /**< Memory budget in bytes of the open trips, 0
+                                for none */
+  tsessionEvict evict;     /**< Trips closed when exceeding the budget */
+  int maxcount;            /**< Initial number of instants of the trips, 0
+                                for the default */
+  tsession_flush_fn flush; /**< Function receiving the closed trips */
+  void *arg;               /**< Argument passed to the function */
+} tsessionOptions;
+
+/**
+ * Opaque structure to represent the state of the detection of stops of a
+ * stream of temporal point instants
+ */
+typedef struct StopsState StopsState;
+
+/**
+ * Opaque structure to represent the state of the transformation of temporal
+ * points into the same Mapbox Vector Tile
+ */
+typedef struct MVTState MVTState;
+
+/**
+ * Opaque structure to represent the state of the evaluation of the entering
+ * and exiting of many moving objects into and from a set of zones
+ */
+typedef struct GeofenceState GeofenceState;
+
+/**
+ * Enumeration that defines the events of a geofence
+ */
+typedef enum
+{
+  TGEOFENCE_ENTER,     /**< The object enters the zone */
+  TGEOFENCE_EXIT,      /**< The object exits the zone */
+} tgeofenceEvent;
+
+/* Definition of the function receiving the events of a geofence */
+typedef void (*tgeofence_event_fn)(int64 id, int zone, tgeofenceEvent event,
+  TimestampTz t, void *arg);
+
+/**
+ * Structure to represent an edge of the road network of the BerlinMOD data
+ * generator
+ */
+typedef struct
+{
+  int64 source;            /**< Identifier of the start node */
+  int64 target;            /**< Identifier of the end node */
+  const GSERIALIZED *geom; /**< Line from the start node to the end node */
+  double maxspeed;         /**< Maximum speed in km/h */
+  int category;            /**< Road category: 0 for side roads, 1 for main
+                                roads, and 2 for freeways */
+  bool oneway;             /**< True when the edge can only be traversed
+                                from the start node to the end node */
+} berlinmodEdge;
+
+/**
+ * Structure to represent the options of the BerlinMOD data generator
+ */
+typedef struct
+{
+  double scalefactor;      /**< Scale factor of the benchmark */
+  int nvehicles;           /**< Number of vehicles, 0 to derive it from the
+                                scale factor */
+  int ndays;               /**< Number of days, 0 to derive it from the
+                                scale factor */
+  TimestampTz startday;    /**< Start of the first day */
+  unsigned long seed;      /**< Seed of the random generators */
+  bool disturb;            /**< True to disturb the positions to simulate GPS
+                                errors */
+  int nthreads;            /**< Number of threads, 0 for the default */
+} berlinmodOptions;
+
+/* Definition of the function receiving the trips of the BerlinMOD data
+ * generator, which returns false to stop the generation */
+typedef bool (*berlinmod_trip_fn)(int vehicle, int day, int seq,
+  TSequence *trip, void *arg);
+
 /*****************************************************************************/
 
 /**
  * Structure to represent skiplist elements
+ *
+ * The forward links of an element are allocated according to its height,
+ * except for the head and the tail whose height may grow up to
+ * SKIPLIST_MAXLEVEL.
  */
 
 #define SKIPLIST_MAXLEVEL 32  /**< maximum possible is 47 with current RNG */
@@ -276,7 +510,7 @@ typedef struct
 {
   void *value;
   int height;
-  int next[SKIPLIST_MAXLEVEL];
+  int *next;
 } SkipListElem;
 
 /**
@@ -294,8 +528,124 @@ typedef struct
   void *extra;
   size_t extrasize;
   SkipListElem *elems;
+  int tailpred[SKIPLIST_MAXLEVEL]; /**< Predecessors of the tail per level */
+  bool tailpred_valid;             /**< True if tailpred is up to date */
 } SkipList;
 
+/**
+ * Structure to represent the state of the approximate temporal distinct count
+ * aggregation, which keeps a HyperLogLog sketch per time bucket
+ *
+ * The state is a flat varlena value so that it can be serialized by copying.
+ * It is followed by the time buckets in time order, each one composed of its
+ * start timestamp followed by the registers of its sketch.
+ */
+
+#define HLL_PRECISION 10  /**< number of bits of the register index */
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+typedef struct
+{
+  int32 vl_len_;         /**< Varlena header (do not touch directly!) */
+  int32 count;           /**< Number of time buckets */
+  int32 capacity;        /**< Number of time buckets allocated */
+  int32 precision;       /**< Precision of the sketches */
+  int64 tunits;          /**< Size of the time buckets in microseconds */
+  TimestampTz torigin;   /**< Origin of the time buckets */
+} TcountDistinctState;
+
+/**
+ * Structure to represent the state of the tile density aggregation, which
+ * keeps the density of each tile of the grid in a hash table
+ */
+typedef struct
+{
+  double xsize;          /**< Size of the tiles in the X dimension */
+  double ysize;          /**< Size of the tiles in the Y dimension */
+  int64 tunits;          /**< Size of the tiles in the T dimension, 0 if none */
+  double xorigin;        /**< Origin of the grid in the X dimension */
+  double yorigin;        /**< Origin of the grid in the Y dimension */
+  TimestampTz torigin;   /**< Origin of the grid in the T dimension */
+  int32 srid;            /**< SRID of the grid */
+  int64 ntemps;          /**< Number of temporal points aggregated */
+  void *table;           /**< Hash table of the tile densities */
+} TileDensityState;
+
+/**
+ * Structure to represent a spatial and possibly temporal grid, which keeps
+ * the validated parameters of the grid so that it can be created once and
+ * used for splitting or tiling many temporal points. The set of tiles
+ * traversed by a temporal point is kept in the grid and reused across the
+ * temporal points.
+ */
+typedef struct
+{
+  double xsize;          /**< Size of the tiles in the X dimension */
+  double ysize;          /**< Size of the tiles in the Y dimension */
+  double zsize;          /**< Size of the tiles in the Z dimension */
+  int64 tunits;          /**< Size of the tiles in the T dimension, 0 if none */
+  double xorigin;        /**< Origin of the grid in the X dimension */
+  double yorigin;        /**< Origin of the grid in the Y dimension */
+  double zorigin;        /**< Origin of the grid in the Z dimension, if any */
+  TimestampTz torigin;   /**< Origin of the grid in the T dimension */
+  int32 srid;            /**< SRID of the spatial origin */
+  uint8 gflags;          /**< Flags of the spatial origin */
+  void *tiles;           /**< Set of tiles reused across the temporal points */
+} STBoxGrid;
+
+/**
+ * Structure to represent the density of a tile
+ */
+typedef struct
+{
+  double x;              /**< Minimum X value of the tile */
+  double y;              /**< Minimum Y value of the tile */
+  TimestampTz t;         /**< Minimum T value of the tile, if any */
+  int64 count;           /**< Number of temporal points traversing the tile */
+  int64 duration;        /**< Time spent in the tile in microseconds */
+  double distance;       /**< Distance traveled in the tile */
+} TileDensity;
+
+/**
+ * Structure to represent a run of the temporal centroid aggregation, that is,
+ * a maximal sequence of consecutive instants of the state
+ */
+typedef struct
+{
+  int start;             /**< Position of the first instant of the run */
+  int count;             /**< Number of instants of the run */
+  bool lower_inc;        /**< True if the lower bound of the run is inclusive */
+  bool upper_inc;        /**< True if the upper bound of the run is inclusive */
+} TCentroidRun;
+
+/**
+ * Structure to represent the state of the temporal centroid aggregation
+ *
+ * The instants are kept in time order in columns storing their timestamps
+ * and the sums of the X, Y, and Z coordinates and of the number of points,
+ * the runs being time-disjoint. The Z column is only used when the points
+ * have Z dimension.
+ *
+ * This state replaces the skiplist previously used by the temporal centroid
+ * aggregation, and thus the functions tpoint_tcentroid_transfn() and
+ * tpoint_tcentroid_finalfn() no longer take or return a @p SkipList. The
+ * final function does not free the state, which must be freed with
+ * tcentroid_state_free().
+ */
+typedef struct
+{
+  int32 srid;            /**< SRID of the points */
+  bool hasz;             /**< True if the points have Z dimension */
+  interpType interp;     /**< Interpolation of the runs */
+  int nruns;             /**< Number of runs */
+  int maxruns;           /**< Number of runs allocated */
+  int count;             /**< Number of instants */
+  int maxcount;          /**< Number of instants allocated */
+  TCentroidRun *runs;    /**< Runs in time order */
+  TimestampTz *times;    /**< Column of the timestamps */
+  double *sums[4];       /**< Columns of the sums of X, Y, Z, and points */
+} TCentroidState;
+
 /*****************************************************************************
  * Error codes
  *****************************************************************************/
@@ -336,6 +686,8 @@ extern int meos_errno(void);
 extern int meos_errno_set(int err);
 extern int meos_errno_restore(int err);
 extern int meos_errno_reset(void);
+extern bool meos_error_quiet(void);
+extern bool meos_error_quiet_set(bool quiet);
 
 /*****************************************************************************
  * Initialization of the MEOS library
@@ -345,6 +697,8 @@ extern int meos_errno_reset(void);
 typedef void (*error_handler_fn)(int, int, char *);
 
 extern void meos_initialize_timezone(const char *name);
+extern void meos_initialize_timezone_thread(const char *name);
+extern void meos_initialize_timezone_lazy(const char *name);
 extern void meos_initialize_error_handler(error_handler_fn err_handler);
 extern void meos_finalize_timezone(void);
 
@@ -352,9 +706,140 @@ extern bool meos_set_datestyle(char *newval, void *extra);
 extern bool meos_set_intervalstyle(char *newval, int extra);
 extern char *meos_get_datestyle(void);
 extern char *meos_get_intervalstyle(void);
+extern void meos_set_fast_geodetic(bool value);
+extern bool meos_get_fast_geodetic(void);
+
+/**
+ * @brief Enumeration that defines the runtime statistics kept by MEOS
+ */
+typedef enum
+{
+  MEOS_STAT_LIFTED_INSTANTS =   0,  /**< Instants of the arguments of lifted functions */
+  MEOS_STAT_SKIPLIST_SPLICES =  1,  /**< Splices into aggregation skiplists */
+  MEOS_STAT_SKIPLIST_ELEMENTS = 2,  /**< Elements spliced into skiplists */
+  MEOS_STAT_INDEX_CONSISTENT =  3,  /**< Calls to the index consistent methods */
+  MEOS_STAT_INDEX_RECHECKS =    4,  /**< Index matches that must be rechecked */
+  MEOS_STAT_DETOAST_BYTES =     5,  /**< Bytes of detoasted temporal arguments */
+  MEOS_STAT_GEOS_CONVERSIONS =  6,  /**< Conversions from and to GEOS */
+  MEOS_STAT_ROUTE_CACHE_HITS =  7,  /**< Route lookups found in the cache */
+  MEOS_STAT_ROUTE_CACHE_MISSES = 8, /**< Route lookups read from the table */
+} meosStat;
+
+#define MEOS_STAT_NUMBER  (MEOS_STAT_ROUTE_CACHE_MISSES + 1)
+
+extern void meos_set_track_stats(bool value);
+extern bool meos_get_track_stats(void);
+extern const char *meos_stat_name(meosStat stat);
+extern int64 meos_stat_value(meosStat stat);
+extern void meos_stats_reset(void);
+
+/**
+ * @brief Enumeration that defines the families of entry points of MEOS whose
+ * calls are timed when the runtime statistics are tracked
+ */
+typedef enum
+{
+  MEOS_FAMILY_CONSTRUCTOR =   0,  /**< Constructors of temporal values */
+  MEOS_FAMILY_IO =            1,  /**< Input and output of temporal values */
+  MEOS_FAMILY_LIFTING =       2,  /**< Lifted functions */
+  MEOS_FAMILY_RESTRICTION =   3,  /**< Restriction functions */
+  MEOS_FAMILY_TILING =        4,  /**< Split functions */
+  MEOS_FAMILY_AGGREGATION =   5,  /**< Temporal aggregation */
+  MEOS_FAMILY_SIMILARITY =    6,  /**< Similarity distances */
+} meosFamily;
+
+#define MEOS_FAMILY_NUMBER  (MEOS_FAMILY_SIMILARITY + 1)
+
+/* Number of buckets of the histograms of the duration of the calls */
+#define MEOS_STATS_HIST_SIZE  16
+
+/**
+ * @brief Structure to represent the statistics of a family of entry points
+ * @details Bucket 0 of the histogram counts the calls that took less than
+ * one microsecond, bucket i > 0 the calls that took between 2^(i-1) and 2^i
+ * microseconds, and the last bucket all the longer calls.
+ */
+typedef struct
+{
+  int64 calls;                      /**< Number of calls */
+  int64 nsecs;                      /**< Cumulative time in nanoseconds */
+  int64 bytes;                      /**< Bytes allocated during the calls */
+  int64 hist[MEOS_STATS_HIST_SIZE]; /**< Number of calls per duration */
+} meosFamilyStats;
+
+/**
+ * @brief Structure to represent a snapshot of the runtime statistics
+ */
+typedef struct
+{
+  int64 counters[MEOS_STAT_NUMBER];                /**< Counters */
+  meosFamilyStats families[MEOS_FAMILY_NUMBER];    /**< Timed entry points */
+} meosStats;
+
+extern void meos_stats_enable(bool value);
+extern const char *meos_family_name(meosFamily family);
+extern bool meos_stats_snapshot(meosStats *result);
+extern char *meos_stats_as_json(const meosStats *stats);
 
 extern void meos_initialize(const char *tz_str, error_handler_fn err_handler);
 extern void meos_finalize(void);
+extern void meos_initialize_thread(const char *tz_str);
+extern void meos_finalize_thread(void);
+
+/* Definition of the allocation functions */
+typedef void *(*meos_alloc_fn)(void *ctx, size_t size);
+typedef void *(*meos_realloc_fn)(void *ctx, void *ptr, size_t size);
+typedef void (*meos_free_fn)(void *ctx, void *ptr);
+
+extern void meos_set_allocator(meos_alloc_fn alloc_fn,
+  meos_realloc_fn realloc_fn, meos_free_fn free_fn, void *ctx);
+extern void meos_region_begin(void);
+extern void meos_region_end(void);
+
+/*****************************************************************************
+ * Parallel batch functions
+ *****************************************************************************/
+
+/**
+ * Structure to represent the options of the parallel batch functions
+ */
+typedef struct
+{
+  int nthreads;        /**< Number of threads, 0 for the number of processors */
+  int chunksize;       /**< Number of values taken at once by a thread, 0 for
+                            the default */
+  void *arg;           /**< Argument passed to the function */
+} meosBatchOptions;
+
+/* Definition of the functions applied by the batch functions */
+typedef Temporal *(*meos_batch_temporal_fn)(const Temporal *temp, void *arg);
+typedef double (*meos_batch_double_fn)(const Temporal *temp, void *arg);
+typedef void *(*meos_batch_array_fn)(const Temporal *temp, void *arg,
+  int *count);
+
+/**
+ * Enumeration for the temporal aggregates computed by the batch functions
+ */
+typedef enum
+{
+  BATCH_AGG_TCOUNT,
+  BATCH_AGG_TAND,
+  BATCH_AGG_TOR,
+  BATCH_AGG_TMIN,
+  BATCH_AGG_TMAX,
+  BATCH_AGG_TSUM,
+  BATCH_AGG_TAVG,
+  BATCH_AGG_TCENTROID,
+} meosBatchAgg;
+
+extern bool meos_batch_map(meos_batch_temporal_fn fn, const Temporal **in, Temporal **out, int n, const meosBatchOptions *opts);
+extern bool meos_batch_map_double(meos_batch_double_fn fn, const Temporal **in, double *out, int n, const meosBatchOptions *opts);
+extern bool meos_batch_map_array(meos_batch_array_fn fn, const Temporal **in, void **out, int *counts, int n, const meosBatchOptions *opts);
+extern Temporal *meos_batch_aggregate(meosBatchAgg agg, const Temporal **in, int n, const meosBatchOptions *opts);
+
+/* Definition of the callback receiving the chunks of the streaming writers,
+ * which returns false to stop the output */
+typedef bool (*meos_write_fn)(const char *data, size_t size, void *arg);
 
 /*===========================================================================*
  * Functions for PostgreSQL types
@@ -757,12 +1242,19 @@ extern bool contains_spanset_int(const SpanSet *ss, int i);
 extern bool contains_spanset_span(const SpanSet *ss, const Span *s);
 extern bool contains_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2);
 extern bool contains_spanset_timestamptz(const SpanSet *ss, TimestampTz t);
+extern bool *contains_spanset_timestamptzarr(const SpanSet *ss, const TimestampTz *times, int count);
 extern bool overlaps_set_set(const Set *s1, const Set *s2);
 extern bool overlaps_span_span(const Span *s1, const Span *s2);
 extern bool overlaps_span_spanset(const Span *s, const SpanSet *ss);
 extern bool overlaps_spanset_span(const SpanSet *ss, const Span *s);
 extern bool overlaps_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2);
 
+/* Definition of the function receiving the pairs of the interval joins,
+ * which returns false to stop the join */
+typedef bool (*meos_join_fn)(int i, int j, void *arg);
+
+extern int tstzspan_overlap_join(const Span *spans1, int count1, const Span *spans2, int count2, meos_join_fn fn, void *arg);
+
 /*****************************************************************************/
 
 /* Position functions for set and span types */
@@ -1088,9 +1580,15 @@ extern SpanSet *span_union_transfn(SpanSet *state, const Span *s);
 extern Span *spanset_extent_transfn(Span *state, const SpanSet *ss);
 extern SpanSet *spanset_union_finalfn(SpanSet *state);
 extern SpanSet *spanset_union_transfn(SpanSet *state, const SpanSet *ss);
+extern SpanSet *spanset_state_finish(SpansetState *state);
+extern void spanset_state_free(SpansetState *state);
+extern SpansetState *spanset_state_make(int maxcount);
+extern bool spanset_state_push(SpansetState *state, const Span *s);
+extern bool spanset_state_push_spanset(SpansetState *state, const SpanSet *ss);
 extern Set *text_union_transfn(Set *state, const text *txt);
 extern Span *timestamptz_extent_transfn(Span *state, TimestampTz t);
 extern Set *timestamptz_union_transfn(Set *state, TimestampTz t);
+extern bool tstzspanset_state_push_tbool(SpansetState *state, const Temporal *temp);
 
 /*===========================================================================*
  * Functions for box types
@@ -1205,6 +1703,7 @@ extern STBox *stbox_set_srid(const STBox *box, int32 srid);
 extern STBox *stbox_shift_scale_time(const STBox *box, const Interval *shift, const Interval *duration);
 extern STBox *stbox_transform(const STBox *box, int32 srid);
 extern STBox *stbox_transform_pipeline(const STBox *box, char *pipelinestr, int32 srid, bool is_forward);
+extern STBox *stboxarr_balanced_split(const STBox *boxes, const double *weights, int count, int k, int *newcount);
 extern TBox *tbox_expand_time(const TBox *box, const Interval *interv);
 extern TBox *tbox_expand_float(const TBox *box, const double d);
 extern TBox *tbox_expand_int(const TBox *box, const int i);
@@ -1309,6 +1808,9 @@ extern Temporal *tgeompoint_from_mfjson(const char *str);
 extern Temporal *tgeogpoint_from_mfjson(const char *str);
 extern Temporal *temporal_from_wkb(const uint8_t *wkb, size_t size);
 extern Temporal *temporal_from_hexwkb(const char *hexwkb);
+extern int temporal_from_wkb_bulk(const uint8_t *wkb, size_t size, meosArena *arena, Temporal **result, int count, size_t *consumed);
+extern int temporal_from_hexwkb_bulk(const char *hexwkb, size_t size, meosArena *arena, Temporal **result, int count, size_t *consumed);
+extern Temporal **tpoint_from_csv(const char *filename, const tpointCsvOptions *options, int64 **ids, int *count);
 
 extern char *tbool_out(const Temporal *temp);
 extern char *tint_out(const Temporal *temp);
@@ -1320,6 +1822,32 @@ extern char *tpoint_as_ewkt(const Temporal *temp, int maxdd);
 extern char *temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags, int precision, char *srs);
 extern uint8_t *temporal_as_wkb(const Temporal *temp, uint8_t variant, size_t *size_out);
 extern char *temporal_as_hexwkb(const Temporal *temp, uint8_t variant, size_t *size_out);
+extern uint8_t *temporal_delta_since(const Temporal *temp, TimestampTz t, uint8_t variant, size_t *size_out);
+extern bool temporal_as_mfjson_write(const Temporal *temp, bool with_bbox, int precision, char *srs, meos_write_fn write, void *arg);
+extern bool temporal_as_wkb_write(const Temporal *temp, uint8_t variant, meos_write_fn write, void *arg);
+extern bool temporal_as_mfjson_file(const Temporal *temp, bool with_bbox, int precision, char *srs, FILE *file);
+extern bool temporal_as_wkb_file(const Temporal *temp, uint8_t variant, FILE *file);
+
+extern bool tcontainer_write(const char *filename, const Temporal **temps, int count, bool native);
+extern TContainer *tcontainer_open(const char *filename);
+extern void tcontainer_close(TContainer *cont);
+extern int tcontainer_count(const TContainer *cont);
+extern Temporal *tcontainer_get(const TContainer *cont, int n);
+extern const Temporal *tcontainer_view(const TContainer *cont, int n);
+extern int *tcontainer_filter_tstzspan(const TContainer *cont, const Span *s, int *count);
+extern int *tcontainer_filter_tbox(const TContainer *cont, const TBox *box, int *count);
+extern int *tcontainer_filter_stbox(const TContainer *cont, const STBox *box, int *count);
+
+extern TStore *tstore_make(size_t maxslack);
+extern void tstore_free(TStore *store);
+extern int tstore_add(TStore *store, const Temporal *temp);
+extern bool tstore_append(TStore *store, int handle, const TInstant *inst, double maxdist, const Interval *maxt);
+extern bool tstore_remove(TStore *store, int handle);
+extern int tstore_count(const TStore *store);
+extern const Temporal *tstore_view(const TStore *store, int handle);
+extern int *tstore_search_tstzspan(TStore *store, const Span *s, int *count);
+extern int *tstore_search_stbox(TStore *store, const STBox *box, int *count);
+extern int *tstore_knn_geo(TStore *store, const GSERIALIZED *gs, int k, int *count);
 
 /*****************************************************************************
  * Constructor functions for temporal types
@@ -1347,6 +1875,7 @@ extern TSequence *tpointseq_from_base_tstzspan(const GSERIALIZED *gs, const Span
 extern TSequence *tpointseq_from_base_tstzset(const GSERIALIZED *gs, const Set *s);
 extern TSequenceSet *tpointseqset_from_base_tstzspanset(const GSERIALIZED *gs, const SpanSet *ss, interpType interp);
 extern TSequence *tsequence_make(const TInstant **instants, int count, bool lower_inc, bool upper_inc, interpType interp, bool normalize);
+extern int tsequence_make_try(const TInstant **instants, int count, bool lower_inc, bool upper_inc, interpType interp, bool normalize, TSequence **result);
 extern TSequenceSet *tsequenceset_make(const TSequence **sequences, int count, bool normalize);
 extern TSequenceSet *tsequenceset_make_gaps(const TInstant **instants, int count, interpType interp, Interval *maxt, double maxdist);
 extern Temporal *ttext_from_base_temp(const text *txt, const Temporal *temp);
@@ -1378,6 +1907,7 @@ extern TInstant *temporal_end_instant(const Temporal *temp);
 extern TSequence *temporal_end_sequence(const Temporal *temp);
 extern TimestampTz temporal_end_timestamptz(const Temporal *temp);
 extern uint32 temporal_hash(const Temporal *temp);
+extern uint64 temporal_hash_extended(const Temporal *temp, uint64 seed);
 extern TInstant *temporal_instant_n(const Temporal *temp, int n);
 extern TInstant **temporal_instants(const Temporal *temp, int *count);
 extern const char *temporal_interp(const Temporal *temp);
@@ -1395,6 +1925,9 @@ extern TInstant *temporal_start_instant(const Temporal *temp);
 extern TSequence *temporal_start_sequence(const Temporal *temp);
 extern TimestampTz temporal_start_timestamptz(const Temporal *temp);
 extern TSequenceSet *temporal_stops(const Temporal *temp, double maxdist, const Interval *minduration);
+extern TSequence *tstops_state_finish(StopsState *state);
+extern StopsState *tstops_state_make(double maxdist, const Interval *minduration);
+extern TSequence *tstops_state_push(StopsState *state, const TInstant *inst);
 extern const char *temporal_subtype(const Temporal *temp);
 extern SpanSet *temporal_time(const Temporal *temp);
 extern bool temporal_timestamptz_n(const Temporal *temp, int n, TimestampTz *result);
@@ -1406,6 +1939,7 @@ extern double tfloat_start_value(const Temporal *temp);
 extern bool tfloat_value_at_timestamptz(const Temporal *temp, TimestampTz t, bool strict, double *value);
 extern bool tfloat_value_n(const Temporal *temp, int n, double *result);
 extern double *tfloat_values(const Temporal *temp, int *count);
+extern int tfloat_values_at_timestamps(const Temporal *temp, const TimestampTz *times, int count, bool strict, const double *slopes, double *values, bool *found);
 extern int tint_end_value(const Temporal *temp);
 extern int tint_max_value(const Temporal *temp);
 extern int tint_min_value(const Temporal *temp);
@@ -1415,12 +1949,15 @@ extern bool tint_value_n(const Temporal *temp, int n, int *result);
 extern int *tint_values(const Temporal *temp, int *count);
 extern double tnumber_integral(const Temporal *temp);
 extern double tnumber_twavg(const Temporal *temp);
+extern double tnumber_twavg_at_tstzspan(const Temporal *temp, const Span *s);
 extern SpanSet *tnumber_valuespans(const Temporal *temp);
+extern int tpoint_coords_at_timestamps(const Temporal *temp, const TimestampTz *times, int count, bool strict, const double *slopes, double *coords, bool *found);
 extern GSERIALIZED *tpoint_end_value(const Temporal *temp);
 extern GSERIALIZED *tpoint_start_value(const Temporal *temp);
 extern bool tpoint_value_at_timestamptz(const Temporal *temp, TimestampTz t, bool strict, GSERIALIZED **value);
 extern bool tpoint_value_n(const Temporal *temp, int n, GSERIALIZED **result);
 extern GSERIALIZED **tpoint_values(const Temporal *temp, int *count);
+extern double *temporal_segment_slopes(const Temporal *temp, int *count);
 extern text *ttext_end_value(const Temporal *temp);
 extern text *ttext_max_value(const Temporal *temp);
 extern text *ttext_min_value(const Temporal *temp);
@@ -1453,6 +1990,7 @@ extern Temporal **tfloatarr_round(const Temporal **temp, int count, int maxdd);
 extern Temporal *tint_scale_value(const Temporal *temp, int width);
 extern Temporal *tint_shift_scale_value(const Temporal *temp, int shift, int width);
 extern Temporal *tint_shift_value(const Temporal *temp, int shift);
+extern Temporal *tpoint_coords_pipeline(const Temporal *temp, const CoordOp *ops, int count, bool filter_pts);
 extern Temporal *tpoint_round(const Temporal *temp, int maxdd);
 extern Temporal *tpoint_transform(const Temporal *temp, int32 srid);
 extern Temporal *tpoint_transform_pipeline(const Temporal *temp, char *pipelinestr, int32 srid, bool is_forward);
@@ -1465,7 +2003,18 @@ extern Temporal **tpointarr_round(const Temporal **temp, int count, int maxdd);
  *****************************************************************************/
 
 extern Temporal *temporal_append_tinstant(Temporal *temp, const TInstant *inst, double maxdist, Interval *maxt, bool expand);
+extern int temporal_append_tinstant_try(Temporal *temp, const TInstant *inst, double maxdist, Interval *maxt, bool expand, Temporal **result);
+extern SessionState *tsession_state_make(const tsessionOptions *opts);
+extern bool tsession_state_push(SessionState *state, int64 id, const TInstant *inst);
+extern int tsession_state_flush_idle(SessionState *state, TimestampTz t);
+extern int tsession_state_count(const SessionState *state);
+extern size_t tsession_state_memsize(const SessionState *state);
+extern void tsession_state_finish(SessionState *state);
+extern ReorderState *treorder_state_make(const Interval *lateness, int maxinsts, interpType interp);
+extern bool treorder_state_push(ReorderState *state, const TInstant *inst);
+extern TSequence *treorder_state_finish(ReorderState *state);
 extern Temporal *temporal_append_tsequence(Temporal *temp, const TSequence *seq, bool expand);
+extern Temporal *temporal_apply_delta(Temporal *temp, const uint8_t *delta, size_t size, bool expand);
 extern Temporal *temporal_delete_tstzspan(const Temporal *temp, const Span *s, bool connect);
 extern Temporal *temporal_delete_tstzspanset(const Temporal *temp, const SpanSet *ss, bool connect);
 extern Temporal *temporal_delete_timestamptz(const Temporal *temp, TimestampTz t, bool connect);
@@ -1759,6 +2308,10 @@ extern bool same_tpoint_stbox(const Temporal *temp, const STBox *box);
 extern bool same_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
 extern bool same_tstzspan_temporal(const Span *s, const Temporal *temp);
 
+/* Interval join functions for temporal types */
+extern int temporal_overlap_join(const Temporal **temps1, int count1, const Temporal **temps2, int count2, bool bbox, meos_join_fn fn, void *arg);
+extern int *temporal_overlap_join_pairs(const Temporal **temps1, int count1, const Temporal **temps2, int count2, bool bbox, int *count);
+
 /*****************************************************************************/
 
 /* Position box functions for temporal types */
@@ -1908,6 +2461,8 @@ extern Temporal *textcat_ttext_ttext(const Temporal *temp1, const Temporal *temp
 extern Temporal *ttext_upper(const Temporal *temp);
 extern Temporal *ttext_lower(const Temporal *temp);
 extern Temporal *ttext_initcap(const Temporal *temp);
+extern Temporal *ttext_dict_encode(const Temporal *temp, const Set *dict);
+extern Temporal *tint_dict_decode(const Temporal *temp, const Set *dict);
 
 /*****************************************************************************
  * Distance functions for temporal types
@@ -1931,10 +2486,13 @@ extern double nad_tboxfloat_tboxfloat(const TBox *box1, const TBox *box2);
 extern double nad_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 extern double nad_tpoint_stbox(const Temporal *temp, const STBox *box);
 extern double nad_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
+extern int nad_tpoint_tpoint_lt(const Temporal *temp1, const Temporal *temp2, double dist);
 extern TInstant *nai_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 extern TInstant *nai_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
 extern GSERIALIZED *shortestline_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 extern GSERIALIZED *shortestline_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
+extern SpanSet **tpointarr_knn(const Temporal *temp, const Temporal **temparr, int count, int k);
+extern int *tpoint_coords_dwithin_pairs(const double *xcoords, const double *ycoords, const TimestampTz *times, const int *offsets, int count, double dist, const Span *period, double **nad, int *npairs);
 
 /*****************************************************************************
  * Spatial functions for temporal points
@@ -1956,6 +2514,7 @@ extern Temporal *tpoint_get_y(const Temporal *temp);
 extern Temporal *tpoint_get_z(const Temporal *temp);
 extern bool tpoint_is_simple(const Temporal *temp);
 extern double tpoint_length(const Temporal *temp);
+extern double tpoint_length_at_tstzspan(const Temporal *temp, const Span *s);
 extern Temporal *tpoint_speed(const Temporal *temp);
 extern int tpoint_srid(const Temporal *temp);
 extern GSERIALIZED *tpoint_trajectory(const Temporal *temp);
@@ -1970,6 +2529,9 @@ extern Temporal *geomeas_to_tpoint(const GSERIALIZED *gs);
 extern Temporal *tgeogpoint_to_tgeompoint(const Temporal *temp);
 extern Temporal *tgeompoint_to_tgeogpoint(const Temporal *temp);
 bool tpoint_AsMVTGeom(const Temporal *temp, const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom, GSERIALIZED **gsarr, int64 **timesarr, int *count);
+extern bool tpoint_mvt_state_eq(const MVTState *state, const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom);
+extern MVTState *tpoint_mvt_state_make(const STBox *bounds, int32_t extent, int32_t buffer, bool clip_geom);
+extern bool tpoint_mvt_state_push(const MVTState *state, const Temporal *temp, GSERIALIZED **gsarr, int64 **timesarr, int *count);
 extern STBox *tpoint_expand_space(const Temporal *temp, double d);
 extern Temporal **tpoint_make_simple(const Temporal *temp, int *count);
 extern Temporal *tpoint_set_srid(const Temporal *temp, int32 srid);
@@ -1993,6 +2555,7 @@ extern int edisjoint_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
 extern int edwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist);
 extern int edwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2, double dist);
 extern int eintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
+extern int eintersects_tpoint_span_stbox_geo(const Temporal *temp, const Span *s, const STBox *box, const GSERIALIZED *gs);
 extern int eintersects_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2);
 extern int etouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs);
 
@@ -2005,10 +2568,23 @@ extern Temporal *tdisjoint_tpoint_geo(const Temporal *temp, const GSERIALIZED *g
 extern Temporal *tdisjoint_tpoint_tpoint (const Temporal *temp1, const Temporal *temp2, bool restr, bool atvalue);
 extern Temporal *tdwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist, bool restr, bool atvalue);
 extern Temporal *tdwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2, double dist, bool restr, bool atvalue);
+extern int tdwithin_tpointarr_tpointarr(const Temporal **temparr1, int count1, const Temporal **temparr2, int count2, double dist, int **idx1, int **idx2, SpanSet ***spansets);
 extern Temporal *tintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool restr, bool atvalue);
+extern SpanSet **tintersects_tpoint_geoarr(const Temporal *temp, const GSERIALIZED **gsarr, int count);
 extern Temporal *tintersects_tpoint_tpoint (const Temporal *temp1, const Temporal *temp2, bool restr, bool atvalue);
 extern Temporal *ttouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool restr, bool atvalue);
 
+extern bool tgeofence_state_entered(const GeofenceState *state, int64 id, int zone, TimestampTz t, const Interval *window);
+extern void tgeofence_state_free(GeofenceState *state);
+extern bool tgeofence_state_inside(const GeofenceState *state, int64 id, int zone);
+extern GeofenceState *tgeofence_state_make(const GSERIALIZED **zones, int count, interpType interp, tgeofence_event_fn event, void *arg);
+extern int tgeofence_state_push(GeofenceState *state, int64 id, const TInstant *inst);
+extern bool tgeofence_state_remove(GeofenceState *state, int64 id);
+
+/* Data generation for temporal points */
+
+extern int berlinmod_generate(const berlinmodEdge *edges, int count, const berlinmodOptions *opts, berlinmod_trip_fn trip_fn, void *arg);
+
 /*****************************************************************************
  * Aggregate functions for temporal types
  *****************************************************************************/
@@ -2016,7 +2592,14 @@ extern Temporal *ttouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs
 extern SkipList *tbool_tand_transfn(SkipList *state, const Temporal *temp);
 extern SkipList *tbool_tor_transfn(SkipList *state, const Temporal *temp);
 extern Span *temporal_extent_transfn(Span *s, const Temporal *temp);
+extern SkipList *temporal_tagg_expire(SkipList *state, TimestampTz t);
 extern Temporal *temporal_tagg_finalfn(SkipList *state);
+extern Temporal *temporal_tcount_approx_error_finalfn(SkipList *state);
+extern Temporal *temporal_tcount_approx_finalfn(SkipList *state);
+extern SkipList *temporal_tcount_approx_transfn(SkipList *state, const Temporal *temp, double fraction, const Interval *duration, TimestampTz torigin);
+extern TcountDistinctState *temporal_tcount_distinct_combinefn(TcountDistinctState *state1, const TcountDistinctState *state2);
+extern Temporal *temporal_tcount_distinct_finalfn(const TcountDistinctState *state);
+extern TcountDistinctState *temporal_tcount_distinct_transfn(TcountDistinctState *state, int64 id, const Temporal *temp, const Interval *duration, TimestampTz torigin);
 extern SkipList *temporal_tcount_transfn(SkipList *state, const Temporal *temp);
 extern SkipList *tfloat_tmax_transfn(SkipList *state, const Temporal *temp);
 extern SkipList *tfloat_tmin_transfn(SkipList *state, const Temporal *temp);
@@ -2033,11 +2616,25 @@ extern SkipList *tint_wmin_transfn(SkipList *state, const Temporal *temp, const
 extern SkipList *tint_wsum_transfn(SkipList *state, const Temporal *temp, const Interval *interv);
 extern TBox *tnumber_extent_transfn(TBox *box, const Temporal *temp);
 extern Temporal *tnumber_tavg_finalfn(SkipList *state);
+extern Temporal *tnumber_tavg_approx_error_finalfn(SkipList *state);
+extern Temporal *tnumber_tavg_approx_finalfn(SkipList *state);
+extern SkipList *tnumber_tavg_approx_transfn(SkipList *state, const Temporal *temp, double fraction, const Interval *duration, TimestampTz torigin);
 extern SkipList *tnumber_tavg_transfn(SkipList *state, const Temporal *temp);
 extern SkipList *tnumber_wavg_transfn(SkipList *state, const Temporal *temp, const Interval *interv);
+extern Temporal *tnumber_wavg(const Temporal *temp, const Interval *interv);
+extern Temporal *tnumber_wcount(const Temporal *temp, const Interval *interv);
+extern Temporal *tnumber_wmax(const Temporal *temp, const Interval *interv);
+extern Temporal *tnumber_wmin(const Temporal *temp, const Interval *interv);
+extern Temporal *tnumber_wsum(const Temporal *temp, const Interval *interv);
 extern STBox *tpoint_extent_transfn(STBox *box, const Temporal *temp);
-extern Temporal *tpoint_tcentroid_finalfn(SkipList *state);
-extern SkipList *tpoint_tcentroid_transfn(SkipList *state, Temporal *temp);
+extern TCentroidState *tpoint_tcentroid_combinefn(TCentroidState *state1, TCentroidState *state2);
+extern Temporal *tpoint_tcentroid_finalfn(const TCentroidState *state);
+extern TCentroidState *tpoint_tcentroid_transfn(TCentroidState *state, const Temporal *temp);
+extern TCentroidState *tcentroid_state_deserialize(const char *buf, size_t size);
+extern TCentroidState *tcentroid_state_expire(TCentroidState *state, TimestampTz t);
+extern void tcentroid_state_free(TCentroidState *state);
+extern void tcentroid_state_serialize(const TCentroidState *state, char *buf);
+extern size_t tcentroid_state_serialize_size(const TCentroidState *state);
 extern SkipList *tstzset_tcount_transfn(SkipList *state, const Set *s);
 extern SkipList *tstzspan_tcount_transfn(SkipList *state, const Span *s);
 extern SkipList *tstzspanset_tcount_transfn(SkipList *state, const SpanSet *ss);
@@ -2051,9 +2648,21 @@ extern SkipList *ttext_tmin_transfn(SkipList *state, const Temporal *temp);
 /* Simplification functions for temporal types */
 
 Temporal *temporal_simplify_dp(const Temporal *temp, double eps_dist, bool synchronized);
+Temporal *temporal_simplify_dp_select(const Temporal *temp, const double *weights, int count, double dist);
+double *temporal_simplify_dp_weights(const Temporal *temp, bool syncdist, int *count);
 Temporal *temporal_simplify_max_dist(const Temporal *temp, double eps_dist, bool synchronized);
 Temporal *temporal_simplify_min_dist(const Temporal *temp, double dist);
 Temporal *temporal_simplify_min_tdelta(const Temporal *temp, const Interval *mint);
+Temporal *temporal_simplify_npoints(const Temporal *temp, int npoints, bool synchronized);
+extern SimplifyState *tsimplify_state_make(double dist, bool syncdist, int maxinsts);
+extern TInstant *tsimplify_state_push(SimplifyState *state, const TInstant *inst);
+extern TInstant *tsimplify_state_finish(SimplifyState *state);
+
+/*****************************************************************************/
+
+/* Clustering functions for temporal types */
+
+extern int *tpointarr_stdbscan(const Temporal **temparr, int count, double eps_space, const Interval *eps_time, int minpts, int *nclusters);
 
 /*****************************************************************************/
 
@@ -2061,25 +2670,37 @@ Temporal *temporal_simplify_min_tdelta(const Temporal *temp, const Interval *min
 
 extern Temporal *temporal_tprecision(const Temporal *temp, const Interval *duration, TimestampTz origin);
 extern Temporal *temporal_tsample(const Temporal *temp, const Interval *duration, TimestampTz origin, interpType interp);
+extern double *tnumberarr_tsample_matrix(const Temporal **temparr, int count, const Span *s, const Interval *duration, TimestampTz torigin, TimestampTz *first, int *nbuckets);
 
 /*****************************************************************************/
 
 /* Similarity functions for temporal types */
 
-extern double temporal_dyntimewarp_distance(const Temporal *temp1, const Temporal *temp2);
+extern double temporal_dyntimewarp_distance(const Temporal *temp1, const Temporal *temp2, int band);
+extern bool temporal_dyntimewarp_distance_within(const Temporal *temp1, const Temporal *temp2, double dist, int band);
+extern double temporal_dyntimewarp_lower_bound(const Temporal *temp1, const Temporal *temp2, int band);
 extern Match *temporal_dyntimewarp_path(const Temporal *temp1, const Temporal *temp2, int *count);
-extern double temporal_frechet_distance(const Temporal *temp1, const Temporal *temp2);
+extern double temporal_frechet_distance(const Temporal *temp1, const Temporal *temp2, int band);
+extern bool temporal_frechet_distance_within(const Temporal *temp1, const Temporal *temp2, double dist, int band);
+extern double temporal_frechet_lower_bound(const Temporal *temp1, const Temporal *temp2, int band);
 extern Match *temporal_frechet_path(const Temporal *temp1, const Temporal *temp2, int *count);
 extern double temporal_hausdorff_distance(const Temporal *temp1, const Temporal *temp2);
+extern bool temporal_hausdorff_distance_within(const Temporal *temp1, const Temporal *temp2, double dist);
 
 /*****************************************************************************/
 
 /* Tile functions for temporal types */
 
 extern double float_bucket(double value, double size, double origin);
+extern double *floatarr_bucket(const double *values, int count, double size, double origin);
 extern Span *floatspan_bucket_list(const Span *bounds, double size, double origin, int *count);
 extern int int_bucket(int value, int size, int origin);
+extern int *intarr_bucket(const int *values, int count, int size, int origin);
 extern Span *intspan_bucket_list(const Span *bounds, int size, int origin, int *count);
+extern void stbox_grid_free(STBoxGrid *grid);
+extern STBoxGrid *stbox_grid_make(double xsize, double ysize, double zsize, const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin);
+extern Set *stbox_space_time_tiles(const STBox *bounds, double xsize, double ysize, double zsize, const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin);
+extern int64 stbox_tile_key(const GSERIALIZED *point, TimestampTz t, double xsize, double ysize, double zsize, const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin, bool hast);
 extern STBox *stbox_tile(GSERIALIZED *point, TimestampTz t, double xsize, double ysize, double zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool hast);
 extern STBox *stbox_tile_list(const STBox *bounds, double xsize, double ysize, double zsize, const Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool border_inc, int *count);
 extern Temporal **temporal_time_split(Temporal *temp, Interval *duration, TimestampTz torigin, TimestampTz **time_buckets, int *count);
@@ -2088,12 +2709,33 @@ extern Temporal **tfloat_value_time_split(Temporal *temp, double size, Interval
 extern TBox *tfloatbox_tile(double value, TimestampTz t, double vsize, Interval *duration, double vorigin, TimestampTz torigin);
 extern TBox *tfloatbox_tile_list(const TBox *box, double xsize, const Interval *duration, double xorigin, TimestampTz torigin, int *count);
 extern TimestampTz timestamptz_bucket(TimestampTz timestamp, const Interval *duration, TimestampTz origin);
+extern TimestampTz *timestamptzarr_bucket(const TimestampTz *times, int count, const Interval *duration, TimestampTz origin);
 extern Temporal **tint_value_split(Temporal *temp, int size, int origin, int **value_buckets, int *count);
 extern Temporal **tint_value_time_split(Temporal *temp, int size, Interval *duration, int vorigin, TimestampTz torigin, int **value_buckets, TimestampTz **time_buckets, int *count);
 extern TBox *tintbox_tile(int value, TimestampTz t, int vsize, Interval *duration, int vorigin, TimestampTz torigin);
 extern TBox *tintbox_tile_list(const TBox *box, int xsize, const Interval *duration, int xorigin, TimestampTz torigin, int *count);
+extern Temporal *tnumber_bucket_max(const Temporal *temp, const Interval *duration, TimestampTz torigin);
+extern Temporal *tnumber_bucket_twavg(const Temporal *temp, const Interval *duration, TimestampTz torigin);
+extern Temporal *tpoint_bucket_length(const Temporal *temp, const Interval *duration, TimestampTz torigin);
+extern Temporal **tpoint_grid_key_split(Temporal *temp, STBoxGrid *grid, bool bitmatrix, bool border_inc, int64 **keys, int *count);
+extern Temporal **tpoint_grid_split(Temporal *temp, STBoxGrid *grid, bool bitmatrix, bool border_inc, GSERIALIZED ***space_buckets, TimestampTz **time_buckets, int *count);
+extern Set *tpoint_grid_tiles(Temporal *temp, STBoxGrid *grid);
+extern uint64 tpoint_space_signature(const Temporal *temp);
 extern Temporal **tpoint_space_split(Temporal *temp, float xsize, float ysize, float zsize, GSERIALIZED *sorigin, bool bitmatrix, bool border_inc, GSERIALIZED ***space_buckets, int *count);
+extern Temporal **tpoint_space_time_key_split(Temporal *temp, float xsize, float ysize, float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool bitmatrix, bool border_inc, int64 **keys, int *count);
 extern Temporal **tpoint_space_time_split(Temporal *temp, float xsize, float ysize, float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin, bool bitmatrix, bool border_inc, GSERIALIZED ***space_buckets, TimestampTz **time_buckets, int *count);
+extern Set *tpoint_space_time_tiles(Temporal *temp, float xsize, float ysize, float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin);
+extern TileDensityState *tpoint_tile_density_combinefn(TileDensityState *state1, TileDensityState *state2);
+extern TileDensity *tpoint_tile_density_finalfn(const TileDensityState *state, int *count);
+extern TileDensityState *tpoint_coords_tile_density_transfn(TileDensityState *state, const double *xcoords, const double *ycoords, const TimestampTz *times, const int *offsets, int count, int32 srid, double xsize, double ysize, const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin);
+extern TileDensityState *tpoint_tile_density_transfn(TileDensityState *state, const Temporal *temp, double xsize, double ysize, const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin);
+extern Set *tile_key_children(int64 key);
+extern int tile_key_level(int64 key);
+extern int64 tile_key_parent(int64 key, int levels);
+extern TileDensityState *tile_density_state_deserialize(const char *buf, size_t size);
+extern void tile_density_state_free(TileDensityState *state);
+extern void tile_density_state_serialize(const TileDensityState *state, char *buf);
+extern size_t tile_density_state_serialize_size(const TileDensityState *state);
 extern Span *tstzspan_bucket_list(const Span *bounds, const Interval *duration, TimestampTz origin, int *count);
 
 /*****************************************************************************/
@@ -58,6 +58,48 @@ extern gsl_rng *gsl_get_aggregation_rng(void);
  *****************************************************************************/
 
 extern PJ_CONTEXT *proj_get_context(void);
+extern LWPROJ *proj_cache_get(int32 srid_from, int32 srid_to);
+extern LWPROJ *proj_cache_add(int32 srid_from, int32 srid_to, LWPROJ *pj);
+
+/*****************************************************************************
+ * Runtime statistics
+ *****************************************************************************/
+
+extern MEOS_THREAD_LOCAL bool MEOS_TRACK_STATS;
+extern MEOS_THREAD_LOCAL int64 MEOS_STATS[MEOS_STAT_NUMBER];
+
+/* The increment is not evaluated when the statistics are not tracked */
+#define MEOS_STAT_ADD(stat, n) \
+  do { if (MEOS_TRACK_STATS) MEOS_STATS[(stat)] += (n); } while (0)
+
+/**
+ * @brief Structure to represent a timed call of an entry point
+ */
+typedef struct
+{
+  bool outer;         /**< True if the call is not nested in another one */
+  int64 start;        /**< Start time in nanoseconds */
+  int64 bytes;        /**< Bytes allocated by the thread at the start */
+} meosStatsCall;
+
+extern void meos_stats_call_begin(meosStatsCall *call);
+extern void meos_stats_call_end(meosStatsCall *call, meosFamily family);
+extern void meos_stats_call_abort(void);
+
+/* The statement is executed without timing when the statistics are not
+ * tracked, it must not return from the enclosing function */
+#define MEOS_STATS_CALL(family, stmt) \
+  do { \
+    if (MEOS_TRACK_STATS) \
+    { \
+      meosStatsCall call_; \
+      meos_stats_call_begin(&call_); \
+      stmt; \
+      meos_stats_call_end(&call_, (family)); \
+    } \
+    else \
+      stmt; \
+  } while (0)
 
 /*****************************************************************************
  * Direct access to a single point in the GSERIALIZED struct
@@ -108,7 +150,9 @@ extern PJ_CONTEXT *proj_get_context(void);
 
 /*****************************************************************************
  * Macros for manipulating the 'flags' element where the less significant
- * bits are GTZXIICB, where
+ * bits are PFGTZXIICB, where
+ *   P: sequence (set) stored in the compressed format
+ *   F: instants of a sequence are stored at a fixed stride
  *   G: coordinates are geodetic
  *   T: has T coordinate,
  *   Z: has Z coordinate
@@ -137,6 +181,10 @@ extern PJ_CONTEXT *proj_get_context(void);
 #define MEOS_FLAG_Z          0x0020  // 32
 #define MEOS_FLAG_T          0x0040  // 64
 #define MEOS_FLAG_GEODETIC   0x0080  // 128
+/* The following flag is only used for TSequence */
+#define MEOS_FLAG_FIXED      0x0100  // 256
+/* The following flag is only used for TSequence and TSequenceSet */
+#define MEOS_FLAG_COMPRESSED 0x0200  // 512
 
 #define MEOS_FLAGS_GET_BYVAL(flags)      ((bool) (((flags) & MEOS_FLAG_BYVAL)))
 #define MEOS_FLAGS_GET_ORDERED(flags)    ((bool) (((flags) & MEOS_FLAG_ORDERED)>>1))
@@ -145,6 +193,8 @@ extern PJ_CONTEXT *proj_get_context(void);
 #define MEOS_FLAGS_GET_Z(flags)          ((bool) (((flags) & MEOS_FLAG_Z)>>5))
 #define MEOS_FLAGS_GET_T(flags)          ((bool) (((flags) & MEOS_FLAG_T)>>6))
 #define MEOS_FLAGS_GET_GEODETIC(flags)   ((bool) (((flags) & MEOS_FLAG_GEODETIC)>>7))
+#define MEOS_FLAGS_GET_FIXED(flags)      ((bool) (((flags) & MEOS_FLAG_FIXED)>>8))
+#define MEOS_FLAGS_GET_COMPRESSED(flags) ((bool) (((flags) & MEOS_FLAG_COMPRESSED)>>9))
 
 #define MEOS_FLAGS_BYREF(flags)          ((bool) (((flags) & ! MEOS_FLAG_BYVAL)))
 
@@ -162,6 +212,10 @@ extern PJ_CONTEXT *proj_get_context(void);
   ((flags) = (value) ? ((flags) | MEOS_FLAG_T) : ((flags) & ~MEOS_FLAG_T))
 #define MEOS_FLAGS_SET_GEODETIC(flags, value) \
   ((flags) = (value) ? ((flags) | MEOS_FLAG_GEODETIC) : ((flags) & ~MEOS_FLAG_GEODETIC))
+#define MEOS_FLAGS_SET_FIXED(flags, value) \
+  ((flags) = (value) ? ((flags) | MEOS_FLAG_FIXED) : ((flags) & ~MEOS_FLAG_FIXED))
+#define MEOS_FLAGS_SET_COMPRESSED(flags, value) \
+  ((flags) = (value) ? ((flags) | MEOS_FLAG_COMPRESSED) : ((flags) & ~MEOS_FLAG_COMPRESSED))
 
 #define MEOS_FLAGS_GET_INTERP(flags) (((flags) & MEOS_FLAGS_INTERP) >> 2)
 #define MEOS_FLAGS_SET_INTERP(flags, value) ((flags) = (((flags) & ~MEOS_FLAGS_INTERP) | ((value & 0x0003) << 2)))
@@ -235,6 +289,15 @@ extern const Span *SPANSET_SP_N(const SpanSet *ss, int index);
 
 /* Macros for speeding up access to components of temporal sequences (sets)*/
 
+/**
+ * @brief Return the number of elements of the offsets array of a temporal
+ * sequence
+ * @note When the instants are stored at a fixed stride, the offsets array is
+ * replaced by a single element that keeps the stride
+ */
+#define TSEQUENCE_NOFFSETS(seq) \
+  ( MEOS_FLAGS_GET_FIXED((seq)->flags) ? 1 : (seq)->maxcount )
+
 #ifdef DEBUG_BUILD
 extern size_t *TSEQUENCE_OFFSETS_PTR(const TSequence *seq);
 extern const TInstant *TSEQUENCE_INST_N(const TSequence *seq, int index);
@@ -256,7 +319,10 @@ extern const TSequence *TSEQUENCESET_SEQ_N(const TSequenceSet *ss, int index);
  */
 #define TSEQUENCE_INST_N(seq, index) ( (const TInstant *)( \
   ((char *) &((seq)->period)) + (seq)->bboxsize + \
-  (sizeof(size_t) * (seq)->maxcount) + (TSEQUENCE_OFFSETS_PTR(seq))[index] ) )
+  (sizeof(size_t) * TSEQUENCE_NOFFSETS(seq)) + \
+  ( MEOS_FLAGS_GET_FIXED((seq)->flags) ? \
+    (TSEQUENCE_OFFSETS_PTR(seq))[0] * (index) : \
+    (TSEQUENCE_OFFSETS_PTR(seq))[index] ) ) )
 
 /**
  * @brief Return a pointer to the offsets array of a temporal sequence set
@@ -398,6 +464,7 @@ extern bool contained_value_spanset(Datum value, const SpanSet *ss);
 extern bool contains_set_value(const Set *s, Datum value);
 extern bool contains_span_value(const Span *s, Datum value);
 extern bool contains_spanset_value(const SpanSet *ss, Datum value);
+extern bool *contains_spanset_values(const SpanSet *ss, const Datum *values, int count);
 extern bool ovadj_span_span(const Span *s1, const Span *s2);
 extern bool over_span_span(const Span *s1, const Span *s2);
 
@@ -671,6 +738,7 @@ extern Datum *temporal_vals(const Temporal *temp, int *count);
 extern bool temporal_value_n(const Temporal *temp, int n, Datum *result);
 extern Datum *temporal_values(const Temporal *temp, int *count);
 extern uint32 tinstant_hash(const TInstant *inst);
+extern uint64 tinstant_hash_extended(const TInstant *inst, uint64 seed);
 extern const TInstant **tinstant_insts(const TInstant *inst, int *count);
 extern void tinstant_set_bbox(const TInstant *inst, void *box);
 extern SpanSet *tinstant_time(const TInstant *inst);
@@ -686,6 +754,7 @@ extern SpanSet *tnumberseqset_valuespans(const TSequenceSet *ss);
 extern Interval *tsequence_duration(const TSequence *seq);
 extern TimestampTz tsequence_end_timestamptz(const TSequence *seq);
 extern uint32 tsequence_hash(const TSequence *seq);
+extern uint64 tsequence_hash_extended(const TSequence *seq, uint64 seed);
 extern const TInstant **tsequence_insts(const TSequence *seq);
 extern const TInstant *tsequence_max_inst(const TSequence *seq);
 extern Datum tsequence_max_val(const TSequence *seq);
@@ -699,10 +768,14 @@ extern TimestampTz tsequence_start_timestamptz(const TSequence *seq);
 extern SpanSet *tsequence_time(const TSequence *seq);
 extern TimestampTz *tsequence_timestamps(const TSequence *seq, int *count);
 extern bool tsequence_value_at_timestamptz(const TSequence *seq, TimestampTz t, bool strict, Datum *result);
+extern int tsequence_values_at_timestamps(const TSequence *seq, const TimestampTz *times, int count, bool strict, Datum *values, bool *found);
+extern void tsequence_segment_slopes(const TSequence *seq, double *slopes);
+extern int tsequence_doubles_at_timestamps(const TSequence *seq, const TimestampTz *times, int count, bool strict, const double *slopes, double *values, bool *found);
 extern Datum *tsequence_vals(const TSequence *seq, int *count);
 extern Interval *tsequenceset_duration(const TSequenceSet *ss, bool boundspan);
 extern TimestampTz tsequenceset_end_timestamptz(const TSequenceSet *ss);
 extern uint32 tsequenceset_hash(const TSequenceSet *ss);
+extern uint64 tsequenceset_hash_extended(const TSequenceSet *ss, uint64 seed);
 extern const TInstant *tsequenceset_inst_n(const TSequenceSet *ss, int n);
 extern const TInstant **tsequenceset_insts(const TSequenceSet *ss);
 extern const TInstant *tsequenceset_max_inst(const TSequenceSet *ss);
@@ -720,6 +793,9 @@ extern Interval *tsequenceset_timespan(const TSequenceSet *ss);
 extern bool tsequenceset_timestamptz_n(const TSequenceSet *ss, int n, TimestampTz *result);
 extern TimestampTz *tsequenceset_timestamps(const TSequenceSet *ss, int *count);
 extern bool tsequenceset_value_at_timestamptz(const TSequenceSet *ss, TimestampTz t, bool strict, Datum *result);
+extern int tsequenceset_values_at_timestamps(const TSequenceSet *ss, const TimestampTz *times, int count, bool strict, Datum *values, bool *found);
+extern void tsequenceset_segment_slopes(const TSequenceSet *ss, double *slopes);
+extern int tsequenceset_doubles_at_timestamps(const TSequenceSet *ss, const TimestampTz *times, int count, bool strict, const double *slopes, double *values, bool *found);
 extern bool tsequenceset_value_n(const TSequenceSet *ss, int n, Datum *result);
 extern Datum *tsequenceset_vals(const TSequenceSet *ss, int *count);
 
@@ -728,6 +804,8 @@ extern Datum *tsequenceset_vals(const TSequenceSet *ss, int *count);
 /* Transformation functions for temporal types */
 
 extern Temporal *temporal_compact(const Temporal *temp);
+extern Temporal *temporal_compress(const Temporal *temp);
+extern Temporal *temporal_decompress(const Temporal *temp);
 extern void temporal_restart(Temporal *temp, int count);
 extern TSequence *temporal_tsequence(const Temporal *temp, interpType interp);
 extern TSequenceSet *temporal_tsequenceset(const Temporal *temp, interpType interp);
@@ -984,6 +1062,7 @@ extern TInstant *tgeompointinst_tgeogpointinst(const TInstant *inst, bool oper);
 extern TSequence *tgeompointseq_tgeogpointseq(const TSequence *seq, bool oper);
 extern TSequenceSet *tgeompointseqset_tgeogpointseqset(const TSequenceSet *ss, bool oper);
 extern Temporal *tgeompoint_tgeogpoint(const Temporal *temp, bool oper);
+extern Temporal *tpoint_coords_pipeline_free(Temporal *temp, const CoordOp *ops, int count, bool filter_pts);
 extern TInstant *tpointinst_set_srid(const TInstant *inst, int32 srid);
 extern TSequence **tpointseq_make_simple(const TSequence *seq, int *count);
 extern TSequence *tpointseq_set_srid(const TSequence *seq, int32 srid);
@@ -1009,6 +1088,56 @@ extern Temporal *temporal_compact(const Temporal *temp);
 extern TSequence *tsequence_compact(const TSequence *seq);
 extern TSequenceSet *tsequenceset_compact(const TSequenceSet *ss);
 
+/* Slack budget of long-lived expandable values */
+
+typedef struct ExpandPool ExpandPool;
+
+extern ExpandPool *expand_pool_make(size_t maxslack);
+extern int expand_pool_add(ExpandPool *pool, Temporal *temp);
+extern const Temporal *expand_pool_get(const ExpandPool *pool, int handle);
+extern bool expand_pool_append(ExpandPool *pool, int handle, const TInstant *inst, double maxdist, const Interval *maxt);
+extern int expand_pool_compact(ExpandPool *pool, size_t maxslack);
+extern Temporal *expand_pool_remove(ExpandPool *pool, int handle);
+extern int expand_pool_count(const ExpandPool *pool);
+extern size_t expand_pool_slack(const ExpandPool *pool);
+extern void expand_pool_free(ExpandPool *pool);
+
+/*****************************************************************************/
+
+/* Random generation of temporal values */
+
+/**
+ * @brief Structure to represent the options of the random generation of
+ * temporal values
+ * @note The values of the temporal network points are generated on the routes
+ * whose identifier is in the range [lowvalue, highvalue]
+ */
+typedef struct
+{
+  meosType temptype;      /**< Temporal type */
+  tempSubtype subtype;    /**< Subtype */
+  interpType interp;      /**< Interpolation of the sequences */
+  double lowvalue;        /**< Minimum value of the temporal numbers */
+  double highvalue;       /**< Maximum value of the temporal numbers */
+  double lowx, highx;     /**< Minimum and maximum X coordinates */
+  double lowy, highy;     /**< Minimum and maximum Y coordinates */
+  double lowz, highz;     /**< Minimum and maximum Z coordinates */
+  bool hasz;              /**< True when the points have Z coordinates */
+  int32 srid;             /**< SRID of the points */
+  int maxlength;          /**< Maximum length of the temporal texts */
+  TimestampTz lowtime;    /**< Minimum timestamp */
+  TimestampTz hightime;   /**< Maximum timestamp */
+  double maxdelta;        /**< Maximum difference between two values */
+  int maxminutes;         /**< Maximum minutes between two timestamps */
+  int mininsts;           /**< Minimum number of instants of a sequence */
+  int maxinsts;           /**< Maximum number of instants of a sequence */
+  int minseqs;            /**< Minimum number of sequences of a set */
+  int maxseqs;            /**< Maximum number of sequences of a set */
+} temporalRandomOptions;
+
+extern Temporal *temporal_random(const temporalRandomOptions *opts, gsl_rng *rng);
+extern Temporal **temporal_random_bulk(const temporalRandomOptions *opts, int count, uint64 seed);
+
 /*****************************************************************************/
 
 /* Aggregate functions for temporal types */
@@ -1016,6 +1145,8 @@ extern TSequenceSet *tsequenceset_compact(const TSequenceSet *ss);
 extern void skiplist_free(SkipList *list);
 extern Temporal *temporal_app_tinst_transfn(Temporal *state, const TInstant *inst, double maxdist, Interval *maxt);
 extern Temporal *temporal_app_tseq_transfn(Temporal *state, const TSequence *seq);
+extern Temporal *temporal_app_tinst_combinefn(Temporal *state1, Temporal *state2);
+extern Temporal *temporal_app_tseq_combinefn(Temporal *state1, Temporal *state2);
 
 /*****************************************************************************/
 
@@ -0,0 +1,127 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief API of the Mobility Engine Open Source (MEOS) library for network
+ * points.
+ */
+
+#ifndef __MEOS_NPOINT_H__
+#define __MEOS_NPOINT_H__
+
+/* C */
+#include <stdbool.h>
+#include <stdint.h>
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************
+ * Type definitions
+ *****************************************************************************/
+
+/**
+ * Structure to represent network-based points
+ */
+typedef struct
+{
+  int64 rid;        /**< route identifier */
+  double pos;       /**< position */
+} Npoint;
+
+/**
+ * Structure to represent network-based segments
+ */
+typedef struct
+{
+  int64 rid;       /**< route identifier */
+  double pos1;     /**< position1 */
+  double pos2;     /**< position2 */
+} Nsegment;
+
+/**
+ * @brief Function returning the geometry of a route from its identifier
+ *
+ * The function returns @p NULL if the route does not exist. Otherwise, it
+ * returns the route geometry, which must be a line and stays owned by the
+ * caller of #meos_set_route_provider, and sets the length argument to the
+ * route length, or to a negative value if the length must be computed from
+ * the geometry.
+ */
+typedef const GSERIALIZED *(*route_provider_fn)(int64 rid, double *length,
+  void *extra);
+
+/*****************************************************************************
+ * Functions for the route network
+ *****************************************************************************/
+
+extern void meos_set_route_provider(route_provider_fn provider, void *extra);
+extern bool meos_route_add(int64 rid, const GSERIALIZED *gs, double length);
+extern bool meos_route_add_wkb(int64 rid, const uint8_t *wkb, size_t size, double length);
+extern int meos_route_load_csv(const char *filename);
+extern int meos_route_count(void);
+extern void meos_route_clear(void);
+
+/*****************************************************************************
+ * Functions for static network-based points and segments
+ *****************************************************************************/
+
+extern Npoint *npoint_in(const char *str, bool end);
+extern char *npoint_out(const Npoint *np, int maxdd);
+extern Nsegment *nsegment_in(const char *str);
+extern char *nsegment_out(const Nsegment *ns, int maxdd);
+
+extern Npoint *npoint_make(int64 rid, double pos);
+extern Nsegment *nsegment_make(int64 rid, double pos1, double pos2);
+
+extern int64 npoint_route(const Npoint *np);
+extern double npoint_position(const Npoint *np);
+extern int64 nsegment_route(const Nsegment *ns);
+extern double nsegment_start_position(const Nsegment *ns);
+extern double nsegment_end_position(const Nsegment *ns);
+
+extern GSERIALIZED *npoint_geom(const Npoint *np);
+extern Npoint *geom_npoint(const GSERIALIZED *gs);
+extern GSERIALIZED *nsegment_geom(const Nsegment *ns);
+extern Nsegment *geom_nsegment(const GSERIALIZED *gs);
+
+/*****************************************************************************
+ * Functions for temporal network points
+ *****************************************************************************/
+
+extern Temporal *tnpoint_tgeompoint(const Temporal *temp);
+extern Temporal *tgeompoint_tnpoint(const Temporal *temp);
+extern Temporal *tgeompoint_tnpoint_snap(const Temporal *temp, double tolerance);
+
+extern double npoint_network_distance(const Npoint *np1, const Npoint *np2);
+extern Temporal *ndistance_tnpoint_npoint(const Temporal *temp, const Npoint *np);
+extern Temporal *ndistance_tnpoint_tnpoint(const Temporal *temp1, const Temporal *temp2);
+
+/*****************************************************************************/
+
+#endif /* __MEOS_NPOINT_H__ */
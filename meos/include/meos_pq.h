@@ -0,0 +1,96 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief API of the companion library of the Mobility Engine Open Source
+ * (MEOS) library for streaming temporal values into a MobilityDB database
+ * with the binary COPY protocol of libpq.
+ */
+
+#ifndef __MEOS_PQ_H__
+#define __MEOS_PQ_H__
+
+/* C */
+#include <stdbool.h>
+#include <stdint.h>
+/* PostgreSQL */
+#include <libpq-fe.h>
+/* MEOS */
+#include <meos.h>
+
+/*****************************************************************************/
+
+/**
+ * Opaque structure to represent an ongoing binary COPY into a table
+ */
+typedef struct MeosCopy MeosCopy;
+
+/* Default size in bytes of the batches sent to the server */
+#define MEOS_COPY_BATCH_SIZE (1024 * 1024)
+
+extern MeosCopy *meos_copy_begin(PGconn *conn, const char *target, int nfields, size_t batchsize);
+extern bool meos_copy_put_null(MeosCopy *copy);
+extern bool meos_copy_put_bool(MeosCopy *copy, bool value);
+extern bool meos_copy_put_int4(MeosCopy *copy, int32_t value);
+extern bool meos_copy_put_int8(MeosCopy *copy, int64_t value);
+extern bool meos_copy_put_float8(MeosCopy *copy, double value);
+extern bool meos_copy_put_text(MeosCopy *copy, const char *value);
+extern bool meos_copy_put_temporal(MeosCopy *copy, const Temporal *temp);
+extern int64_t meos_copy_end(MeosCopy *copy);
+
+/*****************************************************************************/
+
+/* Definition of the function reading the next instant of a pipeline, which
+ * returns false at the end of the stream */
+typedef bool (*meos_pipeline_read_fn)(int64_t *id, TInstant **inst,
+  void *arg);
+
+/**
+ * Structure to represent the options of an ingestion pipeline
+ */
+typedef struct
+{
+  const char *conninfo;    /**< Connection string of the writers */
+  const char *target;      /**< Table and columns of the identifier and the
+                                trip, e.g., `trips(id, trip)` */
+  int nassemblers;         /**< Number of assembler threads, 0 for one */
+  int nwriters;            /**< Number of writer threads and connections, 0
+                                for one */
+  int queuesize;           /**< Size of the queues between the stages, 0 for
+                                the default */
+  size_t batchsize;        /**< Size in bytes of the COPY batches, 0 for
+                                #MEOS_COPY_BATCH_SIZE */
+  tsessionOptions session; /**< Options of the assembly of the trips */
+} meosPipelineOptions;
+
+extern int64_t meos_pipeline_run(meos_pipeline_read_fn read, void *arg, const meosPipelineOptions *opts, int64_t *nerrors);
+
+/*****************************************************************************/
+
+#endif /* __MEOS_PQ_H__ */
@@ -38,27 +38,7 @@
 #include <postgres.h>
 /* MEOS */
 #include <meos.h>
-
-/*****************************************************************************
- * Struct definitions
- *****************************************************************************/
-
-/* Network-based point */
-
-typedef struct
-{
-  int64 rid;        /**< route identifier */
-  double pos;       /**< position */
-} Npoint;
-
-/* Network-based segment */
-
-typedef struct
-{
-  int64 rid;       /**< route identifier */
-  double pos1;     /**< position1 */
-  double pos2;     /**< position2 */
-} Nsegment;
+#include <meos_npoint.h>
 
 /*****************************************************************************
  * fmgr macros
@@ -76,6 +56,35 @@ typedef struct
 #define PG_GETARG_NSEGMENT_P(X)    DatumGetNsegmentP(PG_GETARG_DATUM(X))
 #define PG_RETURN_NSEGMENT_P(X)    PG_RETURN_POINTER(X)
 
+/*****************************************************************************
+ * Packed storage format
+ *****************************************************************************/
+
+/** Marker of the packed format, distinct from the endian byte of the WKB
+ * encoding used by the other compressed values */
+#define TNPOINT_PACKED_FORMAT   0x314B504E  /* "NPK1" */
+
+/**
+ * Structure of the body of a temporal network point sequence (set) in the
+ * packed format, kept after the header and the bounding box of the value.
+ * It is followed by the arrays
+ * - `int64 rids[nruns]`: route of each run of instants on the same route,
+ * - `TimestampTz times[count]`: timestamps of the instants,
+ * - `int32 runstarts[nruns]`: number of the first instant of each run,
+ * - `int32 seqstarts[nseqs]`: number of the first instant of each sequence,
+ * - `float4 positions[count]`: positions of the instants,
+ * - `uint8 bounds[nseqs]`: lower (bit 0) and upper (bit 1) inclusive flags of
+ *   each sequence,
+ * so that the routes can be read without reading the positions.
+ */
+typedef struct
+{
+  int32 format;         /**< Value TNPOINT_PACKED_FORMAT */
+  int32 count;          /**< Number of instants */
+  int32 nruns;          /**< Number of runs of instants on the same route */
+  int32 nseqs;          /**< Number of sequences */
+} TNpointPacked;
+
 /*****************************************************************************/
 
 /* Input/output functions */
@@ -90,12 +99,11 @@ extern TInstant *tnpointinst_tgeompointinst(const TInstant *inst);
 extern TSequence *tnpointseq_tgeompointseq_disc(const TSequence *is);
 extern TSequence *tnpointseq_tgeompointseq_cont(const TSequence *seq);
 extern TSequenceSet *tnpointseqset_tgeompointseqset(const TSequenceSet *ss);
-extern Temporal *tnpoint_tgeompoint(const Temporal *temp);
 
 extern TInstant *tgeompointinst_tnpointinst(const TInstant *inst);
 extern TSequence *tgeompointseq_tnpointseq(const TSequence *seq);
 extern TSequenceSet *tgeompointseqset_tnpointseqset(const TSequenceSet *ss);
-extern Temporal *tgeompoint_tnpoint(const Temporal *temp);
+extern Npoint **tgeompointseq_snap(const TSequence *seq, double tolerance);
 
 /* Accessor functions */
 
@@ -113,6 +121,14 @@ extern Set *tnpoint_routes(const Temporal *temp);
 
 extern Nsegment *tnpointseq_linear_positions(const TSequence *seq);
 
+/* Packed storage format */
+
+extern Temporal *tnpoint_pack(const Temporal *temp);
+extern bool tnpoint_packed(const Temporal *temp);
+extern Temporal *tnpoint_unpack(const Temporal *temp);
+extern const int64 *tnpoint_packed_runs(const Temporal *temp,
+  const int32 **runstarts, int *nruns);
+
 /*****************************************************************************/
 
 #endif /* __TNPOINT_H__ */
@@ -41,7 +41,8 @@
 
 /*****************************************************************************/
 
-extern SkipList *tnpoint_tcentroid_transfn(SkipList *state, Temporal *temp);
+extern TCentroidState *tnpoint_tcentroid_transfn(TCentroidState *state,
+  const Temporal *temp);
 
 /*****************************************************************************/
 
@@ -43,6 +43,11 @@
 /*****************************************************************************/
 
 extern Datum npoint_distance(Datum np1, Datum np2);
+extern bool tnpoint_same_route(const Temporal *temp1, const Temporal *temp2,
+  int64 *rid);
+extern bool route_straight(int64 rid);
+extern Temporal *distance_tnpoint_tnpoint_route(const Temporal *temp1,
+  const Temporal *temp2, int64 rid);
 extern Temporal *distance_tnpoint_point(const Temporal *temp,
   const GSERIALIZED *gs);
 extern Temporal *distance_tnpoint_npoint(const Temporal *temp,
@@ -41,49 +41,49 @@
 
 /*****************************************************************************/
 
+#if ! MEOS
+/** Maximum number of routes kept in the per-backend route cache */
+#ifndef ROUTE_CACHE_SIZE
+  #define ROUTE_CACHE_SIZE 1024
+#endif
+#endif /* ! MEOS */
+
 /* General functions */
 
 extern int32_t get_srid_ways(void);
+extern int ridarr_sort_unique(int64 *rids, int count);
+extern int ridarr_find(const int64 *rids, int count, int64 rid);
 extern GSERIALIZED *npointarr_geom(Npoint **points, int count);
 extern GSERIALIZED *nsegmentarr_geom(Nsegment **segments, int count);
 extern Nsegment **nsegmentarr_normalize(Nsegment **segments, int *count);
 
-/* Input/output functions */
-
-extern Npoint *npoint_in(const char *str, bool end);
-extern char *npoint_out(const Npoint *np, int maxdd);
-
-extern Nsegment *nsegment_in(const char *str);
-extern char *nsegment_out(const Nsegment *ns, int maxdd);
-
 /* Constructor functions */
 
-extern Npoint *npoint_make(int64 rid, double pos);
 extern void npoint_set(int64 rid, double pos, Npoint *np);
-extern Nsegment *nsegment_make(int64 rid, double pos1, double pos2);
 extern void nsegment_set(int64 rid, double pos1, double pos2, Nsegment *ns);
 
 /* Conversion functions */
 
 extern Nsegment *npoint_to_nsegment(const Npoint *np);
 
-/* Accessor functions */
-
-extern int64 npoint_route(const Npoint *np);
-extern double npoint_position(const Npoint *np);
-extern int64 nsegment_route(const Nsegment *ns);
-extern double nsegment_start_position(const Nsegment *ns);
-extern double nsegment_end_position(const Nsegment *ns);
-
 /* Conversions between network and Euclidean space */
 
+#if ! MEOS
+extern void route_cache_reset(void);
+extern void route_cache_stats(int64 *hits, int64 *misses, int *count,
+  int *capacity);
+#endif /* ! MEOS */
 extern bool route_exists(int64 rid);
 extern double route_length(int64 rid);
 extern GSERIALIZED *route_geom(int64 rid);
-extern GSERIALIZED *npoint_geom(const Npoint *np);
-extern Npoint *geom_npoint(const GSERIALIZED *gs);
-extern GSERIALIZED *nsegment_geom(const Nsegment *ns);
-extern Nsegment *geom_nsegment(const GSERIALIZED *gs);
+extern GSERIALIZED **route_geom_batch(const int64 *rids, int count);
+extern bool route_set_stbox(int64 rid, STBox *box);
+extern int32_t route_srid(int64 rid);
+extern bool route_network_read(int64 **rids, double **ends, double **lengths,
+  int *count);
+extern void route_graph_reset(void);
+extern bool route_geoms_read(int64 **rids, GSERIALIZED ***geoms, int *count);
+extern void route_index_reset(void);
 
 /* SRID functions */
 
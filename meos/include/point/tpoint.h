@@ -70,6 +70,35 @@
 #define TYPMOD_DEL_SUBTYPE(typmod) (typmod = typmod >> 4 )
 #define TYPMOD_SET_SUBTYPE(typmod, subtype) ((typmod) = typmod << 4 | subtype)
 
+/*****************************************************************************
+ * Quantized storage format
+ *****************************************************************************/
+
+/** Marker of the quantized format, distinct from the endian byte of the WKB
+ * encoding used by the other compressed values */
+#define TPOINT_QUANTIZED_FORMAT 0x3151504D  /* "MPQ1" */
+
+/**
+ * Structure of the body of a temporal point sequence (set) in the quantized
+ * format, kept after the header and the bounding box of the value.
+ * It is followed by the arrays
+ * - `TimestampTz times[count]`: timestamps of the instants,
+ * - `int32 coords[count * ndims]`: coordinates of the instants as positions
+ *   in the grid relative to the origin,
+ * - `int32 seqstarts[nseqs]`: number of the first instant of each sequence,
+ * - `uint8 bounds[nseqs]`: lower (bit 0) and upper (bit 1) inclusive flags of
+ *   each sequence.
+ */
+typedef struct
+{
+  int32 format;         /**< Value TPOINT_QUANTIZED_FORMAT */
+  int32 count;          /**< Number of instants */
+  int32 nseqs;          /**< Number of sequences */
+  int32 ndims;          /**< Number of coordinates of the points */
+  double scale;         /**< Size of the grid */
+  int64 origin[3];      /**< Position in the grid of the origin */
+} TPointQuantized;
+
 /*****************************************************************************/
 
 /* General functions */
@@ -84,6 +113,12 @@ extern Temporal *tcomp_point_tpoint(const GSERIALIZED *gs,
 extern Temporal *tcomp_tpoint_point(const Temporal *temp,
   const GSERIALIZED *gs, Datum (*func)(Datum, Datum, meosType));
 
+/* Quantized storage format */
+
+extern Temporal *tpoint_quantize(const Temporal *temp, double scale);
+extern bool tpoint_quantized(const Temporal *temp);
+extern Temporal *tpoint_unquantize(const Temporal *temp);
+
 /*****************************************************************************/
 
 #endif
@@ -42,30 +42,9 @@
 
 /*****************************************************************************/
 
-/**
- * Structure storing the SRID and the dimensionality of the temporal point
- * values for aggregation. Notice that for the moment we do not aggregate
- * temporal geographic points.
- */
-struct GeoAggregateState
-{
-  int32_t srid;
-  bool hasz;
-};
-
-/*****************************************************************************/
-
-extern bool ensure_geoaggstate(const SkipList *state, int32_t srid, bool hasz);
-extern bool ensure_geoaggstate_state(const SkipList *state1,
-  const SkipList *state2);
-
-extern Temporal **tpoint_transform_tcentroid(const Temporal *temp, int *count);
-extern SkipList * tpoint_tcentroid_transfn(SkipList *state, Temporal *temp);
-extern TSequence *tpointinst_tcentroid_finalfn(TInstant **instants, int count,
-  int srid);
-extern TSequenceSet *tpointseq_tcentroid_finalfn(TSequence **sequences,
-  int count, int srid);
-extern Temporal *tpoint_tcentroid_finalfn(SkipList *state);
+extern TCentroidState *tpoint_tcentroid_transfn(TCentroidState *state,
+  const Temporal *temp);
+extern Temporal *tpoint_tcentroid_finalfn(const TCentroidState *state);
 
 /*****************************************************************************/
 
@@ -46,8 +46,66 @@
 #define REST_TIME           true
 #define REST_TIME_NO        false
 
+/**
+ * @brief Minimum number of vertices of a geometry from which the restriction
+ * and the distance functions use an index of its edges
+ */
+#define EDGEINDEX_MIN_POINTS 1000
+
+/** Symbolic constants for the location of a point with respect to the
+ * polygon of an edge index */
+#define EDGEINDEX_EXTERIOR  0
+#define EDGEINDEX_INTERIOR  1
+#define EDGEINDEX_BOUNDARY  2
+
+/**
+ * @brief Structure to represent a bounding box of the edge index
+ */
+typedef struct
+{
+  double xmin, ymin, xmax, ymax;
+} EdgeBox;
+
+/**
+ * @brief Structure to represent an index of the edges of a polygon or a line
+ * @details The nodes of level @p i + 1 are the bounding boxes of groups of
+ * @p EDGEINDEX_NODE_SIZE consecutive entries of level @p i, where the entries
+ * of level 0 are the edges. The structure is allocated with @p malloc since
+ * it survives the calls.
+ */
+typedef struct
+{
+  GSERIALIZED *gs;         /**< Geometry indexed */
+  bool areal;              /**< True when the geometry is a polygon */
+  int npoints;             /**< Number of vertices of the geometry */
+  int nedges;              /**< Number of edges */
+  POINT2D *edges;          /**< Start and end points of the edges */
+  int nlevels;             /**< Number of levels of the tree */
+  int *nnodes;             /**< Number of nodes of each level */
+  EdgeBox **nodes;         /**< Nodes of each level */
+} EdgeIndex;
+
 /*****************************************************************************/
 
+/* Edge index functions */
+
+extern const EdgeIndex *edge_index_get(const GSERIALIZED *gs, int minpoints,
+  bool lines);
+extern int edge_index_query(const EdgeIndex *index, const EdgeBox *box,
+  int **edges, int *maxedges);
+extern int edge_index_locate_point(const EdgeIndex *index, const POINT2D *p,
+  int **edges, int *maxedges);
+extern int edge_index_segment_fractions(const EdgeIndex *index,
+  const POINT2D *p, const POINT2D *q, int **edges, int *maxedges,
+  double **fracs, int *maxfracs);
+extern double edge_index_segment_distance(const EdgeIndex *index,
+  const POINT2D *p, const POINT2D *q, double maxdist, double *fraction);
+extern int edge_index_segment_dwithin(const EdgeIndex *index,
+  const POINT2D *p, const POINT2D *q, double dist, int **edges, int *maxedges,
+  double **fracs, int *maxfracs);
+extern const EdgeIndex *tpoint_geo_dist_edge_index(const Temporal *temp,
+  const GSERIALIZED *gs, int minpoints);
+
 /* Restriction functions */
 
 extern TSequence **tpointseq_at_geom(const TSequence *seq,
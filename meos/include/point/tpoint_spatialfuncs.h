@@ -75,10 +75,22 @@ extern datum_func2 pt_distance_fn(int16 flags);
 extern Datum geom_distance2d(Datum geom1, Datum geom2);
 extern Datum geom_distance3d(Datum geom1, Datum geom2);
 extern Datum geog_distance(Datum geog1, Datum geog2);
+extern double geog_distance_haversine(const POINT2D *p1, const POINT2D *p2);
+extern Datum geog_point_distance_fast(Datum geog1, Datum geog2);
 extern Datum pt_distance2d(Datum geom1, Datum geom2);
 extern Datum pt_distance3d(Datum geom1, Datum geom2);
 extern Datum geom_intersection2d(Datum geom1, Datum geom2);
 
+/* Columnar access functions */
+
+extern int tpointseq_coords_iter(const TSequence *seq, double *x, double *y,
+  double *z);
+
+/* Length functions */
+
+extern double tpointseq_segment_lengths(const TSequence *seq,
+  double *lengths);
+
 /* Parameter tests */
 
 extern bool ensure_spatial_validity(const Temporal *temp1,
@@ -183,6 +195,8 @@ extern TSequenceSet *tpointseqset_transform(const TSequenceSet *ss, int srid);
 extern Temporal *tpoint_transform(const Temporal *temp, int srid);
 extern Temporal *tpoint_transform_pj(const Temporal *temp, int32 srid, const LWPROJ* pj);
 extern LWPROJ *lwproj_transform(int32 srid_from, int32 srid_to);
+extern LWPROJ *lwproj_transform_cached(int32 srid_from, int32 srid_to);
+extern bool pt4darr_transf_pj(POINT4D *points, int count, const LWPROJ *pj);
 
 /* Stop function */
 
@@ -54,6 +54,7 @@ extern Datum geom_touches(Datum geom1, Datum geom2);
 extern Datum geom_dwithin2d(Datum geom1, Datum geom2, Datum dist);
 extern Datum geom_dwithin3d(Datum geom1, Datum geom2, Datum dist);
 extern Datum geog_dwithin(Datum geog1, Datum geog2, Datum dist);
+extern Datum geog_point_dwithin_fast(Datum geog1, Datum geog2, Datum dist);
 
 extern datum_func2 get_disjoint_fn_gs(int16 flags1, uint8_t flags2);
 extern datum_func2 get_intersects_fn_gs(int16 flags1, uint8_t flags2);
@@ -61,6 +62,8 @@ extern datum_func3 get_dwithin_fn(int16 flags1, int16 flags2);
 
 /*****************************************************************************/
 
+extern const GSERIALIZED *tpoint_trajectory_cache(const Temporal *temp);
+
 extern Datum ea_disjoint_tpoint_geo(const Temporal *temp,
   const GSERIALIZED *gs, bool ever);
 extern int ea_spatialrel_tpoint_tpoint(const Temporal *temp1,
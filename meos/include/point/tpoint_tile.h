@@ -39,17 +39,48 @@
 
 #define MAXDIMS 4
 
+/** Number of cells in each dimension of the spatial signature grid */
+#define SIGNATURE_SIZE 8
+/** Bit of the spatial signature of the cell in column i and row j */
+#define SIGNATURE_BIT(i, j) \
+  (UINT64CONST(1) << ((j) * SIGNATURE_SIZE + (i)))
+/** Enlargement of a box in the signature grid, in fractions of a cell */
+#define SIGNATURE_EPSILON 1e-6
+
 /*****************************************************************************/
 
 /**
- * Structure for storing a bit matrix
+ * Structure for associating a tile of a grid with a segment of a temporal
+ * point traversing it
+ */
+typedef struct
+{
+  int64 tile;            /**< Linear identifier of the tile */
+  int seq;               /**< Number of the sequence of the segment */
+  int inst;              /**< Number of the start instant of the segment */
+} TileSegm;
+
+/**
+ * Structure for storing the set of tiles of a grid traversed by a temporal
+ * point. The tiles are kept as their linear identifiers in the grid, in which
+ * the X dimension varies fastest, so that once sorted they follow the order
+ * in which the grid is traversed. Optionally, the segments traversing each
+ * tile are also kept, so that a tile is only intersected with these segments.
  */
 typedef struct
 {
   int ndims;             /**< Number of dimensions */
   int count[MAXDIMS];    /**< Number of elements in each dimension */
-  uint8_t byte[1];       /**< beginning of variable-length data */
-} BitMatrix;
+  int ntiles;            /**< Number of tiles in the set */
+  int maxtiles;          /**< Number of tiles allocated */
+  int64 *tiles;          /**< Linear identifiers of the tiles */
+  int seq;               /**< Sequence of the segment being traversed */
+  int inst;              /**< Start instant of the segment being traversed */
+  bool keepsegms;        /**< True when the segments are kept */
+  int nsegms;            /**< Number of segments in the set */
+  int maxsegms;          /**< Number of segments allocated */
+  TileSegm *segms;       /**< Optional segments traversing the tiles */
+} TileSet;
 
 /**
  * Struct for storing the state that persists across multiple calls generating
@@ -67,8 +98,13 @@ typedef struct STboxGridState
   int64 tunits;            /**< Size of the time dimension, 0 for spatial only */
   STBox box;               /**< Bounding box of the grid */
   const Temporal *temp;    /**< Optional temporal point to be split */
-  BitMatrix *bm;           /**< Optional bit matrix for speeding up the
+  TileSet *tiles;          /**< Optional set of tiles for speeding up the
                               computation of the split functions */
+  bool owntiles;           /**< True when the set of tiles is freed with the
+                              state, otherwise it belongs to a grid */
+  int tilepos;             /**< Position of the current tile in the set */
+  int segmpos;             /**< Position of the first segment of the current
+                              tile in the set */
   double x;                /**< Minimum x value of the current tile */
   double y;                /**< Minimum y value of the current tile */
   double z;                /**< Minimum z value of the current tile, if any */
@@ -76,13 +112,18 @@ typedef struct STboxGridState
   int ntiles;              /**< Total number of tiles */
   int max_coords[MAXDIMS]; /**< Maximum coordinates of the tiles */
   int coords[MAXDIMS];     /**< Coordinates of the current tile */
+  int64 base[MAXDIMS];     /**< Absolute coordinates of the first tile of the
+                              grid with respect to the origin */
 } STboxGridState;
 
 /*****************************************************************************/
 
-extern BitMatrix *bitmatrix_make(int *count, int ndims);
+extern TileSet *tileset_make(const int *count, int ndims, bool segms);
+extern void tileset_reset(TileSet *ts, const int *count, int ndims,
+  bool segms);
+extern void tileset_free(TileSet *ts);
 extern int tpoint_set_tiles(const Temporal *temp, const STboxGridState *state,
-  BitMatrix *bm);
+  TileSet *ts);
 extern Temporal *tpoint_at_tile(const Temporal *temp, const STBox *box);
 
 extern void stbox_tile_set(double x, double y, double z, TimestampTz t,
@@ -93,11 +134,26 @@ extern STboxGridState *stbox_tile_state_make(const Temporal *temp,
   POINT3DZ sorigin, TimestampTz torigin, bool border_inc);
 extern void stbox_tile_state_next(STboxGridState *state);
 extern bool stbox_tile_state_get(STboxGridState *state, STBox *box);
+extern Temporal *stbox_tile_state_restrict(STboxGridState *state,
+  const STBox *box);
+extern int64 stbox_tile_state_key(const STboxGridState *state);
+extern void stbox_tile_state_free(STboxGridState *state);
+
+extern bool stbox_grid_set(double xsize, double ysize, double zsize,
+  const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin,
+  STBoxGrid *grid);
+extern bool stbox_grid_eq(const STBoxGrid *grid1, const STBoxGrid *grid2);
+extern STBoxGrid *stbox_grid_copy(const STBoxGrid *grid);
 
 extern STboxGridState *tpoint_space_time_split_init(Temporal *temp,
   float xsize, float ysize, float zsize, Interval *duration,
   GSERIALIZED *sorigin, TimestampTz torigin, bool bitmatrix, bool border_inc,
   int *ntiles);
+extern STboxGridState *tpoint_grid_split_init(Temporal *temp,
+  STBoxGrid *grid, bool bitmatrix, bool border_inc, int *ntiles);
+
+extern bool signature_overlaps_stbox(uint64 sig, const STBox *box1,
+  const STBox *box2);
 
 /*****************************************************************************/
 
@@ -132,6 +132,18 @@
 #define pg_attribute_unused()
 #endif
 
+/*
+ * MEOS: storage class of the global variables that are kept per thread, such
+ * as the session timezone and the date and interval styles
+ */
+#ifndef MEOS_THREAD_LOCAL
+#ifdef _MSC_VER
+#define MEOS_THREAD_LOCAL __declspec(thread)
+#else
+#define MEOS_THREAD_LOCAL __thread
+#endif
+#endif
+
 /*
  * pg_nodiscard means the compiler should warn if the result of a function
  * call is ignored.  The name "nodiscard" is chosen in alignment with
@@ -70,7 +70,9 @@ extern size_t pg_strftime(char *s, size_t max, const char *format,
 
 /* these functions and variables are in pgtz.c */
 
-extern pg_tz *session_timezone;
+extern MEOS_THREAD_LOCAL pg_tz *session_timezone;
+/* MEOS: Session timezone loaded on first use */
+extern pg_tz *pg_session_timezone(void);
 extern pg_tz *log_timezone;
 
 extern void pg_timezone_initialize(void);
@@ -67,13 +67,19 @@
 #endif
 #define EXIT_FAILURE 1
 
-/* MEOS: redefining palloc0, palloc, and pfree */
+/* MEOS: redefining palloc0, palloc, and pfree, which use the allocator set
+ * with meos_set_allocator and the region opened with meos_region_begin */
 #if MEOS
-#define palloc0(X) (calloc(1, X))
-#define palloc malloc
-#define repalloc realloc
-#define pfree free
-#define pstrdup strdup
+extern void *meos_palloc(size_t size);
+extern void *meos_palloc0(size_t size);
+extern void *meos_repalloc(void *ptr, size_t size);
+extern void meos_pfree(void *ptr);
+extern char *meos_pstrdup(const char *str);
+#define palloc0(X) (meos_palloc0(X))
+#define palloc meos_palloc
+#define repalloc meos_repalloc
+#define pfree meos_pfree
+#define pstrdup meos_pstrdup
 #endif /* MEOS */
 
 /* ----------------------------------------------------------------
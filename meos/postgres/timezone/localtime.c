@@ -101,7 +101,7 @@ static bool typesequiv(struct state const *, int, int);
  * Thanks to Paul Eggert for noting this.
  */
 
-static struct pg_tm tm;
+static MEOS_THREAD_LOCAL struct pg_tm tm; /* MEOS */
 
 /* Initialize *S to a value based on UTOFF, ISDST, and DESIGIDX.  */
 static void
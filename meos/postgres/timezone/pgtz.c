@@ -18,6 +18,7 @@
 #include <dirent.h> /* MEOS */
 #include <common/hashfn.h> /* MEOS */
 #include <sys/stat.h> /* MEOS */
+#include <pthread.h> /* MEOS */
 // #include "datatype/timestamp.h" /* MEOS */
 #include "utils/timestamp_def.h"
 #include "pgtz.h"
@@ -56,8 +57,19 @@ static uint32 hash_string_pointer(const char *s);
 /* Function in findtimezone.c */
 extern const char *select_default_timezone(const char *share_path);
 
-/* Current session timezone (controlled by TimeZone GUC) */
-pg_tz *session_timezone = NULL;
+/* Current session timezone (controlled by TimeZone GUC)
+ * MEOS: The session timezone is kept per thread */
+MEOS_THREAD_LOCAL pg_tz *session_timezone = NULL;
+
+/* MEOS: Timezone set by meos_initialize_timezone and inherited by the threads
+ * initialized with meos_initialize_thread */
+static pg_tz *default_timezone = NULL;
+
+/* MEOS: Name of the default timezone when it is loaded on first use, an empty
+ * string stands for the local timezone of the system */
+static char default_timezone_name[TZ_STRLEN_MAX + 1];
+static bool default_timezone_pending = false;
+static pthread_mutex_t default_timezone_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* Current log timezone (controlled by log_timezone GUC) */
 // pg_tz *log_timezone = NULL; /* MEOS */
@@ -272,6 +284,9 @@ scan_directory_ci(const char *dirname, const char *fname, int fnamelen,
 
 static tzcache_hash *timezone_cache = NULL;
 
+/* MEOS: The timezone cache is shared by all threads */
+static pthread_mutex_t timezone_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static bool
 init_timezone_hashtable(void)
 {
@@ -298,8 +313,8 @@ init_timezone_hashtable(void)
  * 3. It's quick enough that we don't waste much time when the bootstrap
  * default timezone setting is later overridden from postgresql.conf.
  */
-pg_tz *
-pg_tzset(const char *name)
+static pg_tz *
+pg_tzset_internal(const char *name)
 {
   // pg_tz_cache *tzp; /* MEOS */
   struct state tzstate;
@@ -333,8 +348,10 @@ pg_tzset(const char *name)
 
   /*
    * "GMT" is always sent to tzparse(), as per discussion above.
+   * MEOS: "UTC" is also sent to tzparse() to avoid accessing the filesystem
+   * for the most frequent timezone of standalone programs.
    */
-  if (strcmp(uppername, "GMT") == 0)
+  if (strcmp(uppername, "GMT") == 0 || strcmp(uppername, "UTC") == 0)
   {
     if (!tzparse(uppername, &tzstate, true))
     {
@@ -375,6 +392,20 @@ pg_tzset(const char *name)
   return NULL;
 }
 
+/*
+ * MEOS: Serialize the accesses to the timezone cache shared by all threads.
+ * The returned timezones are never freed before meos_finalize_timezone and
+ * can thus be used without holding the lock.
+ */
+pg_tz *
+pg_tzset(const char *name)
+{
+  pthread_mutex_lock(&timezone_cache_mutex);
+  pg_tz *result = pg_tzset_internal(name);
+  pthread_mutex_unlock(&timezone_cache_mutex);
+  return result;
+}
+
 /*
  * Load a fixed-GMT-offset timezone.
  * This is used for SQL-spec SET TIME ZONE INTERVAL 'foo' cases.
@@ -436,6 +467,76 @@ meos_initialize_timezone(const char *tz_str)
   if (! session_timezone)
     meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
       "Failed to initialize local timezone");
+  default_timezone = session_timezone;
+  return;
+}
+
+/*
+ * Set the default timezone without loading it, which is done on first use by
+ * pg_session_timezone
+ */
+void
+meos_initialize_timezone_lazy(const char *tz_str)
+{
+  pthread_mutex_lock(&default_timezone_mutex);
+  if (tz_str && strlen(tz_str) > TZ_STRLEN_MAX)
+    tz_str = NULL;
+  strcpy(default_timezone_name, tz_str ? tz_str : "");
+  default_timezone_pending = true;
+  default_timezone = NULL;
+  pthread_mutex_unlock(&default_timezone_mutex);
+  session_timezone = NULL;
+  return;
+}
+
+/*
+ * Return the session timezone of the current thread, loading the default
+ * timezone on first use
+ */
+pg_tz *
+pg_session_timezone(void)
+{
+  if (session_timezone)
+    return session_timezone;
+  pthread_mutex_lock(&default_timezone_mutex);
+  if (! default_timezone)
+  {
+    const char *tz_str = default_timezone_pending ?
+      default_timezone_name : NULL;
+    if (tz_str == NULL || strlen(tz_str) == 0)
+      /* fetch local timezone */
+      tz_str = select_default_timezone(NULL);
+    if (tz_str == NULL)
+      /* default timezone */
+      tz_str = "GMT";
+    default_timezone = pg_tzset(tz_str);
+    default_timezone_pending = false;
+  }
+  session_timezone = default_timezone;
+  pthread_mutex_unlock(&default_timezone_mutex);
+  if (! session_timezone)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Failed to initialize local timezone");
+  return session_timezone;
+}
+
+/*
+ * Initialize the timezone of the current thread, which is the one set by
+ * meos_initialize_timezone if the argument is NULL or empty
+ */
+void
+meos_initialize_timezone_thread(const char *tz_str)
+{
+  if (tz_str == NULL || strlen(tz_str) == 0)
+  {
+    /* The default timezone is loaded on first use if it is not yet */
+    session_timezone = default_timezone;
+    return;
+  }
+  session_timezone = pg_tzset(tz_str);
+  if (! session_timezone)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Failed to initialize the timezone of the thread");
   return;
 }
 
@@ -445,8 +546,11 @@ meos_initialize_timezone(const char *tz_str)
 void
 meos_finalize_timezone(void)
 {
-  if (session_timezone)
+  if (timezone_cache)
     tzcache_destroy(timezone_cache);
+  timezone_cache = NULL;
+  session_timezone = default_timezone = NULL;
+  default_timezone_pending = false;
   return;
 }
 /*****************************************************************************/
@@ -368,13 +368,15 @@ GetCurrentTimeUsec(struct pg_tm *tm, fsec_t *fsec, int *tzp)
    * however, it might need another look if we ever allow entries in that
    * hash to be recycled.
    */
-  static TimestampTz cache_ts = 0;
-  static pg_tz *cache_timezone = NULL;
-  static struct pg_tm cache_tm;
-  static fsec_t cache_fsec;
-  static int  cache_tz;
-
-  if (cur_ts != cache_ts || session_timezone != cache_timezone)
+  /* MEOS: The cache is kept per thread */
+  static MEOS_THREAD_LOCAL TimestampTz cache_ts = 0;
+  static MEOS_THREAD_LOCAL pg_tz *cache_timezone = NULL;
+  static MEOS_THREAD_LOCAL struct pg_tm cache_tm;
+  static MEOS_THREAD_LOCAL fsec_t cache_fsec;
+  static MEOS_THREAD_LOCAL int  cache_tz;
+  pg_tz *session_tz = pg_session_timezone();
+
+  if (cur_ts != cache_ts || session_tz != cache_timezone)
   {
     /*
      * Make sure cache is marked invalid in case of error after partial
@@ -388,7 +390,7 @@ GetCurrentTimeUsec(struct pg_tm *tm, fsec_t *fsec, int *tzp)
      * within range, but check just for sanity's sake.
      */
     if (timestamp2tm(cur_ts, &cache_tz, &cache_tm, &cache_fsec, NULL,
-             session_timezone) != 0)
+             session_tz) != 0)
     {
       meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE, "timestamp out of range");
       return;
@@ -396,7 +398,7 @@ GetCurrentTimeUsec(struct pg_tm *tm, fsec_t *fsec, int *tzp)
 
     /* OK, so mark the cache valid. */
     cache_ts = cur_ts;
-    cache_timezone = session_timezone;
+    cache_timezone = session_tz;
   }
 
   *tm = cache_tm;
@@ -1454,7 +1456,7 @@ DecodeDateTime(char **field, int *ftype, int nf, int *dtype,
       if (fmask & DTK_M(DTZMOD))
         return DTERR_BAD_FORMAT;
 
-      *tzp = DetermineTimeZoneOffset(tm, session_timezone);
+      *tzp = DetermineTimeZoneOffset(tm, pg_session_timezone());
     }
   }
 
@@ -2306,7 +2308,7 @@ DecodeTimeOnly(char **field, int *ftype, int nf, int *dtype, struct pg_tm *tm,
     tmp->tm_hour = tm->tm_hour;
     tmp->tm_min = tm->tm_min;
     tmp->tm_sec = tm->tm_sec;
-    *tzp = DetermineTimeZoneOffset(tmp, session_timezone);
+    *tzp = DetermineTimeZoneOffset(tmp, pg_session_timezone());
     tm->tm_isdst = tmp->tm_isdst;
   }
 
@@ -22,10 +22,11 @@
 /* this struct is declared in utils/tzparser.h: */
 struct tzEntry;
 
-/* Definitions of the global variables taken from miscadmin.h */
-extern int DateStyle;
-extern int DateOrder;
-extern int IntervalStyle;
+/* Definitions of the global variables taken from miscadmin.h, which MEOS
+ * keeps per thread */
+extern MEOS_THREAD_LOCAL int DateStyle;
+extern MEOS_THREAD_LOCAL int DateOrder;
+extern MEOS_THREAD_LOCAL int IntervalStyle;
 
 /* valid DateOrder values taken */
 #define DATEORDER_YMD      0
@@ -367,9 +367,10 @@ typedef struct
 
 
 /* global cache for date/time format pictures */
-static DCHCacheEntry *DCHCache[DCH_CACHE_ENTRIES];
-static int  n_DCHCache = 0;    /* current number of entries */
-static int  DCHCounter = 0;    /* aging-event counter */
+/* MEOS: The cache is kept per thread */
+static MEOS_THREAD_LOCAL DCHCacheEntry *DCHCache[DCH_CACHE_ENTRIES];
+static MEOS_THREAD_LOCAL int  n_DCHCache = 0;    /* current number of entries */
+static MEOS_THREAD_LOCAL int  DCHCounter = 0;    /* aging-event counter */
 
 
 /* ----------
@@ -3315,7 +3316,7 @@ pg_to_timestamp(text *date_txt, text *fmt)
     }
   }
   else
-    tz = DetermineTimeZoneOffset(&tm, session_timezone);
+    tz = DetermineTimeZoneOffset(&tm, pg_session_timezone());
 
   if (tm2timestamp(&tm, fsec, &tz, &result) != 0)
   {
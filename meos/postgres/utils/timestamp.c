@@ -103,7 +103,7 @@ timestamp2tm(Timestamp dt, int *tzp, struct pg_tm *tm, fsec_t *fsec, const char
 
   /* Use session timezone if caller asks for default */
   if (attimezone == NULL)
-    attimezone = session_timezone;
+    attimezone = pg_session_timezone();
 
   time = dt;
   TMODULO(time, date, USECS_PER_DAY);
@@ -327,5 +327,83 @@ double4_cmp(const double4 *d1, const double4 *d2)
 }
 #endif /* not used */
 
-/*****************************************************************************/
+/*****************************************************************************
+ * Array kernels
+ * These functions process arrays of values in a single loop without
+ * allocating intermediate values, which the compiler may vectorize.
+ * The result array may be one of the input arrays.
+ *****************************************************************************/
+
+/**
+ * @brief Sum two arrays of double2 values
+ * @param[in] arr1,arr2 Arrays
+ * @param[in] count Number of elements in the arrays
+ * @param[out] result Array of the sums
+ */
+void
+double2arr_add(const double2 *arr1, const double2 *arr2, int count,
+  double2 *result)
+{
+  for (int i = 0; i < count; i++)
+  {
+    result[i].a = arr1[i].a + arr2[i].a;
+    result[i].b = arr1[i].b + arr2[i].b;
+  }
+  return;
+}
+
+/**
+ * @brief Sum two arrays of double3 values
+ * @param[in] arr1,arr2 Arrays
+ * @param[in] count Number of elements in the arrays
+ * @param[out] result Array of the sums
+ */
+void
+double3arr_add(const double3 *arr1, const double3 *arr2, int count,
+  double3 *result)
+{
+  for (int i = 0; i < count; i++)
+  {
+    result[i].a = arr1[i].a + arr2[i].a;
+    result[i].b = arr1[i].b + arr2[i].b;
+    result[i].c = arr1[i].c + arr2[i].c;
+  }
+  return;
+}
 
+/**
+ * @brief Sum two arrays of double4 values
+ * @param[in] arr1,arr2 Arrays
+ * @param[in] count Number of elements in the arrays
+ * @param[out] result Array of the sums
+ */
+void
+double4arr_add(const double4 *arr1, const double4 *arr2, int count,
+  double4 *result)
+{
+  for (int i = 0; i < count; i++)
+  {
+    result[i].a = arr1[i].a + arr2[i].a;
+    result[i].b = arr1[i].b + arr2[i].b;
+    result[i].c = arr1[i].c + arr2[i].c;
+    result[i].d = arr1[i].d + arr2[i].d;
+  }
+  return;
+}
+
+/**
+ * @brief Return the quotients of the components of an array of double2
+ * values, that is, the averages of their (sum, count) pairs
+ * @param[in] arr Array
+ * @param[in] count Number of elements in the array
+ * @param[out] result Array of the quotients
+ */
+void
+double2arr_div(const double2 *arr, int count, double *result)
+{
+  for (int i = 0; i < count; i++)
+    result[i] = arr[i].a / arr[i].b;
+  return;
+}
+
+/*****************************************************************************/
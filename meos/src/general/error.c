@@ -41,15 +41,23 @@
 #include <postgres.h>
 /* MEOS */
 #include <meos.h>
+#include <meos_internal.h>
 
 /*****************************************************************************
  * Global variables
  *****************************************************************************/
 
 /**
- * @brief Global variable that keeps the last error number
+ * @brief Global variable that keeps the last error number of the thread
  */
-static int MEOS_ERR_NO = 0;
+static MEOS_THREAD_LOCAL int MEOS_ERR_NO = 0;
+
+/**
+ * @brief Global variable stating whether the errors of the thread only set
+ * the error number without formatting the message nor calling the error
+ * handler
+ */
+static MEOS_THREAD_LOCAL bool MEOS_ERROR_QUIET = false;
 
 /**
  * @brief Read an error number
@@ -179,18 +187,54 @@ meos_initialize_error_handler(error_handler_fn err_handler)
 
 /*****************************************************************************/
 
+/**
+ * @brief Return true if the errors only set the error number
+ * @see #meos_error_quiet_set
+ */
+bool
+meos_error_quiet(void)
+{
+  return MEOS_ERROR_QUIET;
+}
+
+/**
+ * @brief Set whether the errors only set the error number without formatting
+ * the message nor calling the error handler
+ * @details This enables the caller to detect invalid arguments at a low cost
+ * by testing the result of the functions and the error number, as done by
+ * the `_try` variants of the constructors. Warnings and notices are not
+ * affected.
+ * @return Previous value of the setting, for restoring it afterwards
+ */
+bool
+meos_error_quiet_set(bool quiet)
+{
+  bool result = MEOS_ERROR_QUIET;
+  MEOS_ERROR_QUIET = quiet;
+  return result;
+}
+
 /**
  * @brief Function handling error messages
  */
 void
 meos_error(int errlevel, int errcode, char *format, ...)
 {
+  /* In quiet mode only the error number is set */
+  if (MEOS_ERROR_QUIET && errlevel >= ERROR)
+  {
+    MEOS_ERR_NO = errcode;
+    return;
+  }
   char buffer[1024];
   va_list args;
   va_start(args, format);
   /* TODO: maybe check if the error message was truncated */
   vsnprintf(buffer, sizeof(buffer), format, args);
   va_end(args);
+  /* The error handler may not return to the timed functions */
+  if (errlevel >= ERROR)
+    meos_stats_call_abort();
   /* Execute the error handler function */
   if (MEOS_ERROR_HANDLER)
     MEOS_ERROR_HANDLER(errlevel, errcode, buffer);
@@ -176,12 +176,133 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/meos_probes.h"
 #include "general/temporal_restrict.h"
+#include "general/tinstant.h"
 #include "general/tsequence.h"
 #include "general/tsequenceset.h"
 #include "general/type_util.h"
 #include "point/tpoint_spatialfuncs.h"
 
+/*****************************************************************************
+ * Scratch block for the instants of the result of a lifted function
+ *****************************************************************************/
+
+/**
+ * @brief Structure to represent a scratch block in which the instants of the
+ * result of a lifted function are constructed contiguously
+ * @details The instants are obtained by advancing an offset in the block
+ * instead of calling palloc for each of them. The instants are copied into
+ * the resulting sequence and the block is freed at once afterwards. The block
+ * is only used when the base type of the result is passed by value, e.g., for
+ * lifted comparisons and arithmetic, since then all the instants have the
+ * same size and the size of the block can be determined in advance.
+ */
+typedef struct
+{
+  char *block;         /**< Scratch block, NULL if not used */
+  size_t size;         /**< Size of the scratch block */
+  size_t used;         /**< Number of bytes used in the scratch block */
+} LiftArena;
+
+/**
+ * @brief Initialize a scratch block for a maximum number of instants
+ * @param[out] arena Scratch block
+ * @param[in] restype Temporal type of the instants
+ * @param[in] count Maximum number of instants
+ */
+static void
+lift_arena_init(LiftArena *arena, meosType restype, int count)
+{
+  arena->used = 0;
+  if (count > 0 && basetype_byvalue(temptype_basetype(restype)))
+  {
+    arena->size = tinstant_make_size((Datum) 0, restype) * count;
+    arena->block = palloc(arena->size);
+  }
+  else
+  {
+    arena->size = 0;
+    arena->block = NULL;
+  }
+  return;
+}
+
+/**
+ * @brief Return true if a temporal instant is located in a scratch block
+ */
+static inline bool
+lift_arena_owns(const LiftArena *arena, const TInstant *inst)
+{
+  return arena->block && (const char *) inst >= arena->block &&
+    (const char *) inst < arena->block + arena->size;
+}
+
+/**
+ * @brief Return a temporal instant constructed in a scratch block, or
+ * allocated with palloc when the block is not used or is full, and free the
+ * base value
+ */
+static TInstant *
+lift_arena_make_free(LiftArena *arena, Datum value, meosType restype,
+  TimestampTz t)
+{
+  if (arena->block)
+  {
+    size_t size = tinstant_make_size(value, restype);
+    if (arena->used + size <= arena->size)
+    {
+      /* Values passed by value do not need to be freed */
+      TInstant *result = tinstant_make_in(arena->block + arena->used, value,
+        restype, t);
+      arena->used += size;
+      return result;
+    }
+  }
+  return tinstant_make_free(value, restype, t);
+}
+
+/**
+ * @brief Return a temporal sequence from an array of instants constructed
+ * with a scratch block, and free the array, the instants that are not in the
+ * block, and the block
+ * @see #tsequence_make_free
+ */
+static TSequence *
+lift_arena_tsequence_make_free(LiftArena *arena, TInstant **instants,
+  int count, bool lower_inc, bool upper_inc, interpType interp, bool normalize)
+{
+  TSequence *result = (count == 0) ? NULL :
+    tsequence_make((const TInstant **) instants, count, lower_inc, upper_inc,
+      interp, normalize);
+  for (int i = 0; i < count; i++)
+  {
+    if (! lift_arena_owns(arena, instants[i]))
+      pfree(instants[i]);
+  }
+  pfree(instants);
+  if (arena->block)
+    pfree(arena->block);
+  arena->block = NULL;
+  arena->size = arena->used = 0;
+  return result;
+}
+
+/**
+ * @brief Return the number of instants of a temporal value for the runtime
+ * statistics and the probes, without removing the duplicates between the
+ * sequences
+ */
+static inline int64
+lifting_stat_instants(const Temporal *temp)
+{
+  if (temp->subtype == TINSTANT)
+    return 1;
+  if (temp->subtype == TSEQUENCE)
+    return ((TSequence *) temp)->count;
+  return ((TSequenceSet *) temp)->totalcount;
+}
+
 /*****************************************************************************
  * Functions where the argument is a temporal type.
  * The function is applied to the composing instants.
@@ -231,11 +352,19 @@ tfunc_tinstant(const TInstant *inst, LiftedFunctionInfo *lfinfo)
 TSequence *
 tfunc_tsequence(const TSequence *seq, LiftedFunctionInfo *lfinfo)
 {
+  LiftArena arena;
+  lift_arena_init(&arena, lfinfo->restype, seq->count);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   for (int i = 0; i < seq->count; i++)
-    instants[i] = tfunc_tinstant(TSEQUENCE_INST_N(seq, i), lfinfo);
-  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
-    seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    Datum resvalue = tfunc_base(tinstant_val(inst), lfinfo);
+    instants[i] = lift_arena_make_free(&arena, resvalue, lfinfo->restype,
+      inst->t);
+  }
+  return lift_arena_tsequence_make_free(&arena, instants, seq->count,
+    seq->period.lower_inc, seq->period.upper_inc,
+    MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
 }
 
 /**
@@ -261,6 +390,7 @@ Temporal *
 tfunc_temporal(const Temporal *temp, LiftedFunctionInfo *lfinfo)
 {
   assert(temptype_subtype(temp->subtype));
+  MEOS_STAT_ADD(MEOS_STAT_LIFTED_INSTANTS, lifting_stat_instants(temp));
   switch (temp->subtype)
   {
     case TINSTANT:
@@ -327,11 +457,19 @@ TSequence *
 tfunc_tsequence_base(const TSequence *seq, Datum value,
   LiftedFunctionInfo *lfinfo)
 {
+  LiftArena arena;
+  lift_arena_init(&arena, lfinfo->restype, seq->count);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   for (int i = 0; i < seq->count; i++)
-    instants[i] = tfunc_tinstant_base(TSEQUENCE_INST_N(seq, i), value, lfinfo);
-  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
-    seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    Datum resvalue = tfunc_base_base(tinstant_val(inst), value, lfinfo);
+    instants[i] = lift_arena_make_free(&arena, resvalue, lfinfo->restype,
+      inst->t);
+  }
+  return lift_arena_tsequence_make_free(&arena, instants, seq->count,
+    seq->period.lower_inc, seq->period.upper_inc,
+    MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
 }
 
 /**
@@ -348,6 +486,8 @@ tfunc_tlinearseq_base_turnpt(const TSequence *seq, Datum value,
   LiftedFunctionInfo *lfinfo, TSequence **result)
 {
   int ninsts = 0;
+  LiftArena arena;
+  lift_arena_init(&arena, lfinfo->restype, seq->count * 2);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count * 2);
   const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
   Datum value1 = tinstant_val(inst1);
@@ -357,7 +497,8 @@ tfunc_tlinearseq_base_turnpt(const TSequence *seq, Datum value,
     /* Each iteration of the loop adds between one and two instants */
     const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
     Datum value2 = tinstant_val(inst2);
-    instants[ninsts++] = tfunc_tinstant_base(inst1, value, lfinfo);
+    instants[ninsts++] = lift_arena_make_free(&arena,
+      tfunc_base_base(value1, value, lfinfo), lfinfo->restype, inst1->t);
     /* If not constant segment and linear compute the function on the potential
        intermediate turning point before adding the new instant */
     Datum intervalue;
@@ -367,15 +508,16 @@ tfunc_tlinearseq_base_turnpt(const TSequence *seq, Datum value,
       lfinfo->tpfunc_base(inst1, inst2, value, lfinfo->argtype[1],
         &intervalue, &intertime))
     {
-      instants[ninsts++] = tinstant_make_free(intervalue, lfinfo->restype,
-        intertime);
+      instants[ninsts++] = lift_arena_make_free(&arena, intervalue,
+        lfinfo->restype, intertime);
     }
     inst1 = inst2;
     value1 = value2;
   }
-  instants[ninsts++] = tfunc_tinstant_base(inst1, value, lfinfo);
-  result[0] = tsequence_make_free(instants, ninsts, seq->period.lower_inc,
-    seq->period.upper_inc, interp, NORMALIZE);
+  instants[ninsts++] = lift_arena_make_free(&arena,
+    tfunc_base_base(value1, value, lfinfo), lfinfo->restype, inst1->t);
+  result[0] = lift_arena_tsequence_make_free(&arena, instants, ninsts,
+    seq->period.lower_inc, seq->period.upper_inc, interp, NORMALIZE);
   return 1;
 }
 
@@ -620,6 +762,7 @@ tfunc_temporal_base(const Temporal *temp, Datum value,
   LiftedFunctionInfo *lfinfo)
 {
   assert(temptype_subtype(temp->subtype));
+  MEOS_STAT_ADD(MEOS_STAT_LIFTED_INSTANTS, lifting_stat_instants(temp));
   switch (temp->subtype)
   {
     case TINSTANT:
@@ -814,24 +957,27 @@ static TSequence *
 tfunc_tcontseq_tdiscseq(const TSequence *seq1, const TSequence *seq2,
   LiftedFunctionInfo *lfinfo)
 {
-  TInstant **instants = palloc(sizeof(TInstant *) * seq2->count);
+  /* Get the values of the first sequence at the instants of the second one
+   * in a single pass over both sequences */
+  int count;
+  TimestampTz *times = tsequence_timestamps(seq2, &count);
+  Datum *values = palloc(sizeof(Datum) * count);
+  bool *found = palloc(sizeof(bool) * count);
+  tsequence_values_at_timestamps(seq1, times, count, true, values, found);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
   int ninsts = 0;
-  TimestampTz upper1 = DatumGetTimestampTz(seq1->period.upper);
-  for (int i = 0; i < seq2->count; i++)
+  meosType basetype = temptype_basetype(seq1->temptype);
+  for (int i = 0; i < count; i++)
   {
+    if (! found[i])
+      continue;
     const TInstant *inst = TSEQUENCE_INST_N(seq2, i);
-    if (contains_span_timestamptz(&seq1->period, inst->t))
-    {
-      Datum value;
-      tsequence_value_at_timestamptz(seq1, inst->t, true, &value);
-      Datum resvalue = tfunc_base_base(value, tinstant_val(inst), lfinfo);
-      DATUM_FREE(value, temptype_basetype(seq1->temptype));
-      instants[ninsts++] = tinstant_make_free(resvalue, lfinfo->restype,
-        inst->t);
-    }
-    if (upper1 < inst->t)
-      break;
+    Datum resvalue = tfunc_base_base(values[i], tinstant_val(inst), lfinfo);
+    DATUM_FREE(values[i], basetype);
+    instants[ninsts++] = tinstant_make_free(resvalue, lfinfo->restype,
+      inst->t);
   }
+  pfree(times); pfree(values); pfree(found);
   return tsequence_make_free(instants, ninsts, true, true, DISCRETE, NORMALIZE_NO);
 }
 
@@ -857,33 +1003,27 @@ static TSequence *
 tfunc_tsequenceset_tdiscseq(const TSequenceSet *ss, const TSequence *seq,
   LiftedFunctionInfo *lfinfo)
 {
-  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  int i = 0, j = 0, ninsts = 0;
+  /* Get the values of the sequence set at the instants of the sequence in a
+   * single pass over both values */
+  int count;
+  TimestampTz *times = tsequence_timestamps(seq, &count);
+  Datum *values = palloc(sizeof(Datum) * count);
+  bool *found = palloc(sizeof(bool) * count);
+  tsequenceset_values_at_timestamps(ss, times, count, true, values, found);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  int ninsts = 0;
   meosType basetype = temptype_basetype(ss->temptype);
-  while (i < ss->count && j < seq->count)
+  for (int i = 0; i < count; i++)
   {
-    const TSequence *seq1 = TSEQUENCESET_SEQ_N(ss, i);
-    const TInstant *inst = TSEQUENCE_INST_N(seq, j);
-    if (contains_span_timestamptz(&seq1->period, inst->t))
-    {
-      Datum value;
-      tsequenceset_value_at_timestamptz(ss, inst->t, true, &value);
-      Datum resvalue = tfunc_base_base(value, tinstant_val(inst), lfinfo);
-      DATUM_FREE(value, basetype);
-      instants[ninsts++] = tinstant_make_free(resvalue, lfinfo->restype,
-        inst->t);
-    }
-    int cmp = timestamptz_cmp_internal(DatumGetTimestampTz(seq1->period.upper),
+    if (! found[i])
+      continue;
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    Datum resvalue = tfunc_base_base(values[i], tinstant_val(inst), lfinfo);
+    DATUM_FREE(values[i], basetype);
+    instants[ninsts++] = tinstant_make_free(resvalue, lfinfo->restype,
       inst->t);
-    if (cmp == 0)
-    {
-      i++; j++;
-    }
-    else if (cmp < 0)
-      i++;
-    else
-      j++;
   }
+  pfree(times); pfree(values); pfree(found);
   return tsequence_make_free(instants, ninsts, true, true, DISCRETE, NORMALIZE_NO);
 }
 
@@ -944,6 +1084,8 @@ tfunc_tcontseq_tcontseq_single(const TSequence *seq1, const TSequence *seq2,
     inst2 = (TInstant *) TSEQUENCE_INST_N(seq2, j);
   }
   int count = (seq1->count - i + seq2->count - j) * 2;
+  LiftArena arena;
+  lift_arena_init(&arena, lfinfo->restype, count);
   TInstant **instants = palloc(sizeof(TInstant *) * count);
   TInstant **tofree = palloc(sizeof(TInstant *) * count);
   Datum value;
@@ -976,11 +1118,13 @@ tfunc_tcontseq_tcontseq_single(const TSequence *seq1, const TSequence *seq2,
       bool found = lfinfo->tpfunc(prev1, inst1, prev2, inst2, &value, &tptime);
       /* Avoid adding a turning point at the same timestamp added next */
       if (found && tptime != prev1->t)
-        instants[ninsts++] = tinstant_make_free(value, lfinfo->restype, tptime);
+        instants[ninsts++] = lift_arena_make_free(&arena, value,
+          lfinfo->restype, tptime);
     }
     /* Compute the function on the synchronized instants */
     value = tfunc_base_base(tinstant_val(inst1), tinstant_val(inst2), lfinfo);
-    instants[ninsts++] = tinstant_make_free(value, lfinfo->restype, inst1->t);
+    instants[ninsts++] = lift_arena_make_free(&arena, value, lfinfo->restype,
+      inst1->t);
     if (i == seq1->count || j == seq2->count)
       break;
     prev1 = inst1;
@@ -993,7 +1137,8 @@ tfunc_tcontseq_tcontseq_single(const TSequence *seq1, const TSequence *seq2,
      exclusive upper bound must be equal */
   if (! lfinfo->reslinear && ! inter->upper_inc && ninsts > 1)
   {
-    tofree[nfree++] = instants[ninsts - 1];
+    if (! lift_arena_owns(&arena, instants[ninsts - 1]))
+      tofree[nfree++] = instants[ninsts - 1];
     value = tinstant_val(instants[ninsts - 2]);
     instants[ninsts - 1] = tinstant_make(value, lfinfo->restype,
       instants[ninsts - 1]->t);
@@ -1001,8 +1146,66 @@ tfunc_tcontseq_tcontseq_single(const TSequence *seq1, const TSequence *seq2,
   pfree_array((void **) tofree, nfree);
   interpType interp = Min(MEOS_FLAGS_GET_INTERP(seq1->flags),
     MEOS_FLAGS_GET_INTERP(seq2->flags));
-  result[0] = tsequence_make_free(instants, ninsts, inter->lower_inc,
-    inter->upper_inc, interp, NORMALIZE);
+  result[0] = lift_arena_tsequence_make_free(&arena, instants, ninsts,
+    inter->lower_inc, inter->upper_inc, interp, NORMALIZE);
+  return 1;
+}
+
+/**
+ * @brief Apply a lifted function to two temporal sequences with the same
+ * timestamps
+ * @details The instants of the two sequences are zipped without computing
+ * synchronization points. This is the case, for example, when the two
+ * sequences have been sampled on the same grid.
+ * @param[in] seq1,seq2 Temporal values
+ * @param[in] lfinfo Information about the lifted function
+ * @param[out] result Array on which the pointer of the newly constructed
+ * sequence is stored
+ */
+static int
+tfunc_tcontseq_tcontseq_zip(const TSequence *seq1, const TSequence *seq2,
+  LiftedFunctionInfo *lfinfo, TSequence **result)
+{
+  int count = (lfinfo->tpfunc != NULL) ? seq1->count * 2 : seq1->count;
+  LiftArena arena;
+  lift_arena_init(&arena, lfinfo->restype, count);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  const TInstant *prev1 = NULL, *prev2 = NULL; /* make compiler quiet */
+  int ninsts = 0;
+  Datum value;
+  for (int i = 0; i < seq1->count; i++)
+  {
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq1, i);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq2, i);
+    /* If not the first instant compute the function on the potential
+       turning point before adding the new instants */
+    if (lfinfo->tpfunc != NULL && i > 0)
+    {
+      TimestampTz tptime;
+      bool found = lfinfo->tpfunc(prev1, inst1, prev2, inst2, &value, &tptime);
+      if (found && tptime != prev1->t)
+        instants[ninsts++] = lift_arena_make_free(&arena, value,
+          lfinfo->restype, tptime);
+    }
+    value = tfunc_base_base(tinstant_val(inst1), tinstant_val(inst2), lfinfo);
+    instants[ninsts++] = lift_arena_make_free(&arena, value, lfinfo->restype,
+      inst1->t);
+    prev1 = inst1;
+    prev2 = inst2;
+  }
+  /* The last two values of sequences with step interpolation and
+     exclusive upper bound must be equal */
+  if (! lfinfo->reslinear && ! seq1->period.upper_inc && ninsts > 1)
+  {
+    TInstant *last = instants[ninsts - 1];
+    instants[ninsts - 1] = tinstant_make(tinstant_val(instants[ninsts - 2]),
+      lfinfo->restype, last->t);
+    if (! lift_arena_owns(&arena, last))
+      pfree(last);
+  }
+  result[0] = lift_arena_tsequence_make_free(&arena, instants, ninsts,
+    seq1->period.lower_inc, seq1->period.upper_inc,
+    MEOS_FLAGS_GET_INTERP(seq1->flags), NORMALIZE);
   return 1;
 }
 
@@ -1335,6 +1538,8 @@ tfunc_tcontseq_tcontseq_dispatch(const TSequence *seq1, const TSequence *seq2,
 
   bool linear1 = MEOS_FLAGS_LINEAR_INTERP(seq1->flags);
   bool linear2 = MEOS_FLAGS_LINEAR_INTERP(seq2->flags);
+  if (linear1 == linear2 && tsequence_same_timestamps(seq1, seq2))
+    return tfunc_tcontseq_tcontseq_zip(seq1, seq2, lfinfo, result);
   if (linear1 == linear2)
     return tfunc_tcontseq_tcontseq_single(seq1, seq2, lfinfo, &inter, result);
   else
@@ -1493,11 +1698,12 @@ tfunc_tsequenceset_tsequenceset(const TSequenceSet *ss1,
 
 /**
  * @brief Synchronize two temporal values and apply to them a lifted function
+ * (dispatch function)
  * @param[in] temp1,temp2 Temporal values
  * @param[in] lfinfo Information about the lifted function
  */
-Temporal *
-tfunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
+static Temporal *
+tfunc_temporal_temporal_dispatch(const Temporal *temp1, const Temporal *temp2,
   LiftedFunctionInfo *lfinfo)
 {
   /* Bounding box test */
@@ -1507,6 +1713,9 @@ tfunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
   if (! over_span_span(&s1, &s2))
     return NULL;
 
+  MEOS_STAT_ADD(MEOS_STAT_LIFTED_INSTANTS,
+    lifting_stat_instants(temp1) + lifting_stat_instants(temp2));
+
   tempSubtype subtype1 = temp1->subtype;
   tempSubtype subtype2 = temp2->subtype;
   assert(temptype_subtype(subtype1));
@@ -1591,6 +1800,151 @@ tfunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
   }
 }
 
+/**
+ * @brief Synchronize two temporal values and apply to them a lifted function
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] lfinfo Information about the lifted function
+ */
+Temporal *
+tfunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
+  LiftedFunctionInfo *lfinfo)
+{
+  MEOS_PROBE_TFUNC_START(lifting_stat_instants(temp1),
+    lifting_stat_instants(temp2));
+  Temporal *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_LIFTING,
+    result = tfunc_temporal_temporal_dispatch(temp1, temp2, lfinfo));
+  MEOS_PROBE_TFUNC_DONE(result ? lifting_stat_instants(result) : 0);
+  return result;
+}
+
+/*****************************************************************************
+ * Iterator over the synchronized segments of two temporal sequences
+ *****************************************************************************/
+
+/**
+ * @brief Initialize an iterator over the pairs of synchronized segments of
+ * two temporal continuous sequences
+ * @param[out] iter Iterator
+ * @param[in] seq1,seq2 Temporal values
+ * @param[in] inter Overlapping period of the two sequences
+ * @note The start instants of the iterator are set to the lower bound of the
+ * overlapping period, the first call to #syncsegm_iter_next sets the end
+ * instants of the first segment pair
+ */
+void
+syncsegm_iter_init(SyncSegmIter *iter, const TSequence *seq1,
+  const TSequence *seq2, const Span *inter)
+{
+  assert(iter); assert(seq1); assert(seq2); assert(inter);
+  assert(! MEOS_FLAGS_DISCRETE_INTERP(seq1->flags));
+  assert(! MEOS_FLAGS_DISCRETE_INTERP(seq2->flags));
+  memset(iter, 0, sizeof(SyncSegmIter));
+  iter->seq1 = seq1;
+  iter->seq2 = seq2;
+  iter->interp1 = MEOS_FLAGS_GET_INTERP(seq1->flags);
+  iter->interp2 = MEOS_FLAGS_GET_INTERP(seq2->flags);
+  iter->start1 = TSEQUENCE_INST_N(seq1, 0);
+  iter->start2 = TSEQUENCE_INST_N(seq2, 0);
+  iter->i = iter->j = 1;
+  /* Synchronize the two start instants */
+  TimestampTz lower = DatumGetTimestampTz(inter->lower);
+  if (iter->start1->t < lower)
+  {
+    iter->start1 = tsequence_at_timestamptz(seq1, lower);
+    iter->free_start1 = true;
+    iter->i = tcontseq_find_timestamptz(seq1, lower) + 1;
+  }
+  else if (iter->start2->t < lower)
+  {
+    iter->start2 = tsequence_at_timestamptz(seq2, lower);
+    iter->free_start2 = true;
+    iter->j = tcontseq_find_timestamptz(seq2, lower) + 1;
+  }
+  iter->lower_inc = inter->lower_inc;
+  iter->last_upper_inc = inter->upper_inc;
+  return;
+}
+
+/**
+ * @brief Advance an iterator over the synchronized segments of two temporal
+ * continuous sequences to the next pair of segments
+ * @details The end instants of the previous pair become the start instants
+ * of the next pair. When the function returns false the start instants of
+ * the iterator are the last synchronized instants of the sequences.
+ * @param[in,out] iter Iterator
+ * @return True if there is a next pair of segments
+ */
+bool
+syncsegm_iter_next(SyncSegmIter *iter)
+{
+  assert(iter);
+  /* Shift the end instants of the previous pair of segments, if any */
+  if (iter->end1)
+  {
+    if (iter->free_start1)
+      pfree((void *) iter->start1);
+    if (iter->free_start2)
+      pfree((void *) iter->start2);
+    iter->start1 = iter->end1; iter->free_start1 = iter->free_end1;
+    iter->start2 = iter->end2; iter->free_start2 = iter->free_end2;
+    iter->end1 = iter->end2 = NULL;
+    iter->free_end1 = iter->free_end2 = false;
+    iter->lower_inc = true;
+  }
+  if (iter->i >= iter->seq1->count || iter->j >= iter->seq2->count)
+    return false;
+
+  /* Synchronize the two end instants */
+  const TInstant *end1 = TSEQUENCE_INST_N(iter->seq1, iter->i);
+  const TInstant *end2 = TSEQUENCE_INST_N(iter->seq2, iter->j);
+  int cmp = timestamptz_cmp_internal(end1->t, end2->t);
+  if (cmp == 0)
+  {
+    iter->i++; iter->j++;
+  }
+  else if (cmp < 0)
+  {
+    iter->i++;
+    end2 = tsegment_at_timestamptz(iter->start2, end2, iter->interp2,
+      end1->t);
+    iter->free_end2 = true;
+  }
+  else
+  {
+    iter->j++;
+    end1 = tsegment_at_timestamptz(iter->start1, end1, iter->interp1,
+      end2->t);
+    iter->free_end1 = true;
+  }
+  iter->end1 = end1;
+  iter->end2 = end2;
+  iter->upper_inc = (iter->i >= iter->seq1->count ||
+    iter->j >= iter->seq2->count) ? iter->last_upper_inc : false;
+  return true;
+}
+
+/**
+ * @brief Free the synchronization instants kept by an iterator over the
+ * synchronized segments of two temporal continuous sequences
+ */
+void
+syncsegm_iter_free(SyncSegmIter *iter)
+{
+  assert(iter);
+  if (iter->free_start1)
+    pfree((void *) iter->start1);
+  if (iter->free_end1)
+    pfree((void *) iter->end1);
+  if (iter->free_start2)
+    pfree((void *) iter->start2);
+  if (iter->free_end2)
+    pfree((void *) iter->end2);
+  iter->free_start1 = iter->free_end1 = false;
+  iter->free_start2 = iter->free_end2 = false;
+  return;
+}
+
 /*****************************************************************************
  * Functions that take either (1) a temporal value and a base value, or (2) two
  * temporal values and apply to them a Boolean functio using the ever/always
@@ -1783,6 +2137,7 @@ eafunc_temporal_base(const Temporal *temp, Datum value,
 {
   assert(temp);
   assert(temptype_subtype(temp->subtype));
+  MEOS_STAT_ADD(MEOS_STAT_LIFTED_INSTANTS, lifting_stat_instants(temp));
   switch (temp->subtype)
   {
     case TINSTANT:
@@ -2078,73 +2433,39 @@ eafunc_tcontseq_tcontseq_discfn(const TSequence *seq1,
   const TSequence *seq2, LiftedFunctionInfo *lfinfo, Span *inter)
 {
   assert(seq1); assert(seq2); assert(seq1->temptype == seq2->temptype);
-  /* Array that keeps the new instants added for synchronization */
-  TInstant **tofree = palloc(sizeof(TInstant *) *
-    (seq1->count + seq2->count) * 2);
-  TInstant *start1 = (TInstant *) TSEQUENCE_INST_N(seq1, 0);
-  TInstant *start2 = (TInstant *) TSEQUENCE_INST_N(seq2, 0);
-  int i = 1, j = 1, nfree = 0;
-  /* Synchronize two start instant */
-  if (start1->t < DatumGetTimestampTz(inter->lower))
-  {
-    start1 = tsequence_at_timestamptz(seq1, inter->lower);
-    tofree[nfree++] = start1;
-    i = tcontseq_find_timestamptz(seq1, inter->lower) + 1;
-  }
-  else if (start2->t < DatumGetTimestampTz(inter->lower))
-  {
-    start2 = tsequence_at_timestamptz(seq2, inter->lower);
-    tofree[nfree++] = start2;
-    j = tcontseq_find_timestamptz(seq2, inter->lower) + 1;
-  }
-  bool lower_inc = inter->lower_inc;
   interpType interp1 = MEOS_FLAGS_GET_INTERP(seq1->flags);
   interpType interp2 = MEOS_FLAGS_GET_INTERP(seq2->flags);
-  Datum startvalue1, startvalue2;
   meosType basetype = temptype_basetype(seq1->temptype);
-  bool res;
-  while (i < seq1->count && j < seq2->count)
+  /* The segments are synchronized on the fly and the loop stops at the first
+   * true value (for ever) or false value (for always) */
+  SyncSegmIter iter;
+  syncsegm_iter_init(&iter, seq1, seq2, inter);
+  Datum startvalue1, startvalue2;
+  bool res, found = false;
+  while (! found && syncsegm_iter_next(&iter))
   {
     /* Compute the function at the start instant */
-    startvalue1 = tinstant_val(start1);
-    startvalue2 = tinstant_val(start2);
-    if (lower_inc)
+    startvalue1 = tinstant_val(iter.start1);
+    startvalue2 = tinstant_val(iter.start2);
+    if (iter.lower_inc)
     {
       res = DatumGetBool(tfunc_base_base(startvalue1, startvalue2, lfinfo));
       if ((lfinfo->ever && res) || (! lfinfo->ever && ! res))
       {
-        pfree_array((void **) tofree, nfree);
-        return lfinfo->ever ? 1 : 0;
+        found = true;
+        break;
       }
     }
-    /* Synchronize two end instants */
-    TInstant *end1 = (TInstant *) TSEQUENCE_INST_N(seq1, i);
-    TInstant *end2 = (TInstant *) TSEQUENCE_INST_N(seq2, j);
-    int cmp = timestamptz_cmp_internal(end1->t, end2->t);
-    if (cmp == 0)
-    {
-      i++; j++;
-    }
-    else if (cmp < 0)
-    {
-      i++;
-      end2 = tsegment_at_timestamptz(start2, end2, interp2, end1->t);
-      tofree[nfree++] = end2;
-    }
-    else
-    {
-      j++;
-      end1 = tsegment_at_timestamptz(start1, end1, interp1, end2->t);
-      tofree[nfree++] = end1;
-    }
     /* Compute the function at the end instant */
-    Datum endvalue1 = (interp1 == LINEAR) ? tinstant_val(end1) : startvalue1;
-    Datum endvalue2 = (interp2 == LINEAR) ? tinstant_val(end2) : startvalue2;
+    Datum endvalue1 = (interp1 == LINEAR) ?
+      tinstant_val(iter.end1) : startvalue1;
+    Datum endvalue2 = (interp2 == LINEAR) ?
+      tinstant_val(iter.end2) : startvalue2;
     res = DatumGetBool(tfunc_base_base(endvalue1, endvalue2, lfinfo));
     if ((lfinfo->ever && res) || (! lfinfo->ever && ! res))
     {
-      pfree_array((void **) tofree, nfree);
-      return lfinfo->ever ? 1 : 0;
+      found = true;
+      break;
     }
     /* If either the start values or the end values are equal, determine
      * whether there is a crossing and if there is one compute the value at
@@ -2154,33 +2475,28 @@ eafunc_tcontseq_tcontseq_discfn(const TSequence *seq1,
     {
       Datum intvalue1, intvalue2;
       TimestampTz inttime;
-      bool hascross = tsegment_intersection(start1, end1, interp1,
-        start2, end2, interp2, &intvalue1, &intvalue2, &inttime);
+      bool hascross = tsegment_intersection(iter.start1, iter.end1, interp1,
+        iter.start2, iter.end2, interp2, &intvalue1, &intvalue2, &inttime);
       if (hascross)
       {
         res = DatumGetBool(tfunc_base_base(intvalue1, intvalue2, lfinfo));
         if ((lfinfo->ever && res) || (! lfinfo->ever && ! res))
-        {
-          pfree_array((void **) tofree, nfree);
-          return lfinfo->ever ? 1 : 0;
-        }
+          found = true;
       }
     }
-    start1 = end1; start2 = end2;
-    lower_inc = true;
   }
-  /* Add a final instant if any */
-  if (inter->upper_inc)
+  /* Compute the function at the final instant if any, when the loop ends the
+   * start instants of the iterator are the last synchronized instants */
+  if (! found && inter->upper_inc)
   {
-    res = DatumGetBool(tfunc_base_base(tinstant_val(start1),
-      tinstant_val(start2), lfinfo));
+    res = DatumGetBool(tfunc_base_base(tinstant_val(iter.start1),
+      tinstant_val(iter.start2), lfinfo));
     if ((lfinfo->ever && res) || (! lfinfo->ever && ! res))
-    {
-      pfree_array((void **) tofree, nfree);
-      return lfinfo->ever ? 1 : 0;
-    }
+      found = true;
   }
-  pfree_array((void **) tofree, nfree);
+  syncsegm_iter_free(&iter);
+  if (found)
+    return lfinfo->ever ? 1 : 0;
   return lfinfo->ever ? 0 : 1;
 }
 
@@ -2326,11 +2642,12 @@ eafunc_tsequenceset_tsequenceset(const TSequenceSet *ss1,
 
 /**
  * @brief Synchronize two temporal values and apply to them a lifted function
+ * (dispatch function)
  * @param[in] temp1,temp2 Temporal values
  * @param[in] lfinfo Information about the lifted function
  */
-int
-eafunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
+static int
+eafunc_temporal_temporal_dispatch(const Temporal *temp1, const Temporal *temp2,
   LiftedFunctionInfo *lfinfo)
 {
   assert(temp1); assert(temp2); assert(temp1->temptype == temp2->temptype);
@@ -2341,6 +2658,9 @@ eafunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
   if (! over_span_span(&s1, &s2))
     return -1;
 
+  MEOS_STAT_ADD(MEOS_STAT_LIFTED_INSTANTS,
+    lifting_stat_instants(temp1) + lifting_stat_instants(temp2));
+
   assert(temptype_subtype(temp1->subtype));
   assert(temptype_subtype(temp2->subtype));
   switch (temp1->subtype)
@@ -2425,4 +2745,22 @@ eafunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
   }
 }
 
+/**
+ * @brief Synchronize two temporal values and apply to them a lifted function
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] lfinfo Information about the lifted function
+ */
+int
+eafunc_temporal_temporal(const Temporal *temp1, const Temporal *temp2,
+  LiftedFunctionInfo *lfinfo)
+{
+  MEOS_PROBE_EAFUNC_START(lifting_stat_instants(temp1),
+    lifting_stat_instants(temp2));
+  int result;
+  MEOS_STATS_CALL(MEOS_FAMILY_LIFTING,
+    result = eafunc_temporal_temporal_dispatch(temp1, temp2, lfinfo));
+  MEOS_PROBE_EAFUNC_DONE(result);
+  return result;
+}
+
 /*****************************************************************************/
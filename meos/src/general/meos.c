@@ -34,7 +34,12 @@
  */
 
 /* C */
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#if MEOS
+  #include <pthread.h>
+#endif
 /* PostgreSQL */
 #include <postgres.h>
 /* GSL */
@@ -42,29 +47,50 @@
 #include <gsl/gsl_randist.h>
 /* Proj */
 #include <proj.h>
+/* PostGIS */
+#include <stringbuffer.h>
 /* MEOS */
 #include <meos.h>
-// #include <meos_internal.h>
+#include <meos_internal.h>
 
 /***************************************************************************
  * Functions for the Gnu Scientific Library (GSL)
  ***************************************************************************/
 
-/* Global variables */
+/* Global variables, the random generators are kept per thread */
+
+static MEOS_THREAD_LOCAL bool MEOS_GSL_INITIALIZED = false;
+static MEOS_THREAD_LOCAL gsl_rng *MEOS_GENERATION_RNG = NULL;
+static MEOS_THREAD_LOCAL gsl_rng *MEOS_AGGREGATION_RNG = NULL;
+
+#if MEOS
+/* The environment of the GSL is read only once for all threads */
+static pthread_once_t MEOS_GSL_ENV_ONCE = PTHREAD_ONCE_INIT;
 
-static bool MEOS_GSL_INITIALIZED = false;
-static gsl_rng *MEOS_GENERATION_RNG = NULL;
-static gsl_rng *MEOS_AGGREGATION_RNG = NULL;
+/**
+ * @brief Read the default random generator and seed from the environment
+ */
+static void
+gsl_env_setup(void)
+{
+  gsl_rng_env_setup();
+  return;
+}
+#endif /* MEOS */
 
 /**
- * @brief Initialize the Gnu Scientific Library
+ * @brief Initialize the Gnu Scientific Library for the current thread
  */
 static void
 gsl_initialize(void)
 {
   if (! MEOS_GSL_INITIALIZED)
   {
+#if MEOS
+    pthread_once(&MEOS_GSL_ENV_ONCE, &gsl_env_setup);
+#else
     gsl_rng_env_setup();
+#endif /* MEOS */
     MEOS_GENERATION_RNG = gsl_rng_alloc(gsl_rng_default);
     MEOS_AGGREGATION_RNG = gsl_rng_alloc(gsl_rng_ranlxd1);
     MEOS_GSL_INITIALIZED = true;
@@ -74,13 +100,16 @@ gsl_initialize(void)
 
 #if MEOS
 /**
- * @brief Finalize the Gnu Scientific Library
+ * @brief Finalize the Gnu Scientific Library for the current thread
  */
 static void
 gsl_finalize(void)
 {
+  if (! MEOS_GSL_INITIALIZED)
+    return;
   gsl_rng_free(MEOS_GENERATION_RNG);
   gsl_rng_free(MEOS_AGGREGATION_RNG);
+  MEOS_GENERATION_RNG = MEOS_AGGREGATION_RNG = NULL;
   MEOS_GSL_INITIALIZED = false;
   return;
 }
@@ -108,16 +137,343 @@ gsl_get_aggregation_rng(void)
   return MEOS_AGGREGATION_RNG;
 }
 
+/***************************************************************************
+ * Fast geodetic mode
+ ***************************************************************************/
+
+/**
+ * @brief Global variable stating whether the distances between temporal
+ * geography points are approximated on a sphere
+ */
+static bool MEOS_FAST_GEODETIC = false;
+
+/**
+ * @brief Set the fast geodetic mode
+ * @details When set, the length, cumulative length, speed, temporal distance
+ * to a point, and temporal dwithin of temporal geography points compute the
+ * distance between two points with the haversine formula on a sphere of
+ * radius @p WGS84_RADIUS instead of on the WGS84 spheroid. The relative
+ * error with respect to the spheroidal distance is bounded by about 0.5%.
+ */
+void
+meos_set_fast_geodetic(bool value)
+{
+  MEOS_FAST_GEODETIC = value;
+  return;
+}
+
+/**
+ * @brief Return true if the fast geodetic mode is set
+ */
+bool
+meos_get_fast_geodetic(void)
+{
+  return MEOS_FAST_GEODETIC;
+}
+
+/***************************************************************************
+ * Runtime statistics
+ ***************************************************************************/
+
+/**
+ * @brief Global variable stating whether the runtime statistics are tracked
+ */
+MEOS_THREAD_LOCAL bool MEOS_TRACK_STATS = false;
+
+/**
+ * @brief Global array keeping the runtime statistics, which are kept per
+ * thread so that they are updated without synchronization
+ */
+MEOS_THREAD_LOCAL int64 MEOS_STATS[MEOS_STAT_NUMBER];
+
+/**
+ * @brief Names of the runtime statistics
+ */
+static const char *MEOS_STAT_NAMES[] =
+{
+  [MEOS_STAT_LIFTED_INSTANTS] = "lifted_instants",
+  [MEOS_STAT_SKIPLIST_SPLICES] = "skiplist_splices",
+  [MEOS_STAT_SKIPLIST_ELEMENTS] = "skiplist_elements",
+  [MEOS_STAT_INDEX_CONSISTENT] = "index_consistent_calls",
+  [MEOS_STAT_INDEX_RECHECKS] = "index_rechecks",
+  [MEOS_STAT_DETOAST_BYTES] = "detoast_bytes",
+  [MEOS_STAT_GEOS_CONVERSIONS] = "geos_conversions",
+  [MEOS_STAT_ROUTE_CACHE_HITS] = "route_cache_hits",
+  [MEOS_STAT_ROUTE_CACHE_MISSES] = "route_cache_misses",
+};
+
+/**
+ * @brief Set whether the runtime statistics are tracked
+ * @details The statistics count the work done in the hot paths of MEOS, such
+ * as the instants processed by lifted functions or the recheck of index
+ * matches. They are not updated when they are not tracked, which is the
+ * default.
+ */
+void
+meos_set_track_stats(bool value)
+{
+  MEOS_TRACK_STATS = value;
+  return;
+}
+
+/**
+ * @brief Return true if the runtime statistics are tracked
+ */
+bool
+meos_get_track_stats(void)
+{
+  return MEOS_TRACK_STATS;
+}
+
+/**
+ * @brief Return the name of a runtime statistic
+ * @return On error return @p NULL
+ */
+const char *
+meos_stat_name(meosStat stat)
+{
+  if (stat < 0 || stat >= MEOS_STAT_NUMBER)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Unknown runtime statistic: %d", stat);
+    return NULL;
+  }
+  return MEOS_STAT_NAMES[stat];
+}
+
+/**
+ * @brief Return the value of a runtime statistic of the current thread
+ * @return On error return -1
+ */
+int64
+meos_stat_value(meosStat stat)
+{
+  if (stat < 0 || stat >= MEOS_STAT_NUMBER)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Unknown runtime statistic: %d", stat);
+    return -1;
+  }
+  return MEOS_STATS[stat];
+}
+
+/**
+ * @brief Global array keeping the statistics of the timed entry points
+ */
+static MEOS_THREAD_LOCAL meosFamilyStats MEOS_FAMILY_STATS[MEOS_FAMILY_NUMBER];
+
+/**
+ * @brief Global variable keeping the number of timed calls in progress, so
+ * that the time of nested calls is only attributed to the outermost one
+ */
+static MEOS_THREAD_LOCAL int MEOS_STATS_DEPTH = 0;
+
+/**
+ * @brief Global variable keeping the bytes allocated by MEOS while the
+ * runtime statistics are tracked
+ */
+static MEOS_THREAD_LOCAL int64 MEOS_ALLOC_BYTES = 0;
+
+/**
+ * @brief Names of the families of timed entry points
+ */
+static const char *MEOS_FAMILY_NAMES[] =
+{
+  [MEOS_FAMILY_CONSTRUCTOR] = "constructor",
+  [MEOS_FAMILY_IO] = "io",
+  [MEOS_FAMILY_LIFTING] = "lifting",
+  [MEOS_FAMILY_RESTRICTION] = "restriction",
+  [MEOS_FAMILY_TILING] = "tiling",
+  [MEOS_FAMILY_AGGREGATION] = "aggregation",
+  [MEOS_FAMILY_SIMILARITY] = "similarity",
+};
+
+/**
+ * @brief Reset the runtime statistics of the current thread
+ */
+void
+meos_stats_reset(void)
+{
+  memset(MEOS_STATS, 0, sizeof(MEOS_STATS));
+  memset(MEOS_FAMILY_STATS, 0, sizeof(MEOS_FAMILY_STATS));
+  MEOS_STATS_DEPTH = 0;
+  MEOS_ALLOC_BYTES = 0;
+  return;
+}
+
+/**
+ * @brief Enable or disable the instrumentation of MEOS for the current thread
+ * @details When enabled, the counters of #meos_stat_value are updated and the
+ * calls to the entry points of the families of #meosFamily are counted and
+ * timed. The time and the memory allocated by a call are attributed to the
+ * outermost timed call in progress, e.g., a constructor called by a
+ * restriction function is accounted as restriction. A disabled
+ * instrumentation costs a test per call. The memory allocated is only
+ * measured by MEOS as a library, since in MobilityDB it is allocated by
+ * PostgreSQL. This function is equivalent to #meos_set_track_stats.
+ */
+void
+meos_stats_enable(bool value)
+{
+  MEOS_TRACK_STATS = value;
+  return;
+}
+
+/**
+ * @brief Return the name of a family of timed entry points
+ * @return On error return @p NULL
+ */
+const char *
+meos_family_name(meosFamily family)
+{
+  if (family < 0 || family >= MEOS_FAMILY_NUMBER)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Unknown family of functions: %d", family);
+    return NULL;
+  }
+  return MEOS_FAMILY_NAMES[family];
+}
+
+/**
+ * @brief Return the current value of a monotonic clock in nanoseconds
+ */
+static int64
+meos_stats_clock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64) ts.tv_sec * 1000000000 + (int64) ts.tv_nsec;
+}
+
+/**
+ * @brief Start a timed call of an entry point
+ * @note Called by the macro MEOS_STATS_CALL when the statistics are tracked
+ */
+void
+meos_stats_call_begin(meosStatsCall *call)
+{
+  call->outer = (MEOS_STATS_DEPTH++ == 0);
+  if (call->outer)
+  {
+    call->bytes = MEOS_ALLOC_BYTES;
+    call->start = meos_stats_clock();
+  }
+  return;
+}
+
+/**
+ * @brief End a timed call of an entry point and add it to the statistics of
+ * its family
+ */
+void
+meos_stats_call_end(meosStatsCall *call, meosFamily family)
+{
+  if (MEOS_STATS_DEPTH > 0)
+    MEOS_STATS_DEPTH--;
+  if (! call->outer)
+    return;
+  int64 nsecs = meos_stats_clock() - call->start;
+  meosFamilyStats *stats = &MEOS_FAMILY_STATS[family];
+  stats->calls++;
+  stats->nsecs += nsecs;
+  stats->bytes += MEOS_ALLOC_BYTES - call->bytes;
+  int bucket = 0;
+  for (int64 usecs = nsecs / 1000;
+       usecs > 0 && bucket < MEOS_STATS_HIST_SIZE - 1; usecs >>= 1)
+    bucket++;
+  stats->hist[bucket]++;
+  return;
+}
+
+/**
+ * @brief Abandon the timed calls in progress
+ * @note Called when an error is raised, since the error handler may not
+ * return to the functions that started the calls
+ */
+void
+meos_stats_call_abort(void)
+{
+  MEOS_STATS_DEPTH = 0;
+  return;
+}
+
+/**
+ * @brief Copy in the argument the runtime statistics of the current thread
+ * @param[out] result Statistics
+ * @return On error return false
+ */
+bool
+meos_stats_snapshot(meosStats *result)
+{
+  if (! result)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The argument of the snapshot cannot be NULL");
+    return false;
+  }
+  memcpy(result->counters, MEOS_STATS, sizeof(MEOS_STATS));
+  memcpy(result->families, MEOS_FAMILY_STATS, sizeof(MEOS_FAMILY_STATS));
+  return true;
+}
+
+/**
+ * @brief Return the JSON representation of a snapshot of the runtime
+ * statistics
+ * @details The document has an object `counters` with the value of each
+ * counter and an object `families` with, for each family of entry points,
+ * the number of calls, the cumulative time in nanoseconds, the bytes
+ * allocated, and the histogram of the duration of the calls, e.g.,
+ * @code
+ * {"counters":{"lifted_instants":120,...},"families":{"constructor":
+ *   {"calls":10,"nsecs":52000,"bytes":8400,"hist":[0,2,8,0,...]},...}}
+ * @endcode
+ * @param[in] stats Statistics
+ * @return On error return @p NULL
+ */
+char *
+meos_stats_as_json(const meosStats *stats)
+{
+  if (! stats)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The statistics cannot be NULL");
+    return NULL;
+  }
+  stringbuffer_t *sb = stringbuffer_create();
+  stringbuffer_append_len(sb, "{\"counters\":{", 13);
+  for (int i = 0; i < MEOS_STAT_NUMBER; i++)
+    stringbuffer_aprintf(sb, "%s\"%s\":%ld", i ? "," : "",
+      MEOS_STAT_NAMES[i], (long) stats->counters[i]);
+  stringbuffer_append_len(sb, "},\"families\":{", 14);
+  for (int i = 0; i < MEOS_FAMILY_NUMBER; i++)
+  {
+    const meosFamilyStats *family = &stats->families[i];
+    stringbuffer_aprintf(sb,
+      "%s\"%s\":{\"calls\":%ld,\"nsecs\":%ld,\"bytes\":%ld,\"hist\":[",
+      i ? "," : "", MEOS_FAMILY_NAMES[i], (long) family->calls,
+      (long) family->nsecs, (long) family->bytes);
+    for (int j = 0; j < MEOS_STATS_HIST_SIZE; j++)
+      stringbuffer_aprintf(sb, "%s%ld", j ? "," : "", (long) family->hist[j]);
+    stringbuffer_append_len(sb, "]}", 2);
+  }
+  stringbuffer_append_len(sb, "}}", 2);
+  char *result = stringbuffer_getstringcopy(sb);
+  stringbuffer_destroy(sb);
+  return result;
+}
+
 /***************************************************************************
  * Functions for the PROJ library
  ***************************************************************************/
 
-/* Global variables keeping Proj context */
+/* Global variables keeping Proj context, which is kept per thread since
+ * PROJ contexts must not be shared between threads */
 
-PJ_CONTEXT *MEOS_PJ_CONTEXT = NULL;
+MEOS_THREAD_LOCAL PJ_CONTEXT *MEOS_PJ_CONTEXT = NULL;
 
 /**
- * @brief Initialize the PROJ library
+ * @brief Initialize the PROJ library for the current thread
  */
 static void
 proj_initialize(void)
@@ -127,16 +483,109 @@ proj_initialize(void)
   return;
 }
 
+/*
+ * Cache of the transformations between two SRIDs. The structures are
+ * allocated with malloc since they are kept across calls, their PJ objects
+ * are owned by the PROJ context above and are thus also kept per thread.
+ */
+
+#define PROJ_CACHE_SIZE 8
+
+typedef struct
+{
+  int32 srid_from;  /**< Source SRID */
+  int32 srid_to;    /**< Target SRID */
+  LWPROJ *pj;       /**< Transformation */
+} ProjCacheItem;
+
+static MEOS_THREAD_LOCAL ProjCacheItem MEOS_PROJ_CACHE[PROJ_CACHE_SIZE];
+static MEOS_THREAD_LOCAL int MEOS_PROJ_CACHE_COUNT = 0;
+/* Next entry to be replaced when the cache is full */
+static MEOS_THREAD_LOCAL int MEOS_PROJ_CACHE_NEXT = 0;
+
+/**
+ * @brief Return the cached transformation between two SRIDs, or @p NULL if
+ * it is not in the cache
+ * @note The result must not be freed by the caller
+ */
+LWPROJ *
+proj_cache_get(int32 srid_from, int32 srid_to)
+{
+  for (int i = 0; i < MEOS_PROJ_CACHE_COUNT; i++)
+  {
+    if (MEOS_PROJ_CACHE[i].srid_from == srid_from &&
+        MEOS_PROJ_CACHE[i].srid_to == srid_to)
+      return MEOS_PROJ_CACHE[i].pj;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Add a transformation between two SRIDs to the cache, replacing the
+ * oldest entry when the cache is full
+ * @param[in] srid_from,srid_to SRIDs
+ * @param[in] pj Transformation, which is owned by the cache afterwards
+ * @return Cached transformation, which must not be freed by the caller
+ */
+LWPROJ *
+proj_cache_add(int32 srid_from, int32 srid_to, LWPROJ *pj)
+{
+  LWPROJ *copy = malloc(sizeof(LWPROJ));
+  memcpy(copy, pj, sizeof(LWPROJ));
+  lwfree(pj);
+  ProjCacheItem *item;
+  if (MEOS_PROJ_CACHE_COUNT < PROJ_CACHE_SIZE)
+    item = &MEOS_PROJ_CACHE[MEOS_PROJ_CACHE_COUNT++];
+  else
+  {
+    item = &MEOS_PROJ_CACHE[MEOS_PROJ_CACHE_NEXT];
+    MEOS_PROJ_CACHE_NEXT = (MEOS_PROJ_CACHE_NEXT + 1) % PROJ_CACHE_SIZE;
+    proj_destroy(item->pj->pj);
+    free(item->pj);
+  }
+  item->srid_from = srid_from;
+  item->srid_to = srid_to;
+  item->pj = copy;
+  return copy;
+}
+
 #if MEOS
+/**
+ * @brief Free the cache of transformations
+ */
+static void
+proj_cache_finalize(void)
+{
+  for (int i = 0; i < MEOS_PROJ_CACHE_COUNT; i++)
+  {
+    proj_destroy(MEOS_PROJ_CACHE[i].pj->pj);
+    free(MEOS_PROJ_CACHE[i].pj);
+  }
+  MEOS_PROJ_CACHE_COUNT = MEOS_PROJ_CACHE_NEXT = 0;
+  return;
+}
+
+/**
+ * @brief Finalize the PROJ library for the current thread
+ */
+static void
+proj_finalize_thread(void)
+{
+  proj_cache_finalize();
+  if (MEOS_PJ_CONTEXT)
+    proj_context_destroy(MEOS_PJ_CONTEXT);
+  MEOS_PJ_CONTEXT = NULL;
+  return;
+}
+
 /**
  * @brief Finalize the PROJ library
  */
 static void
 proj_finalize(void)
 {
-  proj_context_destroy(MEOS_PJ_CONTEXT);
+  proj_finalize_thread();
   proj_cleanup();
-  MEOS_PJ_CONTEXT = NULL;
   return;
 }
 #endif /* MEOS */
@@ -154,6 +603,294 @@ proj_get_context(void)
 
 /*****************************************************************************/
 #if MEOS
+/*****************************************************************************
+ * Memory allocation
+ *****************************************************************************/
+
+/*
+ * Allocator used by palloc, repalloc, and pfree, the C library allocator is
+ * used when the functions are NULL. The allocator is shared by all threads
+ * and must be set before starting them.
+ */
+static meos_alloc_fn MEOS_ALLOC = NULL;
+static meos_realloc_fn MEOS_REALLOC = NULL;
+static meos_free_fn MEOS_FREE = NULL;
+static void *MEOS_ALLOC_CTX = NULL;
+
+/**
+ * @brief Make liblwgeom allocate its memory with the allocator of MEOS
+ * @details MEOS frees with pfree the geometries allocated by liblwgeom and
+ * conversely
+ */
+static void
+meos_set_lwgeom_allocator(void)
+{
+  lwgeom_set_handlers(&meos_palloc, &meos_repalloc, &meos_pfree, NULL, NULL);
+  return;
+}
+
+/**
+ * @brief Set the allocator of the memory of MEOS
+ * @details All the memory allocated by MEOS, including the results returned
+ * to the caller, is obtained from the allocator, which receives the context
+ * given as argument. When any of the functions is NULL, the C library
+ * functions @p malloc, @p realloc, and @p free are used, and the results of
+ * MEOS can then be freed with @p free. Otherwise the results must be freed
+ * with the free function of the allocator.
+ * @param[in] alloc_fn,realloc_fn,free_fn Allocation functions
+ * @param[in] ctx Context passed to the allocation functions
+ * @note The allocator must be set before allocating any memory with MEOS
+ */
+void
+meos_set_allocator(meos_alloc_fn alloc_fn, meos_realloc_fn realloc_fn,
+  meos_free_fn free_fn, void *ctx)
+{
+  if (alloc_fn && realloc_fn && free_fn)
+  {
+    MEOS_ALLOC = alloc_fn;
+    MEOS_REALLOC = realloc_fn;
+    MEOS_FREE = free_fn;
+    MEOS_ALLOC_CTX = ctx;
+  }
+  else
+  {
+    MEOS_ALLOC = NULL;
+    MEOS_REALLOC = NULL;
+    MEOS_FREE = NULL;
+    MEOS_ALLOC_CTX = NULL;
+  }
+  meos_set_lwgeom_allocator();
+  return;
+}
+
+/*
+ * Regions are stacks of blocks from which the allocations are carved
+ * sequentially and that are released at once by #meos_region_end. Each
+ * allocation is preceded by its size to support repalloc. Since the blocks
+ * grow geometrically, deciding whether a pointer belongs to a region only
+ * requires a few comparisons.
+ */
+
+#define REGION_MIN_BLOCK_SIZE  (8 * 1024)
+#define REGION_MAX_BLOCK_SIZE  (1024 * 1024)
+#define REGION_CHUNK_HDRSZ     MAXALIGN(sizeof(size_t))
+
+typedef struct RegionBlock
+{
+  struct RegionBlock *next;  /**< Previous block of the region */
+  char *end;                 /**< End of the data of the block */
+  char *free;                /**< First free byte of the block */
+} RegionBlock;
+
+#define REGION_BLOCK_HDRSZ     MAXALIGN(sizeof(RegionBlock))
+
+typedef struct Region
+{
+  struct Region *parent;     /**< Enclosing region */
+  RegionBlock *blocks;       /**< Blocks of the region, the last one first */
+  size_t blocksize;          /**< Size of the next block */
+} Region;
+
+/* Innermost region of the thread */
+static MEOS_THREAD_LOCAL Region *MEOS_REGION = NULL;
+
+/**
+ * @brief Allocate memory with the allocator of MEOS outside of any region
+ */
+static inline void *
+meos_alloc_raw(size_t size)
+{
+  return MEOS_ALLOC ? MEOS_ALLOC(MEOS_ALLOC_CTX, size) : malloc(size);
+}
+
+/**
+ * @brief Free memory with the allocator of MEOS
+ */
+static inline void
+meos_free_raw(void *ptr)
+{
+  if (MEOS_FREE)
+    MEOS_FREE(MEOS_ALLOC_CTX, ptr);
+  else
+    free(ptr);
+  return;
+}
+
+/**
+ * @brief Return the size of an allocation of a region
+ */
+static inline size_t
+region_chunk_size(const void *ptr)
+{
+  return *(const size_t *) ((const char *) ptr - REGION_CHUNK_HDRSZ);
+}
+
+/**
+ * @brief Return true if a pointer was allocated in one of the regions of the
+ * thread
+ */
+static bool
+region_owns(const void *ptr)
+{
+  for (const Region *region = MEOS_REGION; region; region = region->parent)
+  {
+    for (const RegionBlock *block = region->blocks; block; block = block->next)
+    {
+      if ((const char *) ptr >= (const char *) block &&
+          (const char *) ptr < block->end)
+        return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Allocate memory in the innermost region of the thread
+ */
+static void *
+region_alloc(Region *region, size_t size)
+{
+  size_t chunksize = REGION_CHUNK_HDRSZ + MAXALIGN(size);
+  RegionBlock *block = region->blocks;
+  if (! block || (size_t) (block->end - block->free) < chunksize)
+  {
+    size_t blocksize = region->blocksize;
+    if (blocksize < REGION_BLOCK_HDRSZ + chunksize)
+      blocksize = REGION_BLOCK_HDRSZ + chunksize;
+    else if (region->blocksize < REGION_MAX_BLOCK_SIZE)
+      region->blocksize *= 2;
+    block = meos_alloc_raw(blocksize);
+    if (! block)
+      return NULL;
+    block->next = region->blocks;
+    block->end = (char *) block + blocksize;
+    block->free = (char *) block + REGION_BLOCK_HDRSZ;
+    region->blocks = block;
+  }
+  char *result = block->free + REGION_CHUNK_HDRSZ;
+  *(size_t *) block->free = size;
+  block->free += chunksize;
+  return result;
+}
+
+/**
+ * @brief Open a memory region for the current thread
+ * @details Until the matching call to #meos_region_end, the memory allocated
+ * by MEOS in the thread, including the results returned to the caller, is
+ * carved from the region and freeing it is a no-op. Regions can be nested.
+ */
+void
+meos_region_begin(void)
+{
+  Region *region = meos_alloc_raw(sizeof(Region));
+  region->parent = MEOS_REGION;
+  region->blocks = NULL;
+  region->blocksize = REGION_MIN_BLOCK_SIZE;
+  MEOS_REGION = region;
+  meos_set_lwgeom_allocator();
+  return;
+}
+
+/**
+ * @brief Close the innermost memory region of the current thread and free at
+ * once all the memory allocated in it
+ */
+void
+meos_region_end(void)
+{
+  Region *region = MEOS_REGION;
+  if (! region)
+    return;
+  RegionBlock *block = region->blocks;
+  while (block)
+  {
+    RegionBlock *next = block->next;
+    meos_free_raw(block);
+    block = next;
+  }
+  MEOS_REGION = region->parent;
+  meos_free_raw(region);
+  return;
+}
+
+/**
+ * @brief Allocate memory, implementation of palloc
+ */
+void *
+meos_palloc(size_t size)
+{
+  if (MEOS_TRACK_STATS)
+    MEOS_ALLOC_BYTES += (int64) size;
+  return MEOS_REGION ? region_alloc(MEOS_REGION, size) : meos_alloc_raw(size);
+}
+
+/**
+ * @brief Allocate zeroed memory, implementation of palloc0
+ */
+void *
+meos_palloc0(size_t size)
+{
+  if (! MEOS_REGION && ! MEOS_ALLOC)
+  {
+    if (MEOS_TRACK_STATS)
+      MEOS_ALLOC_BYTES += (int64) size;
+    return calloc(1, size);
+  }
+  void *result = meos_palloc(size);
+  if (result)
+    memset(result, 0, size);
+  return result;
+}
+
+/**
+ * @brief Resize memory, implementation of repalloc
+ */
+void *
+meos_repalloc(void *ptr, size_t size)
+{
+  if (! ptr)
+    return meos_palloc(size);
+  if (MEOS_TRACK_STATS)
+    MEOS_ALLOC_BYTES += (int64) size;
+  if (MEOS_REGION && region_owns(ptr))
+  {
+    size_t oldsize = region_chunk_size(ptr);
+    if (size <= oldsize)
+      return ptr;
+    void *result = region_alloc(MEOS_REGION, size);
+    if (result)
+      memcpy(result, ptr, oldsize);
+    return result;
+  }
+  return MEOS_REALLOC ? MEOS_REALLOC(MEOS_ALLOC_CTX, ptr, size) :
+    realloc(ptr, size);
+}
+
+/**
+ * @brief Free memory, implementation of pfree
+ */
+void
+meos_pfree(void *ptr)
+{
+  if (MEOS_REGION && region_owns(ptr))
+    return;
+  meos_free_raw(ptr);
+  return;
+}
+
+/**
+ * @brief Copy a string, implementation of pstrdup
+ */
+char *
+meos_pstrdup(const char *str)
+{
+  size_t size = strlen(str) + 1;
+  char *result = meos_palloc(size);
+  if (result)
+    memcpy(result, str, size);
+  return result;
+}
+
 /*****************************************************************************/
 
 /* Definitions taken from miscadmin.h */
@@ -182,11 +919,12 @@ proj_get_context(void)
 #define INTSTYLE_SQL_STANDARD      2
 #define INTSTYLE_ISO_8601          3
 
-/* Global variables with default definitions taken from globals.c */
+/* Global variables with default definitions taken from globals.c, which are
+ * kept per thread */
 
-int DateStyle = USE_ISO_DATES;
-int DateOrder = DATEORDER_MDY;
-int IntervalStyle = INTSTYLE_POSTGRES;
+MEOS_THREAD_LOCAL int DateStyle = USE_ISO_DATES;
+MEOS_THREAD_LOCAL int DateOrder = DATEORDER_MDY;
+MEOS_THREAD_LOCAL int IntervalStyle = INTSTYLE_POSTGRES;
 
 /***************************************************************************
  * Definitions taken from pg_regress.h/c
@@ -230,8 +968,8 @@ free_stringlist(_stringlist **listhead)
     return;
   if ((*listhead)->next != NULL)
     free_stringlist(&((*listhead)->next));
-  free((*listhead)->str);
-  free(*listhead);
+  pfree((*listhead)->str);
+  pfree(*listhead);
   *listhead = NULL;
 }
 
@@ -249,7 +987,7 @@ split_to_stringlist(const char *s, const char *delim, _stringlist **listhead)
     add_stringlist_item(listhead, token);
     token = strtok(NULL, delim);
   }
-  free(sc);
+  pfree(sc);
 }
 
 /***************************************************************************
@@ -561,16 +1299,48 @@ meos_get_intervalstyle(void)
 
 /*
  * Initialize MEOS library
+ * The timezone, the PROJ context, and the random generators are initialized
+ * on first use so that programs that do not need them start immediately
  */
 void
 meos_initialize(const char *tz_str, error_handler_fn err_handler)
 {
   meos_initialize_error_handler(err_handler);
-  meos_initialize_timezone(tz_str);
-  /* Initialize PROJ */
-  proj_initialize();
-  /* Initialize GSL */
-  gsl_initialize();
+  meos_initialize_timezone_lazy(tz_str);
+  return;
+}
+
+/**
+ * @brief Initialize the state of MEOS for the current thread
+ * @details MEOS keeps per thread the error number, the session timezone, the
+ * date and interval styles, the random generators, the PROJ context, and
+ * the caches of the last arguments of some functions, while the timezone
+ * cache, the error handler, and the catalog are shared by all threads.
+ * This function must be called by every thread other than the one that
+ * called #meos_initialize before calling any other function of MEOS, and
+ * #meos_finalize_thread must be called before the thread exits.
+ * @param[in] tz_str Timezone of the thread, the one given to
+ * #meos_initialize is used when it is NULL or empty
+ */
+void
+meos_initialize_thread(const char *tz_str)
+{
+  /* PROJ and GSL are initialized on first use */
+  meos_initialize_timezone_thread(tz_str);
+  return;
+}
+
+/**
+ * @brief Free the state of MEOS for the current thread
+ * @see #meos_initialize_thread
+ */
+void
+meos_finalize_thread(void)
+{
+  /* Finalize PROJ */
+  proj_finalize_thread();
+  /* Finalize GSL */
+  gsl_finalize();
   return;
 }
 
@@ -202,69 +202,199 @@ static const char * MEOS_INTERPTYPE_NAMES[] =
 /*****************************************************************************/
 
 /**
- * @brief Global constant array that keeps type information for the defined set
- * types
- */
-static const settype_catalog_struct MEOS_SETTYPE_CATALOG[] =
-{
-  /* settype        basetype */
-  {T_INTSET,        T_INT4},
-  {T_BIGINTSET,     T_INT8},
-  {T_FLOATSET,      T_FLOAT8},
-  {T_DATESET,       T_DATE},
-  {T_TSTZSET,       T_TIMESTAMPTZ},
-  {T_TEXTSET,       T_TEXT},
-  {T_GEOMSET,       T_GEOMETRY},
-  {T_GEOGSET,       T_GEOGRAPHY},
-  {T_NPOINTSET,     T_NPOINT},
-};
-
-/**
- * @brief Global constant array that keeps type information for the defined
- * span types
- */
-static const spantype_catalog_struct MEOS_SPANTYPE_CATALOG[] =
-{
-  /* spantype       basetype */
-  {T_INTSPAN,       T_INT4},
-  {T_BIGINTSPAN,    T_INT8},
-  {T_FLOATSPAN,     T_FLOAT8},
-  {T_DATESPAN,      T_DATE},
-  {T_TSTZSPAN,      T_TIMESTAMPTZ},
+ * @brief Classes of types stored in the bitmask of the type catalog, each of
+ * which corresponds to a predicate function below
+ */
+#define CAT_BASE            (UINT64CONST(1) << 0)  /**< meos_basetype */
+#define CAT_BYVALUE         (UINT64CONST(1) << 1)  /**< basetype_byvalue */
+#define CAT_VARLENGTH       (UINT64CONST(1) << 2)  /**< basetype_varlength */
+#define CAT_ALPHANUM_BASE   (UINT64CONST(1) << 3)  /**< alphanum_basetype */
+#define CAT_GEO_BASE        (UINT64CONST(1) << 4)  /**< geo_basetype */
+#define CAT_SPATIAL_BASE    (UINT64CONST(1) << 5)  /**< spatial_basetype */
+#define CAT_TIME            (UINT64CONST(1) << 6)  /**< time_type */
+#define CAT_SET_BASE        (UINT64CONST(1) << 7)  /**< set_basetype */
+#define CAT_SET             (UINT64CONST(1) << 8)  /**< set_type */
+#define CAT_NUMSET          (UINT64CONST(1) << 9)  /**< numset_type */
+#define CAT_TIMESET         (UINT64CONST(1) << 10) /**< timeset_type */
+#define CAT_SET_SPAN        (UINT64CONST(1) << 11) /**< set_spantype */
+#define CAT_ALPHANUMSET     (UINT64CONST(1) << 12) /**< alphanumset_type */
+#define CAT_GEOSET          (UINT64CONST(1) << 13) /**< geoset_type */
+#define CAT_SPATIALSET      (UINT64CONST(1) << 14) /**< spatialset_type */
+#define CAT_SPAN_BASE       (UINT64CONST(1) << 15) /**< span_basetype */
+#define CAT_SPAN_CANON_BASE (UINT64CONST(1) << 16) /**< span_canon_basetype */
+#define CAT_SPAN            (UINT64CONST(1) << 17) /**< span_type */
+#define CAT_NUMSPAN_BASE    (UINT64CONST(1) << 18) /**< numspan_basetype */
+#define CAT_NUMSPAN         (UINT64CONST(1) << 19) /**< numspan_type */
+#define CAT_TIMESPAN_BASE   (UINT64CONST(1) << 20) /**< timespan_basetype */
+#define CAT_TIMESPAN        (UINT64CONST(1) << 21) /**< timespan_type */
+#define CAT_SPANSET         (UINT64CONST(1) << 22) /**< spanset_type */
+#define CAT_NUMSPANSET      (UINT64CONST(1) << 23) /**< numspanset_type */
+#define CAT_TIMESPANSET     (UINT64CONST(1) << 24) /**< timespanset_type */
+#define CAT_TEMPORAL        (UINT64CONST(1) << 25) /**< temporal_type */
+#define CAT_TEMPORAL_BASE   (UINT64CONST(1) << 26) /**< temporal_basetype */
+#define CAT_CONTINUOUS      (UINT64CONST(1) << 27) /**< temptype_continuous */
+#define CAT_TALPHANUM       (UINT64CONST(1) << 28) /**< talphanum_type */
+#define CAT_TALPHA          (UINT64CONST(1) << 29) /**< talpha_type */
+#define CAT_TNUMBER         (UINT64CONST(1) << 30) /**< tnumber_type */
+#define CAT_TNUMBER_BASE    (UINT64CONST(1) << 31) /**< tnumber_basetype */
+#define CAT_TNUMBER_SPAN    (UINT64CONST(1) << 32) /**< tnumber_spantype */
+#define CAT_TNUMBER_SPANSET (UINT64CONST(1) << 33) /**< tnumber_spansettype */
+#define CAT_TSPATIAL        (UINT64CONST(1) << 34) /**< tspatial_type */
+#define CAT_TSPATIAL_BASE   (UINT64CONST(1) << 35) /**< tspatial_basetype */
+#define CAT_TGEO            (UINT64CONST(1) << 36) /**< tgeo_type */
+
+/* The network point types are only temporal types when they are enabled */
+#if NPOINT
+  #define CAT_NPOINT_TEMPORAL_BASE  (CAT_TEMPORAL_BASE | CAT_TSPATIAL_BASE)
+  #define CAT_NPOINT_TEMPORAL       (CAT_TEMPORAL | CAT_CONTINUOUS | \
+    CAT_TSPATIAL)
+  #define NPOINT_LENGTH             sizeof(Npoint)
+#else
+  #define CAT_NPOINT_TEMPORAL_BASE  0
+  #define CAT_NPOINT_TEMPORAL       0
+  #define NPOINT_LENGTH             0
+#endif /* NPOINT */
+
+/**
+ * @brief Global constant array that keeps the type information of all types
+ * indexed by the enumeration meosType defined in file `meos_catalog.h`
+ * @details The array replaces the sequences of comparisons in the predicates
+ * and the type conversion functions below by a single lookup. The entries
+ * that are not initialized, such as those of the PostgreSQL range types, are
+ * zeroed, that is, their types are T_UNKNOWN and their bitmask is empty.
+ */
+static const meostype_catalog_struct MEOS_TYPE_CATALOG[NO_MEOS_TYPES] =
+{
+  /* Base types */
+  [T_BOOL] = {.length = sizeof(Datum),
+    .flags = CAT_BASE | CAT_BYVALUE | CAT_ALPHANUM_BASE | CAT_TEMPORAL_BASE},
+  [T_INT4] = {.settype = T_INTSET, .spantype = T_INTSPAN,
+    .length = sizeof(Datum),
+    .flags = CAT_BASE | CAT_BYVALUE | CAT_ALPHANUM_BASE | CAT_SET_BASE |
+      CAT_SPAN_BASE | CAT_SPAN_CANON_BASE | CAT_NUMSPAN_BASE |
+      CAT_TEMPORAL_BASE | CAT_TNUMBER_BASE},
+  [T_INT8] = {.settype = T_BIGINTSET, .spantype = T_BIGINTSPAN,
+    .length = sizeof(Datum),
+    .flags = CAT_BASE | CAT_BYVALUE | CAT_ALPHANUM_BASE | CAT_SET_BASE |
+      CAT_SPAN_BASE | CAT_SPAN_CANON_BASE | CAT_NUMSPAN_BASE},
+  [T_FLOAT8] = {.settype = T_FLOATSET, .spantype = T_FLOATSPAN,
+    .length = sizeof(Datum),
+    .flags = CAT_BASE | CAT_BYVALUE | CAT_ALPHANUM_BASE | CAT_SET_BASE |
+      CAT_SPAN_BASE | CAT_NUMSPAN_BASE | CAT_TEMPORAL_BASE |
+      CAT_TNUMBER_BASE},
+  [T_DATE] = {.settype = T_DATESET, .spantype = T_DATESPAN,
+    .length = sizeof(Datum),
+    .flags = CAT_BASE | CAT_BYVALUE | CAT_ALPHANUM_BASE | CAT_TIME |
+      CAT_SET_BASE | CAT_SPAN_BASE | CAT_SPAN_CANON_BASE | CAT_NUMSPAN_BASE |
+      CAT_TIMESPAN_BASE},
+  [T_TIMESTAMPTZ] = {.settype = T_TSTZSET, .spantype = T_TSTZSPAN,
+    .length = sizeof(Datum),
+    .flags = CAT_BASE | CAT_BYVALUE | CAT_ALPHANUM_BASE | CAT_TIME |
+      CAT_SET_BASE | CAT_SPAN_BASE | CAT_TIMESPAN_BASE},
+  [T_TEXT] = {.settype = T_TEXTSET, .length = -1,
+    .flags = CAT_BASE | CAT_VARLENGTH | CAT_ALPHANUM_BASE | CAT_SET_BASE |
+      CAT_TEMPORAL_BASE},
+  /* The doubleX are internal types used for temporal aggregation */
+  [T_DOUBLE2] = {.length = sizeof(double2),
+    .flags = CAT_BASE | CAT_TEMPORAL_BASE},
+  [T_DOUBLE3] = {.length = sizeof(double3),
+    .flags = CAT_BASE | CAT_TEMPORAL_BASE},
+  [T_DOUBLE4] = {.length = sizeof(double4),
+    .flags = CAT_BASE | CAT_TEMPORAL_BASE},
+  [T_GEOMETRY] = {.settype = T_GEOMSET, .length = -1,
+    .flags = CAT_BASE | CAT_VARLENGTH | CAT_GEO_BASE | CAT_SPATIAL_BASE |
+      CAT_SET_BASE | CAT_TEMPORAL_BASE | CAT_TSPATIAL_BASE},
+  [T_GEOGRAPHY] = {.settype = T_GEOGSET, .length = -1,
+    .flags = CAT_BASE | CAT_VARLENGTH | CAT_GEO_BASE | CAT_SPATIAL_BASE |
+      CAT_SET_BASE | CAT_TEMPORAL_BASE | CAT_TSPATIAL_BASE},
+  [T_NPOINT] = {.settype = T_NPOINTSET, .length = NPOINT_LENGTH,
+    .flags = CAT_BASE | CAT_SPATIAL_BASE | CAT_SET_BASE |
+      CAT_NPOINT_TEMPORAL_BASE},
+  /* Set types */
+  [T_INTSET] = {.basetype = T_INT4,
+    .flags = CAT_SET | CAT_NUMSET | CAT_SET_SPAN | CAT_ALPHANUMSET},
+  [T_BIGINTSET] = {.basetype = T_INT8,
+    .flags = CAT_SET | CAT_NUMSET | CAT_SET_SPAN | CAT_ALPHANUMSET},
+  [T_FLOATSET] = {.basetype = T_FLOAT8,
+    .flags = CAT_SET | CAT_NUMSET | CAT_SET_SPAN | CAT_ALPHANUMSET},
+  /* Dates are represented as integers */
+  [T_DATESET] = {.basetype = T_DATE,
+    .flags = CAT_TIME | CAT_SET | CAT_NUMSET | CAT_TIMESET | CAT_SET_SPAN |
+      CAT_ALPHANUMSET},
+  [T_TSTZSET] = {.basetype = T_TIMESTAMPTZ,
+    .flags = CAT_TIME | CAT_SET | CAT_TIMESET | CAT_SET_SPAN |
+      CAT_ALPHANUMSET},
+  [T_TEXTSET] = {.basetype = T_TEXT,
+    .flags = CAT_SET | CAT_ALPHANUMSET},
+  [T_GEOMSET] = {.basetype = T_GEOMETRY,
+    .flags = CAT_SET | CAT_GEOSET | CAT_SPATIALSET},
+  [T_GEOGSET] = {.basetype = T_GEOGRAPHY,
+    .flags = CAT_SET | CAT_GEOSET | CAT_SPATIALSET},
+  [T_NPOINTSET] = {.basetype = T_NPOINT,
+    .flags = CAT_SET | CAT_SPATIALSET},
+  /* Span types */
+  [T_INTSPAN] = {.basetype = T_INT4, .spansettype = T_INTSPANSET,
+    .flags = CAT_SPAN | CAT_NUMSPAN | CAT_TNUMBER_SPAN},
+  [T_BIGINTSPAN] = {.basetype = T_INT8, .spansettype = T_BIGINTSPANSET,
+    .flags = CAT_SPAN | CAT_NUMSPAN},
+  [T_FLOATSPAN] = {.basetype = T_FLOAT8, .spansettype = T_FLOATSPANSET,
+    .flags = CAT_SPAN | CAT_NUMSPAN | CAT_TNUMBER_SPAN},
+  [T_DATESPAN] = {.basetype = T_DATE, .spansettype = T_DATESPANSET,
+    .flags = CAT_TIME | CAT_SPAN | CAT_TIMESPAN},
+  [T_TSTZSPAN] = {.basetype = T_TIMESTAMPTZ, .spansettype = T_TSTZSPANSET,
+    .flags = CAT_TIME | CAT_SPAN | CAT_TIMESPAN},
+  /* Span set types */
+  [T_INTSPANSET] = {.spantype = T_INTSPAN,
+    .flags = CAT_SPANSET | CAT_NUMSPANSET | CAT_TNUMBER_SPANSET},
+  [T_BIGINTSPANSET] = {.spantype = T_BIGINTSPAN,
+    .flags = CAT_SPANSET | CAT_NUMSPANSET},
+  [T_FLOATSPANSET] = {.spantype = T_FLOATSPAN,
+    .flags = CAT_SPANSET | CAT_NUMSPANSET | CAT_TNUMBER_SPANSET},
+  [T_DATESPANSET] = {.spantype = T_DATESPAN,
+    .flags = CAT_TIME | CAT_SPANSET | CAT_TIMESPANSET},
+  [T_TSTZSPANSET] = {.spantype = T_TSTZSPAN,
+    .flags = CAT_TIME | CAT_SPANSET | CAT_TIMESPANSET},
+  /* Temporal types */
+  [T_TBOOL] = {.basetype = T_BOOL,
+    .flags = CAT_TEMPORAL | CAT_TALPHANUM | CAT_TALPHA},
+  [T_TINT] = {.basetype = T_INT4,
+    .flags = CAT_TEMPORAL | CAT_TALPHANUM | CAT_TNUMBER},
+  [T_TFLOAT] = {.basetype = T_FLOAT8,
+    .flags = CAT_TEMPORAL | CAT_CONTINUOUS | CAT_TALPHANUM | CAT_TNUMBER},
+  [T_TTEXT] = {.basetype = T_TEXT,
+    .flags = CAT_TEMPORAL | CAT_TALPHANUM | CAT_TALPHA},
+  [T_TDOUBLE2] = {.basetype = T_DOUBLE2,
+    .flags = CAT_TEMPORAL | CAT_CONTINUOUS | CAT_TALPHA},
+  [T_TDOUBLE3] = {.basetype = T_DOUBLE3,
+    .flags = CAT_TEMPORAL | CAT_CONTINUOUS | CAT_TALPHA},
+  [T_TDOUBLE4] = {.basetype = T_DOUBLE4,
+    .flags = CAT_TEMPORAL | CAT_CONTINUOUS | CAT_TALPHA},
+  [T_TGEOMPOINT] = {.basetype = T_GEOMETRY,
+    .flags = CAT_TEMPORAL | CAT_CONTINUOUS | CAT_TSPATIAL | CAT_TGEO},
+  [T_TGEOGPOINT] = {.basetype = T_GEOGRAPHY,
+    .flags = CAT_TEMPORAL | CAT_CONTINUOUS | CAT_TSPATIAL | CAT_TGEO},
+  [T_TNPOINT] = {.basetype = T_NPOINT,
+    .flags = CAT_NPOINT_TEMPORAL},
 };
 
 /**
- * @brief Global constant array that keeps type information for the defined
- * span set types
+ * @brief Return the entry of the type catalog of a type
  */
-static const spansettype_catalog_struct MEOS_SPANSETTYPE_CATALOG[] =
+static inline const meostype_catalog_struct *
+meostype_catalog(meosType type)
 {
-  /* spansettype    spantype */
-  {T_INTSPANSET,    T_INTSPAN},
-  {T_BIGINTSPANSET, T_BIGINTSPAN},
-  {T_FLOATSPANSET,  T_FLOATSPAN},
-  {T_DATESPANSET,   T_DATESPAN},
-  {T_TSTZSPANSET,   T_TSTZSPAN},
-};
+  return ((unsigned int) type < NO_MEOS_TYPES) ?
+    &MEOS_TYPE_CATALOG[type] : &MEOS_TYPE_CATALOG[T_UNKNOWN];
+}
 
 /**
- * @brief Global constant array that keeps type information for the defined
- * temporal types
+ * @brief Return true if the type belongs to one of the classes of a bitmask
  */
-static const temptype_catalog_struct MEOS_TEMPTYPE_CATALOG[] =
+static inline bool
+meostype_flag(meosType type, uint64 flag)
 {
-  /* temptype    basetype */
-  {T_TDOUBLE2,   T_DOUBLE2},
-  {T_TDOUBLE3,   T_DOUBLE3},
-  {T_TDOUBLE4,   T_DOUBLE4},
-  {T_TBOOL,      T_BOOL},
-  {T_TINT,       T_INT4},
-  {T_TFLOAT,     T_FLOAT8},
-  {T_TTEXT,      T_TEXT},
-  {T_TGEOMPOINT, T_GEOMETRY},
-  {T_TGEOGPOINT, T_GEOGRAPHY},
-  {T_TNPOINT,    T_NPOINT},
-};
+  return (meostype_catalog(type)->flags & flag) != 0;
+}
 
 /*****************************************************************************/
 
@@ -438,12 +568,9 @@ interptype_from_string(const char *str)
 meosType
 temptype_basetype(meosType type)
 {
-  int n = sizeof(MEOS_TEMPTYPE_CATALOG) / sizeof(temptype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (MEOS_TEMPTYPE_CATALOG[i].temptype == type)
-      return MEOS_TEMPTYPE_CATALOG[i].basetype;
-  }
+  const meostype_catalog_struct *cat = meostype_catalog(type);
+  if (cat->flags & CAT_TEMPORAL)
+    return cat->basetype;
   /* We only arrive here on error */
   meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
     "type %d is not a temporal type", type);
@@ -460,12 +587,9 @@ temptype_basetype(meosType type)
 meosType
 settype_basetype(meosType type)
 {
-  int n = sizeof(MEOS_SETTYPE_CATALOG) / sizeof(settype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (MEOS_SETTYPE_CATALOG[i].settype == type)
-      return MEOS_SETTYPE_CATALOG[i].basetype;
-  }
+  const meostype_catalog_struct *cat = meostype_catalog(type);
+  if (cat->flags & CAT_SET)
+    return cat->basetype;
   /* We only arrive here on error */
   meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
     "type %s is not a set type", meostype_name(type));
@@ -478,12 +602,9 @@ settype_basetype(meosType type)
 meosType
 basetype_settype(meosType type)
 {
-  int n = sizeof(MEOS_SETTYPE_CATALOG) / sizeof(settype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (MEOS_SETTYPE_CATALOG[i].basetype == type)
-      return MEOS_SETTYPE_CATALOG[i].settype;
-  }
+  const meostype_catalog_struct *cat = meostype_catalog(type);
+  if (cat->flags & CAT_SET_BASE)
+    return cat->settype;
   /* We only arrive here on error */
   meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
     "type %s is not a set type", meostype_name(type));
@@ -496,12 +617,9 @@ basetype_settype(meosType type)
 meosType
 spantype_basetype(meosType type)
 {
-  int n = sizeof(MEOS_SPANTYPE_CATALOG) / sizeof(spantype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (MEOS_SPANTYPE_CATALOG[i].spantype == type)
-      return MEOS_SPANTYPE_CATALOG[i].basetype;
-  }
+  const meostype_catalog_struct *cat = meostype_catalog(type);
+  if (cat->flags & CAT_SPAN)
+    return cat->basetype;
   /* We only arrive here on error */
   meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
     "type %s is not a span type", meostype_name(type));
@@ -514,12 +632,9 @@ spantype_basetype(meosType type)
 meosType
 spansettype_spantype(meosType type)
 {
-  int n = sizeof(MEOS_SPANSETTYPE_CATALOG) / sizeof(spansettype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (MEOS_SPANSETTYPE_CATALOG[i].spansettype == type)
-      return MEOS_SPANSETTYPE_CATALOG[i].spantype;
-  }
+  const meostype_catalog_struct *cat = meostype_catalog(type);
+  if (cat->flags & CAT_SPANSET)
+    return cat->spantype;
   /* We only arrive here on error */
   meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
     "type %s is not a span set type", meostype_name(type));
@@ -532,12 +647,9 @@ spansettype_spantype(meosType type)
 meosType
 basetype_spantype(meosType type)
 {
-  int n = sizeof(MEOS_SPANTYPE_CATALOG) / sizeof(spantype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (MEOS_SPANTYPE_CATALOG[i].basetype == type)
-      return MEOS_SPANTYPE_CATALOG[i].spantype;
-  }
+  const meostype_catalog_struct *cat = meostype_catalog(type);
+  if (cat->flags & CAT_SPAN_BASE)
+    return cat->spantype;
   /* We only arrive here on error */
   meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
     "type %s is not a span type", meostype_name(type));
@@ -550,12 +662,9 @@ basetype_spantype(meosType type)
 meosType
 spantype_spansettype(meosType type)
 {
-  int n = sizeof(MEOS_SPANSETTYPE_CATALOG) / sizeof(spansettype_catalog_struct);
-  for (int i = 0; i < n; i++)
-  {
-    if (MEOS_SPANSETTYPE_CATALOG[i].spantype == type)
-      return MEOS_SPANSETTYPE_CATALOG[i].spansettype;
-  }
+  const meostype_catalog_struct *cat = meostype_catalog(type);
+  if (cat->flags & CAT_SPAN)
+    return cat->spansettype;
   /* We only arrive here on error */
   meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
     "type %s is not a span type", meostype_name(type));
@@ -587,14 +696,7 @@ meostype_internal(meosType type)
 bool
 meos_basetype(meosType type)
 {
-  if (type == T_BOOL || type == T_INT4 || type == T_INT8 || type == T_FLOAT8 ||
-    type == T_TEXT || type == T_DATE || type == T_TIMESTAMPTZ ||
-    /* The doubleX are internal types used for temporal aggregation */
-    type == T_DOUBLE2 || type == T_DOUBLE3 || type == T_DOUBLE4 ||
-    type == T_GEOMETRY || type == T_GEOGRAPHY || type == T_NPOINT
-    )
-    return true;
-  return false;
+  return meostype_flag(type, CAT_BASE);
 }
 #endif
 
@@ -605,10 +707,7 @@ bool
 basetype_byvalue(meosType type)
 {
   assert(meos_basetype(type));
-  if (type == T_BOOL || type == T_INT4 || type == T_INT8 || type == T_FLOAT8 ||
-      type == T_DATE || type == T_TIMESTAMPTZ)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_BYVALUE);
 }
 
 /**
@@ -618,9 +717,7 @@ bool
 basetype_varlength(meosType type)
 {
   assert(meos_basetype(type));
-  if (type == T_TEXT || type == T_GEOMETRY || type == T_GEOGRAPHY)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_VARLENGTH);
 }
 
 /**
@@ -631,22 +728,9 @@ int16
 basetype_length(meosType type)
 {
   assert(meos_basetype(type));
-  if (basetype_byvalue(type))
-    return sizeof(Datum);
-  if (type == T_DOUBLE2)
-    return sizeof(double2);
-  if (type == T_DOUBLE3)
-    return sizeof(double3);
-  if (type == T_DOUBLE4)
-    return sizeof(double4);
-  if (type == T_TEXT)
-    return -1;
-  if (type == T_GEOMETRY || type == T_GEOGRAPHY)
-    return -1;
-#if NPOINT
-  if (type == T_NPOINT)
-    return sizeof(Npoint);
-#endif
+  int16 result = meostype_catalog(type)->length;
+  if (result != 0)
+    return result;
   meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
     "Unknown base type: %s", meostype_name(type));
   return SHRT_MAX;
@@ -660,10 +744,7 @@ basetype_length(meosType type)
 bool
 alphanum_basetype(meosType type)
 {
-  if (type == T_BOOL || type == T_INT4 || type == T_INT8 || type == T_FLOAT8 ||
-      type == T_TEXT || type == T_DATE || type == T_TIMESTAMPTZ)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_ALPHANUM_BASE);
 }
 #endif
 
@@ -673,9 +754,7 @@ alphanum_basetype(meosType type)
 bool
 geo_basetype(meosType type)
 {
-  if (type == T_GEOMETRY || type == T_GEOGRAPHY)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_GEO_BASE);
 }
 
 /**
@@ -684,9 +763,7 @@ geo_basetype(meosType type)
 bool
 spatial_basetype(meosType type)
 {
-  if (type == T_GEOMETRY || type == T_GEOGRAPHY || type == T_NPOINT)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SPATIAL_BASE);
 }
 
 /*****************************************************************************/
@@ -697,11 +774,7 @@ spatial_basetype(meosType type)
 bool
 time_type(meosType type)
 {
-  if (type == T_DATE || type == T_DATESET || type == T_DATESPAN ||
-      type == T_DATESPANSET || type == T_TIMESTAMPTZ || type == T_TSTZSET ||
-    type == T_TSTZSPAN || type == T_TSTZSPANSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TIME);
 }
 
 /*****************************************************************************/
@@ -714,11 +787,7 @@ time_type(meosType type)
 bool
 set_basetype(meosType type)
 {
-  if (type == T_TIMESTAMPTZ || type == T_DATE || type == T_INT4 ||
-      type == T_INT8 || type == T_FLOAT8 || type == T_TEXT ||
-      type == T_GEOMETRY || type == T_GEOGRAPHY || type == T_NPOINT)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SET_BASE);
 }
 #endif
 
@@ -728,11 +797,7 @@ set_basetype(meosType type)
 bool
 set_type(meosType type)
 {
-  if (type == T_TSTZSET || type == T_DATESET || type == T_INTSET ||
-      type == T_BIGINTSET || type == T_FLOATSET || type == T_TEXTSET ||
-      type == T_GEOMSET || type == T_GEOGSET || type == T_NPOINTSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SET);
 }
 
 /**
@@ -741,11 +806,7 @@ set_type(meosType type)
 bool
 numset_type(meosType type)
 {
-  if (type == T_INTSET || type == T_BIGINTSET || type == T_FLOATSET ||
-      /* Dates are represented as integers */
-      type == T_DATESET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_NUMSET);
 }
 
 /**
@@ -769,9 +830,7 @@ ensure_numset_type(meosType type)
 bool
 timeset_type(meosType type)
 {
-  if (type == T_DATESET || type == T_TSTZSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TIMESET);
 }
 
 #if 0 /* not used */
@@ -797,10 +856,7 @@ ensure_timeset_type(meosType type)
 bool
 set_spantype(meosType type)
 {
-  if (type == T_INTSET || type == T_BIGINTSET || type == T_FLOATSET ||
-    type == T_DATESET || type == T_TSTZSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SET_SPAN);
 }
 
 /**
@@ -824,10 +880,7 @@ ensure_set_spantype(meosType type)
 bool
 alphanumset_type(meosType type)
 {
-  if (type == T_TSTZSET || type == T_DATESET || type == T_INTSET ||
-      type == T_BIGINTSET || type == T_FLOATSET || type == T_TEXTSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_ALPHANUMSET);
 }
 
 /**
@@ -836,9 +889,7 @@ alphanumset_type(meosType type)
 bool
 geoset_type(meosType type)
 {
-  if (type == T_GEOMSET || type == T_GEOGSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_GEOSET);
 }
 
 /**
@@ -862,9 +913,7 @@ ensure_geoset_type(meosType type)
 bool
 spatialset_type(meosType type)
 {
-  if (type == T_GEOMSET || type == T_GEOGSET || type == T_NPOINTSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SPATIALSET);
 }
 
 /**
@@ -890,10 +939,7 @@ ensure_spatialset_type(meosType type)
 bool
 span_basetype(meosType type)
 {
-  if (type == T_TIMESTAMPTZ || type == T_DATE || type == T_INT4 ||
-      type == T_INT8 || type == T_FLOAT8)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SPAN_BASE);
 }
 
 /**
@@ -902,9 +948,7 @@ span_basetype(meosType type)
 bool
 span_canon_basetype(meosType type)
 {
-  if (type == T_DATE || type == T_INT4 || type == T_INT8)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SPAN_CANON_BASE);
 }
 
 /**
@@ -913,10 +957,7 @@ span_canon_basetype(meosType type)
 bool
 span_type(meosType type)
 {
-  if (type == T_TSTZSPAN || type == T_DATESPAN || type == T_INTSPAN ||
-      type == T_BIGINTSPAN || type == T_FLOATSPAN)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SPAN);
 }
 
 #ifdef DEBUG_BUILD
@@ -940,11 +981,7 @@ span_bbox_type(meosType type)
 bool
 numspan_basetype(meosType type)
 {
-  if (type == T_INT4 || type == T_INT8 || type == T_FLOAT8 ||
-      /* Dates are represented as integers */
-      type == T_DATE)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_NUMSPAN_BASE);
 }
 
 /**
@@ -953,9 +990,7 @@ numspan_basetype(meosType type)
 bool
 numspan_type(meosType type)
 {
-  if (type == T_INTSPAN || type == T_BIGINTSPAN || type == T_FLOATSPAN)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_NUMSPAN);
 }
 
 /**
@@ -979,9 +1014,7 @@ ensure_numspan_type(meosType type)
 bool
 timespan_basetype(meosType type)
 {
-  if (type == T_TIMESTAMPTZ || type == T_DATE)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TIMESPAN_BASE);
 }
 
 /**
@@ -990,9 +1023,7 @@ timespan_basetype(meosType type)
 bool
 timespan_type(meosType type)
 {
-  if (type == T_TSTZSPAN || type == T_DATESPAN)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TIMESPAN);
 }
 
 #if 0 /* not used */
@@ -1020,10 +1051,7 @@ ensure_timespan_type(meosType type)
 bool
 spanset_type(meosType type)
 {
-  if (type == T_TSTZSPANSET || type == T_DATESPANSET || type == T_INTSPANSET ||
-      type == T_BIGINTSPANSET || type == T_FLOATSPANSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_SPANSET);
 }
 
 #if 0 /* not used */
@@ -1033,10 +1061,7 @@ spanset_type(meosType type)
 bool
 numspanset_type(meosType type)
 {
-  if (type == T_INTSPANSET || type == T_BIGINTSPANSET ||
-      type == T_FLOATSPANSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_NUMSPANSET);
 }
 #endif
 
@@ -1046,9 +1071,7 @@ numspanset_type(meosType type)
 bool
 timespanset_type(meosType type)
 {
-  if (type == T_TSTZSPANSET || type == T_DATESPANSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TIMESPANSET);
 }
 
 /**
@@ -1075,16 +1098,7 @@ ensure_timespanset_type(meosType type)
 bool
 temporal_type(meosType type)
 {
-  if (type == T_TBOOL || type == T_TINT || type == T_TFLOAT ||
-      type == T_TTEXT || type == T_TGEOMPOINT || type == T_TGEOGPOINT ||
-      /* The doubleX are internal types used for temporal aggregation */
-      type == T_TDOUBLE2 || type == T_TDOUBLE3 || type == T_TDOUBLE4
-#if NPOINT
-    || type == T_TNPOINT
-#endif
-    )
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TEMPORAL);
 }
 
 #ifdef DEBUG_BUILD
@@ -1095,16 +1109,7 @@ temporal_type(meosType type)
 bool
 temporal_basetype(meosType type)
 {
-  if (type == T_BOOL || type == T_INT4 || type == T_FLOAT8 || type == T_TEXT ||
-    /* The doubleX are internal types used for temporal aggregation */
-    type == T_DOUBLE2 || type == T_DOUBLE3 || type == T_DOUBLE4 ||
-    type == T_GEOMETRY || type == T_GEOGRAPHY
-#if NPOINT
-    || type == T_NPOINT
-#endif
-    )
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TEMPORAL_BASE);
 }
 #endif
 
@@ -1114,14 +1119,7 @@ temporal_basetype(meosType type)
 bool
 temptype_continuous(meosType type)
 {
-  if (type == T_TFLOAT || type == T_TDOUBLE2 || type == T_TDOUBLE3 ||
-      type == T_TDOUBLE4 || type == T_TGEOMPOINT || type == T_TGEOGPOINT
-#if NPOINT
-    || type == T_TNPOINT
-#endif
-    )
-    return true;
-  return false;
+  return meostype_flag(type, CAT_CONTINUOUS);
 }
 
 #ifdef DEBUG_BUILD
@@ -1132,9 +1130,7 @@ temptype_continuous(meosType type)
 bool
 talphanum_type(meosType type)
 {
-  if (type == T_TBOOL || type == T_TINT || type == T_TFLOAT || type == T_TTEXT)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TALPHANUM);
 }
 #endif
 
@@ -1145,10 +1141,7 @@ talphanum_type(meosType type)
 bool
 talpha_type(meosType type)
 {
-  if (type == T_TBOOL || type == T_TTEXT || type == T_TDOUBLE2 ||
-      type == T_TDOUBLE3 || type == T_TDOUBLE4)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TALPHA);
 }
 
 /**
@@ -1157,9 +1150,7 @@ talpha_type(meosType type)
 bool
 tnumber_type(meosType type)
 {
-  if (type == T_TINT || type == T_TFLOAT)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TNUMBER);
 }
 
 /**
@@ -1183,9 +1174,7 @@ ensure_tnumber_type(meosType type)
 bool
 tnumber_basetype(meosType type)
 {
-  if (type == T_INT4 || type == T_FLOAT8)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TNUMBER_BASE);
 }
 
 /**
@@ -1211,9 +1200,7 @@ ensure_tnumber_basetype(meosType type)
 bool
 tnumber_spantype(meosType type)
 {
-  if (type == T_INTSPAN || type == T_FLOATSPAN)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TNUMBER_SPAN);
 }
 
 #if MEOS
@@ -1223,9 +1210,7 @@ tnumber_spantype(meosType type)
 bool
 tnumber_spansettype(meosType type)
 {
-  if (type == T_INTSPANSET || type == T_FLOATSPANSET)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TNUMBER_SPANSET);
 }
 #endif /* MEOS */
 
@@ -1238,13 +1223,7 @@ tnumber_spansettype(meosType type)
 bool
 tspatial_type(meosType type)
 {
-  if (type == T_TGEOMPOINT || type == T_TGEOGPOINT
-#if NPOINT
-      || type == T_TNPOINT
-#endif
-      )
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TSPATIAL);
 }
 
 /**
@@ -1271,13 +1250,7 @@ ensure_tspatial_type(meosType type)
 bool
 tspatial_basetype(meosType type)
 {
-  if (type == T_GEOMETRY || type == T_GEOGRAPHY
-#if NPOINT
-    || type == T_NPOINT
-#endif
-    )
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TSPATIAL_BASE);
 }
 
 /**
@@ -1286,9 +1259,7 @@ tspatial_basetype(meosType type)
 bool
 tgeo_type(meosType type)
 {
-  if (type == T_TGEOMPOINT || type == T_TGEOGPOINT)
-    return true;
-  return false;
+  return meostype_flag(type, CAT_TGEO);
 }
 
 /**
@@ -42,6 +42,7 @@
 /* PostgreSQL */
 #include <postgres.h>
 #include <common/int128.h>
+#include <pgtime.h>
 #include <utils/datetime.h>
 #include <utils/float.h>
 #include "utils/formatting.h"
@@ -53,6 +54,9 @@
 #if POSTGRESQL_VERSION_NUMBER >= 160000
   #include "varatt.h"
 #endif
+#if ! MEOS
+  #include <miscadmin.h>
+#endif
 /* PostGIS */
 #include <liblwgeom_internal.h> /* for OUT_DOUBLE_BUFFER_SIZE */
 
@@ -480,7 +484,7 @@ float8_in_opt_error(char *num, const char *type_name, const char *orig_string)
        */
       if (val == 0.0 || val >= HUGE_VAL || val <= -HUGE_VAL)
       {
-        char *errnumber = strdup(num);
+        char *errnumber = pstrdup(num);
         errnumber[endptr - num] = '\0';
         meos_error(ERROR, MEOS_ERR_TEXT_INPUT,
           "\"%s\" is out of range for type double precision", errnumber);
@@ -849,7 +853,7 @@ date2timestamptz_opt_overflow(DateADT dateVal, int *overflow)
     tm->tm_hour = 0;
     tm->tm_min = 0;
     tm->tm_sec = 0;
-    tz = DetermineTimeZoneOffset(tm, session_timezone);
+    tz = DetermineTimeZoneOffset(tm, pg_session_timezone());
 
     result = dateVal * USECS_PER_DAY + tz * USECS_PER_SEC;
 
@@ -1297,6 +1301,188 @@ pg_timestamptz_in(const char *str, int32 prec)
 }
 #endif /* MEOS */
 
+/*****************************************************************************
+ * Fast output of timestamps with time zone in ISO 8601
+ *****************************************************************************/
+
+/**
+ * @brief Structure keeping the UTC offset of a time zone on the last range of
+ * time without transition in which a timestamp was output
+ * @details Since the lower bound of the range is the first timestamp seen
+ * after the cache was filled, the cache is hit by the timestamps of a
+ * temporal value, which are output in ascending order
+ */
+typedef struct
+{
+  const pg_tz *tz;     /**< Time zone of the cached range */
+  TimestampTz lower;   /**< Inclusive lower bound of the range */
+  TimestampTz upper;   /**< Exclusive upper bound of the range */
+  long int gmtoff;     /**< UTC offset in seconds east of Greenwich */
+} TzOffsetCache;
+
+static MEOS_THREAD_LOCAL TzOffsetCache _tz_offset_cache = {NULL, 0, 0, 0};
+
+/**
+ * @brief Return in the last argument the UTC offset of a time zone at a
+ * timestamp, using the range of time cached by the previous call when
+ * possible
+ * @return False if the offset cannot be determined
+ */
+static bool
+tz_offset_cached(TimestampTz t, const pg_tz *tz, long int *gmtoff)
+{
+  TzOffsetCache *cache = &_tz_offset_cache;
+  if (cache->tz == tz && t >= cache->lower && t < cache->upper)
+  {
+    *gmtoff = cache->gmtoff;
+    return true;
+  }
+
+  /* Seconds since the Unix epoch, rounded down */
+  int64 secs = t / USECS_PER_SEC;
+  if (t % USECS_PER_SEC < 0)
+    secs--;
+  pg_time_t utime = (pg_time_t) (secs +
+    (POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * SECS_PER_DAY);
+  long int before_gmtoff, after_gmtoff;
+  int before_isdst, after_isdst;
+  pg_time_t boundary;
+  int res = pg_next_dst_boundary(&utime, &before_gmtoff, &before_isdst,
+    &boundary, &after_gmtoff, &after_isdst, tz);
+  if (res < 0)
+    return false;
+
+  cache->tz = tz;
+  cache->lower = t;
+  cache->gmtoff = *gmtoff = before_gmtoff;
+  if (res == 0)
+    /* No transition after the timestamp */
+    cache->upper = DT_NOEND;
+  else
+  {
+    boundary -= (POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * SECS_PER_DAY;
+    cache->upper = (boundary > (DT_NOEND / USECS_PER_SEC) - 1) ?
+      DT_NOEND : (TimestampTz) boundary * USECS_PER_SEC;
+  }
+  return true;
+}
+
+/**
+ * @brief Write into a buffer an integer padded with zeros to a given width
+ * @return Pointer to the end of the string written
+ */
+static inline char *
+iso8601_zeropad(char *str, int value, int width)
+{
+  for (int i = width - 1; i >= 0; i--)
+  {
+    str[i] = (char) ('0' + value % 10);
+    value /= 10;
+  }
+  return str + width;
+}
+
+/**
+ * @brief Write into a buffer a timestamp with time zone in ISO 8601 format
+ * in the session time zone
+ * @details The result is the one of PostgreSQL with DateStyle ISO, e.g.,
+ * `2000-01-01 08:30:00.5+01`, where the date and the time parts are
+ * separated by a given character. The UTC offset of the time zone is kept
+ * for the range of time until its next transition, so that the timestamps
+ * of a temporal value are output without converting each of them to the
+ * local time.
+ * @param[in] t Timestamp
+ * @param[in] sep Separator between the date and the time parts
+ * @param[out] buf Buffer of at least MAXDATELEN + 1 characters
+ * @return Number of characters written, -1 if the timestamp is infinite or
+ * its year is not between 1 and 9999, which are output by PostgreSQL in
+ * another format
+ */
+int
+timestamptz_to_iso8601_buf(TimestampTz t, char sep, char *buf)
+{
+  if (TIMESTAMP_NOT_FINITE(t))
+    return -1;
+#if MEOS
+  const pg_tz *tz = pg_session_timezone();
+#else
+  const pg_tz *tz = session_timezone;
+#endif /* MEOS */
+  long int gmtoff;
+  if (! tz || ! tz_offset_cached(t, tz, &gmtoff))
+    return -1;
+
+  /* Broken-down local time without time zone conversion */
+  struct pg_tm tt, *tm = &tt;
+  fsec_t fsec;
+  if (timestamp2tm(t + (TimestampTz) gmtoff * USECS_PER_SEC, NULL, tm, &fsec,
+        NULL, NULL) != 0 || tm->tm_year < 1 || tm->tm_year > 9999)
+    return -1;
+
+  char *str = buf;
+  str = iso8601_zeropad(str, tm->tm_year, 4);
+  *str++ = '-';
+  str = iso8601_zeropad(str, tm->tm_mon, 2);
+  *str++ = '-';
+  str = iso8601_zeropad(str, tm->tm_mday, 2);
+  *str++ = sep;
+  str = iso8601_zeropad(str, tm->tm_hour, 2);
+  *str++ = ':';
+  str = iso8601_zeropad(str, tm->tm_min, 2);
+  *str++ = ':';
+  str = iso8601_zeropad(str, tm->tm_sec, 2);
+  /* Fractional seconds without trailing zeros */
+  if (fsec != 0)
+  {
+    int ndigits = 6;
+    while (fsec % 10 == 0)
+    {
+      fsec /= 10;
+      ndigits--;
+    }
+    *str++ = '.';
+    str = iso8601_zeropad(str, fsec, ndigits);
+  }
+  /* UTC offset as in EncodeTimezone */
+  int sec = (int) labs(gmtoff);
+  int min = sec / SECS_PER_MINUTE;
+  sec -= min * SECS_PER_MINUTE;
+  int hour = min / MINS_PER_HOUR;
+  min -= hour * MINS_PER_HOUR;
+  *str++ = (gmtoff >= 0) ? '+' : '-';
+  str = iso8601_zeropad(str, hour, 2);
+  if (min != 0 || sec != 0)
+  {
+    *str++ = ':';
+    str = iso8601_zeropad(str, min, 2);
+  }
+  if (sec != 0)
+  {
+    *str++ = ':';
+    str = iso8601_zeropad(str, sec, 2);
+  }
+  *str = '\0';
+  return (int) (str - buf);
+}
+
+/**
+ * @brief Return a timestamp with time zone converted to a string in ISO 8601
+ * format if possible
+ * @return NULL when the timestamp is not handled by
+ * #timestamptz_to_iso8601_buf
+ */
+static char *
+timestamptz_out_iso8601(TimestampTz t)
+{
+  char buf[MAXDATELEN + 1];
+  int len = timestamptz_to_iso8601_buf(t, ' ', buf);
+  if (len < 0)
+    return NULL;
+  char *result = palloc(len + 1);
+  memcpy(result, buf, len + 1);
+  return result;
+}
+
 #if ! MEOS
 /**
  * @ingroup meos_pg_types
@@ -1308,6 +1494,12 @@ pg_timestamptz_in(const char *str, int32 prec)
 char *
 pg_timestamptz_out(TimestampTz t)
 {
+  if (DateStyle == USE_ISO_DATES)
+  {
+    char *result = timestamptz_out_iso8601(t);
+    if (result)
+      return result;
+  }
   Datum d = TimestampTzGetDatum(t);
   return DatumGetCString(call_function1(timestamptz_out, d));
 }
@@ -1361,6 +1553,12 @@ pg_timestamp_out(Timestamp t)
 char *
 pg_timestamptz_out(TimestampTz t)
 {
+  if (DateStyle == USE_ISO_DATES)
+  {
+    char *result = timestamptz_out_iso8601(t);
+    if (result)
+      return result;
+  }
   return timestamp_out_common(t, true);
 }
 #endif /* MEOS */
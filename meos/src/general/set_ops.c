@@ -36,6 +36,7 @@
 #include <assert.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <port/pg_bitutils.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -97,6 +98,186 @@ bbox_contains_set_value(const Set *s, Datum value)
 
 /*****************************************************************************/
 
+/**
+ * @brief Maximum number of bits per value in the bitmaps used for the set
+ * operations of dense integer sets
+ * @details With this value the two bitmaps take at most as much memory as
+ * the array of values of the result of the merge
+ */
+#define SET_BITMAP_BITS_PER_VALUE 64
+
+/**
+ * @brief Return the value of an integer or big integer as a 64-bit integer
+ */
+static inline int64
+intset_value(Datum value, meosType basetype)
+{
+  return (basetype == T_INT4) ? (int64) DatumGetInt32(value) :
+    DatumGetInt64(value);
+}
+
+/**
+ * @brief Return true if the union, intersection, or difference of two
+ * integer or big integer sets is computed with bitmaps
+ * @details This is the case when the values in the range covered by the
+ * result are dense enough
+ * @param[in] s1,s2 Sets
+ * @param[in] op Set operation
+ * @param[out] lower,upper Range of values covered by the result
+ */
+static bool
+intset_bitmap_dense(const Set *s1, const Set *s2, SetOper op, int64 *lower,
+  int64 *upper)
+{
+  meosType basetype = s1->basetype;
+  if (basetype != T_INT4 && basetype != T_INT8)
+    return false;
+  int64 min1 = intset_value(SET_VAL_N(s1, MINIDX), basetype);
+  int64 max1 = intset_value(SET_VAL_N(s1, s1->MAXIDX), basetype);
+  int64 min2 = intset_value(SET_VAL_N(s2, MINIDX), basetype);
+  int64 max2 = intset_value(SET_VAL_N(s2, s2->MAXIDX), basetype);
+  if (op == UNION)
+  {
+    *lower = Min(min1, min2);
+    *upper = Max(max1, max2);
+  }
+  else if (op == INTER)
+  {
+    *lower = Max(min1, min2);
+    *upper = Min(max1, max2);
+  }
+  else /* op == MINUS */
+  {
+    *lower = min1;
+    *upper = max1;
+  }
+  /* The difference is computed on unsigned integers to avoid overflow */
+  uint64 range = (uint64) *upper - (uint64) *lower;
+  return range < (uint64) SET_BITMAP_BITS_PER_VALUE *
+    (uint64) (s1->count + s2->count);
+}
+
+/**
+ * @brief Set in a bitmap the bits of the values of an integer or big integer
+ * set in a range
+ */
+static void
+intset_bitmap_fill(const Set *s, int64 lower, int64 upper, uint64 *bitmap)
+{
+  meosType basetype = s->basetype;
+  for (int i = 0; i < s->count; i++)
+  {
+    int64 value = intset_value(SET_VAL_N(s, i), basetype);
+    if (value < lower || value > upper)
+      continue;
+    uint64 bit = (uint64) value - (uint64) lower;
+    bitmap[bit / 64] |= UINT64CONST(1) << (bit % 64);
+  }
+  return;
+}
+
+/**
+ * @brief Return the position of the first value of a set, starting from a
+ * given position, that is greater than or equal to a value
+ * @details The position is found with an exponential (galloping) search
+ * followed by a binary search, so that skipping @p d values costs O(log d)
+ * comparisons in the merges of sets of very different sizes
+ * @param[in] s Set
+ * @param[in] from Start position
+ * @param[in] value Value
+ * @return Position between @p from and the number of values
+ */
+static int
+set_gallop_value(const Set *s, int from, Datum value)
+{
+  meosType basetype = s->basetype;
+  if (from >= s->count || ! datum_lt(SET_VAL_N(s, from), value, basetype))
+    return from;
+  /* The value at position lo is always less than the argument value and
+   * the value at position hi is not, or hi is equal to the number of values */
+  int lo = from, hi = from + 1, step = 1;
+  while (hi < s->count && datum_lt(SET_VAL_N(s, hi), value, basetype))
+  {
+    lo = hi;
+    step *= 2;
+    hi = lo + step;
+  }
+  if (hi > s->count)
+    hi = s->count;
+  while (hi - lo > 1)
+  {
+    int middle = lo + (hi - lo) / 2;
+    if (datum_lt(SET_VAL_N(s, middle), value, basetype))
+      lo = middle;
+    else
+      hi = middle;
+  }
+  return hi;
+}
+
+/**
+ * @brief Return the union, intersection, or difference of two dense integer
+ * or big integer sets computed with bitmaps
+ * @details The bitmaps of the two sets in the range of the result are
+ * combined word by word and the values of the result are decoded from the
+ * resulting bitmap in increasing order
+ * @param[in] s1,s2 Sets
+ * @param[in] op Set operation
+ * @param[in] lower,upper Range of values covered by the result
+ */
+static Set *
+intset_setop_bitmap(const Set *s1, const Set *s2, SetOper op, int64 lower,
+  int64 upper)
+{
+  uint64 nwords = ((uint64) upper - (uint64) lower) / 64 + 1;
+  uint64 *bitmap1 = palloc0(sizeof(uint64) * nwords);
+  uint64 *bitmap2 = palloc0(sizeof(uint64) * nwords);
+  intset_bitmap_fill(s1, lower, upper, bitmap1);
+  intset_bitmap_fill(s2, lower, upper, bitmap2);
+  if (op == UNION)
+  {
+    for (uint64 i = 0; i < nwords; i++)
+      bitmap1[i] |= bitmap2[i];
+  }
+  else if (op == INTER)
+  {
+    for (uint64 i = 0; i < nwords; i++)
+      bitmap1[i] &= bitmap2[i];
+  }
+  else /* op == MINUS */
+  {
+    for (uint64 i = 0; i < nwords; i++)
+      bitmap1[i] &= ~bitmap2[i];
+  }
+  pfree(bitmap2);
+
+  int count;
+  if (op == UNION)
+    count = s1->count + s2->count;
+  else if (op == INTER)
+    count = Min(s1->count, s2->count);
+  else /* op == MINUS */
+    count = s1->count;
+  Datum *values = palloc(sizeof(Datum) * count);
+  int nvals = 0;
+  meosType basetype = s1->basetype;
+  for (uint64 i = 0; i < nwords; i++)
+  {
+    uint64 word = bitmap1[i];
+    while (word != 0)
+    {
+      int64 value = (int64) ((uint64) lower + i * 64 +
+        (uint64) pg_rightmost_one_pos64(word));
+      values[nvals++] = (basetype == T_INT4) ?
+        Int32GetDatum((int32) value) : Int64GetDatum(value);
+      /* Clear the rightmost bit set */
+      word &= word - 1;
+    }
+  }
+  pfree(bitmap1);
+  return set_make_free(values, nvals, basetype, ORDER_NO);
+}
+
 /**
  * @brief Return the union, intersection, or difference of two sets
  */
@@ -111,6 +292,11 @@ setop_set_set(const Set *s1, const Set *s2, SetOper op)
       return op == INTER ? NULL : set_cp(s1);
   }
 
+  /* Use bitmaps for dense integer sets */
+  int64 lower, upper;
+  if (intset_bitmap_dense(s1, s2, op, &lower, &upper))
+    return intset_setop_bitmap(s1, s2, op, lower, upper);
+
   int count;
   if (op == UNION)
     count = s1->count + s2->count;
@@ -139,8 +325,13 @@ setop_set_set(const Set *s1, const Set *s2, SetOper op)
     else if (cmp < 0)
     {
       if (op == UNION || op == MINUS)
+      {
         values[nvals++] = value1;
-      i++;
+        i++;
+      }
+      else
+        /* Skip the values of the first set that are not in the result */
+        i = set_gallop_value(s1, i + 1, value2);
       if (i == s1->count)
         break;
       else
@@ -149,8 +340,13 @@ setop_set_set(const Set *s1, const Set *s2, SetOper op)
     else
     {
       if (op == UNION)
+      {
         values[nvals++] = value2;
-      j++;
+        j++;
+      }
+      else
+        /* Skip the values of the second set that are not in the first one */
+        j = set_gallop_value(s2, j + 1, value1);
       if (j == s2->count)
         break;
       else
@@ -336,7 +532,11 @@ contains_set_set(const Set *s1, const Set *s2)
       i++; j++;
     }
     else if (cmp < 0)
-      i++;
+    {
+      i = set_gallop_value(s1, i + 1, SET_VAL_N(s2, j));
+      if (i == s1->count)
+        return false;
+    }
     else
       return false;
   }
@@ -518,9 +718,9 @@ overlaps_set_set(const Set *s1, const Set *s2)
     if (cmp == 0)
       return true;
     if (cmp < 0)
-      i++;
+      i = set_gallop_value(s1, i + 1, SET_VAL_N(s2, j));
     else
-      j++;
+      j = set_gallop_value(s2, j + 1, SET_VAL_N(s1, i));
   }
   return false;
 }
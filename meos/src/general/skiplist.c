@@ -54,6 +54,7 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/meos_probes.h"
 #include "general/temporal_aggfuncs.h"
 #include "general/type_util.h"
 
@@ -205,6 +206,8 @@ skiplist_delete(SkipList *list, int cur)
   }
   /* Mark the element as free */
   list->elems[cur].value = NULL;
+  pfree(list->elems[cur].next);
+  list->elems[cur].next = NULL;
   list->freed[list->freecount++] = cur;
   list->length--;
   return;
@@ -226,7 +229,8 @@ skiplist_free(SkipList *list)
     pfree(list->freed);
   if (list->elems)
   {
-    /* Free the element values of the skiplist if they are not NULL */
+    /* Free the element values of the skiplist if they are not NULL and the
+     * forward links of the elements */
     int cur = 0;
     while (cur != -1)
     {
@@ -234,6 +238,7 @@ skiplist_free(SkipList *list)
       if (e->value)
         pfree(e->value);
       cur = e->next[0];
+      pfree(e->next);
     }
     /* Free the element list */
     pfree(list->elems);
@@ -305,16 +310,13 @@ void
 aggstate_set_extra(SkipList *state, void *data, size_t size)
 {
 #if ! MEOS
-  MemoryContext ctx;
-  if(! AggCheckCallContext(fetch_fcinfo(), &ctx))
-    elog(ERROR, "Transition function called in non-aggregate context");
-  MemoryContext oldctx = MemoryContextSwitchTo(ctx);
+  MemoryContext oldctx = set_aggregation_context(fetch_fcinfo());
 #endif /* ! MEOS */
   state->extra = palloc(size);
   state->extrasize = size;
   memcpy(state->extra, data, size);
 #if ! MEOS
-  MemoryContextSwitchTo(oldctx);
+  unset_aggregation_context(oldctx);
 #endif /* ! MEOS */
   return;
 }
@@ -373,6 +375,19 @@ skiplist_make(void **values, int count)
     result->elems[i + 1].value = temporal_cp((Temporal *) values[i]);
   result->elems[count - 1].value = NULL; /* set tail value to NULL */
   result->tail = count - 1;
+
+  /* Allocate the forward links of the elements according to the height they
+   * have in the balanced list, the head and the tail may grow up to the
+   * maximum level */
+  result->elems[0].next = palloc0(sizeof(int) * SKIPLIST_MAXLEVEL);
+  for (int i = 1; i < count - 1; i++)
+  {
+    int h = 1;
+    while (h < height && i % (1 << h) == 0)
+      h++;
+    result->elems[i].next = palloc0(sizeof(int) * h);
+  }
+  result->elems[count - 1].next = palloc0(sizeof(int) * SKIPLIST_MAXLEVEL);
 #if ! MEOS
   unset_aggregation_context(oldctx);
 #endif /* ! MEOS */
@@ -438,6 +453,80 @@ skiplist_elempos(const SkipList *list, Span *s, int cur)
     return pos_span_span(s, &((TSequence *) temp)->period);
 }
 
+/**
+ * @brief Set the predecessors of the tail at each level of the skiplist
+ * @note The predecessors are kept while values are appended with
+ * #skiplist_append and are invalidated by any other modification of the list
+ */
+static void
+skiplist_set_tailpred(SkipList *list)
+{
+  if (list->tailpred_valid)
+    return;
+  int cur = 0;
+  for (int level = list->elems[0].height - 1; level >= 0; level--)
+  {
+    while (list->elems[cur].next[level] != list->tail)
+      cur = list->elems[cur].next[level];
+    list->tailpred[level] = cur;
+  }
+  list->tailpred_valid = true;
+  return;
+}
+
+/**
+ * @brief Append the array of values at the end of the skiplist
+ * @details The values are linked after the predecessors of the tail, which
+ * avoids searching the levels of the list
+ * @param[in,out] list Skiplist
+ * @param[in] values Array of values
+ * @param[in] count Number of elements in the array
+ * @pre The values are after the last value of the list and the predecessors
+ * of the tail are up to date
+ */
+static void
+skiplist_append(SkipList *list, void **values, int count)
+{
+  assert(list->tailpred_valid);
+#if ! MEOS
+  MemoryContext oldctx;
+#endif /* ! MEOS */
+  int height = list->elems[0].height;
+  for (int i = 0; i < count; i++)
+  {
+    int rheight = random_level();
+    /* Get the location for the new element, head & tail must be accessed
+     * after this call since a repalloc may have been done */
+    int new = skiplist_alloc(list);
+    if (rheight > height)
+    {
+      /* Grow head and tail as appropriate */
+      for (int l = height; l < rheight; l++)
+        list->tailpred[l] = 0;
+      list->elems[0].height = rheight;
+      list->elems[list->tail].height = rheight;
+      height = rheight;
+    }
+    SkipListElem *newelm = &list->elems[new];
+#if ! MEOS
+    oldctx = set_aggregation_context(fetch_fcinfo());
+#endif /* ! MEOS */
+    newelm->value = temporal_cp(values[i]);
+    newelm->next = palloc0(sizeof(int) * rheight);
+#if ! MEOS
+    unset_aggregation_context(oldctx);
+#endif /* ! MEOS */
+    newelm->height = rheight;
+    for (int level = 0; level < rheight; level++)
+    {
+      newelm->next[level] = list->tail;
+      list->elems[list->tailpred[level]].next[level] = new;
+      list->tailpred[level] = new;
+    }
+  }
+  return;
+}
+
 /**
  * @brief Splice the skiplist with the array of values using the aggregation
  * function
@@ -459,6 +548,9 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
   bool crossings)
 {
   assert(list->length > 0);
+  MEOS_STAT_ADD(MEOS_STAT_SKIPLIST_SPLICES, 1);
+  MEOS_PROBE_SKIPLIST_SPLICE(list->length, count);
+  MEOS_STAT_ADD(MEOS_STAT_SKIPLIST_ELEMENTS, count);
 
 #if ! MEOS
   MemoryContext oldctx;
@@ -500,6 +592,18 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
       last->period.upper_inc, T_TIMESTAMPTZ, T_TSTZSPAN, &s);
   }
 
+  /* If the new values are after the last value of the list, which is the
+   * case when the input is sorted by time, append them after the tail
+   * without searching the levels of the list */
+  skiplist_set_tailpred(list);
+  if (skiplist_elempos(list, &s, list->tailpred[0]) == AFTER)
+  {
+    skiplist_append(list, values, count);
+    return;
+  }
+  /* The predecessors of the tail are invalidated by the general case */
+  list->tailpred_valid = false;
+
   /* Find the list values that are strictly before the span of new values */
   int update[SKIPLIST_MAXLEVEL];
   memset(update, 0, sizeof(update));
@@ -547,8 +651,10 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
         prev->next[level] = list->elems[cur].next[level];
       }
       spliced[spliced_count++] = list->elems[cur].value;
+      /* The forward links of the element are freed when deleting it */
+      int next = list->elems[cur].next[0];
       skiplist_delete(list, cur);
-      cur = list->elems[cur].next[0];
+      cur = next;
     }
   }
 
@@ -607,6 +713,7 @@ skiplist_splice(SkipList *list, void **values, int count, datum_func2 func,
     oldctx = set_aggregation_context(fetch_fcinfo());
 #endif /* ! MEOS */
     newelm->value = temporal_cp(values[i]);
+    newelm->next = palloc0(sizeof(int) * rheight);
 #if ! MEOS
     unset_aggregation_context(oldctx);
 #endif /* ! MEOS */
@@ -671,3 +778,105 @@ skiplist_temporal_values(SkipList *list)
 }
 
 /*****************************************************************************/
+
+/**
+ * @brief Return the size of the flat serialized form of a skiplist
+ * @param[in] list Skiplist
+ * @see #skiplist_serialize
+ */
+size_t
+skiplist_serialize_size(const SkipList *list)
+{
+  size_t result = sizeof(int64) + sizeof(uint64);
+  int cur = list->elems[0].next[0];
+  while (cur != list->tail)
+  {
+    result += DOUBLE_PAD(VARSIZE(list->elems[cur].value));
+    cur = list->elems[cur].next[0];
+  }
+  return result + list->extrasize;
+}
+
+/**
+ * @brief Write a skiplist in flat serialized form into a buffer
+ * @details The serialized form is composed of the number of values and the
+ * size of the extra data, followed by the values in time order, each one
+ * padded to a double boundary, and by the extra data. Only the values are
+ * kept, the levels of the skiplist are rebuilt by #skiplist_deserialize.
+ * @param[in] list Skiplist
+ * @param[out] buf Buffer of size at least #skiplist_serialize_size
+ * @note The values are written in the native memory layout, the serialized
+ * form is meant to be exchanged between processes of the same server, such
+ * as the workers of a parallel aggregation
+ */
+void
+skiplist_serialize(const SkipList *list, char *buf)
+{
+  int64 length = list->length;
+  uint64 extrasize = list->extrasize;
+  memcpy(buf, &length, sizeof(int64));
+  memcpy(buf + sizeof(int64), &extrasize, sizeof(uint64));
+  char *ptr = buf + sizeof(int64) + sizeof(uint64);
+  int cur = list->elems[0].next[0];
+  while (cur != list->tail)
+  {
+    const void *value = list->elems[cur].value;
+    size_t size = VARSIZE(value);
+    memcpy(ptr, value, size);
+    if (DOUBLE_PAD(size) != size)
+      memset(ptr + size, 0, DOUBLE_PAD(size) - size);
+    ptr += DOUBLE_PAD(size);
+    cur = list->elems[cur].next[0];
+  }
+  if (list->extrasize)
+    memcpy(ptr, list->extra, list->extrasize);
+  return;
+}
+
+/**
+ * @brief Return a skiplist from its flat serialized form
+ * @param[in] buf Buffer
+ * @param[in] size Size of the buffer
+ * @pre The buffer is aligned on a double boundary
+ * @see #skiplist_serialize
+ */
+SkipList *
+skiplist_deserialize(const char *buf, size_t size)
+{
+  int64 length;
+  uint64 extrasize;
+  memcpy(&length, buf, sizeof(int64));
+  memcpy(&extrasize, buf + sizeof(int64), sizeof(uint64));
+  if (length <= 0 ||
+      size < sizeof(int64) + sizeof(uint64) + (size_t) extrasize)
+  {
+    meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+      "Invalid serialized state of a temporal aggregate");
+    return NULL;
+  }
+  /* The values point to the buffer since the skiplist copies them */
+  const char *ptr = buf + sizeof(int64) + sizeof(uint64);
+  const char *end = buf + size - extrasize;
+  void **values = palloc(sizeof(void *) * length);
+  for (int64 i = 0; i < length; i++)
+  {
+    if (end - ptr < (ptrdiff_t) sizeof(Temporal) ||
+        VARSIZE(ptr) < sizeof(Temporal) ||
+        (size_t) (end - ptr) < DOUBLE_PAD(VARSIZE(ptr)))
+    {
+      pfree(values);
+      meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+        "Invalid serialized state of a temporal aggregate");
+      return NULL;
+    }
+    values[i] = (void *) ptr;
+    ptr += DOUBLE_PAD(VARSIZE(ptr));
+  }
+  SkipList *result = skiplist_make(values, (int) length);
+  pfree(values);
+  if (extrasize)
+    aggstate_set_extra(result, (void *) ptr, (size_t) extrasize);
+  return result;
+}
+
+/*****************************************************************************/
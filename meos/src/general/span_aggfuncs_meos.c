@@ -41,6 +41,21 @@
 #include <meos_internal.h>
 #include "general/span.h"
 #include "general/temporal.h"
+#include "general/type_util.h"
+
+/** Default initial number of spans of a span set state */
+#define SPANSET_STATE_MAXCOUNT 64
+
+/**
+ * @brief Structure to represent the state of the incremental construction of
+ * a span set
+ */
+struct SpansetState
+{
+  int maxcount;            /**< Initial number of spans of the span set */
+  SpanSet *ss;             /**< Expandable span set, NULL before the first
+                                span */
+};
 
 /*****************************************************************************
  * Aggregate functions for span set types
@@ -196,3 +211,260 @@ spanset_union_finalfn(SpanSet *state)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Incremental construction of span sets
+ * A span set state keeps an expandable span set whose spans are disjoint and
+ * ordered. A span starting after the start of the last span is merged with
+ * it or appended, which is the common case when the spans are produced in
+ * time order, e.g., the periods at which a stream of positions is inside a
+ * zone. A late span is positioned by a binary search and merged with the
+ * spans it overlaps or is adjacent to. The capacity of the span set is
+ * doubled when it is full.
+ *****************************************************************************/
+
+/**
+ * @brief Double the capacity of the span set of a state
+ */
+static void
+spanset_state_expand(SpansetState *state)
+{
+  int maxcount = state->ss->maxcount * 2;
+#ifdef DEBUG_EXPAND
+  meos_error(WARNING, " Spanset -> %d\n", maxcount);
+#endif /* DEBUG_EXPAND */
+  /* The first element span is already declared in the struct */
+  size_t memsize = DOUBLE_PAD(sizeof(SpanSet)) +
+    DOUBLE_PAD(sizeof(Span)) * (maxcount - 1);
+  state->ss = repalloc(state->ss, memsize);
+  SET_VARSIZE(state->ss, memsize);
+  state->ss->maxcount = maxcount;
+  return;
+}
+
+/**
+ * @brief Set the bounding span of a span set from its first and last spans
+ */
+static void
+spanset_state_set_bbox(SpanSet *ss)
+{
+  const Span *first = &ss->elems[0];
+  const Span *last = &ss->elems[ss->count - 1];
+  span_set(first->lower, last->upper, first->lower_inc, last->upper_inc,
+    ss->basetype, ss->spantype, &ss->span);
+  return;
+}
+
+/**
+ * @brief Return true if the first span is before the second one and not
+ * adjacent to it
+ */
+static bool
+span_before_nonadj(const Span *s1, const Span *s2)
+{
+  int cmp = datum_cmp(s1->upper, s2->lower, s1->basetype);
+  return cmp < 0 || (cmp == 0 && ! s1->upper_inc && ! s2->lower_inc);
+}
+
+/**
+ * @ingroup meos_setspan_agg
+ * @brief Return a new state for the incremental construction of a span set
+ * @param[in] maxcount Initial number of spans, 0 for the default
+ * @see #spanset_state_push
+ */
+SpansetState *
+spanset_state_make(int maxcount)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_negative(maxcount))
+    return NULL;
+  SpansetState *result = palloc0(sizeof(SpansetState));
+  result->maxcount = maxcount ? maxcount : SPANSET_STATE_MAXCOUNT;
+  return result;
+}
+
+/**
+ * @ingroup meos_setspan_agg
+ * @brief Add a span to the span set of a state
+ * @details A span that starts after the start of the last span of the span
+ * set is merged with it when they overlap or are adjacent, or it is
+ * appended otherwise, in amortized constant time. The position of a late
+ * span is found by a binary search, after which the spans it overlaps or is
+ * adjacent to are merged with it and the following ones are shifted.
+ * @param[in,out] state Span set state
+ * @param[in] s Span
+ * @return On error return false
+ */
+bool
+spanset_state_push(SpansetState *state, const Span *s)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) s))
+    return false;
+  if (! state->ss)
+  {
+    state->ss = spanset_make_exp((Span *) s, 1, state->maxcount, NORMALIZE_NO,
+      ORDER);
+    return state->ss != NULL;
+  }
+  if (! ensure_same_span_type(&state->ss->elems[0], s))
+    return false;
+
+  SpanSet *ss = state->ss;
+  Span *last = &ss->elems[ss->count - 1];
+  /* Span starting after the start of the last span */
+  if (span_lower_cmp(s, last) >= 0)
+  {
+    if (ovadj_span_span(last, s))
+      span_expand(s, last);
+    else
+    {
+      if (ss->count == ss->maxcount)
+      {
+        spanset_state_expand(state);
+        ss = state->ss;
+      }
+      ss->elems[ss->count++] = *s;
+    }
+    spanset_state_set_bbox(ss);
+    return true;
+  }
+
+  /* Late span: find the first span that is not before the span */
+  int first = 0, last_pos = ss->count - 1;
+  while (first < last_pos)
+  {
+    int middle = (first + last_pos) / 2;
+    if (span_before_nonadj(&ss->elems[middle], s))
+      first = middle + 1;
+    else
+      last_pos = middle;
+  }
+  /* Find the spans overlapping or adjacent to the span */
+  int n = 0;
+  while (first + n < ss->count && ! span_before_nonadj(s,
+      &ss->elems[first + n]))
+    n++;
+  if (n == 0)
+  {
+    /* Insert the span before the first span after it */
+    if (ss->count == ss->maxcount)
+    {
+      spanset_state_expand(state);
+      ss = state->ss;
+    }
+    memmove(&ss->elems[first + 1], &ss->elems[first],
+      sizeof(Span) * (ss->count - first));
+    ss->elems[first] = *s;
+    ss->count++;
+  }
+  else
+  {
+    /* Merge the span with the spans it overlaps or is adjacent to */
+    Span merged = *s;
+    span_expand(&ss->elems[first], &merged);
+    span_expand(&ss->elems[first + n - 1], &merged);
+    ss->elems[first] = merged;
+    memmove(&ss->elems[first + 1], &ss->elems[first + n],
+      sizeof(Span) * (ss->count - first - n));
+    ss->count -= n - 1;
+  }
+  spanset_state_set_bbox(ss);
+  return true;
+}
+
+/**
+ * @ingroup meos_setspan_agg
+ * @brief Add the spans of a span set to the span set of a state
+ * @param[in,out] state Span set state
+ * @param[in] ss Span set
+ * @return On error return false
+ */
+bool
+spanset_state_push_spanset(SpansetState *state, const SpanSet *ss)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) ss))
+    return false;
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (! spanset_state_push(state, SPANSET_SP_N(ss, i)))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_setspan_agg
+ * @brief Add the periods at which a temporal boolean is true to the span set
+ * of a state
+ * @details This enables to keep, e.g., the periods at which an object is
+ * inside a zone from the results of a streaming evaluation of a spatial
+ * relationship. The periods of a geofence are added instead with
+ * #spanset_state_push from the timestamps of its enter and exit events.
+ * @param[in,out] state Span set state
+ * @param[in] temp Temporal boolean
+ * @return On error return false
+ * @see #tbool_when_true
+ */
+bool
+tstzspanset_state_push_tbool(SpansetState *state, const Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) temp) ||
+      ! ensure_temporal_isof_type(temp, T_TBOOL))
+    return false;
+  int last_errno = meos_errno_reset();
+  SpanSet *ss = tbool_when_true(temp);
+  if (! ss)
+  {
+    /* The temporal boolean is never true */
+    if (! meos_errno())
+    {
+      meos_errno_restore(last_errno);
+      return true;
+    }
+    return false;
+  }
+  bool result = spanset_state_push_spanset(state, ss);
+  pfree(ss);
+  meos_errno_restore(last_errno);
+  return result;
+}
+
+/**
+ * @ingroup meos_setspan_agg
+ * @brief Return the span set of a state and free the state
+ * @details The span set is returned without copying its spans and thus may
+ * have extra storage space, which can be removed with #spanset_compact.
+ * @param[in] state Span set state
+ * @return Return NULL if no span was added
+ */
+SpanSet *
+spanset_state_finish(SpansetState *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return NULL;
+  SpanSet *result = state->ss;
+  pfree(state);
+  return result;
+}
+
+/**
+ * @ingroup meos_setspan_agg
+ * @brief Free a span set state and its span set
+ * @param[in] state Span set state
+ */
+void
+spanset_state_free(SpansetState *state)
+{
+  if (! state)
+    return;
+  if (state->ss)
+    pfree(state->ss);
+  pfree(state);
+  return;
+}
+
+/*****************************************************************************/
@@ -45,6 +45,187 @@
 #include "general/temporal.h"
 #include "general/type_util.h"
 
+/*****************************************************************************
+ * Exponential search
+ *****************************************************************************/
+
+/**
+ * @brief Return the position of the first span of a span set, starting from
+ * a given position, that is not to the left of a span
+ * @details The position is found with an exponential (galloping) search
+ * followed by a binary search, so that skipping @p d spans costs O(log d)
+ * comparisons instead of @p d comparisons in the merges of span sets of
+ * very different sizes
+ * @param[in] ss Span set
+ * @param[in] from Start position
+ * @param[in] s Span
+ * @return Position between @p from and the number of spans
+ */
+static int
+spanset_gallop_span(const SpanSet *ss, int from, const Span *s)
+{
+  if (from >= ss->count || ! lf_span_span(SPANSET_SP_N(ss, from), s))
+    return from;
+  /* The span at position lo is always to the left of the argument span and
+   * the span at position hi is not, or hi is equal to the number of spans */
+  int lo = from, hi = from + 1, step = 1;
+  while (hi < ss->count && lf_span_span(SPANSET_SP_N(ss, hi), s))
+  {
+    lo = hi;
+    step *= 2;
+    hi = lo + step;
+  }
+  if (hi > ss->count)
+    hi = ss->count;
+  while (hi - lo > 1)
+  {
+    int middle = lo + (hi - lo) / 2;
+    if (lf_span_span(SPANSET_SP_N(ss, middle), s))
+      lo = middle;
+    else
+      hi = middle;
+  }
+  return hi;
+}
+
+/**
+ * @brief Return true if a span is to the left of a value
+ */
+static inline bool
+lf_span_value(const Span *s, Datum value)
+{
+  int cmp = datum_cmp(s->upper, value, s->basetype);
+  return (cmp < 0 || (cmp == 0 && ! s->upper_inc));
+}
+
+/**
+ * @brief Return the position of the first span of a span set, starting from
+ * a given position, that is not to the left of a value
+ * @see #spanset_gallop_span
+ */
+static int
+spanset_gallop_value(const SpanSet *ss, int from, Datum value)
+{
+  if (from >= ss->count || ! lf_span_value(SPANSET_SP_N(ss, from), value))
+    return from;
+  int lo = from, hi = from + 1, step = 1;
+  while (hi < ss->count && lf_span_value(SPANSET_SP_N(ss, hi), value))
+  {
+    lo = hi;
+    step *= 2;
+    hi = lo + step;
+  }
+  if (hi > ss->count)
+    hi = ss->count;
+  while (hi - lo > 1)
+  {
+    int middle = lo + (hi - lo) / 2;
+    if (lf_span_value(SPANSET_SP_N(ss, middle), value))
+      lo = middle;
+    else
+      hi = middle;
+  }
+  return hi;
+}
+
+/*****************************************************************************
+ * Packed bounds
+ *****************************************************************************/
+
+/**
+ * @brief Minimum number of spans of a span set for which a batch of values
+ * is located in packed arrays of its bounds
+ */
+#define SPANSET_PACKED_MIN_SPANS 64
+
+/**
+ * @brief Return true if a batch of values is located in packed arrays of the
+ * bounds of a span set
+ * @details Packing the bounds costs a pass over the spans, which is amortized
+ * when the number of values is not negligible with respect to the number of
+ * spans. Only the span sets whose bounds are integers are packed, so that an
+ * exclusive bound can be replaced by the adjacent inclusive one.
+ */
+static bool
+spanset_packable(const SpanSet *ss, int count)
+{
+  if (ss->count < SPANSET_PACKED_MIN_SPANS ||
+      (int64) count * 16 < (int64) ss->count)
+    return false;
+  return ss->basetype == T_TIMESTAMPTZ || ss->basetype == T_INT8 ||
+    ss->basetype == T_INT4 || ss->basetype == T_DATE;
+}
+
+/**
+ * @brief Return a datum of an integer base type as a 64-bit integer
+ */
+static inline int64
+datum_int64(Datum value, meosType basetype)
+{
+  return (basetype == T_INT4 || basetype == T_DATE) ?
+    (int64) DatumGetInt32(value) : DatumGetInt64(value);
+}
+
+/**
+ * @brief Pack the bounds of a span set into arrays of inclusive bounds
+ * @param[in] ss Span set
+ * @param[out] lower,upper Arrays of lower and upper bounds
+ */
+static void
+spanset_pack_bounds(const SpanSet *ss, int64 *lower, int64 *upper)
+{
+  meosType basetype = ss->basetype;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const Span *s = SPANSET_SP_N(ss, i);
+    lower[i] = datum_int64(s->lower, basetype) + (s->lower_inc ? 0 : 1);
+    upper[i] = datum_int64(s->upper, basetype) - (s->upper_inc ? 0 : 1);
+  }
+  return;
+}
+
+/**
+ * @brief Return the position of the first element of an ordered array of
+ * integers that is greater than or equal to a value
+ * @details The binary search is branch free, the comparison selecting the
+ * half of the array with a conditional move, so that the probes of a batch do
+ * not stall on mispredicted branches
+ */
+static inline int
+int64arr_lower_bound(const int64 *arr, int count, int64 value)
+{
+  const int64 *base = arr;
+  int n = count;
+  while (n > 1)
+  {
+    int half = n / 2;
+    base = (base[half - 1] < value) ? base + half : base;
+    n -= half;
+  }
+  return (int) (base - arr) + (count > 0 && *base < value);
+}
+
+/**
+ * @brief Set the array stating whether a span set contains each value of a
+ * batch using packed arrays of its bounds
+ */
+static void
+contains_spanset_values_packed(const SpanSet *ss, const Datum *values,
+  int count, bool *result)
+{
+  int64 *lower = palloc(sizeof(int64) * ss->count);
+  int64 *upper = palloc(sizeof(int64) * ss->count);
+  spanset_pack_bounds(ss, lower, upper);
+  for (int i = 0; i < count; i++)
+  {
+    int64 value = datum_int64(values[i], ss->basetype);
+    int j = int64arr_lower_bound(upper, ss->count, value);
+    result[i] = (j < ss->count) && lower[j] <= value;
+  }
+  pfree(lower); pfree(upper);
+  return;
+}
+
 /*****************************************************************************
  * Contains
  *****************************************************************************/
@@ -156,6 +337,84 @@ contains_spanset_timestamptz(const SpanSet *ss, TimestampTz t)
   return contains_spanset_value(ss, TimestampTzGetDatum(t));
 }
 
+/**
+ * @ingroup meos_internal_setspan_topo
+ * @brief Return an array stating whether a span set contains each value of
+ * an array
+ * @details When the span set has many spans with integer bounds and the batch
+ * is not negligible with respect to them, each value is located by a binary
+ * search in packed arrays of the bounds. Otherwise, when the values are in increasing order the
+ * span set is traversed in a single pass that skips the spans between two
+ * consecutive values with exponential search, and each value is located with
+ * a binary search when they are not ordered
+ * @param[in] ss Span set
+ * @param[in] values Values
+ * @param[in] count Number of values
+ */
+bool *
+contains_spanset_values(const SpanSet *ss, const Datum *values, int count)
+{
+  assert(ss); assert(values); assert(count > 0);
+  bool *result = palloc(sizeof(bool) * count);
+  if (spanset_packable(ss, count))
+  {
+    contains_spanset_values_packed(ss, values, count, result);
+    return result;
+  }
+  meosType basetype = ss->basetype;
+  bool ordered = true;
+  for (int i = 1; i < count; i++)
+  {
+    if (datum_lt(values[i], values[i - 1], basetype))
+    {
+      ordered = false;
+      break;
+    }
+  }
+  if (! ordered)
+  {
+    for (int i = 0; i < count; i++)
+      result[i] = contains_spanset_value(ss, values[i]);
+    return result;
+  }
+  int j = 0;
+  for (int i = 0; i < count; i++)
+  {
+    j = spanset_gallop_value(ss, j, values[i]);
+    result[i] = (j < ss->count) &&
+      contains_span_value(SPANSET_SP_N(ss, j), values[i]);
+  }
+  return result;
+}
+
+#if MEOS
+/**
+ * @ingroup meos_setspan_topo
+ * @brief Return an array stating whether a span set contains each timestamptz
+ * of an array
+ * @param[in] ss Span set
+ * @param[in] times Timestamps
+ * @param[in] count Number of timestamps
+ * @see #contains_spanset_values
+ */
+bool *
+contains_spanset_timestamptzarr(const SpanSet *ss, const TimestampTz *times,
+  int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) ss) || ! ensure_not_null((void *) times) ||
+      ! ensure_spanset_isof_basetype(ss, T_TIMESTAMPTZ) ||
+      ! ensure_positive(count))
+    return NULL;
+  Datum *values = palloc(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+    values[i] = TimestampTzGetDatum(times[i]);
+  bool *result = contains_spanset_values(ss, values, count);
+  pfree(values);
+  return result;
+}
+#endif /* MEOS */
+
 /**
  * @ingroup meos_setspan_topo
  * @brief Return true if a span set contains a span
@@ -2247,6 +2506,17 @@ intersection_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2)
   {
     const Span *s1 = SPANSET_SP_N(ss1, i);
     const Span *s2 = SPANSET_SP_N(ss2, j);
+    /* Skip the spans that are to the left of the span of the other set */
+    if (lf_span_span(s1, s2))
+    {
+      i = spanset_gallop_span(ss1, i + 1, s2);
+      continue;
+    }
+    if (lf_span_span(s2, s1))
+    {
+      j = spanset_gallop_span(ss2, j + 1, s1);
+      continue;
+    }
     Span inter;
     if (inter_span_span(s1, s2, &inter))
       spans[nspans++] = inter;
@@ -2613,11 +2883,20 @@ minus_spanset_spanset(const SpanSet *ss1, const SpanSet *ss2)
   {
     const Span *s1 = SPANSET_SP_N(ss1, i);
     const Span *s2 = SPANSET_SP_N(ss2, j);
-    /* The spans do not overlap, copy the first span */
+    /* Skip the spans of the second set that are to the left of the span */
+    if (lf_span_span(s2, s1))
+    {
+      j = spanset_gallop_span(ss2, j + 1, s1);
+      continue;
+    }
+    /* The spans of the first set that are to the left of the span do not
+     * overlap it, copy them */
     if (! over_span_span(s1, s2))
     {
-      spans[nspans++] = *s1;
-      i++;
+      int k = spanset_gallop_span(ss1, i + 1, s2);
+      memcpy(&spans[nspans], SPANSET_SP_N(ss1, i), sizeof(Span) * (k - i));
+      nspans += k - i;
+      i = k;
     }
     else
     {
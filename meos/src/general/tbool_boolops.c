@@ -36,6 +36,9 @@
 
 /* C */
 #include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -76,9 +79,27 @@ datum_not(Datum d)
  * Generic functions
  *****************************************************************************/
 
+/**
+ * @brief Negate in place the values of the instants of a temporal boolean
+ * sequence
+ */
+static void
+tboolseq_not_inplace(TSequence *seq)
+{
+  for (int i = 0; i < seq->count; i++)
+  {
+    TInstant *inst = (TInstant *) TSEQUENCE_INST_N(seq, i);
+    inst->value = BoolGetDatum(! DatumGetBool(inst->value));
+  }
+  return;
+}
+
 /**
  * @ingroup meos_temporal_bool
  * @brief Return the boolean not of a temporal boolean
+ * @details Since negating the values keeps the instants and the bounding
+ * period, the result is a copy of the temporal boolean whose values are
+ * negated in place, instead of going through the lifting infrastructure
  * @param[in] temp Temporal value
  * @csqlfn #Tnot_tbool()
  */
@@ -90,16 +111,27 @@ tnot_tbool(const Temporal *temp)
       ! ensure_temporal_isof_type(temp, T_TBOOL))
     return NULL;
 
-  LiftedFunctionInfo lfinfo;
-  memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
-  lfinfo.func = (varfunc) &datum_not;
-  lfinfo.numparam = 0;
-  lfinfo.argtype[0] = T_TBOOL;
-  lfinfo.restype = T_TBOOL;
-  lfinfo.reslinear = false;
-  lfinfo.invert = INVERT_NO;
-  lfinfo.discont = CONTINUOUS;
-  return tfunc_temporal(temp, &lfinfo);
+  Temporal *result = temporal_copy(temp);
+  assert(temptype_subtype(result->subtype));
+  switch (result->subtype)
+  {
+    case TINSTANT:
+    {
+      TInstant *inst = (TInstant *) result;
+      inst->value = BoolGetDatum(! DatumGetBool(inst->value));
+      break;
+    }
+    case TSEQUENCE:
+      tboolseq_not_inplace((TSequence *) result);
+      break;
+    default: /* TSEQUENCESET */
+    {
+      TSequenceSet *ss = (TSequenceSet *) result;
+      for (int i = 0; i < ss->count; i++)
+        tboolseq_not_inplace((TSequence *) TSEQUENCESET_SEQ_N(ss, i));
+    }
+  }
+  return result;
 }
 
 /**
@@ -123,8 +155,181 @@ boolop_tbool_bool(const Temporal *temp, Datum b, datum_func2 func, bool invert)
   return tfunc_temporal_base(temp, b, &lfinfo);
 }
 
+/**
+ * @brief Return the index of the last instant of a temporal sequence whose
+ * timestamp is less than or equal to a timestamp
+ * @pre The timestamp is not before the first instant of the sequence
+ */
+static int
+tboolseq_find_timestamptz_le(const TSequence *seq, TimestampTz t)
+{
+  int first = 0, last = seq->count - 1, result = 0;
+  while (first <= last)
+  {
+    int middle = (first + last) / 2;
+    if (TSEQUENCE_INST_N(seq, middle)->t <= t)
+    {
+      result = middle;
+      first = middle + 1;
+    }
+    else
+      last = middle - 1;
+  }
+  return result;
+}
+
+/**
+ * @brief Return the boolean operator of two temporal boolean sequences with
+ * step interpolation
+ * @details The instants of the sequences are merged in a single pass and
+ * only the instants where the result value changes are kept. This gives the
+ * normalized sequence obtained by synchronizing the sequences and applying
+ * the lifted function, without constructing the synchronized instants.
+ * @param[in] seq1,seq2 Temporal values
+ * @param[in] func Boolean function
+ * @param[out] result Array on which the pointer of the newly constructed
+ * sequence is stored
+ * @return Number of resulting sequences returned, that is, 0 or 1
+ */
+static int
+boolop_tboolseq_tboolseq(const TSequence *seq1, const TSequence *seq2,
+  datum_func2 func, TSequence **result)
+{
+  Span inter;
+  if (! inter_span_span(&seq1->period, &seq2->period, &inter))
+    return 0;
+
+  TimestampTz lower = DatumGetTimestampTz(inter.lower);
+  TimestampTz upper = DatumGetTimestampTz(inter.upper);
+  int i = tboolseq_find_timestamptz_le(seq1, lower);
+  int j = tboolseq_find_timestamptz_le(seq2, lower);
+  Datum value1 = tinstant_val(TSEQUENCE_INST_N(seq1, i++));
+  Datum value2 = tinstant_val(TSEQUENCE_INST_N(seq2, j++));
+  Datum value = func(value1, value2);
+
+  /* If the two sequences intersect at an instant */
+  if (lower == upper)
+  {
+    result[0] = tinstant_to_tsequence_free(tinstant_make(value, T_TBOOL,
+      lower), STEP);
+    return 1;
+  }
+
+  TInstant **instants = palloc(sizeof(TInstant *) *
+    (seq1->count + seq2->count));
+  instants[0] = tinstant_make(value, T_TBOOL, lower);
+  int ninsts = 1;
+  while (true)
+  {
+    TimestampTz t1 = (i < seq1->count) ? TSEQUENCE_INST_N(seq1, i)->t : upper;
+    TimestampTz t2 = (j < seq2->count) ? TSEQUENCE_INST_N(seq2, j)->t : upper;
+    TimestampTz t = Min(t1, t2);
+    if (t >= upper)
+      break;
+    if (t1 == t)
+      value1 = tinstant_val(TSEQUENCE_INST_N(seq1, i++));
+    if (t2 == t)
+      value2 = tinstant_val(TSEQUENCE_INST_N(seq2, j++));
+    Datum newvalue = func(value1, value2);
+    if (DatumGetBool(newvalue) != DatumGetBool(value))
+    {
+      instants[ninsts++] = tinstant_make(newvalue, T_TBOOL, t);
+      value = newvalue;
+    }
+  }
+  /* The last two values of sequences with step interpolation and exclusive
+   * upper bound must be equal */
+  if (inter.upper_inc)
+  {
+    if (i < seq1->count && TSEQUENCE_INST_N(seq1, i)->t == upper)
+      value1 = tinstant_val(TSEQUENCE_INST_N(seq1, i));
+    if (j < seq2->count && TSEQUENCE_INST_N(seq2, j)->t == upper)
+      value2 = tinstant_val(TSEQUENCE_INST_N(seq2, j));
+    value = func(value1, value2);
+  }
+  instants[ninsts++] = tinstant_make(value, T_TBOOL, upper);
+  result[0] = tsequence_make_free(instants, ninsts, inter.lower_inc,
+    inter.upper_inc, STEP, NORMALIZE_NO);
+  return 1;
+}
+
+/**
+ * @brief Return the composing sequences of a temporal boolean sequence or
+ * sequence set
+ */
+static const TSequence **
+tbool_sequences_p(const Temporal *temp, int *count)
+{
+  if (temp->subtype == TSEQUENCE)
+  {
+    const TSequence **result = palloc(sizeof(TSequence *));
+    result[0] = (const TSequence *) temp;
+    *count = 1;
+    return result;
+  }
+  const TSequenceSet *ss = (const TSequenceSet *) temp;
+  const TSequence **result = palloc(sizeof(TSequence *) * ss->count);
+  for (int i = 0; i < ss->count; i++)
+    result[i] = TSEQUENCESET_SEQ_N(ss, i);
+  *count = ss->count;
+  return result;
+}
+
+/**
+ * @brief Return the boolean operator of two temporal booleans with step
+ * interpolation
+ * @details The composing sequences of the arguments are merged as done in
+ * function #tfunc_tsequenceset_tsequenceset
+ */
+static Temporal *
+boolop_tboolstep_tboolstep(const Temporal *temp1, const Temporal *temp2,
+  datum_func2 func)
+{
+  int count1, count2;
+  const TSequence **seqs1 = tbool_sequences_p(temp1, &count1);
+  const TSequence **seqs2 = tbool_sequences_p(temp2, &count2);
+  TSequence **sequences = palloc(sizeof(TSequence *) * (count1 + count2));
+  int i = 0, j = 0, nseqs = 0;
+  while (i < count1 && j < count2)
+  {
+    const TSequence *seq1 = seqs1[i];
+    const TSequence *seq2 = seqs2[j];
+    nseqs += boolop_tboolseq_tboolseq(seq1, seq2, func, &sequences[nseqs]);
+    int cmp = timestamptz_cmp_internal(DatumGetTimestampTz(seq1->period.upper),
+      DatumGetTimestampTz(seq2->period.upper));
+    if (cmp == 0)
+    {
+      if (! seq1->period.upper_inc && seq2->period.upper_inc)
+        cmp = -1;
+      else if (seq1->period.upper_inc && ! seq2->period.upper_inc)
+        cmp = 1;
+    }
+    if (cmp == 0)
+    {
+      i++; j++;
+    }
+    else if (cmp < 0)
+      i++;
+    else
+      j++;
+  }
+  pfree(seqs1); pfree(seqs2);
+
+  /* The result of two sequences is a sequence */
+  if (temp1->subtype == TSEQUENCE && temp2->subtype == TSEQUENCE)
+  {
+    Temporal *result = (nseqs == 0) ? NULL : (Temporal *) sequences[0];
+    pfree(sequences);
+    return result;
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+}
+
 /**
  * @brief Return the boolean operator of two temporal booleans
+ * @details Temporal booleans with step interpolation, such as those resulting
+ * from the temporal spatial relationships, use a specialized merge of their
+ * instants, the other ones use the lifting infrastructure
  */
 Temporal *
 boolop_tbool_tbool(const Temporal *temp1, const Temporal *temp2,
@@ -133,6 +338,11 @@ boolop_tbool_tbool(const Temporal *temp1, const Temporal *temp2,
   assert(temp1); assert(temp2);
   assert(temp1->temptype == temp2->temptype);
   assert(temp1->temptype == T_TBOOL);
+  if (temp1->subtype != TINSTANT && temp2->subtype != TINSTANT &&
+      ! MEOS_FLAGS_DISCRETE_INTERP(temp1->flags) &&
+      ! MEOS_FLAGS_DISCRETE_INTERP(temp2->flags))
+    return boolop_tboolstep_tboolstep(temp1, temp2, func);
+
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
   lfinfo.func = (varfunc) func;
@@ -148,6 +358,57 @@ boolop_tbool_tbool(const Temporal *temp1, const Temporal *temp2,
 
 /*****************************************************************************/
 
+/**
+ * @brief Return in the last argument the spans of the runs of true values of
+ * a temporal boolean sequence
+ * @return Number of spans returned
+ */
+static int
+tboolseq_when_true_iter(const TSequence *seq, Span *result)
+{
+  int nspans = 0;
+  /* Discrete or instantaneous sequence */
+  if (MEOS_FLAGS_DISCRETE_INTERP(seq->flags) || seq->count == 1)
+  {
+    for (int i = 0; i < seq->count; i++)
+    {
+      const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+      if (DatumGetBool(tinstant_val(inst)))
+        span_set(TimestampTzGetDatum(inst->t), TimestampTzGetDatum(inst->t),
+          true, true, T_TIMESTAMPTZ, T_TSTZSPAN, &result[nspans++]);
+    }
+    return nspans;
+  }
+
+  /* Step sequence: each run of true values ends at the next false value or
+   * at the end of the sequence */
+  int start = -1;
+  for (int i = 0; i < seq->count; i++)
+  {
+    bool value = DatumGetBool(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+    if (value && start < 0)
+      start = i;
+    else if (! value && start >= 0)
+    {
+      span_set(TimestampTzGetDatum(TSEQUENCE_INST_N(seq, start)->t),
+        TimestampTzGetDatum(TSEQUENCE_INST_N(seq, i)->t),
+        (start == 0) ? seq->period.lower_inc : true, false, T_TIMESTAMPTZ,
+        T_TSTZSPAN, &result[nspans++]);
+      start = -1;
+    }
+  }
+  if (start >= 0)
+  {
+    /* A run starting at the last instant is only kept when the upper bound
+     * is inclusive */
+    if (start < seq->count - 1 || seq->period.upper_inc)
+      span_set(TimestampTzGetDatum(TSEQUENCE_INST_N(seq, start)->t),
+        seq->period.upper, (start == 0) ? seq->period.lower_inc : true,
+        seq->period.upper_inc, T_TIMESTAMPTZ, T_TSTZSPAN, &result[nspans++]);
+  }
+  return nspans;
+}
+
 /**
  * @ingroup meos_temporal_bool
  * @brief Return the time when the temporal boolean has value true
@@ -162,12 +423,29 @@ tbool_when_true(const Temporal *temp)
       ! ensure_temporal_isof_type(temp, T_TBOOL))
     return NULL;
 
-  Temporal *temp1 = temporal_restrict_value(temp, BoolGetDatum(true), REST_AT);
-  if (! temp1)
-    return NULL;
-  SpanSet *result = temporal_time(temp1);
-  pfree(temp1);
-  return result;
+  /* The spans are extracted from the runs of true values of the instants
+   * instead of restricting the temporal boolean to true */
+  int count = (temp->subtype == TINSTANT) ? 1 :
+    ((temp->subtype == TSEQUENCE) ? ((TSequence *) temp)->count :
+      ((TSequenceSet *) temp)->totalcount);
+  Span *spans = palloc(sizeof(Span) * count);
+  int nspans = 0;
+  if (temp->subtype == TINSTANT)
+  {
+    const TInstant *inst = (const TInstant *) temp;
+    if (DatumGetBool(tinstant_val(inst)))
+      span_set(TimestampTzGetDatum(inst->t), TimestampTzGetDatum(inst->t),
+        true, true, T_TIMESTAMPTZ, T_TSTZSPAN, &spans[nspans++]);
+  }
+  else
+  {
+    int nseqs;
+    const TSequence **seqs = tbool_sequences_p(temp, &nseqs);
+    for (int i = 0; i < nseqs; i++)
+      nspans += tboolseq_when_true_iter(seqs[i], &spans[nspans]);
+    pfree(seqs);
+  }
+  return spanset_make_free(spans, nspans, NORMALIZE, ORDER_NO);
 }
 
 /*****************************************************************************/
@@ -49,7 +49,9 @@
 #include <meos_internal.h>
 #include "general/doxygen_meos.h"
 #include "general/lifting.h"
+#include "general/span.h"
 #include "general/temporal_boxops.h"
+#include "general/temporal_restrict.h"
 #include "general/temporal_tile.h"
 #include "general/tinstant.h"
 #include "general/tsequence.h"
@@ -58,6 +60,9 @@
 #include "general/type_util.h"
 #include "point/tpoint.h"
 #include "point/tpoint_spatialfuncs.h"
+#if NPOINT
+  #include "npoint/tnpoint.h"
+#endif
 
 /*****************************************************************************
  * Parameter tests
@@ -704,7 +709,9 @@ Temporal *
 temporal_in(const char *str, meosType temptype)
 {
   assert(str);
-  return temporal_parse(&str, temptype);
+  Temporal *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_IO, result = temporal_parse(&str, temptype));
+  return result;
 }
 
 #if MEOS
@@ -720,7 +727,7 @@ tbool_in(const char *str)
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) str))
     return NULL;
-  return temporal_parse(&str, T_TBOOL);
+  return temporal_in(str, T_TBOOL);
 }
 
 /**
@@ -735,7 +742,7 @@ tint_in(const char *str)
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) str))
     return NULL;
-  return temporal_parse(&str, T_TINT);
+  return temporal_in(str, T_TINT);
 }
 
 /**
@@ -749,7 +756,7 @@ tfloat_in(const char *str)
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) str))
     return NULL;
-  return temporal_parse(&str, T_TFLOAT);
+  return temporal_in(str, T_TFLOAT);
 }
 
 /**
@@ -763,23 +770,17 @@ ttext_in(const char *str)
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) str))
     return NULL;
-  return temporal_parse(&str, T_TTEXT);
+  return temporal_in(str, T_TTEXT);
 }
 #endif /* MEOS */
 
 /**
- * @ingroup meos_internal_temporal_inout
  * @brief Return the Well-Known Text (WKT) representation of a temporal value
- * @param[in] temp Temporal value
- * @param[in] maxdd Maximum number of decimal digits
+ * according to its subtype
  */
-char *
-temporal_out(const Temporal *temp, int maxdd)
+static char *
+temporal_out_dispatch(const Temporal *temp, int maxdd)
 {
-  assert(temp);
-  if (! ensure_not_negative(maxdd))
-    return NULL;
-
   assert(temptype_subtype(temp->subtype));
   switch (temp->subtype)
   {
@@ -792,6 +793,24 @@ temporal_out(const Temporal *temp, int maxdd)
   }
 }
 
+/**
+ * @ingroup meos_internal_temporal_inout
+ * @brief Return the Well-Known Text (WKT) representation of a temporal value
+ * @param[in] temp Temporal value
+ * @param[in] maxdd Maximum number of decimal digits
+ */
+char *
+temporal_out(const Temporal *temp, int maxdd)
+{
+  assert(temp);
+  if (! ensure_not_negative(maxdd))
+    return NULL;
+  char *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_IO,
+    result = temporal_out_dispatch(temp, maxdd));
+  return result;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_inout
@@ -1492,6 +1511,91 @@ temporal_compact(const Temporal *temp)
   }
 }
 
+/**
+ * @brief Return the size of the part of a temporal sequence (set) that is
+ * kept uncompressed in the compressed format, that is, up to and including
+ * the bounding box
+ */
+size_t
+temporal_compressed_header_size(const Temporal *temp)
+{
+  if (temp->subtype == TSEQUENCE)
+    return (char *) TSEQUENCE_OFFSETS_PTR((TSequence *) temp) - (char *) temp;
+  return (char *) TSEQUENCESET_OFFSETS_PTR((TSequenceSet *) temp) -
+    (char *) temp;
+}
+
+/**
+ * @ingroup meos_internal_temporal_transf
+ * @brief Return a temporal value in the compressed storage format
+ * @details The header and the bounding box of a temporal sequence (set) are
+ * kept uncompressed at the front of the value, so that they can be read
+ * without decompressing the value, while the composing instants or sequences
+ * are replaced by the compressed WKB representation of the value, see
+ * #temporal_as_wkb. A compressed value must be decompressed with
+ * #temporal_decompress before any other function is applied to it.
+ * @param[in] temp Temporal value
+ * @return A copy of the temporal value if it is an instant or if its
+ * compressed representation is not smaller
+ */
+Temporal *
+temporal_compress(const Temporal *temp)
+{
+  assert(temp);
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT || MEOS_FLAGS_GET_COMPRESSED(temp->flags))
+    return temporal_cp(temp);
+
+  size_t hdrsize = temporal_compressed_header_size(temp);
+  size_t wkbsize;
+  uint8_t *wkb = temporal_as_wkb(temp,
+    WKB_EXTENDED | WKB_NDR | MEOS_WKB_COMPRESSED, &wkbsize);
+  size_t memsize = hdrsize + wkbsize;
+  if (memsize >= VARSIZE(temp))
+  {
+    pfree(wkb);
+    return temporal_cp(temp);
+  }
+  Temporal *result = palloc(memsize);
+  memcpy(result, temp, hdrsize);
+  SET_VARSIZE(result, memsize);
+  /* Remove the extra storage space and the storage layout of the value */
+  if (temp->subtype == TSEQUENCE)
+    ((TSequence *) result)->maxcount = ((TSequence *) temp)->count;
+  else
+    ((TSequenceSet *) result)->maxcount = ((TSequenceSet *) temp)->count;
+  MEOS_FLAGS_SET_FIXED(result->flags, false);
+  MEOS_FLAGS_SET_COMPRESSED(result->flags, true);
+  memcpy((char *) result + hdrsize, wkb, wkbsize);
+  pfree(wkb);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_transf
+ * @brief Return a temporal value in the compressed storage format converted
+ * to the standard format
+ * @param[in] temp Temporal value
+ * @return A copy of the temporal value if it is not compressed
+ */
+Temporal *
+temporal_decompress(const Temporal *temp)
+{
+  assert(temp);
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT || ! MEOS_FLAGS_GET_COMPRESSED(temp->flags))
+    return temporal_cp(temp);
+  if (tpoint_quantized(temp))
+    return tpoint_unquantize(temp);
+#if NPOINT
+  if (tnpoint_packed(temp))
+    return tnpoint_unpack(temp);
+#endif
+  size_t hdrsize = temporal_compressed_header_size(temp);
+  return temporal_from_wkb((uint8_t *) temp + hdrsize,
+    VARSIZE(temp) - hdrsize);
+}
+
 #if MEOS
 /**
  * @ingroup meos_internal_temporal_transf
@@ -3641,6 +3745,70 @@ tnumber_twavg(const Temporal *temp)
   }
 }
 
+#if MEOS
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return the time-weighted average of a temporal number restricted to
+ * a timestamptz span
+ * @details The result is equal to the time-weighted average of the
+ * restriction of the temporal number to the span but, for continuous
+ * sequences and sequence sets, the composing instants are not copied
+ * @param[in] temp Temporal value
+ * @param[in] s Timestamp span
+ * @return On error or if the restriction is empty return @p DBL_MAX
+ * @see #tnumber_twavg
+ */
+double
+tnumber_twavg_at_tstzspan(const Temporal *temp, const Span *s)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) s) ||
+      ! ensure_tnumber_type(temp->temptype) ||
+      ! ensure_span_isof_type(s, T_TSTZSPAN))
+    return DBL_MAX;
+
+  assert(temptype_subtype(temp->subtype));
+  TSequenceView view;
+  double result;
+  if (temp->subtype == TINSTANT || MEOS_FLAGS_DISCRETE_INTERP(temp->flags))
+  {
+    /* Instants and discrete sequences do not copy their values */
+    Temporal *at = temporal_restrict_tstzspan(temp, s, REST_AT);
+    if (! at)
+      return DBL_MAX;
+    result = tnumber_twavg(at);
+    pfree(at);
+    return result;
+  }
+  if (temp->subtype == TSEQUENCE)
+  {
+    if (! tcontseq_at_tstzspan_view((TSequence *) temp, s, &view))
+      return DBL_MAX;
+    result = tnumberseqview_twavg(&view);
+    tsequenceview_free(&view);
+    return result;
+  }
+  /* TSEQUENCESET, computed as in #tnumberseqset_twavg */
+  const TSequenceSet *ss = (const TSequenceSet *) temp;
+  double integral = 0.0, duration = 0.0, twavg = 0.0;
+  int count = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (! tcontseq_at_tstzspan_view(TSEQUENCESET_SEQ_N(ss, i), s, &view))
+      continue;
+    integral += tnumberseqview_integral(&view);
+    duration += (double) (DatumGetTimestampTz(view.period.upper) -
+      DatumGetTimestampTz(view.period.lower));
+    twavg += tnumberseqview_twavg(&view);
+    count++;
+    tsequenceview_free(&view);
+  }
+  if (count == 0)
+    return DBL_MAX;
+  return (duration == 0.0) ? twavg / count : integral / duration;
+}
+#endif /* MEOS */
+
 /*****************************************************************************
  * Comparison functions for defining B-tree index
  *****************************************************************************/
@@ -3660,6 +3828,10 @@ temporal_eq(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_temporal_type(temp1, temp2))
     return false;
 
+  /* Values with the same bytes are equal, e.g., when deduplicating */
+  if (VARLENA_BYTES_EQ(temp1, temp2))
+    return true;
+
   assert(temptype_subtype(temp1->subtype));
   assert(temptype_subtype(temp2->subtype));
   /* If both are of the same temporal type use the specific equality */
@@ -3750,10 +3922,88 @@ temporal_ne(const Temporal *temp1, const Temporal *temp2)
 
 /*****************************************************************************/
 
+/**
+ * @brief Classes of the representation-independent order of temporal values
+ */
+typedef enum
+{
+  TEMPORAL_CMP_INSTANTS,   /**< Instants, discrete sequences, and sequence
+                                (sets) composed of instantaneous sequences */
+  TEMPORAL_CMP_SEQUENCE,   /**< Continuous sequences and sequence sets with a
+                                single sequence */
+  TEMPORAL_CMP_SEQUENCESET /**< Other sequence sets */
+} temporalCmpClass;
+
+/**
+ * @brief Return the class of a temporal value in the order independent of
+ * the representation, which is the same for the values that are equal
+ * @param[in] temp Temporal value
+ * @param[out] count Number of instants of a value of the instants class
+ */
+static temporalCmpClass
+temporal_cmp_class(const Temporal *temp, int *count)
+{
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      *count = 1;
+      return TEMPORAL_CMP_INSTANTS;
+    case TSEQUENCE:
+    {
+      const TSequence *seq = (const TSequence *) temp;
+      *count = seq->count;
+      return (seq->count == 1 || MEOS_FLAGS_DISCRETE_INTERP(seq->flags)) ?
+        TEMPORAL_CMP_INSTANTS : TEMPORAL_CMP_SEQUENCE;
+    }
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      *count = ss->count;
+      /* All the composing sequences are instantaneous */
+      if (ss->totalcount == ss->count)
+        return TEMPORAL_CMP_INSTANTS;
+      return (ss->count == 1) ? TEMPORAL_CMP_SEQUENCE :
+        TEMPORAL_CMP_SEQUENCESET;
+    }
+  }
+}
+
+/**
+ * @brief Return the n-th instant of a temporal value of the instants class
+ */
+static const TInstant *
+temporal_cmp_inst_n(const Temporal *temp, int n)
+{
+  if (temp->subtype == TINSTANT)
+    return (const TInstant *) temp;
+  if (temp->subtype == TSEQUENCE)
+    return TSEQUENCE_INST_N((const TSequence *) temp, n);
+  return TSEQUENCE_INST_N(TSEQUENCESET_SEQ_N((const TSequenceSet *) temp, n),
+    0);
+}
+
+/**
+ * @brief Return the sequence of a temporal value of the sequence class
+ */
+static const TSequence *
+temporal_cmp_seq(const Temporal *temp)
+{
+  return (temp->subtype == TSEQUENCE) ? (const TSequence *) temp :
+    TSEQUENCESET_SEQ_N((const TSequenceSet *) temp, 0);
+}
+
 /**
  * @ingroup meos_temporal_comp_trad
  * @brief Return -1, 0, or 1 depending on whether the first temporal value is
  * less than, equal, or greater than the second one
+ * @details The order does not depend on the subtype of the values, so that it
+ * is consistent with #temporal_eq, which considers equal, e.g., an instant
+ * and a sequence composed of this instant. The values are ordered by their
+ * bounding box, then by their class, where the instants, the discrete
+ * sequences, and the sequence (sets) composed of instantaneous sequences are
+ * before the continuous sequences, which are before the sequence sets, and
+ * finally by their composing instants or sequences.
  * @param[in] temp1,temp2 Temporal values
  * @note Function used for B-tree comparison
  * @csqlfn #Temporal_cmp()
@@ -3766,6 +4016,11 @@ temporal_cmp(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_temporal_type(temp1, temp2))
     return INT_MAX;
 
+  /* Values with the same bytes are equal, e.g., when deduplicating or when
+   * building a unique index, avoid comparing their instants */
+  if (VARLENA_BYTES_EQ(temp1, temp2))
+    return 0;
+
   /* Compare bounding box */
   bboxunion box1, box2;
   temporal_set_bbox(temp1, &box1);
@@ -3774,50 +4029,34 @@ temporal_cmp(const Temporal *temp1, const Temporal *temp2)
   if (result)
     return result;
 
-  /* If both are of the same temporal type use the specific comparison */
-  if (temp1->subtype == temp2->subtype)
+  /* Compare the class of the values */
+  int count1, count2;
+  temporalCmpClass class1 = temporal_cmp_class(temp1, &count1);
+  temporalCmpClass class2 = temporal_cmp_class(temp2, &count2);
+  if (class1 != class2)
+    return (class1 < class2) ? -1 : 1;
+
+  switch (class1)
   {
-    assert(temptype_subtype(temp1->subtype));
-    switch (temp1->subtype)
+    case TEMPORAL_CMP_INSTANTS:
     {
-      case TINSTANT:
-        return tinstant_cmp((TInstant *) temp1, (TInstant *) temp2);
-      case TSEQUENCE:
-        return tsequence_cmp((TSequence *) temp1, (TSequence *) temp2);
-      default: /* TSEQUENCESET */
-        return tsequenceset_cmp((TSequenceSet *) temp1, (TSequenceSet *) temp2);
+      /* Compare the composing instants whatever the subtype */
+      int count = Min(count1, count2);
+      for (int i = 0; i < count; i++)
+      {
+        result = tinstant_cmp(temporal_cmp_inst_n(temp1, i),
+          temporal_cmp_inst_n(temp2, i));
+        if (result)
+          return result;
+      }
+      return (count1 < count2) ? -1 : ((count1 > count2) ? 1 : 0);
     }
+    case TEMPORAL_CMP_SEQUENCE:
+      return tsequence_cmp(temporal_cmp_seq(temp1), temporal_cmp_seq(temp2));
+    default: /* TEMPORAL_CMP_SEQUENCESET */
+      return tsequenceset_cmp((const TSequenceSet *) temp1,
+        (const TSequenceSet *) temp2);
   }
-
-  /* Use the hash comparison */
-  uint32 hash1 = temporal_hash(temp1);
-  uint32 hash2 = temporal_hash(temp2);
-  if (hash1 < hash2)
-    return -1;
-  else if (hash1 > hash2)
-    return 1;
-
-  /* Compare memory size */
-  size_t size1 = VARSIZE(temp1);
-  size_t size2 = VARSIZE(temp2);
-  if (size1 < size2)
-    return -1;
-  else if (size1 > size2)
-    return 1;
-
-  /* Compare flags */
-  if (temp1->flags < temp2->flags)
-    return -1;
-  if (temp1->flags > temp2->flags)
-    return 1;
-
-  /* Finally compare temporal subtype */
-  if (temp1->subtype < temp2->subtype)
-    return -1;
-  else if (temp1->subtype > temp2->subtype)
-    return 1;
-  else
-    return 0;
 }
 
 /**
@@ -3896,7 +4135,8 @@ temporal_hash(const Temporal *temp)
   switch (temp->subtype)
   {
     case TINSTANT:
-      return tinstant_hash((TInstant *) temp);
+      /* Same hash value as a sequence composed of the instant */
+      return 31 + tinstant_hash((TInstant *) temp);
     case TSEQUENCE:
       return tsequence_hash((TSequence *) temp);
     default: /* TSEQUENCESET */
@@ -3904,4 +4144,34 @@ temporal_hash(const Temporal *temp)
   }
 }
 
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return the 64-bit hash value of a temporal value using a seed
+ * @details As required by PostgreSQL, the low-order 32 bits of the hash
+ * value for the seed 0 are equal to the result of #temporal_hash()
+ * @param[in] temp Temporal value
+ * @param[in] seed Seed
+ * @result On error return @p INT_MAX
+ * @csqlfn #Temporal_hash_extended()
+ */
+uint64
+temporal_hash_extended(const Temporal *temp, uint64 seed)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp))
+    return INT_MAX;
+
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      /* Same hash value as a sequence composed of the instant */
+      return 31 + tinstant_hash_extended((TInstant *) temp, seed);
+    case TSEQUENCE:
+      return tsequence_hash_extended((TSequence *) temp, seed);
+    default: /* TSEQUENCESET */
+      return tsequenceset_hash_extended((TSequenceSet *) temp, seed);
+  }
+}
+
 /*****************************************************************************/
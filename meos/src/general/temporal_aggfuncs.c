@@ -36,18 +36,22 @@
 
 /* C */
 #include <assert.h>
+#include <math.h>
 #include <string.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <port/pg_bitutils.h>
 #include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/pg_types.h"
 #include "general/set.h"
 #include "general/skiplist.h"
 #include "general/span.h"
 #include "general/spanset.h"
 #include "general/temporal_restrict.h"
+#include "general/temporal_tile.h"
 #include "general/tbool_boolops.h"
 #include "general/tinstant.h"
 #include "general/tsequence.h"
@@ -167,6 +171,92 @@ datum_sum_double4(Datum l, Datum r)
     (double4 *) DatumGetPointer(r)));
 }
 
+/*****************************************************************************
+ * Aggregate functions on arrays of doubleN values
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the function is the sum of doubleN values, which is
+ * computed with the array kernels
+ */
+static bool
+datum_sum_doublen_fn(datum_func2 func)
+{
+  return func == &datum_sum_double2 || func == &datum_sum_double3 ||
+    func == &datum_sum_double4;
+}
+
+/**
+ * @brief Sum two arrays of doubleN values of a temporal type
+ * @param[in] arr1,arr2 Arrays
+ * @param[in] count Number of elements in the arrays
+ * @param[in] temptype Temporal type of the values
+ * @param[out] result Array of the sums, may be the first array
+ */
+static void
+doublenarr_add(const void *arr1, const void *arr2, int count,
+  meosType temptype, void *result)
+{
+  assert(temptype == T_TDOUBLE2 || temptype == T_TDOUBLE3 ||
+    temptype == T_TDOUBLE4);
+  if (temptype == T_TDOUBLE2)
+    double2arr_add(arr1, arr2, count, result);
+  else if (temptype == T_TDOUBLE3)
+    double3arr_add(arr1, arr2, count, result);
+  else /* temptype == T_TDOUBLE4 */
+    double4arr_add(arr1, arr2, count, result);
+  return;
+}
+
+/**
+ * @brief Copy the values of a temporal doubleN sequence into an array
+ * @param[in] seq Temporal sequence
+ * @param[in] size Size of the values
+ * @param[out] result Array of values
+ */
+static void
+tdoublenseq_values(const TSequence *seq, size_t size, char *result)
+{
+  for (int i = 0; i < seq->count; i++)
+    memcpy(result + size * i,
+      DatumGetPointer(tinstant_val(TSEQUENCE_INST_N(seq, i))), size);
+  return;
+}
+
+/**
+ * @brief Return the sum of two synchronized temporal doubleN sequences
+ * @details The values are summed with an array kernel and the instants are
+ * constructed contiguously in a single memory block, instead of allocating
+ * an intermediate value and an instant for every timestamp
+ * @param[in] seq1,seq2 Temporal sequences with the same timestamps
+ * @param[in] lower_inc,upper_inc Bounds of the result
+ */
+static TSequence *
+tdoublenseq_sum(const TSequence *seq1, const TSequence *seq2, bool lower_inc,
+  bool upper_inc)
+{
+  int count = seq1->count;
+  size_t size = (size_t) basetype_length(temptype_basetype(seq1->temptype));
+  char *values = palloc(size * count * 2);
+  char *values2 = values + size * count;
+  tdoublenseq_values(seq1, size, values);
+  tdoublenseq_values(seq2, size, values2);
+  doublenarr_add(values, values2, count, seq1->temptype, values);
+  /* Construct the instants contiguously and the resulting sequence */
+  size_t instsize = tinstant_make_size(PointerGetDatum(values),
+    seq1->temptype);
+  char *block = palloc(instsize * count);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = tinstant_make_in(block + instsize * i,
+      PointerGetDatum(values + size * i), seq1->temptype,
+      TSEQUENCE_INST_N(seq1, i)->t);
+  TSequence *result = tsequence_make((const TInstant **) instants, count,
+    lower_inc, upper_inc, MEOS_FLAGS_GET_INTERP(seq1->flags), NORMALIZE);
+  pfree(instants); pfree(block); pfree(values);
+  return result;
+}
+
 /*****************************************************************************
  * Generic aggregation functions
  *****************************************************************************/
@@ -195,7 +285,16 @@ tinstant_tagg(TInstant **instants1, int count1, TInstant **instants2,
     int cmp = timestamptz_cmp_internal(inst1->t, inst2->t);
     if (cmp == 0)
     {
-      if (func != NULL)
+      if (func != NULL && datum_sum_doublen_fn(func))
+      {
+        /* Sum into a value on the stack copied into the instant */
+        double4 sum;
+        doublenarr_add(DatumGetPointer(tinstant_val(inst1)),
+          DatumGetPointer(tinstant_val(inst2)), 1, inst1->temptype, &sum);
+        result[count++] = tinstant_make(PointerGetDatum(&sum),
+          inst1->temptype, inst1->t);
+      }
+      else if (func != NULL)
         result[count++] = tinstant_make(
           func(tinstant_val(inst1), tinstant_val(inst2)), inst1->temptype,
           inst1->t);
@@ -326,31 +425,37 @@ tsequence_tagg_iter(const TSequence *seq1, const TSequence *seq2,
    */
   TSequence *syncseq1, *syncseq2;
   synchronize_tsequence_tsequence(seq1, seq2, &syncseq1, &syncseq2, crossings);
-  TInstant **instants = palloc(sizeof(TInstant *) * syncseq1->count);
-  for (int i = 0; i < syncseq1->count; i++)
+  if (func != NULL && datum_sum_doublen_fn(func))
+    sequences[nseqs++] = tdoublenseq_sum(syncseq1, syncseq2, lower_inc,
+      upper_inc);
+  else
   {
-    const TInstant *inst1 = TSEQUENCE_INST_N(syncseq1, i);
-    const TInstant *inst2 = TSEQUENCE_INST_N(syncseq2, i);
-    if (func != NULL)
-      instants[i] = tinstant_make(
-        func(tinstant_val(inst1), tinstant_val(inst2)), seq1->temptype,
-        inst1->t);
-    else
+    TInstant **instants = palloc(sizeof(TInstant *) * syncseq1->count);
+    for (int i = 0; i < syncseq1->count; i++)
     {
-      if (tinstant_eq(inst1, inst2))
-        instants[i] = tinstant_copy(inst1);
+      const TInstant *inst1 = TSEQUENCE_INST_N(syncseq1, i);
+      const TInstant *inst2 = TSEQUENCE_INST_N(syncseq2, i);
+      if (func != NULL)
+        instants[i] = tinstant_make(
+          func(tinstant_val(inst1), tinstant_val(inst2)), seq1->temptype,
+          inst1->t);
       else
       {
-        char *t1 = pg_timestamptz_out(inst1->t);
-        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-          "The temporal values have different value at their common timestamp %s",
-          t1);
-        return -1;
+        if (tinstant_eq(inst1, inst2))
+          instants[i] = tinstant_copy(inst1);
+        else
+        {
+          char *t1 = pg_timestamptz_out(inst1->t);
+          meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+            "The temporal values have different value at their common timestamp %s",
+            t1);
+          return -1;
+        }
       }
     }
+    sequences[nseqs++] = tsequence_make_free(instants, syncseq1->count,
+      lower_inc, upper_inc, MEOS_FLAGS_GET_INTERP(seq1->flags), NORMALIZE);
   }
-  sequences[nseqs++] = tsequence_make_free(instants, syncseq1->count,
-    lower_inc, upper_inc, MEOS_FLAGS_GET_INTERP(seq1->flags), NORMALIZE);
   pfree(syncseq1); pfree(syncseq2);
 
   /* Compute the aggregation on the period after the intersection of the
@@ -576,18 +681,14 @@ tsequenceset_tagg_transfn(SkipList *state, const TSequenceSet *ss,
 }
 
 /**
- * @brief Generic transition function for aggregating temporal values
- * of sequence set subtype
- * @param[in,out] state Skiplist containing the state
- * @param[in] temp Temporal value
- * @param[in] func Function, may be NULL for the merge aggregate function
- * @param[in] crossings True if turning points are added in the segments
+ * @brief Transition function for temporal aggregation of temporal values
+ * according to their subtype
  */
-SkipList *
-temporal_tagg_transfn(SkipList *state, const Temporal *temp, datum_func2 func,
-  bool crossings)
+static SkipList *
+temporal_tagg_transfn_dispatch(SkipList *state, const Temporal *temp,
+  datum_func2 func, bool crossings)
 {
-  assert(temp); assert(temptype_subtype(temp->subtype));
+  assert(temptype_subtype(temp->subtype));
   switch (temp->subtype)
   {
     case TINSTANT:
@@ -602,6 +703,226 @@ temporal_tagg_transfn(SkipList *state, const Temporal *temp, datum_func2 func,
   }
 }
 
+/**
+ * @brief Generic transition function for aggregating temporal values
+ * of sequence set subtype
+ * @param[in,out] state Skiplist containing the state
+ * @param[in] temp Temporal value
+ * @param[in] func Function, may be NULL for the merge aggregate function
+ * @param[in] crossings True if turning points are added in the segments
+ */
+SkipList *
+temporal_tagg_transfn(SkipList *state, const Temporal *temp, datum_func2 func,
+  bool crossings)
+{
+  assert(temp);
+  SkipList *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_AGGREGATION,
+    result = temporal_tagg_transfn_dispatch(state, temp, func, crossings));
+  return result;
+}
+
+/**
+ * @brief Aggregate among themselves the instants of an array of temporal
+ * values of instant or discrete sequence subtype
+ * @param[in] temps Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] ninsts Total number of instants of the temporal values
+ * @param[in] func Function, may be NULL for the merge aggregate function
+ * @param[out] newcount Number of instants in the output array
+ * @note Return new instants that must be freed by the calling function
+ */
+static TInstant **
+tinstant_tagg_batch(const Temporal **temps, int count, int ninsts,
+  datum_func2 func, int *newcount)
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * ninsts);
+  int n = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (temps[i]->subtype == TINSTANT)
+      instants[n++] = (TInstant *) temps[i];
+    else /* temps[i]->subtype == TSEQUENCE */
+    {
+      const TSequence *seq = (const TSequence *) temps[i];
+      for (int j = 0; j < seq->count; j++)
+        instants[n++] = (TInstant *) TSEQUENCE_INST_N(seq, j);
+    }
+  }
+  tinstarr_sort(instants, n);
+
+  /* Aggregate the instants that have the same timestamp */
+  TInstant **result = palloc(sizeof(TInstant *) * n);
+  int k = 0, i = 0;
+  while (i < n)
+  {
+    TInstant *inst = instants[i];
+    Datum value = tinstant_val(inst);
+    int j = i + 1;
+    while (j < n && instants[j]->t == inst->t)
+    {
+      if (func != NULL)
+        value = func(value, tinstant_val(instants[j]));
+      else if (! tinstant_eq(inst, instants[j]))
+      {
+        char *t1 = pg_timestamptz_out(inst->t);
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "The temporal values have different value at their common timestamp %s",
+          t1);
+        pfree(t1); pfree(instants); pfree_array((void **) result, k);
+        return NULL;
+      }
+      j++;
+    }
+    result[k++] = (j == i + 1 || func == NULL) ? tinstant_copy(inst) :
+      tinstant_make(value, inst->temptype, inst->t);
+    i = j;
+  }
+  pfree(instants);
+  *newcount = k;
+  return result;
+}
+
+/**
+ * @brief Aggregate among themselves the sequences of an array of temporal
+ * values of continuous sequence or sequence set subtype
+ * @details The arrays of sequences of the temporal values are aggregated
+ * pairwise with #tsequence_tagg until a single array remains
+ * @param[in] temps Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] func Function, may be NULL for the merge aggregate function
+ * @param[in] crossings True if turning points are added in the segments
+ * @param[out] newcount Number of sequences in the output array
+ * @param[out] owned True if the sequences in the output array are new
+ * sequences that must be freed by the calling function, false if they are
+ * the sequences of the unique temporal value
+ */
+static TSequence **
+tsequence_tagg_batch(const Temporal **temps, int count, datum_func2 func,
+  bool crossings, int *newcount, bool *owned)
+{
+  TSequence ***seqarrs = palloc(sizeof(TSequence **) * count);
+  int *counts = palloc(sizeof(int) * count);
+  bool *owns = palloc0(sizeof(bool) * count);
+  for (int i = 0; i < count; i++)
+  {
+    if (temps[i]->subtype == TSEQUENCE)
+    {
+      seqarrs[i] = palloc(sizeof(TSequence *));
+      seqarrs[i][0] = (TSequence *) temps[i];
+      counts[i] = 1;
+    }
+    else /* temps[i]->subtype == TSEQUENCESET */
+    {
+      seqarrs[i] = (TSequence **) tsequenceset_seqs(
+        (const TSequenceSet *) temps[i]);
+      counts[i] = ((const TSequenceSet *) temps[i])->count;
+    }
+  }
+
+  /* Aggregate the arrays pairwise until a single one remains */
+  int narrs = count;
+  while (narrs > 1)
+  {
+    int n = 0;
+    for (int i = 0; i < narrs; i += 2)
+    {
+      if (i + 1 == narrs)
+      {
+        seqarrs[n] = seqarrs[i]; counts[n] = counts[i]; owns[n] = owns[i];
+        n++;
+        continue;
+      }
+      int nseqs;
+      TSequence **seqs = tsequence_tagg(seqarrs[i], counts[i], seqarrs[i + 1],
+        counts[i + 1], func, crossings, &nseqs);
+      for (int j = i; j <= i + 1; j++)
+      {
+        if (owns[j])
+          pfree_array((void **) seqarrs[j], counts[j]);
+        else
+          pfree(seqarrs[j]);
+      }
+      seqarrs[n] = seqs; counts[n] = nseqs; owns[n] = true;
+      n++;
+    }
+    narrs = n;
+  }
+  TSequence **result = seqarrs[0];
+  *newcount = counts[0];
+  *owned = owns[0];
+  pfree(seqarrs); pfree(counts); pfree(owns);
+  return result;
+}
+
+/**
+ * @brief Generic transition function for aggregating an array of temporal
+ * values at once
+ * @details The temporal values are first aggregated among themselves and the
+ * result is spliced into the state in a single call, instead of one call to
+ * #skiplist_splice per value
+ * @param[in,out] state Skiplist containing the state, may be NULL
+ * @param[in] temps Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] func Function, may be NULL for the merge aggregate function
+ * @param[in] crossings True if turning points are added in the segments
+ */
+SkipList *
+temporal_tagg_transfn_batch(SkipList *state, const Temporal **temps,
+  int count, datum_func2 func, bool crossings)
+{
+  assert(temps); assert(count > 0);
+  /* Temporal aggregation cannot mix instants and sequences */
+  bool instants = temps[0]->subtype == TINSTANT ||
+    MEOS_FLAGS_DISCRETE_INTERP(temps[0]->flags);
+  int ninsts = 0;
+  for (int i = 0; i < count; i++)
+  {
+    assert(temps[i]); assert(temptype_subtype(temps[i]->subtype));
+    bool instants1 = temps[i]->subtype == TINSTANT ||
+      MEOS_FLAGS_DISCRETE_INTERP(temps[i]->flags);
+    if (instants1 != instants)
+    {
+      meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+        "Cannot aggregate temporal values of different subtype");
+      return NULL;
+    }
+    if (MEOS_FLAGS_LINEAR_INTERP(temps[i]->flags) !=
+        MEOS_FLAGS_LINEAR_INTERP(temps[0]->flags))
+    {
+      meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+        "Cannot aggregate temporal values of different interpolation");
+      return NULL;
+    }
+    if (instants)
+      ninsts += (temps[i]->subtype == TINSTANT) ? 1 :
+        ((const TSequence *) temps[i])->count;
+  }
+
+  int newcount;
+  bool owned = true;
+  void **values = instants ?
+    (void **) tinstant_tagg_batch(temps, count, ninsts, func, &newcount) :
+    (void **) tsequence_tagg_batch(temps, count, func, crossings, &newcount,
+      &owned);
+  if (! values)
+    return NULL;
+
+  SkipList *result;
+  if (! state)
+    result = skiplist_make(values, newcount);
+  else
+  {
+    skiplist_splice(state, values, newcount, func, crossings);
+    result = state;
+  }
+  if (owned)
+    pfree_array(values, newcount);
+  else
+    pfree(values);
+  return result;
+}
+
 /**
  * @brief Generic combine function for aggregating temporal values
  * @param[in] state1, state2 State values
@@ -657,6 +978,62 @@ temporal_tagg_finalfn(SkipList *state)
   return result;
 }
 
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Remove from the state of a temporal aggregate the part of its
+ * values before a timestamp
+ * @details The values ending before the timestamp are removed and the value
+ * overlapping the timestamp is restricted to start at it, so that the final
+ * function of the aggregate returns the result of the aggregation restricted
+ * to the period starting at the timestamp
+ * @param[in] state Current aggregate state, which is freed
+ * @param[in] t Timestamp
+ * @return When no value remains return NULL
+ */
+SkipList *
+temporal_tagg_expire(SkipList *state, TimestampTz t)
+{
+  if (! state)
+    return NULL;
+  Span s;
+  span_set(TimestampTzGetDatum(t), TimestampTzGetDatum(DT_NOEND), true, true,
+    T_TIMESTAMPTZ, T_TSTZSPAN, &s);
+  int length = state->length;
+  void **values = skiplist_values(state);
+  Temporal **kept = palloc(sizeof(Temporal *) * Max(length, 1));
+  bool *restricted = palloc0(sizeof(bool) * Max(length, 1));
+  int count = 0;
+  for (int i = 0; i < length; i++)
+  {
+    Temporal *temp = (Temporal *) values[i];
+    if (temp->subtype == TINSTANT)
+    {
+      if (((TInstant *) temp)->t >= t)
+        kept[count++] = temp;
+      continue;
+    }
+    /* The values of the state are instants or continuous sequences */
+    const Span *p = &((TSequence *) temp)->period;
+    if (DatumGetTimestampTz(p->lower) >= t)
+      kept[count++] = temp;
+    else if (DatumGetTimestampTz(p->upper) > t ||
+        (DatumGetTimestampTz(p->upper) == t && p->upper_inc))
+    {
+      restricted[count] = true;
+      kept[count++] = temporal_restrict_tstzspan(temp, &s, REST_AT);
+    }
+  }
+  SkipList *result = count ? skiplist_make((void **) kept, count) : NULL;
+  for (int i = 0; i < count; i++)
+  {
+    if (restricted[i])
+      pfree(kept[i]);
+  }
+  pfree(values); pfree(kept); pfree(restricted);
+  skiplist_free(state);
+  return result;
+}
+
 /*****************************************************************************
  * MEOS aggregate transition functions
  *****************************************************************************/
@@ -1330,6 +1707,271 @@ temporal_tcount_transfn(SkipList *state, const Temporal *temp)
   return state;
 }
 
+/*****************************************************************************
+ * Temporal approximate distinct count
+ *****************************************************************************/
+
+/**
+ * @brief Return the size of a time bucket of a distinct count state, which is
+ * composed of its start timestamp followed by the registers of its sketch
+ */
+#define TDISTINCT_BUCKET_SIZE (sizeof(TimestampTz) + HLL_REGISTERS)
+
+/**
+ * @brief Return a pointer to the n-th time bucket of a distinct count state
+ */
+#define TDISTINCT_BUCKET_N(state, n) ( (TimestampTz *) ( \
+  (char *) (state) + sizeof(TcountDistinctState) + \
+  (size_t) (n) * TDISTINCT_BUCKET_SIZE ) )
+
+/**
+ * @brief Return a pointer to the registers of the n-th time bucket of a
+ * distinct count state
+ */
+#define TDISTINCT_REGISTERS_N(state, n) \
+  ( (uint8 *) (TDISTINCT_BUCKET_N((state), (n)) + 1) )
+
+/**
+ * @brief Return a new distinct count state
+ * @param[in] tunits Size of the time buckets in microseconds
+ * @param[in] torigin Origin of the time buckets
+ * @param[in] capacity Number of time buckets allocated
+ */
+static TcountDistinctState *
+tdistinct_state_make(int64 tunits, TimestampTz torigin, int capacity)
+{
+  size_t size = sizeof(TcountDistinctState) +
+    (size_t) capacity * TDISTINCT_BUCKET_SIZE;
+  TcountDistinctState *result = palloc0(size);
+  SET_VARSIZE(result, size);
+  result->count = 0;
+  result->capacity = capacity;
+  result->precision = HLL_PRECISION;
+  result->tunits = tunits;
+  result->torigin = torigin;
+  return result;
+}
+
+/**
+ * @brief Return the position of the time bucket starting at a timestamp in a
+ * distinct count state, adding an empty bucket if it is not found
+ * @param[in,out] state State, which may be reallocated
+ * @param[in] t Start timestamp of the bucket
+ * @param[in] hint Position where the search starts, which is the position of
+ * the previous bucket found when adding consecutive buckets
+ * @note Buckets are kept in time order and thus values that arrive in time
+ * order only append buckets to the state
+ */
+static int
+tdistinct_state_bucket(TcountDistinctState **state, TimestampTz t, int hint)
+{
+  TcountDistinctState *st = *state;
+  /* Find the first bucket whose start is not smaller than t */
+  int lo = hint, hi = st->count;
+  if (lo > 0 && *TDISTINCT_BUCKET_N(st, lo - 1) >= t)
+    lo = 0;
+  while (lo < hi)
+  {
+    int mid = lo + (hi - lo) / 2;
+    if (*TDISTINCT_BUCKET_N(st, mid) < t)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo < st->count && *TDISTINCT_BUCKET_N(st, lo) == t)
+    return lo;
+
+  /* Add a new empty bucket at the position found */
+  if (st->count == st->capacity)
+  {
+    st->capacity *= 2;
+    size_t size = sizeof(TcountDistinctState) +
+      (size_t) st->capacity * TDISTINCT_BUCKET_SIZE;
+    st = repalloc(st, size);
+    SET_VARSIZE(st, size);
+    *state = st;
+  }
+  if (lo < st->count)
+    memmove(TDISTINCT_BUCKET_N(st, lo + 1), TDISTINCT_BUCKET_N(st, lo),
+      (size_t) (st->count - lo) * TDISTINCT_BUCKET_SIZE);
+  *TDISTINCT_BUCKET_N(st, lo) = t;
+  memset(TDISTINCT_REGISTERS_N(st, lo), 0, HLL_REGISTERS);
+  st->count++;
+  return lo;
+}
+
+/**
+ * @brief Ensure that two distinct count aggregations use the same time buckets
+ */
+static bool
+ensure_same_tdistinct_buckets(const TcountDistinctState *state, int64 tunits,
+  TimestampTz torigin)
+{
+  if (state->tunits == tunits && state->torigin == torigin &&
+      state->precision == HLL_PRECISION)
+    return true;
+  meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+    "The time buckets of the distinct count aggregation must be the same");
+  return false;
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Transition function for approximate temporal distinct count
+ * aggregation
+ * @details The state keeps a HyperLogLog sketch of the identifiers of the
+ * values that are defined at some instant of each time bucket
+ * @param[in,out] state Current aggregate state
+ * @param[in] id Identifier of the moving object of the temporal value
+ * @param[in] temp Temporal value to aggregate
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Origin of the time buckets
+ * @csqlfn #Temporal_tcount_distinct_transfn()
+ */
+TcountDistinctState *
+temporal_tcount_distinct_transfn(TcountDistinctState *state, int64 id,
+  const Temporal *temp, const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) duration) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+  int64 tunits = interval_units(duration);
+  if (! state)
+    /* Arbitrary initialization to 16 buckets */
+    state = tdistinct_state_make(tunits, torigin, 16);
+  else if (! ensure_same_tdistinct_buckets(state, tunits, torigin))
+    return NULL;
+
+  /* Register and rank of the identifier in the sketches */
+  uint64 hash = pg_hashint8extended(id, 0);
+  int reg = (int) (hash >> (64 - HLL_PRECISION));
+  uint64 rest = (hash << HLL_PRECISION) | ((uint64) 1 << (HLL_PRECISION - 1));
+  uint8 rank = (uint8) (64 - pg_leftmost_one_pos64(rest));
+
+  /* Add the identifier to the buckets intersecting the time of the value.
+   * Since the sketches are idempotent, buckets shared by consecutive spans
+   * are simply updated twice */
+  SpanSet *ss = temporal_time(temp);
+  int pos = 0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const Span *s = SPANSET_SP_N(ss, i);
+    TimestampTz lower = DatumGetTimestampTz(s->lower);
+    TimestampTz upper = DatumGetTimestampTz(s->upper);
+    TimestampTz first = timestamptz_bucket1(lower, tunits, torigin);
+    TimestampTz last = timestamptz_bucket1(upper, tunits, torigin);
+    /* An exclusive upper bound at the start of a bucket does not reach it */
+    if (! s->upper_inc && last == upper && last > first)
+      last -= tunits;
+    for (TimestampTz t = first; t <= last; t += tunits)
+    {
+      pos = tdistinct_state_bucket(&state, t, pos);
+      uint8 *registers = TDISTINCT_REGISTERS_N(state, pos);
+      if (registers[reg] < rank)
+        registers[reg] = rank;
+    }
+  }
+  pfree(ss);
+  return state;
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Combine function for approximate temporal distinct count aggregation
+ * @param[in] state1,state2 States
+ * @csqlfn #Temporal_tcount_distinct_combinefn()
+ */
+TcountDistinctState *
+temporal_tcount_distinct_combinefn(TcountDistinctState *state1,
+  const TcountDistinctState *state2)
+{
+  if (! state2)
+    return state1;
+  if (! state1)
+  {
+    TcountDistinctState *result = palloc(VARSIZE(state2));
+    memcpy(result, state2, VARSIZE(state2));
+    return result;
+  }
+  if (! ensure_same_tdistinct_buckets(state1, state2->tunits,
+      state2->torigin))
+    return NULL;
+  int pos = 0;
+  for (int i = 0; i < state2->count; i++)
+  {
+    pos = tdistinct_state_bucket(&state1, *TDISTINCT_BUCKET_N(state2, i), pos);
+    uint8 *registers1 = TDISTINCT_REGISTERS_N(state1, pos);
+    const uint8 *registers2 = TDISTINCT_REGISTERS_N(state2, i);
+    for (int j = 0; j < HLL_REGISTERS; j++)
+      registers1[j] = Max(registers1[j], registers2[j]);
+  }
+  return state1;
+}
+
+/**
+ * @brief Return the estimated number of distinct identifiers of a
+ * HyperLogLog sketch
+ * @note Small cardinalities are estimated with linear counting, which makes
+ * them almost exact
+ */
+static int
+hll_estimate(const uint8 *registers)
+{
+  double m = (double) HLL_REGISTERS, sum = 0.0;
+  int zeros = 0;
+  for (int i = 0; i < HLL_REGISTERS; i++)
+  {
+    sum += ldexp(1.0, - (int) registers[i]);
+    if (registers[i] == 0)
+      zeros++;
+  }
+  double estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+  if (estimate <= 2.5 * m && zeros > 0)
+    estimate = m * log(m / zeros);
+  return (int) (estimate + 0.5);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Final function for approximate temporal distinct count aggregation
+ * @details The result is a temporal integer with step interpolation that is
+ * constant in each time bucket where some value is defined
+ * @param[in] state State
+ * @csqlfn #Temporal_tcount_distinct_finalfn()
+ */
+Temporal *
+temporal_tcount_distinct_finalfn(const TcountDistinctState *state)
+{
+  if (! state || state->count == 0)
+    return NULL;
+  TInstant **instants = palloc(sizeof(TInstant *) * (state->count + 1));
+  TSequence **sequences = palloc(sizeof(TSequence *) * state->count);
+  int ninsts = 0, nseqs = 0;
+  for (int i = 0; i < state->count; i++)
+  {
+    TimestampTz t = *TDISTINCT_BUCKET_N(state, i);
+    int value = hll_estimate(TDISTINCT_REGISTERS_N(state, i));
+    instants[ninsts++] = tinstant_make(Int32GetDatum(value), T_TINT, t);
+    /* Close the sequence when the next bucket is not consecutive */
+    if (i == state->count - 1 ||
+        *TDISTINCT_BUCKET_N(state, i + 1) != t + state->tunits)
+    {
+      instants[ninsts++] = tinstant_make(Int32GetDatum(value), T_TINT,
+        t + state->tunits);
+      sequences[nseqs++] = tsequence_make((const TInstant **) instants,
+        ninsts, true, false, STEP, NORMALIZE);
+      pfree_array((void **) instants, ninsts);
+      ninsts = 0;
+    }
+  }
+  pfree(instants);
+  return (Temporal *) tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+}
+
 /*****************************************************************************
  * Temporal average
  *****************************************************************************/
@@ -1347,6 +1989,34 @@ tnumberinst_transform_tavg(const TInstant *inst)
   return tinstant_make(PointerGetDatum(&dvalue), T_TDOUBLE2, inst->t);
 }
 
+/**
+ * @brief Return a temporal float sequence with the averages of the double2
+ * values of an array of instants
+ * @details The averages are computed with an array kernel and the instants
+ * are constructed contiguously in a single memory block
+ */
+static TSequence *
+tdouble2instarr_tavg(const TInstant **instants, int count, bool lower_inc,
+  bool upper_inc, interpType interp, bool normalize)
+{
+  double2 *values = palloc(sizeof(double2) * count);
+  double *avgs = palloc(sizeof(double) * count);
+  for (int i = 0; i < count; i++)
+    memcpy(&values[i], DatumGetPointer(tinstant_val(instants[i])),
+      sizeof(double2));
+  double2arr_div(values, count, avgs);
+  size_t size = tinstant_make_size(Float8GetDatum(0.0), T_TFLOAT);
+  char *block = palloc(size * count);
+  TInstant **newinstants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    newinstants[i] = tinstant_make_in(block + size * i,
+      Float8GetDatum(avgs[i]), T_TFLOAT, instants[i]->t);
+  TSequence *result = tsequence_make((const TInstant **) newinstants, count,
+    lower_inc, upper_inc, interp, normalize);
+  pfree(newinstants); pfree(block); pfree(avgs); pfree(values);
+  return result;
+}
+
 /**
  * @brief Final function for temporal average aggregation of temporal instant
  * values
@@ -1354,16 +2024,8 @@ tnumberinst_transform_tavg(const TInstant *inst)
 TSequence *
 tinstant_tavg_finalfn(TInstant **instants, int count)
 {
-  TInstant **newinstants = palloc(sizeof(TInstant *) * count);
-  for (int i = 0; i < count; i++)
-  {
-    TInstant *inst = instants[i];
-    double2 *value = (double2 *) DatumGetPointer(tinstant_val(inst));
-    double tavg = value->a / value->b;
-    newinstants[i] = tinstant_make(Float8GetDatum(tavg), T_TFLOAT, inst->t);
-  }
-  return tsequence_make_free(newinstants, count, true, true, DISCRETE,
-    NORMALIZE_NO);
+  return tdouble2instarr_tavg((const TInstant **) instants, count, true, true,
+    DISCRETE, NORMALIZE_NO);
 }
 
 /**
@@ -1377,17 +2039,13 @@ tsequence_tavg_finalfn(TSequence **sequences, int count)
   for (int i = 0; i < count; i++)
   {
     TSequence *seq = sequences[i];
-    TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+    const TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
     for (int j = 0; j < seq->count; j++)
-    {
-      const TInstant *inst = TSEQUENCE_INST_N(seq, j);
-      double2 *value2 = (double2 *) DatumGetPointer(tinstant_val(inst));
-      double value = value2->a / value2->b;
-      instants[j] = tinstant_make(Float8GetDatum(value), T_TFLOAT, inst->t);
-    }
-    newsequences[i] = tsequence_make_free(instants, seq->count,
+      instants[j] = TSEQUENCE_INST_N(seq, j);
+    newsequences[i] = tdouble2instarr_tavg(instants, seq->count,
       seq->period.lower_inc, seq->period.upper_inc,
       MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
+    pfree(instants);
   }
   return tsequenceset_make_free(newsequences, count, NORMALIZE);
 }
@@ -1418,6 +2076,280 @@ tnumber_tavg_finalfn(SkipList *state)
   return result;
 }
 
+/*****************************************************************************
+ * Approximate temporal count and average
+ *****************************************************************************/
+
+/**
+ * @brief Quantile of the standard normal distribution used for the half-width
+ * of the 95% confidence intervals of the approximate aggregates
+ */
+#define APPROX_Z95 1.959963984540054
+
+/**
+ * @brief Return true if a sampling fraction is valid, that is, if it is
+ * in the interval (0, 1]
+ */
+static bool
+ensure_valid_fraction(double fraction)
+{
+  if (fraction > 0.0 && fraction <= 1.0)
+    return true;
+  meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+    "The sampling fraction must be in the interval (0, 1]");
+  return false;
+}
+
+/**
+ * @brief Store the sampling fraction in the extra data of the state of an
+ * approximate aggregate
+ * @note The fraction is kept in the extra data so that it is transmitted with
+ * the state by the serialization and combine functions of the aggregate
+ */
+static SkipList *
+approx_state_set_fraction(SkipList *state, double fraction)
+{
+  if (state && ! state->extra)
+    aggstate_set_extra(state, &fraction, sizeof(double));
+  return state;
+}
+
+/**
+ * @brief Transform a temporal number into a temporal double3 value composed
+ * of the value, its square, and a count, for performing approximate temporal
+ * average aggregation
+ */
+static TInstant *
+tnumberinst_transform_tavg_approx(const TInstant *inst)
+{
+  double value = tnumberinst_double(inst);
+  double3 dvalue;
+  double3_set(value, value * value, 1, &dvalue);
+  return tinstant_make(PointerGetDatum(&dvalue), T_TDOUBLE3, inst->t);
+}
+
+/**
+ * @brief Return the value of an instant of the state of an approximate
+ * aggregate
+ * @details For a count, the sampled count @f$n@f$ is scaled to the estimate
+ * @f$n/f@f$, whose variance under Bernoulli sampling is @f$n(1-f)/f^2@f$.
+ * For an average, the estimate is the sample mean and its variance is the
+ * one of the sample divided by @f$n@f$ with the finite population correction
+ * @f$1-f@f$.
+ * @param[in] inst Instant of the state
+ * @param[in] fraction Sampling fraction
+ * @param[in] error True when the half-width of the 95% confidence interval is
+ * returned instead of the estimate
+ */
+static double
+tinstant_approx_value(const TInstant *inst, double fraction, bool error)
+{
+  if (inst->temptype == T_TINT)
+  {
+    double n = (double) DatumGetInt32(tinstant_val(inst));
+    return error ? APPROX_Z95 * sqrt(n * (1.0 - fraction)) / fraction :
+      n / fraction;
+  }
+  assert(inst->temptype == T_TDOUBLE3);
+  double3 *value = (double3 *) DatumGetPointer(tinstant_val(inst));
+  double mean = value->a / value->c;
+  if (! error)
+    return mean;
+  double var = value->b / value->c - mean * mean;
+  return (var <= 0.0) ? 0.0 :
+    APPROX_Z95 * sqrt(var / value->c * (1.0 - fraction));
+}
+
+/**
+ * @brief Return a temporal float sequence with the values of an array of
+ * instants of the state of an approximate aggregate
+ */
+static TSequence *
+tinstarr_approx(const TInstant **instants, int count, bool lower_inc,
+  bool upper_inc, interpType interp, double fraction, bool error)
+{
+  TInstant **newinstants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    newinstants[i] = tinstant_make(Float8GetDatum(tinstant_approx_value(
+      instants[i], fraction, error)), T_TFLOAT, instants[i]->t);
+  return tsequence_make_free(newinstants, count, lower_inc, upper_inc, interp,
+    NORMALIZE);
+}
+
+/**
+ * @brief Generic final function for the approximate temporal aggregates
+ * @details Contrary to the final functions of the exact aggregates, the state
+ * is not freed, so that both the estimate and the error can be obtained from
+ * the same state
+ * @param[in] state Current aggregate state
+ * @param[in] error True when the half-width of the 95% confidence interval is
+ * returned instead of the estimate
+ */
+static Temporal *
+temporal_approx_finalfn(SkipList *state, bool error)
+{
+  if (! state || state->length == 0)
+    return NULL;
+  assert(state->extra && state->extrasize == sizeof(double));
+  double fraction = *((double *) state->extra);
+  Temporal **values = (Temporal **) skiplist_values(state);
+  Temporal *result;
+  assert(values[0]->subtype == TINSTANT || values[0]->subtype == TSEQUENCE);
+  if (values[0]->subtype == TINSTANT)
+    result = (Temporal *) tinstarr_approx((const TInstant **) values,
+      state->length, true, true, DISCRETE, fraction, error);
+  else /* values[0]->subtype == TSEQUENCE */
+  {
+    TSequence **sequences = palloc(sizeof(TSequence *) * state->length);
+    for (int i = 0; i < state->length; i++)
+    {
+      const TSequence *seq = (const TSequence *) values[i];
+      const TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+      for (int j = 0; j < seq->count; j++)
+        instants[j] = TSEQUENCE_INST_N(seq, j);
+      sequences[i] = tinstarr_approx(instants, seq->count,
+        seq->period.lower_inc, seq->period.upper_inc,
+        MEOS_FLAGS_GET_INTERP(seq->flags), fraction, error);
+      pfree(instants);
+    }
+    result = (Temporal *) tsequenceset_make_free(sequences, state->length,
+      NORMALIZE);
+  }
+  pfree(values);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Transition function for approximate temporal count aggregation
+ * @details The values are expected to be a sample of the rows, e.g., obtained
+ * with a @p TABLESAMPLE clause, with the given fraction. The time of each
+ * value is set to the precision of the time buckets with
+ * #tstzspanset_tprecision before being merged into the state, which reduces
+ * the number of instants of the state to at most two per bucket.
+ * @param[in,out] state Current aggregate state
+ * @param[in] temp Temporal value to aggregate
+ * @param[in] fraction Sampling fraction in (0, 1]
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @csqlfn #Temporal_tcount_approx_transfn()
+ */
+SkipList *
+temporal_tcount_approx_transfn(SkipList *state, const Temporal *temp,
+  double fraction, const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_fraction(fraction) ||
+      ! ensure_not_null((void *) duration) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+
+  SpanSet *ss = temporal_time(temp);
+  SpanSet *ss1 = tstzspanset_tprecision(ss, duration, torigin);
+  state = tstzspanset_tcount_transfn(state, ss1);
+  pfree(ss); pfree(ss1);
+  return approx_state_set_fraction(state, fraction);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Final function for approximate temporal count aggregation
+ * @details The result is a temporal float with the counts of the sample
+ * scaled by the inverse of the sampling fraction. The state is not freed.
+ * @param[in] state Current aggregate state
+ * @csqlfn #Temporal_tcount_approx_finalfn()
+ */
+Temporal *
+temporal_tcount_approx_finalfn(SkipList *state)
+{
+  return temporal_approx_finalfn(state, false);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Final function for the error of the approximate temporal count
+ * aggregation
+ * @details The result is a temporal float with the half-width of the 95%
+ * confidence interval of the estimate returned by
+ * #temporal_tcount_approx_finalfn. The state is not freed.
+ * @param[in] state Current aggregate state
+ * @csqlfn #Temporal_tcount_approx_error_finalfn()
+ */
+Temporal *
+temporal_tcount_approx_error_finalfn(SkipList *state)
+{
+  return temporal_approx_finalfn(state, true);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Transition function for approximate temporal average aggregation
+ * @details The values are expected to be a sample of the rows with the given
+ * fraction. Each value is reduced with #temporal_tprecision before being
+ * merged into the state, which keeps for each instant the sum of the values,
+ * the sum of their squares, and their count.
+ * @param[in,out] state Current aggregate state
+ * @param[in] temp Temporal number to aggregate
+ * @param[in] fraction Sampling fraction in (0, 1]
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @csqlfn #Tnumber_tavg_approx_transfn()
+ */
+SkipList *
+tnumber_tavg_approx_transfn(SkipList *state, const Temporal *temp,
+  double fraction, const Interval *duration, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_tnumber_type(temp->temptype) ||
+      ! ensure_valid_fraction(fraction) ||
+      ! ensure_not_null((void *) duration) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+
+  Temporal *temp1 = temporal_tprecision(temp, duration, torigin);
+  if (! temp1)
+    return state;
+  state = temporal_tagg_transform_transfn(state, temp1, &datum_sum_double3,
+    CROSSINGS_NO, &tnumberinst_transform_tavg_approx);
+  pfree(temp1);
+  return approx_state_set_fraction(state, fraction);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Final function for approximate temporal average aggregation
+ * @details The state is not freed
+ * @param[in] state Current aggregate state
+ * @csqlfn #Tnumber_tavg_approx_finalfn()
+ */
+Temporal *
+tnumber_tavg_approx_finalfn(SkipList *state)
+{
+  return temporal_approx_finalfn(state, false);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Final function for the error of the approximate temporal average
+ * aggregation
+ * @details The result is a temporal float with the half-width of the 95%
+ * confidence interval of the estimate returned by
+ * #tnumber_tavg_approx_finalfn. The state is not freed.
+ * @param[in] state Current aggregate state
+ * @csqlfn #Tnumber_tavg_approx_error_finalfn()
+ */
+Temporal *
+tnumber_tavg_approx_error_finalfn(SkipList *state)
+{
+  return temporal_approx_finalfn(state, true);
+}
+
 /*****************************************************************************/
 
 /**
@@ -1552,4 +2484,105 @@ temporal_app_tseq_transfn(Temporal *state, const TSequence *seq)
   return temporal_append_tsequence(state, seq, true);
 }
 
+/**
+ * @brief Merge by time the instants of two partial states of the append
+ * temporal instant aggregate
+ * @param[in] seq1,seq2 Partial aggregate states
+ * @note Contrary to #temporal_merge, the partial states may overlap in time,
+ * which is the case when the workers of a parallel aggregation receive
+ * interleaved blocks of a table
+ */
+static TSequence *
+tsequence_app_tinst_combine(const TSequence *seq1, const TSequence *seq2)
+{
+  meosType basetype = temptype_basetype(seq1->temptype);
+  const TInstant **instants = palloc(sizeof(TInstant *) *
+    (seq1->count + seq2->count));
+  int i = 0, j = 0, ninsts = 0;
+  while (i < seq1->count && j < seq2->count)
+  {
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq1, i);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq2, j);
+    int cmp = timestamptz_cmp_internal(inst1->t, inst2->t);
+    if (cmp == 0)
+    {
+      if (! datum_eq(tinstant_val(inst1), tinstant_val(inst2), basetype))
+      {
+        char *str = pg_timestamptz_out(inst1->t);
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "The temporal values have different value at their common timestamp %s",
+          str);
+        pfree(str); pfree(instants);
+        return NULL;
+      }
+      instants[ninsts++] = inst1;
+      i++; j++;
+    }
+    else if (cmp < 0)
+    {
+      instants[ninsts++] = inst1;
+      i++;
+    }
+    else
+    {
+      instants[ninsts++] = inst2;
+      j++;
+    }
+  }
+  while (i < seq1->count)
+    instants[ninsts++] = TSEQUENCE_INST_N(seq1, i++);
+  while (j < seq2->count)
+    instants[ninsts++] = TSEQUENCE_INST_N(seq2, j++);
+  TSequence *result = tsequence_make(instants, ninsts, true, true,
+    MEOS_FLAGS_GET_INTERP(seq1->flags), NORMALIZE);
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_agg
+ * @brief Combine function for append temporal instant aggregate
+ * @details The instants of the partial states are merged by time, so that
+ * partial states overlapping in time can be combined
+ * @param[in] state1,state2 Partial aggregate states
+ * @note The function is only used by the aggregate without a maximum distance
+ * or time gap, whose partial states are always sequences. The gaps are not
+ * reapplied to the merged instants, so that the function cannot combine the
+ * partial states of the aggregate with gaps.
+ * @csqlfn #Temporal_app_tinst_combinefn()
+ */
+Temporal *
+temporal_app_tinst_combinefn(Temporal *state1, Temporal *state2)
+{
+  if (! state1)
+    return state2;
+  if (! state2)
+    return state1;
+  if (state1->subtype != TSEQUENCE || state2->subtype != TSEQUENCE)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The partial states of the append aggregate must be temporal sequences");
+    return NULL;
+  }
+  return (Temporal *) tsequence_app_tinst_combine((TSequence *) state1,
+    (TSequence *) state2);
+}
+
+/**
+ * @ingroup meos_internal_temporal_agg
+ * @brief Combine function for append temporal sequence aggregate
+ * @details The partial states are merged by time with #temporal_merge
+ * @param[in] state1,state2 Partial aggregate states
+ * @csqlfn #Temporal_app_tseq_combinefn()
+ */
+Temporal *
+temporal_app_tseq_combinefn(Temporal *state1, Temporal *state2)
+{
+  if (! state1)
+    return state2;
+  if (! state2)
+    return state1;
+  return temporal_merge(state1, state2);
+}
+
 /*****************************************************************************/
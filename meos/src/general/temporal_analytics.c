@@ -38,8 +38,10 @@
 #include <assert.h>
 #include <math.h>
 #include <float.h>
+#include <limits.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <utils/float.h>
 /* PostGIS */
 #include <liblwgeom_internal.h>
 /* MEOS */
@@ -50,6 +52,7 @@
 #include "general/span.h"
 #include "general/spanset.h"
 #include "general/temporal_tile.h"
+#include "general/tinstant.h"
 #include "general/tsequence.h"
 #include "general/type_util.h"
 #include "point/tpoint_distance.h"
@@ -93,11 +96,17 @@ tstzset_tprecision(const Set *s, const Interval *duration, TimestampTz torigin)
       ! ensure_valid_duration(duration))
     return NULL;
 
-  Datum *values = palloc(sizeof(Datum) * s->count);
-  /* Loop for each value */
+  TimestampTz *values = palloc(sizeof(TimestampTz) * s->count);
   for (int i = 0; i < s->count; i++)
-    values[i] = timestamptz_bucket(SET_VAL_N(s, i), duration, torigin);
-  return set_make_free(values, s->count, T_TIMESTAMPTZ, ORDER);
+    values[i] = DatumGetTimestampTz(SET_VAL_N(s, i));
+  /* Bucket all the values at once */
+  if (! timestamptzarr_bucket1(values, s->count, interval_units(duration),
+      torigin, values))
+  {
+    pfree(values);
+    return NULL;
+  }
+  return set_make_free((Datum *) values, s->count, T_TIMESTAMPTZ, ORDER);
 }
 
 /**
@@ -664,73 +673,371 @@ temporal_tsample(const Temporal *temp, const Interval *duration,
   }
 }
 
+#if MEOS
+/**
+ * @brief Fill a row of a sample matrix with the values of a temporal number
+ * sequence at the buckets of a grid
+ * @param[in] seq Temporal value
+ * @param[in] first First bucket of the grid
+ * @param[in] nbuckets Number of buckets of the grid
+ * @param[in] tunits Time size of the buckets in PostgreSQL time units
+ * @param[out] row Row of the matrix, whose buckets outside the sequence are
+ * left unchanged
+ * @note Contrary to #tsequence_tsample_iter, the sequence is traversed once
+ * with a cursor and no instant is created
+ */
+static void
+tnumberseq_tsample_row(const TSequence *seq, TimestampTz first, int nbuckets,
+  int64 tunits, double *row)
+{
+  meosType basetype = temptype_basetype(seq->temptype);
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  TimestampTz lower = DatumGetTimestampTz(seq->period.lower);
+  TimestampTz upper = DatumGetTimestampTz(seq->period.upper);
+  TimestampTz last_bucket = first + (nbuckets - 1) * tunits;
+  if (upper < first || lower > last_bucket)
+    return;
+  /* Range of the buckets of the grid within the bounds of the sequence */
+  int k = (lower <= first) ? 0 : (int) ((lower - first + tunits - 1) / tunits);
+  int last = (upper >= last_bucket) ? nbuckets - 1 :
+    (int) ((upper - first) / tunits);
+
+  if (interp == DISCRETE)
+  {
+    int i = 0;
+    while (i < seq->count && k <= last)
+    {
+      const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+      TimestampTz t = first + k * tunits;
+      if (inst->t == t)
+      {
+        row[k++] = datum_double(tinstant_val(inst), basetype);
+        i++;
+      }
+      else if (inst->t < t)
+        i++;
+      else
+        /* Jump to the first bucket that is not before the instant */
+        k = (int) ((inst->t - first + tunits - 1) / tunits);
+    }
+    return;
+  }
+
+  if (seq->count == 1)
+  {
+    if (first + k * tunits == lower)
+      row[k] = datum_double(tinstant_val(TSEQUENCE_INST_N(seq, 0)), basetype);
+    return;
+  }
+  int i = 1; /* Current segment of the sequence */
+  for (; k <= last; k++)
+  {
+    TimestampTz t = first + k * tunits;
+    if ((t == lower && ! seq->period.lower_inc) ||
+        (t == upper && ! seq->period.upper_inc))
+      continue;
+    /* Advance to the segment containing the bucket */
+    while (i < seq->count - 1 && TSEQUENCE_INST_N(seq, i)->t <= t)
+      i++;
+    Datum value = tsegment_value_at_timestamptz(TSEQUENCE_INST_N(seq, i - 1),
+      TSEQUENCE_INST_N(seq, i), interp, t);
+    row[k] = datum_double(value, basetype);
+  }
+}
+
+/**
+ * @ingroup meos_temporal_analytics_reduction
+ * @brief Return the matrix of the values of an array of temporal numbers
+ * sampled on a shared grid of time buckets
+ * @details The grid is composed of the buckets of the time span, which are
+ * computed once for all the temporal values. The result is a row-major
+ * matrix of doubles with one row per temporal value and one column per
+ * bucket, where the buckets at which a temporal value is not defined are set
+ * to @p NaN, so that it can be directly consumed by numeric libraries.
+ * The value of column @p j corresponds to the timestamp
+ * <tt>*first + j * duration</tt>.
+ * @param[in] temparr Array of temporal numbers
+ * @param[in] count Number of elements in the array
+ * @param[in] s Time span of the grid
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[out] first First bucket of the grid
+ * @param[out] nbuckets Number of buckets of the grid
+ * @return On error return @p NULL
+ */
+double *
+tnumberarr_tsample_matrix(const Temporal **temparr, int count, const Span *s,
+  const Interval *duration, TimestampTz torigin, TimestampTz *first,
+  int *nbuckets)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) || ! ensure_not_null((void *) s) ||
+      ! ensure_not_null((void *) duration) || ! ensure_not_null((void *) first) ||
+      ! ensure_not_null((void *) nbuckets) || ! ensure_positive(count) ||
+      ! ensure_span_isof_type(s, T_TSTZSPAN) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_not_null((void *) temparr[i]) ||
+        ! ensure_tnumber_type(temparr[i]->temptype))
+      return NULL;
+  }
+
+  /* Compute the grid once for all the temporal values */
+  int64 tunits = interval_units(duration);
+  TimestampTz lower = DatumGetTimestampTz(s->lower);
+  TimestampTz upper = DatumGetTimestampTz(s->upper);
+  TimestampTz lower_bucket = timestamptz_bucket(lower, duration, torigin);
+  if (lower_bucket < lower || (lower_bucket == lower && ! s->lower_inc))
+    lower_bucket += tunits;
+  TimestampTz upper_bucket = timestamptz_bucket(upper, duration, torigin);
+  if (upper_bucket == upper && ! s->upper_inc)
+    upper_bucket -= tunits;
+  if (upper_bucket < lower_bucket)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The time span does not contain any bucket");
+    return NULL;
+  }
+  int64 ncols = (upper_bucket - lower_bucket) / tunits + 1;
+  if (ncols > INT_MAX / count)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Too many values in the sample matrix");
+    return NULL;
+  }
+  *first = lower_bucket;
+  *nbuckets = (int) ncols;
+
+  double *result = palloc(sizeof(double) * count * *nbuckets);
+  double nan = get_float8_nan();
+  for (int i = 0; i < count * *nbuckets; i++)
+    result[i] = nan;
+  for (int i = 0; i < count; i++)
+  {
+    const Temporal *temp = temparr[i];
+    double *row = &result[i * *nbuckets];
+    assert(temptype_subtype(temp->subtype));
+    if (temp->subtype == TINSTANT)
+    {
+      const TInstant *inst = (const TInstant *) temp;
+      if (inst->t >= lower_bucket && inst->t <= upper_bucket &&
+          (inst->t - lower_bucket) % tunits == 0)
+        row[(inst->t - lower_bucket) / tunits] = datum_double(
+          tinstant_val(inst), temptype_basetype(inst->temptype));
+    }
+    else if (temp->subtype == TSEQUENCE)
+      tnumberseq_tsample_row((const TSequence *) temp, lower_bucket,
+        *nbuckets, tunits, row);
+    else /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      for (int j = 0; j < ss->count; j++)
+        tnumberseq_tsample_row(TSEQUENCESET_SEQ_N(ss, j), lower_bucket,
+          *nbuckets, tunits, row);
+    }
+  }
+  return result;
+}
+#endif
+
 /*****************************************************************************
  * Linear space computation of the similarity distance
  *****************************************************************************/
 
+/**
+ * @brief Return the column of the diagonal of the distance matrix for a row
+ * @details The diagonal is scaled to the dimensions of the matrix, which
+ * requires that count1 >= count2, and the column is rounded so that the
+ * columns of two consecutive rows differ by at most one
+ */
+static inline int
+similarity_band_center(int i, int count1, int count2)
+{
+  if (count1 == 1)
+    return 0;
+  return (int) (((int64) i * (count2 - 1) * 2 + (count1 - 1)) /
+    (2 * (count1 - 1)));
+}
+
+/**
+ * @brief Return the number of coordinates of the instants of a temporal value
+ * that are extracted for computing the similarity distances in bulk
+ * @return Return 0 for geodetic points whose distance is not Euclidean
+ */
+static int
+similarity_ndims(const TInstant *inst)
+{
+  if (tnumber_type(inst->temptype))
+    return 1;
+  if (MEOS_FLAGS_GET_GEODETIC(inst->flags))
+    return 0;
+  return MEOS_FLAGS_GET_Z(inst->flags) ? 3 : 2;
+}
+
+/**
+ * @brief Return the coordinates of an array of temporal instants in a single
+ * array that stores the coordinates of each dimension contiguously
+ * @param[in] instants Array of temporal instants
+ * @param[in] count Number of instants in the array
+ * @param[in] ndims Number of coordinates, i.e., 1 for temporal numbers and
+ * 2 or 3 for temporal points
+ */
+static double *
+tinstarr_coords(const TInstant **instants, int count, int ndims)
+{
+  double *result = palloc(sizeof(double) * ndims * count);
+  for (int i = 0; i < count; i++)
+  {
+    if (ndims == 1)
+      result[i] = tnumberinst_double(instants[i]);
+    else if (ndims == 2)
+    {
+      const POINT2D *pt = DATUM_POINT2D_P(tinstant_val(instants[i]));
+      result[i] = pt->x;
+      result[count + i] = pt->y;
+    }
+    else /* ndims == 3 */
+    {
+      const POINT3DZ *pt = DATUM_POINT3DZ_P(tinstant_val(instants[i]));
+      result[i] = pt->x;
+      result[count + i] = pt->y;
+      result[2 * count + i] = pt->z;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Compute the distances between an instant of the first array and
+ * a range of instants of the second array from their coordinates
+ * @details The loops are free of function calls and branches so that they
+ * can be vectorized by the compiler
+ * @param[in] coords1,coords2 Coordinates of the arrays of instants
+ * @param[in] count1,count2 Number of instants in the arrays
+ * @param[in] ndims Number of coordinates
+ * @param[in] i Instant of the first array
+ * @param[in] jmin,jmax Range of instants of the second array
+ * @param[out] cells Distances, indexed by the instants of the second array
+ */
+static void
+coords_distance_row(const double *coords1, int count1, const double *coords2,
+  int count2, int ndims, int i, int jmin, int jmax, double *cells)
+{
+  const double *xs = coords2, *ys = coords2 + count2,
+    *zs = coords2 + 2 * count2;
+  double x = coords1[i];
+  if (ndims == 1)
+  {
+    for (int j = jmin; j <= jmax; j++)
+      cells[j] = fabs(xs[j] - x);
+  }
+  else if (ndims == 2)
+  {
+    double y = coords1[count1 + i];
+    for (int j = jmin; j <= jmax; j++)
+    {
+      double dx = xs[j] - x, dy = ys[j] - y;
+      cells[j] = sqrt(dx * dx + dy * dy);
+    }
+  }
+  else /* ndims == 3 */
+  {
+    double y = coords1[count1 + i], z = coords1[2 * count1 + i];
+    for (int j = jmin; j <= jmax; j++)
+    {
+      double dx = xs[j] - x, dy = ys[j] - y, dz = zs[j] - z;
+      cells[j] = sqrt(dx * dx + dy * dy + dz * dz);
+    }
+  }
+  return;
+}
+
 /**
  * @brief Linear space computation of the similarity distance between two
  * temporal values
  * @param[in] instants1,instants2 Arrays of temporal instants
  * @param[in] count1,count2 Number of instants in the arrays
+ * @param[in] coords1,coords2 Coordinates of the arrays of instants, which
+ * are NULL when the distance between the instants is computed one at a time
+ * @param[in] ndims Number of coordinates
  * @param[in] simfunc Similarity function, i.e., Frechet or DTW
+ * @param[in] band Width of the Sakoe-Chiba band around the diagonal in number
+ * of instants, a negative value means that the matrix is not constrained
+ * @param[in] bound Distance above which the computation is abandoned
  * @param[out] dist Array keeping the distances
- * @note Only two rows of the full matrix are used
+ * @param[out] cells Array keeping the distances between the instants of a row
+ * @return On early abandon return @p DBL_MAX
+ * @note Only two rows of the full matrix are used. The cells of these rows
+ * that are outside of the band must be initialized to @p DBL_MAX.
+ * @pre count1 >= count2
  */
 static double
-tinstarr_similarity1(double *dist, const TInstant **instants1, int count1,
-  const TInstant **instants2, int count2, SimFunc simfunc)
+tinstarr_similarity1(double *dist, double *cells, const TInstant **instants1,
+  int count1, const TInstant **instants2, int count2, const double *coords1,
+  const double *coords2, int ndims, SimFunc simfunc, int band, double bound)
 {
   datum_func2 func = pt_distance_fn(instants1[0]->flags);
+  /* Columns of the band of the two rows kept in the array */
+  int lower[2] = {0, 0}, upper[2] = {-1, -1};
   for (int i = 0; i < count1; i++)
   {
-    for (int j = 0; j < count2; j++)
+    double *row = dist + (i % 2) * count2;
+    const double *prevrow = dist + ((i + 1) % 2) * count2;
+    int jmin = 0, jmax = count2 - 1;
+    if (band >= 0)
     {
-      const TInstant *inst1 = instants1[i];
-      const TInstant *inst2 = instants2[j];
-      double d = tinstant_distance(inst1, inst2, func);
-      if (i > 0 && j > 0)
-      {
-        if (simfunc == FRECHET)
-        {
-          dist[i%2 * count2 + j] = Max(d,
-            Min(dist[(i - 1)%2 * count2 + j - 1],
-              Min(dist[(i - 1)%2 * count2 + j], dist[i%2 * count2 + j - 1])));
-        }
-        else /* simfunc == DYNTIMEWARP */
-        {
-          dist[i%2 * count2 + j] = d +
-            Min(dist[(i - 1)%2 * count2 + j - 1],
-              Min(dist[(i - 1)%2 * count2 + j], dist[i%2 * count2 + j - 1]));
-        }
-      }
-      else if (i > 0 && j == 0)
-      {
-        if (simfunc == FRECHET)
-        {
-          dist[i%2 * count2] = Max(d, dist[(i - 1)%2 * count2]);
-        }
-        else /* simfunc == DYNTIMEWARP */
-        {
-          dist[i%2 * count2] = d + dist[(i - 1)%2 * count2];
-        }
-      }
-      else if (i == 0 && j > 0)
+      int center = similarity_band_center(i, count1, count2);
+      jmin = Max(0, center - band);
+      jmax = Min(count2 - 1, center + band);
+    }
+    /* Reset the cells of the row before the last one that are outside of
+     * the band of the current row */
+    for (int j = lower[i % 2]; j <= upper[i % 2]; j++)
+    {
+      if (j < jmin || j > jmax)
+        row[j] = DBL_MAX;
+    }
+    lower[i % 2] = jmin;
+    upper[i % 2] = jmax;
+
+    /* Compute the distances between the instants of the row */
+    if (coords1)
+      coords_distance_row(coords1, count1, coords2, count2, ndims, i, jmin,
+        jmax, cells);
+    else
+    {
+      for (int j = jmin; j <= jmax; j++)
+        cells[j] = tinstant_distance(instants1[i], instants2[j], func);
+    }
+
+    double rowmin = DBL_MAX;
+    for (int j = jmin; j <= jmax; j++)
+    {
+      double d = cells[j];
+      if (i > 0 || j > 0)
       {
+        double prev = DBL_MAX;
+        if (i > 0 && j > 0)
+          prev = prevrow[j - 1];
+        if (i > 0)
+          prev = Min(prev, prevrow[j]);
+        if (j > 0)
+          prev = Min(prev, row[j - 1]);
         if (simfunc == FRECHET)
-        {
-          dist[j] = Max(d, dist[j - 1]);
-        }
+          d = Max(d, prev);
         else /* simfunc == DYNTIMEWARP */
-        {
-          dist[j] = d + dist[j - 1];
-        }
-      }
-      else /* i == 0 && j == 0 */
-      {
-        dist[0] = d;
+          d += prev;
       }
+      row[j] = d;
+      rowmin = Min(rowmin, d);
     }
+    /* Since the distances are non decreasing along any path of the matrix,
+     * the result will be greater than the bound when all the cells of the
+     * current row are */
+    if (rowmin > bound)
+      return DBL_MAX;
   }
   return dist[(count1 - 1)%2 * count2 + count2 - 1];
 }
@@ -738,25 +1045,45 @@ tinstarr_similarity1(double *dist, const TInstant **instants1, int count1,
 /**
  * @brief Linear space computation of the similarity distance between two
  * temporal values
+ * @details Except for geodetic points, the coordinates of the instants are
+ * extracted beforehand into contiguous arrays so that the distances of a row
+ * of the matrix are computed in bulk
  * @param[in] instants1,instants2 Arrays of temporal instants
  * @param[in] count1,count2 Number of instants in the arrays
  * @param[in] simfunc Similarity function, i.e., Frechet or DTW
+ * @param[in] band Width of the Sakoe-Chiba band, negative if not constrained
+ * @param[in] bound Distance above which the computation is abandoned
  * @note Only two rows of the full matrix are used
  */
 static double
 tinstarr_similarity(const TInstant **instants1, int count1,
-  const TInstant **instants2, int count2, SimFunc simfunc)
+  const TInstant **instants2, int count2, SimFunc simfunc, int band,
+  double bound)
 {
-  /* Allocate memory for two rows of the distance matrix */
-  double *dist = palloc(sizeof(double) * 2 * count2);
-  /* Initialise it with -1.0 */
+  /* Allocate memory for two rows of the distance matrix and for the
+   * distances between the instants of a row */
+  double *dist = palloc(sizeof(double) * 3 * count2);
+  double *cells = dist + 2 * count2;
+  /* Initialise it with DBL_MAX for the cells outside of the band */
   for (int i = 0; i < 2 * count2; i++)
-    *(dist + i) = -1.0;
+    *(dist + i) = DBL_MAX;
+  /* Extract the coordinates of the instants */
+  int ndims = similarity_ndims(instants1[0]);
+  double *coords1 = NULL, *coords2 = NULL;
+  if (ndims > 0)
+  {
+    coords1 = tinstarr_coords(instants1, count1, ndims);
+    coords2 = tinstarr_coords(instants2, count2, ndims);
+  }
   /* Call the linear_space computation of the similarity distance */
-  double result = tinstarr_similarity1(dist, instants1, count1, instants2,
-    count2, simfunc);
+  double result = tinstarr_similarity1(dist, cells, instants1, count1,
+    instants2, count2, coords1, coords2, ndims, simfunc, band, bound);
   /* Free memory */
   pfree(dist);
+  if (coords1)
+  {
+    pfree(coords1); pfree(coords2);
+  }
   return result;
 }
 
@@ -764,10 +1091,16 @@ tinstarr_similarity(const TInstant **instants1, int count1,
  * @brief Return the similarity distance between two temporal values
  * @param[in] temp1,temp2 Temporal values
  * @param[in] simfunc Similarity function, i.e., Frechet or DTW
+ * @param[in] band Width in number of instants of the Sakoe-Chiba band around
+ * the diagonal of the distance matrix, a negative value means that the
+ * matrix is not constrained
+ * @param[in] bound Distance above which the computation is abandoned, which
+ * is @p DBL_MAX for computing the exact distance
+ * @return On early abandon return @p DBL_MAX
  */
 double
 temporal_similarity(const Temporal *temp1, const Temporal *temp2,
-  SimFunc simfunc)
+  SimFunc simfunc, int band, double bound)
 {
   assert(temp1); assert(temp2);
   assert(temp1->temptype == temp2->temptype);
@@ -776,8 +1109,10 @@ temporal_similarity(const Temporal *temp1, const Temporal *temp2,
   const TInstant **instants1 = temporal_insts(temp1, &count1);
   const TInstant **instants2 = temporal_insts(temp2, &count2);
   result = count1 > count2 ?
-    tinstarr_similarity(instants1, count1, instants2, count2, simfunc) :
-    tinstarr_similarity(instants2, count2, instants1, count1, simfunc);
+    tinstarr_similarity(instants1, count1, instants2, count2, simfunc, band,
+      bound) :
+    tinstarr_similarity(instants2, count2, instants1, count1, simfunc, band,
+      bound);
   /* Free memory */
   pfree(instants1); pfree(instants2);
   return result;
@@ -788,108 +1123,374 @@ temporal_similarity(const Temporal *temp1, const Temporal *temp2,
  * @ingroup meos_temporal_analytics_similarity
  * @brief Return the Frechet distance between two temporal values
  * @param[in] temp1,temp2 Temporal values
+ * @param[in] band Width in number of instants of the Sakoe-Chiba band around
+ * the diagonal of the distance matrix, a negative value means that the
+ * matrix is not constrained
  * @return On error return @p DBL_MAX
  * @csqlfn #Temporal_frechet_distance()
  */
 double
-temporal_frechet_distance(const Temporal *temp1, const Temporal *temp2)
+temporal_frechet_distance(const Temporal *temp1, const Temporal *temp2,
+  int band)
 {
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
       ! ensure_same_temporal_type(temp1, temp2))
     return DBL_MAX;
-  return temporal_similarity(temp1, temp2, FRECHET);
+  double result;
+  MEOS_STATS_CALL(MEOS_FAMILY_SIMILARITY,
+    result = temporal_similarity(temp1, temp2, FRECHET, band, DBL_MAX));
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return true if the Frechet distance between two temporal values is
+ * less than or equal to a bound
+ * @details The computation is abandoned as soon as the bound is exceeded
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] dist Bound
+ * @param[in] band Width of the Sakoe-Chiba band, negative if not constrained
+ * @return On error return false
+ * @csqlfn #Temporal_frechet_distance_within()
+ */
+bool
+temporal_frechet_distance_within(const Temporal *temp1, const Temporal *temp2,
+  double dist, int band)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_same_temporal_type(temp1, temp2) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+    return false;
+  return temporal_similarity(temp1, temp2, FRECHET, band, dist) <= dist;
 }
 
 /**
  * @ingroup meos_temporal_analytics_similarity
  * @brief Return the Dynamic Time Warp distance between two temporal values
  * @param[in] temp1,temp2 Temporal values
+ * @param[in] band Width in number of instants of the Sakoe-Chiba band around
+ * the diagonal of the distance matrix, a negative value means that the
+ * matrix is not constrained
  * @result On error return @p DBL_MAX
  * @csqlfn #Temporal_dyntimewarp_distance()
  */
 double
-temporal_dyntimewarp_distance(const Temporal *temp1, const Temporal *temp2)
+temporal_dyntimewarp_distance(const Temporal *temp1, const Temporal *temp2,
+  int band)
 {
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
       ! ensure_same_temporal_type(temp1, temp2))
     return DBL_MAX;
-  return temporal_similarity(temp1, temp2, DYNTIMEWARP);
+  double result;
+  MEOS_STATS_CALL(MEOS_FAMILY_SIMILARITY,
+    result = temporal_similarity(temp1, temp2, DYNTIMEWARP, band, DBL_MAX));
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return true if the Dynamic Time Warp distance between two temporal
+ * values is less than or equal to a bound
+ * @details The computation is abandoned as soon as the bound is exceeded
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] dist Bound
+ * @param[in] band Width of the Sakoe-Chiba band, negative if not constrained
+ * @return On error return false
+ * @csqlfn #Temporal_dyntimewarp_distance_within()
+ */
+bool
+temporal_dyntimewarp_distance_within(const Temporal *temp1,
+  const Temporal *temp2, double dist, int band)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_same_temporal_type(temp1, temp2) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+    return false;
+  return temporal_similarity(temp1, temp2, DYNTIMEWARP, band, dist) <= dist;
 }
 #endif
 
 /*****************************************************************************
- * Iterative implementation of the similarity distance with a full matrix
+ * Lower bounds of the similarity distances
  *****************************************************************************/
 
-#ifdef DEBUG_BUILD
 /**
- * @brief Print a distance matrix in tabular form
+ * @brief Return the distance between the bounding boxes of two temporal
+ * values without taking into account the time dimension
  */
-void
-matrix_print(double *dist, int count1, int count2)
+static double
+temporal_bbox_distance(const Temporal *temp1, const Temporal *temp2)
 {
-  int len = 0;
-  char buf[65536];
-  int i, j;
-  len += sprintf(buf+len, "\n      ");
-  for (j = 0; j < count2; j++)
-    len += sprintf(buf+len, "    %2d    ", j);
-  len += sprintf(buf+len, "\n");
-  for (j = 0; j < count2; j++)
-    len += sprintf(buf+len, "------------");
-  len += sprintf(buf+len, "\n");
-  for (i = 0; i < count1; i++)
+  assert(tnumber_type(temp1->temptype) || tgeo_type(temp1->temptype));
+  if (tnumber_type(temp1->temptype))
   {
-    len += sprintf(buf+len, "%2d | ", i);
-    for (j = 0; j < count2; j++)
-      len += sprintf(buf+len, " %9.3f", dist[i * count2 + j]);
-    len += sprintf(buf+len, "\n");
+    TBox box1, box2;
+    temporal_set_bbox(temp1, &box1);
+    temporal_set_bbox(temp2, &box2);
+    Datum dist = dist_span_span(&box1.span, &box2.span);
+    return (box1.span.basetype == T_INT4) ?
+      (double) DatumGetInt32(dist) : DatumGetFloat8(dist);
   }
-  for (j = 0; j < count2; j++)
-    len += sprintf(buf+len, "------------");
-  len += sprintf(buf+len, "\n      ");
-  for (j = 0; j < count2; j++)
-    len += sprintf(buf+len, "    %2d    ", j);
-  sprintf(buf+len, "\n"); /* make Codacy quiet by removing last assignment */
-  meos_error(WARNING, 0, "MATRIX:\n%s", buf);
-  return;
+  STBox box1, box2;
+  temporal_set_bbox(temp1, &box1);
+  temporal_set_bbox(temp2, &box2);
+  /* The similarity distances do not take into account the time dimension */
+  MEOS_FLAGS_SET_T(box1.flags, false);
+  MEOS_FLAGS_SET_T(box2.flags, false);
+  return nad_stbox_stbox(&box1, &box2);
 }
 
 /**
- * @brief Print a distant path found from the distance matrix
+ * @brief Return a lower bound of the similarity distance between two arrays
+ * of temporal number instants from the envelope of the second array
+ * @details For each instant of the first array the envelope is given by the
+ * minimum and the maximum values of the instants of the second array in the
+ * columns of the band of the distance matrix. Since any warping path has at
+ * least one cell in each row, the distance of a value to its envelope is a
+ * lower bound of the distance of the cell of the row in the path. The
+ * envelopes are maintained with two monotonic queues since the columns of
+ * the band are non decreasing.
+ * @param[in] instants1,instants2 Arrays of temporal instants
+ * @param[in] count1,count2 Number of instants in the arrays
+ * @param[in] simfunc Similarity function, i.e., Frechet or DTW
+ * @param[in] band Width of the Sakoe-Chiba band, negative if not constrained
+ * @pre count1 >= count2
  */
-void
-path_print(Match *path, int count)
+static double
+tnumberinstarr_envelope_bound(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2, SimFunc simfunc, int band)
 {
-  int len = 0;
-  char buf[65536];
-  int i, k = 0;
-  for (i = count - 1; i >= 0; i--)
-    len += sprintf(buf+len, "%d: (%2d,%2d)\n", k++, path[i].i, path[i].j);
-  meos_error(WARNING, 0, "PATH:\n%s", buf);
-  return;
+  double *values = palloc(sizeof(double) * count2);
+  for (int j = 0; j < count2; j++)
+    values[j] = tnumberinst_double(instants2[j]);
+  /* Monotonic queues of the column numbers of the maximum and minimum values
+   * in the band, each column is inserted exactly once */
+  int *maxq = palloc(sizeof(int) * count2);
+  int *minq = palloc(sizeof(int) * count2);
+  int maxhead = 0, maxtail = 0, minhead = 0, mintail = 0, next = 0;
+  double result = 0.0;
+  for (int i = 0; i < count1; i++)
+  {
+    int jmin = 0, jmax = count2 - 1;
+    if (band >= 0)
+    {
+      int center = similarity_band_center(i, count1, count2);
+      jmin = Max(0, center - band);
+      jmax = Min(count2 - 1, center + band);
+    }
+    /* Add the new columns of the band */
+    for ( ; next <= jmax; next++)
+    {
+      while (maxtail > maxhead && values[maxq[maxtail - 1]] <= values[next])
+        maxtail--;
+      maxq[maxtail++] = next;
+      while (mintail > minhead && values[minq[mintail - 1]] >= values[next])
+        mintail--;
+      minq[mintail++] = next;
+    }
+    /* Remove the columns that are no longer in the band */
+    while (maxq[maxhead] < jmin)
+      maxhead++;
+    while (minq[minhead] < jmin)
+      minhead++;
+    /* Distance of the value to the envelope */
+    double value = tnumberinst_double(instants1[i]);
+    double dist = 0.0;
+    if (value > values[maxq[maxhead]])
+      dist = value - values[maxq[maxhead]];
+    else if (value < values[minq[minhead]])
+      dist = values[minq[minhead]] - value;
+    if (simfunc == FRECHET)
+      result = Max(result, dist);
+    else /* simfunc == DYNTIMEWARP */
+      result += dist;
+  }
+  /* Free memory */
+  pfree(values); pfree(maxq); pfree(minq);
+  return result;
 }
-#endif
 
 /**
- * @brief Return the similarity path between two temporal values based on the
- * distance matrix
- * @param[in] dist Matrix keeping the distances
- * @param[in] count1,count2 Number of rows and columns of the matrix
- * @param[out] count Number of elements of the similarity path
+ * @brief Return a lower bound of the similarity distance between two
+ * temporal values
+ * @details The result is the maximum of the following bounds
+ * - the distance between the first instants and the distance between the
+ *   last instants, since every warping path starts and ends at these cells
+ *   of the distance matrix,
+ * - the distance between the bounding boxes, which is a lower bound of the
+ *   distance of every cell of the distance matrix, and of which the path
+ *   has at least as many cells as instants has the longest value,
+ * - for temporal numbers, the distance to the envelope of the other value
+ *   in the band of the distance matrix.
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] simfunc Similarity function, i.e., Frechet or DTW
+ * @param[in] band Width of the Sakoe-Chiba band, negative if not constrained,
+ * which must be the one used for computing the distance
  */
-static Match *
-tinstarr_similarity_path(double *dist, int count1, int count2, int *count)
+double
+temporal_similarity_lower_bound(const Temporal *temp1, const Temporal *temp2,
+  SimFunc simfunc, int band)
 {
-  Match *result = palloc(sizeof(Match) * (count1 + count2));
-  int i = count1 - 1;
-  int j = count2 - 1;
-  int k = 0;
-  while (true)
+  assert(temp1); assert(temp2);
+  assert(temp1->temptype == temp2->temptype);
+  int count1, count2;
+  const TInstant **instants1 = temporal_insts(temp1, &count1);
+  const TInstant **instants2 = temporal_insts(temp2, &count2);
+  if (count1 < count2)
   {
-    result[k].i = i;
+    const TInstant **insts = instants1;
+    instants1 = instants2; instants2 = insts;
+    int count = count1;
+    count1 = count2; count2 = count;
+  }
+
+  /* Bound from the first and the last instants */
+  datum_func2 func = pt_distance_fn(instants1[0]->flags);
+  double start = tinstant_distance(instants1[0], instants2[0], func);
+  double result = start;
+  if (count1 > 1)
+  {
+    double end = tinstant_distance(instants1[count1 - 1],
+      instants2[count2 - 1], func);
+    result = (simfunc == FRECHET) ? Max(start, end) : start + end;
+  }
+
+  /* Bound from the bounding boxes */
+  double dist = temporal_bbox_distance(temp1, temp2);
+  if (simfunc == DYNTIMEWARP)
+    dist *= count1;
+  result = Max(result, dist);
+
+  /* Bound from the envelope */
+  if (tnumber_type(temp1->temptype))
+  {
+    dist = tnumberinstarr_envelope_bound(instants1, count1, instants2, count2,
+      simfunc, band);
+    result = Max(result, dist);
+  }
+
+  /* Free memory */
+  pfree(instants1); pfree(instants2);
+  return result;
+}
+
+#if MEOS
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return a lower bound of the Frechet distance between two temporal
+ * values
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] band Width of the Sakoe-Chiba band, negative if not constrained
+ * @return On error return -1.0
+ * @csqlfn #Temporal_frechet_lower_bound()
+ */
+double
+temporal_frechet_lower_bound(const Temporal *temp1, const Temporal *temp2,
+  int band)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_same_temporal_type(temp1, temp2))
+    return -1.0;
+  return temporal_similarity_lower_bound(temp1, temp2, FRECHET, band);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return a lower bound of the Dynamic Time Warp distance between two
+ * temporal values
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] band Width of the Sakoe-Chiba band, negative if not constrained
+ * @return On error return -1.0
+ * @csqlfn #Temporal_dyntimewarp_lower_bound()
+ */
+double
+temporal_dyntimewarp_lower_bound(const Temporal *temp1, const Temporal *temp2,
+  int band)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_same_temporal_type(temp1, temp2))
+    return -1.0;
+  return temporal_similarity_lower_bound(temp1, temp2, DYNTIMEWARP, band);
+}
+#endif
+
+/*****************************************************************************
+ * Iterative implementation of the similarity distance with a full matrix
+ *****************************************************************************/
+
+#ifdef DEBUG_BUILD
+/**
+ * @brief Print a distance matrix in tabular form
+ */
+void
+matrix_print(double *dist, int count1, int count2)
+{
+  int len = 0;
+  char buf[65536];
+  int i, j;
+  len += sprintf(buf+len, "\n      ");
+  for (j = 0; j < count2; j++)
+    len += sprintf(buf+len, "    %2d    ", j);
+  len += sprintf(buf+len, "\n");
+  for (j = 0; j < count2; j++)
+    len += sprintf(buf+len, "------------");
+  len += sprintf(buf+len, "\n");
+  for (i = 0; i < count1; i++)
+  {
+    len += sprintf(buf+len, "%2d | ", i);
+    for (j = 0; j < count2; j++)
+      len += sprintf(buf+len, " %9.3f", dist[i * count2 + j]);
+    len += sprintf(buf+len, "\n");
+  }
+  for (j = 0; j < count2; j++)
+    len += sprintf(buf+len, "------------");
+  len += sprintf(buf+len, "\n      ");
+  for (j = 0; j < count2; j++)
+    len += sprintf(buf+len, "    %2d    ", j);
+  sprintf(buf+len, "\n"); /* make Codacy quiet by removing last assignment */
+  meos_error(WARNING, 0, "MATRIX:\n%s", buf);
+  return;
+}
+
+/**
+ * @brief Print a distant path found from the distance matrix
+ */
+void
+path_print(Match *path, int count)
+{
+  int len = 0;
+  char buf[65536];
+  int i, k = 0;
+  for (i = count - 1; i >= 0; i--)
+    len += sprintf(buf+len, "%d: (%2d,%2d)\n", k++, path[i].i, path[i].j);
+  meos_error(WARNING, 0, "PATH:\n%s", buf);
+  return;
+}
+#endif
+
+/**
+ * @brief Return the similarity path between two temporal values based on the
+ * distance matrix
+ * @param[in] dist Matrix keeping the distances
+ * @param[in] count1,count2 Number of rows and columns of the matrix
+ * @param[out] count Number of elements of the similarity path
+ */
+static Match *
+tinstarr_similarity_path(double *dist, int count1, int count2, int *count)
+{
+  Match *result = palloc(sizeof(Match) * (count1 + count2));
+  int i = count1 - 1;
+  int j = count2 - 1;
+  int k = 0;
+  while (true)
+  {
+    result[k].i = i;
     result[k++].j = j;
     if (i == 0 && j == 0)
       break;
@@ -1079,59 +1680,171 @@ temporal_dyntimewarp_path(const Temporal *temp1, const Temporal *temp2,
  *****************************************************************************/
 
 /**
- * @brief Return the discrete Hausdorff distance between two temporal values
+ * @brief Return a pseudo-random permutation of the numbers from 0 to
+ * count - 1
+ * @details The permutation is computed with the Fisher-Yates shuffle driven
+ * by a xorshift generator with a fixed seed, so that it is reproducible
+ */
+static int *
+hausdorff_permutation(int count)
+{
+  int *result = palloc(sizeof(int) * count);
+  for (int i = 0; i < count; i++)
+    result[i] = i;
+  uint64 state = UINT64CONST(0x9E3779B97F4A7C15);
+  for (int i = count - 1; i > 0; i--)
+  {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    int j = (int) (state % (uint64) (i + 1));
+    int tmp = result[i];
+    result[i] = result[j];
+    result[j] = tmp;
+  }
+  return result;
+}
+
+/**
+ * @brief Return the distance between two instants for the Hausdorff
+ * distance, which is squared when it is computed from the coordinates
+ */
+static inline double
+hausdorff_cell(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2, const double *coords1,
+  const double *coords2, int ndims, datum_func2 func, int i, int j)
+{
+  if (! coords1)
+    return tinstant_distance(instants1[i], instants2[j], func);
+  double result = 0.0;
+  for (int k = 0; k < ndims; k++)
+  {
+    double d = coords1[k * count1 + i] - coords2[k * count2 + j];
+    result += d * d;
+  }
+  return result;
+}
+
+/**
+ * @brief Return the directed Hausdorff distance from the first array of
+ * instants to the second one, or any value greater than the bound when it
+ * exceeds the bound
+ * @details The early break algorithm of Taha and Hanbury stops looking for
+ * the nearest neighbour of an instant as soon as a neighbour closer than the
+ * current maximum is found, since the instant cannot increase the maximum
  * @param[in] instants1,instants2 Arrays of temporal instants
  * @param[in] count1,count2 Number of instants in the arrays
+ * @param[in] coords1,coords2 Coordinates of the arrays of instants, which
+ * are NULL when the distance between the instants is computed one at a time
+ * @param[in] ndims Number of coordinates
+ * @param[in] perm1,perm2 Order in which the instants are visited
+ * @param[in] cmax Current maximum distance
+ * @param[in] bound Distance above which the computation is abandoned
  */
 static double
-tinstarr_hausdorff_distance(const TInstant **instants1, int count1,
-  const TInstant **instants2, int count2)
+tinstarr_hausdorff_directed(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2, const double *coords1,
+  const double *coords2, int ndims, const int *perm1, const int *perm2,
+  double cmax, double bound)
 {
-  datum_func2 func = pt_distance_fn(instants1[0]->flags);
-  const TInstant *inst1, *inst2;
-  double cmax = 0.0, cmin;
-  double d;
-  int i, j;
-  for (i = 0; i < count1; i++)
+  datum_func2 func = coords1 ? NULL : pt_distance_fn(instants1[0]->flags);
+  for (int k = 0; k < count1; k++)
   {
-    inst1 = instants1[i];
-    cmin = DBL_MAX;
-    for (j = 0; j < count2; j++)
+    int i = perm1[k];
+    double cmin = DBL_MAX;
+    for (int l = 0; l < count2; l++)
     {
-      inst2 = instants2[j];
-      d = tinstant_distance(inst1, inst2, func);
+      double d = hausdorff_cell(instants1, count1, instants2, count2,
+        coords1, coords2, ndims, func, i, perm2[l]);
       if (d < cmin)
+      {
         cmin = d;
-      if (cmin < cmax)
-        break;
+        if (cmin <= cmax)
+          break;
+      }
     }
-    if (cmax < cmin && cmin < DBL_MAX)
-      cmax = cmin;
-  }
-  for (j = 0; j < count2; j++)
-  {
-    cmin = DBL_MAX;
-    inst2 = instants2[j];
-    for (i = 0; i < count1; i++)
+    if (cmin > cmax)
     {
-      inst1 = instants1[i];
-      d = tinstant_distance(inst1, inst2, func);
-      if (d < cmin)
-        cmin = d;
-      if (cmin < cmax)
+      cmax = cmin;
+      if (cmax > bound)
         break;
     }
-    if (cmax < cmin && cmin < DBL_MAX)
-      cmax = cmin;
   }
   return cmax;
 }
 
+/**
+ * @brief Return the discrete Hausdorff distance between two temporal values
+ * @details The instants are visited in a pseudo-random order, which makes
+ * the early breaks of #tinstarr_hausdorff_directed effective for
+ * trajectories, whose consecutive instants are close to each other. The
+ * distances between instants are computed from their coordinates except
+ * for geodetic points.
+ * @param[in] instants1,instants2 Arrays of temporal instants
+ * @param[in] count1,count2 Number of instants in the arrays
+ * @param[in] bound Distance above which the computation is abandoned, which
+ * is @p DBL_MAX for computing the exact distance
+ * @return Return @p DBL_MAX when the distance is greater than the bound
+ */
+static double
+tinstarr_hausdorff_distance(const TInstant **instants1, int count1,
+  const TInstant **instants2, int count2, double bound)
+{
+  int ndims = similarity_ndims(instants1[0]);
+  double *coords1 = NULL, *coords2 = NULL;
+  double bound1 = bound;
+  if (ndims > 0)
+  {
+    coords1 = tinstarr_coords(instants1, count1, ndims);
+    coords2 = tinstarr_coords(instants2, count2, ndims);
+    /* The distances computed from the coordinates are squared */
+    bound1 = (bound < sqrt(DBL_MAX)) ? bound * bound : DBL_MAX;
+  }
+  int *perm1 = hausdorff_permutation(count1);
+  int *perm2 = hausdorff_permutation(count2);
+  double cmax = tinstarr_hausdorff_directed(instants1, count1, instants2,
+    count2, coords1, coords2, ndims, perm1, perm2, 0.0, bound1);
+  if (cmax <= bound1)
+    cmax = tinstarr_hausdorff_directed(instants2, count2, instants1, count1,
+      coords2, coords1, ndims, perm2, perm1, cmax, bound1);
+  /* Free memory */
+  pfree(perm1); pfree(perm2);
+  if (coords1)
+  {
+    pfree(coords1); pfree(coords2);
+    cmax = sqrt(cmax);
+  }
+  return (cmax > bound) ? DBL_MAX : cmax;
+}
+
+/**
+ * @brief Return the discrete Hausdorff distance between two temporal values
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] bound Distance above which the computation is abandoned, which
+ * is @p DBL_MAX for computing the exact distance
+ * @return Return @p DBL_MAX when the distance is greater than the bound
+ */
+double
+temporal_hausdorff(const Temporal *temp1, const Temporal *temp2, double bound)
+{
+  assert(temp1); assert(temp2);
+  assert(temp1->temptype == temp2->temptype);
+  int count1, count2;
+  const TInstant **instants1 = temporal_insts(temp1, &count1);
+  const TInstant **instants2 = temporal_insts(temp2, &count2);
+  double result = tinstarr_hausdorff_distance(instants1, count1, instants2,
+    count2, bound);
+  /* Free memory */
+  pfree(instants1); pfree(instants2);
+  return result;
+}
+
 /**
  * @ingroup meos_temporal_analytics_similarity
  * @brief Return the Hausdorf distance between two temporal values
  * @param[in] temp1,temp2 Temporal values
  * @return On error return -1.0
+ * @csqlfn #Temporal_hausdorff_distance()
  */
 double
 temporal_hausdorff_distance(const Temporal *temp1, const Temporal *temp2)
@@ -1140,17 +1853,36 @@ temporal_hausdorff_distance(const Temporal *temp1, const Temporal *temp2)
   if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
       ! ensure_same_temporal_type(temp1, temp2))
     return -1.0;
-
   double result;
-  int count1, count2;
-  const TInstant **instants1 = temporal_insts(temp1, &count1);
-  const TInstant **instants2 = temporal_insts(temp2, &count2);
-  result = tinstarr_hausdorff_distance(instants1, count1, instants2, count2);
-  /* Free memory */
-  pfree(instants1); pfree(instants2);
+  MEOS_STATS_CALL(MEOS_FAMILY_SIMILARITY,
+    result = temporal_hausdorff(temp1, temp2, DBL_MAX));
   return result;
 }
 
+#if MEOS
+/**
+ * @ingroup meos_temporal_analytics_similarity
+ * @brief Return true if the Hausdorff distance between two temporal values
+ * is less than or equal to a bound
+ * @details The computation is abandoned as soon as the bound is exceeded
+ * @param[in] temp1,temp2 Temporal values
+ * @param[in] dist Bound
+ * @return On error return false
+ * @csqlfn #Temporal_hausdorff_distance_within()
+ */
+bool
+temporal_hausdorff_distance_within(const Temporal *temp1,
+  const Temporal *temp2, double dist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_same_temporal_type(temp1, temp2) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+    return false;
+  return temporal_hausdorff(temp1, temp2, dist) <= dist;
+}
+#endif /* MEOS */
+
 /***********************************************************************
  * Minimum distance simplification for temporal floats and points.
  * Inspired from Moving Pandas function MinDistanceGeneralizer
@@ -1684,94 +2416,180 @@ temporal_simplify_max_dist(const Temporal *temp, double dist, bool syncdist)
 /*****************************************************************************/
 
 /**
- * @brief Return a negative or a positive value depending on whether the first
- * number is less than or greater than the second one
+ * @brief Return the number of coordinates of the instants of a temporal
+ * sequence float/point used for the simplification
  */
 static int
-int_cmp(const void *a, const void *b)
+simplify_ndims(const TSequence *seq)
+{
+  if (seq->temptype == T_TFLOAT)
+    return 1;
+  return MEOS_FLAGS_GET_Z(seq->flags) ? 3 : 2;
+}
+
+/**
+ * @brief Return the coordinates of the instants of a temporal sequence
+ * float/point in contiguous arrays, one per dimension, and their timestamps
+ * @param[in] seq Temporal sequence
+ * @param[in] ndims Number of coordinates
+ * @param[out] times Timestamps of the instants
+ */
+static double *
+tsequence_simplify_coords(const TSequence *seq, int ndims, double **times)
+{
+  const TInstant **instants = tsequence_insts(seq);
+  double *result = tinstarr_coords(instants, seq->count, ndims);
+  *times = palloc(sizeof(double) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+    (*times)[i] = (double) instants[i]->t;
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @brief Return the distance between an instant and the segment defined by
+ * two other instants of a sequence from the coordinates of its instants
+ * @param[in] coords,times Coordinates and timestamps of the instants
+ * @param[in] count Number of instants
+ * @param[in] ndims Number of coordinates
+ * @param[in] a,b Indexes of the instants defining the segment
+ * @param[in] k Index of the instant
+ * @param[in] syncdist True when computing the Synchronized Euclidean
+ * Distance (SED), false when computing the spatial only distance
+ * @note For temporal floats only the Synchronized Distance is used
+ */
+static double
+coords_segment_distance(const double *coords, const double *times, int count,
+  int ndims, int a, int k, int b, bool syncdist)
 {
-  /* casting pointer types */
-  const int *ia = (const int *) a;
-  const int *ib = (const int *) b;
-  /* returns negative if b > a and positive if a > b */
-  return *ia - *ib;
+  /* Fraction of the segment of the point to which the distance is computed,
+   * either the synchronized point or the closest point of the segment */
+  double r;
+  if (syncdist || ndims == 1)
+    r = (times[k] - times[a]) / (times[b] - times[a]);
+  else
+  {
+    double num = 0.0, den = 0.0;
+    for (int d = 0; d < ndims; d++)
+    {
+      const double *c = coords + d * count;
+      num += (c[k] - c[a]) * (c[b] - c[a]);
+      den += (c[b] - c[a]) * (c[b] - c[a]);
+    }
+    r = (den == 0.0) ? 0.0 : Max(0.0, Min(1.0, num / den));
+  }
+  double result = 0.0;
+  for (int d = 0; d < ndims; d++)
+  {
+    const double *c = coords + d * count;
+    double diff = c[k] - (c[a] + (c[b] - c[a]) * r);
+    result += diff * diff;
+  }
+  return sqrt(result);
 }
 
-#define DP_STACK_SIZE 256
+/**
+ * @brief Find a split when simplifying a temporal sequence float/point using
+ * the Douglas-Peucker line simplification algorithm from the coordinates of
+ * its instants
+ * @param[in] coords,times Coordinates and timestamps of the instants
+ * @param[in] count Number of instants
+ * @param[in] ndims Number of coordinates
+ * @param[in] i1,i2 Indexes of the reference instants
+ * @param[in] syncdist True when using the Synchronized Euclidean Distance
+ * @param[out] split Location of the split
+ * @param[out] dist Distance at the split
+ */
+static void
+coords_findsplit(const double *coords, const double *times, int count,
+  int ndims, int i1, int i2, bool syncdist, int *split, double *dist)
+{
+  *split = i1;
+  *dist = -1;
+  for (int idx = i1 + 1; idx < i2; idx++)
+  {
+    double d = coords_segment_distance(coords, times, count, ndims, i1, idx,
+      i2, syncdist);
+    if (d > *dist)
+    {
+      /* Record the maximum */
+      *split = idx;
+      *dist = d;
+    }
+  }
+  return;
+}
 
 /**
  * @brief Return a temporal sequence set float/point simplified using the
  * Douglas-Peucker line simplification algorithm
+ * @note Except for geodetic points, for which the synchronized points are
+ * obtained by geodesic interpolation, the distances are computed from the
+ * coordinates of the instants extracted beforehand
  */
 static TSequence *
 tsequence_simplify_dp(const TSequence *seq, double dist, bool syncdist,
   uint32_t minpts)
 {
-  int *stack, *outlist; /* recursion stack */
-  int stack_static[DP_STACK_SIZE];
-  int outlist_static[DP_STACK_SIZE];
-  int sp = -1; /* recursion stack pointer */
-  int i1, split;
-  uint32_t outn = 0;
-  uint32_t i;
-  double d;
-
   assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags));
   assert(seq->temptype == T_TFLOAT || tgeo_type(seq->temptype));
   /* Do not try to simplify really short things */
   if (seq->count < 3)
     return tsequence_copy(seq);
 
-  /* Only heap allocate book-keeping arrays if necessary */
-  if ((unsigned int) seq->count > DP_STACK_SIZE)
-  {
-    stack = palloc(sizeof(int) * seq->count);
-    outlist = palloc(sizeof(int) * seq->count);
-  }
-  else
-  {
-    stack = stack_static;
-    outlist = outlist_static;
-  }
-
-  i1 = 0;
+  int ndims = simplify_ndims(seq);
+  double *times = NULL, *coords = NULL;
+  if (! MEOS_FLAGS_GET_GEODETIC(seq->flags))
+    coords = tsequence_simplify_coords(seq, ndims, &times);
+  /* Recursion stack and flags of the instants kept */
+  int *stack = palloc(sizeof(int) * seq->count);
+  bool *keep = palloc0(sizeof(bool) * seq->count);
+  int sp = -1; /* recursion stack pointer */
+  int i1, split;
+  uint32_t outn = 0;
+  double d;
+
+  i1 = 0;
   stack[++sp] = seq->count - 1;
   /* Add first point to output list */
-  outlist[outn++] = 0;
+  keep[0] = true;
+  outn++;
   do
   {
-    /* For temporal floats only Synchronized Distance is used */
-    if (seq->temptype == T_TFLOAT)
-      tfloatseq_findsplit(seq, i1, stack[sp], &split, &d);
-    else /* tgeo_type(seq->temptype) */
+    if (coords)
+      coords_findsplit(coords, times, seq->count, ndims, i1, stack[sp],
+        syncdist, &split, &d);
+    else /* Geodetic points */
       tpointseq_findsplit(seq, i1, stack[sp], syncdist, &split, &d);
     bool dosplit = (d >= 0 && (d > dist || outn + sp + 1 < minpts));
     if (dosplit)
       stack[++sp] = split;
     else
     {
-      outlist[outn++] = stack[sp];
+      keep[stack[sp]] = true;
+      outn++;
       i1 = stack[sp--];
     }
   }
   while (sp >= 0);
 
-  /* Order the list of points kept */
-  qsort(outlist, outn, sizeof(int), int_cmp);
-  /* Create a new temporal sequence */
+  /* Create a new temporal sequence with the instants kept in order */
   const TInstant **instants = palloc(sizeof(TInstant *) * outn);
-  for (i = 0; i < outn; i++)
-    instants[i] = TSEQUENCE_INST_N(seq, outlist[i]);
-  TSequence *result = tsequence_make(instants, outn, seq->period.lower_inc,
+  int ninsts = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    if (keep[i])
+      instants[ninsts++] = TSEQUENCE_INST_N(seq, i);
+  }
+  TSequence *result = tsequence_make(instants, ninsts, seq->period.lower_inc,
     seq->period.upper_inc, LINEAR, NORMALIZE);
-  pfree(instants);
-
-  /* Free memory only if arrays are on the heap */
-  if (stack != stack_static)
-    pfree(stack);
-  if (outlist != outlist_static)
-    pfree(outlist);
 
+  /* Free memory */
+  pfree(instants); pfree(stack); pfree(keep);
+  if (coords)
+  {
+    pfree(coords); pfree(times);
+  }
   return result;
 }
 
@@ -1832,4 +2650,1087 @@ temporal_simplify_dp(const Temporal *temp, double dist, bool syncdist)
   }
 }
 
+/*****************************************************************************
+ * Multiresolution simplification where a single Douglas-Peucker pass computes
+ * the weight of each instant, that is, the largest distance for which the
+ * instant is kept by the algorithm. The simplification for any distance is
+ * then obtained by selecting the instants whose weight is greater than the
+ * distance, without recomputing any distance.
+ *****************************************************************************/
+
+/**
+ * @brief Compute the Douglas-Peucker weights of the instants of a temporal
+ * sequence float/point
+ * @details The weight of a split instant is the minimum of its distance to
+ * the segment being split and the weight of the segment, which is the
+ * minimum of the weights of its two endpoints. The first and the last
+ * instant always have an infinite weight.
+ * @param[in] seq Temporal sequence
+ * @param[in] syncdist True when computing the Synchronized Euclidean
+ * Distance (SED), false when computing the spatial only distance
+ * @param[out] weights Weights of the instants
+ */
+static void
+tsequence_dp_weights(const TSequence *seq, bool syncdist, double *weights)
+{
+  for (int i = 0; i < seq->count; i++)
+    weights[i] = get_float8_infinity();
+  if (! MEOS_FLAGS_LINEAR_INTERP(seq->flags) || seq->count < 3)
+    return;
+
+  int ndims = simplify_ndims(seq);
+  double *times = NULL, *coords = NULL;
+  if (! MEOS_FLAGS_GET_GEODETIC(seq->flags))
+    coords = tsequence_simplify_coords(seq, ndims, &times);
+  /* Recursion stack */
+  int *stack = palloc(sizeof(int) * seq->count);
+  int sp = -1; /* recursion stack pointer */
+  int i1 = 0, split;
+  double d;
+  stack[++sp] = seq->count - 1;
+  do
+  {
+    if (coords)
+      coords_findsplit(coords, times, seq->count, ndims, i1, stack[sp],
+        syncdist, &split, &d);
+    else /* Geodetic points */
+      tpointseq_findsplit(seq, i1, stack[sp], syncdist, &split, &d);
+    if (d >= 0)
+    {
+      weights[split] = Min(d, Min(weights[i1], weights[stack[sp]]));
+      stack[++sp] = split;
+    }
+    else
+      i1 = stack[sp--];
+  }
+  while (sp >= 0);
+
+  pfree(stack);
+  if (coords)
+  {
+    pfree(coords); pfree(times);
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return the Douglas-Peucker weights of the instants of a temporal
+ * float/point
+ * @details The weight of an instant is the largest distance for which the
+ * instant is kept by the Douglas-Peucker algorithm, so that the result of
+ * #temporal_simplify_dp() for a distance is composed of the instants whose
+ * weight is greater than the distance. The instants of values without linear
+ * interpolation and the bounds of the sequences have an infinite weight.
+ * @param[in] temp Temporal value
+ * @param[in] syncdist True when the Synchronized Distance is used, false when
+ * the spatial-only distance is used. Only used for temporal points.
+ * @param[out] count Number of weights, which is the number of instants
+ * @see #temporal_simplify_dp_select()
+ * @csqlfn #Temporal_simplify_dp_weights()
+ */
+double *
+temporal_simplify_dp_weights(const Temporal *temp, bool syncdist, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) count) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype))
+    return NULL;
+
+  *count = temporal_num_instants(temp);
+  double *result = palloc(sizeof(double) * *count);
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      result[0] = get_float8_infinity();
+      break;
+    case TSEQUENCE:
+      tsequence_dp_weights((TSequence *) temp, syncdist, result);
+      break;
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      int ninsts = 0;
+      for (int i = 0; i < ss->count; i++)
+      {
+        const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+        tsequence_dp_weights(seq, syncdist, &result[ninsts]);
+        ninsts += seq->count;
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Return a temporal sequence composed of the instants whose weight is
+ * greater than a distance
+ */
+static TSequence *
+tsequence_simplify_dp_select(const TSequence *seq, const double *weights,
+  double dist, const TInstant **instants)
+{
+  int ninsts = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    if (weights[i] > dist)
+      instants[ninsts++] = TSEQUENCE_INST_N(seq, i);
+  }
+  return tsequence_make(instants, ninsts, seq->period.lower_inc,
+    seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return a temporal float/point simplified using the Douglas-Peucker
+ * line simplification algorithm from the weights of its instants
+ * @details The result is equal to the one of #temporal_simplify_dp() with the
+ * same distance when the weights are those returned by
+ * #temporal_simplify_dp_weights(), but no distance is computed, so that a
+ * single set of weights can be used for obtaining the simplifications at
+ * multiple resolutions, for example, for each zoom level of a map.
+ * @param[in] temp Temporal value
+ * @param[in] weights Weights of the instants
+ * @param[in] count Number of weights
+ * @param[in] dist Distance
+ * @csqlfn #Temporal_simplify_dp_select()
+ */
+Temporal *
+temporal_simplify_dp_select(const Temporal *temp, const double *weights,
+  int count, double dist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) weights) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype) ||
+      ! ensure_positive_datum(Float8GetDatum(dist), T_FLOAT8))
+    return NULL;
+  int ninsts = temporal_num_instants(temp);
+  if (count != ninsts)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of weights must be equal to the number of instants: %d",
+      ninsts);
+    return NULL;
+  }
+
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    return temporal_cp(temp);
+
+  const TInstant **instants = palloc(sizeof(TInstant *) * ninsts);
+  Temporal *result;
+  if (temp->subtype == TSEQUENCE)
+    result = (Temporal *) tsequence_simplify_dp_select((TSequence *) temp,
+      weights, dist, instants);
+  else /* TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+    ninsts = 0;
+    for (int i = 0; i < ss->count; i++)
+    {
+      const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+      sequences[i] = tsequence_simplify_dp_select(seq, &weights[ninsts], dist,
+        instants);
+      ninsts += seq->count;
+    }
+    result = (Temporal *) tsequenceset_make_free(sequences, ss->count,
+      NORMALIZE);
+  }
+  pfree(instants);
+  return result;
+}
+
+/*****************************************************************************/
+
+/*****************************************************************************
+ * Simplification to a given number of instants in the style of the
+ * Visvalingam-Whyatt algorithm, where the instants are removed in order of
+ * increasing importance computed as the distance to the segment defined by
+ * their neighbours.
+ *****************************************************************************/
+
+/**
+ * @brief Structure to represent the binary min-heap of the instants ordered
+ * by their importance
+ */
+typedef struct
+{
+  int *heap;            /**< Indexes of the instants in heap order */
+  int *pos;             /**< Position of each instant in the heap */
+  double *key;          /**< Importance of each instant */
+  int size;             /**< Number of instants in the heap */
+} SimplifyHeap;
+
+/**
+ * @brief Swap two elements of the heap
+ */
+static void
+simplify_heap_swap(SimplifyHeap *h, int i, int j)
+{
+  int tmp = h->heap[i];
+  h->heap[i] = h->heap[j];
+  h->heap[j] = tmp;
+  h->pos[h->heap[i]] = i;
+  h->pos[h->heap[j]] = j;
+  return;
+}
+
+/**
+ * @brief Restore the heap property from an element towards the root
+ */
+static void
+simplify_heap_up(SimplifyHeap *h, int i)
+{
+  while (i > 0)
+  {
+    int parent = (i - 1) / 2;
+    if (h->key[h->heap[parent]] <= h->key[h->heap[i]])
+      break;
+    simplify_heap_swap(h, i, parent);
+    i = parent;
+  }
+  return;
+}
+
+/**
+ * @brief Restore the heap property from an element towards the leaves
+ */
+static void
+simplify_heap_down(SimplifyHeap *h, int i)
+{
+  while (true)
+  {
+    int min = i, left = 2 * i + 1, right = 2 * i + 2;
+    if (left < h->size && h->key[h->heap[left]] < h->key[h->heap[min]])
+      min = left;
+    if (right < h->size && h->key[h->heap[right]] < h->key[h->heap[min]])
+      min = right;
+    if (min == i)
+      break;
+    simplify_heap_swap(h, i, min);
+    i = min;
+  }
+  return;
+}
+
+/**
+ * @brief Set the importance of an instant in the heap
+ */
+static void
+simplify_heap_update(SimplifyHeap *h, int inst, double key)
+{
+  h->key[inst] = key;
+  simplify_heap_up(h, h->pos[inst]);
+  simplify_heap_down(h, h->pos[inst]);
+  return;
+}
+
+/**
+ * @brief Remove and return the instant with minimum importance of the heap
+ */
+static int
+simplify_heap_pop(SimplifyHeap *h)
+{
+  int result = h->heap[0];
+  simplify_heap_swap(h, 0, --h->size);
+  simplify_heap_down(h, 0);
+  h->pos[result] = -1;
+  return result;
+}
+
+/**
+ * @brief Return a temporal sequence float/point simplified to a number of
+ * instants by removing the instants in order of increasing importance
+ * @details The importance of an instant is its distance to the segment
+ * defined by its neighbours, which is updated for the neighbours of each
+ * removed instant. As in the Visvalingam-Whyatt algorithm, the importance of
+ * a neighbour is never less than the one of the last instant removed.
+ * @param[in] seq Temporal sequence
+ * @param[in] npoints Number of instants of the result
+ * @param[in] syncdist True when computing the Synchronized Euclidean
+ * Distance (SED), false when computing the spatial only distance.
+ */
+static TSequence *
+tsequence_simplify_npoints(const TSequence *seq, int npoints, bool syncdist)
+{
+  assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags));
+  assert(seq->temptype == T_TFLOAT || tgeo_type(seq->temptype));
+  assert(npoints >= 2);
+  int count = seq->count;
+  if (count <= npoints)
+    return tsequence_copy(seq);
+
+  int ndims = simplify_ndims(seq);
+  double *times;
+  double *coords = tsequence_simplify_coords(seq, ndims, &times);
+  /* Doubly linked list of the instants remaining */
+  int *prev = palloc(sizeof(int) * count);
+  int *next = palloc(sizeof(int) * count);
+  for (int i = 0; i < count; i++)
+  {
+    prev[i] = i - 1;
+    next[i] = i + 1;
+  }
+  /* Heap of the inner instants, the first and the last one are always kept */
+  SimplifyHeap h;
+  h.heap = palloc(sizeof(int) * count);
+  h.pos = palloc(sizeof(int) * count);
+  h.key = palloc(sizeof(double) * count);
+  h.size = 0;
+  for (int i = 1; i < count - 1; i++)
+  {
+    h.key[i] = coords_segment_distance(coords, times, count, ndims, i - 1, i,
+      i + 1, syncdist);
+    h.heap[h.size] = i;
+    h.pos[i] = h.size;
+    simplify_heap_up(&h, h.size++);
+  }
+
+  double maxkey = 0.0;
+  for (int remaining = count; remaining > npoints; remaining--)
+  {
+    int i = simplify_heap_pop(&h);
+    maxkey = Max(maxkey, h.key[i]);
+    int p = prev[i], n = next[i];
+    next[p] = n;
+    prev[n] = p;
+    if (p > 0)
+      simplify_heap_update(&h, p, Max(maxkey, coords_segment_distance(coords,
+        times, count, ndims, prev[p], p, n, syncdist)));
+    if (n < count - 1)
+      simplify_heap_update(&h, n, Max(maxkey, coords_segment_distance(coords,
+        times, count, ndims, p, n, next[n], syncdist)));
+  }
+
+  /* Create a new temporal sequence with the instants remaining */
+  const TInstant **instants = palloc(sizeof(TInstant *) * npoints);
+  int ninsts = 0;
+  for (int i = 0; i < count; i = next[i])
+    instants[ninsts++] = TSEQUENCE_INST_N(seq, i);
+  TSequence *result = tsequence_make(instants, ninsts, seq->period.lower_inc,
+    seq->period.upper_inc, LINEAR, NORMALIZE);
+
+  /* Free memory */
+  pfree(instants); pfree(prev); pfree(next);
+  pfree(h.heap); pfree(h.pos); pfree(h.key);
+  pfree(coords); pfree(times);
+  return result;
+}
+
+/**
+ * @brief Return a temporal sequence set float/point simplified to a number
+ * of instants
+ * @details The number of instants is distributed among the composing
+ * sequences proportionally to their number of instants
+ * @param[in] ss Temporal sequence set
+ * @param[in] npoints Number of instants of the result
+ * @param[in] syncdist True when computing the Synchronized Euclidean
+ * Distance (SED), false when computing the spatial only distance.
+ */
+static TSequenceSet *
+tsequenceset_simplify_npoints(const TSequenceSet *ss, int npoints,
+  bool syncdist)
+{
+  TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    int n = (int) ceil((double) npoints * seq->count / ss->totalcount);
+    sequences[i] = tsequence_simplify_npoints(seq, Max(2, n), syncdist);
+  }
+  return tsequenceset_make_free(sequences, ss->count, NORMALIZE);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return a temporal float/point simplified to a number of instants by
+ * removing the less important instants first
+ * @param[in] temp Temporal value
+ * @param[in] npoints Number of instants of the result
+ * @param[in] syncdist True when the Synchronized Distance is used, false when
+ * the spatial-only distance is used. Only used for temporal points.
+ * @note The funcion applies only for temporal sequences or sequence sets with
+ * linear interpolation. In all other cases, it returns a copy of the temporal
+ * value. For temporal geography points the distances are computed on the
+ * longitude and latitude coordinates.
+ * @csqlfn #Temporal_simplify_npoints()
+ */
+Temporal *
+temporal_simplify_npoints(const Temporal *temp, int npoints, bool syncdist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_tnumber_tgeo_type(temp->temptype))
+    return NULL;
+  if (npoints < 2)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of points must be at least 2: %d", npoints);
+    return NULL;
+  }
+
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      return temporal_cp(temp);
+    case TSEQUENCE:
+      return ! MEOS_FLAGS_LINEAR_INTERP(temp->flags) ? temporal_cp(temp) :
+        (Temporal *) tsequence_simplify_npoints((TSequence *) temp, npoints,
+          syncdist);
+    default: /* TSEQUENCESET */
+      return ! MEOS_FLAGS_LINEAR_INTERP(temp->flags) ? temporal_cp(temp) :
+        (Temporal *) tsequenceset_simplify_npoints((TSequenceSet *) temp,
+          npoints, syncdist);
+  }
+}
+
+/*****************************************************************************
+ * Online simplification of a stream of temporal instants using the
+ * opening window algorithm.
+ * The instants are received one at a time and the kept instants are returned
+ * as soon as they are known, so that the simplified sequence can be built
+ * incrementally, for example with the expandable sequences, while the
+ * memory used is bounded by the size of the window.
+ *****************************************************************************/
+
+#if MEOS
+/**
+ * @brief Structure to keep the state of the online simplification of a
+ * stream of temporal instants
+ */
+struct SimplifyState
+{
+  double dist;          /**< Distance threshold */
+  bool syncdist;        /**< True when using the Synchronized Distance */
+  int maxinsts;         /**< Maximum number of instants in the window */
+  int count;            /**< Number of instants in the window */
+  TInstant *anchor;     /**< Last instant kept */
+  TInstant **window;    /**< Instants received after the anchor */
+};
+
+/**
+ * @brief Return the distance between an instant and the segment defined by
+ * two other instants
+ * @param[in] start,end Instants defining the segment
+ * @param[in] inst Instant
+ * @param[in] syncdist True when computing the Synchronized Euclidean
+ * Distance (SED), false when computing the spatial only distance.
+ * @note For temporal floats only the Synchronized Distance is used
+ */
+static double
+tsimplify_dist(const TInstant *start, const TInstant *end,
+  const TInstant *inst, bool syncdist)
+{
+  if (inst->temptype == T_TFLOAT)
+  {
+    /* The following is equivalent to
+     * #tsegment_value_at_timestamptz(start, end, LINEAR, inst->t); */
+    double startval = DatumGetFloat8(tinstant_val(start));
+    double endval = DatumGetFloat8(tinstant_val(end));
+    double ratio = (double) (inst->t - start->t) /
+      (double) (end->t - start->t);
+    double value_interp = startval + (endval - startval) * ratio;
+    return fabs(DatumGetFloat8(tinstant_val(inst)) - value_interp);
+  }
+
+  bool hasz = MEOS_FLAGS_GET_Z(inst->flags);
+  double result;
+  if (syncdist)
+  {
+    Datum value = tsegment_value_at_timestamptz(start, end, LINEAR, inst->t);
+    result = hasz ?
+      dist3d_pt_pt(DATUM_POINT3DZ_P(tinstant_val(inst)),
+        DATUM_POINT3DZ_P(value)) :
+      dist2d_pt_pt(DATUM_POINT2D_P(tinstant_val(inst)),
+        DATUM_POINT2D_P(value));
+    pfree(DatumGetPointer(value));
+  }
+  else
+    result = hasz ?
+      dist3d_pt_seg(DATUM_POINT3DZ_P(tinstant_val(inst)),
+        DATUM_POINT3DZ_P(tinstant_val(start)),
+        DATUM_POINT3DZ_P(tinstant_val(end))) :
+      dist2d_pt_seg(DATUM_POINT2D_P(tinstant_val(inst)),
+        DATUM_POINT2D_P(tinstant_val(start)),
+        DATUM_POINT2D_P(tinstant_val(end)));
+  return result;
+}
+
+/**
+ * @brief Return true if an instant of the window is farther than the
+ * distance threshold from the segment from the anchor to a new instant
+ */
+static bool
+tsimplify_window_exceeds(const SimplifyState *state, const TInstant *inst)
+{
+  for (int i = 0; i < state->count; i++)
+  {
+    if (tsimplify_dist(state->anchor, inst, state->window[i],
+        state->syncdist) > state->dist)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Return the initial state of the online simplification of a stream
+ * of temporal float/point instants
+ * @param[in] dist Distance in the units of the values for temporal floats or
+ * the units of the coordinate system for temporal points
+ * @param[in] syncdist True when the Synchronized Distance is used, false when
+ * the spatial-only distance is used. Only used for temporal points.
+ * @param[in] maxinsts Maximum number of instants kept in memory between two
+ * consecutive instants of the result
+ * @return On error return @p NULL
+ * @see #tsimplify_state_push()
+ */
+SimplifyState *
+tsimplify_state_make(double dist, bool syncdist, int maxinsts)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_positive_datum(Float8GetDatum(dist), T_FLOAT8) ||
+      ! ensure_positive(maxinsts))
+    return NULL;
+
+  SimplifyState *result = palloc0(sizeof(SimplifyState));
+  result->dist = dist;
+  result->syncdist = syncdist;
+  result->maxinsts = maxinsts;
+  result->window = palloc(sizeof(TInstant *) * maxinsts);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Add a temporal instant to the online simplification of a stream and
+ * return the instant of the simplified sequence that has been determined,
+ * if any
+ * @details The first instant of the stream is always kept. Afterwards, the
+ * instants are accumulated in the window while all of them are within the
+ * distance threshold of the segment that starts at the last kept instant and
+ * ends at the new instant. Otherwise, or when the window is full, the last
+ * instant of the window is kept and becomes the start of the next window.
+ * @param[in] state State of the simplification
+ * @param[in] inst Temporal instant, which must be after the previous one
+ * @return Return a new instant if one is kept, @p NULL otherwise or on error
+ */
+TInstant *
+tsimplify_state_push(SimplifyState *state, const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) inst))
+    return NULL;
+  if (inst->temptype != T_TFLOAT && ! tgeo_type(inst->temptype))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The temporal value must be a temporal float or a temporal point");
+    return NULL;
+  }
+
+  /* The first instant of the stream is always kept */
+  if (! state->anchor)
+  {
+    state->anchor = tinstant_copy(inst);
+    return tinstant_copy(inst);
+  }
+
+  const TInstant *last = (state->count > 0) ?
+    state->window[state->count - 1] : state->anchor;
+  if (! ensure_same_temporal_type((Temporal *) last, (Temporal *) inst) ||
+      (tgeo_type(inst->temptype) &&
+        ! ensure_spatial_validity((Temporal *) last, (Temporal *) inst)) ||
+      ! ensure_increasing_timestamps(last, inst, false))
+    return NULL;
+
+  TInstant *result = NULL;
+  if (state->count > 0 && (state->count == state->maxinsts ||
+      tsimplify_window_exceeds(state, inst)))
+  {
+    /* Keep the last instant of the window, which becomes the anchor */
+    pfree(state->anchor);
+    state->anchor = state->window[state->count - 1];
+    for (int i = 0; i < state->count - 1; i++)
+      pfree(state->window[i]);
+    state->count = 0;
+    result = tinstant_copy(state->anchor);
+  }
+  state->window[state->count++] = tinstant_copy(inst);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_simplify
+ * @brief Finish the online simplification of a stream, returning the last
+ * instant of the simplified sequence if it has not yet been returned, and
+ * free the state
+ * @param[in] state State of the simplification
+ * @return Return a new instant, @p NULL if there is no pending instant
+ */
+TInstant *
+tsimplify_state_finish(SimplifyState *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return NULL;
+
+  TInstant *result = NULL;
+  if (state->count > 0)
+  {
+    result = state->window[state->count - 1];
+    for (int i = 0; i < state->count - 1; i++)
+      pfree(state->window[i]);
+  }
+  if (state->anchor)
+    pfree(state->anchor);
+  pfree(state->window);
+  pfree(state);
+  return result;
+}
+#endif /* MEOS */
+
+/*****************************************************************************
+ * ST-DBSCAN clustering of temporal points.
+ * The bounding boxes of the segments of the temporal points are bulk loaded
+ * into an in-memory R-tree packed with the Sort-Tile-Recursive (STR)
+ * algorithm, which is queried with the bounding box of each temporal point
+ * expanded by the spatial and temporal distances to find its candidate
+ * neighbours.
+ *****************************************************************************/
+
+/* Number of entries of a node of the R-tree */
+#define STR_NODE_CAPACITY 16
+/* Dimensions used for sorting the entries: X, Y, and T */
+#define STR_NDIMS 3
+/* Maximum number of boxes per temporal point loaded into the R-tree */
+#define STDBSCAN_MAX_BOXES 16
+/* Cluster number of the temporal points that are not yet visited */
+#define STDBSCAN_UNVISITED -2
+
+/**
+ * @brief Entry of a node of an STR-packed R-tree
+ */
+typedef struct
+{
+  STBox box;          /**< Bounding box of the entry */
+  int child;          /**< Position of the temporal point in a leaf node,
+                           position of the child node otherwise */
+} StrEntry;
+
+/**
+ * @brief Node of an STR-packed R-tree, the entries of a node are
+ * consecutive in the array of entries of the tree
+ */
+typedef struct
+{
+  int start;          /**< Position of the first entry of the node */
+  int count;          /**< Number of entries of the node */
+  bool leaf;          /**< True when the node is a leaf */
+} StrNode;
+
+/**
+ * @brief STR-packed R-tree
+ */
+typedef struct
+{
+  StrEntry *entries;  /**< Entries of all the nodes */
+  StrNode *nodes;     /**< Nodes of the tree */
+  int root;           /**< Position of the root node */
+} StrTree;
+
+/**
+ * @brief Return the center of a box on a dimension of the STR sort
+ */
+static double
+str_box_center(const STBox *box, int dim)
+{
+  if (dim == 0)
+    return (box->xmin + box->xmax) / 2.0;
+  if (dim == 1)
+    return (box->ymin + box->ymax) / 2.0;
+  return ((double) DatumGetTimestampTz(box->period.lower) +
+    (double) DatumGetTimestampTz(box->period.upper)) / 2.0;
+}
+
+/**
+ * @brief Comparator functions of the entries of an STR-packed R-tree on
+ * the center of their boxes on the X, Y, and T dimensions
+ */
+static int
+str_entry_cmp_x(const void *a, const void *b)
+{
+  double c1 = str_box_center(&((const StrEntry *) a)->box, 0);
+  double c2 = str_box_center(&((const StrEntry *) b)->box, 0);
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+static int
+str_entry_cmp_y(const void *a, const void *b)
+{
+  double c1 = str_box_center(&((const StrEntry *) a)->box, 1);
+  double c2 = str_box_center(&((const StrEntry *) b)->box, 1);
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+static int
+str_entry_cmp_t(const void *a, const void *b)
+{
+  double c1 = str_box_center(&((const StrEntry *) a)->box, 2);
+  double c2 = str_box_center(&((const StrEntry *) b)->box, 2);
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+/**
+ * @brief Sort the entries of a level of an STR-packed R-tree so that each
+ * run of consecutive entries filling a node is a tile
+ * @details The entries are sorted on the current dimension and cut into
+ * slices, each slice being recursively sorted on the next dimension
+ */
+static void
+str_sort(StrEntry *entries, int count, int dim)
+{
+  static int (*cmp[STR_NDIMS])(const void *, const void *) =
+    { &str_entry_cmp_x, &str_entry_cmp_y, &str_entry_cmp_t };
+  if (count <= STR_NODE_CAPACITY)
+    return;
+  qsort(entries, count, sizeof(StrEntry), cmp[dim]);
+  if (dim == STR_NDIMS - 1)
+    return;
+  int nnodes = (count + STR_NODE_CAPACITY - 1) / STR_NODE_CAPACITY;
+  int nslices = (int) ceil(pow((double) nnodes, 1.0 / (STR_NDIMS - dim)));
+  int slice = STR_NODE_CAPACITY * ((nnodes + nslices - 1) / nslices);
+  for (int i = 0; i < count; i += slice)
+    str_sort(&entries[i], Min(slice, count - i), dim + 1);
+}
+
+/**
+ * @brief Bulk load an STR-packed R-tree from an array of entries
+ * @param[in] entries Array of leaf entries, which must have space for
+ * twice the number of entries since the entries of the inner nodes are
+ * stored after those of the leaves
+ * @param[in] count Number of leaf entries
+ * @param[out] tree Tree
+ */
+static void
+str_tree_build(StrEntry *entries, int count, StrTree *tree)
+{
+  tree->entries = entries;
+  tree->nodes = palloc(sizeof(StrNode) * count);
+  int nnodes = 0, start = 0;
+  bool leaf = true;
+  while (true)
+  {
+    str_sort(&entries[start], count, 0);
+    int first = nnodes;
+    for (int i = 0; i < count; i += STR_NODE_CAPACITY)
+    {
+      tree->nodes[nnodes].start = start + i;
+      tree->nodes[nnodes].count = Min(STR_NODE_CAPACITY, count - i);
+      tree->nodes[nnodes++].leaf = leaf;
+    }
+    if (nnodes - first == 1)
+      break;
+    /* The nodes of the level are the entries of the next level */
+    int next = start + count;
+    for (int i = first; i < nnodes; i++)
+    {
+      StrEntry *entry = &entries[next + i - first];
+      StrNode *node = &tree->nodes[i];
+      entry->box = entries[node->start].box;
+      for (int j = 1; j < node->count; j++)
+        stbox_expand(&entries[node->start + j].box, &entry->box);
+      entry->child = i;
+    }
+    start = next;
+    count = nnodes - first;
+    leaf = false;
+  }
+  tree->root = nnodes - 1;
+  return;
+}
+
+/**
+ * @brief Return true if two boxes with the same dimensionality overlap
+ * @note The function does not verify the SRID and the dimensionality of
+ * the boxes as it is done by #overlaps_stbox_stbox
+ */
+static bool
+str_box_overlaps(const STBox *box1, const STBox *box2)
+{
+  if (box1->xmin > box2->xmax || box2->xmin > box1->xmax ||
+      box1->ymin > box2->ymax || box2->ymin > box1->ymax)
+    return false;
+  if (MEOS_FLAGS_GET_Z(box1->flags) &&
+      (box1->zmin > box2->zmax || box2->zmin > box1->zmax))
+    return false;
+  return overlaps_span_span(&box1->period, &box2->period);
+}
+
+/**
+ * @brief Search an STR-packed R-tree, adding to the array of candidates
+ * the temporal points whose boxes overlap the query box
+ * @param[in] tree Tree
+ * @param[in] node Position of the node to search
+ * @param[in] box Query box
+ * @param[in] query Position of the query temporal point, which is used to
+ * mark the temporal points already found in the array @p mark
+ * @param[in,out] mark Array of the last query for which each temporal point
+ * was found, used to return once the points having several boxes
+ * @param[out] cand Array of candidate temporal points
+ * @param[out] ncand Number of candidates
+ */
+static void
+str_tree_search(const StrTree *tree, int node, const STBox *box, int query,
+  int *mark, int *cand, int *ncand)
+{
+  const StrNode *n = &tree->nodes[node];
+  for (int i = n->start; i < n->start + n->count; i++)
+  {
+    const StrEntry *entry = &tree->entries[i];
+    if (! str_box_overlaps(&entry->box, box))
+      continue;
+    if (! n->leaf)
+      str_tree_search(tree, entry->child, box, query, mark, cand, ncand);
+    else if (mark[entry->child] != query)
+    {
+      mark[entry->child] = query;
+      cand[(*ncand)++] = entry->child;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Return true if two temporal points have two instants that are
+ * within a spatial distance and a temporal distance
+ * @details Since the instants of both temporal points are ordered by time,
+ * for each instant of the first temporal point only the window of instants
+ * of the second temporal point within the temporal distance is scanned
+ */
+static bool
+tpoint_stneighbors(const TInstant **insts1, int count1,
+  const TInstant **insts2, int count2, double eps_space, int64 eps_time,
+  bool hasz)
+{
+  double eps2 = eps_space * eps_space;
+  int first = 0;
+  for (int i = 0; i < count1; i++)
+  {
+    TimestampTz t = insts1[i]->t;
+    while (first < count2 && insts2[first]->t < t - eps_time)
+      first++;
+    if (first == count2)
+      return false;
+    Datum value1 = tinstant_val(insts1[i]);
+    for (int j = first; j < count2 && insts2[j]->t <= t + eps_time; j++)
+    {
+      Datum value2 = tinstant_val(insts2[j]);
+      double dist2;
+      if (hasz)
+      {
+        const POINT3DZ *p1 = DATUM_POINT3DZ_P(value1);
+        const POINT3DZ *p2 = DATUM_POINT3DZ_P(value2);
+        dist2 = (p1->x - p2->x) * (p1->x - p2->x) +
+          (p1->y - p2->y) * (p1->y - p2->y) +
+          (p1->z - p2->z) * (p1->z - p2->z);
+      }
+      else
+      {
+        const POINT2D *p1 = DATUM_POINT2D_P(value1);
+        const POINT2D *p2 = DATUM_POINT2D_P(value2);
+        dist2 = (p1->x - p2->x) * (p1->x - p2->x) +
+          (p1->y - p2->y) * (p1->y - p2->y);
+      }
+      if (dist2 <= eps2)
+        return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Find the neighbours of a temporal point, that is, the temporal
+ * points having an instant within the distances from an instant of it
+ * @return Number of neighbours, not including the temporal point itself
+ */
+static int
+tpoint_stdbscan_neighbors(const StrTree *tree, const STBox *queries,
+  const TInstant ***insts, const int *ninsts, int i, double eps_space,
+  int64 eps_time, bool hasz, int *mark, int *neighbors)
+{
+  int ncand = 0, result = 0;
+  str_tree_search(tree, tree->root, &queries[i], i, mark, neighbors, &ncand);
+  for (int k = 0; k < ncand; k++)
+  {
+    int j = neighbors[k];
+    if (j != i && tpoint_stneighbors(insts[i], ninsts[i], insts[j],
+        ninsts[j], eps_space, eps_time, hasz))
+      neighbors[result++] = j;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_cluster
+ * @brief Return the cluster numbers of an array of temporal points using
+ * the ST-DBSCAN algorithm
+ * @details Two temporal points are neighbours if they have two instants
+ * that are within the spatial distance @p eps_space and the temporal
+ * distance @p eps_time. A temporal point is a core point if, including
+ * itself, it has at least @p minpts neighbours. The clusters are made of
+ * the core points that are transitively neighbours and of their
+ * neighbours. The candidate neighbours are found by querying an in-memory
+ * R-tree of the boxes of the segments of the temporal points packed with
+ * the Sort-Tile-Recursive (STR) algorithm.
+ * @param[in] temparr Array of temporal points
+ * @param[in] count Number of elements in the array
+ * @param[in] eps_space Spatial distance
+ * @param[in] eps_time Temporal distance
+ * @param[in] minpts Minimum number of neighbours of a core point
+ * @param[out] nclusters Number of clusters
+ * @return Array with the cluster number of each temporal point, starting
+ * from 0, where the temporal points that are not in a cluster have the
+ * value -1. On error return @p NULL
+ */
+int *
+tpointarr_stdbscan(const Temporal **temparr, int count, double eps_space,
+  const Interval *eps_time, int minpts, int *nclusters)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr) ||
+      ! ensure_not_null((void *) eps_time) ||
+      ! ensure_not_null((void *) nclusters) || ! ensure_positive(count) ||
+      ! ensure_positive(minpts) ||
+      ! ensure_not_negative_datum(Float8GetDatum(eps_space), T_FLOAT8) ||
+      ! ensure_valid_duration(eps_time))
+    return NULL;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_not_null((void *) temparr[i]) ||
+        ! ensure_tgeo_type(temparr[i]->temptype) ||
+        ! ensure_not_geodetic(temparr[i]->flags) ||
+        ! ensure_same_srid(tpoint_srid(temparr[0]), tpoint_srid(temparr[i])) ||
+        ! ensure_same_dimensionality(temparr[0]->flags, temparr[i]->flags))
+      return NULL;
+  }
+
+  bool hasz = MEOS_FLAGS_GET_Z(temparr[0]->flags);
+  int64 tunits = interval_units(eps_time);
+  /* Bulk load the boxes of the segments of each temporal point and compute
+   * the query boxes, which are the bounding boxes expanded by the distances */
+  STBox **boxes = palloc(sizeof(STBox *) * count);
+  int *nboxes = palloc(sizeof(int) * count);
+  int nentries = 0;
+  for (int i = 0; i < count; i++)
+  {
+    boxes[i] = tpoint_stboxes(temparr[i], STDBSCAN_MAX_BOXES, &nboxes[i]);
+    nentries += nboxes[i];
+  }
+  /* The entries of the inner nodes are stored after those of the leaves */
+  StrEntry *entries = palloc(sizeof(StrEntry) * nentries * 2);
+  STBox *queries = palloc(sizeof(STBox) * count);
+  const TInstant ***insts = palloc(sizeof(TInstant **) * count);
+  int *ninsts = palloc(sizeof(int) * count);
+  nentries = 0;
+  for (int i = 0; i < count; i++)
+  {
+    for (int j = 0; j < nboxes[i]; j++)
+    {
+      entries[nentries].box = boxes[i][j];
+      entries[nentries++].child = i;
+    }
+    pfree(boxes[i]);
+    temporal_set_bbox(temparr[i], &queries[i]);
+    queries[i].xmin -= eps_space;
+    queries[i].ymin -= eps_space;
+    queries[i].xmax += eps_space;
+    queries[i].ymax += eps_space;
+    if (hasz)
+    {
+      queries[i].zmin -= eps_space;
+      queries[i].zmax += eps_space;
+    }
+    queries[i].period.lower = TimestampTzGetDatum(
+      DatumGetTimestampTz(queries[i].period.lower) - tunits);
+    queries[i].period.upper = TimestampTzGetDatum(
+      DatumGetTimestampTz(queries[i].period.upper) + tunits);
+    queries[i].period.lower_inc = queries[i].period.upper_inc = true;
+    insts[i] = temporal_insts(temparr[i], &ninsts[i]);
+  }
+  pfree(boxes); pfree(nboxes);
+  StrTree tree;
+  str_tree_build(entries, nentries, &tree);
+
+  /* DBSCAN expansion of the clusters from the core points */
+  int *result = palloc(sizeof(int) * count);
+  int *mark = palloc(sizeof(int) * count);
+  int *neighbors = palloc(sizeof(int) * count);
+  int *queue = palloc(sizeof(int) * count);
+  bool *queued = palloc0(sizeof(bool) * count);
+  for (int i = 0; i < count; i++)
+  {
+    result[i] = STDBSCAN_UNVISITED;
+    mark[i] = -1;
+  }
+  int cluster = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (result[i] != STDBSCAN_UNVISITED)
+      continue;
+    int nneigh = tpoint_stdbscan_neighbors(&tree, queries, insts, ninsts, i,
+      eps_space, tunits, hasz, mark, neighbors);
+    if (nneigh + 1 < minpts)
+    {
+      /* Noise unless it is later found to be the neighbour of a core point */
+      result[i] = -1;
+      continue;
+    }
+    result[i] = cluster;
+    queued[i] = true;
+    int head = 0, tail = 0;
+    for (int k = 0; k < nneigh; k++)
+    {
+      if (! queued[neighbors[k]])
+      {
+        queued[neighbors[k]] = true;
+        queue[tail++] = neighbors[k];
+      }
+    }
+    while (head < tail)
+    {
+      int j = queue[head++];
+      if (result[j] == -1)
+        /* Border point */
+        result[j] = cluster;
+      if (result[j] != STDBSCAN_UNVISITED)
+        continue;
+      result[j] = cluster;
+      nneigh = tpoint_stdbscan_neighbors(&tree, queries, insts, ninsts, j,
+        eps_space, tunits, hasz, mark, neighbors);
+      if (nneigh + 1 < minpts)
+        continue;
+      /* Core point, the cluster is expanded with its neighbours */
+      for (int k = 0; k < nneigh; k++)
+      {
+        if (! queued[neighbors[k]])
+        {
+          queued[neighbors[k]] = true;
+          queue[tail++] = neighbors[k];
+        }
+      }
+    }
+    cluster++;
+  }
+
+  for (int i = 0; i < count; i++)
+    pfree(insts[i]);
+  pfree(insts); pfree(ninsts); pfree(entries); pfree(tree.nodes);
+  pfree(queries); pfree(mark); pfree(neighbors); pfree(queue); pfree(queued);
+  *nclusters = cluster;
+  return result;
+}
+
 /*****************************************************************************/
@@ -0,0 +1,499 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Import and export of temporal values through the Apache Arrow C Data
+ * Interface
+ * @details A batch of temporal values is represented as an Arrow column of
+ * type `list<struct<t, v>>` for temporal numbers and `list<struct<t, x, y>>`
+ * or `list<struct<t, x, y, z>>` for temporal points, where `t` is a timestamp
+ * with microsecond precision in UTC, `v` is an `int32` or a `float64`, and
+ * the coordinates are `float64`. Each list element contains the instants of
+ * a temporal value and a null element corresponds to a missing value.
+ */
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_arrow.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/** Difference in microseconds between the Unix and the PostgreSQL epochs */
+#define ARROW_EPOCH_SHIFT \
+  ((int64) (POSTGRES_EPOCH_JDATE - UNIX_EPOCH_JDATE) * USECS_PER_DAY)
+
+/*****************************************************************************
+ * Allocation and release of the Arrow structures
+ *****************************************************************************/
+
+/**
+ * @brief Release an Arrow schema produced by MEOS
+ * @note The format and name strings are static
+ */
+static void
+arrow_schema_release(struct ArrowSchema *schema)
+{
+  for (int64_t i = 0; i < schema->n_children; i++)
+  {
+    struct ArrowSchema *child = schema->children[i];
+    if (child->release)
+      child->release(child);
+    pfree(child);
+  }
+  if (schema->children)
+    pfree(schema->children);
+  schema->release = NULL;
+  return;
+}
+
+/**
+ * @brief Release an Arrow array produced by MEOS
+ */
+static void
+arrow_array_release(struct ArrowArray *array)
+{
+  for (int64_t i = 0; i < array->n_children; i++)
+  {
+    struct ArrowArray *child = array->children[i];
+    if (child->release)
+      child->release(child);
+    pfree(child);
+  }
+  if (array->children)
+    pfree(array->children);
+  for (int64_t i = 0; i < array->n_buffers; i++)
+  {
+    if (array->buffers[i])
+      pfree((void *) array->buffers[i]);
+  }
+  pfree(array->buffers);
+  array->release = NULL;
+  return;
+}
+
+/**
+ * @brief Initialize an Arrow schema with a number of empty children
+ */
+static void
+arrow_schema_init(struct ArrowSchema *schema, const char *format,
+  const char *name, int64_t flags, int64_t nchildren)
+{
+  memset(schema, 0, sizeof(struct ArrowSchema));
+  schema->format = format;
+  schema->name = name;
+  schema->flags = flags;
+  schema->n_children = nchildren;
+  if (nchildren)
+  {
+    schema->children = palloc(sizeof(struct ArrowSchema *) * nchildren);
+    for (int64_t i = 0; i < nchildren; i++)
+      schema->children[i] = palloc0(sizeof(struct ArrowSchema));
+  }
+  schema->release = arrow_schema_release;
+  return;
+}
+
+/**
+ * @brief Initialize an Arrow array with a number of buffers, which are set
+ * to @p NULL, and of empty children
+ */
+static void
+arrow_array_init(struct ArrowArray *array, int64_t length, int64_t nbuffers,
+  int64_t nchildren)
+{
+  memset(array, 0, sizeof(struct ArrowArray));
+  array->length = length;
+  array->n_buffers = nbuffers;
+  array->buffers = palloc0(sizeof(void *) * nbuffers);
+  array->n_children = nchildren;
+  if (nchildren)
+  {
+    array->children = palloc(sizeof(struct ArrowArray *) * nchildren);
+    for (int64_t i = 0; i < nchildren; i++)
+      array->children[i] = palloc0(sizeof(struct ArrowArray));
+  }
+  array->release = arrow_array_release;
+  return;
+}
+
+/**
+ * @brief Initialize a child of an Arrow struct as a primitive array without
+ * nulls
+ */
+static void
+arrow_child_init(struct ArrowSchema *schema, struct ArrowArray *array,
+  const char *format, const char *name, int64_t length, void *data)
+{
+  arrow_schema_init(schema, format, name, 0, 0);
+  arrow_array_init(array, length, 2, 0);
+  array->buffers[1] = data;
+  return;
+}
+
+/*****************************************************************************
+ * Export
+ *****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Export an array of temporal values into Arrow C Data Interface
+ * structures
+ * @details The result is a column of type `list<struct<t, v>>` for temporal
+ * numbers and `list<struct<t, x, y[, z]>>` for temporal points. The
+ * interpolation, the bounds, and the gaps of the values are not kept.
+ * The structures are released by calling their release callback.
+ * @param[in] temps Array of temporal values, which may contain @p NULL
+ * @param[in] count Number of elements in the array
+ * @param[out] schema Arrow schema
+ * @param[out] array Arrow array
+ * @return On error return false
+ */
+bool
+temporal_to_arrow(const Temporal **temps, int count, struct ArrowSchema *schema,
+  struct ArrowArray *array)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temps) || ! ensure_not_null((void *) schema) ||
+      ! ensure_not_null((void *) array))
+    return false;
+  if (count <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of temporal values must be positive");
+    return false;
+  }
+
+  /* Determine the type and the number of instants of the values */
+  meosType temptype = T_UNKNOWN;
+  bool hasz = false;
+  int64 total = 0, nulls = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (! temps[i])
+    {
+      nulls++;
+      continue;
+    }
+    if (temptype == T_UNKNOWN)
+    {
+      temptype = temps[i]->temptype;
+      hasz = MEOS_FLAGS_GET_Z(temps[i]->flags);
+    }
+    else if (temps[i]->temptype != temptype ||
+      MEOS_FLAGS_GET_Z(temps[i]->flags) != hasz)
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+        "The temporal values must be of the same type and dimensionality");
+      return false;
+    }
+    total += temporal_num_instants(temps[i]);
+  }
+  if (temptype != T_TINT && temptype != T_TFLOAT &&
+      temptype != T_TGEOMPOINT && temptype != T_TGEOGPOINT)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The temporal values must be temporal integers, floats, or points");
+    return false;
+  }
+  if (total > PG_INT32_MAX)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Too many instants for an Arrow list: " INT64_FORMAT, total);
+    return false;
+  }
+  bool isgeo = tgeo_type(temptype);
+  int nchildren = isgeo ? (hasz ? 4 : 3) : 2;
+
+  /* Allocate the buffers */
+  uint8_t *validity = nulls ? palloc0((count + 7) / 8) : NULL;
+  int32_t *offsets = palloc(sizeof(int32_t) * (count + 1));
+  int64_t *times = palloc(sizeof(int64_t) * Max(total, 1));
+  void *values[3];
+  size_t valsize = (temptype == T_TINT) ? sizeof(int32_t) : sizeof(double);
+  for (int j = 0; j < nchildren - 1; j++)
+    values[j] = palloc(valsize * Max(total, 1));
+
+  /* Fill the buffers */
+  int32_t k = 0;
+  offsets[0] = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (temps[i])
+    {
+      if (validity)
+        validity[i / 8] |= (uint8_t) (1 << (i % 8));
+      int n;
+      const TInstant **instants = temporal_insts(temps[i], &n);
+      for (int j = 0; j < n; j++, k++)
+      {
+        const TInstant *inst = instants[j];
+        times[k] = inst->t + ARROW_EPOCH_SHIFT;
+        Datum value = tinstant_val(inst);
+        if (temptype == T_TINT)
+          ((int32_t *) values[0])[k] = DatumGetInt32(value);
+        else if (temptype == T_TFLOAT)
+          ((double *) values[0])[k] = DatumGetFloat8(value);
+        else if (hasz)
+        {
+          const POINT3DZ *point = DATUM_POINT3DZ_P(value);
+          ((double *) values[0])[k] = point->x;
+          ((double *) values[1])[k] = point->y;
+          ((double *) values[2])[k] = point->z;
+        }
+        else
+        {
+          const POINT2D *point = DATUM_POINT2D_P(value);
+          ((double *) values[0])[k] = point->x;
+          ((double *) values[1])[k] = point->y;
+        }
+      }
+      pfree(instants);
+    }
+    offsets[i + 1] = k;
+  }
+
+  /* Construct the list of structs */
+  arrow_schema_init(schema, "+l", "", ARROW_FLAG_NULLABLE, 1);
+  arrow_array_init(array, count, 2, 1);
+  array->null_count = nulls;
+  array->buffers[0] = validity;
+  array->buffers[1] = offsets;
+  struct ArrowSchema *sstruct = schema->children[0];
+  struct ArrowArray *astruct = array->children[0];
+  arrow_schema_init(sstruct, "+s", "item", 0, nchildren);
+  arrow_array_init(astruct, total, 1, nchildren);
+  arrow_child_init(sstruct->children[0], astruct->children[0], "tsu:UTC", "t",
+    total, times);
+  if (isgeo)
+  {
+    static const char *names[] = {"x", "y", "z"};
+    for (int j = 0; j < nchildren - 1; j++)
+      arrow_child_init(sstruct->children[j + 1], astruct->children[j + 1], "g",
+        names[j], total, values[j]);
+  }
+  else
+    arrow_child_init(sstruct->children[1], astruct->children[1],
+      (temptype == T_TINT) ? "i" : "g", "v", total, values[0]);
+  return true;
+}
+
+/*****************************************************************************
+ * Import
+ *****************************************************************************/
+
+/**
+ * @brief Return the index of the child of an Arrow struct schema with a name,
+ * or -1 if there is no such child
+ */
+static int
+arrow_child_find(const struct ArrowSchema *schema, const char *name)
+{
+  for (int64_t i = 0; i < schema->n_children; i++)
+  {
+    if (schema->children[i]->name &&
+        strcmp(schema->children[i]->name, name) == 0)
+      return (int) i;
+  }
+  return -1;
+}
+
+/**
+ * @brief Return a pointer to the data of a child of an Arrow struct array
+ * at the first element of the struct array and without nulls
+ * @return On error return @p NULL
+ */
+static const void *
+arrow_child_data(const struct ArrowSchema *sstruct,
+  const struct ArrowArray *astruct, int child, const char *format,
+  size_t size)
+{
+  const struct ArrowSchema *schema = sstruct->children[child];
+  const struct ArrowArray *array = astruct->children[child];
+  if (strncmp(schema->format, format, strlen(format)) != 0 ||
+      array->n_buffers != 2 || ! array->buffers[1])
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "Invalid Arrow format for the field '%s': %s", schema->name,
+      schema->format);
+    return NULL;
+  }
+  if (array->null_count != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The field '%s' of the Arrow array cannot have nulls", schema->name);
+    return NULL;
+  }
+  return (const char *) array->buffers[1] +
+    size * (size_t) (array->offset + astruct->offset);
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Import an array of temporal sequences from Arrow C Data Interface
+ * structures
+ * @details The column must be of type `list<struct<t, v>>` for temporal
+ * numbers or `list<struct<t, x, y[, z]>>` for temporal points as produced by
+ * #temporal_to_arrow(). The value buffers are read directly and each list
+ * element results in a sequence with inclusive bounds, or @p NULL for null
+ * or empty elements. The structures remain owned by the caller.
+ * @param[in] schema Arrow schema
+ * @param[in] array Arrow array
+ * @param[in] geodetic True for temporal geography points
+ * @param[in] srid SRID of temporal points
+ * @param[in] interp Interpolation of the sequences
+ * @param[out] count Number of elements in the result
+ * @return On error return @p NULL
+ */
+Temporal **
+temporal_from_arrow(const struct ArrowSchema *schema,
+  const struct ArrowArray *array, bool geodetic, int32 srid, interpType interp,
+  int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) schema) || ! ensure_not_null((void *) array) ||
+      ! ensure_not_null((void *) count))
+    return NULL;
+  bool large = (strcmp(schema->format, "+L") == 0);
+  if ((! large && strcmp(schema->format, "+l") != 0) ||
+      schema->n_children != 1 || array->n_children != 1 ||
+      array->n_buffers != 2 || strcmp(schema->children[0]->format, "+s") != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The Arrow array must be a list of structs");
+    return NULL;
+  }
+  if (interp == INTERP_NONE)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The interpolation of the sequences must be specified");
+    return NULL;
+  }
+  const struct ArrowSchema *sstruct = schema->children[0];
+  const struct ArrowArray *astruct = array->children[0];
+  int tpos = arrow_child_find(sstruct, "t"), xpos = arrow_child_find(sstruct, "x"),
+    ypos = arrow_child_find(sstruct, "y"), zpos = arrow_child_find(sstruct, "z"),
+    vpos = arrow_child_find(sstruct, "v");
+  bool isgeo = (xpos >= 0 && ypos >= 0);
+  if (tpos < 0 || (! isgeo && vpos < 0) ||
+      sstruct->n_children != astruct->n_children)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The Arrow struct must have the fields 't' and either 'v' or 'x' and 'y'");
+    return NULL;
+  }
+
+  /* Get the data of the fields */
+  meosType temptype;
+  const int64_t *times = arrow_child_data(sstruct, astruct, tpos, "tsu:",
+    sizeof(int64_t));
+  const void *xs = NULL, *ys = NULL, *zs = NULL, *vs = NULL;
+  if (isgeo)
+  {
+    temptype = geodetic ? T_TGEOGPOINT : T_TGEOMPOINT;
+    xs = arrow_child_data(sstruct, astruct, xpos, "g", sizeof(double));
+    ys = arrow_child_data(sstruct, astruct, ypos, "g", sizeof(double));
+    if (zpos >= 0)
+      zs = arrow_child_data(sstruct, astruct, zpos, "g", sizeof(double));
+    if (! xs || ! ys || (zpos >= 0 && ! zs))
+      return NULL;
+  }
+  else
+  {
+    bool isint = (strcmp(sstruct->children[vpos]->format, "i") == 0);
+    temptype = isint ? T_TINT : T_TFLOAT;
+    vs = arrow_child_data(sstruct, astruct, vpos, isint ? "i" : "g",
+      isint ? sizeof(int32_t) : sizeof(double));
+    if (! vs)
+      return NULL;
+  }
+  if (! times || ! ensure_valid_interp(temptype, interp))
+    return NULL;
+
+  /* Construct the sequences */
+  const uint8_t *validity = array->buffers[0];
+  int64_t n = array->length;
+  Temporal **result = palloc(sizeof(Temporal *) * n);
+  TimestampTz *ts = NULL;
+  int64_t maxts = 0;
+  for (int64_t i = 0; i < n; i++)
+  {
+    int64_t pos = array->offset + i;
+    int64_t start = large ? ((const int64_t *) array->buffers[1])[pos] :
+      ((const int32_t *) array->buffers[1])[pos];
+    int64_t end = large ? ((const int64_t *) array->buffers[1])[pos + 1] :
+      ((const int32_t *) array->buffers[1])[pos + 1];
+    if ((validity && ! (validity[pos / 8] & (1 << (pos % 8)))) ||
+        end <= start)
+    {
+      result[i] = NULL;
+      continue;
+    }
+    int ninsts = (int) (end - start);
+    if (ninsts > maxts)
+    {
+      if (ts)
+        pfree(ts);
+      maxts = ninsts;
+      ts = palloc(sizeof(TimestampTz) * maxts);
+    }
+    for (int j = 0; j < ninsts; j++)
+      ts[j] = times[start + j] - ARROW_EPOCH_SHIFT;
+    if (isgeo)
+      result[i] = (Temporal *) tpointseq_make_coords(
+        (const double *) xs + start, (const double *) ys + start,
+        zs ? (const double *) zs + start : NULL, ts, ninsts, srid, geodetic,
+        true, true, interp, NORMALIZE);
+    else
+    {
+      TInstant **instants = palloc(sizeof(TInstant *) * ninsts);
+      for (int j = 0; j < ninsts; j++)
+      {
+        Datum value = (temptype == T_TINT) ?
+          Int32GetDatum(((const int32_t *) vs)[start + j]) :
+          Float8GetDatum(((const double *) vs)[start + j]);
+        instants[j] = tinstant_make(value, temptype, ts[j]);
+      }
+      result[i] = (Temporal *) tsequence_make_free(instants, ninsts, true,
+        true, interp, NORMALIZE);
+    }
+  }
+  if (ts)
+    pfree(ts);
+  *count = (int) n;
+  return result;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,650 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Parallel application of functions and temporal aggregates to arrays
+ * of temporal values
+ * @details The values are processed by a pool of threads created for each
+ * call. The threads take chunks of consecutive values from a shared counter
+ * until the array is exhausted, so that threads that receive cheap values
+ * take more chunks than the threads that receive expensive ones. The calling
+ * thread participates in the computation, and the other threads are
+ * initialized with #meos_initialize_thread. For the temporal aggregates,
+ * each thread feeds its own state, the states are merged with the combine
+ * function of the aggregate in a tree reduction, and the result is finalized
+ * once by the calling thread.
+ */
+
+/* C */
+#include <float.h>
+#include <pthread.h>
+#include <unistd.h>
+/* PostgreSQL */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/tbool_boolops.h"
+#include "general/temporal.h"
+#include "general/temporal_aggfuncs.h"
+
+/** Maximum number of threads of a batch */
+#define BATCH_MAX_THREADS 256
+/** Default number of values taken at once by a thread */
+#define BATCH_DEFAULT_CHUNK 64
+
+/**
+ * @brief Kind of the function applied by a batch
+ */
+typedef enum
+{
+  BATCH_TEMPORAL,
+  BATCH_DOUBLE,
+  BATCH_ARRAY,
+} batchKind;
+
+/**
+ * @brief Structure to represent the state shared by the threads of a batch
+ */
+typedef struct
+{
+  batchKind kind;             /**< Kind of the function */
+  union
+  {
+    meos_batch_temporal_fn temporal;
+    meos_batch_double_fn dbl;
+    meos_batch_array_fn array;
+  } fn;                       /**< Function applied to the values */
+  void *arg;                  /**< Argument of the function */
+  const Temporal **in;        /**< Input values */
+  void *out;                  /**< Output array */
+  int *counts;                /**< Number of elements of the output arrays */
+  int n;                      /**< Number of input values */
+  int chunk;                  /**< Number of values taken at once */
+  int next;                   /**< Next value to process */
+  pthread_mutex_t mutex;      /**< Mutex protecting the next value */
+} batch_state;
+
+/**
+ * @brief Return the default number of threads of a batch
+ */
+static int
+batch_default_threads(void)
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return (n < 1) ? 1 : (n > BATCH_MAX_THREADS) ? BATCH_MAX_THREADS : (int) n;
+}
+
+/**
+ * @brief Process chunks of a batch until all its values are taken
+ */
+/**
+ * @brief Take the next chunk of a batch
+ * @return False when all the values of the batch are taken
+ */
+static bool
+batch_take(batch_state *state, int *from, int *to)
+{
+  pthread_mutex_lock(&state->mutex);
+  *from = state->next;
+  state->next = Min(*from + state->chunk, state->n);
+  pthread_mutex_unlock(&state->mutex);
+  *to = Min(*from + state->chunk, state->n);
+  return *from < state->n;
+}
+
+/**
+ * @brief Set the number of threads and the chunk size of a batch from its
+ * options
+ * @return Number of threads
+ */
+static int
+batch_setup(batch_state *state, const meosBatchOptions *opts)
+{
+  int nthreads = (opts && opts->nthreads > 0) ?
+    Min(opts->nthreads, BATCH_MAX_THREADS) : batch_default_threads();
+  state->chunk = (opts && opts->chunksize > 0) ?
+    opts->chunksize : BATCH_DEFAULT_CHUNK;
+  state->arg = opts ? opts->arg : NULL;
+  state->next = 0;
+  /* Do not start more threads than chunks */
+  int nchunks = (state->n + state->chunk - 1) / state->chunk;
+  return Min(nthreads, nchunks);
+}
+
+/**
+ * @brief Process chunks of a batch until all its values are taken
+ */
+static void
+batch_run(batch_state *state)
+{
+  int from, to;
+  while (batch_take(state, &from, &to))
+  {
+    for (int i = from; i < to; i++)
+    {
+      const Temporal *temp = state->in[i];
+      switch (state->kind)
+      {
+        case BATCH_TEMPORAL:
+          ((Temporal **) state->out)[i] = temp ?
+            state->fn.temporal(temp, state->arg) : NULL;
+          break;
+        case BATCH_DOUBLE:
+          ((double *) state->out)[i] = temp ?
+            state->fn.dbl(temp, state->arg) : DBL_MAX;
+          break;
+        default: /* BATCH_ARRAY */
+          state->counts[i] = 0;
+          ((void **) state->out)[i] = temp ?
+            state->fn.array(temp, state->arg, &state->counts[i]) : NULL;
+      }
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Start function of the threads of a batch
+ */
+static void *
+batch_thread(void *arg)
+{
+  meos_initialize_thread(NULL);
+  batch_run((batch_state *) arg);
+  meos_finalize_thread();
+  return NULL;
+}
+
+/**
+ * @brief Apply a function to an array of temporal values in parallel
+ */
+static bool
+batch_execute(batch_state *state, const meosBatchOptions *opts)
+{
+  if (! ensure_not_null((void *) state->in) ||
+      ! ensure_not_null((void *) state->out) || ! ensure_not_negative(state->n))
+    return false;
+  if (state->n == 0)
+    return true;
+
+  int nthreads = batch_setup(state, opts);
+  pthread_mutex_init(&state->mutex, NULL);
+
+  /* The calling thread processes the chunks not taken by the other threads,
+   * including those of the threads that could not be started */
+  pthread_t threads[BATCH_MAX_THREADS];
+  bool started[BATCH_MAX_THREADS];
+  for (int i = 1; i < nthreads; i++)
+    started[i] = pthread_create(&threads[i], NULL, batch_thread, state) == 0;
+  batch_run(state);
+  for (int i = 1; i < nthreads; i++)
+  {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&state->mutex);
+  return true;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup meos_misc
+ * @brief Apply a function returning a temporal value to an array of temporal
+ * values in parallel
+ * @details For example, the following call simplifies an array of temporal
+ * points with several threads
+ * @code
+ * static Temporal *
+ * simplify(const Temporal *temp, void *arg)
+ * {
+ *   return temporal_simplify_dp(temp, *(double *) arg, false);
+ * }
+ * ...
+ * double eps = 10.0;
+ * meosBatchOptions opts = { .arg = &eps };
+ * meos_batch_map(&simplify, trips, result, count, &opts);
+ * @endcode
+ * @param[in] fn Function, which must be thread safe
+ * @param[in] in Input values, where @p NULL values result in @p NULL
+ * @param[out] out Output values, which must hold @p n values
+ * @param[in] n Number of values
+ * @param[in] opts Options, the default ones are used if @p NULL
+ * @return False if the arguments are invalid
+ */
+bool
+meos_batch_map(meos_batch_temporal_fn fn, const Temporal **in, Temporal **out,
+  int n, const meosBatchOptions *opts)
+{
+  if (! ensure_not_null((void *) fn))
+    return false;
+  batch_state state;
+  state.kind = BATCH_TEMPORAL;
+  state.fn.temporal = fn;
+  state.in = in;
+  state.out = out;
+  state.counts = NULL;
+  state.n = n;
+  return batch_execute(&state, opts);
+}
+
+/**
+ * @ingroup meos_misc
+ * @brief Apply a function returning a double to an array of temporal values
+ * in parallel
+ * @param[in] fn Function, which must be thread safe
+ * @param[in] in Input values, where @p NULL values result in @p DBL_MAX
+ * @param[out] out Output values, which must hold @p n values
+ * @param[in] n Number of values
+ * @param[in] opts Options, the default ones are used if @p NULL
+ * @return False if the arguments are invalid
+ * @see #meos_batch_map
+ */
+bool
+meos_batch_map_double(meos_batch_double_fn fn, const Temporal **in,
+  double *out, int n, const meosBatchOptions *opts)
+{
+  if (! ensure_not_null((void *) fn))
+    return false;
+  batch_state state;
+  state.kind = BATCH_DOUBLE;
+  state.fn.dbl = fn;
+  state.in = in;
+  state.out = out;
+  state.counts = NULL;
+  state.n = n;
+  return batch_execute(&state, opts);
+}
+
+/**
+ * @ingroup meos_misc
+ * @brief Apply a function returning an array to an array of temporal values
+ * in parallel, such as the one returning the boxes of a temporal point
+ * @param[in] fn Function, which must be thread safe
+ * @param[in] in Input values, where @p NULL values result in @p NULL
+ * @param[out] out Output arrays, which must hold @p n arrays
+ * @param[out] counts Number of elements of the output arrays, which must hold
+ * @p n values
+ * @param[in] n Number of values
+ * @param[in] opts Options, the default ones are used if @p NULL
+ * @return False if the arguments are invalid
+ * @see #meos_batch_map
+ */
+bool
+meos_batch_map_array(meos_batch_array_fn fn, const Temporal **in, void **out,
+  int *counts, int n, const meosBatchOptions *opts)
+{
+  if (! ensure_not_null((void *) fn) || ! ensure_not_null((void *) counts))
+    return false;
+  batch_state state;
+  state.kind = BATCH_ARRAY;
+  state.fn.array = fn;
+  state.in = in;
+  state.out = out;
+  state.counts = counts;
+  state.n = n;
+  return batch_execute(&state, opts);
+}
+
+/*****************************************************************************
+ * Parallel temporal aggregates
+ *****************************************************************************/
+
+/**
+ * @brief Structure to represent the state shared by the threads of a batch
+ * aggregate
+ */
+typedef struct
+{
+  batch_state batch;          /**< Input values and chunks */
+  meosBatchAgg agg;           /**< Aggregate computed */
+  meosType temptype;          /**< Temporal type of the input values */
+  int nthreads;               /**< Number of threads started */
+  bool ready;                 /**< True when all the threads are started */
+  bool error;                 /**< True when an error occurred */
+  void *states[BATCH_MAX_THREADS]; /**< Aggregate states of the threads */
+  bool done[BATCH_MAX_THREADS]; /**< True when the state of a thread is
+                                     completely merged */
+  pthread_cond_t cond;        /**< Condition signaling the changes of the
+                                   ready and done flags */
+} batch_agg_state;
+
+/**
+ * @brief Structure to represent the argument of the threads of a batch
+ * aggregate
+ */
+typedef struct
+{
+  batch_agg_state *state;     /**< Shared state */
+  int id;                     /**< Number of the thread */
+} batch_agg_arg;
+
+/**
+ * @brief Free an aggregate state
+ */
+static void
+batch_agg_free(meosBatchAgg agg, void *state)
+{
+  if (! state)
+    return;
+  if (agg == BATCH_AGG_TCENTROID)
+    tcentroid_state_free((TCentroidState *) state);
+  else
+    skiplist_free((SkipList *) state);
+  return;
+}
+
+/**
+ * @brief Transition function of a batch aggregate
+ */
+static void *
+batch_agg_transfn(meosBatchAgg agg, void *state, const Temporal *temp)
+{
+  SkipList *list = (SkipList *) state;
+  bool isint = temp->temptype == T_TINT;
+  switch (agg)
+  {
+    case BATCH_AGG_TCOUNT:
+      return temporal_tcount_transfn(list, temp);
+    case BATCH_AGG_TAND:
+      return tbool_tand_transfn(list, temp);
+    case BATCH_AGG_TOR:
+      return tbool_tor_transfn(list, temp);
+    case BATCH_AGG_TMIN:
+      return isint ? tint_tmin_transfn(list, temp) :
+        tfloat_tmin_transfn(list, temp);
+    case BATCH_AGG_TMAX:
+      return isint ? tint_tmax_transfn(list, temp) :
+        tfloat_tmax_transfn(list, temp);
+    case BATCH_AGG_TSUM:
+      return isint ? tint_tsum_transfn(list, temp) :
+        tfloat_tsum_transfn(list, temp);
+    case BATCH_AGG_TAVG:
+      return tnumber_tavg_transfn(list, temp);
+    default: /* BATCH_AGG_TCENTROID */
+      return tpoint_tcentroid_transfn((TCentroidState *) state, temp);
+  }
+}
+
+/**
+ * @brief Combine function of a batch aggregate, which frees the state not
+ * returned
+ * @return On error return @p NULL after freeing both states
+ */
+static void *
+batch_agg_combinefn(const batch_agg_state *state, void *state1, void *state2)
+{
+  if (state->agg == BATCH_AGG_TCENTROID)
+  {
+    TCentroidState *result = tpoint_tcentroid_combinefn(
+      (TCentroidState *) state1, (TCentroidState *) state2);
+    if (! result)
+    {
+      tcentroid_state_free((TCentroidState *) state1);
+      tcentroid_state_free((TCentroidState *) state2);
+      return NULL;
+    }
+    if (state1 && state1 != result)
+      tcentroid_state_free((TCentroidState *) state1);
+    if (state2 && state2 != result)
+      tcentroid_state_free((TCentroidState *) state2);
+    return result;
+  }
+
+  bool isint = state->temptype == T_TINT;
+  datum_func2 func;
+  bool crossings = CROSSINGS_NO;
+  switch (state->agg)
+  {
+    case BATCH_AGG_TCOUNT:
+      func = &datum_sum_int32;
+      break;
+    case BATCH_AGG_TAND:
+      func = &datum_and;
+      break;
+    case BATCH_AGG_TOR:
+      func = &datum_or;
+      break;
+    case BATCH_AGG_TMIN:
+      func = isint ? &datum_min_int32 : &datum_min_float8;
+      crossings = ! isint;
+      break;
+    case BATCH_AGG_TMAX:
+      func = isint ? &datum_max_int32 : &datum_max_float8;
+      crossings = ! isint;
+      break;
+    case BATCH_AGG_TSUM:
+      func = isint ? &datum_sum_int32 : &datum_sum_float8;
+      break;
+    default: /* BATCH_AGG_TAVG */
+      func = &datum_sum_double2;
+  }
+  SkipList *result = temporal_tagg_combinefn((SkipList *) state1,
+    (SkipList *) state2, func, crossings);
+  if (state1 && state1 != result)
+    skiplist_free((SkipList *) state1);
+  if (state2 && state2 != result)
+    skiplist_free((SkipList *) state2);
+  return result;
+}
+
+/**
+ * @brief Feed the aggregate state of a thread with chunks of the batch and
+ * merge into it the states of the threads of its subtree
+ * @details At step @p s of the reduction, the threads whose number is a
+ * multiple of @p 2s merge the state of the thread @p s positions after them,
+ * so that the state of the calling thread, whose number is 0, receives all
+ * the states after log2(n) steps
+ */
+static void
+batch_agg_run(batch_agg_state *state, int id)
+{
+  /* Feed the state */
+  void *agg = NULL;
+  int from, to;
+  while (batch_take(&state->batch, &from, &to))
+  {
+    for (int i = from; i < to; i++)
+    {
+      const Temporal *temp = state->batch.in[i];
+      if (! temp)
+        continue;
+      void *res = batch_agg_transfn(state->agg, agg, temp);
+      if (! res)
+      {
+        /* Stop all the threads from taking more chunks */
+        pthread_mutex_lock(&state->batch.mutex);
+        state->error = true;
+        state->batch.next = state->batch.n;
+        pthread_mutex_unlock(&state->batch.mutex);
+        break;
+      }
+      agg = res;
+    }
+  }
+
+  /* Wait until the number of threads is known */
+  pthread_mutex_lock(&state->batch.mutex);
+  while (! state->ready)
+    pthread_cond_wait(&state->cond, &state->batch.mutex);
+  int nthreads = state->nthreads;
+  pthread_mutex_unlock(&state->batch.mutex);
+
+  /* Tree reduction */
+  for (int s = 1; s < nthreads && id % (2 * s) == 0; s *= 2)
+  {
+    int partner = id + s;
+    if (partner >= nthreads)
+      continue;
+    pthread_mutex_lock(&state->batch.mutex);
+    while (! state->done[partner])
+      pthread_cond_wait(&state->cond, &state->batch.mutex);
+    pthread_mutex_unlock(&state->batch.mutex);
+    void *other = state->states[partner];
+    state->states[partner] = NULL;
+    if (! agg && ! other)
+      continue;
+    agg = batch_agg_combinefn(state, agg, other);
+    if (! agg)
+    {
+      pthread_mutex_lock(&state->batch.mutex);
+      state->error = true;
+      pthread_mutex_unlock(&state->batch.mutex);
+    }
+  }
+
+  /* Publish the merged state */
+  pthread_mutex_lock(&state->batch.mutex);
+  state->states[id] = agg;
+  state->done[id] = true;
+  pthread_cond_broadcast(&state->cond);
+  pthread_mutex_unlock(&state->batch.mutex);
+  return;
+}
+
+/**
+ * @brief Start function of the threads of a batch aggregate
+ */
+static void *
+batch_agg_thread(void *arg)
+{
+  batch_agg_arg *targ = (batch_agg_arg *) arg;
+  meos_initialize_thread(NULL);
+  batch_agg_run(targ->state, targ->id);
+  meos_finalize_thread();
+  return NULL;
+}
+
+/**
+ * @ingroup meos_misc
+ * @brief Return a temporal aggregate of an array of temporal values computed
+ * in parallel
+ * @details Each thread aggregates the chunks it takes into its own state, the
+ * states are merged with the combine function of the aggregate in a tree
+ * reduction, and the final function is applied once to the merged state. For
+ * example, the following call computes the temporal count of an array of
+ * trips with the default options
+ * @code
+ * Temporal *count = meos_batch_aggregate(BATCH_AGG_TCOUNT, trips, n, NULL);
+ * @endcode
+ * The aggregates @p BATCH_AGG_TMIN, @p BATCH_AGG_TMAX, and @p BATCH_AGG_TSUM
+ * are computed for temporal integers or temporal floats according to the
+ * type of the values, and @p BATCH_AGG_TCENTROID for temporal points.
+ * @param[in] agg Aggregate
+ * @param[in] in Input values, where @p NULL values are ignored
+ * @param[in] n Number of values
+ * @param[in] opts Options, the default ones are used if @p NULL, the argument
+ * of the options is ignored
+ * @return On error or when all the values are @p NULL return @p NULL
+ * @see #meos_batch_map
+ */
+Temporal *
+meos_batch_aggregate(meosBatchAgg agg, const Temporal **in, int n,
+  const meosBatchOptions *opts)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) in) || ! ensure_not_negative(n))
+    return NULL;
+  if (agg < BATCH_AGG_TCOUNT || agg > BATCH_AGG_TCENTROID)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Unknown batch aggregate: %d", agg);
+    return NULL;
+  }
+  /* The type of the first non-null value determines the combine function */
+  int first = 0;
+  while (first < n && ! in[first])
+    first++;
+  if (first == n)
+    return NULL;
+
+  batch_agg_state state;
+  memset(&state, 0, sizeof(batch_agg_state));
+  state.batch.in = in;
+  state.batch.n = n;
+  state.agg = agg;
+  state.temptype = in[first]->temptype;
+  int nthreads = batch_setup(&state.batch, opts);
+  pthread_mutex_init(&state.batch.mutex, NULL);
+  pthread_cond_init(&state.cond, NULL);
+
+  /* The reduction only involves the threads that could be started, the
+   * calling thread processing the chunks that they do not take */
+  pthread_t threads[BATCH_MAX_THREADS];
+  batch_agg_arg args[BATCH_MAX_THREADS];
+  int nstarted = 1;
+  for (int i = 1; i < nthreads; i++)
+  {
+    args[i].state = &state;
+    args[i].id = i;
+    if (pthread_create(&threads[i], NULL, batch_agg_thread, &args[i]) != 0)
+      break;
+    nstarted++;
+  }
+  pthread_mutex_lock(&state.batch.mutex);
+  state.nthreads = nstarted;
+  state.ready = true;
+  pthread_cond_broadcast(&state.cond);
+  pthread_mutex_unlock(&state.batch.mutex);
+  batch_agg_run(&state, 0);
+  for (int i = 1; i < nstarted; i++)
+    pthread_join(threads[i], NULL);
+  pthread_cond_destroy(&state.cond);
+  pthread_mutex_destroy(&state.batch.mutex);
+
+  /* Finalize the merged state once */
+  void *merged = state.states[0];
+  if (state.error)
+  {
+    batch_agg_free(agg, merged);
+    return NULL;
+  }
+  if (! merged)
+    return NULL;
+  if (agg == BATCH_AGG_TCENTROID)
+  {
+    Temporal *result =
+      tpoint_tcentroid_finalfn((const TCentroidState *) merged);
+    tcentroid_state_free((TCentroidState *) merged);
+    return result;
+  }
+  /* The final functions of the skip lists free nonempty states */
+  SkipList *list = (SkipList *) merged;
+  if (list->length == 0)
+  {
+    skiplist_free(list);
+    return NULL;
+  }
+  return (agg == BATCH_AGG_TAVG) ? tnumber_tavg_finalfn(list) :
+    temporal_tagg_finalfn(list);
+}
+
+/*****************************************************************************/
@@ -335,42 +335,47 @@ tnumberinstarr_set_tbox(const TInstant **instants, int count, bool lower_inc,
   assert(tnumber_type(instants[0]->temptype));
   meosType basetype = temptype_basetype(instants[0]->temptype);
   meosType spantype = basetype_spantype(basetype);
-  /* For discrete or step interpolation the bounds are always inclusive */
-  bool lower_inc1 = lower_inc;
-  bool upper_inc1 = upper_inc;
-  if (interp != LINEAR)
+  /* Compute the value span keeping the position of the extreme values */
+  int imin = 0, imax = 0;
+  if (basetype == T_INT4)
   {
-    lower_inc1 = upper_inc1 = true;
-  }
-  /* Compute the value span */
-  Datum min = tinstant_val(instants[0]);
-  Datum max = min;
-  bool min_inc = lower_inc1, max_inc = lower_inc1;
-  for (int i = 1; i < count; i++)
-  {
-    Datum value = tinstant_val(instants[i]);
-    int min_cmp = datum_cmp(value, min, basetype);
-    int max_cmp = datum_cmp(value, max, basetype);
-    if (min_cmp <= 0)
+    int min = DatumGetInt32(tinstant_val(instants[0])), max = min;
+    for (int i = 1; i < count; i++)
     {
-      min = value;
-      if (min_cmp == 0)
-        min_inc |= (i < count - 1) ? true : upper_inc1;
-      else
-        min_inc = (i < count - 1) ? true : upper_inc1;
+      int value = DatumGetInt32(tinstant_val(instants[i]));
+      if (value < min) { min = value; imin = i; }
+      if (value > max) { max = value; imax = i; }
     }
-    if (max_cmp >= 0)
+  }
+  else /* basetype == T_FLOAT8 */
+  {
+    double min = DatumGetFloat8(tinstant_val(instants[0])), max = min;
+    for (int i = 1; i < count; i++)
     {
-      max = value;
-      if (max_cmp == 0)
-        max_inc |= (i < count - 1) ? true : upper_inc1;
-      else
-        max_inc = (i < count - 1) ? true : upper_inc1;
+      double value = DatumGetFloat8(tinstant_val(instants[i]));
+      if (value < min) { min = value; imin = i; }
+      if (value > max) { max = value; imax = i; }
     }
   }
-  if (datum_eq(min, max, basetype))
+  Datum min = tinstant_val(instants[imin]);
+  Datum max = tinstant_val(instants[imax]);
+  /* The bounds of the value span are inclusive unless the extreme values
+   * are only reached at exclusive bounds of a linear sequence. For discrete
+   * or step interpolation the bounds are always inclusive */
+  bool min_inc = true, max_inc = true;
+  if (interp == LINEAR && ! datum_eq(min, max, basetype))
   {
-    min_inc = max_inc = true;
+    min_inc = max_inc = false;
+    for (int i = 0; i < count; i++)
+    {
+      bool inc = (i == 0) ? lower_inc :
+        ((i == count - 1) ? upper_inc : true);
+      Datum value = tinstant_val(instants[i]);
+      if (! min_inc && datum_eq(value, min, basetype))
+        min_inc = inc;
+      if (! max_inc && datum_eq(value, max, basetype))
+        max_inc = inc;
+    }
   }
   span_set(min, max, min_inc, max_inc, basetype, spantype, &box->span);
   /* Compute the time span */
@@ -613,6 +618,54 @@ tnumberinst_tboxes(const TInstant *inst, int *count)
   return result;
 }
 
+/**
+ * @brief Return the last argument initialized with the temporal box of the
+ * consecutive instants of a temporal number sequence between two positions
+ * @param[in] seq Temporal sequence
+ * @param[in] from,to Positions of the first and the last instants
+ * @param[out] box Temporal box
+ * @note The values are compared in place instead of building and expanding
+ * a box for every instant
+ */
+static void
+tnumberseq_tbox_range(const TSequence *seq, int from, int to, TBox *box)
+{
+  meosType basetype = temptype_basetype(seq->temptype);
+  int imin = from, imax = from;
+  if (basetype == T_INT4)
+  {
+    int min = DatumGetInt32(tinstant_val(TSEQUENCE_INST_N(seq, from)));
+    int max = min;
+    for (int i = from + 1; i <= to; i++)
+    {
+      int value = DatumGetInt32(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+      if (value < min) { min = value; imin = i; }
+      if (value > max) { max = value; imax = i; }
+    }
+  }
+  else /* basetype == T_FLOAT8 */
+  {
+    double min = DatumGetFloat8(tinstant_val(TSEQUENCE_INST_N(seq, from)));
+    double max = min;
+    for (int i = from + 1; i <= to; i++)
+    {
+      double value = DatumGetFloat8(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+      if (value < min) { min = value; imin = i; }
+      if (value > max) { max = value; imax = i; }
+    }
+  }
+  memset(box, 0, sizeof(TBox));
+  span_set(tinstant_val(TSEQUENCE_INST_N(seq, imin)),
+    tinstant_val(TSEQUENCE_INST_N(seq, imax)), true, true, basetype,
+    basetype_spantype(basetype), &box->span);
+  span_set(TimestampTzGetDatum(TSEQUENCE_INST_N(seq, from)->t),
+    TimestampTzGetDatum(TSEQUENCE_INST_N(seq, to)->t), true, true,
+    T_TIMESTAMPTZ, T_TSTZSPAN, &box->period);
+  MEOS_FLAGS_SET_X(box->flags, true);
+  MEOS_FLAGS_SET_T(box->flags, true);
+  return;
+}
+
 /**
  * @brief Return an array of maximum n temporal boxes from the instants of a
  * temporal number sequence with discrete interpolation (iterator function)
@@ -650,14 +703,7 @@ tnumberseq_disc_tboxes_iter(const TSequence *seq, int max_count, TBox *result)
       if (k < remainder)
         j++;
       assert(i < j);
-      tnumberinst_set_tbox(TSEQUENCE_INST_N(seq, i), &result[k]);
-      for (int l = i + 1; l <= j; l++)
-      {
-        const TInstant *inst = TSEQUENCE_INST_N(seq, l);
-        TBox box;
-        tnumberinst_set_tbox(inst, &box);
-        tbox_expand(&box, &result[k]);
-      }
+      tnumberseq_tbox_range(seq, i, j, &result[k]);
       k++;
       i = j;
     }
@@ -683,16 +729,8 @@ tnumberseq_cont_tboxes_iter(const TSequence *seq, int max_count, TBox *result)
   if (max_count < 1 || nsegs <= max_count)
   {
     /* One bounding box per segment */
-    const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
     for (int i = 0; i < seq->count - 1; i++)
-    {
-      tnumberinst_set_tbox(inst1, &result[i]);
-      const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
-      TBox box;
-      tnumberinst_set_tbox(inst2, &box);
-      tbox_expand(&box, &result[i]);
-      inst1 = inst2;
-    }
+      tnumberseq_tbox_range(seq, i, i + 1, &result[i]);
     return nsegs;
   }
   else
@@ -710,14 +748,7 @@ tnumberseq_cont_tboxes_iter(const TSequence *seq, int max_count, TBox *result)
       if (k < remainder)
         j++;
       assert(i < j);
-      tnumberinst_set_tbox(TSEQUENCE_INST_N(seq, i), &result[k]);
-      for (int l = i + 1; l <= j; l++)
-      {
-        const TInstant *inst = TSEQUENCE_INST_N(seq, l);
-        TBox box;
-        tnumberinst_set_tbox(inst, &box);
-        tbox_expand(&box, &result[k]);
-      }
+      tnumberseq_tbox_range(seq, i, j, &result[k]);
       k++;
       i = j;
     }
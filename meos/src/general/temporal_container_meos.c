@@ -0,0 +1,533 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Container files storing collections of temporal values with random
+ * access
+ * @details A container file is composed of a header, the temporal values
+ * stored one after the other, and an index with, for each value, its offset,
+ * its size, and its bounding box. The values are stored either in WKB format,
+ * which is portable, or in the native in-memory format, in which case the
+ * values are aligned so that they can be used directly from the memory-mapped
+ * file without any copy. The index is always stored in the native format and
+ * a container file can thus only be opened on a machine with the same
+ * endianness and structure layout as the one that wrote it.
+ */
+
+/* C */
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+/* PostgreSQL */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/span.h"
+#include "general/temporal.h"
+#include "general/temporal_boxops.h"
+
+/** Magic number of the container files */
+#define TCONTAINER_MAGIC "MEOSTCF"
+/** Version of the format of the container files */
+#define TCONTAINER_VERSION 1
+/** Alignment of the values and of the index in the container files */
+#define TCONTAINER_ALIGN 8
+/** Encoding of the values in the container files */
+#define TCONTAINER_WKB 0
+#define TCONTAINER_NATIVE 1
+
+/**
+ * @brief Structure for the header of a container file
+ */
+typedef struct
+{
+  char magic[8];           /**< Magic number */
+  uint32 version;          /**< Version of the format */
+  uint8 endian;            /**< Endianness, either NDR or XDR */
+  uint8 encoding;          /**< Encoding of the values */
+  uint16 entrysize;        /**< Size of an entry of the index */
+  uint64 count;            /**< Number of values */
+  uint64 index;            /**< Offset of the index */
+} tcontainer_header;
+
+/**
+ * @brief Structure for an entry of the index of a container file
+ */
+typedef struct
+{
+  uint64 offset;           /**< Offset of the value */
+  uint64 size;             /**< Size of the value */
+  uint8 temptype;          /**< Temporal type of the value */
+  uint8 boxtype;           /**< Type of the bounding box */
+  uint8 padding[6];        /**< Unused */
+  union
+  {
+    Span period;
+    TBox tbox;
+    STBox stbox;
+  } box;                   /**< Bounding box of the value */
+} tcontainer_entry;
+
+/**
+ * @brief Structure for an open container file
+ */
+struct TContainer
+{
+  const char *map;         /**< Address of the memory-mapped file */
+  size_t size;             /**< Size of the file */
+  uint8 encoding;          /**< Encoding of the values */
+  int count;               /**< Number of values */
+  const tcontainer_entry *entries; /**< Index of the values */
+};
+
+/*****************************************************************************
+ * Writing
+ *****************************************************************************/
+
+/**
+ * @brief Write padding bytes until the next aligned offset of a file
+ * @return On error return false
+ */
+static bool
+tcontainer_pad(FILE *file, uint64 *offset)
+{
+  static const char zeros[TCONTAINER_ALIGN] = {0};
+  size_t npad = (size_t) ((TCONTAINER_ALIGN - (*offset % TCONTAINER_ALIGN)) %
+    TCONTAINER_ALIGN);
+  if (npad && fwrite(zeros, 1, npad, file) != npad)
+    return false;
+  *offset += npad;
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Write an array of temporal values into a container file
+ * @param[in] filename Name of the file
+ * @param[in] temps Array of temporal values
+ * @param[in] count Number of elements in the array
+ * @param[in] native True when the values are stored in the native format,
+ * which allows reading them without copy, false for the WKB format
+ * @return On error return false
+ */
+bool
+tcontainer_write(const char *filename, const Temporal **temps, int count,
+  bool native)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) filename) || ! ensure_not_null((void *) temps))
+    return false;
+  if (count < 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of temporal values cannot be negative");
+    return false;
+  }
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_not_null((void *) temps[i]))
+      return false;
+  }
+
+  FILE *file = fopen(filename, "wb");
+  if (! file)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot open the file \"%s\": %s", filename, strerror(errno));
+    return false;
+  }
+  tcontainer_header header;
+  memset(&header, 0, sizeof(tcontainer_header));
+  memcpy(header.magic, TCONTAINER_MAGIC, sizeof(TCONTAINER_MAGIC));
+  header.version = TCONTAINER_VERSION;
+  header.endian = MEOS_IS_BIG_ENDIAN ? XDR : NDR;
+  header.encoding = native ? TCONTAINER_NATIVE : TCONTAINER_WKB;
+  header.entrysize = (uint16) sizeof(tcontainer_entry);
+  header.count = (uint64) count;
+  bool ok = fwrite(&header, sizeof(tcontainer_header), 1, file) == 1;
+
+  /* Write the values */
+  tcontainer_entry *entries = palloc0(sizeof(tcontainer_entry) *
+    Max(count, 1));
+  uint64 offset = sizeof(tcontainer_header);
+  for (int i = 0; ok && i < count; i++)
+  {
+    const Temporal *temp = temps[i];
+    ok = tcontainer_pad(file, &offset);
+    if (! ok)
+      break;
+    size_t size;
+    uint8_t *wkb = NULL;
+    const void *data;
+    if (native)
+    {
+      data = temp;
+      size = VARSIZE(temp);
+    }
+    else
+    {
+      wkb = temporal_as_wkb(temp, WKB_EXTENDED, &size);
+      if (! wkb)
+      {
+        ok = false;
+        break;
+      }
+      data = wkb;
+    }
+    ok = fwrite(data, 1, size, file) == size;
+    if (wkb)
+      pfree(wkb);
+    tcontainer_entry *entry = &entries[i];
+    entry->offset = offset;
+    entry->size = size;
+    entry->temptype = (uint8) temp->temptype;
+    entry->boxtype = (uint8) (talpha_type(temp->temptype) ? T_TSTZSPAN :
+      tnumber_type(temp->temptype) ? T_TBOX : T_STBOX);
+    temporal_set_bbox(temp, &entry->box);
+    offset += size;
+  }
+
+  /* Write the index and the final header */
+  if (ok)
+    ok = tcontainer_pad(file, &offset);
+  if (ok)
+  {
+    header.index = offset;
+    ok = fwrite(entries, sizeof(tcontainer_entry), (size_t) count, file) ==
+        (size_t) count &&
+      fseek(file, 0, SEEK_SET) == 0 &&
+      fwrite(&header, sizeof(tcontainer_header), 1, file) == 1;
+  }
+  pfree(entries);
+  if (fclose(file) != 0)
+    ok = false;
+  if (! ok)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Error while writing the file \"%s\"", filename);
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * Reading
+ *****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Open a container file
+ * @details The file is memory-mapped and remains so until it is closed
+ * with #tcontainer_close()
+ * @param[in] filename Name of the file
+ * @return On error return @p NULL
+ */
+TContainer *
+tcontainer_open(const char *filename)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) filename))
+    return NULL;
+
+  int fd = open(filename, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot open the file \"%s\": %s", filename, strerror(errno));
+    if (fd >= 0)
+      close(fd);
+    return NULL;
+  }
+  size_t size = (size_t) st.st_size;
+  if (size < sizeof(tcontainer_header))
+  {
+    close(fd);
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "The file \"%s\" is not a MEOS container file", filename);
+    return NULL;
+  }
+  const char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot map the file \"%s\": %s", filename, strerror(errno));
+    return NULL;
+  }
+
+  /* Validate the header and the index */
+  const tcontainer_header *header = (const tcontainer_header *) map;
+  const char *errmsg = NULL;
+  if (memcmp(header->magic, TCONTAINER_MAGIC, sizeof(TCONTAINER_MAGIC)) != 0)
+    errmsg = "is not a MEOS container file";
+  else if (header->version != TCONTAINER_VERSION)
+    errmsg = "has an unsupported version";
+  else if (header->endian != (MEOS_IS_BIG_ENDIAN ? XDR : NDR) ||
+      header->entrysize != sizeof(tcontainer_entry))
+    errmsg = "was written on an incompatible platform";
+  else if (header->count > (uint64) PG_INT32_MAX ||
+      header->index % TCONTAINER_ALIGN != 0 || header->index > size ||
+      header->count > (size - header->index) / sizeof(tcontainer_entry))
+    errmsg = "has an invalid index";
+  if (! errmsg)
+  {
+    const tcontainer_entry *entries =
+      (const tcontainer_entry *) (map + header->index);
+    for (uint64 i = 0; i < header->count; i++)
+    {
+      const tcontainer_entry *entry = &entries[i];
+      if (entry->offset < sizeof(tcontainer_header) ||
+          entry->offset > header->index ||
+          entry->size > header->index - entry->offset ||
+          (header->encoding == TCONTAINER_NATIVE &&
+            (entry->offset % TCONTAINER_ALIGN != 0 ||
+             entry->size < sizeof(Temporal) ||
+             VARSIZE(map + entry->offset) != entry->size)))
+      {
+        errmsg = "has an invalid index";
+        break;
+      }
+    }
+  }
+  if (errmsg)
+  {
+    munmap((void *) map, size);
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR, "The file \"%s\" %s", filename,
+      errmsg);
+    return NULL;
+  }
+
+  TContainer *result = palloc(sizeof(TContainer));
+  result->map = map;
+  result->size = size;
+  result->encoding = header->encoding;
+  result->count = (int) header->count;
+  result->entries = (const tcontainer_entry *) (map + header->index);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Close a container file
+ * @note The views obtained with #tcontainer_view() are no longer valid
+ * @param[in] cont Container file
+ */
+void
+tcontainer_close(TContainer *cont)
+{
+  if (! cont)
+    return;
+  munmap((void *) cont->map, cont->size);
+  pfree(cont);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the number of temporal values of a container file
+ * @param[in] cont Container file
+ * @return On error return -1
+ */
+int
+tcontainer_count(const TContainer *cont)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) cont))
+    return -1;
+  return cont->count;
+}
+
+/**
+ * @brief Ensure that the number of a value of a container file is valid
+ */
+static bool
+ensure_valid_tcontainer_n(const TContainer *cont, int n)
+{
+  if (! ensure_not_null((void *) cont))
+    return false;
+  if (n < 0 || n >= cont->count)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The value number must be between 0 and %d: %d", cont->count - 1, n);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return a view of the n-th temporal value of a container file
+ * @details The value is not copied and points to the memory-mapped file. It
+ * must not be modified or freed and is valid until the file is closed.
+ * @param[in] cont Container file
+ * @param[in] n Number of the value, starting from 0
+ * @return On error or when the values are not stored in the native format
+ * return @p NULL
+ */
+const Temporal *
+tcontainer_view(const TContainer *cont, int n)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_tcontainer_n(cont, n))
+    return NULL;
+  if (cont->encoding != TCONTAINER_NATIVE)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The values of the container file are not stored in the native format");
+    return NULL;
+  }
+  return (const Temporal *) (cont->map + cont->entries[n].offset);
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return a copy of the n-th temporal value of a container file
+ * @param[in] cont Container file
+ * @param[in] n Number of the value, starting from 0
+ * @return On error return @p NULL
+ */
+Temporal *
+tcontainer_get(const TContainer *cont, int n)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_tcontainer_n(cont, n))
+    return NULL;
+  const tcontainer_entry *entry = &cont->entries[n];
+  if (cont->encoding == TCONTAINER_NATIVE)
+    return temporal_copy((const Temporal *) (cont->map + entry->offset));
+  return temporal_from_wkb((const uint8_t *) (cont->map + entry->offset),
+    (size_t) entry->size);
+}
+
+/**
+ * @brief Return the numbers of the values of a container file whose bounding
+ * box overlaps a box, using only the index of the file
+ * @param[in] cont Container file
+ * @param[in] box Bounding box
+ * @param[in] boxtype Type of the bounding box
+ * @param[out] count Number of elements in the result
+ */
+static int *
+tcontainer_filter(const TContainer *cont, const void *box, meosType boxtype,
+  int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) cont) || ! ensure_not_null((void *) box) ||
+      ! ensure_not_null((void *) count))
+    return NULL;
+
+  int *result = palloc(sizeof(int) * Max(cont->count, 1));
+  int k = 0;
+  meos_errno_reset();
+  for (int i = 0; i < cont->count; i++)
+  {
+    const tcontainer_entry *entry = &cont->entries[i];
+    bool overlap;
+    if (boxtype == T_TSTZSPAN)
+    {
+      /* All bounding boxes have a time dimension */
+      const Span *period = (entry->boxtype == T_TSTZSPAN) ?
+        &entry->box.period : (entry->boxtype == T_TBOX) ?
+        &entry->box.tbox.period : &entry->box.stbox.period;
+      overlap = overlaps_span_span(period, (const Span *) box);
+    }
+    else if (entry->boxtype != boxtype)
+      continue;
+    else if (boxtype == T_TBOX)
+      overlap = overlaps_tbox_tbox(&entry->box.tbox, (const TBox *) box);
+    else
+      overlap = overlaps_stbox_stbox(&entry->box.stbox, (const STBox *) box);
+    if (overlap)
+      result[k++] = i;
+    else if (meos_errno())
+    {
+      pfree(result);
+      return NULL;
+    }
+  }
+  *count = k;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the numbers of the temporal values of a container file whose
+ * time span overlaps a timestamptz span
+ * @param[in] cont Container file
+ * @param[in] s Timestamptz span
+ * @param[out] count Number of elements in the result
+ * @return On error return @p NULL
+ */
+int *
+tcontainer_filter_tstzspan(const TContainer *cont, const Span *s, int *count)
+{
+  if (! ensure_not_null((void *) s) || ! ensure_span_isof_type(s, T_TSTZSPAN))
+    return NULL;
+  return tcontainer_filter(cont, s, T_TSTZSPAN, count);
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the numbers of the temporal numbers of a container file whose
+ * bounding box overlaps a temporal box
+ * @param[in] cont Container file
+ * @param[in] box Temporal box
+ * @param[out] count Number of elements in the result
+ * @return On error return @p NULL
+ */
+int *
+tcontainer_filter_tbox(const TContainer *cont, const TBox *box, int *count)
+{
+  return tcontainer_filter(cont, box, T_TBOX, count);
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the numbers of the spatiotemporal values of a container file
+ * whose bounding box overlaps a spatiotemporal box
+ * @param[in] cont Container file
+ * @param[in] box Spatiotemporal box
+ * @param[out] count Number of elements in the result
+ * @return On error return @p NULL
+ */
+int *
+tcontainer_filter_stbox(const TContainer *cont, const STBox *box, int *count)
+{
+  return tcontainer_filter(cont, box, T_STBOX, count);
+}
+
+/*****************************************************************************/
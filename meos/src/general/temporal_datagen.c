@@ -0,0 +1,538 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Random generation of temporal values
+ * @details These functions are the C counterpart of the PL/pgSQL generators
+ * `random_<type>_<subtype>` of the `datagen` directory. They receive the same
+ * parameters, that is, the bounds of the values and of the timestamps, the
+ * maximum difference between two consecutive values and between two
+ * consecutive timestamps, and the minimum and maximum number of instants and
+ * of sequences, and generate the values in the same way. However, the
+ * sequences are constructed directly from the generated instants instead of
+ * concatenating and parsing strings.
+ */
+
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* GSL */
+#include <gsl/gsl_rng.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+#include "general/type_util.h"
+#include "point/tpoint_spatialfuncs.h"
+#if NPOINT
+  #include "npoint/tnpoint_static.h"
+#endif
+
+/**
+ * @brief Structure to represent the current state of the random walk that
+ * generates the values of a temporal value
+ */
+typedef struct
+{
+  double value;     /**< Current value of a temporal number */
+  double x, y, z;   /**< Current coordinates of a temporal point */
+  bool b;           /**< Current value of a temporal Boolean */
+  int64 rid;        /**< Route of a temporal network point */
+} RandomWalk;
+
+/*****************************************************************************
+ * Random values
+ *****************************************************************************/
+
+/**
+ * @brief Return a random integer in the closed range [low, high]
+ */
+static int
+random_int(gsl_rng *rng, int low, int high)
+{
+  return low + (int) gsl_rng_uniform_int(rng, (unsigned long) (high - low + 1));
+}
+
+/**
+ * @brief Return a random float in the range [low, high)
+ */
+static double
+random_float(gsl_rng *rng, double low, double high)
+{
+  return low + gsl_rng_uniform(rng) * (high - low);
+}
+
+/**
+ * @brief Return a random timestamptz in the range [low, high] truncated to
+ * the minute
+ */
+static TimestampTz
+random_timestamptz(gsl_rng *rng, TimestampTz low, TimestampTz high)
+{
+  TimestampTz result = low + (TimestampTz) (gsl_rng_uniform(rng) *
+    (double) (high - low));
+  /* Truncate to the minute with respect to the lower bound */
+  return result - (result - low) % USECS_PER_MINUTE;
+}
+
+/**
+ * @brief Return the next value of a random walk, that is, the value shifted
+ * by a random delta in [-maxdelta, maxdelta] or by its opposite, whichever
+ * keeps the value in the range [low, high]
+ * @note If neither the delta nor its opposite keep the value in the range the
+ * same value is kept
+ */
+static double
+random_step(double value, double delta, double low, double high)
+{
+  if (value + delta >= low && value + delta <= high)
+    return value + delta;
+  if (value - delta >= low && value - delta <= high)
+    return value - delta;
+  return value;
+}
+
+/**
+ * @brief Return a random text value with a length in [1, maxlength] composed
+ * of uppercase letters
+ */
+static text *
+random_text(gsl_rng *rng, int maxlength)
+{
+  int len = random_int(rng, 1, maxlength);
+  char *str = palloc(len + 1);
+  for (int i = 0; i < len; i++)
+    str[i] = (char) random_int(rng, 'A', 'Z');
+  str[len] = '\0';
+  text *result = cstring2text(str);
+  pfree(str);
+  return result;
+}
+
+/**
+ * @brief Initialize the random walk generating the values of a temporal
+ * value
+ */
+static void
+random_walk_init(const temporalRandomOptions *opts, gsl_rng *rng,
+  RandomWalk *walk)
+{
+  memset(walk, 0, sizeof(RandomWalk));
+  switch (opts->temptype)
+  {
+    case T_TBOOL:
+      walk->b = gsl_rng_uniform(rng) > 0.5;
+      break;
+    case T_TINT:
+      walk->value = random_int(rng, (int) opts->lowvalue,
+        (int) opts->highvalue);
+      break;
+    case T_TFLOAT:
+      walk->value = random_float(rng, opts->lowvalue,
+        opts->highvalue - opts->maxdelta);
+      break;
+    case T_TGEOMPOINT:
+    case T_TGEOGPOINT:
+      walk->x = random_float(rng, opts->lowx, opts->highx);
+      walk->y = random_float(rng, opts->lowy, opts->highy);
+      if (opts->hasz)
+        walk->z = random_float(rng, opts->lowz, opts->highz);
+      break;
+#if NPOINT
+    case T_TNPOINT:
+      walk->rid = random_int(rng, (int) opts->lowvalue,
+        (int) opts->highvalue);
+      break;
+#endif /* NPOINT */
+    default: /* T_TTEXT */
+      break;
+  }
+  return;
+}
+
+/**
+ * @brief Return the current value of the random walk and advance the walk
+ * @param[in] opts Options
+ * @param[in] rng Random number generator
+ * @param[in] discrete True when the values are those of a discrete sequence,
+ * where consecutive Boolean values and routes are independent
+ * @param[in,out] walk Random walk
+ */
+static Datum
+random_walk_next(const temporalRandomOptions *opts, gsl_rng *rng,
+  bool discrete, RandomWalk *walk)
+{
+  Datum result;
+  switch (opts->temptype)
+  {
+    case T_TBOOL:
+      if (discrete)
+        walk->b = gsl_rng_uniform(rng) > 0.5;
+      result = BoolGetDatum(walk->b);
+      walk->b = ! walk->b;
+      return result;
+    case T_TINT:
+      result = Int32GetDatum((int) walk->value);
+      walk->value = random_step(walk->value,
+        (double) random_int(rng, - (int) opts->maxdelta, (int) opts->maxdelta),
+        opts->lowvalue, opts->highvalue);
+      return result;
+    case T_TFLOAT:
+      result = Float8GetDatum(walk->value);
+      walk->value = random_step(walk->value,
+        random_float(rng, - opts->maxdelta, opts->maxdelta),
+        opts->lowvalue, opts->highvalue);
+      return result;
+    case T_TTEXT:
+      return PointerGetDatum(random_text(rng, opts->maxlength));
+    case T_TGEOMPOINT:
+    case T_TGEOGPOINT:
+      result = PointerGetDatum(geopoint_make(walk->x, walk->y, walk->z,
+        opts->hasz, opts->temptype == T_TGEOGPOINT, opts->srid));
+      walk->x = random_step(walk->x,
+        random_float(rng, - opts->maxdelta, opts->maxdelta),
+        opts->lowx, opts->highx);
+      walk->y = random_step(walk->y,
+        random_float(rng, - opts->maxdelta, opts->maxdelta),
+        opts->lowy, opts->highy);
+      if (opts->hasz)
+        walk->z = random_step(walk->z,
+          random_float(rng, - opts->maxdelta, opts->maxdelta),
+          opts->lowz, opts->highz);
+      return result;
+#if NPOINT
+    case T_TNPOINT:
+      if (discrete)
+        walk->rid = random_int(rng, (int) opts->lowvalue,
+          (int) opts->highvalue);
+      return PointerGetDatum(npoint_make(walk->rid, gsl_rng_uniform(rng)));
+#endif /* NPOINT */
+    default: /* Error! */
+      meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+        "Unknown temporal type for random generation: %s",
+        meostype_name(opts->temptype));
+      return 0;
+  }
+}
+
+/*****************************************************************************
+ * Validity of the options
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the options for the random generation of temporal
+ * values are valid
+ */
+static bool
+temporal_random_valid(const temporalRandomOptions *opts)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) opts))
+    return false;
+  if (opts->temptype != T_TBOOL && opts->temptype != T_TINT &&
+      opts->temptype != T_TFLOAT && opts->temptype != T_TTEXT &&
+      opts->temptype != T_TGEOMPOINT && opts->temptype != T_TGEOGPOINT
+#if NPOINT
+      && opts->temptype != T_TNPOINT
+#endif /* NPOINT */
+    )
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "Unsupported temporal type for random generation: %s",
+      meostype_name(opts->temptype));
+    return false;
+  }
+  if (opts->subtype != TINSTANT && opts->subtype != TSEQUENCE &&
+      opts->subtype != TSEQUENCESET)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid temporal subtype for random generation");
+    return false;
+  }
+  if (opts->subtype != TINSTANT)
+  {
+    if (opts->interp == LINEAR && ! temptype_continuous(opts->temptype))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The temporal type cannot have linear interpolation");
+      return false;
+    }
+    if (opts->interp == INTERP_NONE ||
+        (opts->subtype == TSEQUENCESET && opts->interp == DISCRETE))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Invalid interpolation for random generation");
+      return false;
+    }
+  }
+  if (opts->lowtime >= opts->hightime)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "lowtime must be less than hightime");
+    return false;
+  }
+  if (opts->maxminutes < 1)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "maxminutes must be greater than 0: %d", opts->maxminutes);
+    return false;
+  }
+  if (opts->mininsts < 1 || opts->mininsts > opts->maxinsts)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "mininsts must be greater than 0 and less than or equal to maxinsts: %d, %d",
+      opts->mininsts, opts->maxinsts);
+    return false;
+  }
+  if (opts->subtype == TSEQUENCESET &&
+      (opts->minseqs < 1 || opts->minseqs > opts->maxseqs))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "minseqs must be greater than 0 and less than or equal to maxseqs: %d, %d",
+      opts->minseqs, opts->maxseqs);
+    return false;
+  }
+  switch (opts->temptype)
+  {
+    case T_TINT:
+#if NPOINT
+    case T_TNPOINT:
+#endif /* NPOINT */
+      if (opts->lowvalue > opts->highvalue)
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "lowvalue must be less than or equal to highvalue: %g, %g",
+          opts->lowvalue, opts->highvalue);
+        return false;
+      }
+      break;
+    case T_TFLOAT:
+      if (opts->lowvalue > opts->highvalue - opts->maxdelta)
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "lowvalue must be less than or equal to highvalue - maxdelta: %g, %g, %g",
+          opts->lowvalue, opts->highvalue, opts->maxdelta);
+        return false;
+      }
+      break;
+    case T_TTEXT:
+      if (opts->maxlength < 1)
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "maxlength must be greater than 0: %d", opts->maxlength);
+        return false;
+      }
+      break;
+    case T_TGEOMPOINT:
+    case T_TGEOGPOINT:
+      if (opts->lowx > opts->highx || opts->lowy > opts->highy ||
+          (opts->hasz && opts->lowz > opts->highz))
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "The lower bounds of the coordinates must be less than or equal to the upper bounds");
+        return false;
+      }
+      if (opts->temptype == T_TGEOGPOINT &&
+          (opts->lowx < -180 || opts->highx > 180 ||
+           opts->lowy < -90 || opts->highy > 90))
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "The coordinates of geography points must be in the range [-180, 180] x [-90, 90]");
+        return false;
+      }
+      break;
+    default: /* T_TBOOL */
+      break;
+  }
+  /* Ensure that there is enough time for generating the instants */
+  int64 minutes;
+  if (opts->subtype == TSEQUENCESET)
+    minutes = (int64) opts->maxminutes *
+      (opts->maxinsts - opts->mininsts) * (opts->maxseqs - opts->minseqs) +
+      (int64) (opts->maxseqs - opts->minseqs) * opts->maxminutes;
+  else
+    minutes = (int64) opts->maxminutes * (opts->maxinsts - opts->mininsts);
+  if (opts->lowtime > opts->hightime - minutes * USECS_PER_MINUTE)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The duration between lowtime and hightime is not enough to generate the temporal value");
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * Random temporal values
+ *****************************************************************************/
+
+/**
+ * @brief Return a random temporal instant
+ */
+static TInstant *
+tinstant_random(const temporalRandomOptions *opts, gsl_rng *rng)
+{
+  RandomWalk walk;
+  random_walk_init(opts, rng, &walk);
+  Datum value = random_walk_next(opts, rng, true, &walk);
+  TimestampTz t = random_timestamptz(rng, opts->lowtime, opts->hightime);
+  return tinstant_make_free(value, opts->temptype, t);
+}
+
+/**
+ * @brief Return a random temporal sequence whose timestamps start in the
+ * range [lowtime, hightime]
+ * @param[in] opts Options
+ * @param[in] rng Random number generator
+ * @param[in] lowtime,hightime Bounds of the start timestamp
+ * @param[in] fixstart True when the sequence starts at the lower bound
+ */
+static TSequence *
+tsequence_random(const temporalRandomOptions *opts, gsl_rng *rng,
+  TimestampTz lowtime, TimestampTz hightime, bool fixstart)
+{
+  bool discrete = (opts->interp == DISCRETE);
+  int count = random_int(rng, opts->mininsts, opts->maxinsts);
+  TimestampTz t = fixstart ? lowtime : random_timestamptz(rng, lowtime,
+    hightime - (int64) opts->maxminutes * count * USECS_PER_MINUTE);
+  bool lower_inc = true, upper_inc = true;
+  if (! discrete && count > 1)
+  {
+    lower_inc = gsl_rng_uniform(rng) > 0.5;
+    upper_inc = gsl_rng_uniform(rng) > 0.5;
+  }
+  RandomWalk walk;
+  random_walk_init(opts, rng, &walk);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    /* Sequences with step interpolation and exclusive upper bound must have
+     * the same value in the last two instants */
+    if (i > 0 && i == count - 1 && opts->interp == STEP && ! upper_inc)
+      instants[i] = tinstant_make(tinstant_val(instants[i - 1]),
+        opts->temptype, t);
+    else
+      instants[i] = tinstant_make_free(random_walk_next(opts, rng, discrete,
+        &walk), opts->temptype, t);
+    t += (int64) random_int(rng, 1, opts->maxminutes) * USECS_PER_MINUTE;
+  }
+  return tsequence_make_free(instants, count, lower_inc, upper_inc,
+    opts->interp, NORMALIZE);
+}
+
+/**
+ * @brief Return a random temporal sequence set
+ * @note The bounds of the start timestamp of each sequence are computed as
+ * in the PL/pgSQL generators so that the sequences are disjoint and fit in
+ * the time range of the options
+ */
+static TSequenceSet *
+tsequenceset_random(const temporalRandomOptions *opts, gsl_rng *rng)
+{
+  int count = random_int(rng, opts->minseqs, opts->maxseqs);
+  TimestampTz t1 = opts->lowtime;
+  TimestampTz t2 = opts->hightime - USECS_PER_MINUTE *
+    ((int64) opts->maxminutes * (opts->maxinsts - opts->mininsts) *
+      (opts->maxseqs - opts->minseqs) +
+     (int64) (opts->maxseqs - opts->minseqs) * opts->maxminutes);
+  TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    /* All sequences except the first one start at the lower bound */
+    sequences[i] = tsequence_random(opts, rng, t1, t2, i > 0);
+    t1 = tsequence_end_timestamptz(sequences[i]) +
+      (int64) random_int(rng, 1, opts->maxminutes) * USECS_PER_MINUTE;
+    t2 += USECS_PER_MINUTE * opts->maxminutes *
+      (1 + opts->maxinsts - opts->mininsts);
+  }
+  return tsequenceset_make_free(sequences, count, NORMALIZE);
+}
+
+/**
+ * @brief Return a random temporal value without validating the options
+ */
+static Temporal *
+temporal_random_int(const temporalRandomOptions *opts, gsl_rng *rng)
+{
+  if (opts->subtype == TINSTANT)
+    return (Temporal *) tinstant_random(opts, rng);
+  if (opts->subtype == TSEQUENCE)
+    return (Temporal *) tsequence_random(opts, rng, opts->lowtime,
+      opts->hightime, false);
+  return (Temporal *) tsequenceset_random(opts, rng);
+}
+
+/**
+ * @ingroup meos_internal_temporal_constructor
+ * @brief Return a random temporal value
+ * @param[in] opts Options
+ * @param[in] rng Random number generator, the generator of the data
+ * generator is used when the argument is NULL
+ * @note The function is equivalent to the PL/pgSQL functions
+ * `random_<type>_<subtype>` of the `datagen` directory
+ */
+Temporal *
+temporal_random(const temporalRandomOptions *opts, gsl_rng *rng)
+{
+  /* Ensure validity of the arguments */
+  if (! temporal_random_valid(opts))
+    return NULL;
+  if (! rng)
+    rng = gsl_get_generation_rng();
+  return temporal_random_int(opts, rng);
+}
+
+/**
+ * @ingroup meos_internal_temporal_constructor
+ * @brief Return an array of random temporal values
+ * @details The values are generated with a random number generator of their
+ * own that is initialized with the seed, so that the same arguments always
+ * result in the same values
+ * @param[in] opts Options
+ * @param[in] count Number of values
+ * @param[in] seed Seed of the random number generator
+ */
+Temporal **
+temporal_random_bulk(const temporalRandomOptions *opts, int count,
+  uint64 seed)
+{
+  /* Ensure validity of the arguments */
+  if (! temporal_random_valid(opts) || ! ensure_positive(count))
+    return NULL;
+
+  gsl_rng *rng = gsl_rng_alloc(gsl_rng_default);
+  gsl_rng_set(rng, (unsigned long) seed);
+  Temporal **result = palloc(sizeof(Temporal *) * count);
+  for (int i = 0; i < count; i++)
+    result[i] = temporal_random_int(opts, rng);
+  gsl_rng_free(rng);
+  return result;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,456 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Memory budget of long-lived expandable temporal values
+ * @details An expand pool keeps expandable temporal values, e.g., the open
+ * trips of the objects of a stream, and tracks the free space, or slack,
+ * that they reserve for future appends. When the total slack exceeds the
+ * budget of the pool, the values whose last append is the oldest are
+ * compacted until the slack is at most half of the budget.
+ *
+ * A compacted value whose sequence becomes full again grows by a factor
+ * 1 + 1/2^k instead of doubling, where k is the number of times the value
+ * has been compacted, so that the objects that have gone quiet do not
+ * reserve again a large slack. The usual doubling is restored progressively
+ * at each growth of the value.
+ */
+
+/* C */
+#include <assert.h>
+#include <stdlib.h>
+/* PostgreSQL */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+
+/** Maximum number of times the growth factor of a quiet value is reduced */
+#define EXPAND_POOL_MAXQUIET 4
+/** Minimum number of instants reserved when a quiet value grows */
+#define EXPAND_POOL_MINGROWTH 4
+/** Initial number of entries of a pool */
+#define EXPAND_POOL_SIZE 64
+
+/**
+ * @brief Structure to represent an entry of an expand pool
+ */
+typedef struct
+{
+  Temporal *temp;          /**< Value, NULL for a free entry */
+  size_t slack;            /**< Slack of the value */
+  uint64 tick;             /**< Logical time of the last append */
+  int quiet;               /**< Number of reductions of the growth factor */
+  int next;                /**< Next free entry */
+} ExpandEntry;
+
+/**
+ * @brief Structure to represent an expand pool
+ */
+struct ExpandPool
+{
+  size_t maxslack;         /**< Budget of the total slack */
+  size_t slack;            /**< Total slack of the values */
+  uint64 tick;             /**< Logical time of the last append */
+  int count;               /**< Number of values */
+  int size;                /**< Number of used entries */
+  int maxsize;             /**< Number of allocated entries */
+  int freelist;            /**< First free entry, -1 if none */
+  ExpandEntry *entries;    /**< Entries */
+};
+
+/*****************************************************************************/
+
+/**
+ * @brief Return the free space reserved by an expandable temporal sequence
+ * @note The free space of the offsets array is included
+ */
+static size_t
+tsequence_slack(const TSequence *seq)
+{
+  const TInstant *last = TSEQUENCE_INST_N(seq, seq->count - 1);
+  size_t used = (char *) last + DOUBLE_PAD(VARSIZE(last)) - (char *) seq;
+  size_t result = VARSIZE(seq) - used;
+  if (! MEOS_FLAGS_GET_FIXED(seq->flags))
+    result += sizeof(size_t) * (seq->maxcount - seq->count);
+  return result;
+}
+
+/**
+ * @brief Return the free space reserved by an expandable temporal value
+ * @note For sequence sets, only the free space of the last composing
+ * sequence, which is the one receiving the appends, is taken into account
+ */
+static size_t
+temporal_slack(const Temporal *temp)
+{
+  if (temp->subtype == TINSTANT)
+    return 0;
+  if (temp->subtype == TSEQUENCE)
+    return tsequence_slack((const TSequence *) temp);
+  /* TSEQUENCESET */
+  const TSequenceSet *ss = (const TSequenceSet *) temp;
+  const TSequence *last = TSEQUENCESET_SEQ_N(ss, ss->count - 1);
+  size_t used = (char *) last + DOUBLE_PAD(VARSIZE(last)) - (char *) ss;
+  return VARSIZE(ss) - used +
+    sizeof(size_t) * (ss->maxcount - ss->count) + tsequence_slack(last);
+}
+
+/**
+ * @brief Return the entry of a handle of an expand pool
+ * @return On error return @p NULL
+ */
+static ExpandEntry *
+expand_pool_entry(const ExpandPool *pool, int handle)
+{
+  if (! ensure_not_null((void *) pool))
+    return NULL;
+  if (handle < 0 || handle >= pool->size || ! pool->entries[handle].temp)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid handle of the expand pool: %d", handle);
+    return NULL;
+  }
+  return &pool->entries[handle];
+}
+
+/**
+ * @brief Replace the value of an entry and update the slack of the pool
+ */
+static void
+expand_entry_set(ExpandPool *pool, ExpandEntry *entry, Temporal *temp)
+{
+  pool->slack -= entry->slack;
+  entry->temp = temp;
+  entry->slack = temporal_slack(temp);
+  pool->slack += entry->slack;
+  return;
+}
+
+/**
+ * @brief Compact the value of an entry
+ */
+static void
+expand_entry_compact(ExpandPool *pool, ExpandEntry *entry)
+{
+  Temporal *temp = temporal_compact(entry->temp);
+  pfree(entry->temp);
+  expand_entry_set(pool, entry, temp);
+  if (entry->quiet < EXPAND_POOL_MAXQUIET)
+    entry->quiet++;
+  return;
+}
+
+/**
+ * @brief Comparator of entries by logical time of the last append
+ */
+static int
+expand_tick_cmp(const void *a, const void *b)
+{
+  uint64 t1 = ((const uint64 *) a)[0], t2 = ((const uint64 *) b)[0];
+  return (t1 < t2) ? -1 : ((t1 > t2) ? 1 : 0);
+}
+
+/**
+ * @brief Reserve space for more instants in a full sequence of a quiet value
+ * with a growth factor that decreases with the number of times the value has
+ * been compacted
+ */
+static void
+expand_entry_grow(ExpandPool *pool, ExpandEntry *entry)
+{
+  TSequence *seq = (TSequence *) entry->temp;
+  int maxcount = seq->count + Max(seq->count >> entry->quiet,
+    EXPAND_POOL_MINGROWTH);
+  const TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+    instants[i] = TSEQUENCE_INST_N(seq, i);
+  TSequence *result = tsequence_make_exp(instants, seq->count, maxcount,
+    seq->period.lower_inc, seq->period.upper_inc,
+    MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE_NO);
+  pfree(instants);
+  pfree(seq);
+  expand_entry_set(pool, entry, (Temporal *) result);
+  entry->quiet--;
+  return;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Return a new expand pool that bounds the total slack of its
+ * expandable temporal values
+ * @param[in] maxslack Budget in bytes of the total slack
+ * @see #expand_pool_append
+ */
+ExpandPool *
+expand_pool_make(size_t maxslack)
+{
+  if (maxslack == 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The slack budget of an expand pool must be positive");
+    return NULL;
+  }
+  ExpandPool *result = palloc0(sizeof(ExpandPool));
+  result->maxslack = maxslack;
+  result->freelist = -1;
+  result->maxsize = EXPAND_POOL_SIZE;
+  result->entries = palloc0(sizeof(ExpandEntry) * result->maxsize);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Add an expandable temporal value to an expand pool, which takes the
+ * ownership of the value
+ * @param[in,out] pool Expand pool
+ * @param[in] temp Temporal sequence or sequence set
+ * @return Handle of the value in the pool, on error return -1
+ */
+int
+expand_pool_add(ExpandPool *pool, Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pool) || ! ensure_not_null((void *) temp) ||
+      ! ensure_continuous(temp))
+    return -1;
+  if (temp->subtype == TINSTANT)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The value of an expand pool must be a sequence or a sequence set");
+    return -1;
+  }
+
+  int result;
+  if (pool->freelist >= 0)
+  {
+    result = pool->freelist;
+    pool->freelist = pool->entries[result].next;
+  }
+  else
+  {
+    if (pool->size == pool->maxsize)
+    {
+      pool->maxsize *= 2;
+      pool->entries = repalloc(pool->entries,
+        sizeof(ExpandEntry) * pool->maxsize);
+    }
+    result = pool->size++;
+  }
+  ExpandEntry *entry = &pool->entries[result];
+  memset(entry, 0, sizeof(ExpandEntry));
+  expand_entry_set(pool, entry, temp);
+  entry->tick = ++pool->tick;
+  pool->count++;
+  if (pool->slack > pool->maxslack)
+    expand_pool_compact(pool, pool->maxslack / 2);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Return the value of a handle of an expand pool
+ * @param[in] pool Expand pool
+ * @param[in] handle Handle
+ * @note The value remains owned by the pool and is valid until the next
+ * operation on the pool
+ * @return On error return @p NULL
+ */
+const Temporal *
+expand_pool_get(const ExpandPool *pool, int handle)
+{
+  ExpandEntry *entry = expand_pool_entry(pool, handle);
+  return entry ? entry->temp : NULL;
+}
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Append an instant to a value of an expand pool, compacting the
+ * values whose last append is the oldest when the budget is exceeded
+ * @param[in,out] pool Expand pool
+ * @param[in] handle Handle
+ * @param[in] inst Temporal instant
+ * @param[in] maxdist Maximum distance for defining a gap
+ * @param[in] maxt Maximum time interval for defining a gap
+ * @return On error return false, in which case the value is left unchanged
+ * @see #temporal_append_tinstant
+ */
+bool
+expand_pool_append(ExpandPool *pool, int handle, const TInstant *inst,
+  double maxdist, const Interval *maxt)
+{
+  ExpandEntry *entry = expand_pool_entry(pool, handle);
+  if (! entry || ! ensure_not_null((void *) inst))
+    return false;
+
+  /* Reduce the growth of a quiet value whose sequence is full */
+  if (entry->quiet > 0 && entry->temp->subtype == TSEQUENCE &&
+      ((TSequence *) entry->temp)->count ==
+        ((TSequence *) entry->temp)->maxcount)
+    expand_entry_grow(pool, entry);
+
+  Temporal *temp = entry->temp;
+  Temporal *result = temporal_append_tinstant(temp, inst, maxdist,
+    (Interval *) maxt, true);
+  if (! result)
+    return false;
+  /* In expandable mode, a sequence is freed when it is copied into a larger
+   * one but not when the result is a sequence set */
+  if (temp->subtype == TSEQUENCE && result->subtype == TSEQUENCESET)
+    pfree(temp);
+  expand_entry_set(pool, entry, result);
+  entry->tick = ++pool->tick;
+  if (pool->slack > pool->maxslack)
+    expand_pool_compact(pool, pool->maxslack / 2);
+  return true;
+}
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Compact the values of an expand pool whose last append is the
+ * oldest until the total slack is at most a given size
+ * @param[in,out] pool Expand pool
+ * @param[in] maxslack Maximum total slack in bytes after the compaction
+ * @return Number of values compacted, on error return -1
+ */
+int
+expand_pool_compact(ExpandPool *pool, size_t maxslack)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pool))
+    return -1;
+  if (pool->slack <= maxslack)
+    return 0;
+
+  /* Sort the values with slack by logical time of their last append, each
+   * element of the array is a pair (tick, handle) */
+  uint64 *order = palloc(sizeof(uint64) * 2 * pool->count);
+  int n = 0;
+  for (int i = 0; i < pool->size; i++)
+  {
+    if (pool->entries[i].temp && pool->entries[i].slack > 0)
+    {
+      order[2 * n] = pool->entries[i].tick;
+      order[2 * n + 1] = (uint64) i;
+      n++;
+    }
+  }
+  qsort(order, (size_t) n, sizeof(uint64) * 2, &expand_tick_cmp);
+  int result = 0;
+  for (int i = 0; i < n && pool->slack > maxslack; i++)
+  {
+    expand_entry_compact(pool, &pool->entries[order[2 * i + 1]]);
+    result++;
+  }
+  pfree(order);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Remove a value from an expand pool
+ * @param[in,out] pool Expand pool
+ * @param[in] handle Handle
+ * @return Compacted value, whose ownership is transferred to the caller, on
+ * error return @p NULL
+ */
+Temporal *
+expand_pool_remove(ExpandPool *pool, int handle)
+{
+  ExpandEntry *entry = expand_pool_entry(pool, handle);
+  if (! entry)
+    return NULL;
+  Temporal *result = (entry->slack > 0) ?
+    temporal_compact(entry->temp) : entry->temp;
+  if (result != entry->temp)
+    pfree(entry->temp);
+  pool->slack -= entry->slack;
+  entry->temp = NULL;
+  entry->slack = 0;
+  entry->next = pool->freelist;
+  pool->freelist = handle;
+  pool->count--;
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Return the number of values of an expand pool
+ * @param[in] pool Expand pool
+ * @return On error return -1
+ */
+int
+expand_pool_count(const ExpandPool *pool)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pool))
+    return -1;
+  return pool->count;
+}
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Return the total slack in bytes of the values of an expand pool
+ * @param[in] pool Expand pool
+ * @return On error return 0
+ */
+size_t
+expand_pool_slack(const ExpandPool *pool)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) pool))
+    return 0;
+  return pool->slack;
+}
+
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Free an expand pool and its values
+ * @param[in] pool Expand pool
+ */
+void
+expand_pool_free(ExpandPool *pool)
+{
+  if (! pool)
+    return;
+  for (int i = 0; i < pool->size; i++)
+  {
+    if (pool->entries[i].temp)
+      pfree(pool->entries[i].temp);
+  }
+  pfree(pool->entries);
+  pfree(pool);
+  return;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,419 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Interval join of arrays of temporal values on the overlap of their
+ * time spans
+ * @details The join sorts the values of both arrays on the lower bound of
+ * their time span and sweeps them in this order, keeping for each array the
+ * list of the values whose time span may still overlap the next ones. A value
+ * is compared only with the active values of the other array, so that the
+ * cost of the join is proportional to the number of values plus the number
+ * of overlapping pairs rather than to the product of the number of values.
+ */
+
+/* PostgreSQL */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/span.h"
+#include "general/temporal.h"
+
+/**
+ * @brief Structure to represent a value of a join
+ */
+typedef struct
+{
+  Span span;                  /**< Time span of the value */
+  int idx;                    /**< Position of the value in its array */
+} join_entry;
+
+/**
+ * @brief Definition of the function testing the overlap of the bounding
+ * boxes of two values of a join
+ */
+typedef bool (*join_box_fn)(const void *box1, const void *box2);
+
+/**
+ * @brief Comparator of the values of a join on the lower bound of their span
+ */
+static int
+join_entry_cmp(const join_entry *e1, const join_entry *e2)
+{
+  return span_lower_cmp(&e1->span, &e2->span);
+}
+
+/**
+ * @brief Remove from a list of active values of the join those that end
+ * before a span, and report the pairs that the other value forms with the
+ * remaining ones
+ * @param[in] cur Value of the join
+ * @param[in] boxcur Bounding box of the value, may be @p NULL
+ * @param[in] entries Values of the other array
+ * @param[in] boxes Bounding boxes of the other array, may be @p NULL
+ * @param[in,out] active Positions of the active values in @p entries
+ * @param[in,out] nactive Number of active values
+ * @param[in] first True when the value belongs to the first array
+ * @param[in] boxfn Function testing the overlap of the bounding boxes
+ * @param[in] fn Function called for each pair
+ * @param[in] arg Argument of the function
+ * @param[in,out] count Number of pairs reported
+ * @return False when the function asked to stop the join
+ */
+static bool
+join_probe(const join_entry *cur, const bboxunion *boxcur,
+  const join_entry *entries, const bboxunion *boxes, int *active,
+  int *nactive, bool first, join_box_fn boxfn, meos_join_fn fn, void *arg,
+  int *count)
+{
+  TimestampTz lower = DatumGetTimestampTz(cur->span.lower);
+  int k = 0;
+  while (k < *nactive)
+  {
+    const join_entry *other = &entries[active[k]];
+    /* The following values start at or after the current one */
+    if (DatumGetTimestampTz(other->span.upper) < lower)
+    {
+      active[k] = active[--(*nactive)];
+      continue;
+    }
+    k++;
+    if (! overlaps_span_span(&cur->span, &other->span) ||
+        (boxfn && ! boxfn(boxcur, &boxes[other->idx])))
+      continue;
+    (*count)++;
+    if (! (first ? fn(cur->idx, other->idx, arg) :
+        fn(other->idx, cur->idx, arg)))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Sweep the sorted values of two arrays and report their overlapping
+ * pairs
+ * @return Number of pairs reported
+ */
+static int
+join_sweep(const join_entry *entries1, int count1, const bboxunion *boxes1,
+  const join_entry *entries2, int count2, const bboxunion *boxes2,
+  join_box_fn boxfn, meos_join_fn fn, void *arg)
+{
+  int *active1 = palloc(sizeof(int) * Max(count1, 1));
+  int *active2 = palloc(sizeof(int) * Max(count2, 1));
+  int nactive1 = 0, nactive2 = 0, count = 0;
+  int i = 0, j = 0;
+  while (i < count1 || j < count2)
+  {
+    /* The remaining values of an array can only overlap the active values
+     * of the other one */
+    if ((i == count1 && nactive1 == 0) || (j == count2 && nactive2 == 0))
+      break;
+    if (j == count2 ||
+        (i < count1 && join_entry_cmp(&entries1[i], &entries2[j]) <= 0))
+    {
+      const bboxunion *box = boxes1 ? &boxes1[entries1[i].idx] : NULL;
+      if (! join_probe(&entries1[i], box, entries2, boxes2, active2,
+          &nactive2, true, boxfn, fn, arg, &count))
+        break;
+      active1[nactive1++] = i++;
+    }
+    else
+    {
+      const bboxunion *box = boxes2 ? &boxes2[entries2[j].idx] : NULL;
+      if (! join_probe(&entries2[j], box, entries1, boxes1, active1,
+          &nactive1, false, boxfn, fn, arg, &count))
+        break;
+      active2[nactive2++] = j++;
+    }
+  }
+  pfree(active1); pfree(active2);
+  return count;
+}
+
+/**
+ * @brief Sort the values of an array for a join
+ * @return Number of values
+ */
+static int
+join_entries_sort(join_entry *entries, int count)
+{
+  qsort(entries, (size_t) count, sizeof(join_entry),
+    (qsort_comparator) &join_entry_cmp);
+  return count;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup meos_setspan_topo
+ * @brief Call a function for each pair of overlapping spans of two arrays of
+ * timestamptz spans
+ * @details The function receives the positions of the spans in their
+ * arrays and returns false to stop the join. The pairs are not reported in
+ * a particular order.
+ * @param[in] spans1,spans2 Arrays of spans
+ * @param[in] count1,count2 Number of spans of the arrays
+ * @param[in] fn Function called for each pair
+ * @param[in] arg Argument of the function
+ * @return Number of pairs reported, on error return -1
+ */
+int
+tstzspan_overlap_join(const Span *spans1, int count1, const Span *spans2,
+  int count2, meos_join_fn fn, void *arg)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) fn) || ! ensure_not_negative(count1) ||
+      ! ensure_not_negative(count2) ||
+      (count1 > 0 && ! ensure_not_null((void *) spans1)) ||
+      (count2 > 0 && ! ensure_not_null((void *) spans2)))
+    return -1;
+  for (int i = 0; i < count1; i++)
+    if (! ensure_span_isof_type(&spans1[i], T_TSTZSPAN))
+      return -1;
+  for (int i = 0; i < count2; i++)
+    if (! ensure_span_isof_type(&spans2[i], T_TSTZSPAN))
+      return -1;
+
+  join_entry *entries1 = palloc(sizeof(join_entry) * Max(count1, 1));
+  join_entry *entries2 = palloc(sizeof(join_entry) * Max(count2, 1));
+  for (int i = 0; i < count1; i++)
+  {
+    entries1[i].span = spans1[i];
+    entries1[i].idx = i;
+  }
+  for (int i = 0; i < count2; i++)
+  {
+    entries2[i].span = spans2[i];
+    entries2[i].idx = i;
+  }
+  join_entries_sort(entries1, count1);
+  join_entries_sort(entries2, count2);
+  int result = join_sweep(entries1, count1, NULL, entries2, count2, NULL,
+    NULL, fn, arg);
+  pfree(entries1); pfree(entries2);
+  return result;
+}
+
+/**
+ * @brief Collect the time spans and, if requested, the bounding boxes of an
+ * array of temporal values for a join, ignoring @p NULL values
+ * @return Number of values kept
+ */
+static int
+join_temporal_entries(const Temporal **temps, int count, bool spatial,
+  join_entry *entries, bboxunion *boxes)
+{
+  int n = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (! temps[i])
+      continue;
+    temporal_set_tstzspan(temps[i], &entries[n].span);
+    entries[n].idx = i;
+    if (boxes)
+    {
+      if (spatial)
+        temporal_set_bbox(temps[i], &boxes[i].g);
+      else
+        temporal_set_bbox(temps[i], &boxes[i].b);
+    }
+    n++;
+  }
+  return join_entries_sort(entries, n);
+}
+
+/**
+ * @brief Return true if the values of an array of temporal values are all
+ * spatial or all numbers, according to the argument
+ */
+static bool
+ensure_join_bbox_type(const Temporal **temps, int count, bool spatial)
+{
+  for (int i = 0; i < count; i++)
+  {
+    if (temps[i] && (spatial ? ! tspatial_type(temps[i]->temptype) :
+        ! tnumber_type(temps[i]->temptype)))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+        "The values of a join on bounding boxes must be all %s",
+        spatial ? "spatial" : "numbers");
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_bbox_topo
+ * @brief Call a function for each pair of values of two arrays of temporal
+ * values whose time spans overlap
+ * @details The function receives the positions of the values in their
+ * arrays and returns false to stop the join. The pairs are not reported in
+ * a particular order. When @p bbox is true, the pairs whose bounding boxes
+ * do not overlap are not reported either, which requires the values to be
+ * all temporal numbers or all spatiotemporal values. For example, the
+ * following code counts the pairs of trips and road closures whose
+ * bounding boxes overlap
+ * @code
+ * static bool
+ * count_pair(int i, int j, void *arg)
+ * {
+ *   (*(int *) arg)++;
+ *   return true;
+ * }
+ * ...
+ * int npairs = 0;
+ * temporal_overlap_join(trips, ntrips, closures, nclosures, true,
+ *   &count_pair, &npairs);
+ * @endcode
+ * @param[in] temps1,temps2 Arrays of temporal values, where @p NULL values
+ * are ignored
+ * @param[in] count1,count2 Number of values of the arrays
+ * @param[in] bbox True when the bounding boxes must also overlap
+ * @param[in] fn Function called for each pair
+ * @param[in] arg Argument of the function
+ * @return Number of pairs reported, on error return -1
+ */
+int
+temporal_overlap_join(const Temporal **temps1, int count1,
+  const Temporal **temps2, int count2, bool bbox, meos_join_fn fn, void *arg)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) fn) || ! ensure_not_negative(count1) ||
+      ! ensure_not_negative(count2) ||
+      (count1 > 0 && ! ensure_not_null((void *) temps1)) ||
+      (count2 > 0 && ! ensure_not_null((void *) temps2)))
+    return -1;
+
+  /* The first non-null value determines the type of the bounding boxes */
+  bool spatial = false;
+  join_box_fn boxfn = NULL;
+  if (bbox)
+  {
+    const Temporal *temp = NULL;
+    for (int i = 0; i < count1 && ! temp; i++)
+      temp = temps1[i];
+    for (int i = 0; i < count2 && ! temp; i++)
+      temp = temps2[i];
+    if (! temp)
+      return 0;
+    spatial = tspatial_type(temp->temptype);
+    if (! ensure_join_bbox_type(temps1, count1, spatial) ||
+        ! ensure_join_bbox_type(temps2, count2, spatial))
+      return -1;
+    boxfn = spatial ? (join_box_fn) &overlaps_stbox_stbox :
+      (join_box_fn) &overlaps_tbox_tbox;
+  }
+
+  join_entry *entries1 = palloc(sizeof(join_entry) * Max(count1, 1));
+  join_entry *entries2 = palloc(sizeof(join_entry) * Max(count2, 1));
+  bboxunion *boxes1 = bbox ? palloc(sizeof(bboxunion) * Max(count1, 1)) : NULL;
+  bboxunion *boxes2 = bbox ? palloc(sizeof(bboxunion) * Max(count2, 1)) : NULL;
+  int n1 = join_temporal_entries(temps1, count1, spatial, entries1, boxes1);
+  int n2 = join_temporal_entries(temps2, count2, spatial, entries2, boxes2);
+  int result = join_sweep(entries1, n1, boxes1, entries2, n2, boxes2, boxfn,
+    fn, arg);
+  pfree(entries1); pfree(entries2);
+  if (bbox)
+  {
+    pfree(boxes1); pfree(boxes2);
+  }
+  return result;
+}
+
+/**
+ * @brief Structure to collect the pairs of a join
+ */
+typedef struct
+{
+  int *pairs;                 /**< Positions of the values of the pairs */
+  int count;                  /**< Number of pairs */
+  int maxcount;               /**< Number of pairs allocated */
+} join_pairs;
+
+/**
+ * @brief Append a pair to the result of a join
+ */
+static bool
+join_pairs_append(int i, int j, void *arg)
+{
+  join_pairs *state = (join_pairs *) arg;
+  if (state->count == state->maxcount)
+  {
+    state->maxcount *= 2;
+    state->pairs = repalloc(state->pairs, sizeof(int) * 2 * state->maxcount);
+  }
+  state->pairs[2 * state->count] = i;
+  state->pairs[2 * state->count + 1] = j;
+  state->count++;
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_bbox_topo
+ * @brief Return the pairs of values of two arrays of temporal values whose
+ * time spans overlap
+ * @details The result is an array of @p 2 * count positions, where the
+ * positions @p 2k and @p 2k+1 are those of the values of the @p k-th pair in
+ * the first and the second array, respectively
+ * @param[in] temps1,temps2 Arrays of temporal values, where @p NULL values
+ * are ignored
+ * @param[in] count1,count2 Number of values of the arrays
+ * @param[in] bbox True when the bounding boxes must also overlap
+ * @param[out] count Number of pairs
+ * @return On error or when there are no pairs return @p NULL
+ * @see #temporal_overlap_join
+ */
+int *
+temporal_overlap_join_pairs(const Temporal **temps1, int count1,
+  const Temporal **temps2, int count2, bool bbox, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) count))
+    return NULL;
+  join_pairs state;
+  state.count = 0;
+  state.maxcount = 64;
+  state.pairs = palloc(sizeof(int) * 2 * state.maxcount);
+  int npairs = temporal_overlap_join(temps1, count1, temps2, count2, bbox,
+    &join_pairs_append, &state);
+  if (npairs <= 0)
+  {
+    pfree(state.pairs);
+    *count = 0;
+    return NULL;
+  }
+  *count = state.count;
+  return state.pairs;
+}
+
+/*****************************************************************************/
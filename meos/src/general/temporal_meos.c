@@ -34,12 +34,15 @@
 
 #include "general/temporal.h"
 
+/* C */
+#include <assert.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/set.h"
 #include "general/span.h"
 #include "general/spanset.h"
+#include "general/tinstant.h"
 
 /*****************************************************************************
  * Restriction Functions
@@ -381,6 +384,181 @@ tpoint_value_at_timestamptz(const Temporal *temp, TimestampTz t, bool strict,
 
 /*****************************************************************************/
 
+/**
+ * @brief Ensure that an array of timestamps is sorted in ascending order
+ */
+static bool
+ensure_sorted_timestamps(const TimestampTz *times, int count)
+{
+  for (int i = 1; i < count; i++)
+  {
+    if (times[i - 1] > times[i])
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The timestamps must be sorted in ascending order");
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Return in the last arguments the values of a temporal float or a
+ * temporal point at an array of timestamps as raw doubles
+ * @return On error return -1
+ */
+static int
+temporal_doubles_at_timestamps(const Temporal *temp, const TimestampTz *times,
+  int count, bool strict, const double *slopes, double *values, bool *found)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) times) || ! ensure_not_null((void *) values) ||
+      ! ensure_not_null((void *) found) || ! ensure_positive(count) ||
+      ! ensure_sorted_timestamps(times, count))
+    return -1;
+
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+    {
+      const TInstant *inst = (const TInstant *) temp;
+      int ndims = TEMPORAL_NDOUBLES(temp);
+      int result = 0;
+      for (int i = 0; i < count; i++)
+      {
+        found[i] = (times[i] == inst->t);
+        if (found[i])
+        {
+          tinstant_doubles(inst, ndims, &values[i * ndims]);
+          result++;
+        }
+      }
+      return result;
+    }
+    case TSEQUENCE:
+      return tsequence_doubles_at_timestamps((const TSequence *) temp, times,
+        count, strict, slopes, values, found);
+    default: /* TSEQUENCESET */
+      return tsequenceset_doubles_at_timestamps((const TSequenceSet *) temp,
+        times, count, strict, slopes, values, found);
+  }
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last arguments the values of a temporal float at an
+ * array of timestamptz values
+ * @details The function locates the timestamps in a single pass over the
+ * instants and does not construct a value for each timestamp, which makes
+ * it suitable for sampling a temporal value at a high rate, e.g., for
+ * aligning it to the timestamps of another sensor
+ * @param[in] temp Temporal value
+ * @param[in] times Array of timestamps sorted in ascending order
+ * @param[in] count Number of timestamps
+ * @param[in] strict True if the timestamps must belong to the temporal value,
+ * false when they may be at an exclusive bound
+ * @param[in] slopes Slopes of the segments as computed by
+ * #temporal_segment_slopes, may be NULL
+ * @param[out] values Array of @p count values, only set for the timestamps
+ * at which the temporal value is defined
+ * @param[out] found Array of @p count flags stating whether the temporal
+ * value is defined at the timestamps
+ * @return Number of timestamps at which the temporal value is defined,
+ * on error return -1
+ */
+int
+tfloat_values_at_timestamps(const Temporal *temp, const TimestampTz *times,
+  int count, bool strict, const double *slopes, double *values, bool *found)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_temporal_isof_type(temp, T_TFLOAT))
+    return -1;
+  return temporal_doubles_at_timestamps(temp, times, count, strict, slopes,
+    values, found);
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return in the last arguments the coordinates of a temporal point at
+ * an array of timestamptz values
+ * @details The function locates the timestamps in a single pass over the
+ * instants and does not construct a point for each timestamp. The
+ * coordinates of geography points are interpolated along the great circle.
+ * @param[in] temp Temporal value
+ * @param[in] times Array of timestamps sorted in ascending order
+ * @param[in] count Number of timestamps
+ * @param[in] strict True if the timestamps must belong to the temporal value,
+ * false when they may be at an exclusive bound
+ * @param[in] slopes Slopes of the segments as computed by
+ * #temporal_segment_slopes, may be NULL, ignored for geography points
+ * @param[out] coords Array of @p count times 2 or 3 coordinates, depending on
+ * whether the temporal point has Z dimension, only set for the timestamps at
+ * which the temporal point is defined
+ * @param[out] found Array of @p count flags stating whether the temporal
+ * point is defined at the timestamps
+ * @return Number of timestamps at which the temporal point is defined,
+ * on error return -1
+ */
+int
+tpoint_coords_at_timestamps(const Temporal *temp, const TimestampTz *times,
+  int count, bool strict, const double *slopes, double *coords, bool *found)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_tgeo_type(temp->temptype))
+    return -1;
+  return temporal_doubles_at_timestamps(temp, times, count, strict, slopes,
+    coords, found);
+}
+
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return the slopes of the segments of a temporal float or a temporal
+ * geometry point with linear interpolation
+ * @details The slopes are the variation per microsecond of the value, or of
+ * each coordinate, of the segments. Computing them once allows
+ * #tfloat_values_at_timestamps and #tpoint_coords_at_timestamps to
+ * interpolate each timestamp of repeated calls with a multiplication.
+ * @param[in] temp Temporal value
+ * @param[out] count Number of slopes
+ * @return On error return NULL
+ */
+double *
+temporal_segment_slopes(const Temporal *temp, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) count) ||
+      ! ensure_continuous(temp) || ! ensure_linear_interp(temp->flags))
+    return NULL;
+  if (temp->temptype != T_TFLOAT && temp->temptype != T_TGEOMPOINT)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The temporal value must be a temporal float or a temporal geometry point");
+    return NULL;
+  }
+
+  int ndims = TEMPORAL_NDOUBLES(temp);
+  double *result;
+  if (temp->subtype == TSEQUENCE)
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    *count = (seq->count - 1) * ndims;
+    result = palloc(sizeof(double) * Max(*count, 1));
+    tsequence_segment_slopes(seq, result);
+  }
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    *count = (ss->totalcount - ss->count) * ndims;
+    result = palloc(sizeof(double) * Max(*count, 1));
+    tsequenceset_segment_slopes(ss, result);
+  }
+  return result;
+}
+
+/*****************************************************************************/
+
 /**
  * @ingroup meos_temporal_restrict
  * @brief Return a temporal value restricted to its minimum base value
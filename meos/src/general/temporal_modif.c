@@ -63,6 +63,27 @@
  * Merge functions
  *****************************************************************************/
 
+/**
+ * @brief Merge an array of temporal instants sorted by timestamp
+ * @param[in,out] instants Array of temporal instants, the duplicates are
+ * removed in place
+ * @param[in] count Number of elements in the array
+ * @result Result value that can be either a temporal instant or a temporal
+ * discrete sequence
+ */
+static Temporal *
+tinstarr_merge_sorted(const TInstant **instants, int count)
+{
+  /* Ensure validity of the arguments, two instants may only have the same
+   * timestamp if they have the same value */
+  if (! ensure_valid_tinstarr(instants, count, MERGE, DISCRETE))
+    return NULL;
+  int newcount = tinstarr_remove_duplicates(instants, count);
+  return (newcount == 1) ? (Temporal *) tinstant_copy(instants[0]) :
+    (Temporal *) tsequence_make_exp1(instants, newcount, newcount, true,
+      true, DISCRETE, NORMALIZE_NO, NULL);
+}
+
 /**
  * @ingroup meos_internal_temporal_modif
  * @brief Merge two temporal instants
@@ -91,17 +112,9 @@ tinstant_merge_array(const TInstant **instants, int count)
 {
   assert(instants); assert(count > 1);
   tinstarr_sort((TInstant **) instants, count);
-  /* Ensure validity of the arguments and compute the bounding box */
-  if (! ensure_valid_tinstarr(instants, count, MERGE, DISCRETE))
-    return NULL;
-
   const TInstant **newinstants = palloc(sizeof(TInstant *) * count);
   memcpy(newinstants, instants, sizeof(TInstant *) * count);
-  int newcount = tinstarr_remove_duplicates(newinstants, count);
-  Temporal *result = (newcount == 1) ?
-    (Temporal *) tinstant_copy(newinstants[0]) :
-    (Temporal *) tsequence_make_exp1(newinstants, newcount, newcount, true,
-      true, DISCRETE, NORMALIZE_NO, NULL);
+  Temporal *result = tinstarr_merge_sorted(newinstants, count);
   pfree(newinstants);
   return result;
 }
@@ -127,7 +140,8 @@ tsequence_merge(const TSequence *seq1, const TSequence *seq2)
  * @brief Merge an array of temporal discrete sequences
  * @note The function does not assume that the values in the array are strictly
  * ordered on time, i.e., the intersection of the bounding boxes of two values
- * may be a period. For this reason two passes are necessary.
+ * may be a period. Since the instants of each sequence are sorted, they are
+ * merged with a k-way merge of the sequences.
  * @param[in] sequences Array of temporal sequences
  * @param[in] count Number of elements in the array
  * @result Result value that can be either a temporal instant or a temporal
@@ -137,21 +151,27 @@ Temporal *
 tdiscseq_merge_array(const TSequence **sequences, int count)
 {
   assert(sequences);
-  /* Validity test will be done in #tinstant_merge_array */
   /* Collect the composing instants */
   int totalcount = 0;
+  int *counts = palloc(sizeof(int) * count);
   for (int i = 0; i < count; i++)
-    totalcount += sequences[i]->count;
-  const TInstant **instants = palloc0(sizeof(TInstant *) * totalcount);
+  {
+    counts[i] = sequences[i]->count;
+    totalcount += counts[i];
+  }
+  const TInstant **instants = palloc(sizeof(TInstant *) * totalcount);
   int ninsts = 0;
   for (int i = 0; i < count; i++)
   {
     for (int j = 0; j < sequences[i]->count; j++)
       instants[ninsts++] = TSEQUENCE_INST_N(sequences[i], j);
   }
+  const TInstant **newinstants = palloc(sizeof(TInstant *) * totalcount);
+  tinstarr_merge_runs(instants, counts, count, newinstants);
+  pfree(instants); pfree(counts);
   /* Create the result */
-  Temporal *result = tinstant_merge_array(instants, totalcount);
-  pfree(instants);
+  Temporal *result = tinstarr_merge_sorted(newinstants, totalcount);
+  pfree(newinstants);
   return result;
 }
 
@@ -159,16 +179,17 @@ tdiscseq_merge_array(const TSequence **sequences, int count)
  * @brief Merge an array of temporal sequences
  * @param[in] sequences Array of values
  * @param[in] count Number of elements in the array
+ * @param[in] sorted True when the sequences are already sorted by period
  * @param[out] totalcount Number of elements in the resulting array
  * @result Array of merged sequences
  * @note The values in the array may overlap on a single instant.
  */
 static TSequence **
-tsequence_merge_array1(const TSequence **sequences, int count,
+tsequence_merge_array1(const TSequence **sequences, int count, bool sorted,
   int *totalcount)
 {
   assert(sequences); assert(totalcount);
-  if (count > 1)
+  if (count > 1 && ! sorted)
     tseqarr_sort((TSequence **) sequences, count);
   /* Test the validity of the composing sequences */
   const TSequence *seq1 = sequences[0];
@@ -227,7 +248,8 @@ tsequence_merge_array(const TSequence **sequences, int count)
 
   /* Continuous sequences */
   int totalcount;
-  TSequence **newseqs = tsequence_merge_array1(sequences, count, &totalcount);
+  TSequence **newseqs = tsequence_merge_array1(sequences, count, false,
+    &totalcount);
   Temporal *result;
   if (totalcount == 1)
   {
@@ -273,20 +295,30 @@ tsequenceset_merge_array(const TSequenceSet **seqsets, int count)
   assert(count > 0);
   /* Collect the composing sequences */
   int totalcount = 0;
+  int *counts = palloc(sizeof(int) * count);
   for (int i = 0; i < count; i++)
-    totalcount += seqsets[i]->count;
-  const TSequence **sequences = palloc0(sizeof(TSequence *) * totalcount);
+  {
+    counts[i] = seqsets[i]->count;
+    totalcount += counts[i];
+  }
+  const TSequence **sequences = palloc(sizeof(TSequence *) * totalcount);
   int nseqs = 0;
   for (int i = 0; i < count; i++)
   {
     for (int j = 0; j < seqsets[i]->count; j++)
       sequences[nseqs++] = TSEQUENCESET_SEQ_N(seqsets[i], j);
   }
+  /* The sequences of each sequence set are sorted, merge them with a k-way
+   * merge of the sequence sets */
+  const TSequence **sortedseqs = palloc(sizeof(TSequence *) * totalcount);
+  tseqarr_merge_runs(sequences, counts, count, sortedseqs);
+  pfree(sequences); pfree(counts);
   /* We cannot call directly #tsequence_merge_array since the result must be of
    * subtype TSEQUENCESET */
   int newcount;
-  TSequence **newseqs = tsequence_merge_array1(sequences, totalcount,
+  TSequence **newseqs = tsequence_merge_array1(sortedseqs, totalcount, true,
     &newcount);
+  pfree(sortedseqs);
   return tsequenceset_make_free(newseqs, newcount, NORMALIZE);
 }
 
@@ -584,7 +616,9 @@ tcontseq_insert(const TSequence *seq1, const TSequence *seq2)
   sequences[nseqs++] = (TSequence *) seq2;
 
   int count;
-  TSequence **newseqs = tsequence_merge_array1(sequences, nseqs, &count);
+  /* The sequences are ordered by construction */
+  TSequence **newseqs = tsequence_merge_array1(sequences, nseqs, true,
+    &count);
   Temporal *result;
   if (count == 1)
   {
@@ -1511,18 +1545,99 @@ temporal_delete_tstzspanset(const Temporal *temp, const SpanSet *ss,
  ****************************************************************************/
 
 /**
- * @ingroup meos_internal_temporal_modif
+ * @brief Return a copy of a temporal sequence with room for @p maxcount
+ * instants to which an instant is appended
+ * @details The composing instants of the sequence are copied as a single
+ * block, since the offsets are relative to the start of the instants and thus
+ * remain valid. In expandable mode the space reserved for the instants is at
+ * least doubled so that successive appends are amortized in constant time.
+ * @param[in] seq Temporal sequence
+ * @param[in] inst Temporal instant
+ * @param[in] count Number of instants of the result, which is equal to
+ * the number of instants of the sequence when the new instant replaces the
+ * last one through normalization
+ * @param[in] maxcount Maximum number of instants of the result
+ * @param[in] bbox Bounding box of the result
+ * @param[in] expand True when reserving space for additional instants
+ */
+static TSequence *
+tsequence_append_exp(const TSequence *seq, const TInstant *inst, int count,
+  int maxcount, const bboxunion *bbox, bool expand)
+{
+  assert(count >= 2); assert(maxcount >= count);
+  /* Size of the fixed part of the sequence, up to the offsets array */
+  size_t hdrsize = (char *) TSEQUENCE_OFFSETS_PTR(seq) - (char *) seq;
+  if (MEOS_FLAGS_GET_FIXED(seq->flags))
+  {
+    size_t stride = (TSEQUENCE_OFFSETS_PTR(seq))[0];
+    if (DOUBLE_PAD(VARSIZE(inst)) != stride)
+    {
+      /* The new instant cannot be stored at the stride of the sequence */
+      const TInstant **instants = palloc(sizeof(TInstant *) * count);
+      for (int i = 0; i < count - 1; i++)
+        instants[i] = TSEQUENCE_INST_N(seq, i);
+      instants[count - 1] = inst;
+      TSequence *result = tsequence_make_exp1(instants, count, maxcount,
+        seq->period.lower_inc, true, MEOS_FLAGS_GET_INTERP(seq->flags),
+        NORMALIZE_NO, (void *) bbox);
+      pfree(instants);
+      return result;
+    }
+    size_t pos = stride * (count - 1);
+    size_t memsize = hdrsize + sizeof(size_t) + stride * maxcount;
+    /* Copy the fixed part, the stride, and the composing instants */
+    TSequence *result = palloc0(memsize);
+    memcpy(result, seq, hdrsize);
+    SET_VARSIZE(result, memsize);
+    result->count = count;
+    result->maxcount = maxcount;
+    memcpy(TSEQUENCE_BBOX_PTR(result), bbox, seq->bboxsize);
+    (TSEQUENCE_OFFSETS_PTR(result))[0] = stride;
+    char *data = (char *) TSEQUENCE_OFFSETS_PTR(result) + sizeof(size_t);
+    memcpy(data, TSEQUENCE_INST_N(seq, 0), pos);
+    memcpy(data + pos, inst, VARSIZE(inst));
+    return result;
+  }
+  size_t oldinsts = VARSIZE(seq) - hdrsize - sizeof(size_t) * seq->maxcount;
+  /* Size of the composing instants kept from the sequence */
+  const TInstant *last = TSEQUENCE_INST_N(seq, count - 2);
+  size_t pos = (TSEQUENCE_OFFSETS_PTR(seq))[count - 2] +
+    DOUBLE_PAD(VARSIZE(last));
+  size_t insts_size = pos + DOUBLE_PAD(VARSIZE(inst));
+  if (expand && insts_size < oldinsts * 2)
+    insts_size = oldinsts * 2;
+  size_t memsize = hdrsize + sizeof(size_t) * maxcount + insts_size;
+
+  /* Copy the fixed part, the offsets, and the composing instants */
+  TSequence *result = palloc0(memsize);
+  memcpy(result, seq, hdrsize);
+  SET_VARSIZE(result, memsize);
+  result->count = count;
+  result->maxcount = maxcount;
+  memcpy(TSEQUENCE_BBOX_PTR(result), bbox, seq->bboxsize);
+  size_t *offsets = TSEQUENCE_OFFSETS_PTR(result);
+  memcpy(offsets, TSEQUENCE_OFFSETS_PTR(seq), sizeof(size_t) * (count - 1));
+  offsets[count - 1] = pos;
+  char *data = (char *) offsets + sizeof(size_t) * maxcount;
+  memcpy(data, TSEQUENCE_INST_N(seq, 0), pos);
+  memcpy(data + pos, inst, VARSIZE(inst));
+  return result;
+}
+
+/**
  * @brief Append an instant to a temporal sequence accounting for potential gaps
  * @param[in,out] seq Temporal sequence
  * @param[in] inst Temporal instant
  * @param[in] maxdist Maximum distance for defining a gap
  * @param[in] maxt Maximum time interval for defining a gap
  * @param[in] expand True when reserving space for additional instants
- * @csqlfn #Temporal_append_tinstant()
+ * @param[in] free_seq True when the sequence is freed when it is copied into
+ * a larger one in expandable mode, false when it is a composing sequence of
+ * a sequence set
  */
-Temporal *
-tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
-  const Interval *maxt, bool expand)
+static Temporal *
+tsequence_append_tinstant1(TSequence *seq, const TInstant *inst,
+  double maxdist, const Interval *maxt, bool expand, bool free_seq)
 {
   assert(seq); assert(inst); assert(seq->temptype == inst->temptype);
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
@@ -1539,6 +1654,12 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
    * account inclusive/exclusive bounds */
   if (last->t > inst->t)
   {
+    /* Do not format the timestamps if the message is not used */
+    if (meos_error_quiet())
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE, "");
+      return NULL;
+    }
     str1 = pg_timestamptz_out(last->t);
     char *str2 = pg_timestamptz_out(inst->t);
     meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
@@ -1556,6 +1677,11 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
     {
       if (! eqv1v)
       {
+        if (meos_error_quiet())
+        {
+          meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE, "");
+          return NULL;
+        }
         str1 = pg_timestamptz_out(last->t);
         meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
           "The temporal values have different value at their common timestamp %s",
@@ -1563,8 +1689,9 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
         pfree(str1);
         return NULL;
       }
-      /* Do not add the new instant if new instant is equal to be last one */
-      return (Temporal *) tsequence_copy(seq);
+      /* Do not add the new instant if new instant is equal to be last one,
+       * in expandable mode the sequence is returned unchanged */
+      return expand ? (Temporal *) seq : (Temporal *) tsequence_copy(seq);
     }
     /* Exclusive upper bound and different value => result is a sequence set */
     else if (interp == LINEAR && ! eqv1v)
@@ -1608,6 +1735,8 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
         expand ? 64 : 1, true, true, interp, NORMALIZE_NO);
       TSequenceSet *result = tsequenceset_make_exp(
         (const TSequence **) sequences, 2, expand ? 64 : 2, NORMALIZE_NO);
+      if (sequences[0] != seq)
+        pfree(sequences[0]);
       pfree(sequences[1]);
       return (Temporal *) result;
     }
@@ -1635,6 +1764,10 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
   {
     /* Determine whether there is enough available space */
     size_t size = DOUBLE_PAD(VARSIZE(inst));
+    /* The instants of a fixed-stride sequence must have the same size */
+    if (MEOS_FLAGS_GET_FIXED(seq->flags) &&
+        size != (TSEQUENCE_OFFSETS_PTR(seq))[0])
+      break;
     /* Get the last instant to keep. It is either the last instant or the
      * penultimate one if the last one is redundant through normalization */
     last = (TInstant *) TSEQUENCE_INST_N(seq, count - 2);
@@ -1650,8 +1783,9 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
     if (count != seq->count)
     {
       /* Update the offsets array and the count when adding one instant */
-      (TSEQUENCE_OFFSETS_PTR(seq))[count - 1] =
-        (TSEQUENCE_OFFSETS_PTR(seq))[count - 2] + size_last;
+      if (! MEOS_FLAGS_GET_FIXED(seq->flags))
+        (TSEQUENCE_OFFSETS_PTR(seq))[count - 1] =
+          (TSEQUENCE_OFFSETS_PTR(seq))[count - 2] + size_last;
       seq->count++;
     }
     memcpy(new, inst, VARSIZE(inst));
@@ -1662,10 +1796,6 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
 
   /* This is the first time we use an expandable structure or there is no more
    * free space */
-  const TInstant **instants = palloc(sizeof(TInstant *) * count);
-  for (int i = 0; i < count - 1; i++)
-    instants[i] = TSEQUENCE_INST_N(seq, i);
-  instants[count - 1] = inst;
   int maxcount;
   if (expand)
   {
@@ -1681,22 +1811,42 @@ tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
   else
     maxcount = count;
 
-  /* Get the bounding box size */
+  /* Expand the bounding box of the sequence with the new instant */
   size_t bboxsize = DOUBLE_PAD(temporal_bbox_size(seq->temptype));
   bboxunion bbox, bbox1;
   memcpy(&bbox, TSEQUENCE_BBOX_PTR(seq), bboxsize);
   tinstant_set_bbox(inst, &bbox1);
   bbox_expand(&bbox1, &bbox, seq->temptype);
-  TSequence *result = tsequence_make_exp1(instants, count, maxcount,
-    seq->period.lower_inc, true, interp, NORMALIZE_NO, &bbox);
-  pfree(instants);
+  TSequence *result = tsequence_append_exp(seq, inst, count, maxcount, &bbox,
+    expand);
 #if MEOS
-  if (expand)
+  if (expand && free_seq)
     pfree(seq);
 #endif /* MEOS */
   return (Temporal *) result;
 }
 
+/**
+ * @ingroup meos_internal_temporal_modif
+ * @brief Append an instant to a temporal sequence accounting for potential gaps
+ * @details In expandable mode, the result is either the sequence itself, in
+ * which the instant has been appended in place, a new sequence, in which case
+ * the sequence has been freed, or a new sequence set when there is a gap, in
+ * which case the sequence is left unchanged
+ * @param[in,out] seq Temporal sequence
+ * @param[in] inst Temporal instant
+ * @param[in] maxdist Maximum distance for defining a gap
+ * @param[in] maxt Maximum time interval for defining a gap
+ * @param[in] expand True when reserving space for additional instants
+ * @csqlfn #Temporal_append_tinstant()
+ */
+Temporal *
+tsequence_append_tinstant(TSequence *seq, const TInstant *inst, double maxdist,
+  const Interval *maxt, bool expand)
+{
+  return tsequence_append_tinstant1(seq, inst, maxdist, maxt, expand, true);
+}
+
 /**
  * @ingroup meos_internal_temporal_modif
  * @brief Append a sequence to a temporal sequence
@@ -1789,10 +1939,13 @@ tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst,
 {
   assert(ss); assert(inst);
   assert(ss->temptype == inst->temptype);
-  /* Append the instant to the last sequence */
+  /* Append the instant to the last sequence, which cannot be freed since it
+   * is stored in the sequence set */
   TSequence *last = (TSequence *) TSEQUENCESET_SEQ_N(ss, ss->count - 1);
-  Temporal *temp = tsequence_append_tinstant(last, inst, maxdist, maxt,
-    expand);
+  Temporal *temp = tsequence_append_tinstant1(last, inst, maxdist, maxt,
+    expand, false);
+  if (! temp)
+    return NULL;
   /* The result may be a single sequence or a sequence set with 2 sequences */
   TSequence *seq1 = NULL, *seq2 = NULL;
   TSequenceSet *ss1 = NULL;
@@ -1847,6 +2000,9 @@ tsequenceset_append_tinstant(TSequenceSet *ss, const TInstant *inst,
     tsequenceset_expand_bbox(ss, (TSequence *) seq1);
     if (temp->subtype == TSEQUENCESET)
       tsequenceset_expand_bbox(ss, seq2);
+    /* The sequence(s) have been copied into the sequence set */
+    if ((void *) TSEQUENCESET_SEQ_N(ss, ss->count - 1) != (void *) temp)
+      pfree(temp);
     return ss;
   }
 
@@ -2047,7 +2203,9 @@ temporal_append_tinstant(Temporal *temp, const TInstant *inst, double maxdist,
       TSequence *seq = tinstant_to_tsequence((const TInstant *) temp, interp);
       Temporal *result = (Temporal *) tsequence_append_tinstant(seq, inst,
         maxdist, maxt, expand);
-      pfree(seq);
+      /* In expandable mode the sequence may have been freed or returned */
+      if (! expand || ! result || result->subtype == TSEQUENCESET)
+        pfree(seq);
       return result;
     }
     case TSEQUENCE:
@@ -2059,6 +2217,37 @@ temporal_append_tinstant(Temporal *temp, const TInstant *inst, double maxdist,
   }
 }
 
+#if MEOS
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return in the last argument the result of appending an instant to a
+ * temporal value, or return the error code if the arguments are invalid
+ * @details Contrary to #temporal_append_tinstant, an invalid argument does
+ * not call the error handler nor formats the error message, which enables
+ * the application to discard invalid records at a low cost. The temporal
+ * value is left unchanged on error.
+ * @param[in,out] temp Temporal value
+ * @param[in] inst Temporal instant
+ * @param[in] maxdist Maximum distance for defining a gap
+ * @param[in] maxt Maximum time interval for defining a gap
+ * @param[in] expand True when reserving space for additional instants
+ * @param[out] result Resulting temporal value, NULL on error
+ * @return #MEOS_SUCCESS or the error code
+ */
+int
+temporal_append_tinstant_try(Temporal *temp, const TInstant *inst,
+  double maxdist, Interval *maxt, bool expand, Temporal **result)
+{
+  bool quiet = meos_error_quiet_set(true);
+  int last_errno = meos_errno_reset();
+  *result = temporal_append_tinstant(temp, inst, maxdist, maxt, expand);
+  meos_error_quiet_set(quiet);
+  if (*result)
+    return meos_errno_restore(last_errno);
+  return meos_errno() ? meos_errno() : meos_errno_set(MEOS_ERR_INTERNAL_ERROR);
+}
+#endif /* MEOS */
+
 /**
  * @ingroup meos_temporal_modif
  * @brief Append a sequence to a temporal value
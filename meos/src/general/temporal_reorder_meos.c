@@ -0,0 +1,329 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+
+/**
+ * @file
+ * @brief Assembly of a temporal sequence from a stream of instants that may
+ * arrive out of order
+ * @details A reorder state keeps the most recent instants in a small buffer
+ * sorted by timestamp. An instant is appended to the sequence when it falls
+ * out of the lateness window, i.e., when its timestamp is before the latest
+ * timestamp received minus the lateness, or when the buffer is full. The
+ * instants arriving after their position in the sequence has been emitted
+ * are collected in a second buffer, which is merged with the sequence in a
+ * single pass when it is full or when the assembly is finished, so that
+ * each late instant does not require to rebuild the sequence.
+ */
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+#include "general/temporal_tile.h"
+#include "general/type_util.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/** Default number of instants of the buffers */
+#define TREORDER_MAXINSTS 64
+/** Initial number of instants of the sequence */
+#define TREORDER_MAXCOUNT 64
+
+/**
+ * @brief Structure to represent the state of the assembly of a sequence
+ * from a stream of instants that may arrive out of order
+ */
+struct ReorderState
+{
+  int64 lateness;          /**< Lateness window in PostgreSQL time units */
+  int maxinsts;            /**< Maximum number of instants of the buffers */
+  interpType interp;       /**< Interpolation of the sequence */
+  meosType temptype;       /**< Temporal type, T_UNKNOWN before the first
+                                instant */
+  TimestampTz watermark;   /**< Latest timestamp received */
+  TSequence *seq;          /**< Expandable sequence of the emitted instants */
+  int count;               /**< Number of instants in the buffer */
+  TInstant **buffer;       /**< Buffer of instants sorted by timestamp */
+  int nlate;               /**< Number of late instants */
+  TInstant **late;         /**< Buffer of late instants */
+};
+
+/*****************************************************************************/
+
+/**
+ * @brief Append an instant to the sequence of the state
+ * @return On error return false
+ */
+static bool
+treorder_emit(ReorderState *state, const TInstant *inst)
+{
+  if (! state->seq)
+  {
+    state->seq = tsequence_make_exp((const TInstant **) &inst, 1,
+      TREORDER_MAXCOUNT, true, true, state->interp, NORMALIZE_NO);
+    return state->seq != NULL;
+  }
+  Temporal *result = tsequence_append_tinstant(state->seq, inst, 0.0, NULL,
+    true);
+  if (! result)
+    return false;
+  /* Without gaps and with inclusive bounds the result is a sequence */
+  assert(result->subtype == TSEQUENCE);
+  /* When the result is a new sequence the previous one has been freed */
+  state->seq = (TSequence *) result;
+  return true;
+}
+
+/**
+ * @brief Merge the late instants with the sequence of the state
+ * @return On error return false, e.g., when a late instant has a different
+ * value than the instant of the sequence at the same timestamp
+ */
+static bool
+treorder_merge_late(ReorderState *state)
+{
+  if (state->nlate == 0)
+    return true;
+  tinstarr_sort(state->late, state->nlate);
+  meosType basetype = temptype_basetype(state->temptype);
+  int count = state->seq->count;
+  const TInstant **instants = palloc(sizeof(TInstant *) *
+    (count + state->nlate));
+  int i = 0, j = 0, k = 0;
+  bool result = true;
+  while (i < count || j < state->nlate)
+  {
+    const TInstant *inst;
+    if (j == state->nlate || (i < count &&
+        TSEQUENCE_INST_N(state->seq, i)->t <= state->late[j]->t))
+      inst = TSEQUENCE_INST_N(state->seq, i++);
+    else
+      inst = state->late[j++];
+    /* Keep only one of the instants with the same timestamp */
+    if (k > 0 && instants[k - 1]->t == inst->t)
+    {
+      if (! datum_eq(tinstant_val(instants[k - 1]), tinstant_val(inst),
+          basetype))
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "The temporal values have different value at their common timestamp");
+        result = false;
+        break;
+      }
+      continue;
+    }
+    instants[k++] = inst;
+  }
+  if (result)
+  {
+    TSequence *seq = tsequence_make_exp(instants, k,
+      Max(k * 2, TREORDER_MAXCOUNT), true, true, state->interp, NORMALIZE);
+    if (seq)
+    {
+      pfree(state->seq);
+      state->seq = seq;
+    }
+    else
+      result = false;
+  }
+  pfree(instants);
+  /* The late instants are discarded on error */
+  for (i = 0; i < state->nlate; i++)
+    pfree(state->late[i]);
+  state->nlate = 0;
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return a new state for assembling a temporal sequence from a stream
+ * of instants that may arrive out of order
+ * @param[in] lateness Maximum delay of an instant with respect to the latest
+ * one received for which the instant is inserted at a low cost
+ * @param[in] maxinsts Maximum number of instants kept in the buffers, 0 for
+ * the default
+ * @param[in] interp Interpolation of the sequence
+ * @see #treorder_state_push
+ */
+ReorderState *
+treorder_state_make(const Interval *lateness, int maxinsts, interpType interp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) lateness) ||
+      ! ensure_valid_duration(lateness) || ! ensure_not_negative(maxinsts))
+    return NULL;
+  if (interp != DISCRETE && interp != STEP && interp != LINEAR)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid interpolation for the sequence");
+    return NULL;
+  }
+
+  ReorderState *result = palloc0(sizeof(ReorderState));
+  result->lateness = interval_units(lateness);
+  result->maxinsts = maxinsts ? maxinsts : TREORDER_MAXINSTS;
+  result->interp = interp;
+  result->temptype = T_UNKNOWN;
+  result->watermark = DT_NOBEGIN;
+  result->buffer = palloc(sizeof(TInstant *) * (result->maxinsts + 1));
+  result->late = palloc(sizeof(TInstant *) * result->maxinsts);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Add an instant to the sequence of a reorder state
+ * @details The instant is kept in the buffer and appended to the sequence
+ * once it falls out of the lateness window. An instant with a timestamp
+ * before the last instant appended is merged with the sequence together
+ * with the other late instants.
+ * @param[in,out] state Reorder state
+ * @param[in] inst Temporal instant
+ * @return On error return false, for example, when the instant has a
+ * different value than a buffered instant with the same timestamp
+ */
+bool
+treorder_state_push(ReorderState *state, const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) inst) ||
+      ! ensure_temporal_isof_subtype((Temporal *) inst, TINSTANT))
+    return false;
+  if (state->temptype == T_UNKNOWN)
+    state->temptype = inst->temptype;
+  else if (state->temptype != inst->temptype)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The instants must be of the same temporal type");
+    return false;
+  }
+  const Temporal *first = state->count > 0 ? (Temporal *) state->buffer[0] :
+    (Temporal *) state->seq;
+  if (first && ! ensure_spatial_validity(first, (Temporal *) inst))
+    return false;
+
+  /* Instant later than the lateness window */
+  if (state->seq &&
+      inst->t <= TSEQUENCE_INST_N(state->seq, state->seq->count - 1)->t)
+  {
+    state->late[state->nlate++] = tinstant_copy(inst);
+    if (state->nlate == state->maxinsts)
+      return treorder_merge_late(state);
+    return true;
+  }
+
+  /* Insert the instant in the sorted buffer, the instants arrive in order in
+   * most cases, so the position is searched from the end */
+  int i = state->count;
+  while (i > 0 && state->buffer[i - 1]->t > inst->t)
+    i--;
+  if (i > 0 && state->buffer[i - 1]->t == inst->t)
+  {
+    if (datum_eq(tinstant_val(state->buffer[i - 1]), tinstant_val(inst),
+        temptype_basetype(inst->temptype)))
+      return true;
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The temporal values have different value at their common timestamp");
+    return false;
+  }
+  memmove(&state->buffer[i + 1], &state->buffer[i],
+    sizeof(TInstant *) * (state->count - i));
+  state->buffer[i] = tinstant_copy(inst);
+  state->count++;
+  if (inst->t > state->watermark)
+    state->watermark = inst->t;
+
+  /* Emit the instants out of the lateness window */
+  int n = 0;
+  while (n < state->count && (state->count - n > state->maxinsts ||
+      state->buffer[n]->t < state->watermark - state->lateness))
+    n++;
+  bool result = true;
+  for (i = 0; i < n; i++)
+  {
+    if (result && ! treorder_emit(state, state->buffer[i]))
+      result = false;
+    pfree(state->buffer[i]);
+  }
+  if (n > 0)
+  {
+    memmove(&state->buffer[0], &state->buffer[n],
+      sizeof(TInstant *) * (state->count - n));
+    state->count -= n;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return the sequence of a reorder state after appending the buffered
+ * instants and merging the late instants, and free the state
+ * @param[in] state Reorder state
+ * @return Return NULL if no instant was added or on error
+ */
+TSequence *
+treorder_state_finish(ReorderState *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return NULL;
+
+  bool valid = true;
+  for (int i = 0; i < state->count; i++)
+  {
+    if (valid && ! treorder_emit(state, state->buffer[i]))
+      valid = false;
+    pfree(state->buffer[i]);
+  }
+  if (valid && state->seq)
+    valid = treorder_merge_late(state);
+  for (int i = 0; i < state->nlate; i++)
+    pfree(state->late[i]);
+  TSequence *result = NULL;
+  if (valid && state->seq)
+  {
+    result = (state->seq->count < state->seq->maxcount) ?
+      tsequence_compact(state->seq) : state->seq;
+    if (result != state->seq)
+      pfree(state->seq);
+  }
+  else if (state->seq)
+    pfree(state->seq);
+  pfree(state->buffer); pfree(state->late);
+  pfree(state);
+  return result;
+}
+
+/*****************************************************************************/
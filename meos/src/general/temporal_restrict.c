@@ -131,20 +131,12 @@ tnumber_bbox_restrict_span(const Temporal *temp, const Span *s)
  *****************************************************************************/
 
 /**
- * @ingroup meos_internal_temporal_restrict
  * @brief Restrict a temporal value to (the complement of) a base value
- * @param[in] temp Temporal value
- * @param[in] value Value
- * @param[in] atfunc True if the restriction is at, false for minus
- * @note This function does a bounding box test for the temporal types
- * different from instant. The singleton tests are done in the functions for
- * the specific temporal types.
- * @csqlfn #Temporal_at_value(), #Temporal_minus_value()
  */
-Temporal *
-temporal_restrict_value(const Temporal *temp, Datum value, bool atfunc)
+static Temporal *
+temporal_restrict_value_dispatch(const Temporal *temp, Datum value,
+  bool atfunc)
 {
-  assert(temp);
   /* Ensure validity of the arguments */
   if (tgeo_type(temp->temptype))
   {
@@ -184,6 +176,27 @@ temporal_restrict_value(const Temporal *temp, Datum value, bool atfunc)
   }
 }
 
+/**
+ * @ingroup meos_internal_temporal_restrict
+ * @brief Restrict a temporal value to (the complement of) a base value
+ * @param[in] temp Temporal value
+ * @param[in] value Value
+ * @param[in] atfunc True if the restriction is at, false for minus
+ * @note This function does a bounding box test for the temporal types
+ * different from instant. The singleton tests are done in the functions for
+ * the specific temporal types.
+ * @csqlfn #Temporal_at_value(), #Temporal_minus_value()
+ */
+Temporal *
+temporal_restrict_value(const Temporal *temp, Datum value, bool atfunc)
+{
+  assert(temp);
+  Temporal *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_RESTRICTION,
+    result = temporal_restrict_value_dispatch(temp, value, atfunc));
+  return result;
+}
+
 /*****************************************************************************/
 
 /**
@@ -495,17 +508,13 @@ temporal_restrict_tstzset(const Temporal *temp, const Set *s, bool atfunc)
 /*****************************************************************************/
 
 /**
- * @ingroup meos_internal_temporal_restrict
  * @brief Restrict a temporal value to (the complement of) a timestamptz span
- * @param[in] temp Temporal value
- * @param[in] s Span
- * @param[in] atfunc True if the restriction is at, false for minus
- * @csqlfn #Temporal_at_tstzspan(), #Temporal_minus_tstzspan()
+ * according to its subtype
  */
-Temporal *
-temporal_restrict_tstzspan(const Temporal *temp, const Span *s, bool atfunc)
+static Temporal *
+temporal_restrict_tstzspan_dispatch(const Temporal *temp, const Span *s,
+  bool atfunc)
 {
-  assert(temp); assert(s);
   assert(temptype_subtype(temp->subtype));
   switch (temp->subtype)
   {
@@ -520,6 +529,24 @@ temporal_restrict_tstzspan(const Temporal *temp, const Span *s, bool atfunc)
   }
 }
 
+/**
+ * @ingroup meos_internal_temporal_restrict
+ * @brief Restrict a temporal value to (the complement of) a timestamptz span
+ * @param[in] temp Temporal value
+ * @param[in] s Span
+ * @param[in] atfunc True if the restriction is at, false for minus
+ * @csqlfn #Temporal_at_tstzspan(), #Temporal_minus_tstzspan()
+ */
+Temporal *
+temporal_restrict_tstzspan(const Temporal *temp, const Span *s, bool atfunc)
+{
+  assert(temp); assert(s);
+  Temporal *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_RESTRICTION,
+    result = temporal_restrict_tstzspan_dispatch(temp, s, atfunc));
+  return result;
+}
+
 /*****************************************************************************/
 
 /**
@@ -1170,6 +1197,20 @@ tcontseq_restrict_value(const TSequence *seq, Datum value, bool atfunc)
 
 /*****************************************************************************/
 
+/**
+ * @brief Return the position of the first value of a set that is greater
+ * than or equal to a value
+ */
+static int
+set_lower_loc(const Set *s, Datum value)
+{
+  int loc;
+  if (! set_find_value(s, value, &loc) && loc < s->count &&
+      datum_lt(SET_VAL_N(s, loc), value, s->basetype))
+    loc++;
+  return loc;
+}
+
 /**
  * @brief Restrict a temporal sequence to an array of base values (iterator
  * function)
@@ -1203,25 +1244,56 @@ tsequence_at_values_iter(const TSequence *seq, const Set *set,
   if (! temporal_bbox_restrict_set((Temporal *) seq, set))
     return 0;
 
-  /* General case */
+  /* General case
+   * Each segment is only restricted to the values of the set that it can
+   * take, which are found by binary search since the set is ordered. The
+   * values are visited in the direction of the segment, so that the
+   * resulting sequences are produced in time order and need not be sorted */
   interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  meosType basetype = temptype_basetype(seq->temptype);
   inst1 = TSEQUENCE_INST_N(seq, 0);
   bool lower_inc = seq->period.lower_inc;
-  int nseqs = 0;
+  int nseqs = 0, loc;
   for (int i = 1; i < seq->count; i++)
   {
     inst2 = TSEQUENCE_INST_N(seq, i);
     bool upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-    for (int j = 0; j < set->count; j++)
-      /* Each iteration adds between 0 and 2 sequences */
-      nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
-        upper_inc, SET_VAL_N(set, j), REST_AT, &result[nseqs]);
+    Datum value1 = tinstant_val(inst1);
+    Datum value2 = tinstant_val(inst2);
+    int cmp = datum_cmp(value1, value2, basetype);
+    if (interp == STEP || cmp == 0)
+    {
+      /* The segment only takes the values of its bounds, the one of the
+       * start instant comes first */
+      if (set_find_value(set, value1, &loc))
+        nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
+          upper_inc, value1, REST_AT, &result[nseqs]);
+      if (cmp != 0 && upper_inc && set_find_value(set, value2, &loc))
+        nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
+          upper_inc, value2, REST_AT, &result[nseqs]);
+    }
+    else if (cmp < 0)
+    {
+      /* Increasing segment: visit the values in [value1, value2] upwards */
+      for (int j = set_lower_loc(set, value1); j < set->count &&
+          datum_le(SET_VAL_N(set, j), value2, basetype); j++)
+        nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
+          upper_inc, SET_VAL_N(set, j), REST_AT, &result[nseqs]);
+    }
+    else
+    {
+      /* Decreasing segment: visit the values in [value2, value1] downwards */
+      int first = set_lower_loc(set, value2), last = first;
+      while (last < set->count &&
+          datum_le(SET_VAL_N(set, last), value1, basetype))
+        last++;
+      for (int j = last - 1; j >= first; j--)
+        nseqs += tsegment_restrict_value(inst1, inst2, interp, lower_inc,
+          upper_inc, SET_VAL_N(set, j), REST_AT, &result[nseqs]);
+    }
     inst1 = inst2;
     lower_inc = true;
   }
-  if (nseqs > 1)
-    tseqarr_sort(result, nseqs);
-
   return nseqs;
 }
 
@@ -2369,75 +2441,199 @@ tcontseq_minus_tstzset(const TSequence *seq, const Set *s)
 /*****************************************************************************/
 
 /**
- * @brief Restrict a continuous temporal sequence to a timestamptz span
+ * @brief Initialize a view of a continuous temporal sequence restricted to a
+ * timestamptz span
+ * @details The view references the instants of the sequence that are strictly
+ * inside the intersecting period and only allocates the instants at the
+ * bounds of the period, so that accessors and aggregates over the
+ * restriction do not need to copy the composing instants. The view must be
+ * released with #tsequenceview_free
+ * @param[in] seq Temporal sequence
+ * @param[in] s Span
+ * @param[out] view Sequence view
+ * @return False if the sequence and the span do not intersect
  */
-TSequence *
-tcontseq_at_tstzspan(const TSequence *seq, const Span *s)
+bool
+tcontseq_at_tstzspan_view(const TSequence *seq, const Span *s,
+  TSequenceView *view)
 {
-  assert(seq); assert(s);
+  assert(seq); assert(s); assert(view);
   /* Bounding box test */
-  Span inter;
-  if (! inter_span_span(&seq->period, s, &inter))
-    return NULL;
+  if (! inter_span_span(&seq->period, s, &view->period))
+    return false;
 
+  view->seq = seq;
+  view->start = view->end = NULL;
   /* Instantaneous sequence */
   if (seq->count == 1)
-    return tsequence_copy(seq);
+  {
+    view->period = seq->period;
+    view->first = view->last = 0;
+    return true;
+  }
 
-  /* General case */
-  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  TSequence *result;
   /* Intersecting period is instantaneous */
-  if (inter.lower == inter.upper)
+  TimestampTz lower = DatumGetTimestampTz(view->period.lower);
+  TimestampTz upper = DatumGetTimestampTz(view->period.upper);
+  if (lower == upper)
   {
-    TInstant *inst = tcontseq_at_timestamptz(seq, inter.lower);
-    result = tinstant_to_tsequence(inst, interp);
-    pfree(inst);
-    return result;
+    view->start = tcontseq_at_timestamptz(seq, lower);
+    view->first = 0; view->last = -1;
+    return true;
   }
 
-  const TInstant *inst1, *inst2;
-  int n = tcontseq_find_timestamptz(seq, inter.lower);
+  /* General case */
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  int n = tcontseq_find_timestamptz(seq, lower);
   /* If the lower bound of the intersecting period is exclusive */
   if (n == -1)
     n = 0;
-  TInstant **instants = palloc(sizeof(TInstant *) * (seq->count - n));
   /* Compute the value at the beginning of the intersecting period */
-  inst1 = TSEQUENCE_INST_N(seq, n);
-  inst2 = TSEQUENCE_INST_N(seq, n + 1);
-  instants[0] = tsegment_at_timestamptz(inst1, inst2, interp, inter.lower);
-  int ninsts = 1;
-  for (int i = n + 2; i < seq->count; i++)
-  {
-    /* If the end of the intersecting period is between inst1 and inst2 */
-    if (inst1->t <= DatumGetTimestampTz(inter.upper) &&
-        DatumGetTimestampTz(inter.upper) <= inst2->t)
-      break;
-
-    inst1 = inst2;
-    inst2 = TSEQUENCE_INST_N(seq, i);
-    /* If the intersecting period contains inst1 */
-    if (DatumGetTimestampTz(inter.lower) <= inst1->t &&
-        inst1->t <= DatumGetTimestampTz(inter.upper))
-      instants[ninsts++] = (TInstant *) inst1;
-  }
+  view->start = tsegment_at_timestamptz(TSEQUENCE_INST_N(seq, n),
+    TSEQUENCE_INST_N(seq, n + 1), interp, lower);
+  /* The instants strictly inside the intersecting period */
+  int m = n + 1;
+  while (TSEQUENCE_INST_N(seq, m)->t < upper)
+    m++;
+  view->first = n + 1;
+  view->last = m - 1;
   /* The last two values of sequences with step interpolation and
    * exclusive upper bound must be equal */
-  if (interp == LINEAR || inter.upper_inc)
-    instants[ninsts++] = tsegment_at_timestamptz(inst1, inst2, interp,
-      inter.upper);
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, m - 1);
+  if (interp == LINEAR || view->period.upper_inc)
+    view->end = tsegment_at_timestamptz(inst1, TSEQUENCE_INST_N(seq, m),
+      interp, upper);
   else
+    view->end = tinstant_make(tinstant_val(inst1), seq->temptype, upper);
+  return true;
+}
+
+/**
+ * @brief Return the number of instants of a sequence view
+ */
+int
+tsequenceview_count(const TSequenceView *view)
+{
+  assert(view);
+  return (view->start ? 1 : 0) + (view->last - view->first + 1) +
+    (view->end ? 1 : 0);
+}
+
+/**
+ * @brief Return the n-th instant of a sequence view
+ * @param[in] view Sequence view
+ * @param[in] n Position, starting from 0
+ */
+const TInstant *
+tsequenceview_inst_n(const TSequenceView *view, int n)
+{
+  assert(view); assert(n >= 0 && n < tsequenceview_count(view));
+  if (view->start)
   {
-    Datum value = tinstant_val(instants[ninsts - 1]);
-    instants[ninsts++] = tinstant_make(value, seq->temptype, inter.upper);
+    if (n == 0)
+      return view->start;
+    n--;
   }
+  if (n <= view->last - view->first)
+    return TSEQUENCE_INST_N(view->seq, view->first + n);
+  return view->end;
+}
+
+/**
+ * @brief Return a temporal sequence from a sequence view
+ */
+TSequence *
+tsequenceview_make(const TSequenceView *view)
+{
+  assert(view);
+  int count = tsequenceview_count(view);
+  const TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = tsequenceview_inst_n(view, i);
   /* Since by definition the sequence is normalized it is not necessary to
    * normalize the projection of the sequence to the period */
-  result = tsequence_make((const TInstant **) instants, ninsts,
-    inter.lower_inc, inter.upper_inc, interp, NORMALIZE_NO);
+  TSequence *result = tsequence_make(instants, count, view->period.lower_inc,
+    view->period.upper_inc, MEOS_FLAGS_GET_INTERP(view->seq->flags),
+    NORMALIZE_NO);
+  pfree(instants);
+  return result;
+}
 
-  pfree(instants[0]); pfree(instants[ninsts - 1]); pfree(instants);
+/**
+ * @brief Free the instants allocated by a sequence view
+ */
+void
+tsequenceview_free(TSequenceView *view)
+{
+  assert(view);
+  if (view->start)
+    pfree(view->start);
+  if (view->end)
+    pfree(view->end);
+  view->start = view->end = NULL;
+  return;
+}
 
+/**
+ * @brief Return the integral (area under the curve) of a view of a temporal
+ * number sequence
+ * @see #tnumberseq_integral
+ */
+double
+tnumberseqview_integral(const TSequenceView *view)
+{
+  assert(view); assert(tnumber_type(view->seq->temptype));
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(view->seq->flags);
+  meosType basetype = temptype_basetype(view->seq->temptype);
+  int count = tsequenceview_count(view);
+  double result = 0;
+  const TInstant *inst1 = tsequenceview_inst_n(view, 0);
+  for (int i = 1; i < count; i++)
+  {
+    const TInstant *inst2 = tsequenceview_inst_n(view, i);
+    double value1 = datum_double(tinstant_val(inst1), basetype);
+    if (linear)
+    {
+      double value2 = datum_double(tinstant_val(inst2), basetype);
+      result += (value1 + value2) * (double) (inst2->t - inst1->t) / 2.0;
+    }
+    else
+      result += value1 * (double) (inst2->t - inst1->t);
+    inst1 = inst2;
+  }
+  return result;
+}
+
+/**
+ * @brief Return the time-weighted average of a view of a temporal number
+ * sequence
+ * @see #tnumbercontseq_twavg
+ */
+double
+tnumberseqview_twavg(const TSequenceView *view)
+{
+  assert(view); assert(tnumber_type(view->seq->temptype));
+  double duration = (double) (DatumGetTimestampTz(view->period.upper) -
+    DatumGetTimestampTz(view->period.lower));
+  if (duration == 0.0)
+    /* Instantaneous view */
+    return datum_double(tinstant_val(tsequenceview_inst_n(view, 0)),
+      temptype_basetype(view->seq->temptype));
+  return tnumberseqview_integral(view) / duration;
+}
+
+/**
+ * @brief Restrict a continuous temporal sequence to a timestamptz span
+ */
+TSequence *
+tcontseq_at_tstzspan(const TSequence *seq, const Span *s)
+{
+  assert(seq); assert(s);
+  TSequenceView view;
+  if (! tcontseq_at_tstzspan_view(seq, s, &view))
+    return NULL;
+  TSequence *result = tsequenceview_make(&view);
+  tsequenceview_free(&view);
   return result;
 }
 
@@ -2860,7 +3056,13 @@ tsequenceset_restrict_timestamptz(const TSequenceSet *ss, TimestampTz t,
     /* At most one composing sequence can be split into two */
     TSequence **sequences = palloc(sizeof(TSequence *) * (ss->count + 1));
     int i, nseqs = 0;
-    for (i = 0; i < ss->count; i++)
+    /* The sequences before the one located by binary search do not contain
+     * the timestamp and are copied */
+    int loc;
+    tsequenceset_find_timestamptz(ss, t, &loc);
+    for (i = 0; i < loc; i++)
+      sequences[nseqs++] = tsequence_copy(TSEQUENCESET_SEQ_N(ss, i));
+    for (i = loc; i < ss->count; i++)
     {
       seq = TSEQUENCESET_SEQ_N(ss, i);
       nseqs += tcontseq_minus_timestamp_iter(seq, t, &sequences[nseqs]);
@@ -2941,8 +3143,13 @@ tsequenceset_restrict_tstzset(const TSequenceSet *ss, const Set *s,
       {
         if (t <= DatumGetTimestampTz(seq->period.lower))
           i++;
+        /* Locate by binary search the sequence of the timestamp */
         if (t >= DatumGetTimestampTz(seq->period.upper))
-          j++;
+        {
+          int loc;
+          tsequenceset_find_timestamptz(ss, t, &loc);
+          j = Max(j + 1, loc);
+        }
       }
     }
     return (Temporal *) tsequence_make_free(instants, count, true, true,
@@ -3003,10 +3210,14 @@ tsequenceset_restrict_tstzspan(const TSequenceSet *ss, const Span *s,
   if (atfunc)
   {
     /* AT */
-    int loc;
+    int loc, loc_upper;
     tsequenceset_find_timestamptz(ss, DatumGetTimestampTz(s->lower), &loc);
     /* We are sure that loc < ss->count due to the bounding period test above */
-    TSequence **sequences = palloc(sizeof(TSequence *) * (ss->count - loc));
+    tsequenceset_find_timestamptz(ss, DatumGetTimestampTz(s->upper),
+      &loc_upper);
+    loc_upper = Min(loc_upper, ss->count - 1);
+    TSequence **sequences = palloc(sizeof(TSequence *) *
+      (loc_upper - loc + 1));
     TSequence *tofree[2];
     int nseqs = 0, nfree = 0;
     for (int i = loc; i < ss->count; i++)
@@ -3088,7 +3299,7 @@ tsequenceset_restrict_tstzspanset(const TSequenceSet *ss, const SpanSet *ps,
     TimestampTz t = Max(DatumGetTimestampTz(ss->period.lower),
       DatumGetTimestampTz(ps->span.lower));
     tsequenceset_find_timestamptz(ss, t, &i);
-    spanset_find_value(ps, DatumGetTimestampTz(t), &j);
+    spanset_find_value(ps, TimestampTzGetDatum(t), &j);
     sequences = palloc(sizeof(TSequence *) * (ss->count + ps->count - i - j));
   }
   else
@@ -3100,10 +3311,20 @@ tsequenceset_restrict_tstzspanset(const TSequenceSet *ss, const SpanSet *ps,
     /* The sequence and the period do not overlap */
     if (lf_span_span(&seq->period, s))
     {
-      if (! atfunc)
+      if (atfunc)
+      {
+        /* Locate by binary search the next sequence overlapping the span */
+        int loc;
+        tsequenceset_find_timestamptz(ss, DatumGetTimestampTz(s->lower),
+          &loc);
+        i = Max(i + 1, loc);
+      }
+      else
+      {
         /* Copy the sequence */
         sequences[nseqs++] = tsequence_copy(seq);
-      i++;
+        i++;
+      }
     }
     else if (over_span_span(&seq->period, s))
     {
@@ -3136,7 +3357,12 @@ tsequenceset_restrict_tstzspanset(const TSequenceSet *ss, const SpanSet *ps,
       }
     }
     else
-      j++;
+    {
+      /* Locate by binary search the next span overlapping the sequence */
+      int loc;
+      spanset_find_value(ps, seq->period.lower, &loc);
+      j = Max(j + 1, loc);
+    }
   }
   if (! atfunc)
   {
@@ -0,0 +1,373 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+
+/**
+ * @file
+ * @brief Assembly of the trips of many concurrent moving objects from a
+ * stream of observations with a bounded memory
+ * @details A session state keeps in a hash table, for each object
+ * identifier, the expandable sequence of its open trip. The observations
+ * are appended to the open trip of their object, which is closed when the
+ * time or distance gap between two consecutive observations exceeds the
+ * thresholds of the state. The closed trips are sent to a callback function
+ * that takes the ownership of them. When the open trips exceed the memory
+ * budget of the state, the largest or the oldest ones, i.e., the ones whose
+ * last observation is the earliest, are sent to the callback function until
+ * the open trips use at most 90% of the budget.
+ */
+
+/* C */
+#include <assert.h>
+/* PostgreSQL */
+#include <postgres.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/pg_types.h"
+#include "general/temporal.h"
+
+/** Default initial number of instants of the open trips */
+#define TSESSION_MAXCOUNT 64
+
+/**
+ * @brief Structure to represent an entry of the hash table of open trips
+ */
+typedef struct
+{
+  int64 id;                /**< Object identifier (hashtable key) */
+  TSequence *trip;         /**< Expandable sequence of the open trip */
+  char status;             /* hash status */
+} tsession_entry;
+
+/**
+ * @brief Define a hashtable mapping object identifiers to open trips
+ */
+#define SH_PREFIX tsessiontable
+#define SH_ELEMENT_TYPE tsession_entry
+#define SH_KEY_TYPE int64
+#define SH_KEY id
+#define SH_HASH_KEY(tb, key) pg_hashint8(key)
+#define SH_EQUAL(tb, a, b) ((a) == (b))
+#define SH_RAW_ALLOCATOR palloc0
+#define SH_SCOPE static inline
+#define SH_DEFINE
+#define SH_DECLARE
+#include "lib/simplehash.h"
+
+/**
+ * @brief Structure to represent the state of the assembly of trips
+ */
+struct SessionState
+{
+  double maxdist;          /**< Maximum distance defining a gap */
+  Interval *maxt;          /**< Maximum time interval defining a gap */
+  interpType interp;       /**< Interpolation of the trips */
+  size_t memlimit;         /**< Memory budget of the open trips */
+  tsessionEvict evict;     /**< Eviction policy */
+  int maxcount;            /**< Initial number of instants of the trips */
+  tsession_flush_fn flush; /**< Function receiving the closed trips */
+  void *arg;               /**< Argument passed to the function */
+  meosType temptype;       /**< Temporal type, T_UNKNOWN before the first
+                                observation */
+  size_t memsize;          /**< Memory used by the open trips */
+  tsessiontable_hash *table; /**< Hash table of the open trips */
+};
+
+/*****************************************************************************/
+
+/**
+ * @brief Send an open trip to the callback function and remove it from the
+ * state
+ */
+static void
+tsession_close(SessionState *state, tsession_entry *entry,
+  tsessionFlush reason)
+{
+  TSequence *trip = entry->trip;
+  int64 id = entry->id;
+  state->memsize -= VARSIZE(trip);
+  tsessiontable_delete_item(state->table, entry);
+  /* Release the free space reserved for the expandable sequence */
+  if (trip->count < trip->maxcount)
+  {
+    TSequence *compact = tsequence_compact(trip);
+    pfree(trip);
+    trip = compact;
+  }
+  state->flush(id, trip, reason, state->arg);
+  return;
+}
+
+/**
+ * @brief Return a new open trip from an observation
+ */
+static TSequence *
+tsession_open(const SessionState *state, const TInstant *inst)
+{
+  return tsequence_make_exp((const TInstant **) &inst, 1, state->maxcount,
+    true, true, state->interp, NORMALIZE_NO);
+}
+
+/**
+ * @brief Close the open trips according to the eviction policy until the
+ * open trips use at most 90% of the memory budget
+ */
+static void
+tsession_evict(SessionState *state)
+{
+  size_t target = state->memlimit / 10 * 9;
+  while (state->memsize > target)
+  {
+    tsession_entry *victim = NULL;
+    tsessiontable_iterator iter;
+    tsession_entry *entry;
+    tsessiontable_start_iterate(state->table, &iter);
+    while ((entry = tsessiontable_iterate(state->table, &iter)) != NULL)
+    {
+      if (! victim ||
+          (state->evict == TSESSION_EVICT_LARGEST &&
+            VARSIZE(entry->trip) > VARSIZE(victim->trip)) ||
+          (state->evict == TSESSION_EVICT_OLDEST &&
+            DatumGetTimestampTz(entry->trip->period.upper) <
+              DatumGetTimestampTz(victim->trip->period.upper)))
+        victim = entry;
+    }
+    if (! victim)
+      break;
+    tsession_close(state, victim, TSESSION_EVICT);
+  }
+  return;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return a new state for assembling the trips of many concurrent
+ * moving objects from a stream of observations
+ * @param[in] opts Options of the assembly
+ * @see #tsession_state_push
+ */
+SessionState *
+tsession_state_make(const tsessionOptions *opts)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) opts) ||
+      ! ensure_not_null((void *) opts->flush) ||
+      ! ensure_not_negative_datum(Float8GetDatum(opts->maxdist), T_FLOAT8) ||
+      ! ensure_not_negative(opts->maxcount))
+    return NULL;
+  if (opts->interp != DISCRETE && opts->interp != STEP &&
+      opts->interp != LINEAR)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid interpolation for the trips");
+    return NULL;
+  }
+
+  SessionState *result = palloc0(sizeof(SessionState));
+  result->maxdist = opts->maxdist;
+  if (opts->maxt)
+  {
+    result->maxt = palloc(sizeof(Interval));
+    memcpy(result->maxt, opts->maxt, sizeof(Interval));
+  }
+  result->interp = opts->interp;
+  result->memlimit = opts->memlimit;
+  result->evict = opts->evict;
+  result->maxcount = opts->maxcount ? opts->maxcount : TSESSION_MAXCOUNT;
+  result->flush = opts->flush;
+  result->arg = opts->arg;
+  result->temptype = T_UNKNOWN;
+  /* Arbitrary initialization to 256 objects */
+  result->table = tsessiontable_create(256, NULL);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Append an observation to the open trip of an object
+ * @details The trip is closed and sent to the callback function when the
+ * observation is separated from the last one of the trip by a gap, in which
+ * case the observation starts a new trip. The trips that exceed the memory
+ * budget are closed afterwards.
+ * @param[in,out] state State of the assembly
+ * @param[in] id Object identifier
+ * @param[in] inst Observation
+ * @return On error return false, e.g., when the observation is not after
+ * the last one of the trip, in which case the trip is left unchanged
+ */
+bool
+tsession_state_push(SessionState *state, int64 id, const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) inst) ||
+      ! ensure_temporal_isof_subtype((Temporal *) inst, TINSTANT))
+    return false;
+  if (state->temptype == T_UNKNOWN)
+    state->temptype = inst->temptype;
+  else if (state->temptype != inst->temptype)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The observations must be of the same temporal type");
+    return false;
+  }
+
+  bool found;
+  tsession_entry *entry = tsessiontable_insert(state->table, id, &found);
+  if (! found)
+  {
+    /* First observation of the object */
+    entry->trip = tsession_open(state, inst);
+    if (! entry->trip)
+    {
+      tsessiontable_delete_item(state->table, entry);
+      return false;
+    }
+    state->memsize += VARSIZE(entry->trip);
+  }
+  else
+  {
+    TSequence *trip = entry->trip;
+    size_t size = VARSIZE(trip);
+    Temporal *result = tsequence_append_tinstant(trip, inst, state->maxdist,
+      state->maxt, true);
+    if (! result)
+      return false;
+    if (result->subtype == TSEQUENCE)
+    {
+      /* The observation was appended, possibly into a new sequence, in which
+       * case the previous one has been freed */
+      entry->trip = (TSequence *) result;
+      state->memsize += VARSIZE(result) - size;
+    }
+    else
+    {
+      /* There is a gap: close the trip and start a new one */
+      pfree(result);
+      TSequence *newtrip = tsession_open(state, inst);
+      if (! newtrip)
+        return false;
+      tsession_close(state, entry, TSESSION_GAP);
+      entry = tsessiontable_insert(state->table, id, &found);
+      entry->trip = newtrip;
+      state->memsize += VARSIZE(newtrip);
+    }
+  }
+
+  if (state->memlimit && state->memsize > state->memlimit)
+    tsession_evict(state);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Close the open trips whose last observation is before a timestamp
+ * @param[in,out] state State of the assembly
+ * @param[in] t Timestamp
+ * @return Number of trips closed, -1 on error
+ */
+int
+tsession_state_flush_idle(SessionState *state, TimestampTz t)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return -1;
+
+  int result = 0;
+  tsessiontable_iterator iter;
+  tsession_entry *entry;
+  tsessiontable_start_iterate(state->table, &iter);
+  /* The current entry may be deleted during the iteration */
+  while ((entry = tsessiontable_iterate(state->table, &iter)) != NULL)
+  {
+    if (DatumGetTimestampTz(entry->trip->period.upper) < t)
+    {
+      tsession_close(state, entry, TSESSION_IDLE);
+      result++;
+    }
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return the number of open trips of the state
+ * @param[in] state State of the assembly
+ * @return On error return -1
+ */
+int
+tsession_state_count(const SessionState *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return -1;
+  return (int) state->table->members;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return the memory in bytes used by the open trips of the state
+ * @param[in] state State of the assembly
+ */
+size_t
+tsession_state_memsize(const SessionState *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return 0;
+  return state->memsize;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Close all the open trips and free the state
+ * @param[in] state State of the assembly
+ */
+void
+tsession_state_finish(SessionState *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return;
+
+  tsessiontable_iterator iter;
+  tsession_entry *entry;
+  tsessiontable_start_iterate(state->table, &iter);
+  while ((entry = tsessiontable_iterate(state->table, &iter)) != NULL)
+    tsession_close(state, entry, TSESSION_FINISH);
+  tsessiontable_destroy(state->table);
+  if (state->maxt)
+    pfree(state->maxt);
+  pfree(state);
+  return;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,681 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief In-memory store of temporal values with a time index and a spatial
+ * index
+ * @details The values of a store are kept in an expand pool, so that
+ * instants can be appended to them without copying them at each append. The
+ * store has two indexes, which are rebuilt on the first query following a
+ * modification of the store.
+ * - The time index contains the time span of each sequence of the values,
+ *   sorted by their lower bound and grouped in blocks that keep the largest
+ *   upper bound of their spans, so that a query only scans the blocks that
+ *   may contain spans overlapping its period.
+ * - The spatial index is an R-tree bulk loaded with the Sort-Tile-Recursive
+ *   (STR) algorithm over the boxes obtained by @p tpoint_stboxes from the
+ *   temporal points of the store.
+ *
+ * The queries return the handles of the values, which are accessed without
+ * copy with #tstore_view.
+ */
+
+/* C */
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/doublen.h"
+#include "general/span.h"
+#include "general/temporal.h"
+
+/** Number of spans of a block of the time index */
+#define STORE_TIME_BLOCK 32
+/** Number of children of a node of the spatial index */
+#define STORE_FANOUT 16
+/** Maximum number of levels of the spatial index */
+#define STORE_MAX_LEVELS 16
+/** Maximum number of boxes of a temporal point in the spatial index */
+#define STORE_MAX_BOXES 16
+
+/**
+ * @brief Structure to represent an entry of the time index of a store
+ */
+typedef struct
+{
+  Span period;                /**< Time span of a sequence of the value */
+  int handle;                 /**< Handle of the value */
+} store_time_entry;
+
+/**
+ * @brief Structure to represent a node of the spatial index of a store
+ * @details The nodes of the leaf level are the boxes of the values, for
+ * which @p first is the handle of the value and @p count is 0
+ */
+typedef struct
+{
+  STBox box;                  /**< Bounding box of the node */
+  int first;                  /**< First child in the level below */
+  int count;                  /**< Number of children */
+} store_node;
+
+/**
+ * @brief Structure to represent a store of temporal values
+ */
+struct TStore
+{
+  ExpandPool *pool;           /**< Values of the store */
+  int maxhandle;              /**< One more than the largest handle */
+  bool dirty;                 /**< True when the indexes must be rebuilt */
+  int ntimes;                 /**< Number of entries of the time index */
+  store_time_entry *times;    /**< Entries of the time index */
+  TimestampTz *blockmax;      /**< Largest upper bound of each block */
+  int nlevels;                /**< Number of levels of the spatial index */
+  int nnodes[STORE_MAX_LEVELS]; /**< Number of nodes of each level */
+  store_node *levels[STORE_MAX_LEVELS]; /**< Nodes of each level, the leaf
+                                             level being the first one */
+};
+
+/*****************************************************************************
+ * Index construction
+ *****************************************************************************/
+
+/**
+ * @brief Comparator of the entries of the time index of a store
+ */
+static int
+store_time_cmp(const store_time_entry *e1, const store_time_entry *e2)
+{
+  return span_lower_cmp(&e1->period, &e2->period);
+}
+
+/**
+ * @brief Comparator of the nodes of the spatial index of a store on the
+ * center of their X extent
+ */
+static int
+store_node_xcmp(const store_node *n1, const store_node *n2)
+{
+  double c1 = n1->box.xmin + n1->box.xmax, c2 = n2->box.xmin + n2->box.xmax;
+  return (c1 < c2) ? -1 : (c1 > c2) ? 1 : 0;
+}
+
+/**
+ * @brief Comparator of the nodes of the spatial index of a store on the
+ * center of their Y extent
+ */
+static int
+store_node_ycmp(const store_node *n1, const store_node *n2)
+{
+  double c1 = n1->box.ymin + n1->box.ymax, c2 = n2->box.ymin + n2->box.ymax;
+  return (c1 < c2) ? -1 : (c1 > c2) ? 1 : 0;
+}
+
+/**
+ * @brief Free the indexes of a store
+ */
+static void
+store_index_free(TStore *store)
+{
+  if (store->times)
+    pfree(store->times);
+  if (store->blockmax)
+    pfree(store->blockmax);
+  for (int i = 0; i < store->nlevels; i++)
+    pfree(store->levels[i]);
+  store->times = NULL;
+  store->blockmax = NULL;
+  store->ntimes = store->nlevels = 0;
+  return;
+}
+
+/**
+ * @brief Build the time index of a store
+ */
+static void
+store_time_build(TStore *store)
+{
+  int maxcount = 64, n = 0;
+  store_time_entry *times = palloc(sizeof(store_time_entry) * maxcount);
+  for (int h = 0; h < store->maxhandle; h++)
+  {
+    const Temporal *temp = expand_pool_get(store->pool, h);
+    if (! temp)
+      continue;
+    int nseqs = (temp->subtype == TSEQUENCESET) ?
+      ((const TSequenceSet *) temp)->count : 1;
+    if (n + nseqs > maxcount)
+    {
+      while (n + nseqs > maxcount)
+        maxcount *= 2;
+      times = repalloc(times, sizeof(store_time_entry) * maxcount);
+    }
+    for (int i = 0; i < nseqs; i++)
+    {
+      times[n].period = (temp->subtype == TSEQUENCESET) ?
+        TSEQUENCESET_SEQ_N((const TSequenceSet *) temp, i)->period :
+        ((const TSequence *) temp)->period;
+      times[n++].handle = h;
+    }
+  }
+  qsort(times, (size_t) n, sizeof(store_time_entry),
+    (qsort_comparator) &store_time_cmp);
+
+  int nblocks = (n + STORE_TIME_BLOCK - 1) / STORE_TIME_BLOCK;
+  TimestampTz *blockmax = palloc(sizeof(TimestampTz) * Max(nblocks, 1));
+  for (int b = 0; b < nblocks; b++)
+  {
+    int to = Min((b + 1) * STORE_TIME_BLOCK, n);
+    TimestampTz max = DT_NOBEGIN;
+    for (int i = b * STORE_TIME_BLOCK; i < to; i++)
+      max = Max(max, DatumGetTimestampTz(times[i].period.upper));
+    blockmax[b] = max;
+  }
+  store->times = times;
+  store->ntimes = n;
+  store->blockmax = blockmax;
+  return;
+}
+
+/**
+ * @brief Sort the nodes of a level of the spatial index of a store with the
+ * Sort-Tile-Recursive algorithm
+ * @details The nodes are sorted on X, cut into vertical slices of
+ * @p sqrt(n / fanout) groups of nodes, and each slice is sorted on Y, so that
+ * the consecutive groups of @p fanout nodes are the nodes of the level above
+ */
+static void
+store_str_sort(store_node *nodes, int count)
+{
+  qsort(nodes, (size_t) count, sizeof(store_node),
+    (qsort_comparator) &store_node_xcmp);
+  int ngroups = (count + STORE_FANOUT - 1) / STORE_FANOUT;
+  int nslices = (int) ceil(sqrt((double) ngroups));
+  int slice = nslices * STORE_FANOUT;
+  for (int i = 0; i < count; i += slice)
+    qsort(&nodes[i], (size_t) Min(slice, count - i), sizeof(store_node),
+      (qsort_comparator) &store_node_ycmp);
+  return;
+}
+
+/**
+ * @brief Build the spatial index of a store
+ */
+static void
+store_space_build(TStore *store)
+{
+  int maxcount = 64, n = 0;
+  store_node *leaves = palloc(sizeof(store_node) * maxcount);
+  for (int h = 0; h < store->maxhandle; h++)
+  {
+    const Temporal *temp = expand_pool_get(store->pool, h);
+    if (! temp || ! tgeo_type(temp->temptype))
+      continue;
+    int nboxes;
+    STBox *boxes = tpoint_stboxes(temp, STORE_MAX_BOXES, &nboxes);
+    if (! boxes)
+      continue;
+    if (n + nboxes > maxcount)
+    {
+      while (n + nboxes > maxcount)
+        maxcount *= 2;
+      leaves = repalloc(leaves, sizeof(store_node) * maxcount);
+    }
+    for (int i = 0; i < nboxes; i++)
+    {
+      leaves[n].box = boxes[i];
+      leaves[n].first = h;
+      leaves[n++].count = 0;
+    }
+    pfree(boxes);
+  }
+  if (n == 0)
+  {
+    pfree(leaves);
+    return;
+  }
+
+  /* Pack the levels from the leaves up to the root */
+  store_node *nodes = leaves;
+  int count = n;
+  store->nlevels = 0;
+  while (true)
+  {
+    store->levels[store->nlevels] = nodes;
+    store->nnodes[store->nlevels++] = count;
+    if (count == 1 || store->nlevels == STORE_MAX_LEVELS)
+      break;
+    store_str_sort(nodes, count);
+    int nparents = (count + STORE_FANOUT - 1) / STORE_FANOUT;
+    store_node *parents = palloc(sizeof(store_node) * nparents);
+    for (int i = 0; i < nparents; i++)
+    {
+      parents[i].first = i * STORE_FANOUT;
+      parents[i].count = Min(STORE_FANOUT, count - parents[i].first);
+      parents[i].box = nodes[parents[i].first].box;
+      for (int j = 1; j < parents[i].count; j++)
+        stbox_expand(&nodes[parents[i].first + j].box, &parents[i].box);
+    }
+    nodes = parents;
+    count = nparents;
+  }
+  return;
+}
+
+/**
+ * @brief Rebuild the indexes of a store if it was modified since the last
+ * query
+ */
+static void
+store_index_build(TStore *store)
+{
+  if (! store->dirty)
+    return;
+  store_index_free(store);
+  store_time_build(store);
+  store_space_build(store);
+  store->dirty = false;
+  return;
+}
+
+/*****************************************************************************
+ * Index search
+ *****************************************************************************/
+
+/**
+ * @brief Mark the handles of the values of a store that have a sequence
+ * whose time span overlaps a span
+ */
+static void
+store_time_search(const TStore *store, const Span *s, bool *found)
+{
+  /* First entry whose lower bound is after the upper bound of the span */
+  TimestampTz lower = DatumGetTimestampTz(s->lower);
+  TimestampTz upper = DatumGetTimestampTz(s->upper);
+  int lo = 0, hi = store->ntimes;
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (DatumGetTimestampTz(store->times[mid].period.lower) <= upper)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  for (int b = 0; b * STORE_TIME_BLOCK < lo; b++)
+  {
+    if (store->blockmax[b] < lower)
+      continue;
+    int to = Min((b + 1) * STORE_TIME_BLOCK, lo);
+    for (int i = b * STORE_TIME_BLOCK; i < to; i++)
+    {
+      if (! found[store->times[i].handle] &&
+          overlaps_span_span(&store->times[i].period, s))
+        found[store->times[i].handle] = true;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Mark the handles of the values of a store that have a box of the
+ * spatial index overlapping a box
+ */
+static void
+store_space_search(const TStore *store, int level, int n, const STBox *box,
+  bool *found)
+{
+  const store_node *node = &store->levels[level][n];
+  if (! overlaps_stbox_stbox(&node->box, box))
+    return;
+  if (level == 0)
+  {
+    found[node->first] = true;
+    return;
+  }
+  for (int i = 0; i < node->count; i++)
+    store_space_search(store, level - 1, node->first + i, box, found);
+  return;
+}
+
+/**
+ * @brief Return the handles marked by a search in ascending order
+ */
+static int *
+store_found_handles(const TStore *store, bool *found, int *count)
+{
+  int *result = palloc(sizeof(int) * Max(store->maxhandle, 1));
+  int k = 0;
+  for (int h = 0; h < store->maxhandle; h++)
+  {
+    if (found[h])
+      result[k++] = h;
+  }
+  pfree(found);
+  *count = k;
+  return result;
+}
+
+/*****************************************************************************
+ * Store functions
+ *****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return a new empty store of temporal values
+ * @param[in] maxslack Budget in bytes of the free space reserved by the
+ * values for future appends
+ * @see #expand_pool_make
+ */
+TStore *
+tstore_make(size_t maxslack)
+{
+  TStore *result = palloc0(sizeof(TStore));
+  result->pool = expand_pool_make(maxslack);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Free a store and its values
+ * @param[in] store Store
+ */
+void
+tstore_free(TStore *store)
+{
+  if (! store)
+    return;
+  store_index_free(store);
+  expand_pool_free(store->pool);
+  pfree(store);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Add a copy of a temporal value to a store
+ * @param[in,out] store Store
+ * @param[in] temp Temporal sequence or sequence set with continuous
+ * interpolation
+ * @return Handle of the value in the store, on error return -1
+ */
+int
+tstore_add(TStore *store, const Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store) || ! ensure_not_null((void *) temp))
+    return -1;
+  Temporal *copy = temporal_copy(temp);
+  int result = expand_pool_add(store->pool, copy);
+  if (result < 0)
+  {
+    pfree(copy);
+    return -1;
+  }
+  store->maxhandle = Max(store->maxhandle, result + 1);
+  store->dirty = true;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Append an instant to a value of a store
+ * @param[in,out] store Store
+ * @param[in] handle Handle
+ * @param[in] inst Temporal instant
+ * @param[in] maxdist Maximum distance for defining a gap
+ * @param[in] maxt Maximum time interval for defining a gap
+ * @return On error return false, in which case the value is left unchanged
+ * @see #expand_pool_append
+ */
+bool
+tstore_append(TStore *store, int handle, const TInstant *inst,
+  double maxdist, const Interval *maxt)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store) ||
+      ! expand_pool_append(store->pool, handle, inst, maxdist, maxt))
+    return false;
+  store->dirty = true;
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Remove a value from a store
+ * @param[in,out] store Store
+ * @param[in] handle Handle, which may be returned by a later addition
+ * @return On error return false
+ */
+bool
+tstore_remove(TStore *store, int handle)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store))
+    return false;
+  Temporal *temp = expand_pool_remove(store->pool, handle);
+  if (! temp)
+    return false;
+  pfree(temp);
+  store->dirty = true;
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return the number of values of a store
+ * @param[in] store Store
+ * @return On error return -1
+ */
+int
+tstore_count(const TStore *store)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store))
+    return -1;
+  return expand_pool_count(store->pool);
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return a value of a store without copying it
+ * @param[in] store Store
+ * @param[in] handle Handle
+ * @note The value remains owned by the store and is valid until the next
+ * modification of the store
+ * @return On error return @p NULL
+ */
+const Temporal *
+tstore_view(const TStore *store, int handle)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store))
+    return NULL;
+  return expand_pool_get(store->pool, handle);
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return the handles of the values of a store whose time span
+ * overlaps a timestamptz span
+ * @param[in,out] store Store, whose indexes are rebuilt if needed
+ * @param[in] s Timestamptz span
+ * @param[out] count Number of elements in the result
+ * @return Handles in ascending order, on error return @p NULL
+ */
+int *
+tstore_search_tstzspan(TStore *store, const Span *s, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store) || ! ensure_not_null((void *) s) ||
+      ! ensure_not_null((void *) count) ||
+      ! ensure_span_isof_type(s, T_TSTZSPAN))
+    return NULL;
+
+  store_index_build(store);
+  bool *found = palloc0(sizeof(bool) * Max(store->maxhandle, 1));
+  store_time_search(store, s, found);
+  return store_found_handles(store, found, count);
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return the handles of the temporal points of a store whose bounding
+ * box overlaps a spatiotemporal box
+ * @details A box without spatial dimension is answered with the time index
+ * and thus also returns the values of the store that are not temporal points
+ * @param[in,out] store Store, whose indexes are rebuilt if needed
+ * @param[in] box Spatiotemporal box
+ * @param[out] count Number of elements in the result
+ * @return Handles in ascending order, on error return @p NULL
+ */
+int *
+tstore_search_stbox(TStore *store, const STBox *box, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store) || ! ensure_not_null((void *) box) ||
+      ! ensure_not_null((void *) count))
+    return NULL;
+  if (! MEOS_FLAGS_GET_X(box->flags))
+    return tstore_search_tstzspan(store, &box->period, count);
+
+  store_index_build(store);
+  bool *found = palloc0(sizeof(bool) * Max(store->maxhandle, 1));
+  if (store->nlevels > 0)
+  {
+    meos_errno_reset();
+    int root = store->nlevels - 1;
+    for (int i = 0; i < store->nnodes[root]; i++)
+      store_space_search(store, root, i, box, found);
+    if (meos_errno())
+    {
+      pfree(found);
+      return NULL;
+    }
+  }
+  return store_found_handles(store, found, count);
+}
+
+/**
+ * @brief Comparator of pairs (distance, handle) on the distance
+ */
+static int
+store_dist_cmp(const double2 *d1, const double2 *d2)
+{
+  return (d1->a < d2->a) ? -1 : (d1->a > d2->a) ? 1 : 0;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return the handles of the @p k temporal points of a store whose
+ * nearest approach distance to a geometry is the smallest
+ * @details The distances from the geometry to the boxes of the spatial index
+ * give a lower bound of the distance of each value, and the values are
+ * visited in the order of this bound until the bound reaches the distance of
+ * the k-th nearest value found, so that the distance of the values far from
+ * the geometry is not computed
+ * @param[in,out] store Store, whose indexes are rebuilt if needed
+ * @param[in] gs Geometry
+ * @param[in] k Number of values
+ * @param[out] count Number of elements in the result
+ * @return Handles by increasing distance, on error return @p NULL
+ */
+int *
+tstore_knn_geo(TStore *store, const GSERIALIZED *gs, int k, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) store) || ! ensure_not_null((void *) gs) ||
+      ! ensure_not_null((void *) count) || ! ensure_positive(k))
+    return NULL;
+
+  store_index_build(store);
+  /* Lower bound of the distance of each value, as a pair (bound, handle) */
+  double2 *bounds = palloc(sizeof(double2) * Max(store->maxhandle, 1));
+  for (int h = 0; h < store->maxhandle; h++)
+  {
+    bounds[h].a = DBL_MAX;
+    bounds[h].b = (double) h;
+  }
+  meos_errno_reset();
+  int nleaves = (store->nlevels > 0) ? store->nnodes[0] : 0;
+  for (int i = 0; i < nleaves; i++)
+  {
+    const store_node *leaf = &store->levels[0][i];
+    double d = nad_stbox_geo(&leaf->box, gs);
+    if (meos_errno())
+    {
+      pfree(bounds);
+      return NULL;
+    }
+    if (d < bounds[leaf->first].a)
+      bounds[leaf->first].a = d;
+  }
+  qsort(bounds, (size_t) store->maxhandle, sizeof(double2),
+    (qsort_comparator) &store_dist_cmp);
+
+  /* Best values found by increasing distance, as pairs (distance, handle) */
+  double2 *best = palloc(sizeof(double2) * k);
+  int nbest = 0;
+  for (int i = 0; i < store->maxhandle && bounds[i].a < DBL_MAX; i++)
+  {
+    if (nbest == k && bounds[i].a >= best[k - 1].a)
+      break;
+    int h = (int) bounds[i].b;
+    double d = nad_tpoint_geo(expand_pool_get(store->pool, h), gs);
+    if (meos_errno())
+    {
+      pfree(bounds); pfree(best);
+      return NULL;
+    }
+    if (nbest == k && d >= best[k - 1].a)
+      continue;
+    /* Insert the value in the best ones */
+    int j = (nbest < k) ? nbest++ : k - 1;
+    while (j > 0 && best[j - 1].a > d)
+    {
+      best[j] = best[j - 1];
+      j--;
+    }
+    best[j].a = d;
+    best[j].b = (double) h;
+  }
+  int *result = palloc(sizeof(int) * Max(nbest, 1));
+  for (int i = 0; i < nbest; i++)
+    result[i] = (int) best[i].b;
+  pfree(bounds); pfree(best);
+  *count = nbest;
+  return result;
+}
+
+/*****************************************************************************/
@@ -50,7 +50,9 @@
 #include "general/span.h"
 #include "general/temporal_restrict.h"
 #include "general/tsequence.h"
+#include "general/tsequenceset.h"
 #include "general/type_util.h"
+#include "point/tpoint_spatialfuncs.h"
 
 /*****************************************************************************
  * Span bucket functions
@@ -401,6 +403,183 @@ datum_bucket(Datum value, Datum size, Datum origin, meosType type)
   }
 }
 
+/*****************************************************************************
+ * Batch bucket functions
+ *****************************************************************************/
+
+/**
+ * @brief Set the initial timestamps of the buckets that contain the
+ * timestamps of an array
+ * @details The validity of the arguments is checked in a first pass so that
+ * the second pass is a straight-line loop without early exits, which the
+ * compiler can unroll and pipeline. The floor division is obtained from the
+ * truncating one by subtracting the size when the remainder is negative.
+ * @param[in] times Input timestamps
+ * @param[in] count Number of elements in the array
+ * @param[in] size Size of the time buckets in PostgreSQL time units
+ * @param[in] origin Origin of the buckets
+ * @param[out] result Output timestamps, which may be equal to @p times
+ * @return On error return false
+ */
+bool
+timestamptzarr_bucket1(const TimestampTz *times, int count, int64 size,
+  TimestampTz origin, TimestampTz *result)
+{
+  assert(times); assert(result); assert(size > 0);
+  /* Bounds of the input timestamps such that the origin can be applied */
+  TimestampTz mint = (origin > 0) ? DT_NOBEGIN + origin : DT_NOBEGIN;
+  TimestampTz maxt = (origin < 0) ? DT_NOEND + origin : DT_NOEND;
+  bool invalid = false;
+  for (int i = 0; i < count; i++)
+    invalid |= TIMESTAMP_NOT_FINITE(times[i]) || times[i] < mint ||
+      times[i] > maxt;
+  if (invalid)
+  {
+    meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE, "timestamp out of span");
+    return false;
+  }
+  TimestampTz minbucket = DT_NOBEGIN + size;
+  bool overflow = false;
+  for (int i = 0; i < count; i++)
+  {
+    TimestampTz t = times[i] - origin;
+    TimestampTz q = t / size;
+    TimestampTz trunc = q * size;
+    bool neg = (t - trunc) < 0;
+    overflow |= neg && trunc < minbucket;
+    result[i] = trunc - (neg ? size : 0) + origin;
+  }
+  if (overflow)
+  {
+    meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE, "timestamp out of span");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the initial timestamps of the buckets that contain the
+ * timestamps of an array
+ * @param[in] times Input timestamps
+ * @param[in] count Number of elements in the array
+ * @param[in] duration Interval defining the size of the buckets
+ * @param[in] origin Origin of the buckets
+ * @return On error return @p NULL
+ * @csqlfn #Timestamptzarr_bucket()
+ */
+TimestampTz *
+timestamptzarr_bucket(const TimestampTz *times, int count,
+  const Interval *duration, TimestampTz origin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) times) ||
+      ! ensure_not_null((void *) duration) || ! ensure_positive(count) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+
+  TimestampTz *result = palloc(sizeof(TimestampTz) * count);
+  if (! timestamptzarr_bucket1(times, count, interval_units(duration), origin,
+      result))
+  {
+    pfree(result);
+    return NULL;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the initial values of the buckets that contain the integers
+ * of an array
+ * @details As for #timestamptzarr_bucket1, the validity of the values is
+ * checked in a first pass and the buckets are computed in a second one.
+ * @param[in] values Input values
+ * @param[in] count Number of elements in the array
+ * @param[in] size Size of the buckets
+ * @param[in] origin Origin of the buckets
+ * @return On error return @p NULL
+ * @csqlfn #Numberarr_bucket()
+ */
+int *
+intarr_bucket(const int *values, int count, int size, int origin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) values) || ! ensure_positive(count) ||
+      ! ensure_positive(size))
+    return NULL;
+
+  int minv = (origin > 0) ? PG_INT32_MIN + origin : PG_INT32_MIN;
+  int maxv = (origin < 0) ? PG_INT32_MAX + origin : PG_INT32_MAX;
+  bool invalid = false;
+  for (int i = 0; i < count; i++)
+    invalid |= values[i] < minv || values[i] > maxv;
+  if (invalid)
+  {
+    meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE, "number out of span");
+    return NULL;
+  }
+
+  int *result = palloc(sizeof(int) * count);
+  bool overflow = false;
+  for (int i = 0; i < count; i++)
+  {
+    int64 v = (int64) values[i] - origin;
+    int64 trunc = (v / size) * size;
+    int64 bucket = trunc - ((v - trunc) < 0 ? size : 0);
+    overflow |= bucket < PG_INT32_MIN;
+    result[i] = (int) (bucket + origin);
+  }
+  if (overflow)
+  {
+    meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE, "number out of span");
+    pfree(result);
+    return NULL;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the initial values of the buckets that contain the floats of
+ * an array
+ * @details As for #timestamptzarr_bucket1, the validity of the values is
+ * checked in a first pass and the buckets are computed in a second one.
+ * The quotient is computed as in #float_bucket rather than by multiplying by
+ * the reciprocal of the size, whose rounding would yield buckets different
+ * from the scalar function for values close to the bucket boundaries.
+ * @param[in] values Input values
+ * @param[in] count Number of elements in the array
+ * @param[in] size Size of the buckets
+ * @param[in] origin Origin of the buckets
+ * @return On error return @p NULL
+ * @csqlfn #Numberarr_bucket()
+ */
+double *
+floatarr_bucket(const double *values, int count, double size, double origin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) values) || ! ensure_positive(count) ||
+      ! ensure_positive_datum(Float8GetDatum(size), T_FLOAT8))
+    return NULL;
+
+  double minv = (origin > 0) ? -1 * DBL_MAX + origin : -1 * DBL_MAX;
+  double maxv = (origin < 0) ? DBL_MAX + origin : DBL_MAX;
+  bool invalid = false;
+  for (int i = 0; i < count; i++)
+    invalid |= values[i] < minv || values[i] > maxv;
+  if (invalid)
+  {
+    meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE, "number out of span");
+    return NULL;
+  }
+
+  double *result = palloc(sizeof(double) * count);
+  for (int i = 0; i < count; i++)
+    result[i] = floor((values[i] - origin) / size) * size + origin;
+  return result;
+}
+
 /*****************************************************************************
  * Bucket list functions
  *****************************************************************************/
@@ -1158,9 +1337,12 @@ temporal_time_split(Temporal *temp, Interval *duration, TimestampTz torigin,
   int nbuckets = tstzspan_no_buckets(&s, duration, torigin, &start_bucket,
     &end_bucket);
   int64 tunits = interval_units(duration);
-  return temporal_time_split1(temp, DatumGetTimestampTz(start_bucket),
-    DatumGetTimestampTz(end_bucket), tunits, torigin, nbuckets, buckets,
-    count);
+  Temporal **result;
+  MEOS_STATS_CALL(MEOS_FAMILY_TILING,
+    result = temporal_time_split1(temp, DatumGetTimestampTz(start_bucket),
+      DatumGetTimestampTz(end_bucket), tunits, torigin, nbuckets, buckets,
+      count));
+  return result;
 }
 
 /*****************************************************************************
@@ -1695,74 +1877,581 @@ tnumber_value_split(const Temporal *temp, Datum size, Datum vorigin,
 /**
  * @brief Return a temporal value split according to a base value and possibly
  * a temporal grid
+ * @details The temporal value is first split in a single pass into its
+ * fragments for each value bucket, and each of these fragments is then split
+ * according to the time buckets. The fragments are collected from
+ * #value_time_split_state_next() so that they are the same as those returned
+ * by the set-returning functions in SQL.
  */
 Temporal **
 tnumber_value_time_split(Temporal *temp, Datum size, Interval *duration,
   Datum vorigin, TimestampTz torigin, Datum **value_buckets,
   TimestampTz **time_buckets, int *count)
 {
-  meosType basetype = temptype_basetype(temp->temptype);
-  meosType spantype = basetype_spantype(basetype);
-  ensure_positive_datum(size, basetype);
-  ensure_valid_duration(duration);
+  ValueTimeSplitState *state = value_time_split_state_make(temp, true, size,
+    vorigin, duration, torigin);
+  if (! state)
+    return NULL;
 
+  /* Compute the number of time buckets */
   Span s;
-  Datum start_bucket, end_bucket, start_time_bucket, end_time_bucket;
-  /* Compute the value bounds */
-  tnumber_set_span(temp, &s);
-  int value_count = span_no_buckets(&s, size, vorigin, &start_bucket,
-      &end_bucket);
-  /* Compute the time bounds */
+  Datum start_time_bucket, end_time_bucket;
   temporal_set_tstzspan(temp, &s);
-  int time_count = tstzspan_no_buckets(&s, duration, torigin, &start_time_bucket,
-      &end_time_bucket);
-  TimestampTz start_time = DatumGetTimestampTz(start_time_bucket);
-  TimestampTz end_time = DatumGetTimestampTz(end_time_bucket);
+  int time_count = tstzspan_no_buckets(&s, duration, torigin,
+    &start_time_bucket, &end_time_bucket);
+
+  /* Collect the fragments of the tiles */
+  int ntiles = state->count * time_count;
+  Datum *v_buckets = palloc(sizeof(Datum) * ntiles);
+  TimestampTz *t_buckets = palloc(sizeof(TimestampTz) * ntiles);
+  Temporal **fragments = palloc(sizeof(Temporal *) * ntiles);
+  int nfrags = 0;
+  while (value_time_split_state_next(state, &v_buckets[nfrags],
+      &t_buckets[nfrags], &fragments[nfrags]))
+    nfrags++;
+  value_time_split_state_free(state);
+  *count = nfrags;
+  if (value_buckets)
+    *value_buckets = v_buckets;
+  else
+    pfree(v_buckets);
+  if (time_buckets)
+    *time_buckets = t_buckets;
+  else
+    pfree(t_buckets);
+  return fragments;
+}
+
+/*****************************************************************************
+ * Bucketed aggregation functions
+ *****************************************************************************/
+
+/**
+ * @brief Struct for storing the aggregate value of a time bucket
+ */
+typedef struct
+{
+  bool found;       /**< True when the temporal value is defined in the bucket */
+  double value;     /**< Integral, maximum, or length in the bucket */
+  double duration;  /**< Duration of the continuous pieces in the bucket */
+  double isum;      /**< Sum of the values of the instants in the bucket */
+  int icount;       /**< Number of instants in the bucket */
+} BucketAggValue;
+
+/**
+ * @brief Add an instant to the aggregate value of a bucket
+ */
+static void
+bucket_agg_instant(BucketAggValue *bucket, const TInstant *inst,
+  bucketAggType type)
+{
+  if (type != BUCKET_LENGTH)
+  {
+    double value = datum_double(tinstant_val(inst),
+      temptype_basetype(inst->temptype));
+    if (type == BUCKET_TWAVG)
+    {
+      bucket->isum += value;
+      bucket->icount++;
+    }
+    else /* type == BUCKET_MAX */
+      bucket->value = bucket->found ? Max(bucket->value, value) : value;
+  }
+  bucket->found = true;
+}
+
+/**
+ * @brief Add a piece of a segment to the aggregate value of a bucket
+ * @param[in] bucket Aggregate value of the bucket
+ * @param[in] value1,value2 Values at the start and the end of the piece
+ * @param[in] duration Duration of the piece
+ * @param[in] interp Interpolation of the segment
+ * @param[in] basetype Base type of the values
+ * @param[in] distfn Distance function for temporal points
+ * @param[in] type Aggregate function
+ * @note For step interpolation both values are the value at the start of the
+ * segment
+ */
+static void
+bucket_agg_piece(BucketAggValue *bucket, Datum value1, Datum value2,
+  int64 duration, interpType interp, meosType basetype, datum_func2 distfn,
+  bucketAggType type)
+{
+  if (type == BUCKET_LENGTH)
+  {
+    if (interp == LINEAR)
+      bucket->value += DatumGetFloat8(distfn(value1, value2));
+  }
+  else
+  {
+    double d1 = datum_double(value1, basetype);
+    double d2 = datum_double(value2, basetype);
+    if (type == BUCKET_TWAVG)
+    {
+      /* The average of the values is exact for linear segments */
+      bucket->value += (d1 + d2) / 2 * (double) duration;
+      bucket->duration += (double) duration;
+    }
+    else /* type == BUCKET_MAX */
+    {
+      double max = Max(d1, d2);
+      bucket->value = bucket->found ? Max(bucket->value, max) : max;
+    }
+  }
+  bucket->found = true;
+}
+
+/**
+ * @brief Add a temporal sequence to the aggregate values of the buckets
+ * @details The segments are traversed once and each segment is cut at the
+ * bucket boundaries that it crosses
+ * @param[in] seq Temporal value
+ * @param[in] first First bucket, which must not be after the sequence
+ * @param[in] tunits Size of the buckets in PostgreSQL time units
+ * @param[in] type Aggregate function
+ * @param[out] buckets Aggregate values of the buckets
+ */
+static void
+tsequence_bucket_agg_iter(const TSequence *seq, TimestampTz first,
+  int64 tunits, bucketAggType type, BucketAggValue *buckets)
+{
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  if (interp == DISCRETE || seq->count == 1)
+  {
+    for (int i = 0; i < seq->count; i++)
+    {
+      const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+      bucket_agg_instant(&buckets[(inst->t - first) / tunits], inst, type);
+    }
+    return;
+  }
+
+  meosType basetype = temptype_basetype(seq->temptype);
+  bool byval = MEOS_FLAGS_GET_BYVAL(seq->flags);
+  datum_func2 distfn = (type == BUCKET_LENGTH) ?
+    pt_distance_fn(seq->flags) : NULL;
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  for (int i = 1; i < seq->count; i++)
+  {
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+    TimestampTz t1 = inst1->t;
+    Datum value1 = tinstant_val(inst1);
+    bool free1 = false;
+    int64 k = (t1 - first) / tunits;
+    while (t1 < inst2->t)
+    {
+      /* Cut the segment at the end of the current bucket */
+      TimestampTz t2 = Min(first + (k + 1) * tunits, inst2->t);
+      Datum value2 = value1;
+      bool free2 = false;
+      if (interp == LINEAR)
+      {
+        if (t2 == inst2->t)
+          value2 = tinstant_val(inst2);
+        else
+        {
+          value2 = tsegment_value_at_timestamptz(inst1, inst2, interp, t2);
+          free2 = ! byval;
+        }
+      }
+      bucket_agg_piece(&buckets[k], value1, value2, t2 - t1, interp,
+        basetype, distfn, type);
+      if (free1)
+        pfree(DatumGetPointer(value1));
+      value1 = value2;
+      free1 = free2;
+      t1 = t2;
+      k++;
+    }
+    if (free1)
+      pfree(DatumGetPointer(value1));
+    inst1 = inst2;
+  }
+  /* The last instant belongs to the bucket starting at its timestamp */
+  if (seq->period.upper_inc)
+    bucket_agg_instant(&buckets[(inst1->t - first) / tunits], inst1, type);
+}
+
+/**
+ * @brief Return the step sequence of the aggregate values of a run of
+ * consecutive buckets
+ */
+static TSequence *
+bucket_agg_seq(const BucketAggValue *buckets, int start, int end,
+  TimestampTz first, int64 tunits, bucketAggType type)
+{
+  TInstant **instants = palloc(sizeof(TInstant *) * (end - start + 2));
+  double value = 0;
+  for (int i = start; i <= end; i++)
+  {
+    const BucketAggValue *bucket = &buckets[i];
+    if (type != BUCKET_TWAVG)
+      value = bucket->value;
+    else
+      value = (bucket->duration > 0) ? bucket->value / bucket->duration :
+        bucket->isum / bucket->icount;
+    instants[i - start] = tinstant_make(Float8GetDatum(value), T_TFLOAT,
+      first + i * tunits);
+  }
+  /* The value of the last bucket is kept until the end of the bucket */
+  instants[end - start + 1] = tinstant_make(Float8GetDatum(value), T_TFLOAT,
+    first + (end + 1) * tunits);
+  return tsequence_make_free(instants, end - start + 2, true, false, STEP,
+    NORMALIZE);
+}
+
+/**
+ * @brief Return the aggregate values of a temporal value per time bucket
+ * computed with a single scan of the value, without splitting it first
+ * @details The result is a temporal float with step interpolation whose
+ * value in each bucket is the aggregate value of the temporal value in this
+ * bucket, the buckets where the temporal value is not defined are gaps.
+ * This is equivalent to applying the aggregate function to every fragment
+ * obtained with #temporal_time_split(), except that the last instant of a
+ * sequence that ends on the upper bound of a bucket only belongs to the next
+ * bucket when it is inclusive.
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @param[in] type Aggregate function
+ */
+Temporal *
+temporal_bucket_agg(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin, bucketAggType type)
+{
+  assert(temp); assert(duration); assert(valid_duration(duration));
   int64 tunits = interval_units(duration);
+  Span s;
+  temporal_set_tstzspan(temp, &s);
+  TimestampTz first = timestamptz_bucket1(DatumGetTimestampTz(s.lower),
+    tunits, torigin);
+  TimestampTz last = timestamptz_bucket1(DatumGetTimestampTz(s.upper),
+    tunits, torigin);
+  int count = (int) ((last - first) / tunits) + 1;
+  BucketAggValue *buckets = palloc0(sizeof(BucketAggValue) * count);
 
-  /* Total number of tiles */
-  int ntiles = value_count * time_count;
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    bucket_agg_instant(&buckets[0], (const TInstant *) temp, type);
+  else if (temp->subtype == TSEQUENCE)
+    tsequence_bucket_agg_iter((const TSequence *) temp, first, tunits, type,
+      buckets);
+  else /* TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count; i++)
+      tsequence_bucket_agg_iter(TSEQUENCESET_SEQ_N(ss, i), first, tunits,
+        type, buckets);
+  }
 
-  /* Split the temporal value */
-  Datum *v_buckets = NULL;
-  TimestampTz *t_buckets = NULL;
-  Temporal **fragments;
-  v_buckets = palloc(sizeof(Datum) * ntiles);
-  t_buckets = palloc(sizeof(TimestampTz) * ntiles);
-  fragments = palloc(sizeof(Temporal *) * ntiles);
-  int nfrags = 0;
-  Datum lower_value = start_bucket;
-  while (datum_lt(lower_value, end_bucket, basetype))
+  /* Construct one step sequence per run of consecutive nonempty buckets */
+  TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  int nseqs = 0, i = 0;
+  while (i < count)
+  {
+    if (! buckets[i].found)
+    {
+      i++;
+      continue;
+    }
+    int j = i;
+    while (j + 1 < count && buckets[j + 1].found)
+      j++;
+    sequences[nseqs++] = bucket_agg_seq(buckets, i, j, first, tunits, type);
+    i = j + 1;
+  }
+  pfree(buckets);
+  if (nseqs == 1)
+  {
+    Temporal *result = (Temporal *) sequences[0];
+    pfree(sequences);
+    return result;
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the time-weighted average of a temporal number per time
+ * bucket
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @return On error return @p NULL
+ * @csqlfn #Tnumber_bucket_twavg()
+ */
+Temporal *
+tnumber_bucket_twavg(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_not_null((void *) duration) ||
+      ! ensure_tnumber_type(temp->temptype) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+  return temporal_bucket_agg(temp, duration, torigin, BUCKET_TWAVG);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the maximum value of a temporal number per time bucket
+ * @param[in] temp Temporal value
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @return On error return @p NULL
+ * @csqlfn #Tnumber_bucket_max()
+ */
+Temporal *
+tnumber_bucket_max(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_not_null((void *) duration) ||
+      ! ensure_tnumber_type(temp->temptype) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+  return temporal_bucket_agg(temp, duration, torigin, BUCKET_MAX);
+}
+
+/*****************************************************************************
+ * Incremental value and time split functions
+ *****************************************************************************/
+
+/**
+ * @brief Return the fragment of a discrete sequence in a time bucket
+ * @param[in] seq Temporal value
+ * @param[in] lower,upper Bounds of the bucket
+ */
+static TSequence *
+tdiscseq_time_bucket(const TSequence *seq, TimestampTz lower,
+  TimestampTz upper)
+{
+  /* Binary search of the first instant not before the bucket */
+  int first = 0, last = seq->count;
+  while (first < last)
+  {
+    int middle = (first + last) / 2;
+    if (TSEQUENCE_INST_N(seq, middle)->t < lower)
+      first = middle + 1;
+    else
+      last = middle;
+  }
+  int n = first;
+  while (n < seq->count && TSEQUENCE_INST_N(seq, n)->t < upper)
+    n++;
+  if (n == first)
+    return NULL;
+  const TInstant **instants = palloc(sizeof(TInstant *) * (n - first));
+  for (int i = first; i < n; i++)
+    instants[i - first] = TSEQUENCE_INST_N(seq, i);
+  TSequence *result = tsequence_make(instants, n - first, true, true,
+    DISCRETE, NORMALIZE_NO);
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @brief Return the fragment of a continuous sequence in a time bucket
+ * @details As in #tsequence_time_split_iter(), the last instant of a
+ * sequence that ends on the upper bound of a bucket belongs to this bucket
+ * @param[in] seq Temporal value
+ * @param[in] lower,upper Bounds of the bucket
+ */
+static TSequence *
+tcontseq_time_bucket(const TSequence *seq, TimestampTz lower,
+  TimestampTz upper)
+{
+  TimestampTz end = DatumGetTimestampTz(seq->period.upper);
+  if (seq->count > 1 && end == lower)
+    return NULL;
+  bool upper_inc = (seq->count > 1 && end == upper && seq->period.upper_inc);
+  Span s;
+  span_set(TimestampTzGetDatum(lower), TimestampTzGetDatum(upper), true,
+    upper_inc, T_TIMESTAMPTZ, T_TSTZSPAN, &s);
+  return tcontseq_at_tstzspan(seq, &s);
+}
+
+/**
+ * @brief Return the fragment of a temporal value in a time bucket, which is
+ * the same as the one obtained with #temporal_time_split()
+ * @param[in] temp Temporal value
+ * @param[in] lower,upper Bounds of the bucket
+ * @return When the fragment is empty return @p NULL
+ */
+static Temporal *
+temporal_time_bucket(const Temporal *temp, TimestampTz lower,
+  TimestampTz upper)
+{
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+    {
+      const TInstant *inst = (const TInstant *) temp;
+      return (lower <= inst->t && inst->t < upper) ?
+        (Temporal *) tinstant_copy(inst) : NULL;
+    }
+    case TSEQUENCE:
+      return MEOS_FLAGS_DISCRETE_INTERP(temp->flags) ?
+        (Temporal *) tdiscseq_time_bucket((const TSequence *) temp, lower,
+          upper) :
+        (Temporal *) tcontseq_time_bucket((const TSequence *) temp, lower,
+          upper);
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      int loc;
+      tsequenceset_find_timestamptz(ss, lower, &loc);
+      TSequence **sequences = palloc(sizeof(TSequence *) * (ss->count - loc));
+      int nseqs = 0;
+      for (int i = loc; i < ss->count; i++)
+      {
+        const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+        if (DatumGetTimestampTz(seq->period.lower) > upper)
+          break;
+        TSequence *frag = tcontseq_time_bucket(seq, lower, upper);
+        if (frag)
+          sequences[nseqs++] = frag;
+      }
+      if (nseqs == 0)
+      {
+        pfree(sequences);
+        return NULL;
+      }
+      return (Temporal *) tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+    }
+  }
+}
+
+/**
+ * @brief Create the state for splitting a temporal value incrementally with
+ * respect to value buckets and/or time buckets
+ * @details The temporal value is split in a single pass into its fragments
+ * for each value bucket as in #tnumber_value_split(), which are stored in the
+ * state. The fragments of each of them in the time buckets are then obtained
+ * one at a time with #value_time_split_state_next(), so that the memory needed
+ * does not depend on the number of tiles
+ * @param[in] temp Temporal value, which must remain valid while the state
+ * is used
+ * @param[in] valuesplit True when splitting according to value buckets
+ * @param[in] size,vorigin Size and origin of the value buckets
+ * @param[in] duration,torigin Size and origin of the time buckets, the
+ * duration is @p NULL when not splitting according to time buckets
+ * @return On error return @p NULL
+ */
+ValueTimeSplitState *
+value_time_split_state_make(const Temporal *temp, bool valuesplit,
+  Datum size, Datum vorigin, const Interval *duration, TimestampTz torigin)
+{
+  assert(temp); assert(valuesplit || duration);
+  if ((valuesplit && ! ensure_positive_datum(size,
+        temptype_basetype(temp->temptype))) ||
+      (duration && ! ensure_valid_duration(duration)))
+    return NULL;
+
+  ValueTimeSplitState *state = palloc0(sizeof(ValueTimeSplitState));
+  state->valuesplit = valuesplit;
+  state->timesplit = (duration != NULL);
+  state->temp = temp;
+  if (valuesplit)
+    state->atspans = tnumber_value_split(temp, size, vorigin, &state->values,
+      &state->count);
+  if (state->timesplit)
   {
-    Datum upper_value = datum_add(lower_value, size, basetype);
     Span s;
-    span_set(lower_value, upper_value, true, false, basetype, spantype, &s);
-    Temporal *atspan = tnumber_restrict_span(temp, &s, REST_AT);
-    if (atspan != NULL)
+    Datum start, end;
+    temporal_set_tstzspan(temp, &s);
+    tstzspan_no_buckets(&s, duration, torigin, &start, &end);
+    state->tunits = interval_units(duration);
+    state->torigin = torigin;
+    state->t = DatumGetTimestampTz(start);
+    state->end_time = DatumGetTimestampTz(end);
+    /* Start the time buckets at the start of the first value fragment */
+    if (valuesplit && state->count > 0)
+      state->t = timestamptz_bucket1(temporal_start_timestamptz(
+        state->atspans[0]), state->tunits, torigin);
+  }
+  return state;
+}
+
+/**
+ * @brief Return the next fragment of a temporal value split with respect to
+ * value buckets and/or time buckets
+ * @param[in,out] state State
+ * @param[out] value Lower bound of the value bucket of the fragment, if any
+ * @param[out] t Lower bound of the time bucket of the fragment, if any
+ * @param[out] fragment New fragment
+ * @return Return false when all fragments have been returned
+ */
+bool
+value_time_split_state_next(ValueTimeSplitState *state, Datum *value,
+  TimestampTz *t, Temporal **fragment)
+{
+  assert(state); assert(fragment);
+  while (! state->done)
+  {
+    if (state->valuesplit && state->i >= state->count)
+      break;
+    /* Value split only, the fragment is given to the caller */
+    if (! state->timesplit)
+    {
+      if (value)
+        *value = state->values[state->i];
+      *fragment = state->atspans[state->i];
+      state->atspans[state->i++] = NULL;
+      return true;
+    }
+    /* Time split, possibly of the fragment of the current value bucket */
+    const Temporal *temp = state->valuesplit ?
+      state->atspans[state->i] : state->temp;
+    while (state->t < state->end_time)
     {
-      int num_time_splits;
-      TimestampTz *times;
-      Temporal **time_splits = temporal_time_split1(atspan, start_time,
-        end_time, tunits, torigin, time_count, &times, &num_time_splits);
-      for (int i = 0; i < num_time_splits; i++)
+      TimestampTz lower = state->t;
+      state->t += state->tunits;
+      Temporal *frag = temporal_time_bucket(temp, lower, state->t);
+      if (frag)
       {
-        v_buckets[i + nfrags] = lower_value;
-        t_buckets[i + nfrags] = times[i];
-        fragments[i + nfrags] = time_splits[i];
+        if (value && state->valuesplit)
+          *value = state->values[state->i];
+        if (t)
+          *t = lower;
+        *fragment = frag;
+        return true;
       }
-      nfrags += num_time_splits;
-      pfree(time_splits);
-      pfree(times);
-      pfree(atspan);
+      /* There is no fragment after the end of the temporal value */
+      if (lower > temporal_end_timestamptz(temp))
+        break;
     }
-    lower_value = upper_value;
+    if (! state->valuesplit)
+      break;
+    /* Move to the next value bucket and restart the time buckets at the
+     * start of its fragment */
+    pfree(state->atspans[state->i]);
+    state->atspans[state->i++] = NULL;
+    if (state->i < state->count)
+      state->t = timestamptz_bucket1(temporal_start_timestamptz(
+        state->atspans[state->i]), state->tunits, state->torigin);
   }
-  *count = nfrags;
-  if (value_buckets)
-    *value_buckets = v_buckets;
-  if (time_buckets)
-    *time_buckets = t_buckets;
-  return fragments;
+  state->done = true;
+  return false;
+}
+
+/**
+ * @brief Free the state for splitting a temporal value incrementally
+ */
+void
+value_time_split_state_free(ValueTimeSplitState *state)
+{
+  if (! state)
+    return;
+  if (state->atspans)
+    pfree_array((void **) state->atspans, state->count);
+  if (state->values)
+    pfree(state->values);
+  pfree(state);
+  return;
 }
 
 #if MEOS
@@ -40,6 +40,7 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/doublen.h"
+#include "general/tinstant.h"
 #include "general/type_util.h"
 
 /*****************************************************************************
@@ -567,6 +568,354 @@ temporal_wagg_transform_transfn(SkipList *state, const Temporal *temp,
   return result;
 }
 
+/*****************************************************************************
+ * Sliding window functions for a single temporal number
+ *****************************************************************************/
+
+/**
+ * @brief Enumeration for the sliding window functions
+ */
+typedef enum
+{
+  WMIN,
+  WMAX,
+  WSUM,
+  WCOUNT,
+  WAVG,
+} WindowFunc;
+
+/**
+ * @brief Add the pieces of a temporal sequence number with discrete or step
+ * interpolation, that is, its values with the time span in which they are
+ * valid, which is extended by a time interval
+ * @details For continuous sequences the pieces are only used for the count,
+ * for which the values are not taken into account
+ * @param[in] seq Temporal sequence
+ * @param[in] interv Interval
+ * @param[out] values,lower,upper Values and time spans of the pieces
+ * @param[in] k Number of pieces already in the arrays
+ * @return Number of pieces in the arrays
+ */
+static int
+tsequence_window_pieces(const TSequence *seq, const Interval *interv,
+  double *values, TimestampTz *lower, TimestampTz *upper, int k)
+{
+  bool discrete = MEOS_FLAGS_DISCRETE_INTERP(seq->flags);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    TimestampTz t;
+    if (discrete || seq->count == 1)
+      t = inst->t;
+    else if (i < seq->count - 1)
+      t = TSEQUENCE_INST_N(seq, i + 1)->t;
+    /* The last instant of a continuous sequence is only taken into account
+     * when it is inclusive and for the values but not for the count */
+    else if (seq->period.upper_inc && ! MEOS_FLAGS_LINEAR_INTERP(seq->flags))
+      t = inst->t;
+    else
+      break;
+    values[k] = tnumberinst_double(inst);
+    lower[k] = inst->t;
+    upper[k++] = add_timestamptz_interval(t, interv);
+  }
+  return k;
+}
+
+/**
+ * @brief Return the datum of a window aggregate value
+ */
+static Datum
+window_value_datum(double value, meosType temptype)
+{
+  return (temptype == T_TINT) ? Int32GetDatum((int32) value) :
+    Float8GetDatum(value);
+}
+
+/**
+ * @brief Return the sliding window aggregate of the pieces of a temporal
+ * number in linear time
+ * @details The starts and the ends of the time spans of the pieces are both
+ * non decreasing, and thus the pieces in the window at any timestamp are
+ * consecutive. The window is swept through the merged starts and ends,
+ * maintaining a monotonic queue of the pieces that can be the minimum or the
+ * maximum, and the prefix sums of the values for the sum and the average.
+ * @param[in] values,lower,upper Values and time spans of the pieces
+ * @param[in] count Number of pieces
+ * @param[in] func Window function
+ * @param[in] temptype Temporal type of the result
+ */
+static TSequenceSet *
+window_pieces_sweep(const double *values, const TimestampTz *lower,
+  const TimestampTz *upper, int count, WindowFunc func, meosType temptype)
+{
+  int *queue = palloc(sizeof(int) * count);
+  double *prefix = palloc(sizeof(double) * (count + 1));
+  prefix[0] = 0.0;
+  for (int i = 0; i < count; i++)
+    prefix[i + 1] = prefix[i] + values[i];
+  TInstant **instants = palloc(sizeof(TInstant *) * (2 * count + 1));
+  TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  int head = 0, tail = 0, ninsts = 0, nseqs = 0;
+  /* The pieces in the window are those in [first, next) */
+  int first = 0, next = 0;
+  double prev = 0.0;
+  while (next < count || first < next)
+  {
+    /* Timestamp of the next event */
+    TimestampTz t;
+    if (first == next)
+      t = lower[next];
+    else if (next < count)
+      t = Min(lower[next], upper[first]);
+    else
+      t = upper[first];
+
+    /* Remove the pieces that end at the timestamp */
+    while (first < next && upper[first] <= t)
+      first++;
+    while (head < tail && queue[head] < first)
+      head++;
+    /* Add the pieces that start at the timestamp */
+    for ( ; next < count && lower[next] <= t; next++)
+    {
+      if (func != WMIN && func != WMAX)
+        continue;
+      while (head < tail && ((func == WMIN) ?
+          values[queue[tail - 1]] >= values[next] :
+          values[queue[tail - 1]] <= values[next]))
+        tail--;
+      queue[tail++] = next;
+    }
+
+    /* An empty window ends the current sequence */
+    if (first == next)
+    {
+      if (ninsts > 0)
+      {
+        instants[ninsts++] = tinstant_make(window_value_datum(prev, temptype),
+          temptype, t);
+        sequences[nseqs++] = tsequence_make((const TInstant **) instants,
+          ninsts, true, false, STEP, NORMALIZE);
+        pfree_array((void **) instants, ninsts);
+        ninsts = 0;
+      }
+      continue;
+    }
+
+    double value;
+    if (func == WMIN || func == WMAX)
+      value = values[queue[head]];
+    else if (func == WSUM)
+      value = prefix[next] - prefix[first];
+    else if (func == WCOUNT)
+      value = (double) (next - first);
+    else /* func == WAVG */
+      value = (prefix[next] - prefix[first]) / (next - first);
+    if (ninsts == 0 || value != prev)
+    {
+      instants[ninsts++] = tinstant_make(window_value_datum(value, temptype),
+        temptype, t);
+      prev = value;
+    }
+  }
+  TSequenceSet *result = tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+  pfree(queue); pfree(prefix); pfree(instants);
+  return result;
+}
+
+/**
+ * @brief Merge an array of possibly overlapping temporal sequences by
+ * aggregating them pairwise in a balanced way
+ * @param[in] sequences Array of sequences
+ * @param[in] count Number of elements in the array
+ * @param[in] func Function
+ * @param[in] crossings True if turning points are added in the segments
+ * @param[out] newcount Number of elements in the result
+ * @note The sequences in the input array are not freed
+ */
+static TSequence **
+tseqarr_tagg_merge(TSequence **sequences, int count, datum_func2 func,
+  bool crossings, int *newcount)
+{
+  if (count == 1)
+  {
+    TSequence **result = palloc(sizeof(TSequence *));
+    result[0] = tsequence_copy(sequences[0]);
+    *newcount = 1;
+    return result;
+  }
+  int mid = count / 2, count1, count2;
+  TSequence **sequences1 = tseqarr_tagg_merge(sequences, mid, func,
+    crossings, &count1);
+  TSequence **sequences2 = tseqarr_tagg_merge(sequences + mid, count - mid,
+    func, crossings, &count2);
+  TSequence **result = tsequence_tagg(sequences1, count1, sequences2, count2,
+    func, crossings, newcount);
+  pfree_array((void **) sequences1, count1);
+  pfree_array((void **) sequences2, count2);
+  return result;
+}
+
+/**
+ * @brief Return the sliding window aggregate of a temporal float with linear
+ * interpolation
+ * @details The values are extended by the interval as for the window
+ * aggregates and the extended sequences are aggregated in a balanced way
+ */
+static TSequenceSet *
+tfloat_linear_window(const Temporal *temp, const Interval *interv,
+  WindowFunc func)
+{
+  int count, newcount;
+  TSequence **sequences = (func == WAVG) ?
+    tnumber_transform_wavg(temp, interv, &count) :
+    temporal_extend(temp, interv, (func != WMAX), &count);
+  datum_func2 aggfunc = (func == WMIN) ? &datum_min_float8 :
+    (func == WMAX) ? &datum_max_float8 : &datum_sum_double2;
+  TSequence **merged = tseqarr_tagg_merge(sequences, count, aggfunc,
+    (func != WAVG), &newcount);
+  pfree_array((void **) sequences, count);
+  if (func == WAVG)
+  {
+    TSequenceSet *result = tsequence_tavg_finalfn(merged, newcount);
+    pfree_array((void **) merged, newcount);
+    return result;
+  }
+  return tsequenceset_make_free(merged, newcount, NORMALIZE);
+}
+
+/**
+ * @brief Return the sliding window aggregate of a temporal number
+ * @details The value of the result at a timestamp aggregates the values of
+ * the temporal number that are valid at some timestamp within the interval
+ * preceding it. Except for the minimum, maximum, and average of temporal
+ * floats with linear interpolation, the result is computed in linear time.
+ * @param[in] temp Temporal number
+ * @param[in] interv Interval
+ * @param[in] func Window function
+ */
+static Temporal *
+tnumber_window(const Temporal *temp, const Interval *interv, WindowFunc func)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) interv) ||
+      ! ensure_tnumber_type(temp->temptype) ||
+      ! ensure_valid_duration(interv))
+    return NULL;
+
+  if (MEOS_FLAGS_LINEAR_INTERP(temp->flags) && func == WSUM)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "Operation not supported for temporal continuous float sequences");
+    return NULL;
+  }
+  if (MEOS_FLAGS_LINEAR_INTERP(temp->flags) && func != WCOUNT)
+    return (Temporal *) tfloat_linear_window(temp, interv, func);
+
+  int count = temporal_num_instants(temp);
+  double *values = palloc(sizeof(double) * count);
+  TimestampTz *lower = palloc(sizeof(TimestampTz) * count);
+  TimestampTz *upper = palloc(sizeof(TimestampTz) * count);
+  int k = 0;
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+    {
+      const TInstant *inst = (const TInstant *) temp;
+      values[k] = tnumberinst_double(inst);
+      lower[k] = inst->t;
+      upper[k++] = add_timestamptz_interval(inst->t, interv);
+      break;
+    }
+    case TSEQUENCE:
+      k = tsequence_window_pieces((const TSequence *) temp, interv, values,
+        lower, upper, k);
+      break;
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      for (int i = 0; i < ss->count; i++)
+        k = tsequence_window_pieces(TSEQUENCESET_SEQ_N(ss, i), interv,
+          values, lower, upper, k);
+    }
+  }
+  meosType temptype = (func == WCOUNT) ? T_TINT :
+    (func == WAVG) ? T_TFLOAT : temp->temptype;
+  TSequenceSet *result = window_pieces_sweep(values, lower, upper, k, func,
+    temptype);
+  pfree(values); pfree(lower); pfree(upper);
+  return (Temporal *) result;
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Return the sliding window minimum of a temporal number
+ * @details Applying the temporal minimum aggregate to the results of this
+ * function for several values yields the window minimum aggregate
+ * @param[in] temp Temporal number
+ * @param[in] interv Interval
+ * @csqlfn #Tnumber_wmin()
+ */
+Temporal *
+tnumber_wmin(const Temporal *temp, const Interval *interv)
+{
+  return tnumber_window(temp, interv, WMIN);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Return the sliding window maximum of a temporal number
+ * @param[in] temp Temporal number
+ * @param[in] interv Interval
+ * @csqlfn #Tnumber_wmax()
+ */
+Temporal *
+tnumber_wmax(const Temporal *temp, const Interval *interv)
+{
+  return tnumber_window(temp, interv, WMAX);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Return the sliding window sum of a temporal number
+ * @param[in] temp Temporal number
+ * @param[in] interv Interval
+ * @csqlfn #Tnumber_wsum()
+ */
+Temporal *
+tnumber_wsum(const Temporal *temp, const Interval *interv)
+{
+  return tnumber_window(temp, interv, WSUM);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Return the sliding window count of a temporal number
+ * @param[in] temp Temporal number
+ * @param[in] interv Interval
+ * @csqlfn #Tnumber_wcount()
+ */
+Temporal *
+tnumber_wcount(const Temporal *temp, const Interval *interv)
+{
+  return tnumber_window(temp, interv, WCOUNT);
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Return the sliding window average of a temporal number
+ * @param[in] temp Temporal number
+ * @param[in] interv Interval
+ * @csqlfn #Tnumber_wavg()
+ */
+Temporal *
+tnumber_wavg(const Temporal *temp, const Interval *interv)
+{
+  return tnumber_window(temp, interv, WAVG);
+}
+
 /*****************************************************************************
  * MEOS window aggregate transition functions
  *****************************************************************************/
@@ -128,6 +128,43 @@ tnumberinst_double(const TInstant *inst)
     return DatumGetFloat8(value);
 }
 
+/**
+ * @brief Copy into an array the doubles of the value of a temporal float or
+ * a temporal point
+ * @param[in] value Value
+ * @param[in] temptype Temporal type
+ * @param[in] ndims Number of doubles of the value
+ * @param[out] result Array of doubles
+ */
+void
+datum_doubles(Datum value, meosType temptype, int ndims, double *result)
+{
+  if (temptype == T_TFLOAT)
+    result[0] = DatumGetFloat8(value);
+  else if (ndims == 3)
+  {
+    const POINT3DZ *p = DATUM_POINT3DZ_P(value);
+    result[0] = p->x; result[1] = p->y; result[2] = p->z;
+  }
+  else
+  {
+    const POINT2D *p = DATUM_POINT2D_P(value);
+    result[0] = p->x; result[1] = p->y;
+  }
+  return;
+}
+
+/**
+ * @brief Copy into an array the doubles of the value of an instant of a
+ * temporal float or a temporal point
+ */
+void
+tinstant_doubles(const TInstant *inst, int ndims, double *result)
+{
+  datum_doubles(tinstant_val(inst), inst->temptype, ndims, result);
+  return;
+}
+
 /*****************************************************************************
  * Intput/output functions
  *****************************************************************************/
@@ -289,33 +326,52 @@ tinstant_out(const TInstant *inst, int maxdd)
  */
 TInstant *
 tinstant_make(Datum value, meosType temptype, TimestampTz t)
+{
+  void *mem = palloc(tinstant_make_size(value, temptype));
+  return tinstant_make_in(mem, value, temptype, t);
+}
+
+/**
+ * @brief Return the size in bytes of a temporal instant constructed from the
+ * arguments
+ * @param[in] value Value
+ * @param[in] temptype Temporal type
+ */
+size_t
+tinstant_make_size(Datum value, meosType temptype)
+{
+  meosType basetype = temptype_basetype(temptype);
+  size_t value_offset = sizeof(TInstant) - sizeof(Datum);
+  /* For base types passed by value */
+  if (basetype_byvalue(basetype))
+    return value_offset + DOUBLE_PAD(sizeof(Datum));
+  /* For base types passed by reference */
+  int16 typlen = basetype_length(basetype);
+  return value_offset + ((typlen != -1) ? DOUBLE_PAD((unsigned int) typlen) :
+    DOUBLE_PAD(VARSIZE(DatumGetPointer(value))));
+}
+
+/**
+ * @brief Return a temporal instant from the arguments constructed in a
+ * memory block provided by the calling function
+ * @details This function enables the calling function to construct many
+ * instants in a single memory block, as done by the lifting infrastructure.
+ * @param[out] mem Memory block of at least #tinstant_make_size bytes
+ * @param[in] value Value
+ * @param[in] temptype Temporal type
+ * @param[in] t Timestamp
+ */
+TInstant *
+tinstant_make_in(void *mem, Datum value, meosType temptype, TimestampTz t)
 {
   size_t value_offset = sizeof(TInstant) - sizeof(Datum);
-  size_t size = value_offset;
-  /* Create the temporal instant */
-  size_t value_size;
-  void *value_from;
+  size_t size = tinstant_make_size(value, temptype);
   meosType basetype = temptype_basetype(temptype);
   bool typbyval = basetype_byvalue(basetype);
   /* Copy value */
-  if (typbyval)
-  {
-    /* For base types passed by value */
-    value_size = DOUBLE_PAD(sizeof(Datum));
-    value_from = &value;
-  }
-  else
-  {
-    /* For base types passed by reference */
-    int16 typlen = basetype_length(basetype);
-    value_from = DatumGetPointer(value);
-    value_size = (typlen != -1) ? DOUBLE_PAD((unsigned int) typlen) :
-      DOUBLE_PAD(VARSIZE(value_from));
-  }
-  size += value_size;
-  TInstant *result = palloc0(size);
-  void *value_to = ((char *) result) + value_offset;
-  memcpy(value_to, value_from, value_size);
+  void *value_from = typbyval ? (void *) &value : DatumGetPointer(value);
+  TInstant *result = memset(mem, 0, size);
+  memcpy(((char *) result) + value_offset, value_from, size - value_offset);
   /* Initialize fixed-size values */
   result->temptype = temptype;
   result->subtype = TINSTANT;
@@ -718,15 +774,10 @@ tinstant_cmp(const TInstant *inst1, const TInstant *inst2)
     return -1;
   if (cmp > 0)
     return 1;
-  /* Compare values */
-  if (datum_lt(tinstant_val(inst1), tinstant_val(inst2),
-      temptype_basetype(inst1->temptype)))
-    return -1;
-  if (datum_gt(tinstant_val(inst1), tinstant_val(inst2),
-      temptype_basetype(inst1->temptype)))
-    return 1;
-  /* The two values are equal */
-  return 0;
+  /* Compare values with a single call to the comparison function */
+  cmp = datum_cmp(tinstant_val(inst1), tinstant_val(inst2),
+    temptype_basetype(inst1->temptype));
+  return (cmp < 0) ? -1 : ((cmp > 0) ? 1 : 0);
 }
 
 /*****************************************************************************
@@ -758,4 +809,28 @@ tinstant_hash(const TInstant *inst)
   return result;
 }
 
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return the 64-bit hash value of a temporal instant using a seed
+ * @param[in] inst Temporal instant
+ * @param[in] seed Seed
+ * @csqlfn #Temporal_hash_extended()
+ */
+uint64
+tinstant_hash_extended(const TInstant *inst, uint64 seed)
+{
+  assert(inst);
+  Datum value = tinstant_val(inst);
+  meosType basetype = temptype_basetype(inst->temptype);
+  /* Apply the hash function to the base type */
+  uint64 value_hash = datum_hash_extended(value, basetype, seed);
+  /* Apply the hash function to the timestamp */
+  uint64 time_hash = pg_hashint8extended(inst->t, seed);
+  /* Merge hashes of value and timestamp */
+  uint64 result = value_hash;
+  result = ROTATE_HIGH_AND_LOW_32BITS(result);
+  result ^= time_hash;
+  return result;
+}
+
 /*****************************************************************************/
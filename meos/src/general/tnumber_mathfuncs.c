@@ -142,6 +142,194 @@ tnumber_div_tp_at_timestamptz(const TInstant *start1, const TInstant *end1,
     value, t);
 }
 
+/*****************************************************************************
+ * Fast paths for temporal integers and temporal floats
+ *****************************************************************************/
+
+/**
+ * @brief Apply an arithmetic operator to an array of values and either a
+ * second array of values or a constant
+ */
+#define ARITHOP_VALUES_LOOP(OP) \
+  do { \
+    if (values2) \
+      for (int i = 0; i < count; i++) \
+        values[i] = values[i] OP values2[i]; \
+    else if (invert) \
+      for (int i = 0; i < count; i++) \
+        values[i] = value OP values[i]; \
+    else \
+      for (int i = 0; i < count; i++) \
+        values[i] = values[i] OP value; \
+  } while (0)
+
+/**
+ * @brief Generate a function applying an arithmetic operator to an array of
+ * values of a C type
+ * @details The operator is dispatched once for the whole array so that each
+ * loop only operates on plain arrays and can be vectorized by the compiler
+ */
+#define ARITHOP_VALUES_FUNC(NAME, TYPE) \
+static void \
+NAME(TYPE *values, const TYPE *values2, TYPE value, TArithmetic oper, \
+  bool invert, int count) \
+{ \
+  switch (oper) \
+  { \
+    case ADD: \
+      ARITHOP_VALUES_LOOP(+); \
+      break; \
+    case SUB: \
+      ARITHOP_VALUES_LOOP(-); \
+      break; \
+    case MULT: \
+      ARITHOP_VALUES_LOOP(*); \
+      break; \
+    default: /* DIV */ \
+      ARITHOP_VALUES_LOOP(/); \
+  } \
+  return; \
+}
+
+ARITHOP_VALUES_FUNC(int4arr_arithop, int)
+ARITHOP_VALUES_FUNC(float8arr_arithop, double)
+
+/**
+ * @brief Return true if two temporal number sequences have the same
+ * timestamps, bounds, and interpolation
+ */
+static bool
+tnumberseq_same_timestamps(const TSequence *seq1, const TSequence *seq2)
+{
+  return MEOS_FLAGS_GET_INTERP(seq1->flags) ==
+      MEOS_FLAGS_GET_INTERP(seq2->flags) &&
+    tsequence_same_timestamps(seq1, seq2);
+}
+
+/**
+ * @brief Return true if the arithmetic operator of two temporal numbers can
+ * be applied instant by instant
+ * @details This is the case when the values are sequences or sequence sets
+ * with the same timestamps, bounds, and interpolation, e.g., after they have
+ * been sampled with the same parameters, unless the operator may have turning
+ * points between the instants
+ */
+static bool
+tnumber_arithop_sync(const Temporal *temp1, const Temporal *temp2,
+  TArithmetic oper)
+{
+  if (temp1->subtype != temp2->subtype || temp1->subtype == TINSTANT ||
+      (MEOS_FLAGS_LINEAR_INTERP(temp1->flags) && (oper == MULT || oper == DIV)))
+    return false;
+  if (temp1->subtype == TSEQUENCE)
+    return tnumberseq_same_timestamps((TSequence *) temp1,
+      (TSequence *) temp2);
+  /* TSEQUENCESET */
+  const TSequenceSet *ss1 = (const TSequenceSet *) temp1;
+  const TSequenceSet *ss2 = (const TSequenceSet *) temp2;
+  if (ss1->count != ss2->count)
+    return false;
+  for (int i = 0; i < ss1->count; i++)
+  {
+    if (! tnumberseq_same_timestamps(TSEQUENCESET_SEQ_N(ss1, i),
+        TSEQUENCESET_SEQ_N(ss2, i)))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Return the arithmetic operation of a temporal number sequence and
+ * either a number or a second sequence with the same timestamps
+ * @param[in] seq1 Temporal sequence
+ * @param[in] seq2 Temporal sequence with the same timestamps, may be NULL
+ * @param[in] value Number, used when the second sequence is NULL
+ * @param[in] oper Arithmetic operator
+ * @param[in] invert True if the number is the first argument of the operator
+ * @note The values are processed in typed arrays instead of calling the
+ * generic lifting function for each instant
+ */
+static TSequence *
+tnumberseq_arithop_values(const TSequence *seq1, const TSequence *seq2,
+  Datum value, TArithmetic oper, bool invert)
+{
+  meosType basetype = temptype_basetype(seq1->temptype);
+  int count = seq1->count;
+  /* Compute the values of the result */
+  Datum *resvalues = palloc(sizeof(Datum) * count);
+  if (basetype == T_INT4)
+  {
+    int *values = palloc(sizeof(int) * count * (seq2 ? 2 : 1));
+    int *values2 = seq2 ? values + count : NULL;
+    for (int i = 0; i < count; i++)
+      values[i] = DatumGetInt32(tinstant_val(TSEQUENCE_INST_N(seq1, i)));
+    if (seq2)
+    {
+      for (int i = 0; i < count; i++)
+        values2[i] = DatumGetInt32(tinstant_val(TSEQUENCE_INST_N(seq2, i)));
+    }
+    int4arr_arithop(values, values2, DatumGetInt32(value), oper, invert,
+      count);
+    for (int i = 0; i < count; i++)
+      resvalues[i] = Int32GetDatum(values[i]);
+    pfree(values);
+  }
+  else /* basetype == T_FLOAT8 */
+  {
+    double *values = palloc(sizeof(double) * count * (seq2 ? 2 : 1));
+    double *values2 = seq2 ? values + count : NULL;
+    tnumberseq_values_iter(seq1, values);
+    if (seq2)
+      tnumberseq_values_iter(seq2, values2);
+    float8arr_arithop(values, values2, DatumGetFloat8(value), oper, invert,
+      count);
+    for (int i = 0; i < count; i++)
+      resvalues[i] = Float8GetDatum(values[i]);
+    pfree(values);
+  }
+  /* Construct the instants contiguously and the resulting sequence */
+  size_t size = tinstant_make_size(resvalues[0], seq1->temptype);
+  char *block = palloc(size * count);
+  TInstant **instants = palloc(sizeof(TInstant *) * count);
+  for (int i = 0; i < count; i++)
+    instants[i] = tinstant_make_in(block + size * i, resvalues[i],
+      seq1->temptype, TSEQUENCE_INST_N(seq1, i)->t);
+  TSequence *result = tsequence_make((const TInstant **) instants, count,
+    seq1->period.lower_inc, seq1->period.upper_inc,
+    MEOS_FLAGS_GET_INTERP(seq1->flags), NORMALIZE);
+  pfree(instants); pfree(block); pfree(resvalues);
+  return result;
+}
+
+/**
+ * @brief Return the arithmetic operation of a temporal number sequence or
+ * sequence set and either a number or a second temporal number with the same
+ * timestamps
+ * @param[in] temp1 Temporal number
+ * @param[in] temp2 Temporal number with the same timestamps, may be NULL
+ * @param[in] value Number, used when the second temporal number is NULL
+ * @param[in] oper Arithmetic operator
+ * @param[in] invert True if the number is the first argument of the operator
+ */
+static Temporal *
+tnumber_arithop_values(const Temporal *temp1, const Temporal *temp2,
+  Datum value, TArithmetic oper, bool invert)
+{
+  assert(temp1->subtype != TINSTANT);
+  if (temp1->subtype == TSEQUENCE)
+    return (Temporal *) tnumberseq_arithop_values((TSequence *) temp1,
+      (TSequence *) temp2, value, oper, invert);
+  /* TSEQUENCESET */
+  const TSequenceSet *ss1 = (const TSequenceSet *) temp1;
+  const TSequenceSet *ss2 = (const TSequenceSet *) temp2;
+  TSequence **sequences = palloc(sizeof(TSequence *) * ss1->count);
+  for (int i = 0; i < ss1->count; i++)
+    sequences[i] = tnumberseq_arithop_values(TSEQUENCESET_SEQ_N(ss1, i),
+      ss2 ? TSEQUENCESET_SEQ_N(ss2, i) : NULL, value, oper, invert);
+  return (Temporal *) tsequenceset_make_free(sequences, ss1->count,
+    NORMALIZE);
+}
+
 /*****************************************************************************
  * Generic functions
  *****************************************************************************/
@@ -183,6 +371,10 @@ arithop_tnumber_number(const Temporal *temp, Datum value, TArithmetic oper,
     }
   }
 
+  /* Apply the operator to the values of the sequences in typed arrays */
+  if (temp->subtype != TINSTANT && oper != DIST)
+    return tnumber_arithop_values(temp, NULL, value, oper, invert);
+
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
   lfinfo.func = (varfunc) func;
@@ -234,6 +426,10 @@ arithop_tnumber_tnumber(const Temporal *temp1, const Temporal *temp2,
     }
   }
 
+  /* Apply the operator instant by instant to synchronized values */
+  if (oper != DIST && tnumber_arithop_sync(temp1, temp2, oper))
+    return tnumber_arithop_values(temp1, temp2, (Datum) 0, oper, INVERT_NO);
+
   /* Fill the lifted structure */
   meosType basetype = temptype_basetype(temp1->temptype);
   LiftedFunctionInfo lfinfo;
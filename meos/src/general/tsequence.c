@@ -770,9 +770,11 @@ TSEQUENCE_OFFSETS_PTR(const TSequence *seq)
 const TInstant *
 TSEQUENCE_INST_N(const TSequence *seq, int i)
 {
+  size_t *offsets = TSEQUENCE_OFFSETS_PTR(seq);
   return (const TInstant *)(
     ((char *) &seq->period) + seq->bboxsize +
-    sizeof(size_t) * seq->maxcount + (TSEQUENCE_OFFSETS_PTR(seq))[i] );
+    sizeof(size_t) * TSEQUENCE_NOFFSETS(seq) +
+    (MEOS_FLAGS_GET_FIXED(seq->flags) ? offsets[0] * i : offsets[i]) );
 }
 #endif /* DEBUG_BUILD */
 
@@ -790,6 +792,10 @@ TSEQUENCE_INST_N(const TSequence *seq, int i)
  * @endcode
  * where the @p X are unused bytes added for double padding, @p offset_0 and
  * @p offset_1 are offsets for the corresponding instants.
+ *
+ * When all the instants of a temporal sequence of a base type of fixed size
+ * have the same size, the offsets array is replaced by a single element
+ * @p stride and the n-th instant is located at `n * stride`.
  * @pre @p maxcount is greater than or equal to @p count
  * @note The validity of the arguments has been tested before
  */
@@ -813,20 +819,32 @@ tsequence_make_exp1(const TInstant **instants, int count, int maxcount,
   /* Compute the size of the temporal sequence */
   size_t insts_size = 0;
   /* Size of composing instants */
+  size_t stride = DOUBLE_PAD(VARSIZE(norminsts[0]));
+  meosType temptype = instants[0]->temptype;
+  bool fixed = basetype_byvalue(temptype_basetype(temptype)) ||
+    tgeo_type(temptype);
   for (int i = 0; i < newcount; i++)
-    insts_size += DOUBLE_PAD(VARSIZE(norminsts[i]));
+  {
+    size_t size = DOUBLE_PAD(VARSIZE(norminsts[i]));
+    insts_size += size;
+    if (size != stride)
+      fixed = false;
+  }
   /* Compute the total size for maxcount instants as a proportion of the size
    * of the count instants provided. Note that this is only an initial
    * estimation. The functions adding instants to a sequence must verify both
    * the maximum number of instants and the remaining space for adding an
    * additional variable-length instant of arbitrary size */
   if (count != maxcount)
-    insts_size = DOUBLE_PAD((size_t) ((double) insts_size * maxcount / count));
+    insts_size = fixed ? stride * maxcount :
+      DOUBLE_PAD((size_t) ((double) insts_size * maxcount / count));
   else
     maxcount = newcount;
+  /* Number of elements of the offsets array */
+  int noffsets = fixed ? 1 : maxcount;
   /* Total size of the struct */
   size_t memsize = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
-    sizeof(size_t) * maxcount + insts_size;
+    sizeof(size_t) * noffsets + insts_size;
 
   /* Create the temporal sequence */
   TSequence *result = palloc0(memsize);
@@ -847,6 +865,7 @@ tsequence_make_exp1(const TInstant **instants, int count, int maxcount,
     MEOS_FLAGS_SET_GEODETIC(result->flags,
       MEOS_FLAGS_GET_GEODETIC(instants[0]->flags));
   }
+  MEOS_FLAGS_SET_FIXED(result->flags, fixed);
   /* Initialization of the variable-length part */
   /* Store the bounding box passed as parameter or compute it if not given */
   if (bbox)
@@ -856,13 +875,16 @@ tsequence_make_exp1(const TInstant **instants, int count, int maxcount,
       upper_inc, interp, TSEQUENCE_BBOX_PTR(result));
   /* Store the composing instants */
   size_t pdata = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
-    sizeof(size_t) * maxcount;
+    sizeof(size_t) * noffsets;
   size_t pos = 0;
+  if (fixed)
+    (TSEQUENCE_OFFSETS_PTR(result))[0] = stride;
   for (int i = 0; i < newcount; i++)
   {
     memcpy(((char *) result) + pdata + pos, norminsts[i],
       VARSIZE(norminsts[i]));
-    (TSEQUENCE_OFFSETS_PTR(result))[i] = pos;
+    if (! fixed)
+      (TSEQUENCE_OFFSETS_PTR(result))[i] = pos;
     pos += DOUBLE_PAD(VARSIZE(norminsts[i]));
   }
   if (interp != DISCRETE && normalize && count > 1)
@@ -882,20 +904,31 @@ ensure_increasing_timestamps(const TInstant *inst1, const TInstant *inst2,
 {
   if ((merge && inst1->t > inst2->t) || (! merge && inst1->t >= inst2->t))
   {
-    char *t1 = pg_timestamptz_out(inst1->t);
-    char *t2 = pg_timestamptz_out(inst2->t);
-    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-      "Timestamps for temporal value must be increasing: %s, %s", t1, t2);
+    /* Do not format the timestamps if the message is not used */
+    if (meos_error_quiet())
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE, "");
+    else
+    {
+      char *t1 = pg_timestamptz_out(inst1->t);
+      char *t2 = pg_timestamptz_out(inst2->t);
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "Timestamps for temporal value must be increasing: %s, %s", t1, t2);
+    }
     return false;
   }
   if (merge && inst1->t == inst2->t &&
     ! datum_eq(tinstant_val(inst1), tinstant_val(inst2),
         temptype_basetype(inst1->temptype)))
   {
-    char *t1 = pg_timestamptz_out(inst1->t);
-    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-      "The temporal values have different value at their overlapping instant %s",
-      t1);
+    if (meos_error_quiet())
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE, "");
+    else
+    {
+      char *t1 = pg_timestamptz_out(inst1->t);
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The temporal values have different value at their overlapping instant %s",
+        t1);
+    }
     return false;
   }
   return true;
@@ -1044,10 +1077,44 @@ tsequence_make(const TInstant **instants, int count, bool lower_inc,
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) instants) || ! ensure_positive(count))
     return NULL;
-  return tsequence_make_exp(instants, count, count, lower_inc, upper_inc,
-    interp, normalize);
+  TSequence *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_CONSTRUCTOR,
+    result = tsequence_make_exp(instants, count, count, lower_inc, upper_inc,
+      interp, normalize));
+  return result;
 }
 
+#if MEOS
+/**
+ * @ingroup meos_temporal_constructor
+ * @brief Return in the last argument a temporal sequence from an array of
+ * temporal instants, or return the error code if the arguments are invalid
+ * @details Contrary to #tsequence_make, an invalid argument does not call
+ * the error handler nor formats the error message, which enables the
+ * application to discard invalid records at a low cost.
+ * @param[in] instants Array of instants
+ * @param[in] count Number of elements in the array
+ * @param[in] lower_inc,upper_inc True if the respective bound is inclusive
+ * @param[in] interp Interpolation
+ * @param[in] normalize True if the resulting value should be normalized
+ * @param[out] result Resulting sequence, NULL on error
+ * @return #MEOS_SUCCESS or the error code
+ */
+int
+tsequence_make_try(const TInstant **instants, int count, bool lower_inc,
+  bool upper_inc, interpType interp, bool normalize, TSequence **result)
+{
+  bool quiet = meos_error_quiet_set(true);
+  int last_errno = meos_errno_reset();
+  *result = tsequence_make(instants, count, lower_inc, upper_inc, interp,
+    normalize);
+  meos_error_quiet_set(quiet);
+  if (*result)
+    return meos_errno_restore(last_errno);
+  return meos_errno() ? meos_errno() : meos_errno_set(MEOS_ERR_INTERNAL_ERROR);
+}
+#endif /* MEOS */
+
 /**
  * @brief Return a temporal sequence from an array of temporal instants
  * and free the array and the instants after the creation
@@ -1395,7 +1462,7 @@ tsequence_compact(const TSequence *seq)
   for (int i = 0; i < seq->count; i++)
     insts_size += DOUBLE_PAD(VARSIZE(TSEQUENCE_INST_N(seq, i)));
   size_t seqsize = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra +
-    sizeof(size_t) * seq->count;
+    sizeof(size_t) * (MEOS_FLAGS_GET_FIXED(seq->flags) ? 1 : seq->count);
   /* Create the sequence */
   TSequence *result = palloc0(seqsize + insts_size);
   /* Copy until the last used element of the offsets array */
@@ -1412,6 +1479,72 @@ tsequence_compact(const TSequence *seq)
   return result;
 }
 
+/**
+ * @brief Return the size of a temporal sequence in its packed layout, that
+ * is, without any extra storage space and with the instants stored at a fixed
+ * stride when possible
+ * @param[in] seq Temporal sequence
+ * @param[out] fixed True if the instants can be stored at a fixed stride
+ * @see #tsequence_pack_iter
+ */
+size_t
+tsequence_pack_size(const TSequence *seq, bool *fixed)
+{
+  assert(seq); assert(fixed);
+  size_t stride = DOUBLE_PAD(VARSIZE(TSEQUENCE_INST_N(seq, 0)));
+  *fixed = MEOS_FLAGS_GET_FIXED(seq->flags) ||
+    basetype_byvalue(temptype_basetype(seq->temptype)) ||
+    tgeo_type(seq->temptype);
+  size_t insts_size = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    size_t size = DOUBLE_PAD(VARSIZE(TSEQUENCE_INST_N(seq, i)));
+    insts_size += size;
+    if (size != stride)
+      *fixed = false;
+  }
+  return DOUBLE_PAD(sizeof(TSequence)) + seq->bboxsize - sizeof(Span) +
+    sizeof(size_t) * (*fixed ? 1 : seq->count) + insts_size;
+}
+
+/**
+ * @brief Write a temporal sequence in its packed layout into a buffer
+ * @details This function is called for writing the composing sequences of a
+ * temporal sequence set, which are thus stored without the extra space of
+ * expandable sequences and, when possible, with a single stride instead of
+ * an offset per instant
+ * @param[in] seq Temporal sequence
+ * @param[in] fixed True if the instants are stored at a fixed stride
+ * @param[out] result Buffer of the size given by #tsequence_pack_size,
+ * initialized to zero
+ */
+void
+tsequence_pack_iter(const TSequence *seq, bool fixed, TSequence *result)
+{
+  assert(seq); assert(result);
+  /* Size of the fixed part of the sequence, up to the offsets array */
+  size_t hdrsize = (char *) TSEQUENCE_OFFSETS_PTR(seq) - (char *) seq;
+  int noffsets = fixed ? 1 : seq->count;
+  memcpy(result, seq, hdrsize);
+  result->maxcount = seq->count;
+  MEOS_FLAGS_SET_FIXED(result->flags, fixed);
+  size_t *offsets = TSEQUENCE_OFFSETS_PTR(result);
+  char *data = (char *) offsets + sizeof(size_t) * noffsets;
+  size_t pos = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    memcpy(data + pos, inst, VARSIZE(inst));
+    if (! fixed)
+      offsets[i] = pos;
+    pos += DOUBLE_PAD(VARSIZE(inst));
+  }
+  if (fixed)
+    offsets[0] = DOUBLE_PAD(VARSIZE(TSEQUENCE_INST_N(seq, 0)));
+  SET_VARSIZE(result, (data - (char *) result) + pos);
+  return;
+}
+
 #if MEOS
 /**
  * @ingroup meos_internal_temporal_transf
@@ -2225,6 +2358,25 @@ tsequence_timestamps_iter(const TSequence *seq, TimestampTz *times)
   return seq->count;
 }
 
+/**
+ * @brief Return the array of base values of a temporal number sequence as
+ * doubles (iterator function)
+ * @details Together with #tsequence_timestamps_iter, this function provides
+ * a columnar view of the sequence on which scans can be performed without
+ * accessing the instants
+ * @param[in] seq Temporal sequence
+ * @param[out] values Values
+ * @note This function is called for each sequence of a temporal sequence set
+ */
+int
+tnumberseq_values_iter(const TSequence *seq, double *values)
+{
+  assert(seq); assert(values); assert(tnumber_type(seq->temptype));
+  for (int i = 0; i < seq->count; i++)
+    values[i] = tnumberinst_double(TSEQUENCE_INST_N(seq, i));
+  return seq->count;
+}
+
 /**
  * @ingroup meos_internal_temporal_accessor
  * @brief Return the array of timestamps of a temporal sequence
@@ -2391,10 +2543,259 @@ tsequence_value_at_timestamptz(const TSequence *seq, TimestampTz t, bool strict,
   return true;
 }
 
+/**
+ * @brief Return the index of the last instant of a temporal sequence whose
+ * timestamp is less than or equal to a timestamp using binary search
+ * @param[in] seq Temporal sequence
+ * @param[in] t Timestamp
+ * @result Return -1 if the timestamp is before the first instant
+ */
+static int
+tsequence_find_timestamptz_le(const TSequence *seq, TimestampTz t)
+{
+  int first = 0, last = seq->count - 1, result = -1;
+  while (first <= last)
+  {
+    int middle = (first + last) / 2;
+    if (TSEQUENCE_INST_N(seq, middle)->t <= t)
+    {
+      result = middle;
+      first = middle + 1;
+    }
+    else
+      last = middle - 1;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return in the last arguments (a copy of) the values of a temporal
+ * sequence at an array of timestamptz values
+ * @details The first timestamp is located with binary search and the
+ * following ones with a single merge pass over the instants of the sequence,
+ * which is more efficient than calling #tsequence_value_at_timestamptz or
+ * #tdiscseq_value_at_timestamptz for each timestamp.
+ * @param[in] seq Temporal sequence
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ * @param[in] strict True if inclusive/exclusive bounds are taken into account
+ * @param[out] values Array of values, only set for the timestamps contained
+ * in the sequence
+ * @param[out] found Array of flags stating whether the timestamps are
+ * contained in the sequence
+ * @result Return the number of timestamps contained in the sequence
+ * @pre The timestamps are sorted in ascending order
+ */
+int
+tsequence_values_at_timestamps(const TSequence *seq, const TimestampTz *times,
+  int count, bool strict, Datum *values, bool *found)
+{
+  assert(seq); assert(times); assert(values); assert(found);
+  bool discrete = MEOS_FLAGS_DISCRETE_INTERP(seq->flags);
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  const TInstant *first = TSEQUENCE_INST_N(seq, 0);
+  const TInstant *last = TSEQUENCE_INST_N(seq, seq->count - 1);
+  int n = -1, result = 0;
+  for (int i = 0; i < count; i++)
+  {
+    TimestampTz t = times[i];
+    found[i] = false;
+    /* Timestamps outside the time span of the sequence, the exclusive bounds
+     * are only taken into account for continuous sequences */
+    if (t < first->t || t > last->t)
+      continue;
+    if (! discrete && strict && ! contains_span_timestamptz(&seq->period, t))
+      continue;
+    /* Locate the instant with the first timestamp, since the timestamps are
+     * sorted, the following instants are found by advancing the index */
+    if (n < 0)
+      n = tsequence_find_timestamptz_le(seq, t);
+    else
+    {
+      while (n < seq->count - 1 && TSEQUENCE_INST_N(seq, n + 1)->t <= t)
+        n++;
+    }
+    const TInstant *inst = TSEQUENCE_INST_N(seq, n);
+    if (inst->t == t)
+      values[i] = tinstant_value(inst);
+    else if (discrete)
+      continue;
+    else
+      values[i] = tsegment_value_at_timestamptz(inst,
+        TSEQUENCE_INST_N(seq, n + 1), interp, t);
+    found[i] = true;
+    result++;
+  }
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return in the last argument the slopes of the segments of a
+ * temporal float or a temporal geometry point sequence with linear
+ * interpolation
+ * @details The slopes are the variation per microsecond of each of the
+ * doubles of the values, that is, the value for temporal floats and the
+ * coordinates for temporal points. They allow the values at many timestamps
+ * to be interpolated with a multiplication and an addition each.
+ * @param[in] seq Temporal sequence
+ * @param[out] slopes Array of @p (seq->count - 1) * TEMPORAL_NDOUBLES(seq)
+ * slopes
+ */
+void
+tsequence_segment_slopes(const TSequence *seq, double *slopes)
+{
+  assert(seq); assert(slopes);
+  assert(seq->temptype == T_TFLOAT || seq->temptype == T_TGEOMPOINT);
+  assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags));
+  int ndims = TEMPORAL_NDOUBLES(seq);
+  double start[3], end[3];
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  tinstant_doubles(inst1, ndims, start);
+  for (int i = 1; i < seq->count; i++)
+  {
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+    tinstant_doubles(inst2, ndims, end);
+    double duration = (double) (inst2->t - inst1->t);
+    for (int j = 0; j < ndims; j++)
+    {
+      slopes[(i - 1) * ndims + j] = (end[j] - start[j]) / duration;
+      start[j] = end[j];
+    }
+    inst1 = inst2;
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return in the last arguments the values of a temporal float or a
+ * temporal point sequence at an array of timestamptz values as raw doubles
+ * @details The function is similar to #tsequence_values_at_timestamps but
+ * writes the value or the coordinates of the points into an array of doubles
+ * without constructing a value for each timestamp. When the slopes of the
+ * segments computed by #tsequence_segment_slopes are given, the linear
+ * interpolation uses them instead of computing the ratio of the durations.
+ * @param[in] seq Temporal sequence
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ * @param[in] strict True if inclusive/exclusive bounds are taken into account
+ * @param[in] slopes Slopes of the segments, may be NULL, ignored for
+ * geography points
+ * @param[out] values Array of @p count * TEMPORAL_NDOUBLES(seq) doubles, only
+ * set for the timestamps contained in the sequence
+ * @param[out] found Array of flags stating whether the timestamps are
+ * contained in the sequence
+ * @result Return the number of timestamps contained in the sequence
+ * @pre The timestamps are sorted in ascending order
+ */
+int
+tsequence_doubles_at_timestamps(const TSequence *seq, const TimestampTz *times,
+  int count, bool strict, const double *slopes, double *values, bool *found)
+{
+  assert(seq); assert(times); assert(values); assert(found);
+  assert(seq->temptype == T_TFLOAT || tgeo_type(seq->temptype));
+  bool discrete = MEOS_FLAGS_DISCRETE_INTERP(seq->flags);
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags);
+  bool geodetic = MEOS_FLAGS_GET_GEODETIC(seq->flags);
+  int ndims = TEMPORAL_NDOUBLES(seq);
+  const TInstant *first = TSEQUENCE_INST_N(seq, 0);
+  const TInstant *last = TSEQUENCE_INST_N(seq, seq->count - 1);
+  int n = -1, result = 0;
+  for (int i = 0; i < count; i++)
+  {
+    TimestampTz t = times[i];
+    double *value = &values[i * ndims];
+    found[i] = false;
+    /* Timestamps outside the time span of the sequence, the exclusive bounds
+     * are only taken into account for continuous sequences */
+    if (t < first->t || t > last->t)
+      continue;
+    if (! discrete && strict && ! contains_span_timestamptz(&seq->period, t))
+      continue;
+    /* Locate the instant with the first timestamp, the following instants
+     * are found by advancing the index */
+    if (n < 0)
+      n = tsequence_find_timestamptz_le(seq, t);
+    else
+    {
+      while (n < seq->count - 1 && TSEQUENCE_INST_N(seq, n + 1)->t <= t)
+        n++;
+    }
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq, n);
+    if (inst1->t == t || (! discrete && ! linear))
+      tinstant_doubles(inst1, ndims, value);
+    else if (discrete)
+      continue;
+    else if (slopes && ! geodetic)
+    {
+      tinstant_doubles(inst1, ndims, value);
+      double duration = (double) (t - inst1->t);
+      for (int j = 0; j < ndims; j++)
+        value[j] += slopes[n * ndims + j] * duration;
+    }
+    else
+    {
+      const TInstant *inst2 = TSEQUENCE_INST_N(seq, n + 1);
+      long double ratio = (long double) (t - inst1->t) /
+        (long double) (inst2->t - inst1->t);
+      if (geodetic)
+      {
+        /* Interpolate along the great circle without serializing the point */
+        POINT4D p1, p2, p;
+        datum_point4d(tinstant_val(inst1), &p1);
+        datum_point4d(tinstant_val(inst2), &p2);
+        interpolate_point4d_spheroid(&p1, &p2, &p, NULL, (double) ratio);
+        value[0] = p.x; value[1] = p.y;
+        if (ndims == 3)
+          value[2] = p.z;
+      }
+      else
+      {
+        /* Same computation as #tsegment_value_at_timestamptz */
+        double start[3], end[3];
+        tinstant_doubles(inst1, ndims, start);
+        tinstant_doubles(inst2, ndims, end);
+        for (int j = 0; j < ndims; j++)
+          value[j] = start[j] +
+            (double) ((long double) (end[j] - start[j]) * ratio);
+      }
+    }
+    found[i] = true;
+    result++;
+  }
+  return result;
+}
+
 /*****************************************************************************
  * Synchronization functions
  *****************************************************************************/
 
+/**
+ * @brief Return true if two temporal sequences have the same timestamps and
+ * the same bounds, for example, when they have been sampled on the same grid
+ * @param[in] seq1,seq2 Temporal sequences
+ * @note The temporal types of the arguments may be different
+ */
+bool
+tsequence_same_timestamps(const TSequence *seq1, const TSequence *seq2)
+{
+  assert(seq1); assert(seq2);
+  if (seq1->count != seq2->count ||
+      ! span_eq_int(&seq1->period, &seq2->period))
+    return false;
+  /* The first and last timestamps are equal to the bounds of the periods */
+  for (int i = 1; i < seq1->count - 1; i++)
+  {
+    if (TSEQUENCE_INST_N(seq1, i)->t != TSEQUENCE_INST_N(seq2, i)->t)
+      return false;
+  }
+  return true;
+}
+
 /**
  * @brief Synchronize two temporal sequences
  * @details The resulting values are composed of denormalized sequences
@@ -2423,6 +2824,16 @@ synchronize_tsequence_tsequence(const TSequence *seq1, const TSequence *seq2,
   interpType interp2 = MEOS_FLAGS_GET_INTERP(seq2->flags);
   TInstant *inst1, *inst2;
 
+  /* If the two sequences have the same timestamps and no crossings are
+   * needed, they are already synchronized */
+  if ((! crossings || (interp1 != LINEAR && interp2 != LINEAR)) &&
+      tsequence_same_timestamps(seq1, seq2))
+  {
+    *sync1 = tsequence_copy(seq1);
+    *sync2 = tsequence_copy(seq2);
+    return true;
+  }
+
   /* If the two sequences intersect at an instant */
   if (inter.lower == inter.upper)
   {
@@ -2939,27 +3350,23 @@ tnumberseq_integral(const TSequence *seq)
 {
   assert(seq);
   assert(tnumber_type(seq->temptype));
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags);
+  meosType basetype = temptype_basetype(seq->temptype);
   double result = 0;
   const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  double value1 = datum_double(tinstant_val(inst1), basetype);
   for (int i = 1; i < seq->count; i++)
   {
     const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
-    if (MEOS_FLAGS_LINEAR_INTERP(seq->flags))
-    {
+    double value2 = datum_double(tinstant_val(inst2), basetype);
+    if (linear)
       /* Linear interpolation */
-      double min = Min(DatumGetFloat8(tinstant_val(inst1)),
-        DatumGetFloat8(tinstant_val(inst2)));
-      double max = Max(DatumGetFloat8(tinstant_val(inst1)),
-        DatumGetFloat8(tinstant_val(inst2)));
-      result += (max + min) * (double) (inst2->t - inst1->t) / 2.0;
-    }
+      result += (value1 + value2) * (double) (inst2->t - inst1->t) / 2.0;
     else
-    {
       /* Step interpolation */
-      result += datum_double(tinstant_val(inst1),
-        temptype_basetype(inst1->temptype)) * (double) (inst2->t - inst1->t);
-    }
+      result += value1 * (double) (inst2->t - inst1->t);
     inst1 = inst2;
+    value1 = value2;
   }
   return result;
 }
@@ -3032,8 +3439,10 @@ tsequence_eq(const TSequence *seq1, const TSequence *seq2)
 {
   assert(seq1); assert(seq2);
   assert(seq1->temptype == seq2->temptype);
-  /* If number of sequences, flags, or periods are not equal */
-  if (seq1->count != seq2->count || seq1->flags != seq2->flags ||
+  /* If number of sequences, flags, or periods are not equal. The storage
+   * layout of the instants is not taken into account */
+  if (seq1->count != seq2->count ||
+      (seq1->flags & ~MEOS_FLAG_FIXED) != (seq2->flags & ~MEOS_FLAG_FIXED) ||
       ! span_eq(&seq1->period, &seq2->period))
     return false;
 
@@ -3042,10 +3451,12 @@ tsequence_eq(const TSequence *seq1, const TSequence *seq2)
       seq1->temptype))
     return false;
 
-  /* Compare the composing instants */
+  /* Compare the composing instants, skipping those with the same bytes */
   for (int i = 0; i < seq1->count; i++)
   {
-    if (! tinstant_eq(TSEQUENCE_INST_N(seq1, i), TSEQUENCE_INST_N(seq2, i)))
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq1, i);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq2, i);
+    if (! VARLENA_BYTES_EQ(inst1, inst2) && ! tinstant_eq(inst1, inst2))
       return false;
   }
   return true;
@@ -3067,12 +3478,15 @@ tsequence_cmp(const TSequence *seq1, const TSequence *seq2)
   assert(seq1); assert(seq2);
   assert(seq1->temptype == seq2->temptype);
 
-  /* Compare composing instants */
+  /* Compare composing instants, skipping those with the same bytes */
   int count = Min(seq1->count, seq2->count);
   for (int i = 0; i < count; i++)
   {
-    int result = tinstant_cmp(TSEQUENCE_INST_N(seq1, i),
-      TSEQUENCE_INST_N(seq2, i));
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq1, i);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq2, i);
+    if (VARLENA_BYTES_EQ(inst1, inst2))
+      continue;
+    int result = tinstant_cmp(inst1, inst2);
     if (result)
       return result;
   }
@@ -3097,9 +3511,32 @@ tsequence_cmp(const TSequence *seq1, const TSequence *seq2)
  * bounds.
  *****************************************************************************/
 
+/**
+ * @brief Return the flags of a temporal sequence that are merged into its
+ * hash value
+ * @details Discrete sequences and sequences with a single instant are equal
+ * to instants and to sequence sets composed of single-instant sequences with
+ * the same instants, and thus their hash value only depends on the instants
+ */
+static uint32
+tsequence_hash_flags(const TSequence *seq)
+{
+  if (seq->count == 1 || MEOS_FLAGS_DISCRETE_INTERP(seq->flags))
+    return 0;
+  /* Create flags from the lower_inc, upper_inc, and interpolation values */
+  uint32 flags = (uint32) MEOS_FLAGS_GET_INTERP(seq->flags) << 2;
+  if (seq->period.lower_inc)
+    flags |= 0x01;
+  if (seq->period.upper_inc)
+    flags |= 0x02;
+  return flags;
+}
+
 /**
  * @ingroup meos_internal_temporal_accessor
  * @brief Return the 32-bit hash value of a temporal sequence
+ * @details The hash value is consistent with #temporal_eq(), that is, equal
+ * temporal values have the same hash value whatever their subtype
  * @param[in] seq Temporal sequence
  * @csqlfn #Temporal_hash()
  */
@@ -3107,13 +3544,8 @@ uint32
 tsequence_hash(const TSequence *seq)
 {
   assert(seq);
-  /* Create flags from the lower_inc and upper_inc values */
-  char flags = '\0';
-  if (seq->period.lower_inc)
-    flags |= 0x01;
-  if (seq->period.upper_inc)
-    flags |= 0x02;
-  uint32 result = hash_bytes_uint32((uint32) flags);
+  uint32 flags = tsequence_hash_flags(seq);
+  uint32 result = flags ? hash_bytes_uint32(flags) : 1;
 
   /* Merge with hash of instants */
   for (int i = 0; i < seq->count; i++)
@@ -3124,4 +3556,27 @@ tsequence_hash(const TSequence *seq)
   return result;
 }
 
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return the 64-bit hash value of a temporal sequence using a seed
+ * @param[in] seq Temporal sequence
+ * @param[in] seed Seed
+ * @csqlfn #Temporal_hash_extended()
+ */
+uint64
+tsequence_hash_extended(const TSequence *seq, uint64 seed)
+{
+  assert(seq);
+  uint32 flags = tsequence_hash_flags(seq);
+  uint64 result = flags ? hash_bytes_uint32_extended(flags, seed) : 1;
+
+  /* Merge with hash of instants */
+  for (int i = 0; i < seq->count; i++)
+  {
+    uint64 inst_hash = tinstant_hash_extended(TSEQUENCE_INST_N(seq, i), seed);
+    result = (result << 5) - result + inst_hash;
+  }
+  return result;
+}
+
 /*****************************************************************************/
@@ -328,13 +328,17 @@ tsequenceset_make_exp(const TSequence **sequences, int count, int maxcount,
   /* The period component of the bbox is already declared in the struct */
   size_t bboxsize_extra = bboxsize - sizeof(Span);
 
-  /* Compute the size of the temporal sequence set */
+  /* Compute the size of the temporal sequence set, where the composing
+   * sequences are stored in their packed layout */
   size_t seqs_size = 0;
   int totalcount = 0;
+  size_t *sizes = palloc(sizeof(size_t) * newcount);
+  bool *fixed = palloc(sizeof(bool) * newcount);
   for (int i = 0; i < newcount; i++)
   {
     totalcount += normseqs[i]->count;
-    seqs_size += DOUBLE_PAD(VARSIZE(normseqs[i]));
+    sizes[i] = tsequence_pack_size(normseqs[i], &fixed[i]);
+    seqs_size += DOUBLE_PAD(sizes[i]);
   }
   /* Compute the total size for maxcount sequences as a proportion of the size
    * of the count sequences provided. Note that this is only an initial
@@ -380,11 +384,12 @@ tsequenceset_make_exp(const TSequence **sequences, int count, int maxcount,
   size_t pos = 0;
   for (int i = 0; i < newcount; i++)
   {
-    memcpy(((char *) result) + pdata + pos, normseqs[i],
-      VARSIZE(normseqs[i]));
+    tsequence_pack_iter(normseqs[i], fixed[i],
+      (TSequence *) (((char *) result) + pdata + pos));
     (TSEQUENCESET_OFFSETS_PTR(result))[i] = pos;
-    pos += DOUBLE_PAD(VARSIZE(normseqs[i]));
+    pos += DOUBLE_PAD(sizes[i]);
   }
+  pfree(sizes); pfree(fixed);
   if (normalize && count > 1)
     pfree_array((void **) normseqs, newcount);
   return result;
@@ -406,7 +411,10 @@ tsequenceset_make(const TSequence **sequences, int count, bool normalize)
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) sequences) || ! ensure_positive(count))
     return NULL;
-  return tsequenceset_make_exp(sequences, count, count, normalize);
+  TSequenceSet *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_CONSTRUCTOR,
+    result = tsequenceset_make_exp(sequences, count, count, normalize));
+  return result;
 }
 
 /**
@@ -1366,7 +1374,11 @@ tsequenceset_value_at_timestamptz(const TSequenceSet *ss, TimestampTz t,
       return tsequence_value_at_timestamptz(TSEQUENCESET_SEQ_N(ss, 0), t, false,
         result);
 
-    for (int i = 0; i < ss->count; i++)
+    /* Only the sequence located by binary search and the previous one may
+     * contain the timestamp or have it at an exclusive bound */
+    int loc;
+    tsequenceset_find_timestamptz(ss, t, &loc);
+    for (int i = Max(loc - 1, 0); i <= Min(loc, ss->count - 1); i++)
     {
       const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
       /* Test whether the timestamp is at one of the bounds */
@@ -1398,6 +1410,126 @@ tsequenceset_value_at_timestamptz(const TSequenceSet *ss, TimestampTz t,
     result);
 }
 
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return in the last arguments (a copy of) the values of a temporal
+ * sequence set at an array of timestamptz values
+ * @details The timestamps are split in a single pass among the composing
+ * sequences, which are then processed by #tsequence_values_at_timestamps.
+ * @param[in] ss Temporal sequence set
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ * @param[in] strict True if inclusive/exclusive bounds are taken into account
+ * @param[out] values Array of values, only set for the timestamps contained
+ * in the sequence set
+ * @param[out] found Array of flags stating whether the timestamps are
+ * contained in the sequence set
+ * @result Return the number of timestamps contained in the sequence set
+ * @pre The timestamps are sorted in ascending order
+ */
+int
+tsequenceset_values_at_timestamps(const TSequenceSet *ss,
+  const TimestampTz *times, int count, bool strict, Datum *values, bool *found)
+{
+  assert(ss); assert(times); assert(values); assert(found);
+  int i = 0, result = 0;
+  for (int j = 0; j < ss->count && i < count; j++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, j);
+    TimestampTz upper = DatumGetTimestampTz(seq->period.upper);
+    /* A timestamp at an exclusive upper bound is given to the next sequence
+     * when the bounds are taken into account */
+    bool upper_inc = seq->period.upper_inc || ! strict;
+    int k = i;
+    while (k < count && (times[k] < upper || (upper_inc && times[k] == upper)))
+      k++;
+    if (k > i)
+      result += tsequence_values_at_timestamps(seq, &times[i], k - i, strict,
+        &values[i], &found[i]);
+    i = k;
+  }
+  /* Timestamps after the last sequence */
+  for ( ; i < count; i++)
+    found[i] = false;
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return in the last argument the slopes of the segments of a
+ * temporal float or a temporal geometry point sequence set with linear
+ * interpolation
+ * @details The slopes of the composing sequences are stored one after the
+ * other, as computed by #tsequence_segment_slopes
+ * @param[in] ss Temporal sequence set
+ * @param[out] slopes Array of @p (ss->totalcount - ss->count) *
+ * TEMPORAL_NDOUBLES(ss) slopes
+ */
+void
+tsequenceset_segment_slopes(const TSequenceSet *ss, double *slopes)
+{
+  assert(ss); assert(slopes);
+  int ndims = TEMPORAL_NDOUBLES(ss);
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    tsequence_segment_slopes(seq, slopes);
+    slopes += (seq->count - 1) * ndims;
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return in the last arguments the values of a temporal float or a
+ * temporal point sequence set at an array of timestamptz values as raw
+ * doubles
+ * @details The timestamps are split in a single pass among the composing
+ * sequences, which are then processed by #tsequence_doubles_at_timestamps.
+ * @param[in] ss Temporal sequence set
+ * @param[in] times Array of timestamps
+ * @param[in] count Number of elements in the array
+ * @param[in] strict True if inclusive/exclusive bounds are taken into account
+ * @param[in] slopes Slopes of the segments computed by
+ * #tsequenceset_segment_slopes, may be NULL
+ * @param[out] values Array of @p count * TEMPORAL_NDOUBLES(ss) doubles, only
+ * set for the timestamps contained in the sequence set
+ * @param[out] found Array of flags stating whether the timestamps are
+ * contained in the sequence set
+ * @result Return the number of timestamps contained in the sequence set
+ * @pre The timestamps are sorted in ascending order
+ */
+int
+tsequenceset_doubles_at_timestamps(const TSequenceSet *ss,
+  const TimestampTz *times, int count, bool strict, const double *slopes,
+  double *values, bool *found)
+{
+  assert(ss); assert(times); assert(values); assert(found);
+  int ndims = TEMPORAL_NDOUBLES(ss);
+  int i = 0, result = 0;
+  for (int j = 0; j < ss->count && i < count; j++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, j);
+    TimestampTz upper = DatumGetTimestampTz(seq->period.upper);
+    /* A timestamp at an exclusive upper bound is given to the next sequence
+     * when the bounds are taken into account */
+    bool upper_inc = seq->period.upper_inc || ! strict;
+    int k = i;
+    while (k < count && (times[k] < upper || (upper_inc && times[k] == upper)))
+      k++;
+    if (k > i)
+      result += tsequence_doubles_at_timestamps(seq, &times[i], k - i, strict,
+        slopes, &values[i * ndims], &found[i]);
+    if (slopes)
+      slopes += (seq->count - 1) * ndims;
+    i = k;
+  }
+  /* Timestamps after the last sequence */
+  for ( ; i < count; i++)
+    found[i] = false;
+  return result;
+}
+
 /*****************************************************************************
  * Transformation functions
  *****************************************************************************/
@@ -1414,22 +1546,17 @@ TSequenceSet *
 tsequenceset_compact(const TSequenceSet *ss)
 {
   assert(ss);
-  /* Extra size needed for the bounding box of each sequence */
-  size_t bboxsize_extra = ss->bboxsize - sizeof(Span);
-  /* Size of the fixed-length part of a sequence (set) */
-  size_t seqheader = DOUBLE_PAD(sizeof(TSequence)) + bboxsize_extra;
-  size_t ssheader = DOUBLE_PAD(sizeof(TSequenceSet)) + bboxsize_extra;
-  /* Total size of the composing sequences */
+  /* Size of the fixed-length part of the sequence set */
+  size_t ssheader = DOUBLE_PAD(sizeof(TSequenceSet)) + ss->bboxsize -
+    sizeof(Span);
+  /* Total size of the composing sequences in their packed layout */
   size_t seqs_size = 0;
-  /* Array keeping the total size of the instants of each composing sequence */
-  size_t *insts_size = palloc0(sizeof(size_t) * ss->count);
-  const TSequence *seq;
+  size_t *sizes = palloc(sizeof(size_t) * ss->count);
+  bool *fixed = palloc(sizeof(bool) * ss->count);
   for (int i = 0; i < ss->count; i++)
   {
-    seq = TSEQUENCESET_SEQ_N(ss, i);
-    for (int j = 0; j < seq->count; j++)
-      insts_size[i] += DOUBLE_PAD(VARSIZE(TSEQUENCE_INST_N(seq, j)));
-    seqs_size += seqheader + sizeof(size_t) * seq->count + insts_size[i];
+    sizes[i] = tsequence_pack_size(TSEQUENCESET_SEQ_N(ss, i), &fixed[i]);
+    seqs_size += DOUBLE_PAD(sizes[i]);
   }
   /* Compute the total size of the sequence set */
   size_t ss_size = ssheader + sizeof(size_t) * ss->count + seqs_size;
@@ -1446,32 +1573,12 @@ tsequenceset_compact(const TSequenceSet *ss)
   size_t pos = 0;
   for (int i = 0; i < ss->count; i++)
   {
-    seq = TSEQUENCESET_SEQ_N(ss, i);
-    size_t pdata_seq = seqheader + sizeof(size_t) * seq->count;
-    /* Copy the entire sequence if it has no extra space */
-    if (seq->count == seq->maxcount)
-      memcpy(((char *) result) + pdata_ss + pos, seq, VARSIZE(seq));
-    else
-    {
-      /* Copy until the last used element of the offsets array */
-      memcpy(((char *) result) + pdata_ss + pos, seq, pdata_seq);
-      /* Set the size and maxcount of the compacted sequence */
-      TSequence *resultseq = (TSequence *) ((char *) result + pdata_ss + pos);
-      SET_VARSIZE(resultseq, pdata_seq + insts_size[i]);
-      resultseq->maxcount = seq->count;
-      /* Copy the instants */
-      memcpy(((char *) result) + pdata_ss + pos + pdata_seq,
-        ((char *) seq) + seqheader + sizeof(size_t) * seq->maxcount,
-        insts_size[i]);
-#if DEBUG_EXPAND
-      meos_error(WARNING, 0, " Sequence -> %d ", seq->count);
-#endif
-    }
-    /* Set the offset */
+    tsequence_pack_iter(TSEQUENCESET_SEQ_N(ss, i), fixed[i],
+      (TSequence *) (((char *) result) + pdata_ss + pos));
     (TSEQUENCESET_OFFSETS_PTR(result))[i] = pos;
-    pos += pdata_seq + insts_size[i];
+    pos += DOUBLE_PAD(sizes[i]);
   }
-  pfree(insts_size);
+  pfree(sizes); pfree(fixed);
   return result;
 }
 
@@ -2302,10 +2409,12 @@ tsequenceset_eq(const TSequenceSet *ss1, const TSequenceSet *ss2)
       TSEQUENCESET_BBOX_PTR(ss2), ss1->temptype))
     return false;
 
-  /* Compare the composing sequences */
+  /* Compare the composing sequences, skipping those with the same bytes */
   for (int i = 0; i < ss1->count; i++)
   {
-    if (! tsequence_eq(TSEQUENCESET_SEQ_N(ss1, i), TSEQUENCESET_SEQ_N(ss2, i)))
+    const TSequence *seq1 = TSEQUENCESET_SEQ_N(ss1, i);
+    const TSequence *seq2 = TSEQUENCESET_SEQ_N(ss2, i);
+    if (! VARLENA_BYTES_EQ(seq1, seq2) && ! tsequence_eq(seq1, seq2))
       return false;
   }
   return true;
@@ -2331,8 +2440,11 @@ tsequenceset_cmp(const TSequenceSet *ss1, const TSequenceSet *ss2)
   int count = Min(ss1->count, ss2->count);
   for (int i = 0; i < count; i++)
   {
-    int result = tsequence_cmp(TSEQUENCESET_SEQ_N(ss1, i),
-      TSEQUENCESET_SEQ_N(ss2, i));
+    const TSequence *seq1 = TSEQUENCESET_SEQ_N(ss1, i);
+    const TSequence *seq2 = TSEQUENCESET_SEQ_N(ss2, i);
+    if (VARLENA_BYTES_EQ(seq1, seq2))
+      continue;
+    int result = tsequence_cmp(seq1, seq2);
     if (result)
       return result;
   }
@@ -2352,9 +2464,28 @@ tsequenceset_cmp(const TSequenceSet *ss1, const TSequenceSet *ss2)
  * the elements.
  *****************************************************************************/
 
+/**
+ * @brief Return true if all the sequences of a temporal sequence set have a
+ * single instant
+ */
+static bool
+tsequenceset_instants_p(const TSequenceSet *ss)
+{
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (TSEQUENCESET_SEQ_N(ss, i)->count > 1)
+      return false;
+  }
+  return true;
+}
+
 /**
  * @ingroup meos_internal_temporal_accessor
  * @brief Return the 32-bit hash value of a temporal sequence set
+ * @details The hash value is consistent with #temporal_eq(): a sequence set
+ * with a single sequence has the hash value of the sequence and a sequence
+ * set composed of single-instant sequences has the hash value of the
+ * discrete sequence with the same instants
  * @param[in] ss Temporal sequence set
  * @csqlfn #Temporal_hash()
  */
@@ -2362,10 +2493,41 @@ uint32
 tsequenceset_hash(const TSequenceSet *ss)
 {
   assert(ss);
+  if (ss->count == 1)
+    return tsequence_hash(TSEQUENCESET_SEQ_N(ss, 0));
+  bool instants = tsequenceset_instants_p(ss);
   uint32 result = 1;
   for (int i = 0; i < ss->count; i++)
   {
-    uint32 seq_hash = tsequence_hash(TSEQUENCESET_SEQ_N(ss, i));
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    uint32 seq_hash = instants ? tinstant_hash(TSEQUENCE_INST_N(seq, 0)) :
+      tsequence_hash(seq);
+    result = (result << 5) - result + seq_hash;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_accessor
+ * @brief Return the 64-bit hash value of a temporal sequence set using a seed
+ * @param[in] ss Temporal sequence set
+ * @param[in] seed Seed
+ * @csqlfn #Temporal_hash_extended()
+ */
+uint64
+tsequenceset_hash_extended(const TSequenceSet *ss, uint64 seed)
+{
+  assert(ss);
+  if (ss->count == 1)
+    return tsequence_hash_extended(TSEQUENCESET_SEQ_N(ss, 0), seed);
+  bool instants = tsequenceset_instants_p(ss);
+  uint64 result = 1;
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    uint64 seq_hash = instants ?
+      tinstant_hash_extended(TSEQUENCE_INST_N(seq, 0), seed) :
+      tsequence_hash_extended(seq, seed);
     result = (result << 5) - result + seq_hash;
   }
   return result;
@@ -41,7 +41,10 @@
   #include "varatt.h"
 #endif
 /* MEOS */
+#include <meos_internal.h>
 #include "general/lifting.h"
+#include "general/set.h"
+#include "general/type_util.h"
 
 /*****************************************************************************
  * Generic functions on temporal texts
@@ -122,3 +125,128 @@ textfunc_ttext_ttext(const Temporal *temp1, const Temporal *temp2,
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Dictionary encoding
+ *****************************************************************************/
+
+/**
+ * @brief Return the code of a text value in a dictionary
+ * @details The code is the 1-based position of the value in the ordered set,
+ * so that the code order is the order of the texts
+ * @note The value must belong to the dictionary
+ */
+static Datum
+datum_dict_encode(Datum value, Datum dict)
+{
+  int loc;
+  set_find_value((Set *) DatumGetPointer(dict), value, &loc);
+  return Int32GetDatum(loc + 1);
+}
+
+/**
+ * @brief Return the text value of a code in a dictionary
+ * @note The code must be between 1 and the number of values of the dictionary
+ */
+static Datum
+datum_dict_decode(Datum code, Datum dict)
+{
+  return datum_copy(SET_VAL_N((Set *) DatumGetPointer(dict), DatumGetInt32(code) - 1),
+    T_TEXT);
+}
+
+/**
+ * @brief Apply a dictionary encoding or decoding function to a temporal value
+ */
+static Temporal *
+tdict_func(const Temporal *temp, const Set *dict, bool encode)
+{
+  LiftedFunctionInfo lfinfo;
+  memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
+  lfinfo.func = encode ? (varfunc) &datum_dict_encode :
+    (varfunc) &datum_dict_decode;
+  lfinfo.numparam = 1;
+  lfinfo.param[0] = PointerGetDatum(dict);
+  lfinfo.argtype[0] = encode ? T_TTEXT : T_TINT;
+  lfinfo.restype = encode ? T_TINT : T_TTEXT;
+  lfinfo.tpfunc_base = NULL;
+  lfinfo.tpfunc = NULL;
+  return tfunc_temporal(temp, &lfinfo);
+}
+
+/**
+ * @ingroup meos_temporal_text
+ * @brief Return a temporal text encoded as a temporal integer whose values
+ * are the positions of the texts in a dictionary
+ * @details Since the dictionary is an ordered set, the order of the codes is
+ * the order of the texts. Therefore, comparisons, restrictions to values,
+ * and minimum or maximum computations can be performed on the integer codes,
+ * which avoids the repeated comparison of varlena values, and the texts are
+ * only decoded when needed with #tint_dict_decode.
+ * @param[in] temp Temporal value
+ * @param[in] dict Text set, e.g., obtained with @p ttext_values
+ * @csqlfn #Ttext_dict_encode()
+ */
+Temporal *
+ttext_dict_encode(const Temporal *temp, const Set *dict)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) dict) ||
+      ! ensure_temporal_isof_type(temp, T_TTEXT) ||
+      ! ensure_set_isof_type(dict, T_TEXTSET))
+    return NULL;
+
+  /* Ensure that all the values are in the dictionary */
+  int count, loc;
+  Datum *values = temporal_vals(temp, &count);
+  for (int i = 0; i < count; i++)
+  {
+    if (! set_find_value(dict, values[i], &loc))
+    {
+      pfree(values);
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The values of the temporal text must belong to the dictionary");
+      return NULL;
+    }
+  }
+  pfree(values);
+  return tdict_func(temp, dict, true);
+}
+
+/**
+ * @ingroup meos_temporal_text
+ * @brief Return a temporal integer of dictionary codes decoded as a temporal
+ * text
+ * @param[in] temp Temporal value
+ * @param[in] dict Text set used for the encoding
+ * @csqlfn #Tint_dict_decode()
+ */
+Temporal *
+tint_dict_decode(const Temporal *temp, const Set *dict)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) dict) ||
+      ! ensure_temporal_isof_type(temp, T_TINT) ||
+      ! ensure_set_isof_type(dict, T_TEXTSET))
+    return NULL;
+
+  /* Ensure that all the codes are valid positions in the dictionary */
+  int count;
+  Datum *values = temporal_vals(temp, &count);
+  for (int i = 0; i < count; i++)
+  {
+    int code = DatumGetInt32(values[i]);
+    if (code < 1 || code > dict->count)
+    {
+      pfree(values);
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The values of the temporal integer must be between 1 and %d",
+        dict->count);
+      return NULL;
+    }
+  }
+  pfree(values);
+  return tdict_func(temp, dict, false);
+}
+
+/*****************************************************************************/
@@ -34,15 +34,19 @@
 
 /* C */
 #include <assert.h>
+#include <ctype.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include "utils/timestamp.h"
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/meos_probes.h"
 #include "general/set.h"
 #include "general/span.h"
 #include "general/tbox.h"
+#include "general/tinstant.h"
+#include "general/type_util.h"
 #include "point/stbox.h"
 #include "point/tpoint_spatialfuncs.h"
 #if NPOINT
@@ -73,7 +77,13 @@ typedef struct
   bool geodetic;          /**< Geodetic? */
   bool has_srid;          /**< SRID? */
   interpType interp;      /**< Interpolation */
+  bool compressed;        /**< Compressed encoding? */
   const uint8_t *pos;     /**< Current parse position */
+  char *block;            /**< Optional block in which the instants of a
+                               sequence are constructed */
+  size_t blocksize;       /**< Size of the block */
+  size_t blockused;       /**< Number of bytes used in the block */
+  size_t instsize;        /**< Largest size of the instants constructed */
 } wkb_parse_state;
 
 /*****************************************************************************
@@ -768,6 +778,750 @@ ensure_temptype_mfjson(const char *typestr)
   return true;
 }
 
+/*****************************************************************************
+ * Streaming input in MF-JSON representation
+ *****************************************************************************/
+
+/** Maximum nesting level of the members skipped by the streaming parser */
+#define MFJSON_MAX_DEPTH 64
+
+/**
+ * @brief Structure keeping the values of a temporal sequence read by the
+ * streaming MF-JSON parser
+ */
+typedef struct
+{
+  char kind;              /**< Kind of values: 'b', 'n', 's', or 'c' */
+  bool integers;          /**< True when all the numbers are integers */
+  int dim;                /**< Number of doubles per value */
+  int nvalues;            /**< Number of values */
+  int maxvalues;          /**< Maximum number of values */
+  double *values;         /**< Booleans, numbers, or coordinates */
+  const char **strs;      /**< Strings, pointing into the input */
+  int *strlens;           /**< Length of the strings */
+  int ntimes;             /**< Number of timestamps */
+  int maxtimes;           /**< Maximum number of timestamps */
+  TimestampTz *times;     /**< Timestamps */
+  bool lower_inc;         /**< Lower bound flag */
+  bool upper_inc;         /**< Upper bound flag */
+} mfjson_seq_state;
+
+/**
+ * @brief Structure keeping the members of an MF-JSON document read by the
+ * streaming parser
+ */
+typedef struct
+{
+  const char *type;       /**< Value of the 'type' member */
+  int typelen;            /**< Length of the 'type' member */
+  const char *interp;     /**< Value of the 'interpolation' member */
+  int interplen;          /**< Length of the 'interpolation' member */
+  const char *srs;        /**< Name of the 'crs' member */
+  int srslen;             /**< Length of the name of the 'crs' member */
+  bool crstype;           /**< True when the 'crs' member has a type */
+  mfjson_seq_state top;   /**< Values of an instant or a sequence */
+  bool hasseqs;           /**< True when there is a 'sequences' member */
+  int nseqs;              /**< Number of sequences */
+  int maxseqs;            /**< Maximum number of sequences */
+  mfjson_seq_state *seqs; /**< Values of the sequences */
+} mfjson_doc_state;
+
+/**
+ * @brief Skip the white space of an MF-JSON string
+ */
+static inline const char *
+mfjson_ws(const char *p)
+{
+  while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+    p++;
+  return p;
+}
+
+/**
+ * @brief Consume a character of an MF-JSON string
+ */
+static inline bool
+mfjson_char(const char **pos, char c)
+{
+  const char *p = mfjson_ws(*pos);
+  if (*p != c)
+    return false;
+  *pos = p + 1;
+  return true;
+}
+
+/**
+ * @brief Read a string without escape sequences of an MF-JSON string
+ * @return False for strings with escape sequences, which are left to the
+ * json-c parser
+ */
+static bool
+mfjson_string(const char **pos, const char **str, int *len)
+{
+  const char *p = mfjson_ws(*pos);
+  if (*p != '"')
+    return false;
+  const char *start = ++p;
+  while (*p && *p != '"')
+  {
+    if (*p == '\\')
+      return false;
+    p++;
+  }
+  if (! *p)
+    return false;
+  *str = start;
+  *len = (int) (p - start);
+  *pos = p + 1;
+  return true;
+}
+
+/**
+ * @brief Read a number of an MF-JSON string
+ */
+static bool
+mfjson_number(const char **pos, double *d, bool *isint)
+{
+  const char *p = mfjson_ws(*pos);
+  if (*p != '-' && ! isdigit((unsigned char) *p))
+    return false;
+  char *end;
+  *d = strtod(p, &end);
+  if (end == p)
+    return false;
+  *isint = true;
+  for (const char *q = p; q < end; q++)
+  {
+    if (*q == '.' || *q == 'e' || *q == 'E')
+      *isint = false;
+  }
+  *pos = end;
+  return true;
+}
+
+/**
+ * @brief Read a Boolean of an MF-JSON string
+ */
+static bool
+mfjson_bool(const char **pos, bool *b)
+{
+  const char *p = mfjson_ws(*pos);
+  if (strncmp(p, "true", 4) == 0)
+  {
+    *b = true;
+    *pos = p + 4;
+    return true;
+  }
+  if (strncmp(p, "false", 5) == 0)
+  {
+    *b = false;
+    *pos = p + 5;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Advance to the next element of an MF-JSON array
+ * @return 1 if there is another element, 0 at the end of the array, and -1
+ * on error
+ */
+static int
+mfjson_array_next(const char **pos, bool first)
+{
+  const char *p = mfjson_ws(*pos);
+  if (*p == ']')
+  {
+    *pos = p + 1;
+    return 0;
+  }
+  if (! first)
+  {
+    if (*p != ',')
+      return -1;
+    p++;
+  }
+  *pos = p;
+  return 1;
+}
+
+/**
+ * @brief Advance to the next member of an MF-JSON object and read its key
+ * @return 1 if there is another member, 0 at the end of the object, and -1
+ * on error
+ */
+static int
+mfjson_object_next(const char **pos, bool first, const char **key, int *len)
+{
+  const char *p = mfjson_ws(*pos);
+  if (*p == '}')
+  {
+    *pos = p + 1;
+    return 0;
+  }
+  if (! first)
+  {
+    if (*p != ',')
+      return -1;
+    p++;
+  }
+  if (! mfjson_string(&p, key, len) || ! mfjson_char(&p, ':'))
+    return -1;
+  *pos = p;
+  return 1;
+}
+
+/**
+ * @brief Return true if the key of an MF-JSON member is equal to a name,
+ * ignoring case as done by #findMemberByName()
+ */
+static inline bool
+mfjson_key_eq(const char *key, int len, const char *name)
+{
+  return (size_t) len == strlen(name) && pg_strncasecmp(key, name, len) == 0;
+}
+
+/**
+ * @brief Return true if a string of an MF-JSON string is equal to a name
+ */
+static inline bool
+mfjson_str_eq(const char *str, int len, const char *name)
+{
+  return (size_t) len == strlen(name) && strncmp(str, name, len) == 0;
+}
+
+/**
+ * @brief Skip a value of an MF-JSON string
+ */
+static bool
+mfjson_skip_value(const char **pos, int depth)
+{
+  const char *p = mfjson_ws(*pos);
+  if (depth > MFJSON_MAX_DEPTH)
+    return false;
+  if (*p == '"')
+  {
+    for (p++; *p && *p != '"'; p++)
+    {
+      if (*p == '\\' && ! *(++p))
+        return false;
+    }
+    if (! *p)
+      return false;
+    *pos = p + 1;
+    return true;
+  }
+  if (*p == '[' || *p == '{')
+  {
+    bool isobj = (*p == '{');
+    p++;
+    for (bool first = true; ; first = false)
+    {
+      const char *key;
+      int len;
+      int next = isobj ? mfjson_object_next(&p, first, &key, &len) :
+        mfjson_array_next(&p, first);
+      if (next < 0)
+        return false;
+      if (next == 0)
+        break;
+      if (! mfjson_skip_value(&p, depth + 1))
+        return false;
+    }
+    *pos = p;
+    return true;
+  }
+  /* Numbers, Booleans, and null */
+  const char *start = p;
+  while (isalnum((unsigned char) *p) || *p == '-' || *p == '+' || *p == '.')
+    p++;
+  if (p == start)
+    return false;
+  *pos = p;
+  return true;
+}
+
+/**
+ * @brief Ensure that there is space for an additional value in the state
+ * of a sequence read by the streaming MF-JSON parser
+ */
+static void
+mfjson_seq_enlarge(mfjson_seq_state *state)
+{
+  if (state->nvalues < state->maxvalues)
+    return;
+  state->maxvalues = state->maxvalues ? state->maxvalues * 2 : 64;
+  state->values = state->values ?
+    repalloc(state->values, sizeof(double) * 3 * state->maxvalues) :
+    palloc(sizeof(double) * 3 * state->maxvalues);
+  if (state->kind == 's')
+  {
+    state->strs = state->strs ?
+      repalloc(state->strs, sizeof(char *) * state->maxvalues) :
+      palloc(sizeof(char *) * state->maxvalues);
+    state->strlens = state->strlens ?
+      repalloc(state->strlens, sizeof(int) * state->maxvalues) :
+      palloc(sizeof(int) * state->maxvalues);
+  }
+  return;
+}
+
+/**
+ * @brief Read the 'values' or the 'coordinates' array of an MF-JSON string
+ * into the state of a sequence
+ */
+static bool
+mfjson_values_parse(const char **pos, mfjson_seq_state *state, bool coords)
+{
+  if (state->nvalues || ! mfjson_char(pos, '['))
+    return false;
+  state->integers = true;
+  for (bool first = true; ; first = false)
+  {
+    int next = mfjson_array_next(pos, first);
+    if (next < 0)
+      return false;
+    if (next == 0)
+      break;
+    const char *p = mfjson_ws(*pos);
+    char kind = coords ? 'c' : (*p == '"') ? 's' :
+      (*p == 't' || *p == 'f') ? 'b' : 'n';
+    if (first)
+      state->kind = kind;
+    else if (kind != state->kind)
+      return false;
+    mfjson_seq_enlarge(state);
+    double *values = state->values + 3 * state->nvalues;
+    bool isint;
+    if (kind == 'c')
+    {
+      /* Read an array of 2 or 3 coordinates */
+      int dim = 0;
+      if (! mfjson_char(&p, '['))
+        return false;
+      for (bool firstc = true; ; firstc = false)
+      {
+        next = mfjson_array_next(&p, firstc);
+        if (next < 0 || (next > 0 && dim == 3))
+          return false;
+        if (next == 0)
+          break;
+        if (! mfjson_number(&p, &values[dim++], &isint))
+          return false;
+      }
+      if (dim < 2 || (! first && dim != state->dim))
+        return false;
+      state->dim = dim;
+    }
+    else if (kind == 's')
+    {
+      if (! mfjson_string(&p, &state->strs[state->nvalues],
+          &state->strlens[state->nvalues]))
+        return false;
+    }
+    else if (kind == 'b')
+    {
+      bool b;
+      if (! mfjson_bool(&p, &b))
+        return false;
+      values[0] = b ? 1.0 : 0.0;
+    }
+    else
+    {
+      if (! mfjson_number(&p, &values[0], &isint))
+        return false;
+      state->integers &= isint;
+    }
+    state->nvalues++;
+    *pos = p;
+  }
+  return true;
+}
+
+/**
+ * @brief Read the 'datetimes' array of an MF-JSON string into the state of a
+ * sequence
+ */
+static bool
+mfjson_datetimes_parse(const char **pos, mfjson_seq_state *state)
+{
+  if (state->ntimes || ! mfjson_char(pos, '['))
+    return false;
+  for (bool first = true; ; first = false)
+  {
+    int next = mfjson_array_next(pos, first);
+    if (next < 0)
+      return false;
+    if (next == 0)
+      break;
+    const char *str;
+    int len;
+    char datetime[64];
+    if (! mfjson_string(pos, &str, &len) || len <= 10 ||
+        len >= (int) sizeof(datetime))
+      return false;
+    if (state->ntimes == state->maxtimes)
+    {
+      state->maxtimes = state->maxtimes ? state->maxtimes * 2 : 64;
+      state->times = state->times ?
+        repalloc(state->times, sizeof(TimestampTz) * state->maxtimes) :
+        palloc(sizeof(TimestampTz) * state->maxtimes);
+    }
+    memcpy(datetime, str, len);
+    datetime[len] = '\0';
+    /* Replace 'T' by ' ' before converting to timestamptz */
+    datetime[10] = ' ';
+    /* The last argument is for an unused typmod */
+    state->times[state->ntimes++] = pg_timestamptz_in(datetime, -1);
+  }
+  return true;
+}
+
+/**
+ * @brief Read a member of an MF-JSON object that is kept in the state of a
+ * sequence
+ * @return 1 if the member is kept in the state, 0 if it is not, and -1 on
+ * error
+ */
+static int
+mfjson_seq_member_parse(const char **pos, const char *key, int len,
+  mfjson_seq_state *state)
+{
+  if (mfjson_key_eq(key, len, "values") ||
+      mfjson_key_eq(key, len, "coordinates"))
+    return mfjson_values_parse(pos, state,
+      mfjson_key_eq(key, len, "coordinates")) ? 1 : -1;
+  if (mfjson_key_eq(key, len, "datetimes"))
+    return mfjson_datetimes_parse(pos, state) ? 1 : -1;
+  if (mfjson_key_eq(key, len, "lower_inc"))
+    return mfjson_bool(pos, &state->lower_inc) ? 1 : -1;
+  if (mfjson_key_eq(key, len, "upper_inc"))
+    return mfjson_bool(pos, &state->upper_inc) ? 1 : -1;
+  return 0;
+}
+
+/**
+ * @brief Read the 'crs' member of an MF-JSON string
+ */
+static bool
+mfjson_crs_parse(const char **pos, mfjson_doc_state *doc)
+{
+  if (! mfjson_char(pos, '{'))
+    return false;
+  for (bool first = true; ; first = false)
+  {
+    const char *key;
+    int len;
+    int next = mfjson_object_next(pos, first, &key, &len);
+    if (next < 0)
+      return false;
+    if (next == 0)
+      return true;
+    if (mfjson_key_eq(key, len, "type"))
+      doc->crstype = true;
+    if (! mfjson_key_eq(key, len, "properties"))
+    {
+      if (! mfjson_skip_value(pos, 1))
+        return false;
+      continue;
+    }
+    if (! mfjson_char(pos, '{'))
+      return false;
+    for (bool firstp = true; ; firstp = false)
+    {
+      next = mfjson_object_next(pos, firstp, &key, &len);
+      if (next < 0)
+        return false;
+      if (next == 0)
+        break;
+      if (mfjson_key_eq(key, len, "name"))
+      {
+        if (! mfjson_string(pos, &doc->srs, &doc->srslen))
+          return false;
+      }
+      else if (! mfjson_skip_value(pos, 2))
+        return false;
+    }
+  }
+}
+
+/**
+ * @brief Read the 'sequences' member of an MF-JSON string
+ */
+static bool
+mfjson_sequences_parse(const char **pos, mfjson_doc_state *doc)
+{
+  if (doc->hasseqs || ! mfjson_char(pos, '['))
+    return false;
+  doc->hasseqs = true;
+  for (bool first = true; ; first = false)
+  {
+    int next = mfjson_array_next(pos, first);
+    if (next < 0)
+      return false;
+    if (next == 0)
+      return true;
+    if (doc->nseqs == doc->maxseqs)
+    {
+      doc->maxseqs = doc->maxseqs ? doc->maxseqs * 2 : 16;
+      doc->seqs = doc->seqs ?
+        repalloc(doc->seqs, sizeof(mfjson_seq_state) * doc->maxseqs) :
+        palloc(sizeof(mfjson_seq_state) * doc->maxseqs);
+    }
+    mfjson_seq_state *state = &doc->seqs[doc->nseqs++];
+    memset(state, 0, sizeof(mfjson_seq_state));
+    state->lower_inc = state->upper_inc = true;
+    if (! mfjson_char(pos, '{'))
+      return false;
+    for (bool firstm = true; ; firstm = false)
+    {
+      const char *key;
+      int len;
+      next = mfjson_object_next(pos, firstm, &key, &len);
+      if (next < 0)
+        return false;
+      if (next == 0)
+        break;
+      int kept = mfjson_seq_member_parse(pos, key, len, state);
+      if (kept < 0 || (kept == 0 && ! mfjson_skip_value(pos, 2)))
+        return false;
+    }
+  }
+}
+
+/**
+ * @brief Read an MF-JSON document in a single pass
+ */
+static bool
+mfjson_doc_parse(const char **pos, mfjson_doc_state *doc)
+{
+  doc->top.lower_inc = doc->top.upper_inc = true;
+  if (! mfjson_char(pos, '{'))
+    return false;
+  for (bool first = true; ; first = false)
+  {
+    const char *key;
+    int len;
+    int next = mfjson_object_next(pos, first, &key, &len);
+    if (next < 0)
+      return false;
+    if (next == 0)
+      return true;
+    int kept = mfjson_seq_member_parse(pos, key, len, &doc->top);
+    if (kept < 0)
+      return false;
+    if (kept > 0)
+      continue;
+    bool ok;
+    if (mfjson_key_eq(key, len, "type"))
+      ok = ! doc->type && mfjson_string(pos, &doc->type, &doc->typelen);
+    else if (mfjson_key_eq(key, len, "interpolation"))
+      ok = ! doc->interp && mfjson_string(pos, &doc->interp, &doc->interplen);
+    else if (mfjson_key_eq(key, len, "crs"))
+      ok = mfjson_crs_parse(pos, doc);
+    else if (mfjson_key_eq(key, len, "sequences"))
+      ok = mfjson_sequences_parse(pos, doc);
+    else
+      ok = mfjson_skip_value(pos, 1);
+    if (! ok)
+      return false;
+  }
+}
+
+/**
+ * @brief Free the state of a sequence read by the streaming MF-JSON parser
+ */
+static void
+mfjson_seq_free(mfjson_seq_state *state)
+{
+  if (state->values) pfree(state->values);
+  if (state->strs) pfree(state->strs);
+  if (state->strlens) pfree(state->strlens);
+  if (state->times) pfree(state->times);
+  return;
+}
+
+/**
+ * @brief Return the array of temporal instants of a sequence read by the
+ * streaming MF-JSON parser
+ * @return On values that do not correspond to the temporal type return
+ * @p NULL
+ */
+static TInstant **
+mfjson_seq_instants(const mfjson_seq_state *state, meosType temptype,
+  int srid)
+{
+  char kind = tgeo_type(temptype) ? 'c' : (temptype == T_TBOOL) ? 'b' :
+    (temptype == T_TTEXT) ? 's' : 'n';
+  if (state->nvalues < 1 || state->nvalues != state->ntimes ||
+      state->kind != kind || (temptype == T_TINT && ! state->integers))
+    return NULL;
+  if (temptype == T_TINT)
+  {
+    for (int i = 0; i < state->nvalues; i++)
+    {
+      if (state->values[3 * i] < PG_INT32_MIN ||
+          state->values[3 * i] > PG_INT32_MAX)
+        return NULL;
+    }
+  }
+  TInstant **result = palloc(sizeof(TInstant *) * state->nvalues);
+  for (int i = 0; i < state->nvalues; i++)
+  {
+    const double *values = state->values + 3 * i;
+    Datum value;
+    switch (temptype)
+    {
+      case T_TBOOL:
+        value = BoolGetDatum(values[0] != 0.0);
+        break;
+      case T_TINT:
+        value = Int32GetDatum((int32) values[0]);
+        break;
+      case T_TFLOAT:
+        value = Float8GetDatum(values[0]);
+        break;
+      case T_TTEXT:
+      {
+        text *txt = palloc(state->strlens[i] + VARHDRSZ);
+        SET_VARSIZE(txt, state->strlens[i] + VARHDRSZ);
+        memcpy(VARDATA(txt), state->strs[i], state->strlens[i]);
+        value = PointerGetDatum(txt);
+        break;
+      }
+      default: /* T_TGEOMPOINT, T_TGEOGPOINT */
+      {
+        LWPOINT *point = (state->dim == 3) ?
+          lwpoint_make3dz(srid, values[0], values[1], values[2]) :
+          lwpoint_make2d(srid, values[0], values[1]);
+        FLAGS_SET_GEODETIC(point->flags, temptype == T_TGEOGPOINT);
+        value = PointerGetDatum(geo_serialize((LWGEOM *) point));
+        lwpoint_free(point);
+      }
+    }
+    result[i] = tinstant_make_free(value, temptype, state->times[i]);
+  }
+  return result;
+}
+
+/**
+ * @brief Return a temporal value from an MF-JSON document read by the
+ * streaming parser
+ * @return On a document that is not handled by the streaming parser return
+ * @p NULL
+ */
+static Temporal *
+mfjson_doc_temporal(const mfjson_doc_state *doc, meosType temptype)
+{
+  if (! doc->type || ! doc->interp)
+    return NULL;
+  /* Determine the temporal type */
+  meosType jtemptype;
+  if (mfjson_str_eq(doc->type, doc->typelen, "MovingBoolean"))
+    jtemptype = T_TBOOL;
+  else if (mfjson_str_eq(doc->type, doc->typelen, "MovingInteger"))
+    jtemptype = T_TINT;
+  else if (mfjson_str_eq(doc->type, doc->typelen, "MovingFloat"))
+    jtemptype = T_TFLOAT;
+  else if (mfjson_str_eq(doc->type, doc->typelen, "MovingText"))
+    jtemptype = T_TTEXT;
+  else if (mfjson_str_eq(doc->type, doc->typelen, "MovingPoint"))
+    jtemptype = (temptype == T_TGEOGPOINT) ? T_TGEOGPOINT : T_TGEOMPOINT;
+  else
+    return NULL;
+  if (temptype != T_UNKNOWN && jtemptype != temptype)
+    return NULL;
+  temptype = jtemptype;
+
+  /* Determine the SRID */
+  int srid = 0;
+  if (tgeo_type(temptype))
+  {
+    if (doc->srs && doc->crstype)
+    {
+      char srs[64];
+      if (doc->srslen >= (int) sizeof(srs))
+        return NULL;
+      memcpy(srs, doc->srs, doc->srslen);
+      srs[doc->srslen] = '\0';
+      sscanf(srs, "EPSG:%d", &srid);
+    }
+    else if (temptype == T_TGEOGPOINT)
+      srid = 4326;
+  }
+
+  /* Determine the interpolation */
+  interpType interp;
+  if (mfjson_str_eq(doc->interp, doc->interplen, "None"))
+    interp = INTERP_NONE;
+  else if (mfjson_str_eq(doc->interp, doc->interplen, "Discrete"))
+    interp = DISCRETE;
+  else if (mfjson_str_eq(doc->interp, doc->interplen, "Step"))
+    interp = STEP;
+  else if (mfjson_str_eq(doc->interp, doc->interplen, "Linear"))
+    interp = LINEAR;
+  else
+    return NULL;
+
+  /* Construct the temporal value */
+  if (interp == INTERP_NONE || interp == DISCRETE || ! doc->hasseqs)
+  {
+    if (interp == INTERP_NONE && doc->top.nvalues != 1)
+      return NULL;
+    TInstant **instants = mfjson_seq_instants(&doc->top, temptype, srid);
+    if (! instants)
+      return NULL;
+    if (interp == INTERP_NONE)
+    {
+      TInstant *result = instants[0];
+      pfree(instants);
+      return (Temporal *) result;
+    }
+    return (Temporal *) tsequence_make_free(instants, doc->top.nvalues,
+      doc->top.lower_inc, doc->top.upper_inc, interp, NORMALIZE);
+  }
+  if (doc->nseqs < 1)
+    return NULL;
+  TSequence **sequences = palloc(sizeof(TSequence *) * doc->nseqs);
+  for (int i = 0; i < doc->nseqs; i++)
+  {
+    TInstant **instants = mfjson_seq_instants(&doc->seqs[i], temptype, srid);
+    if (! instants)
+    {
+      pfree_array((void **) sequences, i);
+      return NULL;
+    }
+    sequences[i] = tsequence_make_free(instants, doc->seqs[i].nvalues,
+      doc->seqs[i].lower_inc, doc->seqs[i].upper_inc, interp, NORMALIZE);
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, doc->nseqs, NORMALIZE);
+}
+
+/**
+ * @brief Return a temporal value from its MF-JSON representation read in a
+ * single pass without constructing a json-c document
+ * @details Only the subset of MF-JSON output by MEOS is handled, that is,
+ * without escape sequences in strings. On any other input, including
+ * invalid input, the function returns @p NULL and the caller falls back to
+ * the json-c parser, which reports the errors.
+ */
+static Temporal *
+temporal_from_mfjson_stream(const char *mfjson, meosType temptype)
+{
+  mfjson_doc_state doc;
+  memset(&doc, 0, sizeof(mfjson_doc_state));
+  const char *pos = mfjson;
+  Temporal *result = NULL;
+  if (mfjson_doc_parse(&pos, &doc) && *mfjson_ws(pos) == '\0')
+    result = mfjson_doc_temporal(&doc, temptype);
+  mfjson_seq_free(&doc.top);
+  for (int i = 0; i < doc.nseqs; i++)
+    mfjson_seq_free(&doc.seqs[i]);
+  if (doc.seqs)
+    pfree(doc.seqs);
+  return result;
+}
+
 /**
  * @ingroup meos_temporal_inout
  * @brief Return a temporal object from its MF-JSON representation
@@ -785,9 +1539,14 @@ temporal_from_mfjson(const char *mfjson, meosType temptype)
   if (! ensure_not_null((void *) mfjson))
     return NULL;
 
+  /* Try first the streaming parser, which returns NULL for the input that
+   * must be parsed with json-c */
+  Temporal *result = temporal_from_mfjson_stream(mfjson, temptype);
+  if (result)
+    return result;
+
   char *srs = NULL;
   int srid = 0;
-  Temporal *result = NULL;
 
   json_tokener *jstok = NULL;
   json_object *poObj = NULL;
@@ -1218,6 +1977,21 @@ text_from_wkb_state(wkb_parse_state *s)
   return result;
 }
 
+/**
+ * @brief Return a point from its coordinates using the SRID, Z, and geodetic
+ * flags of the parse state
+ */
+static Datum
+point_from_coords_wkb_state(wkb_parse_state *s, double x, double y, double z)
+{
+  LWPOINT *point = s->hasz ? lwpoint_make3dz(s->srid, x, y, z) :
+    lwpoint_make2d(s->srid, x, y);
+  FLAGS_SET_GEODETIC(point->flags, s->geodetic);
+  Datum result = PointerGetDatum(geo_serialize((LWGEOM *) point));
+  lwpoint_free(point);
+  return result;
+}
+
 /**
  * @brief Return a point from its WKB representation
  * @note A WKB point has just a set of doubles, with the quantity depending on
@@ -1231,12 +2005,7 @@ point_from_wkb_state(wkb_parse_state *s)
   y = double_from_wkb_state(s);
   if (s->hasz)
     z = double_from_wkb_state(s);
-  LWPOINT *point = s->hasz ? lwpoint_make3dz(s->srid, x, y, z) :
-    lwpoint_make2d(s->srid, x, y);
-  FLAGS_SET_GEODETIC(point->flags, s->geodetic);
-  Datum result = PointerGetDatum(geo_serialize((LWGEOM *) point));
-  lwpoint_free(point);
-  return result;
+  return point_from_coords_wkb_state(s, x, y, z);
 }
 
 #if NPOINT
@@ -1584,6 +2353,7 @@ temporal_flags_from_wkb_state(wkb_parse_state *s, uint8_t wkb_flags)
     if (wkb_flags & MEOS_WKB_SRIDFLAG)
       s->has_srid = true;
   }
+  s->compressed = (wkb_flags & MEOS_WKB_COMPRESSEDFLAG) != 0;
   /* Mask off the upper flags to get the subtype */
   wkb_flags &= (uint8_t) 0x03;
   switch (wkb_flags)
@@ -1605,6 +2375,92 @@ temporal_flags_from_wkb_state(wkb_parse_state *s, uint8_t wkb_flags)
   return;
 }
 
+/**
+ * @brief Prepare the instant block of the parse state for the instants of a
+ * sequence
+ * @details The block is only used by the bulk input functions, which reuse
+ * it across the sequences instead of calling palloc for each instant. Since
+ * the block is empty when a sequence starts, it can be enlarged without
+ * moving any instant. Its size is estimated from the largest instant
+ * constructed so far, the instants that do not fit in it are allocated with
+ * palloc.
+ */
+static void
+instblock_reserve(wkb_parse_state *s, int count)
+{
+  if (! s->block)
+    return;
+  s->blockused = 0;
+  size_t size = s->instsize * count;
+  if (size > s->blocksize)
+  {
+    pfree(s->block);
+    s->block = palloc(size);
+    s->blocksize = size;
+  }
+  return;
+}
+
+/**
+ * @brief Return true if a temporal instant is located in the instant block
+ * of the parse state
+ */
+static inline bool
+instblock_owns(const wkb_parse_state *s, const TInstant *inst)
+{
+  return s->block && (const char *) inst >= s->block &&
+    (const char *) inst < s->block + s->blocksize;
+}
+
+/**
+ * @brief Return a temporal instant constructed in the instant block of the
+ * parse state, or allocated with palloc when there is no block or it is full,
+ * and free the base value
+ */
+static TInstant *
+tinstant_make_wkb_state(wkb_parse_state *s, Datum value, TimestampTz t)
+{
+  if (s->block)
+  {
+    size_t size = tinstant_make_size(value, s->temptype);
+    s->instsize = Max(s->instsize, size);
+    if (s->blockused + size <= s->blocksize)
+    {
+      TInstant *result = tinstant_make_in(s->block + s->blockused, value,
+        s->temptype, t);
+      s->blockused += size;
+      DATUM_FREE(value, s->basetype);
+      return result;
+    }
+  }
+  return tinstant_make_free(value, s->temptype, t);
+}
+
+/**
+ * @brief Return a temporal sequence from an array of instants constructed
+ * with #tinstant_make_wkb_state, and free the array and the instants that
+ * are not in the instant block
+ * @see #tsequence_make_free
+ */
+static TSequence *
+tsequence_make_wkb_state(wkb_parse_state *s, TInstant **instants, int count,
+  bool lower_inc, bool upper_inc)
+{
+  if (! s->block)
+    return tsequence_make_free(instants, count, lower_inc, upper_inc,
+      s->interp, NORMALIZE);
+  TSequence *result = tsequence_make((const TInstant **) instants, count,
+    lower_inc, upper_inc, s->interp, NORMALIZE);
+  for (int i = 0; i < count; i++)
+  {
+    if (! instblock_owns(s, instants[i]))
+      pfree(instants[i]);
+  }
+  pfree(instants);
+  s->blockused = 0;
+  return result;
+}
+
 /**
  * @brief Return a temporal instant from its WKB representation
  * @details The function reads the base type value and the timestamp and
@@ -1633,11 +2489,144 @@ tinstarr_from_wkb_state(wkb_parse_state *s, int count)
     /* Parse the point and the timestamp to create the instant point */
     Datum value = basevalue_from_wkb_state(s);
     TimestampTz t = timestamp_from_wkb_state(s);
-    result[i] = tinstant_make_free(value, s->temptype, t);
+    result[i] = tinstant_make_wkb_state(s, value, t);
+  }
+  return result;
+}
+
+/**
+ * @brief Read an unsigned varint of the compressed encoding and advance the
+ * parse state forward
+ */
+static uint64
+varint_from_wkb_state(wkb_parse_state *s)
+{
+  uint64 result = 0;
+  int shift = 0;
+  uint8_t b;
+  do
+  {
+    if (shift > 63)
+    {
+      meos_error(ERROR, MEOS_ERR_WKB_INPUT, "Invalid varint in WKB string");
+      return 0;
+    }
+    b = byte_from_wkb_state(s);
+    result |= (uint64) (b & 0x7F) << shift;
+    shift += 7;
+  } while (b & 0x80);
+  return result;
+}
+
+/**
+ * @brief Read a zigzag-encoded signed varint of the compressed encoding and
+ * advance the parse state forward
+ */
+static int64
+zigzag_from_wkb_state(wkb_parse_state *s)
+{
+  uint64 u = varint_from_wkb_state(s);
+  return (int64) ((u >> 1) ^ (~(u & 1) + 1));
+}
+
+/**
+ * @brief Read the XOR of two doubles of the compressed encoding and advance
+ * the parse state forward
+ */
+static uint64
+xor_from_wkb_state(wkb_parse_state *s)
+{
+  uint8_t header = byte_from_wkb_state(s);
+  int lead = header >> 4, trail = header & 0x0F;
+  if (lead + trail > 8)
+  {
+    meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+      "Invalid XOR header in WKB string: %d", header);
+    return 0;
   }
+  uint64 result = 0;
+  for (int i = 7 - lead; i >= trail; i--)
+    result |= (uint64) byte_from_wkb_state(s) << (8 * i);
+  return result;
+}
+
+/**
+ * @brief Read a double of the compressed encoding given the bits of the
+ * previous one and advance the parse state forward
+ */
+static double
+double_from_wkb_state_delta(wkb_parse_state *s, uint64 *prev)
+{
+  *prev ^= xor_from_wkb_state(s);
+  double result;
+  memcpy(&result, prev, sizeof(double));
   return result;
 }
 
+/**
+ * @brief Return a temporal instant from its compressed WKB representation
+ * and advance the state
+ * @see #tinstant_wkb_delta_codes()
+ */
+static TInstant *
+tinstant_from_wkb_state_delta(wkb_parse_state *s, WkbDeltaState *state)
+{
+  Datum value;
+  switch (s->basetype)
+  {
+    case T_INT4:
+    case T_INT8:
+    case T_DATE:
+    case T_TIMESTAMPTZ:
+    {
+      state->ival = (int64) ((uint64) state->ival +
+        (uint64) zigzag_from_wkb_state(s));
+      if (s->basetype == T_INT4)
+        value = Int32GetDatum((int32) state->ival);
+      else if (s->basetype == T_DATE)
+        value = DateADTGetDatum((DateADT) state->ival);
+      else if (s->basetype == T_INT8)
+        value = Int64GetDatum(state->ival);
+      else
+        value = TimestampTzGetDatum((TimestampTz) state->ival);
+      break;
+    }
+    case T_FLOAT8:
+      value = Float8GetDatum(double_from_wkb_state_delta(s, &state->dval[0]));
+      break;
+    case T_GEOMETRY:
+    case T_GEOGRAPHY:
+    {
+      double x = double_from_wkb_state_delta(s, &state->dval[0]);
+      double y = double_from_wkb_state_delta(s, &state->dval[1]);
+      double z = s->hasz ? double_from_wkb_state_delta(s, &state->dval[2]) : 0;
+      value = point_from_coords_wkb_state(s, x, y, z);
+      break;
+    }
+#if NPOINT
+    case T_NPOINT:
+    {
+      state->ival = (int64) ((uint64) state->ival +
+        (uint64) zigzag_from_wkb_state(s));
+      double pos = double_from_wkb_state_delta(s, &state->dval[0]);
+      Npoint *np = palloc(sizeof(Npoint));
+      npoint_set(state->ival, pos, np);
+      value = PointerGetDatum(np);
+      break;
+    }
+#endif /* NPOINT */
+    default: /* Standard encoding */
+      value = basevalue_from_wkb_state(s);
+      break;
+  }
+  int64 dt = (int64) ((uint64) zigzag_from_wkb_state(s) + (uint64) state->dt);
+  TimestampTz t = (TimestampTz) ((uint64) state->t + (uint64) dt);
+  state->t = t;
+  state->dt = state->count ? dt : 0;
+  state->count++;
+  return tinstant_make_wkb_state(s, value, t);
+}
+
 /**
  * @brief Return a temporal sequence value from its WKB representation
  */
@@ -1645,16 +2634,27 @@ static TSequence *
 tsequence_from_wkb_state(wkb_parse_state *s)
 {
   /* Get the number of instants */
-  int count = int32_from_wkb_state(s);
+  int count = s->compressed ? (int) varint_from_wkb_state(s) :
+    int32_from_wkb_state(s);
   assert(count > 0);
   /* Get the period bounds */
   uint8_t wkb_bounds = (uint8_t) byte_from_wkb_state(s);
   bool lower_inc, upper_inc;
   bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
   /* Parse the instants */
-  TInstant **instants = tinstarr_from_wkb_state(s, count);
-  return tsequence_make_free(instants, count, lower_inc, upper_inc, s->interp,
-    NORMALIZE);
+  instblock_reserve(s, count);
+  TInstant **instants;
+  if (s->compressed)
+  {
+    WkbDeltaState state;
+    memset(&state, 0, sizeof(WkbDeltaState));
+    instants = palloc(sizeof(TInstant *) * count);
+    for (int i = 0; i < count; i++)
+      instants[i] = tinstant_from_wkb_state_delta(s, &state);
+  }
+  else
+    instants = tinstarr_from_wkb_state(s, count);
+  return tsequence_make_wkb_state(s, instants, count, lower_inc, upper_inc);
 }
 
 /**
@@ -1664,29 +2664,40 @@ static TSequenceSet *
 tsequenceset_from_wkb_state(wkb_parse_state *s)
 {
   /* Get the number of sequences */
-  int count = int32_from_wkb_state(s);
+  int count = s->compressed ? (int) varint_from_wkb_state(s) :
+    int32_from_wkb_state(s);
   assert(count > 0);
+  /* The state of the compressed encoding is kept across the sequences */
+  WkbDeltaState state;
+  memset(&state, 0, sizeof(WkbDeltaState));
   /* Parse the sequences */
   TSequence **sequences = palloc(sizeof(TSequence *) * count);
   for (int i = 0; i < count; i++)
   {
     /* Get the number of instants */
-    int ninst = int32_from_wkb_state(s);
+    int ninst = s->compressed ? (int) varint_from_wkb_state(s) :
+      int32_from_wkb_state(s);
     /* Get the period bounds */
     uint8_t wkb_bounds = (uint8_t) byte_from_wkb_state(s);
     bool lower_inc, upper_inc;
     bounds_from_wkb_state(wkb_bounds, &lower_inc, &upper_inc);
     /* Parse the instants */
+    instblock_reserve(s, ninst);
     TInstant **instants = palloc(sizeof(TInstant *) * ninst);
     for (int j = 0; j < ninst; j++)
     {
+      if (s->compressed)
+      {
+        instants[j] = tinstant_from_wkb_state_delta(s, &state);
+        continue;
+      }
       /* Parse the value and the timestamp to create the temporal instant */
       Datum value = basevalue_from_wkb_state(s);
       TimestampTz t = timestamp_from_wkb_state(s);
-      instants[j] = tinstant_make_free(value, s->temptype, t);
+      instants[j] = tinstant_make_wkb_state(s, value, t);
     }
-    sequences[i] = tsequence_make_free(instants, ninst, lower_inc, upper_inc,
-      s->interp, NORMALIZE);
+    sequences[i] = tsequence_make_wkb_state(s, instants, ninst, lower_inc,
+      upper_inc);
   }
   return tsequenceset_make_free(sequences, count, NORMALIZE);
 }
@@ -1728,32 +2739,45 @@ temporal_from_wkb_state(wkb_parse_state *s)
 /*****************************************************************************/
 
 /**
- * @brief Return a value from its Well-Known Binary (WKB) representation
+ * @brief Read the endian flag starting a WKB value and set the parse state
+ * accordingly
+ * @return On error return false
  */
-static Datum
-datum_from_wkb(const uint8_t *wkb, size_t size, meosType type)
+static bool
+wkb_parse_state_endian(wkb_parse_state *s)
 {
-  /* Initialize the state appropriately */
-  wkb_parse_state s;
-  memset(&s, 0, sizeof(wkb_parse_state));
-  s.wkb = s.pos = wkb;
-  s.wkb_size = size;
   /* Fail when handed incorrect starting byte */
-  uint8_t wkb_little_endian = byte_from_wkb_state(&s);
+  uint8_t wkb_little_endian = byte_from_wkb_state(s);
   if (wkb_little_endian != 1 && wkb_little_endian != 0)
   {
     meos_error(ERROR, MEOS_ERR_WKB_INPUT,
         "Invalid endian flag value in WKB string.");
-    return 0;
+    return false;
   }
   /* Check the endianness of our input */
-  s.swap_bytes = false;
+  s->swap_bytes = false;
   /* Machine arch is big endian, request is for little */
   if (MEOS_IS_BIG_ENDIAN && wkb_little_endian)
-    s.swap_bytes = true;
+    s->swap_bytes = true;
   /* Machine arch is little endian, request is for big */
   else if ((! MEOS_IS_BIG_ENDIAN) && (! wkb_little_endian))
-    s.swap_bytes = true;
+    s->swap_bytes = true;
+  return true;
+}
+
+/**
+ * @brief Return a value from its Well-Known Binary (WKB) representation
+ */
+static Datum
+datum_from_wkb(const uint8_t *wkb, size_t size, meosType type)
+{
+  /* Initialize the state appropriately */
+  wkb_parse_state s;
+  memset(&s, 0, sizeof(wkb_parse_state));
+  s.wkb = s.pos = wkb;
+  s.wkb_size = size;
+  if (! wkb_parse_state_endian(&s))
+    return 0;
 
   /* Call the type-specific function */
   s.type = type;
@@ -1990,8 +3014,12 @@ temporal_from_wkb(const uint8_t *wkb, size_t size)
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) wkb))
     return NULL;
+  MEOS_PROBE_WKB_READ(size);
   /* We pass ANY temporal type, the actual type is read from the byte string */
-  return DatumGetTemporalP(datum_from_wkb(wkb, size, T_TINT));
+  Temporal *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_IO,
+    result = DatumGetTemporalP(datum_from_wkb(wkb, size, T_TINT)));
+  return result;
 }
 
 /**
@@ -2010,7 +3038,407 @@ temporal_from_hexwkb(const char *hexwkb)
     return NULL;
   size_t size = strlen(hexwkb);
   /* We pass ANY temporal type, the actual type is read from the byte string */
-  return DatumGetTemporalP(datum_from_hexwkb(hexwkb, size, T_TINT));
+  Temporal *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_IO,
+    result = DatumGetTemporalP(datum_from_hexwkb(hexwkb, size, T_TINT)));
+  return result;
+}
+
+#if MEOS
+/*****************************************************************************
+ * Bulk WKB and HexWKB input functions for temporal types
+ * The values of a buffer are parsed one after the other with a single parse
+ * state, whose instant block is reused across the sequences, and copied into
+ * an arena provided by the caller, so that the per-value allocations are
+ * freed as soon as the value is parsed.
+ *****************************************************************************/
+
+/** Initial size of the instant block of the bulk input functions */
+#define WKB_BULK_BLOCK_SIZE 8192
+/** Initial size of the buffer for the bytes of a HexWKB value */
+#define WKB_BULK_BUFFER_SIZE 1024
+
+/** Value of the hexadecimal digits, 0xFF for the other characters */
+static const uint8_t HEXVAL[256] =
+{
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+    0,  1,  2,  3,  4,  5,  6,  7,  8,  9,255,255,255,255,255,255,
+  255, 10, 11, 12, 13, 14, 15,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255, 10, 11, 12, 13, 14, 15,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255
+};
+
+/**
+ * @brief Parse a temporal value from its WKB representation and copy it into
+ * an arena
+ * @param[in,out] s Parse state, whose instant block is kept
+ * @param[in] wkb WKB value, possibly followed by other values
+ * @param[in] size Size of the buffer
+ * @param[in,out] arena Arena
+ * @param[out] result Temporal value in the arena
+ * @param[out] length Number of bytes of the WKB value
+ * @return 1 if the value has been read, 0 if it does not fit in the arena,
+ * and -1 on error
+ */
+static int
+temporal_from_wkb_arena(wkb_parse_state *s, const uint8_t *wkb, size_t size,
+  meosArena *arena, Temporal **result, size_t *length)
+{
+  /* Reset the state of the previous value, keeping the instant block */
+  char *block = s->block;
+  size_t blocksize = s->blocksize, instsize = s->instsize;
+  memset(s, 0, sizeof(wkb_parse_state));
+  s->block = block;
+  s->blocksize = blocksize;
+  s->instsize = instsize;
+  s->wkb = s->pos = wkb;
+  s->wkb_size = size;
+  s->type = T_TINT;
+  if (! wkb_parse_state_endian(s))
+    return -1;
+  Temporal *temp = temporal_from_wkb_state(s);
+  if (meos_errno())
+    return -1;
+
+  /* Copy the value into the arena, keeping the alignment of the values */
+  size_t start = DOUBLE_PAD(arena->used);
+  size_t tsize = VARSIZE(temp);
+  if (start > arena->size || tsize > arena->size - start)
+  {
+    pfree(temp);
+    return 0;
+  }
+  *result = memcpy(arena->data + start, temp, tsize);
+  arena->used = start + tsize;
+  pfree(temp);
+  *length = (size_t) (s->pos - wkb);
+  return 1;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the number of temporal values read from a buffer of
+ * consecutive Well-Known Binary (WKB) values, which are stored in an arena
+ * @details The function stops when the buffer is exhausted, when @p count
+ * values have been read, or when the next value does not fit in the arena.
+ * In the latter case, the reading can be resumed with another arena from the
+ * position of the buffer given by @p consumed.
+ * @param[in] wkb Buffer of WKB values
+ * @param[in] size Size of the buffer
+ * @param[in,out] arena Arena in which the values are stored, whose memory
+ * block must be aligned on 8 bytes
+ * @param[out] result Array of at least @p count values
+ * @param[in] count Maximum number of values read
+ * @param[out] consumed Number of bytes of the buffer that have been read
+ * @return On error return -1
+ * @see #temporal_from_wkb()
+ */
+int
+temporal_from_wkb_bulk(const uint8_t *wkb, size_t size, meosArena *arena,
+  Temporal **result, int count, size_t *consumed)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) wkb) || ! ensure_not_null((void *) arena) ||
+      ! ensure_not_null((void *) result) ||
+      ! ensure_not_null((void *) consumed) || ! ensure_positive(count))
+    return -1;
+  MEOS_PROBE_WKB_READ(size);
+
+  wkb_parse_state s;
+  memset(&s, 0, sizeof(wkb_parse_state));
+  s.block = palloc(WKB_BULK_BLOCK_SIZE);
+  s.blocksize = WKB_BULK_BLOCK_SIZE;
+  meos_errno_reset();
+  size_t pos = 0;
+  int n = 0;
+  while (n < count && pos < size)
+  {
+    size_t length;
+    int found = temporal_from_wkb_arena(&s, wkb + pos, size - pos, arena,
+      &result[n], &length);
+    if (found <= 0)
+    {
+      if (found < 0)
+        n = -1;
+      break;
+    }
+    pos += length;
+    n++;
+  }
+  pfree(s.block);
+  *consumed = pos;
+  return n;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the number of temporal values read from a buffer of
+ * hex-encoded ASCII Well-Known Binary (WKB) values, which are stored in an
+ * arena
+ * @details The values are separated by any character that is not an
+ * hexadecimal digit, such as the line feeds of a file with one value per
+ * line. The function stops when the buffer is exhausted, when @p count
+ * values have been read, or when the next value does not fit in the arena.
+ * In the latter case, the reading can be resumed with another arena from the
+ * position of the buffer given by @p consumed.
+ * @param[in] hexwkb Buffer of HexWKB values, which is not necessarily
+ * terminated by a null character
+ * @param[in] size Size of the buffer
+ * @param[in,out] arena Arena in which the values are stored, whose memory
+ * block must be aligned on 8 bytes
+ * @param[out] result Array of at least @p count values
+ * @param[in] count Maximum number of values read
+ * @param[out] consumed Number of characters of the buffer that have been read
+ * @return On error return -1
+ * @see #temporal_from_hexwkb()
+ */
+int
+temporal_from_hexwkb_bulk(const char *hexwkb, size_t size, meosArena *arena,
+  Temporal **result, int count, size_t *consumed)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) hexwkb) ||
+      ! ensure_not_null((void *) arena) ||
+      ! ensure_not_null((void *) result) ||
+      ! ensure_not_null((void *) consumed) || ! ensure_positive(count))
+    return -1;
+
+  wkb_parse_state s;
+  memset(&s, 0, sizeof(wkb_parse_state));
+  s.block = palloc(WKB_BULK_BLOCK_SIZE);
+  s.blocksize = WKB_BULK_BLOCK_SIZE;
+  size_t maxbytes = WKB_BULK_BUFFER_SIZE;
+  uint8_t *bytes = palloc(maxbytes);
+  meos_errno_reset();
+  size_t pos = 0;
+  int n = 0;
+  while (n < count)
+  {
+    /* Skip the separators and find the end of the value */
+    while (pos < size && HEXVAL[(uint8_t) hexwkb[pos]] > 15)
+      pos++;
+    if (pos == size)
+      break;
+    size_t end = pos;
+    while (end < size && HEXVAL[(uint8_t) hexwkb[end]] <= 15)
+      end++;
+    size_t nbytes = (end - pos) / 2;
+    if ((end - pos) % 2)
+    {
+      meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+        "Invalid HexWKB string, its length has to be a multiple of two");
+      n = -1;
+      break;
+    }
+    MEOS_PROBE_WKB_READ(nbytes);
+
+    /* Decode the value, whose digits have been verified while scanning it */
+    if (nbytes > maxbytes)
+    {
+      pfree(bytes);
+      maxbytes = Max(nbytes, maxbytes * 2);
+      bytes = palloc(maxbytes);
+    }
+    const uint8_t *hex = (const uint8_t *) hexwkb + pos;
+    for (size_t i = 0; i < nbytes; i++)
+      bytes[i] = (uint8_t) ((HEXVAL[hex[2 * i]] << 4) | HEXVAL[hex[2 * i + 1]]);
+
+    size_t length;
+    int found = temporal_from_wkb_arena(&s, bytes, nbytes, arena, &result[n],
+      &length);
+    if (found <= 0)
+    {
+      if (found < 0)
+        n = -1;
+      break;
+    }
+    if (length != nbytes)
+    {
+      meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+        "Invalid HexWKB string, the value is followed by other bytes");
+      n = -1;
+      break;
+    }
+    pos = end;
+    n++;
+  }
+  pfree(s.block); pfree(bytes);
+  *consumed = pos;
+  return n;
+}
+#endif /* MEOS */
+
+/*****************************************************************************
+ * Delta of the instants appended to a temporal value
+ *****************************************************************************/
+
+/**
+ * @brief Replace the value being built when applying a delta by the result
+ * of an append, freeing the previous value when it is not reused
+ * @param[in] prev Previous value
+ * @param[in] next Result of the append
+ * @param[in] temp Value to which the delta is applied
+ * @param[in] inplace True when the previous value may have been modified in
+ * place or freed by the append
+ */
+static Temporal *
+temporal_delta_next(Temporal *prev, Temporal *next, const Temporal *temp,
+  bool inplace)
+{
+  if (next == prev)
+    return next;
+  /* An expandable append frees the previous value when it copies it into a
+   * larger one, which is not the case for instants and new sequence sets */
+  if (inplace && prev->subtype != TINSTANT &&
+      ! (prev->subtype == TSEQUENCE && next->subtype == TSEQUENCESET))
+    return next;
+  if (prev != temp || inplace)
+    pfree(prev);
+  return next;
+}
+
+/**
+ * @ingroup meos_temporal_modif
+ * @brief Return a temporal value with the instants of a delta appended
+ * @details The delta must have been computed from the end timestamp of the
+ * value, that is, from the version of the value that is updated.
+ * @param[in,out] temp Temporal value, may be @p NULL when the delta has
+ * been computed from -infinity
+ * @param[in] delta Delta
+ * @param[in] size Size of the delta
+ * @param[in] expand True when reserving space for additional instants, in
+ * which case the value is consumed and must not be used afterwards
+ * @return On error return @p NULL
+ * @see #temporal_delta_since
+ * @csqlfn #Temporal_apply_delta()
+ */
+Temporal *
+temporal_apply_delta(Temporal *temp, const uint8_t *delta, size_t size,
+  bool expand)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) delta))
+    return NULL;
+  if (size < MEOS_WKB_BYTE_SIZE * 2 + MEOS_WKB_TIMESTAMP_SIZE)
+  {
+    meos_error(ERROR, MEOS_ERR_WKB_INPUT, "Invalid size of the delta");
+    return NULL;
+  }
+  MEOS_PROBE_WKB_READ(size);
+
+  /* Read the header of the delta */
+  wkb_parse_state s;
+  memset(&s, 0, sizeof(wkb_parse_state));
+  s.wkb = s.pos = delta;
+  s.wkb_size = size;
+  uint8_t wkb_little_endian = byte_from_wkb_state(&s);
+  if (wkb_little_endian != 1 && wkb_little_endian != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+      "Invalid endian flag value in the delta.");
+    return NULL;
+  }
+  s.swap_bytes = (MEOS_IS_BIG_ENDIAN && wkb_little_endian) ||
+    (! MEOS_IS_BIG_ENDIAN && ! wkb_little_endian);
+  uint8_t flags = byte_from_wkb_state(&s);
+  TimestampTz since = timestamp_from_wkb_state(&s);
+
+  /* Ensure that the delta has been computed from the version of the value */
+  if (temp ? temporal_end_timestamptz(temp) != since : since != DT_NOBEGIN)
+  {
+    char *str = pg_timestamptz_out(since);
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The delta from %s does not apply to the value", str);
+    pfree(str);
+    return NULL;
+  }
+  if (! (flags & MEOS_DELTA_VALUEFLAG))
+  {
+    if (! temp)
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The delta does not have any instant");
+      return NULL;
+    }
+    return expand ? temp : temporal_copy(temp);
+  }
+  Temporal *tail = temporal_from_wkb(s.pos, size - (s.pos - delta));
+  if (! tail || ! temp)
+    return tail;
+  if (! ensure_same_temporal_type(temp, tail) ||
+      ! ensure_spatial_validity(temp, tail))
+  {
+    pfree(tail);
+    return NULL;
+  }
+
+  /* Append the instants of the first sequence of the delta to the last
+   * sequence of the value when it continues it, and the remaining sequences
+   * of the delta as new sequences */
+  int count;
+  const TSequence **sequences = NULL;
+  if (tail->subtype == TINSTANT)
+    count = 1;
+  else if (tail->subtype == TSEQUENCE)
+  {
+    count = 1;
+    sequences = palloc(sizeof(TSequence *));
+    sequences[0] = (const TSequence *) tail;
+  }
+  else /* TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) tail;
+    count = ss->count;
+    sequences = palloc(sizeof(TSequence *) * count);
+    for (int i = 0; i < count; i++)
+      sequences[i] = TSEQUENCESET_SEQ_N(ss, i);
+  }
+  Temporal *result = temp;
+  for (int i = 0; i < count && result; i++)
+  {
+    Temporal *next;
+    if (! sequences)
+    {
+      next = temporal_append_tinstant(result, (const TInstant *) tail, 0.0,
+        NULL, expand);
+      if (next)
+        result = temporal_delta_next(result, next, temp, expand);
+    }
+    else if (i == 0 && (flags & MEOS_DELTA_CONTINUEFLAG))
+    {
+      for (int j = 0; j < sequences[0]->count && result; j++)
+      {
+        next = temporal_append_tinstant(result,
+          TSEQUENCE_INST_N(sequences[0], j), 0.0, NULL, expand);
+        result = next ?
+          temporal_delta_next(result, next, temp, expand) : NULL;
+      }
+      continue;
+    }
+    else
+    {
+      next = temporal_append_tsequence(result, sequences[i], false);
+      if (next)
+        result = temporal_delta_next(result, next, temp, false);
+    }
+    if (! next)
+      result = NULL;
+  }
+  if (sequences)
+    pfree(sequences);
+  pfree(tail);
+  return result;
 }
 
 /*****************************************************************************/
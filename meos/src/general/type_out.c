@@ -36,6 +36,7 @@
 #include <assert.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include "utils/datetime.h"
 #include "utils/timestamp.h"
 #if POSTGRESQL_VERSION_NUMBER >= 160000
   #include "varatt.h"
@@ -46,6 +47,8 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/meos_probes.h"
+#include "general/pg_types.h"
 #include "general/temporal.h"
 #if NPOINT
   #include "npoint/tnpoint.h"
@@ -72,7 +75,10 @@
 static void
 bool_as_mfjson_sb(stringbuffer_t *sb, bool b)
 {
-  stringbuffer_aprintf(sb, "%s", b ? "true" : "false");
+  if (b)
+    stringbuffer_append_len(sb, "true", 4);
+  else
+    stringbuffer_append_len(sb, "false", 5);
   return;
 }
 
@@ -176,10 +182,21 @@ coordinates_as_mfjson_sb(stringbuffer_t *sb, const TInstant *inst, int precision
 static void
 datetimes_as_mfjson_sb(stringbuffer_t *sb, TimestampTz t)
 {
+  char buf[MAXDATELEN + 1];
+  int len = timestamptz_to_iso8601_buf(t, 'T', buf);
+  if (len > 0)
+  {
+    stringbuffer_append_char(sb, '"');
+    stringbuffer_append_len(sb, buf, len);
+    stringbuffer_append_char(sb, '"');
+    return;
+  }
   char *tstr = pg_timestamptz_out(t);
   /* Replace ' ' by 'T' as separator between date and time parts */
   tstr[10] = 'T';
-  stringbuffer_aprintf(sb, "\"%s\"", tstr);
+  stringbuffer_append_char(sb, '"');
+  stringbuffer_append(sb, tstr);
+  stringbuffer_append_char(sb, '"');
   pfree(tstr);
   return;
 }
@@ -453,13 +470,53 @@ tpointinst_as_mfjson(const TInstant *inst, bool with_bbox, int precision,
 
 /*****************************************************************************/
 
+/**
+ * @brief Size of the chunks handed to the callback of a streaming writer
+ */
+#define MEOS_WRITER_CHUNK_SIZE 65536
+
+/**
+ * @brief Structure to hand the output of a streaming writer to a callback
+ * in chunks of bounded size
+ */
+typedef struct
+{
+  meos_write_fn write;  /**< Callback receiving the chunks */
+  void *arg;            /**< Argument passed to the callback */
+  uint8_t *buf;         /**< Buffer for the binary output */
+  size_t maxlen;        /**< Size of the buffer */
+} MeosWriter;
+
+/**
+ * @brief Hand the content of the string buffer to the writer and empty the
+ * buffer when it reaches the chunk size or when the output is finished
+ * @param[in] sb String buffer
+ * @param[in] writer Writer, @p NULL when the output is kept in memory
+ * @param[in] final True when this is the last chunk of the output
+ * @return False when the callback asks to stop
+ */
+static bool
+mfjson_sb_flush(stringbuffer_t *sb, const MeosWriter *writer, bool final)
+{
+  if (! writer)
+    return true;
+  size_t len = (size_t) stringbuffer_getlength(sb);
+  if (len == 0 || (! final && len < MEOS_WRITER_CHUNK_SIZE))
+    return true;
+  bool result = writer->write(stringbuffer_getstring(sb), len, writer->arg);
+  stringbuffer_clear(sb);
+  return result;
+}
+
 /**
  * @brief Write into the buffer a temporal sequence in the MF-JSON
  * representation
+ * @note When a writer is given, the buffer is flushed after each instant
  */
 static bool
 tsequence_as_mfjson_sb(stringbuffer_t *sb, const TSequence *seq, bool isgeo,
-  bool hasz, const bboxunion *bbox, int precision, char *srs)
+  bool hasz, const bboxunion *bbox, int precision, char *srs,
+  const MeosWriter *writer)
 {
   bool result = temptype_as_mfjson_sb(sb, seq->temptype);
   /* Propagate errors up */
@@ -489,6 +546,8 @@ tsequence_as_mfjson_sb(stringbuffer_t *sb, const TSequence *seq, bool isgeo,
       if (! result)
         return false;
     }
+    if (! mfjson_sb_flush(sb, writer, false))
+      return false;
   }
   stringbuffer_append_len(sb, "],\"datetimes\":[", 15);
   for (int i = 0; i < seq->count; i++)
@@ -496,6 +555,8 @@ tsequence_as_mfjson_sb(stringbuffer_t *sb, const TSequence *seq, bool isgeo,
     if (i) stringbuffer_append_char(sb, ',');
     inst = TSEQUENCE_INST_N(seq, i);
     datetimes_as_mfjson_sb(sb, inst->t);
+    if (! mfjson_sb_flush(sb, writer, false))
+      return false;
   }
   stringbuffer_aprintf(sb, "],\"lower_inc\":%s,\"upper_inc\":%s,\"interpolation\":\"%s\"}",
     seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ? "true" : "false",
@@ -580,10 +641,12 @@ tpointseq_as_mfjson(const TSequence *seq, bool with_bbox, int precision,
 /**
  * @brief Write into the buffer a temporal sequence set in the MF-JSON
  * representation
+ * @note When a writer is given, the buffer is flushed after each instant
  */
 static bool
 tsequenceset_as_mfjson_sb(stringbuffer_t *sb, const TSequenceSet *ss, bool isgeo,
-  bool hasz, const bboxunion *bbox, int precision, char *srs)
+  bool hasz, const bboxunion *bbox, int precision, char *srs,
+  const MeosWriter *writer)
 {
   bool result = temptype_as_mfjson_sb(sb, ss->temptype);
   /* Propagate errors up */
@@ -618,6 +681,8 @@ tsequenceset_as_mfjson_sb(stringbuffer_t *sb, const TSequenceSet *ss, bool isgeo
         if (! result)
           return false;
       }
+      if (! mfjson_sb_flush(sb, writer, false))
+        return false;
     }
     stringbuffer_append_len(sb, "],\"datetimes\":[", 15);
     for (int j = 0; j < seq->count; j++)
@@ -625,6 +690,8 @@ tsequenceset_as_mfjson_sb(stringbuffer_t *sb, const TSequenceSet *ss, bool isgeo
       if (j) stringbuffer_append_char(sb, ',');
       inst = TSEQUENCE_INST_N(seq, j);
       datetimes_as_mfjson_sb(sb, inst->t);
+      if (! mfjson_sb_flush(sb, writer, false))
+        return false;
     }
     stringbuffer_aprintf(sb, "],\"lower_inc\":%s,\"upper_inc\":%s}",
       seq->period.lower_inc ? "true" : "false", seq->period.upper_inc ?
@@ -709,24 +776,86 @@ tpointseqset_as_mfjson(const TSequenceSet *ss, bool with_bbox, int precision,
 /*****************************************************************************/
 
 /**
- * @ingroup meos_temporal_inout
- * @brief Return the MF-JSON representation of a temporal value
+ * @brief Estimated size of a timestamptz in the MF-JSON representation
+ * including the quotes and the separator, e.g.,
+ * @p "2000-01-01T08:00:00.123456+01:00",
+ */
+#define MFJSON_TIMESTAMPTZ_SIZE  40
+/**
+ * @brief Estimated size of the fixed part of the MF-JSON representation, that
+ * is, the type, the bounding box, and the interpolation
+ */
+#define MFJSON_HEADER_SIZE       512
+/**
+ * @brief Estimated size of the fixed part of a sequence in the MF-JSON
+ * representation, that is, the key names and the period bounds
+ */
+#define MFJSON_SEQUENCE_SIZE     96
+
+/**
+ * @brief Return the estimated size of the MF-JSON representation of a
+ * temporal value
+ * @details The estimation is exact for all components except for the
+ * timestamps whose size depends on the time zone and the fractional seconds.
+ * It is used to allocate the string buffer once, which still grows if needed.
+ */
+static size_t
+temporal_mfjson_size(const Temporal *temp, bool isgeo, bool hasz,
+  const char *srs)
+{
+  size_t result = MFJSON_HEADER_SIZE;
+  if (srs)
+    result += strlen(srs);
+  int count, nseqs;
+  if (temp->subtype == TINSTANT)
+    count = nseqs = 1;
+  else if (temp->subtype == TSEQUENCE)
+  {
+    count = ((TSequence *) temp)->count;
+    nseqs = 1;
+  }
+  else /* TSEQUENCESET */
+  {
+    count = ((TSequenceSet *) temp)->totalcount;
+    nseqs = ((TSequenceSet *) temp)->count;
+  }
+  result += nseqs * MFJSON_SEQUENCE_SIZE + count * MFJSON_TIMESTAMPTZ_SIZE;
+  /* Size of the values including the separator */
+  if (isgeo)
+    return result + count * (3 + (hasz ? 3 : 2) * (OUT_MAX_BYTES_DOUBLE + 1));
+  switch (temp->temptype)
+  {
+    case T_TBOOL:
+      return result + count * 6;
+    case T_TINT:
+      return result + count * 12;
+    case T_TFLOAT:
+      return result + count * (OUT_MAX_BYTES_DOUBLE + 1);
+    default: /* T_TTEXT */
+    {
+      const TInstant **instants = temporal_insts(temp, &count);
+      for (int i = 0; i < count; i++)
+        result += VARSIZE_ANY_EXHDR(DatumGetTextP(tinstant_val(instants[i])))
+          + 3;
+      pfree(instants);
+      return result;
+    }
+  }
+}
+
+/**
+ * @brief Write into the buffer a temporal value in the MF-JSON representation
+ * @param[in] sb String buffer
  * @param[in] temp Temporal value
  * @param[in] with_bbox True when the output value has bounding box
- * @param[in] flags Flags
  * @param[in] precision Number of decimal digits
  * @param[in] srs Spatial reference system
- * @return On error return @p NULL
- * @csqlfn #Temporal_as_mfjson()
+ * @param[in] writer Writer, @p NULL when the output is kept in memory
  */
-char *
-temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
-  int precision, char *srs)
+static bool
+temporal_as_mfjson_sb(stringbuffer_t *sb, const Temporal *temp,
+  bool with_bbox, int precision, char *srs, const MeosWriter *writer)
 {
-  /* Ensure validity of the arguments */
-  if (! ensure_not_null((void *) temp))
-    return NULL;
-
   /* Get bounding box if needed */
   bboxunion *bbox = NULL, tmp;
   if (with_bbox)
@@ -737,30 +866,50 @@ temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
   bool isgeo = tgeo_type(temp->temptype);
   bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
 
-  /* Create the string buffer */
-  stringbuffer_t *sb = stringbuffer_create();
-
-  bool res;
   assert(temptype_subtype(temp->subtype));
   switch (temp->subtype)
   {
     case TINSTANT:
-      res = tinstant_as_mfjson_sb(sb, (TInstant *) temp, isgeo, hasz, bbox,
+      return tinstant_as_mfjson_sb(sb, (TInstant *) temp, isgeo, hasz, bbox,
         precision, srs);
-      break;
     case TSEQUENCE:
-      res = tsequence_as_mfjson_sb(sb, (TSequence *) temp, isgeo, hasz, bbox,
-        precision, srs);
-      break;
+      return tsequence_as_mfjson_sb(sb, (TSequence *) temp, isgeo, hasz, bbox,
+        precision, srs, writer);
     default: /* TSEQUENCESET */
-      res = tsequenceset_as_mfjson_sb(sb, (TSequenceSet *) temp, isgeo, hasz,
-        bbox, precision, srs);
+      return tsequenceset_as_mfjson_sb(sb, (TSequenceSet *) temp, isgeo, hasz,
+        bbox, precision, srs, writer);
   }
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the MF-JSON representation of a temporal value
+ * @param[in] temp Temporal value
+ * @param[in] with_bbox True when the output value has bounding box
+ * @param[in] flags Flags
+ * @param[in] precision Number of decimal digits
+ * @param[in] srs Spatial reference system
+ * @return On error return @p NULL
+ * @csqlfn #Temporal_as_mfjson()
+ */
+char *
+temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
+  int precision, char *srs)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp))
+    return NULL;
+
+  /* Create the string buffer with the estimated size of the result */
+  stringbuffer_t *sb = stringbuffer_create_with_size(
+    temporal_mfjson_size(temp, tgeo_type(temp->temptype),
+      MEOS_FLAGS_GET_Z(temp->flags), srs));
+  bool res = temporal_as_mfjson_sb(sb, temp, with_bbox, precision, srs, NULL);
   /* Convert the string buffer to a C string */
   char *result = ! res ? NULL : stringbuffer_getstringcopy(sb);
   stringbuffer_destroy(sb);
 
-  if (flags == 0)
+  if (flags == 0 || ! result)
     return result;
 
   struct json_object *jobj = json_tokener_parse(result);
@@ -768,6 +917,43 @@ temporal_as_mfjson(const Temporal *temp, bool with_bbox, int flags,
   return (char *) json_object_to_json_string_ext(jobj, flags);
 }
 
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Write the MF-JSON representation of a temporal value through a
+ * callback in chunks of bounded size
+ * @details The output is the same as the one of #temporal_as_mfjson without
+ * JSON flags, but the memory used is bounded by the chunk size instead of
+ * by the size of the whole representation
+ * @param[in] temp Temporal value
+ * @param[in] with_bbox True when the output value has bounding box
+ * @param[in] precision Number of decimal digits
+ * @param[in] srs Spatial reference system
+ * @param[in] write Callback receiving the chunks, which returns false to
+ * stop the output
+ * @param[in] arg Argument passed to the callback
+ * @return Return false on error or when the callback stops the output
+ * @csqlfn #Temporal_as_mfjson_chunks()
+ */
+bool
+temporal_as_mfjson_write(const Temporal *temp, bool with_bbox, int precision,
+  char *srs, meos_write_fn write, void *arg)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) write))
+    return false;
+
+  MeosWriter writer;
+  memset(&writer, 0, sizeof(MeosWriter));
+  writer.write = write;
+  writer.arg = arg;
+  stringbuffer_t *sb = stringbuffer_create_with_size(MEOS_WRITER_CHUNK_SIZE +
+    MFJSON_HEADER_SIZE);
+  bool result = temporal_as_mfjson_sb(sb, temp, with_bbox, precision, srs,
+      &writer) && mfjson_sb_flush(sb, &writer, true);
+  stringbuffer_destroy(sb);
+  return result;
+}
+
 /*****************************************************************************
  * Output in Well-Known Binary (WKB) representation
  *
@@ -1038,6 +1224,183 @@ tpoint_wkb_needs_srid(const Temporal *temp, uint8_t variant)
   return false;
 }
 
+/**
+ * @brief Return true if the temporal value is output in the compressed WKB
+ * encoding
+ */
+static inline bool
+temporal_wkb_compressed(const Temporal *temp, uint8_t variant)
+{
+  return (variant & MEOS_WKB_COMPRESSED) && temp->subtype != TINSTANT;
+}
+
+/**
+ * @brief Return the zigzag encoding of a signed integer
+ */
+static inline uint64
+zigzag_encode(int64 i)
+{
+  return ((uint64) i << 1) ^ (uint64) (i >> 63);
+}
+
+/**
+ * @brief Return the size in bytes of an unsigned varint
+ */
+static size_t
+varint_to_wkb_size(uint64 u)
+{
+  size_t result = 1;
+  while (u >= 0x80)
+  {
+    u >>= 7;
+    result++;
+  }
+  return result;
+}
+
+/**
+ * @brief Return the number of leading and trailing zero bytes of the XOR of
+ * two doubles
+ * @note For a zero XOR there are 8 leading and 0 trailing zero bytes
+ */
+static void
+xor_zero_bytes(uint64 x, int *lead, int *trail)
+{
+  *lead = *trail = 0;
+  while (*lead < 8 && ! ((x >> (8 * (7 - *lead))) & 0xFF))
+    (*lead)++;
+  if (x)
+    while (! ((x >> (8 * *trail)) & 0xFF))
+      (*trail)++;
+  return;
+}
+
+/**
+ * @brief Return the size in bytes of the XOR of two doubles, that is, a header
+ * byte with the number of leading and trailing zero bytes followed by the
+ * remaining bytes
+ */
+static size_t
+xor_to_wkb_size(uint64 x)
+{
+  int lead, trail;
+  xor_zero_bytes(x, &lead, &trail);
+  return MEOS_WKB_BYTE_SIZE + (size_t) (8 - lead - trail);
+}
+
+/**
+ * @brief Compute the codes of a temporal instant in the compressed WKB
+ * encoding and advance the state
+ * @param[in] inst Temporal instant
+ * @param[in,out] state Previous instant
+ * @param[out] codes Integer codes followed by the double codes and the
+ * timestamp code
+ * @param[out] nint,ndbl Number of integer and double codes of the value
+ * @note When both @p nint and @p ndbl are zero, as for the Boolean and text
+ * base types, the value is written in the standard encoding
+ */
+static void
+tinstant_wkb_delta_codes(const TInstant *inst, WkbDeltaState *state,
+  uint64 *codes, int *nint, int *ndbl)
+{
+  Datum value = tinstant_val(inst);
+  int64 ival = 0;
+  double dval[3];
+  *nint = *ndbl = 0;
+  switch (temptype_basetype(inst->temptype))
+  {
+    case T_INT4:
+      ival = DatumGetInt32(value);
+      *nint = 1;
+      break;
+    case T_INT8:
+      ival = DatumGetInt64(value);
+      *nint = 1;
+      break;
+    case T_DATE:
+      ival = DatumGetDateADT(value);
+      *nint = 1;
+      break;
+    case T_TIMESTAMPTZ:
+      ival = DatumGetTimestampTz(value);
+      *nint = 1;
+      break;
+    case T_FLOAT8:
+      dval[0] = DatumGetFloat8(value);
+      *ndbl = 1;
+      break;
+    case T_GEOMETRY:
+    case T_GEOGRAPHY:
+      if (MEOS_FLAGS_GET_Z(inst->flags))
+      {
+        const POINT3DZ *point = DATUM_POINT3DZ_P(value);
+        dval[0] = point->x; dval[1] = point->y; dval[2] = point->z;
+        *ndbl = 3;
+      }
+      else
+      {
+        const POINT2D *point = DATUM_POINT2D_P(value);
+        dval[0] = point->x; dval[1] = point->y;
+        *ndbl = 2;
+      }
+      break;
+#if NPOINT
+    case T_NPOINT:
+    {
+      const Npoint *np = DatumGetNpointP(value);
+      ival = np->rid;
+      dval[0] = np->pos;
+      *nint = *ndbl = 1;
+      break;
+    }
+#endif /* NPOINT */
+    default: /* Standard encoding */
+      break;
+  }
+  int n = 0;
+  if (*nint)
+  {
+    codes[n++] = zigzag_encode((int64) ((uint64) ival - (uint64) state->ival));
+    state->ival = ival;
+  }
+  for (int i = 0; i < *ndbl; i++)
+  {
+    uint64 bits;
+    memcpy(&bits, &dval[i], sizeof(uint64));
+    codes[n++] = bits ^ state->dval[i];
+    state->dval[i] = bits;
+  }
+  /* The first timestamp is written as is, the second one as a delta, and the
+   * next ones as a delta of deltas */
+  int64 dt = (int64) ((uint64) inst->t - (uint64) state->t);
+  codes[n] = zigzag_encode((int64) ((uint64) dt - (uint64) state->dt));
+  state->t = inst->t;
+  state->dt = state->count ? dt : 0;
+  state->count++;
+  return;
+}
+
+/**
+ * @brief Return the size in bytes of a temporal instant in the compressed WKB
+ * encoding and advance the state
+ */
+static size_t
+tinstant_to_wkb_size_delta(const TInstant *inst, WkbDeltaState *state)
+{
+  uint64 codes[5];
+  int nint, ndbl;
+  tinstant_wkb_delta_codes(inst, state, codes, &nint, &ndbl);
+  size_t result = 0;
+  if (! nint && ! ndbl)
+    result += basetype_to_wkb_size(tinstant_val(inst),
+      temptype_basetype(inst->temptype), inst->flags);
+  for (int i = 0; i < nint; i++)
+    result += varint_to_wkb_size(codes[i]);
+  for (int i = nint; i < nint + ndbl; i++)
+    result += xor_to_wkb_size(codes[i]);
+  return result + varint_to_wkb_size(codes[nint + ndbl]);
+}
+
 /**
  * @brief Return the maximum size in bytes of the temporal instant in the
  * Well-Known Binary (WKB) representation
@@ -1069,6 +1432,17 @@ tsequence_to_wkb_size(const TSequence *seq, uint8_t variant)
   if (tgeo_type(seq->temptype) &&
       tpoint_wkb_needs_srid((Temporal *) seq, variant))
     size += MEOS_WKB_INT4_SIZE;
+  if (temporal_wkb_compressed((Temporal *) seq, variant))
+  {
+    /* Include the number of instants, the period bounds flag, and the
+     * compressed instants */
+    size += varint_to_wkb_size((uint64) seq->count) + MEOS_WKB_BYTE_SIZE;
+    WkbDeltaState state;
+    memset(&state, 0, sizeof(WkbDeltaState));
+    for (int i = 0; i < seq->count; i++)
+      size += tinstant_to_wkb_size_delta(TSEQUENCE_INST_N(seq, i), &state);
+    return size;
+  }
   /* Include the number of instants and the period bounds flag */
   size += MEOS_WKB_INT4_SIZE + MEOS_WKB_BYTE_SIZE;
   const TInstant **instants = tsequence_insts(seq);
@@ -1091,6 +1465,23 @@ tsequenceset_to_wkb_size(const TSequenceSet *ss, uint8_t variant)
   if (tgeo_type(ss->temptype) &&
       tpoint_wkb_needs_srid((Temporal *) ss, variant))
     size += MEOS_WKB_INT4_SIZE;
+  if (temporal_wkb_compressed((Temporal *) ss, variant))
+  {
+    /* Include the number of sequences and, for each sequence, the number of
+     * instants, the period bounds flag, and the compressed instants, where
+     * the state is kept across the sequences */
+    size += varint_to_wkb_size((uint64) ss->count);
+    WkbDeltaState state;
+    memset(&state, 0, sizeof(WkbDeltaState));
+    for (int i = 0; i < ss->count; i++)
+    {
+      const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+      size += varint_to_wkb_size((uint64) seq->count) + MEOS_WKB_BYTE_SIZE;
+      for (int j = 0; j < seq->count; j++)
+        size += tinstant_to_wkb_size_delta(TSEQUENCE_INST_N(seq, j), &state);
+    }
+    return size;
+  }
   /* Include the number of sequences */
   size += MEOS_WKB_INT4_SIZE;
   /* For each sequence include the number of instants and the period bounds flag */
@@ -1812,6 +2203,65 @@ stbox_to_wkb_buf(const STBox *box, uint8_t *buf, uint8_t variant)
 
 /*****************************************************************************/
 
+/**
+ * @brief Write into the buffer an unsigned varint in the compressed WKB
+ * encoding
+ * @note The bytes are written from the least significant 7-bit group, which
+ * is independent of the endianness
+ */
+static uint8_t *
+varint_to_wkb_buf(uint64 u, uint8_t *buf, uint8_t variant)
+{
+  while (u >= 0x80)
+  {
+    buf = uint8_to_wkb_buf((uint8_t) (u | 0x80), buf, variant);
+    u >>= 7;
+  }
+  return uint8_to_wkb_buf((uint8_t) u, buf, variant);
+}
+
+/**
+ * @brief Write into the buffer the XOR of two doubles in the compressed WKB
+ * encoding
+ * @details The output is a header byte with the number of leading zero bytes
+ * in the upper four bits and the number of trailing zero bytes in the lower
+ * four bits, followed by the remaining bytes from the most significant one
+ */
+static uint8_t *
+xor_to_wkb_buf(uint64 x, uint8_t *buf, uint8_t variant)
+{
+  int lead, trail;
+  xor_zero_bytes(x, &lead, &trail);
+  buf = uint8_to_wkb_buf((uint8_t) (lead << 4 | trail), buf, variant);
+  for (int i = 7 - lead; i >= trail; i--)
+    buf = uint8_to_wkb_buf((uint8_t) (x >> (8 * i)), buf, variant);
+  return buf;
+}
+
+/**
+ * @brief Write into the buffer a temporal instant in the compressed WKB
+ * encoding and advance the state
+ * @details The output is as follows
+ * - base value
+ * - timestamp
+ */
+static uint8_t *
+tinstant_to_wkb_buf_delta(const TInstant *inst, WkbDeltaState *state,
+  uint8_t *buf, uint8_t variant)
+{
+  uint64 codes[5];
+  int nint, ndbl;
+  tinstant_wkb_delta_codes(inst, state, codes, &nint, &ndbl);
+  if (! nint && ! ndbl)
+    buf = basevalue_to_wkb_buf(tinstant_val(inst),
+      temptype_basetype(inst->temptype), inst->flags, buf, variant);
+  for (int i = 0; i < nint; i++)
+    buf = varint_to_wkb_buf(codes[i], buf, variant);
+  for (int i = nint; i < nint + ndbl; i++)
+    buf = xor_to_wkb_buf(codes[i], buf, variant);
+  return varint_to_wkb_buf(codes[nint + ndbl], buf, variant);
+}
+
 /**
  * @brief Write into the buffer the flag containing the temporal type and
  * other characteristics in the Well-Known Binary (WKB) representation
@@ -1839,6 +2289,8 @@ temporal_flags_to_wkb_buf(const Temporal *temp, uint8_t *buf, uint8_t variant)
     if (tpoint_wkb_needs_srid(temp, variant))
       wkb_flags |= MEOS_WKB_SRIDFLAG;
   }
+  if (temporal_wkb_compressed(temp, variant))
+    wkb_flags |= MEOS_WKB_COMPRESSEDFLAG;
   /* Write the flags */
   return uint8_to_wkb_buf(wkb_flags, buf, variant);
 }
@@ -1863,28 +2315,44 @@ tinstant_basevalue_time_to_wkb_buf(const TInstant *inst, uint8_t *buf,
 }
 
 /**
- * @brief Write into the buffer the temporal instant in the Well-Known Binary
- * (WKB) representation
+ * @brief Write into the buffer the header of a temporal value in the
+ * Well-Known Binary (WKB) representation
  * @details The output is as follows
  * - Endian
  * - Temporal type
  * - Temporal flags: Linear, SRID, Geodetic, Z, Temporal subtype
  * - SRID (if requested)
- * - Output of a single instant
  */
 static uint8_t *
-tinstant_to_wkb_buf(const TInstant *inst, uint8_t *buf, uint8_t variant)
+temporal_header_to_wkb_buf(const Temporal *temp, uint8_t *buf,
+  uint8_t variant)
 {
   /* Write the endian flag */
   buf = endian_to_wkb_buf(buf, variant);
   /* Write the temporal type */
-  buf = int16_to_wkb_buf(inst->temptype, buf, variant);
-  /* Write the temporal flags */
-  buf = temporal_flags_to_wkb_buf((Temporal *) inst, buf, variant);
+  buf = int16_to_wkb_buf(temp->temptype, buf, variant);
+  /* Write the temporal flags and interpolation */
+  buf = temporal_flags_to_wkb_buf(temp, buf, variant);
   /* Write the optional SRID for extended variant */
-  if (tgeo_type(inst->temptype) &&
-      tpoint_wkb_needs_srid((Temporal *) inst, variant))
-    buf = int32_to_wkb_buf(tpointinst_srid(inst), buf, variant);
+  if (tgeo_type(temp->temptype) && tpoint_wkb_needs_srid(temp, variant))
+    buf = int32_to_wkb_buf(tpoint_srid(temp), buf, variant);
+  return buf;
+}
+
+/**
+ * @brief Write into the buffer the temporal instant in the Well-Known Binary
+ * (WKB) representation
+ * @details The output is as follows
+ * - Endian
+ * - Temporal type
+ * - Temporal flags: Linear, SRID, Geodetic, Z, Temporal subtype
+ * - SRID (if requested)
+ * - Output of a single instant
+ */
+static uint8_t *
+tinstant_to_wkb_buf(const TInstant *inst, uint8_t *buf, uint8_t variant)
+{
+  buf = temporal_header_to_wkb_buf((Temporal *) inst, buf, variant);
   return tinstant_basevalue_time_to_wkb_buf(inst, buf, variant);
 }
 
@@ -1902,16 +2370,20 @@ tinstant_to_wkb_buf(const TInstant *inst, uint8_t *buf, uint8_t variant)
 static uint8_t *
 tsequence_to_wkb_buf(const TSequence *seq, uint8_t *buf, uint8_t variant)
 {
-  /* Write the endian flag */
-  buf = endian_to_wkb_buf(buf, variant);
-  /* Write the temporal type */
-  buf = int16_to_wkb_buf(seq->temptype, buf, variant);
-  /* Write the temporal flags and interpolation */
-  buf = temporal_flags_to_wkb_buf((Temporal *) seq, buf, variant);
-  /* Write the optional SRID for extended variant */
-  if (tgeo_type(seq->temptype) &&
-      tpoint_wkb_needs_srid((Temporal *) seq, variant))
-    buf = int32_to_wkb_buf(tpointseq_srid(seq), buf, variant);
+  buf = temporal_header_to_wkb_buf((Temporal *) seq, buf, variant);
+  if (temporal_wkb_compressed((Temporal *) seq, variant))
+  {
+    /* Write the count, the period bounds, and the compressed instants */
+    buf = varint_to_wkb_buf((uint64) seq->count, buf, variant);
+    buf = bounds_to_wkb_buf(seq->period.lower_inc, seq->period.upper_inc, buf,
+      variant);
+    WkbDeltaState state;
+    memset(&state, 0, sizeof(WkbDeltaState));
+    for (int i = 0; i < seq->count; i++)
+      buf = tinstant_to_wkb_buf_delta(TSEQUENCE_INST_N(seq, i), &state, buf,
+        variant);
+    return buf;
+  }
   /* Write the count */
   buf = int32_to_wkb_buf(seq->count, buf, variant);
   /* Write the period bounds */
@@ -1940,16 +2412,26 @@ tsequence_to_wkb_buf(const TSequence *seq, uint8_t *buf, uint8_t variant)
 static uint8_t *
 tsequenceset_to_wkb_buf(const TSequenceSet *ss, uint8_t *buf, uint8_t variant)
 {
-  /* Write the endian flag */
-  buf = endian_to_wkb_buf(buf, variant);
-  /* Write the temporal type */
-  buf = int16_to_wkb_buf(ss->temptype, buf, variant);
-  /* Write the temporal and interpolation flags */
-  buf = temporal_flags_to_wkb_buf((Temporal *) ss, buf, variant);
-  /* Write the optional SRID for extended variant */
-  if (tgeo_type(ss->temptype) &&
-      tpoint_wkb_needs_srid((Temporal *) ss, variant))
-    buf = int32_to_wkb_buf(tpointseqset_srid(ss), buf, variant);
+  buf = temporal_header_to_wkb_buf((Temporal *) ss, buf, variant);
+  if (temporal_wkb_compressed((Temporal *) ss, variant))
+  {
+    /* Write the count and the sequences, where the state is kept across the
+     * sequences */
+    buf = varint_to_wkb_buf((uint64) ss->count, buf, variant);
+    WkbDeltaState state;
+    memset(&state, 0, sizeof(WkbDeltaState));
+    for (int i = 0; i < ss->count; i++)
+    {
+      const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+      buf = varint_to_wkb_buf((uint64) seq->count, buf, variant);
+      buf = bounds_to_wkb_buf(seq->period.lower_inc, seq->period.upper_inc,
+        buf, variant);
+      for (int j = 0; j < seq->count; j++)
+        buf = tinstant_to_wkb_buf_delta(TSEQUENCE_INST_N(seq, j), &state, buf,
+          variant);
+    }
+    return buf;
+  }
   /* Write the count */
   buf = int32_to_wkb_buf(ss->count, buf, variant);
   /* Write the sequences */
@@ -2340,8 +2822,12 @@ temporal_as_wkb(const Temporal *temp, uint8_t variant, size_t *size_out)
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) size_out))
     return NULL;
-  return datum_as_wkb(PointerGetDatum(temp), temp->temptype,
-    variant, size_out);
+  uint8_t *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_IO,
+    result = datum_as_wkb(PointerGetDatum(temp), temp->temptype, variant,
+      size_out));
+  MEOS_PROBE_WKB_WRITE(*size_out);
+  return result;
 }
 
 #if MEOS
@@ -2360,8 +2846,374 @@ temporal_as_hexwkb(const Temporal *temp, uint8_t variant, size_t *size_out)
   /* Ensure validity of the arguments */
   if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) size_out))
     return NULL;
-  return (char *) datum_as_wkb(PointerGetDatum(temp), temp->temptype,
-    variant | (uint8_t) WKB_HEX, size_out);
+  char *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_IO,
+    result = (char *) datum_as_wkb(PointerGetDatum(temp), temp->temptype,
+      variant | (uint8_t) WKB_HEX, size_out));
+  return result;
+}
+#endif /* MEOS */
+
+/*****************************************************************************
+ * Delta of the instants appended to a temporal value
+ * The delta is composed of the endian byte, a flag byte, the timestamp from
+ * which the delta is computed, and the WKB representation of the instants
+ * after this timestamp
+ *****************************************************************************/
+
+/**
+ * @brief Return the instants of a temporal sequence after a timestamp as a
+ * sequence, or @p NULL if there are none
+ * @param[in] seq Temporal sequence
+ * @param[in] t Timestamp
+ * @param[out] cont True when the instants continue the sequence, that is,
+ * when the sequence has instants before or at the timestamp
+ */
+static TSequence *
+tsequence_tail(const TSequence *seq, TimestampTz t, bool *cont)
+{
+  /* The instants are scanned backwards so that the cost is proportional to
+   * the number of instants of the result */
+  int first = seq->count;
+  while (first > 0 && TSEQUENCE_INST_N(seq, first - 1)->t > t)
+    first--;
+  *cont = (first > 0);
+  if (first == seq->count)
+    return NULL;
+  const TInstant **instants = palloc(sizeof(TInstant *) *
+    (seq->count - first));
+  for (int i = first; i < seq->count; i++)
+    instants[i - first] = TSEQUENCE_INST_N(seq, i);
+  TSequence *result = tsequence_make(instants, seq->count - first,
+    *cont ? true : seq->period.lower_inc, seq->period.upper_inc,
+    MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE_NO);
+  pfree(instants);
+  return result;
+}
+
+/**
+ * @brief Return the instants of a temporal value after a timestamp, or
+ * @p NULL if there are none
+ * @param[in] temp Temporal value
+ * @param[in] t Timestamp
+ * @param[out] cont True when the first sequence of the result continues the
+ * last sequence of the value restricted to the timestamp
+ */
+static Temporal *
+temporal_tail(const Temporal *temp, TimestampTz t, bool *cont)
+{
+  *cont = false;
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      return (((const TInstant *) temp)->t > t) ?
+        (Temporal *) tinstant_copy((const TInstant *) temp) : NULL;
+    case TSEQUENCE:
+      return (Temporal *) tsequence_tail((const TSequence *) temp, t, cont);
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      /* Find the first sequence that has instants after the timestamp */
+      int first = ss->count;
+      while (first > 0 &&
+          DatumGetTimestampTz(TSEQUENCESET_SEQ_N(ss, first - 1)->period.upper)
+            > t)
+        first--;
+      if (first == ss->count)
+        return NULL;
+      TSequence **sequences = palloc(sizeof(TSequence *) *
+        (ss->count - first));
+      for (int i = first; i < ss->count; i++)
+      {
+        bool cont1;
+        sequences[i - first] = tsequence_tail(TSEQUENCESET_SEQ_N(ss, i), t,
+          &cont1);
+        if (i == first)
+          *cont = cont1;
+      }
+      if (ss->count - first == 1)
+      {
+        TSequence *result = sequences[0];
+        pfree(sequences);
+        return (Temporal *) result;
+      }
+      return (Temporal *) tsequenceset_make_free(sequences,
+        ss->count - first, NORMALIZE_NO);
+    }
+  }
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the delta of the instants of a temporal value after a
+ * timestamp in a binary representation
+ * @details The delta allows a replica of a value that is appended
+ * continuously to be kept up to date by sending only the instants appended
+ * since the version it has, identified by its end timestamp. The instants
+ * are encoded in the Well-Known Binary (WKB) representation.
+ * @param[in] temp Temporal value
+ * @param[in] t End timestamp of the version of the replica, -infinity for
+ * the whole value
+ * @param[in] variant Output variant
+ * @param[out] size_out Size of the output
+ * @see #temporal_apply_delta
+ * @csqlfn #Temporal_delta_since()
+ */
+uint8_t *
+temporal_delta_since(const Temporal *temp, TimestampTz t, uint8_t variant,
+  size_t *size_out)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) size_out))
+    return NULL;
+  /* The delta is always binary and keeps the SRID of temporal points */
+  variant &= (uint8_t) ~WKB_HEX;
+  variant |= (uint8_t) WKB_EXTENDED;
+  if (! (variant & WKB_NDR || variant & WKB_XDR) ||
+    (variant & WKB_NDR && variant & WKB_XDR))
+    variant |= MEOS_IS_BIG_ENDIAN ? (uint8_t) WKB_XDR : (uint8_t) WKB_NDR;
+
+  bool cont;
+  Temporal *tail = temporal_tail(temp, t, &cont);
+  size_t size = MEOS_WKB_BYTE_SIZE * 2 + MEOS_WKB_TIMESTAMP_SIZE;
+  if (tail)
+    size += temporal_to_wkb_size(tail, variant);
+  uint8_t *result = palloc(size);
+  uint8_t *buf = endian_to_wkb_buf(result, variant);
+  uint8_t flags = 0;
+  if (tail)
+    flags |= MEOS_DELTA_VALUEFLAG;
+  if (cont)
+    flags |= MEOS_DELTA_CONTINUEFLAG;
+  buf = uint8_to_wkb_buf(flags, buf, variant);
+  buf = timestamptz_to_wkb_buf(t, buf, variant);
+  if (tail)
+  {
+    buf = temporal_to_wkb_buf(tail, buf, variant);
+    pfree(tail);
+  }
+  assert((size_t) (buf - result) == size);
+  *size_out = size;
+  MEOS_PROBE_WKB_WRITE(size);
+  return result;
+}
+
+/*****************************************************************************
+ * Streaming output of temporal values in chunks
+ *****************************************************************************/
+
+/**
+ * @brief Ensure that the WKB buffer of a writer has room for a given number
+ * of bytes after the position, handing the content to the callback otherwise
+ * @details The buffer is enlarged when a single component, e.g., a long text
+ * value, does not fit into an empty buffer
+ * @return Return the new position or @p NULL when the callback asks to stop
+ */
+static uint8_t *
+wkb_writer_reserve(MeosWriter *writer, uint8_t *pos, size_t size)
+{
+  size_t len = (size_t) (pos - writer->buf);
+  if (len + size <= writer->maxlen)
+    return pos;
+  if (len > 0 && ! writer->write((char *) writer->buf, len, writer->arg))
+    return NULL;
+  if (size > writer->maxlen)
+  {
+    writer->buf = repalloc(writer->buf, size);
+    writer->maxlen = size;
+  }
+  return writer->buf;
+}
+
+/**
+ * @brief Maximum size of the binary header of a temporal value or of a
+ * composing sequence, that is, endian, type, flags, SRID, count, and bounds
+ */
+#define MEOS_WKB_HEADER_MAXSIZE 32
+
+/**
+ * @brief Write through the writer the composing instants of a temporal
+ * sequence in the Well-Known Binary (WKB) representation
+ * @param[in] writer Writer
+ * @param[in] seq Temporal sequence
+ * @param[in] pos Current position in the buffer of the writer
+ * @param[in] variant Output variant
+ * @param[in] state State of the compressed encoding, @p NULL if the output is
+ * not compressed
+ * @return Return the new position or @p NULL when the callback asks to stop
+ */
+static uint8_t *
+tsequence_to_wkb_write(MeosWriter *writer, const TSequence *seq,
+  uint8_t *pos, uint8_t variant, WkbDeltaState *state)
+{
+  size_t mult = (variant & WKB_HEX) ? 2 : 1;
+  pos = wkb_writer_reserve(writer, pos, mult * MEOS_WKB_HEADER_MAXSIZE);
+  if (! pos)
+    return NULL;
+  /* Write the count and the period bounds */
+  if (state)
+    pos = varint_to_wkb_buf((uint64) seq->count, pos, variant);
+  else
+    pos = int32_to_wkb_buf(seq->count, pos, variant);
+  pos = bounds_to_wkb_buf(seq->period.lower_inc, seq->period.upper_inc, pos,
+    variant);
+  /* Write the instants, reserving the exact size of each one */
+  meosType basetype = temptype_basetype(seq->temptype);
+  for (int i = 0; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    size_t size;
+    if (state)
+    {
+      WkbDeltaState copy = *state;
+      size = tinstant_to_wkb_size_delta(inst, &copy);
+    }
+    else
+      size = temporal_basetype_to_wkb_size(tinstant_val(inst), basetype,
+        inst->flags) + MEOS_WKB_TIMESTAMP_SIZE;
+    pos = wkb_writer_reserve(writer, pos, mult * size);
+    if (! pos)
+      return NULL;
+    pos = state ? tinstant_to_wkb_buf_delta(inst, state, pos, variant) :
+      tinstant_basevalue_time_to_wkb_buf(inst, pos, variant);
+  }
+  return pos;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Write the Well-Known Binary (WKB) representation of a temporal
+ * value through a callback in chunks of bounded size
+ * @details The concatenation of the chunks is the output of
+ * #temporal_as_wkb for the same variant, except that the hex-encoded output
+ * is not null-terminated
+ * @param[in] temp Temporal value
+ * @param[in] variant Output variant
+ * @param[in] write Callback receiving the chunks, which returns false to
+ * stop the output
+ * @param[in] arg Argument passed to the callback
+ * @return Return false on error or when the callback stops the output
+ * @csqlfn #Temporal_as_wkb_chunks()
+ */
+bool
+temporal_as_wkb_write(const Temporal *temp, uint8_t variant,
+  meos_write_fn write, void *arg)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) write))
+    return false;
+
+  /* If neither or both variants are specified, choose the native order */
+  if (! (variant & WKB_NDR || variant & WKB_XDR) ||
+    (variant & WKB_NDR && variant & WKB_XDR))
+  {
+    if (MEOS_IS_BIG_ENDIAN)
+      variant = variant | (uint8_t) WKB_XDR;
+    else
+      variant = variant | (uint8_t) WKB_NDR;
+  }
+
+  MeosWriter writer;
+  writer.write = write;
+  writer.arg = arg;
+  writer.maxlen = MEOS_WRITER_CHUNK_SIZE;
+  writer.buf = palloc(MEOS_WRITER_CHUNK_SIZE);
+  size_t mult = (variant & WKB_HEX) ? 2 : 1;
+  uint8_t *pos = temporal_header_to_wkb_buf(temp, writer.buf, variant);
+  WkbDeltaState state, *pstate = NULL;
+  if (temporal_wkb_compressed(temp, variant))
+  {
+    memset(&state, 0, sizeof(WkbDeltaState));
+    pstate = &state;
+  }
+
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+  {
+    const TInstant *inst = (const TInstant *) temp;
+    pos = wkb_writer_reserve(&writer, pos, mult * (MEOS_WKB_TIMESTAMP_SIZE +
+      temporal_basetype_to_wkb_size(tinstant_val(inst),
+        temptype_basetype(inst->temptype), inst->flags)));
+    if (pos)
+      pos = tinstant_basevalue_time_to_wkb_buf(inst, pos, variant);
+  }
+  else if (temp->subtype == TSEQUENCE)
+    pos = tsequence_to_wkb_write(&writer, (const TSequence *) temp, pos,
+      variant, pstate);
+  else /* TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    /* The header was written into an empty buffer and thus there is room
+     * for the count */
+    if (pstate)
+      pos = varint_to_wkb_buf((uint64) ss->count, pos, variant);
+    else
+      pos = int32_to_wkb_buf(ss->count, pos, variant);
+    for (int i = 0; i < ss->count && pos; i++)
+      pos = tsequence_to_wkb_write(&writer, TSEQUENCESET_SEQ_N(ss, i), pos,
+        variant, pstate);
+  }
+
+  /* Hand the remaining bytes to the callback */
+  bool result = false;
+  if (pos)
+  {
+    size_t len = (size_t) (pos - writer.buf);
+    result = (len == 0) || write((char *) writer.buf, len, arg);
+  }
+  pfree(writer.buf);
+  return result;
+}
+
+#if MEOS
+/**
+ * @brief Callback of the streaming writers writing the chunks into a file
+ */
+static bool
+file_write_fn(const char *data, size_t size, void *arg)
+{
+  return fwrite(data, 1, size, (FILE *) arg) == size;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Write the MF-JSON representation of a temporal value into a file
+ * without building the whole representation in memory
+ * @param[in] temp Temporal value
+ * @param[in] with_bbox True when the output value has bounding box
+ * @param[in] precision Number of decimal digits
+ * @param[in] srs Spatial reference system
+ * @param[in] file File opened for writing
+ * @return Return false on error
+ */
+bool
+temporal_as_mfjson_file(const Temporal *temp, bool with_bbox, int precision,
+  char *srs, FILE *file)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) file))
+    return false;
+  return temporal_as_mfjson_write(temp, with_bbox, precision, srs,
+    &file_write_fn, (void *) file);
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Write the Well-Known Binary (WKB) representation of a temporal
+ * value into a file without building the whole representation in memory
+ * @param[in] temp Temporal value
+ * @param[in] variant Output variant
+ * @param[in] file File opened for writing
+ * @return Return false on error
+ */
+bool
+temporal_as_wkb_file(const Temporal *temp, uint8_t variant, FILE *file)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) file))
+    return false;
+  return temporal_as_wkb_write(temp, variant, &file_write_fn, (void *) file);
 }
 #endif /* MEOS */
 
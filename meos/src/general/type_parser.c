@@ -38,6 +38,10 @@
 
 #include "general/type_parser.h"
 
+/* PostgreSQL */
+#include <postgres.h>
+#include <pgtime.h>
+#include <utils/datetime.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -400,8 +404,129 @@ tbox_parse(const char **str)
 /*****************************************************************************/
 /* Time Types */
 
+/**
+ * @brief Parse a given number of digits
+ * @return On error return -1
+ */
+static inline int
+digits_scan(const char *str, int n)
+{
+  int result = 0;
+  for (int i = 0; i < n; i++)
+  {
+    if (str[i] < '0' || str[i] > '9')
+      return -1;
+    result = result * 10 + (str[i] - '0');
+  }
+  return result;
+}
+
+/**
+ * @brief Scan a timestamp in the ISO 8601 format
+ * `YYYY-MM-DD[ T]HH:MM:SS[.ffffff][Z|+HH[[:]MM]|-HH[[:]MM]]`
+ * @details The function does not depend on the session state and can thus
+ * be called concurrently. On success, the time zone @p tz is expressed as in
+ * PostgreSQL in seconds west of UTC and is only set when @p hastz is true.
+ * @param[in] str Input string, which is not necessarily null-terminated
+ * @param[in] len Length of the input string
+ * @param[out] tm,fsec Broken-down time and fractional seconds
+ * @param[out] tz,hastz Time zone and whether it is given
+ * @return Return false when the string is not in this format, in which case
+ * it must be parsed with #pg_timestamptz_in()
+ */
+bool
+timestamp_scan_iso(const char *str, int len, struct pg_tm *tm, int32 *fsec,
+  int *tz, bool *hastz)
+{
+  static const int mdays[] =
+    {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (len < 19 || str[4] != '-' || str[7] != '-' ||
+      (str[10] != ' ' && str[10] != 'T') || str[13] != ':' || str[16] != ':')
+    return false;
+  memset(tm, 0, sizeof(struct pg_tm));
+  tm->tm_year = digits_scan(str, 4);
+  tm->tm_mon = digits_scan(str + 5, 2);
+  tm->tm_mday = digits_scan(str + 8, 2);
+  tm->tm_hour = digits_scan(str + 11, 2);
+  tm->tm_min = digits_scan(str + 14, 2);
+  tm->tm_sec = digits_scan(str + 17, 2);
+  /* Unusual values such as leap seconds are left to PostgreSQL */
+  if (tm->tm_year < 1 || tm->tm_mon < 1 || tm->tm_mon > 12 ||
+      tm->tm_mday < 1 || tm->tm_hour < 0 || tm->tm_hour > 23 ||
+      tm->tm_min < 0 || tm->tm_min > 59 || tm->tm_sec < 0 || tm->tm_sec > 59 ||
+      tm->tm_mday > mdays[tm->tm_mon - 1] +
+        (tm->tm_mon == 2 && isleap(tm->tm_year) ? 1 : 0))
+    return false;
+  int pos = 19;
+  *fsec = 0;
+  if (pos < len && str[pos] == '.')
+  {
+    int ndigits = 0;
+    for (pos++; pos < len && str[pos] >= '0' && str[pos] <= '9'; pos++)
+    {
+      /* Rounding of more than six digits is left to PostgreSQL */
+      if (++ndigits > 6)
+        return false;
+      *fsec = *fsec * 10 + (str[pos] - '0');
+    }
+    if (ndigits == 0)
+      return false;
+    for (; ndigits < 6; ndigits++)
+      *fsec *= 10;
+  }
+  *hastz = false;
+  if (pos < len && str[pos] == 'Z')
+  {
+    *tz = 0;
+    *hastz = true;
+    pos++;
+  }
+  else if (pos < len && (str[pos] == '+' || str[pos] == '-'))
+  {
+    int sign = (str[pos++] == '-') ? 1 : -1;
+    int tzhour = (pos + 2 <= len) ? digits_scan(str + pos, 2) : -1;
+    if (tzhour < 0 || tzhour > 15)
+      return false;
+    pos += 2;
+    int tzmin = 0;
+    if (pos < len && str[pos] == ':')
+      pos++;
+    if (pos < len)
+    {
+      tzmin = (pos + 2 <= len) ? digits_scan(str + pos, 2) : -1;
+      if (tzmin < 0 || tzmin > 59)
+        return false;
+      pos += 2;
+    }
+    *tz = sign * (tzhour * SECS_PER_HOUR + tzmin * SECS_PER_MINUTE);
+    *hastz = true;
+  }
+  return pos == len;
+}
+
+/**
+ * @brief Parse a timestamp value in the ISO 8601 format, where timestamps
+ * without time zone are interpreted in the session time zone
+ * @return Return false when the string must be parsed by PostgreSQL
+ */
+static bool
+timestamp_parse_iso(const char *str, int len, TimestampTz *result)
+{
+  struct pg_tm tm;
+  int32 fsec;
+  int tz;
+  bool hastz;
+  if (! timestamp_scan_iso(str, len, &tm, &fsec, &tz, &hastz))
+    return false;
+  if (! hastz)
+    tz = DetermineTimeZoneOffset(&tm, pg_session_timezone());
+  return tm2timestamp(&tm, fsec, &tz, result) == 0;
+}
+
 /**
  * @brief Parse a timestamp value from the buffer
+ * @details Timestamps in the ISO 8601 format are parsed directly, while the
+ * other ones are parsed by PostgreSQL
  * @return On error return DT_NOEND
  */
 TimestampTz
@@ -413,11 +538,23 @@ timestamp_parse(const char **str)
     (*str)[delim] != '}' && (*str)[delim] != '\0')
     delim++;
 
+  /* Fast path, trailing white spaces are ignored */
+  int len = delim;
+  while (len > 0 && ((*str)[len - 1] == ' ' || (*str)[len - 1] == '\t' ||
+      (*str)[len - 1] == '\n' || (*str)[len - 1] == '\r'))
+    len--;
+  TimestampTz result;
+  if (timestamp_parse_iso(*str, len, &result))
+  {
+    *str += delim;
+    return result;
+  }
+
   char *str1 = palloc(sizeof(char) * (delim + 1));
   strncpy(str1, *str, delim);
   str1[delim] = '\0';
   /* The last argument is for an unused typmod */
-  TimestampTz result = pg_timestamptz_in(str1, -1);
+  result = pg_timestamptz_in(str1, -1);
   pfree(str1);
   *str += delim;
   return result;
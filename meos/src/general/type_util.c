@@ -427,10 +427,17 @@ datum_hash_extended(Datum d, meosType type, uint64 seed)
       return pg_hashfloat8extended(DatumGetFloat8(d), seed);
     case T_TEXT:
       return pg_hashtextextended(DatumGetTextP(d), seed);
-    // PostGIS currently does not provide an extended hash function
-    // case T_GEOMETRY:
-    // case T_GEOGRAPHY:
-      // return gserialized_hash_extended(DatumGetGserializedP(d), seed);
+    case T_GEOMETRY:
+    case T_GEOGRAPHY:
+    {
+      /* PostGIS currently does not provide an extended hash function, the
+       * 32-bit hash is kept in the low-order bits to be consistent with
+       * #datum_hash() when the seed is 0 */
+      uint32 hash = gserialized_hash(DatumGetGserializedP(d));
+      uint64 result = hash_bytes_uint32_extended(hash, seed);
+      return (result & UINT64CONST(0xFFFFFFFF00000000)) |
+        (uint64) (hash ^ (uint32) seed);
+    }
 #if NPOINT
     case T_NPOINT:
       return npoint_hash_extended(DatumGetNpointP(d), seed);
@@ -639,6 +646,151 @@ tseqarr_sort(TSequence **sequences, int count)
   return;
 }
 
+/*****************************************************************************
+ * Merge functions of sorted runs
+ * The runs are merged with a binary heap of their indexes ordered by their
+ * current element, which costs O(N log k) for N elements in k runs instead
+ * of O(N log N) for sorting the concatenation of the runs
+ *****************************************************************************/
+
+/**
+ * @brief Structure keeping the state of a k-way merge of sorted runs
+ */
+typedef struct
+{
+  const void **values;     /**< Concatenation of the runs */
+  int *pos;                /**< Position of the current element of each run */
+  int *end;                /**< One past the last element of each run */
+  int *heap;               /**< Binary heap of the runs */
+  qsort_comparator cmp;    /**< Comparison function of the elements */
+} KWayMerge;
+
+/**
+ * @brief Return true if the current element of a run precedes the one of
+ * another run, the runs ordering the elements that compare equal so that
+ * the merge is stable
+ */
+static inline bool
+kway_less(const KWayMerge *m, int r1, int r2)
+{
+  int c = m->cmp(&m->values[m->pos[r1]], &m->values[m->pos[r2]]);
+  return c < 0 || (c == 0 && r1 < r2);
+}
+
+/**
+ * @brief Restore the heap property from a position of the heap downwards
+ */
+static void
+kway_sift_down(KWayMerge *m, int size, int i)
+{
+  while (true)
+  {
+    int min = i, l = 2 * i + 1, r = 2 * i + 2;
+    if (l < size && kway_less(m, m->heap[l], m->heap[min]))
+      min = l;
+    if (r < size && kway_less(m, m->heap[r], m->heap[min]))
+      min = r;
+    if (min == i)
+      return;
+    int tmp = m->heap[i];
+    m->heap[i] = m->heap[min];
+    m->heap[min] = tmp;
+    i = min;
+  }
+}
+
+/**
+ * @brief Merge runs of pointers, each one sorted according to a comparison
+ * function, into an array
+ * @param[in] values Concatenation of the runs
+ * @param[in] counts Number of elements of each run
+ * @param[in] nruns Number of runs
+ * @param[in] cmp Comparison function
+ * @param[out] result Array of the merged elements, which must have room for
+ * all the elements of the runs
+ */
+static void
+ptrarr_merge_runs(const void **values, const int *counts, int nruns,
+  qsort_comparator cmp, const void **result)
+{
+  /* The runs follow each other, e.g., partitions of consecutive periods */
+  int total = counts[0];
+  bool ordered = true;
+  for (int i = 1; i < nruns; i++)
+  {
+    if (ordered && counts[i] > 0 && total > 0 &&
+        cmp(&values[total - 1], &values[total]) > 0)
+      ordered = false;
+    total += counts[i];
+  }
+  if (ordered)
+  {
+    memcpy(result, values, sizeof(void *) * total);
+    return;
+  }
+
+  KWayMerge m;
+  m.values = values;
+  m.cmp = cmp;
+  m.pos = palloc(sizeof(int) * nruns);
+  m.end = palloc(sizeof(int) * nruns);
+  m.heap = palloc(sizeof(int) * nruns);
+  int size = 0, start = 0;
+  for (int i = 0; i < nruns; i++)
+  {
+    m.pos[i] = start;
+    start += counts[i];
+    m.end[i] = start;
+    if (counts[i] > 0)
+      m.heap[size++] = i;
+  }
+  for (int i = size / 2 - 1; i >= 0; i--)
+    kway_sift_down(&m, size, i);
+  int n = 0;
+  while (size > 0)
+  {
+    int run = m.heap[0];
+    result[n++] = values[m.pos[run]++];
+    if (m.pos[run] == m.end[run])
+      m.heap[0] = m.heap[--size];
+    kway_sift_down(&m, size, 0);
+  }
+  pfree(m.pos); pfree(m.end); pfree(m.heap);
+  return;
+}
+
+/**
+ * @brief Merge runs of temporal instants sorted by timestamp
+ * @param[in] instants Concatenation of the runs
+ * @param[in] counts Number of instants of each run
+ * @param[in] nruns Number of runs
+ * @param[out] result Array of the merged instants
+ */
+void
+tinstarr_merge_runs(const TInstant **instants, const int *counts, int nruns,
+  const TInstant **result)
+{
+  ptrarr_merge_runs((const void **) instants, counts, nruns,
+    (qsort_comparator) &tinstarr_sort_cmp, (const void **) result);
+  return;
+}
+
+/**
+ * @brief Merge runs of temporal sequences sorted by period
+ * @param[in] sequences Concatenation of the runs
+ * @param[in] counts Number of sequences of each run
+ * @param[in] nruns Number of runs
+ * @param[out] result Array of the merged sequences
+ */
+void
+tseqarr_merge_runs(const TSequence **sequences, const int *counts, int nruns,
+  const TSequence **result)
+{
+  ptrarr_merge_runs((const void **) sequences, counts, nruns,
+    (qsort_comparator) &tseqarr_sort_cmp, (const void **) result);
+  return;
+}
+
 /*****************************************************************************
  * Remove duplicate functions
  * These functions assume that the array has been sorted before
@@ -43,6 +43,7 @@
 #include "general/lifting.h"
 #include "general/temporal.h"
 #include "general/type_util.h"
+#include "point/pgis_types.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "npoint/tnpoint_static.h"
 
@@ -66,30 +67,47 @@ tnpointinst_tgeompointinst(const TInstant *inst)
 TSequence *
 tnpointseq_tgeompointseq_disc(const TSequence *seq)
 {
+  /* Fetch the distinct routes at once */
+  int64 *rids = palloc(sizeof(int64) * seq->count);
+  for (int i = 0; i < seq->count; i++)
+    rids[i] = DatumGetNpointP(tinstant_val(TSEQUENCE_INST_N(seq, i)))->rid;
+  int nrids = ridarr_sort_unique(rids, seq->count);
+  GSERIALIZED **lines = route_geom_batch(rids, nrids);
+
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   for (int i = 0; i < seq->count; i++)
-    instants[i] = tnpointinst_tgeompointinst(TSEQUENCE_INST_N(seq, i));
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    const Npoint *np = DatumGetNpointP(tinstant_val(inst));
+    GSERIALIZED *line = lines[ridarr_find(rids, nrids, np->rid)];
+    GSERIALIZED *geom = linestring_line_interpolate_point(line, np->pos, 0);
+    instants[i] = tinstant_make_free(PointerGetDatum(geom), T_TGEOMPOINT,
+      inst->t);
+  }
+  pfree_array((void **) lines, nrids);
+  pfree(rids);
   return tsequence_make_free(instants, seq->count, true, true, DISCRETE,
     NORMALIZE_NO);
 }
 
 /**
- * @brief Return a temporal network point converted to a temporal geometry point
+ * @brief Return a temporal network point converted to a temporal geometry
+ * point, where the route geometry of the sequence is given
+ * @param[in] seq Temporal network point
+ * @param[in] line Geometry of the route of the sequence
  */
-TSequence *
-tnpointseq_tgeompointseq_cont(const TSequence *seq)
+static TSequence *
+tnpointseq_tgeompointseq_cont_line(const TSequence *seq,
+  const GSERIALIZED *line)
 {
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  const TInstant *inst = TSEQUENCE_INST_N(seq, 0);
-  const Npoint *np = DatumGetNpointP(tinstant_val(inst));
   /* We are sure line is not empty */
-  GSERIALIZED *line = route_geom(np->rid);
   int srid = gserialized_get_srid(line);
   LWLINE *lwline = (LWLINE *) lwgeom_from_gserialized(line);
   for (int i = 0; i < seq->count; i++)
   {
-    inst = TSEQUENCE_INST_N(seq, i);
-    np = DatumGetNpointP(tinstant_val(inst));
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    const Npoint *np = DatumGetNpointP(tinstant_val(inst));
     POINTARRAY *opa = lwline_interpolate_points(lwline, np->pos, 0);
     assert(opa->npoints <= 1);
     LWGEOM *lwpoint = lwpoint_as_lwgeom(lwpoint_construct(srid, NULL, opa));
@@ -97,21 +115,51 @@ tnpointseq_tgeompointseq_cont(const TSequence *seq)
     lwgeom_free(lwpoint);
     instants[i] = tinstant_make_free(point, T_TGEOMPOINT, inst->t);
   }
-
-  pfree(line); lwline_free(lwline);
+  lwline_free(lwline);
   return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
     seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE_NO);
 }
 
+/**
+ * @brief Return a temporal network point converted to a temporal geometry point
+ */
+TSequence *
+tnpointseq_tgeompointseq_cont(const TSequence *seq)
+{
+  const Npoint *np = DatumGetNpointP(tinstant_val(TSEQUENCE_INST_N(seq, 0)));
+  GSERIALIZED *line = route_geom(np->rid);
+  TSequence *result = tnpointseq_tgeompointseq_cont_line(seq, line);
+  pfree(line);
+  return result;
+}
+
 /**
  * @brief Return a temporal network point converted to a temporal geometry point
  */
 TSequenceSet *
 tnpointseqset_tgeompointseqset(const TSequenceSet *ss)
 {
+  /* Fetch the distinct routes at once, each continuous sequence is defined
+   * on a single route */
+  int64 *rids = palloc(sizeof(int64) * ss->count);
+  for (int i = 0; i < ss->count; i++)
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    rids[i] = DatumGetNpointP(tinstant_val(TSEQUENCE_INST_N(seq, 0)))->rid;
+  }
+  int nrids = ridarr_sort_unique(rids, ss->count);
+  GSERIALIZED **lines = route_geom_batch(rids, nrids);
+
   TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
   for (int i = 0; i < ss->count; i++)
-    sequences[i] = tnpointseq_tgeompointseq_cont(TSEQUENCESET_SEQ_N(ss, i));
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    const Npoint *np = DatumGetNpointP(tinstant_val(TSEQUENCE_INST_N(seq, 0)));
+    sequences[i] = tnpointseq_tgeompointseq_cont_line(seq,
+      lines[ridarr_find(rids, nrids, np->rid)]);
+  }
+  pfree_array((void **) lines, nrids);
+  pfree(rids);
   return tsequenceset_make_free(sequences, ss->count, NORMALIZE_NO);
 }
 
@@ -151,21 +199,31 @@ tgeompointinst_tnpointinst(const TInstant *inst)
 
 /**
  * @brief Return a temporal geometry point converted to a temporal network point
+ * @note The instants are snapped in a single pass over the index of the route
+ * geometries, which prefers to keep the same route at junctions
  */
 TSequence *
 tgeompointseq_tnpointseq(const TSequence *seq)
 {
+  Npoint **points = tgeompointseq_snap(seq, DIST_EPSILON);
+  if (points == NULL)
+    return NULL;
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   for (int i = 0; i < seq->count; i++)
   {
-    TInstant *inst = tgeompointinst_tnpointinst(TSEQUENCE_INST_N(seq, i));
-    if (inst == NULL)
+    if (points[i] == NULL)
     {
       pfree_array((void **) instants, i);
+      for (int j = i + 1; j < seq->count; j++)
+        if (points[j])
+          pfree(points[j]);
+      pfree(points);
       return NULL;
     }
-    instants[i] = inst;
+    instants[i] = tinstant_make_free(PointerGetDatum(points[i]), T_TNPOINT,
+      TSEQUENCE_INST_N(seq, i)->t);
   }
+  pfree(points);
   return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
     seq->period.upper_inc, MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
 }
@@ -445,6 +503,26 @@ Set *
 tnpoint_routes(const Temporal *temp)
 {
   assert(temptype_subtype(temp->subtype));
+  /* The routes of a packed value are read without unpacking it */
+  if (temp->subtype != TINSTANT && MEOS_FLAGS_GET_COMPRESSED(temp->flags))
+  {
+    if (! tnpoint_packed(temp))
+    {
+      Temporal *temp1 = temporal_decompress(temp);
+      Set *result = tnpoint_routes(temp1);
+      pfree(temp1);
+      return result;
+    }
+    int nruns;
+    const int32 *runstarts;
+    const int64 *rids = tnpoint_packed_runs(temp, &runstarts, &nruns);
+    Datum *values = palloc(sizeof(Datum) * nruns);
+    for (int i = 0; i < nruns; i++)
+      values[i] = Int64GetDatum(rids[i]);
+    datumarr_sort(values, nruns, T_INT8);
+    int count = datumarr_remove_duplicates(values, nruns, T_INT8);
+    return set_make_free(values, count, T_INT8, ORDER_NO);
+  }
   switch (temp->subtype)
   {
     case TINSTANT:
@@ -458,5 +536,237 @@ tnpoint_routes(const Temporal *temp)
   }
 }
 
-/*****************************************************************************/
+/*****************************************************************************
+ * Packed storage format
+ *****************************************************************************/
+
+/**
+ * @brief Return the size of the body of a temporal network point in the
+ * packed format
+ */
+static size_t
+tnpoint_packed_size(int count, int nruns, int nseqs)
+{
+  return DOUBLE_PAD(sizeof(TNpointPacked) +
+    (sizeof(int64) + sizeof(int32)) * nruns +
+    (sizeof(TimestampTz) + sizeof(float4)) * count +
+    (sizeof(int32) + sizeof(uint8)) * nseqs);
+}
+
+/**
+ * @brief Return the body of a temporal network point in the packed format
+ */
+static TNpointPacked *
+tnpoint_packed_body(const Temporal *temp)
+{
+  return (TNpointPacked *) ((char *) temp +
+    temporal_compressed_header_size(temp));
+}
+
+/**
+ * @brief Return a network point with its position rounded to a float4
+ */
+static Datum
+datum_npoint_round_float4(Datum np)
+{
+  const Npoint *np1 = DatumGetNpointP(np);
+  return PointerGetDatum(npoint_make(np1->rid, (double) (float4) np1->pos));
+}
 
+/**
+ * @brief Return true if a temporal network point is stored in the packed
+ * format
+ */
+bool
+tnpoint_packed(const Temporal *temp)
+{
+  return temp->temptype == T_TNPOINT && temp->subtype != TINSTANT &&
+    MEOS_FLAGS_GET_COMPRESSED(temp->flags) &&
+    tnpoint_packed_body(temp)->format == TNPOINT_PACKED_FORMAT;
+}
+
+/**
+ * @brief Return the routes of the runs of instants of a temporal network
+ * point in the packed format
+ * @param[in] temp Temporal network point
+ * @param[out] runstarts Number of the first instant of each run
+ * @param[out] nruns Number of runs
+ */
+const int64 *
+tnpoint_packed_runs(const Temporal *temp, const int32 **runstarts, int *nruns)
+{
+  assert(tnpoint_packed(temp));
+  const TNpointPacked *pk = tnpoint_packed_body(temp);
+  const int64 *rids = (const int64 *) (pk + 1);
+  const TimestampTz *times = (const TimestampTz *) (rids + pk->nruns);
+  *runstarts = (const int32 *) (times + pk->count);
+  *nruns = pk->nruns;
+  return rids;
+}
+
+/**
+ * @ingroup meos_internal_temporal_transf
+ * @brief Return a temporal network point in the packed storage format
+ * @details The header and the bounding box of the value are kept unchanged as
+ * in #temporal_compress, while the instants are replaced by run-length
+ * encoded routes, the timestamps, and the positions as float4 values. The
+ * positions are rounded to float4 before computing the header so that the
+ * value obtained by #tnpoint_unpack has the same bounding box.
+ * @param[in] temp Temporal network point
+ * @return A copy of the temporal value if it is an instant
+ * @note The conversion loses the precision of the positions beyond float4
+ */
+Temporal *
+tnpoint_pack(const Temporal *temp)
+{
+  assert(temp); assert(temp->temptype == T_TNPOINT);
+  if (temp->subtype == TINSTANT || tnpoint_packed(temp))
+    return temporal_cp(temp);
+  if (MEOS_FLAGS_GET_COMPRESSED(temp->flags))
+  {
+    Temporal *temp1 = temporal_decompress(temp);
+    Temporal *result = tnpoint_pack(temp1);
+    pfree(temp1);
+    return result;
+  }
+
+  /* Round the positions */
+  LiftedFunctionInfo lfinfo;
+  memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
+  lfinfo.func = (varfunc) &datum_npoint_round_float4;
+  lfinfo.numparam = 0;
+  lfinfo.argtype[0] = temp->temptype;
+  lfinfo.restype = T_TNPOINT;
+  Temporal *rounded = tfunc_temporal(temp, &lfinfo);
+
+  /* Collect the composing sequences */
+  const TSequence **sequences;
+  int nseqs, count;
+  if (rounded->subtype == TSEQUENCE)
+  {
+    sequences = palloc(sizeof(TSequence *));
+    sequences[0] = (const TSequence *) rounded;
+    nseqs = 1;
+    count = sequences[0]->count;
+  }
+  else
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) rounded;
+    sequences = palloc(sizeof(TSequence *) * ss->count);
+    for (int i = 0; i < ss->count; i++)
+      sequences[i] = TSEQUENCESET_SEQ_N(ss, i);
+    nseqs = ss->count;
+    count = ss->totalcount;
+  }
+
+  /* Count the runs of instants on the same route */
+  int nruns = 0;
+  int64 rid = 0; /* make compiler quiet */
+  for (int i = 0; i < nseqs; i++)
+  {
+    for (int j = 0; j < sequences[i]->count; j++)
+    {
+      const Npoint *np = DatumGetNpointP(tinstant_val(
+        TSEQUENCE_INST_N(sequences[i], j)));
+      if (nruns == 0 || np->rid != rid)
+      {
+        rid = np->rid;
+        nruns++;
+      }
+    }
+  }
+
+  /* Copy the header and fill the body */
+  size_t hdrsize = temporal_compressed_header_size(rounded);
+  size_t memsize = hdrsize + tnpoint_packed_size(count, nruns, nseqs);
+  Temporal *result = palloc0(memsize);
+  memcpy(result, rounded, hdrsize);
+  SET_VARSIZE(result, memsize);
+  if (result->subtype == TSEQUENCE)
+    ((TSequence *) result)->maxcount = ((TSequence *) rounded)->count;
+  else
+    ((TSequenceSet *) result)->maxcount = ((TSequenceSet *) rounded)->count;
+  MEOS_FLAGS_SET_FIXED(result->flags, false);
+  MEOS_FLAGS_SET_COMPRESSED(result->flags, true);
+  TNpointPacked *pk = tnpoint_packed_body(result);
+  pk->format = TNPOINT_PACKED_FORMAT;
+  pk->count = count;
+  pk->nruns = nruns;
+  pk->nseqs = nseqs;
+  int64 *rids = (int64 *) (pk + 1);
+  TimestampTz *times = (TimestampTz *) (rids + nruns);
+  int32 *runstarts = (int32 *) (times + count);
+  int32 *seqstarts = runstarts + nruns;
+  float4 *positions = (float4 *) (seqstarts + nseqs);
+  uint8 *bounds = (uint8 *) (positions + count);
+  int k = 0, r = 0;
+  for (int i = 0; i < nseqs; i++)
+  {
+    seqstarts[i] = k;
+    bounds[i] = (sequences[i]->period.lower_inc ? 1 : 0) |
+      (sequences[i]->period.upper_inc ? 2 : 0);
+    for (int j = 0; j < sequences[i]->count; j++)
+    {
+      const TInstant *inst = TSEQUENCE_INST_N(sequences[i], j);
+      const Npoint *np = DatumGetNpointP(tinstant_val(inst));
+      if (r == 0 || np->rid != rids[r - 1])
+      {
+        rids[r] = np->rid;
+        runstarts[r++] = k;
+      }
+      times[k] = inst->t;
+      positions[k++] = (float4) np->pos;
+    }
+  }
+  pfree(sequences); pfree(rounded);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_transf
+ * @brief Return a temporal network point in the packed storage format
+ * converted to the standard format
+ * @param[in] temp Temporal network point
+ */
+Temporal *
+tnpoint_unpack(const Temporal *temp)
+{
+  assert(tnpoint_packed(temp));
+  const TNpointPacked *pk = tnpoint_packed_body(temp);
+  const int64 *rids = (const int64 *) (pk + 1);
+  const TimestampTz *times = (const TimestampTz *) (rids + pk->nruns);
+  const int32 *runstarts = (const int32 *) (times + pk->count);
+  const int32 *seqstarts = runstarts + pk->nruns;
+  const float4 *positions = (const float4 *) (seqstarts + pk->nseqs);
+  const uint8 *bounds = (const uint8 *) (positions + pk->count);
+  interpType interp = MEOS_FLAGS_GET_INTERP(temp->flags);
+
+  TSequence **sequences = palloc(sizeof(TSequence *) * pk->nseqs);
+  int r = 0;
+  for (int i = 0; i < pk->nseqs; i++)
+  {
+    int start = seqstarts[i];
+    int end = (i < pk->nseqs - 1) ? seqstarts[i + 1] : pk->count;
+    TInstant **instants = palloc(sizeof(TInstant *) * (end - start));
+    for (int k = start; k < end; k++)
+    {
+      while (r < pk->nruns - 1 && runstarts[r + 1] <= k)
+        r++;
+      Npoint *np = npoint_make(rids[r], (double) positions[k]);
+      instants[k - start] = tinstant_make_free(PointerGetDatum(np), T_TNPOINT,
+        times[k]);
+    }
+    sequences[i] = tsequence_make_free(instants, end - start, bounds[i] & 1,
+      (bounds[i] & 2) != 0, interp, NORMALIZE_NO);
+  }
+  if (temp->subtype == TSEQUENCE)
+  {
+    TSequence *result = sequences[0];
+    pfree(sequences);
+    return (Temporal *) result;
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, pk->nseqs,
+    NORMALIZE_NO);
+}
+
+/*****************************************************************************/
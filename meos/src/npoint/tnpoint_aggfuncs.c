@@ -38,9 +38,6 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
-#include "general/skiplist.h"
-#include "general/temporal_aggfuncs.h"
-#include "general/type_util.h"
 #include "point/tpoint_aggfuncs.h"
 #include "npoint/tnpoint_spatialfuncs.h"
 
@@ -50,38 +47,16 @@
  * @brief Transition function for temporal centroid aggregation of temporal
  * network points
  */
-SkipList *
-tnpoint_tcentroid_transfn(SkipList *state, Temporal *temp)
+TCentroidState *
+tnpoint_tcentroid_transfn(TCentroidState *state, const Temporal *temp)
 {
   /* Null temporal: return state */
   if (! temp)
     return state;
-  bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
-  /* Ensure validity of the arguments */
-  if (! ensure_geoaggstate(state, tnpoint_srid(temp), hasz))
-    return NULL;
   Temporal *temp1 = tnpoint_tgeompoint(temp);
-  datum_func2 func = MEOS_FLAGS_GET_Z(temp1->flags) ?
-    &datum_sum_double4 : &datum_sum_double3;
-
-  int count;
-  Temporal **temparr = tpoint_transform_tcentroid(temp1, &count);
-  if (state)
-    skiplist_splice(state, (void **) temparr, count, func, false);
-  else
-  {
-    state = skiplist_make((void **) temparr, count);
-    struct GeoAggregateState extra =
-    {
-      .srid = tpoint_srid(temp1),
-      .hasz = MEOS_FLAGS_GET_Z(temp1->flags) != 0
-    };
-    aggstate_set_extra(state, &extra, sizeof(struct GeoAggregateState));
-  }
-
-  pfree_array((void **) temparr, count);
+  TCentroidState *result = tpoint_tcentroid_transfn(state, temp1);
   pfree(temp1);
-  return state;
+  return result;
 }
 
 /*****************************************************************************/
@@ -155,16 +155,19 @@ tnpointinstarr_linear_set_stbox(const TInstant **instants, int count,
     posmax = Max(posmax, np->pos);
   }
 
-  GSERIALIZED *line = route_geom(rid);
-  GSERIALIZED *gs = (posmin == 0 && posmax == 1) ? line :
-    linestring_substring(line, posmin, posmax);
-  geo_set_stbox(gs, box);
+  if (posmin == 0 && posmax == 1)
+    /* The bounding box of the whole route is kept in the route cache */
+    route_set_stbox(rid, box);
+  else
+  {
+    GSERIALIZED *line = route_geom(rid);
+    GSERIALIZED *gs = linestring_substring(line, posmin, posmax);
+    geo_set_stbox(gs, box);
+    pfree(line); pfree(gs);
+  }
   span_set(TimestampTzGetDatum(tmin), TimestampTzGetDatum(tmax),
     true, true, T_TIMESTAMPTZ, T_TSTZSPAN, &box->period);
   MEOS_FLAGS_SET_T(box->flags, true);
-  pfree(line);
-  if (posmin != 0 || posmax != 1)
-    pfree(gs);
   return;
 }
 
@@ -207,7 +210,7 @@ tnpointseq_expand_stbox(const TSequence *seq, const TInstant *inst)
     Npoint *np2 = DatumGetNpointP(tinstant_val(inst));
     int64 rid = np1->rid;
     double posmin = Min(np1->pos, np2->pos);
-    double posmax = Min(np1->pos, np2->pos);
+    double posmax = Max(np1->pos, np2->pos);
     GSERIALIZED *line = route_geom(rid);
     GSERIALIZED *gs = (posmin == 0 && posmax == 1) ? line :
       linestring_substring(line, posmin, posmax);
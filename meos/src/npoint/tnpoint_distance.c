@@ -34,9 +34,12 @@
 
 #include "npoint/tnpoint_distance.h"
 
+/* PostGIS */
+#include <liblwgeom.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/lifting.h"
 #include "point/pgis_types.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "npoint/tnpoint_spatialfuncs.h"
@@ -56,6 +59,95 @@ npoint_distance(Datum np1, Datum np2)
   return pt_distance2d(geom1, geom2);
 }
 
+/*****************************************************************************
+ * Same-route fast path
+ *****************************************************************************/
+
+/**
+ * @brief Return true if all the instants of two temporal network points are
+ * located on the same route
+ * @param[in] temp1,temp2 Temporal network points
+ * @param[out] rid Route identifier
+ */
+bool
+tnpoint_same_route(const Temporal *temp1, const Temporal *temp2, int64 *rid)
+{
+  int count1, count2;
+  const TInstant **instants1 = temporal_insts(temp1, &count1);
+  const TInstant **instants2 = temporal_insts(temp2, &count2);
+  *rid = DatumGetNpointP(tinstant_val(instants1[0]))->rid;
+  bool result = true;
+  for (int i = 1; i < count1 && result; i++)
+    if (DatumGetNpointP(tinstant_val(instants1[i]))->rid != *rid)
+      result = false;
+  for (int i = 0; i < count2 && result; i++)
+    if (DatumGetNpointP(tinstant_val(instants2[i]))->rid != *rid)
+      result = false;
+  pfree(instants1); pfree(instants2);
+  return result;
+}
+
+/**
+ * @brief Return true if the geometry of a route is a straight line, that is,
+ * if the distance along the route is equal to the Euclidean distance
+ */
+bool
+route_straight(int64 rid)
+{
+  GSERIALIZED *gs = route_geom(rid);
+  if (! gs)
+    return false;
+  LWGEOM *geom = lwgeom_from_gserialized(gs);
+  bool result = (geom->type == LINETYPE && lwgeom_count_vertices(geom) == 2);
+  lwgeom_free(geom); pfree(gs);
+  return result;
+}
+
+/**
+ * @brief Return the position of a network point as a float datum
+ */
+static Datum
+datum_npoint_position(Datum np)
+{
+  return Float8GetDatum(DatumGetNpointP(np)->pos);
+}
+
+/**
+ * @brief Return the temporal distance along a route between two temporal
+ * network points located on that route
+ * @details The distance is computed from the positions and the length of the
+ * route without converting the network points into geometries. It is an upper
+ * bound of the Euclidean distance which is exact when the route is straight,
+ * see #route_straight.
+ * @param[in] temp1,temp2 Temporal network points
+ * @param[in] rid Route identifier of both temporal network points
+ * @return On error or if the values do not intersect in time return @p NULL
+ */
+Temporal *
+distance_tnpoint_tnpoint_route(const Temporal *temp1, const Temporal *temp2,
+  int64 rid)
+{
+  double length = route_length(rid);
+  if (length < 0)
+    return NULL;
+  /* We only need to fill these parameters for tfunc_temporal */
+  LiftedFunctionInfo lfinfo;
+  memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
+  lfinfo.func = (varfunc) &datum_npoint_position;
+  lfinfo.numparam = 0;
+  lfinfo.argtype[0] = temp1->temptype;
+  lfinfo.restype = T_TFLOAT;
+  Temporal *pos1 = tfunc_temporal(temp1, &lfinfo);
+  Temporal *pos2 = tfunc_temporal(temp2, &lfinfo);
+  Temporal *dist = distance_tnumber_tnumber(pos1, pos2);
+  pfree(pos1); pfree(pos2);
+  if (! dist)
+    return NULL;
+  Temporal *result = mult_tfloat_float(dist, length);
+  pfree(dist);
+  return result;
+}
+
 /*****************************************************************************
  * Temporal distance
  *****************************************************************************/
@@ -94,9 +186,10 @@ distance_tnpoint_npoint(const Temporal *temp, const Npoint *np)
 
 /**
  * @brief Return the temporal distance between two temporal network points
+ * converted into temporal geometry points
  */
-Temporal *
-distance_tnpoint_tnpoint(const Temporal *temp1, const Temporal *temp2)
+static Temporal *
+distance_tnpoint_tnpoint_geom(const Temporal *temp1, const Temporal *temp2)
 {
   Temporal *tpoint1 = tnpoint_tgeompoint(temp1);
   Temporal *tpoint2 = tnpoint_tgeompoint(temp2);
@@ -105,6 +198,19 @@ distance_tnpoint_tnpoint(const Temporal *temp1, const Temporal *temp2)
   return result;
 }
 
+/**
+ * @brief Return the temporal distance between two temporal network points
+ */
+Temporal *
+distance_tnpoint_tnpoint(const Temporal *temp1, const Temporal *temp2)
+{
+  /* Values on the same straight route do not need to be converted */
+  int64 rid;
+  if (tnpoint_same_route(temp1, temp2, &rid) && route_straight(rid))
+    return distance_tnpoint_tnpoint_route(temp1, temp2, rid);
+  return distance_tnpoint_tnpoint_geom(temp1, temp2);
+}
+
 /*****************************************************************************
  * Nearest approach instant (NAI)
  *****************************************************************************/
@@ -207,10 +313,26 @@ nad_tnpoint_npoint(const Temporal *temp, const Npoint *np)
 double
 nad_tnpoint_tnpoint(const Temporal *temp1, const Temporal *temp2)
 {
-  Temporal *dist = distance_tnpoint_tnpoint(temp1, temp2);
+  /* Values on the same route that meet have a zero distance whatever the
+   * geometry of the route */
+  int64 rid;
+  if (tnpoint_same_route(temp1, temp2, &rid))
+  {
+    Temporal *dist = distance_tnpoint_tnpoint_route(temp1, temp2, rid);
+    if (dist == NULL)
+      return -1;
+    double result = DatumGetFloat8(temporal_min_value(dist));
+    pfree(dist);
+    if (result == 0.0 || route_straight(rid))
+      return result;
+  }
+
+  Temporal *dist = distance_tnpoint_tnpoint_geom(temp1, temp2);
   if (dist == NULL)
     return -1;
-  return DatumGetFloat8(temporal_min_value(dist));
+  double result = DatumGetFloat8(temporal_min_value(dist));
+  pfree(dist);
+  return result;
 }
 
 /*****************************************************************************
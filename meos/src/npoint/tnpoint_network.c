@@ -0,0 +1,1025 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Network distance for network points and temporal network points.
+ *
+ * The network distance between two network points is the length of the
+ * shortest path between them along the routes. The routes of the network are
+ * read once into a graph in Compressed Sparse Row (CSR) format whose nodes are
+ * the end points of the routes, two routes being connected when they share an
+ * end point, and whose edges are the routes, which can be traversed in both
+ * directions. The graph is kept until the routes change, that is, in
+ * MobilityDB until the route cache is flushed and in MEOS until the route
+ * table or the route provider is changed.
+ *
+ * The shortest paths are computed with the ALT algorithm, that is, an A*
+ * search whose heuristic is the lower bound given by the triangle inequality
+ * on the distances to a small set of landmark nodes. The distances from the
+ * landmarks to all the nodes are computed when the graph is built.
+ */
+
+/* C */
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+/* PostgreSQL */
+#include <postgres.h>
+#if ! MEOS
+  #include <utils/memutils.h>
+#endif /* ! MEOS */
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+#include "general/type_util.h"
+#include "npoint/tnpoint_distance.h"
+#include "npoint/tnpoint_static.h"
+
+/** Maximum number of landmarks of the graph of the route network */
+#ifndef ROUTE_GRAPH_LANDMARKS
+  #define ROUTE_GRAPH_LANDMARKS 8
+#endif
+
+/**
+ * @brief Structure to represent the graph of the route network
+ */
+typedef struct
+{
+  int nnodes;            /**< Number of nodes */
+  int nroutes;           /**< Number of routes */
+  int64 *rids;           /**< Route identifiers in ascending order */
+  int *source;           /**< Start node of each route */
+  int *target;           /**< End node of each route */
+  double *lengths;       /**< Length of each route */
+  int *offsets;          /**< Offsets of the arcs of each node, nnodes + 1 */
+  int *arcnodes;         /**< Node reached by each arc */
+  double *arclengths;    /**< Length of each arc */
+  int nlandmarks;        /**< Number of landmarks */
+  double *lmdist;        /**< Distances from each landmark to every node */
+  /* Scratch space of the searches */
+  double *dist;          /**< Tentative distance of each node */
+  uint32 *visit;         /**< Search in which the distance was set */
+  uint32 *done;          /**< Search in which the node was settled */
+  uint32 search;         /**< Number of the current search */
+  double *heapkeys;      /**< Keys of the binary heap */
+  int *heapnodes;        /**< Nodes of the binary heap */
+} RouteGraph;
+
+/**
+ * @brief Global variable keeping the graph of the route network
+ */
+static RouteGraph *ROUTE_GRAPH = NULL;
+
+#if ! MEOS
+/**
+ * @brief Memory context of the graph of the route network
+ */
+static MemoryContext ROUTE_GRAPH_CXT = NULL;
+#endif /* ! MEOS */
+
+/*****************************************************************************
+ * Graph construction
+ *****************************************************************************/
+
+/**
+ * @brief Allocate memory for the graph of the route network
+ */
+static void *
+route_graph_alloc(size_t size)
+{
+#if ! MEOS
+  return MemoryContextAlloc(ROUTE_GRAPH_CXT, size);
+#else
+  return palloc(size);
+#endif /* ! MEOS */
+}
+
+/**
+ * @brief Free the graph of the route network, which is built again by the
+ * next network distance computation
+ */
+void
+route_graph_reset(void)
+{
+#if ! MEOS
+  if (ROUTE_GRAPH_CXT)
+    MemoryContextDelete(ROUTE_GRAPH_CXT);
+  ROUTE_GRAPH_CXT = NULL;
+#else
+  if (ROUTE_GRAPH)
+  {
+    RouteGraph *g = ROUTE_GRAPH;
+    pfree(g->rids); pfree(g->source); pfree(g->target); pfree(g->lengths);
+    pfree(g->offsets); pfree(g->arcnodes); pfree(g->arclengths);
+    pfree(g->lmdist); pfree(g->dist); pfree(g->visit); pfree(g->done);
+    pfree(g->heapkeys); pfree(g->heapnodes); pfree(g);
+  }
+#endif /* ! MEOS */
+  ROUTE_GRAPH = NULL;
+  return;
+}
+
+/**
+ * @brief Structure to sort the end points of the routes
+ */
+typedef struct
+{
+  double x;              /**< X coordinate */
+  double y;              /**< Y coordinate */
+  int end;               /**< 2 * route + 0 for the start, + 1 for the end */
+} RouteEnd;
+
+/**
+ * @brief Comparator function for the end points of the routes
+ */
+static int
+route_end_cmp(const RouteEnd *l, const RouteEnd *r)
+{
+  if (l->x != r->x)
+    return l->x < r->x ? -1 : 1;
+  if (l->y != r->y)
+    return l->y < r->y ? -1 : 1;
+  return 0;
+}
+
+/**
+ * @brief Structure to sort the routes by identifier
+ */
+typedef struct
+{
+  int64 rid;             /**< Route identifier */
+  int pos;               /**< Position in the arrays read from the routes */
+} RouteOrder;
+
+/**
+ * @brief Comparator function for the routes
+ */
+static int
+route_order_cmp(const RouteOrder *l, const RouteOrder *r)
+{
+  if (l->rid == r->rid)
+    return 0;
+  return l->rid < r->rid ? -1 : 1;
+}
+
+/*****************************************************************************
+ * Binary heap
+ *****************************************************************************/
+
+/**
+ * @brief Push a node into the binary heap of a search
+ */
+static void
+route_heap_push(RouteGraph *g, int *count, double key, int node)
+{
+  int i = (*count)++;
+  while (i > 0)
+  {
+    int parent = (i - 1) / 2;
+    if (g->heapkeys[parent] <= key)
+      break;
+    g->heapkeys[i] = g->heapkeys[parent];
+    g->heapnodes[i] = g->heapnodes[parent];
+    i = parent;
+  }
+  g->heapkeys[i] = key;
+  g->heapnodes[i] = node;
+  return;
+}
+
+/**
+ * @brief Pop the node with the smallest key from the binary heap of a search
+ */
+static int
+route_heap_pop(RouteGraph *g, int *count, double *key)
+{
+  int result = g->heapnodes[0];
+  *key = g->heapkeys[0];
+  int n = --(*count);
+  double lastkey = g->heapkeys[n];
+  int lastnode = g->heapnodes[n];
+  int i = 0;
+  while (2 * i + 1 < n)
+  {
+    int child = 2 * i + 1;
+    if (child + 1 < n && g->heapkeys[child + 1] < g->heapkeys[child])
+      child++;
+    if (lastkey <= g->heapkeys[child])
+      break;
+    g->heapkeys[i] = g->heapkeys[child];
+    g->heapnodes[i] = g->heapnodes[child];
+    i = child;
+  }
+  g->heapkeys[i] = lastkey;
+  g->heapnodes[i] = lastnode;
+  return result;
+}
+
+/*****************************************************************************
+ * Shortest paths
+ *****************************************************************************/
+
+/**
+ * @brief Start a new search in the graph, invalidating the distances of the
+ * previous search without reinitializing the arrays
+ */
+static void
+route_search_start(RouteGraph *g)
+{
+  if (++g->search == 0)
+  {
+    /* The search counter wrapped around */
+    memset(g->visit, 0, sizeof(uint32) * g->nnodes);
+    memset(g->done, 0, sizeof(uint32) * g->nnodes);
+    g->search = 1;
+  }
+  return;
+}
+
+/**
+ * @brief Compute with the Dijkstra algorithm the distances from a node to all
+ * the nodes of the graph
+ * @param[in] g Graph
+ * @param[in] source Source node
+ * @param[out] result Distances, DBL_MAX for the unreachable nodes
+ */
+static void
+route_dijkstra_all(RouteGraph *g, int source, double *result)
+{
+  for (int i = 0; i < g->nnodes; i++)
+    result[i] = DBL_MAX;
+  route_search_start(g);
+  int count = 0;
+  result[source] = 0.0;
+  route_heap_push(g, &count, 0.0, source);
+  while (count > 0)
+  {
+    double key;
+    int node = route_heap_pop(g, &count, &key);
+    if (g->done[node] == g->search)
+      continue;
+    g->done[node] = g->search;
+    for (int k = g->offsets[node]; k < g->offsets[node + 1]; k++)
+    {
+      int next = g->arcnodes[k];
+      double d = key + g->arclengths[k];
+      if (d < result[next])
+      {
+        result[next] = d;
+        route_heap_push(g, &count, d, next);
+      }
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Return a lower bound of the distance between two nodes given by the
+ * landmarks, or DBL_MAX if the nodes are not connected
+ */
+static double
+route_lower_bound(const RouteGraph *g, int node1, int node2)
+{
+  double result = 0.0;
+  for (int i = 0; i < g->nlandmarks; i++)
+  {
+    const double *lm = g->lmdist + (size_t) i * g->nnodes;
+    bool reach1 = lm[node1] < DBL_MAX, reach2 = lm[node2] < DBL_MAX;
+    /* A landmark reaching only one of the nodes proves that they are in
+     * different connected components */
+    if (reach1 != reach2)
+      return DBL_MAX;
+    if (reach1)
+      result = Max(result, fabs(lm[node1] - lm[node2]));
+  }
+  return result;
+}
+
+/**
+ * @brief Compute with the ALT algorithm the distances from a node to two nodes
+ * of the graph
+ * @param[in] g Graph
+ * @param[in] source Source node
+ * @param[in] targets Target nodes
+ * @param[out] result Distances, DBL_MAX for the unreachable nodes
+ */
+static void
+route_alt_search(RouteGraph *g, int source, const int targets[2],
+  double result[2])
+{
+  result[0] = result[1] = DBL_MAX;
+  bool found[2];
+  int nfound = 0;
+  for (int i = 0; i < 2; i++)
+  {
+    found[i] = false;
+    if (targets[i] == source)
+    {
+      result[i] = 0.0;
+      found[i] = true;
+      nfound++;
+    }
+    else if (route_lower_bound(g, source, targets[i]) == DBL_MAX)
+    {
+      found[i] = true;
+      nfound++;
+    }
+  }
+  if (nfound == 2)
+    return;
+
+  route_search_start(g);
+  int count = 0;
+  g->dist[source] = 0.0;
+  g->visit[source] = g->search;
+  route_heap_push(g, &count, 0.0, source);
+  while (count > 0 && nfound < 2)
+  {
+    double key;
+    int node = route_heap_pop(g, &count, &key);
+    if (g->done[node] == g->search)
+      continue;
+    g->done[node] = g->search;
+    double d = g->dist[node];
+    for (int i = 0; i < 2; i++)
+    {
+      if (! found[i] && node == targets[i])
+      {
+        result[i] = d;
+        found[i] = true;
+        nfound++;
+      }
+    }
+    for (int k = g->offsets[node]; k < g->offsets[node + 1]; k++)
+    {
+      int next = g->arcnodes[k];
+      double dnext = d + g->arclengths[k];
+      if (g->visit[next] == g->search && g->dist[next] <= dnext)
+        continue;
+      /* The heuristic is the smallest lower bound to the targets that are
+       * still to be found, which is consistent */
+      double h = DBL_MAX;
+      for (int i = 0; i < 2; i++)
+        if (! found[i])
+          h = Min(h, route_lower_bound(g, next, targets[i]));
+      if (h == DBL_MAX)
+        continue;
+      g->dist[next] = dnext;
+      g->visit[next] = g->search;
+      route_heap_push(g, &count, dnext + h, next);
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Choose the landmarks of the graph and compute their distances to all
+ * the nodes
+ * @details The landmarks are chosen by the farthest heuristic, each landmark
+ * being the node farthest from the previous ones, where the nodes that are
+ * unreachable from the previous landmarks are the farthest ones, so that each
+ * connected component has a landmark while there are landmarks left.
+ */
+static void
+route_graph_landmarks(RouteGraph *g)
+{
+  g->nlandmarks = Min(ROUTE_GRAPH_LANDMARKS, g->nnodes);
+  g->lmdist = route_graph_alloc(sizeof(double) * g->nlandmarks * g->nnodes);
+  double *mindist = palloc(sizeof(double) * g->nnodes);
+  int landmark = 0;
+  for (int i = 0; i < g->nlandmarks; i++)
+  {
+    double *lm = g->lmdist + (size_t) i * g->nnodes;
+    route_dijkstra_all(g, landmark, lm);
+    double farthest = -1.0;
+    for (int j = 0; j < g->nnodes; j++)
+    {
+      mindist[j] = (i == 0) ? lm[j] : Min(mindist[j], lm[j]);
+      if (mindist[j] > farthest)
+      {
+        farthest = mindist[j];
+        landmark = j;
+      }
+    }
+    /* Every node is a landmark */
+    if (farthest == 0.0)
+    {
+      g->nlandmarks = i + 1;
+      break;
+    }
+  }
+  pfree(mindist);
+  return;
+}
+
+/**
+ * @brief Return the graph of the route network, building it if needed
+ * @return On error return @p NULL
+ */
+static RouteGraph *
+route_graph_get(void)
+{
+  if (ROUTE_GRAPH)
+    return ROUTE_GRAPH;
+
+  int64 *rids;
+  double *ends, *lengths;
+  int count;
+  if (! route_network_read(&rids, &ends, &lengths, &count))
+    return NULL;
+
+  /* Free a graph whose construction was interrupted by an error */
+  route_graph_reset();
+#if ! MEOS
+  ROUTE_GRAPH_CXT = AllocSetContextCreate(CacheMemoryContext,
+    "MobilityDB route graph", ALLOCSET_DEFAULT_SIZES);
+#endif /* ! MEOS */
+  RouteGraph *g = route_graph_alloc(sizeof(RouteGraph));
+  memset(g, 0, sizeof(RouteGraph));
+
+  /* Sort the routes by identifier */
+  RouteOrder *order = palloc(sizeof(RouteOrder) * count);
+  for (int i = 0; i < count; i++)
+  {
+    order[i].rid = rids[i];
+    order[i].pos = i;
+  }
+  qsort(order, (size_t) count, sizeof(RouteOrder),
+    (qsort_comparator) &route_order_cmp);
+  g->nroutes = count;
+  g->rids = route_graph_alloc(sizeof(int64) * count);
+  g->lengths = route_graph_alloc(sizeof(double) * count);
+  g->source = route_graph_alloc(sizeof(int) * count);
+  g->target = route_graph_alloc(sizeof(int) * count);
+  RouteEnd *pts = palloc(sizeof(RouteEnd) * count * 2);
+  for (int i = 0; i < count; i++)
+  {
+    int pos = order[i].pos;
+    g->rids[i] = order[i].rid;
+    g->lengths[i] = lengths[pos];
+    pts[2 * i].x = ends[4 * pos];
+    pts[2 * i].y = ends[4 * pos + 1];
+    pts[2 * i].end = 2 * i;
+    pts[2 * i + 1].x = ends[4 * pos + 2];
+    pts[2 * i + 1].y = ends[4 * pos + 3];
+    pts[2 * i + 1].end = 2 * i + 1;
+  }
+  pfree(order); pfree(rids); pfree(ends); pfree(lengths);
+
+  /* The nodes are the distinct end points of the routes */
+  qsort(pts, (size_t) count * 2, sizeof(RouteEnd),
+    (qsort_comparator) &route_end_cmp);
+  int nnodes = 0;
+  for (int i = 0; i < count * 2; i++)
+  {
+    if (i == 0 || route_end_cmp(&pts[i - 1], &pts[i]) != 0)
+      nnodes++;
+    int route = pts[i].end / 2;
+    if (pts[i].end % 2 == 0)
+      g->source[route] = nnodes - 1;
+    else
+      g->target[route] = nnodes - 1;
+  }
+  pfree(pts);
+  g->nnodes = nnodes;
+
+  /* Build the arcs of both directions of the routes in CSR format */
+  g->offsets = route_graph_alloc(sizeof(int) * (nnodes + 1));
+  memset(g->offsets, 0, sizeof(int) * (nnodes + 1));
+  for (int i = 0; i < count; i++)
+  {
+    g->offsets[g->source[i] + 1]++;
+    g->offsets[g->target[i] + 1]++;
+  }
+  for (int i = 0; i < nnodes; i++)
+    g->offsets[i + 1] += g->offsets[i];
+  g->arcnodes = route_graph_alloc(sizeof(int) * count * 2);
+  g->arclengths = route_graph_alloc(sizeof(double) * count * 2);
+  int *fill = palloc(sizeof(int) * nnodes);
+  memcpy(fill, g->offsets, sizeof(int) * nnodes);
+  for (int i = 0; i < count; i++)
+  {
+    int k = fill[g->source[i]]++;
+    g->arcnodes[k] = g->target[i];
+    g->arclengths[k] = g->lengths[i];
+    k = fill[g->target[i]]++;
+    g->arcnodes[k] = g->source[i];
+    g->arclengths[k] = g->lengths[i];
+  }
+  pfree(fill);
+
+  /* Allocate the scratch space of the searches, the heap keeps at most one
+   * entry per relaxed arc plus the source */
+  g->dist = route_graph_alloc(sizeof(double) * nnodes);
+  g->visit = route_graph_alloc(sizeof(uint32) * nnodes);
+  g->done = route_graph_alloc(sizeof(uint32) * nnodes);
+  memset(g->visit, 0, sizeof(uint32) * nnodes);
+  memset(g->done, 0, sizeof(uint32) * nnodes);
+  g->search = 0;
+  g->heapkeys = route_graph_alloc(sizeof(double) * (count * 2 + 1));
+  g->heapnodes = route_graph_alloc(sizeof(int) * (count * 2 + 1));
+
+  route_graph_landmarks(g);
+  ROUTE_GRAPH = g;
+  return g;
+}
+
+/**
+ * @brief Return the position of a route in the graph, or -1 if the route is
+ * not in the graph
+ */
+static int
+route_graph_find(const RouteGraph *g, int64 rid)
+{
+  int first = 0, last = g->nroutes - 1;
+  while (first <= last)
+  {
+    int middle = (first + last) / 2;
+    if (g->rids[middle] == rid)
+      return middle;
+    if (g->rids[middle] < rid)
+      first = middle + 1;
+    else
+      last = middle - 1;
+  }
+  return -1;
+}
+
+/*****************************************************************************
+ * Network distance between network points
+ *****************************************************************************/
+
+/**
+ * @brief Structure to keep the distances between the end points of two
+ * routes, from which the network distance between two network points located
+ * on these routes is computed from their positions
+ */
+typedef struct
+{
+  double length1;        /**< Length of the first route */
+  double length2;        /**< Length of the second route */
+  bool same;             /**< True if both routes are equal */
+  double dist[4];        /**< Distances start1-start2, start1-end2,
+                              end1-start2, end1-end2, DBL_MAX if unreachable */
+} RoutePair;
+
+/**
+ * @brief Initialize the distances between the end points of two routes
+ * @return On error return false
+ */
+static bool
+route_pair_init(int64 rid1, int64 rid2, RoutePair *pair)
+{
+  RouteGraph *g = route_graph_get();
+  if (! g)
+    return false;
+  int r1 = route_graph_find(g, rid1);
+  int r2 = route_graph_find(g, rid2);
+  if (r1 < 0 || r2 < 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "There is no route %ld in the route network", r1 < 0 ? rid1 : rid2);
+    return false;
+  }
+  pair->length1 = g->lengths[r1];
+  pair->length2 = g->lengths[r2];
+  pair->same = (r1 == r2);
+  int targets[2] = { g->source[r2], g->target[r2] };
+  route_alt_search(g, g->source[r1], targets, &pair->dist[0]);
+  if (g->target[r1] == g->source[r1])
+  {
+    pair->dist[2] = pair->dist[0];
+    pair->dist[3] = pair->dist[1];
+  }
+  else
+    route_alt_search(g, g->target[r1], targets, &pair->dist[2]);
+  return true;
+}
+
+/**
+ * @brief Return true if two network points located on the routes of a pair
+ * are connected
+ */
+static bool
+route_pair_connected(const RoutePair *pair)
+{
+  return pair->same || pair->dist[0] < DBL_MAX || pair->dist[1] < DBL_MAX ||
+    pair->dist[2] < DBL_MAX || pair->dist[3] < DBL_MAX;
+}
+
+/**
+ * @brief Return the network distance between two network points located on
+ * the routes of a pair, DBL_MAX if they are not connected
+ */
+static double
+route_pair_distance(const RoutePair *pair, double pos1, double pos2)
+{
+  double ends1[2] = { pos1 * pair->length1, (1.0 - pos1) * pair->length1 };
+  double ends2[2] = { pos2 * pair->length2, (1.0 - pos2) * pair->length2 };
+  double result = pair->same ? fabs(pos1 - pos2) * pair->length1 : DBL_MAX;
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 2; j++)
+      if (pair->dist[2 * i + j] < DBL_MAX)
+        result = Min(result, ends1[i] + pair->dist[2 * i + j] + ends2[j]);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return the network distance between two network points, that is,
+ * the length of the shortest path between them along the routes
+ * @param[in] np1,np2 Network points
+ * @return On error or if the network points are not connected return -1
+ */
+double
+npoint_network_distance(const Npoint *np1, const Npoint *np2)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) np1) || ! ensure_not_null((void *) np2))
+    return -1.0;
+  RoutePair pair;
+  if (! route_pair_init(np1->rid, np2->rid, &pair))
+    return -1.0;
+  double result = route_pair_distance(&pair, np1->pos, np2->pos);
+  return result < DBL_MAX ? result : -1.0;
+}
+
+/*****************************************************************************
+ * Temporal network distance
+ *****************************************************************************/
+
+/**
+ * @brief Number of linear functions of a segment whose lower envelope gives
+ * the network distance, that is, the four paths through the end points of the
+ * routes and the two branches of the distance along a single route
+ */
+#define ROUTE_PAIR_LINES 6
+
+/**
+ * @brief Return the network distance between two network points moving
+ * linearly on the routes of a pair during a segment as a piecewise linear
+ * function given by the fractions of the segment where it changes of slope
+ * @param[in] pair Route pair
+ * @param[in] p1,e1 Positions of the first point at the start and the end of
+ * the segment
+ * @param[in] p2,e2 Positions of the second point at the start and the end of
+ * the segment
+ * @param[out] fractions Fractions in [0, 1] in ascending order, starting
+ * with 0 and ending with 1
+ * @param[out] values Network distance at each fraction
+ * @result Number of fractions
+ */
+static int
+route_pair_segment(const RoutePair *pair, double p1, double e1, double p2,
+  double e2, double *fractions, double *values)
+{
+  /* Each line is value = c0 + c1 * fraction */
+  double c0[ROUTE_PAIR_LINES], c1[ROUTE_PAIR_LINES];
+  int nlines = 0;
+  double l1 = pair->length1, l2 = pair->length2;
+  double s1[2] = { l1 * p1, l1 * (1.0 - p1) }, d1[2] = { l1 * (e1 - p1),
+    - l1 * (e1 - p1) };
+  double s2[2] = { l2 * p2, l2 * (1.0 - p2) }, d2[2] = { l2 * (e2 - p2),
+    - l2 * (e2 - p2) };
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 2; j++)
+      if (pair->dist[2 * i + j] < DBL_MAX)
+      {
+        c0[nlines] = s1[i] + pair->dist[2 * i + j] + s2[j];
+        c1[nlines++] = d1[i] + d2[j];
+      }
+  if (pair->same)
+  {
+    c0[nlines] = l1 * (p1 - p2);
+    c1[nlines] = l1 * ((e1 - p1) - (e2 - p2));
+    c0[nlines + 1] = - c0[nlines];
+    c1[nlines + 1] = - c1[nlines];
+    nlines += 2;
+  }
+
+  /* The envelope changes of slope only where two lines intersect */
+  int count = 0;
+  fractions[count++] = 0.0;
+  for (int i = 0; i < nlines; i++)
+    for (int j = i + 1; j < nlines; j++)
+    {
+      if (c1[i] == c1[j])
+        continue;
+      double u = (c0[j] - c0[i]) / (c1[i] - c1[j]);
+      if (u > 0.0 && u < 1.0)
+        fractions[count++] = u;
+    }
+  fractions[count++] = 1.0;
+  /* Insertion sort of the few fractions */
+  for (int i = 1; i < count; i++)
+  {
+    double u = fractions[i];
+    int j = i - 1;
+    for (; j >= 0 && fractions[j] > u; j--)
+      fractions[j + 1] = fractions[j];
+    fractions[j + 1] = u;
+  }
+  int k = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (k > 0 && fractions[i] == fractions[k - 1])
+      continue;
+    fractions[k] = fractions[i];
+    /* The end positions are used as such to avoid rounding errors */
+    double u = fractions[i];
+    values[k++] = (u == 1.0) ? route_pair_distance(pair, e1, e2) :
+      route_pair_distance(pair, p1 + (e1 - p1) * u, p2 + (e2 - p2) * u);
+  }
+  return k;
+}
+
+/**
+ * @brief Return the temporal network distance between two synchronized
+ * temporal network point sequences with continuous interpolation
+ * @return Return @p NULL if the sequences are not connected
+ */
+static Temporal *
+ndistance_tnpointseq_tnpointseq_cont(const TSequence *seq1,
+  const TSequence *seq2, const RoutePair *pair)
+{
+  bool linear1 = MEOS_FLAGS_LINEAR_INTERP(seq1->flags);
+  bool linear2 = MEOS_FLAGS_LINEAR_INTERP(seq2->flags);
+  int count = seq1->count;
+  double *pos1 = palloc(sizeof(double) * count);
+  double *pos2 = palloc(sizeof(double) * count);
+  for (int i = 0; i < count; i++)
+  {
+    pos1[i] = DatumGetNpointP(tinstant_val(TSEQUENCE_INST_N(seq1, i)))->pos;
+    pos2[i] = DatumGetNpointP(tinstant_val(TSEQUENCE_INST_N(seq2, i)))->pos;
+  }
+
+  /* With step interpolation the distance is constant between the instants */
+  if (! linear1 && ! linear2)
+  {
+    TInstant **instants = palloc(sizeof(TInstant *) * count);
+    for (int i = 0; i < count; i++)
+      instants[i] = tinstant_make(Float8GetDatum(route_pair_distance(pair,
+        pos1[i], pos2[i])), T_TFLOAT, TSEQUENCE_INST_N(seq1, i)->t);
+    pfree(pos1); pfree(pos2);
+    return (Temporal *) tsequence_make_free(instants, count,
+      seq1->period.lower_inc, seq1->period.upper_inc, STEP, NORMALIZE);
+  }
+
+  /* Otherwise the distance is piecewise linear, with jumps at the instants
+   * where an operand with step interpolation changes of value */
+  double fractions[ROUTE_PAIR_LINES * ROUTE_PAIR_LINES];
+  double values[ROUTE_PAIR_LINES * ROUTE_PAIR_LINES];
+  TSequence **sequences = palloc(sizeof(TSequence *) * count);
+  int nseqs = 0;
+  TInstant **instants = palloc(sizeof(TInstant *) *
+    (count * ROUTE_PAIR_LINES * ROUTE_PAIR_LINES + 1));
+  int ninsts = 0;
+  bool lower_inc = seq1->period.lower_inc;
+  double left = 0.0; /* make compiler quiet */
+  for (int i = 0; i < count - 1; i++)
+  {
+    TimestampTz t1 = TSEQUENCE_INST_N(seq1, i)->t;
+    TimestampTz t2 = TSEQUENCE_INST_N(seq1, i + 1)->t;
+    double e1 = linear1 ? pos1[i + 1] : pos1[i];
+    double e2 = linear2 ? pos2[i + 1] : pos2[i];
+    int n = route_pair_segment(pair, pos1[i], e1, pos2[i], e2, fractions,
+      values);
+    if (ninsts > 0 && values[0] != left)
+    {
+      /* Close the current sequence with an exclusive upper bound */
+      instants[ninsts++] = tinstant_make(Float8GetDatum(left), T_TFLOAT, t1);
+      sequences[nseqs++] = tsequence_make_free(instants, ninsts, lower_inc,
+        false, LINEAR, NORMALIZE);
+      instants = palloc(sizeof(TInstant *) *
+        (count * ROUTE_PAIR_LINES * ROUTE_PAIR_LINES + 1));
+      ninsts = 0;
+      lower_inc = true;
+    }
+    for (int j = 0; j < n - 1; j++)
+    {
+      TimestampTz t = t1 + (TimestampTz) ((double) (t2 - t1) * fractions[j]);
+      if (ninsts > 0 && t <= instants[ninsts - 1]->t)
+        continue;
+      instants[ninsts++] = tinstant_make(Float8GetDatum(values[j]), T_TFLOAT,
+        t);
+    }
+    left = values[n - 1];
+  }
+  const TInstant *last = TSEQUENCE_INST_N(seq1, count - 1);
+  double value = route_pair_distance(pair, pos1[count - 1], pos2[count - 1]);
+  pfree(pos1); pfree(pos2);
+  if (count == 1 || value == left)
+  {
+    instants[ninsts++] = tinstant_make(Float8GetDatum(value), T_TFLOAT,
+      last->t);
+    sequences[nseqs++] = tsequence_make_free(instants, ninsts, lower_inc,
+      seq1->period.upper_inc, LINEAR, NORMALIZE);
+  }
+  else
+  {
+    instants[ninsts++] = tinstant_make(Float8GetDatum(left), T_TFLOAT,
+      last->t);
+    sequences[nseqs++] = tsequence_make_free(instants, ninsts, lower_inc,
+      false, LINEAR, NORMALIZE);
+    if (seq1->period.upper_inc)
+    {
+      TInstant *inst = tinstant_make(Float8GetDatum(value), T_TFLOAT,
+        last->t);
+      sequences[nseqs++] = tinstant_to_tsequence_free(inst, LINEAR);
+    }
+  }
+  if (nseqs == 1)
+  {
+    Temporal *result = (Temporal *) sequences[0];
+    pfree(sequences);
+    return result;
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, nseqs, NORMALIZE);
+}
+
+/**
+ * @brief Return the temporal network distance between two synchronized
+ * temporal network point sequences
+ * @return On error or if the sequences are never connected return @p NULL
+ */
+static Temporal *
+ndistance_tnpointseq_tnpointseq(const TSequence *seq1, const TSequence *seq2)
+{
+  RoutePair pair;
+  if (MEOS_FLAGS_DISCRETE_INTERP(seq1->flags))
+  {
+    /* The instants of a discrete sequence may be on different routes */
+    TInstant **instants = palloc(sizeof(TInstant *) * seq1->count);
+    int ninsts = 0;
+    for (int i = 0; i < seq1->count; i++)
+    {
+      const TInstant *inst1 = TSEQUENCE_INST_N(seq1, i);
+      const Npoint *np1 = DatumGetNpointP(tinstant_val(inst1));
+      const Npoint *np2 = DatumGetNpointP(tinstant_val(
+        TSEQUENCE_INST_N(seq2, i)));
+      if (! route_pair_init(np1->rid, np2->rid, &pair))
+      {
+        pfree_array((void **) instants, ninsts);
+        return NULL;
+      }
+      double value = route_pair_distance(&pair, np1->pos, np2->pos);
+      if (value < DBL_MAX)
+        instants[ninsts++] = tinstant_make(Float8GetDatum(value), T_TFLOAT,
+          inst1->t);
+    }
+    if (ninsts == 0)
+    {
+      pfree(instants);
+      return NULL;
+    }
+    return (Temporal *) tsequence_make_free(instants, ninsts, true, true,
+      DISCRETE, NORMALIZE_NO);
+  }
+
+  /* The instants of a continuous sequence are on a single route */
+  if (! route_pair_init(tnpoint_route((Temporal *) seq1),
+      tnpoint_route((Temporal *) seq2), &pair) ||
+      ! route_pair_connected(&pair))
+    return NULL;
+  return ndistance_tnpointseq_tnpointseq_cont(seq1, seq2, &pair);
+}
+
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return the temporal network distance between two temporal network
+ * points, that is, the length of the shortest path between them along the
+ * routes at each instant
+ * @details The positions of the points move linearly along their routes, so
+ * that the network distance during a segment is the lower envelope of the
+ * lengths of the paths through the end points of the routes and of the
+ * distance along the route when both points are on the same route, which are
+ * linear functions of time
+ * @param[in] temp1,temp2 Temporal network points
+ * @return On error or if the temporal network points are never connected
+ * return @p NULL
+ */
+Temporal *
+ndistance_tnpoint_tnpoint(const Temporal *temp1, const Temporal *temp2)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp1) || ! ensure_not_null((void *) temp2) ||
+      ! ensure_same_temporal_type(temp1, temp2))
+    return NULL;
+
+  Temporal *sync1, *sync2;
+  /* Return NULL if the temporal network points do not intersect in time */
+  if (! intersection_temporal_temporal(temp1, temp2, SYNCHRONIZE_NOCROSS,
+      &sync1, &sync2))
+    return NULL;
+
+  Temporal *result = NULL;
+  assert(temptype_subtype(sync1->subtype));
+  switch (sync1->subtype)
+  {
+    case TINSTANT:
+    {
+      const TInstant *inst1 = (const TInstant *) sync1;
+      double value = npoint_network_distance(
+        DatumGetNpointP(tinstant_val(inst1)),
+        DatumGetNpointP(tinstant_val((const TInstant *) sync2)));
+      if (value >= 0.0)
+        result = (Temporal *) tinstant_make(Float8GetDatum(value), T_TFLOAT,
+          inst1->t);
+      break;
+    }
+    case TSEQUENCE:
+      result = ndistance_tnpointseq_tnpointseq((const TSequence *) sync1,
+        (const TSequence *) sync2);
+      break;
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss1 = (const TSequenceSet *) sync1;
+      const TSequenceSet *ss2 = (const TSequenceSet *) sync2;
+      Temporal **pieces = palloc(sizeof(Temporal *) * ss1->count);
+      int npieces = 0, nseqs = 0;
+      for (int i = 0; i < ss1->count; i++)
+      {
+        Temporal *piece = ndistance_tnpointseq_tnpointseq(
+          TSEQUENCESET_SEQ_N(ss1, i), TSEQUENCESET_SEQ_N(ss2, i));
+        if (! piece)
+          continue;
+        pieces[npieces++] = piece;
+        nseqs += (piece->subtype == TSEQUENCE) ? 1 :
+          ((TSequenceSet *) piece)->count;
+      }
+      if (npieces > 0)
+      {
+        TSequence **sequences = palloc(sizeof(TSequence *) * nseqs);
+        int k = 0;
+        for (int i = 0; i < npieces; i++)
+        {
+          if (pieces[i]->subtype == TSEQUENCE)
+            sequences[k++] = (TSequence *) pieces[i];
+          else
+          {
+            const TSequenceSet *ss = (const TSequenceSet *) pieces[i];
+            for (int j = 0; j < ss->count; j++)
+              sequences[k++] = tsequence_copy(TSEQUENCESET_SEQ_N(ss, j));
+            pfree(pieces[i]);
+          }
+        }
+        result = (Temporal *) tsequenceset_make_free(sequences, nseqs,
+          NORMALIZE);
+      }
+      pfree(pieces);
+    }
+  }
+  pfree(sync1); pfree(sync2);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return the temporal network distance between a temporal network
+ * point and a network point
+ * @param[in] temp Temporal network point
+ * @param[in] np Network point
+ * @return On error or if the values are never connected return @p NULL
+ */
+Temporal *
+ndistance_tnpoint_npoint(const Temporal *temp, const Npoint *np)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) np))
+    return NULL;
+  Temporal *temp1 = temporal_from_base_temp(PointerGetDatum(np), T_TNPOINT,
+    temp);
+  Temporal *result = ndistance_tnpoint_tnpoint(temp, temp1);
+  pfree(temp1);
+  return result;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,778 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Route network of network points in MEOS.
+ *
+ * In the MobilityDB extension the routes of network points are read from the
+ * ways table. Since MEOS has no database connection, an application either
+ * loads the routes into an in-memory route table, e.g., from WKB or from a
+ * CSV file, or registers a route provider, that is, a function returning the
+ * geometry and the length of a route from its identifier.
+ *
+ * The route table is a flat array of entries sorted by route identifier and
+ * searched by binary search. The route geometries are stored contiguously in
+ * a single buffer addressed by the offsets kept in the entries.
+ */
+
+#include "npoint/tnpoint_static.h"
+
+/* C */
+#include <assert.h>
+#include <ctype.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* PostgreSQL */
+#include <postgres.h>
+/* PostGIS */
+#include <liblwgeom.h>
+#include <liblwgeom_internal.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include <meos_npoint.h>
+#include "general/meos_probes.h"
+#include "general/temporal.h"
+#include "general/type_util.h"
+#include "point/pgis_types.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/** Initial number of entries of the route table */
+#define ROUTE_TABLE_INITIAL_COUNT 64
+/** Initial size in bytes of the geometry buffer of the route table */
+#define ROUTE_TABLE_INITIAL_SIZE 65536
+/** Initial size in bytes of the line buffer when reading a CSV file */
+#define ROUTE_CSV_LINE_SIZE 4096
+
+/*****************************************************************************
+ * Route table and route provider
+ *****************************************************************************/
+
+/**
+ * @brief Structure to represent a route of the route table
+ */
+typedef struct
+{
+  int64 rid;           /**< Route identifier */
+  double length;       /**< Route length */
+  size_t offset;       /**< Offset of the geometry in the geometry buffer */
+  STBox box;           /**< Bounding box of the route geometry */
+} RouteEntry;
+
+/**
+ * @brief Global variable keeping the in-memory route table
+ */
+static struct
+{
+  RouteEntry *entries;  /**< Array of routes */
+  int count;            /**< Number of routes */
+  int maxcount;         /**< Allocated number of routes */
+  bool sorted;          /**< True when the routes are sorted by identifier */
+  char *geoms;          /**< Buffer keeping the route geometries */
+  size_t size;          /**< Used size of the geometry buffer */
+  size_t maxsize;       /**< Allocated size of the geometry buffer */
+  int32_t srid;         /**< SRID of the routes */
+} ROUTE_TABLE = { NULL, 0, 0, true, NULL, 0, 0, SRID_UNKNOWN };
+
+/**
+ * @brief Global variable keeping the route provider, if any
+ */
+static struct
+{
+  route_provider_fn provider;  /**< Function returning a route */
+  void *extra;                 /**< Extra argument passed to the function */
+} ROUTE_PROVIDER = { NULL, NULL };
+
+/**
+ * @brief Set the function used to obtain the routes of network points
+ *
+ * When a route provider is set, it is used instead of the route table.
+ * Setting the provider to @p NULL restores the use of the route table.
+ * @param[in] provider Function returning the geometry and the length of a
+ * route from its identifier
+ * @param[in] extra Extra argument passed to each call of the function
+ */
+void
+meos_set_route_provider(route_provider_fn provider, void *extra)
+{
+  route_graph_reset();
+  route_index_reset();
+  ROUTE_PROVIDER.provider = provider;
+  ROUTE_PROVIDER.extra = provider ? extra : NULL;
+  return;
+}
+
+/**
+ * @brief Remove all the routes from the route table
+ */
+void
+meos_route_clear(void)
+{
+  route_graph_reset();
+  route_index_reset();
+  if (ROUTE_TABLE.entries)
+    pfree(ROUTE_TABLE.entries);
+  if (ROUTE_TABLE.geoms)
+    pfree(ROUTE_TABLE.geoms);
+  ROUTE_TABLE.entries = NULL;
+  ROUTE_TABLE.geoms = NULL;
+  ROUTE_TABLE.count = ROUTE_TABLE.maxcount = 0;
+  ROUTE_TABLE.size = ROUTE_TABLE.maxsize = 0;
+  ROUTE_TABLE.sorted = true;
+  ROUTE_TABLE.srid = SRID_UNKNOWN;
+  return;
+}
+
+/**
+ * @brief Add a route to the route table
+ *
+ * A route with the identifier of a route already in the table replaces it.
+ * @param[in] rid Route identifier
+ * @param[in] gs Route geometry, which must be a line
+ * @param[in] length Route length, computed from the geometry if negative
+ * @return On error return false
+ */
+bool
+meos_route_add(int64 rid, const GSERIALIZED *gs, double length)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) gs) || ! ensure_not_empty(gs))
+    return false;
+  if (gserialized_get_type(gs) != LINETYPE)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The geometry of route %ld must be a line", rid);
+    return false;
+  }
+  int32_t srid = gserialized_get_srid(gs);
+  if (ROUTE_TABLE.count > 0 && ! ensure_same_srid(ROUTE_TABLE.srid, srid))
+    return false;
+
+  if (length < 0)
+  {
+    LWGEOM *geom = lwgeom_from_gserialized(gs);
+    length = lwgeom_length_2d(geom);
+    lwgeom_free(geom);
+  }
+
+  /* Enlarge the arrays if needed */
+  if (ROUTE_TABLE.count == ROUTE_TABLE.maxcount)
+  {
+    ROUTE_TABLE.maxcount = ROUTE_TABLE.maxcount ?
+      ROUTE_TABLE.maxcount * 2 : ROUTE_TABLE_INITIAL_COUNT;
+    ROUTE_TABLE.entries = repalloc(ROUTE_TABLE.entries,
+      sizeof(RouteEntry) * ROUTE_TABLE.maxcount);
+  }
+  /* The geometries are aligned to double since they are read in place */
+  size_t size = DOUBLEALIGN(VARSIZE(gs));
+  if (ROUTE_TABLE.size + size > ROUTE_TABLE.maxsize)
+  {
+    size_t maxsize = ROUTE_TABLE.maxsize ?
+      ROUTE_TABLE.maxsize : ROUTE_TABLE_INITIAL_SIZE;
+    while (ROUTE_TABLE.size + size > maxsize)
+      maxsize *= 2;
+    ROUTE_TABLE.geoms = repalloc(ROUTE_TABLE.geoms, maxsize);
+    ROUTE_TABLE.maxsize = maxsize;
+  }
+
+  /* The graph of the route network is rebuilt with the new route */
+  route_graph_reset();
+  route_index_reset();
+  RouteEntry *entry = &ROUTE_TABLE.entries[ROUTE_TABLE.count];
+  entry->rid = rid;
+  entry->length = length;
+  entry->offset = ROUTE_TABLE.size;
+  memcpy(ROUTE_TABLE.geoms + ROUTE_TABLE.size, gs, VARSIZE(gs));
+  geo_set_stbox(gs, &entry->box);
+  ROUTE_TABLE.size += size;
+  /* Appending the routes in ascending order keeps the table sorted */
+  if (ROUTE_TABLE.count > 0 && entry[-1].rid >= rid)
+    ROUTE_TABLE.sorted = false;
+  ROUTE_TABLE.count++;
+  ROUTE_TABLE.srid = srid;
+  return true;
+}
+
+/**
+ * @brief Add a route given in (extended) Well-Known Binary representation to
+ * the route table
+ * @param[in] rid Route identifier
+ * @param[in] wkb WKB of the route geometry, which must be a line
+ * @param[in] size Size of the WKB
+ * @param[in] length Route length, computed from the geometry if negative
+ * @return On error return false
+ */
+bool
+meos_route_add_wkb(int64 rid, const uint8_t *wkb, size_t size, double length)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) wkb))
+    return false;
+  LWGEOM *geom = lwgeom_from_wkb(wkb, size, LW_PARSER_CHECK_ALL);
+  if (! geom)
+  {
+    meos_error(ERROR, MEOS_ERR_WKB_INPUT,
+      "Cannot parse the geometry of route %ld", rid);
+    return false;
+  }
+  GSERIALIZED *gs = geo_serialize(geom);
+  lwgeom_free(geom);
+  bool result = meos_route_add(rid, gs, length);
+  pfree(gs);
+  return result;
+}
+
+/**
+ * @brief Read a line of arbitrary length from a file into a buffer that is
+ * enlarged as needed
+ * @return Return @p NULL at the end of the file
+ */
+static char *
+csv_read_line(FILE *file, char **buf, size_t *size)
+{
+  size_t len = 0;
+  while (fgets(*buf + len, (int) (*size - len), file))
+  {
+    len += strlen(*buf + len);
+    /* Return if the line is complete or if the end of file was reached */
+    if ((*buf)[len - 1] == '\n' || len + 1 < *size)
+      return *buf;
+    *size *= 2;
+    *buf = repalloc(*buf, *size);
+  }
+  return len > 0 ? *buf : NULL;
+}
+
+/**
+ * @brief Parse a line of a CSV file of routes and add the route to the route
+ * table
+ * @return On error return false
+ */
+static bool
+csv_route_add(char *line)
+{
+  char *ptr = line;
+  char *end;
+  int64 rid = strtoll(ptr, &end, 10);
+  if (end == ptr || *end != ',')
+    return false;
+  ptr = end + 1;
+
+  /* The geometry may be quoted, e.g., when it is given in WKT */
+  char *geomstr = ptr;
+  if (*ptr == '"')
+  {
+    geomstr = ++ptr;
+    while (*ptr && *ptr != '"')
+      ptr++;
+    if (*ptr != '"')
+      return false;
+    *ptr++ = '\0';
+  }
+  else
+  {
+    while (*ptr && *ptr != ',' && *ptr != '\r' && *ptr != '\n')
+      ptr++;
+  }
+  double length = -1.0;
+  if (*ptr == ',')
+  {
+    *ptr++ = '\0';
+    if (*ptr && *ptr != '\r' && *ptr != '\n')
+    {
+      length = strtod(ptr, &end);
+      if (end == ptr)
+        return false;
+    }
+  }
+  else
+    *ptr = '\0';
+
+  GSERIALIZED *gs = pgis_geometry_in(geomstr, -1);
+  if (! gs)
+    return false;
+  bool result = meos_route_add(rid, gs, length);
+  pfree(gs);
+  return result;
+}
+
+/**
+ * @brief Load the routes of a CSV file into the route table
+ *
+ * Each line of the file contains the route identifier, the route geometry in
+ * HexEWKB or in (quoted) WKT, and optionally the route length, as obtained,
+ * e.g., with the following command
+ * @code
+ * \copy (SELECT gid, the_geom, length FROM ways) TO 'ways.csv' CSV
+ * @endcode
+ * An optional header line is skipped. The routes read before an erroneous
+ * line are kept in the route table.
+ * @param[in] filename Name of the file
+ * @return Number of routes read. On error return -1
+ */
+int
+meos_route_load_csv(const char *filename)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) filename))
+    return -1;
+  FILE *file = fopen(filename, "r");
+  if (! file)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot open the file of routes %s", filename);
+    return -1;
+  }
+
+  size_t size = ROUTE_CSV_LINE_SIZE;
+  char *buf = palloc(size);
+  int nlines = 0, result = 0;
+  char *line;
+  while ((line = csv_read_line(file, &buf, &size)) != NULL)
+  {
+    nlines++;
+    /* Skip empty lines and the header line */
+    if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0' ||
+        (nlines == 1 && ! isdigit((unsigned char) line[0]) && line[0] != '-'))
+      continue;
+    if (! csv_route_add(line))
+    {
+      meos_error(ERROR, MEOS_ERR_TEXT_INPUT,
+        "Invalid route in line %d of the file %s", nlines, filename);
+      result = -1;
+      break;
+    }
+    result++;
+  }
+  pfree(buf);
+  fclose(file);
+  return result;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Comparator function for the routes of the route table
+ * @note The routes added later are sorted after those with the same
+ * identifier added earlier
+ */
+static int
+route_entry_cmp(const RouteEntry *l, const RouteEntry *r)
+{
+  if (l->rid != r->rid)
+    return (l->rid < r->rid) ? -1 : 1;
+  return (l->offset < r->offset) ? -1 : ((l->offset > r->offset) ? 1 : 0);
+}
+
+/**
+ * @brief Sort the route table, keeping only the last route added for each
+ * route identifier
+ */
+static void
+route_table_sort(void)
+{
+  qsort(ROUTE_TABLE.entries, (size_t) ROUTE_TABLE.count, sizeof(RouteEntry),
+    (qsort_comparator) &route_entry_cmp);
+  int count = 0;
+  for (int i = 0; i < ROUTE_TABLE.count; i++)
+  {
+    if (i + 1 < ROUTE_TABLE.count &&
+        ROUTE_TABLE.entries[i].rid == ROUTE_TABLE.entries[i + 1].rid)
+      continue;
+    ROUTE_TABLE.entries[count++] = ROUTE_TABLE.entries[i];
+  }
+  ROUTE_TABLE.count = count;
+  ROUTE_TABLE.sorted = true;
+  return;
+}
+
+/**
+ * @brief Return the route of the route table with a route identifier
+ * @return Return @p NULL if the route table does not contain the route
+ */
+static const RouteEntry *
+route_table_find(int64 rid)
+{
+  if (! ROUTE_TABLE.sorted)
+    route_table_sort();
+  int first = 0, last = ROUTE_TABLE.count - 1;
+  while (first <= last)
+  {
+    int middle = (first + last) / 2;
+    const RouteEntry *entry = &ROUTE_TABLE.entries[middle];
+    if (entry->rid == rid)
+      return entry;
+    if (entry->rid < rid)
+      first = middle + 1;
+    else
+      last = middle - 1;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Return the number of routes in the route table
+ */
+int
+meos_route_count(void)
+{
+  /* Make sure that the replaced routes are not counted */
+  if (! ROUTE_TABLE.sorted)
+    route_table_sort();
+  return ROUTE_TABLE.count;
+}
+
+/**
+ * @brief Return the geometry of a route of the route table
+ */
+static inline const GSERIALIZED *
+route_entry_geom(const RouteEntry *entry)
+{
+  return (const GSERIALIZED *) (ROUTE_TABLE.geoms + entry->offset);
+}
+
+/**
+ * @brief Return the geometry and the length of a route from the route
+ * provider, if any, or from the route table
+ * @param[in] rid Route identifier
+ * @param[out] length Route length
+ * @return Return @p NULL if the route does not exist
+ */
+static const GSERIALIZED *
+route_lookup(int64 rid, double *length)
+{
+  if (ROUTE_PROVIDER.provider)
+  {
+    double len = -1.0;
+    const GSERIALIZED *gs = ROUTE_PROVIDER.provider(rid, &len,
+      ROUTE_PROVIDER.extra);
+    if (gs && len < 0)
+    {
+      LWGEOM *geom = lwgeom_from_gserialized(gs);
+      len = lwgeom_length_2d(geom);
+      lwgeom_free(geom);
+    }
+    *length = len;
+    return gs;
+  }
+  const RouteEntry *entry = route_table_find(rid);
+  if (! entry)
+    return NULL;
+  *length = entry->length;
+  return route_entry_geom(entry);
+}
+
+/*****************************************************************************
+ * Functions used by network points
+ *****************************************************************************/
+
+/**
+ * @brief Return the SRID of the routes in the route table
+ * @return On error return SRID_INVALID
+ */
+int32_t
+get_srid_ways()
+{
+  if (ROUTE_PROVIDER.provider || ROUTE_TABLE.count == 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "Cannot determine SRID of the route table");
+    return SRID_INVALID;
+  }
+  return ROUTE_TABLE.srid;
+}
+
+/**
+ * @brief Return true if the route network contains a route with the route
+ * identifier
+ */
+bool
+route_exists(int64 rid)
+{
+  double length;
+  return route_lookup(rid, &length) != NULL;
+}
+
+/**
+ * @brief Return the route length from the corresponding route identifier
+ * @brief On error return -1
+ */
+double
+route_length(int64 rid)
+{
+  double length;
+  if (! route_lookup(rid, &length))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Cannot get the length for route %ld", rid);
+    return -1.0;
+  }
+  return length;
+}
+
+/**
+ * @brief Return a copy of the route geometry from the corresponding route
+ * identifier
+ * @return On error return @p NULL
+ */
+GSERIALIZED *
+route_geom(int64 rid)
+{
+  MEOS_PROBE_ROUTE_GEOM(rid);
+  double length;
+  const GSERIALIZED *gs = route_lookup(rid, &length);
+  if (! gs)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Cannot get the geometry for route %ld", rid);
+    return NULL;
+  }
+  GSERIALIZED *result = palloc(VARSIZE(gs));
+  memcpy(result, gs, VARSIZE(gs));
+  return result;
+}
+
+/**
+ * @brief Return in the last arguments the end points and the length of all
+ * the routes of the route table, which are used to build the graph of the
+ * route network
+ * @param[out] rids Route identifiers
+ * @param[out] ends Coordinates X1, Y1, X2, Y2 of the start and end points of
+ * each route
+ * @param[out] lengths Route lengths
+ * @param[out] count Number of routes
+ * @return On error return false
+ * @note The routes of a route provider cannot be enumerated, so that they must
+ * be added to the route table to compute network distances
+ */
+bool
+route_network_read(int64 **rids, double **ends, double **lengths, int *count)
+{
+  if (! ROUTE_TABLE.sorted)
+    route_table_sort();
+  if (ROUTE_TABLE.count == 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The route table must contain the routes of the network");
+    return false;
+  }
+  *rids = palloc(sizeof(int64) * ROUTE_TABLE.count);
+  *ends = palloc(sizeof(double) * ROUTE_TABLE.count * 4);
+  *lengths = palloc(sizeof(double) * ROUTE_TABLE.count);
+  for (int i = 0; i < ROUTE_TABLE.count; i++)
+  {
+    const RouteEntry *entry = &ROUTE_TABLE.entries[i];
+    LWLINE *line = lwgeom_as_lwline(lwgeom_from_gserialized(
+      route_entry_geom(entry)));
+    POINT2D start, end;
+    getPoint2d_p(line->points, 0, &start);
+    getPoint2d_p(line->points, line->points->npoints - 1, &end);
+    lwline_free(line);
+    (*rids)[i] = entry->rid;
+    (*ends)[4 * i] = start.x;
+    (*ends)[4 * i + 1] = start.y;
+    (*ends)[4 * i + 2] = end.x;
+    (*ends)[4 * i + 3] = end.y;
+    (*lengths)[i] = entry->length;
+  }
+  *count = ROUTE_TABLE.count;
+  return true;
+}
+
+/**
+ * @brief Return in the last arguments a copy of the identifiers and the
+ * geometries of all the routes of the route table, which are used to build
+ * the index of the route geometries
+ * @param[out] rids Route identifiers
+ * @param[out] geoms Route geometries
+ * @param[out] count Number of routes
+ * @return On error return false
+ * @note The routes of a route provider cannot be enumerated, so that they must
+ * be added to the route table to transform geometries into network points
+ */
+bool
+route_geoms_read(int64 **rids, GSERIALIZED ***geoms, int *count)
+{
+  if (! ROUTE_TABLE.sorted)
+    route_table_sort();
+  if (ROUTE_TABLE.count == 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The route table must contain the routes of the network");
+    return false;
+  }
+  *rids = palloc(sizeof(int64) * ROUTE_TABLE.count);
+  *geoms = palloc(sizeof(GSERIALIZED *) * ROUTE_TABLE.count);
+  for (int i = 0; i < ROUTE_TABLE.count; i++)
+  {
+    const RouteEntry *entry = &ROUTE_TABLE.entries[i];
+    const GSERIALIZED *gs = route_entry_geom(entry);
+    (*rids)[i] = entry->rid;
+    (*geoms)[i] = palloc(VARSIZE(gs));
+    memcpy((*geoms)[i], gs, VARSIZE(gs));
+  }
+  *count = ROUTE_TABLE.count;
+  return true;
+}
+
+/**
+ * @brief Return a copy of the route geometries from an array of route
+ * identifiers
+ * @param[in] rids Array of distinct route identifiers
+ * @param[in] count Number of elements in the array
+ * @return Array of route geometries in the same order as the route
+ * identifiers. On error return @p NULL
+ */
+GSERIALIZED **
+route_geom_batch(const int64 *rids, int count)
+{
+  assert(count > 0);
+  GSERIALIZED **result = palloc(sizeof(GSERIALIZED *) * count);
+  for (int i = 0; i < count; i++)
+  {
+    result[i] = route_geom(rids[i]);
+    if (! result[i])
+    {
+      pfree_array((void **) result, i);
+      return NULL;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Return the last argument initialized with the spatial bounding box
+ * of the route geometry from the corresponding route identifier
+ * @return On error return false
+ */
+bool
+route_set_stbox(int64 rid, STBox *box)
+{
+  if (! ROUTE_PROVIDER.provider)
+  {
+    const RouteEntry *entry = route_table_find(rid);
+    if (entry)
+    {
+      memcpy(box, &entry->box, sizeof(STBox));
+      return true;
+    }
+  }
+  else
+  {
+    double length;
+    const GSERIALIZED *gs = route_lookup(rid, &length);
+    if (gs)
+      return geo_set_stbox(gs, box);
+  }
+  meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+    "Cannot get the geometry for route %ld", rid);
+  return false;
+}
+
+/**
+ * @brief Return the SRID of the route geometry from the corresponding route
+ * identifier
+ * @return On error return SRID_INVALID
+ */
+int32_t
+route_srid(int64 rid)
+{
+  double length;
+  const GSERIALIZED *gs = route_lookup(rid, &length);
+  if (! gs)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Cannot get the geometry for route %ld", rid);
+    return SRID_INVALID;
+  }
+  return gserialized_get_srid(gs);
+}
+
+/**
+ * @brief Transform a geometry into a network point
+ *
+ * The point is projected onto the closest route of the route table that is
+ * within a distance of DIST_EPSILON. The routes are prefiltered with their
+ * bounding box.
+ * @return Return @p NULL if the point is not located on a route
+ */
+Npoint *
+geom_npoint(const GSERIALIZED *gs)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) gs) || ! ensure_not_empty(gs) ||
+      ! ensure_point_type(gs))
+    return NULL;
+  if (ROUTE_PROVIDER.provider)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Cannot transform a geometry into a network point with a route provider");
+    return NULL;
+  }
+  int32_t srid_geom = gserialized_get_srid(gs);
+  int32_t srid_ways = get_srid_ways();
+  if (srid_ways == SRID_INVALID || ! ensure_same_srid(srid_geom, srid_ways))
+    return NULL;
+
+  if (! ROUTE_TABLE.sorted)
+    route_table_sort();
+  const POINT2D *pt = GSERIALIZED_POINT2D_P(gs);
+  POINT4D p, p_proj;
+  p.x = pt->x; p.y = pt->y; p.z = p.m = 0.0;
+  int64 rid = 0;
+  double pos = 0.0, mindist = DBL_MAX;
+  for (int i = 0; i < ROUTE_TABLE.count; i++)
+  {
+    const RouteEntry *entry = &ROUTE_TABLE.entries[i];
+    if (p.x < entry->box.xmin - DIST_EPSILON ||
+        p.x > entry->box.xmax + DIST_EPSILON ||
+        p.y < entry->box.ymin - DIST_EPSILON ||
+        p.y > entry->box.ymax + DIST_EPSILON)
+      continue;
+    LWGEOM *geom = lwgeom_from_gserialized(route_entry_geom(entry));
+    double dist;
+    double fraction = ptarray_locate_point(lwgeom_as_lwline(geom)->points, &p,
+      &dist, &p_proj);
+    lwgeom_free(geom);
+    if (dist <= DIST_EPSILON && dist < mindist)
+    {
+      rid = entry->rid;
+      pos = fraction;
+      mindist = dist;
+    }
+  }
+  if (mindist == DBL_MAX)
+    return NULL;
+  return npoint_make(rid, pos);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,632 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Batched transformation of temporal geometry points into temporal
+ * network points.
+ *
+ * The routes of the network are read once into an index that keeps the
+ * coordinates of the route geometries in a flat array together with an
+ * R-tree of their bounding boxes packed with the Sort-Tile-Recursive (STR)
+ * algorithm. The index is kept until the routes change, that is, in
+ * MobilityDB until the route cache is flushed and in MEOS until the route
+ * table or the route provider is changed.
+ *
+ * A temporal point is snapped instant by instant to the routes located within
+ * a tolerance distance. Among the candidate routes of the successive
+ * instants, the path minimizing the sum of the distances to the routes plus a
+ * penalty for each change of route is chosen with the Viterbi algorithm, so
+ * that a point located at a junction is assigned to the route that is
+ * followed before or after it.
+ */
+
+/* C */
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+/* PostgreSQL */
+#include <postgres.h>
+#if ! MEOS
+  #include <utils/memutils.h>
+#endif /* ! MEOS */
+/* PostGIS */
+#include <liblwgeom.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include <meos_npoint.h>
+#include "general/temporal.h"
+#include "general/type_util.h"
+#include "npoint/tnpoint.h"
+#include "npoint/tnpoint_static.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/** Maximum number of children of a node of the route index */
+#define ROUTE_INDEX_FANOUT 16
+/** Maximum number of candidate routes of an instant */
+#define ROUTE_SNAP_CANDIDATES 8
+
+/**
+ * @brief Structure to represent an entry of the route index, that is, either
+ * a route or a node of the R-tree
+ */
+typedef struct
+{
+  double xmin;           /**< Minimum X value */
+  double ymin;           /**< Minimum Y value */
+  double xmax;           /**< Maximum X value */
+  double ymax;           /**< Maximum Y value */
+  int first;             /**< Route or first child of the node */
+  int count;             /**< Number of children of the node */
+} RouteIndexNode;
+
+/**
+ * @brief Structure to represent the index of the route geometries
+ */
+typedef struct
+{
+  int nroutes;           /**< Number of routes */
+  int64 *rids;           /**< Route identifiers */
+  int *starts;           /**< Offsets of the points of each route, nroutes + 1 */
+  POINT2D *points;       /**< Points of all the routes */
+  RouteIndexNode *entries; /**< Routes in STR order */
+  int nnodes;            /**< Number of nodes of the R-tree */
+  int nleaves;           /**< Number of leaves, which come first */
+  RouteIndexNode *nodes; /**< Nodes of the R-tree, the root is the last one */
+} RouteIndex;
+
+/**
+ * @brief Structure to represent a candidate route of an instant
+ */
+typedef struct
+{
+  int64 rid;             /**< Route identifier */
+  double pos;            /**< Position of the projected point */
+  double dist;           /**< Distance to the route */
+} RouteCandidate;
+
+/**
+ * @brief Global variable keeping the index of the route geometries
+ */
+static RouteIndex *ROUTE_INDEX = NULL;
+
+#if ! MEOS
+/**
+ * @brief Memory context of the index of the route geometries
+ */
+static MemoryContext ROUTE_INDEX_CXT = NULL;
+#endif /* ! MEOS */
+
+/*****************************************************************************
+ * Index construction
+ *****************************************************************************/
+
+/**
+ * @brief Allocate memory for the index of the route geometries
+ */
+static void *
+route_index_alloc(size_t size)
+{
+#if ! MEOS
+  return MemoryContextAlloc(ROUTE_INDEX_CXT, size);
+#else
+  return palloc(size);
+#endif /* ! MEOS */
+}
+
+/**
+ * @brief Free the index of the route geometries, which is built again by the
+ * next transformation into temporal network points
+ */
+void
+route_index_reset(void)
+{
+#if ! MEOS
+  if (ROUTE_INDEX_CXT)
+    MemoryContextDelete(ROUTE_INDEX_CXT);
+  ROUTE_INDEX_CXT = NULL;
+#else
+  if (ROUTE_INDEX)
+  {
+    RouteIndex *idx = ROUTE_INDEX;
+    pfree(idx->rids); pfree(idx->starts); pfree(idx->points);
+    pfree(idx->entries); pfree(idx->nodes); pfree(idx);
+  }
+#endif /* ! MEOS */
+  ROUTE_INDEX = NULL;
+  return;
+}
+
+/**
+ * @brief Comparator of index entries on the center of their X extent
+ */
+static int
+route_node_xcmp(const RouteIndexNode *l, const RouteIndexNode *r)
+{
+  double x1 = l->xmin + l->xmax, x2 = r->xmin + r->xmax;
+  return (x1 < x2) ? -1 : ((x1 > x2) ? 1 : 0);
+}
+
+/**
+ * @brief Comparator of index entries on the center of their Y extent
+ */
+static int
+route_node_ycmp(const RouteIndexNode *l, const RouteIndexNode *r)
+{
+  double y1 = l->ymin + l->ymax, y2 = r->ymin + r->ymax;
+  return (y1 < y2) ? -1 : ((y1 > y2) ? 1 : 0);
+}
+
+/**
+ * @brief Sort index entries in STR order, that is, in vertical slices sorted
+ * by X, each slice being sorted by Y, so that groups of consecutive entries
+ * have small bounding boxes
+ */
+static void
+route_index_str_sort(RouteIndexNode *entries, int count)
+{
+  int nparents = (count + ROUTE_INDEX_FANOUT - 1) / ROUTE_INDEX_FANOUT;
+  int nslices = (int) ceil(sqrt((double) nparents));
+  int slice = nslices * ROUTE_INDEX_FANOUT;
+  qsort(entries, (size_t) count, sizeof(RouteIndexNode),
+    (qsort_comparator) &route_node_xcmp);
+  for (int i = 0; i < count; i += slice)
+    qsort(&entries[i], (size_t) Min(slice, count - i),
+      sizeof(RouteIndexNode), (qsort_comparator) &route_node_ycmp);
+  return;
+}
+
+/**
+ * @brief Set the nodes of the R-tree grouping consecutive index entries
+ * @return Number of nodes
+ */
+static int
+route_index_group(const RouteIndexNode *entries, int count,
+  RouteIndexNode *nodes)
+{
+  int n = 0;
+  for (int i = 0; i < count; i += ROUTE_INDEX_FANOUT)
+  {
+    RouteIndexNode *node = &nodes[n++];
+    node->first = i;
+    node->count = Min(ROUTE_INDEX_FANOUT, count - i);
+    node->xmin = node->ymin = DBL_MAX;
+    node->xmax = node->ymax = -DBL_MAX;
+    for (int j = i; j < i + node->count; j++)
+    {
+      node->xmin = Min(node->xmin, entries[j].xmin);
+      node->ymin = Min(node->ymin, entries[j].ymin);
+      node->xmax = Max(node->xmax, entries[j].xmax);
+      node->ymax = Max(node->ymax, entries[j].ymax);
+    }
+  }
+  return n;
+}
+
+/**
+ * @brief Return the index of the route geometries, building it if needed
+ * @return On error return @p NULL
+ */
+static RouteIndex *
+route_index_get(void)
+{
+  if (ROUTE_INDEX)
+    return ROUTE_INDEX;
+
+  int64 *rids;
+  GSERIALIZED **geoms;
+  int count;
+  if (! route_geoms_read(&rids, &geoms, &count))
+    return NULL;
+
+  /* Keep the routes that are lines */
+  LWLINE **lines = palloc(sizeof(LWLINE *) * count);
+  int nroutes = 0, npoints = 0;
+  for (int i = 0; i < count; i++)
+  {
+    LWGEOM *geom = lwgeom_from_gserialized(geoms[i]);
+    LWLINE *line = lwgeom_as_lwline(geom);
+    if (! line || line->points->npoints == 0)
+    {
+      lwgeom_free(geom);
+      pfree(geoms[i]);
+      continue;
+    }
+    rids[nroutes] = rids[i];
+    geoms[nroutes] = geoms[i];
+    lines[nroutes++] = line;
+    npoints += line->points->npoints;
+  }
+
+  /* Free an index whose construction was interrupted by an error */
+  route_index_reset();
+#if ! MEOS
+  ROUTE_INDEX_CXT = AllocSetContextCreate(CacheMemoryContext,
+    "MobilityDB route index", ALLOCSET_DEFAULT_SIZES);
+#endif /* ! MEOS */
+  RouteIndex *idx = route_index_alloc(sizeof(RouteIndex));
+  memset(idx, 0, sizeof(RouteIndex));
+  idx->nroutes = nroutes;
+  idx->rids = route_index_alloc(sizeof(int64) * Max(nroutes, 1));
+  idx->starts = route_index_alloc(sizeof(int) * (nroutes + 1));
+  idx->points = route_index_alloc(sizeof(POINT2D) * Max(npoints, 1));
+  idx->entries = route_index_alloc(sizeof(RouteIndexNode) * Max(nroutes, 1));
+  idx->starts[0] = 0;
+  for (int i = 0; i < nroutes; i++)
+  {
+    const POINTARRAY *pa = lines[i]->points;
+    RouteIndexNode *entry = &idx->entries[i];
+    entry->xmin = entry->ymin = DBL_MAX;
+    entry->xmax = entry->ymax = -DBL_MAX;
+    entry->first = i;
+    entry->count = 0;
+    POINT2D *pts = &idx->points[idx->starts[i]];
+    for (uint32_t j = 0; j < pa->npoints; j++)
+    {
+      getPoint2d_p(pa, j, &pts[j]);
+      entry->xmin = Min(entry->xmin, pts[j].x);
+      entry->ymin = Min(entry->ymin, pts[j].y);
+      entry->xmax = Max(entry->xmax, pts[j].x);
+      entry->ymax = Max(entry->ymax, pts[j].y);
+    }
+    idx->starts[i + 1] = idx->starts[i] + (int) pa->npoints;
+    idx->rids[i] = rids[i];
+    lwline_free(lines[i]);
+  }
+  pfree(lines); pfree(rids);
+  pfree_array((void **) geoms, nroutes);
+
+  /* Pack the R-tree level by level, each level having at most 1/FANOUT of
+   * the entries of the level below */
+  int maxnodes = 1, n = nroutes;
+  while (n > 1)
+  {
+    n = (n + ROUTE_INDEX_FANOUT - 1) / ROUTE_INDEX_FANOUT;
+    maxnodes += n;
+  }
+  idx->nodes = route_index_alloc(sizeof(RouteIndexNode) * maxnodes);
+  route_index_str_sort(idx->entries, nroutes);
+  idx->nleaves = route_index_group(idx->entries, nroutes, idx->nodes);
+  int lower = 0, upper = idx->nleaves;
+  while (upper - lower > 1)
+  {
+    RouteIndexNode *level = &idx->nodes[lower];
+    route_index_str_sort(level, upper - lower);
+    int k = route_index_group(level, upper - lower, &idx->nodes[upper]);
+    /* The children of the new nodes are counted from the start of the
+     * array of nodes */
+    for (int i = 0; i < k; i++)
+      idx->nodes[upper + i].first += lower;
+    lower = upper;
+    upper += k;
+  }
+  idx->nnodes = upper;
+  ROUTE_INDEX = idx;
+  return idx;
+}
+
+/*****************************************************************************
+ * Snapping
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the bounding box of an index entry is within a
+ * distance of a point
+ */
+static bool
+route_node_dwithin(const RouteIndexNode *node, const POINT2D *pt,
+  double tolerance)
+{
+  return pt->x >= node->xmin - tolerance && pt->x <= node->xmax + tolerance &&
+    pt->y >= node->ymin - tolerance && pt->y <= node->ymax + tolerance;
+}
+
+/**
+ * @brief Return in the last argument the routes located within a distance of
+ * a point ordered by distance
+ * @return Number of candidate routes
+ */
+static int
+route_index_candidates(const RouteIndex *idx, const POINT2D *pt,
+  double tolerance, RouteCandidate *result)
+{
+  if (idx->nnodes == 0)
+    return 0;
+  POINT4D p, p_proj;
+  p.x = pt->x; p.y = pt->y; p.z = p.m = 0.0;
+  /* The depth of the R-tree is at most 8 for 2^31 routes */
+  int stack[ROUTE_INDEX_FANOUT * 8];
+  int nstack = 0, ncands = 0;
+  stack[nstack++] = idx->nnodes - 1;
+  while (nstack > 0)
+  {
+    int n = stack[--nstack];
+    const RouteIndexNode *node = &idx->nodes[n];
+    if (! route_node_dwithin(node, pt, tolerance))
+      continue;
+    if (n >= idx->nleaves)
+    {
+      for (int i = 0; i < node->count; i++)
+        stack[nstack++] = node->first + i;
+      continue;
+    }
+    for (int i = node->first; i < node->first + node->count; i++)
+    {
+      const RouteIndexNode *entry = &idx->entries[i];
+      if (! route_node_dwithin(entry, pt, tolerance))
+        continue;
+      int route = entry->first;
+      /* Reference the points of the route without copying them */
+      POINTARRAY pa;
+      pa.flags = lwflags(0, 0, 0);
+      pa.npoints = pa.maxpoints =
+        (uint32_t) (idx->starts[route + 1] - idx->starts[route]);
+      pa.serialized_pointlist = (uint8_t *) &idx->points[idx->starts[route]];
+      double dist;
+      double pos = ptarray_locate_point(&pa, &p, &dist, &p_proj);
+      if (dist > tolerance || (ncands == ROUTE_SNAP_CANDIDATES &&
+          dist >= result[ncands - 1].dist))
+        continue;
+      /* Insert the candidate keeping the candidates ordered by distance */
+      int k = Min(ncands, ROUTE_SNAP_CANDIDATES - 1);
+      while (k > 0 && result[k - 1].dist > dist)
+      {
+        result[k] = result[k - 1];
+        k--;
+      }
+      result[k].rid = idx->rids[route];
+      result[k].pos = pos;
+      result[k].dist = dist;
+      if (ncands < ROUTE_SNAP_CANDIDATES)
+        ncands++;
+    }
+  }
+  return ncands;
+}
+
+/**
+ * @brief Return the network points of the instants of a temporal geometry
+ * point snapped to the routes within a distance
+ *
+ * The route of each instant is chosen among its candidate routes by
+ * minimizing the sum of the distances to the routes plus a penalty equal to
+ * the tolerance for each change of route between consecutive instants.
+ * @param[in] seq Temporal geometry point
+ * @param[in] tolerance Maximum distance between a point and its route
+ * @return Array of network points with one element per instant, which is
+ * @p NULL if the instant is not within the distance of a route. On error
+ * return @p NULL
+ */
+Npoint **
+tgeompointseq_snap(const TSequence *seq, double tolerance)
+{
+  RouteIndex *idx = route_index_get();
+  if (! idx)
+    return NULL;
+
+  int count = seq->count;
+  RouteCandidate *cands = palloc(sizeof(RouteCandidate) * count *
+    ROUTE_SNAP_CANDIDATES);
+  int *ncands = palloc(sizeof(int) * count);
+  int *prev = palloc(sizeof(int) * count);
+  double *cost = palloc(sizeof(double) * count * ROUTE_SNAP_CANDIDATES);
+  int *back = palloc(sizeof(int) * count * ROUTE_SNAP_CANDIDATES);
+  int last = -1;
+  for (int i = 0; i < count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    RouteCandidate *ci = &cands[i * ROUTE_SNAP_CANDIDATES];
+    double *costi = &cost[i * ROUTE_SNAP_CANDIDATES];
+    int *backi = &back[i * ROUTE_SNAP_CANDIDATES];
+    ncands[i] = route_index_candidates(idx,
+      DATUM_POINT2D_P(tinstant_val(inst)), tolerance, ci);
+    prev[i] = last;
+    if (ncands[i] == 0)
+      continue;
+    for (int k = 0; k < ncands[i]; k++)
+    {
+      costi[k] = ci[k].dist;
+      backi[k] = -1;
+      if (last < 0)
+        continue;
+      /* Extend the cheapest path of the previous matched instant */
+      const RouteCandidate *cl = &cands[last * ROUTE_SNAP_CANDIDATES];
+      const double *costl = &cost[last * ROUTE_SNAP_CANDIDATES];
+      double mincost = DBL_MAX;
+      for (int j = 0; j < ncands[last]; j++)
+      {
+        double c = costl[j] + (cl[j].rid == ci[k].rid ? 0.0 : tolerance);
+        if (c < mincost)
+        {
+          mincost = c;
+          backi[k] = j;
+        }
+      }
+      costi[k] += mincost;
+    }
+    last = i;
+  }
+
+  Npoint **result = palloc0(sizeof(Npoint *) * count);
+  if (last >= 0)
+  {
+    /* Follow the cheapest path backwards from the last matched instant */
+    const double *costl = &cost[last * ROUTE_SNAP_CANDIDATES];
+    int k = 0;
+    for (int j = 1; j < ncands[last]; j++)
+      if (costl[j] < costl[k])
+        k = j;
+    for (int i = last; i >= 0 && k >= 0; i = prev[i])
+    {
+      const RouteCandidate *c = &cands[i * ROUTE_SNAP_CANDIDATES + k];
+      result[i] = npoint_make(c->rid, c->pos);
+      k = back[i * ROUTE_SNAP_CANDIDATES + k];
+    }
+  }
+  pfree(cands); pfree(ncands); pfree(prev); pfree(cost); pfree(back);
+  return result;
+}
+
+/**
+ * @brief Append to the last argument the sequences of a temporal geometry
+ * point snapped to the routes, which are split at the changes of route
+ * @return Number of sequences appended
+ */
+static int
+tgeompointseq_snap_iter(const TSequence *seq, double tolerance,
+  TSequence **result)
+{
+  Npoint **points = tgeompointseq_snap(seq, tolerance);
+  if (! points)
+    return 0;
+  TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
+  bool discrete = MEOS_FLAGS_DISCRETE_INTERP(seq->flags);
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  int nseqs = 0, ninsts = 0, first = -1, lastinst = -1;
+  for (int i = 0; i <= seq->count; i++)
+  {
+    /* Close the current sequence at the end or at a change of route */
+    if (ninsts > 0 && (i == seq->count || (points[i] && ! discrete &&
+        points[i]->rid != points[lastinst]->rid)))
+    {
+      bool lower_inc = (first == 0) ? seq->period.lower_inc : true;
+      bool upper_inc = (lastinst == seq->count - 1) ?
+        seq->period.upper_inc : true;
+      /* An instantaneous sequence must have inclusive bounds */
+      if (ninsts > 1 || (lower_inc && upper_inc))
+      {
+        result[nseqs++] = tsequence_make_free(instants, ninsts, lower_inc,
+          upper_inc, interp, NORMALIZE);
+        instants = (i < seq->count) ?
+          palloc(sizeof(TInstant *) * seq->count) : NULL;
+      }
+      else
+        pfree(instants[0]);
+      ninsts = 0;
+    }
+    if (i == seq->count)
+      break;
+    if (! points[i])
+      continue;
+    if (ninsts == 0)
+      first = i;
+    instants[ninsts++] = tinstant_make(PointerGetDatum(points[i]), T_TNPOINT,
+      TSEQUENCE_INST_N(seq, i)->t);
+    lastinst = i;
+  }
+  if (instants)
+    pfree(instants);
+  pfree_array((void **) points, seq->count);
+  return nseqs;
+}
+
+/**
+ * @ingroup meos_temporal_conversion
+ * @brief Return a temporal geometry point snapped to the routes within a
+ * distance
+ *
+ * The instants that are not within the distance of a route are removed and
+ * the sequences are split at the changes of route.
+ * @param[in] temp Temporal geometry point
+ * @param[in] tolerance Maximum distance between a point and its route
+ * @return On error or if no instant is within the distance of a route
+ * return @p NULL
+ */
+Temporal *
+tgeompoint_tnpoint_snap(const Temporal *temp, double tolerance)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_temporal_isof_type(temp, T_TGEOMPOINT) ||
+      ! ensure_not_negative_datum(Float8GetDatum(tolerance), T_FLOAT8))
+    return NULL;
+  int32_t srid_ways = get_srid_ways();
+  if (srid_ways == SRID_INVALID ||
+      ! ensure_same_srid(tpoint_srid(temp), srid_ways))
+    return NULL;
+
+  const TSequence **sequences;
+  int count;
+  TSequence *seq = NULL;
+  if (temp->subtype == TINSTANT)
+  {
+    seq = tinstant_to_tsequence((const TInstant *) temp, STEP);
+    sequences = palloc(sizeof(TSequence *));
+    sequences[0] = seq;
+    count = 1;
+  }
+  else if (temp->subtype == TSEQUENCE)
+  {
+    sequences = palloc(sizeof(TSequence *));
+    sequences[0] = (const TSequence *) temp;
+    count = 1;
+  }
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    sequences = palloc(sizeof(TSequence *) * ss->count);
+    for (int i = 0; i < ss->count; i++)
+      sequences[i] = TSEQUENCESET_SEQ_N(ss, i);
+    count = ss->count;
+  }
+
+  /* A sequence of n instants is split into at most n sequences */
+  int ninsts = 0;
+  for (int i = 0; i < count; i++)
+    ninsts += sequences[i]->count;
+  TSequence **result = palloc(sizeof(TSequence *) * ninsts);
+  int nseqs = 0;
+  for (int i = 0; i < count; i++)
+    nseqs += tgeompointseq_snap_iter(sequences[i], tolerance, &result[nseqs]);
+  pfree(sequences);
+  if (seq)
+    pfree(seq);
+
+  if (nseqs == 0)
+  {
+    pfree(result);
+    return NULL;
+  }
+  if (temp->subtype == TINSTANT)
+  {
+    Temporal *res = (Temporal *) tinstant_copy(TSEQUENCE_INST_N(result[0], 0));
+    pfree_array((void **) result, nseqs);
+    return res;
+  }
+  if (temp->subtype == TSEQUENCE && nseqs == 1)
+  {
+    Temporal *res = (Temporal *) result[0];
+    pfree(result);
+    return res;
+  }
+  return (Temporal *) tsequenceset_make_free(result, nseqs, NORMALIZE);
+}
+
+/*****************************************************************************/
@@ -48,12 +48,43 @@
 #include "general/lifting.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_spatialrels.h"
+#include "npoint/tnpoint_distance.h"
 #include "npoint/tnpoint_spatialfuncs.h"
 
 /*****************************************************************************
  * Generic binary functions for two temporal network points
  *****************************************************************************/
 
+/**
+ * @brief Return true if two temporal network points located on the same
+ * route are ever/always equal or different computed from their positions
+ * @details Equal positions are equal points whatever the geometry of the route
+ * while different positions are different points only if the route is
+ * straight. The function returns -2 when the result cannot be determined
+ * from the positions.
+ */
+static int
+ea_spatialrel_tnpoint_tnpoint_route(const Temporal *temp1,
+  const Temporal *temp2, int64 rid, bool eq, bool ever)
+{
+  Temporal *dist = distance_tnpoint_tnpoint_route(temp1, temp2, rid);
+  if (! dist)
+    return -1;
+  double min = DatumGetFloat8(temporal_min_value(dist));
+  double max = DatumGetFloat8(temporal_max_value(dist));
+  pfree(dist);
+  if (eq)
+  {
+    if ((ever ? min : max) == 0.0)
+      return 1;
+  }
+  else if ((ever ? max : min) == 0.0)
+    return 0;
+  if (route_straight(rid))
+    return eq ? 0 : 1;
+  return -2;
+}
+
 /**
  * @brief Return true if the temporal network points ever satisfy the spatial
  * relationship
@@ -66,6 +97,16 @@ ea_spatialrel_tnpoint_tnpoint(const Temporal *temp1, const Temporal *temp2,
   datum_func2 func, bool ever)
 {
   assert(tnpoint_srid(temp1) == tnpoint_srid(temp2));
+  /* Values on the same route are compared from their positions if possible */
+  int64 rid;
+  if ((func == &datum2_point_eq || func == &datum2_point_ne) &&
+      tnpoint_same_route(temp1, temp2, &rid))
+  {
+    int result = ea_spatialrel_tnpoint_tnpoint_route(temp1, temp2, rid,
+      func == &datum2_point_eq, ever);
+    if (result != -2)
+      return result;
+  }
   /* Transform the temporal network points */
   Temporal *tpoint1 = tnpoint_tgeompoint(temp1);
   Temporal *tpoint2 = tnpoint_tgeompoint(temp2);
@@ -331,6 +372,25 @@ ea_dwithin_tnpoint_tnpoint(const Temporal *temp1, const Temporal *temp2,
       &sync1, &sync2))
     return -1;
 
+  /* The distance along a route is an upper bound of the Euclidean distance
+   * which is exact when the route is straight */
+  int64 rid;
+  if (tnpoint_same_route(sync1, sync2, &rid))
+  {
+    Temporal *rdist = distance_tnpoint_tnpoint_route(sync1, sync2, rid);
+    if (rdist)
+    {
+      double bound = DatumGetFloat8(ever ? temporal_min_value(rdist) :
+        temporal_max_value(rdist));
+      pfree(rdist);
+      if (bound <= dist || route_straight(rid))
+      {
+        pfree(sync1); pfree(sync2);
+        return bound <= dist ? 1 : 0;
+      }
+    }
+  }
+
   Temporal *tpoint1 = tnpoint_tgeompoint(sync1);
   Temporal *tpoint2 = tnpoint_tgeompoint(sync2);
   bool result = ea_dwithin_tpoint_tpoint1(tpoint1, tpoint2, dist, ever);
@@ -41,17 +41,31 @@
 #include <assert.h>
 /* PostgreSQL */
 #include <postgres.h>
-#include <libpq/pqformat.h>
-#include <executor/spi.h>
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  #include <common/hashfn.h>
+#else
+  #include <access/hash.h>
+#endif
+#if ! MEOS
+  #include <catalog/pg_namespace.h>
+  #include <catalog/pg_type.h>
+  #include <executor/spi.h>
+  #include <utils/array.h>
+  #include <utils/inval.h>
+  #include <utils/lsyscache.h>
+  #include <utils/memutils.h>
+#endif /* ! MEOS */
 /* PostGIS */
 #include <liblwgeom.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/meos_probes.h"
 #include "general/pg_types.h"
 #include "general/type_out.h"
 #include "general/type_util.h"
 #include "point/pgis_types.h"
+#include "point/stbox.h"
 #include "point/tpoint.h"
 #include "point/tpoint_out.h"
 #include "point/tpoint_spatialfuncs.h"
@@ -66,37 +80,50 @@
  *****************************************************************************/
 
 /**
- * @brief Return the SRID of the routes in the ways table
- * @return On error return SRID_INVALID
+ * @brief Comparator function for route identifiers
  */
-int32_t
-get_srid_ways()
+static int
+rid_sort_cmp(const int64 *l, const int64 *r)
 {
-  int32_t srid_ways = 0; /* make compiler quiet */
-  bool isNull = true;
-  SPI_connect();
-  int ret = SPI_execute("SELECT ST_SRID(the_geom) FROM public.ways LIMIT 1;", true, 1);
-  uint64 proc = SPI_processed;
-  if (ret > 0 && proc > 0 && SPI_tuptable != NULL)
-  {
-    SPITupleTable *tuptable = SPI_tuptable;
-    Datum value = SPI_getbinval(tuptable->vals[0], tuptable->tupdesc, 1, &isNull);
-    if (isNull)
-    {
-      meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-        "Cannot determine SRID of the ways table");
-      return SRID_INVALID;
-    }
-    srid_ways = DatumGetInt32(value);
-  }
-  else
+  return (*l < *r) ? -1 : ((*l > *r) ? 1 : 0);
+}
+
+/**
+ * @brief Sort an array of route identifiers and remove its duplicates
+ * @return Number of distinct route identifiers
+ */
+int
+ridarr_sort_unique(int64 *rids, int count)
+{
+  assert(count > 0);
+  qsort(rids, (size_t) count, sizeof(int64),
+    (qsort_comparator) &rid_sort_cmp);
+  int newcount = 0;
+  for (int i = 1; i < count; i++)
+    if (rids[newcount] != rids[i])
+      rids[++newcount] = rids[i];
+  return newcount + 1;
+}
+
+/**
+ * @brief Return the position of a route identifier in a sorted array of
+ * distinct route identifiers, or -1 if it is not found
+ */
+int
+ridarr_find(const int64 *rids, int count, int64 rid)
+{
+  int first = 0, last = count - 1;
+  while (first <= last)
   {
-    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
-      "Cannot determine SRID of the ways table");
-    return SRID_INVALID;
+    int middle = (first + last) / 2;
+    if (rids[middle] == rid)
+      return middle;
+    if (rids[middle] < rid)
+      first = middle + 1;
+    else
+      last = middle - 1;
   }
-  SPI_finish();
-  return srid_ways;
+  return -1;
 }
 
 /*****************************************************************************
@@ -107,20 +134,36 @@ get_srid_ways()
  * @brief Return an array of network points converted into a geometry
  * @param[in] points Array of network points
  * @param[in] count Number of elements in the input array
+ * @return On error return @p NULL
  * @pre The argument @p count is greater than 1
  */
 GSERIALIZED *
 npointarr_geom(Npoint **points, int count)
 {
   assert(count > 1);
+  /* Fetch the distinct routes at once */
+  int64 *rids = palloc(sizeof(int64) * count);
+  for (int i = 0; i < count; i++)
+    rids[i] = points[i]->rid;
+  int nrids = ridarr_sort_unique(rids, count);
+  GSERIALIZED **gslines = route_geom_batch(rids, nrids);
+  if (! gslines)
+  {
+    pfree(rids);
+    return NULL;
+  }
+  LWGEOM **lines = palloc0(sizeof(LWGEOM *) * nrids);
+  int32_t srid = gserialized_get_srid(gslines[0]);
+
   LWGEOM **geoms = palloc(sizeof(LWGEOM *) * count);
   for (int i = 0; i < count; i++)
   {
-    GSERIALIZED *gsline = route_geom(points[i]->rid);
-    int32_t srid = gserialized_get_srid(gsline);
-    LWGEOM *line = lwgeom_from_gserialized(gsline);
-    geoms[i] = lwgeom_line_interpolate_point(line, points[i]->pos, srid, 0);
-    pfree(gsline); pfree(line);
+    int j = ridarr_find(rids, nrids, points[i]->rid);
+    /* Deserialize each route only once */
+    if (! lines[j])
+      lines[j] = lwgeom_from_gserialized(gslines[j]);
+    geoms[i] = lwgeom_line_interpolate_point(lines[j], points[i]->pos, srid,
+      0);
   }
   int newcount;
   LWGEOM **newgeoms = lwpointarr_remove_duplicates(geoms, count, &newcount);
@@ -128,6 +171,13 @@ npointarr_geom(Npoint **points, int count)
   GSERIALIZED *result = geo_serialize(geom);
   pfree(newgeoms); pfree(geom);
   pfree_array((void **) geoms, count);
+  for (int i = 0; i < nrids; i++)
+  {
+    if (lines[i])
+      lwgeom_free(lines[i]);
+  }
+  pfree(lines); pfree(rids);
+  pfree_array((void **) gslines, nrids);
   return result;
 }
 
@@ -135,16 +185,29 @@ npointarr_geom(Npoint **points, int count)
  * @brief Return an array of network segments converted into a geometry
  * @param[in] segments Array of network segments
  * @param[in] count Number of elements in the input array
+ * @return On error return @p NULL
  * @pre The argument @p count is greater than 1
  */
 GSERIALIZED *
 nsegmentarr_geom(Nsegment **segments, int count)
 {
   assert(count > 1);
+  /* Fetch the distinct routes at once */
+  int64 *rids = palloc(sizeof(int64) * count);
+  for (int i = 0; i < count; i++)
+    rids[i] = segments[i]->rid;
+  int nrids = ridarr_sort_unique(rids, count);
+  GSERIALIZED **lines = route_geom_batch(rids, nrids);
+  if (! lines)
+  {
+    pfree(rids);
+    return NULL;
+  }
+
   GSERIALIZED **geoms = palloc(sizeof(GSERIALIZED *) * count);
   for (int i = 0; i < count; i++)
   {
-    GSERIALIZED *line = route_geom(segments[i]->rid);
+    GSERIALIZED *line = lines[ridarr_find(rids, nrids, segments[i]->rid)];
     if (segments[i]->pos1 == 0 && segments[i]->pos2 == 1)
       geoms[i] = geo_copy(line);
     else if (segments[i]->pos1 == segments[i]->pos2)
@@ -152,10 +215,11 @@ nsegmentarr_geom(Nsegment **segments, int count)
     else
       geoms[i] = linestring_substring(line, segments[i]->pos1,
         segments[i]->pos2);
-    pfree(line);
   }
   GSERIALIZED *result = geometry_array_union(geoms, count);
   pfree_array((void **) geoms, count);
+  pfree_array((void **) lines, nrids);
+  pfree(rids);
   return result;
 }
 
@@ -454,58 +518,426 @@ nsegment_end_position(const Nsegment *ns)
  * Conversions between network and Euclidean space
  *****************************************************************************/
 
+#if ! MEOS
+/*****************************************************************************
+ * Route cache
+ *
+ * The conversions from network points to geometries access the ways table
+ * through SPI for every network point. Since a temporal network point visits
+ * the same routes many times, the routes are kept in a bounded per-backend
+ * cache keyed by the route identifier. The cache keeps the detoasted route
+ * geometry together with its length and its bounding box. The least recently
+ * used route is evicted when the cache is full.
+ *
+ * The cache is flushed by a relcache callback whenever the ways table is
+ * invalidated (e.g., by ALTER TABLE, TRUNCATE, or DROP TABLE). Since row
+ * updates do not produce relcache invalidations, the cache can also be
+ * flushed explicitly with #route_cache_reset.
+ *
+ * Each process, including the parallel workers, has its own cache, which
+ * also keeps the SRID of the ways table. Since the routes are only read
+ * through read-only SPI queries and never written, the functions that need
+ * them are parallel safe, a worker filling its own cache on first access.
+ *****************************************************************************/
+
 /**
- * @brief Return true if the edge table contains a route with the route
- * identifier
+ * @brief Structure to represent a route kept in the route cache
+ */
+typedef struct
+{
+  int64 rid;           /**< Route identifier */
+  GSERIALIZED *geom;   /**< Detoasted route geometry */
+  double length;       /**< Route length, negative if NULL in the ways table
+                            or if not yet read */
+  STBox box;           /**< Bounding box of the route geometry */
+  int prev;            /**< Previous (more recently used) slot, -1 if none */
+  int next;            /**< Next (less recently used) slot, -1 if none */
+} RouteCacheSlot;
+
+/**
+ * @brief Structure to represent the route cache hash table
+ */
+typedef struct
+{
+  int64 rid;           /**< Route identifier (hash table key) */
+  int slot;            /**< Slot of the route in the cache */
+  char status;         /**< Hash status */
+} route_entry;
+
+/**
+ * @brief Define a hashtable mapping route identifiers to cache slots
+ */
+#define SH_PREFIX routetable
+#define SH_ELEMENT_TYPE route_entry
+#define SH_KEY_TYPE int64
+#define SH_KEY rid
+#define SH_HASH_KEY(tb, key) pg_hashint8(key)
+#define SH_EQUAL(tb, a, b) a == b
+#define SH_SCOPE static inline
+#define SH_DEFINE
+#define SH_DECLARE
+#include "lib/simplehash.h"
+
+/**
+ * @brief Global variable keeping the routes of the ways table
+ */
+static struct
+{
+  MemoryContext cxt;              /**< Memory context of the cached routes */
+  struct routetable_hash *table;  /**< Route identifier -> slot */
+  RouteCacheSlot slots[ROUTE_CACHE_SIZE]; /**< Cached routes */
+  int count;                      /**< Number of used slots */
+  int head;                       /**< Most recently used slot, -1 if none */
+  int tail;                       /**< Least recently used slot, -1 if none */
+  uint64 hits;                    /**< Number of lookups found in the cache */
+  uint64 misses;                  /**< Number of lookups read from the table */
+} ROUTE_CACHE = { NULL, NULL, {{0}}, 0, -1, -1, 0, 0 };
+
+/**
+ * @brief Oid of the ways table, InvalidOid if not yet known
+ * @note The Oid is flushed together with the route cache, since the table may
+ * have been dropped and recreated
+ */
+static Oid ROUTE_CACHE_WAYS_OID = InvalidOid;
+
+/**
+ * @brief SRID of the routes of the ways table, SRID_INVALID if not yet known
+ * @note The SRID is flushed together with the route cache
  */
+static int32_t ROUTE_CACHE_SRID = SRID_INVALID;
+
+/**
+ * @brief Global variable that states whether the relcache callback has been
+ * registered
+ */
+static bool ROUTE_CACHE_CALLBACK = false;
+
+/**
+ * @brief Flush the route cache
+ * @note The hit and miss counters are kept
+ */
+void
+route_cache_reset(void)
+{
+  route_graph_reset();
+  route_index_reset();
+  ROUTE_CACHE_SRID = SRID_INVALID;
+  ROUTE_CACHE_WAYS_OID = InvalidOid;
+  if (ROUTE_CACHE.cxt)
+    MemoryContextDelete(ROUTE_CACHE.cxt);
+  ROUTE_CACHE.cxt = NULL;
+  ROUTE_CACHE.table = NULL;
+  ROUTE_CACHE.count = 0;
+  ROUTE_CACHE.head = ROUTE_CACHE.tail = -1;
+  return;
+}
+
+/**
+ * @brief Relcache callback that flushes the route cache when the ways table
+ * is invalidated
+ * @note A relid equal to InvalidOid means that all relations are invalidated
+ */
+static void
+route_cache_relcache_callback(Datum arg __attribute__((unused)), Oid relid)
+{
+  if (relid == InvalidOid || relid == ROUTE_CACHE_WAYS_OID)
+    route_cache_reset();
+  return;
+}
+
+/**
+ * @brief Create the route cache if it does not exist
+ */
+static void
+route_cache_init(void)
+{
+  if (! ROUTE_CACHE_CALLBACK)
+  {
+    CacheRegisterRelcacheCallback(route_cache_relcache_callback, (Datum) 0);
+    ROUTE_CACHE_CALLBACK = true;
+  }
+  if (ROUTE_CACHE.cxt)
+    return;
+  ROUTE_CACHE.cxt = AllocSetContextCreate(CacheMemoryContext,
+    "MobilityDB route cache", ALLOCSET_DEFAULT_SIZES);
+  ROUTE_CACHE.table = routetable_create(ROUTE_CACHE.cxt, ROUTE_CACHE_SIZE,
+    NULL);
+  return;
+}
+
+/**
+ * @brief Remove a slot from the LRU list
+ */
+static void
+route_cache_unlink(int slot)
+{
+  RouteCacheSlot *rs = &ROUTE_CACHE.slots[slot];
+  if (rs->prev >= 0)
+    ROUTE_CACHE.slots[rs->prev].next = rs->next;
+  else
+    ROUTE_CACHE.head = rs->next;
+  if (rs->next >= 0)
+    ROUTE_CACHE.slots[rs->next].prev = rs->prev;
+  else
+    ROUTE_CACHE.tail = rs->prev;
+  rs->prev = rs->next = -1;
+  return;
+}
+
+/**
+ * @brief Make a slot the most recently used one
+ */
+static void
+route_cache_push(int slot)
+{
+  RouteCacheSlot *rs = &ROUTE_CACHE.slots[slot];
+  rs->prev = -1;
+  rs->next = ROUTE_CACHE.head;
+  if (ROUTE_CACHE.head >= 0)
+    ROUTE_CACHE.slots[ROUTE_CACHE.head].prev = slot;
+  ROUTE_CACHE.head = slot;
+  if (ROUTE_CACHE.tail < 0)
+    ROUTE_CACHE.tail = slot;
+  return;
+}
+
+/**
+ * @brief Add a route to the cache, evicting the least recently used route if
+ * the cache is full
+ * @param[in] rid Route identifier
+ * @param[in] gs Route geometry
+ * @param[in] length Route length
+ */
+static RouteCacheSlot *
+route_cache_add(int64 rid, const GSERIALIZED *gs, double length)
+{
+  route_cache_init();
+  int slot;
+  if (ROUTE_CACHE.count < ROUTE_CACHE_SIZE)
+    slot = ROUTE_CACHE.count++;
+  else
+  {
+    /* Evict the least recently used route */
+    slot = ROUTE_CACHE.tail;
+    route_cache_unlink(slot);
+    routetable_delete(ROUTE_CACHE.table, ROUTE_CACHE.slots[slot].rid);
+    pfree(ROUTE_CACHE.slots[slot].geom);
+  }
+  RouteCacheSlot *rs = &ROUTE_CACHE.slots[slot];
+  rs->rid = rid;
+  rs->geom = MemoryContextAlloc(ROUTE_CACHE.cxt, VARSIZE(gs));
+  memcpy(rs->geom, gs, VARSIZE(gs));
+  rs->length = length;
+  geo_set_stbox(rs->geom, &rs->box);
+  route_cache_push(slot);
+  bool found;
+  route_entry *entry = routetable_insert(ROUTE_CACHE.table, rid, &found);
+  entry->slot = slot;
+  return rs;
+}
+
 #define SQL_ROUTE_MAXLEN 64
 
-bool
-route_exists(int64 rid)
+/**
+ * @brief Return the route from the cache, reading it from the ways table if
+ * it is not in the cache
+ * @param[in] rid Route identifier
+ * @return Return @p NULL if the ways table does not contain the route
+ * identifier or if its geometry is NULL
+ */
+static const RouteCacheSlot *
+route_cache_fetch(int64 rid)
 {
+  if (ROUTE_CACHE.table)
+  {
+    route_entry *entry = routetable_lookup(ROUTE_CACHE.table, rid);
+    if (entry)
+    {
+      ROUTE_CACHE.hits++;
+      MEOS_STAT_ADD(MEOS_STAT_ROUTE_CACHE_HITS, 1);
+      if (ROUTE_CACHE.head != entry->slot)
+      {
+        route_cache_unlink(entry->slot);
+        route_cache_push(entry->slot);
+      }
+      return &ROUTE_CACHE.slots[entry->slot];
+    }
+  }
+  ROUTE_CACHE.misses++;
+  MEOS_STAT_ADD(MEOS_STAT_ROUTE_CACHE_MISSES, 1);
+
   char sql[SQL_ROUTE_MAXLEN];
   snprintf(sql, sizeof(sql),
-    "SELECT true FROM public.ways WHERE gid = %ld", rid);
-  bool isNull = true;
-  bool result = false;
+    "SELECT the_geom, length FROM public.ways WHERE gid = %ld", rid);
+  GSERIALIZED *gs = NULL;
+  double length = -1.0;
   SPI_connect();
   int ret = SPI_execute(sql, true, 1);
   uint64 proc = SPI_processed;
   if (ret > 0 && proc > 0 && SPI_tuptable != NULL)
   {
     SPITupleTable *tuptable = SPI_tuptable;
-    result = DatumGetBool(SPI_getbinval(tuptable->vals[0],
-      tuptable->tupdesc, 1, &isNull));
+    bool isNull = true;
+    Datum line = SPI_getbinval(tuptable->vals[0], tuptable->tupdesc, 1,
+      &isNull);
+    if (! isNull)
+    {
+      /* Must allocate this in upper executor context to keep it alive after
+       * SPI_finish() */
+      GSERIALIZED *gs1 = (GSERIALIZED *) PG_DETOAST_DATUM(line);
+      gs = (GSERIALIZED *) SPI_palloc(VARSIZE(gs1));
+      memcpy(gs, gs1, VARSIZE(gs1));
+      Datum value = SPI_getbinval(tuptable->vals[0], tuptable->tupdesc, 2,
+        &isNull);
+      if (! isNull)
+        length = DatumGetFloat8(value);
+    }
   }
   SPI_finish();
+  if (! gs)
+    return NULL;
+  if (! ensure_not_empty(gs))
+  {
+    pfree(gs);
+    return NULL;
+  }
+
+  /* Opening the ways table above may have processed invalidation messages
+   * that flushed the cache, the route is thus added after SPI_finish() */
+  if (ROUTE_CACHE_WAYS_OID == InvalidOid)
+    ROUTE_CACHE_WAYS_OID = get_relname_relid("ways", PG_PUBLIC_NAMESPACE);
+  const RouteCacheSlot *result = route_cache_add(rid, gs, length);
+  pfree(gs);
   return result;
 }
 
 /**
- * @brief Access the edge table to return the route length from the
- * corresponding route identifier
- * @brief On error return -1
+ * @brief Read the length of a route from the ways table and keep it in the
+ * route cache
+ * @param[in] rid Route identifier
+ * @return Return -1 if the ways table does not contain the route identifier
+ * or if its length is NULL
  */
-double
-route_length(int64 rid)
+static double
+route_cache_read_length(int64 rid)
 {
   char sql[SQL_ROUTE_MAXLEN];
   snprintf(sql, sizeof(sql),
     "SELECT length FROM public.ways WHERE gid = %ld", rid);
-  bool isNull = true;
-  double result = 0;
+  double result = -1.0;
   SPI_connect();
   int ret = SPI_execute(sql, true, 1);
   uint64 proc = SPI_processed;
   if (ret > 0 && proc > 0 && SPI_tuptable != NULL)
   {
     SPITupleTable *tuptable = SPI_tuptable;
-    result = DatumGetFloat8(SPI_getbinval(tuptable->vals[0],
-      tuptable->tupdesc, 1, &isNull));
+    bool isNull = true;
+    Datum value = SPI_getbinval(tuptable->vals[0], tuptable->tupdesc, 1,
+      &isNull);
+    if (! isNull)
+      result = DatumGetFloat8(value);
   }
   SPI_finish();
 
-  if (isNull)
+  /* As for the routes, the length is stored after SPI_finish() since the
+   * cache may have been flushed */
+  if (result >= 0 && ROUTE_CACHE.table)
+  {
+    route_entry *entry = routetable_lookup(ROUTE_CACHE.table, rid);
+    if (entry)
+      ROUTE_CACHE.slots[entry->slot].length = result;
+  }
+  return result;
+}
+
+/**
+ * @brief Return in the last arguments the statistics of the route cache
+ * @param[out] hits Number of route lookups found in the cache
+ * @param[out] misses Number of route lookups read from the ways table
+ * @param[out] count Number of routes currently in the cache
+ * @param[out] capacity Maximum number of routes in the cache
+ */
+void
+route_cache_stats(int64 *hits, int64 *misses, int *count, int *capacity)
+{
+  *hits = (int64) ROUTE_CACHE.hits;
+  *misses = (int64) ROUTE_CACHE.misses;
+  *count = ROUTE_CACHE.count;
+  *capacity = ROUTE_CACHE_SIZE;
+  return;
+}
+
+/**
+ * @brief Return the SRID of the routes in the ways table
+ * @details The SRID is read once from the ways table and kept for the next
+ * calls until the route cache is flushed
+ * @return On error return SRID_INVALID
+ */
+int32_t
+get_srid_ways()
+{
+  if (ROUTE_CACHE_SRID != SRID_INVALID)
+    return ROUTE_CACHE_SRID;
+
+  int32_t srid_ways = 0; /* make compiler quiet */
+  bool isNull = true;
+  SPI_connect();
+  int ret = SPI_execute("SELECT ST_SRID(the_geom) FROM public.ways LIMIT 1;", true, 1);
+  uint64 proc = SPI_processed;
+  if (ret > 0 && proc > 0 && SPI_tuptable != NULL)
+  {
+    SPITupleTable *tuptable = SPI_tuptable;
+    Datum value = SPI_getbinval(tuptable->vals[0], tuptable->tupdesc, 1, &isNull);
+    if (isNull)
+    {
+      meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+        "Cannot determine SRID of the ways table");
+      return SRID_INVALID;
+    }
+    srid_ways = DatumGetInt32(value);
+  }
+  else
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR,
+      "Cannot determine SRID of the ways table");
+    return SRID_INVALID;
+  }
+  SPI_finish();
+
+  /* As for the routes, the SRID is kept after SPI_finish() */
+  route_cache_init();
+  if (ROUTE_CACHE_WAYS_OID == InvalidOid)
+    ROUTE_CACHE_WAYS_OID = get_relname_relid("ways", PG_PUBLIC_NAMESPACE);
+  ROUTE_CACHE_SRID = srid_ways;
+  return srid_ways;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Return true if the edge table contains a route with the route
+ * identifier
+ */
+bool
+route_exists(int64 rid)
+{
+  return route_cache_fetch(rid) != NULL;
+}
+
+/**
+ * @brief Access the edge table to return the route length from the
+ * corresponding route identifier
+ * @brief On error return -1
+ */
+double
+route_length(int64 rid)
+{
+  const RouteCacheSlot *rs = route_cache_fetch(rid);
+  double result = rs ? rs->length : -1.0;
+  /* The routes read by route_geom_batch() are cached without their length */
+  if (rs && result < 0)
+    result = route_cache_read_length(rid);
+  if (result < 0)
   {
     meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
       "Cannot get the length for route %ld", rid);
@@ -522,44 +954,317 @@ route_length(int64 rid)
 GSERIALIZED *
 route_geom(int64 rid)
 {
-  char sql[SQL_ROUTE_MAXLEN];
-  snprintf(sql, sizeof(sql),
-    "SELECT the_geom FROM public.ways WHERE gid = %ld", rid);
-  bool isNull = true;
-  GSERIALIZED *result = NULL;
+  MEOS_PROBE_ROUTE_GEOM(rid);
+  const RouteCacheSlot *rs = route_cache_fetch(rid);
+  if (! rs)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Cannot get the geometry for route %ld", rid);
+    return NULL;
+  }
+  GSERIALIZED *result = palloc(VARSIZE(rs->geom));
+  memcpy(result, rs->geom, VARSIZE(rs->geom));
+  return result;
+}
+
+/**
+ * @brief Prepared statement fetching the routes of an array of route
+ * identifiers, kept for the lifetime of the backend
+ */
+static SPIPlanPtr ROUTE_BATCH_PLAN = NULL;
+
+/**
+ * @brief Access the edge table to get the route geometries from an array of
+ * route identifiers
+ *
+ * The routes not found in the route cache are read with a single query
+ * `SELECT ... WHERE gid = ANY($1)` rather than one query per route, and are
+ * then added to the cache.
+ * @param[in] rids Array of distinct route identifiers
+ * @param[in] count Number of elements in the array
+ * @return Array of route geometries in the same order as the route
+ * identifiers. On error return @p NULL
+ * @pre The route identifiers are sorted in ascending order and do not have
+ * duplicates, e.g., as returned by #ridarr_sort_unique
+ */
+GSERIALIZED **
+route_geom_batch(const int64 *rids, int count)
+{
+  assert(count > 0);
+  GSERIALIZED **result = palloc(sizeof(GSERIALIZED *) * count);
+  /* Positions in the input array of the routes not found in the cache */
+  int *missing = palloc(sizeof(int) * count);
+  int nmissing = 0;
+  for (int i = 0; i < count; i++)
+  {
+    route_entry *entry = ROUTE_CACHE.table ?
+      routetable_lookup(ROUTE_CACHE.table, rids[i]) : NULL;
+    if (entry)
+    {
+      ROUTE_CACHE.hits++;
+      MEOS_STAT_ADD(MEOS_STAT_ROUTE_CACHE_HITS, 1);
+      if (ROUTE_CACHE.head != entry->slot)
+      {
+        route_cache_unlink(entry->slot);
+        route_cache_push(entry->slot);
+      }
+      const GSERIALIZED *gs = ROUTE_CACHE.slots[entry->slot].geom;
+      result[i] = palloc(VARSIZE(gs));
+      memcpy(result[i], gs, VARSIZE(gs));
+    }
+    else
+    {
+      ROUTE_CACHE.misses++;
+      MEOS_STAT_ADD(MEOS_STAT_ROUTE_CACHE_MISSES, 1);
+      result[i] = NULL;
+      missing[nmissing++] = i;
+    }
+  }
+  if (nmissing == 0)
+  {
+    pfree(missing);
+    return result;
+  }
+
+  /* Read the missing routes from the ways table with a single query.
+   * The query results are kept in the current memory context and are added
+   * to the cache after SPI_finish(), since opening the ways table may have
+   * processed invalidation messages that flushed the cache */
+  Datum *values = palloc(sizeof(Datum) * nmissing);
+  for (int i = 0; i < nmissing; i++)
+    values[i] = Int64GetDatum(rids[missing[i]]);
+  ArrayType *array = construct_array(values, nmissing, INT8OID,
+    sizeof(int64), FLOAT8PASSBYVAL, 'd');
   SPI_connect();
-  int ret = SPI_execute(sql, true, 1);
-  uint64 proc = SPI_processed;
-  if (ret > 0 && proc > 0 && SPI_tuptable != NULL)
+  if (! ROUTE_BATCH_PLAN)
+  {
+    Oid argtypes[1] = { INT8ARRAYOID };
+    SPIPlanPtr plan = SPI_prepare(
+      "SELECT gid, the_geom FROM public.ways WHERE gid = ANY($1)",
+      1, argtypes);
+    if (! plan)
+    {
+      SPI_finish();
+      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+        "Cannot prepare the query reading the ways table");
+      return NULL;
+    }
+    SPI_keepplan(plan);
+    ROUTE_BATCH_PLAN = plan;
+  }
+  Datum args[1] = { PointerGetDatum(array) };
+  int ret = SPI_execute_plan(ROUTE_BATCH_PLAN, args, NULL, true, 0);
+  if (ret == SPI_OK_SELECT && SPI_tuptable != NULL)
   {
     SPITupleTable *tuptable = SPI_tuptable;
-    Datum line = SPI_getbinval(tuptable->vals[0], tuptable->tupdesc, 1, &isNull);
-    if (!isNull)
+    for (uint64 k = 0; k < SPI_processed; k++)
     {
-      /* Must allocate this in upper executor context to keep it alive after SPI_finish() */
+      bool isNull;
+      int64 rid = DatumGetInt64(SPI_getbinval(tuptable->vals[k],
+        tuptable->tupdesc, 1, &isNull));
+      int i = ridarr_find(rids, count, rid);
+      if (i < 0 || result[i])
+        continue;
+      Datum line = SPI_getbinval(tuptable->vals[k], tuptable->tupdesc, 2,
+        &isNull);
+      if (isNull)
+        continue;
+      /* Must allocate this in upper executor context to keep it alive after
+       * SPI_finish() */
       GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(line);
-      result = (GSERIALIZED *) SPI_palloc(gs->size);
-      memcpy(result, gs, gs->size);
+      result[i] = (GSERIALIZED *) SPI_palloc(VARSIZE(gs));
+      memcpy(result[i], gs, VARSIZE(gs));
     }
   }
   SPI_finish();
+  pfree(values); pfree(array);
 
-  if (isNull)
+  if (ROUTE_CACHE_WAYS_OID == InvalidOid)
+    ROUTE_CACHE_WAYS_OID = get_relname_relid("ways", PG_PUBLIC_NAMESPACE);
+  for (int j = 0; j < nmissing; j++)
+  {
+    int i = missing[j];
+    if (! result[i] || ! ensure_not_empty(result[i]))
+    {
+      if (! result[i])
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "Cannot get the geometry for route %ld", rids[i]);
+      for (int k = 0; k < count; k++)
+        if (result[k])
+          pfree(result[k]);
+      pfree(result); pfree(missing);
+      return NULL;
+    }
+    /* The length is read when needed by route_length() */
+    route_cache_add(rids[i], result[i], -1.0);
+  }
+  pfree(missing);
+  return result;
+}
+
+/**
+ * @brief Return in the last arguments the end points and the length of all
+ * the routes of the ways table, which are used to build the graph of the
+ * route network
+ * @param[out] rids Route identifiers
+ * @param[out] ends Coordinates X1, Y1, X2, Y2 of the start and end points of
+ * each route
+ * @param[out] lengths Route lengths
+ * @param[out] count Number of routes
+ * @return On error return false
+ */
+bool
+route_network_read(int64 **rids, double **ends, double **lengths, int *count)
+{
+  int n = 0;
+  SPI_connect();
+  int ret = SPI_execute(
+    "SELECT gid, ST_X(ST_StartPoint(the_geom)), ST_Y(ST_StartPoint(the_geom)), "
+    "ST_X(ST_EndPoint(the_geom)), ST_Y(ST_EndPoint(the_geom)), "
+    "COALESCE(length, ST_Length(the_geom)) FROM public.ways "
+    "WHERE the_geom IS NOT NULL", true, 0);
+  if (ret == SPI_OK_SELECT && SPI_tuptable != NULL && SPI_processed > 0)
+  {
+    SPITupleTable *tuptable = SPI_tuptable;
+    /* Must allocate this in upper executor context to keep it alive after
+     * SPI_finish() */
+    *rids = SPI_palloc(sizeof(int64) * SPI_processed);
+    *ends = SPI_palloc(sizeof(double) * SPI_processed * 4);
+    *lengths = SPI_palloc(sizeof(double) * SPI_processed);
+    for (uint64 k = 0; k < SPI_processed; k++)
+    {
+      bool isNull;
+      (*rids)[n] = DatumGetInt64(SPI_getbinval(tuptable->vals[k],
+        tuptable->tupdesc, 1, &isNull));
+      bool valid = true;
+      for (int j = 0; j < 5; j++)
+      {
+        Datum value = SPI_getbinval(tuptable->vals[k], tuptable->tupdesc,
+          j + 2, &isNull);
+        if (isNull)
+        {
+          valid = false;
+          break;
+        }
+        if (j < 4)
+          (*ends)[4 * n + j] = DatumGetFloat8(value);
+        else
+          (*lengths)[n] = DatumGetFloat8(value);
+      }
+      /* Empty geometries have NULL end points */
+      if (valid)
+        n++;
+    }
+  }
+  SPI_finish();
+  if (n == 0)
   {
     meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-      "Cannot get the geometry for route %ld", rid);
-    return NULL;
+      "Cannot read the routes of the ways table");
+    return false;
   }
+  /* Register the relcache callback that also flushes the graph built from
+   * the routes */
+  route_cache_init();
+  if (ROUTE_CACHE_WAYS_OID == InvalidOid)
+    ROUTE_CACHE_WAYS_OID = get_relname_relid("ways", PG_PUBLIC_NAMESPACE);
+  *count = n;
+  return true;
+}
 
-  if (! ensure_not_empty(result))
+/**
+ * @brief Return in the last arguments the identifiers and the geometries of
+ * all the routes of the ways table, which are used to build the index of the
+ * route geometries
+ * @param[out] rids Route identifiers
+ * @param[out] geoms Route geometries
+ * @param[out] count Number of routes
+ * @return On error return false
+ */
+bool
+route_geoms_read(int64 **rids, GSERIALIZED ***geoms, int *count)
+{
+  int n = 0;
+  SPI_connect();
+  int ret = SPI_execute("SELECT gid, the_geom FROM public.ways "
+    "WHERE the_geom IS NOT NULL", true, 0);
+  if (ret == SPI_OK_SELECT && SPI_tuptable != NULL && SPI_processed > 0)
   {
-    pfree(result);
-    return NULL;
+    SPITupleTable *tuptable = SPI_tuptable;
+    /* Must allocate this in upper executor context to keep it alive after
+     * SPI_finish() */
+    *rids = SPI_palloc(sizeof(int64) * SPI_processed);
+    *geoms = SPI_palloc(sizeof(GSERIALIZED *) * SPI_processed);
+    for (uint64 k = 0; k < SPI_processed; k++)
+    {
+      bool isNull;
+      int64 rid = DatumGetInt64(SPI_getbinval(tuptable->vals[k],
+        tuptable->tupdesc, 1, &isNull));
+      Datum line = SPI_getbinval(tuptable->vals[k], tuptable->tupdesc, 2,
+        &isNull);
+      if (isNull)
+        continue;
+      GSERIALIZED *gs = (GSERIALIZED *) PG_DETOAST_DATUM(line);
+      (*geoms)[n] = (GSERIALIZED *) SPI_palloc(VARSIZE(gs));
+      memcpy((*geoms)[n], gs, VARSIZE(gs));
+      (*rids)[n++] = rid;
+    }
   }
+  SPI_finish();
+  if (n == 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Cannot read the routes of the ways table");
+    return false;
+  }
+  /* Register the relcache callback that also flushes the index built from
+   * the routes */
+  route_cache_init();
+  if (ROUTE_CACHE_WAYS_OID == InvalidOid)
+    ROUTE_CACHE_WAYS_OID = get_relname_relid("ways", PG_PUBLIC_NAMESPACE);
+  *count = n;
+  return true;
+}
 
-  return result;
+/**
+ * @brief Return the last argument initialized with the spatial bounding box
+ * of the route geometry from the corresponding route identifier
+ * @return On error return false
+ */
+bool
+route_set_stbox(int64 rid, STBox *box)
+{
+  const RouteCacheSlot *rs = route_cache_fetch(rid);
+  if (! rs)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Cannot get the geometry for route %ld", rid);
+    return false;
+  }
+  memcpy(box, &rs->box, sizeof(STBox));
+  return true;
+}
+
+/**
+ * @brief Return the SRID of the route geometry from the corresponding route
+ * identifier
+ * @return On error return SRID_INVALID
+ */
+int32_t
+route_srid(int64 rid)
+{
+  const RouteCacheSlot *rs = route_cache_fetch(rid);
+  if (! rs)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Cannot get the geometry for route %ld", rid);
+    return SRID_INVALID;
+  }
+  return gserialized_get_srid(rs->geom);
 }
 
+#endif /* ! MEOS */
+
 #if 0 /* not used */
 /**
  * @brief Access the edge table to get the rid from a geometry
@@ -610,6 +1315,7 @@ npoint_geom(const Npoint *np)
   return result;
 }
 
+#if ! MEOS
 /**
  * @brief Transform a geometry into a network point
  */
@@ -661,6 +1367,8 @@ geom_npoint(const GSERIALIZED *gs)
   return result;
 }
 
+#endif /* ! MEOS */
+
 /**
  * @brief Transform a network segment into a geometry
  */
@@ -752,10 +1460,7 @@ geom_nsegment(const GSERIALIZED *gs)
 int
 npoint_srid(const Npoint *np)
 {
-  GSERIALIZED *line = route_geom(np->rid);
-  int result = gserialized_get_srid(line);
-  pfree(line);
-  return result;
+  return route_srid(np->rid);
 }
 
 /**
@@ -764,10 +1469,7 @@ npoint_srid(const Npoint *np)
 int
 nsegment_srid(const Nsegment *ns)
 {
-  GSERIALIZED *line = route_geom(ns->rid);
-  int result = gserialized_get_srid(line);
-  pfree(line);
-  return result;
+  return route_srid(ns->rid);
 }
 
 /*****************************************************************************
@@ -966,7 +1668,7 @@ npoint_hash(const Npoint *np)
 }
 
 /**
- * @brief Return the 32-bit hash value of a network point
+ * @brief Return the 64-bit hash value of a network point using a seed
  */
 uint64
 npoint_hash_extended(const Npoint *np, uint64 seed)
@@ -977,7 +1679,7 @@ npoint_hash_extended(const Npoint *np, uint64 seed)
 
   /* Merge hashes of value and position */
   uint64 result = rid_hash;
-  result = (result << 1) | (result >> 31);
+  result = ROTATE_HIGH_AND_LOW_32BITS(result);
   result ^= pos_hash;
   return result;
 }
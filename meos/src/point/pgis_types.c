@@ -38,17 +38,25 @@
 /* C */
 #include <assert.h>
 #include <float.h>
+#include <stdlib.h>
+#include <string.h>
 /* GEOS */
 #include <geos_c.h>
 /* PostgreSQL */
 #if POSTGRESQL_VERSION_NUMBER >= 160000
   #include "varatt.h"
 #endif
+#if ! MEOS
+  #include <utils/memutils.h>
+#endif /* ! MEOS */
 /* PostGIS */
 #include <liblwgeom.h>
+#include <lwgeodetic_tree.h>
 #include <lwgeom_log.h>
 #include <lwgeom_geos.h>
 /* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
 #include "point/tpoint.h"
 #include "point/tpoint_spatialfuncs.h"
 
@@ -649,6 +657,7 @@ POSTGIS2GEOS(const GSERIALIZED *gs)
   }
   result = LWGEOM2GEOS(lwgeom, 0);
   lwgeom_free(lwgeom);
+  MEOS_STAT_ADD(MEOS_STAT_GEOS_CONVERSIONS, 1);
   return result;
 }
 
@@ -667,9 +676,162 @@ GEOS2POSTGIS(GEOSGeom geom, char want3d)
     lwgeom_add_bbox(lwgeom);
   GSERIALIZED *result = geo_serialize(lwgeom);
   lwgeom_free(lwgeom);
+  MEOS_STAT_ADD(MEOS_STAT_GEOS_CONVERSIONS, 1);
   return result;
 }
 
+/*****************************************************************************
+ * Cache of the prepared geometry of a constant argument
+ *****************************************************************************/
+
+/**
+ * @brief Structure to keep the GEOS geometry and the prepared geometry of the
+ * argument that remains constant across consecutive calls of a function, as
+ * in queries comparing many temporal points against the same geometry
+ * @details As in PostGIS, the arguments of the last call are kept and a
+ * geometry is prepared the second time it is passed at the same position.
+ * The structure is allocated with @p malloc since it survives the calls.
+ */
+typedef struct
+{
+  GSERIALIZED *gs[2];        /**< Arguments of the last call */
+  int argnum;                /**< Argument prepared, 0 if none */
+  GEOSGeometry *geom;        /**< GEOS geometry of the argument prepared */
+  const GEOSPreparedGeometry *prepgeom; /**< Prepared geometry of the same */
+} PrepGeomCache;
+
+static MEOS_THREAD_LOCAL PrepGeomCache _PREP_GEOM_CACHE = {{NULL, NULL}, 0, NULL, NULL};
+
+/**
+ * @brief Return true if a geometry is equal to the one kept by the cache at
+ * a position
+ */
+static bool
+prep_geom_cache_eq(int i, const GSERIALIZED *gs)
+{
+  const GSERIALIZED *key = _PREP_GEOM_CACHE.gs[i];
+  return key && VARSIZE(key) == VARSIZE(gs) &&
+    memcmp(key, gs, VARSIZE(gs)) == 0;
+}
+
+/**
+ * @brief Destroy the prepared geometry of the cache
+ */
+static void
+prep_geom_cache_clear(void)
+{
+  if (_PREP_GEOM_CACHE.prepgeom)
+    GEOSPreparedGeom_destroy(_PREP_GEOM_CACHE.prepgeom);
+  if (_PREP_GEOM_CACHE.geom)
+    GEOSGeom_destroy(_PREP_GEOM_CACHE.geom);
+  _PREP_GEOM_CACHE.prepgeom = NULL;
+  _PREP_GEOM_CACHE.geom = NULL;
+  _PREP_GEOM_CACHE.argnum = 0;
+  return;
+}
+
+/**
+ * @brief Return the prepared geometry of one of the two arguments of a
+ * function if it is the same as in the previous call, @p NULL otherwise
+ * @param[in] gs1,gs2 Geometries
+ * @param[out] argnum Argument prepared, either 1 or 2
+ * @note The function must be called after @p initGEOS
+ */
+static const GEOSPreparedGeometry *
+prep_geom_cache_get(const GSERIALIZED *gs1, const GSERIALIZED *gs2,
+  int *argnum)
+{
+  const GSERIALIZED *gs[2] = {gs1, gs2};
+  /* The prepared argument is the same */
+  if (_PREP_GEOM_CACHE.argnum &&
+      prep_geom_cache_eq(_PREP_GEOM_CACHE.argnum - 1,
+        gs[_PREP_GEOM_CACHE.argnum - 1]))
+  {
+    *argnum = _PREP_GEOM_CACHE.argnum;
+    return _PREP_GEOM_CACHE.prepgeom;
+  }
+  /* An argument is repeated, prepare it */
+  prep_geom_cache_clear();
+  for (int i = 0; i < 2; i++)
+  {
+    if (prep_geom_cache_eq(i, gs[i]))
+    {
+      _PREP_GEOM_CACHE.geom = POSTGIS2GEOS(gs[i]);
+      if (! _PREP_GEOM_CACHE.geom)
+        return NULL;
+      _PREP_GEOM_CACHE.prepgeom = GEOSPrepare(_PREP_GEOM_CACHE.geom);
+      if (! _PREP_GEOM_CACHE.prepgeom)
+      {
+        GEOSGeom_destroy(_PREP_GEOM_CACHE.geom);
+        _PREP_GEOM_CACHE.geom = NULL;
+        return NULL;
+      }
+      _PREP_GEOM_CACHE.argnum = *argnum = i + 1;
+      return _PREP_GEOM_CACHE.prepgeom;
+    }
+  }
+  /* No argument is repeated, keep the arguments for the next call */
+  for (int i = 0; i < 2; i++)
+  {
+    free(_PREP_GEOM_CACHE.gs[i]);
+    _PREP_GEOM_CACHE.gs[i] = malloc(VARSIZE(gs[i]));
+    memcpy(_PREP_GEOM_CACHE.gs[i], gs[i], VARSIZE(gs[i]));
+  }
+  return NULL;
+}
+
+/**
+ * @brief Return true if two geometries satisfy a spatial relationship using
+ * the prepared geometry of one of them
+ * @param[in] gs1,gs2 Geometries
+ * @param[in] rel Spatial relationship
+ * @param[out] result Result
+ * @return Return false if no argument is prepared, in which case the result
+ * must be computed without prepared geometry
+ */
+static bool
+prep_geom_spatialrel(const GSERIALIZED *gs1, const GSERIALIZED *gs2,
+  spatialRel rel, bool *result)
+{
+  initGEOS(lwnotice, lwgeom_geos_error);
+  int argnum;
+  const GEOSPreparedGeometry *prepgeom = prep_geom_cache_get(gs1, gs2,
+    &argnum);
+  if (! prepgeom)
+    return false;
+
+  GEOSGeometry *geom = POSTGIS2GEOS(argnum == 1 ? gs2 : gs1);
+  if (! geom)
+    return false;
+  char res;
+  switch (rel)
+  {
+    case INTERSECTS:
+      res = GEOSPreparedIntersects(prepgeom, geom);
+      break;
+    case TOUCHES:
+      res = GEOSPreparedTouches(prepgeom, geom);
+      break;
+    case CONTAINS:
+      res = (argnum == 1) ? GEOSPreparedContains(prepgeom, geom) :
+        GEOSPreparedWithin(prepgeom, geom);
+      break;
+    default: /* COVERS */
+      res = (argnum == 1) ? GEOSPreparedCovers(prepgeom, geom) :
+        GEOSPreparedCoveredBy(prepgeom, geom);
+  }
+  GEOSGeom_destroy(geom);
+  if (res == 2)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_TYPE_ERROR, "GEOS returned error");
+    return false;
+  }
+  *result = (bool) res;
+  return true;
+}
+
+/*****************************************************************************/
+
 /**
  * @brief Transform two @p GSERIALIZED geometries into @p GEOSGeometry and
  * call the GEOS function passed as argument
@@ -752,6 +914,9 @@ geometry_spatialrel(const GSERIALIZED *gs1, const GSERIALIZED *gs2,
   /* Call GEOS function */
   assert(rel == INTERSECTS || rel == CONTAINS || rel == TOUCHES ||
     rel == COVERS);
+  bool result;
+  if (prep_geom_spatialrel(gs1, gs2, rel, &result))
+    return result;
   switch (rel)
   {
     case INTERSECTS:
@@ -828,6 +993,43 @@ GSERIALIZED *
 geometry_intersection(const GSERIALIZED *gs1, const GSERIALIZED *gs2)
 {
   GSERIALIZED *result;
+  /* When one argument is prepared, the disjoint case is detected without
+   * computing the intersection, otherwise the GEOS geometry of the prepared
+   * argument is reused */
+  if (! gserialized_is_empty(gs1) && ! gserialized_is_empty(gs2))
+  {
+    initGEOS(lwnotice, lwgeom_geos_error);
+    int argnum;
+    const GEOSPreparedGeometry *prepgeom = prep_geom_cache_get(gs1, gs2,
+      &argnum);
+    GEOSGeometry *geom = prepgeom ? POSTGIS2GEOS(argnum == 1 ? gs2 : gs1) :
+      NULL;
+    if (geom)
+    {
+      int32_t srid = gserialized_get_srid(gs1);
+      bool hasz = gserialized_has_z(gs1) && gserialized_has_z(gs2);
+      char inter = GEOSPreparedIntersects(prepgeom, geom);
+      GEOSGeometry *geomres = NULL;
+      if (inter == 1)
+        /* Keep the order of the arguments for the result */
+        geomres = (argnum == 1) ?
+          GEOSIntersection(_PREP_GEOM_CACHE.geom, geom) :
+          GEOSIntersection(geom, _PREP_GEOM_CACHE.geom);
+      GEOSGeom_destroy(geom);
+      if (inter == 0)
+        return geo_serialize(lwgeom_construct_empty(COLLECTIONTYPE, srid,
+          hasz, 0));
+      if (geomres)
+      {
+        GEOSSetSRID(geomres, srid);
+        result = GEOS2POSTGIS(geomres, hasz);
+        GEOSGeom_destroy(geomres);
+        return result;
+      }
+      /* Otherwise fall back to the computation below */
+    }
+  }
+
   LWGEOM *geom1, *geom2, *lwresult;
   double prec = -1;
   geom1 = lwgeom_from_gserialized(gs1);
@@ -1391,6 +1593,230 @@ pgis_geography_length(const GSERIALIZED *gs, bool use_spheroid)
   return length;
 }
 
+/*****************************************************************************
+ * Geography tree cache
+ *****************************************************************************/
+
+/* Functions not exported by PostGIS */
+extern int gbox_pt_outside(const GBOX *gbox, POINT2D *pt_outside);
+extern int gbox_contains_point3d(const GBOX *gbox, const POINT3D *pt);
+
+/**
+ * @brief Number of geographies whose circular tree is kept in the cache
+ * @details Two slots are enough for a constant geography argument and the
+ * trajectory of the temporal point it is compared with
+ */
+#define GEOG_TREE_CACHE_SIZE 2
+
+/**
+ * @brief Circular tree of a geography
+ */
+typedef struct
+{
+  LWGEOM *geom;        /**< Geometry whose point arrays the tree references */
+  CIRC_NODE *tree;     /**< Circular tree of the geometry */
+  bool polygonal;      /**< True when the geometry is a (multi)polygon */
+  GBOX gbox;           /**< Geodetic box, only set for (multi)polygons */
+} GeogTree;
+
+/**
+ * @brief Entry of the geography tree cache
+ */
+typedef struct
+{
+#if ! MEOS
+  MemoryContext cxt;   /**< Context holding the entry */
+#endif /* ! MEOS */
+  GSERIALIZED *gs;     /**< Copy of the geography, NULL if the slot is free */
+  GeogTree gtree;      /**< Circular tree of the geography */
+  int lastuse;         /**< Clock value at the last use of the entry */
+} GeogTreeCacheEntry;
+
+static MEOS_THREAD_LOCAL GeogTreeCacheEntry GEOG_TREE_CACHE[GEOG_TREE_CACHE_SIZE];
+static MEOS_THREAD_LOCAL int GEOG_TREE_CLOCK = 0;
+
+/**
+ * @brief Build the circular tree of a geography
+ * @note The geometry must outlive the tree since the leaves of the tree point
+ * to its point arrays
+ */
+static void
+geog_tree_make(LWGEOM *geom, const GSERIALIZED *gs, GeogTree *result)
+{
+  result->geom = geom;
+  result->tree = lwgeom_calculate_circ_tree(geom);
+  result->polygonal = (geom->type == POLYGONTYPE ||
+    geom->type == MULTIPOLYGONTYPE);
+  /* A box is needed to compute a point outside of the polygon */
+  if (result->polygonal &&
+      gserialized_get_gbox_p(gs, &result->gbox) == LW_FAILURE)
+    lwgeom_calculate_gbox_geodetic(geom, &result->gbox);
+  return;
+}
+
+/**
+ * @brief Free the slot of the geography tree cache
+ */
+static void
+geog_tree_cache_free(GeogTreeCacheEntry *entry)
+{
+#if MEOS
+  if (entry->gtree.tree)
+    circ_tree_free(entry->gtree.tree);
+  if (entry->gtree.geom)
+    lwgeom_free(entry->gtree.geom);
+  if (entry->gs)
+    pfree(entry->gs);
+#else
+  if (entry->cxt)
+    MemoryContextDelete(entry->cxt);
+  entry->cxt = NULL;
+#endif /* MEOS */
+  entry->gs = NULL;
+  memset(&entry->gtree, 0, sizeof(GeogTree));
+  entry->lastuse = 0;
+  return;
+}
+
+/**
+ * @brief Return the circular tree of a geography, reusing the one built in a
+ * previous call if the geography has the same content
+ * @details Computing the distance between a constant geography and the
+ * trajectories of many temporal points, or between many geographies and the
+ * same trajectory, rebuilds the same circular tree in every call, which is
+ * the dominant cost for large geographies. As for the geography cache of
+ * PostGIS, the trees of the last geographies are kept across calls. Their
+ * memory is allocated in a context that survives the memory context of the
+ * call, and the least recently used entry is evicted.
+ * @note The result is owned by the cache and must not be freed
+ */
+static const GeogTree *
+geog_tree_cache_get(const GSERIALIZED *gs)
+{
+  size_t size = VARSIZE(gs);
+  int victim = 0;
+  for (int i = 0; i < GEOG_TREE_CACHE_SIZE; i++)
+  {
+    GeogTreeCacheEntry *entry = &GEOG_TREE_CACHE[i];
+    if (entry->gs && VARSIZE(entry->gs) == size &&
+        memcmp(entry->gs, gs, size) == 0)
+    {
+      entry->lastuse = ++GEOG_TREE_CLOCK;
+      return &entry->gtree;
+    }
+    if (entry->lastuse < GEOG_TREE_CACHE[victim].lastuse)
+      victim = i;
+  }
+
+  GeogTreeCacheEntry *entry = &GEOG_TREE_CACHE[victim];
+  geog_tree_cache_free(entry);
+#if ! MEOS
+  entry->cxt = AllocSetContextCreate(CacheMemoryContext,
+    "MobilityDB geography tree", ALLOCSET_SMALL_SIZES);
+  MemoryContext oldcxt = MemoryContextSwitchTo(entry->cxt);
+#endif /* ! MEOS */
+  GSERIALIZED *copy = palloc(size);
+  memcpy(copy, gs, size);
+  geog_tree_make(lwgeom_from_gserialized(copy), copy, &entry->gtree);
+#if ! MEOS
+  MemoryContextSwitchTo(oldcxt);
+#endif /* ! MEOS */
+  /* Only publish the entry once it is complete */
+  entry->gs = copy;
+  entry->lastuse = ++GEOG_TREE_CLOCK;
+  return &entry->gtree;
+}
+
+/**
+ * @brief Return true if a point is strictly inside the polygonal geography
+ * of a circular tree
+ * @note PostGIS function: @p CircTreePIP(tree1, g1, in_point)
+ */
+static bool
+geog_tree_pip(const GeogTree *gtree, const POINT4D *in_point)
+{
+  if (! gtree->polygonal)
+    return false;
+
+  /* If the candidate is not in the box, it is not in the polygon */
+  GEOGRAPHIC_POINT in_gpoint;
+  POINT3D in_point3d;
+  geographic_point_init(in_point->x, in_point->y, &in_gpoint);
+  geog2cart(&in_gpoint, &in_point3d);
+  if (! gbox_contains_point3d(&gtree->gbox, &in_point3d))
+    return false;
+
+  /* Compute a definitive outside point and test for strict containment */
+  POINT2D pt2d_inside, pt2d_outside;
+  pt2d_inside.x = in_point->x;
+  pt2d_inside.y = in_point->y;
+  if (gbox_pt_outside(&gtree->gbox, &pt2d_outside) == LW_FAILURE &&
+      circ_tree_get_point_outside(gtree->tree, &pt2d_outside) == LW_FAILURE)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Unable to generate a point outside of a geography");
+    return false;
+  }
+  return circ_tree_contains_point(gtree->tree, &pt2d_inside, &pt2d_outside,
+    0, NULL);
+}
+
+/**
+ * @brief Return the distance between two geographies that are not both
+ * points using their circular trees
+ * @details The trees of non-point geographies are taken from the geography
+ * tree cache while the trees of points, which are trivial to build, are
+ * built on the fly so that they do not evict the cached ones.
+ * @param[in] gs1,gs2 Geographies
+ * @param[in] s Spheroid
+ * @param[in] tolerance Distance below which the computation stops
+ * @note PostGIS function: @p geography_tree_distance(g1, g2, s, tolerance,
+ * distance)
+ */
+static double
+geog_tree_distance(const GSERIALIZED *gs1, const GSERIALIZED *gs2,
+  const SPHEROID *s, double tolerance)
+{
+  const GSERIALIZED *gs[2] = {gs1, gs2};
+  const GeogTree *gtrees[2];
+  GeogTree local[2];
+  bool islocal[2];
+  for (int i = 0; i < 2; i++)
+  {
+    islocal[i] = (gserialized_get_type(gs[i]) == POINTTYPE);
+    if (islocal[i])
+    {
+      geog_tree_make(lwgeom_from_gserialized(gs[i]), gs[i], &local[i]);
+      gtrees[i] = &local[i];
+    }
+    else
+      gtrees[i] = geog_tree_cache_get(gs[i]);
+  }
+
+  /* If one is a polygon containing the other the distance is zero */
+  double result;
+  POINT4D pt1, pt2;
+  lwgeom_startpoint(gtrees[0]->geom, &pt1);
+  lwgeom_startpoint(gtrees[1]->geom, &pt2);
+  if (geog_tree_pip(gtrees[0], &pt2) || geog_tree_pip(gtrees[1], &pt1))
+    result = 0.0;
+  else
+    result = circ_tree_distance_tree(gtrees[0]->tree, gtrees[1]->tree, s,
+      tolerance);
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (islocal[i])
+    {
+      circ_tree_free(local[i].tree);
+      lwgeom_free(local[i].geom);
+    }
+  }
+  return result;
+}
+
+/*****************************************************************************/
+
 /**
  * @brief Return true if two geographies are within a distance
  * @note PostGIS function: @p geography_dwithin_uncached(PG_FUNCTION_ARGS)
@@ -1417,13 +1843,19 @@ pgis_geography_dwithin(const GSERIALIZED *gs1, GSERIALIZED *gs2, double toleranc
   if (! use_spheroid)
     s.a = s.b = s.radius;
 
-  LWGEOM *lwgeom1 = lwgeom_from_gserialized(gs1);
-  LWGEOM *lwgeom2 = lwgeom_from_gserialized(gs2);
-  double distance = lwgeom_distance_spheroid(lwgeom1, lwgeom2, &s, tolerance);
-
-  /* Clean up */
-  lwgeom_free(lwgeom1);
-  lwgeom_free(lwgeom2);
+  double distance;
+  if (gserialized_get_type(gs1) != POINTTYPE ||
+      gserialized_get_type(gs2) != POINTTYPE)
+    distance = geog_tree_distance(gs1, gs2, &s, tolerance);
+  else
+  {
+    LWGEOM *lwgeom1 = lwgeom_from_gserialized(gs1);
+    LWGEOM *lwgeom2 = lwgeom_from_gserialized(gs2);
+    distance = lwgeom_distance_spheroid(lwgeom1, lwgeom2, &s, tolerance);
+    /* Clean up */
+    lwgeom_free(lwgeom1);
+    lwgeom_free(lwgeom2);
+  }
 
   /* Something went wrong... should already be eloged, return FALSE */
   if (distance < 0.0)
@@ -1469,18 +1901,19 @@ pgis_geography_distance(const GSERIALIZED *gs1, const GSERIALIZED *gs2)
   if (!  use_spheroid )
     s.a = s.b = s.radius;
 
-  LWGEOM *lwgeom1 = lwgeom_from_gserialized(gs1);
-  LWGEOM *lwgeom2 = lwgeom_from_gserialized(gs2);
-
-  /* Make sure we have boxes attached */
-  lwgeom_add_bbox_deep(lwgeom1, NULL);
-  lwgeom_add_bbox_deep(lwgeom2, NULL);
-
-  double distance = lwgeom_distance_spheroid(lwgeom1, lwgeom2, &s, tolerance);
-
-  /* Clean up */
-  lwgeom_free(lwgeom1);
-  lwgeom_free(lwgeom2);
+  double distance;
+  if (gserialized_get_type(gs1) != POINTTYPE ||
+      gserialized_get_type(gs2) != POINTTYPE)
+    distance = geog_tree_distance(gs1, gs2, &s, tolerance);
+  else
+  {
+    LWGEOM *lwgeom1 = lwgeom_from_gserialized(gs1);
+    LWGEOM *lwgeom2 = lwgeom_from_gserialized(gs2);
+    distance = lwgeom_distance_spheroid(lwgeom1, lwgeom2, &s, tolerance);
+    /* Clean up */
+    lwgeom_free(lwgeom1);
+    lwgeom_free(lwgeom2);
+  }
 
   /* Something went wrong, negative return... should already be eloged, return NULL */
   if ( distance < 0.0 )
@@ -1912,7 +2345,7 @@ geo_as_hexewkb(const GSERIALIZED *gs, const char *endian)
   /* Create WKB hex string */
   LWGEOM *geom = lwgeom_from_gserialized(gs);
   lwvarlena_t *hexwkb = lwgeom_to_hexwkb_varlena(geom, variant | WKB_EXTENDED);
-  char *result = strdup(VARDATA(hexwkb));
+  char *result = pstrdup(VARDATA(hexwkb));
   pfree(hexwkb);
   return result;
 }
@@ -2079,6 +2079,303 @@ stbox_quad_split(const STBox *box, int *count)
   return result;
 }
 
+/*****************************************************************************
+ * Balanced split
+ *****************************************************************************/
+
+/* Dimensions of the balanced split */
+#define KD_DIMS 4
+#define KD_T 3
+
+/**
+ * @brief Center of a box and its weight in the balanced split
+ */
+typedef struct
+{
+  double c[KD_DIMS];
+  double w;
+} KDPoint;
+
+/**
+ * @brief Region of the balanced split, the time dimension is expressed in
+ * microseconds
+ */
+typedef struct
+{
+  double min[KD_DIMS];
+  double max[KD_DIMS];
+  bool lower_inc;
+  bool upper_inc;
+} KDRegion;
+
+/**
+ * @brief State of the balanced split
+ */
+typedef struct
+{
+  bool hasz;
+  bool hast;
+  int32 srid;
+  double scale[KD_DIMS];
+  STBox *result;
+  int count;
+} KDState;
+
+static int
+kdpoint_cmp_x(const void *a, const void *b)
+{
+  double c1 = ((const KDPoint *) a)->c[0], c2 = ((const KDPoint *) b)->c[0];
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+static int
+kdpoint_cmp_y(const void *a, const void *b)
+{
+  double c1 = ((const KDPoint *) a)->c[1], c2 = ((const KDPoint *) b)->c[1];
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+static int
+kdpoint_cmp_z(const void *a, const void *b)
+{
+  double c1 = ((const KDPoint *) a)->c[2], c2 = ((const KDPoint *) b)->c[2];
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+static int
+kdpoint_cmp_t(const void *a, const void *b)
+{
+  double c1 = ((const KDPoint *) a)->c[3], c2 = ((const KDPoint *) b)->c[3];
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+/**
+ * @brief Output a region of the balanced split as a spatiotemporal box
+ */
+static void
+kdregion_emit(KDState *state, const KDRegion *region)
+{
+  Span period;
+  if (state->hast)
+    span_set(TimestampTzGetDatum((TimestampTz) region->min[KD_T]),
+      TimestampTzGetDatum((TimestampTz) region->max[KD_T]), region->lower_inc,
+      region->upper_inc, T_TIMESTAMPTZ, T_TSTZSPAN, &period);
+  stbox_set(true, state->hasz, false, state->srid, region->min[0],
+    region->max[0], region->min[1], region->max[1], region->min[2],
+    region->max[2], state->hast ? &period : NULL,
+    &state->result[state->count++]);
+  return;
+}
+
+/**
+ * @brief Split a region into k regions with the same weight of points
+ * @details The region is split in the dimension with the largest normalized
+ * spread of the points at the weighted quantile k/2 over k
+ */
+static void
+kdregion_split(KDState *state, KDPoint *points, int count, KDRegion *region,
+  int k)
+{
+  if (k <= 1)
+  {
+    kdregion_emit(state, region);
+    return;
+  }
+
+  /* Choose the dimension with the largest spread of the points or, if all
+   * points are equal, the largest extent of the region */
+  int dim = -1, rdim = -1;
+  double maxspread = 0.0, maxwidth = 0.0;
+  for (int d = 0; d < KD_DIMS; d++)
+  {
+    if ((d == 2 && ! state->hasz) || (d == KD_T && ! state->hast))
+      continue;
+    double lo = DBL_MAX, hi = -DBL_MAX;
+    for (int i = 0; i < count; i++)
+    {
+      lo = Min(lo, points[i].c[d]);
+      hi = Max(hi, points[i].c[d]);
+    }
+    double spread = (count > 1) ? (hi - lo) / state->scale[d] : 0.0;
+    if (spread > maxspread)
+    {
+      maxspread = spread;
+      dim = d;
+    }
+    double width = (region->max[d] - region->min[d]) / state->scale[d];
+    if (width > maxwidth)
+    {
+      maxwidth = width;
+      rdim = d;
+    }
+  }
+
+  int k1 = k / 2;
+  int m;
+  double value;
+  if (dim >= 0)
+  {
+    static int (*cmp[KD_DIMS])(const void *, const void *) =
+      {&kdpoint_cmp_x, &kdpoint_cmp_y, &kdpoint_cmp_z, &kdpoint_cmp_t};
+    qsort(points, (size_t) count, sizeof(KDPoint), cmp[dim]);
+    double total = 0.0;
+    for (int i = 0; i < count; i++)
+      total += points[i].w;
+    /* Find the weighted quantile and move it between two distinct values */
+    double target = total * k1 / k, acc = 0.0;
+    for (m = 0; m < count - 1; m++)
+    {
+      acc += points[m].w;
+      if (acc >= target)
+        break;
+    }
+    m = Max(1, Min(m + 1, count - 1));
+    int m1 = m;
+    while (m1 < count && points[m1 - 1].c[dim] == points[m1].c[dim])
+      m1++;
+    if (m1 == count)
+    {
+      m1 = m;
+      while (m1 > 1 && points[m1 - 1].c[dim] == points[m1].c[dim])
+        m1--;
+    }
+    m = m1;
+    value = (points[m - 1].c[dim] + points[m].c[dim]) / 2.0;
+  }
+  else if (rdim >= 0)
+  {
+    /* All points are equal, split the region proportionally */
+    dim = rdim;
+    value = region->min[dim] + (region->max[dim] - region->min[dim]) * k1 / k;
+    m = 0;
+    for (int i = 0; i < count; i++)
+    {
+      if (points[i].c[dim] < value)
+      {
+        KDPoint swap = points[m];
+        points[m++] = points[i];
+        points[i] = swap;
+      }
+    }
+  }
+  else
+  {
+    /* The region cannot be split further */
+    kdregion_emit(state, region);
+    return;
+  }
+  if (dim == KD_T)
+    value = floor(value);
+  if (value <= region->min[dim] || value >= region->max[dim])
+  {
+    kdregion_emit(state, region);
+    return;
+  }
+
+  /* The lower region excludes the split instant */
+  KDRegion left = *region, right = *region;
+  left.max[dim] = right.min[dim] = value;
+  if (dim == KD_T)
+  {
+    left.upper_inc = false;
+    right.lower_inc = true;
+  }
+  kdregion_split(state, points, m, &left, k1);
+  kdregion_split(state, points + m, count - m, &right, k - k1);
+  return;
+}
+
+/**
+ * @ingroup meos_box_transf
+ * @brief Return at most k spatiotemporal boxes partitioning the extent of an
+ * array of boxes such that each partition has the same weight of boxes
+ * @details The extent is recursively split as a KD-tree on the weighted
+ * quantiles of the centers of the boxes, in the dimension with the largest
+ * spread of the centers relative to the extent. The Z and the time
+ * dimensions are only considered when all boxes have them. Adjacent
+ * partitions share their spatial bounds while their periods are disjoint.
+ * Fewer than k partitions are returned when the centers cannot be
+ * further separated.
+ * @param[in] boxes Spatiotemporal boxes, for example from a sample of a
+ * table
+ * @param[in] weights Weights of the boxes, may be @p NULL for unit weights
+ * @param[in] count Number of boxes
+ * @param[in] k Number of partitions
+ * @param[out] newcount Number of elements in the output array
+ * @csqlfn #Stboxarr_balanced_partitions()
+ */
+STBox *
+stboxarr_balanced_split(const STBox *boxes, const double *weights, int count,
+  int k, int *newcount)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) boxes) ||
+      ! ensure_not_null((void *) newcount) || ! ensure_positive(count) ||
+      ! ensure_positive(k))
+    return NULL;
+  bool hasz = true, hast = true;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_has_X_stbox(&boxes[i]) ||
+        ! ensure_not_geodetic(boxes[i].flags) ||
+        ! ensure_same_srid(boxes[0].srid, boxes[i].srid))
+      return NULL;
+    if (! MEOS_FLAGS_GET_Z(boxes[i].flags))
+      hasz = false;
+    if (! MEOS_FLAGS_GET_T(boxes[i].flags))
+      hast = false;
+  }
+
+  /* Compute the centers of the boxes and the extent */
+  KDPoint *points = palloc0(sizeof(KDPoint) * count);
+  KDRegion region;
+  for (int d = 0; d < KD_DIMS; d++)
+  {
+    region.min[d] = DBL_MAX;
+    region.max[d] = -DBL_MAX;
+  }
+  region.lower_inc = region.upper_inc = true;
+  for (int i = 0; i < count; i++)
+  {
+    const STBox *box = &boxes[i];
+    double min[KD_DIMS] = {box->xmin, box->ymin, 0.0, 0.0};
+    double max[KD_DIMS] = {box->xmax, box->ymax, 0.0, 0.0};
+    if (hasz)
+    {
+      min[2] = box->zmin;
+      max[2] = box->zmax;
+    }
+    if (hast)
+    {
+      min[KD_T] = (double) DatumGetTimestampTz(box->period.lower);
+      max[KD_T] = (double) DatumGetTimestampTz(box->period.upper);
+    }
+    for (int d = 0; d < KD_DIMS; d++)
+    {
+      points[i].c[d] = min[d] + (max[d] - min[d]) / 2.0;
+      region.min[d] = Min(region.min[d], min[d]);
+      region.max[d] = Max(region.max[d], max[d]);
+    }
+    points[i].w = weights ? Max(weights[i], 0.0) : 1.0;
+  }
+
+  KDState state;
+  state.hasz = hasz;
+  state.hast = hast;
+  state.srid = boxes[0].srid;
+  for (int d = 0; d < KD_DIMS; d++)
+  {
+    double width = region.max[d] - region.min[d];
+    state.scale[d] = (width > 0) ? width : 1.0;
+  }
+  state.result = palloc(sizeof(STBox) * k);
+  state.count = 0;
+  kdregion_split(&state, points, count, &region, k);
+  pfree(points);
+  *newcount = state.count;
+  return state.result;
+}
+
 /*****************************************************************************
  * Comparison functions for defining B-tree indexes
  *****************************************************************************/
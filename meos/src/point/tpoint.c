@@ -36,6 +36,7 @@
 
 /* C */
 #include <assert.h>
+#include <math.h>
 /* PostgreSQL */
 #if POSTGRESQL_VERSION_NUMBER >= 160000
   #include "varatt.h"
@@ -43,7 +44,9 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/lifting.h"
 #include "general/temporal.h"
+#include "point/tpoint_spatialfuncs.h"
 #include "npoint/tnpoint_boxops.h"
 
 /*****************************************************************************
@@ -167,4 +170,274 @@ tpoint_expand_space(const Temporal *temp, double d)
   return stbox_expand_space(&box, d);
 }
 
+/*****************************************************************************
+ * Quantized storage format
+ *****************************************************************************/
+
+/**
+ * @brief Return the size of the body of a temporal point in the quantized
+ * format
+ */
+static size_t
+tpoint_quantized_size(int count, int ndims, int nseqs)
+{
+  return DOUBLE_PAD(sizeof(TPointQuantized) +
+    (sizeof(TimestampTz) + sizeof(int32) * ndims) * count +
+    (sizeof(int32) + sizeof(uint8)) * nseqs);
+}
+
+/**
+ * @brief Return the body of a temporal point in the quantized format
+ */
+static TPointQuantized *
+tpoint_quantized_body(const Temporal *temp)
+{
+  return (TPointQuantized *) ((char *) temp +
+    temporal_compressed_header_size(temp));
+}
+
+/**
+ * @brief Return true if a temporal point is stored in the quantized format
+ */
+bool
+tpoint_quantized(const Temporal *temp)
+{
+  return tgeo_type(temp->temptype) && temp->subtype != TINSTANT &&
+    MEOS_FLAGS_GET_COMPRESSED(temp->flags) &&
+    tpoint_quantized_body(temp)->format == TPOINT_QUANTIZED_FORMAT;
+}
+
+/**
+ * @brief Return the coordinates of a point
+ */
+static void
+point_coords(Datum point, bool hasz, double *coords)
+{
+  if (hasz)
+  {
+    const POINT3DZ *p = DATUM_POINT3DZ_P(point);
+    coords[0] = p->x; coords[1] = p->y; coords[2] = p->z;
+  }
+  else
+  {
+    const POINT2D *p = DATUM_POINT2D_P(point);
+    coords[0] = p->x; coords[1] = p->y;
+  }
+  return;
+}
+
+/**
+ * @brief Return a point with its coordinates rounded to a grid
+ */
+static Datum
+datum_point_quantize(Datum point, Datum size)
+{
+  const GSERIALIZED *gs = DatumGetGserializedP(point);
+  double scale = DatumGetFloat8(size);
+  bool hasz = (bool) FLAGS_GET_Z(gs->gflags);
+  double coords[3] = {0};
+  point_coords(point, hasz, coords);
+  for (int i = 0; i < 3; i++)
+    coords[i] = (double) llround(coords[i] / scale) * scale;
+  return PointerGetDatum(geopoint_make(coords[0], coords[1], coords[2], hasz,
+    (bool) FLAGS_GET_GEODETIC(gs->gflags), gserialized_get_srid(gs)));
+}
+
+/**
+ * @ingroup meos_internal_temporal_transf
+ * @brief Return a temporal point in the quantized storage format
+ * @details The header and the bounding box of the value are kept unchanged as
+ * in #temporal_compress, while the instants are replaced by the timestamps
+ * and by the coordinates as int32 positions in a grid relative to the
+ * minimum position of the value. The coordinates are rounded to the grid
+ * before computing the header so that the value obtained by
+ * #tpoint_unquantize has the same bounding box.
+ * @param[in] temp Temporal point
+ * @param[in] scale Size of the grid
+ * @return A copy of the temporal value rounded to the grid if it is an
+ * instant. On error return @p NULL
+ * @note The conversion loses the precision of the coordinates beyond the
+ * size of the grid
+ */
+Temporal *
+tpoint_quantize(const Temporal *temp, double scale)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_tgeo_type(temp->temptype) ||
+      ! ensure_positive_datum(Float8GetDatum(scale), T_FLOAT8))
+    return NULL;
+  if (MEOS_FLAGS_GET_COMPRESSED(temp->flags))
+  {
+    Temporal *temp1 = temporal_decompress(temp);
+    Temporal *result = tpoint_quantize(temp1, scale);
+    pfree(temp1);
+    return result;
+  }
+
+  /* Compute the minimum and maximum positions in the grid, the coordinates
+   * of geodetic points are not those of their bounding box */
+  bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
+  int ndims = hasz ? 3 : 2;
+  int count;
+  const TInstant **instants = temporal_insts(temp, &count);
+  int64 origin[3], qmax[3];
+  for (int i = 0; i < count; i++)
+  {
+    double coords[3];
+    point_coords(tinstant_val(instants[i]), hasz, coords);
+    for (int j = 0; j < ndims; j++)
+    {
+      /* Ensure that the positions can be represented exactly */
+      if (fabs(coords[j] / scale) >= (double) ((int64) 1 << 52))
+      {
+        pfree(instants);
+        meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE,
+          "The size of the grid is too small for the coordinates");
+        return NULL;
+      }
+      int64 q = (int64) llround(coords[j] / scale);
+      if (i == 0 || q < origin[j])
+        origin[j] = q;
+      if (i == 0 || q > qmax[j])
+        qmax[j] = q;
+    }
+  }
+  pfree(instants);
+  for (int j = 0; j < ndims; j++)
+  {
+    if (qmax[j] - origin[j] > PG_INT32_MAX)
+    {
+      meos_error(ERROR, MEOS_ERR_VALUE_OUT_OF_RANGE,
+        "The size of the grid is too small for the extent of the value");
+      return NULL;
+    }
+  }
+
+  /* Round the coordinates */
+  LiftedFunctionInfo lfinfo;
+  memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
+  lfinfo.func = (varfunc) &datum_point_quantize;
+  lfinfo.numparam = 1;
+  lfinfo.param[0] = Float8GetDatum(scale);
+  lfinfo.argtype[0] = temp->temptype;
+  lfinfo.restype = temp->temptype;
+  Temporal *rounded = tfunc_temporal(temp, &lfinfo);
+  if (rounded->subtype == TINSTANT)
+    return rounded;
+
+  /* Collect the composing sequences */
+  const TSequence **sequences;
+  int nseqs;
+  if (rounded->subtype == TSEQUENCE)
+  {
+    sequences = palloc(sizeof(TSequence *));
+    sequences[0] = (const TSequence *) rounded;
+    nseqs = 1;
+    count = sequences[0]->count;
+  }
+  else
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) rounded;
+    sequences = palloc(sizeof(TSequence *) * ss->count);
+    for (int i = 0; i < ss->count; i++)
+      sequences[i] = TSEQUENCESET_SEQ_N(ss, i);
+    nseqs = ss->count;
+    count = ss->totalcount;
+  }
+
+  /* Copy the header and fill the body */
+  size_t hdrsize = temporal_compressed_header_size(rounded);
+  size_t memsize = hdrsize + tpoint_quantized_size(count, ndims, nseqs);
+  Temporal *result = palloc0(memsize);
+  memcpy(result, rounded, hdrsize);
+  SET_VARSIZE(result, memsize);
+  if (result->subtype == TSEQUENCE)
+    ((TSequence *) result)->maxcount = ((TSequence *) rounded)->count;
+  else
+    ((TSequenceSet *) result)->maxcount = ((TSequenceSet *) rounded)->count;
+  MEOS_FLAGS_SET_FIXED(result->flags, false);
+  MEOS_FLAGS_SET_COMPRESSED(result->flags, true);
+  TPointQuantized *qt = tpoint_quantized_body(result);
+  qt->format = TPOINT_QUANTIZED_FORMAT;
+  qt->count = count;
+  qt->nseqs = nseqs;
+  qt->ndims = ndims;
+  qt->scale = scale;
+  for (int j = 0; j < ndims; j++)
+    qt->origin[j] = origin[j];
+  TimestampTz *times = (TimestampTz *) (qt + 1);
+  int32 *coords = (int32 *) (times + count);
+  int32 *seqstarts = coords + count * ndims;
+  uint8 *bounds = (uint8 *) (seqstarts + nseqs);
+  int k = 0;
+  for (int i = 0; i < nseqs; i++)
+  {
+    seqstarts[i] = k;
+    bounds[i] = (sequences[i]->period.lower_inc ? 1 : 0) |
+      (sequences[i]->period.upper_inc ? 2 : 0);
+    for (int j = 0; j < sequences[i]->count; j++)
+    {
+      const TInstant *inst = TSEQUENCE_INST_N(sequences[i], j);
+      double values[3];
+      point_coords(tinstant_val(inst), hasz, values);
+      for (int l = 0; l < ndims; l++)
+        coords[k * ndims + l] = (int32) (llround(values[l] / scale) -
+          origin[l]);
+      times[k++] = inst->t;
+    }
+  }
+  pfree(sequences); pfree(rounded);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_transf
+ * @brief Return a temporal point in the quantized storage format converted
+ * to the standard format
+ * @param[in] temp Temporal point
+ */
+Temporal *
+tpoint_unquantize(const Temporal *temp)
+{
+  assert(tpoint_quantized(temp));
+  const TPointQuantized *qt = tpoint_quantized_body(temp);
+  const TimestampTz *times = (const TimestampTz *) (qt + 1);
+  const int32 *coords = (const int32 *) (times + qt->count);
+  const int32 *seqstarts = coords + qt->count * qt->ndims;
+  const uint8 *bounds = (const uint8 *) (seqstarts + qt->nseqs);
+  interpType interp = MEOS_FLAGS_GET_INTERP(temp->flags);
+  bool hasz = (qt->ndims == 3);
+  bool geodetic = MEOS_FLAGS_GET_GEODETIC(temp->flags);
+  int32 srid = tpoint_srid(temp);
+
+  TSequence **sequences = palloc(sizeof(TSequence *) * qt->nseqs);
+  for (int i = 0; i < qt->nseqs; i++)
+  {
+    int start = seqstarts[i];
+    int end = (i < qt->nseqs - 1) ? seqstarts[i + 1] : qt->count;
+    TInstant **instants = palloc(sizeof(TInstant *) * (end - start));
+    for (int k = start; k < end; k++)
+    {
+      double values[3] = {0};
+      for (int l = 0; l < qt->ndims; l++)
+        values[l] = (double) (qt->origin[l] + coords[k * qt->ndims + l]) *
+          qt->scale;
+      GSERIALIZED *gs = geopoint_make(values[0], values[1], values[2], hasz,
+        geodetic, srid);
+      instants[k - start] = tinstant_make_free(PointerGetDatum(gs),
+        temp->temptype, times[k]);
+    }
+    sequences[i] = tsequence_make_free(instants, end - start, bounds[i] & 1,
+      (bounds[i] & 2) != 0, interp, NORMALIZE_NO);
+  }
+  if (temp->subtype == TSEQUENCE)
+  {
+    TSequence *result = sequences[0];
+    pfree(sequences);
+    return (Temporal *) result;
+  }
+  return (Temporal *) tsequenceset_make_free(sequences, qt->nseqs,
+    NORMALIZE_NO);
+}
+
 /*****************************************************************************/
@@ -38,163 +38,602 @@
 
 /* C */
 #include <assert.h>
+#include <string.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
-#include "general/doublen.h"
-#include "general/skiplist.h"
-#include "general/temporal_aggfuncs.h"
 #include "general/type_util.h"
 #include "point/tpoint_spatialfuncs.h"
 
 /*****************************************************************************
- * Generic functions
+ * Extent
  *****************************************************************************/
 
 /**
- * @brief Check the validity of two temporal points for aggregation
+ * @ingroup meos_temporal_agg
+ * @brief Transition function for temporal extent aggregation of temporal
+ * points
+ * @param[in] box Current aggregate value
+ * @param[in] temp Temporal point
+ * @csqlfn #Tpoint_extent_transfn()
  */
-bool
-ensure_geoaggstate(const SkipList *state, int32_t srid, bool hasz)
+STBox *
+tpoint_extent_transfn(STBox *box, const Temporal *temp)
+{
+  /* Can't do anything with null inputs */
+  if (! box && ! temp)
+    return NULL;
+  STBox *result = palloc0(sizeof(STBox));
+  /* Null box and non-null temporal, return the bbox of the temporal */
+  if (temp && ! box )
+  {
+    temporal_set_bbox(temp, result);
+    return result;
+  }
+  /* Non-null box and null temporal, return the box */
+  if (box && ! temp)
+  {
+    memcpy(result, box, sizeof(STBox));
+    return result;
+  }
+
+  /* Both box and temporal are not null */
+  if (! ensure_same_srid(tpoint_srid(temp), stbox_srid(box)) ||
+      ! ensure_same_dimensionality(temp->flags, box->flags) ||
+      ! ensure_same_geodetic(temp->flags, box->flags))
+    return NULL;
+
+  temporal_set_bbox(temp, result);
+  stbox_expand(box, result);
+  return result;
+}
+
+/*****************************************************************************
+ * Centroid
+ *
+ * The state of the aggregation keeps the instants in time order in columns
+ * storing their timestamps and the sums of the coordinates and of the number
+ * of points, grouped into time-disjoint runs. Each new value is merged with
+ * the runs of the state overlapping its time span with a sweep over their
+ * timestamps, and the temporal point is only built by the final function.
+ *****************************************************************************/
+
+/** Number of columns of sums of a temporal centroid state */
+#define TCENTROID_SUMS 4
+/** Position of the column of the number of points */
+#define TCENTROID_N 3
+
+/** Lower bound of a run of a temporal centroid state */
+#define TCENTROID_RUN_LOWER(state, r) \
+  ((state)->times[(state)->runs[r].start])
+/** Upper bound of a run of a temporal centroid state */
+#define TCENTROID_RUN_UPPER(state, r) \
+  ((state)->times[(state)->runs[r].start + (state)->runs[r].count - 1])
+
+/**
+ * Structure to iterate over consecutive runs of a temporal centroid state
+ */
+typedef struct
+{
+  const TCentroidState *state; /**< State */
+  int cur;                     /**< Current run */
+  int end;                     /**< One past the last run */
+} TCentroidCursor;
+
+/**
+ * @brief Return a new empty temporal centroid state
+ */
+static TCentroidState *
+tcentroid_state_make(int32 srid, bool hasz, interpType interp, int maxruns,
+  int maxcount)
+{
+  TCentroidState *result = palloc0(sizeof(TCentroidState));
+  result->srid = srid;
+  result->hasz = hasz;
+  result->interp = interp;
+  result->maxruns = Max(maxruns, 1);
+  result->maxcount = Max(maxcount, 1);
+  result->runs = palloc(sizeof(TCentroidRun) * result->maxruns);
+  result->times = palloc(sizeof(TimestampTz) * result->maxcount);
+  for (int i = 0; i < TCENTROID_SUMS; i++)
+  {
+    /* The Z column is not used for points without Z dimension */
+    if (i != 2 || hasz)
+      result->sums[i] = palloc(sizeof(double) * result->maxcount);
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Free a temporal centroid state
+ * @param[in] state State
+ */
+void
+tcentroid_state_free(TCentroidState *state)
 {
   if (! state)
-    return true;
-  struct GeoAggregateState *extra = state->extra;
-  if (extra && extra->srid != srid)
+    return;
+  pfree(state->runs);
+  pfree(state->times);
+  for (int i = 0; i < TCENTROID_SUMS; i++)
   {
-    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-      "Geometries must have the same SRID for temporal aggregation");
-    return false;
+    if (state->sums[i])
+      pfree(state->sums[i]);
   }
-  if (extra && extra->hasz != hasz)
+  pfree(state);
+  return;
+}
+
+/**
+ * @brief Ensure that a temporal centroid state has space for additional runs
+ * and instants
+ */
+static void
+tcentroid_state_enlarge(TCentroidState *state, int nruns, int count)
+{
+  if (state->nruns + nruns > state->maxruns)
   {
-    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-      "Geometries must have the same dimensionality for temporal aggregation");
-    return false;
+    while (state->nruns + nruns > state->maxruns)
+      state->maxruns *= 2;
+    state->runs = repalloc(state->runs,
+      sizeof(TCentroidRun) * state->maxruns);
   }
-  return true;
+  if (state->count + count > state->maxcount)
+  {
+    while (state->count + count > state->maxcount)
+      state->maxcount *= 2;
+    state->times = repalloc(state->times,
+      sizeof(TimestampTz) * state->maxcount);
+    for (int i = 0; i < TCENTROID_SUMS; i++)
+    {
+      if (state->sums[i])
+        state->sums[i] = repalloc(state->sums[i],
+          sizeof(double) * state->maxcount);
+    }
+  }
+  return;
 }
 
 /**
- * @brief Check the validity of two temporal points for aggregation
+ * @brief Append an instant to the last run of a temporal centroid state
  */
-bool
-ensure_geoaggstate_state(const SkipList *state1, const SkipList *state2)
+static void
+tcentroid_state_append(TCentroidState *state, TimestampTz t,
+  const double *value)
 {
-  if(! state2)
-    return true;
-  struct GeoAggregateState *extra2 = state2->extra;
-  if (extra2)
-    return ensure_geoaggstate(state1, extra2->srid, extra2->hasz);
-  return true;
+  tcentroid_state_enlarge(state, 0, 1);
+  state->times[state->count] = t;
+  for (int i = 0; i < TCENTROID_SUMS; i++)
+  {
+    if (state->sums[i])
+      state->sums[i][state->count] = value[i];
+  }
+  state->count++;
+  return;
 }
 
-/*****************************************************************************/
+/**
+ * @brief Start a new run in a temporal centroid state
+ */
+static void
+tcentroid_state_open_run(TCentroidState *state, bool lower_inc)
+{
+  tcentroid_state_enlarge(state, 1, 0);
+  TCentroidRun *run = &state->runs[state->nruns++];
+  run->start = state->count;
+  run->count = 0;
+  run->lower_inc = lower_inc;
+  run->upper_inc = false;
+  return;
+}
 
 /**
- * @brief Transform a temporal point instant into a temporal @p double3 of
- * @p double4 for performing temporal centroid aggregation
+ * @brief End the last run of a temporal centroid state
  */
-static TInstant *
-tpointinst_transform_tcentroid(const TInstant *inst)
+static void
+tcentroid_state_close_run(TCentroidState *state, bool upper_inc)
+{
+  TCentroidRun *run = &state->runs[state->nruns - 1];
+  run->count = state->count - run->start;
+  run->upper_inc = upper_inc;
+  return;
+}
+
+/**
+ * @brief Append a temporal point instant to the last run of a temporal
+ * centroid state
+ */
+static void
+tcentroid_state_append_tinstant(TCentroidState *state, const TInstant *inst)
 {
-  if (MEOS_FLAGS_GET_Z(inst->flags))
+  double value[TCENTROID_SUMS];
+  if (state->hasz)
   {
     const POINT3DZ *point = DATUM_POINT3DZ_P(tinstant_val(inst));
-    double4 dvalue;
-    double4_set(point->x, point->y, point->z, 1, &dvalue);
-    return tinstant_make(PointerGetDatum(&dvalue), T_TDOUBLE4, inst->t);
+    value[0] = point->x;
+    value[1] = point->y;
+    value[2] = point->z;
   }
   else
   {
     const POINT2D *point = DATUM_POINT2D_P(tinstant_val(inst));
-    double3 dvalue;
-    double3_set(point->x, point->y, 1, &dvalue);
-    return tinstant_make(PointerGetDatum(&dvalue), T_TDOUBLE3, inst->t);
+    value[0] = point->x;
+    value[1] = point->y;
+    value[2] = 0;
   }
+  value[TCENTROID_N] = 1;
+  tcentroid_state_append(state, inst->t, value);
+  return;
 }
 
 /**
- * @brief Transform a temporal point discrete sequence into a temporal
- * @p double3 or @p double4 for performing temporal centroid aggregation
+ * @brief Append a temporal point sequence as a run of a temporal centroid
+ * state, or as one run per instant when the sequence is discrete
  */
-static TInstant **
-tpointseq_disc_transform_tcentroid(const TSequence *seq)
+static void
+tcentroid_state_append_tsequence(TCentroidState *state, const TSequence *seq)
 {
-  TInstant **result = palloc(sizeof(TInstant *) * seq->count);
+  if (MEOS_FLAGS_DISCRETE_INTERP(seq->flags))
+  {
+    for (int i = 0; i < seq->count; i++)
+    {
+      tcentroid_state_open_run(state, true);
+      tcentroid_state_append_tinstant(state, TSEQUENCE_INST_N(seq, i));
+      tcentroid_state_close_run(state, true);
+    }
+    return;
+  }
+  tcentroid_state_open_run(state, seq->period.lower_inc);
   for (int i = 0; i < seq->count; i++)
-    result[i] = tpointinst_transform_tcentroid(TSEQUENCE_INST_N(seq, i));
-  return result;
+    tcentroid_state_append_tinstant(state, TSEQUENCE_INST_N(seq, i));
+  tcentroid_state_close_run(state, seq->period.upper_inc);
+  return;
 }
 
 /**
- * @brief Transform a temporal point sequence into a temporal
- * @p double3 or @p double4 for performing temporal centroid aggregation
+ * @brief Return the interpolation of a temporal point in a temporal centroid
+ * state, where instants are considered as discrete
  */
-static TSequence *
-tpointseq_cont_transform_tcentroid(const TSequence *seq)
+static interpType
+tcentroid_interp(const Temporal *temp)
 {
-  TInstant **instants = tpointseq_disc_transform_tcentroid(seq);
-  return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
-    seq->period.upper_inc,  MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE_NO);
+  return (temp->subtype == TINSTANT) ? DISCRETE :
+    MEOS_FLAGS_GET_INTERP(temp->flags);
 }
 
 /**
- * @brief Transform a temporal point sequence set into a temporal
- * @p double3 or @p double4 for performing temporal centroid aggregation
+ * @brief Return a temporal centroid state containing a temporal point
  */
-static TSequence **
-tpointseqset_transform_tcentroid(const TSequenceSet *ss)
+static TCentroidState *
+tpoint_tcentroid_state(const Temporal *temp)
 {
-  TSequence **result = palloc(sizeof(TSequence *) * ss->count);
-  for (int i = 0; i < ss->count; i++)
-    result[i] = tpointseq_cont_transform_tcentroid(TSEQUENCESET_SEQ_N(ss, i));
+  TCentroidState *result = tcentroid_state_make(tpoint_srid(temp),
+    MEOS_FLAGS_GET_Z(temp->flags), tcentroid_interp(temp),
+    temp->subtype == TSEQUENCESET ? ((TSequenceSet *) temp)->count : 1,
+    temporal_num_instants(temp));
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      tcentroid_state_open_run(result, true);
+      tcentroid_state_append_tinstant(result, (TInstant *) temp);
+      tcentroid_state_close_run(result, true);
+      break;
+    case TSEQUENCE:
+      tcentroid_state_append_tsequence(result, (TSequence *) temp);
+      break;
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (TSequenceSet *) temp;
+      for (int i = 0; i < ss->count; i++)
+        tcentroid_state_append_tsequence(result, TSEQUENCESET_SEQ_N(ss, i));
+    }
+  }
   return result;
 }
 
 /**
- * @brief Transform a temporal point for performing temporal centroid
- * aggregation
+ * @brief Ensure that a temporal point can be aggregated into a temporal
+ * centroid state
  */
-Temporal **
-tpoint_transform_tcentroid(const Temporal *temp, int *count)
+static bool
+ensure_valid_tcentroid_state(const TCentroidState *state, int32 srid,
+  bool hasz, interpType interp)
 {
-  Temporal **result;
-  assert(temptype_subtype(temp->subtype));
-  switch (temp->subtype)
+  if (state->srid != srid)
   {
-    case TINSTANT:
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Geometries must have the same SRID for temporal aggregation");
+    return false;
+  }
+  if (state->hasz != hasz)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Geometries must have the same dimensionality for temporal aggregation");
+    return false;
+  }
+  /* Temporal aggregation cannot mix instants and sequences */
+  if ((state->interp == DISCRETE) != (interp == DISCRETE))
+  {
+    meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+      "Cannot aggregate temporal values of different subtype");
+    return false;
+  }
+  if (state->interp != interp)
+  {
+    meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+      "Cannot aggregate temporal values of different interpolation");
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Add to the last argument the value of a run of a temporal centroid
+ * state at a timestamp, which is the limit from the left when the
+ * corresponding argument is true
+ * @pre The timestamp is in the period of the run
+ */
+static void
+tcentroid_run_add_value(const TCentroidState *state, int r, TimestampTz t,
+  bool left, double *value)
+{
+  const TCentroidRun *run = &state->runs[r];
+  const TimestampTz *times = state->times + run->start;
+  /* Find the last instant of the run that is not after the timestamp */
+  int lo = 0, hi = run->count - 1;
+  while (lo < hi)
+  {
+    int mid = (lo + hi + 1) / 2;
+    if (times[mid] <= t)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  int i = run->start + lo;
+  if (times[lo] == t || state->interp != LINEAR || lo == run->count - 1)
+  {
+    /* The limit from the left of a step run is the previous value */
+    if (left && times[lo] == t && lo > 0 && state->interp == STEP)
+      i--;
+    for (int j = 0; j < TCENTROID_SUMS; j++)
     {
-      result = palloc(sizeof(Temporal *));
-      result[0] = (Temporal *) tpointinst_transform_tcentroid((TInstant *) temp);
-      *count = 1;
-      break;
+      if (state->sums[j])
+        value[j] += state->sums[j][i];
     }
-    case TSEQUENCE:
+    return;
+  }
+  double ratio = (double) (t - times[lo]) /
+    (double) (times[lo + 1] - times[lo]);
+  for (int j = 0; j < TCENTROID_SUMS; j++)
+  {
+    if (state->sums[j])
+      value[j] += state->sums[j][i] +
+        (state->sums[j][i + 1] - state->sums[j][i]) * ratio;
+  }
+  return;
+}
+
+/**
+ * @brief Compute in the last argument the sum of the values of two runs of
+ * temporal centroid states at a timestamp, where a negative run is ignored
+ */
+static void
+tcentroid_runs_value(const TCentroidState *state1, int r1,
+  const TCentroidState *state2, int r2, TimestampTz t, bool left,
+  double *value)
+{
+  memset(value, 0, sizeof(double) * TCENTROID_SUMS);
+  if (r1 >= 0)
+    tcentroid_run_add_value(state1, r1, t, left, value);
+  if (r2 >= 0)
+    tcentroid_run_add_value(state2, r2, t, left, value);
+  return;
+}
+
+/**
+ * @brief Find the runs of a cursor spanning the period before a timestamp,
+ * containing the timestamp, and spanning the period after it, -1 for none
+ * @param[in] cursor Cursor, which is advanced to the first run that is not
+ * before the timestamp
+ * @param[in] t Timestamp
+ * @param[in] hasnext True if there is a period after the timestamp
+ * @param[out] left,point,right Runs
+ */
+static void
+tcentroid_cursor_runs(TCentroidCursor *cursor, TimestampTz t, bool hasnext,
+  int *left, int *point, int *right)
+{
+  const TCentroidState *state = cursor->state;
+  *left = *point = *right = -1;
+  while (cursor->cur < cursor->end &&
+      TCENTROID_RUN_UPPER(state, cursor->cur) < t)
+    cursor->cur++;
+  /* Up to three runs may touch the timestamp, as in [a, t), [t, t], (t, b] */
+  for (int r = cursor->cur; r < cursor->end; r++)
+  {
+    TimestampTz lower = TCENTROID_RUN_LOWER(state, r);
+    TimestampTz upper = TCENTROID_RUN_UPPER(state, r);
+    if (lower > t)
+      break;
+    const TCentroidRun *run = &state->runs[r];
+    if (lower < t)
+      *left = r;
+    if ((lower < t || run->lower_inc) && (t < upper || run->upper_inc))
+      *point = r;
+    if (hasnext && t < upper)
+      *right = r;
+  }
+  return;
+}
+
+/**
+ * @brief Return the merge of the runs of two cursors over temporal centroid
+ * states
+ * @details The distinct timestamps of the runs are swept in time order. At
+ * each timestamp, the runs spanning the period before it, containing it, and
+ * spanning the period after it are determined for both cursors, and a run of
+ * the result ends whenever these runs change. Since the sum of linear
+ * functions is linear, no instants other than those of the runs are needed.
+ */
+static TCentroidState *
+tcentroid_merge(TCentroidCursor *cursor1, TCentroidCursor *cursor2)
+{
+  const TCentroidState *state1 = cursor1->state;
+  const TCentroidState *state2 = cursor2->state;
+  int i1 = state1->runs[cursor1->cur].start;
+  int end1 = state1->runs[cursor1->end - 1].start +
+    state1->runs[cursor1->end - 1].count;
+  int i2 = state2->runs[cursor2->cur].start;
+  int end2 = state2->runs[cursor2->end - 1].start +
+    state2->runs[cursor2->end - 1].count;
+  TCentroidState *result = tcentroid_state_make(state1->srid, state1->hasz,
+    state1->interp, (cursor1->end - cursor1->cur) +
+    (cursor2->end - cursor2->cur), (end1 - i1) + (end2 - i2));
+  double value[TCENTROID_SUMS];
+  while (i1 < end1 || i2 < end2)
+  {
+    /* Next timestamp of the sweep */
+    TimestampTz t = (i2 == end2 ||
+      (i1 < end1 && state1->times[i1] <= state2->times[i2])) ?
+      state1->times[i1] : state2->times[i2];
+    /* Touching runs of a state may repeat a timestamp */
+    while (i1 < end1 && state1->times[i1] == t)
+      i1++;
+    while (i2 < end2 && state2->times[i2] == t)
+      i2++;
+    bool hasnext = (i1 < end1 || i2 < end2);
+    int left1, point1, right1, left2, point2, right2;
+    tcentroid_cursor_runs(cursor1, t, hasnext, &left1, &point1, &right1);
+    tcentroid_cursor_runs(cursor2, t, hasnext, &left2, &point2, &right2);
+    bool hasleft = (left1 >= 0 || left2 >= 0);
+    bool haspoint = (point1 >= 0 || point2 >= 0);
+    bool hasright = (right1 >= 0 || right2 >= 0);
+    bool sameleft = (left1 == point1 && left2 == point2);
+    bool sameright = (right1 == point1 && right2 == point2);
+    if (hasleft)
     {
-      if (MEOS_FLAGS_DISCRETE_INTERP(temp->flags))
-      {
-        result = (Temporal **) tpointseq_disc_transform_tcentroid((TSequence *) temp);
-        *count = ((TSequence *) temp)->count;
-      }
-      else
+      /* The current run continues after the timestamp */
+      if (sameleft && sameright)
       {
-        result = palloc(sizeof(Temporal *));
-        result[0] = (Temporal *) tpointseq_cont_transform_tcentroid((TSequence *) temp);
-        *count = 1;
+        tcentroid_runs_value(state1, point1, state2, point2, t, false,
+          value);
+        tcentroid_state_append(result, t, value);
+        continue;
       }
-      break;
+      /* End the current run, including the timestamp if possible */
+      tcentroid_runs_value(state1, left1, state2, left2, t, ! sameleft,
+        value);
+      tcentroid_state_append(result, t, value);
+      tcentroid_state_close_run(result, sameleft);
     }
-    default: /* TSEQUENCESET */
+    if (haspoint && ! (hasleft && sameleft))
+    {
+      /* Start a run at the timestamp, which is instantaneous if the runs
+       * change after the timestamp */
+      tcentroid_runs_value(state1, point1, state2, point2, t, false, value);
+      tcentroid_state_open_run(result, true);
+      tcentroid_state_append(result, t, value);
+      if (! sameright)
+        tcentroid_state_close_run(result, true);
+    }
+    if (hasright && ! (haspoint && sameright))
     {
-      result = (Temporal **) tpointseqset_transform_tcentroid((TSequenceSet *) temp);
-      *count = ((TSequenceSet *) temp)->count;
+      /* Start a run just after the timestamp */
+      tcentroid_runs_value(state1, right1, state2, right2, t, false, value);
+      tcentroid_state_open_run(result, false);
+      tcentroid_state_append(result, t, value);
     }
   }
-  assert(result != NULL);
   return result;
 }
 
+/**
+ * @brief Merge a temporal centroid state into another one
+ * @details Only the runs of the first state that overlap or are adjacent to
+ * the time span of the second one are merged, the result replacing them in
+ * the columns of the first state
+ */
+static void
+tcentroid_state_splice(TCentroidState *state, const TCentroidState *other)
+{
+  if (other->nruns == 0)
+    return;
+  TimestampTz lower = other->times[0];
+  TimestampTz upper = other->times[other->count - 1];
+  /* First run whose upper bound is not before the lower bound */
+  int lo = 0, hi = state->nruns;
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (TCENTROID_RUN_UPPER(state, mid) < lower)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  /* First run whose lower bound is after the upper bound */
+  int first = lo;
+  hi = state->nruns;
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    if (TCENTROID_RUN_LOWER(state, mid) <= upper)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  int last = lo;
+
+  const TCentroidState *runs = other;
+  TCentroidState *merged = NULL;
+  if (first < last)
+  {
+    TCentroidCursor cursor1 = { state, first, last };
+    TCentroidCursor cursor2 = { other, 0, other->nruns };
+    merged = tcentroid_merge(&cursor1, &cursor2);
+    runs = merged;
+  }
+
+  /* Replace the instants and the runs of the window by those of the merge */
+  int start = (first < state->nruns) ? state->runs[first].start :
+    state->count;
+  int end = (first < last) ?
+    state->runs[last - 1].start + state->runs[last - 1].count : start;
+  int delta = runs->count - (end - start);
+  int rdelta = runs->nruns - (last - first);
+  tcentroid_state_enlarge(state, Max(rdelta, 0), Max(delta, 0));
+  memmove(&state->times[end + delta], &state->times[end],
+    sizeof(TimestampTz) * (state->count - end));
+  memcpy(&state->times[start], runs->times, sizeof(TimestampTz) * runs->count);
+  for (int i = 0; i < TCENTROID_SUMS; i++)
+  {
+    if (! state->sums[i])
+      continue;
+    memmove(&state->sums[i][end + delta], &state->sums[i][end],
+      sizeof(double) * (state->count - end));
+    memcpy(&state->sums[i][start], runs->sums[i],
+      sizeof(double) * runs->count);
+  }
+  memmove(&state->runs[last + rdelta], &state->runs[last],
+    sizeof(TCentroidRun) * (state->nruns - last));
+  for (int r = last + rdelta; r < state->nruns + rdelta; r++)
+    state->runs[r].start += delta;
+  for (int r = 0; r < runs->nruns; r++)
+  {
+    state->runs[first + r] = runs->runs[r];
+    state->runs[first + r].start += start;
+  }
+  state->count += delta;
+  state->nruns += rdelta;
+
+  if (merged)
+    tcentroid_state_free(merged);
+  return;
+}
+
 /*****************************************************************************/
 
 /**
@@ -203,194 +642,274 @@ tpoint_transform_tcentroid(const Temporal *temp, int *count)
  * points
  * @param[in] state Current aggregate value
  * @param[in] temp Temporal point
+ * @note Before the introduction of #TCentroidState the state of this function
+ * was a skiplist, callers must now free it with #tcentroid_state_free()
  * @csqlfn #Tpoint_tcentroid_transfn()
  */
-SkipList *
-tpoint_tcentroid_transfn(SkipList *state, Temporal *temp)
+TCentroidState *
+tpoint_tcentroid_transfn(TCentroidState *state, const Temporal *temp)
 {
   /* Null temporal: return state */
   if (! temp)
     return state;
-  bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
   /* Ensure validity of the arguments */
-  if (! ensure_tgeo_type(temp->temptype) ||
-      ! ensure_geoaggstate(state, tpoint_srid(temp), hasz))
+  if (! ensure_tgeo_type(temp->temptype) || (state &&
+      ! ensure_valid_tcentroid_state(state, tpoint_srid(temp),
+        MEOS_FLAGS_GET_Z(temp->flags), tcentroid_interp(temp))))
     return NULL;
 
-  datum_func2 func = hasz ? &datum_sum_double4 : &datum_sum_double3;
-
-  int count;
-  Temporal **temparr = tpoint_transform_tcentroid(temp, &count);
-  if (state)
-    skiplist_splice(state, (void **) temparr, count, func, false);
-  else
-  {
-    state = skiplist_make((void **) temparr, count);
-    struct GeoAggregateState extra =
-    {
-      .srid = tpoint_srid(temp),
-      .hasz = hasz
-    };
-    aggstate_set_extra(state, &extra, sizeof(struct GeoAggregateState));
-  }
-
-  pfree_array((void **) temparr, count);
+  TCentroidState *state1 = tpoint_tcentroid_state(temp);
+  if (! state)
+    return state1;
+  tcentroid_state_splice(state, state1);
+  tcentroid_state_free(state1);
   return state;
 }
 
-/*****************************************************************************
- * Extent
- *****************************************************************************/
-
 /**
  * @ingroup meos_temporal_agg
- * @brief Transition function for temporal extent aggregation of temporal
+ * @brief Combine function for temporal centroid aggregation of temporal
  * points
- * @param[in] box Current aggregate value
- * @param[in] temp Temporal point
- * @csqlfn #Tpoint_extent_transfn()
+ * @param[in] state1,state2 States
+ * @csqlfn #Tpoint_tcentroid_combinefn()
  */
-STBox *
-tpoint_extent_transfn(STBox *box, const Temporal *temp)
+TCentroidState *
+tpoint_tcentroid_combinefn(TCentroidState *state1, TCentroidState *state2)
 {
-  /* Can't do anything with null inputs */
-  if (! box && ! temp)
+  if (! state1)
+    return state2;
+  if (! state2)
+    return state1;
+  if (! ensure_valid_tcentroid_state(state1, state2->srid, state2->hasz,
+      state2->interp))
     return NULL;
-  STBox *result = palloc0(sizeof(STBox));
-  /* Null box and non-null temporal, return the bbox of the temporal */
-  if (temp && ! box )
+  tcentroid_state_splice(state1, state2);
+  return state1;
+}
+
+/**
+ * @ingroup meos_temporal_agg
+ * @brief Remove from a temporal centroid state the instants before a
+ * timestamp
+ * @details The runs ending before the timestamp are removed and the run
+ * overlapping the timestamp is cut at it, its value at the timestamp
+ * becoming its first instant
+ * @param[in] state State, which is freed
+ * @param[in] t Timestamp
+ * @return When no instant remains return NULL
+ */
+TCentroidState *
+tcentroid_state_expire(TCentroidState *state, TimestampTz t)
+{
+  if (! state)
+    return NULL;
+  TCentroidState *result = tcentroid_state_make(state->srid, state->hasz,
+    state->interp, state->nruns, state->count);
+  double value[TCENTROID_SUMS];
+  for (int r = 0; r < state->nruns; r++)
   {
-    temporal_set_bbox(temp, result);
-    return result;
+    const TCentroidRun *run = &state->runs[r];
+    TimestampTz lower = TCENTROID_RUN_LOWER(state, r);
+    TimestampTz upper = TCENTROID_RUN_UPPER(state, r);
+    if (upper < t || (upper == t && ! run->upper_inc))
+      continue;
+    int i = run->start;
+    if (lower >= t)
+      tcentroid_state_open_run(result, run->lower_inc);
+    else
+    {
+      /* Start the run with its value at the timestamp */
+      memset(value, 0, sizeof(value));
+      tcentroid_run_add_value(state, r, t, false, value);
+      tcentroid_state_open_run(result, true);
+      tcentroid_state_append(result, t, value);
+      while (i < run->start + run->count && state->times[i] <= t)
+        i++;
+    }
+    for (; i < run->start + run->count; i++)
+    {
+      for (int j = 0; j < TCENTROID_SUMS; j++)
+        value[j] = state->sums[j] ? state->sums[j][i] : 0;
+      tcentroid_state_append(result, state->times[i], value);
+    }
+    tcentroid_state_close_run(result, run->upper_inc);
   }
-  /* Non-null box and null temporal, return the box */
-  if (box && ! temp)
+  tcentroid_state_free(state);
+  if (result->nruns == 0)
   {
-    memcpy(result, box, sizeof(STBox));
-    return result;
-  }
-
-  /* Both box and temporal are not null */
-  if (! ensure_same_srid(tpoint_srid(temp), stbox_srid(box)) ||
-      ! ensure_same_dimensionality(temp->flags, box->flags) ||
-      ! ensure_same_geodetic(temp->flags, box->flags))
+    tcentroid_state_free(result);
     return NULL;
-
-  temporal_set_bbox(temp, result);
-  stbox_expand(box, result);
+  }
   return result;
 }
 
-/*****************************************************************************
- * Centroid
- *****************************************************************************/
+/**
+ * @brief Return the temporal point instant of the centroid at an instant of
+ * a temporal centroid state
+ */
+static TInstant *
+tcentroid_state_tinstant(const TCentroidState *state, int i)
+{
+  double n = state->sums[TCENTROID_N][i];
+  assert(n != 0);
+  LWPOINT *point = state->hasz ?
+    lwpoint_make3dz(state->srid, state->sums[0][i] / n,
+      state->sums[1][i] / n, state->sums[2][i] / n) :
+    lwpoint_make2d(state->srid, state->sums[0][i] / n, state->sums[1][i] / n);
+  /* Notice that for the moment we do not aggregate temporal geography points */
+  Datum value = PointerGetDatum(geo_serialize((LWGEOM *) point));
+  lwpoint_free(point);
+  return tinstant_make_free(value, T_TGEOMPOINT, state->times[i]);
+}
 
 /**
- * @brief Transform a temporal doubleN instant into a point
+ * @ingroup meos_temporal_agg
+ * @brief Final function for temporal centroid aggregation of temporal points
+ * @param[in] state Current aggregate value
+ * @note Before the introduction of #TCentroidState the state of this function
+ * was a skiplist that was freed by the function, the state must now be freed
+ * by the caller with #tcentroid_state_free()
+ * @csqlfn #Tpoint_tcentroid_finalfn()
  */
-static Datum
-doublen_to_point(const TInstant *inst, int srid)
+Temporal *
+tpoint_tcentroid_finalfn(const TCentroidState *state)
 {
-  assert(inst->temptype == T_TDOUBLE3 || inst->temptype == T_TDOUBLE4);
-  LWPOINT *point;
-  if (inst->temptype == T_TDOUBLE3)
+  if (! state || state->nruns == 0)
+    return NULL;
+
+  if (state->interp == DISCRETE)
   {
-    double3 *value3 = (double3 *) DatumGetPointer(tinstant_val(inst));
-    assert(value3->c != 0);
-    double valuea = value3->a / value3->c;
-    double valueb = value3->b / value3->c;
-    point = lwpoint_make2d(srid, valuea, valueb);
+    TInstant **instants = palloc(sizeof(TInstant *) * state->count);
+    for (int i = 0; i < state->count; i++)
+      instants[i] = tcentroid_state_tinstant(state, i);
+    return (Temporal *) tsequence_make_free(instants, state->count, true,
+      true, DISCRETE, NORMALIZE_NO);
   }
-  else /* inst->temptype == T_TDOUBLE4 */
+
+  TSequence **sequences = palloc(sizeof(TSequence *) * state->nruns);
+  for (int r = 0; r < state->nruns; r++)
   {
-    double4 *value4 = (double4 *) DatumGetPointer(tinstant_val(inst));
-    assert(value4->d != 0);
-    double valuea = value4->a / value4->d;
-    double valueb = value4->b / value4->d;
-    double valuec = value4->c / value4->d;
-    point = lwpoint_make3dz(srid, valuea, valueb, valuec);
+    const TCentroidRun *run = &state->runs[r];
+    TInstant **instants = palloc(sizeof(TInstant *) * run->count);
+    for (int i = 0; i < run->count; i++)
+      instants[i] = tcentroid_state_tinstant(state, run->start + i);
+    sequences[r] = tsequence_make_free(instants, run->count, run->lower_inc,
+      run->upper_inc, state->interp, NORMALIZE);
   }
-  /* Notice that for the moment we do not aggregate temporal geography points */
-  Datum result = PointerGetDatum(geo_serialize((LWGEOM *) point));
-  lwpoint_free(point);
-  return result;
+  return (Temporal *) tsequenceset_make_free(sequences, state->nruns,
+    NORMALIZE);
 }
 
+/*****************************************************************************/
+
 /**
- * @brief Final function for temporal centroid aggregation of temporal point
- * instants
- * @param[in] instants Temporal instants
- * @param[in] count Number of elements in the array
- * @param[in] srid SRID of the values
+ * @ingroup meos_temporal_agg
+ * @brief Return the size of the serialization of a temporal centroid state
+ * @param[in] state State
  */
-TSequence *
-tpointinst_tcentroid_finalfn(TInstant **instants, int count, int srid)
+size_t
+tcentroid_state_serialize_size(const TCentroidState *state)
 {
-  TInstant **newinstants = palloc(sizeof(TInstant *) * count);
-  for (int i = 0; i < count; i++)
-  {
-    TInstant *inst = instants[i];
-    Datum value = doublen_to_point(inst, srid);
-    newinstants[i] = tinstant_make_free(value, T_TGEOMPOINT, inst->t);
-  }
-  return tsequence_make_free(newinstants, count,  true, true, DISCRETE,
-    NORMALIZE_NO);
+  int ncols = state->hasz ? TCENTROID_SUMS : TCENTROID_SUMS - 1;
+  return sizeof(TCentroidState) + sizeof(TCentroidRun) * state->nruns +
+    (sizeof(TimestampTz) + sizeof(double) * ncols) * state->count;
 }
 
 /**
- * @brief Final function for temporal centroid aggregation of temporal point
- * sequences
- * @param[in] sequences Temporal values
- * @param[in] count Number of elements in the array
- * @param[in] srid SRID of the values
+ * @ingroup meos_temporal_agg
+ * @brief Serialize a temporal centroid state into a buffer
+ * @details The buffer contains the state followed by its runs and its
+ * columns, whose pointers in the state are not meaningful
+ * @param[in] state State
+ * @param[out] buf Buffer of the size given by
+ * #tcentroid_state_serialize_size()
  */
-TSequenceSet *
-tpointseq_tcentroid_finalfn(TSequence **sequences, int count, int srid)
+void
+tcentroid_state_serialize(const TCentroidState *state, char *buf)
 {
-  TSequence **newsequences = palloc(sizeof(TSequence *) * count);
-  for (int i = 0; i < count; i++)
+  memcpy(buf, state, sizeof(TCentroidState));
+  char *ptr = buf + sizeof(TCentroidState);
+  memcpy(ptr, state->runs, sizeof(TCentroidRun) * state->nruns);
+  ptr += sizeof(TCentroidRun) * state->nruns;
+  memcpy(ptr, state->times, sizeof(TimestampTz) * state->count);
+  ptr += sizeof(TimestampTz) * state->count;
+  for (int i = 0; i < TCENTROID_SUMS; i++)
   {
-    TSequence *seq = sequences[i];
-    TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-    for (int j = 0; j < seq->count; j++)
-    {
-      const TInstant *inst = TSEQUENCE_INST_N(seq, j);
-      Datum value = doublen_to_point(inst, srid);
-      instants[j] = tinstant_make_free(value, T_TGEOMPOINT, inst->t);
-    }
-    newsequences[i] = tsequence_make_free(instants, seq->count,
-      seq->period.lower_inc, seq->period.upper_inc,
-      MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
+    if (! state->sums[i])
+      continue;
+    memcpy(ptr, state->sums[i], sizeof(double) * state->count);
+    ptr += sizeof(double) * state->count;
   }
-  return tsequenceset_make_free(newsequences, count, NORMALIZE);
+  return;
 }
 
-/*****************************************************************************/
-
 /**
  * @ingroup meos_temporal_agg
- * @brief Final function for temporal centroid aggregation of temporal points
- * @param[in] state Current aggregate value
- * @csqlfn #Tpoint_tcentroid_finalfn()
+ * @brief Deserialize a temporal centroid state from a buffer
+ * @param[in] buf Buffer
+ * @param[in] size Size of the buffer
  */
-Temporal *
-tpoint_tcentroid_finalfn(SkipList *state)
+TCentroidState *
+tcentroid_state_deserialize(const char *buf, size_t size)
 {
-  if (state == NULL || state->length == 0)
+  TCentroidState header;
+  if (size < sizeof(TCentroidState))
+  {
+    meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+      "Invalid serialized state of a temporal aggregate");
     return NULL;
-
-  Temporal **values = (Temporal **) skiplist_values(state);
-  int32_t srid = ((struct GeoAggregateState *) state->extra)->srid;
-  Temporal *result;
-  assert(values[0]->subtype == TINSTANT || values[0]->subtype == TSEQUENCE);
-  if (values[0]->subtype == TINSTANT)
-    result = (Temporal *) tpointinst_tcentroid_finalfn((TInstant **) values,
-      state->length, srid);
-  else /* values[0]->subtype == TSEQUENCE */
-    result = (Temporal *) tpointseq_tcentroid_finalfn((TSequence **) values,
-      state->length, srid);
-  pfree(values);
-  skiplist_free(state);
+  }
+  memcpy(&header, buf, sizeof(TCentroidState));
+  header.hasz = header.hasz ? true : false;
+  if (header.interp < DISCRETE || header.interp > LINEAR ||
+      header.nruns < 0 || header.count < header.nruns ||
+      tcentroid_state_serialize_size(&header) != size)
+  {
+    meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+      "Invalid serialized state of a temporal aggregate");
+    return NULL;
+  }
+  TCentroidState *result = tcentroid_state_make(header.srid, header.hasz,
+    header.interp, header.nruns, header.count);
+  const char *ptr = buf + sizeof(TCentroidState);
+  memcpy(result->runs, ptr, sizeof(TCentroidRun) * header.nruns);
+  ptr += sizeof(TCentroidRun) * header.nruns;
+  memcpy(result->times, ptr, sizeof(TimestampTz) * header.count);
+  ptr += sizeof(TimestampTz) * header.count;
+  for (int i = 0; i < TCENTROID_SUMS; i++)
+  {
+    if (! result->sums[i])
+      continue;
+    memcpy(result->sums[i], ptr, sizeof(double) * header.count);
+    ptr += sizeof(double) * header.count;
+  }
+  result->nruns = header.nruns;
+  result->count = header.count;
+  /* The runs must cover consecutive instants and contain at least one
+   * point, as is the case for the states built by the aggregate */
+  int next = 0;
+  for (int r = 0; r < result->nruns; r++)
+  {
+    if (result->runs[r].start != next || result->runs[r].count <= 0 ||
+        result->runs[r].count > result->count - next)
+    {
+      tcentroid_state_free(result);
+      meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+        "Invalid serialized state of a temporal aggregate");
+      return NULL;
+    }
+    next += result->runs[r].count;
+  }
+  for (int i = 0; i < result->count; i++)
+  {
+    if (! (result->sums[TCENTROID_N][i] > 0))
+    {
+      tcentroid_state_free(result);
+      meos_error(ERROR, MEOS_ERR_AGGREGATION_ERROR,
+        "Invalid serialized state of a temporal aggregate");
+      return NULL;
+    }
+  }
   return result;
 }
 
@@ -128,30 +128,79 @@ tpointinstarr_set_stbox(const TInstant **instants, int count, STBox *box)
 {
   /* Initialize the bounding box with the first instant */
   tpointinst_set_stbox(instants[0], box);
-  /* Prepare for the iteration */
-  bool hasz = MEOS_FLAGS_GET_Z(instants[0]->flags);
-  bool geodetic = MEOS_FLAGS_GET_GEODETIC(instants[0]->flags);
-  for (int i = 1; i < count; i++)
+  /* Keep the extreme coordinates in local variables and read the coordinates
+   * in place to avoid unpacking every point */
+  double xmin = box->xmin, xmax = box->xmax;
+  double ymin = box->ymin, ymax = box->ymax;
+  if (MEOS_FLAGS_GET_Z(instants[0]->flags))
+  {
+    double zmin = box->zmin, zmax = box->zmax;
+    for (int i = 1; i < count; i++)
+    {
+      const POINT3DZ *pt = DATUM_POINT3DZ_P(tinstant_val(instants[i]));
+      xmin = Min(xmin, pt->x); xmax = Max(xmax, pt->x);
+      ymin = Min(ymin, pt->y); ymax = Max(ymax, pt->y);
+      zmin = Min(zmin, pt->z); zmax = Max(zmax, pt->z);
+    }
+    box->zmin = zmin; box->zmax = zmax;
+  }
+  else
+  {
+    for (int i = 1; i < count; i++)
+    {
+      const POINT2D *pt = DATUM_POINT2D_P(tinstant_val(instants[i]));
+      xmin = Min(xmin, pt->x); xmax = Max(xmax, pt->x);
+      ymin = Min(ymin, pt->y); ymax = Max(ymax, pt->y);
+    }
+  }
+  box->xmin = xmin; box->xmax = xmax;
+  box->ymin = ymin; box->ymax = ymax;
+  /* The instants are ordered by timestamp */
+  box->period.upper = TimestampTzGetDatum(instants[count - 1]->t);
+  return;
+}
+
+/**
+ * @brief Return the last argument initialized with the spatiotemporal box of
+ * the consecutive instants of a temporal point sequence between two positions
+ * @param[in] seq Temporal sequence
+ * @param[in] from,to Positions of the first and the last instants
+ * @param[out] box Spatiotemporal box
+ * @note The coordinates are read in place instead of building and expanding
+ * a box for every instant
+ */
+static void
+tpointseq_stbox_range(const TSequence *seq, int from, int to, STBox *box)
+{
+  tpointinst_set_stbox(TSEQUENCE_INST_N(seq, from), box);
+  double xmin = box->xmin, xmax = box->xmax;
+  double ymin = box->ymin, ymax = box->ymax;
+  if (MEOS_FLAGS_GET_Z(seq->flags))
+  {
+    double zmin = box->zmin, zmax = box->zmax;
+    for (int i = from + 1; i <= to; i++)
+    {
+      const POINT3DZ *pt = DATUM_POINT3DZ_P(
+        tinstant_val(TSEQUENCE_INST_N(seq, i)));
+      xmin = Min(xmin, pt->x); xmax = Max(xmax, pt->x);
+      ymin = Min(ymin, pt->y); ymax = Max(ymax, pt->y);
+      zmin = Min(zmin, pt->z); zmax = Max(zmax, pt->z);
+    }
+    box->zmin = zmin; box->zmax = zmax;
+  }
+  else
   {
-    GSERIALIZED *point = DatumGetGserializedP(tinstant_val(instants[i]));
-    double x, y, z;
-    point_get_coords(point, hasz, &x, &y, &z);
-    box->xmin = Min(box->xmin, x);
-    box->xmax = Max(box->xmax, x);
-    box->ymin = Min(box->ymin, y);
-    box->ymax = Max(box->ymax, y);
-    if (hasz)
+    for (int i = from + 1; i <= to; i++)
     {
-      box->zmin = Min(box->zmin, z);
-      box->zmax = Max(box->zmax, z);
+      const POINT2D *pt = DATUM_POINT2D_P(
+        tinstant_val(TSEQUENCE_INST_N(seq, i)));
+      xmin = Min(xmin, pt->x); xmax = Max(xmax, pt->x);
+      ymin = Min(ymin, pt->y); ymax = Max(ymax, pt->y);
     }
-    box->period.lower = TimestampTzGetDatum(
-      Min(DatumGetTimestampTz(box->period.lower), instants[i]->t));
-    box->period.upper = TimestampTzGetDatum(
-      Max(DatumGetTimestampTz(box->period.upper), instants[i]->t));
   }
-  MEOS_FLAGS_SET_Z(box->flags, hasz);
-  MEOS_FLAGS_SET_GEODETIC(box->flags, geodetic);
+  box->xmin = xmin; box->xmax = xmax;
+  box->ymin = ymin; box->ymax = ymax;
+  box->period.upper = TimestampTzGetDatum(TSEQUENCE_INST_N(seq, to)->t);
   return;
 }
 
@@ -251,14 +300,7 @@ tpointseq_disc_stboxes_iter(const TSequence *seq, int max_count, STBox *result)
       if (k < remainder)
         j++;
       assert(i < j);
-      tpointinst_set_stbox(TSEQUENCE_INST_N(seq, i), &result[k]);
-      for (int l = i + 1; l <= j; l++)
-      {
-        const TInstant *inst = TSEQUENCE_INST_N(seq, l);
-        STBox box;
-        tpointinst_set_stbox(inst, &box);
-        stbox_expand(&box, &result[k]);
-      }
+      tpointseq_stbox_range(seq, i, j, &result[k]);
       k++;
       i = j;
     }
@@ -293,16 +335,8 @@ tpointseq_cont_stboxes_iter(const TSequence *seq, int max_count, STBox *result)
   if (max_count < 1 || nsegs <= max_count)
   {
     /* One bounding box per segment */
-    const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
     for (int i = 0; i < seq->count - 1; i++)
-    {
-      tpointinst_set_stbox(inst1, &result[i]);
-      const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
-      STBox box;
-      tpointinst_set_stbox(inst2, &box);
-      stbox_expand(&box, &result[i]);
-      inst1 = inst2;
-    }
+      tpointseq_stbox_range(seq, i, i + 1, &result[i]);
     return nsegs;
   }
   else
@@ -320,14 +354,7 @@ tpointseq_cont_stboxes_iter(const TSequence *seq, int max_count, STBox *result)
       if (k < remainder)
         j++;
       assert(i < j);
-      tpointinst_set_stbox(TSEQUENCE_INST_N(seq, i), &result[k]);
-      for (int l = i + 1; l <= j; l++)
-      {
-        const TInstant *inst = TSEQUENCE_INST_N(seq, l);
-        STBox box;
-        tpointinst_set_stbox(inst, &box);
-        stbox_expand(&box, &result[k]);
-      }
+      tpointseq_stbox_range(seq, i, j, &result[k]);
       k++;
       i = j;
     }
@@ -0,0 +1,651 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Bulk input of temporal points from CSV files
+ * @details The file is read in large blocks that are split at line
+ * boundaries and parsed in parallel by several threads. The parsing threads
+ * only convert the fields of the rows into numbers and never call MEOS
+ * functions, which are not thread safe. The main thread then groups the
+ * parsed rows by object identifier into growing arrays of coordinates and
+ * timestamps from which the sequences are built at the end of the file.
+ */
+
+/* C */
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <pgtime.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+#include "general/type_parser.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/** Size of the blocks read from the file */
+#define CSV_BLOCK_SIZE (64 * 1024 * 1024)
+/** Maximum number of parsing threads */
+#define CSV_MAX_THREADS 64
+/** Maximum length of a timestamp parsed by PostgreSQL */
+#define CSV_MAX_TIMESTAMP 64
+/** Initial number of instants of a sequence */
+#define CSV_INIT_INSTANTS 64
+
+/**
+ * @brief Structure for a parsed row
+ * @details When the timestamp cannot be parsed by the fast path, the field
+ * is kept for parsing it with PostgreSQL in the main thread
+ */
+typedef struct
+{
+  int64 id;                /**< Identifier of the object */
+  TimestampTz t;           /**< Timestamp, if parsed */
+  double x, y, z;          /**< Coordinates */
+  const char *tstr;        /**< Timestamp field, if not parsed */
+  int tlen;                /**< Length of the timestamp field */
+} csv_row;
+
+/**
+ * @brief Structure for the state of a parsing thread
+ */
+typedef struct
+{
+  const tpointCsvOptions *options; /**< Layout of the file */
+  int maxcol;              /**< Last column used */
+  const char *start;       /**< First character of the slice */
+  const char *end;         /**< Character after the slice */
+  csv_row *rows;           /**< Parsed rows */
+  int64 nrows;             /**< Number of parsed rows */
+  int64 maxrows;           /**< Number of allocated rows */
+  int64 nskipped;          /**< Number of malformed lines */
+  bool nomem;              /**< True when an allocation failed */
+} csv_slice;
+
+/**
+ * @brief Structure for the instants of an object
+ */
+typedef struct
+{
+  int64 id;                /**< Identifier of the object */
+  int count;               /**< Number of instants */
+  int maxcount;            /**< Number of allocated instants */
+  bool ordered;            /**< True when the timestamps are increasing */
+  TimestampTz *times;      /**< Timestamps */
+  double *xs, *ys, *zs;    /**< Coordinates */
+} csv_group;
+
+/**
+ * @brief Structure for an open-addressing hash table from identifiers to
+ * groups
+ */
+typedef struct
+{
+  int *slots;              /**< Group number plus one, 0 if the slot is free */
+  int64 size;              /**< Number of slots, a power of two */
+  csv_group *groups;       /**< Groups in order of first appearance */
+  int ngroups;             /**< Number of groups */
+  int maxgroups;           /**< Number of allocated groups */
+} csv_groups;
+
+/*****************************************************************************
+ * Parsing functions executed by the threads
+ *****************************************************************************/
+
+/**
+ * @brief Parse a timestamp in the ISO 8601 format, where timestamps without
+ * time zone are interpreted in UTC
+ * @return Return false when the timestamp is not in this format, which is
+ * then parsed by PostgreSQL
+ */
+static bool
+csv_timestamp_fast(const char *str, int len, TimestampTz *result)
+{
+  struct pg_tm tm;
+  int32 fsec;
+  int tz;
+  bool hastz;
+  if (! timestamp_scan_iso(str, len, &tm, &fsec, &tz, &hastz))
+    return false;
+  if (! hastz)
+    tz = 0;
+  return tm2timestamp(&tm, fsec, &tz, result) == 0;
+}
+
+/**
+ * @brief Parse a floating point field
+ */
+static inline bool
+csv_double(const char *str, const char *end, double *result)
+{
+  char *endptr;
+  errno = 0;
+  *result = strtod(str, &endptr);
+  return endptr != str && endptr == end && errno == 0;
+}
+
+/**
+ * @brief Parse an integer field
+ */
+static inline bool
+csv_int64(const char *str, const char *end, int64 *result)
+{
+  char *endptr;
+  errno = 0;
+  *result = (int64) strtoll(str, &endptr, 10);
+  return endptr != str && endptr == end && errno == 0;
+}
+
+/**
+ * @brief Parse a line into a row
+ * @return Return false for malformed lines
+ */
+static bool
+csv_parse_line(const csv_slice *slice, const char *line, const char *end,
+  csv_row *row)
+{
+  const tpointCsvOptions *opts = slice->options;
+  bool found_id = false, found_t = false, found_x = false, found_y = false,
+    found_z = (opts->z_col < 0);
+  const char *field = line;
+  for (int col = 0; col <= slice->maxcol; col++)
+  {
+    if (field > end)
+      return false;
+    const char *fend = memchr(field, opts->delimiter, end - field);
+    if (! fend)
+      fend = end;
+    if (col == opts->id_col)
+      found_id = csv_int64(field, fend, &row->id);
+    else if (col == opts->t_col)
+    {
+      found_t = true;
+      row->tstr = NULL;
+      if (! csv_timestamp_fast(field, (int) (fend - field), &row->t))
+      {
+        if (fend - field >= CSV_MAX_TIMESTAMP || fend == field)
+          return false;
+        row->tstr = field;
+        row->tlen = (int) (fend - field);
+      }
+    }
+    else if (col == opts->x_col)
+      found_x = csv_double(field, fend, &row->x);
+    else if (col == opts->y_col)
+      found_y = csv_double(field, fend, &row->y);
+    else if (col == opts->z_col)
+      found_z = csv_double(field, fend, &row->z);
+    field = fend + 1;
+  }
+  return found_id && found_t && found_x && found_y && found_z;
+}
+
+/**
+ * @brief Parse the lines of a slice of a block
+ */
+static void *
+csv_parse_slice(void *arg)
+{
+  csv_slice *slice = (csv_slice *) arg;
+  const char *line = slice->start;
+  while (line < slice->end)
+  {
+    const char *eol = memchr(line, '\n', slice->end - line);
+    if (! eol)
+      eol = slice->end;
+    const char *end = eol;
+    if (end > line && end[-1] == '\r')
+      end--;
+    if (end > line)
+    {
+      if (slice->nrows == slice->maxrows)
+      {
+        int64 maxrows = slice->maxrows ? slice->maxrows * 2 : 4096;
+        csv_row *rows = realloc(slice->rows, sizeof(csv_row) * maxrows);
+        if (! rows)
+        {
+          slice->nomem = true;
+          return NULL;
+        }
+        slice->rows = rows;
+        slice->maxrows = maxrows;
+      }
+      if (csv_parse_line(slice, line, end, &slice->rows[slice->nrows]))
+        slice->nrows++;
+      else
+        slice->nskipped++;
+    }
+    line = eol + 1;
+  }
+  return NULL;
+}
+
+/*****************************************************************************
+ * Grouping functions executed by the main thread
+ *****************************************************************************/
+
+/**
+ * @brief Return the hash slot of an identifier
+ */
+static inline int64
+csv_hash_slot(int64 id, int64 size)
+{
+  uint64 h = (uint64) id * UINT64CONST(0x9E3779B97F4A7C15);
+  return (int64) ((h ^ (h >> 32)) & (uint64) (size - 1));
+}
+
+/**
+ * @brief Return the group of an identifier, creating it if needed
+ */
+static csv_group *
+csv_group_get(csv_groups *groups, int64 id, bool hasz)
+{
+  int64 slot = csv_hash_slot(id, groups->size);
+  while (groups->slots[slot])
+  {
+    csv_group *group = &groups->groups[groups->slots[slot] - 1];
+    if (group->id == id)
+      return group;
+    slot = (slot + 1) & (groups->size - 1);
+  }
+  if (groups->ngroups == groups->maxgroups)
+  {
+    groups->maxgroups *= 2;
+    groups->groups = repalloc(groups->groups,
+      sizeof(csv_group) * groups->maxgroups);
+  }
+  csv_group *group = &groups->groups[groups->ngroups];
+  group->id = id;
+  group->count = 0;
+  group->maxcount = CSV_INIT_INSTANTS;
+  group->ordered = true;
+  group->times = palloc(sizeof(TimestampTz) * group->maxcount);
+  group->xs = palloc(sizeof(double) * group->maxcount);
+  group->ys = palloc(sizeof(double) * group->maxcount);
+  group->zs = hasz ? palloc(sizeof(double) * group->maxcount) : NULL;
+  groups->slots[slot] = ++groups->ngroups;
+  /* Keep the load factor of the table below one half */
+  if (groups->ngroups * 2 > groups->size)
+  {
+    int64 size = groups->size * 2;
+    int *slots = palloc0(sizeof(int) * size);
+    for (int i = 0; i < groups->ngroups; i++)
+    {
+      int64 s = csv_hash_slot(groups->groups[i].id, size);
+      while (slots[s])
+        s = (s + 1) & (size - 1);
+      slots[s] = i + 1;
+    }
+    pfree(groups->slots);
+    groups->slots = slots;
+    groups->size = size;
+  }
+  return &groups->groups[groups->ngroups - 1];
+}
+
+/**
+ * @brief Append a row to its group
+ */
+static void
+csv_group_append(csv_groups *groups, const csv_row *row, TimestampTz t,
+  bool hasz)
+{
+  csv_group *group = csv_group_get(groups, row->id, hasz);
+  if (group->count == group->maxcount)
+  {
+    group->maxcount *= 2;
+    group->times = repalloc(group->times,
+      sizeof(TimestampTz) * group->maxcount);
+    group->xs = repalloc(group->xs, sizeof(double) * group->maxcount);
+    group->ys = repalloc(group->ys, sizeof(double) * group->maxcount);
+    if (hasz)
+      group->zs = repalloc(group->zs, sizeof(double) * group->maxcount);
+  }
+  int n = group->count++;
+  if (n > 0 && t <= group->times[n - 1])
+    group->ordered = false;
+  group->times[n] = t;
+  group->xs[n] = row->x;
+  group->ys[n] = row->y;
+  if (hasz)
+    group->zs[n] = row->z;
+  return;
+}
+
+/**
+ * @brief Comparator of positions in a group according to their timestamps,
+ * where ties are broken by the position to keep the first observation
+ */
+static int
+csv_pos_cmp(const int *l, const int *r, const TimestampTz *times)
+{
+  if (times[*l] != times[*r])
+    return (times[*l] < times[*r]) ? -1 : 1;
+  return (*l < *r) ? -1 : (*l > *r) ? 1 : 0;
+}
+
+/**
+ * @brief Sort the instants of a group and remove those with a duplicate
+ * timestamp
+ */
+static void
+csv_group_sort(csv_group *group, bool hasz)
+{
+  int n = group->count;
+  int *pos = palloc(sizeof(int) * n);
+  for (int i = 0; i < n; i++)
+    pos[i] = i;
+  qsort_arg(pos, (size_t) n, sizeof(int), (qsort_arg_comparator) &csv_pos_cmp,
+    group->times);
+  TimestampTz *times = palloc(sizeof(TimestampTz) * n);
+  double *xs = palloc(sizeof(double) * n);
+  double *ys = palloc(sizeof(double) * n);
+  double *zs = hasz ? palloc(sizeof(double) * n) : NULL;
+  int k = 0;
+  for (int i = 0; i < n; i++)
+  {
+    int j = pos[i];
+    if (k > 0 && group->times[j] == times[k - 1])
+      continue;
+    times[k] = group->times[j];
+    xs[k] = group->xs[j];
+    ys[k] = group->ys[j];
+    if (hasz)
+      zs[k] = group->zs[j];
+    k++;
+  }
+  pfree(pos); pfree(group->times); pfree(group->xs); pfree(group->ys);
+  if (hasz)
+    pfree(group->zs);
+  group->times = times; group->xs = xs; group->ys = ys; group->zs = zs;
+  group->count = k;
+  return;
+}
+
+/**
+ * @brief Append the rows parsed by a thread to their groups
+ * @return On error return false
+ */
+static bool
+csv_slice_group(csv_groups *groups, const csv_slice *slice, bool hasz)
+{
+  char buf[CSV_MAX_TIMESTAMP];
+  for (int64 i = 0; i < slice->nrows; i++)
+  {
+    const csv_row *row = &slice->rows[i];
+    TimestampTz t = row->t;
+    if (row->tstr)
+    {
+      memcpy(buf, row->tstr, row->tlen);
+      buf[row->tlen] = '\0';
+      t = pg_timestamptz_in(buf, -1);
+      if (t == DT_NOEND)
+        return false;
+    }
+    csv_group_append(groups, row, t, hasz);
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * Input function
+ *****************************************************************************/
+
+/**
+ * @brief Return the default number of parsing threads
+ */
+static int
+csv_default_threads(void)
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return (n < 1) ? 1 : (n > CSV_MAX_THREADS) ? CSV_MAX_THREADS : (int) n;
+}
+
+/**
+ * @brief Parse a block of complete lines with several threads and group the
+ * resulting rows
+ */
+static bool
+csv_parse_block(csv_groups *groups, const tpointCsvOptions *opts, int maxcol,
+  csv_slice *slices, int nthreads, const char *block, size_t size)
+{
+  pthread_t threads[CSV_MAX_THREADS];
+  bool started[CSV_MAX_THREADS];
+  const char *start = block, *end = block + size;
+  for (int i = 0; i < nthreads; i++)
+  {
+    slices[i].options = opts;
+    slices[i].maxcol = maxcol;
+    slices[i].nrows = 0;
+    slices[i].start = start;
+    /* Split the block at line boundaries */
+    const char *send = (i == nthreads - 1) ? end :
+      block + size * (i + 1) / nthreads;
+    if (send < start)
+      send = start;
+    if (send < end)
+    {
+      const char *eol = memchr(send, '\n', end - send);
+      send = eol ? eol + 1 : end;
+    }
+    slices[i].end = send;
+    start = send;
+    started[i] = (i > 0 && slices[i].start < slices[i].end) &&
+      pthread_create(&threads[i], NULL, csv_parse_slice, &slices[i]) == 0;
+  }
+  /* The main thread parses the first slice and those without thread */
+  for (int i = 0; i < nthreads; i++)
+  {
+    if (! started[i])
+      csv_parse_slice(&slices[i]);
+  }
+  for (int i = 0; i < nthreads; i++)
+  {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+  }
+  /* Group the rows in the order of the file */
+  for (int i = 0; i < nthreads; i++)
+  {
+    if (slices[i].nomem)
+    {
+      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+        "Out of memory while parsing the CSV file");
+      return false;
+    }
+    if (! csv_slice_group(groups, &slices[i], opts->z_col >= 0))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Free the groups
+ */
+static void
+csv_groups_free(csv_groups *groups)
+{
+  for (int i = 0; i < groups->ngroups; i++)
+  {
+    pfree(groups->groups[i].times);
+    pfree(groups->groups[i].xs);
+    pfree(groups->groups[i].ys);
+    if (groups->groups[i].zs)
+      pfree(groups->groups[i].zs);
+  }
+  pfree(groups->groups);
+  pfree(groups->slots);
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_inout
+ * @brief Return the temporal points read from a CSV file containing one
+ * observation per line
+ * @details The file is parsed in parallel by several threads. Fields cannot
+ * be quoted. Timestamps in the ISO 8601 format are parsed directly and are
+ * interpreted in UTC when they have no time zone, other timestamps are
+ * parsed as in #pg_timestamptz_in(). Malformed lines are skipped. The
+ * observations of each object are sorted by timestamp and, for duplicate
+ * timestamps, only the first observation is kept.
+ * @param[in] filename Name of the file
+ * @param[in] options Layout of the file
+ * @param[out] ids Identifiers of the objects
+ * @param[out] count Number of objects
+ * @return One sequence per object in the order of their first observation.
+ * On error return @p NULL
+ */
+Temporal **
+tpoint_from_csv(const char *filename, const tpointCsvOptions *options,
+  int64 **ids, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) filename) ||
+      ! ensure_not_null((void *) options) || ! ensure_not_null((void *) ids) ||
+      ! ensure_not_null((void *) count))
+    return NULL;
+  const tpointCsvOptions *opts = options;
+  if (opts->id_col < 0 || opts->t_col < 0 || opts->x_col < 0 ||
+      opts->y_col < 0 || opts->delimiter == '\n' || opts->delimiter == '\0')
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid layout of the CSV file");
+    return NULL;
+  }
+  meosType temptype = opts->geodetic ? T_TGEOGPOINT : T_TGEOMPOINT;
+  if (opts->interp == INTERP_NONE ||
+      ! ensure_valid_interp(temptype, opts->interp))
+    return NULL;
+  int maxcol = Max(Max(opts->id_col, opts->t_col),
+    Max(Max(opts->x_col, opts->y_col), opts->z_col));
+  int nthreads = (opts->nthreads > 0) ?
+    Min(opts->nthreads, CSV_MAX_THREADS) : csv_default_threads();
+  bool hasz = (opts->z_col >= 0);
+
+  FILE *file = fopen(filename, "r");
+  if (! file)
+  {
+    meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+      "Cannot open the file \"%s\": %s", filename, strerror(errno));
+    return NULL;
+  }
+
+  csv_groups groups;
+  groups.size = 1024;
+  groups.slots = palloc0(sizeof(int) * groups.size);
+  groups.maxgroups = 64;
+  groups.ngroups = 0;
+  groups.groups = palloc(sizeof(csv_group) * groups.maxgroups);
+  csv_slice *slices = palloc0(sizeof(csv_slice) * nthreads);
+  size_t bufsize = CSV_BLOCK_SIZE;
+  char *buf = palloc(bufsize);
+  size_t len = 0;
+  bool header = opts->header, ok = true;
+  while (ok)
+  {
+    size_t nread = fread(buf + len, 1, bufsize - len, file);
+    len += nread;
+    bool eof = (nread == 0);
+    if (eof && ferror(file))
+    {
+      meos_error(ERROR, MEOS_ERR_FILE_ERROR,
+        "Error while reading the file \"%s\"", filename);
+      ok = false;
+      break;
+    }
+    /* Find the end of the last complete line of the block */
+    size_t complete = len;
+    if (! eof)
+    {
+      while (complete > 0 && buf[complete - 1] != '\n')
+        complete--;
+      if (complete == 0)
+      {
+        /* The line does not fit in the buffer */
+        if (len == bufsize)
+        {
+          bufsize *= 2;
+          buf = repalloc(buf, bufsize);
+        }
+        continue;
+      }
+    }
+    size_t skip = 0;
+    if (header)
+    {
+      const char *eol = memchr(buf, '\n', complete);
+      skip = eol ? (size_t) (eol - buf + 1) : complete;
+      header = false;
+    }
+    if (complete > skip)
+      ok = csv_parse_block(&groups, opts, maxcol, slices, nthreads,
+        buf + skip, complete - skip);
+    if (eof)
+      break;
+    memmove(buf, buf + complete, len - complete);
+    len -= complete;
+  }
+  fclose(file);
+  pfree(buf);
+  for (int i = 0; i < nthreads; i++)
+    free(slices[i].rows);
+  pfree(slices);
+  if (! ok)
+  {
+    csv_groups_free(&groups);
+    return NULL;
+  }
+
+  /* Construct the sequences */
+  Temporal **result = palloc(sizeof(Temporal *) * Max(groups.ngroups, 1));
+  *ids = palloc(sizeof(int64) * Max(groups.ngroups, 1));
+  for (int i = 0; i < groups.ngroups; i++)
+  {
+    csv_group *group = &groups.groups[i];
+    if (! group->ordered)
+      csv_group_sort(group, hasz);
+    (*ids)[i] = group->id;
+    result[i] = (Temporal *) tpointseq_make_coords(group->xs, group->ys,
+      group->zs, group->times, group->count, opts->srid, opts->geodetic,
+      true, true, opts->interp, NORMALIZE);
+  }
+  *count = groups.ngroups;
+  csv_groups_free(&groups);
+  return result;
+}
+
+/*****************************************************************************/
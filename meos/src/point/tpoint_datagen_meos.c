@@ -0,0 +1,699 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Parallel BerlinMOD data generator in MEOS
+ * @details The generator follows the BerlinMOD benchmark: each vehicle has a
+ * home node and a work node of the road network, drives from home to work in
+ * the morning and back home in the afternoon of every weekday, and makes a
+ * leisure trip with some probability on the weekend days. The paths are
+ * computed by Dijkstra's algorithm on an in-memory graph of the road network
+ * whose arc costs are the travel times at the maximum speed of the edges,
+ * and each trip is simulated along its path with the function
+ * #create_trip.
+ *
+ * The vehicles are distributed among a pool of threads. The random generator
+ * of the data generator is kept per thread and is seeded at the start of each
+ * vehicle from the seed of the options and the vehicle number, so that the
+ * trips generated do not depend on the number of threads.
+ */
+
+/* C */
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* PostGIS */
+#include <liblwgeom.h>
+#include <liblwgeom_internal.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/temporal.h"
+#include "point/tpoint_datagen.h"
+
+/** Maximum number of threads of the data generator */
+#define BERLINMOD_MAX_THREADS 256
+/** Number of attempts to choose the home and work nodes of a vehicle */
+#define BERLINMOD_ATTEMPTS 16
+/** Number of vehicles for a scale factor of 1.0 */
+#define BERLINMOD_VEHICLES 2000
+/** Number of days for a scale factor of 1.0 */
+#define BERLINMOD_DAYS 28
+/** Probability of a leisure trip on a weekend day */
+#define BERLINMOD_P_LEISURE 0.4
+/** Minimum length of a segment, as required by #create_trip */
+#define BERLINMOD_EPSILON 0.0001
+
+/**
+ * @brief Structure to represent the graph of the road network in Compressed
+ * Sparse Row (CSR) format, which is shared by the threads
+ */
+typedef struct
+{
+  const berlinmodEdge *edges; /**< Edges of the road network */
+  int nnodes;            /**< Number of nodes */
+  int narcs;             /**< Number of arcs */
+  int *offsets;          /**< Offsets of the arcs of each node, nnodes + 1 */
+  int *arcsource;        /**< Node from which each arc starts */
+  int *arctarget;        /**< Node reached by each arc */
+  int *arcedge;          /**< Edge of each arc */
+  bool *arcreverse;      /**< True when the arc traverses its edge backwards */
+  double *arccost;       /**< Travel time of each arc */
+} RoadGraph;
+
+/**
+ * @brief Structure to represent the scratch space of the path searches of a
+ * thread
+ */
+typedef struct
+{
+  double *dist;          /**< Tentative cost of each node */
+  int *prev;             /**< Arc reaching each node */
+  uint32 *visit;         /**< Search in which the cost was set */
+  uint32 search;         /**< Number of the current search */
+  double *heapkeys;      /**< Keys of the binary heap */
+  int *heapnodes;        /**< Nodes of the binary heap */
+} RoadSearch;
+
+/**
+ * @brief Structure to represent the state shared by the threads of the data
+ * generator
+ */
+typedef struct
+{
+  const RoadGraph *graph;     /**< Graph of the road network */
+  const berlinmodOptions *opts; /**< Options of the generator */
+  int nvehicles;              /**< Number of vehicles */
+  int ndays;                  /**< Number of days */
+  berlinmod_trip_fn trip_fn;  /**< Function receiving the trips */
+  void *arg;                  /**< Argument passed to the function */
+  int next;                   /**< Next vehicle to simulate */
+  int ntrips;                 /**< Number of trips generated */
+  bool stop;                  /**< True when the function asked to stop */
+  pthread_mutex_t mutex;      /**< Mutex protecting the state */
+} berlinmod_state;
+
+/*****************************************************************************
+ * Road network
+ *****************************************************************************/
+
+/**
+ * @brief Comparator of node identifiers
+ */
+static int
+node_id_cmp(const int64 *l, const int64 *r)
+{
+  return (*l < *r) ? -1 : ((*l > *r) ? 1 : 0);
+}
+
+/**
+ * @brief Return the position of a node identifier in a sorted array
+ */
+static int
+node_id_find(const int64 *ids, int count, int64 id)
+{
+  int lower = 0, upper = count - 1;
+  while (lower <= upper)
+  {
+    int middle = lower + (upper - lower) / 2;
+    if (ids[middle] == id)
+      return middle;
+    if (ids[middle] < id)
+      lower = middle + 1;
+    else
+      upper = middle - 1;
+  }
+  return -1;
+}
+
+/**
+ * @brief Ensure that an edge of the road network can be simulated
+ */
+static bool
+ensure_valid_berlinmod_edge(const berlinmodEdge *edge, int i)
+{
+  if (! edge->geom || gserialized_get_type(edge->geom) != LINETYPE ||
+      gserialized_is_empty(edge->geom))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The geometry of edge %d must be a non-empty line", i);
+    return false;
+  }
+  if (edge->maxspeed <= 0.0 || edge->category < 0 || edge->category > 2)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Edge %d must have a positive maximum speed and a category in [0, 2]",
+      i);
+    return false;
+  }
+  LWLINE *line = lwgeom_as_lwline(lwgeom_from_gserialized(edge->geom));
+  bool result = line->points->npoints > 1;
+  for (uint32_t j = 1; result && j < line->points->npoints; j++)
+  {
+    const POINT2D *p1 = getPoint2d_cp(line->points, j - 1);
+    const POINT2D *p2 = getPoint2d_cp(line->points, j);
+    result = hypot(p1->x - p2->x, p1->y - p2->y) >= BERLINMOD_EPSILON;
+  }
+  lwline_free(line);
+  if (! result)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The geometry of edge %d has a segment of zero length", i);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Return the graph of a road network
+ * @return On error return @p NULL
+ */
+static RoadGraph *
+road_graph_make(const berlinmodEdge *edges, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_valid_berlinmod_edge(&edges[i], i))
+      return NULL;
+  }
+
+  /* The nodes are the distinct identifiers of the end nodes of the edges */
+  int64 *ids = palloc(sizeof(int64) * count * 2);
+  for (int i = 0; i < count; i++)
+  {
+    ids[2 * i] = edges[i].source;
+    ids[2 * i + 1] = edges[i].target;
+  }
+  qsort(ids, (size_t) count * 2, sizeof(int64),
+    (qsort_comparator) &node_id_cmp);
+  int nnodes = 0;
+  for (int i = 0; i < count * 2; i++)
+  {
+    if (i == 0 || ids[i] != ids[nnodes - 1])
+      ids[nnodes++] = ids[i];
+  }
+
+  RoadGraph *g = palloc0(sizeof(RoadGraph));
+  g->edges = edges;
+  g->nnodes = nnodes;
+  g->offsets = palloc0(sizeof(int) * (nnodes + 1));
+  int *source = palloc(sizeof(int) * count);
+  int *target = palloc(sizeof(int) * count);
+  int narcs = 0;
+  for (int i = 0; i < count; i++)
+  {
+    source[i] = node_id_find(ids, nnodes, edges[i].source);
+    target[i] = node_id_find(ids, nnodes, edges[i].target);
+    g->offsets[source[i] + 1]++;
+    narcs++;
+    if (! edges[i].oneway)
+    {
+      g->offsets[target[i] + 1]++;
+      narcs++;
+    }
+  }
+  pfree(ids);
+  for (int i = 0; i < nnodes; i++)
+    g->offsets[i + 1] += g->offsets[i];
+
+  /* Build the arcs, the edges that are not one way give an arc in each
+   * direction */
+  g->narcs = narcs;
+  g->arcsource = palloc(sizeof(int) * narcs);
+  g->arctarget = palloc(sizeof(int) * narcs);
+  g->arcedge = palloc(sizeof(int) * narcs);
+  g->arcreverse = palloc(sizeof(bool) * narcs);
+  g->arccost = palloc(sizeof(double) * narcs);
+  int *fill = palloc(sizeof(int) * nnodes);
+  memcpy(fill, g->offsets, sizeof(int) * nnodes);
+  for (int i = 0; i < count; i++)
+  {
+    LWGEOM *geom = lwgeom_from_gserialized(edges[i].geom);
+    /* Travel time in seconds at the maximum speed given in km/h */
+    double cost = lwgeom_length_2d(geom) / (edges[i].maxspeed / 3.6);
+    lwgeom_free(geom);
+    for (int dir = 0; dir < (edges[i].oneway ? 1 : 2); dir++)
+    {
+      int from = dir ? target[i] : source[i];
+      int k = fill[from]++;
+      g->arcsource[k] = from;
+      g->arctarget[k] = dir ? source[i] : target[i];
+      g->arcedge[k] = i;
+      g->arcreverse[k] = (dir == 1);
+      g->arccost[k] = cost;
+    }
+  }
+  pfree(fill); pfree(source); pfree(target);
+  return g;
+}
+
+/**
+ * @brief Free the graph of a road network
+ */
+static void
+road_graph_free(RoadGraph *g)
+{
+  pfree(g->offsets); pfree(g->arcsource); pfree(g->arctarget);
+  pfree(g->arcedge); pfree(g->arcreverse); pfree(g->arccost); pfree(g);
+  return;
+}
+
+/**
+ * @brief Initialize the scratch space of the path searches of a thread
+ */
+static void
+road_search_init(RoadSearch *s, const RoadGraph *g)
+{
+  s->dist = palloc(sizeof(double) * g->nnodes);
+  s->prev = palloc(sizeof(int) * g->nnodes);
+  s->visit = palloc0(sizeof(uint32) * g->nnodes);
+  s->search = 0;
+  /* The heap keeps at most one entry per relaxed arc plus the source */
+  s->heapkeys = palloc(sizeof(double) * (g->narcs + 1));
+  s->heapnodes = palloc(sizeof(int) * (g->narcs + 1));
+  return;
+}
+
+/**
+ * @brief Free the scratch space of the path searches of a thread
+ */
+static void
+road_search_free(RoadSearch *s)
+{
+  pfree(s->dist); pfree(s->prev); pfree(s->visit);
+  pfree(s->heapkeys); pfree(s->heapnodes);
+  return;
+}
+
+/**
+ * @brief Return true if a node has been reached by the current search
+ */
+static inline bool
+road_reached(const RoadSearch *s, int node)
+{
+  return s->visit[node] == s->search;
+}
+
+/**
+ * @brief Compute the least-cost paths from a node with Dijkstra's algorithm,
+ * stopping when the target node is settled if it is not negative
+ */
+static void
+road_dijkstra(const RoadGraph *g, RoadSearch *s, int source, int target)
+{
+  s->search++;
+  int count = 0;
+  s->dist[source] = 0.0;
+  s->prev[source] = -1;
+  s->visit[source] = s->search;
+  s->heapkeys[0] = 0.0;
+  s->heapnodes[count++] = source;
+  while (count > 0)
+  {
+    /* Pop the minimum of the heap */
+    double key = s->heapkeys[0];
+    int node = s->heapnodes[0];
+    count--;
+    int i = 0;
+    while (true)
+    {
+      int child = 2 * i + 1;
+      if (child >= count)
+        break;
+      if (child + 1 < count && s->heapkeys[child + 1] < s->heapkeys[child])
+        child++;
+      if (s->heapkeys[count] <= s->heapkeys[child])
+        break;
+      s->heapkeys[i] = s->heapkeys[child];
+      s->heapnodes[i] = s->heapnodes[child];
+      i = child;
+    }
+    s->heapkeys[i] = s->heapkeys[count];
+    s->heapnodes[i] = s->heapnodes[count];
+
+    /* Skip the entries of the nodes already settled with a lower cost */
+    if (key > s->dist[node])
+      continue;
+    if (node == target)
+      break;
+    for (int k = g->offsets[node]; k < g->offsets[node + 1]; k++)
+    {
+      int next = g->arctarget[k];
+      double cost = key + g->arccost[k];
+      if (road_reached(s, next) && s->dist[next] <= cost)
+        continue;
+      s->dist[next] = cost;
+      s->prev[next] = k;
+      s->visit[next] = s->search;
+      /* Push the node into the heap */
+      int j = count++;
+      while (j > 0 && s->heapkeys[(j - 1) / 2] > cost)
+      {
+        s->heapkeys[j] = s->heapkeys[(j - 1) / 2];
+        s->heapnodes[j] = s->heapnodes[(j - 1) / 2];
+        j = (j - 1) / 2;
+      }
+      s->heapkeys[j] = cost;
+      s->heapnodes[j] = next;
+    }
+  }
+  return;
+}
+
+/**
+ * @brief Return the arcs of the path to a node found by the last search
+ * @param[out] count Number of arcs
+ */
+static int *
+road_path(const RoadGraph *g, const RoadSearch *s, int target, int *count)
+{
+  int n = 0;
+  for (int k = s->prev[target]; k >= 0; k = s->prev[g->arcsource[k]])
+    n++;
+  int *result = palloc(sizeof(int) * Max(n, 1));
+  *count = n;
+  for (int k = s->prev[target]; k >= 0; k = s->prev[g->arcsource[k]])
+    result[--n] = k;
+  return result;
+}
+
+/**
+ * @brief Choose a node reached by the last search other than a given node
+ * @return Return -1 if no other node has been reached
+ */
+static int
+road_random_reached(const RoadGraph *g, const RoadSearch *s, gsl_rng *rng,
+  int node)
+{
+  int start = (int) gsl_rng_uniform_int(rng, (unsigned long) g->nnodes);
+  for (int i = 0; i < g->nnodes; i++)
+  {
+    int n = (start + i) % g->nnodes;
+    if (n != node && road_reached(s, n))
+      return n;
+  }
+  return -1;
+}
+
+/*****************************************************************************
+ * Trip generation
+ *****************************************************************************/
+
+/**
+ * @brief Return a trip simulated along a path
+ */
+static TSequence *
+berlinmod_trip(const RoadGraph *g, const int *path, int count,
+  TimestampTz start, bool disturb)
+{
+  /* The lines are freed by the function create_trip */
+  LWLINE **lines = palloc(sizeof(LWLINE *) * count);
+  double *maxspeeds = palloc(sizeof(double) * count);
+  int *categories = palloc(sizeof(int) * count);
+  for (int i = 0; i < count; i++)
+  {
+    const berlinmodEdge *edge = &g->edges[g->arcedge[path[i]]];
+    LWLINE *line = lwgeom_as_lwline(lwgeom_from_gserialized(edge->geom));
+    if (g->arcreverse[path[i]])
+    {
+      LWLINE *copy = lwgeom_as_lwline(lwgeom_clone_deep(
+        lwline_as_lwgeom(line)));
+      lwline_free(line);
+      ptarray_reverse_in_place(copy->points);
+      line = copy;
+    }
+    lines[i] = line;
+    maxspeeds[i] = edge->maxspeed;
+    categories[i] = edge->category;
+  }
+  TSequence *result = create_trip(lines, maxspeeds, categories,
+    (uint32_t) count, start, disturb, 0);
+  pfree(maxspeeds); pfree(categories);
+  return result;
+}
+
+/**
+ * @brief Pass a trip to the function of the generator
+ * @return Return false when the generation must stop
+ */
+static bool
+berlinmod_emit(berlinmod_state *state, int vehicle, int day, int seq,
+  TSequence *trip)
+{
+  pthread_mutex_lock(&state->mutex);
+  if (! state->stop)
+  {
+    state->ntrips++;
+    if (! state->trip_fn(vehicle, day, seq, trip, state->arg))
+      state->stop = true;
+  }
+  else
+    pfree(trip);
+  bool result = ! state->stop;
+  pthread_mutex_unlock(&state->mutex);
+  return result;
+}
+
+/**
+ * @brief Return a random duration in microseconds of a normal distribution
+ * truncated to two standard deviations
+ */
+static int64
+berlinmod_pause(gsl_rng *rng, int64 sigma)
+{
+  double value = gsl_ran_gaussian(rng, 1.0);
+  value = Max(-2.0, Min(2.0, value));
+  return (int64) (value * sigma);
+}
+
+/**
+ * @brief Simulate the trips of a vehicle
+ */
+static void
+berlinmod_vehicle(berlinmod_state *state, RoadSearch *s, int vehicle)
+{
+  const RoadGraph *g = state->graph;
+  const berlinmodOptions *opts = state->opts;
+  gsl_rng *rng = gsl_get_generation_rng();
+  gsl_rng_set(rng, opts->seed + (unsigned long) vehicle);
+
+  /* Choose the home and work nodes such that both commuting trips exist */
+  int home = -1, work = -1, ntowork = 0, ntohome = 0;
+  int *towork = NULL, *tohome = NULL;
+  for (int i = 0; i < BERLINMOD_ATTEMPTS && ! tohome; i++)
+  {
+    home = (int) gsl_rng_uniform_int(rng, (unsigned long) g->nnodes);
+    road_dijkstra(g, s, home, -1);
+    work = road_random_reached(g, s, rng, home);
+    if (work < 0)
+      continue;
+    towork = road_path(g, s, work, &ntowork);
+    road_dijkstra(g, s, work, home);
+    if (road_reached(s, home))
+      tohome = road_path(g, s, home, &ntohome);
+    else
+    {
+      pfree(towork);
+      towork = NULL;
+    }
+  }
+  if (! tohome)
+    return;
+
+  /* Day number of the first day counted from Saturday 2000-01-01 */
+  int64 day0 = state->opts->startday / USECS_PER_DAY -
+    (state->opts->startday % USECS_PER_DAY < 0);
+  bool cont = true;
+  for (int d = 0; d < state->ndays && cont; d++)
+  {
+    TimestampTz day = opts->startday + (TimestampTz) d * USECS_PER_DAY;
+    int dow = (int) (((day0 + d) % 7 + 7) % 7);
+    if (dow >= 2)
+    {
+      /* Weekday: commute to work in the morning and back in the afternoon */
+      TimestampTz t = day + 8 * USECS_PER_HOUR +
+        berlinmod_pause(rng, 30 * USECS_PER_MINUTE);
+      TSequence *trip = berlinmod_trip(g, towork, ntowork, t, opts->disturb);
+      TimestampTz end = DatumGetTimestampTz(trip->period.upper);
+      cont = berlinmod_emit(state, vehicle, d + 1, 1, trip);
+      t = day + 16 * USECS_PER_HOUR +
+        berlinmod_pause(rng, 30 * USECS_PER_MINUTE);
+      t = Max(t, end + USECS_PER_MINUTE);
+      if (cont)
+        cont = berlinmod_emit(state, vehicle, d + 1, 2,
+          berlinmod_trip(g, tohome, ntohome, t, opts->disturb));
+    }
+    else if (gsl_rng_uniform(rng) <= BERLINMOD_P_LEISURE)
+    {
+      /* Weekend: leisure trip to a random destination and back home */
+      road_dijkstra(g, s, home, -1);
+      int dest = road_random_reached(g, s, rng, home);
+      if (dest < 0)
+        continue;
+      int nout, nback;
+      int *out = road_path(g, s, dest, &nout);
+      road_dijkstra(g, s, dest, home);
+      if (! road_reached(s, home))
+      {
+        pfree(out);
+        continue;
+      }
+      int *back = road_path(g, s, home, &nback);
+      TimestampTz t = day + 10 * USECS_PER_HOUR +
+        (int64) (gsl_rng_uniform(rng) * 6 * USECS_PER_HOUR);
+      TSequence *trip = berlinmod_trip(g, out, nout, t, opts->disturb);
+      TimestampTz end = DatumGetTimestampTz(trip->period.upper);
+      cont = berlinmod_emit(state, vehicle, d + 1, 1, trip);
+      t = end + USECS_PER_HOUR +
+        (int64) (gsl_ran_exponential(rng, 1.0) * USECS_PER_HOUR);
+      if (cont)
+        cont = berlinmod_emit(state, vehicle, d + 1, 2,
+          berlinmod_trip(g, back, nback, t, opts->disturb));
+      pfree(out); pfree(back);
+    }
+  }
+  pfree(towork); pfree(tohome);
+  return;
+}
+
+/**
+ * @brief Simulate vehicles until all of them are taken
+ */
+static void
+berlinmod_run(berlinmod_state *state)
+{
+  RoadSearch search;
+  road_search_init(&search, state->graph);
+  while (true)
+  {
+    pthread_mutex_lock(&state->mutex);
+    int vehicle = state->stop ? state->nvehicles + 1 : ++state->next;
+    pthread_mutex_unlock(&state->mutex);
+    if (vehicle > state->nvehicles)
+      break;
+    berlinmod_vehicle(state, &search, vehicle);
+  }
+  road_search_free(&search);
+  return;
+}
+
+/**
+ * @brief Start function of the threads of the data generator
+ */
+static void *
+berlinmod_thread(void *arg)
+{
+  meos_initialize_thread(NULL);
+  berlinmod_run((berlinmod_state *) arg);
+  meos_finalize_thread();
+  return NULL;
+}
+
+/**
+ * @ingroup meos_misc
+ * @brief Generate the trips of the BerlinMOD benchmark on a road network
+ * @details The number of vehicles and of days are by default those of
+ * BerlinMOD, that is, `round(2000 * sqrt(scalefactor))` vehicles during
+ * `round(28 * sqrt(scalefactor))` days. The vehicles are simulated in
+ * parallel and each trip is passed to the function @p trip_fn, which takes
+ * ownership of the trip. The calls to the function are serialized, so that
+ * it needs not be thread safe.
+ * @param[in] edges Edges of the road network, whose geometries must remain
+ * valid during the call
+ * @param[in] count Number of edges
+ * @param[in] opts Options of the generator
+ * @param[in] trip_fn Function receiving the vehicle number, the day number,
+ * the sequence number of the trip in the day, and the trip, which returns
+ * false to stop the generation
+ * @param[in] arg Argument passed to the function
+ * @return Number of trips generated, on error return -1
+ * @note The random generator of the data generator of the calling thread,
+ * which also simulates vehicles, is reseeded
+ */
+int
+berlinmod_generate(const berlinmodEdge *edges, int count,
+  const berlinmodOptions *opts, berlinmod_trip_fn trip_fn, void *arg)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) edges) || ! ensure_not_null((void *) opts) ||
+      ! ensure_not_null((void *) trip_fn) || ! ensure_positive(count))
+    return -1;
+  if (opts->nvehicles <= 0 || opts->ndays <= 0)
+  {
+    if (! ensure_positive_datum(Float8GetDatum(opts->scalefactor), T_FLOAT8))
+      return -1;
+  }
+
+  RoadGraph *g = road_graph_make(edges, count);
+  if (! g)
+    return -1;
+  berlinmod_state state;
+  memset(&state, 0, sizeof(berlinmod_state));
+  state.graph = g;
+  state.opts = opts;
+  state.nvehicles = opts->nvehicles > 0 ? opts->nvehicles :
+    Max(1, (int) round(BERLINMOD_VEHICLES * sqrt(opts->scalefactor)));
+  state.ndays = opts->ndays > 0 ? opts->ndays :
+    Max(1, (int) round(BERLINMOD_DAYS * sqrt(opts->scalefactor)));
+  state.trip_fn = trip_fn;
+  state.arg = arg;
+  pthread_mutex_init(&state.mutex, NULL);
+
+  int nthreads = opts->nthreads;
+  if (nthreads <= 0)
+  {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = (n < 1) ? 1 : (int) n;
+  }
+  nthreads = Min(Min(nthreads, BERLINMOD_MAX_THREADS), state.nvehicles);
+
+  /* The calling thread simulates the vehicles not taken by the other
+   * threads, including those of the threads that could not be started */
+  pthread_t threads[BERLINMOD_MAX_THREADS];
+  bool started[BERLINMOD_MAX_THREADS];
+  for (int i = 1; i < nthreads; i++)
+    started[i] = pthread_create(&threads[i], NULL, berlinmod_thread,
+      &state) == 0;
+  berlinmod_run(&state);
+  for (int i = 1; i < nthreads; i++)
+  {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&state.mutex);
+  road_graph_free(g);
+  return state.ntrips;
+}
+
+/*****************************************************************************/
@@ -42,11 +42,15 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/lifting.h"
+#include "general/span.h"
 #include "general/tinstant.h"
 #include "general/tsequence.h"
+#include "general/type_util.h"
 #include "point/pgis_types.h"
 #include "point/geography_funcs.h"
+#include "point/tpoint_restrfuncs.h"
 #include "point/tpoint_spatialfuncs.h"
+#include "point/tpoint_spatialrels.h"
 
 /* Function not exported by PostGIS */
 double circ_tree_distance_tree_internal(const CIRC_NODE* n1, const CIRC_NODE* n2, double threshold, double* min_dist, double* max_dist, GEOGRAPHIC_POINT* closest1, GEOGRAPHIC_POINT* closest2);
@@ -120,6 +124,8 @@ lw_distance_fraction(const LWGEOM *geom1, const LWGEOM *geom2, int mode,
     CIRC_NODE *circ_tree2 = lwgeom_calculate_circ_tree(geom2);
     circ_tree_distance_tree_internal(circ_tree1, circ_tree2, FP_TOLERANCE,
       &min_dist, &max_dist, &closest1, &closest2);
+    circ_tree_free(circ_tree1);
+    circ_tree_free(circ_tree2);
     result = sphere_distance(&closest1, &closest2);
     if (fraction != NULL)
     {
@@ -440,7 +446,10 @@ distance_tpoint_point(const Temporal *temp, const GSERIALIZED *gs)
 
   LiftedFunctionInfo lfinfo;
   memset(&lfinfo, 0, sizeof(LiftedFunctionInfo));
-  lfinfo.func = (varfunc) distance_fn(temp->flags);
+  /* Both arguments are points, which is required by the fast geodetic mode */
+  lfinfo.func = (MEOS_FLAGS_GET_GEODETIC(temp->flags) &&
+      meos_get_fast_geodetic()) ?
+    (varfunc) &geog_point_distance_fast : (varfunc) distance_fn(temp->flags);
   lfinfo.numparam = 0;
   lfinfo.argtype[0] = temp->temptype;
   lfinfo.argtype[1] = temptype_basetype(temp->temptype);
@@ -483,6 +492,199 @@ distance_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
   return tfunc_temporal_temporal(temp1, temp2, &lfinfo);
 }
 
+/*****************************************************************************
+ * Branch-and-bound nearest approach between two temporal points
+ *****************************************************************************/
+
+/**
+ * @brief Number of segments per chunk whose bounding boxes are used for
+ * pruning in the branch-and-bound computation of the nearest approach
+ */
+#define NAD_CHUNK_SEGS 16
+
+/**
+ * @brief Lower bound of the distance between the points of a chunk of the
+ * first sequence and the points of the same chunk of the second one
+ */
+typedef struct
+{
+  double lower;  /**< Distance between the bounding boxes of the chunks */
+  int chunk;     /**< Number of the chunk */
+} NADChunk;
+
+/**
+ * @brief Comparator function for chunks
+ */
+static int
+nad_chunk_cmp(const void *a, const void *b)
+{
+  double l1 = ((const NADChunk *) a)->lower;
+  double l2 = ((const NADChunk *) b)->lower;
+  return (l1 < l2) ? -1 : ((l1 > l2) ? 1 : 0);
+}
+
+/**
+ * @brief Return the distance between the spatial extents of two boxes
+ */
+static double
+nad_stbox_stbox_spatial(const STBox *box1, const STBox *box2, bool hasz)
+{
+  double dx = Max(0.0, Max(box1->xmin - box2->xmax, box2->xmin - box1->xmax));
+  double dy = Max(0.0, Max(box1->ymin - box2->ymax, box2->ymin - box1->ymax));
+  double dz = hasz ?
+    Max(0.0, Max(box1->zmin - box2->zmax, box2->zmin - box1->zmax)) : 0.0;
+  return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+/**
+ * @brief Update the current nearest approach with a new candidate,
+ * choosing the earliest timestamp on ties as done by the minimum instant of
+ * the temporal distance
+ */
+static inline void
+nad_update(double dist, TimestampTz t, double *mindist, TimestampTz *mint)
+{
+  if (dist < *mindist || (dist == *mindist && t < *mint))
+  {
+    *mindist = dist;
+    *mint = t;
+  }
+}
+
+/**
+ * @brief Update the current nearest approach between two synchronized
+ * temporal geometry point sequences with linear interpolation using
+ * branch-and-bound over the bounding boxes of chunks of their segments
+ * (iterator function)
+ * @param[in] seq1,seq2 Synchronized temporal points
+ * @param[in] bound Stop as soon as a distance strictly less than this value
+ * is found, a negative value computes the exact nearest approach
+ * @param[in,out] mindist Current minimum distance
+ * @param[in,out] mint Timestamp of the current minimum distance
+ */
+static void
+nad_tpointseq_tpointseq_bb_iter(const TSequence *seq1, const TSequence *seq2,
+  double bound, double *mindist, TimestampTz *mint)
+{
+  assert(seq1->count == seq2->count);
+  datum_func2 func = pt_distance_fn(seq1->flags);
+  if (seq1->count == 1)
+  {
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq1, 0);
+    nad_update(tpointinst_distance(inst1, TSEQUENCE_INST_N(seq2, 0), func),
+      inst1->t, mindist, mint);
+    return;
+  }
+
+  /* Compute the boxes of the chunks, both sequences have the same number of
+   * instants and thus they are split in the same way */
+  int nsegs = seq1->count - 1;
+  int max_count = (nsegs + NAD_CHUNK_SEGS - 1) / NAD_CHUNK_SEGS;
+  int nboxes1, nboxes2;
+  STBox *boxes1 = tpointseq_stboxes(seq1, max_count, &nboxes1);
+  STBox *boxes2 = tpointseq_stboxes(seq2, max_count, &nboxes2);
+  assert(nboxes1 == nboxes2);
+  bool hasz = MEOS_FLAGS_GET_Z(seq1->flags);
+  NADChunk *chunks = palloc(sizeof(NADChunk) * nboxes1);
+  for (int k = 0; k < nboxes1; k++)
+  {
+    chunks[k].lower = nad_stbox_stbox_spatial(&boxes1[k], &boxes2[k], hasz);
+    chunks[k].chunk = k;
+  }
+  pfree(boxes1); pfree(boxes2);
+  qsort(chunks, nboxes1, sizeof(NADChunk), &nad_chunk_cmp);
+
+  /* Partition of the segments into chunks as done in tpointseq_stboxes */
+  int size = (nboxes1 < nsegs) ? nsegs / nboxes1 : 1;
+  int remainder = (nboxes1 < nsegs) ? nsegs % nboxes1 : 0;
+  for (int k = 0; k < nboxes1; k++)
+  {
+    /* Prune the remaining chunks, keeping those that may contain a tie at
+     * an earlier timestamp */
+    if (chunks[k].lower > *mindist || *mindist < bound)
+      break;
+    int c = chunks[k].chunk;
+    int first = c * size + Min(c, remainder);
+    int last = first + size + (c < remainder ? 1 : 0);
+    const TInstant *start1 = TSEQUENCE_INST_N(seq1, first);
+    const TInstant *start2 = TSEQUENCE_INST_N(seq2, first);
+    nad_update(tpointinst_distance(start1, start2, func), start1->t, mindist,
+      mint);
+    for (int i = first + 1; i <= last; i++)
+    {
+      const TInstant *end1 = TSEQUENCE_INST_N(seq1, i);
+      const TInstant *end2 = TSEQUENCE_INST_N(seq2, i);
+      Datum value;
+      TimestampTz t;
+      if (tgeompoint_min_dist_at_timestamptz(start1, end1, start2, end2,
+          &value, &t) && t != start1->t)
+        nad_update(DatumGetFloat8(value), t, mindist, mint);
+      nad_update(tpointinst_distance(end1, end2, func), end1->t, mindist,
+        mint);
+      start1 = end1;
+      start2 = end2;
+    }
+  }
+  pfree(chunks);
+  return;
+}
+
+/**
+ * @brief Return true if the nearest approach between two temporal points
+ * can be computed with branch-and-bound
+ * @details This is the case for temporal geometry point sequences or
+ * sequence sets with linear interpolation, the other cases are computed from
+ * the temporal distance
+ */
+static bool
+nad_tpoint_tpoint_bb_valid(const Temporal *temp1, const Temporal *temp2)
+{
+  return temp1->subtype != TINSTANT && temp2->subtype != TINSTANT &&
+    MEOS_FLAGS_LINEAR_INTERP(temp1->flags) &&
+    MEOS_FLAGS_LINEAR_INTERP(temp2->flags) &&
+    ! MEOS_FLAGS_GET_GEODETIC(temp1->flags);
+}
+
+/**
+ * @brief Compute the nearest approach between two temporal points using
+ * branch-and-bound
+ * @param[in] temp1,temp2 Temporal points
+ * @param[in] bound Stop as soon as a distance strictly less than this value
+ * is found, a negative value computes the exact nearest approach
+ * @param[out] mindist Minimum distance
+ * @param[out] mint Timestamp of the minimum distance
+ * @return False if the temporal points do not intersect on time
+ * @pre The function #nad_tpoint_tpoint_bb_valid returns true
+ */
+static bool
+nad_tpoint_tpoint_bb(const Temporal *temp1, const Temporal *temp2,
+  double bound, double *mindist, TimestampTz *mint)
+{
+  Temporal *sync1, *sync2;
+  if (! intersection_temporal_temporal(temp1, temp2, SYNCHRONIZE_NOCROSS,
+      &sync1, &sync2))
+    return false;
+
+  *mindist = DBL_MAX;
+  *mint = DT_NOEND;
+  if (sync1->subtype == TINSTANT)
+    nad_update(tpointinst_distance((TInstant *) sync1, (TInstant *) sync2,
+      pt_distance_fn(sync1->flags)), ((TInstant *) sync1)->t, mindist, mint);
+  else if (sync1->subtype == TSEQUENCE)
+    nad_tpointseq_tpointseq_bb_iter((TSequence *) sync1, (TSequence *) sync2,
+      bound, mindist, mint);
+  else /* TSEQUENCESET */
+  {
+    const TSequenceSet *ss1 = (TSequenceSet *) sync1;
+    const TSequenceSet *ss2 = (TSequenceSet *) sync2;
+    for (int i = 0; i < ss1->count && *mindist >= bound; i++)
+      nad_tpointseq_tpointseq_bb_iter(TSEQUENCESET_SEQ_N(ss1, i),
+        TSEQUENCESET_SEQ_N(ss2, i), bound, mindist, mint);
+  }
+  pfree(sync1); pfree(sync2);
+  return true;
+}
+
 /*****************************************************************************
  * Nearest approach instant (NAI)
  *****************************************************************************/
@@ -694,6 +896,90 @@ nai_tpointseqset_linear_geo(const TSequenceSet *ss, const LWGEOM *geo)
   return tinstant_make_free(value, ss->temptype, t);
 }
 
+/**
+ * @brief Return the distance and the timestamp of the nearest approach instant
+ * between a temporal sequence point with linear interpolation and the
+ * geometry of an edge index (iterator function)
+ * @details The entries of the index that are not closer than the minimum
+ * distance found so far are pruned. For a polygon, a start point that is not
+ * in the exterior is at distance zero, otherwise the sequence must cross the
+ * boundary to reach the interior.
+ * @param[in] seq Temporal point
+ * @param[in] index Edge index
+ * @param[in] mindist Minimum distance found so far, or DBL_MAX at the beginning
+ * @param[out] t Timestamp
+ * @param[in,out] edges,maxedges Array used for the queries of the index and
+ * its size
+ */
+static double
+nai_tpointseq_linear_edge_index_iter(const TSequence *seq,
+  const EdgeIndex *index, double mindist, TimestampTz *t, int **edges,
+  int *maxedges)
+{
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  if (index->areal && edge_index_locate_point(index,
+        DATUM_POINT2D_P(tinstant_val(inst1)), edges, maxedges) !=
+      EDGEINDEX_EXTERIOR)
+  {
+    *t = inst1->t;
+    return 0.0;
+  }
+  int nsegs = Max(1, seq->count - 1);
+  for (int i = 0; i < nsegs && mindist > 0.0; i++)
+  {
+    inst1 = TSEQUENCE_INST_N(seq, i);
+    const TInstant *inst2 = (seq->count == 1) ? inst1 :
+      TSEQUENCE_INST_N(seq, i + 1);
+    double fraction;
+    double dist = edge_index_segment_distance(index,
+      DATUM_POINT2D_P(tinstant_val(inst1)),
+      DATUM_POINT2D_P(tinstant_val(inst2)), mindist, &fraction);
+    if (dist < 0.0 || dist >= mindist)
+      continue;
+    mindist = dist;
+    if (fabs(fraction) < MEOS_EPSILON)
+      *t = inst1->t;
+    else if (fabs(fraction - 1.0) < MEOS_EPSILON)
+      *t = inst2->t;
+    else
+    {
+      double duration = (double) (inst2->t - inst1->t);
+      *t = inst1->t + (TimestampTz) (duration * fraction);
+    }
+  }
+  return mindist;
+}
+
+/**
+ * @brief Return the nearest approach instant between a temporal point with
+ * linear interpolation and the geometry of an edge index
+ * @param[in] temp Temporal point
+ * @param[in] index Edge index
+ */
+static TInstant *
+nai_tpoint_linear_edge_index(const Temporal *temp, const EdgeIndex *index)
+{
+  int maxedges = 64;
+  int *edges = palloc(sizeof(int) * maxedges);
+  TimestampTz t = 0; /* make compiler quiet */
+  double mindist = DBL_MAX;
+  if (temp->subtype == TSEQUENCE)
+    nai_tpointseq_linear_edge_index_iter((TSequence *) temp, index, mindist,
+      &t, &edges, &maxedges);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count && mindist > 0.0; i++)
+      mindist = nai_tpointseq_linear_edge_index_iter(TSEQUENCESET_SEQ_N(ss, i),
+        index, mindist, &t, &edges, &maxedges);
+  }
+  pfree(edges);
+  /* The closest point may be at an exclusive bound */
+  Datum value;
+  temporal_value_at_timestamptz(temp, t, false, &value);
+  return tinstant_make_free(value, temp->temptype, t);
+}
+
 /*****************************************************************************/
 
 /**
@@ -712,6 +998,15 @@ nai_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
       ! ensure_same_dimensionality_tpoint_gs(temp, gs))
     return NULL;
 
+  /* Use an index of the edges of large lines and polygons */
+  if (temp->subtype != TINSTANT && MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+  {
+    const EdgeIndex *index = tpoint_geo_dist_edge_index(temp, gs,
+      EDGEINDEX_MIN_POINTS);
+    if (index)
+      return nai_tpoint_linear_edge_index(temp, index);
+  }
+
   LWGEOM *geo = lwgeom_from_gserialized(gs);
   TInstant *result;
   assert(temptype_subtype(temp->subtype));
@@ -748,6 +1043,19 @@ nai_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_dimensionality(temp1->flags, temp2->flags))
     return NULL;
 
+  /* Use branch-and-bound when the segments of the points can be pruned */
+  if (nad_tpoint_tpoint_bb_valid(temp1, temp2))
+  {
+    double mindist;
+    TimestampTz t;
+    if (! nad_tpoint_tpoint_bb(temp1, temp2, -1.0, &mindist, &t))
+      return NULL;
+    /* The closest point may be at an exclusive bound */
+    Datum value;
+    temporal_value_at_timestamptz(temp1, t, false, &value);
+    return tinstant_make_free(value, temp1->temptype, t);
+  }
+
   /* Compute the temporal distance, it may be NULL if the points do not
    * intersect on time */
   Temporal *dist = distance_tpoint_tpoint(temp1, temp2);
@@ -782,11 +1090,11 @@ nad_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
       ! ensure_same_dimensionality_tpoint_gs(temp, gs))
     return -1.0;
 
+  /* Reuse the trajectory, and for geographies its circular tree, computed
+   * in the previous call for the same temporal point */
   datum_func2 func = distance_fn(temp->flags);
-  Datum traj = PointerGetDatum(tpoint_trajectory(temp));
-  double result = DatumGetFloat8(func(traj, PointerGetDatum(gs)));
-  pfree(DatumGetPointer(traj));
-  return result;
+  Datum traj = PointerGetDatum(tpoint_trajectory_cache(temp));
+  return DatumGetFloat8(func(traj, PointerGetDatum(gs)));
 }
 
 /**
@@ -907,6 +1215,15 @@ nad_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
       ! ensure_same_dimensionality(temp1->flags, temp2->flags))
     return -1.0;
 
+  /* Use branch-and-bound when the segments of the points can be pruned */
+  if (nad_tpoint_tpoint_bb_valid(temp1, temp2))
+  {
+    double result;
+    TimestampTz t;
+    return nad_tpoint_tpoint_bb(temp1, temp2, -1.0, &result, &t) ?
+      result : -1.0;
+  }
+
   Temporal *dist = distance_tpoint_tpoint(temp1, temp2);
   if (dist == NULL)
     return -1.0;
@@ -916,6 +1233,42 @@ nad_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
   return result;
 }
 
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return 1 if the nearest approach distance between two temporal
+ * points is strictly less than a distance, 0 if not, and -1 if the temporal
+ * points do not intersect on time
+ * @details The computation stops as soon as a pair of synchronized segments
+ * closer than the distance is found
+ * @param[in] temp1,temp2 Temporal points
+ * @param[in] dist Distance
+ * @return On error return -1
+ */
+int
+nad_tpoint_tpoint_lt(const Temporal *temp1, const Temporal *temp2,
+  double dist)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_tpoint_tpoint(temp1, temp2) ||
+      ! ensure_same_dimensionality(temp1->flags, temp2->flags) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+    return -1;
+
+  if (nad_tpoint_tpoint_bb_valid(temp1, temp2))
+  {
+    double mindist;
+    TimestampTz t;
+    if (! nad_tpoint_tpoint_bb(temp1, temp2, dist, &mindist, &t))
+      return -1;
+    return mindist < dist ? 1 : 0;
+  }
+
+  double mindist = nad_tpoint_tpoint(temp1, temp2);
+  if (mindist < 0.0)
+    return -1;
+  return mindist < dist ? 1 : 0;
+}
+
 /*****************************************************************************
  * ShortestLine
  *****************************************************************************/
@@ -1019,3 +1372,568 @@ shortestline_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Continuous k nearest neighbours
+ *****************************************************************************/
+
+/**
+ * @brief Distance from the reference point of a candidate at a time
+ */
+typedef struct
+{
+  double dist;  /**< Distance to the reference point */
+  int cand;     /**< Number of the candidate */
+} KNNEntry;
+
+/**
+ * @brief Comparator function for the candidates, ties are broken by the
+ * number of the candidate to make the result deterministic
+ */
+static int
+knn_entry_cmp(const void *a, const void *b)
+{
+  const KNNEntry *e1 = (const KNNEntry *) a;
+  const KNNEntry *e2 = (const KNNEntry *) b;
+  if (e1->dist != e2->dist)
+    return (e1->dist < e2->dist) ? -1 : 1;
+  return (e1->cand < e2->cand) ? -1 : ((e1->cand > e2->cand) ? 1 : 0);
+}
+
+/**
+ * @brief Add a span to the spans of the k nearest candidates at a time
+ * @param[in] entries Distances of the candidates defined at the time
+ * @param[in] nentries Number of entries
+ * @param[in] k Number of neighbours
+ * @param[in] lower,upper,lower_inc,upper_inc Bounds of the span
+ * @param[in,out] spans Spans of each candidate
+ * @param[in,out] nspans Number of spans of each candidate
+ * @param[in,out] maxspans Size of the span array of each candidate
+ */
+static void
+knn_add_span(KNNEntry *entries, int nentries, int k, TimestampTz lower,
+  TimestampTz upper, bool lower_inc, bool upper_inc, Span **spans,
+  int *nspans, int *maxspans)
+{
+  qsort(entries, (size_t) nentries, sizeof(KNNEntry), &knn_entry_cmp);
+  for (int i = 0; i < nentries && i < k; i++)
+  {
+    int c = entries[i].cand;
+    if (nspans[c] == maxspans[c])
+    {
+      maxspans[c] *= 2;
+      spans[c] = repalloc(spans[c], sizeof(Span) * maxspans[c]);
+    }
+    span_set(TimestampTzGetDatum(lower), TimestampTzGetDatum(upper),
+      lower_inc, upper_inc, T_TIMESTAMPTZ, T_TSTZSPAN, &spans[c][nspans[c]++]);
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return for each temporal point of an array the periods during which
+ * it is among the k nearest ones to a reference temporal point
+ * @details The temporal distances to the reference point are computed with
+ * #distance_tpoint_tpoint and swept along the union of their timestamps. At
+ * each timestamp and on each interval between two consecutive timestamps the
+ * distances are evaluated in a single pass with
+ * #tfloat_values_at_timestamps. Since the distances are linear on an
+ * interval, the order of the candidates only changes at the times at which
+ * two of them cross, which split the interval into pieces on which the k
+ * nearest candidates are constant.
+ * @param[in] temp Reference temporal point
+ * @param[in] temparr Array of candidate temporal points
+ * @param[in] count Number of elements in the array
+ * @param[in] k Number of neighbours
+ * @return Array of @p count span sets, an element is NULL when the candidate
+ * is never among the k nearest ones. On error return NULL.
+ */
+SpanSet **
+tpointarr_knn(const Temporal *temp, const Temporal **temparr, int count,
+  int k)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) temparr) ||
+      ! ensure_positive(count) || ! ensure_positive(k))
+    return NULL;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_valid_tpoint_tpoint(temp, temparr[i]) ||
+        ! ensure_same_dimensionality(temp->flags, temparr[i]->flags))
+      return NULL;
+  }
+
+  /* Compute the temporal distances and collect their timestamps */
+  Temporal **dist = palloc(sizeof(Temporal *) * count);
+  TimestampTz **candtimes = palloc(sizeof(TimestampTz *) * count);
+  int *ncandtimes = palloc0(sizeof(int) * count);
+  int ntimes = 0;
+  for (int i = 0; i < count; i++)
+  {
+    /* The result is NULL when the temporal points do not intersect on time */
+    dist[i] = distance_tpoint_tpoint(temp, temparr[i]);
+    if (dist[i])
+    {
+      candtimes[i] = temporal_timestamps(dist[i], &ncandtimes[i]);
+      ntimes += ncandtimes[i];
+    }
+  }
+  SpanSet **result = palloc0(sizeof(SpanSet *) * count);
+  if (ntimes == 0)
+  {
+    pfree(dist); pfree(candtimes); pfree(ncandtimes);
+    return result;
+  }
+  TimestampTz *times = palloc(sizeof(TimestampTz) * ntimes);
+  ntimes = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (! dist[i])
+      continue;
+    memcpy(&times[ntimes], candtimes[i], sizeof(TimestampTz) * ncandtimes[i]);
+    ntimes += ncandtimes[i];
+    pfree(candtimes[i]);
+  }
+  timestamparr_sort(times, ntimes);
+  ntimes = timestamparr_remove_duplicates(times, ntimes);
+
+  /* Each interval between consecutive timestamps is sampled at its first
+   * and last interior microseconds, from which the linear functions are
+   * recovered. An interval of one microsecond has no interior timestamp and
+   * is sampled twice at its lower bound to keep the samples sorted. */
+  int nsamples = 2 * (ntimes - 1);
+  TimestampTz *samples = palloc(sizeof(TimestampTz) * (nsamples + 1));
+  for (int j = 0; j < ntimes - 1; j++)
+  {
+    bool interior = times[j + 1] - times[j] >= 2;
+    samples[2 * j] = interior ? times[j] + 1 : times[j];
+    samples[2 * j + 1] = interior ? times[j + 1] - 1 : times[j];
+  }
+  double *instvals = palloc(sizeof(double) * count * ntimes);
+  bool *instfound = palloc(sizeof(bool) * count * ntimes);
+  double *segvals = palloc(sizeof(double) * count * (nsamples + 1));
+  bool *segfound = palloc(sizeof(bool) * count * (nsamples + 1));
+  for (int i = 0; i < count; i++)
+  {
+    if (! dist[i])
+    {
+      memset(&instfound[i * ntimes], 0, sizeof(bool) * ntimes);
+      memset(&segfound[i * nsamples], 0, sizeof(bool) * nsamples);
+      continue;
+    }
+    tfloat_values_at_timestamps(dist[i], times, ntimes, true, NULL,
+      &instvals[i * ntimes], &instfound[i * ntimes]);
+    if (nsamples > 0)
+      tfloat_values_at_timestamps(dist[i], samples, nsamples, true, NULL,
+        &segvals[i * nsamples], &segfound[i * nsamples]);
+  }
+
+  Span **spans = palloc(sizeof(Span *) * count);
+  int *nspans = palloc0(sizeof(int) * count);
+  int *maxspans = palloc(sizeof(int) * count);
+  for (int i = 0; i < count; i++)
+  {
+    maxspans[i] = 16;
+    spans[i] = palloc(sizeof(Span) * maxspans[i]);
+  }
+  KNNEntry *entries = palloc(sizeof(KNNEntry) * count);
+  int *active = palloc(sizeof(int) * count);
+  double *start = palloc(sizeof(double) * count);
+  double *slope = palloc(sizeof(double) * count);
+  TimestampTz *cuts = palloc(sizeof(TimestampTz) * 8);
+  int maxcuts = 8;
+  for (int j = 0; j < ntimes; j++)
+  {
+    /* Nearest candidates at the timestamp */
+    int nentries = 0;
+    for (int i = 0; i < count; i++)
+    {
+      if (instfound[i * ntimes + j])
+      {
+        entries[nentries].dist = instvals[i * ntimes + j];
+        entries[nentries++].cand = i;
+      }
+    }
+    if (nentries > 0)
+      knn_add_span(entries, nentries, k, times[j], times[j], true, true,
+        spans, nspans, maxspans);
+    if (j == ntimes - 1 || times[j + 1] - times[j] < 2)
+      continue;
+
+    /* Linear functions of the candidates defined on the interval, relative
+     * to its lower bound */
+    TimestampTz lower = times[j], upper = times[j + 1];
+    int nactive = 0;
+    for (int i = 0; i < count; i++)
+    {
+      int a = i * nsamples + 2 * j;
+      if (! segfound[a] || ! segfound[a + 1])
+        continue;
+      double duration = (double) (samples[2 * j + 1] - samples[2 * j]);
+      slope[nactive] = (duration > 0) ?
+        (segvals[a + 1] - segvals[a]) / duration : 0.0;
+      start[nactive] = segvals[a] - slope[nactive];
+      active[nactive++] = i;
+    }
+    if (nactive == 0)
+      continue;
+
+    /* Split the interval at the crossings of the candidates when the number
+     * of candidates exceeds the number of neighbours */
+    int ncuts = 0;
+    cuts[ncuts++] = lower;
+    if (nactive > k)
+    {
+      for (int p = 0; p < nactive; p++)
+      {
+        for (int q = p + 1; q < nactive; q++)
+        {
+          double ds = slope[p] - slope[q];
+          if (ds == 0.0)
+            continue;
+          double delta = (start[q] - start[p]) / ds;
+          if (delta <= 0.0 || delta >= (double) (upper - lower))
+            continue;
+          TimestampTz t = lower + (TimestampTz) round(delta);
+          if (t <= lower || t >= upper)
+            continue;
+          if (ncuts == maxcuts)
+          {
+            maxcuts *= 2;
+            cuts = repalloc(cuts, sizeof(TimestampTz) * maxcuts);
+          }
+          cuts[ncuts++] = t;
+        }
+      }
+      timestamparr_sort(cuts, ncuts);
+      ncuts = timestamparr_remove_duplicates(cuts, ncuts);
+    }
+    if (ncuts == maxcuts)
+      cuts = repalloc(cuts, sizeof(TimestampTz) * ++maxcuts);
+    cuts[ncuts++] = upper;
+
+    /* Nearest candidates on each piece, evaluated at its midpoint */
+    for (int c = 0; c < ncuts - 1; c++)
+    {
+      double mid = (double) (cuts[c + 1] - cuts[c]) / 2.0 +
+        (double) (cuts[c] - lower);
+      for (int p = 0; p < nactive; p++)
+      {
+        entries[p].dist = start[p] + slope[p] * mid;
+        entries[p].cand = active[p];
+      }
+      knn_add_span(entries, nactive, k, cuts[c], cuts[c + 1], c > 0,
+        c < ncuts - 2, spans, nspans, maxspans);
+    }
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    if (nspans[i] > 0)
+      result[i] = spanset_make_free(spans[i], nspans[i], NORMALIZE, ORDER);
+    else
+      pfree(spans[i]);
+    if (dist[i])
+      pfree(dist[i]);
+  }
+  pfree(dist); pfree(candtimes); pfree(ncandtimes); pfree(times);
+  pfree(samples); pfree(instvals); pfree(instfound); pfree(segvals);
+  pfree(segfound); pfree(spans); pfree(nspans); pfree(maxspans);
+  pfree(entries); pfree(active); pfree(start); pfree(slope); pfree(cuts);
+  return result;
+}
+
+#if MEOS
+/*****************************************************************************
+ * All-pairs proximity of trajectories given in columnar form
+ *****************************************************************************/
+
+/**
+ * @brief Structure to represent the bounding box of a trajectory in the
+ * plane sweep of #tpoint_coords_dwithin_pairs
+ */
+typedef struct
+{
+  int traj;              /**< Number of the trajectory */
+  double xmin;           /**< Minimum X value */
+  double xmax;           /**< Maximum X value */
+  double ymin;           /**< Minimum Y value */
+  double ymax;           /**< Maximum Y value */
+  TimestampTz tmin;      /**< Minimum T value */
+  TimestampTz tmax;      /**< Maximum T value */
+} CoordsBox;
+
+/**
+ * @brief Structure to represent a pair of trajectories found by
+ * #tpoint_coords_dwithin_pairs
+ */
+typedef struct
+{
+  int traj1;             /**< Number of the first trajectory */
+  int traj2;             /**< Number of the second trajectory */
+  double dist;           /**< Nearest approach distance */
+} CoordsPair;
+
+/**
+ * @brief Comparator function for the boxes of trajectories
+ */
+static int
+coords_box_cmp(const void *a, const void *b)
+{
+  const CoordsBox *box1 = (const CoordsBox *) a;
+  const CoordsBox *box2 = (const CoordsBox *) b;
+  if (box1->xmin == box2->xmin)
+    return (box1->traj < box2->traj) ? -1 : 1;
+  return (box1->xmin < box2->xmin) ? -1 : 1;
+}
+
+/**
+ * @brief Comparator function for the pairs of trajectories
+ */
+static int
+coords_pair_cmp(const void *a, const void *b)
+{
+  const CoordsPair *pair1 = (const CoordsPair *) a;
+  const CoordsPair *pair2 = (const CoordsPair *) b;
+  if (pair1->traj1 == pair2->traj1)
+    return (pair1->traj2 < pair2->traj2) ? -1 :
+      ((pair1->traj2 > pair2->traj2) ? 1 : 0);
+  return (pair1->traj1 < pair2->traj1) ? -1 : 1;
+}
+
+/**
+ * @brief Set in the last arguments the position of a trajectory at a
+ * timestamp
+ * @param[in] xcoords,ycoords,times Arrays of the trajectories
+ * @param[in] i Position of the instant starting the segment that contains
+ * the timestamp
+ * @param[in] last Position of the last instant of the trajectory
+ * @param[in] t Timestamp
+ * @param[out] x,y Coordinates
+ */
+static void
+coords_point_at(const double *xcoords, const double *ycoords,
+  const TimestampTz *times, int i, int last, TimestampTz t, double *x,
+  double *y)
+{
+  if (i == last || times[i] == t)
+  {
+    *x = xcoords[i]; *y = ycoords[i];
+    return;
+  }
+  double ratio = (double) (t - times[i]) / (double) (times[i + 1] - times[i]);
+  *x = xcoords[i] + (xcoords[i + 1] - xcoords[i]) * ratio;
+  *y = ycoords[i] + (ycoords[i + 1] - ycoords[i]) * ratio;
+  return;
+}
+
+/**
+ * @brief Return the nearest approach distance of two trajectories during a
+ * period
+ * @details The period is split at the timestamps of both trajectories, so
+ * that in each piece the vector between the two positions moves linearly
+ * and its minimum length is found by projecting the origin on it
+ * @param[in] xcoords,ycoords,times Arrays of the trajectories
+ * @param[in] first1,last1 Positions of the first and last instants of the
+ * first trajectory
+ * @param[in] first2,last2 Positions of the first and last instants of the
+ * second trajectory
+ * @param[in] lower,upper Bounds of the period, which are assumed to be
+ * covered by both trajectories
+ * @param[in] dist Distance at which the computation may stop
+ * @param[in] stop True when the computation stops as soon as the distance
+ * is reached
+ */
+static double
+coords_nad(const double *xcoords, const double *ycoords,
+  const TimestampTz *times, int first1, int last1, int first2, int last2,
+  TimestampTz lower, TimestampTz upper, double dist, bool stop)
+{
+  double result = DBL_MAX;
+  int i = first1, j = first2;
+  TimestampTz t1 = lower;
+  while (true)
+  {
+    /* Find the segments containing the current timestamp */
+    while (i < last1 && times[i + 1] <= t1)
+      i++;
+    while (j < last2 && times[j + 1] <= t1)
+      j++;
+    TimestampTz t2 = upper;
+    if (i < last1 && times[i + 1] < t2)
+      t2 = times[i + 1];
+    if (j < last2 && times[j + 1] < t2)
+      t2 = times[j + 1];
+    double x1, y1, x2, y2, dx1, dy1, dx2, dy2;
+    coords_point_at(xcoords, ycoords, times, i, last1, t1, &x1, &y1);
+    coords_point_at(xcoords, ycoords, times, j, last2, t1, &x2, &y2);
+    dx1 = x1 - x2; dy1 = y1 - y2;
+    coords_point_at(xcoords, ycoords, times, i, last1, t2, &x1, &y1);
+    coords_point_at(xcoords, ycoords, times, j, last2, t2, &x2, &y2);
+    dx2 = x1 - x2; dy2 = y1 - y2;
+    /* Minimum length of the vector moving from (dx1, dy1) to (dx2, dy2) */
+    double ddx = dx2 - dx1, ddy = dy2 - dy1;
+    double len2 = ddx * ddx + ddy * ddy;
+    double fraction = 0.0;
+    if (len2 > 0.0)
+    {
+      fraction = - (dx1 * ddx + dy1 * ddy) / len2;
+      fraction = Max(0.0, Min(1.0, fraction));
+    }
+    double d = hypot(dx1 + ddx * fraction, dy1 + ddy * fraction);
+    result = Min(result, d);
+    if ((stop && result <= dist) || t2 >= upper)
+      break;
+    t1 = t2;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_dist
+ * @brief Return the pairs of trajectories given in columnar form that are
+ * within a distance of each other during a period
+ * @details The coordinates and the timestamps of the trajectories are given
+ * in flat arrays, such as the buffers of the Arrow arrays read by
+ * #temporal_from_arrow, the instants of the i-th trajectory being those
+ * between the positions `offsets[i]` and `offsets[i + 1] - 1` of the arrays.
+ * The trajectories are assumed to be linearly interpolated in the plane.
+ * The candidate pairs are found with a plane sweep over the bounding boxes of
+ * the trajectories, and the pairs whose boxes are within the distance are
+ * verified by computing their nearest approach distance, segment by segment,
+ * directly from the arrays.
+ * @param[in] xcoords,ycoords Coordinates of the instants
+ * @param[in] times Timestamps of the instants
+ * @param[in] offsets Start position of each trajectory in the arrays,
+ * followed by the total number of instants
+ * @param[in] count Number of trajectories
+ * @param[in] dist Distance
+ * @param[in] period Period, may be NULL for the whole time extent, whose
+ * bounds are considered as inclusive
+ * @param[out] nad Array of the nearest approach distance of the pairs
+ * during the period, may be NULL
+ * @param[out] npairs Number of pairs
+ * @return Array of `2 * npairs` trajectory numbers, starting from 0, in
+ * which the pairs are ordered and the first number of a pair is smaller than
+ * the second one. On error or when no pair is found return NULL.
+ */
+int *
+tpoint_coords_dwithin_pairs(const double *xcoords, const double *ycoords,
+  const TimestampTz *times, const int *offsets, int count, double dist,
+  const Span *period, double **nad, int *npairs)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) xcoords) ||
+      ! ensure_not_null((void *) ycoords) ||
+      ! ensure_not_null((void *) times) ||
+      ! ensure_not_null((void *) offsets) ||
+      ! ensure_not_null((void *) npairs) || ! ensure_not_negative(count) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8) ||
+      (period && ! ensure_span_isof_type(period, T_TSTZSPAN)))
+    return NULL;
+
+  *npairs = 0;
+  if (nad)
+    *nad = NULL;
+
+  /* Compute the bounding boxes of the trajectories */
+  CoordsBox *boxes = palloc(sizeof(CoordsBox) * Max(count, 1));
+  int nboxes = 0;
+  for (int i = 0; i < count; i++)
+  {
+    int first = offsets[i], last = offsets[i + 1] - 1;
+    if (first > last)
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The trajectories must have at least one instant");
+      pfree(boxes);
+      return NULL;
+    }
+    CoordsBox *box = &boxes[nboxes];
+    box->traj = i;
+    box->xmin = box->xmax = xcoords[first];
+    box->ymin = box->ymax = ycoords[first];
+    for (int j = first + 1; j <= last; j++)
+    {
+      if (times[j - 1] >= times[j])
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "The timestamps of a trajectory must be increasing");
+        pfree(boxes);
+        return NULL;
+      }
+      box->xmin = Min(box->xmin, xcoords[j]);
+      box->xmax = Max(box->xmax, xcoords[j]);
+      box->ymin = Min(box->ymin, ycoords[j]);
+      box->ymax = Max(box->ymax, ycoords[j]);
+    }
+    box->tmin = times[first];
+    box->tmax = times[last];
+    if (period)
+    {
+      box->tmin = Max(box->tmin, DatumGetTimestampTz(period->lower));
+      box->tmax = Min(box->tmax, DatumGetTimestampTz(period->upper));
+    }
+    /* Trajectories outside the period are not considered */
+    if (box->tmin <= box->tmax)
+      nboxes++;
+  }
+
+  /* Plane sweep over the boxes ordered by their minimum X value */
+  qsort(boxes, (size_t) nboxes, sizeof(CoordsBox), &coords_box_cmp);
+  int maxpairs = 64, count_pairs = 0;
+  CoordsPair *pairs = palloc(sizeof(CoordsPair) * maxpairs);
+  for (int i = 0; i < nboxes; i++)
+  {
+    const CoordsBox *box1 = &boxes[i];
+    for (int j = i + 1; j < nboxes && boxes[j].xmin <= box1->xmax + dist; j++)
+    {
+      const CoordsBox *box2 = &boxes[j];
+      if (box2->ymin > box1->ymax + dist || box1->ymin > box2->ymax + dist)
+        continue;
+      TimestampTz lower = Max(box1->tmin, box2->tmin);
+      TimestampTz upper = Min(box1->tmax, box2->tmax);
+      if (lower > upper)
+        continue;
+      int t1 = box1->traj, t2 = box2->traj;
+      double d = coords_nad(xcoords, ycoords, times, offsets[t1],
+        offsets[t1 + 1] - 1, offsets[t2], offsets[t2 + 1] - 1, lower, upper,
+        dist, nad == NULL);
+      if (d > dist)
+        continue;
+      if (count_pairs == maxpairs)
+      {
+        maxpairs *= 2;
+        pairs = repalloc(pairs, sizeof(CoordsPair) * maxpairs);
+      }
+      pairs[count_pairs].traj1 = Min(t1, t2);
+      pairs[count_pairs].traj2 = Max(t1, t2);
+      pairs[count_pairs++].dist = d;
+    }
+  }
+  pfree(boxes);
+  if (count_pairs == 0)
+  {
+    pfree(pairs);
+    return NULL;
+  }
+
+  qsort(pairs, (size_t) count_pairs, sizeof(CoordsPair), &coords_pair_cmp);
+  int *result = palloc(sizeof(int) * count_pairs * 2);
+  if (nad)
+    *nad = palloc(sizeof(double) * count_pairs);
+  for (int i = 0; i < count_pairs; i++)
+  {
+    result[2 * i] = pairs[i].traj1;
+    result[2 * i + 1] = pairs[i].traj2;
+    if (nad)
+      (*nad)[i] = pairs[i].dist;
+  }
+  pfree(pairs);
+  *npairs = count_pairs;
+  return result;
+}
+#endif /* MEOS */
+
+/*****************************************************************************/
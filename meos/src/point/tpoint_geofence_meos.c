@@ -0,0 +1,580 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Streaming evaluation of the entering and exiting of many moving
+ * objects into and from a set of zones
+ * @details A geofence state keeps the prepared geometries of the zones and,
+ * for each object identifier, its last position and whether it is inside
+ * each zone. Each new position of an object defines a segment from the
+ * previous one, which is tested against the zones whose bounding box it
+ * overlaps. When the segment is covered by a zone or does not intersect it,
+ * which is decided with the prepared geometry, the state of the zone is
+ * known for the whole segment. Otherwise, the periods at which the segment
+ * intersects the zone are computed as in #tinterrel_tpointcontseq_geom and
+ * the enter and exit events are sent to a callback function with the exact
+ * timestamps of the crossings. The cost of a position is thus independent
+ * of the number of positions previously received for the object.
+ */
+
+/* C */
+#include <assert.h>
+/* GEOS */
+#include <geos_c.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
+/* PostGIS */
+#include <liblwgeom.h>
+#include <lwgeom_log.h>
+#include <lwgeom_geos.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/pg_types.h"
+#include "general/temporal.h"
+#include "general/type_util.h"
+#include "point/pgis_types.h"
+#include "point/tpoint.h"
+#include "point/tpoint_restrfuncs.h"
+#include "point/tpoint_spatialfuncs.h"
+
+/**
+ * @brief Structure to represent a zone of a geofence state
+ */
+typedef struct
+{
+  GSERIALIZED *gs;         /**< Geometry of the zone */
+  STBox box;               /**< Bounding box of the zone */
+  GEOSGeometry *geom;      /**< GEOS geometry of the zone */
+  const GEOSPreparedGeometry *prepgeom; /**< Prepared geometry of the zone */
+} tgeofence_zone;
+
+/**
+ * @brief Structure to represent an entry of the hash table of objects
+ */
+typedef struct
+{
+  int64 id;                /**< Object identifier (hashtable key) */
+  TInstant *last;          /**< Last position of the object */
+  TimestampTz *enter;      /**< Last timestamp at which the object entered
+                                each zone, DT_NOBEGIN if none */
+  bool *inside;            /**< True if the object is inside each zone */
+  char status;             /* hash status */
+} tgeofence_entry;
+
+/**
+ * @brief Define a hashtable mapping object identifiers to their state
+ */
+#define SH_PREFIX tgeofencetable
+#define SH_ELEMENT_TYPE tgeofence_entry
+#define SH_KEY_TYPE int64
+#define SH_KEY id
+#define SH_HASH_KEY(tb, key) pg_hashint8(key)
+#define SH_EQUAL(tb, a, b) ((a) == (b))
+#define SH_RAW_ALLOCATOR palloc0
+#define SH_SCOPE static inline
+#define SH_DEFINE
+#define SH_DECLARE
+#include "lib/simplehash.h"
+
+/**
+ * @brief Structure to represent the state of the evaluation of geofences
+ */
+struct GeofenceState
+{
+  int count;               /**< Number of zones */
+  tgeofence_zone *zones;   /**< Zones */
+  int32_t srid;            /**< SRID of the zones */
+  interpType interp;       /**< Interpolation between the positions */
+  tgeofence_event_fn event; /**< Function receiving the events */
+  void *arg;               /**< Argument passed to the function */
+  tgeofencetable_hash *table; /**< Hash table of the objects */
+};
+
+/*****************************************************************************/
+
+/**
+ * @brief Return the GEOS geometry of the segment between two positions
+ */
+static GEOSGeometry *
+tgeofence_segment(const TInstant *inst1, const TInstant *inst2, int32_t srid)
+{
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(inst1));
+  const POINT2D *p2 = DATUM_POINT2D_P(tinstant_val(inst2));
+  bool point = (p1->x == p2->x && p1->y == p2->y);
+  GEOSCoordSequence *coords = GEOSCoordSeq_create(point ? 1 : 2, 2);
+  if (! coords)
+    return NULL;
+  GEOSCoordSeq_setXY(coords, 0, p1->x, p1->y);
+  if (! point)
+    GEOSCoordSeq_setXY(coords, 1, p2->x, p2->y);
+  GEOSGeometry *result = point ? GEOSGeom_createPoint(coords) :
+    GEOSGeom_createLineString(coords);
+  if (result)
+    GEOSSetSRID(result, srid);
+  return result;
+}
+
+/**
+ * @brief Return true if the bounding box of the segment between two
+ * positions overlaps the bounding box of a zone
+ */
+static bool
+tgeofence_segment_overlaps(const POINT2D *p1, const POINT2D *p2,
+  const STBox *box)
+{
+  return Min(p1->x, p2->x) <= box->xmax && Max(p1->x, p2->x) >= box->xmin &&
+    Min(p1->y, p2->y) <= box->ymax && Max(p1->y, p2->y) >= box->ymin;
+}
+
+/**
+ * @brief Change the state of an object with respect to a zone and send the
+ * event to the callback function
+ */
+static void
+tgeofence_emit(GeofenceState *state, tgeofence_entry *entry, int zone,
+  bool inside, TimestampTz t, int *nevents)
+{
+  entry->inside[zone] = inside;
+  if (inside)
+    entry->enter[zone] = t;
+  state->event(entry->id, zone, inside ? TGEOFENCE_ENTER : TGEOFENCE_EXIT, t,
+    state->arg);
+  (*nevents)++;
+  return;
+}
+
+/**
+ * @brief Evaluate a position of an object that is not connected to a
+ * previous one, i.e., because it is the first one or the positions are
+ * step interpolated
+ * @return On error return false
+ */
+static bool
+tgeofence_position(GeofenceState *state, tgeofence_entry *entry,
+  const TInstant *inst, int *nevents)
+{
+  const POINT2D *p = DATUM_POINT2D_P(tinstant_val(inst));
+  GEOSGeometry *point = NULL;
+  for (int i = 0; i < state->count; i++)
+  {
+    tgeofence_zone *zone = &state->zones[i];
+    bool inside = false;
+    if (tgeofence_segment_overlaps(p, p, &zone->box))
+    {
+      if (! point && ! (point = tgeofence_segment(inst, inst, state->srid)))
+      {
+        meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "GEOS returned error");
+        return false;
+      }
+      char res = GEOSPreparedIntersects(zone->prepgeom, point);
+      if (res == 2)
+      {
+        GEOSGeom_destroy(point);
+        meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "GEOS returned error");
+        return false;
+      }
+      inside = (bool) res;
+    }
+    if (inside != entry->inside[i])
+      tgeofence_emit(state, entry, i, inside, inst->t, nevents);
+  }
+  if (point)
+    GEOSGeom_destroy(point);
+  return true;
+}
+
+/**
+ * @brief Evaluate the segment of an object between its previous position
+ * and a new one with respect to a zone
+ * @return On error return false
+ */
+static bool
+tgeofence_segment_zone(GeofenceState *state, tgeofence_entry *entry,
+  int i, const TInstant *inst, const GEOSGeometry *segment, int *nevents)
+{
+  tgeofence_zone *zone = &state->zones[i];
+  TimestampTz t1 = entry->last->t, t2 = inst->t;
+
+  /* The segment does not intersect the zone */
+  char res = GEOSPreparedIntersects(zone->prepgeom, segment);
+  if (res == 2)
+    return false;
+  if (! res)
+  {
+    if (entry->inside[i])
+      tgeofence_emit(state, entry, i, false, t1, nevents);
+    return true;
+  }
+  /* The segment is covered by the zone */
+  res = GEOSPreparedCovers(zone->prepgeom, segment);
+  if (res == 2)
+    return false;
+  if (res)
+  {
+    if (! entry->inside[i])
+      tgeofence_emit(state, entry, i, true, t1, nevents);
+    return true;
+  }
+
+  /* Compute the periods at which the segment intersects the zone */
+  GEOSGeometry *inter = GEOSIntersection(zone->geom, segment);
+  if (! inter)
+    return false;
+  GEOSSetSRID(inter, state->srid);
+  GSERIALIZED *gsinter = GEOS2POSTGIS(inter, false);
+  GEOSGeom_destroy(inter);
+  if (! gsinter)
+    return false;
+  const TInstant *instants[2] = {entry->last, inst};
+  TSequence *seq = tsequence_make(instants, 2, true, true, LINEAR,
+    NORMALIZE_NO);
+  int npers = 0;
+  Span *periods = gserialized_is_empty(gsinter) ? NULL :
+    tpointseq_interperiods(seq, gsinter, &npers);
+  pfree(seq); pfree(gsinter);
+  if (npers > 1)
+    spanarr_sort(periods, npers);
+
+  /* Emit the events at the bounds of the periods, the periods reduced to a
+   * single timestamp inside the segment are tangent to the zone and are
+   * not considered as crossings */
+  if (entry->inside[i] &&
+      (npers == 0 || DatumGetTimestampTz(periods[0].lower) > t1))
+    tgeofence_emit(state, entry, i, false, t1, nevents);
+  for (int j = 0; j < npers; j++)
+  {
+    TimestampTz lower = DatumGetTimestampTz(periods[j].lower);
+    TimestampTz upper = DatumGetTimestampTz(periods[j].upper);
+    if (! entry->inside[i] && lower == upper && lower > t1 && upper < t2)
+      continue;
+    if (! entry->inside[i])
+      tgeofence_emit(state, entry, i, true, lower, nevents);
+    if (upper < t2)
+      tgeofence_emit(state, entry, i, false, upper, nevents);
+  }
+  if (periods)
+    pfree(periods);
+  return true;
+}
+
+/**
+ * @brief Evaluate the segment of an object between its previous position
+ * and a new one
+ * @return On error return false
+ */
+static bool
+tgeofence_segment_eval(GeofenceState *state, tgeofence_entry *entry,
+  const TInstant *inst, int *nevents)
+{
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(entry->last));
+  const POINT2D *p2 = DATUM_POINT2D_P(tinstant_val(inst));
+  GEOSGeometry *segment = NULL;
+  for (int i = 0; i < state->count; i++)
+  {
+    /* The object stays outside of the zones whose box is not overlapped */
+    if (! tgeofence_segment_overlaps(p1, p2, &state->zones[i].box))
+    {
+      if (entry->inside[i])
+        tgeofence_emit(state, entry, i, false, entry->last->t, nevents);
+      continue;
+    }
+    if (! segment &&
+        ! (segment = tgeofence_segment(entry->last, inst, state->srid)))
+    {
+      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "GEOS returned error");
+      return false;
+    }
+    if (! tgeofence_segment_zone(state, entry, i, inst, segment, nevents))
+    {
+      GEOSGeom_destroy(segment);
+      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "GEOS returned error");
+      return false;
+    }
+  }
+  if (segment)
+    GEOSGeom_destroy(segment);
+  return true;
+}
+
+/**
+ * @brief Free the state of an object
+ */
+static void
+tgeofence_entry_free(tgeofence_entry *entry)
+{
+  pfree(entry->last);
+  pfree(entry->enter);
+  pfree(entry->inside);
+  return;
+}
+
+/*****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Return a new state for evaluating the entering and exiting of many
+ * moving objects into and from a set of zones
+ * @param[in] zones Geometries of the zones
+ * @param[in] count Number of zones
+ * @param[in] interp Interpolation between the positions of an object, either
+ * step or linear
+ * @param[in] event Function receiving the events
+ * @param[in] arg Argument passed to the function
+ * @note The zones are identified in the events by their position in the
+ * array
+ * @see #tgeofence_state_push
+ */
+GeofenceState *
+tgeofence_state_make(const GSERIALIZED **zones, int count, interpType interp,
+  tgeofence_event_fn event, void *arg)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) zones) || ! ensure_not_null((void *) event) ||
+      ! ensure_positive(count))
+    return NULL;
+  if (interp != STEP && interp != LINEAR)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid interpolation for the geofences");
+    return NULL;
+  }
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_not_null((void *) zones[i]) ||
+        ! ensure_not_geodetic(zones[i]->gflags) ||
+        ! ensure_not_empty(zones[i]) ||
+        ! ensure_same_srid(gserialized_get_srid(zones[0]),
+          gserialized_get_srid(zones[i])))
+      return NULL;
+  }
+
+  initGEOS(lwnotice, lwgeom_geos_error);
+  GeofenceState *result = palloc0(sizeof(GeofenceState));
+  result->zones = palloc0(sizeof(tgeofence_zone) * count);
+  for (int i = 0; i < count; i++)
+  {
+    tgeofence_zone *zone = &result->zones[i];
+    zone->gs = geo_copy(zones[i]);
+    geo_set_stbox(zone->gs, &zone->box);
+    zone->geom = POSTGIS2GEOS(zone->gs);
+    zone->prepgeom = zone->geom ? GEOSPrepare(zone->geom) : NULL;
+    result->count++;
+    if (! zone->prepgeom)
+    {
+      tgeofence_state_free(result);
+      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+        "Unable to prepare the geometry of a zone");
+      return NULL;
+    }
+  }
+  result->srid = gserialized_get_srid(zones[0]);
+  result->interp = interp;
+  result->event = event;
+  result->arg = arg;
+  /* Arbitrary initialization to 256 objects */
+  result->table = tgeofencetable_create(256, NULL);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Append a position of an object to a geofence state and send to the
+ * callback function the enter and exit events of the object since its
+ * previous position
+ * @details The first position of an object that is inside a zone generates
+ * an enter event at its timestamp. With linear interpolation, the events
+ * have the timestamps at which the segment from the previous position
+ * crosses the boundary of the zones, with step interpolation they have the
+ * timestamp of the position.
+ * @param[in,out] state Geofence state
+ * @param[in] id Object identifier
+ * @param[in] inst Position
+ * @return Number of events, on error return -1, e.g., when the position is
+ * not after the previous one of the object, in which case the state of the
+ * object is left unchanged
+ */
+int
+tgeofence_state_push(GeofenceState *state, int64 id, const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) ||
+      ! ensure_valid_tpoint_geo((Temporal *) inst, state->zones[0].gs) ||
+      ! ensure_temporal_isof_subtype((Temporal *) inst, TINSTANT))
+    return -1;
+
+  initGEOS(lwnotice, lwgeom_geos_error);
+  int nevents = 0;
+  bool found;
+  tgeofence_entry *entry = tgeofencetable_insert(state->table, id, &found);
+  if (! found)
+  {
+    /* First position of the object */
+    entry->enter = palloc(sizeof(TimestampTz) * state->count);
+    for (int i = 0; i < state->count; i++)
+      entry->enter[i] = DT_NOBEGIN;
+    entry->inside = palloc0(sizeof(bool) * state->count);
+    entry->last = tinstant_copy(inst);
+    if (! tgeofence_position(state, entry, inst, &nevents))
+    {
+      tgeofence_entry_free(entry);
+      tgeofencetable_delete_item(state->table, entry);
+      return -1;
+    }
+    return nevents;
+  }
+
+  if (inst->t <= entry->last->t)
+  {
+    char *str = pg_timestamptz_out(inst->t);
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The position of object %ld at %s is not after the previous one",
+      (long) id, str);
+    pfree(str);
+    return -1;
+  }
+  bool ok = (state->interp == STEP) ?
+    tgeofence_position(state, entry, inst, &nevents) :
+    tgeofence_segment_eval(state, entry, inst, &nevents);
+  if (! ok)
+    return -1;
+  pfree(entry->last);
+  entry->last = tinstant_copy(inst);
+  return nevents;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Return true if an object is inside a zone of a geofence state
+ * @param[in] state Geofence state
+ * @param[in] id Object identifier
+ * @param[in] zone Position of the zone
+ */
+bool
+tgeofence_state_inside(const GeofenceState *state, int64 id, int zone)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return false;
+  if (zone < 0 || zone >= state->count)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid zone of the geofence state: %d", zone);
+    return false;
+  }
+  tgeofence_entry *entry = tgeofencetable_lookup(state->table, id);
+  return entry && entry->inside[zone];
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Return true if an object entered a zone of a geofence state in a
+ * time window ending at a timestamp
+ * @param[in] state Geofence state
+ * @param[in] id Object identifier
+ * @param[in] zone Position of the zone
+ * @param[in] t Timestamp ending the window, e.g., the current time
+ * @param[in] window Duration of the window
+ */
+bool
+tgeofence_state_entered(const GeofenceState *state, int64 id, int zone,
+  TimestampTz t, const Interval *window)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) window))
+    return false;
+  if (zone < 0 || zone >= state->count)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid zone of the geofence state: %d", zone);
+    return false;
+  }
+  tgeofence_entry *entry = tgeofencetable_lookup(state->table, id);
+  if (! entry || entry->enter[zone] == DT_NOBEGIN)
+    return false;
+  TimestampTz start = minus_timestamptz_interval(t, window);
+  return entry->enter[zone] > start && entry->enter[zone] <= t;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Remove an object from a geofence state, e.g., when its trip ends
+ * @param[in,out] state Geofence state
+ * @param[in] id Object identifier
+ * @return True if the object was in the state
+ */
+bool
+tgeofence_state_remove(GeofenceState *state, int64 id)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return false;
+  tgeofence_entry *entry = tgeofencetable_lookup(state->table, id);
+  if (! entry)
+    return false;
+  tgeofence_entry_free(entry);
+  tgeofencetable_delete_item(state->table, entry);
+  return true;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Free a geofence state
+ * @param[in] state Geofence state
+ */
+void
+tgeofence_state_free(GeofenceState *state)
+{
+  if (! state)
+    return;
+  if (state->table)
+  {
+    tgeofencetable_iterator iter;
+    tgeofence_entry *entry;
+    tgeofencetable_start_iterate(state->table, &iter);
+    while ((entry = tgeofencetable_iterate(state->table, &iter)) != NULL)
+      tgeofence_entry_free(entry);
+    tgeofencetable_destroy(state->table);
+  }
+  for (int i = 0; i < state->count; i++)
+  {
+    if (state->zones[i].prepgeom)
+      GEOSPreparedGeom_destroy(state->zones[i].prepgeom);
+    if (state->zones[i].geom)
+      GEOSGeom_destroy(state->zones[i].geom);
+    pfree(state->zones[i].gs);
+  }
+  pfree(state->zones);
+  pfree(state);
+  return;
+}
+
+/*****************************************************************************/
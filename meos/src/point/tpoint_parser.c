@@ -34,6 +34,8 @@
 
 #include "point/tpoint_parser.h"
 
+/* C */
+#include <ctype.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -241,6 +243,84 @@ stbox_parse(const char **str)
 
 /*****************************************************************************/
 
+/**
+ * @brief Parse a coordinate of a point in WKT format from the buffer
+ * @return Return false when the input is not a decimal number
+ */
+static bool
+coord_parse_fast(const char **str, double *result)
+{
+  const char *s = *str;
+  if (*s == '+' || *s == '-')
+    s++;
+  /* Exclude the hexadecimal, infinity, and NaN values accepted by strtod */
+  if (! isdigit((unsigned char) *s) &&
+      ! (*s == '.' && isdigit((unsigned char) s[1])))
+    return false;
+  if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+    return false;
+  char *end;
+  *result = strtod(*str, &end);
+  *str = end;
+  return true;
+}
+
+/**
+ * @brief Parse a geometry point of the form `POINT [Z] (x y [z])` followed by
+ * the `@` of an instant without calling the PostGIS WKT parser
+ * @param[in,out] str Input string, which is only advanced on success
+ * @param[in] srid SRID of the temporal point
+ * @param[out] result New point, may be NULL
+ * @return Return false when the input is not of this form, which must then
+ * be parsed by the general parser
+ */
+static bool
+geompoint_parse_fast(const char **str, int srid, GSERIALIZED **result)
+{
+  const char *s = *str;
+  if (pg_strncasecmp(s, "POINT", 5) != 0)
+    return false;
+  s += 5;
+  p_whitespace(&s);
+  bool zflag = false;
+  if (*s == 'Z' || *s == 'z')
+  {
+    zflag = true;
+    s++;
+    p_whitespace(&s);
+  }
+  if (*s++ != '(')
+    return false;
+  p_whitespace(&s);
+  double x, y, z = 0.0;
+  bool hasz = false;
+  if (! coord_parse_fast(&s, &x) || ! isspace((unsigned char) *s))
+    return false;
+  p_whitespace(&s);
+  if (! coord_parse_fast(&s, &y))
+    return false;
+  if (isspace((unsigned char) *s))
+  {
+    p_whitespace(&s);
+    if (*s != ')')
+    {
+      if (! coord_parse_fast(&s, &z))
+        return false;
+      hasz = true;
+      p_whitespace(&s);
+    }
+  }
+  if (*s++ != ')' || (zflag && ! hasz))
+    return false;
+  p_whitespace(&s);
+  if (*s++ != '@')
+    return false;
+  if (result)
+    *result = geopoint_make(x, y, z, hasz, false, srid);
+  *str = s;
+  return true;
+}
+
 /**
  * @brief Parse a temporal instant point from the buffer
  * @param[in] str Input string
@@ -255,46 +335,54 @@ tpointinst_parse(const char **str, meosType temptype, bool end,
   int *tpoint_srid, TInstant **result)
 {
   p_whitespace(str);
-  meosType basetype = temptype_basetype(temptype);
-  /* The next instruction will throw an exception if it fails */
-  Datum geo;
-  if (! temporal_basetype_parse(str, basetype, &geo))
-    return false;
-  GSERIALIZED *gs = DatumGetGserializedP(geo);
-  if (! ensure_point_type(gs) || ! ensure_not_empty(gs) ||
-      ! ensure_has_not_M_gs(gs))
-  {
-    pfree(gs);
-    return false;
-  }
-  /* If one of the SRID of the temporal point and of the geometry
-   * is SRID_UNKNOWN and the other not, copy the SRID */
-  int geo_srid = gserialized_get_srid(gs);
-  if (*tpoint_srid == SRID_UNKNOWN && geo_srid != SRID_UNKNOWN)
-    *tpoint_srid = geo_srid;
-  else if (*tpoint_srid != SRID_UNKNOWN &&
-    ( geo_srid == SRID_UNKNOWN || geo_srid == SRID_DEFAULT ))
-    gserialized_set_srid(gs, *tpoint_srid);
-  /* If the SRID of the temporal point and of the geometry do not match */
-  else if (*tpoint_srid != SRID_UNKNOWN && geo_srid != SRID_UNKNOWN &&
-    *tpoint_srid != geo_srid)
+  GSERIALIZED *gs = NULL;
+  /* Fast path for geometry points without SRID, which thus take the SRID
+   * of the temporal point. The point is only built in the second parsing. */
+  if (temptype != T_TGEOMPOINT ||
+      ! geompoint_parse_fast(str, *tpoint_srid, result ? &gs : NULL))
   {
-    meos_error(ERROR, MEOS_ERR_TEXT_INPUT,
-      "Geometry SRID (%d) does not match temporal type SRID (%d)",
-      geo_srid, *tpoint_srid);
-    pfree(gs);
-    return false;
+    meosType basetype = temptype_basetype(temptype);
+    /* The next instruction will throw an exception if it fails */
+    Datum geo;
+    if (! temporal_basetype_parse(str, basetype, &geo))
+      return false;
+    gs = DatumGetGserializedP(geo);
+    if (! ensure_point_type(gs) || ! ensure_not_empty(gs) ||
+        ! ensure_has_not_M_gs(gs))
+    {
+      pfree(gs);
+      return false;
+    }
+    /* If one of the SRID of the temporal point and of the geometry
+     * is SRID_UNKNOWN and the other not, copy the SRID */
+    int geo_srid = gserialized_get_srid(gs);
+    if (*tpoint_srid == SRID_UNKNOWN && geo_srid != SRID_UNKNOWN)
+      *tpoint_srid = geo_srid;
+    else if (*tpoint_srid != SRID_UNKNOWN &&
+      ( geo_srid == SRID_UNKNOWN || geo_srid == SRID_DEFAULT ))
+      gserialized_set_srid(gs, *tpoint_srid);
+    /* If the SRID of the temporal point and of the geometry do not match */
+    else if (*tpoint_srid != SRID_UNKNOWN && geo_srid != SRID_UNKNOWN &&
+      *tpoint_srid != geo_srid)
+    {
+      meos_error(ERROR, MEOS_ERR_TEXT_INPUT,
+        "Geometry SRID (%d) does not match temporal type SRID (%d)",
+        geo_srid, *tpoint_srid);
+      pfree(gs);
+      return false;
+    }
   }
   TimestampTz t = timestamp_parse(str);
-  if (t == DT_NOEND)
-    return false;
-  if (end && ! ensure_end_input(str, "temporal point"))
+  if (t == DT_NOEND || (end && ! ensure_end_input(str, "temporal point")))
   {
-    pfree(gs);
+    if (gs)
+      pfree(gs);
     return false;
   }
   if (result)
     *result = tinstant_make_free(PointerGetDatum(gs), temptype, t);
+  else if (gs)
+    pfree(gs);
   return true;
 }
 
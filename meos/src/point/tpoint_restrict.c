@@ -34,6 +34,10 @@
 
 /* C */
 #include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include <utils/float.h>
@@ -50,6 +54,7 @@
 #include "general/temporal_restrict.h"
 #include "general/tsequence.h"
 #include "general/type_util.h"
+#include "point/tpoint_restrfuncs.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_spatialrels.h"
 
@@ -634,6 +639,30 @@ tpointseq_step_restrict_stbox(const TSequence *seq, const STBox *box,
 
 /*****************************************************************************/
 
+/**
+ * @brief Return true if a bounding box is inside the spatial dimensions of a
+ * spatiotemporal box, taking into account the upper border of the latter
+ * @param[in] box1 Bounding box of a temporal point
+ * @param[in] box Spatiotemporal box
+ * @param[in] hasz True when the Z dimension is considered
+ * @param[in] border_inc True when the box contains the upper border
+ */
+static bool
+stbox_inside_xyz(const STBox *box1, const STBox *box, bool hasz,
+  bool border_inc)
+{
+  if (box1->xmin < box->xmin || box1->ymin < box->ymin ||
+      (hasz && box1->zmin < box->zmin))
+    return false;
+  if (border_inc)
+    return box1->xmax <= box->xmax && box1->ymax <= box->ymax &&
+      (! hasz || box1->zmax <= box->zmax);
+  /* The max border is not included, see #computeMaxBorderCode */
+  return box->xmax - box1->xmax >= MEOS_EPSILON &&
+    box->ymax - box1->ymax >= MEOS_EPSILON &&
+    (! hasz || box->zmax - box1->zmax >= MEOS_EPSILON);
+}
+
 /**
  * @brief Restrict the temporal point to the spatial dimensions of a
  * spatiotemporal box
@@ -662,6 +691,21 @@ tpointseq_linear_at_stbox_xyz(const TSequence *seq, const STBox *box,
   bool hasz_seq = MEOS_FLAGS_GET_Z(seq->flags);
   bool hasz_box = MEOS_FLAGS_GET_Z(box->flags);
   bool hasz = hasz_seq && hasz_box;
+
+  /* If the sequence is inside the box, it is returned without clipping its
+   * segments. The time test is needed since the bounds of the sequence may
+   * be exclusive bounds of the box */
+  if (! MEOS_FLAGS_GET_GEODETIC(seq->flags) &&
+      (! MEOS_FLAGS_GET_T(box->flags) ||
+       (contains_span_value(&box->period, seq->period.lower) &&
+        contains_span_value(&box->period, seq->period.upper))))
+  {
+    STBox box1;
+    tsequence_set_bbox(seq, &box1);
+    if (stbox_inside_xyz(&box1, box, hasz, border_inc))
+      return tsequence_to_tsequenceset(seq);
+  }
+
   TSequence **sequences = palloc(sizeof(TSequence *) * seq->count);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   TInstant **tofree = palloc(sizeof(TInstant *) * seq->count);
@@ -691,6 +735,14 @@ tpointseq_linear_at_stbox_xyz(const TSequence *seq, const STBox *box,
       else
         makeseq = true;
     }
+    else if (tpointinst_restrict_stbox_iter(inst1, box, border_inc, REST_AT) &&
+      tpointinst_restrict_stbox_iter(inst2, box, border_inc, REST_AT))
+    {
+      /* Segment inside the box, the clipping would return it unchanged */
+      if (ninsts == 0)
+        instants[ninsts++] = (TInstant *) inst1;
+      instants[ninsts++] = (TInstant *) inst2;
+    }
     else
     {
       /* Clip the segment */
@@ -1528,7 +1580,7 @@ tpointseq_step_restrict_geom_time(const TSequence *seq, const GSERIALIZED *gs,
  * the intersecting geometry is non empty
  */
 Span *
-tpointseq_interperiods(const TSequence *seq, GSERIALIZED *gsinter, int *count)
+tpointseq_interperiods(const TSequence *seq, const GSERIALIZED *gsinter, int *count)
 {
   /* The temporal sequence has at least 2 instants since
    * (1) the test for instantaneous full sequence is done in the calling function
@@ -1654,6 +1706,774 @@ tpointseq_interperiods(const TSequence *seq, GSERIALIZED *gsinter, int *count)
   return result;
 }
 
+/*****************************************************************************
+ * Restriction of a temporal point to a large polygon using an index of the
+ * edges of the polygon. Instead of computing with GEOS the intersection of
+ * the trajectory and the polygon, which is a large geometry, the crossings of
+ * each segment of the temporal point are obtained from the edges that overlap
+ * the segment and the state of the pieces between two crossings is given by
+ * a point-in-polygon test. The index is a packed R-tree built with the
+ * Sort-Tile-Recursive (STR) algorithm that is kept across the calls as long
+ * as the polygon does not change.
+ *****************************************************************************/
+
+/**
+ * @brief Number of entries of a node of the edge index
+ */
+#define EDGEINDEX_NODE_SIZE 16
+
+static MEOS_THREAD_LOCAL EdgeIndex *_EDGE_INDEX = NULL;
+
+/**
+ * @brief Free an edge index
+ */
+static void
+edge_index_free(EdgeIndex *index)
+{
+  for (int i = 0; i < index->nlevels; i++)
+    free(index->nodes[i]);
+  free(index->nodes); free(index->nnodes); free(index->edges);
+  free(index->gs); free(index);
+  return;
+}
+
+/**
+ * @brief Comparator of edges on the X or Y coordinate of their center
+ */
+static int
+edge_cmp(const POINT2D *e1, const POINT2D *e2, bool x)
+{
+  double c1 = x ? e1[0].x + e1[1].x : e1[0].y + e1[1].y;
+  double c2 = x ? e2[0].x + e2[1].x : e2[0].y + e2[1].y;
+  return (c1 < c2) ? -1 : ((c1 > c2) ? 1 : 0);
+}
+
+static int
+edge_cmp_x(const void *e1, const void *e2)
+{
+  return edge_cmp((const POINT2D *) e1, (const POINT2D *) e2, true);
+}
+
+static int
+edge_cmp_y(const void *e1, const void *e2)
+{
+  return edge_cmp((const POINT2D *) e1, (const POINT2D *) e2, false);
+}
+
+/**
+ * @brief Return the bounding box of the entry of a level of an edge index
+ */
+static void
+edge_index_entry_box(const EdgeIndex *index, int level, int i, EdgeBox *box)
+{
+  if (level < 0)
+  {
+    const POINT2D *e = &index->edges[2 * i];
+    box->xmin = Min(e[0].x, e[1].x); box->xmax = Max(e[0].x, e[1].x);
+    box->ymin = Min(e[0].y, e[1].y); box->ymax = Max(e[0].y, e[1].y);
+  }
+  else
+    *box = index->nodes[level][i];
+  return;
+}
+
+/**
+ * @brief Add to an edge index the edges of a point array
+ */
+static void
+edge_index_add_points(EdgeIndex *index, const POINTARRAY *pa)
+{
+  for (uint32_t k = 0; k + 1 < pa->npoints; k++)
+  {
+    index->edges[2 * index->nedges] = *getPoint2d_cp(pa, k);
+    index->edges[2 * index->nedges + 1] = *getPoint2d_cp(pa, k + 1);
+    index->nedges++;
+  }
+  return;
+}
+
+/**
+ * @brief Return an index of the edges of a polygon or a line
+ */
+static EdgeIndex *
+edge_index_make(const GSERIALIZED *gs, const LWGEOM *geom)
+{
+  EdgeIndex *result = malloc(sizeof(EdgeIndex));
+  result->gs = malloc(VARSIZE(gs));
+  memcpy(result->gs, gs, VARSIZE(gs));
+  result->areal = (geom->type == POLYGONTYPE ||
+    geom->type == MULTIPOLYGONTYPE);
+
+  /* Collect the edges of all the rings or lines */
+  int maxedges = (int) lwgeom_count_vertices(geom);
+  result->npoints = maxedges;
+  result->edges = malloc(sizeof(POINT2D) * 2 * Max(1, maxedges));
+  result->nedges = 0;
+  if (geom->type == LINETYPE)
+    edge_index_add_points(result, ((LWLINE *) geom)->points);
+  else if (geom->type == MULTILINETYPE)
+  {
+    const LWMLINE *mline = (LWMLINE *) geom;
+    for (uint32_t i = 0; i < mline->ngeoms; i++)
+      edge_index_add_points(result, mline->geoms[i]->points);
+  }
+  else
+  {
+    int npolys = (geom->type == POLYGONTYPE) ? 1 :
+      (int) ((LWMPOLY *) geom)->ngeoms;
+    for (int i = 0; i < npolys; i++)
+    {
+      const LWPOLY *poly = (geom->type == POLYGONTYPE) ? (LWPOLY *) geom :
+        ((LWMPOLY *) geom)->geoms[i];
+      for (uint32_t j = 0; j < poly->nrings; j++)
+        edge_index_add_points(result, poly->rings[j]);
+    }
+  }
+
+  /* Sort the edges into vertical slices and each slice by Y */
+  int nleaves = (result->nedges + EDGEINDEX_NODE_SIZE - 1) /
+    EDGEINDEX_NODE_SIZE;
+  int nslices = Max(1, (int) ceil(sqrt((double) nleaves)));
+  int slicesize = nslices * EDGEINDEX_NODE_SIZE;
+  qsort(result->edges, result->nedges, sizeof(POINT2D) * 2, &edge_cmp_x);
+  for (int i = 0; i < result->nedges; i += slicesize)
+    qsort(&result->edges[2 * i], Min(slicesize, result->nedges - i),
+      sizeof(POINT2D) * 2, &edge_cmp_y);
+
+  /* Build the levels bottom-up until a single node remains */
+  int maxlevels = 1;
+  for (int n = nleaves; n > 1; n = (n + EDGEINDEX_NODE_SIZE - 1) /
+      EDGEINDEX_NODE_SIZE)
+    maxlevels++;
+  result->nnodes = malloc(sizeof(int) * maxlevels);
+  result->nodes = malloc(sizeof(EdgeBox *) * maxlevels);
+  result->nlevels = 0;
+  int nentries = result->nedges;
+  do
+  {
+    int level = result->nlevels;
+    int n = (nentries + EDGEINDEX_NODE_SIZE - 1) / EDGEINDEX_NODE_SIZE;
+    result->nodes[level] = malloc(sizeof(EdgeBox) * n);
+    result->nnodes[level] = n;
+    for (int i = 0; i < n; i++)
+    {
+      EdgeBox *node = &result->nodes[level][i];
+      edge_index_entry_box(result, level - 1, i * EDGEINDEX_NODE_SIZE, node);
+      int last = Min((i + 1) * EDGEINDEX_NODE_SIZE, nentries);
+      for (int j = i * EDGEINDEX_NODE_SIZE + 1; j < last; j++)
+      {
+        EdgeBox box;
+        edge_index_entry_box(result, level - 1, j, &box);
+        node->xmin = Min(node->xmin, box.xmin);
+        node->ymin = Min(node->ymin, box.ymin);
+        node->xmax = Max(node->xmax, box.xmax);
+        node->ymax = Max(node->ymax, box.ymax);
+      }
+    }
+    result->nlevels++;
+    nentries = n;
+  } while (nentries > 1);
+  return result;
+}
+
+/**
+ * @brief Return the index of the edges of a geometry, building it if the
+ * geometry is not the one of the last call, or @p NULL if the geometry is not
+ * a polygon, or a line when requested, with enough vertices to use an index
+ * @param[in] gs Geometry
+ * @param[in] minpoints Minimum number of vertices of the geometry
+ * @param[in] lines True when lines and multilines are also indexed
+ */
+const EdgeIndex *
+edge_index_get(const GSERIALIZED *gs, int minpoints, bool lines)
+{
+  if (_EDGE_INDEX && VARSIZE(_EDGE_INDEX->gs) == VARSIZE(gs) &&
+      memcmp(_EDGE_INDEX->gs, gs, VARSIZE(gs)) == 0)
+    return (_EDGE_INDEX->npoints >= minpoints &&
+      (lines || _EDGE_INDEX->areal)) ? _EDGE_INDEX : NULL;
+
+  uint32_t type = gserialized_get_type(gs);
+  if (type != POLYGONTYPE && type != MULTIPOLYGONTYPE &&
+      (! lines || (type != LINETYPE && type != MULTILINETYPE)))
+    return NULL;
+  LWGEOM *geom = lwgeom_from_gserialized(gs);
+  if ((int) lwgeom_count_vertices(geom) < Max(minpoints, 2))
+  {
+    lwgeom_free(geom);
+    return NULL;
+  }
+  if (_EDGE_INDEX)
+    edge_index_free(_EDGE_INDEX);
+  _EDGE_INDEX = edge_index_make(gs, geom);
+  lwgeom_free(geom);
+  return _EDGE_INDEX;
+}
+
+/**
+ * @brief Return in an array the edges of an index whose bounding box
+ * overlaps a box
+ * @param[in] index Edge index
+ * @param[in] box Box
+ * @param[out] edges Array of edges, which is enlarged if needed
+ * @param[in,out] maxedges Size of the array
+ * @return Number of edges
+ */
+int
+edge_index_query(const EdgeIndex *index, const EdgeBox *box, int **edges,
+  int *maxedges)
+{
+  /* Stack of the entries to visit, the root is the single entry of the
+   * top level */
+  int stack[64 * EDGEINDEX_NODE_SIZE][2];
+  int sp = 0, nedges = 0;
+  stack[sp][0] = index->nlevels - 1;
+  stack[sp++][1] = 0;
+  while (sp > 0)
+  {
+    sp--;
+    int level = stack[sp][0], i = stack[sp][1];
+    EdgeBox b;
+    edge_index_entry_box(index, level, i, &b);
+    if (b.xmax < box->xmin || b.xmin > box->xmax ||
+        b.ymax < box->ymin || b.ymin > box->ymax)
+      continue;
+    if (level < 0)
+    {
+      if (nedges == *maxedges)
+      {
+        *maxedges *= 2;
+        *edges = repalloc(*edges, sizeof(int) * *maxedges);
+      }
+      (*edges)[nedges++] = i;
+      continue;
+    }
+    int nentries = (level == 0) ? index->nedges : index->nnodes[level - 1];
+    int last = Min((i + 1) * EDGEINDEX_NODE_SIZE, nentries);
+    for (int j = i * EDGEINDEX_NODE_SIZE; j < last; j++)
+    {
+      stack[sp][0] = level - 1;
+      stack[sp++][1] = j;
+    }
+  }
+  return nedges;
+}
+
+/**
+ * @brief Return the location of a point with respect to the polygon of an
+ * edge index
+ * @details The point is on the boundary if it is on an edge, otherwise the
+ * parity of the number of edges crossed by a ray towards the positive X axis
+ * determines whether the point is in the interior.
+ * @return One of @p EDGEINDEX_EXTERIOR, @p EDGEINDEX_INTERIOR, or
+ * @p EDGEINDEX_BOUNDARY
+ */
+int
+edge_index_locate_point(const EdgeIndex *index, const POINT2D *p,
+  int **edges, int *maxedges)
+{
+  EdgeBox box = {p->x, p->y, DBL_MAX, p->y};
+  int nedges = edge_index_query(index, &box, edges, maxedges);
+  bool inside = false;
+  for (int i = 0; i < nedges; i++)
+  {
+    const POINT2D *a = &index->edges[2 * (*edges)[i]];
+    const POINT2D *b = a + 1;
+    /* On the edge */
+    if ((b->x - a->x) * (p->y - a->y) - (b->y - a->y) * (p->x - a->x) == 0 &&
+        p->x >= Min(a->x, b->x) && p->x <= Max(a->x, b->x) &&
+        p->y >= Min(a->y, b->y) && p->y <= Max(a->y, b->y))
+      return EDGEINDEX_BOUNDARY;
+    /* Crossing of the ray */
+    if ((a->y > p->y) != (b->y > p->y) &&
+        p->x < a->x + (p->y - a->y) * (b->x - a->x) / (b->y - a->y))
+      inside = ! inside;
+  }
+  return inside ? EDGEINDEX_INTERIOR : EDGEINDEX_EXTERIOR;
+}
+
+/**
+ * @brief Return true if a point is in the interior or on the boundary of the
+ * polygon of an edge index
+ */
+static bool
+edge_index_covers_point(const EdgeIndex *index, const POINT2D *p,
+  int **edges, int *maxedges)
+{
+  return edge_index_locate_point(index, p, edges, maxedges) !=
+    EDGEINDEX_EXTERIOR;
+}
+
+/**
+ * @brief Comparator of fractions
+ */
+static int
+fraction_cmp(const void *f1, const void *f2)
+{
+  double d1 = *(const double *) f1, d2 = *(const double *) f2;
+  return (d1 < d2) ? -1 : ((d1 > d2) ? 1 : 0);
+}
+
+/**
+ * @brief Return the sorted fractions of a segment at which it crosses or
+ * touches the edges of the polygon of an edge index, including the fractions
+ * 0 and 1 of its end points
+ * @param[in] index Edge index
+ * @param[in] p,q Points defining the segment
+ * @param[in,out] edges,maxedges Array of edges used for the queries and its
+ * size, which is enlarged if needed
+ * @param[in,out] fracs,maxfracs Array of fractions and its size, which is
+ * enlarged if needed
+ * @return Number of fractions
+ */
+int
+edge_index_segment_fractions(const EdgeIndex *index, const POINT2D *p,
+  const POINT2D *q, int **edges, int *maxedges, double **fracs, int *maxfracs)
+{
+  EdgeBox box = {Min(p->x, q->x), Min(p->y, q->y), Max(p->x, q->x),
+    Max(p->y, q->y)};
+  int nedges = edge_index_query(index, &box, edges, maxedges);
+  if (*maxfracs < 2 * nedges + 2)
+  {
+    *maxfracs = 2 * nedges + 2;
+    *fracs = repalloc(*fracs, sizeof(double) * *maxfracs);
+  }
+  double *f = *fracs;
+  int nfracs = 0;
+  f[nfracs++] = 0.0;
+  f[nfracs++] = 1.0;
+  double rx = q->x - p->x, ry = q->y - p->y;
+  double rr = rx * rx + ry * ry;
+  for (int j = 0; rr > 0 && j < nedges; j++)
+  {
+    const POINT2D *a = &index->edges[2 * (*edges)[j]];
+    const POINT2D *b = a + 1;
+    double sx = b->x - a->x, sy = b->y - a->y;
+    double apx = a->x - p->x, apy = a->y - p->y;
+    double denom = rx * sy - ry * sx;
+    if (denom != 0)
+    {
+      double t = (apx * sy - apy * sx) / denom;
+      double u = (apx * ry - apy * rx) / denom;
+      if (t >= 0 && t <= 1 && u >= 0 && u <= 1)
+        f[nfracs++] = t;
+    }
+    else if (apx * ry - apy * rx == 0)
+    {
+      /* Collinear edge, add the bounds of the overlap */
+      double t1 = (apx * rx + apy * ry) / rr;
+      double t2 = ((b->x - p->x) * rx + (b->y - p->y) * ry) / rr;
+      double lower = Max(0.0, Min(t1, t2)), upper = Min(1.0, Max(t1, t2));
+      if (lower <= upper)
+      {
+        f[nfracs++] = lower;
+        f[nfracs++] = upper;
+      }
+    }
+  }
+  qsort(f, nfracs, sizeof(double), &fraction_cmp);
+  return nfracs;
+}
+
+/**
+ * @brief Return the distance between a 2D point and a segment and return in
+ * the last argument the closest point of the segment
+ */
+static double
+point_segment_distance(const POINT2D *p, const POINT2D *a, const POINT2D *b,
+  double *fraction)
+{
+  POINT2D closest;
+  *fraction = (double) closest_point2d_on_segment_ratio(p, a, b, &closest);
+  return hypot(p->x - closest.x, p->y - closest.y);
+}
+
+/**
+ * @brief Return the distance between two 2D segments and return in the last
+ * argument the fraction of the first segment at which it is reached
+ * @details The distance is zero if the segments intersect, otherwise it is
+ * reached at an end point of one of the segments
+ */
+static double
+segment_segment_distance(const POINT2D *p, const POINT2D *q,
+  const POINT2D *a, const POINT2D *b, double *fraction)
+{
+  double rx = q->x - p->x, ry = q->y - p->y;
+  double sx = b->x - a->x, sy = b->y - a->y;
+  double apx = a->x - p->x, apy = a->y - p->y;
+  double denom = rx * sy - ry * sx;
+  if (denom != 0)
+  {
+    double t = (apx * sy - apy * sx) / denom;
+    double u = (apx * ry - apy * rx) / denom;
+    if (t >= 0 && t <= 1 && u >= 0 && u <= 1)
+    {
+      *fraction = t;
+      return 0.0;
+    }
+  }
+  double frac, result;
+  /* End points of the first segment to the second one */
+  result = point_segment_distance(p, a, b, &frac);
+  *fraction = 0.0;
+  double dist = point_segment_distance(q, a, b, &frac);
+  if (dist < result)
+  {
+    result = dist;
+    *fraction = 1.0;
+  }
+  /* End points of the second segment to the first one */
+  dist = point_segment_distance(a, p, q, &frac);
+  if (dist < result)
+  {
+    result = dist;
+    *fraction = frac;
+  }
+  dist = point_segment_distance(b, p, q, &frac);
+  if (dist < result)
+  {
+    result = dist;
+    *fraction = frac;
+  }
+  return result;
+}
+
+/**
+ * @brief Return the distance between two boxes of the edge index
+ */
+static double
+edgebox_distance(const EdgeBox *box1, const EdgeBox *box2)
+{
+  double dx = Max(0.0, Max(box1->xmin - box2->xmax, box2->xmin - box1->xmax));
+  double dy = Max(0.0, Max(box1->ymin - box2->ymax, box2->ymin - box1->ymax));
+  return hypot(dx, dy);
+}
+
+/**
+ * @brief Return the distance between a segment and the edges of an index if
+ * it is not greater than a maximum distance, -1 otherwise
+ * @details The entries of the index whose bounding box is farther from the
+ * segment than the smallest distance found so far are pruned. Notice that
+ * for a polygon the distance is the one to its boundary.
+ * @param[in] index Edge index
+ * @param[in] p,q Points defining the segment, which may be equal
+ * @param[in] maxdist Maximum distance
+ * @param[out] fraction Fraction of the segment at which the distance is
+ * reached
+ */
+double
+edge_index_segment_distance(const EdgeIndex *index, const POINT2D *p,
+  const POINT2D *q, double maxdist, double *fraction)
+{
+  EdgeBox box = {Min(p->x, q->x), Min(p->y, q->y), Max(p->x, q->x),
+    Max(p->y, q->y)};
+  /* Stack of the entries to visit, the root is the single entry of the
+   * top level */
+  int stack[64 * EDGEINDEX_NODE_SIZE][2];
+  int sp = 0;
+  double result = -1.0;
+  stack[sp][0] = index->nlevels - 1;
+  stack[sp++][1] = 0;
+  while (sp > 0)
+  {
+    sp--;
+    int level = stack[sp][0], i = stack[sp][1];
+    EdgeBox b;
+    edge_index_entry_box(index, level, i, &b);
+    if (edgebox_distance(&box, &b) > maxdist)
+      continue;
+    if (level < 0)
+    {
+      const POINT2D *e = &index->edges[2 * i];
+      double frac;
+      double dist = segment_segment_distance(p, q, &e[0], &e[1], &frac);
+      if (dist <= maxdist)
+      {
+        result = maxdist = dist;
+        *fraction = frac;
+        if (dist == 0.0)
+          break;
+      }
+      continue;
+    }
+    int nentries = (level == 0) ? index->nedges : index->nnodes[level - 1];
+    int last = Min((i + 1) * EDGEINDEX_NODE_SIZE, nentries);
+    for (int j = i * EDGEINDEX_NODE_SIZE; j < last; j++)
+    {
+      stack[sp][0] = level - 1;
+      stack[sp++][1] = j;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Restrict the fractions of a segment to the ones at which a linear
+ * function of the fraction is between two bounds
+ * @param[in] c0,c1 Constant and coefficient of the linear function
+ * @param[in] min,max Bounds
+ * @param[in,out] lower,upper Fractions
+ * @return False if the resulting interval of fractions is empty
+ */
+static bool
+linear_fractions_restrict(double c0, double c1, double min, double max,
+  double *lower, double *upper)
+{
+  if (c1 == 0)
+    return c0 >= min && c0 <= max && *lower <= *upper;
+  double t1 = (min - c0) / c1, t2 = (max - c0) / c1;
+  *lower = Max(*lower, Min(t1, t2));
+  *upper = Min(*upper, Max(t1, t2));
+  return *lower <= *upper;
+}
+
+/**
+ * @brief Return in the last arguments the interval of fractions of a segment
+ * at which it is within a distance of an edge
+ * @details The points within a distance of an edge form a convex region, the
+ * union of two disks centered at the end points of the edge and of a
+ * rectangle along the edge. The fractions at which the segment is in this
+ * region thus form a single interval, whose bounds are the smallest and the
+ * largest fractions at which the segment is in one of the three parts.
+ * @return False if the segment is never within the distance of the edge
+ */
+static bool
+segment_edge_dwithin(const POINT2D *p, const POINT2D *q, const POINT2D *a,
+  const POINT2D *b, double dist, double *lower, double *upper)
+{
+  double rx = q->x - p->x, ry = q->y - p->y;
+  double rr = rx * rx + ry * ry;
+  double lo = DBL_MAX, hi = -DBL_MAX;
+  /* Disks centered at the end points of the edge */
+  const POINT2D *ends[2] = {a, b};
+  for (int i = 0; i < 2; i++)
+  {
+    double cx = p->x - ends[i]->x, cy = p->y - ends[i]->y;
+    double c = cx * cx + cy * cy - dist * dist;
+    if (rr == 0)
+    {
+      if (c <= 0)
+      {
+        lo = 0.0;
+        hi = 1.0;
+      }
+      continue;
+    }
+    double bb = 2 * (rx * cx + ry * cy);
+    double disc = bb * bb - 4 * rr * c;
+    if (disc < 0)
+      continue;
+    double sqrtdisc = sqrt(disc);
+    double t1 = Max(0.0, (-bb - sqrtdisc) / (2 * rr));
+    double t2 = Min(1.0, (-bb + sqrtdisc) / (2 * rr));
+    if (t1 <= t2)
+    {
+      lo = Min(lo, t1);
+      hi = Max(hi, t2);
+    }
+  }
+  /* Rectangle along the edge, given by the projection of the point on the
+   * line of the edge and by its signed distance to this line */
+  double sx = b->x - a->x, sy = b->y - a->y;
+  double ss = sx * sx + sy * sy;
+  if (ss > 0)
+  {
+    double apx = p->x - a->x, apy = p->y - a->y;
+    double width = dist * sqrt(ss);
+    double t1 = 0.0, t2 = 1.0;
+    if (linear_fractions_restrict(apx * sx + apy * sy, rx * sx + ry * sy,
+          0.0, ss, &t1, &t2) &&
+        linear_fractions_restrict(sx * apy - sy * apx, sx * ry - sy * rx,
+          - width, width, &t1, &t2))
+    {
+      lo = Min(lo, t1);
+      hi = Max(hi, t2);
+    }
+  }
+  if (lo > hi)
+    return false;
+  *lower = lo;
+  *upper = hi;
+  return true;
+}
+
+/**
+ * @brief Return the sorted and disjoint intervals of fractions of a segment
+ * at which it is within a distance of the geometry of an edge index
+ * @details The intervals are given by the edges near the segment. For a
+ * polygon, the pieces of the segment between the intervals do not cross the
+ * boundary and thus are either entirely in the interior or in the exterior
+ * of the polygon, which is determined by a point-in-polygon test of their
+ * middle point.
+ * @param[in] index Edge index
+ * @param[in] p,q Points defining the segment, which may be equal
+ * @param[in] dist Distance
+ * @param[in,out] edges,maxedges Array of edges used for the queries and its
+ * size, which is enlarged if needed
+ * @param[in,out] fracs,maxfracs Array of fractions and its size, which is
+ * enlarged if needed, where the lower and the upper bound of each interval
+ * are stored consecutively
+ * @return Number of intervals
+ */
+int
+edge_index_segment_dwithin(const EdgeIndex *index, const POINT2D *p,
+  const POINT2D *q, double dist, int **edges, int *maxedges, double **fracs,
+  int *maxfracs)
+{
+  EdgeBox box = {Min(p->x, q->x) - dist, Min(p->y, q->y) - dist,
+    Max(p->x, q->x) + dist, Max(p->y, q->y) + dist};
+  int nedges = edge_index_query(index, &box, edges, maxedges);
+  if (*maxfracs < 2 * nedges + 2)
+  {
+    *maxfracs = 2 * nedges + 2;
+    *fracs = repalloc(*fracs, sizeof(double) * *maxfracs);
+  }
+  double *f = *fracs;
+  int n = 0;
+  for (int j = 0; j < nedges; j++)
+  {
+    const POINT2D *a = &index->edges[2 * (*edges)[j]];
+    if (segment_edge_dwithin(p, q, a, a + 1, dist, &f[2 * n], &f[2 * n + 1]))
+      n++;
+  }
+  /* Sort the intervals on their lower bound and merge them */
+  qsort(f, n, sizeof(double) * 2, &fraction_cmp);
+  int m = 0;
+  for (int i = 0; i < n; i++)
+  {
+    if (m > 0 && f[2 * i] <= f[2 * m - 1])
+      f[2 * m - 1] = Max(f[2 * m - 1], f[2 * i + 1]);
+    else
+    {
+      f[2 * m] = f[2 * i];
+      f[2 * m + 1] = f[2 * i + 1];
+      m++;
+    }
+  }
+  if (! index->areal)
+    return m;
+
+  /* Add the pieces between the intervals that are in the interior of the
+   * polygon, merging them with the adjacent intervals */
+  n = m;
+  m = 0;
+  double start = 0.0;
+  for (int i = 0; i <= n; i++)
+  {
+    double lower = (i < n) ? f[2 * i] : 1.0;
+    double upper = (i < n) ? f[2 * i + 1] : 1.0;
+    bool interior = false;
+    if (start < lower)
+    {
+      double mid = (start + lower) / 2;
+      POINT2D point = {p->x + (q->x - p->x) * mid, p->y + (q->y - p->y) * mid};
+      interior = edge_index_locate_point(index, &point, edges, maxedges) ==
+        EDGEINDEX_INTERIOR;
+    }
+    if (interior)
+    {
+      if (m > 0 && f[2 * m - 1] == start)
+        f[2 * m - 1] = upper;
+      else
+      {
+        f[2 * m] = start;
+        f[2 * m + 1] = upper;
+        m++;
+      }
+    }
+    else if (i < n)
+    {
+      f[2 * m] = lower;
+      f[2 * m + 1] = upper;
+      m++;
+    }
+    start = upper;
+  }
+  return m;
+}
+
+/**
+ * @brief Return the index of the edges of a geometry if the distance
+ * functions of a temporal point and the geometry can be evaluated on it,
+ * @p NULL otherwise
+ * @details The index is used for 2D temporal geometry points and 2D lines,
+ * polygons, and their multi counterparts
+ * @param[in] temp Temporal point
+ * @param[in] gs Geometry
+ * @param[in] minpoints Minimum number of vertices of the geometry
+ */
+const EdgeIndex *
+tpoint_geo_dist_edge_index(const Temporal *temp, const GSERIALIZED *gs,
+  int minpoints)
+{
+  if (MEOS_FLAGS_GET_Z(temp->flags) || MEOS_FLAGS_GET_GEODETIC(temp->flags) ||
+      FLAGS_GET_Z(gs->gflags))
+    return NULL;
+  return edge_index_get(gs, minpoints, true);
+}
+
+/**
+ * @brief Get the periods at which a temporal sequence point with linear
+ * interpolation is in the interior or on the boundary of the polygon of an
+ * edge index
+ * @param[in] seq Temporal point
+ * @param[in] index Edge index
+ * @param[out] count Number of elements in the resulting array
+ */
+static Span *
+tpointseq_edge_index_periods(const TSequence *seq, const EdgeIndex *index,
+  int *count)
+{
+  int maxedges = 64, maxfracs = 64, maxpers = 64, npers = 0;
+  int *edges = palloc(sizeof(int) * maxedges);
+  double *fracs = palloc(sizeof(double) * maxfracs);
+  Span *result = palloc(sizeof(Span) * maxpers);
+  for (int i = 0; i < seq->count - 1; i++)
+  {
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq, i);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val(inst1));
+    const POINT2D *q = DATUM_POINT2D_P(tinstant_val(inst2));
+    /* Fractions of the segment at which it crosses or touches an edge */
+    int nfracs = edge_index_segment_fractions(index, p, q, &edges, &maxedges,
+      &fracs, &maxfracs);
+    double rx = q->x - p->x, ry = q->y - p->y;
+
+    /* Periods of the pieces of the segment covered by the polygon */
+    if (maxpers < npers + 2 * nfracs)
+    {
+      maxpers = Max(2 * maxpers, npers + 2 * nfracs);
+      result = repalloc(result, sizeof(Span) * maxpers);
+    }
+    double duration = (double) (inst2->t - inst1->t);
+    TimestampTz lower = inst1->t;
+    for (int j = 0; j < nfracs; j++)
+    {
+      if (j > 0 && fracs[j] == fracs[j - 1])
+        continue;
+      TimestampTz t = inst1->t + (TimestampTz) (duration * fracs[j]);
+      POINT2D point = {p->x + rx * fracs[j], p->y + ry * fracs[j]};
+      /* The inner fractions are on the boundary */
+      if ((j > 0 && j < nfracs - 1) ||
+          edge_index_covers_point(index, &point, &edges, &maxedges))
+        span_set(t, t, true, true, T_TIMESTAMPTZ, T_TSTZSPAN,
+          &result[npers++]);
+      if (j > 0)
+      {
+        double f = (fracs[j - 1] + fracs[j]) / 2;
+        POINT2D mid = {p->x + rx * f, p->y + ry * f};
+        if (lower < t &&
+            edge_index_covers_point(index, &mid, &edges, &maxedges))
+          span_set(lower, t, true, true, T_TIMESTAMPTZ, T_TSTZSPAN,
+            &result[npers++]);
+      }
+      lower = t;
+    }
+  }
+  pfree(edges); pfree(fracs);
+  *count = npers;
+  return result;
+}
+
 /**
  * @brief Return a temporal sequence point with linear interpolation
  * restricted to a geometry
@@ -1692,6 +2512,23 @@ tpointseq_linear_at_geom(const TSequence *seq, const GSERIALIZED *gs)
   if (! overlaps_stbox_stbox(&box1, &box2))
     return NULL;
 
+  /* Use the index of the edges for large polygons */
+  const EdgeIndex *index = edge_index_get(gs, EDGEINDEX_MIN_POINTS, false);
+  if (index)
+  {
+    int npers;
+    Span *periods = tpointseq_edge_index_periods(seq, index, &npers);
+    if (npers == 0)
+    {
+      pfree(periods);
+      return NULL;
+    }
+    SpanSet *ss = spanset_make_free(periods, npers, NORMALIZE, ORDER);
+    result = tcontseq_restrict_tstzspanset(seq, ss, REST_AT);
+    pfree(ss);
+    return result;
+  }
+
   /* Convert the point to 2D before computing the restriction to geometry */
   bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
   TSequence *seq2d = hasz ?
@@ -1964,20 +2801,13 @@ tpointseqset_restrict_geom_time(const TSequenceSet *ss, const GSERIALIZED *gs,
 }
 
 /**
- * @ingroup meos_internal_temporal_restrict
  * @brief Return a temporal point restricted to (the complement of) a geometry
  * and possibly a Z span and a timestamptz span
- * @param[in] temp Temporal point
- * @param[in] gs Geometry
- * @param[in] zspan Span of values to restrict the Z dimension
- * @param[in] period Period to restrict the T dimension
- * @param[in] atfunc True if the restriction is at, false for minus
  */
-Temporal *
-tpoint_restrict_geom_time(const Temporal *temp, const GSERIALIZED *gs,
-  const Span *zspan, const Span *period, bool atfunc)
+static Temporal *
+tpoint_restrict_geom_time_dispatch(const Temporal *temp,
+  const GSERIALIZED *gs, const Span *zspan, const Span *period, bool atfunc)
 {
-  assert(temp); assert(gs); assert(tgeo_type(temp->temptype));
   if (gserialized_is_empty(gs))
     return atfunc ? NULL : temporal_cp(temp);
   /* Ensure validity of the arguments */
@@ -2040,6 +2870,28 @@ tpoint_restrict_geom_time(const Temporal *temp, const GSERIALIZED *gs,
   return result;
 }
 
+/**
+ * @ingroup meos_internal_temporal_restrict
+ * @brief Return a temporal point restricted to (the complement of) a geometry
+ * and possibly a Z span and a timestamptz span
+ * @param[in] temp Temporal point
+ * @param[in] gs Geometry
+ * @param[in] zspan Span of values to restrict the Z dimension
+ * @param[in] period Period to restrict the T dimension
+ * @param[in] atfunc True if the restriction is at, false for minus
+ */
+Temporal *
+tpoint_restrict_geom_time(const Temporal *temp, const GSERIALIZED *gs,
+  const Span *zspan, const Span *period, bool atfunc)
+{
+  assert(temp); assert(gs); assert(tgeo_type(temp->temptype));
+  Temporal *result;
+  MEOS_STATS_CALL(MEOS_FAMILY_RESTRICTION,
+    result = tpoint_restrict_geom_time_dispatch(temp, gs, zspan, period,
+      atfunc));
+  return result;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_restrict
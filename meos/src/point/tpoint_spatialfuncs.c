@@ -49,9 +49,14 @@
 #include <meos_internal.h>
 #include "general/pg_types.h"
 #include "general/lifting.h"
+#include "general/span.h"
+#include "general/temporal_boxops.h"
 #include "general/temporal_compops.h"
+#include "general/temporal_restrict.h"
+#include "general/temporal_tile.h"
 #include "general/tnumber_mathfuncs.h"
 #include "general/tsequence.h"
+#include "general/type_round.h"
 #include "general/type_util.h"
 #include "point/pgis_types.h"
 #include "point/stbox.h"
@@ -250,7 +255,8 @@ datum_func2
 pt_distance_fn(int16 flags)
 {
   if (MEOS_FLAGS_GET_GEODETIC(flags))
-    return &geog_distance;
+    return meos_get_fast_geodetic() ? &geog_point_distance_fast :
+      &geog_distance;
   else
     return MEOS_FLAGS_GET_Z(flags) ?
       &pt_distance3d : &pt_distance2d;
@@ -287,6 +293,34 @@ geog_distance(Datum geog1, Datum geog2)
     DatumGetGserializedP(geog2)));
 }
 
+/**
+ * @brief Return the distance in meters between two geodetic points using
+ * the haversine formula on a sphere of radius @p WGS84_RADIUS
+ * @details The relative error with respect to the spheroidal distance is
+ * bounded by about 0.5%
+ */
+double
+geog_distance_haversine(const POINT2D *p1, const POINT2D *p2)
+{
+  double lat1 = p1->y * M_PI / 180.0;
+  double lat2 = p2->y * M_PI / 180.0;
+  double sindlat = sin((lat2 - lat1) / 2.0);
+  double sindlon = sin((p2->x - p1->x) * M_PI / 360.0);
+  double a = sindlat * sindlat + cos(lat1) * cos(lat2) * sindlon * sindlon;
+  return 2.0 * WGS84_RADIUS * asin(sqrt(Min(a, 1.0)));
+}
+
+/**
+ * @brief Return the distance between the two geography points in the fast
+ * geodetic mode
+ */
+Datum
+geog_point_distance_fast(Datum geog1, Datum geog2)
+{
+  return Float8GetDatum(geog_distance_haversine(DATUM_POINT2D_P(geog1),
+    DATUM_POINT2D_P(geog2)));
+}
+
 /**
  * @brief Return the 2D distance between the two geometry points
  */
@@ -1955,6 +1989,56 @@ geopointlinearr_make_trajectory(GSERIALIZED **points, int npoints,
 
 /*****************************************************************************/
 
+/**
+ * @brief Return the trajectory of a temporal point sequence with linear
+ * interpolation
+ * @details The coordinates of the instants are copied in a single pass into
+ * the point array of the resulting line, skipping consecutive equal points,
+ * and the result is written directly as a GSERIALIZED as done in
+ * #geopointarr_make_trajectory
+ * @param[in] seq Temporal sequence
+ * @pre The sequence has linear interpolation and at least two instants
+ */
+static GSERIALIZED *
+tpointseq_linear_trajectory(const TSequence *seq)
+{
+  assert(seq->count > 1); assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags));
+  const STBox *box = TSEQUENCE_BBOX_PTR(seq);
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  size_t ptsize = sizeof(double) * (hasz ? 3 : 2);
+  /* Allocate for all the instants, the varsize is set to the actual size
+   * after removing the consecutive equal points */
+  GSERIALIZED *result = palloc0(16 + seq->count * ptsize);
+  gserialized_set_srid(result, box->srid);
+  uint8_t *ptr = (uint8_t *) result + 16;
+  const GSERIALIZED *prev = NULL;
+  uint32_t npoints = 0;
+  for (int i = 0; i < seq->count; i++)
+  {
+    const GSERIALIZED *gs =
+      DatumGetGserializedP(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+    if (prev && geopoint_same(gs, prev))
+      continue;
+    memcpy(ptr, GS_POINT_PTR(gs), ptsize);
+    ptr += ptsize;
+    npoints++;
+    prev = gs;
+  }
+  /* All the points are equal */
+  if (npoints == 1)
+  {
+    pfree(result);
+    return geo_copy(prev);
+  }
+  int geotype = LINETYPE;
+  memcpy((uint8_t *) result + 8, &geotype, sizeof(uint32_t));
+  memcpy((uint8_t *) result + 12, &npoints, sizeof(uint32_t));
+  LWSIZE_SET(result->size, 16 + npoints * ptsize);
+  FLAGS_SET_Z(result->gflags, hasz);
+  FLAGS_SET_GEODETIC(result->gflags, MEOS_FLAGS_GET_GEODETIC(seq->flags));
+  return result;
+}
+
 /**
  * @ingroup meos_internal_temporal_spatial_accessor
  * @brief Return the trajectory of a temporal point sequence
@@ -1972,9 +2056,13 @@ tpointseq_trajectory(const TSequence *seq)
   if (seq->count == 1)
     return DatumGetGserializedP(tinstant_value(TSEQUENCE_INST_N(seq, 0)));
 
+  /* Linear interpolation */
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  if (interp == LINEAR)
+    return tpointseq_linear_trajectory(seq);
+
   /* General case */
   GSERIALIZED **points = palloc(sizeof(GSERIALIZED *) * seq->count);
-  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
   /* Remove two consecutive points if they are equal */
   int npoints = 0;
   for (int i = 0; i < seq->count; i++)
@@ -1989,7 +2077,10 @@ tpointseq_trajectory(const TSequence *seq)
   STBox box;
   memset(&box, 0, sizeof(box));
   tsequence_set_bbox(seq, &box);
-  return geopointarr_make_trajectory(points, npoints, &box, interp);
+  GSERIALIZED *result = geopointarr_make_trajectory(points, npoints, &box,
+    interp);
+  pfree(points);
+  return result;
 }
 
 /**
@@ -3391,58 +3482,508 @@ tpoint_grid(const Temporal *temp, const gridspec *grid, bool filter_pts)
   }
 }
 
+/*****************************************************************************
+ * Coordinate transformation pipeline
+ *****************************************************************************/
+
+#if MEOS
+/**
+ * @brief Apply a coordinate operation to an array of coordinates in place
+ * @param[in] op Operation
+ * @param[in,out] points Coordinates
+ * @param[in] count Number of coordinates
+ * @param[in] hasz True when the points have Z coordinates
+ * @param[in,out] srid SRID of the coordinates
+ */
+static bool
+coordop_apply(const CoordOp *op, POINT4D *points, int count, bool hasz,
+  int32 *srid)
+{
+  switch (op->type)
+  {
+    case COORDOP_AFFINE:
+    {
+      const AFFINE *a = &op->affine;
+      for (int i = 0; i < count; i++)
+      {
+        POINT4D *p = &points[i];
+        double x = p->x, y = p->y, z = p->z;
+        p->x = a->afac * x + a->bfac * y + a->xoff;
+        p->y = a->dfac * x + a->efac * y + a->yoff;
+        if (hasz)
+        {
+          p->x += a->cfac * z;
+          p->y += a->ffac * z;
+          p->z = a->gfac * x + a->hfac * y + a->ifac * z + a->zoff;
+        }
+      }
+      return true;
+    }
+    case COORDOP_TRANSFORM:
+    {
+      /* Input and output SRIDs are equal, noop */
+      if (*srid == op->srid)
+        return true;
+      LWPROJ *pj = lwproj_transform_cached(*srid, op->srid);
+      if (! pj || ! pt4darr_transf_pj(points, count, pj))
+        return false;
+      *srid = op->srid;
+      return true;
+    }
+    case COORDOP_GRID:
+    {
+      for (int i = 0; i < count; i++)
+      {
+        POINT4D *p = &points[i];
+        if (op->xsize > 0)
+          p->x = rint((p->x - op->ipx) / op->xsize) * op->xsize + op->ipx;
+        if (op->ysize > 0)
+          p->y = rint((p->y - op->ipy) / op->ysize) * op->ysize + op->ipy;
+        if (hasz && op->zsize > 0)
+          p->z = rint((p->z - op->ipz) / op->zsize) * op->zsize + op->ipz;
+      }
+      return true;
+    }
+    default: /* COORDOP_ROUND */
+    {
+      for (int i = 0; i < count; i++)
+      {
+        POINT4D *p = &points[i];
+        p->x = float_round(p->x, op->maxdd);
+        p->y = float_round(p->y, op->maxdd);
+        if (hasz)
+          p->z = float_round(p->z, op->maxdd);
+      }
+      return true;
+    }
+  }
+}
+
+/**
+ * @brief Ensure the validity of the arguments of a coordinate transformation
+ * pipeline of temporal points
+ */
+static bool
+ensure_valid_tpoint_coords_pipeline(const Temporal *temp, const CoordOp *ops,
+  int count)
+{
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) ops) ||
+      ! ensure_tgeo_type(temp->temptype) || ! ensure_positive(count))
+    return false;
+  for (int i = 0; i < count; i++)
+  {
+    if (ops[i].type == COORDOP_TRANSFORM)
+    {
+      if (! ensure_srid_known(ops[i].srid))
+        return false;
+    }
+    else if (ops[i].type == COORDOP_ROUND)
+    {
+      if (! ensure_not_negative(ops[i].maxdd))
+        return false;
+    }
+    /* Affine transformations and grids are planar operations */
+    else if (! ensure_not_geodetic(temp->flags))
+      return false;
+  }
+  /* The first transformation needs the SRID of the temporal point */
+  for (int i = 0; i < count; i++)
+  {
+    if (ops[i].type == COORDOP_TRANSFORM)
+      return ensure_srid_known(tpoint_srid(temp));
+  }
+  return true;
+}
+
+/**
+ * @brief Return in the last argument the number of points of a sequence that
+ * are kept after removing the consecutive duplicates and their indexes into
+ * the array of coordinates
+ */
+static int
+pt4darr_dedup(const POINT4D *points, int count, bool hasz, int *keep)
+{
+  int result = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (result > 0)
+    {
+      const POINT4D *prev = &points[keep[result - 1]];
+      if (prev->x == points[i].x && prev->y == points[i].y &&
+          (! hasz || prev->z == points[i].z))
+        continue;
+    }
+    keep[result++] = i;
+  }
+  return result;
+}
+
+/**
+ * @brief Return a temporal point sequence without the consecutive duplicate
+ * points of a sequence whose coordinates have been transformed in place, or
+ * @p NULL when the sequence is reduced to a single instant and single
+ * instants are filtered
+ * @param[in,out] seq Temporal sequence, whose bounding box is recomputed
+ * when no duplicate is found
+ * @param[in] points Transformed coordinates of the sequence
+ * @param[in] keep Array for the indexes of the kept instants
+ * @param[in] filter_pts True when single instants are removed
+ * @param[out] copied True when the result is a new sequence
+ */
+static TSequence *
+tpointseq_coords_dedup(TSequence *seq, const POINT4D *points, int *keep,
+  bool filter_pts, bool *copied)
+{
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  int ninsts = pt4darr_dedup(points, seq->count, hasz, keep);
+  *copied = false;
+  if (filter_pts && ninsts == 1)
+    return NULL;
+  if (ninsts == seq->count)
+  {
+    tsequence_compute_bbox(seq);
+    return seq;
+  }
+  const TInstant **instants = palloc(sizeof(TInstant *) * ninsts);
+  for (int i = 0; i < ninsts; i++)
+    instants[i] = TSEQUENCE_INST_N(seq, keep[i]);
+  TSequence *result = tsequence_make(instants, ninsts,
+    ninsts > 1 ? seq->period.lower_inc : true,
+    ninsts > 1 ? seq->period.upper_inc : true,
+    MEOS_FLAGS_GET_INTERP(seq->flags), NORMALIZE);
+  pfree(instants);
+  *copied = true;
+  return result;
+}
+
+/**
+ * @brief Return a temporal point with a pipeline of coordinate operations
+ * applied, which consumes the input temporal point (iterator function)
+ * @pre The arguments have been validated
+ */
+static Temporal *
+tpoint_coords_pipeline_iter(Temporal *temp, const CoordOp *ops, int count,
+  bool filter_pts)
+{
+  /* Gather the points and their coordinates */
+  bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
+  int npoints = temporal_num_instants(temp);
+  GSERIALIZED **gsarr = palloc(sizeof(GSERIALIZED *) * npoints);
+  POINT4D *points = palloc(sizeof(POINT4D) * npoints);
+  assert(temptype_subtype(temp->subtype));
+  if (temp->subtype == TINSTANT)
+    gsarr[0] = DatumGetGserializedP(tinstant_val((TInstant *) temp));
+  else if (temp->subtype == TSEQUENCE)
+  {
+    const TSequence *seq = (const TSequence *) temp;
+    for (int i = 0; i < seq->count; i++)
+      gsarr[i] = DatumGetGserializedP(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+  }
+  else /* TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    int k = 0;
+    for (int i = 0; i < ss->count; i++)
+    {
+      const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+      for (int j = 0; j < seq->count; j++)
+        gsarr[k++] =
+          DatumGetGserializedP(tinstant_val(TSEQUENCE_INST_N(seq, j)));
+    }
+  }
+  for (int i = 0; i < npoints; i++)
+  {
+    const double *pa_double = (double *) (GS_POINT_PTR(gsarr[i]));
+    points[i].x = pa_double[0];
+    points[i].y = pa_double[1];
+    points[i].z = hasz ? pa_double[2] : 0.0;
+    points[i].m = 0.0;
+  }
+
+  /* Apply the operations */
+  int32 srid = tpoint_srid(temp);
+  bool grid = false;
+  for (int i = 0; i < count; i++)
+  {
+    if (! coordop_apply(&ops[i], points, npoints, hasz, &srid))
+    {
+      pfree(gsarr); pfree(points); pfree(temp);
+      return NULL;
+    }
+    if (ops[i].type == COORDOP_GRID)
+      grid = true;
+  }
+
+  /* Write back the coordinates */
+  for (int i = 0; i < npoints; i++)
+  {
+    double *pa_double = (double *) (GS_POINT_PTR(gsarr[i]));
+    pa_double[0] = points[i].x;
+    pa_double[1] = points[i].y;
+    if (hasz)
+      pa_double[2] = points[i].z;
+    gserialized_set_srid(gsarr[i], srid);
+  }
+  pfree(gsarr);
+
+  /* Recompute the bounding boxes, removing the duplicates after a grid */
+  Temporal *result = temp;
+  if (temp->subtype == TSEQUENCE)
+  {
+    TSequence *seq = (TSequence *) temp;
+    if (grid)
+    {
+      int *keep = palloc(sizeof(int) * seq->count);
+      bool copied;
+      result = (Temporal *) tpointseq_coords_dedup(seq, points, keep,
+        filter_pts, &copied);
+      pfree(keep);
+      if (result != temp)
+        pfree(temp);
+    }
+    else
+      tsequence_compute_bbox(seq);
+  }
+  else if (temp->subtype == TSEQUENCESET)
+  {
+    TSequenceSet *ss = (TSequenceSet *) temp;
+    if (grid)
+    {
+      const TSequence **sequences = palloc(sizeof(TSequence *) * ss->count);
+      bool *copied = palloc(sizeof(bool) * ss->count);
+      int *keep = palloc(sizeof(int) * ss->maxcount);
+      int nseqs = 0, k = 0;
+      bool changed = false;
+      for (int i = 0; i < ss->count; i++)
+      {
+        TSequence *seq = (TSequence *) TSEQUENCESET_SEQ_N(ss, i);
+        TSequence *seq1 = tpointseq_coords_dedup(seq, &points[k], keep,
+          filter_pts, &copied[nseqs]);
+        k += seq->count;
+        if (seq1 != seq)
+          changed = true;
+        if (seq1)
+          sequences[nseqs++] = seq1;
+      }
+      if (! changed)
+        tsequenceset_compute_bbox(ss);
+      else
+      {
+        result = nseqs > 0 ?
+          (Temporal *) tsequenceset_make(sequences, nseqs, NORMALIZE) : NULL;
+        for (int i = 0; i < nseqs; i++)
+        {
+          if (copied[i])
+            pfree((void *) sequences[i]);
+        }
+        pfree(temp);
+      }
+      pfree(sequences); pfree(copied); pfree(keep);
+    }
+    else
+    {
+      for (int i = 0; i < ss->count; i++)
+        tsequence_compute_bbox((TSequence *) TSEQUENCESET_SEQ_N(ss, i));
+      tsequenceset_compute_bbox(ss);
+    }
+  }
+  pfree(points);
+  return result;
+}
+
+/**
+ * @ingroup meos_internal_temporal_spatial_transf
+ * @brief Return a temporal point with a pipeline of coordinate operations
+ * applied, which consumes the input temporal point
+ * @details The coordinates of all the points are gathered once into an array,
+ * transformed in place by the operations in their order, and written back
+ * into the points of the input temporal point. The bounding boxes are then
+ * recomputed once. When the pipeline contains a grid, consecutive points
+ * falling on the same grid cell are collapsed into one single instant and,
+ * if @p filter_pts is true, the sequences reduced to a single instant are
+ * removed.
+ * @param[in,out] temp Temporal point, which is returned modified in place
+ * or freed
+ * @param[in] ops Coordinate operations
+ * @param[in] count Number of operations
+ * @param[in] filter_pts True when the sequences reduced to a single instant
+ * by a grid are removed
+ * @return On error, or if all the sequences are removed, return @p NULL
+ * @see #tpoint_coords_pipeline
+ */
+Temporal *
+tpoint_coords_pipeline_free(Temporal *temp, const CoordOp *ops, int count,
+  bool filter_pts)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_tpoint_coords_pipeline(temp, ops, count))
+  {
+    if (temp)
+      pfree(temp);
+    return NULL;
+  }
+  return tpoint_coords_pipeline_iter(temp, ops, count, filter_pts);
+}
+
+/**
+ * @ingroup meos_temporal_spatial_transf
+ * @brief Return a temporal point with a pipeline of coordinate operations
+ * applied
+ * @details The result is equal to applying one after the other the
+ * operations to the temporal point, for example, with #tpoint_transform and
+ * #tpoint_round, but the temporal point is copied only once
+ * @param[in] temp Temporal point
+ * @param[in] ops Coordinate operations
+ * @param[in] count Number of operations
+ * @param[in] filter_pts True when the sequences reduced to a single instant
+ * by a grid are removed
+ * @return On error, or if all the sequences are removed, return @p NULL
+ * @see #tpoint_coords_pipeline_free
+ */
+Temporal *
+tpoint_coords_pipeline(const Temporal *temp, const CoordOp *ops, int count,
+  bool filter_pts)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_valid_tpoint_coords_pipeline(temp, ops, count))
+    return NULL;
+  return tpoint_coords_pipeline_iter(temporal_cp(temp), ops, count,
+    filter_pts);
+}
+#endif /* MEOS */
+
 /*****************************************************************************/
 
+/**
+ * @brief Structure to represent the transformation of temporal points into a
+ * vector tile, which is shared by all the temporal points of the tile
+ */
+struct MVTState
+{
+  double xmin;             /**< Minimum X value of the tile contents */
+  double xmax;             /**< Maximum X value of the tile contents */
+  double ymin;             /**< Minimum Y value of the tile contents */
+  double ymax;             /**< Maximum Y value of the tile contents */
+  int32_t extent;          /**< Tile extent in tile coordinate space */
+  int32_t buffer;          /**< Buffer distance in tile coordinate space */
+  bool clip_geom;          /**< True if the temporal points are clipped */
+  double res;              /**< Resolution for simplifying the points */
+  AFFINE affine;           /**< Transformation to tile coordinate space */
+  gridspec grid;           /**< Grid for snapping to integer precision */
+  double fxmin;            /**< Minimum X value of the temporal points that
+                                may intersect the tile */
+  double fxmax;            /**< Maximum X value of the same */
+  double fymin;            /**< Minimum Y value of the same */
+  double fymax;            /**< Maximum Y value of the same */
+};
+
+/**
+ * @brief Ensure the validity of the arguments of a transformation into a
+ * vector tile
+ */
+static bool
+ensure_valid_mvt_args(const STBox *bounds, int32_t extent)
+{
+  if (bounds->xmax - bounds->xmin <= 0 || bounds->ymax - bounds->ymin <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "%s: Geometric bounds are too small", __func__);
+    return false;
+  }
+  if (extent <= 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "%s: Extent must be greater than 0", __func__);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Initialize the transformation of temporal points into a vector tile
+ * @param[in] bounds Geometric bounds of the tile contents without buffer
+ * @param[in] extent Tile extent in tile coordinate space
+ * @param[in] buffer Buffer distance in tile coordinate space
+ * @param[in] clip_geom True if the temporal points should be clipped
+ * @param[out] state State
+ */
+static void
+tpoint_mvt_state_init(const STBox *bounds, int32_t extent, int32_t buffer,
+  bool clip_geom, MVTState *state)
+{
+  memset(state, 0, sizeof(MVTState));
+  state->xmin = bounds->xmin;
+  state->xmax = bounds->xmax;
+  state->ymin = bounds->ymin;
+  state->ymax = bounds->ymax;
+  state->extent = extent;
+  state->buffer = buffer;
+  state->clip_geom = clip_geom;
+
+  double width = bounds->xmax - bounds->xmin;
+  double height = bounds->ymax - bounds->ymin;
+  double resx = width / extent;
+  double resy = height / extent;
+  state->res = (resx < resy ? resx : resy) / 2;
+  double fx = extent / width;
+  double fy = -(extent / height);
+  state->affine.afac = fx;
+  state->affine.efac = fy;
+  state->affine.ifac = 1;
+  state->affine.xoff = -bounds->xmin * fx;
+  state->affine.yoff = -bounds->ymax * fy;
+  state->grid.xsize = 1;
+  state->grid.ysize = 1;
+
+  /* Bounds of the temporal points that may intersect the clipping box, which
+   * are enlarged by one tile unit to account for the snapping to the grid */
+  state->fxmin = bounds->xmin - (buffer + 1) * resx;
+  state->fxmax = bounds->xmax + (buffer + 1) * resx;
+  state->fymin = bounds->ymin - (buffer + 1) * resy;
+  state->fymax = bounds->ymax + (buffer + 1) * resy;
+  return;
+}
+
 /**
  * @brief Return a temporal point transformed into vector tile coordinate
  * space
  * @param[in] tpoint Temporal point
- * @param[in] box Geometric bounds of the tile contents without buffer
- * @param[in] extent Tile extent in tile coordinate space
- * @param[in] buffer Buffer distance in tile coordinate space
- * @param[in] clip_geom True if temporal point should be clipped
+ * @param[in] state Transformation into the vector tile
  */
 static Temporal *
-tpoint_mvt(const Temporal *tpoint, const STBox *box, uint32_t extent,
-  uint32_t buffer, bool clip_geom)
+tpoint_mvt(const Temporal *tpoint, const MVTState *state)
 {
-  AFFINE affine = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-  gridspec grid = {0, 0, 0, 0, 1, 1, 0, 0};
-  double width = box->xmax - box->xmin;
-  double height = box->ymax - box->ymin;
-  double resx, resy, res, fx, fy;
-
-  resx = width / extent;
-  resy = height / extent;
-  res = (resx < resy ? resx : resy) / 2;
-  fx = extent / width;
-  fy = -(extent / height);
+  /* When clipping, skip the temporal points whose bounding box does not
+   * intersect the tile since their clipping is empty */
+  if (state->clip_geom)
+  {
+    STBox box;
+    temporal_set_bbox(tpoint, &box);
+    if (box.xmax < state->fxmin || box.xmin > state->fxmax ||
+        box.ymax < state->fymin || box.ymin > state->fymax)
+      return NULL;
+  }
 
   /* Remove all non-essential points (under the output resolution) */
-  Temporal *tpoint1 = tpoint_remove_repeated_points(tpoint, res, 2);
+  Temporal *tpoint1 = tpoint_remove_repeated_points(tpoint, state->res, 2);
 
   /* Euclidean (not synchronized) distance, i.e., parameter set to false */
-  Temporal *tpoint2 = temporal_simplify_dp(tpoint1, res, false);
+  Temporal *tpoint2 = temporal_simplify_dp(tpoint1, state->res, false);
   pfree(tpoint1);
 
   /* Transform to tile coordinate space */
-  affine.afac = fx;
-  affine.efac = fy;
-  affine.ifac = 1;
-  affine.xoff = -box->xmin * fx;
-  affine.yoff = -box->ymax * fy;
-  Temporal *tpoint3 = tpoint_affine(tpoint2, &affine);
+  Temporal *tpoint3 = tpoint_affine(tpoint2, &state->affine);
   pfree(tpoint2);
 
   /* Snap to integer precision, removing duplicate and single points */
-  Temporal *tpoint4 = tpoint_grid(tpoint3, &grid, true);
+  Temporal *tpoint4 = tpoint_grid(tpoint3, &state->grid, true);
   pfree(tpoint3);
-  if (tpoint4 == NULL || ! clip_geom)
+  if (tpoint4 == NULL || ! state->clip_geom)
     return tpoint4;
 
   /* Clip temporal point taking into account the buffer */
-  double max = (double) extent + (double) buffer;
-  double min = -(double) buffer;
+  double max = (double) state->extent + (double) state->buffer;
+  double min = -(double) state->buffer;
   int srid = tpoint_srid(tpoint);
   STBox clip_box;
   stbox_set(true, false, false, srid, min, max, min, max, 0, 0, NULL,
@@ -3453,7 +3994,7 @@ tpoint_mvt(const Temporal *tpoint, const STBox *box, uint32_t extent,
   if (tpoint5 == NULL)
     return NULL;
   /* We need to grid again the result of the clipping */
-  Temporal *result = tpoint_grid(tpoint5, &grid, true);
+  Temporal *result = tpoint_grid(tpoint5, &state->grid, true);
   pfree(tpoint5);
   return result;
 }
@@ -3609,42 +4150,55 @@ tpoint_decouple(const Temporal *temp, int64 **timesarr, int *count)
 
 /**
  * @ingroup meos_temporal_spatial_transf
- * @brief Return a temporal point transformed to Mapbox Vector Tile format
- * @param[in] temp Temporal point
+ * @brief Return the state for transforming many temporal points into the same
+ * Mapbox Vector Tile
+ * @details The transformation into the tile coordinate space and the clipping
+ * box are computed once for all the temporal points of the tile, and the
+ * temporal points whose bounding box does not intersect the tile are skipped
+ * without being transformed.
  * @param[in] bounds Bounds
  * @param[in] extent Extent
  * @param[in] buffer Buffer
  * @param[in] clip_geom True when the geometry is clipped
+ * @return On error return @p NULL
+ * @see #tpoint_AsMVTGeom()
+ */
+MVTState *
+tpoint_mvt_state_make(const STBox *bounds, int32_t extent, int32_t buffer,
+  bool clip_geom)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) bounds) ||
+      ! ensure_valid_mvt_args(bounds, extent))
+    return NULL;
+  MVTState *result = palloc(sizeof(MVTState));
+  tpoint_mvt_state_init(bounds, extent, buffer, clip_geom, result);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_transf
+ * @brief Return a temporal point transformed to Mapbox Vector Tile format
+ * using the transformation of a state
+ * @param[in] state State
+ * @param[in] temp Temporal point
  * @param[out] gsarr Array of geometries
  * @param[out] timesarr Array of timestamps
  * @param[out] count Number of elements in the output array
- * @csqlfn #Tpoint_AsMVTGeom()
+ * @return Return false when the temporal point does not intersect the tile
+ * or on error
  */
 bool
-tpoint_AsMVTGeom(const Temporal *temp, const STBox *bounds, int32_t extent,
-  int32_t buffer, bool clip_geom, GSERIALIZED **gsarr, int64 **timesarr,
-  int *count)
+tpoint_mvt_state_push(const MVTState *state, const Temporal *temp,
+  GSERIALIZED **gsarr, int64 **timesarr, int *count)
 {
   /* Ensure validity of the arguments */
-  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) bounds) ||
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) temp) ||
       ! ensure_not_null((void *) gsarr) ||
       ! ensure_not_null((void *) timesarr) ||
       ! ensure_not_null((void *) count) || ! ensure_tgeo_type(temp->temptype))
     return false;
 
-  if (bounds->xmax - bounds->xmin <= 0 || bounds->ymax - bounds->ymin <= 0)
-  {
-    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-      "%s: Geometric bounds are too small", __func__);
-    return false;
-  }
-  if (extent <= 0)
-  {
-    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-      "%s: Extent must be greater than 0", __func__);
-    return false;
-  }
-
   /* Contrary to what is done in PostGIS we do not use the following filter
    * to enable the visualization of temporal points with instant subtype.
    * PostGIS filtering adapted to MobilityDB would be as follows.
@@ -3665,7 +4219,7 @@ tpoint_AsMVTGeom(const Temporal *temp, const STBox *bounds, int32_t extent,
   }
   */
 
-  Temporal *temp1 = tpoint_mvt(temp, bounds, extent, buffer, clip_geom);
+  Temporal *temp1 = tpoint_mvt(temp, state);
   if (temp1 == NULL)
     return false;
 
@@ -3676,6 +4230,55 @@ tpoint_AsMVTGeom(const Temporal *temp, const STBox *bounds, int32_t extent,
   return true;
 }
 
+/**
+ * @ingroup meos_temporal_spatial_transf
+ * @brief Return true if a state for transforming temporal points into a
+ * Mapbox Vector Tile has the given parameters
+ * @param[in] state State
+ * @param[in] bounds Bounds
+ * @param[in] extent Extent
+ * @param[in] buffer Buffer
+ * @param[in] clip_geom True when the geometry is clipped
+ */
+bool
+tpoint_mvt_state_eq(const MVTState *state, const STBox *bounds,
+  int32_t extent, int32_t buffer, bool clip_geom)
+{
+  return state->xmin == bounds->xmin && state->xmax == bounds->xmax &&
+    state->ymin == bounds->ymin && state->ymax == bounds->ymax &&
+    state->extent == extent && state->buffer == buffer &&
+    state->clip_geom == clip_geom;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_transf
+ * @brief Return a temporal point transformed to Mapbox Vector Tile format
+ * @param[in] temp Temporal point
+ * @param[in] bounds Bounds
+ * @param[in] extent Extent
+ * @param[in] buffer Buffer
+ * @param[in] clip_geom True when the geometry is clipped
+ * @param[out] gsarr Array of geometries
+ * @param[out] timesarr Array of timestamps
+ * @param[out] count Number of elements in the output array
+ * @note When transforming many temporal points into the same tile use
+ * #tpoint_mvt_state_make() and #tpoint_mvt_state_push()
+ * @csqlfn #Tpoint_AsMVTGeom()
+ */
+bool
+tpoint_AsMVTGeom(const Temporal *temp, const STBox *bounds, int32_t extent,
+  int32_t buffer, bool clip_geom, GSERIALIZED **gsarr, int64 **timesarr,
+  int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) bounds) ||
+      ! ensure_valid_mvt_args(bounds, extent))
+    return false;
+  MVTState state;
+  tpoint_mvt_state_init(bounds, extent, buffer, clip_geom, &state);
+  return tpoint_mvt_state_push(&state, temp, gsarr, timesarr, count);
+}
+
 /*****************************************************************************
  * Length functions
  *****************************************************************************/
@@ -3742,6 +4345,19 @@ tpointseq_length(const TSequence *seq)
     return MEOS_FLAGS_GET_Z(seq->flags) ?
       tpointseq_length_3d(seq) : tpointseq_length_2d(seq);
   }
+  else if (meos_get_fast_geodetic())
+  {
+    double result = 0;
+    const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, 0)));
+    for (int i = 1; i < seq->count; i++)
+    {
+      const POINT2D *p2 =
+        DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+      result += geog_distance_haversine(p1, p2);
+      p1 = p2;
+    }
+    return result;
+  }
   else
   {
     /* We are sure that the trajectory is a line */
@@ -3792,8 +4408,184 @@ tpoint_length(const Temporal *temp)
     return tpointseqset_length((TSequenceSet *) temp);
 }
 
+#if MEOS
+/**
+ * @brief Return the length traversed by a view of a temporal point sequence
+ * @pre The temporal point has linear interpolation
+ * @see #tpointseq_length
+ */
+static double
+tpointseqview_length(const TSequenceView *view)
+{
+  int16 flags = view->seq->flags;
+  int count = tsequenceview_count(view);
+  if (count == 1)
+    return 0;
+  /* Geodetic points that require the exact spheroidal length are computed
+   * on the materialized sequence */
+  if (MEOS_FLAGS_GET_GEODETIC(flags) && ! meos_get_fast_geodetic())
+  {
+    TSequence *seq = tsequenceview_make(view);
+    double result = tpointseq_length(seq);
+    pfree(seq);
+    return result;
+  }
+  double result = 0;
+  bool hasz = MEOS_FLAGS_GET_Z(flags);
+  bool geodetic = MEOS_FLAGS_GET_GEODETIC(flags);
+  Datum value1 = tinstant_val(tsequenceview_inst_n(view, 0));
+  for (int i = 1; i < count; i++)
+  {
+    Datum value2 = tinstant_val(tsequenceview_inst_n(view, i));
+    if (geodetic)
+      result += geog_distance_haversine(DATUM_POINT2D_P(value1),
+        DATUM_POINT2D_P(value2));
+    else if (hasz)
+    {
+      const POINT3DZ *p1 = DATUM_POINT3DZ_P(value1);
+      const POINT3DZ *p2 = DATUM_POINT3DZ_P(value2);
+      result += sqrt( ((p1->x - p2->x)*(p1->x - p2->x)) +
+        ((p1->y - p2->y)*(p1->y - p2->y)) +
+        ((p1->z - p2->z)*(p1->z - p2->z)) );
+    }
+    else
+    {
+      const POINT2D *p1 = DATUM_POINT2D_P(value1);
+      const POINT2D *p2 = DATUM_POINT2D_P(value2);
+      result += sqrt( ((p1->x - p2->x) * (p1->x - p2->x)) +
+        ((p1->y - p2->y) * (p1->y - p2->y)) );
+    }
+    value1 = value2;
+  }
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_accessor
+ * @brief Return the length traversed by a temporal point restricted to a
+ * timestamptz span
+ * @details The result is equal to the length of the restriction of the
+ * temporal point to the span but the composing instants are not copied
+ * @param[in] temp Temporal point
+ * @param[in] s Timestamp span
+ * @return On error return -1.0
+ * @see #tpoint_length
+ */
+double
+tpoint_length_at_tstzspan(const Temporal *temp, const Span *s)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) s) ||
+      ! ensure_tgeo_type(temp->temptype) ||
+      ! ensure_span_isof_type(s, T_TSTZSPAN))
+    return -1.0;
+
+  assert(temptype_subtype(temp->subtype));
+  if (! MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+    return 0.0;
+  TSequenceView view;
+  if (temp->subtype == TSEQUENCE)
+  {
+    if (! tcontseq_at_tstzspan_view((TSequence *) temp, s, &view))
+      return 0.0;
+    double result = tpointseqview_length(&view);
+    tsequenceview_free(&view);
+    return result;
+  }
+  /* TSEQUENCESET */
+  const TSequenceSet *ss = (const TSequenceSet *) temp;
+  double result = 0.0;
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (! tcontseq_at_tstzspan_view(TSEQUENCESET_SEQ_N(ss, i), s, &view))
+      continue;
+    result += tpointseqview_length(&view);
+    tsequenceview_free(&view);
+  }
+  return result;
+}
+#endif /* MEOS */
+
 /*****************************************************************************/
 
+/**
+ * @brief Return the coordinates of a temporal point sequence as separate
+ * arrays (iterator function)
+ * @details Together with #tsequence_timestamps_iter, this function provides
+ * a columnar view of the sequence on which scans can be performed without
+ * accessing the instants
+ * @param[in] seq Temporal sequence
+ * @param[out] x,y,z Coordinates, where @p z is ignored if it is @p NULL or
+ * if the sequence has no Z dimension
+ * @note This function is called for each sequence of a temporal sequence set
+ */
+int
+tpointseq_coords_iter(const TSequence *seq, double *x, double *y, double *z)
+{
+  assert(seq); assert(x); assert(y); assert(tgeo_type(seq->temptype));
+  bool hasz = z && MEOS_FLAGS_GET_Z(seq->flags);
+  for (int i = 0; i < seq->count; i++)
+  {
+    Datum value = tinstant_val(TSEQUENCE_INST_N(seq, i));
+    if (hasz)
+    {
+      const POINT3DZ *p = DATUM_POINT3DZ_P(value);
+      x[i] = p->x; y[i] = p->y; z[i] = p->z;
+    }
+    else
+    {
+      const POINT2D *p = DATUM_POINT2D_P(value);
+      x[i] = p->x; y[i] = p->y;
+    }
+  }
+  return seq->count;
+}
+
+/**
+ * @brief Compute in a single pass the lengths of the segments of a temporal
+ * point sequence
+ * @details The distance between planar points is computed inline, as it is
+ * shared by the cumulative length and the speed of the sequence
+ * @param[in] seq Temporal sequence
+ * @param[out] lengths Array of @p seq->count - 1 segment lengths
+ * @return Total length of the sequence
+ * @pre The sequence has linear interpolation and at least two instants
+ */
+double
+tpointseq_segment_lengths(const TSequence *seq, double *lengths)
+{
+  assert(seq); assert(tgeo_type(seq->temptype));
+  assert(MEOS_FLAGS_LINEAR_INTERP(seq->flags)); assert(seq->count > 1);
+  double result = 0;
+  if (! MEOS_FLAGS_GET_GEODETIC(seq->flags) &&
+      ! MEOS_FLAGS_GET_Z(seq->flags))
+  {
+    const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, 0)));
+    for (int i = 1; i < seq->count; i++)
+    {
+      const POINT2D *p2 =
+        DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+      lengths[i - 1] = (p1->x == p2->x && p1->y == p2->y) ? 0.0 :
+        distance2d_pt_pt(p1, p2);
+      result += lengths[i - 1];
+      p1 = p2;
+    }
+    return result;
+  }
+
+  datum_func2 func = pt_distance_fn(seq->flags);
+  Datum value1 = tinstant_val(TSEQUENCE_INST_N(seq, 0));
+  for (int i = 1; i < seq->count; i++)
+  {
+    Datum value2 = tinstant_val(TSEQUENCE_INST_N(seq, i));
+    lengths[i - 1] = datum_point_eq(value1, value2) ? 0.0 :
+      DatumGetFloat8(func(value1, value2));
+    result += lengths[i - 1];
+    value1 = value2;
+  }
+  return result;
+}
+
 /**
  * @ingroup meos_internal_temporal_spatial_accessor
  * @brief Return the cumulative length traversed by a temporal point sequence
@@ -3817,21 +4609,19 @@ tpointseq_cumulative_length(const TSequence *seq, double prevlength)
   }
 
   /* General case */
+  double *lengths = palloc(sizeof(double) * (seq->count - 1));
+  tpointseq_segment_lengths(seq, lengths);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  datum_func2 func = pt_distance_fn(seq->flags);
-  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
-  Datum value1 = tinstant_val(inst1);
   double length = prevlength;
-  instants[0] = tinstant_make(Float8GetDatum(length), T_TFLOAT, inst1->t);
+  instants[0] = tinstant_make(Float8GetDatum(length), T_TFLOAT,
+    TSEQUENCE_INST_N(seq, 0)->t);
   for (int i = 1; i < seq->count; i++)
   {
-    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
-    Datum value2 = tinstant_val(inst2);
-    if (! datum_point_eq(value1, value2))
-      length += DatumGetFloat8(func(value1, value2));
-    instants[i] = tinstant_make(Float8GetDatum(length), T_TFLOAT, inst2->t);
-    value1 = value2;
+    length += lengths[i - 1];
+    instants[i] = tinstant_make(Float8GetDatum(length), T_TFLOAT,
+      TSEQUENCE_INST_N(seq, i)->t);
   }
+  pfree(lengths);
   return tsequence_make_free(instants, seq->count, seq->period.lower_inc,
     seq->period.upper_inc, LINEAR, NORMALIZE);
 }
@@ -3929,22 +4719,20 @@ tpointseq_speed(const TSequence *seq)
     return NULL;
 
   /* General case */
+  double *lengths = palloc(sizeof(double) * (seq->count - 1));
+  tpointseq_segment_lengths(seq, lengths);
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
-  datum_func2 func = pt_distance_fn(seq->flags);
   const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
-  Datum value1 = tinstant_val(inst1);
   double speed = 0.0; /* make compiler quiet */
   for (int i = 0; i < seq->count - 1; i++)
   {
     const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
-    Datum value2 = tinstant_val(inst2);
-    speed = datum_point_eq(value1, value2) ? 0.0 :
-      DatumGetFloat8(func(value1, value2)) /
-        ((double)(inst2->t - inst1->t) / 1000000.0);
+    speed = lengths[i] == 0.0 ? 0.0 :
+      lengths[i] / ((double)(inst2->t - inst1->t) / 1000000.0);
     instants[i] = tinstant_make(Float8GetDatum(speed), T_TFLOAT, inst1->t);
     inst1 = inst2;
-    value1 = value2;
   }
+  pfree(lengths);
   instants[seq->count - 1] = tinstant_make(Float8GetDatum(speed), T_TFLOAT,
     seq->period.upper);
   /* The resulting sequence has step interpolation */
@@ -4009,35 +4797,41 @@ tpoint_speed(const Temporal *temp)
  *****************************************************************************/
 
 /**
- * @brief Return a temporal point sequence split into temporal float sequences
- * for each of its coordinates (iterator function)
+ * @brief Add to the arguments the integrals of the coordinates of a temporal
+ * geometry point sequence with continuous interpolation (iterator function)
+ * @details The integrals are computed in a single pass over the points of
+ * the sequence as it is done in #tnumberseq_integral for each coordinate
  */
-void
-tpointseq_twcentroid_iter(const TSequence *seq, bool hasz, interpType interp,
-  TSequence **seqx, TSequence **seqy, TSequence **seqz)
+static void
+tpointcontseq_integral_iter(const TSequence *seq, bool hasz, double *x,
+  double *y, double *z)
 {
-  TInstant **instantsx = palloc(sizeof(TInstant *) * seq->count);
-  TInstant **instantsy = palloc(sizeof(TInstant *) * seq->count);
-  TInstant **instantsz = hasz ?
-    palloc(sizeof(TInstant *) * seq->count) : NULL;
-
-  for (int i = 0; i < seq->count; i++)
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags);
+  POINT4D p1, p2;
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  datum_point4d(tinstant_val(inst1), &p1);
+  for (int i = 1; i < seq->count; i++)
   {
-    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
-    POINT4D p;
-    datum_point4d(tinstant_val(inst), &p);
-    instantsx[i] = tinstant_make(Float8GetDatum(p.x), T_TFLOAT, inst->t);
-    instantsy[i] = tinstant_make(Float8GetDatum(p.y), T_TFLOAT, inst->t);
-    if (hasz)
-      instantsz[i] = tinstant_make(Float8GetDatum(p.z), T_TFLOAT, inst->t);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+    datum_point4d(tinstant_val(inst2), &p2);
+    double duration = (double) (inst2->t - inst1->t);
+    if (linear)
+    {
+      *x += (p1.x + p2.x) * duration / 2.0;
+      *y += (p1.y + p2.y) * duration / 2.0;
+      if (hasz)
+        *z += (p1.z + p2.z) * duration / 2.0;
+    }
+    else
+    {
+      *x += p1.x * duration;
+      *y += p1.y * duration;
+      if (hasz)
+        *z += p1.z * duration;
+    }
+    inst1 = inst2;
+    p1 = p2;
   }
-  *seqx = tsequence_make_free(instantsx, seq->count, seq->period.lower_inc,
-    seq->period.upper_inc, interp, NORMALIZE);
-  *seqy = tsequence_make_free(instantsy, seq->count, seq->period.lower_inc,
-    seq->period.upper_inc, interp, NORMALIZE);
-  if (hasz)
-    *seqz = tsequence_make_free(instantsz, seq->count, seq->period.lower_inc,
-      seq->period.upper_inc, interp, NORMALIZE);
   return;
 }
 
@@ -4045,6 +4839,9 @@ tpointseq_twcentroid_iter(const TSequence *seq, bool hasz, interpType interp,
  * @ingroup meos_internal_temporal_spatial_accessor
  * @brief Return the time-weighed centroid of a temporal geometry point
  * sequence
+ * @details The centroid is computed directly from the points of the
+ * sequence, which amounts to the time-weighted average of the temporal
+ * floats obtained for each coordinate
  * @param[in] seq Temporal sequence
  * @csqlfn #Tpoint_twcentroid()
  */
@@ -4054,23 +4851,33 @@ tpointseq_twcentroid(const TSequence *seq)
   assert(seq); assert(tgeo_type(seq->temptype));
   int srid = tpointseq_srid(seq);
   bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
-  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
-  TSequence *seqx, *seqy, *seqz;
-  tpointseq_twcentroid_iter(seq, hasz, interp, &seqx, &seqy, &seqz);
-  double twavgx = tnumberseq_twavg(seqx);
-  double twavgy = tnumberseq_twavg(seqy);
-  double twavgz = (hasz) ? tnumberseq_twavg(seqz) : 0.0;
-  GSERIALIZED *result = geopoint_make(twavgx, twavgy, twavgz, hasz, false, srid);
-  pfree(seqx); pfree(seqy);
-  if (hasz)
-    pfree(seqz);
-  return result;
+  double x = 0.0, y = 0.0, z = 0.0;
+  double duration = (double) (DatumGetTimestampTz(seq->period.upper) -
+    DatumGetTimestampTz(seq->period.lower));
+  if (MEOS_FLAGS_DISCRETE_INTERP(seq->flags) || duration == 0.0)
+  {
+    /* Discrete or instantaneous sequence: average of the points */
+    for (int i = 0; i < seq->count; i++)
+    {
+      POINT4D p;
+      datum_point4d(tinstant_val(TSEQUENCE_INST_N(seq, i)), &p);
+      x += p.x; y += p.y; z += p.z;
+    }
+    duration = (double) seq->count;
+  }
+  else
+    tpointcontseq_integral_iter(seq, hasz, &x, &y, &z);
+  return geopoint_make(x / duration, y / duration, hasz ? z / duration : 0.0,
+    hasz, false, srid);
 }
 
 /**
  * @ingroup meos_internal_temporal_spatial_accessor
  * @brief Return the time-weighed centroid of a temporal geometry point
  * sequence set
+ * @details The centroid is computed directly from the points of the
+ * composing sequences as it is done in #tnumberseqset_twavg for each
+ * coordinate
  * @param[in] ss Temporal sequence set
  * @csqlfn #Tpoint_twcentroid()
  */
@@ -4080,27 +4887,29 @@ tpointseqset_twcentroid(const TSequenceSet *ss)
   assert(ss); assert(tgeo_type(ss->temptype));
   int srid = tpointseqset_srid(ss);
   bool hasz = MEOS_FLAGS_GET_Z(ss->flags);
-  interpType interp = MEOS_FLAGS_GET_INTERP(ss->flags);
-  TSequence **sequencesx = palloc(sizeof(TSequence *) * ss->count);
-  TSequence **sequencesy = palloc(sizeof(TSequence *) * ss->count);
-  TSequence **sequencesz = hasz ?
-    palloc(sizeof(TSequence *) * ss->count) : NULL;
+  double x = 0.0, y = 0.0, z = 0.0, duration = 0.0;
   for (int i = 0; i < ss->count; i++)
-    tpointseq_twcentroid_iter(TSEQUENCESET_SEQ_N(ss, i), hasz, interp,
-      &sequencesx[i], &sequencesy[i], &sequencesz[i]);
-  TSequenceSet *ssx = tsequenceset_make_free(sequencesx, ss->count, NORMALIZE);
-  TSequenceSet *ssy = tsequenceset_make_free(sequencesy, ss->count, NORMALIZE);
-  TSequenceSet *ssz = hasz ?
-    tsequenceset_make_free(sequencesz, ss->count, NORMALIZE) : NULL;
-
-  double twavgx = tnumberseqset_twavg(ssx);
-  double twavgy = tnumberseqset_twavg(ssy);
-  double twavgz = hasz ? tnumberseqset_twavg(ssz) : 0;
-  GSERIALIZED *result = geopoint_make(twavgx, twavgy, twavgz, hasz, false, srid);
-  pfree(ssx); pfree(ssy);
-  if (hasz)
-    pfree(ssz);
-  return result;
+  {
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    duration += (double) (DatumGetTimestampTz(seq->period.upper) -
+      DatumGetTimestampTz(seq->period.lower));
+    tpointcontseq_integral_iter(seq, hasz, &x, &y, &z);
+  }
+  if (duration == 0.0)
+  {
+    /* All sequences are instantaneous: average of their first points */
+    x = y = z = 0.0;
+    for (int i = 0; i < ss->count; i++)
+    {
+      POINT4D p;
+      datum_point4d(tinstant_val(TSEQUENCE_INST_N(TSEQUENCESET_SEQ_N(ss, i),
+        0)), &p);
+      x += p.x; y += p.y; z += p.z;
+    }
+    duration = (double) ss->count;
+  }
+  return geopoint_make(x / duration, y / duration, hasz ? z / duration : 0.0,
+    hasz, false, srid);
 }
 
 /**
@@ -4144,21 +4953,36 @@ geom_azimuth(Datum geom1, Datum geom2)
   return Float8GetDatum(result);
 }
 
+/**
+ * @brief Return the azimuth of two geography points given by their
+ * coordinates
+ * @note Same computation as the PostGIS function `lwgeom_azumith_spheroid`
+ * without building the intermediate LWGEOM of the points
+ */
+static double
+geog_azimuth_pt_pt(const POINT2D *p1, const POINT2D *p2, const SPHEROID *s)
+{
+  /* Same point, return NaN */
+  if (FP_EQUALS(p1->x, p2->x) && FP_EQUALS(p1->y, p2->y))
+    return NAN;
+  GEOGRAPHIC_POINT g1, g2;
+  geographic_point_init(p1->x, p1->y, &g1);
+  geographic_point_init(p2->x, p2->y, &g2);
+  double result = spheroid_direction(&g1, &g2, s);
+  /* Ensure result is positive */
+  return result < -0 ? 2 * M_PI + result : result;
+}
+
 /**
  * @brief Return the azimuth two geography points
  */
 static Datum
 geog_azimuth(Datum geog1, Datum geog2)
 {
-  const GSERIALIZED *g1 = DatumGetGserializedP(geog1);
-  const GSERIALIZED *g2 = DatumGetGserializedP(geog2);
-  const LWGEOM *geom1 = lwgeom_from_gserialized(g1);
-  const LWGEOM *geom2 = lwgeom_from_gserialized(g2);
-
   SPHEROID s;
   spheroid_init(&s, WGS84_MAJOR_AXIS, WGS84_MINOR_AXIS);
-  double result = lwgeom_azumith_spheroid(lwgeom_as_lwpoint(geom1),
-    lwgeom_as_lwpoint(geom2), &s);
+  double result = geog_azimuth_pt_pt(DATUM_POINT2D_P(geog1),
+    DATUM_POINT2D_P(geog2), &s);
   return Float8GetDatum(result);
 }
 
@@ -4271,33 +5095,46 @@ tpointseq_azimuth_iter(const TSequence *seq, TSequence **result)
   if (seq->count == 1)
     return 0;
 
-  /* Determine the PostGIS function to call */
-  datum_func2 func = MEOS_FLAGS_GET_GEODETIC(seq->flags) ?
-    &geog_azimuth : &geom_azimuth;
+  /* The azimuth is computed directly on the coordinates of the points */
+  bool geodetic = MEOS_FLAGS_GET_GEODETIC(seq->flags);
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  SPHEROID s;
+  if (geodetic)
+    spheroid_init(&s, WGS84_MAJOR_AXIS, WGS84_MINOR_AXIS);
 
   /* We are sure that there are at least 2 instants */
   TInstant **instants = palloc(sizeof(TInstant *) * seq->count);
   const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
-  Datum value1 = tinstant_val(inst1);
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(inst1));
   int ninsts = 0, nseqs = 0;
-  Datum azimuth = 0; /* Make the compiler quiet */
+  double azimuth = 0; /* Make the compiler quiet */
   bool lower_inc = seq->period.lower_inc;
   bool upper_inc = false; /* make compiler quiet */
   for (int i = 1; i < seq->count; i++)
   {
     const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
-    Datum value2 = tinstant_val(inst2);
+    const POINT2D *p2 = DATUM_POINT2D_P(tinstant_val(inst2));
     upper_inc = (i == seq->count - 1) ? seq->period.upper_inc : false;
-    if (! datum_point_eq(value1, value2))
+    /* Same test as in #datum_point_eq since the SRID and the flags of all
+     * the instants of the sequence are equal */
+    bool eq = float8_eq(p1->x, p2->x) && float8_eq(p1->y, p2->y) &&
+      (! hasz || float8_eq(((const POINT3DZ *) p1)->z,
+        ((const POINT3DZ *) p2)->z));
+    if (! eq)
     {
-      azimuth = func(value1, value2);
-      instants[ninsts++] = tinstant_make(azimuth, T_TFLOAT, inst1->t);
+      if (geodetic)
+        azimuth = geog_azimuth_pt_pt(p1, p2, &s);
+      else
+        azimuth_pt_pt(p1, p2, &azimuth);
+      instants[ninsts++] = tinstant_make(Float8GetDatum(azimuth), T_TFLOAT,
+        inst1->t);
     }
     else
     {
       if (ninsts != 0)
       {
-        instants[ninsts++] = tinstant_make(azimuth, T_TFLOAT, inst1->t);
+        instants[ninsts++] = tinstant_make(Float8GetDatum(azimuth), T_TFLOAT,
+          inst1->t);
         upper_inc = true;
         /* Resulting sequence has step interpolation */
         result[nseqs++] = tsequence_make((const TInstant **) instants, ninsts,
@@ -4309,14 +5146,17 @@ tpointseq_azimuth_iter(const TSequence *seq, TSequence **result)
       lower_inc = true;
     }
     inst1 = inst2;
-    value1 = value2;
+    p1 = p2;
   }
   if (ninsts != 0)
   {
-    instants[ninsts++] = tinstant_make(azimuth, T_TFLOAT, inst1->t);
+    instants[ninsts++] = tinstant_make(Float8GetDatum(azimuth), T_TFLOAT,
+      inst1->t);
     /* Resulting sequence has step interpolation */
     result[nseqs++] = tsequence_make((const TInstant **) instants, ninsts,
       lower_inc, upper_inc, STEP, NORMALIZE);
+    for (int j = 0; j < ninsts; j++)
+      pfree(instants[j]);
   }
 
   pfree(instants);
@@ -4821,66 +5661,276 @@ mrr_distance_geos(GEOSGeometry *geom, bool geodetic)
   return result;
 }
 
+/*****************************************************************************
+ * Stop detection
+ * The window of instants is extended with each new instant and its bounding
+ * box is maintained with monotonic deques. Since the diagonal of the minimum
+ * rotated rectangle is between the diameter of the points and sqrt(2) times
+ * it, the bounding box decides most windows, and the exact rectangle is only
+ * computed with GEOS for the windows that are close to the maximum distance.
+ *****************************************************************************/
+
+/** Number of monotonic deques of a stop detection state */
+#define STOPS_DEQUES 4
+
+/**
+ * @brief Structure to keep the state of the detection of stops of a
+ * temporal point
+ */
+struct StopsState
+{
+  double maxdist;        /**< Maximum size of the area of a stop */
+  int64 mintunits;       /**< Minimum duration of a stop in microseconds */
+  bool geodetic;         /**< True if the points are geodetic */
+  bool copy;             /**< True if the state owns copies of the instants */
+  bool is_stopped;       /**< True if the window is a stop */
+  bool previously_stopped; /**< True if the previous window was a stop */
+  int first;             /**< Position of the first instant of the buffer */
+  int start;             /**< Position of the first instant of the window */
+  int count;             /**< Number of instants received */
+  int maxcount;          /**< Number of instants allocated in the buffer */
+  const TInstant **instants; /**< Buffer of the instants */
+  POINT2D *points;       /**< Buffer of the points of the instants */
+  int *deques[STOPS_DEQUES]; /**< Deques of positions for the minimum and
+                              the maximum X and Y of the window */
+  int head[STOPS_DEQUES]; /**< First element of the deques */
+  int tail[STOPS_DEQUES]; /**< One past the last element of the deques */
+};
+
+/**
+ * @brief Return a new stop detection state
+ */
+static StopsState *
+tstops_state_init(double maxdist, int64 mintunits, bool copy, int maxcount)
+{
+  StopsState *result = palloc0(sizeof(StopsState));
+  result->maxdist = maxdist;
+  result->mintunits = mintunits;
+  result->copy = copy;
+  result->maxcount = Max(maxcount, 2);
+  result->instants = palloc(sizeof(TInstant *) * result->maxcount);
+  result->points = palloc(sizeof(POINT2D) * result->maxcount);
+  for (int i = 0; i < STOPS_DEQUES; i++)
+    result->deques[i] = palloc(sizeof(int) * result->maxcount);
+  return result;
+}
+
 /**
- * @brief Create a GEOS Multipoint geometry from a part (defined by start and
- * end) of a temporal point sequence
+ * @brief Free a stop detection state
  */
-static GEOSGeometry *
-multipoint_make(const TSequence *seq, int start, int end)
+static void
+tstops_state_free(StopsState *state)
 {
-  GSERIALIZED *gs = NULL; /* make compiler quiet */
-  GEOSGeometry **geoms = palloc(sizeof(GEOSGeometry *) * (end - start + 1));
-  for (int i = 0; i < end - start + 1; ++i)
+  if (state->copy)
   {
-    if (tgeo_type(seq->temptype))
-      gs = DatumGetGserializedP(
-        tinstant_val(TSEQUENCE_INST_N(seq, start + i)));
-#if NPOINT
-    else if (seq->temptype == T_TNPOINT)
-      gs = npoint_geom(DatumGetNpointP(
-        tinstant_val(TSEQUENCE_INST_N(seq, start + i))));
-#endif
-    else
-    {
-      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-        "Sequence must have a spatial base type");
-      return NULL;
-    }
-    const POINT2D *pt = GSERIALIZED_POINT2D_P(gs);
+    for (int i = state->first; i < state->count; i++)
+      pfree((TInstant *) state->instants[i - state->first]);
+  }
+  pfree(state->instants);
+  pfree(state->points);
+  for (int i = 0; i < STOPS_DEQUES; i++)
+    pfree(state->deques[i]);
+  pfree(state);
+  return;
+}
+
+/** Instant at a position of a stop detection state */
+#define STOPS_INST(state, pos) ((state)->instants[(pos) - (state)->first])
+/** Point at a position of a stop detection state */
+#define STOPS_POINT(state, pos) (&(state)->points[(pos) - (state)->first])
+
+/**
+ * @brief Return the coordinate of a point compared by a deque of a stop
+ * detection state, negated for the deques of the maximum values
+ */
+static double
+tstops_deque_value(const StopsState *state, int deque, int pos)
+{
+  const POINT2D *pt = STOPS_POINT(state, pos);
+  double value = (deque < 2) ? pt->x : pt->y;
+  return (deque % 2 == 0) ? value : -value;
+}
+
+/**
+ * @brief Make room in the buffer of a stop detection state for a new instant
+ * @details The instants before the window are discarded and, when there are
+ * none, the buffer is enlarged
+ */
+static void
+tstops_state_reserve(StopsState *state)
+{
+  if (state->count - state->first < state->maxcount)
+    return;
+  int shift = state->start - state->first;
+  if (shift == 0)
+  {
+    state->maxcount *= 2;
+    state->instants = repalloc(state->instants,
+      sizeof(TInstant *) * state->maxcount);
+    state->points = repalloc(state->points,
+      sizeof(POINT2D) * state->maxcount);
+    for (int i = 0; i < STOPS_DEQUES; i++)
+      state->deques[i] = repalloc(state->deques[i],
+        sizeof(int) * state->maxcount);
+    return;
+  }
+  if (state->copy)
+  {
+    for (int i = 0; i < shift; i++)
+      pfree((TInstant *) state->instants[i]);
+  }
+  int n = state->count - state->start;
+  memmove(state->instants, &state->instants[shift], sizeof(TInstant *) * n);
+  memmove(state->points, &state->points[shift], sizeof(POINT2D) * n);
+  /* The positions in the deques are absolute, only their storage moves */
+  for (int i = 0; i < STOPS_DEQUES; i++)
+  {
+    int len = state->tail[i] - state->head[i];
+    memmove(state->deques[i], &state->deques[i][state->head[i]],
+      sizeof(int) * len);
+    state->head[i] = 0;
+    state->tail[i] = len;
+  }
+  state->first = state->start;
+  return;
+}
+
+/**
+ * @brief Remove from the deques of a stop detection state the positions
+ * before the start of the window
+ */
+static void
+tstops_deques_prune(StopsState *state)
+{
+  for (int i = 0; i < STOPS_DEQUES; i++)
+  {
+    while (state->head[i] < state->tail[i] &&
+        state->deques[i][state->head[i]] < state->start)
+      state->head[i]++;
+  }
+  return;
+}
+
+/**
+ * @brief Return true if the window of a stop detection state ending at a
+ * position is within an area of the maximum size
+ */
+static bool
+tstops_window_stopped(const StopsState *state, int end)
+{
+  if (! state->geodetic)
+  {
+    double xmin = STOPS_POINT(state, state->deques[0][state->head[0]])->x;
+    double xmax = STOPS_POINT(state, state->deques[1][state->head[1]])->x;
+    double ymin = STOPS_POINT(state, state->deques[2][state->head[2]])->y;
+    double ymax = STOPS_POINT(state, state->deques[3][state->head[3]])->y;
+    double width = xmax - xmin, height = ymax - ymin;
+    /* The diagonal of the rectangle is at least the diameter of the points,
+     * which is at least the width and the height of their bounding box */
+    if (Max(width, height) > state->maxdist)
+      return false;
+    /* The sides of the rectangle are at most the diameter of the points,
+     * which is at most the diagonal of their bounding box */
+    if (M_SQRT2 * hypot(width, height) <= state->maxdist)
+      return true;
+  }
+  int n = end - state->start + 1;
+  GEOSGeometry **geoms = palloc(sizeof(GEOSGeometry *) * n);
+  for (int i = 0; i < n; i++)
+  {
+    const POINT2D *pt = STOPS_POINT(state, state->start + i);
     geoms[i] = GEOSGeom_createPointFromXY(pt->x, pt->y);
   }
-  GEOSGeometry *result = GEOSGeom_createCollection(GEOS_MULTIPOINT, geoms, end - start + 1);
+  GEOSGeometry *geom = GEOSGeom_createCollection(GEOS_MULTIPOINT, geoms, n);
   pfree(geoms);
+  bool result = mrr_distance_geos(geom, state->geodetic) <= state->maxdist;
+  GEOSGeom_destroy(geom);
   return result;
 }
 
 /**
- * @brief Add the point stored in the given instant to a GEOS multipoint
- * geometry
+ * @brief Return a stop made of the instants of a stop detection state
+ * between two positions
+ */
+static TSequence *
+tstops_make_stop(const StopsState *state, int start, int end)
+{
+  return tsequence_make(&STOPS_INST(state, start), end - start + 1, true, true,
+    LINEAR, NORMALIZE_NO);
+}
+
+/**
+ * @brief Add an instant to a stop detection state and return the stop that
+ * ends before it, if any
+ * @pre The instant is after the previous one and has a spatial base type
  */
-static GEOSGeometry *
-multipoint_add_inst_free(GEOSGeometry *geom, const TInstant *inst)
+static TSequence *
+tstops_state_add(StopsState *state, const TInstant *inst)
 {
-  GSERIALIZED *gs = NULL; /* make compiler quiet */
+  tstops_state_reserve(state);
+  int end = state->count++;
+  POINT2D *pt = STOPS_POINT(state, end);
+  STOPS_INST(state, end) = state->copy ? tinstant_copy(inst) : inst;
   if (tgeo_type(inst->temptype))
-    gs = DatumGetGserializedP(tinstant_val(inst));
+    *pt = *GSERIALIZED_POINT2D_P(DatumGetGserializedP(tinstant_val(inst)));
 #if NPOINT
-  else if (inst->temptype == T_TNPOINT)
-    gs = npoint_geom(DatumGetNpointP(tinstant_val(inst)));
+  else /* inst->temptype == T_TNPOINT */
+  {
+    GSERIALIZED *gs = npoint_geom(DatumGetNpointP(tinstant_val(inst)));
+    *pt = *GSERIALIZED_POINT2D_P(gs);
+    pfree(gs);
+  }
 #endif
-  else
+  for (int i = 0; i < STOPS_DEQUES; i++)
   {
-    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
-      "Instant must have a spatial base type");
+    double value = tstops_deque_value(state, i, end);
+    while (state->tail[i] > state->head[i] && tstops_deque_value(state, i,
+        state->deques[i][state->tail[i] - 1]) >= value)
+      state->tail[i]--;
+    state->deques[i][state->tail[i]++] = end;
+  }
+
+  /* Advance the start of the window while it is longer than the duration */
+  const TInstant *inst1 = STOPS_INST(state, state->start);
+  while (! state->is_stopped && end - state->start > 1 &&
+      (int64) (inst->t - inst1->t) >= state->mintunits)
+    inst1 = STOPS_INST(state, ++state->start);
+  tstops_deques_prune(state);
+
+  if (end == state->start)
     return NULL;
+
+  TSequence *result = NULL;
+  state->is_stopped = tstops_window_stopped(state, end);
+  const TInstant *inst2 = STOPS_INST(state, end - 1);
+  if (! state->is_stopped && state->previously_stopped &&
+      (int64) (inst2->t - inst1->t) >= state->mintunits) // Found a stop
+  {
+    result = tstops_make_stop(state, state->start, end - 1);
+    state->start = end;
+    tstops_deques_prune(state);
   }
-  const POINT2D *pt = GSERIALIZED_POINT2D_P(gs);
-  GEOSGeometry *geom1 = GEOSGeom_createPointFromXY(pt->x, pt->y);
-  GEOSGeometry *result = GEOSUnion(geom, geom1);
-  GEOSGeom_destroy(geom1); GEOSGeom_destroy(geom);
+  state->previously_stopped = state->is_stopped;
   return result;
 }
 
+/**
+ * @brief Return the stop that ends with the last instant of a stop detection
+ * state, if any
+ */
+static TSequence *
+tstops_state_last(const StopsState *state)
+{
+  if (state->count == 0)
+    return NULL;
+  const TInstant *inst1 = STOPS_INST(state, state->start);
+  const TInstant *inst2 = STOPS_INST(state, state->count - 1);
+  if (state->is_stopped &&
+      (int64) (inst2->t - inst1->t) >= state->mintunits)
+    return tstops_make_stop(state, state->start, state->count - 1);
+  return NULL;
+}
+
 /**
  * @brief Return the subsequences where the temporal value stays within an area
  * with a given maximum size for at least the specified duration
@@ -4898,71 +5948,115 @@ tpointseq_stops_iter(const TSequence *seq, double maxdist, int64 mintunits,
   assert(seq); assert(seq->count > 1);
   assert(tgeo_type(seq->temptype) || seq->temptype == T_TNPOINT);
 
-  /* Use GEOS only for non-scalar input */
-  bool geodetic = MEOS_FLAGS_GET_GEODETIC(seq->flags);
-  const TInstant *inst1 = NULL, *inst2 = NULL; /* make compiler quiet */
-  GEOSGeometry *geom = NULL;
   initGEOS(lwnotice, lwgeom_geos_error);
-  geom = GEOSGeom_createEmptyCollection(GEOS_MULTIPOINT);
-
-  int end, start = 0, nseqs = 0;
-  bool  is_stopped = false,
-        previously_stopped = false,
-        rebuild_geom = false;
-
-  for (end = 0; end < seq->count; ++end)
+  /* The instants of the sequence are used without copying them */
+  StopsState *state = tstops_state_init(maxdist, mintunits, false,
+    seq->count);
+  state->geodetic = MEOS_FLAGS_GET_GEODETIC(seq->flags);
+  int nseqs = 0;
+  for (int i = 0; i < seq->count; i++)
   {
-    inst1 = TSEQUENCE_INST_N(seq, start);
-    inst2 = TSEQUENCE_INST_N(seq, end);
-
-    while (! is_stopped && end - start > 1
-      && (int64)(inst2->t - inst1->t) >= mintunits)
-    {
-      inst1 = TSEQUENCE_INST_N(seq, ++start);
-      rebuild_geom = true;
-    }
-
-    if (rebuild_geom)
-    {
-      GEOSGeom_destroy(geom);
-      geom = multipoint_make(seq, start, end);
-      rebuild_geom = false;
-    }
-    else
-      geom = multipoint_add_inst_free(geom, inst2);
-
-    if (end - start == 0)
-      continue;
+    TSequence *stop = tstops_state_add(state, TSEQUENCE_INST_N(seq, i));
+    if (stop)
+      result[nseqs++] = stop;
+  }
+  TSequence *stop = tstops_state_last(state);
+  if (stop)
+    result[nseqs++] = stop;
+  tstops_state_free(state);
+  return nseqs;
+}
 
-    is_stopped = mrr_distance_geos(geom, geodetic) <= maxdist;
-    inst2 = TSEQUENCE_INST_N(seq, end - 1);
-    if (! is_stopped && previously_stopped
-      && (int64)(inst2->t - inst1->t) >= mintunits) // Found a stop
-    {
-      const TInstant **insts = palloc(sizeof(TInstant *) * (end - start));
-      for (int i = 0; i < end - start; ++i)
-          insts[i] = TSEQUENCE_INST_N(seq, start + i);
-      result[nseqs++] = tsequence_make(insts, end - start,
-        true, true, LINEAR, NORMALIZE_NO);
-      start = end;
-      rebuild_geom = true;
-    }
-    previously_stopped = is_stopped;
+#if MEOS
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Return the initial state of the detection of stops of a stream of
+ * temporal point instants
+ * @param[in] maxdist Maximum size of the area of a stop
+ * @param[in] minduration Minimum duration of a stop
+ * @return On error return @p NULL
+ * @see #tstops_state_push()
+ * @see #temporal_stops()
+ */
+StopsState *
+tstops_state_make(double maxdist, const Interval *minduration)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) minduration) ||
+      ! ensure_not_negative_datum(Float8GetDatum(maxdist), T_FLOAT8))
+    return NULL;
+  /* We cannot call #ensure_valid_duration since the duration may be zero */
+  Interval intervalzero;
+  memset(&intervalzero, 0, sizeof(Interval));
+  if (pg_interval_cmp(minduration, &intervalzero) < 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The duration must be positive");
+    return NULL;
   }
-  GEOSGeom_destroy(geom);
+  return tstops_state_init(maxdist, interval_units(minduration), true, 64);
+}
 
-  inst2 = TSEQUENCE_INST_N(seq, end - 1);
-  if (is_stopped && (int64)(inst2->t - inst1->t) >= mintunits)
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Add a temporal point instant to the detection of stops of a stream
+ * and return the stop that has been determined, if any
+ * @details The stops are the same as those of #temporal_stops() applied to
+ * the linear sequence of the instants of the stream. Only the instants of
+ * the current window are kept in memory.
+ * @param[in] state State of the stop detection
+ * @param[in] inst Temporal point instant, which must be after the previous
+ * one
+ * @return Return a new sequence if a stop is found, @p NULL otherwise or on
+ * error
+ */
+TSequence *
+tstops_state_push(StopsState *state, const TInstant *inst)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state) || ! ensure_not_null((void *) inst))
+    return NULL;
+  if (! tgeo_type(inst->temptype) && inst->temptype != T_TNPOINT)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_TYPE,
+      "The temporal value must be a temporal point");
+    return NULL;
+  }
+  if (state->count == 0)
   {
-    const TInstant **insts = palloc(sizeof(TInstant *) * (end - start));
-    for (int i = 0; i < end - start; ++i)
-        insts[i] = TSEQUENCE_INST_N(seq, start + i);
-    result[nseqs++] = tsequence_make(insts, end - start,
-      true, true, LINEAR, NORMALIZE_NO);
+    initGEOS(lwnotice, lwgeom_geos_error);
+    state->geodetic = MEOS_FLAGS_GET_GEODETIC(inst->flags);
+  }
+  else
+  {
+    const TInstant *last = STOPS_INST(state, state->count - 1);
+    if (! ensure_same_temporal_type((Temporal *) last, (Temporal *) inst) ||
+        (tgeo_type(inst->temptype) &&
+          ! ensure_spatial_validity((Temporal *) last, (Temporal *) inst)) ||
+        ! ensure_increasing_timestamps(last, inst, true))
+      return NULL;
   }
+  return tstops_state_add(state, inst);
+}
 
-  return nseqs;
+/**
+ * @ingroup meos_temporal_accessor
+ * @brief Finish the detection of stops of a stream, returning the last stop
+ * if it has not yet been returned, and free the state
+ * @param[in] state State of the stop detection
+ * @return Return a new sequence, @p NULL if there is no pending stop
+ */
+TSequence *
+tstops_state_finish(StopsState *state)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) state))
+    return NULL;
+  TSequence *result = tstops_state_last(state);
+  tstops_state_free(state);
+  return result;
 }
+#endif /* MEOS */
 
 /*****************************************************************************
  * Functions computing the intersection of two segments derived from PostGIS
@@ -5214,6 +6308,286 @@ static void gbox_init_point2d(const POINT2D *p, GBOX *gbox)
   gbox->ymin = gbox->ymax = p->y;
 }
 
+/*
+ * Packed R-tree over the segments of a temporal point sequence used for
+ * finding the self-intersections of long sequences. The tree is built with
+ * the Sort-Tile-Recursive (STR) algorithm, the node @p i of level @p l
+ * groups the entries @p i * SEGINDEX_NODE_SIZE up to
+ * (@p i + 1) * SEGINDEX_NODE_SIZE - 1 of level @p l - 1, where the level -1
+ * is composed of the boxes of the segments in STR order.
+ */
+
+/**
+ * @brief Minimum number of segments of a piece of a sequence for
+ * which the self-intersections are found with a segment index
+ */
+#define SEGINDEX_MIN_SEGS 64
+
+/**
+ * @brief Number of entries of a node of a segment index
+ */
+#define SEGINDEX_NODE_SIZE 16
+
+typedef struct
+{
+  double xmin, ymin, xmax, ymax;
+} SegBox;
+
+typedef struct
+{
+  double cx, cy;    /**< Center of the box of the segment */
+  int seg;          /**< Number of the segment */
+} SegEntry;
+
+typedef struct
+{
+  int nsegs;        /**< Number of segments */
+  int *segs;        /**< Number of the segments in STR order */
+  SegBox *boxes;    /**< Boxes of the segments in STR order */
+  int nlevels;      /**< Number of levels of the tree */
+  int *counts;      /**< Number of nodes of each level */
+  SegBox **nodes;   /**< Nodes of each level */
+} SegIndex;
+
+/**
+ * @brief Comparator functions for the STR order of the segments
+ */
+static int
+seg_entry_cmp_x(const void *a, const void *b)
+{
+  double x1 = ((const SegEntry *) a)->cx, x2 = ((const SegEntry *) b)->cx;
+  return (x1 < x2) ? -1 : ((x1 > x2) ? 1 : 0);
+}
+
+static int
+seg_entry_cmp_y(const void *a, const void *b)
+{
+  double y1 = ((const SegEntry *) a)->cy, y2 = ((const SegEntry *) b)->cy;
+  return (y1 < y2) ? -1 : ((y1 > y2) ? 1 : 0);
+}
+
+/**
+ * @brief Expand the first box with the second one
+ */
+static void
+segbox_expand(SegBox *box1, const SegBox *box2)
+{
+  box1->xmin = Min(box1->xmin, box2->xmin);
+  box1->ymin = Min(box1->ymin, box2->ymin);
+  box1->xmax = Max(box1->xmax, box2->xmax);
+  box1->ymax = Max(box1->ymax, box2->ymax);
+}
+
+/**
+ * @brief Set the box of a segment, enlarged with the tolerance used in
+ * @p lw_seg_interact
+ */
+static void
+segbox_set(const POINT2D *p1, const POINT2D *p2, SegBox *box)
+{
+  box->xmin = Min(p1->x, p2->x) - FP_TOLERANCE;
+  box->ymin = Min(p1->y, p2->y) - FP_TOLERANCE;
+  box->xmax = Max(p1->x, p2->x) + FP_TOLERANCE;
+  box->ymax = Max(p1->y, p2->y) + FP_TOLERANCE;
+}
+
+/**
+ * @brief Return true if two boxes overlap
+ */
+static inline bool
+segbox_overlaps(const SegBox *box1, const SegBox *box2)
+{
+  return box1->xmin <= box2->xmax && box2->xmin <= box1->xmax &&
+    box1->ymin <= box2->ymax && box2->ymin <= box1->ymax;
+}
+
+/**
+ * @brief Free a segment index
+ */
+static void
+seg_index_free(SegIndex *index)
+{
+  for (int i = 0; i < index->nlevels; i++)
+    pfree(index->nodes[i]);
+  pfree(index->nodes); pfree(index->counts);
+  pfree(index->segs); pfree(index->boxes);
+  pfree(index);
+  return;
+}
+
+/**
+ * @brief Return a segment index for the segments @p first up to @p last - 1
+ * of an array of points
+ */
+static SegIndex *
+seg_index_make(const POINT2D **points, int first, int last)
+{
+  SegIndex *result = palloc(sizeof(SegIndex));
+  int nsegs = result->nsegs = last - first;
+  SegEntry *entries = palloc(sizeof(SegEntry) * nsegs);
+  for (int i = 0; i < nsegs; i++)
+  {
+    const POINT2D *p1 = points[first + i], *p2 = points[first + i + 1];
+    entries[i].cx = (p1->x + p2->x) / 2.0;
+    entries[i].cy = (p1->y + p2->y) / 2.0;
+    entries[i].seg = first + i;
+  }
+  /* Sort-Tile-Recursive order: vertical slices sorted on y */
+  int nleaves = (nsegs + SEGINDEX_NODE_SIZE - 1) / SEGINDEX_NODE_SIZE;
+  int slicesize = (int) ceil(sqrt((double) nleaves)) * SEGINDEX_NODE_SIZE;
+  qsort(entries, nsegs, sizeof(SegEntry), &seg_entry_cmp_x);
+  for (int i = 0; i < nsegs; i += slicesize)
+    qsort(&entries[i], Min(slicesize, nsegs - i), sizeof(SegEntry),
+      &seg_entry_cmp_y);
+  result->segs = palloc(sizeof(int) * nsegs);
+  result->boxes = palloc(sizeof(SegBox) * nsegs);
+  for (int i = 0; i < nsegs; i++)
+  {
+    int seg = entries[i].seg;
+    result->segs[i] = seg;
+    segbox_set(points[seg], points[seg + 1], &result->boxes[i]);
+  }
+  pfree(entries);
+
+  /* Build the levels of the tree bottom-up */
+  int maxlevels = 1;
+  for (int n = nleaves; n > 1; n = (n + SEGINDEX_NODE_SIZE - 1) /
+      SEGINDEX_NODE_SIZE)
+    maxlevels++;
+  result->nodes = palloc(sizeof(SegBox *) * maxlevels);
+  result->counts = palloc(sizeof(int) * maxlevels);
+  const SegBox *entryboxes = result->boxes;
+  int nentries = nsegs, level = 0;
+  while (true)
+  {
+    int n = (nentries + SEGINDEX_NODE_SIZE - 1) / SEGINDEX_NODE_SIZE;
+    SegBox *nodes = palloc(sizeof(SegBox) * n);
+    for (int i = 0; i < n; i++)
+    {
+      int j = i * SEGINDEX_NODE_SIZE;
+      int k = Min(j + SEGINDEX_NODE_SIZE, nentries);
+      nodes[i] = entryboxes[j];
+      for (j++; j < k; j++)
+        segbox_expand(&nodes[i], &entryboxes[j]);
+    }
+    result->nodes[level] = nodes;
+    result->counts[level++] = n;
+    if (n == 1)
+      break;
+    entryboxes = nodes;
+    nentries = n;
+  }
+  result->nlevels = level;
+  return result;
+}
+
+/**
+ * @brief Return true if the segment @p j intersects a segment @p i with
+ * @p start <= @p i < @p j of the subtree rooted at a node of a segment index
+ * @note Two consecutive segments that touch each other in their common point
+ * do not intersect
+ */
+static bool
+seg_index_intersects(const SegIndex *index, const POINT2D **points,
+  int level, int node, const SegBox *box, int start, int j)
+{
+  int first = node * SEGINDEX_NODE_SIZE;
+  if (level == 0)
+  {
+    int last = Min(first + SEGINDEX_NODE_SIZE, index->nsegs);
+    for (int k = first; k < last; k++)
+    {
+      int i = index->segs[k];
+      if (i < start || i >= j || ! segbox_overlaps(&index->boxes[k], box))
+        continue;
+      POINT2D p = { 0 }; /* make compiler quiet */
+      int intertype = seg2d_intersection(points[i], points[i + 1],
+        points[j], points[j + 1], &p);
+      if (intertype > 0 &&
+          (intertype != MEOS_SEG_TOUCH_END || j != i + 1 ||
+           p.x != points[j]->x || p.y != points[j]->y))
+        return true;
+    }
+    return false;
+  }
+  const SegBox *children = index->nodes[level - 1];
+  int last = Min(first + SEGINDEX_NODE_SIZE, index->counts[level - 1]);
+  for (int k = first; k < last; k++)
+  {
+    if (segbox_overlaps(&children[k], box) &&
+        seg_index_intersects(index, points, level - 1, k, box, start, j))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Return the first segment @p j > @p start of a piece of a sequence
+ * that intersects a previous segment of the piece, or @p end if there is
+ * none
+ * @details The segments are visited as in the pairwise search of function
+ * #tpointseq_linear_find_splits, including its bounding box shortcut, so
+ * that both searches find the same splits
+ * @param[in] index Segment index
+ * @param[in] points Points of the sequence
+ * @param[in] start,end Bounds of the piece
+ */
+static int
+seg_index_find_split(const SegIndex *index, const POINT2D **points,
+  int start, int end)
+{
+  int top = index->nlevels - 1;
+  GBOX box;
+  gbox_init_point2d(points[start], &box);
+  gbox_merge_point2d(points[start + 1], &box);
+  int j = start + 1;
+  while (j < end)
+  {
+    SegBox sbox;
+    segbox_set(points[j], points[j + 1], &sbox);
+    if (segbox_overlaps(&index->nodes[top][0], &sbox) &&
+        seg_index_intersects(index, points, top, 0, &sbox, start, j))
+      return j;
+    j++;
+    /* Shortcut */
+    if (! gbox_contains_point2d(&box, points[j]))
+    {
+      while (j < end)
+      {
+        bool out = false;
+        if (box.xmin > points[j]->x)
+        {
+          box.xmin = points[j]->x;
+          if (box.xmin > points[j + 1]->x)
+            out = true;
+        }
+        else if (box.xmax < points[j]->x)
+        {
+          box.xmax = points[j]->x;
+          if (box.xmax < points[j + 1]->x)
+            out = true;
+        }
+        if (box.ymin > points[j]->y)
+        {
+          box.ymin = points[j]->y;
+          if (box.ymin > points[j + 1]->y)
+            out = true;
+        }
+        else if (box.ymax < points[j]->y)
+        {
+          box.ymax = points[j]->y;
+          if (box.ymax < points[j + 1]->y)
+            out = true;
+        }
+        if (! out)
+          break;
+        j++;
+      }
+    }
+  }
+  return end;
+}
+
 /**
  * @brief Return a temporal point sequence with linear interpolation split into
  * an array of non self-intersecting fragments
@@ -5266,6 +6640,22 @@ tpointseq_linear_find_splits(const TSequence *seq, int *count)
       start = end;
       continue;
     }
+    /* For long pieces, find all the intersections until the next split due
+     * to stationary segments using an index of its segments */
+    if (end - start >= SEGINDEX_MIN_SEGS)
+    {
+      SegIndex *index = seg_index_make(points, start, end);
+      int split;
+      while ((split = seg_index_find_split(index, points, start, end)) < end)
+      {
+        bitarr[split] = true;
+        numsplits++;
+        start = split;
+      }
+      seg_index_free(index);
+      start = end;
+      continue;
+    }
     /* Find intersections in the piece defined by start and end in a
      * breadth-first search */
     int i = start, j = start + 1;
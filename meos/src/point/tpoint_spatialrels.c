@@ -48,13 +48,21 @@
 
 /* C */
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/lifting.h"
+#include "general/span.h"
 #include "point/pgis_types.h"
+#include "point/tpoint_restrfuncs.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tempspatialrels.h"
+#include "point/tpoint_tile.h"
 
 #define INVERT_RESULT(result) (result < 0 ? -1 : (result > 0) ? 0 : 1)
 
@@ -182,6 +190,17 @@ geog_dwithin(Datum geog1, Datum geog2, Datum dist)
     DatumGetGserializedP(geog2), DatumGetFloat8(dist), true));
 }
 
+/**
+ * @brief Return a Datum true if two geography points are within a distance
+ * in the fast geodetic mode
+ */
+Datum
+geog_point_dwithin_fast(Datum geog1, Datum geog2, Datum dist)
+{
+  return BoolGetDatum(geog_distance_haversine(DATUM_POINT2D_P(geog1),
+    DATUM_POINT2D_P(geog2)) <= DatumGetFloat8(dist));
+}
+
 /*****************************************************************************/
 
 /**
@@ -222,7 +241,8 @@ datum_func3
 get_dwithin_fn(int16 flags1, int16 flags2)
 {
   if (MEOS_FLAGS_GET_GEODETIC(flags1))
-    return &geog_dwithin;
+    return meos_get_fast_geodetic() ? &geog_point_dwithin_fast :
+      &geog_dwithin;
   else
     /* 3D only if both arguments are 3D */
     return MEOS_FLAGS_GET_Z(flags1) && MEOS_FLAGS_GET_Z(flags2) ?
@@ -248,6 +268,38 @@ get_dwithin_fn_gs(int16 flags1, uint8_t flags2)
  * Generic ever/always spatial relationship functions
  *****************************************************************************/
 
+/* Temporal point and trajectory of the last call to #tpoint_trajectory_cache */
+static MEOS_THREAD_LOCAL Temporal *TRAJ_CACHE_TEMP = NULL;
+static MEOS_THREAD_LOCAL GSERIALIZED *TRAJ_CACHE_TRAJ = NULL;
+
+/**
+ * @brief Return the trajectory of a temporal point, reusing the one computed
+ * in the previous call if the temporal point has the same content
+ * @details A query frequently evaluates several spatial relationships on the
+ * same temporal point, e.g., for testing it against several geofences. The
+ * cache is kept in memory allocated with malloc so that it survives the
+ * memory context of the call.
+ * @note The result is owned by the cache and must not be freed
+ */
+const GSERIALIZED *
+tpoint_trajectory_cache(const Temporal *temp)
+{
+  size_t size = VARSIZE(temp);
+  if (TRAJ_CACHE_TEMP && VARSIZE(TRAJ_CACHE_TEMP) == size &&
+      memcmp(TRAJ_CACHE_TEMP, temp, size) == 0)
+    return TRAJ_CACHE_TRAJ;
+
+  GSERIALIZED *traj = tpoint_trajectory(temp);
+  size_t trajsize = VARSIZE(traj);
+  free(TRAJ_CACHE_TEMP); free(TRAJ_CACHE_TRAJ);
+  TRAJ_CACHE_TEMP = malloc(size);
+  TRAJ_CACHE_TRAJ = malloc(trajsize);
+  memcpy(TRAJ_CACHE_TEMP, temp, size);
+  memcpy(TRAJ_CACHE_TRAJ, traj, trajsize);
+  pfree(traj);
+  return TRAJ_CACHE_TRAJ;
+}
+
 /**
  * @brief Generic spatial relationship for the trajectory of a temporal point
  * and a geometry
@@ -270,7 +322,7 @@ spatialrel_tpoint_traj_geo(const Temporal *temp, const GSERIALIZED *gs,
 
   assert(numparam == 2 || numparam == 3);
   Datum geo = PointerGetDatum(gs);
-  Datum traj = PointerGetDatum(tpoint_trajectory(temp));
+  Datum traj = PointerGetDatum(tpoint_trajectory_cache(temp));
   Datum result;
   if (numparam == 2)
   {
@@ -282,7 +334,6 @@ spatialrel_tpoint_traj_geo(const Temporal *temp, const GSERIALIZED *gs,
     datum_func3 func3 = (datum_func3) func;
     result = invert ? func3(geo, traj, param) : func3(traj, geo, param);
   }
-  pfree(DatumGetPointer(traj));
   return result ? 1 : 0;
 }
 
@@ -322,6 +373,142 @@ ea_spatialrel_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2,
   return eafunc_temporal_temporal(temp1, temp2, &lfinfo);
 }
 
+/*****************************************************************************
+ * Ever relationships of a temporal point and a polygon evaluated on an index
+ * of the edges of the polygon. Instead of building the trajectory and
+ * computing the relationship with GEOS, the instants and the segments of the
+ * temporal point are tested against the edges that overlap them, stopping at
+ * the first instant or segment that satisfies the relationship.
+ *****************************************************************************/
+
+/**
+ * @brief Return true if the trajectory of a temporal geometry point certainly
+ * does not intersect a geometry, as stated by the spatial signature of the
+ * temporal point
+ * @details The function avoids computing the trajectory and calling GEOS for
+ * the temporal points whose bounding box overlaps the one of the geometry,
+ * such as long diagonal trips, but whose trajectory remains far from it
+ */
+static bool
+tpoint_geo_signature_disjoint(const Temporal *temp, const GSERIALIZED *gs)
+{
+  STBox box1, box2;
+  if (MEOS_FLAGS_GET_GEODETIC(temp->flags) || ! geo_set_stbox(gs, &box2))
+    return false;
+  tspatial_set_stbox(temp, &box1);
+  return ! signature_overlaps_stbox(tpoint_space_signature(temp), &box1,
+    &box2);
+}
+
+/**
+ * @brief Return the index of the edges of a geometry if the ever
+ * relationships of a temporal point and the geometry can be evaluated on it,
+ * @p NULL otherwise
+ * @details The index is used for 2D temporal geometry points and 2D polygons
+ * or multipolygons
+ */
+static const EdgeIndex *
+tpoint_geo_edge_index(const Temporal *temp, const GSERIALIZED *gs)
+{
+  if (MEOS_FLAGS_GET_Z(temp->flags) || MEOS_FLAGS_GET_GEODETIC(temp->flags) ||
+      FLAGS_GET_Z(gs->gflags))
+    return NULL;
+  return edge_index_get(gs, 0, false);
+}
+
+/**
+ * @brief Return true if a temporal point sequence ever intersects the
+ * polygon of an edge index, or ever is in its interior
+ * @param[in] seq Temporal point
+ * @param[in] index Edge index
+ * @param[in] interior True for testing whether the sequence is ever in the
+ * interior of the polygon, false for testing whether it ever intersects it
+ * @param[in,out] edges,maxedges,fracs,maxfracs Arrays used for the queries
+ * of the index and their size
+ */
+static bool
+tpointseq_edge_index_ever(const TSequence *seq, const EdgeIndex *index,
+  bool interior, int **edges, int *maxedges, double **fracs, int *maxfracs)
+{
+  for (int i = 0; i < seq->count; i++)
+  {
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+    int loc = edge_index_locate_point(index, p, edges, maxedges);
+    if (interior ? loc == EDGEINDEX_INTERIOR : loc != EDGEINDEX_EXTERIOR)
+      return true;
+  }
+  if (! MEOS_FLAGS_LINEAR_INTERP(seq->flags))
+    return false;
+
+  /* No instant satisfies the relationship, test the segments */
+  for (int i = 0; i < seq->count - 1; i++)
+  {
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+    const POINT2D *q = DATUM_POINT2D_P(
+      tinstant_val(TSEQUENCE_INST_N(seq, i + 1)));
+    int nfracs = edge_index_segment_fractions(index, p, q, edges, maxedges,
+      fracs, maxfracs);
+    /* The segment crosses or touches an edge */
+    if (! interior)
+    {
+      if (nfracs > 2)
+        return true;
+      continue;
+    }
+    /* The pieces between two crossings are either in the interior, on the
+     * boundary, or in the exterior of the polygon */
+    const double *f = *fracs;
+    for (int j = 1; j < nfracs; j++)
+    {
+      if (f[j] == f[j - 1])
+        continue;
+      double mid = (f[j - 1] + f[j]) / 2;
+      POINT2D point = {p->x + (q->x - p->x) * mid,
+        p->y + (q->y - p->y) * mid};
+      if (edge_index_locate_point(index, &point, edges, maxedges) ==
+          EDGEINDEX_INTERIOR)
+        return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Return 1 if a temporal point ever intersects the polygon of an edge
+ * index, or ever is in its interior, 0 otherwise
+ * @param[in] temp Temporal point
+ * @param[in] index Edge index
+ * @param[in] interior True for testing whether the temporal point is ever in
+ * the interior of the polygon, false for testing whether it ever intersects it
+ */
+static int
+tpoint_edge_index_ever(const Temporal *temp, const EdgeIndex *index,
+  bool interior)
+{
+  int maxedges = 64, maxfracs = 64;
+  int *edges = palloc(sizeof(int) * maxedges);
+  double *fracs = palloc(sizeof(double) * maxfracs);
+  bool result = false;
+  if (temp->subtype == TINSTANT)
+  {
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val((TInstant *) temp));
+    int loc = edge_index_locate_point(index, p, &edges, &maxedges);
+    result = interior ? loc == EDGEINDEX_INTERIOR : loc != EDGEINDEX_EXTERIOR;
+  }
+  else if (temp->subtype == TSEQUENCE)
+    result = tpointseq_edge_index_ever((TSequence *) temp, index, interior,
+      &edges, &maxedges, &fracs, &maxfracs);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count && ! result; i++)
+      result = tpointseq_edge_index_ever(TSEQUENCESET_SEQ_N(ss, i), index,
+        interior, &edges, &maxedges, &fracs, &maxfracs);
+  }
+  pfree(edges); pfree(fracs);
+  return result ? 1 : 0;
+}
+
 /*****************************************************************************
  * Ever/always contains
  *****************************************************************************/
@@ -347,6 +534,11 @@ econtains_geo_tpoint(const GSERIALIZED *gs, const Temporal *temp)
   if (! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs) ||
       ! ensure_has_not_Z_gs(gs) || ! ensure_has_not_Z(temp->flags))
     return -1;
+  if (tpoint_geo_signature_disjoint(temp, gs))
+    return 0;
+  const EdgeIndex *index = tpoint_geo_edge_index(temp, gs);
+  if (index)
+    return tpoint_edge_index_ever(temp, index, true);
   GSERIALIZED *traj = tpoint_trajectory(temp);
   bool result = geo_relate_pattern(gs, traj, "T********");
   pfree(traj);
@@ -468,6 +660,15 @@ adisjoint_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2)
 int
 eintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
 {
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) gs) ||
+      ! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs))
+    return -1;
+  if (tpoint_geo_signature_disjoint(temp, gs))
+    return 0;
+  const EdgeIndex *index = tpoint_geo_edge_index(temp, gs);
+  if (index)
+    return tpoint_edge_index_ever(temp, index, false);
   datum_func2 func = get_intersects_fn_gs(temp->flags, gs->gflags);
   return spatialrel_tpoint_traj_geo(temp, gs, (Datum) NULL, (varfunc) func, 2,
     INVERT_NO);
@@ -491,6 +692,237 @@ aintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
   return INVERT_RESULT(result);
 }
 
+/*****************************************************************************/
+
+/**
+ * @brief Clip a segment to the spatial extent of a spatiotemporal box using
+ * the Liang-Barsky algorithm
+ * @param[in,out] p1,p2 Points defining the segment, which may be equal
+ * @param[in] box Spatiotemporal box
+ * @param[in] hasz True if the Z dimension of the box is clipped
+ * @return False if the segment does not intersect the box
+ */
+static bool
+segment_clip_stbox(POINT4D *p1, POINT4D *p2, const STBox *box, bool hasz)
+{
+  double start[3] = {p1->x, p1->y, p1->z};
+  double delta[3] = {p2->x - p1->x, p2->y - p1->y, p2->z - p1->z};
+  double min[3] = {box->xmin, box->ymin, box->zmin};
+  double max[3] = {box->xmax, box->ymax, box->zmax};
+  double u1 = 0.0, u2 = 1.0;
+  for (int i = 0; i < (hasz ? 3 : 2); i++)
+  {
+    if (delta[i] == 0.0)
+    {
+      if (start[i] < min[i] || start[i] > max[i])
+        return false;
+      continue;
+    }
+    double ua = (min[i] - start[i]) / delta[i];
+    double ub = (max[i] - start[i]) / delta[i];
+    u1 = Max(u1, Min(ua, ub));
+    u2 = Min(u2, Max(ua, ub));
+    if (u1 > u2)
+      return false;
+  }
+  p1->x = start[0] + u1 * delta[0];
+  p1->y = start[1] + u1 * delta[1];
+  p1->z = start[2] + u1 * delta[2];
+  p2->x = start[0] + u2 * delta[0];
+  p2->y = start[1] + u2 * delta[1];
+  p2->z = start[2] + u2 * delta[2];
+  return true;
+}
+
+/**
+ * @brief Return a point or a line from the clipped segment of a temporal
+ * point
+ */
+static LWGEOM *
+lwgeom_make_segment(const POINT4D *p1, const POINT4D *p2, bool hasz,
+  int32 srid)
+{
+  if (p1->x == p2->x && p1->y == p2->y && (! hasz || p1->z == p2->z))
+    return hasz ?
+      (LWGEOM *) lwpoint_make3dz(srid, p1->x, p1->y, p1->z) :
+      (LWGEOM *) lwpoint_make2d(srid, p1->x, p1->y);
+  POINTARRAY *pa = ptarray_construct_empty((char) hasz, 0, 2);
+  ptarray_append_point(pa, p1, LW_TRUE);
+  ptarray_append_point(pa, p2, LW_TRUE);
+  LWGEOM *result = (LWGEOM *) lwline_construct(srid, NULL, pa);
+  FLAGS_SET_Z(result->flags, hasz);
+  return result;
+}
+
+/**
+ * @brief Collect the points and lines of a temporal point sequence that are
+ * within a time span and a spatiotemporal box
+ * @param[in] seq Temporal point sequence
+ * @param[in] s Time span, may be NULL
+ * @param[in] box Spatiotemporal box with X dimension, may be NULL
+ * @param[in] boxz True if the Z dimension of the box is clipped
+ * @param[out] points,lines Arrays of points and lines
+ * @param[out] npoints,nlines Number of elements in the arrays
+ */
+static void
+tpointseq_clip_span_stbox(const TSequence *seq, const Span *s,
+  const STBox *box, bool boxz, LWGEOM **points, LWGEOM **lines, int *npoints,
+  int *nlines)
+{
+  bool hasz = MEOS_FLAGS_GET_Z(seq->flags);
+  int32 srid = tpointseq_srid(seq);
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  POINT4D p1, p2;
+  int last = (interp == DISCRETE || seq->count == 1) ? 0 : seq->count - 1;
+  /* Segments of a continuous sequence */
+  for (int i = 0; i < last; i++)
+  {
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq, i);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
+    TimestampTz t1 = inst1->t, t2 = inst2->t;
+    if (s)
+    {
+      t1 = Max(t1, DatumGetTimestampTz(s->lower));
+      t2 = Min(t2, DatumGetTimestampTz(s->upper));
+      if (t1 > t2 || (t1 == t2 && ! contains_span_timestamptz(s, t1)))
+        continue;
+    }
+    datum_point4d(tinstant_val(inst1), &p1);
+    if (interp == STEP)
+    {
+      /* The value of the segment at its end instant is the next one */
+      if (t1 == inst2->t)
+        continue;
+      p2 = p1;
+    }
+    else
+    {
+      datum_point4d(tinstant_val(inst2), &p2);
+      double duration = (double) (inst2->t - inst1->t);
+      double ratio1 = (double) (t1 - inst1->t) / duration;
+      double ratio2 = (double) (t2 - inst1->t) / duration;
+      POINT4D p = p1;
+      p1.x = p.x + (p2.x - p.x) * ratio1;
+      p1.y = p.y + (p2.y - p.y) * ratio1;
+      p1.z = p.z + (p2.z - p.z) * ratio1;
+      p2.x = p.x + (p2.x - p.x) * ratio2;
+      p2.y = p.y + (p2.y - p.y) * ratio2;
+      p2.z = p.z + (p2.z - p.z) * ratio2;
+    }
+    if (box && ! segment_clip_stbox(&p1, &p2, box, boxz))
+      continue;
+    LWGEOM *geo = lwgeom_make_segment(&p1, &p2, hasz, srid);
+    if (geo->type == POINTTYPE)
+      points[(*npoints)++] = geo;
+    else
+      lines[(*nlines)++] = geo;
+  }
+  /* Instants of a discrete or a singleton sequence and last instant of a
+   * step sequence */
+  int first = (interp == DISCRETE || seq->count == 1) ? 0 :
+    (interp == STEP ? seq->count - 1 : seq->count);
+  for (int i = first; i < seq->count; i++)
+  {
+    const TInstant *inst = TSEQUENCE_INST_N(seq, i);
+    if (s && ! contains_span_timestamptz(s, inst->t))
+      continue;
+    datum_point4d(tinstant_val(inst), &p1);
+    p2 = p1;
+    if (box && ! segment_clip_stbox(&p1, &p2, box, boxz))
+      continue;
+    points[(*npoints)++] = lwgeom_make_segment(&p1, &p2, hasz, srid);
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_ever
+ * @brief Return 1 if a temporal point restricted to a time span and to a
+ * spatiotemporal box ever intersects a geometry, 0 if not, and -1 on error or
+ * if the geometry is empty
+ * @details The function is equivalent to
+ * `eIntersects(atStbox(atTime(temp, s), box), gs)` but clips the segments of
+ * the temporal point in a single pass without building the intermediate
+ * temporal values
+ * @param[in] temp Temporal point
+ * @param[in] s Time span, may be NULL
+ * @param[in] box Spatiotemporal box, may be NULL
+ * @param[in] gs Geometry
+ * @csqlfn #Eintersects_tpoint_span_stbox_geo()
+ */
+int
+eintersects_tpoint_span_stbox_geo(const Temporal *temp, const Span *s,
+  const STBox *box, const GSERIALIZED *gs)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) gs) ||
+      ! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs) ||
+      ! ensure_not_geodetic(temp->flags) ||
+      (s && ! ensure_span_isof_type(s, T_TSTZSPAN)) ||
+      (box && MEOS_FLAGS_GET_X(box->flags) &&
+        ! ensure_same_srid(tpoint_srid(temp), box->srid)))
+    return -1;
+
+  /* Combine the time span with the time dimension of the box */
+  Span period;
+  if (box && MEOS_FLAGS_GET_T(box->flags))
+  {
+    if (! s)
+      s = &box->period;
+    else if (inter_span_span(s, &box->period, &period))
+      s = &period;
+    else
+      return 0;
+  }
+  bool boxz = false;
+  if (box)
+  {
+    if (MEOS_FLAGS_GET_X(box->flags))
+      boxz = MEOS_FLAGS_GET_Z(temp->flags) && MEOS_FLAGS_GET_Z(box->flags);
+    else
+      box = NULL;
+  }
+
+  /* Collect the points and lines of the temporal point in the span and the
+   * box, the number of elements is bounded by the number of instants */
+  int count = temporal_num_instants(temp);
+  LWGEOM **points = palloc(sizeof(LWGEOM *) * count);
+  LWGEOM **lines = palloc(sizeof(LWGEOM *) * count);
+  int npoints = 0, nlines = 0;
+  if (temp->subtype == TINSTANT)
+  {
+    TSequence *seq = tinstant_to_tsequence((TInstant *) temp, DISCRETE);
+    tpointseq_clip_span_stbox(seq, s, box, boxz, points, lines, &npoints,
+      &nlines);
+    pfree(seq);
+  }
+  else if (temp->subtype == TSEQUENCE)
+    tpointseq_clip_span_stbox((TSequence *) temp, s, box, boxz, points,
+      lines, &npoints, &nlines);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count; i++)
+      tpointseq_clip_span_stbox(TSEQUENCESET_SEQ_N(ss, i), s, box, boxz,
+        points, lines, &npoints, &nlines);
+  }
+  if (npoints == 0 && nlines == 0)
+  {
+    pfree(points); pfree(lines);
+    return 0;
+  }
+
+  /* Evaluate the spatial relationship once on the clipped pieces */
+  LWGEOM *lwgeom = lwcoll_from_points_lines(points, lines, npoints, nlines);
+  GSERIALIZED *clipped = geo_serialize(lwgeom);
+  datum_func2 func = get_intersects_fn_gs(temp->flags, gs->gflags);
+  int result = DatumGetBool(func(PointerGetDatum(clipped),
+    PointerGetDatum(gs))) ? 1 : 0;
+  lwgeom_free(lwgeom);
+  pfree(clipped); pfree(points); pfree(lines);
+  return result;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_spatial_rel_ever
@@ -548,6 +980,8 @@ etouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
 
   /* There is no need to do a bounding box test since this is done in
    * the SQL function definition */
+  if (tpoint_geo_signature_disjoint(temp, gs))
+    return 0;
   datum_func2 func = get_intersects_fn_gs(temp->flags, gs->gflags);
   GSERIALIZED *traj = tpoint_trajectory(temp);
   GSERIALIZED *gsbound = geometry_boundary(gs);
@@ -603,9 +1037,78 @@ atouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs)
 
 /*****************************************************************************
  * Ever/always dwithin (for both geometry and geography)
- * The function only accepts points and not arbitrary geometries/geographies
  *****************************************************************************/
 
+/**
+ * @brief Return true if a temporal point sequence and the geometry of an
+ * edge index are ever within a distance
+ * @details For a polygon, a sequence with linear interpolation whose start
+ * point is in the exterior and that never comes within the distance of the
+ * boundary stays in the exterior, so that only the start point is located
+ * @param[in] seq Temporal point
+ * @param[in] index Edge index
+ * @param[in] dist Distance
+ * @param[in,out] edges,maxedges Array used for the queries of the index and
+ * its size
+ */
+static bool
+tpointseq_edge_index_dwithin(const TSequence *seq, const EdgeIndex *index,
+  double dist, int **edges, int *maxedges)
+{
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags);
+  double fraction;
+  for (int i = 0; i < seq->count; i++)
+  {
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+    if (index->areal && (i == 0 || ! linear) &&
+        edge_index_locate_point(index, p, edges, maxedges) !=
+          EDGEINDEX_EXTERIOR)
+      return true;
+    const POINT2D *q = (linear && i < seq->count - 1) ?
+      DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i + 1))) : p;
+    if (edge_index_segment_distance(index, p, q, dist, &fraction) >= 0)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Return 1 if a temporal point and the geometry of an edge index are
+ * ever within a distance, 0 otherwise
+ * @param[in] temp Temporal point
+ * @param[in] index Edge index
+ * @param[in] dist Distance
+ */
+static int
+tpoint_edge_index_dwithin(const Temporal *temp, const EdgeIndex *index,
+  double dist)
+{
+  int maxedges = 64;
+  int *edges = palloc(sizeof(int) * maxedges);
+  bool result = false;
+  if (temp->subtype == TINSTANT)
+  {
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val((TInstant *) temp));
+    double fraction;
+    result = (index->areal &&
+      edge_index_locate_point(index, p, &edges, &maxedges) !=
+        EDGEINDEX_EXTERIOR) ||
+      edge_index_segment_distance(index, p, p, dist, &fraction) >= 0;
+  }
+  else if (temp->subtype == TSEQUENCE)
+    result = tpointseq_edge_index_dwithin((TSequence *) temp, index, dist,
+      &edges, &maxedges);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count && ! result; i++)
+      result = tpointseq_edge_index_dwithin(TSEQUENCESET_SEQ_N(ss, i), index,
+        dist, &edges, &maxedges);
+  }
+  pfree(edges);
+  return result ? 1 : 0;
+}
+
 /**
  * @ingroup meos_temporal_spatial_rel_ever
  * @brief Return 1 if a geometry and a temporal point are ever within the
@@ -619,8 +1122,14 @@ int
 edwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist)
 {
   /* Ensure validity of the arguments */
-  if (! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+  if (! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
     return -1;
+  /* Use an index of the edges of large lines and polygons */
+  const EdgeIndex *index = tpoint_geo_dist_edge_index(temp, gs,
+    EDGEINDEX_MIN_POINTS);
+  if (index)
+    return tpoint_edge_index_dwithin(temp, index, dist);
   datum_func3 func = get_dwithin_fn_gs(temp->flags, gs->gflags);
   return spatialrel_tpoint_traj_geo(temp, gs, Float8GetDatum(dist),
     (varfunc) func, 3, INVERT_NO);
@@ -726,6 +1235,7 @@ ea_dwithin_tpointseq_tpointseq_cont(const TSequence *seq1,
 
   bool linear1 = MEOS_FLAGS_LINEAR_INTERP(seq1->flags);
   bool linear2 = MEOS_FLAGS_LINEAR_INTERP(seq2->flags);
+  bool step = ! linear1 || ! linear2;
   bool hasz = MEOS_FLAGS_GET_Z(seq1->flags);
   TimestampTz lower = start1->t;
   bool lower_inc = seq1->period.lower_inc;
@@ -755,11 +1265,20 @@ ea_dwithin_tpointseq_tpointseq_cont(const TSequence *seq1,
      * is true */
     int solutions = tdwithin_tpointsegm_tpointsegm(sv1, sev1, sv2, sev2,
       lower, upper, dist, hasz, func, &t1, &t2);
+    /* With step interpolation the segment values are kept until the upper
+     * bound exclusive, the end values at an inclusive upper bound are tested
+     * below */
     bool res = (solutions == 2 ||
       (solutions == 1 && ((t1 != lower || lower_inc) &&
-        (t1 != upper || upper_inc))));
+        (t1 != upper || (upper_inc && ! step)))));
     if ((ever && res) || (! ever && ! res))
       return ret_loop;
+    if (step && upper_inc)
+    {
+      res = DatumGetBool(func(ev1, ev2, Float8GetDatum(dist)));
+      if ((ever && res) || (! ever && ! res))
+        return ret_loop;
+    }
 
     sv1 = ev1;
     sv2 = ev2;
@@ -798,6 +1317,150 @@ ea_dwithin_tpointseqset_tpointseqset(const TSequenceSet *ss1,
   return ! ret_loop;
 }
 
+/**
+ * @brief Return 1 if two temporal points are ever within a distance,
+ * 0 if not, -1 if the temporal points do not intersect on time
+ * @param[in] seq1,seq2 Temporal points
+ * @param[in] dist Distance
+ * @param[in] func DWithin function (2D or 3D)
+ * @param[in] ever True for the ever semantics, false for the always semantics
+ * @note Contrary to #ea_dwithin_tpointseq_tpointseq_cont, the temporal points
+ * are not required to be synchronized, their segments are synchronized on the
+ * fly and the function stops at the first segment pair determining the result
+ */
+static int
+ea_dwithin_tcontseq_tcontseq(const TSequence *seq1, const TSequence *seq2,
+  double dist, datum_func3 func, bool ever)
+{
+  assert(seq1); assert(seq2);
+  Span inter;
+  if (! inter_span_span(&seq1->period, &seq2->period, &inter))
+    return -1;
+
+  /* If the two sequences intersect at an instant */
+  if (inter.lower == inter.upper)
+  {
+    Datum value1, value2;
+    tsequence_value_at_timestamptz(seq1, inter.lower, true, &value1);
+    tsequence_value_at_timestamptz(seq2, inter.lower, true, &value2);
+    bool res = DatumGetBool(func(value1, value2, Float8GetDatum(dist)));
+    pfree(DatumGetPointer(value1)); pfree(DatumGetPointer(value2));
+    return res ? 1 : 0;
+  }
+
+  bool linear1 = MEOS_FLAGS_LINEAR_INTERP(seq1->flags);
+  bool linear2 = MEOS_FLAGS_LINEAR_INTERP(seq2->flags);
+  bool step = ! linear1 || ! linear2;
+  bool hasz = MEOS_FLAGS_GET_Z(seq1->flags);
+  SyncSegmIter iter;
+  syncsegm_iter_init(&iter, seq1, seq2, &inter);
+  bool found = false;
+  while (! found && syncsegm_iter_next(&iter))
+  {
+    Datum sv1 = tinstant_val(iter.start1);
+    Datum sv2 = tinstant_val(iter.start2);
+    Datum ev1 = tinstant_val(iter.end1);
+    Datum ev2 = tinstant_val(iter.end2);
+    bool res;
+    /* Both segments are constant */
+    if (datum_point_eq(sv1, ev1) && datum_point_eq(sv2, ev2))
+      res = DatumGetBool(func(sv1, sv2, Float8GetDatum(dist)));
+    /* General case */
+    else
+    {
+      TimestampTz lower = iter.start1->t, upper = iter.end1->t, t1, t2;
+      Datum sev1 = linear1 ? ev1 : sv1;
+      Datum sev2 = linear2 ? ev2 : sv2;
+      /* Find the instants t1 and t2 (if any) during which the dwithin
+       * function is true */
+      int solutions = tdwithin_tpointsegm_tpointsegm(sv1, sev1, sv2, sev2,
+        lower, upper, dist, hasz, func, &t1, &t2);
+      /* With step interpolation the segment values are kept until the upper
+       * bound exclusive, the end values at an inclusive upper bound are tested
+       * below */
+      res = (solutions == 2 ||
+        (solutions == 1 && ((t1 != lower || iter.lower_inc) &&
+          (t1 != upper || (iter.upper_inc && ! step)))));
+    }
+    if ((ever && res) || (! ever && ! res))
+      found = true;
+    else if (step && iter.upper_inc)
+    {
+      res = DatumGetBool(func(ev1, ev2, Float8GetDatum(dist)));
+      if ((ever && res) || (! ever && ! res))
+        found = true;
+    }
+  }
+  syncsegm_iter_free(&iter);
+  if (found)
+    return ever ? 1 : 0;
+  return ever ? 0 : 1;
+}
+
+/**
+ * @brief Return the n-th sequence of a temporal continuous sequence or
+ * sequence set
+ */
+static inline const TSequence *
+tcont_seq_n(const Temporal *temp, int n)
+{
+  return (temp->subtype == TSEQUENCE) ? (const TSequence *) temp :
+    TSEQUENCESET_SEQ_N((const TSequenceSet *) temp, n);
+}
+
+/**
+ * @brief Return 1 if two temporal points are ever within a distance,
+ * 0 if not, -1 if the temporal points do not intersect on time
+ * @param[in] temp1,temp2 Temporal points
+ * @param[in] dist Distance
+ * @param[in] ever True for the ever semantics, false for the always semantics
+ * @pre The temporal points are continuous sequences or sequence sets
+ */
+static int
+ea_dwithin_tcont_tcont(const Temporal *temp1, const Temporal *temp2,
+  double dist, bool ever)
+{
+  datum_func3 func = get_dwithin_fn(temp1->flags, temp2->flags);
+  int count1 = (temp1->subtype == TSEQUENCE) ? 1 :
+    ((const TSequenceSet *) temp1)->count;
+  int count2 = (temp2->subtype == TSEQUENCE) ? 1 :
+    ((const TSequenceSet *) temp2)->count;
+  bool overlap = false;
+  int i = 0, j = 0;
+  while (i < count1 && j < count2)
+  {
+    const TSequence *seq1 = tcont_seq_n(temp1, i);
+    const TSequence *seq2 = tcont_seq_n(temp2, j);
+    int res = ea_dwithin_tcontseq_tcontseq(seq1, seq2, dist, func, ever);
+    if (res != -1)
+    {
+      if ((ever && res == 1) || (! ever && res == 0))
+        return res;
+      overlap = true;
+    }
+    int cmp = timestamptz_cmp_internal(DatumGetTimestampTz(seq1->period.upper),
+      DatumGetTimestampTz(seq2->period.upper));
+    if (cmp == 0)
+    {
+      if (! seq1->period.upper_inc && seq2->period.upper_inc)
+        cmp = -1;
+      else if (seq1->period.upper_inc && ! seq2->period.upper_inc)
+        cmp = 1;
+    }
+    if (cmp == 0)
+    {
+      i++; j++;
+    }
+    else if (cmp < 0)
+      i++;
+    else
+      j++;
+  }
+  if (! overlap)
+    return -1;
+  return ever ? 0 : 1;
+}
+
 /*****************************************************************************/
 
 /**
@@ -847,6 +1510,13 @@ ea_dwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2,
       ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
     return -1;
 
+  /* Continuous temporal points are synchronized segment by segment without
+   * constructing the synchronized temporal points */
+  if (temp1->subtype != TINSTANT && temp2->subtype != TINSTANT &&
+      ! MEOS_FLAGS_DISCRETE_INTERP(temp1->flags) &&
+      ! MEOS_FLAGS_DISCRETE_INTERP(temp2->flags))
+    return ea_dwithin_tcont_tcont(temp1, temp2, dist, ever);
+
   Temporal *sync1, *sync2;
   /* Return NULL if the temporal points do not intersect in time
    * The operation is synchronization without adding crossings */
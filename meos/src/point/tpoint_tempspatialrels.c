@@ -66,6 +66,9 @@
  * - In the case of a temporal point and a point we partly reuse the above
  *   solution by making seg2 to be constant
  *   which amounts to solve the equation distance(seg1(t), seg2(t)) = d.
+ * - In the case of a temporal point and a line or a polygon, the periods at
+ *   which each segment is within the distance of the edges near it are
+ *   obtained from an index of the edges of the geometry.
  */
 
 #include "point/tpoint_tempspatialrels.h"
@@ -73,6 +76,7 @@
 /* C */
 #include <assert.h>
 #include <math.h>
+#include <stdlib.h>
 /* PostgreSQL */
 /* PostGIS */
 #include <liblwgeom.h>
@@ -505,6 +509,147 @@ tintersects_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs,
 
 /*****************************************************************************/
 
+/**
+ * @brief Add a span to the spans at which a temporal point intersects a
+ * geometry, enlarging the array if needed
+ */
+static void
+geoarr_add_span(const Span *s, Span **spans, int *count, int *maxcount)
+{
+  if (*count == *maxcount)
+  {
+    *maxcount = (*maxcount == 0) ? 4 : *maxcount * 2;
+    *spans = (*spans == NULL) ? palloc(sizeof(Span) * *maxcount) :
+      repalloc(*spans, sizeof(Span) * *maxcount);
+  }
+  (*spans)[(*count)++] = *s;
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Return the time at which a temporal point intersects each geometry
+ * of an array
+ * @details The temporal point is split into simple fragments and their
+ * trajectories are computed only once for all the geometries, which are
+ * then filtered with bounding box tests
+ * @param[in] temp Temporal point
+ * @param[in] gsarr Array of geometries
+ * @param[in] count Number of elements in the array
+ * @return Array of @p count span sets, an element is NULL when the temporal
+ * point never intersects the corresponding geometry. On error return NULL
+ * @csqlfn #Tintersects_tpoint_geoarr()
+ */
+SpanSet **
+tintersects_tpoint_geoarr(const Temporal *temp, const GSERIALIZED **gsarr,
+  int count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) gsarr) ||
+      ! ensure_positive(count) || ! ensure_has_not_Z(temp->flags))
+    return NULL;
+  for (int i = 0; i < count; i++)
+  {
+    if (! ensure_valid_tpoint_geo(temp, gsarr[i]) ||
+        ! ensure_has_not_Z_gs(gsarr[i]))
+      return NULL;
+  }
+
+  SpanSet **result = palloc0(sizeof(SpanSet *) * count);
+  /* Temporal points without linear interpolation do not need to be split */
+  if (! MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+  {
+    for (int i = 0; i < count; i++)
+    {
+      if (gserialized_is_empty(gsarr[i]))
+        continue;
+      Temporal *inter = tinterrel_tpoint_geo(temp, gsarr[i], TINTERSECTS,
+        true, true);
+      if (inter)
+      {
+        result[i] = temporal_time(inter);
+        pfree(inter);
+      }
+    }
+    return result;
+  }
+
+  /* Bounding boxes of the geometries */
+  STBox *boxes = palloc(sizeof(STBox) * count);
+  for (int i = 0; i < count; i++)
+  {
+    if (! gserialized_is_empty(gsarr[i]))
+      geo_set_stbox(gsarr[i], &boxes[i]);
+  }
+  /* Spans at which the temporal point intersects each geometry */
+  Span **spans = palloc0(sizeof(Span *) * count);
+  int *nspans = palloc0(sizeof(int) * count);
+  int *maxspans = palloc0(sizeof(int) * count);
+
+  int nseqs;
+  const TSequence **seqs = temporal_seqs(temp, &nseqs);
+  for (int i = 0; i < nseqs; i++)
+  {
+    /* Instantaneous sequence */
+    if (seqs[i]->count == 1)
+    {
+      Datum value = tinstant_val(TSEQUENCE_INST_N(seqs[i], 0));
+      for (int j = 0; j < count; j++)
+      {
+        if (! gserialized_is_empty(gsarr[j]) && DatumGetBool(
+              geom_intersects2d(value, PointerGetDatum(gsarr[j]))))
+          geoarr_add_span(&seqs[i]->period, &spans[j], &nspans[j],
+            &maxspans[j]);
+      }
+      continue;
+    }
+
+    /* Split the sequence into simple fragments */
+    int nsimple;
+    TSequence **simpleseqs = tpointseq_make_simple(seqs[i], &nsimple);
+    for (int k = 0; k < nsimple; k++)
+    {
+      const TSequence *seq = simpleseqs[k];
+      const STBox *box = TSEQUENCE_BBOX_PTR(seq);
+      GSERIALIZED *traj = NULL;
+      for (int j = 0; j < count; j++)
+      {
+        if (gserialized_is_empty(gsarr[j]) ||
+            ! overlaps_stbox_stbox(box, &boxes[j]))
+          continue;
+        /* The trajectory is only computed once for all the geometries */
+        if (! traj)
+          traj = tpointseq_trajectory(seq);
+        GSERIALIZED *gsinter = DatumGetGserializedP(geom_intersection2d(
+          PointerGetDatum(traj), PointerGetDatum(gsarr[j])));
+        if (! gserialized_is_empty(gsinter))
+        {
+          int npers;
+          Span *periods = tpointseq_interperiods(seq, gsinter, &npers);
+          for (int l = 0; l < npers; l++)
+            geoarr_add_span(&periods[l], &spans[j], &nspans[j],
+              &maxspans[j]);
+          if (npers > 0)
+            pfree(periods);
+        }
+        pfree(gsinter);
+      }
+      if (traj)
+        pfree(traj);
+    }
+    pfree_array((void **) simpleseqs, nsimple);
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    if (nspans[i] > 0)
+      result[i] = spanset_make_free(spans[i], nspans[i], NORMALIZE, ORDER);
+  }
+  pfree(seqs); pfree(boxes); pfree(spans); pfree(nspans); pfree(maxspans);
+  return result;
+}
+
+/*****************************************************************************/
+
 /**
  * @brief Evaluates tintersects/tdisjoint for two temporal points
  * @param[in] temp1,temp2 Temporal point2
@@ -652,6 +797,73 @@ tgeompoint '[POINT(4 3)@2000-01-04, POINT(5 3)@2000-01-05]', 1)
 
  *****************************************************************************/
 
+/**
+ * @brief Return the timestamps at which the distance between two segments
+ * given by the coefficients of the quadratic equation of their squared
+ * distance minus the squared distance threshold is negative or zero
+ * @param[in] a,b,c Coefficients of the quadratic equation, where @p a is not
+ * zero
+ * @param[in] lower,upper Timestamps associated to the segments
+ * @param[out] t1,t2 Resulting timestamps
+ * @result Number of timestamps in the result, between 0 and 2. In the case
+ * of a single result both t1 and t2 are set to the unique timestamp
+ */
+static int
+tdwithin_quadratic(long double a, long double b, long double c,
+  TimestampTz lower, TimestampTz upper, TimestampTz *t1, TimestampTz *t2)
+{
+  double duration = (double) (upper - lower);
+  /* Solving the quadratic equation for distance = dist */
+  long double discriminant = b * b - 4 * a * c;
+
+  /* One solution */
+  if (discriminant == 0)
+  {
+    long double t5 = (-1 * b) / (2 * a);
+    if (t5 < 0.0 || t5 > 1.0)
+      return 0;
+    *t1 = *t2 = lower + (TimestampTz) (t5 * duration);
+    return 1;
+  }
+  /* No solution */
+  if (discriminant < 0)
+    return 0;
+  else
+  /* At most two solutions depending on whether they are within the time interval */
+  {
+    /* Apply a mixture of quadratic formula and Viète formula to improve precision */
+    long double t5, t6;
+    if (b >= 0)
+    {
+      t5 = (-1 * b - sqrtl(discriminant)) / (2 * a);
+      t6 = (2 * c ) / (-1 * b - sqrtl(discriminant));
+    }
+    else
+    {
+      t5 = (2 * c ) / (-1 * b + sqrtl(discriminant));
+      t6 = (-1 * b + sqrtl(discriminant)) / (2 * a);
+    }
+
+    /* If the two intervals do not intersect */
+    if (0.0 > t6 || t5 > 1.0)
+      return 0;
+    /* Compute the intersection of the two intervals */
+    long double t7 = Max(0.0, t5);
+    long double t8 = Min(1.0, t6);
+    if (fabsl(t7 - t8) < MEOS_EPSILON)
+    {
+      *t1 = *t2 = lower + (TimestampTz) (t7 * duration);
+      return 1;
+    }
+    else
+    {
+      *t1 = lower + (TimestampTz) (t7 * duration);
+      *t2 = lower + (TimestampTz) (t8 * duration);
+      return 2;
+    }
+  }
+}
+
 /**
  * @brief Return the timestamps at which EITHER the segments of the two
  * temporal points OR a segment of a temporal point and a point are within a
@@ -671,7 +883,6 @@ tdwithin_tpointsegm_tpointsegm(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
   TimestampTz lower, TimestampTz upper, double dist, bool hasz,
   datum_func3 func, TimestampTz *t1, TimestampTz *t2)
 {
-  double duration = (double) (upper - lower);
   long double a, b, c;
   if (hasz) /* 3D */
   {
@@ -759,55 +970,71 @@ tdwithin_tpointsegm_tpointsegm(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
     return 2;
   }
 
-  /* Solving the quadratic equation for distance = dist */
-  long double discriminant = b * b - 4 * a * c;
+  return tdwithin_quadratic(a, b, c, lower, upper, t1, t2);
+}
 
-  /* One solution */
-  if (discriminant == 0)
-  {
-    long double t5 = (-1 * b) / (2 * a);
-    if (t5 < 0.0 || t5 > 1.0)
-      return 0;
-    *t1 = *t2 = lower + (TimestampTz) (t5 * duration);
-    return 1;
-  }
-  /* No solution */
-  if (discriminant < 0)
-    return 0;
-  else
-  /* At most two solutions depending on whether they are within the time interval */
-  {
-    /* Apply a mixture of quadratic formula and Viète formula to improve precision */
-    long double t5, t6;
-    if (b >= 0)
-    {
-      t5 = (-1 * b - sqrtl(discriminant)) / (2 * a);
-      t6 = (2 * c ) / (-1 * b - sqrtl(discriminant));
-    }
-    else
-    {
-      t5 = (2 * c ) / (-1 * b + sqrtl(discriminant));
-      t6 = (-1 * b + sqrtl(discriminant)) / (2 * a);
-    }
+/**
+ * @brief Return the difference in degrees between two longitudes normalized
+ * to the range [-180, 180]
+ */
+static double
+lon_diff(double lon1, double lon2)
+{
+  double result = lon2 - lon1;
+  if (result > 180.0)
+    result -= 360.0;
+  else if (result < -180.0)
+    result += 360.0;
+  return result;
+}
 
-    /* If the two intervals do not intersect */
-    if (0.0 > t6 || t5 > 1.0)
+/**
+ * @brief Return the timestamps at which the segments of two temporal
+ * geography points are within a distance in the fast geodetic mode
+ * @details The segments are projected to a local equirectangular plane
+ * centered at the mean latitude of their points, in which the squared
+ * distance is a quadratic function of time
+ * @param[in] sv1,ev1 Points defining the first segment
+ * @param[in] sv2,ev2 Points defining the second segment
+ * @param[in] lower,upper Timestamps associated to the segments
+ * @param[in] dist Distance in meters
+ * @param[in] func DWithin function
+ * @param[out] t1,t2 Resulting timestamps
+ * @result Number of timestamps in the result, between 0 and 2
+ */
+static int
+tdwithin_tgeogpointsegm_fast(Datum sv1, Datum ev1, Datum sv2, Datum ev2,
+  TimestampTz lower, TimestampTz upper, double dist, datum_func3 func,
+  TimestampTz *t1, TimestampTz *t2)
+{
+  const POINT2D *p1 = DATUM_POINT2D_P(sv1);
+  const POINT2D *p2 = DATUM_POINT2D_P(ev1);
+  const POINT2D *p3 = DATUM_POINT2D_P(sv2);
+  const POINT2D *p4 = DATUM_POINT2D_P(ev2);
+  /* Meters per degree of longitude and latitude in the local plane */
+  double lat0 = (p1->y + p2->y + p3->y + p4->y) / 4.0 * M_PI / 180.0;
+  double ky = WGS84_RADIUS * M_PI / 180.0;
+  double kx = ky * cos(lat0);
+  /* The origin of the plane is the start point of the first segment */
+  double a1 = kx * lon_diff(p1->x, p2->x);
+  double a2 = ky * (p2->y - p1->y);
+  double a3 = kx * lon_diff(p3->x, p4->x);
+  double a4 = ky * (p4->y - p3->y);
+  double c3 = kx * lon_diff(p1->x, p3->x);
+  double c4 = ky * (p3->y - p1->y);
+  long double a = (a1 - a3) * (a1 - a3) + (a2 - a4) * (a2 - a4);
+  long double b = 2 * (a1 - a3) * (- c3) + 2 * (a2 - a4) * (- c4);
+  long double c = c3 * c3 + c4 * c4 - (dist * dist);
+  /* They are parallel, moving in the same direction at the same speed */
+  if (a == 0)
+  {
+    if (! func(sv1, sv2, Float8GetDatum(dist)))
       return 0;
-    /* Compute the intersection of the two intervals */
-    long double t7 = Max(0.0, t5);
-    long double t8 = Min(1.0, t6);
-    if (fabsl(t7 - t8) < MEOS_EPSILON)
-    {
-      *t1 = *t2 = lower + (TimestampTz) (t7 * duration);
-      return 1;
-    }
-    else
-    {
-      *t1 = lower + (TimestampTz) (t7 * duration);
-      *t2 = lower + (TimestampTz) (t8 * duration);
-      return 2;
-    }
+    *t1 = lower;
+    *t2 = upper;
+    return 2;
   }
+  return tdwithin_quadratic(a, b, c, lower, upper, t1, t2);
 }
 
 /**
@@ -863,6 +1090,186 @@ tdwithin_add_solutions(int solutions, TimestampTz lower, TimestampTz upper,
   return nseqs;
 }
 
+/**
+ * @brief Return a temporal Boolean sequence from an array of instants, which
+ * are freed while the array is kept for constructing the next sequence
+ */
+static TSequence *
+tboolseq_make_free_insts(TInstant **instants, int count, bool lower_inc,
+  bool upper_inc)
+{
+  TSequence *result = tsequence_make((const TInstant **) instants, count,
+    lower_inc, upper_inc, STEP, NORMALIZE_NO);
+  for (int i = 0; i < count; i++)
+    pfree(instants[i]);
+  return result;
+}
+
+/**
+ * @brief Return the temporal Boolean sequences that are true during the
+ * periods at which the arguments of a dwithin relationship are within the
+ * distance (iterator function)
+ * @param[in] seq Temporal point giving the time frame of the result
+ * @param[in] lowers,uppers Bounds of the periods, which are sorted, disjoint,
+ * and contained in the time frame
+ * @param[in] nspans Number of periods
+ * @param[out] result Array on which the pointers of the newly constructed
+ * sequences are stored
+ * @result Number of elements in the resulting array
+ * @pre The temporal point has at least two instants
+ */
+static int
+tdwithin_periods_tboolseq(const TSequence *seq, const TimestampTz *lowers,
+  const TimestampTz *uppers, int nspans, TSequence **result)
+{
+  /* Bounds of the periods and of the sequence, with the value at each bound
+   * and the value between a bound and the next one */
+  int maxpts = nspans * 2 + 2, npts = 0;
+  TimestampTz *pts = palloc(sizeof(TimestampTz) * maxpts);
+  pts[npts++] = seq->period.lower;
+  for (int i = 0; i < nspans; i++)
+  {
+    if (lowers[i] > pts[npts - 1])
+      pts[npts++] = lowers[i];
+    if (uppers[i] > pts[npts - 1])
+      pts[npts++] = uppers[i];
+  }
+  if (seq->period.upper > pts[npts - 1])
+    pts[npts++] = seq->period.upper;
+  bool *atpt = palloc(sizeof(bool) * npts * 2);
+  bool *after = atpt + npts;
+  for (int i = 0, s = 0; i < npts; i++)
+  {
+    while (s < nspans && uppers[s] < pts[i])
+      s++;
+    atpt[i] = (s < nspans && lowers[s] <= pts[i]);
+    after[i] = i < npts - 1 && atpt[i] && pts[i + 1] <= uppers[s];
+  }
+
+  /* Construct the sequences of the result, a sequence is split at a bound
+   * when the value at the bound is different from the one after it */
+  TInstant **instants = palloc(sizeof(TInstant *) * npts);
+  int ninsts = 0, nseqs = 0;
+  bool lower_inc = seq->period.lower_inc;
+  if (lower_inc && atpt[0] != after[0])
+  {
+    instants[0] = tinstant_make(BoolGetDatum(atpt[0]), T_TBOOL, pts[0]);
+    result[nseqs++] = tboolseq_make_free_insts(instants, 1, true, true);
+    lower_inc = false;
+  }
+  instants[ninsts++] = tinstant_make(BoolGetDatum(after[0]), T_TBOOL, pts[0]);
+  for (int i = 1; i < npts - 1; i++)
+  {
+    if (atpt[i] == after[i])
+    {
+      if (after[i] != after[i - 1])
+        instants[ninsts++] = tinstant_make(BoolGetDatum(after[i]), T_TBOOL,
+          pts[i]);
+      continue;
+    }
+    instants[ninsts++] = tinstant_make(BoolGetDatum(atpt[i]), T_TBOOL, pts[i]);
+    result[nseqs++] = tboolseq_make_free_insts(instants, ninsts, lower_inc,
+      true);
+    ninsts = 0;
+    lower_inc = false;
+    instants[ninsts++] = tinstant_make(BoolGetDatum(after[i]), T_TBOOL,
+      pts[i]);
+  }
+  bool upper_inc = seq->period.upper_inc;
+  instants[ninsts++] = tinstant_make(BoolGetDatum(upper_inc ?
+    atpt[npts - 1] : after[npts - 2]), T_TBOOL, pts[npts - 1]);
+  result[nseqs++] = tboolseq_make_free_insts(instants, ninsts, lower_inc,
+    upper_inc);
+  pfree(instants); pfree(pts); pfree(atpt);
+  return nseqs;
+}
+
+/**
+ * @brief Return the timestamps at which two temporal geometry points with
+ * linear interpolation are within a distance (iterator function)
+ * @details The coefficients of the quadratic equations of the squared
+ * distance of all the segments are computed in a single loop over the
+ * coordinates of the instants, without calling the distance function for
+ * each segment. The temporal Boolean is then constructed from the periods
+ * at which the points are within the distance, whose bounds are the only
+ * instants of the result
+ * @param[in] seq1,seq2 Temporal points
+ * @param[in] dist Distance
+ * @param[out] result Array on which the pointers of the newly constructed
+ * sequences are stored
+ * @result Number of elements in the resulting array
+ * @pre The temporal points are synchronized, have linear interpolation, and
+ * have at least two instants
+ */
+static int
+tdwithin_tpointseq_tpointseq_linear_iter(const TSequence *seq1,
+  const TSequence *seq2, double dist, TSequence **result)
+{
+  int count = seq1->count, nsegs = count - 1;
+  bool hasz = MEOS_FLAGS_GET_Z(seq1->flags) && MEOS_FLAGS_GET_Z(seq2->flags);
+  /* Coordinates of the difference of the two points at each instant */
+  double *dx = palloc(sizeof(double) * count * 3);
+  double *dy = dx + count, *dz = dy + count;
+  for (int i = 0; i < count; i++)
+  {
+    const POINT3DZ *p1 = DATUM_POINT3DZ_P(tinstant_val(TSEQUENCE_INST_N(seq1,
+      i)));
+    const POINT3DZ *p2 = DATUM_POINT3DZ_P(tinstant_val(TSEQUENCE_INST_N(seq2,
+      i)));
+    dx[i] = p1->x - p2->x;
+    dy[i] = p1->y - p2->y;
+    dz[i] = hasz ? p1->z - p2->z : 0.0;
+  }
+
+  /* Coefficients of the quadratic equation of each segment */
+  double *a = palloc(sizeof(double) * nsegs * 3);
+  double *b = a + nsegs, *c = b + nsegs;
+  for (int i = 0; i < nsegs; i++)
+  {
+    double ax = dx[i + 1] - dx[i], ay = dy[i + 1] - dy[i],
+      az = dz[i + 1] - dz[i];
+    a[i] = ax * ax + ay * ay + az * az;
+    b[i] = 2 * ax * dx[i] + 2 * ay * dy[i] + 2 * az * dz[i];
+    c[i] = dx[i] * dx[i] + dy[i] * dy[i] + dz[i] * dz[i];
+  }
+
+  /* Periods at which the points are within the distance, consecutive periods
+   * touching at an instant are merged */
+  TimestampTz *lowers = palloc(sizeof(TimestampTz) * nsegs * 2);
+  TimestampTz *uppers = lowers + nsegs;
+  int nspans = 0;
+  for (int i = 0; i < nsegs; i++)
+  {
+    TimestampTz lower = TSEQUENCE_INST_N(seq1, i)->t;
+    TimestampTz upper = TSEQUENCE_INST_N(seq1, i + 1)->t;
+    TimestampTz t1, t2;
+    int solutions;
+    /* They are parallel, moving in the same direction at the same speed */
+    if (a[i] == 0)
+    {
+      solutions = (sqrt(c[i]) <= dist) ? 2 : 0;
+      t1 = lower;
+      t2 = upper;
+    }
+    else
+      solutions = tdwithin_quadratic(a[i], b[i], c[i] - (dist * dist), lower,
+        upper, &t1, &t2);
+    if (solutions == 0)
+      continue;
+    if (nspans > 0 && t1 <= uppers[nspans - 1])
+      uppers[nspans - 1] = Max(t2, uppers[nspans - 1]);
+    else
+    {
+      lowers[nspans] = t1;
+      uppers[nspans++] = t2;
+    }
+  }
+  pfree(dx); pfree(a);
+  int nseqs = tdwithin_periods_tboolseq(seq1, lowers, uppers, nspans, result);
+  pfree(lowers);
+  return nseqs;
+}
+
 /**
  * @brief Return the timestamps at which the segments of two temporal points are
  * within a distance (iterator function)
@@ -891,7 +1298,12 @@ tdwithin_tpointseq_tpointseq_iter(const TSequence *seq1, const TSequence *seq2,
   int nseqs = 0;
   bool linear1 = MEOS_FLAGS_LINEAR_INTERP(seq1->flags);
   bool linear2 = MEOS_FLAGS_LINEAR_INTERP(seq2->flags);
+  if (linear1 && linear2 && ! MEOS_FLAGS_GET_GEODETIC(seq1->flags))
+    return tdwithin_tpointseq_tpointseq_linear_iter(seq1, seq2,
+      DatumGetFloat8(dist), result);
   bool hasz = MEOS_FLAGS_GET_Z(seq1->flags);
+  bool fastgeog = MEOS_FLAGS_GET_GEODETIC(seq1->flags) &&
+    meos_get_fast_geodetic();
   Datum sv1 = tinstant_val(start1);
   Datum sv2 = tinstant_val(start2);
   TimestampTz lower = start1->t;
@@ -931,8 +1343,11 @@ tdwithin_tpointseq_tpointseq_iter(const TSequence *seq1, const TSequence *seq2,
       TimestampTz t1, t2;
       Datum sev1 = linear1 ? ev1 : sv1;
       Datum sev2 = linear2 ? ev2 : sv2;
-      int solutions = tdwithin_tpointsegm_tpointsegm(sv1, sev1, sv2, sev2,
-        lower, upper, DatumGetFloat8(dist), hasz, func, &t1, &t2);
+      int solutions = fastgeog ?
+        tdwithin_tgeogpointsegm_fast(sv1, sev1, sv2, sev2, lower, upper,
+          DatumGetFloat8(dist), func, &t1, &t2) :
+        tdwithin_tpointsegm_tpointsegm(sv1, sev1, sv2, sev2, lower, upper,
+          DatumGetFloat8(dist), hasz, func, &t1, &t2);
       bool upper_inc1 = linear1 && linear2 && upper_inc;
       nseqs += tdwithin_add_solutions(solutions, lower, upper, lower_inc,
         upper_inc, upper_inc1, t1, t2, instants, &result[nseqs]);
@@ -1127,6 +1542,119 @@ tdwithin_tpointseqset_point(const TSequenceSet *ss, Datum point, Datum dist,
   return tsequenceset_make_free(sequences, nseqs, NORMALIZE);
 }
 
+/**
+ * @brief Return the timestamps at which a temporal point with linear
+ * interpolation and the geometry of an edge index are within a distance
+ * @details The intervals of each segment within the distance are obtained
+ * from the edges of the geometry near the segment, so that neither the
+ * geometry nor the segment are given to PostGIS
+ * @param[in] seq Temporal point
+ * @param[in] index Edge index
+ * @param[in] dist Distance
+ * @param[out] count Number of elements in the resulting array
+ * @pre The temporal point has at least two instants
+ */
+static TSequence **
+tdwithin_tpointseq_edge_index(const TSequence *seq, const EdgeIndex *index,
+  double dist, int *count)
+{
+  int maxedges = 64, maxfracs = 64, maxspans = 64, nspans = 0;
+  int *edges = palloc(sizeof(int) * maxedges);
+  double *fracs = palloc(sizeof(double) * maxfracs);
+  TimestampTz *lowers = palloc(sizeof(TimestampTz) * maxspans);
+  TimestampTz *uppers = palloc(sizeof(TimestampTz) * maxspans);
+  for (int i = 0; i < seq->count - 1; i++)
+  {
+    const TInstant *inst1 = TSEQUENCE_INST_N(seq, i);
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i + 1);
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val(inst1));
+    const POINT2D *q = DATUM_POINT2D_P(tinstant_val(inst2));
+    int n = edge_index_segment_dwithin(index, p, q, dist, &edges, &maxedges,
+      &fracs, &maxfracs);
+    double duration = (double) (inst2->t - inst1->t);
+    for (int j = 0; j < n; j++)
+    {
+      TimestampTz t1 = inst1->t + (TimestampTz) (duration * fracs[2 * j]);
+      TimestampTz t2 = inst1->t + (TimestampTz) (duration * fracs[2 * j + 1]);
+      /* Consecutive periods touching at an instant are merged */
+      if (nspans > 0 && t1 <= uppers[nspans - 1])
+      {
+        uppers[nspans - 1] = Max(t2, uppers[nspans - 1]);
+        continue;
+      }
+      if (nspans == maxspans)
+      {
+        maxspans *= 2;
+        lowers = repalloc(lowers, sizeof(TimestampTz) * maxspans);
+        uppers = repalloc(uppers, sizeof(TimestampTz) * maxspans);
+      }
+      lowers[nspans] = t1;
+      uppers[nspans++] = t2;
+    }
+  }
+  pfree(edges); pfree(fracs);
+  TSequence **result = palloc(sizeof(TSequence *) * (nspans * 2 + 2));
+  *count = tdwithin_periods_tboolseq(seq, lowers, uppers, nspans, result);
+  pfree(lowers); pfree(uppers);
+  return result;
+}
+
+/**
+ * @brief Return the timestamps at which a temporal point with linear
+ * interpolation and the geometry of an edge index are within a distance
+ * @param[in] temp Temporal point
+ * @param[in] index Edge index
+ * @param[in] dist Distance
+ */
+static TSequenceSet *
+tdwithin_tpoint_edge_index(const Temporal *temp, const EdgeIndex *index,
+  double dist)
+{
+  int nseqs = 0;
+  int count = (temp->subtype == TSEQUENCE) ? 1 : ((TSequenceSet *) temp)->count;
+  TSequence ***sequences = palloc(sizeof(TSequence **) * count);
+  int *countseqs = palloc0(sizeof(int) * count);
+  for (int i = 0; i < count; i++)
+  {
+    const TSequence *seq = (temp->subtype == TSEQUENCE) ?
+      (TSequence *) temp : TSEQUENCESET_SEQ_N((TSequenceSet *) temp, i);
+    if (seq->count == 1)
+    {
+      /* The segment of an instantaneous sequence is reduced to a point */
+      const TInstant *inst = TSEQUENCE_INST_N(seq, 0);
+      const POINT2D *p = DATUM_POINT2D_P(tinstant_val(inst));
+      double fraction;
+      bool value = edge_index_segment_distance(index, p, p, dist,
+        &fraction) >= 0;
+      if (! value && index->areal)
+      {
+        int maxedges = 64;
+        int *edges = palloc(sizeof(int) * maxedges);
+        value = edge_index_locate_point(index, p, &edges, &maxedges) ==
+          EDGEINDEX_INTERIOR;
+        pfree(edges);
+      }
+      sequences[i] = palloc(sizeof(TSequence *));
+      sequences[i][0] = tinstant_to_tsequence_free(tinstant_make(
+        BoolGetDatum(value), T_TBOOL, inst->t), STEP);
+      countseqs[i] = 1;
+    }
+    else
+      sequences[i] = tdwithin_tpointseq_edge_index(seq, index, dist,
+        &countseqs[i]);
+    nseqs += countseqs[i];
+  }
+  TSequence **allseqs = palloc(sizeof(TSequence *) * nseqs);
+  for (int i = 0, k = 0; i < count; i++)
+  {
+    for (int j = 0; j < countseqs[i]; j++)
+      allseqs[k++] = sequences[i][j];
+    pfree(sequences[i]);
+  }
+  pfree(sequences); pfree(countseqs);
+  return tsequenceset_make_free(allseqs, nseqs, NORMALIZE);
+}
+
 /*****************************************************************************
  * Temporal contains
  *****************************************************************************/
@@ -1233,6 +1761,9 @@ ttouches_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, bool restr,
  * @param[in] dist Distance
  * @param[in] restr True when the result is restricted to a value
  * @param[in] atvalue Value to restrict
+ * @note The geometry must be a point unless both arguments are 2D and the
+ * temporal point is not geodetic, in which case lines, polygons, and their
+ * multi counterparts are also accepted
  * @csqlfn #Tdwithin_tpoint_geo()
  */
 Temporal *
@@ -1241,9 +1772,13 @@ tdwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist,
 {
   /* Ensure validity of the arguments */
   if (! ensure_valid_tpoint_geo(temp, gs) || gserialized_is_empty(gs) ||
-      ! ensure_point_type(gs) ||
       ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
     return NULL;
+  /* Lines and polygons are accepted when an index of their edges is used */
+  const EdgeIndex *index = (gserialized_get_type(gs) == POINTTYPE) ? NULL :
+    tpoint_geo_dist_edge_index(temp, gs, 0);
+  if (! index && ! ensure_point_type(gs))
+    return NULL;
 
   datum_func3 func =
     /* 3D only if both arguments are 3D */
@@ -1262,7 +1797,9 @@ tdwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist,
     }
     case TSEQUENCE:
     {
-      if (MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+      if (index && MEOS_FLAGS_LINEAR_INTERP(temp->flags))
+        result = (Temporal *) tdwithin_tpoint_edge_index(temp, index, dist);
+      else if (MEOS_FLAGS_LINEAR_INTERP(temp->flags))
         result = (Temporal *) tdwithin_tpointseq_point((TSequence *) temp,
             PointerGetDatum(gs), Float8GetDatum(dist), func);
       else
@@ -1282,8 +1819,10 @@ tdwithin_tpoint_geo(const Temporal *temp, const GSERIALIZED *gs, double dist,
       break;
     }
     default: /* TSEQUENCESET */
-      result = (Temporal *) tdwithin_tpointseqset_point((TSequenceSet *) temp,
-        PointerGetDatum(gs), Float8GetDatum(dist), func);
+      result = (index && MEOS_FLAGS_LINEAR_INTERP(temp->flags)) ?
+        (Temporal *) tdwithin_tpoint_edge_index(temp, index, dist) :
+        (Temporal *) tdwithin_tpointseqset_point((TSequenceSet *) temp,
+          PointerGetDatum(gs), Float8GetDatum(dist), func);
   }
   /* Restrict the result to the Boolean value in the fourth argument if any */
   if (result != NULL && restr)
@@ -1409,4 +1948,206 @@ tdwithin_tpoint_tpoint(const Temporal *temp1, const Temporal *temp2,
   return result;
 }
 
+/*****************************************************************************
+ * Spatiotemporal join of two arrays of temporal points
+ *****************************************************************************/
+
+/**
+ * @brief Bounding box of an element of an array of temporal points
+ */
+typedef struct
+{
+  STBox box;   /**< Bounding box, possibly expanded by the distance */
+  int i;       /**< Position of the temporal point in the array */
+} TpointBoxIdx;
+
+/**
+ * @brief Pair of temporal points of two arrays that are within a distance
+ */
+typedef struct
+{
+  int i;         /**< Position of the first temporal point */
+  int j;         /**< Position of the second temporal point */
+  SpanSet *ss;   /**< Time at which the temporal points are within distance */
+} TpointPair;
+
+/**
+ * @brief Comparator function for bounding boxes of temporal points
+ */
+static int
+tpoint_boxidx_cmp(const void *a, const void *b)
+{
+  double xmin1 = ((const TpointBoxIdx *) a)->box.xmin;
+  double xmin2 = ((const TpointBoxIdx *) b)->box.xmin;
+  return (xmin1 < xmin2) ? -1 : ((xmin1 > xmin2) ? 1 : 0);
+}
+
+/**
+ * @brief Comparator function for pairs of temporal points
+ */
+static int
+tpoint_pair_cmp(const void *a, const void *b)
+{
+  const TpointPair *p1 = (const TpointPair *) a;
+  const TpointPair *p2 = (const TpointPair *) b;
+  if (p1->i != p2->i)
+    return (p1->i < p2->i) ? -1 : 1;
+  return (p1->j < p2->j) ? -1 : ((p1->j > p2->j) ? 1 : 0);
+}
+
+/**
+ * @brief Return the bounding boxes of an array of temporal points sorted on
+ * their minimum X value, possibly expanded by a distance
+ */
+static TpointBoxIdx *
+tpointarr_boxes(const Temporal **temparr, int count, double dist)
+{
+  TpointBoxIdx *result = palloc(sizeof(TpointBoxIdx) * count);
+  for (int i = 0; i < count; i++)
+  {
+    temporal_set_bbox(temparr[i], &result[i].box);
+    result[i].box.xmin -= dist;
+    result[i].box.ymin -= dist;
+    result[i].box.xmax += dist;
+    result[i].box.ymax += dist;
+    if (MEOS_FLAGS_GET_Z(result[i].box.flags))
+    {
+      result[i].box.zmin -= dist;
+      result[i].box.zmax += dist;
+    }
+    result[i].i = i;
+  }
+  qsort(result, count, sizeof(TpointBoxIdx), &tpoint_boxidx_cmp);
+  return result;
+}
+
+/**
+ * @brief Add a pair of temporal points to the result if they are within a
+ * distance at some instant
+ */
+static void
+tpoint_pair_add(const Temporal **temparr1, const Temporal **temparr2,
+  int i, int j, double dist, bool self, TpointPair **pairs, int *npairs,
+  int *maxpairs)
+{
+  /* In a self join every pair is found twice since the overlap of the boxes
+   * is symmetric, only the one with i < j is considered */
+  if (self && i >= j)
+    return;
+  Temporal *tdwithin = tdwithin_tpoint_tpoint(temparr1[i], temparr2[j],
+    dist, true, true);
+  if (! tdwithin)
+    return;
+  if (*npairs == *maxpairs)
+  {
+    *maxpairs *= 2;
+    *pairs = repalloc(*pairs, sizeof(TpointPair) * *maxpairs);
+  }
+  (*pairs)[*npairs].i = i;
+  (*pairs)[*npairs].j = j;
+  (*pairs)[(*npairs)++].ss = temporal_time(tdwithin);
+  pfree(tdwithin);
+}
+
+/**
+ * @ingroup meos_temporal_spatial_rel_temp
+ * @brief Return the pairs of temporal points of two arrays that are within a
+ * distance at some instant, together with the time at which they are
+ * @details The bounding boxes of the temporal points of the first array are
+ * expanded by the distance, both arrays of boxes are sorted on their minimum
+ * X value, and the function @p tdwithin is only computed for the pairs
+ * of boxes that overlap, which are found by sweeping the sorted boxes
+ * @param[in] temparr1,temparr2 Arrays of temporal points, if the second
+ * array is NULL, the pairs of temporal points of the first array are
+ * computed, each pair being only returned once
+ * @param[in] count1,count2 Number of elements in the arrays
+ * @param[in] dist Distance
+ * @param[out] idx1,idx2 Positions in the arrays of the temporal points of
+ * each pair
+ * @param[out] spansets Time at which the temporal points of each pair are
+ * within the distance
+ * @return Number of pairs, the pairs are sorted on their positions.
+ * On error return -1
+ */
+int
+tdwithin_tpointarr_tpointarr(const Temporal **temparr1, int count1,
+  const Temporal **temparr2, int count2, double dist, int **idx1, int **idx2,
+  SpanSet ***spansets)
+{
+  bool self = (temparr2 == NULL);
+  if (self)
+  {
+    temparr2 = temparr1;
+    count2 = count1;
+  }
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temparr1) || ! ensure_not_null((void *) idx1) ||
+      ! ensure_not_null((void *) idx2) || ! ensure_not_null((void *) spansets) ||
+      ! ensure_positive(count1) || ! ensure_positive(count2) ||
+      ! ensure_not_negative_datum(Float8GetDatum(dist), T_FLOAT8))
+    return -1;
+  for (int i = 0; i < count1 + count2; i++)
+  {
+    const Temporal *temp = (i < count1) ? temparr1[i] : temparr2[i - count1];
+    if (! ensure_not_null((void *) temp) ||
+        ! ensure_tgeo_type(temp->temptype) ||
+        ! ensure_not_geodetic(temp->flags) ||
+        ! ensure_same_srid(tpoint_srid(temparr1[0]), tpoint_srid(temp)) ||
+        ! ensure_same_dimensionality(temparr1[0]->flags, temp->flags))
+      return -1;
+  }
+
+  /* Only the boxes of the first array are expanded by the distance */
+  TpointBoxIdx *boxes1 = tpointarr_boxes(temparr1, count1, dist);
+  TpointBoxIdx *boxes2 = tpointarr_boxes(temparr2, count2, 0.0);
+  int npairs = 0, maxpairs = 64;
+  TpointPair *pairs = palloc(sizeof(TpointPair) * maxpairs);
+  /* Sweep the boxes sorted on their minimum X value, each pair of boxes
+   * overlapping on the X dimension is visited once */
+  int i = 0, j = 0;
+  while (i < count1 && j < count2)
+  {
+    if (boxes1[i].box.xmin <= boxes2[j].box.xmin)
+    {
+      for (int k = j; k < count2 && boxes2[k].box.xmin <= boxes1[i].box.xmax;
+          k++)
+      {
+        if (overlaps_stbox_stbox(&boxes1[i].box, &boxes2[k].box))
+          tpoint_pair_add(temparr1, temparr2, boxes1[i].i, boxes2[k].i, dist,
+            self, &pairs, &npairs, &maxpairs);
+      }
+      i++;
+    }
+    else
+    {
+      for (int k = i; k < count1 && boxes1[k].box.xmin <= boxes2[j].box.xmax;
+          k++)
+      {
+        if (overlaps_stbox_stbox(&boxes1[k].box, &boxes2[j].box))
+          tpoint_pair_add(temparr1, temparr2, boxes1[k].i, boxes2[j].i, dist,
+            self, &pairs, &npairs, &maxpairs);
+      }
+      j++;
+    }
+  }
+  pfree(boxes1); pfree(boxes2);
+
+  /* The pairs are returned in the order of their positions */
+  qsort(pairs, npairs, sizeof(TpointPair), &tpoint_pair_cmp);
+  if (npairs > 0)
+  {
+    *idx1 = palloc(sizeof(int) * npairs);
+    *idx2 = palloc(sizeof(int) * npairs);
+    *spansets = palloc(sizeof(SpanSet *) * npairs);
+    for (int k = 0; k < npairs; k++)
+    {
+      (*idx1)[k] = pairs[k].i;
+      (*idx2)[k] = pairs[k].j;
+      (*spansets)[k] = pairs[k].ss;
+    }
+  }
+  pfree(pairs);
+  return npairs;
+}
+
 /*****************************************************************************/
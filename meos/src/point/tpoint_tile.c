@@ -34,6 +34,8 @@
 
 /* C */
 #include <assert.h>
+#include <math.h>
+#include <stdlib.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include <float.h>
@@ -43,219 +45,186 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/pg_types.h"
 #include "general/temporal.h"
 #include "general/temporal_tile.h"
+#include "general/type_util.h"
 #include "point/stbox.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tile.h"
 
 /*****************************************************************************
- * Bit Matrix implementation based on
- * https://www.pvladov.com/2012/05/bit-matrix-in-c-sharp.html
+ * Sparse set of tiles
+ * The tiles traversed by a temporal point are collected as their linear
+ * identifiers in the grid and then sorted, so that the memory needed is
+ * proportional to the number of tiles traversed rather than to the extent of
+ * the grid, and only these tiles are visited when splitting the point.
  *****************************************************************************/
 
 /**
- * @brief Create a bit matrix
- */
-BitMatrix *
-bitmatrix_make(int *count, int ndims)
-{
-  /* Calculate the needed number of bits and bytes */
-  int i, bitCount = 1;
-  for (i = 0; i < ndims; i++)
-    bitCount *= count[i];
-  int byteCount = bitCount >> 3;
-  if (bitCount % 8 != 0)
-    byteCount++;
-  /* Allocate the needed number of bytes taking into account that there is
-   * already one byte allocated in the struct */
-  size_t size = sizeof(BitMatrix) + byteCount - 1;
-  /* palloc0 to set all bits to 0 */
-  BitMatrix *result = palloc0(size);
-  /* Fill the structure */
+ * @brief Create an empty set of tiles for a grid
+ * @param[in] count Number of tiles in each dimension of the grid
+ * @param[in] ndims Number of dimensions of the grid
+ * @param[in] segms True when the segments traversing the tiles are kept
+ */
+TileSet *
+tileset_make(const int *count, int ndims, bool segms)
+{
+  TileSet *result = palloc0(sizeof(TileSet));
   result->ndims = ndims;
-  for (i = 0; i < ndims; i++)
+  for (int i = 0; i < ndims; i++)
     result->count[i] = count[i];
+  result->maxtiles = 64;
+  result->tiles = palloc(sizeof(int64) * result->maxtiles);
+  result->keepsegms = segms;
+  if (segms)
+  {
+    result->maxsegms = 64;
+    result->segms = palloc(sizeof(TileSegm) * result->maxsegms);
+  }
   return result;
 }
 
 /**
- * @brief Get the value of the bit in the bit matrix
+ * @brief Empty a set of tiles for a grid, keeping its allocated memory so
+ * that it can be reused across temporal points
+ * @param[in] ts Set of tiles
+ * @param[in] count Number of tiles in each dimension of the grid
+ * @param[in] ndims Number of dimensions of the grid
+ * @param[in] segms True when the segments traversing the tiles are kept
+ * @pre The set was created keeping the segments if @p segms is true
  */
-static bool
-bitmatrix_get(const BitMatrix *bm, int *coords)
+void
+tileset_reset(TileSet *ts, const int *count, int ndims, bool segms)
 {
-  int i, j;
-  for (i = 0; i < bm->ndims; i++)
-    assert(coords[i] <= bm->count[i]);
-  int pos = 0;
-  for (i = 0; i < bm->ndims; i++)
-  {
-    int offset = coords[i];
-    for (j = i + 1; j < bm->ndims; j++)
-    {
-      offset *= bm->count[j];
-    }
-    pos += offset;
-  }
-  int index = pos % 8;
-  pos >>= 3;
-  return (bm->byte[pos] & (((uint8_t)1) << index)) != 0;
+  assert(! segms || ts->segms);
+  ts->ndims = ndims;
+  for (int i = 0; i < ndims; i++)
+    ts->count[i] = count[i];
+  ts->ntiles = ts->nsegms = 0;
+  ts->seq = ts->inst = 0;
+  ts->keepsegms = segms;
+  return;
 }
 
 /**
- * @brief Set the value of the bit in the bit matrix
+ * @brief Free a set of tiles
  */
-static void
-bitmatrix_set_cell(BitMatrix *bm, int *coords, bool value)
-{
-  int i, j, pos = 0;
-  for (i = 0; i < bm->ndims; i++)
-    assert(coords[i] <= bm->count[i]);
-  for (i = 0; i < bm->ndims - 1; i++)
-  {
-    int offset = coords[i];
-    for (j = i + 1; j < bm->ndims; j++)
-      offset *= bm->count[j];
-    pos += offset;
-  }
-  pos += coords[bm->ndims - 1];
-  int index = pos % 8;
-  pos >>= 3;
-  bm->byte[pos] &= (unsigned char)(~(1 << index));
-  if (value)
-    bm->byte[pos] |= (uint8_t)(1 << index);
+void
+tileset_free(TileSet *ts)
+{
+  pfree(ts->tiles);
+  if (ts->segms)
+    pfree(ts->segms);
+  pfree(ts);
   return;
 }
 
-#ifdef DEBUG_BUILD
 /**
- * @brief Print a 2D bit matrix
- * @note This function is only used for debugging purposes
+ * @brief Add a tile given by its coordinates to a set of tiles
+ * @details When the segments traversing the tiles are kept, the tile is also
+ * associated with the segment currently traversed, given by the @p seq and
+ * @p inst fields of the set.
+ * @note Tiles outside of the grid, which are never visited, are not added.
+ * Since consecutive tiles traversed by a point are often equal, a tile equal
+ * to the last one added is not added again.
  */
-void
-bitmatrix_print2D(const BitMatrix *bm, int *coords)
+static void
+tileset_add(TileSet *ts, const int *coords)
 {
-  int i, j;
-  int dim = bm->ndims - 2;
-  /* Print the 2D matrix */
-  if (bm->count[dim + 1] / 10 > 0)
+  int64 id = 0;
+  for (int i = ts->ndims - 1; i >= 0; i--)
   {
-    printf("\n      ");
-    for (j = 0; j < bm->count[dim + 1] / 10; j++)
-    {
-      printf("         %1d", j + 1);
-    }
-  }
-  printf("\n     ");
-  for (j = 0; j < bm->count[dim + 1]; j++)
-  {
-    printf("%1d", j % 10);
+    if (coords[i] < 0 || coords[i] >= ts->count[i])
+      return;
+    id = id * ts->count[i] + coords[i];
   }
-  printf("\n-----");
-  for (j = 0; j < bm->count[dim + 1]; j++)
-    printf("-");
-  printf("\n");
-  for (i = 0; i < bm->count[dim + 0]; i++)
+  if (ts->keepsegms)
   {
-    if (i / 10 > 0 && i % 10 == 0)
-      printf("%1d", i / 10);
-    else
-      printf(" ");
-    printf("%1d | ", i % 10);
-    coords[dim + 0] = i;
-    for (j = 0; j < bm->count[dim + 1]; j++)
+    const TileSegm *last = (ts->nsegms > 0) ?
+      &ts->segms[ts->nsegms - 1] : NULL;
+    if (! last || last->tile != id || last->seq != ts->seq ||
+        last->inst != ts->inst)
     {
-      coords[dim + 1] = j;
-      if (bitmatrix_get(bm, coords))
-        printf("1");
-      else
-        printf(".");
+      if (ts->nsegms == ts->maxsegms)
+      {
+        ts->maxsegms *= 2;
+        ts->segms = repalloc(ts->segms, sizeof(TileSegm) * ts->maxsegms);
+      }
+      ts->segms[ts->nsegms].tile = id;
+      ts->segms[ts->nsegms].seq = ts->seq;
+      ts->segms[ts->nsegms++].inst = ts->inst;
     }
-    printf("\n");
   }
-  printf("-----");
-  for (j = 0; j < bm->count[dim + 1]; j++)
-    printf("-");
-  if (bm->count[dim + 1] / 10 > 0)
+  if (ts->ntiles > 0 && ts->tiles[ts->ntiles - 1] == id)
+    return;
+  if (ts->ntiles == ts->maxtiles)
   {
-    printf("\n      ");
-    for (j = 0; j < bm->count[dim + 1] / 10; j++)
-    {
-      printf("         %1d", j + 1);
-    }
+    ts->maxtiles *= 2;
+    ts->tiles = repalloc(ts->tiles, sizeof(int64) * ts->maxtiles);
   }
-  printf("\n     ");
-  for (j = 0; j < bm->count[dim + 1]; j++)
-    printf("%1d", j % 10);
-  printf("\n");
+  ts->tiles[ts->ntiles++] = id;
   return;
 }
 
 /**
- * @brief Print the bit matrix
- * @note This function is only used for debugging purposes
+ * @brief Comparator of tile identifiers
  */
-void
-bitmatrix_print(const BitMatrix *bm)
+static int
+tile_id_cmp(const int64 *l, const int64 *r)
 {
-  int i, j, k, l, coords[MAXDIMS];
-  memset(&coords, 0, sizeof(coords));
-  int totalcount = 1;
-  for (i = 0; i < bm->ndims; i++)
-    totalcount *= bm->count[i];
-  int count = 0;
-  for (i = 0; i < bm->count[0]; i++)
+  return (*l < *r) ? -1 : ((*l > *r) ? 1 : 0);
+}
+
+/**
+ * @brief Comparator of tile segments, which are ordered by tile and then by
+ * their position in the temporal point
+ */
+static int
+tile_segm_cmp(const TileSegm *l, const TileSegm *r)
+{
+  if (l->tile != r->tile)
+    return (l->tile < r->tile) ? -1 : 1;
+  if (l->seq != r->seq)
+    return (l->seq < r->seq) ? -1 : 1;
+  return (l->inst < r->inst) ? -1 : ((l->inst > r->inst) ? 1 : 0);
+}
+
+/**
+ * @brief Sort the tiles of a set and remove the duplicates
+ */
+static void
+tileset_sort(TileSet *ts)
+{
+  if (ts->ntiles == 0)
+    return;
+  qsort(ts->tiles, (size_t) ts->ntiles, sizeof(int64),
+    (qsort_comparator) &tile_id_cmp);
+  int count = 1;
+  for (int i = 1; i < ts->ntiles; i++)
+  {
+    if (ts->tiles[i] != ts->tiles[count - 1])
+      ts->tiles[count++] = ts->tiles[i];
+  }
+  ts->ntiles = count;
+  if (ts->keepsegms)
   {
-    coords[0] = i;
-    for (j = 0; j < bm->count[1]; j++)
+    qsort(ts->segms, (size_t) ts->nsegms, sizeof(TileSegm),
+      (qsort_comparator) &tile_segm_cmp);
+    count = 1;
+    for (int i = 1; i < ts->nsegms; i++)
     {
-      coords[1] = j;
-      if (bm->ndims >= 3)
-      {
-        for (k = 0; k < bm->count[2]; k++)
-        {
-          coords[2] = k;
-          if (bm->ndims >= 4)
-          {
-            for (l = 0; l < bm->count[3]; l++)
-            {
-              coords[3] = l;
-              if (bitmatrix_get(bm, coords))
-              {
-                printf("%d %d %d %d: %c\n", i, j, k, l, '1');
-                count++;
-              }
-            }
-          }
-          else
-          {
-            if (bitmatrix_get(bm, coords))
-            {
-              printf("%d %d %d: %c\n", i, j, k, '1');
-              count++;
-            }
-          }
-        }
-      }
-      else
-      {
-        if (bitmatrix_get(bm, coords))
-        {
-          printf("%d %d: %c\n", i, j, '1');
-          count++;
-        }
-      }
+      if (tile_segm_cmp(&ts->segms[i], &ts->segms[count - 1]) != 0)
+        ts->segms[count++] = ts->segms[i];
     }
+    ts->nsegms = count;
   }
-  printf("Total tiles: %d, Tiles set: %d\n", totalcount, count);
   return;
 }
-#endif /* DEBUG_BUILD */
 
 /*****************************************************************************
  * N-dimensional version of the fast voxel traversal algorithm
- * setting in the bit array all the tiles connecting the two given tiles.
+ * adding to a set all the tiles connecting the two given tiles.
  *
  * Amanatides, John, and Andrew Woo.
  * "A fast voxel traversal algorithm for ray tracing."
@@ -263,18 +232,17 @@ bitmatrix_print(const BitMatrix *bm)
  *****************************************************************************/
 
 /**
- * @brief Set in the bit matrix the bits of the tiles connecting with a line
- * two input tiles
+ * @brief Add to a set the tiles connecting with a line two input tiles
  * @param[in] coords1, coords2 Coordinates of the input tiles
  * @param[in] eps1, eps2 Relative position of the points in the input tiles
  * @param[in] ndims Number of dimensions of the grid. It is either 2 (for 2D),
  * 3 (for 3D or 2D+T) or 4 (3D+T)
- * @param[out] bm Bit matrix
+ * @param[out] ts Set of tiles
  * @result Number of tiles set
  */
 static int
-fastvoxel_bm(int *coords1, double *eps1, int *coords2, double *eps2,
-  int ndims, BitMatrix *bm)
+fastvoxel_tiles(int *coords1, double *eps1, int *coords2, double *eps2,
+  int ndims, TileSet *ts)
 {
   int i, k, coords[MAXDIMS], next[MAXDIMS], result = 0;
   double length, tMax[MAXDIMS], tDelta[MAXDIMS];
@@ -285,14 +253,14 @@ fastvoxel_bm(int *coords1, double *eps1, int *coords2, double *eps2,
   /* Shortcut function if the segment covers only 1 or 2 cells */
   if (k == 0)
   {
-    bitmatrix_set_cell(bm, coords1, true);
+    tileset_add(ts, coords1);
     result++;
     return result;
   }
   else if (k == 1)
   {
-    bitmatrix_set_cell(bm, coords1, true);
-    bitmatrix_set_cell(bm, coords2, true);
+    tileset_add(ts, coords1);
+    tileset_add(ts, coords2);
     result += 2;
     return result;
   }
@@ -327,7 +295,7 @@ fastvoxel_bm(int *coords1, double *eps1, int *coords2, double *eps2,
   }
   /* Set the starting bitmap cell */
   memcpy(coords, coords1, sizeof(int) * ndims);
-  bitmatrix_set_cell(bm, coords, true);
+  tileset_add(ts, coords);
   result++;
   for (i = 0; i < k; ++i)
   {
@@ -342,7 +310,7 @@ fastvoxel_bm(int *coords1, double *eps1, int *coords2, double *eps2,
     tMax[idx] += tDelta[idx];
     coords[idx] += next[idx];
     /* Set the bitmap cell */
-    bitmatrix_set_cell(bm, coords, true);
+    tileset_add(ts, coords);
     result++;
   }
   assert(memcmp(coords, coords2, sizeof(int) * ndims) == 0);
@@ -478,10 +446,53 @@ stbox_tile_state_make(const Temporal *temp, const STBox *box, double xsize,
     else
       MEOS_FLAGS_SET_T(state->box.flags, false);
   }
+  /* Absolute coordinates of the first tile of the grid */
+  state->base[0] = llround((state->box.xmin - sorigin.x) / xsize);
+  state->base[1] = llround((state->box.ymin - sorigin.y) / ysize);
+  if (state->hasz)
+    state->base[2] = llround((state->box.zmin - sorigin.z) / zsize);
+  if (state->hast)
+    state->base[3] = (DatumGetTimestampTz(state->box.period.lower) -
+      torigin) / tunits;
   state->temp = temp;
   return state;
 }
 
+/**
+ * @brief Set the current tile of a state to the tile at the current position
+ * of its set of tiles
+ */
+static void
+stbox_tile_state_set_tile(STboxGridState *state)
+{
+  const TileSet *ts = state->tiles;
+  int64 id = ts->tiles[state->tilepos];
+  int coords[MAXDIMS];
+  for (int i = 0; i < ts->ndims; i++)
+  {
+    coords[i] = (int) (id % ts->count[i]);
+    id /= ts->count[i];
+  }
+  /* The coordinates of the set do not have the Z dimension for 2D+T grids */
+  int k = 0;
+  state->coords[0] = coords[k++];
+  state->x = state->box.xmin + state->coords[0] * state->xsize;
+  state->coords[1] = coords[k++];
+  state->y = state->box.ymin + state->coords[1] * state->ysize;
+  if (state->hasz)
+  {
+    state->coords[2] = coords[k++];
+    state->z = state->box.zmin + state->coords[2] * state->zsize;
+  }
+  if (state->hast)
+  {
+    state->coords[3] = coords[k++];
+    state->t = DatumGetTimestampTz(state->box.period.lower) +
+      state->coords[3] * state->tunits;
+  }
+  return;
+}
+
 /**
  * @brief Increment the current state to the next tile of the multidimensional
  * grid
@@ -492,6 +503,16 @@ stbox_tile_state_next(STboxGridState *state)
 {
   if (! state || state->done)
     return;
+  /* If there is a set of tiles, move to the next tile of the set */
+  if (state->tiles != NULL)
+  {
+    state->i++;
+    if (++state->tilepos >= state->tiles->ntiles)
+      state->done = true;
+    else
+      stbox_tile_state_set_tile(state);
+    return;
+  }
   /* Move to the next cell. We need to take into account whether
    * hasz and/or hast and thus there are 4 possible cases */
   state->i++;
@@ -572,24 +593,26 @@ stbox_tile_state_get(STboxGridState *state, STBox *box)
 {
   if (! state || state->done)
     return false;
-  /* Get the box of the current tile.
-   * If there is a bit matrix for speeding up the computation, the while loop
-     finds the next tile that is set in the matrix, if any */
-  if (state->bm != NULL)
-  {
-    while (! bitmatrix_get(state->bm, state->coords))
-    {
-      stbox_tile_state_next(state);
-      if (state->done)
-        return false;
-    }
-  }
+  /* Get the box of the current tile */
   stbox_tile_set(state->x, state->y, state->z, state->t, state->xsize,
     state->ysize, state->zsize, state->tunits, state->hasz, state->hast,
     state->box.srid, box);
   return true;
 }
 
+/**
+ * @brief Free a grid state together with its set of tiles, unless the set
+ * belongs to a grid
+ */
+void
+stbox_tile_state_free(STboxGridState *state)
+{
+  if (state->tiles && state->owntiles)
+    tileset_free(state->tiles);
+  pfree(state);
+  return;
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_analytics_tile
@@ -841,17 +864,17 @@ tpointinst_get_coords_eps(const TInstant *inst, bool hasz, bool hast,
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting a temporal point
+ * @brief Add to a set the tiles intersecting a temporal point
  * sequence
  * @param[in] seq Temporal point
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
+ * @param[out] ts Set of tiles
  */
 static int
 tpointseq_disc_set_tiles(const TSequence *seq, bool hasz, bool hast,
-  const STboxGridState *state, BitMatrix *bm)
+  const STboxGridState *state, TileSet *ts)
 {
   /* Transform the point into tile coordinates */
   int coords[MAXDIMS], result = 0;
@@ -860,24 +883,24 @@ tpointseq_disc_set_tiles(const TSequence *seq, bool hasz, bool hast,
   {
     tpointinst_get_coords_eps(TSEQUENCE_INST_N(seq, i), hasz, hast, state,
       coords, NULL);
-    bitmatrix_set_cell(bm, coords, true);
+    tileset_add(ts, coords);
     result++;
   }
   return result;
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting the temporal
+ * @brief Add to a set the tiles intersecting the temporal
  * point sequence
  * @param[in] seq Temporal point
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
+ * @param[out] ts Set of tiles
  */
 static int
 tpointseq_cont_set_tiles(const TSequence *seq, bool hasz, bool hast,
-  const STboxGridState *state, BitMatrix *bm)
+  const STboxGridState *state, TileSet *ts)
 {
   int ndims = 2 + (hasz ? 1 : 0) + (hast ? 1 : 0);
   int coords1[MAXDIMS], coords2[MAXDIMS], result = 0;
@@ -886,11 +909,19 @@ tpointseq_cont_set_tiles(const TSequence *seq, bool hasz, bool hast,
   memset(coords2, 0, sizeof(coords2));
   tpointinst_get_coords_eps(TSEQUENCE_INST_N(seq, 0), hasz, hast, state,
     coords1, eps1);
+  /* Instantaneous sequence, which may be a component of a sequence set */
+  if (seq->count == 1)
+  {
+    ts->inst = 0;
+    tileset_add(ts, coords1);
+    return 1;
+  }
   for (int i = 1; i < seq->count; i++)
   {
     tpointinst_get_coords_eps(TSEQUENCE_INST_N(seq, i), hasz, hast, state,
       coords2, eps2);
-    result += fastvoxel_bm(coords1, eps1, coords2, eps2, ndims, bm);
+    ts->inst = i - 1;
+    result += fastvoxel_tiles(coords1, eps1, coords2, eps2, ndims, ts);
     memcpy(coords1, coords2, sizeof(coords1));
     memcpy(eps1, eps2, sizeof(eps1));
   }
@@ -898,83 +929,331 @@ tpointseq_cont_set_tiles(const TSequence *seq, bool hasz, bool hast,
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting the temporal
+ * @brief Add to a set the tiles intersecting the temporal
  * point sequence
  * @param[in] seq Temporal point
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
+ * @param[out] ts Set of tiles
  */
 static int
 tpointseq_set_tiles(const TSequence *seq, bool hasz, bool hast,
-  const STboxGridState *state, BitMatrix *bm)
+  const STboxGridState *state, TileSet *ts)
 {
   return MEOS_FLAGS_LINEAR_INTERP(seq->flags) ?
-    tpointseq_cont_set_tiles((TSequence *) seq, hasz, hast, state, bm) :
-    tpointseq_disc_set_tiles((TSequence *) seq, hasz, hast, state, bm);
+    tpointseq_cont_set_tiles((TSequence *) seq, hasz, hast, state, ts) :
+    tpointseq_disc_set_tiles((TSequence *) seq, hasz, hast, state, ts);
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting a temporal point
+ * @brief Add to a set the tiles intersecting a temporal point
  * sequence set
  * @param[in] ss Temporal point
  * @param[in] hasz Whether the tile has Z dimension
  * @param[in] hast Whether the tile has T dimension
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
+ * @param[out] ts Set of tiles
  */
 static int
 tpointseqset_set_tiles(const TSequenceSet *ss, bool hasz, bool hast,
-  const STboxGridState *state, BitMatrix *bm)
+  const STboxGridState *state, TileSet *ts)
 {
   int result = 0;
   for (int i = 0; i < ss->count; i++)
+  {
+    ts->seq = i;
     result += tpointseq_set_tiles(TSEQUENCESET_SEQ_N(ss, i), hasz, hast, state,
-      bm);
+      ts);
+  }
   return result;
 }
 
 /**
- * @brief Set the bit corresponding to the tiles intersecting a temporal point
+ * @brief Add to a set the tiles intersecting a temporal point
  * @param[in] temp Temporal point
  * @param[in] state Grid definition
- * @param[out] bm Bit matrix
- * @result Number of tiles set
+ * @param[out] ts Set of tiles, which is sorted
+ * @result Number of distinct tiles in the set
  */
 int
 tpoint_set_tiles(const Temporal *temp, const STboxGridState *state,
-  BitMatrix *bm)
+  TileSet *ts)
 {
-  /* The usage of bitmatrix is disallowed for instantaneous temporal values */
+  /* The usage of a set of tiles is disallowed for instantaneous temporal
+   * values */
   assert(temporal_num_instants(temp) > 1);
   bool hasz = MEOS_FLAGS_GET_Z(state->box.flags);
   bool hast = (state->tunits > 0);
   assert(temp->subtype == TSEQUENCE || temp->subtype == TSEQUENCESET);
   if (temp->subtype == TSEQUENCE)
-    return tpointseq_set_tiles((TSequence *) temp, hasz, hast, state, bm);
+    tpointseq_set_tiles((TSequence *) temp, hasz, hast, state, ts);
   else
-    return tpointseqset_set_tiles((TSequenceSet *) temp, hasz, hast, state, bm);
+    tpointseqset_set_tiles((TSequenceSet *) temp, hasz, hast, state, ts);
+  tileset_sort(ts);
+  return ts->ntiles;
 }
 
-/*****************************************************************************/
+/**
+ * @brief Return a temporal point sequence restricted to a tile, where the
+ * segments starting at the instants from @p from to @p to - 1 are the only
+ * ones that may traverse the tile
+ */
+static TSequenceSet *
+tpointseq_at_tile_segms(const TSequence *seq, int from, int to,
+  const STBox *box)
+{
+  if (from == 0 && to == seq->count - 1)
+    return (TSequenceSet *) tpoint_restrict_stbox((Temporal *) seq, box,
+      BORDER_EXC, REST_AT);
+  const TInstant **instants = palloc(sizeof(TInstant *) * (to - from + 1));
+  for (int i = from; i <= to; i++)
+    instants[i - from] = TSEQUENCE_INST_N(seq, i);
+  bool lower_inc = (from == 0) ? seq->period.lower_inc : true;
+  bool upper_inc = (to == seq->count - 1) ? seq->period.upper_inc : true;
+  TSequence *subseq = tsequence_make(instants, to - from + 1, lower_inc,
+    upper_inc, LINEAR, NORMALIZE_NO);
+  TSequenceSet *result = (TSequenceSet *) tpoint_restrict_stbox(
+    (Temporal *) subseq, box, BORDER_EXC, REST_AT);
+  pfree(instants); pfree(subseq);
+  return result;
+}
 
 /**
- * @brief Split a temporal point with respect to a space and possibly time grid
- * @param[in] temp Temporal point
+ * @brief Return the temporal point of a state restricted to its current tile
+ * @details When the segments traversing the tiles are kept in the set of
+ * tiles, only the runs of consecutive segments traversing the current tile
+ * are clipped against the tile, so that the temporal point is scanned only
+ * once for all the tiles. Each run is extended by one segment on each side so
+ * that the bounds of the fragments are computed as when the whole temporal
+ * point is restricted to the tile. Otherwise, the whole temporal point is
+ * restricted to the tile.
+ * @param[in] state Grid state
+ * @param[in] box Current tile of the state
+ * @note The function must be called before advancing the state to the next
+ * tile
+ */
+Temporal *
+stbox_tile_state_restrict(STboxGridState *state, const STBox *box)
+{
+  const TileSet *ts = state->tiles;
+  if (! ts || ! ts->keepsegms)
+    return tpoint_restrict_stbox(state->temp, box, BORDER_EXC, REST_AT);
+
+  /* Find the segments traversing the current tile */
+  int64 id = ts->tiles[state->tilepos];
+  const TileSegm *segms = ts->segms;
+  int first = state->segmpos;
+  while (first < ts->nsegms && segms[first].tile < id)
+    first++;
+  int last = first;
+  while (last < ts->nsegms && segms[last].tile == id)
+    last++;
+  state->segmpos = last;
+  if (first == last)
+    return NULL;
+
+  /* Restrict each run of segments to the tile */
+  TSequenceSet **seqsets = palloc(sizeof(TSequenceSet *) * (last - first));
+  int nseqsets = 0, totalseqs = 0;
+  int i = first;
+  while (i < last)
+  {
+    const TSequence *seq = (state->temp->subtype == TSEQUENCE) ?
+      (const TSequence *) state->temp :
+      TSEQUENCESET_SEQ_N((const TSequenceSet *) state->temp, segms[i].seq);
+    int from = Max(segms[i].inst - 1, 0);
+    int to = Min(segms[i].inst + 2, seq->count - 1);
+    int j = i + 1;
+    /* Merge the runs sharing instants once extended */
+    while (j < last && segms[j].seq == segms[i].seq &&
+        segms[j].inst - 1 <= to)
+      to = Min(segms[j++].inst + 2, seq->count - 1);
+    TSequenceSet *at = tpointseq_at_tile_segms(seq, from, to, box);
+    if (at)
+    {
+      seqsets[nseqsets++] = at;
+      totalseqs += at->count;
+    }
+    i = j;
+  }
+  /* Assemble the fragments of all the runs */
+  Temporal *result = NULL;
+  if (nseqsets == 1)
+  {
+    result = (Temporal *) seqsets[0];
+    pfree(seqsets);
+  }
+  else
+  {
+    if (nseqsets > 1)
+      result = (Temporal *) tseqsetarr_to_tseqset(seqsets, nseqsets,
+        totalseqs);
+    pfree_array((void **) seqsets, nseqsets);
+  }
+  return result;
+}
+
+/*****************************************************************************
+ * Grids
+ *****************************************************************************/
+
+/**
+ * @brief Set the spatial origin of a grid from a point
+ */
+static void
+sorigin_set_point3dz(const GSERIALIZED *sorigin, POINT3DZ *pt)
+{
+  memset(pt, 0, sizeof(POINT3DZ));
+  if (FLAGS_GET_Z(sorigin->gflags))
+  {
+    const POINT3DZ *p3d = GSERIALIZED_POINT3DZ_P(sorigin);
+    pt->x = p3d->x;
+    pt->y = p3d->y;
+    pt->z = p3d->z;
+  }
+  else
+  {
+    const POINT2D *p2d = GSERIALIZED_POINT2D_P(sorigin);
+    pt->x = p2d->x;
+    pt->y = p2d->y;
+  }
+  return;
+}
+
+/**
+ * @brief Set a spatial and possibly temporal grid from its parameters
  * @param[in] xsize,ysize,zsize Size of the corresponding dimension
- * @param[in] duration Duration
+ * @param[in] duration Duration, may be NULL for a spatial only grid
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @param[out] grid Grid, whose set of tiles is set to NULL
+ * @return False if the parameters are not valid
+ */
+bool
+stbox_grid_set(double xsize, double ysize, double zsize,
+  const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin,
+  STBoxGrid *grid)
+{
+  /* Ensure parameter validity */
+  if (! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(zsize), T_FLOAT8) ||
+      ! ensure_not_empty(sorigin) || ! ensure_point_type(sorigin) ||
+      (duration && ! ensure_valid_duration(duration)))
+    return false;
+
+  /* Initialize the missing dimensions to 0 */
+  memset(grid, 0, sizeof(STBoxGrid));
+  grid->xsize = xsize;
+  grid->ysize = ysize;
+  grid->zsize = zsize;
+  if (duration)
+  {
+    grid->tunits = interval_units(duration);
+    grid->torigin = torigin;
+  }
+  POINT3DZ pt;
+  sorigin_set_point3dz(sorigin, &pt);
+  grid->xorigin = pt.x;
+  grid->yorigin = pt.y;
+  grid->zorigin = pt.z;
+  grid->srid = gserialized_get_srid(sorigin);
+  grid->gflags = sorigin->gflags;
+  return true;
+}
+
+/**
+ * @brief Return true if two grids have the same parameters
+ */
+bool
+stbox_grid_eq(const STBoxGrid *grid1, const STBoxGrid *grid2)
+{
+  return grid1->xsize == grid2->xsize && grid1->ysize == grid2->ysize &&
+    grid1->zsize == grid2->zsize && grid1->tunits == grid2->tunits &&
+    grid1->xorigin == grid2->xorigin && grid1->yorigin == grid2->yorigin &&
+    grid1->zorigin == grid2->zorigin && grid1->torigin == grid2->torigin &&
+    grid1->srid == grid2->srid && grid1->gflags == grid2->gflags;
+}
+
+/**
+ * @brief Return a copy of the parameters of a grid together with a new set of
+ * tiles that is reused across the temporal points split or tiled with it
+ * @details The buffer of segments of the set of tiles is allocated upfront,
+ * so that the set is only enlarged afterwards, which keeps it in the memory
+ * context of the grid.
+ */
+STBoxGrid *
+stbox_grid_copy(const STBoxGrid *grid)
+{
+  STBoxGrid *result = palloc(sizeof(STBoxGrid));
+  memcpy(result, grid, sizeof(STBoxGrid));
+  int count[MAXDIMS] = {0};
+  result->tiles = tileset_make(count, MAXDIMS, true);
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return a spatial and possibly temporal grid that can be used for
+ * splitting or tiling many temporal points
+ * @details The parameters of the grid are validated once and the memory
+ * needed for collecting the tiles traversed by a temporal point is reused
+ * across the temporal points, so that the cost of each call of
+ * #tpoint_grid_split or #tpoint_grid_tiles is proportional to the tiles
+ * traversed by the temporal point.
+ * @param[in] xsize,ysize,zsize Size of the corresponding dimension
+ * @param[in] duration Duration, may be NULL for a spatial only grid
  * @param[in] sorigin Origin for the space dimension
  * @param[in] torigin Origin for the time dimension
- * @param[in] bitmatrix True when using a bitmatrix to speed up the computation
+ * @return On error return NULL
+ * @see #stbox_grid_free()
+ */
+STBoxGrid *
+stbox_grid_make(double xsize, double ysize, double zsize,
+  const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) sorigin))
+    return NULL;
+  STBoxGrid grid;
+  if (! stbox_grid_set(xsize, ysize, zsize, duration, sorigin, torigin,
+      &grid))
+    return NULL;
+  return stbox_grid_copy(&grid);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Free a spatial and possibly temporal grid
+ * @param[in] grid Grid
+ */
+void
+stbox_grid_free(STBoxGrid *grid)
+{
+  if (! grid)
+    return;
+  if (grid->tiles)
+    tileset_free((TileSet *) grid->tiles);
+  pfree(grid);
+  return;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Split a temporal point with respect to a grid
+ * @param[in] temp Temporal point
+ * @param[in] grid Grid, whose set of tiles, if any, is reused
+ * @param[in] bitmatrix True when only the tiles traversed by the temporal
+ * point are visited to speed up the computation
  * @param[in] border_inc True when the box contains the upper border, otherwise
  * the upper border is assumed as outside of the box.
  * @param[out] ntiles Number of tiles
  */
 STboxGridState *
-tpoint_space_time_split_init(Temporal *temp, float xsize, float ysize,
-  float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin,
-  bool bitmatrix, bool border_inc, int *ntiles)
+tpoint_grid_split_init(Temporal *temp, STBoxGrid *grid, bool bitmatrix,
+  bool border_inc, int *ntiles)
 {
   /* The usage of bitmatrix is disallowed for instantaneous temporal values */
   assert(! bitmatrix || temporal_num_instants(temp) > 1);
@@ -982,66 +1261,97 @@ tpoint_space_time_split_init(Temporal *temp, float xsize, float ysize,
   STBox bounds;
   temporal_set_bbox(temp, &bounds);
 
-  /* Ensure parameter validity */
-  if (! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
-      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
-      ! ensure_positive_datum(Float8GetDatum(zsize), T_FLOAT8) ||
-      ! ensure_not_empty(sorigin) || ! ensure_point_type(sorigin) ||
-      ! ensure_same_geodetic(temp->flags, sorigin->gflags))
-    return NULL;
-  int32 srid = bounds.srid;
-  int32 gs_srid = gserialized_get_srid(sorigin);
-  if (gs_srid != SRID_UNKNOWN && ! ensure_same_srid(srid, gs_srid))
+  /* Ensure the validity of the temporal point with respect to the grid */
+  if (! ensure_same_geodetic(temp->flags, grid->gflags) ||
+      (grid->srid != SRID_UNKNOWN && ! ensure_same_srid(bounds.srid,
+        grid->srid)))
     return NULL;
 
   POINT3DZ pt;
-  memset(&pt, 0, sizeof(POINT3DZ));
-  bool hasz = MEOS_FLAGS_GET_Z(temp->flags);
-  if (hasz)
-  {
-    ensure_has_Z_gs(sorigin);
-    const POINT3DZ *p3d = GSERIALIZED_POINT3DZ_P(sorigin);
-    pt.x = p3d->x;
-    pt.y = p3d->y;
-    pt.z = p3d->z;
-  }
-  else
+  pt.x = grid->xorigin;
+  pt.y = grid->yorigin;
+  pt.z = 0;
+  double zsize = 0;
+  if (MEOS_FLAGS_GET_Z(temp->flags))
   {
-    const POINT2D *p2d = GSERIALIZED_POINT2D_P(sorigin);
-    pt.x = p2d->x;
-    pt.y = p2d->y;
-    /* Since when zsize is not given we pass by default xsize, if temp does
-     * not have Z dimension we set zsize to 0 */
-    zsize = 0;
+    if (! FLAGS_GET_Z(grid->gflags))
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The geometry must have Z dimension");
+      return NULL;
+    }
+    pt.z = grid->zorigin;
+    zsize = grid->zsize;
   }
+  /* Otherwise, since when zsize is not given we pass by default xsize, if
+   * temp does not have Z dimension zsize is set to 0 */
 
-  int64 tunits = 0;
-  bool timesplit = (duration != NULL);
-  if (timesplit)
-  {
-    ensure_valid_duration(duration);
-    tunits = interval_units(duration);
-  }
-  else
+  if (grid->tunits == 0)
     /* Disallow T dimension for generating a spatial only grid */
     MEOS_FLAGS_SET_T(bounds.flags, false);
 
   /* Create function state */
-  STboxGridState *state = stbox_tile_state_make(temp, &bounds, xsize, ysize,
-    zsize, tunits, pt, torigin, border_inc);
-  int ndims = 2 + (hasz ? 1 : 0) + (state->tunits ? 1 : 0);
-  /* If a bit matrix is used to speed up the process */
+  STboxGridState *state = stbox_tile_state_make(temp, &bounds, grid->xsize,
+    grid->ysize, zsize, grid->tunits, pt, grid->torigin, border_inc);
+  /* If only the tiles traversed by the temporal point are visited */
   if (bitmatrix)
   {
-    /* Create the bit matrix and set the tiles traversed by the temporal point */
-    state->bm = bitmatrix_make(state->max_coords, ndims);
-    *ntiles = tpoint_set_tiles(temp, state, state->bm);
+    int count[MAXDIMS], ndims = 0;
+    count[ndims++] = state->max_coords[0];
+    count[ndims++] = state->max_coords[1];
+    if (state->hasz)
+      count[ndims++] = state->max_coords[2];
+    if (state->hast)
+      count[ndims++] = state->max_coords[3];
+    /* The segments traversing each tile are kept for linear interpolation,
+     * so that a tile is only intersected with the segments traversing it */
+    bool segms = MEOS_FLAGS_LINEAR_INTERP(temp->flags);
+    if (grid->tiles)
+    {
+      state->tiles = (TileSet *) grid->tiles;
+      tileset_reset(state->tiles, count, ndims, segms);
+    }
+    else
+    {
+      state->tiles = tileset_make(count, ndims, segms);
+      state->owntiles = true;
+    }
+    *ntiles = tpoint_set_tiles(temp, state, state->tiles);
+    if (*ntiles == 0)
+      state->done = true;
+    else
+      stbox_tile_state_set_tile(state);
   }
   else
     *ntiles = state->ntiles;
   return state;
 }
 
+/**
+ * @brief Split a temporal point with respect to a space and possibly time grid
+ * @param[in] temp Temporal point
+ * @param[in] xsize,ysize,zsize Size of the corresponding dimension
+ * @param[in] duration Duration
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @param[in] bitmatrix True when only the tiles traversed by the temporal
+ * point are visited to speed up the computation
+ * @param[in] border_inc True when the box contains the upper border, otherwise
+ * the upper border is assumed as outside of the box.
+ * @param[out] ntiles Number of tiles
+ */
+STboxGridState *
+tpoint_space_time_split_init(Temporal *temp, float xsize, float ysize,
+  float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin,
+  bool bitmatrix, bool border_inc, int *ntiles)
+{
+  STBoxGrid grid;
+  if (! stbox_grid_set(xsize, ysize, zsize, duration, sorigin, torigin,
+      &grid))
+    return NULL;
+  return tpoint_grid_split_init(temp, &grid, bitmatrix, border_inc, ntiles);
+}
+
 #if MEOS
 /**
  * @ingroup meos_temporal_analytics_tile
@@ -1050,7 +1360,8 @@ tpoint_space_time_split_init(Temporal *temp, float xsize, float ysize,
  * @param[in] temp Temporal point
  * @param[in] xsize,ysize,zsize Size of the corresponding dimension
  * @param[in] sorigin Origin for the space dimension
- * @param[in] bitmatrix True when using a bitmatrix to speed up the computation
+ * @param[in] bitmatrix True when only the tiles traversed by the temporal
+ * point are visited to speed up the computation
  * @param[in] border_inc True when the box contains the upper border, otherwise
  * the upper border is assumed as outside of the box.
  * @param[out] space_buckets Array of space buckets
@@ -1066,77 +1377,61 @@ tpoint_space_split(Temporal *temp, float xsize, float ysize, float zsize,
 }
 
 /**
- * @ingroup meos_temporal_analytics_tile
- * @brief Return the fragments a temporal point split according to a space and
- * possibly a time grid
- * @param[in] temp Temporal point
- * @param[in] xsize,ysize,zsize Size of the corresponding dimension
- * @param[in] duration Duration
- * @param[in] sorigin Origin for the space dimension
- * @param[in] torigin Origin for the time dimension
- * @param[in] bitmatrix True when using a bitmatrix to speed up the computation
- * @param[in] border_inc True when the box contains the upper border, otherwise
- * the upper border is assumed as outside of the box.
- * @param[out] space_buckets Array of space buckets
- * @param[out] time_buckets Array of time buckets
- * @param[out] count Number of elements in the output arrays
+ * @brief Return the fragments a temporal point split according to a grid,
+ * together with the buckets and/or the keys of the tiles of the fragments
  */
-Temporal **
-tpoint_space_time_split(Temporal *temp, float xsize, float ysize, float zsize,
-  Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin,
-  bool bitmatrix, bool border_inc, GSERIALIZED ***space_buckets,
-  TimestampTz **time_buckets, int *count)
+static Temporal **
+tpoint_grid_split1(Temporal *temp, STBoxGrid *grid, bool bitmatrix,
+  bool border_inc, GSERIALIZED ***space_buckets, TimestampTz **time_buckets,
+  int64 **tile_keys, int *count)
 {
+  /* The usage of bitmatrix is disallowed for instantaneous temporal values */
+  if (temporal_num_instants(temp) == 1)
+    bitmatrix = false;
   /* Initialize state */
   int ntiles;
-  STboxGridState *state = tpoint_space_time_split_init(temp, xsize, ysize,
-    zsize, duration, sorigin, torigin, bitmatrix, border_inc, &ntiles);
+  STboxGridState *state = tpoint_grid_split_init(temp, grid, bitmatrix,
+    border_inc, &ntiles);
   if (! state)
     return NULL;
 
-  GSERIALIZED **spaces = palloc(sizeof(GSERIALIZED *) * ntiles);
+  GSERIALIZED **spaces = space_buckets ?
+    palloc(sizeof(GSERIALIZED *) * ntiles) : NULL;
   TimestampTz *times = NULL;
-  bool timesplit = (duration != NULL);
-  if (timesplit)
+  bool timesplit = (grid->tunits > 0);
+  if (timesplit && time_buckets)
     times = palloc(sizeof(TimestampTz) * ntiles);
+  int64 *keys = tile_keys ? palloc(sizeof(int64) * ntiles) : NULL;
   Temporal **result = palloc(sizeof(Temporal *) * ntiles);
   bool hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
   int i = 0;
   /* We need to loop since atStbox may be NULL */
   while (true)
   {
-    /* Stop when we have used up all the grid tiles */
-    if (state->done)
-    {
-      if (state->bm)
-         pfree(state->bm);
-      pfree(state);
-      break;
-    }
-
-    /* Get current tile (if any) and advance state
-     * It is necessary to test if we found a tile since the previous tile
-     * may be the last one set in the associated bit matrix */
+    /* Get current tile (if any) and advance state, stopping when we have
+     * used up all the grid tiles. It is necessary to test if we found a tile
+     * since the previous tile may be the last one of the associated set of
+     * tiles */
     STBox box;
-    bool found = stbox_tile_state_get(state, &box);
-    if (! found)
+    if (state->done || ! stbox_tile_state_get(state, &box))
     {
-      if (state->bm) pfree(state->bm);
-      pfree(state);
+      stbox_tile_state_free(state);
       break;
     }
-    stbox_tile_state_next(state);
 
-    /* Restrict the temporal point to the box */
-    Temporal *atstbox = tpoint_restrict_stbox(state->temp, &box, BORDER_EXC,
-      REST_AT);
+    /* Restrict the temporal point to the box and advance the state */
+    Temporal *atstbox = stbox_tile_state_restrict(state, &box);
+    if (atstbox && keys)
+      keys[i] = stbox_tile_state_key(state);
+    stbox_tile_state_next(state);
     if (atstbox == NULL)
       continue;
 
     /* Construct value of the result */
-    spaces[i] = geopoint_make(box.xmin, box.ymin, box.zmin, hasz, false,
-      box.srid);
-    if (timesplit)
+    if (spaces)
+      spaces[i] = geopoint_make(box.xmin, box.ymin, box.zmin, hasz, false,
+        box.srid);
+    if (times)
       times[i] = DatumGetTimestampTz(box.period.lower);
     result[i++] = atstbox;
   }
@@ -1145,8 +1440,1336 @@ tpoint_space_time_split(Temporal *temp, float xsize, float ysize, float zsize,
     *space_buckets = spaces;
   if (time_buckets)
     *time_buckets = times;
+  if (tile_keys)
+    *tile_keys = keys;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the fragments a temporal point split according to a space and
+ * possibly a time grid
+ * @param[in] temp Temporal point
+ * @param[in] xsize,ysize,zsize Size of the corresponding dimension
+ * @param[in] duration Duration
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @param[in] bitmatrix True when only the tiles traversed by the temporal
+ * point are visited to speed up the computation
+ * @param[in] border_inc True when the box contains the upper border, otherwise
+ * the upper border is assumed as outside of the box.
+ * @param[out] space_buckets Array of space buckets
+ * @param[out] time_buckets Array of time buckets
+ * @param[out] count Number of elements in the output arrays
+ */
+Temporal **
+tpoint_space_time_split(Temporal *temp, float xsize, float ysize, float zsize,
+  Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin,
+  bool bitmatrix, bool border_inc, GSERIALIZED ***space_buckets,
+  TimestampTz **time_buckets, int *count)
+{
+  STBoxGrid grid;
+  if (! stbox_grid_set(xsize, ysize, zsize, duration, sorigin, torigin,
+      &grid))
+    return NULL;
+  Temporal **result;
+  MEOS_STATS_CALL(MEOS_FAMILY_TILING,
+    result = tpoint_grid_split1(temp, &grid, bitmatrix, border_inc,
+      space_buckets, time_buckets, NULL, count));
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the fragments a temporal point split according to a space and
+ * possibly a time grid, where the tiles are identified by their keys
+ * @param[in] temp Temporal point
+ * @param[in] xsize,ysize,zsize Size of the corresponding dimension
+ * @param[in] duration Duration, may be NULL for a spatial only grid
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @param[in] bitmatrix True when only the tiles traversed by the temporal
+ * point are visited to speed up the computation
+ * @param[in] border_inc True when the box contains the upper border, otherwise
+ * the upper border is assumed as outside of the box.
+ * @param[out] keys Array of tile keys
+ * @param[out] count Number of elements in the output arrays
+ * @see #stbox_tile_key()
+ */
+Temporal **
+tpoint_space_time_key_split(Temporal *temp, float xsize, float ysize,
+  float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin,
+  bool bitmatrix, bool border_inc, int64 **keys, int *count)
+{
+  STBoxGrid grid;
+  if (! stbox_grid_set(xsize, ysize, zsize, duration, sorigin, torigin,
+      &grid))
+    return NULL;
+  Temporal **result;
+  MEOS_STATS_CALL(MEOS_FAMILY_TILING,
+    result = tpoint_grid_split1(temp, &grid, bitmatrix, border_inc, NULL,
+      NULL, keys, count));
   return result;
 }
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the fragments a temporal point split according to a grid
+ * @param[in] temp Temporal point
+ * @param[in] grid Grid
+ * @param[in] bitmatrix True when only the tiles traversed by the temporal
+ * point are visited to speed up the computation
+ * @param[in] border_inc True when the box contains the upper border, otherwise
+ * the upper border is assumed as outside of the box.
+ * @param[out] space_buckets Array of space buckets
+ * @param[out] time_buckets Array of time buckets
+ * @param[out] count Number of elements in the output arrays
+ * @see #stbox_grid_make()
+ */
+Temporal **
+tpoint_grid_split(Temporal *temp, STBoxGrid *grid, bool bitmatrix,
+  bool border_inc, GSERIALIZED ***space_buckets, TimestampTz **time_buckets,
+  int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) grid) ||
+      ! ensure_not_null((void *) count) ||
+      ! ensure_tgeo_type(temp->temptype))
+    return NULL;
+  return tpoint_grid_split1(temp, grid, bitmatrix, border_inc, space_buckets,
+    time_buckets, NULL, count);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the fragments a temporal point split according to a grid,
+ * where the tiles are identified by their keys
+ * @param[in] temp Temporal point
+ * @param[in] grid Grid
+ * @param[in] bitmatrix True when only the tiles traversed by the temporal
+ * point are visited to speed up the computation
+ * @param[in] border_inc True when the box contains the upper border, otherwise
+ * the upper border is assumed as outside of the box.
+ * @param[out] keys Array of tile keys
+ * @param[out] count Number of elements in the output arrays
+ * @see #stbox_grid_make()
+ */
+Temporal **
+tpoint_grid_key_split(Temporal *temp, STBoxGrid *grid, bool bitmatrix,
+  bool border_inc, int64 **keys, int *count)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) grid) ||
+      ! ensure_not_null((void *) count) ||
+      ! ensure_tgeo_type(temp->temptype))
+    return NULL;
+  return tpoint_grid_split1(temp, grid, bitmatrix, border_inc, NULL, NULL,
+    keys, count);
+}
 #endif /* MEOS */
 
+/*****************************************************************************
+ * Spatial signature
+ * The signature of a temporal point is a bitmap of the cells of a regular
+ * grid over the spatial extent of its bounding box that are traversed by its
+ * trajectory. It allows to decide that the trajectory does not intersect a
+ * box that overlaps the bounding box without traversing the instants again.
+ *****************************************************************************/
+
+/**
+ * @brief Set the coordinates of a point in the signature grid of a box
+ * @details A box with zero extent in a dimension has a single cell in it
+ */
+static void
+signature_grid(const STBox *box, double x, double y, double *grid)
+{
+  double width = box->xmax - box->xmin, height = box->ymax - box->ymin;
+  grid[0] = width > 0.0 ?
+    (x - box->xmin) / width * SIGNATURE_SIZE : 0.0;
+  grid[1] = height > 0.0 ?
+    (y - box->ymin) / height * SIGNATURE_SIZE : 0.0;
+  return;
+}
+
+/**
+ * @brief Return the cell of the signature grid containing a coordinate, the
+ * coordinates on the upper border of the grid belonging to the last cell
+ */
+static int
+signature_cell(double coord)
+{
+  double cell = floor(coord);
+  if (cell < 0.0)
+    return 0;
+  if (cell >= SIGNATURE_SIZE)
+    return SIGNATURE_SIZE - 1;
+  return (int) cell;
+}
+
+/**
+ * @brief Add to a signature the cells traversed by a segment
+ * @details The cells are visited with the fast voxel traversal algorithm of
+ * Amanatides and Woo as in #fastvoxel_tiles. A dimension is only advanced
+ * until it reaches the cell of the end point, so that rounding errors in the
+ * crossing order cannot make the traversal leave the grid.
+ * @param[in] box Bounding box of the temporal point
+ * @param[in] p1,p2 Start and end points of the segment, which may be equal
+ * @param[in,out] sig Signature
+ */
+static void
+signature_segment(const STBox *box, const POINT2D *p1, const POINT2D *p2,
+  uint64 *sig)
+{
+  double grid1[2], grid2[2], tMax[2], tDelta[2];
+  int coords[2], last[2], next[2];
+  signature_grid(box, p1->x, p1->y, grid1);
+  signature_grid(box, p2->x, p2->y, grid2);
+  for (int i = 0; i < 2; i++)
+  {
+    coords[i] = signature_cell(grid1[i]);
+    last[i] = signature_cell(grid2[i]);
+    double delta = grid2[i] - grid1[i];
+    if (last[i] > coords[i])
+    {
+      next[i] = 1;
+      tDelta[i] = 1.0 / delta;
+      tMax[i] = ((double) coords[i] + 1.0 - grid1[i]) * tDelta[i];
+    }
+    else if (last[i] < coords[i])
+    {
+      next[i] = -1;
+      tDelta[i] = 1.0 / -delta;
+      tMax[i] = (grid1[i] - (double) coords[i]) * tDelta[i];
+    }
+    else
+    {
+      next[i] = 0;
+      tDelta[i] = tMax[i] = DBL_MAX;
+    }
+  }
+  while (true)
+  {
+    *sig |= SIGNATURE_BIT(coords[0], coords[1]);
+    if (coords[0] == last[0] && coords[1] == last[1])
+      break;
+    /* Progress to the next cell in the dimension with smallest tMax */
+    int idx = (coords[0] == last[0] ||
+      (coords[1] != last[1] && tMax[1] < tMax[0])) ? 1 : 0;
+    tMax[idx] += tDelta[idx];
+    coords[idx] += next[idx];
+  }
+  return;
+}
+
+/**
+ * @brief Add to a signature the cells traversed by a temporal point sequence
+ */
+static void
+tpointseq_signature(const TSequence *seq, const STBox *box, uint64 *sig)
+{
+  const POINT2D *p1 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, 0)));
+  signature_segment(box, p1, p1, sig);
+  /* With discrete or step interpolation only the instants are traversed */
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags);
+  for (int i = 1; i < seq->count; i++)
+  {
+    const POINT2D *p2 = DATUM_POINT2D_P(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+    signature_segment(box, linear ? p1 : p2, p2, sig);
+    p1 = p2;
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the spatial signature of a temporal point, that is, the
+ * bitmap of the cells of an 8x8 grid over the spatial extent of its bounding
+ * box that are traversed by its trajectory, or 0 on error
+ * @details The cell in column @p i and row @p j of the grid is the bit
+ * @p j * 8 + @p i of the signature. The Z dimension is ignored.
+ * @param[in] temp Temporal point
+ * @note The segments of a temporal geography point are considered as
+ * straight lines in the longitude and latitude coordinates
+ */
+uint64
+tpoint_space_signature(const Temporal *temp)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_tgeo_type(temp->temptype))
+    return 0;
+
+  STBox box;
+  tspatial_set_stbox(temp, &box);
+  uint64 result = 0;
+  if (temp->subtype == TINSTANT)
+  {
+    const POINT2D *p = DATUM_POINT2D_P(tinstant_val((TInstant *) temp));
+    signature_segment(&box, p, p, &result);
+  }
+  else if (temp->subtype == TSEQUENCE)
+    tpointseq_signature((TSequence *) temp, &box, &result);
+  else /* temp->subtype == TSEQUENCESET */
+  {
+    const TSequenceSet *ss = (const TSequenceSet *) temp;
+    for (int i = 0; i < ss->count; i++)
+      tpointseq_signature(TSEQUENCESET_SEQ_N(ss, i), &box, &result);
+  }
+  return result;
+}
+
+/**
+ * @brief Return true if a box may intersect the trajectory of a temporal
+ * point given its spatial signature, false if it certainly does not
+ * @details The extent of the box in the signature grid is enlarged by
+ * #SIGNATURE_EPSILON so that the rounding errors of the traversal of the
+ * segments never lead to a wrong negative answer
+ * @param[in] sig Spatial signature of the temporal point
+ * @param[in] box1 Bounding box of the temporal point
+ * @param[in] box2 Box, only its X and Y dimensions are considered
+ */
+bool
+signature_overlaps_stbox(uint64 sig, const STBox *box1, const STBox *box2)
+{
+  assert(MEOS_FLAGS_GET_X(box1->flags)); assert(MEOS_FLAGS_GET_X(box2->flags));
+  if (box2->xmin > box1->xmax || box2->xmax < box1->xmin ||
+      box2->ymin > box1->ymax || box2->ymax < box1->ymin)
+    return false;
+  double min[2], max[2];
+  signature_grid(box1, box2->xmin, box2->ymin, min);
+  signature_grid(box1, box2->xmax, box2->ymax, max);
+  int imin = signature_cell(min[0] - SIGNATURE_EPSILON),
+    imax = signature_cell(max[0] + SIGNATURE_EPSILON),
+    jmin = signature_cell(min[1] - SIGNATURE_EPSILON),
+    jmax = signature_cell(max[1] + SIGNATURE_EPSILON);
+  /* Bitmap of the columns of the box in a row of the grid */
+  uint64 row = ((UINT64CONST(1) << (imax - imin + 1)) - 1) << imin;
+  for (int j = jmin; j <= jmax; j++)
+  {
+    if (sig & (row << (j * SIGNATURE_SIZE)))
+      return true;
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * Tile identifiers
+ *****************************************************************************/
+
+/**
+ * @brief Return the identifier of a tile from its absolute coordinates in
+ * the grid
+ * @details The coordinates are packed into a 64-bit integer using 64/ndims
+ * bits per dimension. Coordinates exceeding this range wrap around so that
+ * distinct tiles may share the same identifier.
+ */
+static int64
+tile_id(const int64 *coords, int ndims)
+{
+  int bits = 64 / ndims;
+  uint64 mask = (UINT64CONST(1) << bits) - 1;
+  uint64 result = 0;
+  for (int i = 0; i < ndims; i++)
+    result = (result << bits) | ((uint64) coords[i] & mask);
+  return (int64) result;
+}
+
+/**
+ * @brief Set the absolute coordinates of the current tile of a grid state
+ * @return Number of dimensions of the grid
+ */
+static int
+stbox_tile_state_abs_coords(const STboxGridState *state, int64 *coords)
+{
+  int ndims = 0;
+  coords[ndims++] = state->base[0] + state->coords[0];
+  coords[ndims++] = state->base[1] + state->coords[1];
+  if (state->hasz)
+    coords[ndims++] = state->base[2] + state->coords[2];
+  if (state->hast)
+    coords[ndims++] = state->base[3] + state->coords[3];
+  return ndims;
+}
+
+/**
+ * @brief Return the set of identifiers of the tiles of a grid state, which
+ * are restricted to those of the set of tiles of the state, if any
+ * @note The state is freed by the function
+ */
+static Set *
+stbox_tile_state_ids(STboxGridState *state, int ntiles)
+{
+  int64 coords[MAXDIMS];
+  Datum *ids = palloc(sizeof(Datum) * ntiles);
+  int count = 0;
+  STBox box;
+  while (count < ntiles && stbox_tile_state_get(state, &box))
+  {
+    int ndims = stbox_tile_state_abs_coords(state, coords);
+    ids[count++] = Int64GetDatum(tile_id(coords, ndims));
+    stbox_tile_state_next(state);
+  }
+  stbox_tile_state_free(state);
+  if (! count)
+  {
+    pfree(ids);
+    return NULL;
+  }
+  return set_make_free(ids, count, T_INT8, ORDER);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the set of identifiers of the tiles of a spatial and possibly
+ * a temporal grid that intersect a spatiotemporal box
+ * @param[in] bounds Spatiotemporal box
+ * @param[in] xsize,ysize,zsize Size of the corresponding dimension
+ * @param[in] duration Duration, may be NULL for a spatial only grid
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @note The identifiers are only comparable with those obtained for the same
+ * grid, for example, with #tpoint_space_time_tiles
+ * @csqlfn #Stbox_space_time_tiles()
+ */
+Set *
+stbox_space_time_tiles(const STBox *bounds, double xsize, double ysize,
+  double zsize, const Interval *duration, const GSERIALIZED *sorigin,
+  TimestampTz torigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) bounds) || ! ensure_has_X_stbox(bounds) ||
+      ! ensure_not_geodetic(bounds->flags) ||
+      ! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
+      ! ensure_not_empty(sorigin) || ! ensure_point_type(sorigin) ||
+      (MEOS_FLAGS_GET_Z(bounds->flags) &&
+        (! ensure_positive_datum(Float8GetDatum(zsize), T_FLOAT8) ||
+         ! ensure_same_spatial_dimensionality_stbox_gs(bounds, sorigin))))
+    return NULL;
+  int64 tunits = 0;
+  if (duration)
+  {
+    if (! ensure_has_T_stbox(bounds) || ! ensure_valid_duration(duration))
+      return NULL;
+    tunits = interval_units(duration);
+  }
+  int32 gs_srid = gserialized_get_srid(sorigin);
+  if (gs_srid != SRID_UNKNOWN && ! ensure_same_srid(bounds->srid, gs_srid))
+    return NULL;
+
+  POINT3DZ pt;
+  sorigin_set_point3dz(sorigin, &pt);
+  if (! MEOS_FLAGS_GET_Z(bounds->flags))
+    zsize = 0;
+  STBox box;
+  memcpy(&box, bounds, sizeof(STBox));
+  if (! duration)
+    /* Disallow T dimension for generating a spatial only grid */
+    MEOS_FLAGS_SET_T(box.flags, false);
+  STboxGridState *state = stbox_tile_state_make(NULL, &box, xsize, ysize,
+    zsize, tunits, pt, torigin, true);
+  return stbox_tile_state_ids(state, state->ntiles);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the set of identifiers of the tiles of a spatial and possibly
+ * a temporal grid traversed by a temporal point
+ * @details The identifiers of the tiles can be indexed with a GIN index, so
+ * that finding the temporal points that traversed a set of tiles amounts to
+ * intersecting the posting lists of the tiles.
+ * @param[in] temp Temporal point
+ * @param[in] xsize,ysize,zsize Size of the corresponding dimension
+ * @param[in] duration Duration, may be NULL for a spatial only grid
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @csqlfn #Tpoint_space_time_tiles()
+ */
+Set *
+tpoint_space_time_tiles(Temporal *temp, float xsize, float ysize,
+  float zsize, Interval *duration, GSERIALIZED *sorigin, TimestampTz torigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) sorigin))
+    return NULL;
+  STBoxGrid grid;
+  if (! stbox_grid_set(xsize, ysize, zsize, duration, sorigin, torigin,
+      &grid))
+    return NULL;
+  return tpoint_grid_tiles(temp, &grid);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the set of identifiers of the tiles of a grid traversed by a
+ * temporal point
+ * @param[in] temp Temporal point
+ * @param[in] grid Grid, whose set of tiles, if any, is reused
+ * @see #stbox_grid_make()
+ * @csqlfn #Tpoint_space_time_tiles()
+ */
+Set *
+tpoint_grid_tiles(Temporal *temp, STBoxGrid *grid)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) || ! ensure_not_null((void *) grid))
+    return NULL;
+  /* The usage of bitmatrix is disallowed for instantaneous temporal values */
+  bool bitmatrix = (temporal_num_instants(temp) > 1);
+  int ntiles;
+  STboxGridState *state = tpoint_grid_split_init(temp, grid, bitmatrix, true,
+    &ntiles);
+  if (! state)
+    return NULL;
+  return stbox_tile_state_ids(state, ntiles);
+}
+
+/*****************************************************************************
+ * Hierarchical tile keys
+ * A tile key encodes the absolute coordinates of a tile along a Z-order
+ * (Morton) space-filling curve. The two upper bits of the key store the
+ * number of dimensions minus one, that is, 1 for 2D, 2 for 3D or 2D+T, and 3
+ * for 3D+T. The remaining bits store a sentinel bit followed by the
+ * interleaved bits of the coordinates, where the X dimension varies fastest,
+ * so that the level of a key is obtained from the position of its sentinel
+ * bit. The grid given by the tile sizes is the finest level, in which each
+ * coordinate has TILEKEY_BITS bits, and the parent of a tile is the tile of
+ * twice its size in every dimension containing it.
+ *****************************************************************************/
+
+/** Position of the number of dimensions in a tile key */
+#define TILEKEY_NDIMS_SHIFT 61
+/** Mask of the sentinel and coordinate bits of a tile key */
+#define TILEKEY_MASK ((UINT64CONST(1) << TILEKEY_NDIMS_SHIFT) - 1)
+/** Number of bits per coordinate at the finest level of a tile key */
+#define TILEKEY_BITS(ndims) (60 / (ndims))
+
+/**
+ * @brief Return the key of a tile from its absolute coordinates in the grid
+ * @details Coordinates are offset so that negative ones keep their order.
+ * Coordinates exceeding the range of TILEKEY_BITS bits wrap around so that
+ * distinct tiles may share the same key.
+ */
+static int64
+tile_key(const int64 *coords, int ndims)
+{
+  int bits = TILEKEY_BITS(ndims);
+  uint64 offset = UINT64CONST(1) << (bits - 1);
+  uint64 mask = (UINT64CONST(1) << bits) - 1;
+  uint64 c[MAXDIMS];
+  for (int i = 0; i < ndims; i++)
+    c[i] = ((uint64) coords[i] + offset) & mask;
+  uint64 result = 1; /* Sentinel bit */
+  for (int b = bits - 1; b >= 0; b--)
+  {
+    for (int i = ndims - 1; i >= 0; i--)
+      result = (result << 1) | ((c[i] >> b) & 1);
+  }
+  return (int64) (result | ((uint64) (ndims - 1) << TILEKEY_NDIMS_SHIFT));
+}
+
+/**
+ * @brief Return the number of dimensions and the level of a tile key
+ * @return On error return false
+ */
+static bool
+tile_key_decode(int64 key, int *ndims, int *level)
+{
+  uint64 low = (uint64) key & TILEKEY_MASK;
+  *ndims = (int) ((uint64) key >> TILEKEY_NDIMS_SHIFT) + 1;
+  int pos = -1;
+  for (uint64 v = low; v; v >>= 1)
+    pos++;
+  if (key < 0 || *ndims < 2 || pos < 0 || pos % *ndims != 0 ||
+      pos / *ndims > TILEKEY_BITS(*ndims))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid tile key: " INT64_FORMAT, key);
+    return false;
+  }
+  *level = pos / *ndims;
+  return true;
+}
+
+/**
+ * @brief Return the key of the current tile of a grid state
+ */
+int64
+stbox_tile_state_key(const STboxGridState *state)
+{
+  int64 coords[MAXDIMS];
+  int ndims = stbox_tile_state_abs_coords(state, coords);
+  return tile_key(coords, ndims);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the key of the tile of a spatial and possibly a temporal grid
+ * that contains a point and possibly a timestamp
+ * @param[in] point Point
+ * @param[in] t Timestamp
+ * @param[in] xsize,ysize,zsize Size of the corresponding dimension
+ * @param[in] duration Duration
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @param[in] hast True if the tile has a time dimension
+ * @return On error return -1
+ * @csqlfn #Tile_key()
+ */
+int64
+stbox_tile_key(const GSERIALIZED *point, TimestampTz t, double xsize,
+  double ysize, double zsize, const Interval *duration,
+  const GSERIALIZED *sorigin, TimestampTz torigin, bool hast)
+{
+  /* Ensure parameter validity */
+  if (! ensure_not_null((void *) point) || ! ensure_not_null((void *) sorigin) ||
+      ! ensure_not_empty(point) || ! ensure_point_type(point) ||
+      ! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
+      ! ensure_not_empty(sorigin) || ! ensure_point_type(sorigin) ||
+      (hast && ! ensure_valid_duration(duration)))
+    return -1;
+  bool hasz = (bool) FLAGS_GET_Z(point->gflags);
+  if (hasz && (! ensure_positive_datum(Float8GetDatum(zsize), T_FLOAT8) ||
+      ! ensure_has_Z_gs(sorigin)))
+    return -1;
+  int32 gs_srid = gserialized_get_srid(sorigin);
+  if (gs_srid != SRID_UNKNOWN &&
+      ! ensure_same_srid(gserialized_get_srid(point), gs_srid))
+    return -1;
+
+  POINT3DZ pt, ptorig;
+  sorigin_set_point3dz(point, &pt);
+  sorigin_set_point3dz(sorigin, &ptorig);
+  int64 coords[MAXDIMS];
+  int ndims = 0;
+  coords[ndims++] = llround((float_bucket(pt.x, xsize, ptorig.x) - ptorig.x) /
+    xsize);
+  coords[ndims++] = llround((float_bucket(pt.y, ysize, ptorig.y) - ptorig.y) /
+    ysize);
+  if (hasz)
+    coords[ndims++] = llround((float_bucket(pt.z, zsize, ptorig.z) -
+      ptorig.z) / zsize);
+  if (hast)
+  {
+    int64 tunits = interval_units(duration);
+    coords[ndims++] = (timestamptz_bucket1(t, tunits, torigin) - torigin) /
+      tunits;
+  }
+  return tile_key(coords, ndims);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the level of a tile key, where the finest level is the one of
+ * the grid used to compute the key
+ * @param[in] key Tile key
+ * @return On error return -1
+ * @csqlfn #Tile_key_level()
+ */
+int
+tile_key_level(int64 key)
+{
+  int ndims, level;
+  if (! tile_key_decode(key, &ndims, &level))
+    return -1;
+  return level;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the key of an ancestor of a tile, whose size is 2^levels
+ * times the one of the tile in every dimension
+ * @param[in] key Tile key
+ * @param[in] levels Number of levels to ascend
+ * @return On error return -1
+ * @csqlfn #Tile_key_parent()
+ */
+int64
+tile_key_parent(int64 key, int levels)
+{
+  int ndims, level;
+  if (! tile_key_decode(key, &ndims, &level))
+    return -1;
+  if (levels < 0 || levels > level)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of levels must be between 0 and %d", level);
+    return -1;
+  }
+  uint64 low = ((uint64) key & TILEKEY_MASK) >> (ndims * levels);
+  return (int64) (((uint64) key & ~TILEKEY_MASK) | low);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the set of keys of the children of a tile, whose size is half
+ * the one of the tile in every dimension
+ * @param[in] key Tile key
+ * @return On error return @p NULL
+ * @csqlfn #Tile_key_children()
+ */
+Set *
+tile_key_children(int64 key)
+{
+  int ndims, level;
+  if (! tile_key_decode(key, &ndims, &level))
+    return NULL;
+  if (level == TILEKEY_BITS(ndims))
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The tile key is at the finest level");
+    return NULL;
+  }
+  int count = 1 << ndims;
+  uint64 high = (uint64) key & ~TILEKEY_MASK;
+  uint64 low = ((uint64) key & TILEKEY_MASK) << ndims;
+  Datum *keys = palloc(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+    keys[i] = Int64GetDatum((int64) (high | low | (uint64) i));
+  return set_make_free(keys, count, T_INT8, ORDER_NO);
+}
+
+/*****************************************************************************
+ * Tile density aggregation
+ *****************************************************************************/
+
+/**
+ * @brief Structure to represent the key of the tile density hash table, which
+ * are the absolute coordinates of a tile in the grid
+ */
+typedef struct
+{
+  int64 x;             /**< Tile coordinate in the X dimension */
+  int64 y;             /**< Tile coordinate in the Y dimension */
+  int64 t;             /**< Tile coordinate in the T dimension, if any */
+} TileKey;
+
+/**
+ * @brief Structure to represent the entries of the tile density hash table
+ */
+typedef struct
+{
+  TileKey key;         /**< Tile coordinates (hash table key) */
+  int64 count;         /**< Number of temporal points traversing the tile */
+  double duration;     /**< Time spent in the tile in microseconds */
+  double distance;     /**< Distance traveled in the tile */
+  int64 last;          /**< Last temporal point counted in the tile */
+  char status;         /**< Hash status */
+} density_entry;
+
+/**
+ * @brief Return the hash value of a tile key
+ */
+static inline uint32
+tilekey_hash(TileKey key)
+{
+  uint32 result = pg_hashint8(key.x);
+  result = (result << 1) | (result >> 31);
+  result ^= pg_hashint8(key.y);
+  result = (result << 1) | (result >> 31);
+  result ^= pg_hashint8(key.t);
+  return result;
+}
+
+/**
+ * @brief Define a hashtable mapping tile coordinates to tile densities
+ */
+#define SH_PREFIX densitytable
+#define SH_ELEMENT_TYPE density_entry
+#define SH_KEY_TYPE TileKey
+#define SH_KEY key
+#define SH_HASH_KEY(tb, key) tilekey_hash(key)
+#define SH_EQUAL(tb, a, b) \
+  ((a).x == (b).x && (a).y == (b).y && (a).t == (b).t)
+#define SH_RAW_ALLOCATOR palloc0
+#define SH_SCOPE static inline
+#define SH_DEFINE
+#define SH_DECLARE
+#include "lib/simplehash.h"
+
+/**
+ * @brief Return the hash table of a tile density state
+ */
+#define TILE_DENSITY_TABLE(state) ((densitytable_hash *) (state)->table)
+
+/**
+ * @brief Return a new tile density state
+ */
+static TileDensityState *
+tile_density_state_make(double xsize, double ysize, int64 tunits,
+  double xorigin, double yorigin, TimestampTz torigin, int32 srid)
+{
+  TileDensityState *result = palloc0(sizeof(TileDensityState));
+  result->xsize = xsize;
+  result->ysize = ysize;
+  result->tunits = tunits;
+  result->xorigin = xorigin;
+  result->yorigin = yorigin;
+  result->torigin = torigin;
+  result->srid = srid;
+  result->ntemps = 0;
+  /* Arbitrary initialization to 256 tiles */
+  result->table = densitytable_create(256, NULL);
+  return result;
+}
+
+/**
+ * @brief Ensure that the grids of two tile density aggregations are the same
+ */
+static bool
+ensure_same_tile_density_grid(const TileDensityState *state1,
+  const TileDensityState *state2)
+{
+  if (state1->xsize == state2->xsize && state1->ysize == state2->ysize &&
+      state1->tunits == state2->tunits &&
+      state1->xorigin == state2->xorigin &&
+      state1->yorigin == state2->yorigin &&
+      state1->torigin == state2->torigin && state1->srid == state2->srid)
+    return true;
+  meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+    "The grids of the tile density aggregation must be the same");
+  return false;
+}
+
+/**
+ * @brief Add to a tile the part of a temporal point that is inside it
+ * @param[in,out] state State
+ * @param[in] coords Coordinates of the tile
+ * @param[in] duration Time spent in the tile in microseconds
+ * @param[in] distance Distance traveled in the tile
+ */
+static void
+tile_density_add(TileDensityState *state, const int64 *coords,
+  double duration, double distance)
+{
+  TileKey key;
+  key.x = coords[0];
+  key.y = coords[1];
+  key.t = state->tunits ? coords[2] : 0;
+  bool found;
+  density_entry *entry = densitytable_insert(state->table, key, &found);
+  if (! found)
+  {
+    entry->count = 0;
+    entry->duration = 0.0;
+    entry->distance = 0.0;
+    entry->last = 0;
+  }
+  /* Each temporal point is counted once per tile */
+  if (entry->last != state->ntemps)
+  {
+    entry->count++;
+    entry->last = state->ntemps;
+  }
+  entry->duration += duration;
+  entry->distance += distance;
+  return;
+}
+
+/**
+ * @brief Set the grid coordinates of a point at a timestamp
+ */
+static int
+tile_density_grid(const TileDensityState *state, const POINT4D *p,
+  TimestampTz t, double *grid)
+{
+  int ndims = 0;
+  grid[ndims++] = (p->x - state->xorigin) / state->xsize;
+  grid[ndims++] = (p->y - state->yorigin) / state->ysize;
+  if (state->tunits)
+    grid[ndims++] = (double) (t - state->torigin) / state->tunits;
+  return ndims;
+}
+
+/**
+ * @brief Add to the tiles the part of a segment that they contain
+ * @details The tiles traversed by the segment are visited with the fast voxel
+ * traversal algorithm of Amanatides and Woo as in #fastvoxel_tiles, keeping the
+ * fraction of the segment in each tile to distribute its duration and length
+ * @param[in,out] state State
+ * @param[in] p1,p2 Start and end points of the segment
+ * @param[in] t1,t2 Start and end timestamps of the segment
+ */
+static void
+tile_density_segment(TileDensityState *state, const POINT4D *p1,
+  const POINT4D *p2, TimestampTz t1, TimestampTz t2)
+{
+  double grid1[MAXDIMS], grid2[MAXDIMS], tMax[MAXDIMS], tDelta[MAXDIMS];
+  int64 coords[MAXDIMS];
+  int next[MAXDIMS];
+  int ndims = tile_density_grid(state, p1, t1, grid1);
+  tile_density_grid(state, p2, t2, grid2);
+  double duration = (double) (t2 - t1);
+  double length = hypot(p2->x - p1->x, p2->y - p1->y);
+  /* Number of tiles crossed by the segment */
+  int64 k = 0;
+  for (int i = 0; i < ndims; i++)
+  {
+    coords[i] = (int64) floor(grid1[i]);
+    int64 last = (int64) floor(grid2[i]);
+    k += llabs(last - coords[i]);
+    double delta = grid2[i] - grid1[i];
+    if (last > coords[i])
+    {
+      next[i] = 1;
+      tDelta[i] = 1.0 / delta;
+      tMax[i] = ((double) coords[i] + 1.0 - grid1[i]) * tDelta[i];
+    }
+    else if (last < coords[i])
+    {
+      next[i] = -1;
+      tDelta[i] = 1.0 / -delta;
+      tMax[i] = (grid1[i] - (double) coords[i]) * tDelta[i];
+    }
+    else
+    {
+      next[i] = 0;
+      tDelta[i] = tMax[i] = DBL_MAX;
+    }
+  }
+  double frac = 0.0;
+  for (int64 n = 0; n <= k; n++)
+  {
+    /* Find dimension with smallest tMax */
+    int idx = 0;
+    for (int j = 1; j < ndims; j++)
+    {
+      if (tMax[j] < tMax[idx])
+        idx = j;
+    }
+    double nextfrac = (n == k) ? 1.0 : Min(tMax[idx], 1.0);
+    /* Tiles touched at a single point, such as the corners, are skipped */
+    if (nextfrac > frac)
+      tile_density_add(state, coords, (nextfrac - frac) * duration,
+        (nextfrac - frac) * length);
+    if (n == k)
+      break;
+    /* Progress to the next tile in that dimension */
+    tMax[idx] += tDelta[idx];
+    coords[idx] += next[idx];
+    frac = nextfrac;
+  }
+  return;
+}
+
+/**
+ * @brief Add a temporal point instant to the tiles
+ */
+static void
+tile_density_inst(TileDensityState *state, const TInstant *inst)
+{
+  POINT4D p;
+  datum_point4d(tinstant_val(inst), &p);
+  tile_density_segment(state, &p, &p, inst->t, inst->t);
+  return;
+}
+
+/**
+ * @brief Add a temporal point sequence to the tiles
+ */
+static void
+tile_density_seq(TileDensityState *state, const TSequence *seq)
+{
+  if (seq->count == 1 || MEOS_FLAGS_DISCRETE_INTERP(seq->flags))
+  {
+    for (int i = 0; i < seq->count; i++)
+      tile_density_inst(state, TSEQUENCE_INST_N(seq, i));
+    return;
+  }
+  bool linear = MEOS_FLAGS_LINEAR_INTERP(seq->flags);
+  const TInstant *inst1 = TSEQUENCE_INST_N(seq, 0);
+  POINT4D p1, p2;
+  datum_point4d(tinstant_val(inst1), &p1);
+  for (int i = 1; i < seq->count; i++)
+  {
+    const TInstant *inst2 = TSEQUENCE_INST_N(seq, i);
+    datum_point4d(tinstant_val(inst2), &p2);
+    /* With step interpolation the point stays at its previous position */
+    tile_density_segment(state, &p1, linear ? &p2 : &p1, inst1->t, inst2->t);
+    inst1 = inst2;
+    p1 = p2;
+  }
+  return;
+}
+
+/**
+ * @brief Return the tile density state, created if it does not exist, after
+ * verifying that its grid is the given one
+ * @return On error return NULL
+ */
+static TileDensityState *
+tile_density_state_grid(TileDensityState *state, int32 srid, double xsize,
+  double ysize, const Interval *duration, const GSERIALIZED *sorigin,
+  TimestampTz torigin)
+{
+  int32 gs_srid = gserialized_get_srid(sorigin);
+  if (gs_srid != SRID_UNKNOWN && ! ensure_same_srid(srid, gs_srid))
+    return NULL;
+
+  POINT3DZ pt;
+  sorigin_set_point3dz(sorigin, &pt);
+  int64 tunits = duration ? interval_units(duration) : 0;
+  if (! state)
+    return tile_density_state_make(xsize, ysize, tunits, pt.x, pt.y,
+      duration ? torigin : 0, srid);
+
+  TileDensityState grid;
+  grid.xsize = xsize; grid.ysize = ysize; grid.tunits = tunits;
+  grid.xorigin = pt.x; grid.yorigin = pt.y;
+  grid.torigin = duration ? torigin : 0; grid.srid = srid;
+  if (! ensure_same_tile_density_grid(state, &grid))
+    return NULL;
+  return state;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Transition function for the tile density aggregation of temporal
+ * points
+ * @details The aggregation computes for each tile of a spatial and possibly
+ * temporal grid the number of temporal points that traverse it, together with
+ * the time spent and the distance traveled in it. Contrary to splitting the
+ * temporal points with #tpoint_space_time_split, the temporal points are
+ * traversed once without restricting them to the tiles.
+ * @param[in,out] state Current aggregate state
+ * @param[in] temp Temporal point
+ * @param[in] xsize,ysize Size of the corresponding dimension
+ * @param[in] duration Duration, may be NULL for a spatial only grid
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @note The Z dimension of the temporal points, if any, is not considered
+ * @csqlfn #Tpoint_tile_density_transfn()
+ */
+TileDensityState *
+tpoint_tile_density_transfn(TileDensityState *state, const Temporal *temp,
+  double xsize, double ysize, const Interval *duration,
+  const GSERIALIZED *sorigin, TimestampTz torigin)
+{
+  /* Null temporal: return state */
+  if (! temp)
+    return state;
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) sorigin) ||
+      ! ensure_tgeo_type(temp->temptype) ||
+      ! ensure_not_geodetic(temp->flags) ||
+      ! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
+      ! ensure_not_empty(sorigin) || ! ensure_point_type(sorigin) ||
+      (duration && ! ensure_valid_duration(duration)))
+    return NULL;
+  state = tile_density_state_grid(state, tpoint_srid(temp), xsize, ysize,
+    duration, sorigin, torigin);
+  if (! state)
+    return NULL;
+
+  state->ntemps++;
+  assert(temptype_subtype(temp->subtype));
+  switch (temp->subtype)
+  {
+    case TINSTANT:
+      tile_density_inst(state, (const TInstant *) temp);
+      break;
+    case TSEQUENCE:
+      tile_density_seq(state, (const TSequence *) temp);
+      break;
+    default: /* TSEQUENCESET */
+    {
+      const TSequenceSet *ss = (const TSequenceSet *) temp;
+      for (int i = 0; i < ss->count; i++)
+        tile_density_seq(state, TSEQUENCESET_SEQ_N(ss, i));
+    }
+  }
+  return state;
+}
+
+#if MEOS
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Transition function for the tile density aggregation of temporal
+ * points given in columnar form
+ * @details The coordinates and the timestamps of the trajectories are given
+ * in flat arrays, such as the buffers of the Arrow arrays read by
+ * #temporal_from_arrow, the instants of the i-th trajectory being those
+ * between the positions `offsets[i]` and `offsets[i + 1] - 1` of the arrays.
+ * The trajectories are assumed to be linearly interpolated. The segments are
+ * traversed directly from the arrays, without building a temporal point for
+ * each trajectory, which makes the function suited to large batches.
+ * @param[in,out] state Current aggregate state
+ * @param[in] xcoords,ycoords Coordinates of the instants
+ * @param[in] times Timestamps of the instants
+ * @param[in] offsets Start position of each trajectory in the arrays,
+ * followed by the total number of instants
+ * @param[in] count Number of trajectories
+ * @param[in] srid SRID of the coordinates
+ * @param[in] xsize,ysize Size of the corresponding dimension
+ * @param[in] duration Duration, may be NULL for a spatial only grid
+ * @param[in] sorigin Origin for the space dimension
+ * @param[in] torigin Origin for the time dimension
+ * @see #tpoint_tile_density_transfn()
+ */
+TileDensityState *
+tpoint_coords_tile_density_transfn(TileDensityState *state,
+  const double *xcoords, const double *ycoords, const TimestampTz *times,
+  const int *offsets, int count, int32 srid, double xsize, double ysize,
+  const Interval *duration, const GSERIALIZED *sorigin, TimestampTz torigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) xcoords) ||
+      ! ensure_not_null((void *) ycoords) ||
+      ! ensure_not_null((void *) times) ||
+      ! ensure_not_null((void *) offsets) ||
+      ! ensure_not_null((void *) sorigin) ||
+      ! ensure_not_negative(count) ||
+      ! ensure_positive_datum(Float8GetDatum(xsize), T_FLOAT8) ||
+      ! ensure_positive_datum(Float8GetDatum(ysize), T_FLOAT8) ||
+      ! ensure_not_empty(sorigin) || ! ensure_point_type(sorigin) ||
+      (duration && ! ensure_valid_duration(duration)))
+    return NULL;
+  for (int i = 0; i < count; i++)
+  {
+    if (offsets[i] >= offsets[i + 1])
+    {
+      meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+        "The trajectories must have at least one instant");
+      return NULL;
+    }
+    for (int j = offsets[i] + 1; j < offsets[i + 1]; j++)
+    {
+      if (times[j - 1] >= times[j])
+      {
+        meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+          "The timestamps of a trajectory must be increasing");
+        return NULL;
+      }
+    }
+  }
+
+  state = tile_density_state_grid(state, srid, xsize, ysize, duration,
+    sorigin, torigin);
+  if (! state)
+    return NULL;
+
+  POINT4D p1, p2;
+  p1.z = p2.z = p1.m = p2.m = 0.0;
+  for (int i = 0; i < count; i++)
+  {
+    state->ntemps++;
+    int j = offsets[i];
+    p1.x = xcoords[j]; p1.y = ycoords[j];
+    if (j + 1 == offsets[i + 1])
+    {
+      tile_density_segment(state, &p1, &p1, times[j], times[j]);
+      continue;
+    }
+    for (j++; j < offsets[i + 1]; j++)
+    {
+      p2.x = xcoords[j]; p2.y = ycoords[j];
+      tile_density_segment(state, &p1, &p2, times[j - 1], times[j]);
+      p1 = p2;
+    }
+  }
+  return state;
+}
+#endif /* MEOS */
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Combine function for the tile density aggregation of temporal points
+ * @param[in,out] state1,state2 States
+ * @note The second state is freed by the function
+ * @csqlfn #Tpoint_tile_density_combinefn()
+ */
+TileDensityState *
+tpoint_tile_density_combinefn(TileDensityState *state1,
+  TileDensityState *state2)
+{
+  if (! state1)
+    return state2;
+  if (! state2)
+    return state1;
+  if (! ensure_same_tile_density_grid(state1, state2))
+    return NULL;
+  densitytable_iterator iter;
+  density_entry *entry2;
+  densitytable_start_iterate(state2->table, &iter);
+  while ((entry2 = densitytable_iterate(state2->table, &iter)) != NULL)
+  {
+    bool found;
+    density_entry *entry1 = densitytable_insert(state1->table, entry2->key,
+      &found);
+    if (! found)
+    {
+      entry1->count = 0;
+      entry1->duration = 0.0;
+      entry1->distance = 0.0;
+      entry1->last = 0;
+    }
+    /* The states aggregate disjoint sets of temporal points */
+    entry1->count += entry2->count;
+    entry1->duration += entry2->duration;
+    entry1->distance += entry2->distance;
+  }
+  tile_density_state_free(state2);
+  return state1;
+}
+
+/**
+ * @brief Comparator function for tile densities
+ */
+static int
+tile_density_cmp(const void *a, const void *b)
+{
+  const TileDensity *td1 = (const TileDensity *) a;
+  const TileDensity *td2 = (const TileDensity *) b;
+  if (td1->t != td2->t)
+    return (td1->t < td2->t) ? -1 : 1;
+  if (td1->x != td2->x)
+    return (td1->x < td2->x) ? -1 : 1;
+  if (td1->y != td2->y)
+    return (td1->y < td2->y) ? -1 : 1;
+  return 0;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Final function for the tile density aggregation of temporal points
+ * @param[in] state State
+ * @param[out] count Number of tiles in the result
+ * @return Array of tile densities ordered by time and space
+ * @csqlfn #Tpoint_tile_density_finalfn()
+ */
+TileDensity *
+tpoint_tile_density_finalfn(const TileDensityState *state, int *count)
+{
+  if (! state || TILE_DENSITY_TABLE(state)->members == 0)
+  {
+    *count = 0;
+    return NULL;
+  }
+  TileDensity *result = palloc(sizeof(TileDensity) * TILE_DENSITY_TABLE(state)->members);
+  int i = 0;
+  densitytable_iterator iter;
+  density_entry *entry;
+  densitytable_start_iterate(state->table, &iter);
+  while ((entry = densitytable_iterate(state->table, &iter)) != NULL)
+  {
+    result[i].x = state->xorigin + entry->key.x * state->xsize;
+    result[i].y = state->yorigin + entry->key.y * state->ysize;
+    result[i].t = state->tunits ?
+      state->torigin + entry->key.t * state->tunits : DT_NOBEGIN;
+    result[i].count = entry->count;
+    result[i].duration = (int64) llround(entry->duration);
+    result[i++].distance = entry->distance;
+  }
+  qsort(result, i, sizeof(TileDensity), &tile_density_cmp);
+  *count = i;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the size of the serialized tile density state
+ */
+size_t
+tile_density_state_serialize_size(const TileDensityState *state)
+{
+  return sizeof(TileDensityState) +
+    (size_t) TILE_DENSITY_TABLE(state)->members * sizeof(density_entry);
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Serialize the tile density state into a buffer
+ * @details The buffer contains the state followed by the entries of the hash
+ * table, whose pointer in the state is not meaningful
+ */
+void
+tile_density_state_serialize(const TileDensityState *state, char *buf)
+{
+  memcpy(buf, state, sizeof(TileDensityState));
+  char *ptr = buf + sizeof(TileDensityState);
+  densitytable_iterator iter;
+  density_entry *entry;
+  densitytable_start_iterate(state->table, &iter);
+  while ((entry = densitytable_iterate(state->table, &iter)) != NULL)
+  {
+    memcpy(ptr, entry, sizeof(density_entry));
+    ptr += sizeof(density_entry);
+  }
+  return;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Deserialize a tile density state from a buffer
+ */
+TileDensityState *
+tile_density_state_deserialize(const char *buf, size_t size)
+{
+  TileDensityState *result = palloc(sizeof(TileDensityState));
+  memcpy(result, buf, sizeof(TileDensityState));
+  int count = (int) ((size - sizeof(TileDensityState)) /
+    sizeof(density_entry));
+  result->table = densitytable_create(Max(count, 256), NULL);
+  const char *ptr = buf + sizeof(TileDensityState);
+  for (int i = 0; i < count; i++)
+  {
+    density_entry entry;
+    memcpy(&entry, ptr, sizeof(density_entry));
+    ptr += sizeof(density_entry);
+    bool found;
+    density_entry *newentry = densitytable_insert(result->table, entry.key,
+      &found);
+    newentry->count = entry.count;
+    newentry->duration = entry.duration;
+    newentry->distance = entry.distance;
+    /* No temporal point of the state is counted by the new entries */
+    newentry->last = 0;
+  }
+  result->ntemps = 0;
+  return result;
+}
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Free a tile density state
+ */
+void
+tile_density_state_free(TileDensityState *state)
+{
+  if (! state)
+    return;
+  densitytable_destroy(state->table);
+  pfree(state);
+  return;
+}
+
+/*****************************************************************************
+ * Bucketed aggregation functions
+ *****************************************************************************/
+
+/**
+ * @ingroup meos_temporal_analytics_tile
+ * @brief Return the length traversed by a temporal point per time bucket
+ * @details The result is a temporal float with step interpolation computed
+ * with a single scan of the temporal point, without splitting it first
+ * @param[in] temp Temporal point
+ * @param[in] duration Size of the time buckets
+ * @param[in] torigin Time origin of the buckets
+ * @return On error return @p NULL
+ * @csqlfn #Tpoint_bucket_length()
+ */
+Temporal *
+tpoint_bucket_length(const Temporal *temp, const Interval *duration,
+  TimestampTz torigin)
+{
+  /* Ensure validity of the arguments */
+  if (! ensure_not_null((void *) temp) ||
+      ! ensure_not_null((void *) duration) ||
+      ! ensure_tgeo_type(temp->temptype) ||
+      ! ensure_valid_duration(duration))
+    return NULL;
+  return temporal_bucket_agg(temp, duration, torigin, BUCKET_LENGTH);
+}
+
 /*****************************************************************************/
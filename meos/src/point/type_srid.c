@@ -336,10 +336,7 @@ int
 tnpointinst_srid(const TInstant *inst)
 {
   const Npoint *np = DatumGetNpointP(tinstant_val(inst));
-  GSERIALIZED *line = route_geom(np->rid);
-  int result = gserialized_get_srid(line);
-  pfree(line);
-  return result;
+  return route_srid(np->rid);
 }
 
 /**
@@ -443,6 +440,25 @@ lwproj_transform(int32 srid_from, int32 srid_to)
   return NULL;
 }
 
+/**
+ * @brief Return the cached structure with the information to perform a
+ * transformation between two SRIDs, creating it on the first call
+ * @param[in] srid_from,srid_to SRIDs
+ * @note The result is kept in the cache of the MEOS context for the
+ * subsequent transformations with the same SRIDs and must not be freed
+ */
+LWPROJ *
+lwproj_transform_cached(int32 srid_from, int32 srid_to)
+{
+  LWPROJ *result = proj_cache_get(srid_from, srid_to);
+  if (result)
+    return result;
+  result = lwproj_transform(srid_from, srid_to);
+  if (! result)
+    return NULL;
+  return proj_cache_add(srid_from, srid_to, result);
+}
+
 /**
  * @brief Return a structure with the information to perform a transformation
  * pipeline
@@ -523,6 +539,97 @@ point_transf_pj(GSERIALIZED *gs, int32 srid_to, const LWPROJ *pj)
   return true;
 }
 
+/**
+ * @brief Transform an array of coordinates in place
+ * @details The coordinates are transformed with a single call to
+ * @p proj_trans_generic
+ * @param[in,out] points Coordinates, the Z values must be 0 for 2D points
+ * @param[in] count Number of coordinates
+ * @param[in] pj Information about the transformation
+ * @note Derived from PostGIS version 3.4.0 function ptarray_transform(),
+ * file `lwgeom_transform.c`
+ */
+bool
+pt4darr_transf_pj(POINT4D *points, int count, const LWPROJ *pj)
+{
+  assert(points); assert(count > 0); assert(pj);
+  PJ_DIRECTION direction = pj->pipeline_is_forward ? PJ_FWD : PJ_INV;
+
+  /* Convert to radians if necessary */
+  if (proj_angular_input(pj->pj, direction))
+  {
+    for (int i = 0; i < count; i++)
+      to_rad(&points[i]);
+  }
+
+  size_t n = proj_trans_generic(pj->pj, direction,
+    &points[0].x, sizeof(POINT4D), (size_t) count,
+    &points[0].y, sizeof(POINT4D), (size_t) count,
+    &points[0].z, sizeof(POINT4D), (size_t) count,
+    NULL, 0, 0);
+  int pj_errno_val = proj_errno_reset(pj->pj);
+  if (pj_errno_val || n != (size_t) count)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG,
+      "Transform: %s (%d)", proj_errno_string(pj_errno_val), pj_errno_val);
+    return false;
+  }
+
+  /* Convert radians to degrees if necessary */
+  if (proj_angular_output(pj->pj, direction))
+  {
+    for (int i = 0; i < count; i++)
+      to_dec(&points[i]);
+  }
+  return true;
+}
+
+/**
+ * @brief Transform an array of points to another SRID
+ * @details The coordinates of the points are gathered in a strided array
+ * that is transformed with a single call to @p proj_trans_generic
+ * @param[in] gsarr Points
+ * @param[in] count Number of points
+ * @param[in] srid_to SRID
+ * @param[in] pj Information about the transformation
+ * @note This function MODIFIES the input points in the first argument
+ */
+static bool
+points_transf_pj(GSERIALIZED **gsarr, int count, int32 srid_to,
+  const LWPROJ *pj)
+{
+  assert(gsarr); assert(count > 0); assert(pj);
+  if (count == 1)
+    return point_transf_pj(gsarr[0], srid_to, pj);
+
+  int has_z = FLAGS_GET_Z(gsarr[0]->gflags);
+  POINT4D *points = palloc(sizeof(POINT4D) * count);
+  for (int i = 0; i < count; i++)
+  {
+    const double *pa_double = (double *) (GS_POINT_PTR(gsarr[i]));
+    points[i].x = pa_double[0];
+    points[i].y = pa_double[1];
+    points[i].z = has_z ? pa_double[2] : 0.0;
+    points[i].m = 0.0;
+  }
+  if (! pt4darr_transf_pj(points, count, pj))
+  {
+    pfree(points);
+    return false;
+  }
+  for (int i = 0; i < count; i++)
+  {
+    double *pa_double = (double *) (GS_POINT_PTR(gsarr[i]));
+    pa_double[0] = points[i].x;
+    pa_double[1] = points[i].y;
+    if (has_z)
+      pa_double[2] = points[i].z;
+    gserialized_set_srid(gsarr[i], srid_to);
+  }
+  pfree(points);
+  return true;
+}
+
 #if MEOS
 /**
  * @brief Return a point transformed to another SRID
@@ -531,15 +638,13 @@ point_transf_pj(GSERIALIZED *gs, int32 srid_to, const LWPROJ *pj)
  * @param[in] pj Information about the transformation
  */
 GSERIALIZED *
-point_transform_pj(const GSERIALIZED *gs, int32 srid_to, LWPROJ *pj)
+point_transform_pj(const GSERIALIZED *gs, int32 srid_to, const LWPROJ *pj)
 {
   GSERIALIZED *result = geo_copy(gs);
   if (! point_transf_pj(result, srid_to, pj))
   {
     pfree(result); result = NULL;
   }
-  /* Clean up and return */
-  proj_destroy(pj->pj); pfree(pj);
   return result;
 }
 
@@ -564,7 +669,7 @@ point_transform(const GSERIALIZED *gs, int32 srid_to)
     return geo_copy(gs);
 
   /* Transform the point */
-  LWPROJ *pj = lwproj_transform(srid_from, srid_to);
+  LWPROJ *pj = lwproj_transform_cached(srid_from, srid_to);
   if (! pj)
     return NULL;
   return point_transform_pj(gs, srid_to, pj);
@@ -594,7 +699,9 @@ point_transform_pipeline(const GSERIALIZED *gs, char *pipeline,
   LWPROJ *pj = lwproj_transform_pipeline(pipeline, is_forward);
   if (! pj)
     return NULL;
-  return point_transform_pj(gs, srid_to, pj);
+  GSERIALIZED *result = point_transform_pj(gs, srid_to, pj);
+  proj_destroy(pj->pj); pfree(pj);
+  return result;
 }
 #endif /* MEOS */
 
@@ -608,7 +715,7 @@ point_transform_pipeline(const GSERIALIZED *gs, char *pipeline,
  * @param[in] pj Information about the transformation
  */
 static Set *
-geoset_transform_pj(const Set *s, int32 srid_to, LWPROJ *pj)
+geoset_transform_pj(const Set *s, int32 srid_to, const LWPROJ *pj)
 {
   assert(s); assert(pj); assert(geoset_type(s->settype));
   /* Copy the set to be able to transform the points of the set in place */
@@ -616,14 +723,12 @@ geoset_transform_pj(const Set *s, int32 srid_to, LWPROJ *pj)
   /* Transform the points of the set */
   for (int i = 0; i < s->count; i++)
   {
-    GSERIALIZED *gs = DatumGetGserializedP(SET_VAL_N(s, i));
+    GSERIALIZED *gs = DatumGetGserializedP(SET_VAL_N(result, i));
     if (! point_transf_pj(gs, srid_to, pj))
     {
-      pfree(result); proj_destroy(pj->pj); pfree(pj); return NULL;
+      pfree(result); return NULL;
     }
   }
-  /* Clean up and return */
-  proj_destroy(pj->pj); pfree(pj);
   return result;
 }
 
@@ -648,13 +753,12 @@ geoset_transform(const Set *s, int32 srid_to)
     return set_cp(s);
 
   /* Get the structure with information about the projection */
-  LWPROJ *pj = lwproj_transform(srid_from, srid_to);
+  LWPROJ *pj = lwproj_transform_cached(srid_from, srid_to);
   if (! pj)
     return NULL;
 
   /* Transform the geo set */
-  Set *result = set_cp(s);
-  return geoset_transform_pj(result, srid_to, pj);
+  return geoset_transform_pj(s, srid_to, pj);
 }
 
 /**
@@ -685,8 +789,9 @@ geoset_transform_pipeline(const Set *s, char *pipeline, int32 srid_to,
     return NULL;
 
   /* Transform the geo set */
-  Set *result = set_cp(s);
-  return geoset_transform_pj(result, srid_to, pj);
+  Set *result = geoset_transform_pj(s, srid_to, pj);
+  proj_destroy(pj->pj); pfree(pj);
+  return result;
 }
 
 /*****************************************************************************/
@@ -753,7 +858,7 @@ stbox_transf_pj(STBox *box, int32 srid_to, const LWPROJ *pj)
  * @param[in] pj Information about the transformation
  */
 static STBox *
-stbox_transform_pj(const STBox *box, int32 srid_to, LWPROJ *pj)
+stbox_transform_pj(const STBox *box, int32 srid_to, const LWPROJ *pj)
 {
   assert(box); assert(pj);
   /* Copy the spatiotemporal box to transform its composing points in place */
@@ -762,8 +867,6 @@ stbox_transform_pj(const STBox *box, int32 srid_to, LWPROJ *pj)
   {
     pfree(result); result = NULL;
   }
-  /* Clean up and return */
-  proj_destroy(pj->pj); pfree(pj);
   return result;
 }
 
@@ -786,7 +889,7 @@ stbox_transform(const STBox *box, int32 srid_to)
     return stbox_cp(box);
 
   /* Get the structure with information about the projection */
-  LWPROJ *pj = lwproj_transform(box->srid, srid_to);
+  LWPROJ *pj = lwproj_transform_cached(box->srid, srid_to);
   if (! pj)
     return NULL;
 
@@ -820,7 +923,9 @@ stbox_transform_pipeline(const STBox *box, char *pipeline,
     return NULL;
 
   /* Transform the temporal point */
-  return stbox_transform_pj(box, srid_to, pj);
+  STBox *result = stbox_transform_pj(box, srid_to, pj);
+  proj_destroy(pj->pj); pfree(pj);
+  return result;
 }
 
 /*****************************************************************************/
@@ -853,12 +958,14 @@ static bool
 tpointseq_transf_pj(TSequence *seq, int32 srid_to, const LWPROJ *pj)
 {
   assert(seq); assert(pj); assert(tgeo_type(seq->temptype));
+  /* Transform all the points of the sequence at once */
+  GSERIALIZED **gsarr = palloc(sizeof(GSERIALIZED *) * seq->count);
   for (int i = 0; i < seq->count; i++)
-  {
-    TInstant *inst = (TInstant *) TSEQUENCE_INST_N(seq, i);
-    if (! tpointinst_transf_pj(inst, srid_to, pj))
-      return false;
-  }
+    gsarr[i] = DatumGetGserializedP(tinstant_val(TSEQUENCE_INST_N(seq, i)));
+  bool ok = points_transf_pj(gsarr, seq->count, srid_to, pj);
+  pfree(gsarr);
+  if (! ok)
+    return false;
   /* Transform and set the SRID of the bounding box */
   STBox *box = TSEQUENCE_BBOX_PTR(seq);
   if (! stbox_transf_pj(box, srid_to, pj))
@@ -877,11 +984,27 @@ static bool
 tpointseqset_transf_pj(TSequenceSet *ss, int32 srid_to, const LWPROJ *pj)
 {
   assert(ss); assert(pj); assert(tgeo_type(ss->temptype));
+  /* Transform all the points of the sequence set at once */
+  GSERIALIZED **gsarr = palloc(sizeof(GSERIALIZED *) * ss->totalcount);
+  int npoints = 0;
   for (int i = 0; i < ss->count; i++)
   {
-    TSequence *seq = (TSequence *) TSEQUENCESET_SEQ_N(ss, i);
-    if (! tpointseq_transf_pj(seq, srid_to, pj))
+    const TSequence *seq = TSEQUENCESET_SEQ_N(ss, i);
+    for (int j = 0; j < seq->count; j++)
+      gsarr[npoints++] =
+        DatumGetGserializedP(tinstant_val(TSEQUENCE_INST_N(seq, j)));
+  }
+  bool ok = points_transf_pj(gsarr, npoints, srid_to, pj);
+  pfree(gsarr);
+  if (! ok)
+    return false;
+  /* Transform and set the SRID of the bounding boxes of the sequences */
+  for (int i = 0; i < ss->count; i++)
+  {
+    STBox *box = TSEQUENCE_BBOX_PTR(TSEQUENCESET_SEQ_N(ss, i));
+    if (! stbox_transf_pj(box, srid_to, pj))
       return false;
+    box->srid = srid_to;
   }
   /* Transform and set the SRID of the bounding box */
   STBox *box = TSEQUENCESET_BBOX_PTR(ss);
@@ -949,16 +1072,12 @@ tpoint_transform(const Temporal *temp, int32 srid_to)
     return temporal_cp(temp);
 
   /* Get the structure with information about the projection */
-  LWPROJ *pj = lwproj_transform(srid_from, srid_to);
+  LWPROJ *pj = lwproj_transform_cached(srid_from, srid_to);
   if (! pj)
     return NULL;
 
   /* Transform the temporal point */
-  Temporal * result = tpoint_transform_pj(temp, srid_to, pj);
-
-  proj_destroy(pj->pj); pfree(pj);
-
-  return result;
+  return tpoint_transform_pj(temp, srid_to, pj);
 }
 
 /**
@@ -0,0 +1,475 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Pipelined ingestion of a stream of temporal point instants into a
+ * MobilityDB database
+ * @details The pipeline has three stages connected by bounded queues
+ * - The calling thread reads the instants with a callback and partitions
+ *   them by object identifier among the assemblers
+ * - Each assembler thread assembles the trips of its objects with a session
+ *   state
+ * - Each writer thread sends the closed trips of its assemblers to the
+ *   database through its own connection with a binary COPY
+ *
+ * Every queue has a single producer and a single consumer, so that it is
+ * lock free with two atomic indexes. A stage waits by yielding the processor
+ * when its output queue is full or its input queues are empty, which slows
+ * down the reader when the database does not keep up.
+ *
+ * A typical use is as follows
+ * @code
+ * meosPipelineOptions opts = {0};
+ * opts.conninfo = "dbname=test";
+ * opts.target = "trips(id, trip)";
+ * opts.nassemblers = 4;
+ * opts.nwriters = 2;
+ * opts.session.maxt = maxt;
+ * opts.session.interp = LINEAR;
+ * int64_t nrows = meos_pipeline_run(&read_instant, file, &opts, NULL);
+ * @endcode
+ */
+
+/* C */
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* MEOS */
+#include <meos_pq.h>
+
+/** Maximum number of assemblers and of writers */
+#define PIPELINE_MAX_THREADS 64
+/** Number of instants handed at once by the reader to an assembler */
+#define PIPELINE_BATCH_SIZE 256
+
+/**
+ * @brief Structure for a bounded queue with a single producer and a single
+ * consumer
+ */
+typedef struct
+{
+  void **items;          /**< Items, the size is a power of two */
+  size_t mask;           /**< Size of the array of items minus one */
+  atomic_size_t head;    /**< Next item to pop, written by the consumer */
+  atomic_size_t tail;    /**< Next item to push, written by the producer */
+  atomic_bool closed;    /**< True when the producer has finished */
+} PipelineQueue;
+
+/**
+ * @brief Structure for a batch of instants handed to an assembler
+ */
+typedef struct
+{
+  int count;                            /**< Number of instants */
+  int64_t ids[PIPELINE_BATCH_SIZE];     /**< Identifiers of the objects */
+  TInstant *insts[PIPELINE_BATCH_SIZE]; /**< Instants */
+} PipelineBatch;
+
+/**
+ * @brief Structure for a closed trip handed to a writer
+ */
+typedef struct
+{
+  int64_t id;            /**< Identifier of the object */
+  TSequence *trip;       /**< Trip */
+} PipelineTrip;
+
+/**
+ * @brief Structure for an assembler
+ */
+typedef struct
+{
+  PipelineQueue in;      /**< Batches of instants */
+  PipelineQueue out;     /**< Closed trips */
+  const meosPipelineOptions *opts; /**< Options of the pipeline */
+  int64_t nerrors;       /**< Number of instants rejected */
+} PipelineAssembler;
+
+/**
+ * @brief Structure for a writer, which sends the trips of the assemblers
+ * whose number modulo the number of writers is the number of the writer
+ */
+typedef struct
+{
+  PipelineAssembler *asms; /**< Assemblers */
+  int nasms;             /**< Number of assemblers */
+  int first;             /**< Number of the first assembler of the writer */
+  int step;              /**< Number of writers */
+  const meosPipelineOptions *opts; /**< Options of the pipeline */
+  int64_t nrows;         /**< Number of rows copied, -1 on error */
+} PipelineWriter;
+
+/*****************************************************************************
+ * Queues
+ *****************************************************************************/
+
+/**
+ * @brief Initialize a queue with room for at least a number of items
+ * @return On error return false
+ */
+static bool
+queue_init(PipelineQueue *q, int size)
+{
+  size_t n = 2;
+  while (n < (size_t) size)
+    n <<= 1;
+  q->items = malloc(n * sizeof(void *));
+  q->mask = n - 1;
+  atomic_init(&q->head, 0);
+  atomic_init(&q->tail, 0);
+  atomic_init(&q->closed, false);
+  return q->items != NULL;
+}
+
+/**
+ * @brief Push an item into a queue, waiting while the queue is full
+ */
+static void
+queue_push(PipelineQueue *q, void *item)
+{
+  size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  while (tail - atomic_load_explicit(&q->head, memory_order_acquire) > q->mask)
+    sched_yield();
+  q->items[tail & q->mask] = item;
+  atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+  return;
+}
+
+/**
+ * @brief Close a queue, after which the producer cannot push any item
+ */
+static void
+queue_close(PipelineQueue *q)
+{
+  atomic_store_explicit(&q->closed, true, memory_order_release);
+  return;
+}
+
+/**
+ * @brief Pop an item from a queue without waiting
+ * @return Return 1 if an item is popped, 0 if the queue is empty, and -1 if
+ * the queue is empty and closed
+ */
+static int
+queue_try_pop(PipelineQueue *q, void **item)
+{
+  size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  /* Read the flag before the tail since the last push precedes the close */
+  bool closed = atomic_load_explicit(&q->closed, memory_order_acquire);
+  if (head == atomic_load_explicit(&q->tail, memory_order_acquire))
+    return closed ? -1 : 0;
+  *item = q->items[head & q->mask];
+  atomic_store_explicit(&q->head, head + 1, memory_order_release);
+  return 1;
+}
+
+/**
+ * @brief Pop an item from a queue, waiting while the queue is empty
+ * @return Return false when the queue is empty and closed
+ */
+static bool
+queue_pop(PipelineQueue *q, void **item)
+{
+  int rc;
+  while ((rc = queue_try_pop(q, item)) == 0)
+    sched_yield();
+  return rc > 0;
+}
+
+/*****************************************************************************
+ * Assemblers
+ *****************************************************************************/
+
+/**
+ * @brief Hand a closed trip of a session state to the writer
+ */
+static void
+assembler_flush(int64 id, TSequence *trip, tsessionFlush reason, void *arg)
+{
+  PipelineAssembler *a = (PipelineAssembler *) arg;
+  PipelineTrip *item = malloc(sizeof(PipelineTrip));
+  if (! item)
+  {
+    free(trip);
+    a->nerrors++;
+    return;
+  }
+  item->id = (int64_t) id;
+  item->trip = trip;
+  queue_push(&a->out, item);
+  return;
+}
+
+/**
+ * @brief Assemble the trips of the instants of an assembler
+ */
+static void *
+assembler_thread(void *arg)
+{
+  PipelineAssembler *a = (PipelineAssembler *) arg;
+  meos_initialize_thread(NULL);
+  tsessionOptions opts = a->opts->session;
+  opts.flush = &assembler_flush;
+  opts.arg = a;
+  SessionState *state = tsession_state_make(&opts);
+  void *item;
+  while (queue_pop(&a->in, &item))
+  {
+    PipelineBatch *batch = (PipelineBatch *) item;
+    for (int i = 0; i < batch->count; i++)
+    {
+      /* The instants that are not after the last one of their object are
+       * rejected, the quiet mode avoids calling the error handler */
+      meos_error_quiet_set(true);
+      if (! state || ! tsession_state_push(state, batch->ids[i],
+          batch->insts[i]))
+        a->nerrors++;
+      meos_error_quiet_set(false);
+      free(batch->insts[i]);
+    }
+    free(batch);
+  }
+  /* Close the remaining trips */
+  if (state)
+    tsession_state_finish(state);
+  queue_close(&a->out);
+  meos_finalize_thread();
+  return NULL;
+}
+
+/*****************************************************************************
+ * Writers
+ *****************************************************************************/
+
+/**
+ * @brief Send the trips of the assemblers of a writer to the database
+ */
+static void *
+writer_thread(void *arg)
+{
+  PipelineWriter *w = (PipelineWriter *) arg;
+  meos_initialize_thread(NULL);
+  MeosCopy *copy = NULL;
+  PGconn *conn = PQconnectdb(w->opts->conninfo);
+  if (PQstatus(conn) != CONNECTION_OK)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "Connection failed: %s",
+      PQerrorMessage(conn));
+  else
+    copy = meos_copy_begin(conn, w->opts->target, 2, w->opts->batchsize);
+  bool ok = (copy != NULL);
+
+  /* Consume the queues until all of them are closed, even after an error,
+   * otherwise the assemblers would wait forever */
+  bool done[PIPELINE_MAX_THREADS] = {0};
+  int nopen = 0;
+  for (int i = w->first; i < w->nasms; i += w->step)
+    nopen++;
+  while (nopen > 0)
+  {
+    bool progress = false;
+    for (int i = w->first; i < w->nasms; i += w->step)
+    {
+      if (done[i])
+        continue;
+      void *item;
+      int rc = queue_try_pop(&w->asms[i].out, &item);
+      if (rc < 0)
+      {
+        done[i] = true;
+        nopen--;
+        continue;
+      }
+      if (rc == 0)
+        continue;
+      PipelineTrip *trip = (PipelineTrip *) item;
+      if (ok)
+        ok = meos_copy_put_int8(copy, trip->id) &&
+          meos_copy_put_temporal(copy, (Temporal *) trip->trip);
+      free(trip->trip);
+      free(trip);
+      progress = true;
+    }
+    if (! progress)
+      sched_yield();
+  }
+
+  w->nrows = copy ? meos_copy_end(copy) : -1;
+  if (! ok)
+    w->nrows = -1;
+  PQfinish(conn);
+  meos_finalize_thread();
+  return NULL;
+}
+
+/*****************************************************************************
+ * API function
+ *****************************************************************************/
+
+/**
+ * @brief Ingest a stream of temporal point instants into a table of a
+ * MobilityDB database
+ * @details The instants are read in the calling thread with the callback,
+ * which transfers the ownership of the instants. The trips are assembled
+ * with the options of the session state, where the function receiving the
+ * closed trips is set by the pipeline, and copied into the columns of the
+ * target that are the identifier of the object as a big integer and the
+ * trip.
+ * @param[in] read Function reading the next instant, which returns false at
+ * the end of the stream and may return a @p NULL instant to skip a record
+ * @param[in] arg Argument passed to the function
+ * @param[in] opts Options of the pipeline
+ * @param[out] nerrors If supplied, number of instants rejected by the
+ * assembly
+ * @return Number of rows copied, on error return -1
+ */
+int64_t
+meos_pipeline_run(meos_pipeline_read_fn read, void *arg,
+  const meosPipelineOptions *opts, int64_t *nerrors)
+{
+  if (nerrors)
+    *nerrors = 0;
+  if (! read || ! opts || ! opts->conninfo || ! opts->target)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid arguments for the ingestion pipeline");
+    return -1;
+  }
+  int nasms = opts->nassemblers > 0 ? opts->nassemblers : 1;
+  int nwriters = opts->nwriters > 0 ? opts->nwriters : 1;
+  if (nasms > PIPELINE_MAX_THREADS || nwriters > nasms)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The number of assemblers must be at most %d and the number of writers "
+      "at most the number of assemblers", PIPELINE_MAX_THREADS);
+    return -1;
+  }
+  int qsize = opts->queuesize > 0 ? opts->queuesize : 1024;
+
+  PipelineAssembler *asms = calloc((size_t) nasms, sizeof(PipelineAssembler));
+  PipelineWriter *writers = calloc((size_t) nwriters, sizeof(PipelineWriter));
+  bool ok = asms && writers;
+  for (int i = 0; ok && i < nasms; i++)
+  {
+    asms[i].opts = opts;
+    ok = queue_init(&asms[i].in, qsize) && queue_init(&asms[i].out, qsize);
+  }
+
+  /* Start the threads, on failure the input is not read so that the started
+   * threads finish without producing anything */
+  pthread_t athreads[PIPELINE_MAX_THREADS], wthreads[PIPELINE_MAX_THREADS];
+  bool astarted[PIPELINE_MAX_THREADS] = {0};
+  bool wstarted[PIPELINE_MAX_THREADS] = {0};
+  for (int i = 0; ok && i < nasms; i++)
+    ok = astarted[i] =
+      pthread_create(&athreads[i], NULL, assembler_thread, &asms[i]) == 0;
+  for (int i = 0; ok && i < nwriters; i++)
+  {
+    writers[i].asms = asms;
+    writers[i].nasms = nasms;
+    writers[i].first = i;
+    writers[i].step = nwriters;
+    writers[i].opts = opts;
+    ok = wstarted[i] =
+      pthread_create(&wthreads[i], NULL, writer_thread, &writers[i]) == 0;
+  }
+  if (! ok)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Cannot start the ingestion pipeline");
+
+  /* Read the instants and hand them in batches to the assemblers */
+  PipelineBatch *batches[PIPELINE_MAX_THREADS] = {0};
+  int64_t id;
+  TInstant *inst;
+  while (ok && read(&id, &inst, arg))
+  {
+    if (! inst)
+      continue;
+    int k = (int) ((uint64_t) id % (uint64_t) nasms);
+    if (! batches[k])
+    {
+      batches[k] = malloc(sizeof(PipelineBatch));
+      if (! batches[k])
+      {
+        free(inst);
+        ok = false;
+        break;
+      }
+      batches[k]->count = 0;
+    }
+    batches[k]->ids[batches[k]->count] = id;
+    batches[k]->insts[batches[k]->count++] = inst;
+    if (batches[k]->count == PIPELINE_BATCH_SIZE)
+    {
+      queue_push(&asms[k].in, batches[k]);
+      batches[k] = NULL;
+    }
+  }
+  for (int i = 0; asms && i < nasms; i++)
+  {
+    if (batches[i])
+      queue_push(&asms[i].in, batches[i]);
+    if (asms[i].in.items)
+      queue_close(&asms[i].in);
+  }
+
+  /* Wait for the threads */
+  int64_t result = ok ? 0 : -1;
+  for (int i = 0; asms && i < nasms; i++)
+  {
+    if (astarted[i])
+      pthread_join(athreads[i], NULL);
+    if (nerrors)
+      *nerrors += asms[i].nerrors;
+  }
+  for (int i = 0; writers && i < nwriters; i++)
+  {
+    if (! wstarted[i])
+      continue;
+    pthread_join(wthreads[i], NULL);
+    if (writers[i].nrows < 0)
+      result = -1;
+    else if (result >= 0)
+      result += writers[i].nrows;
+  }
+
+  for (int i = 0; asms && i < nasms; i++)
+  {
+    free(asms[i].in.items);
+    free(asms[i].out.items);
+  }
+  free(asms);
+  free(writers);
+  return result;
+}
+
+/*****************************************************************************/
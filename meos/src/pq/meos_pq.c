@@ -0,0 +1,503 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Streaming of temporal values into a MobilityDB database with the
+ * binary COPY protocol
+ * @details The rows are encoded in the binary COPY format, where temporal
+ * values are encoded in WKB, which is the binary input format of the
+ * temporal types in MobilityDB. Two buffers are used: while a batch is being
+ * handed to libpq, which sends it in nonblocking mode, the next batch is
+ * encoded in the other buffer. The application only waits for the network
+ * when both buffers are full.
+ *
+ * A typical use is as follows
+ * @code
+ * MeosCopy *copy = meos_copy_begin(conn, "trips(mmsi, trip)", 2, 0);
+ * for (int i = 0; i < count; i++)
+ * {
+ *   meos_copy_put_int8(copy, mmsi[i]);
+ *   meos_copy_put_temporal(copy, trips[i]);
+ * }
+ * int64_t nrows = meos_copy_end(copy);
+ * @endcode
+ */
+
+/* C */
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* MEOS */
+#include <meos_pq.h>
+
+/** Signature of the binary COPY format followed by the flags and the length
+ * of the header extension */
+static const char MEOS_COPY_HEADER[19] =
+  "PGCOPY\n\377\r\n\0\0\0\0\0\0\0\0\0";
+
+/**
+ * @brief Structure for an ongoing binary COPY
+ */
+struct MeosCopy
+{
+  PGconn *conn;            /**< Connection */
+  int nfields;             /**< Number of fields of a row */
+  int field;               /**< Number of the next field of the row */
+  size_t batchsize;        /**< Size of a batch */
+  char *buf[2];            /**< Buffers */
+  size_t len[2];           /**< Number of used bytes of the buffers */
+  size_t maxlen[2];        /**< Size of the buffers */
+  int cur;                 /**< Buffer being filled */
+  bool pending;            /**< True when the other buffer is not yet sent */
+  bool failed;             /**< True after an error */
+  int64_t nrows;           /**< Number of complete rows */
+};
+
+/*****************************************************************************
+ * Sending
+ *****************************************************************************/
+
+/**
+ * @brief Try to hand the pending buffer to libpq without blocking
+ * @return On error return false
+ */
+static bool
+meos_copy_try_send(MeosCopy *copy)
+{
+  if (copy->pending)
+  {
+    int other = 1 - copy->cur;
+    int rc = PQputCopyData(copy->conn, copy->buf[other],
+      (int) copy->len[other]);
+    if (rc < 0)
+      return false;
+    if (rc == 1)
+    {
+      copy->len[other] = 0;
+      copy->pending = false;
+    }
+  }
+  /* Push to the network the data queued in libpq as far as possible */
+  return PQflush(copy->conn) >= 0;
+}
+
+/**
+ * @brief Wait until the socket of the connection accepts data
+ */
+static bool
+meos_copy_wait(MeosCopy *copy)
+{
+  struct pollfd pfd;
+  pfd.fd = PQsocket(copy->conn);
+  pfd.events = POLLOUT | POLLIN;
+  pfd.revents = 0;
+  if (pfd.fd < 0 || poll(&pfd, 1, -1) < 0)
+    return false;
+  /* Consume the messages of the server, such as an early error */
+  if ((pfd.revents & POLLIN) && ! PQconsumeInput(copy->conn))
+    return false;
+  return true;
+}
+
+/**
+ * @brief Send the pending buffer, waiting for the network if needed
+ */
+static bool
+meos_copy_send(MeosCopy *copy)
+{
+  while (true)
+  {
+    if (! meos_copy_try_send(copy))
+      return false;
+    if (! copy->pending)
+      return true;
+    if (! meos_copy_wait(copy))
+      return false;
+  }
+}
+
+/**
+ * @brief Report an error of the connection and abort the COPY
+ */
+static void
+meos_copy_fail(MeosCopy *copy)
+{
+  if (! copy->failed)
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "COPY failed: %s",
+      PQerrorMessage(copy->conn));
+  copy->failed = true;
+  return;
+}
+
+/*****************************************************************************
+ * Encoding
+ *****************************************************************************/
+
+/**
+ * @brief Ensure that the current buffer has space for a number of bytes
+ */
+static char *
+meos_copy_reserve(MeosCopy *copy, size_t size)
+{
+  int cur = copy->cur;
+  if (copy->len[cur] + size > copy->maxlen[cur])
+  {
+    size_t maxlen = copy->maxlen[cur] * 2;
+    while (copy->len[cur] + size > maxlen)
+      maxlen *= 2;
+    char *buf = realloc(copy->buf[cur], maxlen);
+    if (! buf)
+    {
+      meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+        "Out of memory while encoding the COPY data");
+      copy->failed = true;
+      return NULL;
+    }
+    copy->buf[cur] = buf;
+    copy->maxlen[cur] = maxlen;
+  }
+  char *result = copy->buf[cur] + copy->len[cur];
+  copy->len[cur] += size;
+  return result;
+}
+
+/**
+ * @brief Write an unsigned integer in network byte order
+ */
+static void
+meos_copy_write_uint(char *buf, uint64_t value, int size)
+{
+  for (int i = size - 1; i >= 0; i--)
+  {
+    buf[i] = (char) (value & 0xFF);
+    value >>= 8;
+  }
+  return;
+}
+
+/**
+ * @brief Start a field of a row with its length, or -1 for a null
+ * @return Pointer to the data of the field, on error return @p NULL
+ */
+static char *
+meos_copy_field(MeosCopy *copy, int32_t length)
+{
+  if (! copy || copy->failed)
+    return NULL;
+  /* Start a new row with the number of fields */
+  if (copy->field == 0)
+  {
+    char *ptr = meos_copy_reserve(copy, 2);
+    if (! ptr)
+      return NULL;
+    meos_copy_write_uint(ptr, (uint64_t) copy->nfields, 2);
+  }
+  char *ptr = meos_copy_reserve(copy, 4 + (length > 0 ? length : 0));
+  if (! ptr)
+    return NULL;
+  meos_copy_write_uint(ptr, (uint64_t) (uint32_t) length, 4);
+  return ptr + 4;
+}
+
+/**
+ * @brief Finish a field and, at the end of a row, send the current buffer
+ * when it is full
+ */
+static bool
+meos_copy_field_end(MeosCopy *copy)
+{
+  if (++copy->field < copy->nfields)
+    return true;
+  copy->field = 0;
+  copy->nrows++;
+  /* Opportunistically send the pending buffer */
+  if (! meos_copy_try_send(copy))
+  {
+    meos_copy_fail(copy);
+    return false;
+  }
+  if (copy->len[copy->cur] < copy->batchsize)
+    return true;
+  /* Both buffers are full: wait for the pending one */
+  if (copy->pending && ! meos_copy_send(copy))
+  {
+    meos_copy_fail(copy);
+    return false;
+  }
+  copy->pending = true;
+  copy->cur = 1 - copy->cur;
+  if (! meos_copy_try_send(copy))
+  {
+    meos_copy_fail(copy);
+    return false;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * API functions
+ *****************************************************************************/
+
+/**
+ * @brief Start a binary COPY into a table
+ * @param[in] conn Connection, which is set in nonblocking mode until the
+ * end of the COPY
+ * @param[in] target Table and optional column list, e.g., `trips(id, trip)`
+ * @param[in] nfields Number of fields of a row
+ * @param[in] batchsize Size in bytes of the batches sent to the server, 0
+ * for #MEOS_COPY_BATCH_SIZE
+ * @return On error return @p NULL
+ */
+MeosCopy *
+meos_copy_begin(PGconn *conn, const char *target, int nfields,
+  size_t batchsize)
+{
+  if (! conn || ! target || nfields <= 0 || nfields > INT16_MAX)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "Invalid arguments for starting a COPY");
+    return NULL;
+  }
+  size_t len = strlen(target) + 64;
+  char *sql = malloc(len);
+  if (! sql)
+    return NULL;
+  snprintf(sql, len, "COPY %s FROM STDIN (FORMAT binary)", target);
+  PGresult *res = PQexec(conn, sql);
+  free(sql);
+  if (PQresultStatus(res) != PGRES_COPY_IN)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "COPY failed: %s",
+      PQerrorMessage(conn));
+    PQclear(res);
+    return NULL;
+  }
+  PQclear(res);
+
+  MeosCopy *result = calloc(1, sizeof(MeosCopy));
+  if (! result)
+    return NULL;
+  result->conn = conn;
+  result->nfields = nfields;
+  result->batchsize = batchsize ? batchsize : MEOS_COPY_BATCH_SIZE;
+  for (int i = 0; i < 2; i++)
+  {
+    result->maxlen[i] = result->batchsize + 1024;
+    result->buf[i] = malloc(result->maxlen[i]);
+  }
+  if (! result->buf[0] || ! result->buf[1] || PQsetnonblocking(conn, 1) != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR,
+      "Cannot initialize the COPY buffers");
+    PQputCopyEnd(conn, "initialization failed");
+    free(result->buf[0]); free(result->buf[1]); free(result);
+    return NULL;
+  }
+  memcpy(result->buf[0], MEOS_COPY_HEADER, sizeof(MEOS_COPY_HEADER));
+  result->len[0] = sizeof(MEOS_COPY_HEADER);
+  return result;
+}
+
+/**
+ * @brief Add a null field to the current row of a COPY
+ * @return On error return false
+ */
+bool
+meos_copy_put_null(MeosCopy *copy)
+{
+  if (! meos_copy_field(copy, -1))
+    return false;
+  return meos_copy_field_end(copy);
+}
+
+/**
+ * @brief Add a boolean field to the current row of a COPY
+ * @return On error return false
+ */
+bool
+meos_copy_put_bool(MeosCopy *copy, bool value)
+{
+  char *ptr = meos_copy_field(copy, 1);
+  if (! ptr)
+    return false;
+  ptr[0] = value ? 1 : 0;
+  return meos_copy_field_end(copy);
+}
+
+/**
+ * @brief Add an integer field to the current row of a COPY
+ * @return On error return false
+ */
+bool
+meos_copy_put_int4(MeosCopy *copy, int32_t value)
+{
+  char *ptr = meos_copy_field(copy, 4);
+  if (! ptr)
+    return false;
+  meos_copy_write_uint(ptr, (uint64_t) (uint32_t) value, 4);
+  return meos_copy_field_end(copy);
+}
+
+/**
+ * @brief Add a big integer field to the current row of a COPY
+ * @return On error return false
+ */
+bool
+meos_copy_put_int8(MeosCopy *copy, int64_t value)
+{
+  char *ptr = meos_copy_field(copy, 8);
+  if (! ptr)
+    return false;
+  meos_copy_write_uint(ptr, (uint64_t) value, 8);
+  return meos_copy_field_end(copy);
+}
+
+/**
+ * @brief Add a float field to the current row of a COPY
+ * @return On error return false
+ */
+bool
+meos_copy_put_float8(MeosCopy *copy, double value)
+{
+  char *ptr = meos_copy_field(copy, 8);
+  if (! ptr)
+    return false;
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(double));
+  meos_copy_write_uint(ptr, bits, 8);
+  return meos_copy_field_end(copy);
+}
+
+/**
+ * @brief Add a text field to the current row of a COPY
+ * @return On error return false
+ */
+bool
+meos_copy_put_text(MeosCopy *copy, const char *value)
+{
+  if (! value)
+    return meos_copy_put_null(copy);
+  size_t len = strlen(value);
+  char *ptr = meos_copy_field(copy, (int32_t) len);
+  if (! ptr)
+    return false;
+  memcpy(ptr, value, len);
+  return meos_copy_field_end(copy);
+}
+
+/**
+ * @brief Add a temporal field to the current row of a COPY
+ * @return On error return false
+ */
+bool
+meos_copy_put_temporal(MeosCopy *copy, const Temporal *temp)
+{
+  if (! temp)
+    return meos_copy_put_null(copy);
+  if (! copy || copy->failed)
+    return false;
+  size_t size;
+  uint8_t *wkb = temporal_as_wkb(temp, WKB_EXTENDED | WKB_NDR, &size);
+  if (! wkb)
+    return false;
+  char *ptr = meos_copy_field(copy, (int32_t) size);
+  if (ptr)
+    memcpy(ptr, wkb, size);
+  free(wkb);
+  if (! ptr)
+    return false;
+  return meos_copy_field_end(copy);
+}
+
+/**
+ * @brief Finish a COPY and free its resources
+ * @details If there was an error during the COPY, the COPY is aborted
+ * @return Number of rows copied, on error return -1
+ */
+int64_t
+meos_copy_end(MeosCopy *copy)
+{
+  if (! copy)
+    return -1;
+  PGconn *conn = copy->conn;
+  bool ok = ! copy->failed;
+  if (ok && copy->field != 0)
+  {
+    meos_error(ERROR, MEOS_ERR_INVALID_ARG_VALUE,
+      "The last row of the COPY is incomplete");
+    ok = false;
+  }
+  /* Send the remaining data followed by the trailer */
+  char *ptr = ok ? meos_copy_reserve(copy, 2) : NULL;
+  if (ptr)
+  {
+    meos_copy_write_uint(ptr, 0xFFFF, 2);
+    ok = meos_copy_send(copy);
+    if (ok)
+    {
+      copy->pending = true;
+      copy->cur = 1 - copy->cur;
+      ok = meos_copy_send(copy);
+    }
+  }
+  else
+    ok = false;
+  /* Terminate the COPY, aborting it on error */
+  int rc;
+  while ((rc = PQputCopyEnd(conn, ok ? NULL : "aborted by the client")) == 0)
+  {
+    if (! meos_copy_wait(copy))
+      break;
+  }
+  while (rc == 1 && (rc = PQflush(conn)) == 1)
+  {
+    if (! meos_copy_wait(copy))
+      break;
+  }
+  PQsetnonblocking(conn, 0);
+  int64_t result = ok ? copy->nrows : -1;
+  PGresult *res;
+  while ((res = PQgetResult(conn)) != NULL)
+  {
+    if (PQresultStatus(res) != PGRES_COMMAND_OK)
+    {
+      if (ok)
+        meos_error(ERROR, MEOS_ERR_INTERNAL_ERROR, "COPY failed: %s",
+          PQerrorMessage(conn));
+      result = -1;
+    }
+    PQclear(res);
+  }
+  free(copy->buf[0]); free(copy->buf[1]); free(copy);
+  return result;
+}
+
+/*****************************************************************************/
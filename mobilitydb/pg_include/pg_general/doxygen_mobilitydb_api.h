@@ -274,6 +274,10 @@
  * @ingroup mobilitydb_temporal_analytics
  * @brief Similarity functions for temporal types
  *
+ * @defgroup mobilitydb_temporal_analytics_cluster Clustering functions
+ * @ingroup mobilitydb_temporal_analytics
+ * @brief Clustering functions for temporal types
+ *
  * @defgroup mobilitydb_temporal_analytics_tile Tile functions
  * @ingroup mobilitydb_temporal_analytics
  * @brief Tile functions for temporal types
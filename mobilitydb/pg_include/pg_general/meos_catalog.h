@@ -42,8 +42,13 @@
 
 /*****************************************************************************/
 
+/* Maximum number of databases whose Oid caches are kept in shared memory */
+extern int MOBDB_OID_CACHE_DATABASES;
+
 /* MobilityDB functions */
 
+extern void oid_cache_init(void);
+
 extern Oid type_oid(meosType t);
 extern Oid oper_oid(meosOper op, meosType lt, meosType rt);
 extern meosType oid_type(Oid typid);
@@ -58,6 +58,8 @@
 extern void span_compute_stats_generic(VacAttrStats *stats, int non_null_cnt,
   int *slot_idx, SpanBound *lowers, SpanBound *uppers, float8 *lengths,
   bool valuedim);
+extern void set_compute_mcelem(VacAttrStats *stats, int non_null_cnt,
+  int slot_idx, Datum *elems, int nelems, meosType basetype);
 extern Datum set_analyze(FunctionCallInfo fcinfo,
   void (*func)(VacAttrStats *, AnalyzeAttrFetchFunc, int, double));
 
@@ -36,9 +36,11 @@
 
 /* PostgreSQL */
 #include <postgres.h>
+#include <fmgr.h>
 #include <access/stratnum.h>
 /* MEOS */
 #include <meos.h>
+#include "general/meos_catalog.h"
 
 /*****************************************************************************/
 
@@ -49,6 +51,12 @@ extern bool span_index_consistent_leaf(const Span *key, const Span *query,
 extern bool span_gist_consistent(const Span *key, const Span *query,
   StrategyNumber strategy);
 extern bool span_index_recheck(StrategyNumber strategy);
+extern bool span_index_get_span(Datum value, meosType type, Span *result);
+
+extern uint64 bbox_sort_hilbert_key(const double *coords, int ndims);
+extern Datum bbox_gist_sortsupport(FunctionCallInfo fcinfo,
+  uint64 (*sort_key)(Datum));
+extern double span_center_double(const Span *s);
 
 #endif
 
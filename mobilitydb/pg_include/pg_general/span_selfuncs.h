@@ -36,6 +36,7 @@
 
 /* PostgreSQL */
 #include <postgres.h>
+#include <utils/lsyscache.h>
 #include <utils/selfuncs.h>
 /* MEOS */
 #include <meos.h>
@@ -48,6 +49,8 @@ extern float8 span_joinsel_default(meosOper oper);
 
 extern void span_const_to_span(Node *other, Span *span);
 
+extern float8 set_mcelem_freq(Datum value, const AttStatsSlot *sslot,
+  meosType basetype);
 extern double span_sel_hist(VariableStatData *vardata, const Span *constval,
   meosOper oper, bool value);
 extern float8 span_sel(PlannerInfo *root, Oid operid, List *args,
@@ -190,6 +190,13 @@ extern bool ensure_not_empty_array(ArrayType *array);
 
 extern Temporal *temporal_slice(Datum tempdatum);
 
+/**
+ * @brief Fetch only the header and the bounding box of a temporal argument
+ * @note To be used by the functions that only read the bounding box, the
+ * result must be freed with PG_FREE_IF_COPY
+ */
+#define PG_GETARG_TEMPORAL_SLICE(X) temporal_slice(PG_GETARG_DATUM(X))
+
 /*****************************************************************************/
 
 #endif /* __PG_TEMPORAL_H__ */
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @brief Generic functions for BRIN indexes summarizing bounding boxes
+ */
+
+#ifndef __TEMPORAL_BRIN_H__
+#define __TEMPORAL_BRIN_H__
+
+/* PostgreSQL */
+#include <postgres.h>
+#include <fmgr.h>
+#include <access/stratnum.h>
+/* MEOS */
+#include <meos.h>
+#include "general/meos_catalog.h"
+
+/*****************************************************************************/
+
+/* The following functions are also called by tpoint_brin.c */
+extern Datum bbox_brin_opcinfo(meosType bboxtype);
+extern Datum bbox_brin_add_value(FunctionCallInfo fcinfo, meosType bboxtype,
+  void (*set_bbox)(Datum, void *), void (*bbox_adjust)(void *, void *));
+extern Datum bbox_brin_consistent(FunctionCallInfo fcinfo, meosType bboxtype,
+  bool (*get_query)(Datum, meosType, void *),
+  bool (*consistent)(const void *, const void *, StrategyNumber));
+extern Datum bbox_brin_union(FunctionCallInfo fcinfo, meosType bboxtype,
+  void (*bbox_adjust)(void *, void *));
+
+/*****************************************************************************/
+
+#endif /* __TEMPORAL_BRIN_H__ */
@@ -55,6 +55,7 @@ typedef struct
 {
   int  entriesCount;  /**< total number of entries being split */
   bboxunion boundingBox;  /**< minimum bounding box across all entries */
+  double width;      /**< mean width of the entries along the current axis */
   /** Information about currently selected split follows */
   bool first;        /**< true if no split was selected yet */
   double leftUpper;  /**< upper bound of left interval */
@@ -82,6 +83,16 @@ extern Datum bbox_gist_picksplit(FunctionCallInfo fcinfo, meosType bboxtype,
 /* The following functions are also called by tnumber_spgist.c */
 extern bool tbox_index_consistent_leaf(const TBox *key, const TBox *query,
   StrategyNumber strategy);
+extern double tbox_index_distance(const TBox *key, const TBox *query);
+
+/* The following functions are also called by temporal_brin.c */
+extern bool tnumber_gist_consistent(const TBox *key, const TBox *query,
+  StrategyNumber strategy);
+extern bool tnumber_index_get_tbox(Datum value, meosType type, TBox *result);
+extern void tbox_adjust(void *bbox1, void *bbox2);
+
+/* The following functions are also called by temporal_index_stats.c */
+extern double tbox_size(const TBox *box);
 
 /*****************************************************************************/
 
@@ -110,6 +110,9 @@ typedef struct ND_STATS_T
     float4 value[1];
 } ND_STATS;
 
+/* Number of cells on each side of the joint space-time histogram */
+extern int MOBDB_SPACETIME_HISTOGRAM_SIZE;
+
 extern int nd_box_init(ND_BOX *a);
 extern int nd_box_overlap(const ND_STATS *nd_stats, const ND_BOX *nd_box, ND_IBOX *nd_ibox);
 extern int nd_box_intersects(const ND_BOX *a, const ND_BOX *b, int ndims);
@@ -39,6 +39,33 @@
 #include <access/stratnum.h>
 /* MEOS */
 #include <meos.h>
+#include "general/meos_catalog.h"
+
+/*****************************************************************************/
+
+/**
+ * @brief Compressed spatiotemporal box used as key of the lossy GiST
+ * indexes for temporal points
+ *
+ * The coordinates are stored as floats and the timestamps as seconds since
+ * 2000-01-01, both rounded outward so that the key contains the original box.
+ * The SRID is not stored since it is constant for an indexed column.
+ */
+typedef struct
+{
+  float xmin;           /**< minimum x value */
+  float ymin;           /**< minimum y value */
+  float zmin;           /**< minimum z value */
+  float xmax;           /**< maximum x value */
+  float ymax;           /**< maximum y value */
+  float zmax;           /**< maximum z value */
+  int32 tmin;           /**< minimum time value in seconds */
+  int32 tmax;           /**< maximum time value in seconds */
+  int16 flags;          /**< flags */
+} STBox4;
+
+#define DatumGetSTbox4P(X)    ((STBox4 *) DatumGetPointer(X))
+#define STbox4PGetDatum(X)    PointerGetDatum(X)
 
 /*****************************************************************************/
 
@@ -47,6 +74,16 @@ extern bool tpoint_index_recheck(StrategyNumber strategy);
 extern bool stbox_index_consistent_leaf(const STBox *key, const STBox *query,
   StrategyNumber strategy);
 
+/* The following functions are also called by tpoint_brin.c */
+extern bool stbox_gist_consistent(const STBox *key, const STBox *query,
+  StrategyNumber strategy);
+extern bool tspatial_index_get_stbox(Datum value, meosType type,
+  STBox *result);
+extern void stbox_adjust(void *bbox1, void *bbox2);
+
+/* The following functions are also called by temporal_index_stats.c */
+extern double stbox_size(const STBox *box);
+
 /*****************************************************************************/
 
 #endif
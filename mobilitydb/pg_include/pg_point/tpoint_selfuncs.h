@@ -76,8 +76,10 @@
 
 #define STATISTIC_KIND_ND 102
 #define STATISTIC_KIND_2D 103
+#define STATISTIC_KIND_NDT 104
 #define STATISTIC_SLOT_ND 0
 #define STATISTIC_SLOT_2D 1
+#define STATISTIC_SLOT_NDT 4
 
 /**
 * Default geometry selectivity factor
@@ -99,7 +101,10 @@ extern ND_STATS *pg_get_nd_stats(const Oid tableid, AttrNumber att_num,
 
 extern float8 geo_sel(VariableStatData *vardata, const STBox *box,
   meosOper oper);
-extern float8 geo_joinsel(const ND_STATS *s1, const ND_STATS *s2);
+extern float8 geo_time_sel(VariableStatData *vardata, const STBox *box,
+  meosOper oper);
+extern float8 geo_joinsel(const ND_STATS *s1, const ND_STATS *s2,
+  double expand);
 
 /*****************************************************************************/
 
@@ -796,6 +796,20 @@ CREATE FUNCTION set_union_transfn(internal, tstzset)
   AS 'MODULE_PATHNAME', 'Set_union_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+-- The function is not STRICT
+CREATE FUNCTION set_union_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Set_union_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION set_union_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Set_union_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION set_union_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Set_union_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION intset_union_finalfn(internal)
   RETURNS intset
   AS 'MODULE_PATHNAME', 'Set_union_finalfn'
@@ -824,74 +838,134 @@ CREATE FUNCTION textset_union_finalfn(internal)
 CREATE AGGREGATE setUnion(integer) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = intset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(bigint) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = bigintset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(float) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = floatset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(text) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = textset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(date) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = dateset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(timestamptz) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = tstzset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 
 CREATE AGGREGATE setUnion(intset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = intset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(bigintset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = bigintset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(floatset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = floatset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(textset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = textset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(dateset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = dateset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(tstzset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = tstzset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
   PARALLEL = safe
 );
 
@@ -1090,37 +1164,37 @@ CREATE FUNCTION set_cmp(tstzset, tstzset)
 CREATE OPERATOR = (
   LEFTARG = intset, RIGHTARG = intset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = bigintset, RIGHTARG = bigintset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = floatset, RIGHTARG = floatset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = textset, RIGHTARG = textset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = dateset, RIGHTARG = dateset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = tstzset, RIGHTARG = tstzset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 
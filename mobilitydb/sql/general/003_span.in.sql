@@ -853,31 +853,31 @@ CREATE FUNCTION span_cmp(tstzspan, tstzspan)
 CREATE OPERATOR = (
   PROCEDURE = span_eq,
   LEFTARG = intspan, RIGHTARG = intspan,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   PROCEDURE = span_eq,
   LEFTARG = bigintspan, RIGHTARG = bigintspan,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   PROCEDURE = span_eq,
   LEFTARG = floatspan, RIGHTARG = floatspan,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   PROCEDURE = span_eq,
   LEFTARG = datespan, RIGHTARG = datespan,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   PROCEDURE = span_eq,
   LEFTARG = tstzspan, RIGHTARG = tstzspan,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 
@@ -1014,31 +1014,31 @@ CREATE FUNCTION spanset_cmp(tstzspanset, tstzspanset)
 CREATE OPERATOR = (
   LEFTARG = intspanset, RIGHTARG = intspanset,
   PROCEDURE = spanset_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = bigintspanset, RIGHTARG = bigintspanset,
   PROCEDURE = spanset_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = floatspanset, RIGHTARG = floatspanset,
   PROCEDURE = spanset_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = datespanset, RIGHTARG = datespanset,
   PROCEDURE = spanset_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = tstzspanset, RIGHTARG = tstzspanset,
   PROCEDURE = spanset_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 
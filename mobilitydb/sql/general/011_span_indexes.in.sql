@@ -64,6 +64,12 @@ CREATE FUNCTION span_gist_fetch(internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'Span_gist_fetch'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+CREATE FUNCTION span_gist_sortsupport(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Span_gist_sortsupport'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
 
 /******************************************************************************/
 
@@ -111,6 +117,9 @@ CREATE OPERATOR CLASS intspan_rtree_ops
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(intspan, intspan, internal),
   FUNCTION  8  span_gist_distance(internal, intspan, smallint, oid, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  span_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  9  span_gist_fetch(internal);
 
 /******************************************************************************/
@@ -174,6 +183,9 @@ CREATE OPERATOR CLASS bigintspan_rtree_ops
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(bigintspan, bigintspan, internal),
   FUNCTION  8  span_gist_distance(internal, bigintspan, smallint, oid, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  span_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  9  span_gist_fetch(internal);
 
 /******************************************************************************/
@@ -237,6 +249,9 @@ CREATE OPERATOR CLASS floatspan_rtree_ops
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(floatspan, floatspan, internal),
   FUNCTION  8  span_gist_distance(internal, floatspan, smallint, oid, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  span_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  9  span_gist_fetch(internal);
 
 /******************************************************************************/
@@ -300,6 +315,9 @@ CREATE OPERATOR CLASS datespan_rtree_ops
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(datespan, datespan, internal),
   FUNCTION  8  span_gist_distance(internal, datespan, smallint, oid, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  span_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  9  span_gist_fetch(internal);
 
 /******************************************************************************/
@@ -358,6 +376,9 @@ CREATE OPERATOR CLASS tstzspan_rtree_ops
   FUNCTION  5  span_gist_penalty(internal, internal, internal),
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(tstzspan, tstzspan, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  span_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  9  span_gist_fetch(internal);
 
 /******************************************************************************
@@ -304,6 +304,89 @@ CREATE OPERATOR CLASS tstzspanset_rtree_ops
   FUNCTION  6  span_gist_picksplit(internal, internal),
   FUNCTION  7  span_gist_same(tstzspan, tstzspan, internal);
 
+/******************************************************************************
+ * Multi-span R-tree GiST index for span sets
+ *
+ * The leaf entries store up to max_count spans computed by spans(), e.g.,
+ *   CREATE INDEX ON vessels USING gist(presence tstzspanset_mrtree_ops(max_count = 16));
+ ******************************************************************************/
+
+CREATE FUNCTION spanset_mgist_consistent(internal, tstzspanset, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Spanset_mgist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tstzspanset_mgist_union(internal, internal)
+  RETURNS tstzspan[]
+  AS 'MODULE_PATHNAME', 'Spanset_mgist_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spanset_mgist_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Spanset_mgist_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spanset_mgist_penalty(internal, internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Spanset_mgist_penalty'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spanset_mgist_picksplit(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Spanset_mgist_picksplit'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spanset_mgist_same(tstzspan[], tstzspan[], internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Spanset_mgist_same'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+CREATE FUNCTION spanset_mgist_options(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Spanset_mgist_options'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+
+CREATE OPERATOR CLASS tstzspanset_mrtree_ops
+  FOR TYPE tstzspanset USING gist AS
+  STORAGE tstzspan[],
+  -- overlaps
+  OPERATOR  3    && (tstzspanset, tstzspan),
+  OPERATOR  3    && (tstzspanset, tstzspanset),
+  -- contains
+  OPERATOR  7    @> (tstzspanset, timestamptz),
+  OPERATOR  7    @> (tstzspanset, tstzspan),
+  OPERATOR  7    @> (tstzspanset, tstzspanset),
+  -- contained by
+  OPERATOR  8    <@ (tstzspanset, tstzspan),
+  OPERATOR  8    <@ (tstzspanset, tstzspanset),
+  -- adjacent
+  OPERATOR  17    -|- (tstzspanset, tstzspan),
+  OPERATOR  17    -|- (tstzspanset, tstzspanset),
+  -- equals
+  OPERATOR  18    = (tstzspanset, tstzspanset),
+  -- overlaps or before
+  OPERATOR  28    &<# (tstzspanset, timestamptz),
+  OPERATOR  28    &<# (tstzspanset, tstzspan),
+  OPERATOR  28    &<# (tstzspanset, tstzspanset),
+  -- strictly before
+  OPERATOR  29    <<# (tstzspanset, timestamptz),
+  OPERATOR  29    <<# (tstzspanset, tstzspan),
+  OPERATOR  29    <<# (tstzspanset, tstzspanset),
+  -- strictly after
+  OPERATOR  30    #>> (tstzspanset, timestamptz),
+  OPERATOR  30    #>> (tstzspanset, tstzspan),
+  OPERATOR  30    #>> (tstzspanset, tstzspanset),
+  -- overlaps or after
+  OPERATOR  31    #&> (tstzspanset, timestamptz),
+  OPERATOR  31    #&> (tstzspanset, tstzspan),
+  OPERATOR  31    #&> (tstzspanset, tstzspanset),
+  -- functions
+  FUNCTION  1  spanset_mgist_consistent(internal, tstzspanset, smallint, oid, internal),
+  FUNCTION  2  tstzspanset_mgist_union(internal, internal),
+  FUNCTION  3  spanset_mgist_compress(internal),
+  FUNCTION  5  spanset_mgist_penalty(internal, internal, internal),
+  FUNCTION  6  spanset_mgist_picksplit(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  10  spanset_mgist_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  7  spanset_mgist_same(tstzspan[], tstzspan[], internal);
+
 /******************************************************************************
  * Quad-tree SP-GiST indexes
  ******************************************************************************/
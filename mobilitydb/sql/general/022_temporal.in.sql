@@ -37,6 +37,19 @@ CREATE TYPE tint;
 CREATE TYPE tfloat;
 CREATE TYPE ttext;
 
+/*****************************************************************************
+ * Planner Support Functions
+ *****************************************************************************/
+
+CREATE FUNCTION tnumber_supportfn(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_supportfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_overlaps_supportfn(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_overlaps_supportfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * Utility functions
  *****************************************************************************/
@@ -51,6 +64,22 @@ CREATE FUNCTION mobilitydb_full_version()
   AS 'MODULE_PATHNAME', 'Mobilitydb_full_version'
   LANGUAGE C IMMUTABLE;
 
+/******************************************************************************
+ * Runtime statistics
+ ******************************************************************************/
+
+CREATE FUNCTION mobilitydb_stats(OUT name text, OUT value bigint)
+  RETURNS SETOF record
+  AS 'MODULE_PATHNAME', 'Mobilitydb_stats'
+  LANGUAGE C VOLATILE STRICT;
+CREATE FUNCTION mobilitydb_stats_reset()
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Mobilitydb_stats_reset'
+  LANGUAGE C VOLATILE STRICT;
+
+CREATE VIEW mobilitydb_stat_counters AS
+  SELECT name, value FROM mobilitydb_stats();
+
 /******************************************************************************
  * Input/Output
  ******************************************************************************/
@@ -752,10 +781,12 @@ CREATE FUNCTION segments(tbool)
 CREATE FUNCTION segments(tint)
   RETURNS tint[]
   AS 'MODULE_PATHNAME', 'Temporal_segments'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION segments(tfloat)
   RETURNS tfloat[]
   AS 'MODULE_PATHNAME', 'Temporal_segments'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION segments(ttext)
   RETURNS ttext[]
@@ -986,10 +1017,12 @@ CREATE TYPE text_tstzspanset AS (
 CREATE FUNCTION unnest(tint)
   RETURNS SETOF int_tstzspanset
   AS 'MODULE_PATHNAME', 'Temporal_unnest'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION unnest(tfloat)
   RETURNS SETOF float_tstzspanset
   AS 'MODULE_PATHNAME', 'Temporal_unnest'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION unnest(ttext)
   RETURNS SETOF text_tstzspanset
@@ -1568,6 +1601,27 @@ CREATE FUNCTION minusTime(ttext, tstzspanset)
   AS 'MODULE_PATHNAME', 'Temporal_minus_tstzspanset'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*****************************************************************************
+ * Compression functions
+ *****************************************************************************/
+
+CREATE FUNCTION compress(tbool)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'Temporal_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION compress(tint)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION compress(tfloat)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION compress(ttext)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Temporal_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * Modification Functions
  *****************************************************************************/
@@ -1768,7 +1822,7 @@ CREATE OPERATOR <= (
 CREATE OPERATOR = (
   LEFTARG = tbool, RIGHTARG = tbool,
   PROCEDURE = temporal_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR <> (
@@ -1845,7 +1899,7 @@ CREATE OPERATOR <= (
 CREATE OPERATOR = (
   LEFTARG = tint, RIGHTARG = tint,
   PROCEDURE = temporal_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR <> (
@@ -1922,7 +1976,7 @@ CREATE OPERATOR <= (
 CREATE OPERATOR = (
   LEFTARG = tfloat, RIGHTARG = tfloat,
   PROCEDURE = temporal_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR <> (
@@ -1999,7 +2053,7 @@ CREATE OPERATOR <= (
 CREATE OPERATOR = (
   LEFTARG = ttext, RIGHTARG = ttext,
   PROCEDURE = temporal_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR <> (
@@ -2049,21 +2103,42 @@ CREATE FUNCTION temporal_hash(ttext)
   AS 'MODULE_PATHNAME', 'Temporal_hash'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION temporal_hash_extended(tbool, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_hash_extended(tint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_hash_extended(tfloat, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_hash_extended(ttext, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR CLASS tbool_hash_ops
   DEFAULT FOR TYPE tbool USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tbool);
+    FUNCTION    1   temporal_hash(tbool),
+    FUNCTION    2   temporal_hash_extended(tbool, bigint);
 CREATE OPERATOR CLASS tint_hash_ops
   DEFAULT FOR TYPE tint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tint);
+    FUNCTION    1   temporal_hash(tint),
+    FUNCTION    2   temporal_hash_extended(tint, bigint);
 CREATE OPERATOR CLASS tfloat_hash_ops
   DEFAULT FOR TYPE tfloat USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tfloat);
+    FUNCTION    1   temporal_hash(tfloat),
+    FUNCTION    2   temporal_hash_extended(tfloat, bigint);
 CREATE OPERATOR CLASS ttext_hash_ops
   DEFAULT FOR TYPE ttext USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(ttext);
+    FUNCTION    1   temporal_hash(ttext),
+    FUNCTION    2   temporal_hash_extended(ttext, bigint);
 
 /******************************************************************************/
@@ -150,6 +150,23 @@ CREATE FUNCTION asMFJSON(temp ttext, options int4 DEFAULT 0,
   AS 'MODULE_PATHNAME', 'Temporal_as_mfjson'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION asMFJSONChunks(temp tbool, options int4 DEFAULT 0)
+  RETURNS SETOF text
+  AS 'MODULE_PATHNAME', 'Temporal_as_mfjson_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asMFJSONChunks(temp tint, options int4 DEFAULT 0)
+  RETURNS SETOF text
+  AS 'MODULE_PATHNAME', 'Temporal_as_mfjson_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asMFJSONChunks(temp tfloat, options int4 DEFAULT 0, maxdecimaldigits int4 DEFAULT 15)
+  RETURNS SETOF text
+  AS 'MODULE_PATHNAME', 'Temporal_as_mfjson_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asMFJSONChunks(temp ttext, options int4 DEFAULT 0)
+  RETURNS SETOF text
+  AS 'MODULE_PATHNAME', 'Temporal_as_mfjson_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
 
 CREATE FUNCTION asBinary(tbool, endianenconding text DEFAULT '')
@@ -169,6 +186,61 @@ CREATE FUNCTION asBinary(ttext, endianenconding text DEFAULT '')
   AS 'MODULE_PATHNAME', 'Temporal_as_wkb'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION asBinaryChunks(tbool, endianenconding text DEFAULT '')
+  RETURNS SETOF bytea
+  AS 'MODULE_PATHNAME', 'Temporal_as_wkb_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asBinaryChunks(tint, endianenconding text DEFAULT '')
+  RETURNS SETOF bytea
+  AS 'MODULE_PATHNAME', 'Temporal_as_wkb_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asBinaryChunks(tfloat, endianenconding text DEFAULT '')
+  RETURNS SETOF bytea
+  AS 'MODULE_PATHNAME', 'Temporal_as_wkb_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asBinaryChunks(ttext, endianenconding text DEFAULT '')
+  RETURNS SETOF bytea
+  AS 'MODULE_PATHNAME', 'Temporal_as_wkb_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION deltaSince(tbool, timestamptz,
+    endianenconding text DEFAULT '')
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Temporal_delta_since'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION deltaSince(tint, timestamptz,
+    endianenconding text DEFAULT '')
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Temporal_delta_since'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION deltaSince(tfloat, timestamptz,
+    endianenconding text DEFAULT '')
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Temporal_delta_since'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION deltaSince(ttext, timestamptz,
+    endianenconding text DEFAULT '')
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Temporal_delta_since'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION applyDelta(tbool, bytea)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'Temporal_apply_delta'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION applyDelta(tint, bytea)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_apply_delta'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION applyDelta(tfloat, bytea)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_apply_delta'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION applyDelta(ttext, bytea)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Temporal_apply_delta'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION asHexWKB(tbool, endianenconding text DEFAULT '')
   RETURNS text
   AS 'MODULE_PATHNAME', 'Temporal_as_hexwkb'
@@ -68,6 +68,17 @@ CREATE FUNCTION valueBucket("value" float, size float,
   AS 'MODULE_PATHNAME', 'Number_bucket'
   LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
 
+CREATE FUNCTION valueBucket("value" integer[], size integer,
+  origin integer DEFAULT 0)
+  RETURNS integer[]
+  AS 'MODULE_PATHNAME', 'Numberarr_bucket'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION valueBucket("value" float[], size float,
+  origin float DEFAULT '0.0')
+  RETURNS float[]
+  AS 'MODULE_PATHNAME', 'Numberarr_bucket'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+
 CREATE FUNCTION spanBucket("value" integer, size integer,
   origin integer DEFAULT 0)
   RETURNS intspan
@@ -97,6 +108,11 @@ CREATE FUNCTION timeBucket("time" timestamptz, duration interval,
   RETURNS timestamptz
   AS 'MODULE_PATHNAME', 'Timestamptz_bucket'
   LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION timeBucket("time" timestamptz[], duration interval,
+  origin timestamptz DEFAULT '2000-01-03')
+  RETURNS timestamptz[]
+  AS 'MODULE_PATHNAME', 'Timestamptzarr_bucket'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
 
 -- If an interval is given as the third argument, the bucket alignment is offset by the interval.
 -- CREATE FUNCTION timeBucket(ts timestamptz, size interval, "offset" interval)
@@ -221,6 +237,30 @@ CREATE FUNCTION valueTimeSplit(tfloat, size float, duration interval,
   AS 'MODULE_PATHNAME', 'Tnumber_value_time_split'
   LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
 
-/*****************************************************************************/
+/*****************************************************************************
+ * Bucketed aggregation functions
+ *****************************************************************************/
 
+CREATE FUNCTION bucketTwAvg(tint, duration interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_bucket_twavg'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION bucketTwAvg(tfloat, duration interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_bucket_twavg'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+
+CREATE FUNCTION bucketMax(tint, duration interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_bucket_max'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION bucketMax(tfloat, duration interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_bucket_max'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
 
+/*****************************************************************************/
@@ -41,6 +41,7 @@
 CREATE FUNCTION tnumber_add(integer, tint)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Add_number_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR + (
@@ -56,6 +57,7 @@ CREATE OPERATOR + (
 CREATE FUNCTION tnumber_add(float, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Add_number_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR + (
@@ -70,10 +72,12 @@ CREATE OPERATOR + (
 CREATE FUNCTION tnumber_add(tint, integer)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Add_tnumber_number'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tnumber_add(tint, tint)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Add_tnumber_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR + (
@@ -93,10 +97,12 @@ CREATE OPERATOR + (
 CREATE FUNCTION tnumber_add(tfloat, float)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Add_tnumber_number'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tnumber_add(tfloat, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Add_tnumber_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR + (
@@ -119,6 +125,7 @@ CREATE OPERATOR + (
 CREATE FUNCTION tnumber_sub(integer, tint)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Sub_number_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR - (
@@ -133,10 +140,12 @@ CREATE OPERATOR - (
 CREATE FUNCTION tnumber_sub(tint, integer)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Sub_tnumber_number'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tnumber_sub(tint, tint)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Sub_tnumber_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR - (
@@ -155,6 +164,7 @@ CREATE OPERATOR - (
 CREATE FUNCTION tnumber_sub(float, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Sub_number_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR - (
@@ -169,10 +179,12 @@ CREATE OPERATOR - (
 CREATE FUNCTION tnumber_sub(tfloat, float)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Sub_tnumber_number'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tnumber_sub(tfloat, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Sub_tnumber_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR - (
@@ -193,6 +205,7 @@ CREATE OPERATOR - (
 CREATE FUNCTION tnumber_mult(integer, tint)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Mult_number_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR * (
@@ -207,10 +220,12 @@ CREATE OPERATOR * (
 CREATE FUNCTION tnumber_mult(tint, integer)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Mult_tnumber_number'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tnumber_mult(tint, tint)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Mult_tnumber_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR * (
@@ -231,6 +246,7 @@ CREATE OPERATOR * (
 CREATE FUNCTION tnumber_mult(float, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Mult_number_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR * (
@@ -245,10 +261,12 @@ CREATE OPERATOR * (
 CREATE FUNCTION tnumber_mult(tfloat, float)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Mult_tnumber_number'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tnumber_mult(tfloat, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Mult_tnumber_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR * (
@@ -271,6 +289,7 @@ CREATE OPERATOR * (
 CREATE FUNCTION tnumber_div(integer, tint)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Div_number_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR / (
@@ -284,10 +303,12 @@ CREATE OPERATOR / (
 CREATE FUNCTION tnumber_div(tint, integer)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Div_tnumber_number'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tnumber_div(tint, tint)
   RETURNS tint
   AS 'MODULE_PATHNAME', 'Div_tnumber_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR / (
@@ -306,6 +327,7 @@ CREATE OPERATOR / (
 CREATE FUNCTION tnumber_div(float, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Div_number_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR / (
@@ -318,10 +340,12 @@ CREATE OPERATOR / (
 CREATE FUNCTION tnumber_div(tfloat, float)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Div_tnumber_number'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION tnumber_div(tfloat, tfloat)
   RETURNS tfloat
   AS 'MODULE_PATHNAME', 'Div_tnumber_tnumber'
+  SUPPORT tnumber_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR / (
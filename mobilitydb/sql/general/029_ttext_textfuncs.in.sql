@@ -81,4 +81,18 @@ CREATE FUNCTION initcap(ttext)
   AS 'MODULE_PATHNAME', 'Ttext_initcap'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/******************************************************************************
+ * Dictionary encoding
+ *****************************************************************************/
+
+CREATE FUNCTION dictEncode(ttext, textset)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Ttext_dict_encode'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION dictDecode(tint, textset)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Tint_dict_decode'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************/
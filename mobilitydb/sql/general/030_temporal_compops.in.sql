@@ -36,15 +36,6 @@
  * 3 parameters is enough
  */
 
-/*****************************************************************************
- * Index Support Functions
- *****************************************************************************/
-
-CREATE FUNCTION tnumber_supportfn(internal)
-  RETURNS internal
-  AS 'MODULE_PATHNAME', 'Tnumber_supportfn'
-  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
-
 /*****************************************************************************
  * Ever/Always Comparison Functions
  *****************************************************************************/
@@ -41,6 +41,46 @@ CREATE FUNCTION frechetDistance(tfloat, tfloat)
   RETURNS float
   AS 'MODULE_PATHNAME', 'Temporal_frechet_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistance(tint, tint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistance(tfloat, tfloat, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistanceWithin(tint, tint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistanceWithin(tfloat, tfloat, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistanceWithin(tint, tint, dist float, band integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistanceWithin(tfloat, tfloat, dist float, band integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetLowerBound(tint, tint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetLowerBound(tfloat, tfloat)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetLowerBound(tint, tint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetLowerBound(tfloat, tfloat, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION dynTimeWarpDistance(tint, tint)
   RETURNS float
@@ -50,6 +90,46 @@ CREATE FUNCTION dynTimeWarpDistance(tfloat, tfloat)
   RETURNS float
   AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistance(tint, tint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistance(tfloat, tfloat, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistanceWithin(tint, tint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistanceWithin(tfloat, tfloat, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistanceWithin(tint, tint, dist float, band integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistanceWithin(tfloat, tfloat, dist float, band integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpLowerBound(tint, tint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpLowerBound(tfloat, tfloat)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpLowerBound(tint, tint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpLowerBound(tfloat, tfloat, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION hausdorffDistance(tint, tint)
   RETURNS float
@@ -59,6 +139,14 @@ CREATE FUNCTION hausdorffDistance(tfloat, tfloat)
   RETURNS float
   AS 'MODULE_PATHNAME', 'Temporal_hausdorff_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hausdorffDistanceWithin(tint, tint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_hausdorff_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hausdorffDistanceWithin(tfloat, tfloat, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_hausdorff_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************/
 
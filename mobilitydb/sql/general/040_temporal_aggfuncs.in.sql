@@ -571,6 +571,497 @@ CREATE AGGREGATE merge(ttext) (
   PARALLEL = safe
 );
 
+/*****************************************************************************
+ * Approximate distinct count aggregate functions
+ *****************************************************************************/
+
+-- The count of distinct identifiers per time bucket is estimated with a
+-- HyperLogLog sketch
+
+CREATE FUNCTION tcount_distinct_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_finalfn(internal)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_finalfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Tcount_distinct_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tcount_distinct_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tbool, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tbool, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tint, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tint, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tfloat, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tfloat, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, ttext, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, ttext, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcountDistinct(bigint, tbool, interval) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, tbool, interval, timestamptz) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, tint, interval) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, tint, interval, timestamptz) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, tfloat, interval) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, tfloat, interval, timestamptz) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, ttext, interval) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, ttext, interval, timestamptz) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************
+ * Approximate count and average aggregate functions
+ *****************************************************************************/
+
+-- The input rows are expected to be a sample of the table with the given
+-- fraction, e.g., obtained with TABLESAMPLE BERNOULLI. The time of the values
+-- is set to the precision of the time buckets before the aggregation. The
+-- estimate and the half-width of its 95% confidence interval share the same
+-- transition function, so that they are computed from the same state
+
+CREATE FUNCTION tcount_approx_finalfn(internal)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcount_approx_error_finalfn(internal)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_error_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tavg_approx_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_tavg_approx_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_approx_finalfn(internal)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_tavg_approx_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tavg_approx_error_finalfn(internal)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_tavg_approx_error_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tcount_approx_transfn(internal, tbool, float, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_approx_transfn(internal, tbool, float, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_approx_transfn(internal, tint, float, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_approx_transfn(internal, tint, float, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_approx_transfn(internal, tfloat, float, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_approx_transfn(internal, tfloat, float, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_approx_transfn(internal, ttext, float, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_approx_transfn(internal, ttext, float, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_approx_transfn(internal, tint, float, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_tavg_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_approx_transfn(internal, tint, float, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_tavg_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_approx_transfn(internal, tfloat, float, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_tavg_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tavg_approx_transfn(internal, tfloat, float, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_tavg_approx_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcountApprox(tbool, float, interval) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApproxError(tbool, float, interval) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(tbool, float, interval, timestamptz) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApproxError(tbool, float, interval, timestamptz) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(tint, float, interval) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApproxError(tint, float, interval) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(tint, float, interval, timestamptz) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApproxError(tint, float, interval, timestamptz) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(tfloat, float, interval) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApproxError(tfloat, float, interval) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(tfloat, float, interval, timestamptz) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApproxError(tfloat, float, interval, timestamptz) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(ttext, float, interval) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApproxError(ttext, float, interval) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApprox(ttext, float, interval, timestamptz) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountApproxError(ttext, float, interval, timestamptz) (
+  SFUNC = tcount_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavgApprox(tint, float, interval) (
+  SFUNC = tavg_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tavg_approx_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tavg_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavgApproxError(tint, float, interval) (
+  SFUNC = tavg_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tavg_approx_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tavg_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavgApprox(tint, float, interval, timestamptz) (
+  SFUNC = tavg_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tavg_approx_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tavg_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavgApproxError(tint, float, interval, timestamptz) (
+  SFUNC = tavg_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tavg_approx_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tavg_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavgApprox(tfloat, float, interval) (
+  SFUNC = tavg_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tavg_approx_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tavg_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavgApproxError(tfloat, float, interval) (
+  SFUNC = tavg_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tavg_approx_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tavg_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavgApprox(tfloat, float, interval, timestamptz) (
+  SFUNC = tavg_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tavg_approx_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tavg_approx_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tavgApproxError(tfloat, float, interval, timestamptz) (
+  SFUNC = tavg_approx_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tavg_approx_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tavg_approx_error_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
 /*****************************************************************************
  * Append aggregate functions
  *****************************************************************************/
@@ -632,31 +1123,63 @@ CREATE FUNCTION temporal_append_finalfn(ttext)
   AS 'MODULE_PATHNAME', 'Temporal_append_finalfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+-- The function is not STRICT
+CREATE FUNCTION temporal_app_tinst_combinefn(tbool, tbool)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'Temporal_app_tinst_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION temporal_app_tinst_combinefn(tint, tint)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_app_tinst_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION temporal_app_tinst_combinefn(tfloat, tfloat)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_app_tinst_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION temporal_app_tinst_combinefn(ttext, ttext)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Temporal_app_tinst_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 CREATE AGGREGATE appendInstant(tbool) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tbool,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tinst_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 CREATE AGGREGATE appendInstant(tint) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tint,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tinst_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 CREATE AGGREGATE appendInstant(tfloat) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tfloat,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tinst_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 CREATE AGGREGATE appendInstant(ttext) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = ttext,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tinst_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 
+-- The variants with gaps have no combine function, since the gaps would have
+-- to be reapplied to the merged partial states
 CREATE AGGREGATE appendInstant(tbool, interval) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tbool,
@@ -702,29 +1225,227 @@ CREATE FUNCTION temporal_app_tseq_transfn(ttext, ttext)
   AS 'MODULE_PATHNAME', 'Temporal_app_tseq_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+-- The function is not STRICT
+CREATE FUNCTION temporal_app_tseq_combinefn(tbool, tbool)
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'Temporal_app_tseq_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION temporal_app_tseq_combinefn(tint, tint)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_app_tseq_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION temporal_app_tseq_combinefn(tfloat, tfloat)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_app_tseq_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION temporal_app_tseq_combinefn(ttext, ttext)
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Temporal_app_tseq_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 CREATE AGGREGATE appendSequence(tbool) (
   SFUNC = temporal_app_tseq_transfn,
   STYPE = tbool,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tseq_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 CREATE AGGREGATE appendSequence(tint) (
   SFUNC = temporal_app_tseq_transfn,
   STYPE = tint,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tseq_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 CREATE AGGREGATE appendSequence(tfloat) (
   SFUNC = temporal_app_tseq_transfn,
   STYPE = tfloat,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tseq_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 CREATE AGGREGATE appendSequence(ttext) (
   SFUNC = temporal_app_tseq_transfn,
   STYPE = ttext,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tseq_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Persisted aggregate states
+ *
+ * The state of the tCount and tCentroid aggregates can be kept in a table as
+ * a taggstate value, merged with the state of newer values, and expired and
+ * finalized on demand, e.g.,
+ *   UPDATE dashboard SET state = taggExpire(taggMerge(state,
+ *     (SELECT tcountState(trip) FROM trips WHERE inserted > dashboard.since)),
+ *     now() - interval '1 day');
+ *   SELECT tcountFinal(state) FROM dashboard;
+ *****************************************************************************/
+
+CREATE TYPE taggstate;
+
+CREATE FUNCTION taggstate_in(cstring)
+  RETURNS taggstate
+  AS 'MODULE_PATHNAME', 'Taggstate_in'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION taggstate_out(taggstate)
+  RETURNS cstring
+  AS 'MODULE_PATHNAME', 'Taggstate_out'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION taggstate_recv(internal)
+  RETURNS taggstate
+  AS 'MODULE_PATHNAME', 'Taggstate_recv'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION taggstate_send(taggstate)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Taggstate_send'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE taggstate (
+  internallength = variable,
+  input = taggstate_in,
+  output = taggstate_out,
+  receive = taggstate_recv,
+  send = taggstate_send,
+  storage = extended,
+  alignment = double
+);
+
+CREATE FUNCTION tcount_state_finalfn(internal)
+  RETURNS taggstate
+  AS 'MODULE_PATHNAME', 'Tcount_state_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE tcountState(timestamptz) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE AGGREGATE tcountState(tstzset) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE AGGREGATE tcountState(tstzspan) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE AGGREGATE tcountState(tstzspanset) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE AGGREGATE tcountState(tbool) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE AGGREGATE tcountState(tint) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE AGGREGATE tcountState(tfloat) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE AGGREGATE tcountState(ttext) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE FUNCTION taggMerge(taggstate, taggstate)
+  RETURNS taggstate
+  AS 'MODULE_PATHNAME', 'Taggstate_merge'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE taggMerge(taggstate) (
+  SFUNC = taggMerge,
+  STYPE = taggstate,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = taggMerge,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  PARALLEL = SAFE
+);
+
+CREATE FUNCTION taggExpire(taggstate, timestamptz)
+  RETURNS taggstate
+  AS 'MODULE_PATHNAME', 'Taggstate_expire'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION tcountFinal(taggstate)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Taggstate_tcount'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
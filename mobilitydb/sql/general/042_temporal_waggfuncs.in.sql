@@ -189,3 +189,50 @@ CREATE AGGREGATE wavg(tfloat, interval) (
 );
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Sliding window functions for a single temporal number
+ *****************************************************************************/
+
+CREATE FUNCTION windowMin(tint, interval)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Tnumber_wmin'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowMax(tint, interval)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Tnumber_wmax'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowSum(tint, interval)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Tnumber_wsum'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowCount(tint, interval)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Tnumber_wcount'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowAvg(tint, interval)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_wavg'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowMin(tfloat, interval)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_wmin'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowMax(tfloat, interval)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_wmax'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowSum(tfloat, interval)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_wsum'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowCount(tfloat, interval)
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Tnumber_wcount'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION windowAvg(tfloat, interval)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tnumber_wavg'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
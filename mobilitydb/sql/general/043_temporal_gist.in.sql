@@ -58,6 +58,16 @@ CREATE FUNCTION tbox_gist_distance(internal, tbox, smallint, oid, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'Tbox_gist_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tbox_gist_fetch(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tbox_gist_fetch'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+CREATE FUNCTION tbox_gist_sortsupport(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Tbox_gist_sortsupport'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
 
 /******************************************************************************/
 
@@ -137,6 +147,10 @@ CREATE OPERATOR CLASS tbox_rtree_ops
   OPERATOR  17    -|- (tbox, tbox),
   OPERATOR  17    -|- (tbox, tint),
   OPERATOR  17    -|- (tbox, tfloat),
+  -- nearest approach distance
+  OPERATOR  25    |=| (tbox, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tbox, tint) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tbox, tfloat) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tbox, tbox),
   OPERATOR  28    &<# (tbox, tint),
@@ -159,7 +173,11 @@ CREATE OPERATOR CLASS tbox_rtree_ops
   FUNCTION  5  tbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  tbox_gist_picksplit(internal, internal),
   FUNCTION  7  tbox_gist_same(tbox, tbox, internal),
-  FUNCTION  8  tbox_gist_distance(internal, tbox, smallint, oid, internal);
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  tbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  8  tbox_gist_distance(internal, tbox, smallint, oid, internal),
+  FUNCTION  9  tbox_gist_fetch(internal);
 
 /******************************************************************************/
 
@@ -199,6 +217,9 @@ CREATE OPERATOR CLASS tbool_rtree_ops
   FUNCTION  3  tbool_gist_compress(internal),
   FUNCTION  5  span_gist_penalty(internal, internal, internal),
   FUNCTION  6  span_gist_picksplit(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  span_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  7  span_gist_same(tstzspan, tstzspan, internal);
 
 /******************************************************************************/
@@ -249,6 +270,7 @@ CREATE OPERATOR CLASS tint_rtree_ops
   OPERATOR  17    -|- (tint, tint),
   -- nearest approach distance
   OPERATOR  25    |=| (tint, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tint, integer) FOR ORDER BY pg_catalog.float_ops,
   OPERATOR  25    |=| (tint, tint) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tint, tstzspan),
@@ -273,6 +295,9 @@ CREATE OPERATOR CLASS tint_rtree_ops
   FUNCTION  5  tbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  tbox_gist_picksplit(internal, internal),
   FUNCTION  7  tbox_gist_same(tbox, tbox, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  tbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  8  tbox_gist_distance(internal, tbox, smallint, oid, internal);
 
 /******************************************************************************/
@@ -323,6 +348,7 @@ CREATE OPERATOR CLASS tfloat_rtree_ops
   OPERATOR  17    -|- (tfloat, tfloat),
   -- nearest approach distance
   OPERATOR  25    |=| (tfloat, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tfloat, float) FOR ORDER BY pg_catalog.float_ops,
   OPERATOR  25    |=| (tfloat, tfloat) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tfloat, tstzspan),
@@ -347,8 +373,209 @@ CREATE OPERATOR CLASS tfloat_rtree_ops
   FUNCTION  5  tbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  tbox_gist_picksplit(internal, internal),
   FUNCTION  7  tbox_gist_same(tbox, tbox, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  tbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  8  tbox_gist_distance(internal, tbox, smallint, oid, internal);
 
+/******************************************************************************
+ * Multi-box R-tree GiST index for temporal numbers
+ *
+ * The leaf entries store up to max_count boxes computed by tboxes(), e.g.,
+ *   CREATE INDEX ON sensors USING gist(temp tfloat_mrtree_ops(max_count = 16));
+ ******************************************************************************/
+
+CREATE FUNCTION mgist_tint_consistent(internal, tint, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION mgist_tfloat_consistent(internal, tfloat, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_mgist_union(internal, internal)
+  RETURNS tbox[]
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_mgist_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_mgist_penalty(internal, internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_penalty'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_mgist_picksplit(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_picksplit'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_mgist_same(tbox[], tbox[], internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_same'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tnumber_mgist_distance(internal, tbox, smallint, oid, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+CREATE FUNCTION tnumber_mgist_options(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Tnumber_mgist_options'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+
+CREATE OPERATOR CLASS tint_mrtree_ops
+  FOR TYPE tint USING gist AS
+  STORAGE tbox[],
+  -- strictly left
+  OPERATOR  1    << (tint, intspan),
+  OPERATOR  1    << (tint, tbox),
+  OPERATOR  1    << (tint, tint),
+   -- overlaps or left
+  OPERATOR  2    &< (tint, intspan),
+  OPERATOR  2    &< (tint, tbox),
+  OPERATOR  2    &< (tint, tint),
+  -- overlaps
+  OPERATOR  3    && (tint, intspan),
+  OPERATOR  3    && (tint, tstzspan),
+  OPERATOR  3    && (tint, tbox),
+  OPERATOR  3    && (tint, tint),
+  -- overlaps or right
+  OPERATOR  4    &> (tint, intspan),
+  OPERATOR  4    &> (tint, tbox),
+  OPERATOR  4    &> (tint, tint),
+  -- strictly right
+  OPERATOR  5    >> (tint, intspan),
+  OPERATOR  5    >> (tint, tbox),
+  OPERATOR  5    >> (tint, tint),
+    -- same
+  OPERATOR  6    ~= (tint, intspan),
+  OPERATOR  6    ~= (tint, tstzspan),
+  OPERATOR  6    ~= (tint, tbox),
+  OPERATOR  6    ~= (tint, tint),
+  -- contains
+  OPERATOR  7    @> (tint, intspan),
+  OPERATOR  7    @> (tint, tstzspan),
+  OPERATOR  7    @> (tint, tbox),
+  OPERATOR  7    @> (tint, tint),
+  -- contained by
+  OPERATOR  8    <@ (tint, intspan),
+  OPERATOR  8    <@ (tint, tstzspan),
+  OPERATOR  8    <@ (tint, tbox),
+  OPERATOR  8    <@ (tint, tint),
+  -- adjacent
+  OPERATOR  17    -|- (tint, intspan),
+  OPERATOR  17    -|- (tint, tstzspan),
+  OPERATOR  17    -|- (tint, tbox),
+  OPERATOR  17    -|- (tint, tint),
+  -- nearest approach distance
+  OPERATOR  25    |=| (tint, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tint, integer) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tint, tint) FOR ORDER BY pg_catalog.float_ops,
+  -- overlaps or before
+  OPERATOR  28    &<# (tint, tstzspan),
+  OPERATOR  28    &<# (tint, tbox),
+  OPERATOR  28    &<# (tint, tint),
+  -- strictly before
+  OPERATOR  29    <<# (tint, tstzspan),
+  OPERATOR  29    <<# (tint, tbox),
+  OPERATOR  29    <<# (tint, tint),
+  -- strictly after
+  OPERATOR  30    #>> (tint, tstzspan),
+  OPERATOR  30    #>> (tint, tbox),
+  OPERATOR  30    #>> (tint, tint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tint, tstzspan),
+  OPERATOR  31    #&> (tint, tbox),
+  OPERATOR  31    #&> (tint, tint),
+  -- functions
+  FUNCTION  1  mgist_tint_consistent(internal, tint, smallint, oid, internal),
+  FUNCTION  2  tnumber_mgist_union(internal, internal),
+  FUNCTION  3  tnumber_mgist_compress(internal),
+  FUNCTION  5  tnumber_mgist_penalty(internal, internal, internal),
+  FUNCTION  6  tnumber_mgist_picksplit(internal, internal),
+  FUNCTION  7  tnumber_mgist_same(tbox[], tbox[], internal),
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  10  tnumber_mgist_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  8  tnumber_mgist_distance(internal, tbox, smallint, oid, internal);
+
+CREATE OPERATOR CLASS tfloat_mrtree_ops
+  FOR TYPE tfloat USING gist AS
+  STORAGE tbox[],
+  -- strictly left
+  OPERATOR  1    << (tfloat, floatspan),
+  OPERATOR  1    << (tfloat, tbox),
+  OPERATOR  1    << (tfloat, tfloat),
+   -- overlaps or left
+  OPERATOR  2    &< (tfloat, floatspan),
+  OPERATOR  2    &< (tfloat, tbox),
+  OPERATOR  2    &< (tfloat, tfloat),
+  -- overlaps
+  OPERATOR  3    && (tfloat, floatspan),
+  OPERATOR  3    && (tfloat, tstzspan),
+  OPERATOR  3    && (tfloat, tbox),
+  OPERATOR  3    && (tfloat, tfloat),
+  -- overlaps or right
+  OPERATOR  4    &> (tfloat, floatspan),
+  OPERATOR  4    &> (tfloat, tbox),
+  OPERATOR  4    &> (tfloat, tfloat),
+  -- strictly right
+  OPERATOR  5    >> (tfloat, floatspan),
+  OPERATOR  5    >> (tfloat, tbox),
+  OPERATOR  5    >> (tfloat, tfloat),
+    -- same
+  OPERATOR  6    ~= (tfloat, floatspan),
+  OPERATOR  6    ~= (tfloat, tstzspan),
+  OPERATOR  6    ~= (tfloat, tbox),
+  OPERATOR  6    ~= (tfloat, tfloat),
+  -- contains
+  OPERATOR  7    @> (tfloat, floatspan),
+  OPERATOR  7    @> (tfloat, tstzspan),
+  OPERATOR  7    @> (tfloat, tbox),
+  OPERATOR  7    @> (tfloat, tfloat),
+  -- contained by
+  OPERATOR  8    <@ (tfloat, floatspan),
+  OPERATOR  8    <@ (tfloat, tstzspan),
+  OPERATOR  8    <@ (tfloat, tbox),
+  OPERATOR  8    <@ (tfloat, tfloat),
+  -- adjacent
+  OPERATOR  17    -|- (tfloat, floatspan),
+  OPERATOR  17    -|- (tfloat, tstzspan),
+  OPERATOR  17    -|- (tfloat, tbox),
+  OPERATOR  17    -|- (tfloat, tfloat),
+  -- nearest approach distance
+  OPERATOR  25    |=| (tfloat, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tfloat, float) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tfloat, tfloat) FOR ORDER BY pg_catalog.float_ops,
+  -- overlaps or before
+  OPERATOR  28    &<# (tfloat, tstzspan),
+  OPERATOR  28    &<# (tfloat, tbox),
+  OPERATOR  28    &<# (tfloat, tfloat),
+  -- strictly before
+  OPERATOR  29    <<# (tfloat, tstzspan),
+  OPERATOR  29    <<# (tfloat, tbox),
+  OPERATOR  29    <<# (tfloat, tfloat),
+  -- strictly after
+  OPERATOR  30    #>> (tfloat, tstzspan),
+  OPERATOR  30    #>> (tfloat, tbox),
+  OPERATOR  30    #>> (tfloat, tfloat),
+  -- overlaps or after
+  OPERATOR  31    #&> (tfloat, tstzspan),
+  OPERATOR  31    #&> (tfloat, tbox),
+  OPERATOR  31    #&> (tfloat, tfloat),
+  -- functions
+  FUNCTION  1  mgist_tfloat_consistent(internal, tfloat, smallint, oid, internal),
+  FUNCTION  2  tnumber_mgist_union(internal, internal),
+  FUNCTION  3  tnumber_mgist_compress(internal),
+  FUNCTION  5  tnumber_mgist_penalty(internal, internal, internal),
+  FUNCTION  6  tnumber_mgist_picksplit(internal, internal),
+  FUNCTION  7  tnumber_mgist_same(tbox[], tbox[], internal),
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  10  tnumber_mgist_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  8  tnumber_mgist_distance(internal, tbox, smallint, oid, internal);
+
 /******************************************************************************/
 
 CREATE OPERATOR CLASS ttext_rtree_ops
@@ -387,6 +614,48 @@ CREATE OPERATOR CLASS ttext_rtree_ops
   FUNCTION  3  ttext_gist_compress(internal),
   FUNCTION  5  span_gist_penalty(internal, internal, internal),
   FUNCTION  6  span_gist_picksplit(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  span_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  7  span_gist_same(tstzspan, tstzspan, internal);
 
 /******************************************************************************/
+
+/******************************************************************************
+ * Index inspection
+ ******************************************************************************/
+
+CREATE FUNCTION mobilitydb_gist_stats(index regclass, OUT depth integer,
+    OUT pages bigint, OUT tuples bigint, OUT avgFill float,
+    OUT avgKeySize float, OUT overlapX float, OUT overlapY float,
+    OUT overlapZ float, OUT overlapT float)
+  RETURNS SETOF record
+  AS 'MODULE_PATHNAME', 'Index_gist_stats'
+  LANGUAGE C VOLATILE STRICT;
+
+CREATE FUNCTION mobilitydb_gist_probe(index regclass, query intspan,
+    OUT innerPages bigint, OUT leafPages bigint, OUT candidates bigint)
+  AS 'MODULE_PATHNAME', 'Index_gist_probe'
+  LANGUAGE C VOLATILE STRICT;
+CREATE FUNCTION mobilitydb_gist_probe(index regclass, query bigintspan,
+    OUT innerPages bigint, OUT leafPages bigint, OUT candidates bigint)
+  AS 'MODULE_PATHNAME', 'Index_gist_probe'
+  LANGUAGE C VOLATILE STRICT;
+CREATE FUNCTION mobilitydb_gist_probe(index regclass, query floatspan,
+    OUT innerPages bigint, OUT leafPages bigint, OUT candidates bigint)
+  AS 'MODULE_PATHNAME', 'Index_gist_probe'
+  LANGUAGE C VOLATILE STRICT;
+CREATE FUNCTION mobilitydb_gist_probe(index regclass, query datespan,
+    OUT innerPages bigint, OUT leafPages bigint, OUT candidates bigint)
+  AS 'MODULE_PATHNAME', 'Index_gist_probe'
+  LANGUAGE C VOLATILE STRICT;
+CREATE FUNCTION mobilitydb_gist_probe(index regclass, query tstzspan,
+    OUT innerPages bigint, OUT leafPages bigint, OUT candidates bigint)
+  AS 'MODULE_PATHNAME', 'Index_gist_probe'
+  LANGUAGE C VOLATILE STRICT;
+CREATE FUNCTION mobilitydb_gist_probe(index regclass, query tbox,
+    OUT innerPages bigint, OUT leafPages bigint, OUT candidates bigint)
+  AS 'MODULE_PATHNAME', 'Index_gist_probe'
+  LANGUAGE C VOLATILE STRICT;
+
+/******************************************************************************/
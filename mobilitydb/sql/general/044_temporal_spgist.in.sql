@@ -99,6 +99,10 @@ CREATE OPERATOR CLASS tbox_quadtree_ops
   OPERATOR  17    -|- (tbox, tbox),
   OPERATOR  17    -|- (tbox, tint),
   OPERATOR  17    -|- (tbox, tfloat),
+  -- nearest approach distance
+  OPERATOR  25    |=| (tbox, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tbox, tint) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tbox, tfloat) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tbox, tbox),
   OPERATOR  28    &<# (tbox, tint),
@@ -177,6 +181,10 @@ CREATE OPERATOR CLASS tbox_kdtree_ops
   OPERATOR  17    -|- (tbox, tbox),
   OPERATOR  17    -|- (tbox, tint),
   OPERATOR  17    -|- (tbox, tfloat),
+  -- nearest approach distance
+  OPERATOR  25    |=| (tbox, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tbox, tint) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tbox, tfloat) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tbox, tbox),
   OPERATOR  28    &<# (tbox, tint),
@@ -332,6 +340,7 @@ CREATE OPERATOR CLASS tint_quadtree_ops
   OPERATOR  17    -|- (tint, tint),
   -- nearest approach distance
   OPERATOR  25    |=| (tint, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tint, integer) FOR ORDER BY pg_catalog.float_ops,
   OPERATOR  25    |=| (tint, tint) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tint, tstzspan),
@@ -404,6 +413,7 @@ CREATE OPERATOR CLASS tint_kdtree_ops
   OPERATOR  17    -|- (tint, tint),
   -- nearest approach distance
   OPERATOR  25    |=| (tint, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tint, integer) FOR ORDER BY pg_catalog.float_ops,
   OPERATOR  25    |=| (tint, tint) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tint, tstzspan),
@@ -476,6 +486,7 @@ CREATE OPERATOR CLASS tfloat_quadtree_ops
   OPERATOR  17    -|- (tfloat, tfloat),
   -- nearest approach distance
   OPERATOR  25    |=| (tfloat, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tfloat, float) FOR ORDER BY pg_catalog.float_ops,
   OPERATOR  25    |=| (tfloat, tfloat) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tfloat, tstzspan),
@@ -548,6 +559,7 @@ CREATE OPERATOR CLASS tfloat_kdtree_ops
   OPERATOR  17    -|- (tfloat, tfloat),
   -- nearest approach distance
   OPERATOR  25    |=| (tfloat, tbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tfloat, float) FOR ORDER BY pg_catalog.float_ops,
   OPERATOR  25    |=| (tfloat, tfloat) FOR ORDER BY pg_catalog.float_ops,
   -- overlaps or before
   OPERATOR  28    &<# (tfloat, tstzspan),
@@ -652,3 +664,16 @@ CREATE OPERATOR CLASS ttext_kdtree_ops
   FUNCTION  6  temporal_spgist_compress(internal);
 
 /******************************************************************************/
+
+/******************************************************************************
+ * Index inspection
+ ******************************************************************************/
+
+CREATE FUNCTION mobilitydb_spgist_stats(index regclass,
+    OUT innerPages bigint, OUT leafPages bigint, OUT innerTuples bigint,
+    OUT leafTuples bigint, OUT avgNodes float, OUT avgInnerFill float,
+    OUT avgLeafFill float)
+  AS 'MODULE_PATHNAME', 'Index_spgist_stats'
+  LANGUAGE C VOLATILE STRICT;
+
+/******************************************************************************/
@@ -0,0 +1,83 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/*
+ * temporal_chunks.sql
+ * Storage of long temporal values as a table of time chunks
+ *
+ * A long temporal value is stored as one row per chunk in a table with the
+ * columns id, chunk, and temp, where chunk is the start of the time bucket
+ * of the chunk, e.g.,
+ *   CREATE TABLE trip_chunks(id bigint, chunk timestamptz, temp tgeompoint,
+ *     PRIMARY KEY (id, chunk));
+ *   CREATE INDEX ON trip_chunks USING gist(temp);
+ * Appending an instant only rewrites the last chunk, whose size is bounded by
+ * the duration of the chunks. Each chunk starts with the last instant of the
+ * previous one so that the merge of the chunks is the complete value, e.g.,
+ *   SELECT id, merge(temp ORDER BY chunk) FROM trip_chunks GROUP BY id;
+ * The predicates on the chunks use the index and the bounding box of the
+ * chunks, e.g.,
+ *   SELECT id, merge(atTime(temp, p) ORDER BY chunk) FROM trip_chunks
+ *   WHERE temp && p GROUP BY id;
+ */
+
+/******************************************************************************/
+
+CREATE FUNCTION chunkAppendInstant(chunks regclass, id bigint,
+  inst anyelement, duration interval,
+  origin timestamptz DEFAULT '2000-01-03')
+  RETURNS void AS $$
+DECLARE
+  bucket timestamptz;
+  last inst%TYPE;
+  nrows bigint;
+BEGIN
+  bucket = timeBucket(getTimestamp(inst), duration, origin);
+  /* Append the instant to its chunk if it exists */
+  EXECUTE format('UPDATE %s SET temp = appendInstant(temp, $1) '
+    'WHERE id = $2 AND chunk = $3', chunks)
+    USING inst, id, bucket;
+  GET DIAGNOSTICS nrows = ROW_COUNT;
+  IF nrows > 0 THEN
+    RETURN;
+  END IF;
+  /* Otherwise start a new chunk from the last instant of the previous one */
+  EXECUTE format('SELECT endInstant(temp) FROM %s '
+    'WHERE id = $1 AND chunk < $2 ORDER BY chunk DESC LIMIT 1', chunks)
+    INTO last USING id, bucket;
+  IF last IS NOT NULL THEN
+    inst = appendInstant(last, inst);
+  END IF;
+  EXECUTE format('INSERT INTO %s(id, chunk, temp) VALUES ($1, $2, $3)',
+    chunks)
+    USING id, bucket, inst;
+END;
+$$ LANGUAGE plpgsql VOLATILE STRICT;
+
+/******************************************************************************/
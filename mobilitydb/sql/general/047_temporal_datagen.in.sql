@@ -0,0 +1,92 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/*
+ * temporal_datagen.sql
+ * Random generation of temporal Booleans, integers, floats, and texts.
+ * These functions are the C counterpart of the PL/pgSQL generators of the
+ * datagen directory. The Bulk variants return a set of values generated from
+ * a seed, so that the same arguments always return the same values.
+ */
+
+CREATE FUNCTION tboolRandom(period tstzspan, maxminutes int, mininsts int,
+    maxinsts int, minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'step')
+  RETURNS tbool
+  AS 'MODULE_PATHNAME', 'Temporal_random'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+CREATE FUNCTION tintRandom(bounds tbox, maxdelta int, maxminutes int,
+    mininsts int, maxinsts int, minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'step')
+  RETURNS tint
+  AS 'MODULE_PATHNAME', 'Temporal_random'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+CREATE FUNCTION tfloatRandom(bounds tbox, maxdelta float, maxminutes int,
+    mininsts int, maxinsts int, minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'linear')
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_random'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+CREATE FUNCTION ttextRandom(period tstzspan, maxlength int, maxminutes int,
+    mininsts int, maxinsts int, minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'step')
+  RETURNS ttext
+  AS 'MODULE_PATHNAME', 'Temporal_random'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+CREATE FUNCTION tboolRandomBulk(count int, seed bigint, period tstzspan,
+    maxminutes int, mininsts int, maxinsts int, minseqs int DEFAULT 1,
+    maxseqs int DEFAULT 1, subtype text DEFAULT 'Sequence',
+    interp text DEFAULT 'step')
+  RETURNS SETOF tbool
+  AS 'MODULE_PATHNAME', 'Temporal_random_bulk'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tintRandomBulk(count int, seed bigint, bounds tbox,
+    maxdelta int, maxminutes int, mininsts int, maxinsts int,
+    minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'step')
+  RETURNS SETOF tint
+  AS 'MODULE_PATHNAME', 'Temporal_random_bulk'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tfloatRandomBulk(count int, seed bigint, bounds tbox,
+    maxdelta float, maxminutes int, mininsts int, maxinsts int,
+    minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'linear')
+  RETURNS SETOF tfloat
+  AS 'MODULE_PATHNAME', 'Temporal_random_bulk'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION ttextRandomBulk(count int, seed bigint, period tstzspan,
+    maxlength int, maxminutes int, mininsts int, maxinsts int,
+    minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'step')
+  RETURNS SETOF ttext
+  AS 'MODULE_PATHNAME', 'Temporal_random_bulk'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
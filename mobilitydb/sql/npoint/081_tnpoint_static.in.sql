@@ -42,22 +42,22 @@ CREATE TYPE nsegment;
 CREATE FUNCTION npoint_in(cstring)
   RETURNS npoint
   AS 'MODULE_PATHNAME', 'Npoint_in'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION npoint_out(npoint)
   RETURNS cstring
   AS 'MODULE_PATHNAME', 'Npoint_out'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION npoint_recv(internal)
   RETURNS npoint
   AS 'MODULE_PATHNAME', 'Npoint_recv'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION npoint_send(npoint)
   RETURNS bytea
   AS 'MODULE_PATHNAME', 'Npoint_send'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE TYPE npoint (
   internallength = 16,
@@ -71,22 +71,22 @@ CREATE TYPE npoint (
 CREATE FUNCTION nsegment_in(cstring)
   RETURNS nsegment
   AS 'MODULE_PATHNAME', 'Nsegment_in'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION nsegment_out(nsegment)
   RETURNS cstring
   AS 'MODULE_PATHNAME', 'Nsegment_out'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION nsegment_recv(internal)
   RETURNS nsegment
   AS 'MODULE_PATHNAME', 'Nsegment_recv'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION nsegment_send(nsegment)
   RETURNS bytea
   AS 'MODULE_PATHNAME', 'Nsegment_send'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE TYPE nsegment (
   internallength = 24,
@@ -125,38 +125,38 @@ CREATE CAST (npoint AS nsegment) WITH FUNCTION nsegment(npoint);
 CREATE FUNCTION route(npoint)
   RETURNS bigint
   AS 'MODULE_PATHNAME', 'Npoint_route'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 -- position is a reserved word in SQL
 CREATE FUNCTION getPosition(npoint)
   RETURNS double precision
   AS 'MODULE_PATHNAME', 'Npoint_position'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION srid(npoint)
   RETURNS integer
   AS 'MODULE_PATHNAME', 'Npoint_get_srid'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION route(nsegment)
   RETURNS bigint
   AS 'MODULE_PATHNAME', 'Nsegment_route'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION startPosition(nsegment)
   RETURNS double precision
   AS 'MODULE_PATHNAME', 'Nsegment_start_position'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION endPosition(nsegment)
   RETURNS double precision
   AS 'MODULE_PATHNAME', 'Nsegment_end_position'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION srid(nsegment)
   RETURNS integer
   AS 'MODULE_PATHNAME', 'Nsegment_get_srid'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************
  * Modification functions
@@ -179,12 +179,12 @@ CREATE FUNCTION round(nsegment, integer DEFAULT 0)
 CREATE FUNCTION geometry(npoint)
   RETURNS geometry
   AS 'MODULE_PATHNAME', 'Npoint_to_geom'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION npoint(geometry)
   RETURNS npoint
   AS 'MODULE_PATHNAME', 'Geom_to_npoint'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE CAST (npoint AS geometry) WITH FUNCTION geometry(npoint);
 CREATE CAST (geometry AS npoint) WITH FUNCTION npoint(geometry);
@@ -192,15 +192,35 @@ CREATE CAST (geometry AS npoint) WITH FUNCTION npoint(geometry);
 CREATE FUNCTION geometry(nsegment)
   RETURNS geometry
   AS 'MODULE_PATHNAME', 'Nsegment_to_geom'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION nsegment(geometry)
   RETURNS nsegment
   AS 'MODULE_PATHNAME', 'Geom_to_nsegment'
-  LANGUAGE C IMMUTABLE STRICT;
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE CAST (nsegment AS geometry) WITH FUNCTION geometry(nsegment);
 CREATE CAST (geometry AS nsegment) WITH FUNCTION nsegment(geometry);
 
+/*****************************************************************************
+ * Route cache
+ *****************************************************************************/
+
+CREATE TYPE routecache_stats AS (
+  hits bigint,
+  misses bigint,
+  count integer,
+  capacity integer
+);
+
+CREATE FUNCTION routeCacheStats()
+  RETURNS routecache_stats
+  AS 'MODULE_PATHNAME', 'Route_cache_stats'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+CREATE FUNCTION routeCacheReset()
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Route_cache_reset'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
 /******************************************************************************
  * Operators
  ******************************************************************************/
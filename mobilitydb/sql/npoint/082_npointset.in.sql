@@ -186,12 +186,24 @@ CREATE FUNCTION npointset_union_finalfn(internal)
 CREATE AGGREGATE setUnion(npoint) (
   SFUNC = set_union_transfn,
   STYPE = internal,
-  FINALFUNC = npointset_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = npointset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
+  PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(npointset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
-  FINALFUNC = npointset_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = npointset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
+  PARALLEL = safe
 );
 
 /******************************************************************************
@@ -230,7 +242,7 @@ CREATE FUNCTION set_cmp(npointset, npointset)
 CREATE OPERATOR = (
   LEFTARG = npointset, RIGHTARG = npointset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR <> (
@@ -167,6 +167,11 @@ CREATE FUNCTION timeSpan(tnpoint)
   AS 'MODULE_PATHNAME', 'Temporal_to_tstzspan'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION snapToNetwork(tgeompoint, tolerance float)
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Tgeompoint_snap_network'
+  LANGUAGE C STABLE STRICT PARALLEL SAFE;
+
 CREATE CAST (tnpoint AS tgeompoint) WITH FUNCTION tgeompoint(tnpoint);
 CREATE CAST (tgeompoint AS tnpoint) WITH FUNCTION tnpoint(tgeompoint);
 CREATE CAST (tnpoint AS tstzspan) WITH FUNCTION timeSpan(tnpoint);
@@ -210,6 +215,11 @@ CREATE FUNCTION round(tnpoint, integer DEFAULT 0)
   AS 'MODULE_PATHNAME', 'Tnpoint_round'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION pack(tnpoint)
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Tnpoint_pack'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************
  * Append functions
  ******************************************************************************/
@@ -666,7 +676,7 @@ CREATE OPERATOR <= (
 CREATE OPERATOR = (
   LEFTARG = tnpoint, RIGHTARG = tnpoint,
   PROCEDURE = temporal_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR <> (
@@ -704,9 +714,37 @@ CREATE FUNCTION temporal_hash(tnpoint)
   AS 'MODULE_PATHNAME', 'Temporal_hash'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION temporal_hash_extended(tnpoint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR CLASS tnpoint_hash_ops
   DEFAULT FOR TYPE tnpoint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tnpoint);
+    FUNCTION    1   temporal_hash(tnpoint),
+    FUNCTION    2   temporal_hash_extended(tnpoint, bigint);
+
+/******************************************************************************
+ * Random generation
+ * These functions are the C counterpart of the PL/pgSQL generators of the
+ * datagen directory. The network points are located on the routes whose
+ * identifier is between lown and highn.
+ ******************************************************************************/
+
+CREATE FUNCTION tnpointRandom(lown bigint, highn bigint, period tstzspan,
+    maxminutes int, mininsts int, maxinsts int,
+    minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'linear')
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Temporal_random'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+CREATE FUNCTION tnpointRandomBulk(count int, seed bigint, lown bigint,
+    highn bigint, period tstzspan, maxminutes int, mininsts int, maxinsts int,
+    minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'linear')
+  RETURNS SETOF tnpoint
+  AS 'MODULE_PATHNAME', 'Temporal_random_bulk'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /******************************************************************************/
@@ -34,15 +34,10 @@
 
 /*****************************************************************************/
 
--- CREATE FUNCTION tnpoint_sel(internal, oid, internal, integer)
-  -- RETURNS float
-  -- AS 'MODULE_PATHNAME', 'Tnpoint_sel'
-  -- LANGUAGE C IMMUTABLE STRICT;
-
--- CREATE FUNCTION tnpoint_joinsel(internal, oid, internal, smallint, internal)
-  -- RETURNS float
-  -- AS 'MODULE_PATHNAME', 'Tnpoint_joinsel'
-  -- LANGUAGE C IMMUTABLE STRICT;
+CREATE FUNCTION tnpoint_route_sel(internal, oid, internal, integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Tnpoint_route_sel'
+  LANGUAGE C IMMUTABLE STRICT;
 
 /*****************************************************************************
  * Overlaps
@@ -56,8 +51,8 @@ CREATE FUNCTION overlaps_rid(bigintset, tnpoint)
 CREATE OPERATOR @@ (
   PROCEDURE = overlaps_rid,
   LEFTARG = bigintset, RIGHTARG = tnpoint,
-  COMMUTATOR = @@
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @@,
+  RESTRICT = tnpoint_route_sel, JOIN = areajoinsel
 );
 
 CREATE FUNCTION overlaps_rid(tnpoint, bigintset)
@@ -72,14 +67,14 @@ CREATE FUNCTION overlaps_rid(tnpoint, tnpoint)
 CREATE OPERATOR @@ (
   PROCEDURE = overlaps_rid,
   LEFTARG = tnpoint, RIGHTARG = bigintset,
-  COMMUTATOR = @@
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @@,
+  RESTRICT = tnpoint_route_sel, JOIN = areajoinsel
 );
 CREATE OPERATOR @@ (
   PROCEDURE = overlaps_rid,
   LEFTARG = tnpoint, RIGHTARG = tnpoint,
-  COMMUTATOR = @@
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @@,
+  RESTRICT = tnpoint_route_sel, JOIN = areajoinsel
 );
 
 /*****************************************************************************
@@ -94,8 +89,8 @@ CREATE FUNCTION contains_rid(bigintset, tnpoint)
 CREATE OPERATOR @? (
   PROCEDURE = contains_rid,
   LEFTARG = bigintset, RIGHTARG = tnpoint,
-  COMMUTATOR = ?@
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = ?@,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 
 CREATE FUNCTION contains_rid(tnpoint, bigint)
@@ -118,26 +113,26 @@ CREATE FUNCTION contains_rid(tnpoint, tnpoint)
 CREATE OPERATOR @? (
   PROCEDURE = contains_rid,
   LEFTARG = tnpoint, RIGHTARG = bigint,
-  COMMUTATOR = ?@
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = ?@,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR @? (
   PROCEDURE = contains_rid,
   LEFTARG = tnpoint, RIGHTARG = bigintset,
-  COMMUTATOR = ?@
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = ?@,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR @? (
   PROCEDURE = contains_rid,
   LEFTARG = tnpoint, RIGHTARG = npoint,
-  COMMUTATOR = ?@
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = ?@,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR @? (
   PROCEDURE = contains_rid,
   LEFTARG = tnpoint, RIGHTARG = tnpoint,
-  COMMUTATOR = ?@
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = ?@,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 
 /*****************************************************************************
@@ -160,20 +155,20 @@ CREATE FUNCTION contained_rid(npoint, tnpoint)
 CREATE OPERATOR ?@ (
   PROCEDURE = contained_rid,
   LEFTARG = bigint, RIGHTARG = tnpoint,
-  COMMUTATOR = @?
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @?,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR ?@ (
   PROCEDURE = contained_rid,
   LEFTARG = bigintset, RIGHTARG = tnpoint,
-  COMMUTATOR = @?
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @?,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR ?@ (
   PROCEDURE = contained_rid,
   LEFTARG = npoint, RIGHTARG = tnpoint,
-  COMMUTATOR = @?
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @?,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 
 CREATE FUNCTION contained_rid(tnpoint, bigintset)
@@ -188,14 +183,14 @@ CREATE FUNCTION contained_rid(tnpoint, tnpoint)
 CREATE OPERATOR ?@ (
   PROCEDURE = contained_rid,
   LEFTARG = tnpoint, RIGHTARG = bigintset,
-  COMMUTATOR = @?
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @?,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR ?@ (
   PROCEDURE = contained_rid,
   LEFTARG = tnpoint, RIGHTARG = tnpoint,
-  COMMUTATOR = @?
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @?,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 
 /*****************************************************************************
@@ -218,20 +213,20 @@ CREATE FUNCTION same_rid(npoint, tnpoint)
 CREATE OPERATOR @= (
   PROCEDURE = same_rid,
   LEFTARG = bigint, RIGHTARG = tnpoint,
-  COMMUTATOR = @=
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @=,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR @= (
   PROCEDURE = same_rid,
   LEFTARG = bigintset, RIGHTARG = tnpoint,
-  COMMUTATOR = @=
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @=,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR @= (
   PROCEDURE = same_rid,
   LEFTARG = npoint, RIGHTARG = tnpoint,
-  COMMUTATOR = @=
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @=,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 
 CREATE FUNCTION same_rid(tnpoint, bigint)
@@ -254,26 +249,26 @@ CREATE FUNCTION same_rid(tnpoint, tnpoint)
 CREATE OPERATOR @= (
   PROCEDURE = same_rid,
   LEFTARG = tnpoint, RIGHTARG = bigint,
-  COMMUTATOR = @=
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @=,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR @= (
   PROCEDURE = same_rid,
   LEFTARG = tnpoint, RIGHTARG = bigintset,
-  COMMUTATOR = @=
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @=,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR @= (
   PROCEDURE = same_rid,
   LEFTARG = tnpoint, RIGHTARG = npoint,
-  COMMUTATOR = @=
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @=,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 CREATE OPERATOR @= (
   PROCEDURE = same_rid,
   LEFTARG = tnpoint, RIGHTARG = tnpoint,
-  COMMUTATOR = @=
-  -- , RESTRICT = tnpoint_sel, JOIN = tnpoint_joinsel
+  COMMUTATOR = @=,
+  RESTRICT = tnpoint_route_sel, JOIN = contjoinsel
 );
 
 /*****************************************************************************/
@@ -84,4 +84,25 @@ CREATE OPERATOR <-> (
   COMMUTATOR = <->
 );
 
+/*****************************************************************************
+ * Network distance
+ *****************************************************************************/
+
+CREATE FUNCTION networkDistance(npoint, npoint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Network_distance_npoint_npoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION networkDistance(npoint, tnpoint)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Network_distance_npoint_tnpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION networkDistance(tnpoint, npoint)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Network_distance_tnpoint_npoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION networkDistance(tnpoint, tnpoint)
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Network_distance_tnpoint_tnpoint'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -78,8 +78,8 @@ CREATE AGGREGATE tcentroid(tnpoint) (
   COMBINEFUNC = tcentroid_combinefn,
 #endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = tcentroid_finalfn,
-  SERIALFUNC = taggstate_serialize,
-  DESERIALFUNC = taggstate_deserialize,
+  SERIALFUNC = tcentroid_serialize,
+  DESERIALFUNC = tcentroid_deserialize,
   PARALLEL = SAFE
 );
 
@@ -128,13 +128,24 @@ CREATE FUNCTION temporal_append_finalfn(tnpoint)
   AS 'MODULE_PATHNAME', 'Temporal_append_finalfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+-- The function is not STRICT
+CREATE FUNCTION temporal_app_tinst_combinefn(tnpoint, tnpoint)
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Temporal_app_tinst_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 CREATE AGGREGATE appendInstant(tnpoint) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tnpoint,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tinst_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 
+-- The variants with gaps have no combine function, since the gaps would have
+-- to be reapplied to the merged partial states
 CREATE AGGREGATE appendInstant(tnpoint, float, interval) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tnpoint,
@@ -150,9 +161,18 @@ CREATE FUNCTION temporal_app_tseq_transfn(tnpoint, tnpoint)
   AS 'MODULE_PATHNAME', 'Temporal_app_tseq_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+-- The function is not STRICT
+CREATE FUNCTION temporal_app_tseq_combinefn(tnpoint, tnpoint)
+  RETURNS tnpoint
+  AS 'MODULE_PATHNAME', 'Temporal_app_tseq_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 CREATE AGGREGATE appendSequence(tnpoint) (
   SFUNC = temporal_app_tseq_transfn,
   STYPE = tnpoint,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tseq_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
@@ -112,6 +112,9 @@ CREATE OPERATOR CLASS tnpoint_rtree_ops
   FUNCTION  3 tpoint_gist_compress(internal),
   FUNCTION  5 stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6 stbox_gist_picksplit(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11 stbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  7 stbox_gist_same(stbox, stbox, internal);
 --  FUNCTION  8 gist_tnpoint_distance(internal, tnpoint, smallint, oid, internal),
 
@@ -261,6 +264,9 @@ CREATE OPERATOR CLASS tnpoint_kdtree_ops
   FUNCTION  3 stbox_kdtree_picksplit(internal, internal),
   FUNCTION  4 stbox_kdtree_inner_consistent(internal, internal),
   FUNCTION  5 stbox_spgist_leaf_consistent(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  7 stbox_kdtree_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  6 tpoint_spgist_compress(internal);
 
 /******************************************************************************/
@@ -348,23 +348,47 @@ CREATE FUNCTION geogset_union_finalfn(internal)
 CREATE AGGREGATE setUnion(geometry) (
   SFUNC = set_union_transfn,
   STYPE = internal,
-  FINALFUNC = geomset_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = geomset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
+  PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(geography) (
   SFUNC = set_union_transfn,
   STYPE = internal,
-  FINALFUNC = geogset_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = geogset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
+  PARALLEL = safe
 );
 
 CREATE AGGREGATE setUnion(geomset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
-  FINALFUNC = geomset_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = geomset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
+  PARALLEL = safe
 );
 CREATE AGGREGATE setUnion(geogset) (
   SFUNC = set_union_transfn,
   STYPE = internal,
-  FINALFUNC = geogset_union_finalfn
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = set_union_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = geogset_union_finalfn,
+  SERIALFUNC = set_union_serialize,
+  DESERIALFUNC = set_union_deserialize,
+  PARALLEL = safe
 );
 
 /*****************************************************************************
@@ -446,13 +470,13 @@ CREATE FUNCTION set_cmp(geogset, geogset)
 CREATE OPERATOR = (
   LEFTARG = geomset, RIGHTARG = geomset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 CREATE OPERATOR = (
   LEFTARG = geogset, RIGHTARG = geogset,
   PROCEDURE = set_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = eqsel, JOIN = eqjoinsel
 );
 
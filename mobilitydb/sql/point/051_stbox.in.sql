@@ -372,6 +372,10 @@ CREATE FUNCTION expandSpace(stbox, float)
   RETURNS stbox
   AS 'MODULE_PATHNAME', 'Stbox_expand_space'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION expandSpace(stbox[], float)
+  RETURNS stbox[]
+  AS 'MODULE_PATHNAME', 'Stboxarr_expand_space'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION expandTime(stbox, interval)
   RETURNS stbox
   AS 'MODULE_PATHNAME', 'Stbox_expand_time'
@@ -391,6 +395,16 @@ CREATE FUNCTION tpoint_joinsel(internal, oid, internal, smallint, internal)
 AS 'MODULE_PATHNAME', 'Tpoint_joinsel'
   LANGUAGE C IMMUTABLE STRICT;
 
+CREATE FUNCTION tpoint_stboxarr_sel(internal, oid, internal, integer)
+  RETURNS float
+AS 'MODULE_PATHNAME', 'Tpoint_stboxarr_sel'
+  LANGUAGE C IMMUTABLE STRICT;
+
+CREATE FUNCTION tpoint_stboxarr_joinsel(internal, oid, internal, smallint, internal)
+  RETURNS float
+AS 'MODULE_PATHNAME', 'Tpoint_stboxarr_joinsel'
+  LANGUAGE C IMMUTABLE STRICT;
+
 /*****************************************************************************
 * Topological operators
 *****************************************************************************/
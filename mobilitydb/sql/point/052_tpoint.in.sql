@@ -35,6 +35,15 @@
 CREATE TYPE tgeompoint;
 CREATE TYPE tgeogpoint;
 
+/*****************************************************************************
+ * Planner Support Function
+ *****************************************************************************/
+
+CREATE FUNCTION tpoint_supportfn(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_supportfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /******************************************************************************
  * Input/Output
  ******************************************************************************/
@@ -586,10 +595,12 @@ CREATE FUNCTION sequences(tgeogpoint)
 CREATE FUNCTION segments(tgeompoint)
   RETURNS tgeompoint[]
   AS 'MODULE_PATHNAME', 'Temporal_segments'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION segments(tgeogpoint)
   RETURNS tgeogpoint[]
   AS 'MODULE_PATHNAME', 'Temporal_segments'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************
@@ -661,10 +672,12 @@ CREATE TYPE geog_tstzspanset AS (
 CREATE FUNCTION unnest(tgeompoint)
   RETURNS SETOF geom_tstzspanset
   AS 'MODULE_PATHNAME', 'Temporal_unnest'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION unnest(tgeogpoint)
   RETURNS SETOF geog_tstzspanset
   AS 'MODULE_PATHNAME', 'Temporal_unnest'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************
@@ -788,6 +801,28 @@ CREATE FUNCTION minusTime(tgeogpoint, tstzspanset)
   AS 'MODULE_PATHNAME', 'Temporal_minus_tstzspanset'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*****************************************************************************
+ * Compression functions
+ *****************************************************************************/
+
+CREATE FUNCTION compress(tgeompoint)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION compress(tgeogpoint)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION quantize(tgeompoint, float)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Tpoint_quantize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION quantize(tgeogpoint, float)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Tpoint_quantize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * Modification Functions
  *****************************************************************************/
@@ -934,7 +969,7 @@ CREATE OPERATOR <= (
 CREATE OPERATOR = (
   LEFTARG = tgeompoint, RIGHTARG = tgeompoint,
   PROCEDURE = temporal_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = tpoint_sel, JOIN = tpoint_joinsel
 );
 CREATE OPERATOR <> (
@@ -1011,7 +1046,7 @@ CREATE OPERATOR <= (
 CREATE OPERATOR = (
   LEFTARG = tgeogpoint, RIGHTARG = tgeogpoint,
   PROCEDURE = temporal_eq,
-  COMMUTATOR = =, NEGATOR = <>,
+  COMMUTATOR = =, NEGATOR = <>, HASHES,
   RESTRICT = tpoint_sel, JOIN = tpoint_joinsel
 );
 CREATE OPERATOR <> (
@@ -1053,14 +1088,25 @@ CREATE FUNCTION temporal_hash(tgeogpoint)
   AS 'MODULE_PATHNAME', 'Temporal_hash'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION temporal_hash_extended(tgeompoint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION temporal_hash_extended(tgeogpoint, bigint)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Temporal_hash_extended'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE OPERATOR CLASS tgeompoint_hash_ops
   DEFAULT FOR TYPE tgeompoint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tgeompoint);
+    FUNCTION    1   temporal_hash(tgeompoint),
+    FUNCTION    2   temporal_hash_extended(tgeompoint, bigint);
 CREATE OPERATOR CLASS tgeogpoint_hash_ops
   DEFAULT FOR TYPE tgeogpoint USING hash AS
     OPERATOR    1   = ,
-    FUNCTION    1   temporal_hash(tgeogpoint);
+    FUNCTION    1   temporal_hash(tgeogpoint),
+    FUNCTION    2   temporal_hash_extended(tgeogpoint, bigint);
 
 /******************************************************************************/
 
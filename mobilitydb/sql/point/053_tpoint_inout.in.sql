@@ -159,6 +159,15 @@ CREATE FUNCTION asMFJSON(point tgeogpoint, options int4 DEFAULT 0,
   AS 'MODULE_PATHNAME', 'Temporal_as_mfjson'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION asMFJSONChunks(point tgeompoint, options int4 DEFAULT 0, maxdecimaldigits int4 DEFAULT 15)
+  RETURNS SETOF text
+  AS 'MODULE_PATHNAME', 'Temporal_as_mfjson_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asMFJSONChunks(point tgeogpoint, options int4 DEFAULT 0, maxdecimaldigits int4 DEFAULT 15)
+  RETURNS SETOF text
+  AS 'MODULE_PATHNAME', 'Temporal_as_mfjson_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION asBinary(tgeompoint, endianenconding text DEFAULT '')
   RETURNS bytea
   AS 'MODULE_PATHNAME', 'Temporal_as_wkb'
@@ -168,6 +177,35 @@ CREATE FUNCTION asBinary(tgeogpoint, endianenconding text DEFAULT '')
   AS 'MODULE_PATHNAME', 'Temporal_as_wkb'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION asBinaryChunks(tgeompoint, endianenconding text DEFAULT '')
+  RETURNS SETOF bytea
+  AS 'MODULE_PATHNAME', 'Temporal_as_wkb_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION asBinaryChunks(tgeogpoint, endianenconding text DEFAULT '')
+  RETURNS SETOF bytea
+  AS 'MODULE_PATHNAME', 'Temporal_as_wkb_chunks'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION deltaSince(tgeompoint, timestamptz,
+    endianenconding text DEFAULT '')
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Temporal_delta_since'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION deltaSince(tgeogpoint, timestamptz,
+    endianenconding text DEFAULT '')
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Temporal_delta_since'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION applyDelta(tgeompoint, bytea)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_apply_delta'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION applyDelta(tgeogpoint, bytea)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_apply_delta'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 CREATE FUNCTION asEWKB(tgeompoint, endianenconding text DEFAULT '')
   RETURNS bytea
   AS 'MODULE_PATHNAME', 'Tpoint_as_ewkb'
@@ -33,15 +33,6 @@
  * temporal points.
  */
 
-/*****************************************************************************
- * Index Support Function
- *****************************************************************************/
-
-CREATE FUNCTION tpoint_supportfn(internal)
-  RETURNS internal
-  AS 'MODULE_PATHNAME', 'Tpoint_supportfn'
-  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
-
 /*****************************************************************************
  * Ever/Always Comparison Functions
  *****************************************************************************/
@@ -304,35 +304,43 @@ CREATE FUNCTION makeSimple(tgeompoint)
 CREATE FUNCTION atGeometry(tgeompoint, geometry)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_at_geom'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION atGeometry(tgeompoint, geometry, floatspan)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_at_geom'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION atGeometryTime(tgeompoint, geometry, tstzspan)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_at_geom_time'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION atGeometryTime(tgeompoint, geometry, floatspan, tstzspan)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_at_geom_time'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION minusGeometry(tgeompoint, geometry)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_minus_geom'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION minusGeometry(tgeompoint, geometry, floatspan)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_minus_geom'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION minusGeometryTime(tgeompoint, geometry, tstzspan)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_minus_geom_time'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION minusGeometryTime(tgeompoint, geometry, floatspan, tstzspan)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_minus_geom_time'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION atStbox(tgeompoint, stbox, borderInc bool DEFAULT TRUE)
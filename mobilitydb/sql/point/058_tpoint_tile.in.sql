@@ -124,18 +124,21 @@ CREATE FUNCTION spaceSplit(tgeompoint, xsize float, ysize float, zsize float,
     borderInc boolean DEFAULT TRUE)
   RETURNS SETOF point_tpoint
   AS 'MODULE_PATHNAME', 'Tpoint_space_split'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
 CREATE FUNCTION spaceSplit(tgeompoint, size float,
     sorigin geometry DEFAULT 'Point(0 0 0)', bitmatrix boolean DEFAULT TRUE,
     borderInc boolean DEFAULT TRUE)
   RETURNS SETOF point_tpoint
   AS 'SELECT @extschema@.spaceSplit($1, $2, $2, $2, $3, $4)'
+  SUPPORT tpoint_supportfn
   LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
 CREATE FUNCTION spaceSplit(tgeompoint, sizeX float, sizeY float,
     sorigin geometry DEFAULT 'Point(0 0 0)', bitmatrix boolean DEFAULT TRUE,
     borderInc boolean DEFAULT TRUE)
   RETURNS SETOF point_tpoint
   AS 'SELECT @extschema@.spaceSplit($1, $2, $3, $2, $4, $5)'
+  SUPPORT tpoint_supportfn
   LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
 
 CREATE TYPE point_time_tpoint AS (
@@ -150,6 +153,7 @@ CREATE FUNCTION spaceTimeSplit(tgeompoint, xsize float, ysize float,
     borderInc boolean DEFAULT TRUE)
   RETURNS SETOF point_time_tpoint
   AS 'MODULE_PATHNAME', 'Tpoint_space_time_split'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
 CREATE FUNCTION spaceTimeSplit(tgeompoint, size float, interval,
     sorigin geometry DEFAULT 'Point(0 0 0)',
@@ -157,6 +161,7 @@ CREATE FUNCTION spaceTimeSplit(tgeompoint, size float, interval,
     borderInc boolean DEFAULT TRUE)
   RETURNS SETOF point_time_tpoint
   AS 'SELECT @extschema@.spaceTimeSplit($1, $2, $2, $2, $3, $4, $5, $6)'
+  SUPPORT tpoint_supportfn
   LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
 CREATE FUNCTION spaceTimeSplit(tgeompoint, xsize float, ysize float, interval,
     sorigin geometry DEFAULT 'Point(0 0 0)',
@@ -164,6 +169,274 @@ CREATE FUNCTION spaceTimeSplit(tgeompoint, xsize float, ysize float, interval,
     borderInc boolean DEFAULT TRUE)
   RETURNS SETOF point_time_tpoint
   AS 'SELECT @extschema@.spaceTimeSplit($1, $2, $3, $2, $4, $5, $6, $7)'
+  SUPPORT tpoint_supportfn
   LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Tile identifiers
+ *****************************************************************************/
+
+CREATE FUNCTION spaceTiles(stbox, xsize float, ysize float, zsize float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigintset
+  AS 'MODULE_PATHNAME', 'Stbox_space_tiles'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTiles(stbox, size float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigintset
+  AS 'SELECT @extschema@.spaceTiles($1, $2, $2, $2, $3)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTiles(stbox, sizeX float, sizeY float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigintset
+  AS 'SELECT @extschema@.spaceTiles($1, $2, $3, $2, $4)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+
+CREATE FUNCTION spaceTimeTiles(stbox, xsize float, ysize float, zsize float,
+    interval, sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigintset
+  AS 'MODULE_PATHNAME', 'Stbox_space_time_tiles'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTimeTiles(stbox, size float, interval,
+    sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigintset
+  AS 'SELECT @extschema@.spaceTimeTiles($1, $2, $2, $2, $3, $4, $5)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTimeTiles(stbox, sizeX float, sizeY float, interval,
+    sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigintset
+  AS 'SELECT @extschema@.spaceTimeTiles($1, $2, $3, $2, $4, $5, $6)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+
+CREATE FUNCTION spaceTiles(tgeompoint, xsize float, ysize float, zsize float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigintset
+  AS 'MODULE_PATHNAME', 'Tpoint_space_tiles'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTiles(tgeompoint, size float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigintset
+  AS 'SELECT @extschema@.spaceTiles($1, $2, $2, $2, $3)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTiles(tgeompoint, sizeX float, sizeY float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigintset
+  AS 'SELECT @extschema@.spaceTiles($1, $2, $3, $2, $4)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+
+CREATE FUNCTION spaceTimeTiles(tgeompoint, xsize float, ysize float,
+    zsize float, interval, sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigintset
+  AS 'MODULE_PATHNAME', 'Tpoint_space_time_tiles'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTimeTiles(tgeompoint, size float, interval,
+    sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigintset
+  AS 'SELECT @extschema@.spaceTimeTiles($1, $2, $2, $2, $3, $4, $5)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTimeTiles(tgeompoint, sizeX float, sizeY float, interval,
+    sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigintset
+  AS 'SELECT @extschema@.spaceTimeTiles($1, $2, $3, $2, $4, $5, $6)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+
+/*****************************************************************************
+ * Hierarchical tile keys
+ *****************************************************************************/
+
+CREATE FUNCTION tileKey(point geometry, xsize float, ysize float, zsize float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Tile_key'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tileKey(point geometry, size float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigint
+  AS 'SELECT @extschema@.tileKey($1, $2, $2, $2, $3)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION tileKey(point geometry, xsize float, ysize float,
+    sorigin geometry DEFAULT 'Point(0 0 0)')
+  RETURNS bigint
+  AS 'SELECT @extschema@.tileKey($1, $2, $3, $2, $4)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+
+CREATE FUNCTION tileKey(point geometry, "time" timestamptz, xsize float,
+    ysize float, zsize float, duration interval,
+    sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Tile_key'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tileKey(point geometry, "time" timestamptz, size float,
+    duration interval, sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigint
+  AS 'SELECT @extschema@.tileKey($1, $2, $3, $3, $3, $4, $5, $6)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION tileKey(point geometry, "time" timestamptz, xsize float,
+    ysize float, duration interval, sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03')
+  RETURNS bigint
+  AS 'SELECT @extschema@.tileKey($1, $2, $3, $4, $3, $5, $6, $7)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+
+CREATE FUNCTION tileKeyLevel(bigint)
+  RETURNS integer
+  AS 'MODULE_PATHNAME', 'Tile_key_level'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tileKeyParent(bigint, levels integer DEFAULT 1)
+  RETURNS bigint
+  AS 'MODULE_PATHNAME', 'Tile_key_parent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tileKeyChildren(bigint)
+  RETURNS bigintset
+  AS 'MODULE_PATHNAME', 'Tile_key_children'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE key_tpoint AS (
+  key bigint,
+  tpoint tgeompoint
+);
+
+CREATE FUNCTION spaceKeySplit(tgeompoint, xsize float, ysize float,
+    zsize float, sorigin geometry DEFAULT 'Point(0 0 0)',
+    bitmatrix boolean DEFAULT TRUE, borderInc boolean DEFAULT TRUE)
+  RETURNS SETOF key_tpoint
+  AS 'MODULE_PATHNAME', 'Tpoint_space_key_split'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceKeySplit(tgeompoint, size float,
+    sorigin geometry DEFAULT 'Point(0 0 0)', bitmatrix boolean DEFAULT TRUE,
+    borderInc boolean DEFAULT TRUE)
+  RETURNS SETOF key_tpoint
+  AS 'SELECT @extschema@.spaceKeySplit($1, $2, $2, $2, $3, $4, $5)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceKeySplit(tgeompoint, sizeX float, sizeY float,
+    sorigin geometry DEFAULT 'Point(0 0 0)', bitmatrix boolean DEFAULT TRUE,
+    borderInc boolean DEFAULT TRUE)
+  RETURNS SETOF key_tpoint
+  AS 'SELECT @extschema@.spaceKeySplit($1, $2, $3, $2, $4, $5, $6)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+
+CREATE FUNCTION spaceTimeKeySplit(tgeompoint, xsize float, ysize float,
+    zsize float, interval, sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03', bitmatrix boolean DEFAULT TRUE,
+    borderInc boolean DEFAULT TRUE)
+  RETURNS SETOF key_tpoint
+  AS 'MODULE_PATHNAME', 'Tpoint_space_time_key_split'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTimeKeySplit(tgeompoint, size float, interval,
+    sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03', bitmatrix boolean DEFAULT TRUE,
+    borderInc boolean DEFAULT TRUE)
+  RETURNS SETOF key_tpoint
+  AS 'SELECT @extschema@.spaceTimeKeySplit($1, $2, $2, $2, $3, $4, $5, $6, $7)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION spaceTimeKeySplit(tgeompoint, sizeX float, sizeY float,
+    interval, sorigin geometry DEFAULT 'Point(0 0 0)',
+    torigin timestamptz DEFAULT '2000-01-03', bitmatrix boolean DEFAULT TRUE,
+    borderInc boolean DEFAULT TRUE)
+  RETURNS SETOF key_tpoint
+  AS 'SELECT @extschema@.spaceTimeKeySplit($1, $2, $3, $2, $4, $5, $6, $7, $8)'
+  LANGUAGE SQL IMMUTABLE PARALLEL SAFE STRICT;
+
+/*****************************************************************************
+ * Tile density aggregation
+ *****************************************************************************/
+
+CREATE TYPE tile_density AS (
+  point geometry,
+  time timestamptz,
+  count bigint,
+  duration interval,
+  distance float
+);
+
+CREATE FUNCTION tile_density_transfn(internal, tgeompoint, xsize float,
+    ysize float, sorigin geometry)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_tile_density_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tile_density_transfn(internal, tgeompoint, xsize float,
+    ysize float, interval, sorigin geometry, torigin timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_tile_density_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tile_density_combinefn(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_tile_density_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tile_density_finalfn(internal)
+  RETURNS tile_density[]
+  AS 'MODULE_PATHNAME', 'Tpoint_tile_density_finalfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tile_density_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Tile_density_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tile_density_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tile_density_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE tileDensity(tgeompoint, xsize float, ysize float,
+    sorigin geometry) (
+  SFUNC = tile_density_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tile_density_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tile_density_finalfn,
+  SERIALFUNC = tile_density_serialize,
+  DESERIALFUNC = tile_density_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tileDensity(tgeompoint, xsize float, ysize float, interval,
+    sorigin geometry, torigin timestamptz) (
+  SFUNC = tile_density_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tile_density_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tile_density_finalfn,
+  SERIALFUNC = tile_density_serialize,
+  DESERIALFUNC = tile_density_deserialize,
+  PARALLEL = SAFE
+);
+
+/*****************************************************************************
+ * Balanced partitions
+ *****************************************************************************/
+
+CREATE FUNCTION balancedPartitions(stbox[], k integer)
+  RETURNS stbox[]
+  AS 'MODULE_PATHNAME', 'Stboxarr_balanced_partitions'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION balancedPartitions(tbl regclass, col text, k integer)
+  RETURNS stbox[]
+  AS 'MODULE_PATHNAME', 'Tpoint_balanced_partitions'
+  LANGUAGE C STABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************
+ * Bucketed aggregation functions
+ *****************************************************************************/
+
+CREATE FUNCTION bucketLength(tgeompoint, duration interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tpoint_bucket_length'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+CREATE FUNCTION bucketLength(tgeogpoint, duration interval,
+    origin timestamptz DEFAULT '2000-01-03')
+  RETURNS tfloat
+  AS 'MODULE_PATHNAME', 'Tpoint_bucket_length'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE STRICT;
+
+/*****************************************************************************/
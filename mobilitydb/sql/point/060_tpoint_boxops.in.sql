@@ -331,10 +331,12 @@ CREATE OPERATOR <@ (
 CREATE FUNCTION temporal_overlaps(tstzspan, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_tstzspan_temporal'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION temporal_overlaps(tgeompoint, tstzspan)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_temporal_tstzspan'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR && (
@@ -355,14 +357,17 @@ CREATE OPERATOR && (
 CREATE FUNCTION temporal_overlaps(stbox, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_stbox_tpoint'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION temporal_overlaps(tgeompoint, stbox)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_tpoint_stbox'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION temporal_overlaps(tgeompoint, tgeompoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_tpoint_tpoint'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR && (
@@ -384,15 +389,28 @@ CREATE OPERATOR && (
   RESTRICT = tpoint_sel, JOIN = tpoint_joinsel
 );
 
+CREATE FUNCTION temporal_overlaps(tgeompoint, stbox[])
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Overlaps_tpoint_stboxarr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR && (
+  PROCEDURE = temporal_overlaps,
+  LEFTARG = tgeompoint, RIGHTARG = stbox[],
+  RESTRICT = tpoint_stboxarr_sel, JOIN = tpoint_stboxarr_joinsel
+);
+
 /*****************************************************************************/
 
 CREATE FUNCTION temporal_overlaps(tstzspan, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_tstzspan_temporal'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION temporal_overlaps(tgeogpoint, tstzspan)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_temporal_tstzspan'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR && (
@@ -413,14 +431,17 @@ CREATE OPERATOR && (
 CREATE FUNCTION temporal_overlaps(stbox, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_stbox_tpoint'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION temporal_overlaps(tgeogpoint, stbox)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_tpoint_stbox'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 CREATE FUNCTION temporal_overlaps(tgeogpoint, tgeogpoint)
   RETURNS boolean
   AS 'MODULE_PATHNAME', 'Overlaps_tpoint_tpoint'
+  SUPPORT temporal_overlaps_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE OPERATOR && (
@@ -442,6 +463,17 @@ CREATE OPERATOR && (
   RESTRICT = tpoint_sel, JOIN = tpoint_joinsel
 );
 
+CREATE FUNCTION temporal_overlaps(tgeogpoint, stbox[])
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Overlaps_tpoint_stboxarr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR && (
+  PROCEDURE = temporal_overlaps,
+  LEFTARG = tgeogpoint, RIGHTARG = stbox[],
+  RESTRICT = tpoint_stboxarr_sel, JOIN = tpoint_stboxarr_joinsel
+);
+
 /*****************************************************************************
  * Same
  *****************************************************************************/
@@ -291,4 +291,17 @@ CREATE FUNCTION shortestLine(tgeogpoint, tgeogpoint)
   AS 'MODULE_PATHNAME', 'Shortestline_tpoint_tpoint'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+/*****************************************************************************
+ * Continuous k nearest neighbours
+ *****************************************************************************/
+
+CREATE FUNCTION knnPeriods(tgeompoint, ref tgeompoint, k integer)
+  RETURNS tstzspanset
+  AS 'MODULE_PATHNAME', 'Tpoint_knn_periods'
+  LANGUAGE C IMMUTABLE WINDOW PARALLEL SAFE;
+CREATE FUNCTION knnPeriods(tgeogpoint, ref tgeogpoint, k integer)
+  RETURNS tstzspanset
+  AS 'MODULE_PATHNAME', 'Tpoint_knn_periods'
+  LANGUAGE C IMMUTABLE WINDOW PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -42,6 +42,46 @@ CREATE FUNCTION frechetDistance(tgeogpoint, tgeogpoint)
   RETURNS float
   AS 'MODULE_PATHNAME', 'Temporal_frechet_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistance(tgeompoint, tgeompoint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistance(tgeogpoint, tgeogpoint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistanceWithin(tgeompoint, tgeompoint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistanceWithin(tgeogpoint, tgeogpoint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistanceWithin(tgeompoint, tgeompoint, dist float, band integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetDistanceWithin(tgeogpoint, tgeogpoint, dist float, band integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetLowerBound(tgeompoint, tgeompoint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetLowerBound(tgeogpoint, tgeogpoint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetLowerBound(tgeompoint, tgeompoint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION frechetLowerBound(tgeogpoint, tgeogpoint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_frechet_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION frechetDistancePath(tgeompoint, tgeompoint)
   RETURNS SETOF warp
@@ -62,6 +102,46 @@ CREATE FUNCTION dynTimeWarpDistance(tgeogpoint, tgeogpoint)
   RETURNS float
   AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistance(tgeompoint, tgeompoint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistance(tgeogpoint, tgeogpoint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistanceWithin(tgeompoint, tgeompoint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistanceWithin(tgeogpoint, tgeogpoint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistanceWithin(tgeompoint, tgeompoint, dist float, band integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpDistanceWithin(tgeogpoint, tgeogpoint, dist float, band integer)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpLowerBound(tgeompoint, tgeompoint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpLowerBound(tgeogpoint, tgeogpoint)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpLowerBound(tgeompoint, tgeompoint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dynTimeWarpLowerBound(tgeogpoint, tgeogpoint, band integer)
+  RETURNS float
+  AS 'MODULE_PATHNAME', 'Temporal_dyntimewarp_lower_bound'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION dynTimeWarpPath(tgeompoint, tgeompoint)
   RETURNS SETOF warp
@@ -82,6 +162,14 @@ CREATE FUNCTION hausdorffDistance(tgeogpoint, tgeogpoint)
   RETURNS float
   AS 'MODULE_PATHNAME', 'Temporal_hausdorff_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hausdorffDistanceWithin(tgeompoint, tgeompoint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_hausdorff_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION hausdorffDistanceWithin(tgeogpoint, tgeogpoint, dist float)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Temporal_hausdorff_distance_within'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************/
 
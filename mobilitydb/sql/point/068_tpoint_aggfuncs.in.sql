@@ -138,6 +138,14 @@ CREATE FUNCTION tcentroid_finalfn(internal)
   RETURNS tgeompoint
   AS 'MODULE_PATHNAME', 'Tpoint_tcentroid_finalfn'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcentroid_serialize(internal)
+  RETURNS bytea
+  AS 'MODULE_PATHNAME', 'Tcentroid_serialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tcentroid_deserialize(bytea, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tcentroid_deserialize'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE AGGREGATE tcentroid(tgeompoint) (
   SFUNC = tcentroid_transfn,
@@ -146,11 +154,57 @@ CREATE AGGREGATE tcentroid(tgeompoint) (
   COMBINEFUNC = tcentroid_combinefn,
 #endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = tcentroid_finalfn,
+  SERIALFUNC = tcentroid_serialize,
+  DESERIALFUNC = tcentroid_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE AGGREGATE tcountState(tgeompoint) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
   SERIALFUNC = taggstate_serialize,
   DESERIALFUNC = taggstate_deserialize,
   PARALLEL = SAFE
 );
 
+CREATE AGGREGATE tcountState(tgeogpoint) (
+  SFUNC = tcount_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_state_finalfn,
+  SERIALFUNC = taggstate_serialize,
+  DESERIALFUNC = taggstate_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE FUNCTION tcentroid_state_finalfn(internal)
+  RETURNS taggstate
+  AS 'MODULE_PATHNAME', 'Tcentroid_state_finalfn'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE tcentroidState(tgeompoint) (
+  SFUNC = tcentroid_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcentroid_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcentroid_state_finalfn,
+  SERIALFUNC = tcentroid_serialize,
+  DESERIALFUNC = tcentroid_deserialize,
+  PARALLEL = SAFE
+);
+
+CREATE FUNCTION tcentroidFinal(taggstate)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Taggstate_tcentroid'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
 
 CREATE FUNCTION temporal_merge_transfn(internal, tgeompoint)
@@ -194,6 +248,70 @@ CREATE AGGREGATE merge(tgeogpoint) (
   PARALLEL = safe
 );
 
+/*****************************************************************************/
+
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tgeompoint, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tgeompoint, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tgeogpoint, interval)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION tcount_distinct_transfn(internal, bigint, tgeogpoint, interval, timestamptz)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Temporal_tcount_distinct_transfn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE tcountDistinct(bigint, tgeompoint, interval) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, tgeompoint, interval, timestamptz) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, tgeogpoint, interval) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+CREATE AGGREGATE tcountDistinct(bigint, tgeogpoint, interval, timestamptz) (
+  SFUNC = tcount_distinct_transfn,
+  STYPE = internal,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = tcount_distinct_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+  FINALFUNC = tcount_distinct_finalfn,
+  SERIALFUNC = tcount_distinct_serialize,
+  DESERIALFUNC = tcount_distinct_deserialize,
+  PARALLEL = SAFE
+);
+
 /*****************************************************************************
  * Append tinstant aggregate functions
  *****************************************************************************/
@@ -229,19 +347,37 @@ CREATE FUNCTION temporal_append_finalfn(tgeogpoint)
   AS 'MODULE_PATHNAME', 'Temporal_append_finalfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+-- The function is not STRICT
+CREATE FUNCTION temporal_app_tinst_combinefn(tgeompoint, tgeompoint)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_app_tinst_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION temporal_app_tinst_combinefn(tgeogpoint, tgeogpoint)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_app_tinst_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 CREATE AGGREGATE appendInstant(tgeompoint) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tgeompoint,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tinst_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 CREATE AGGREGATE appendInstant(tgeogpoint) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tgeogpoint,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tinst_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 
+-- The variants with gaps have no combine function, since the gaps would have
+-- to be reapplied to the merged partial states
 CREATE AGGREGATE appendInstant(tgeompoint, float, interval) (
   SFUNC = temporal_app_tinst_transfn,
   STYPE = tgeompoint,
@@ -267,15 +403,31 @@ CREATE FUNCTION temporal_app_tseq_transfn(tgeogpoint, tgeogpoint)
   AS 'MODULE_PATHNAME', 'Temporal_app_tseq_transfn'
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+-- The function is not STRICT
+CREATE FUNCTION temporal_app_tseq_combinefn(tgeompoint, tgeompoint)
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_app_tseq_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE FUNCTION temporal_app_tseq_combinefn(tgeogpoint, tgeogpoint)
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_app_tseq_combinefn'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
 CREATE AGGREGATE appendSequence(tgeompoint) (
   SFUNC = temporal_app_tseq_transfn,
   STYPE = tgeompoint,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tseq_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
 CREATE AGGREGATE appendSequence(tgeogpoint) (
   SFUNC = temporal_app_tseq_transfn,
   STYPE = tgeogpoint,
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  COMBINEFUNC = temporal_app_tseq_combinefn,
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
   FINALFUNC = temporal_append_finalfn,
   PARALLEL = safe
 );
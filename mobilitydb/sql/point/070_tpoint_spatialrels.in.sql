@@ -194,6 +194,10 @@ CREATE FUNCTION eIntersects(tgeompoint, tgeompoint)
   AS 'MODULE_PATHNAME', 'Eintersects_tpoint_tpoint'
   SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION eIntersects(tgeompoint, tstzspan, stbox, geometry)
+  RETURNS boolean
+  AS 'MODULE_PATHNAME', 'Eintersects_tpoint_span_stbox_geo'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 CREATE FUNCTION aIntersects(geometry, tgeompoint)
   RETURNS boolean
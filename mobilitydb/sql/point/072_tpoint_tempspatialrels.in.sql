@@ -40,6 +40,7 @@
 CREATE FUNCTION tContains(geometry, tgeompoint, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tcontains_geo_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
 /*****************************************************************************
@@ -50,19 +51,23 @@ CREATE FUNCTION tContains(geometry, tgeompoint, atvalue bool DEFAULT NULL)
 CREATE FUNCTION tDisjoint(geometry, tgeompoint, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tdisjoint_geo_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION tDisjoint(tgeompoint, geometry, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tdisjoint_tpoint_geo'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 -- Alias for temporal not equals, that is, tpoint_tne or #<>
 CREATE FUNCTION tDisjoint(tgeompoint, tgeompoint, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tdisjoint_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION tDisjoint(tgeogpoint, tgeogpoint, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tdisjoint_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
 /*****************************************************************************
@@ -73,21 +78,30 @@ CREATE FUNCTION tDisjoint(tgeogpoint, tgeogpoint, atvalue bool DEFAULT NULL)
 CREATE FUNCTION tIntersects(geometry, tgeompoint, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tintersects_geo_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION tIntersects(tgeompoint, geometry, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tintersects_tpoint_geo'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 -- Alias for temporal equals, that is, tpoint_teq or #=
 CREATE FUNCTION tIntersects(tgeompoint, tgeompoint, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tintersects_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION tIntersects(tgeogpoint, tgeogpoint, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tintersects_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
+CREATE FUNCTION whenIntersects(tgeompoint, geometry[])
+  RETURNS SETOF int_tstzspanset
+  AS 'MODULE_PATHNAME', 'Tintersects_tpoint_geoarr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************
  * tTouches
  *****************************************************************************/
@@ -96,10 +110,12 @@ CREATE FUNCTION tIntersects(tgeogpoint, tgeogpoint, atvalue bool DEFAULT NULL)
 CREATE FUNCTION tTouches(geometry, tgeompoint, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Ttouches_geo_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 CREATE FUNCTION tTouches(tgeompoint, geometry, atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Ttouches_tpoint_geo'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE PARALLEL SAFE;
 
 /*****************************************************************************
@@ -110,16 +126,38 @@ CREATE FUNCTION tDwithin(geometry, tgeompoint, dist float,
    atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tdwithin_geo_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE  PARALLEL SAFE;
 CREATE FUNCTION tDwithin(tgeompoint, geometry, dist float,
     atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tdwithin_tpoint_geo'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE  PARALLEL SAFE;
 CREATE FUNCTION tDwithin(tgeompoint, tgeompoint, dist float,
     atvalue bool DEFAULT NULL)
   RETURNS tbool
   AS 'MODULE_PATHNAME', 'Tdwithin_tpoint_tpoint'
+  SUPPORT tpoint_supportfn
   LANGUAGE C IMMUTABLE  PARALLEL SAFE;
 
+/*****************************************************************************
+ * dwithinPairs
+ *****************************************************************************/
+
+CREATE TYPE index_index_tstzspanset AS (
+  index1 integer,
+  index2 integer,
+  time tstzspanset
+);
+
+CREATE FUNCTION dwithinPairs(tgeompoint[], tgeompoint[], dist float)
+  RETURNS SETOF index_index_tstzspanset
+  AS 'MODULE_PATHNAME', 'Tdwithin_tpointarr_tpointarr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION dwithinPairs(tgeompoint[], dist float)
+  RETURNS SETOF index_index_tstzspanset
+  AS 'MODULE_PATHNAME', 'Tdwithin_tpointarr_tpointarr'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 /*****************************************************************************/
@@ -56,6 +56,16 @@ CREATE FUNCTION stbox_gist_distance(internal, stbox, smallint, oid, internal)
   RETURNS internal
   AS 'MODULE_PATHNAME', 'Stbox_gist_distance'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox_gist_fetch(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Stbox_gist_fetch'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+CREATE FUNCTION stbox_gist_sortsupport(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Stbox_gist_sortsupport'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
 
 CREATE OPERATOR CLASS stbox_rtree_ops
   DEFAULT FOR TYPE stbox USING gist AS
@@ -142,7 +152,11 @@ CREATE OPERATOR CLASS stbox_rtree_ops
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
   FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
-  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  stbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal),
+  FUNCTION  9  stbox_gist_fetch(internal);
 
 /******************************************************************************/
 
@@ -172,6 +186,7 @@ CREATE OPERATOR CLASS tgeompoint_rtree_ops
   OPERATOR  3    && (tgeompoint, tstzspan),
   OPERATOR  3    && (tgeompoint, stbox),
   OPERATOR  3    && (tgeompoint, tgeompoint),
+  OPERATOR  3    && (tgeompoint, stbox[]),
   -- overlaps or right
   OPERATOR  4    &> (tgeompoint, stbox),
   OPERATOR  4    &> (tgeompoint, tgeompoint),
@@ -244,6 +259,9 @@ CREATE OPERATOR CLASS tgeompoint_rtree_ops
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
   FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  stbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
 
 CREATE OPERATOR CLASS tgeogpoint_rtree_ops
@@ -253,6 +271,7 @@ CREATE OPERATOR CLASS tgeogpoint_rtree_ops
   OPERATOR  3    && (tgeogpoint, tstzspan),
   OPERATOR  3    && (tgeogpoint, stbox),
   OPERATOR  3    && (tgeogpoint, tgeogpoint),
+  OPERATOR  3    && (tgeogpoint, stbox[]),
     -- same
   OPERATOR  6    ~= (tgeogpoint, tstzspan),
   OPERATOR  6    ~= (tgeogpoint, stbox),
@@ -295,6 +314,565 @@ CREATE OPERATOR CLASS tgeogpoint_rtree_ops
   FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
   FUNCTION  6  stbox_gist_picksplit(internal, internal),
   FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  stbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Multi-box R-tree GiST index for temporal points
+ *
+ * The leaf entries store up to max_count boxes computed by stboxes(), e.g.,
+ *   CREATE INDEX ON trips USING gist(trip tgeompoint_mrtree_ops(max_count = 16));
+ * Since PostgreSQL 14 the index is built by sorting the leaf entries and
+ * packing them into pages, unless the index is created with buffering = on.
+ ******************************************************************************/
+
+CREATE FUNCTION mgist_tgeompoint_consistent(internal, tgeompoint, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION mgist_tgeogpoint_consistent(internal, tgeogpoint, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_mgist_union(internal, internal)
+  RETURNS stbox[]
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_mgist_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_mgist_penalty(internal, internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_penalty'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_mgist_picksplit(internal, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_picksplit'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_mgist_same(stbox[], stbox[], internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_same'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_mgist_distance(internal, stbox, smallint, oid, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_distance'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+CREATE FUNCTION tpoint_mgist_options(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_options'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+CREATE FUNCTION tpoint_mgist_sortsupport(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_sortsupport'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+
+CREATE OPERATOR CLASS tgeompoint_mrtree_ops
+  FOR TYPE tgeompoint USING gist AS
+  STORAGE stbox[],
+  -- strictly left
+  OPERATOR  1    << (tgeompoint, stbox),
+  OPERATOR  1    << (tgeompoint, tgeompoint),
+  -- overlaps or left
+  OPERATOR  2    &< (tgeompoint, stbox),
+  OPERATOR  2    &< (tgeompoint, tgeompoint),
+  -- overlaps
+  OPERATOR  3    && (tgeompoint, tstzspan),
+  OPERATOR  3    && (tgeompoint, stbox),
+  OPERATOR  3    && (tgeompoint, tgeompoint),
+  OPERATOR  3    && (tgeompoint, stbox[]),
+  -- overlaps or right
+  OPERATOR  4    &> (tgeompoint, stbox),
+  OPERATOR  4    &> (tgeompoint, tgeompoint),
+    -- strictly right
+  OPERATOR  5    >> (tgeompoint, stbox),
+  OPERATOR  5    >> (tgeompoint, tgeompoint),
+    -- same
+  OPERATOR  6    ~= (tgeompoint, tstzspan),
+  OPERATOR  6    ~= (tgeompoint, stbox),
+  OPERATOR  6    ~= (tgeompoint, tgeompoint),
+  -- contains
+  OPERATOR  7    @> (tgeompoint, tstzspan),
+  OPERATOR  7    @> (tgeompoint, stbox),
+  OPERATOR  7    @> (tgeompoint, tgeompoint),
+  -- contained by
+  OPERATOR  8    <@ (tgeompoint, tstzspan),
+  OPERATOR  8    <@ (tgeompoint, stbox),
+  OPERATOR  8    <@ (tgeompoint, tgeompoint),
+  -- overlaps or below
+  OPERATOR  9    &<| (tgeompoint, stbox),
+  OPERATOR  9    &<| (tgeompoint, tgeompoint),
+  -- strictly below
+  OPERATOR  10    <<| (tgeompoint, stbox),
+  OPERATOR  10    <<| (tgeompoint, tgeompoint),
+  -- strictly above
+  OPERATOR  11    |>> (tgeompoint, stbox),
+  OPERATOR  11    |>> (tgeompoint, tgeompoint),
+  -- overlaps or above
+  OPERATOR  12    |&> (tgeompoint, stbox),
+  OPERATOR  12    |&> (tgeompoint, tgeompoint),
+  -- adjacent
+  OPERATOR  17    -|- (tgeompoint, tstzspan),
+  OPERATOR  17    -|- (tgeompoint, stbox),
+  OPERATOR  17    -|- (tgeompoint, tgeompoint),
+  -- nearest approach distance
+  OPERATOR  25    |=| (tgeompoint, stbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tgeompoint, tgeompoint) FOR ORDER BY pg_catalog.float_ops,
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeompoint, tstzspan),
+  OPERATOR  28    &<# (tgeompoint, stbox),
+  OPERATOR  28    &<# (tgeompoint, tgeompoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeompoint, tstzspan),
+  OPERATOR  29    <<# (tgeompoint, stbox),
+  OPERATOR  29    <<# (tgeompoint, tgeompoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeompoint, tstzspan),
+  OPERATOR  30    #>> (tgeompoint, stbox),
+  OPERATOR  30    #>> (tgeompoint, tgeompoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeompoint, tstzspan),
+  OPERATOR  31    #&> (tgeompoint, stbox),
+  OPERATOR  31    #&> (tgeompoint, tgeompoint),
+  -- overlaps or front
+  OPERATOR  32    &</ (tgeompoint, stbox),
+  OPERATOR  32    &</ (tgeompoint, tgeompoint),
+  -- strictly front
+  OPERATOR  33    <</ (tgeompoint, stbox),
+  OPERATOR  33    <</ (tgeompoint, tgeompoint),
+  -- strictly back
+  OPERATOR  34    />> (tgeompoint, stbox),
+  OPERATOR  34    />> (tgeompoint, tgeompoint),
+  -- overlaps or back
+  OPERATOR  35    /&> (tgeompoint, stbox),
+  OPERATOR  35    /&> (tgeompoint, tgeompoint),
+  -- functions
+  FUNCTION  1  mgist_tgeompoint_consistent(internal, tgeompoint, smallint, oid, internal),
+  FUNCTION  2  tpoint_mgist_union(internal, internal),
+  FUNCTION  3  tpoint_mgist_compress(internal),
+  FUNCTION  5  tpoint_mgist_penalty(internal, internal, internal),
+  FUNCTION  6  tpoint_mgist_picksplit(internal, internal),
+  FUNCTION  7  tpoint_mgist_same(stbox[], stbox[], internal),
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  10  tpoint_mgist_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  tpoint_mgist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  8  tpoint_mgist_distance(internal, stbox, smallint, oid, internal);
+
+CREATE OPERATOR CLASS tgeogpoint_mrtree_ops
+  FOR TYPE tgeogpoint USING gist AS
+  STORAGE stbox[],
+  -- overlaps
+  OPERATOR  3    && (tgeogpoint, tstzspan),
+  OPERATOR  3    && (tgeogpoint, stbox),
+  OPERATOR  3    && (tgeogpoint, tgeogpoint),
+  OPERATOR  3    && (tgeogpoint, stbox[]),
+    -- same
+  OPERATOR  6    ~= (tgeogpoint, tstzspan),
+  OPERATOR  6    ~= (tgeogpoint, stbox),
+  OPERATOR  6    ~= (tgeogpoint, tgeogpoint),
+  -- contains
+  OPERATOR  7    @> (tgeogpoint, tstzspan),
+  OPERATOR  7    @> (tgeogpoint, stbox),
+  OPERATOR  7    @> (tgeogpoint, tgeogpoint),
+  -- contained by
+  OPERATOR  8    <@ (tgeogpoint, tstzspan),
+  OPERATOR  8    <@ (tgeogpoint, stbox),
+  OPERATOR  8    <@ (tgeogpoint, tgeogpoint),
+  -- adjacent
+  OPERATOR  17    -|- (tgeogpoint, tstzspan),
+  OPERATOR  17    -|- (tgeogpoint, stbox),
+  OPERATOR  17    -|- (tgeogpoint, tgeogpoint),
+  -- distance
+  OPERATOR  25    |=| (tgeogpoint, stbox) FOR ORDER BY pg_catalog.float_ops,
+  OPERATOR  25    |=| (tgeogpoint, tgeogpoint) FOR ORDER BY pg_catalog.float_ops,
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeogpoint, tstzspan),
+  OPERATOR  28    &<# (tgeogpoint, stbox),
+  OPERATOR  28    &<# (tgeogpoint, tgeogpoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeogpoint, tstzspan),
+  OPERATOR  29    <<# (tgeogpoint, stbox),
+  OPERATOR  29    <<# (tgeogpoint, tgeogpoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeogpoint, tstzspan),
+  OPERATOR  30    #>> (tgeogpoint, stbox),
+  OPERATOR  30    #>> (tgeogpoint, tgeogpoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeogpoint, tstzspan),
+  OPERATOR  31    #&> (tgeogpoint, stbox),
+  OPERATOR  31    #&> (tgeogpoint, tgeogpoint),
+  -- functions
+  FUNCTION  1  mgist_tgeogpoint_consistent(internal, tgeogpoint, smallint, oid, internal),
+  FUNCTION  2  tpoint_mgist_union(internal, internal),
+  FUNCTION  3  tpoint_mgist_compress(internal),
+  FUNCTION  5  tpoint_mgist_penalty(internal, internal, internal),
+  FUNCTION  6  tpoint_mgist_picksplit(internal, internal),
+  FUNCTION  7  tpoint_mgist_same(stbox[], stbox[], internal),
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  10  tpoint_mgist_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  tpoint_mgist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  8  tpoint_mgist_distance(internal, stbox, smallint, oid, internal);
+
+/******************************************************************************/
+
+/******************************************************************************
+ * R-tree GiST indexes for spatial sets
+ *
+ * The key of a set is its bounding box. The multi-box operator classes store
+ * instead up to max_count boxes obtained by merging the boxes of the elements
+ * that are close in Hilbert order, e.g.,
+ *   CREATE INDEX ON tbl USING gist(g geomset_mrtree_ops(max_count = 16));
+ ******************************************************************************/
+
+CREATE FUNCTION gist_geomset_consistent(internal, geomset, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Stbox_gist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist_geogset_consistent(internal, geogset, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Stbox_gist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spatialset_gist_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Spatialset_gist_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS geomset_rtree_ops
+  DEFAULT FOR TYPE geomset USING gist AS
+  STORAGE stbox,
+  -- overlaps
+  OPERATOR  3    && (geomset, geomset),
+  -- same
+  OPERATOR  6    = (geomset, geomset),
+  -- contains
+  OPERATOR  7    @> (geomset, geometry),
+  OPERATOR  7    @> (geomset, geomset),
+  -- contained by
+  OPERATOR  8    <@ (geomset, geomset),
+  -- functions
+  FUNCTION  1  gist_geomset_consistent(internal, geomset, smallint, oid, internal),
+  FUNCTION  2  stbox_gist_union(internal, internal),
+  FUNCTION  3  spatialset_gist_compress(internal),
+  FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
+  FUNCTION  6  stbox_gist_picksplit(internal, internal),
+  FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  stbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
+
+CREATE OPERATOR CLASS geogset_rtree_ops
+  DEFAULT FOR TYPE geogset USING gist AS
+  STORAGE stbox,
+  -- overlaps
+  OPERATOR  3    && (geogset, geogset),
+  -- same
+  OPERATOR  6    = (geogset, geogset),
+  -- contains
+  OPERATOR  7    @> (geogset, geography),
+  OPERATOR  7    @> (geogset, geogset),
+  -- contained by
+  OPERATOR  8    <@ (geogset, geogset),
+  -- functions
+  FUNCTION  1  gist_geogset_consistent(internal, geogset, smallint, oid, internal),
+  FUNCTION  2  stbox_gist_union(internal, internal),
+  FUNCTION  3  spatialset_gist_compress(internal),
+  FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
+  FUNCTION  6  stbox_gist_picksplit(internal, internal),
+  FUNCTION  7  stbox_gist_same(stbox, stbox, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  stbox_gist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  8  stbox_gist_distance(internal, stbox, smallint, oid, internal);
 
 /******************************************************************************/
+
+CREATE FUNCTION mgist_geomset_consistent(internal, geomset, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION mgist_geogset_consistent(internal, geogset, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Tpoint_mgist_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION spatialset_mgist_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Spatialset_mgist_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS geomset_mrtree_ops
+  FOR TYPE geomset USING gist AS
+  STORAGE stbox[],
+  -- overlaps
+  OPERATOR  3    && (geomset, geomset),
+  -- same
+  OPERATOR  6    = (geomset, geomset),
+  -- contains
+  OPERATOR  7    @> (geomset, geometry),
+  OPERATOR  7    @> (geomset, geomset),
+  -- contained by
+  OPERATOR  8    <@ (geomset, geomset),
+  -- functions
+  FUNCTION  1  mgist_geomset_consistent(internal, geomset, smallint, oid, internal),
+  FUNCTION  2  tpoint_mgist_union(internal, internal),
+  FUNCTION  3  spatialset_mgist_compress(internal),
+  FUNCTION  5  tpoint_mgist_penalty(internal, internal, internal),
+  FUNCTION  6  tpoint_mgist_picksplit(internal, internal),
+  FUNCTION  7  tpoint_mgist_same(stbox[], stbox[], internal),
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  10  tpoint_mgist_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  tpoint_mgist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  8  tpoint_mgist_distance(internal, stbox, smallint, oid, internal);
+
+CREATE OPERATOR CLASS geogset_mrtree_ops
+  FOR TYPE geogset USING gist AS
+  STORAGE stbox[],
+  -- overlaps
+  OPERATOR  3    && (geogset, geogset),
+  -- same
+  OPERATOR  6    = (geogset, geogset),
+  -- contains
+  OPERATOR  7    @> (geogset, geography),
+  OPERATOR  7    @> (geogset, geogset),
+  -- contained by
+  OPERATOR  8    <@ (geogset, geogset),
+  -- functions
+  FUNCTION  1  mgist_geogset_consistent(internal, geogset, smallint, oid, internal),
+  FUNCTION  2  tpoint_mgist_union(internal, internal),
+  FUNCTION  3  spatialset_mgist_compress(internal),
+  FUNCTION  5  tpoint_mgist_penalty(internal, internal, internal),
+  FUNCTION  6  tpoint_mgist_picksplit(internal, internal),
+  FUNCTION  7  tpoint_mgist_same(stbox[], stbox[], internal),
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  FUNCTION  10  tpoint_mgist_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 130000
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION 11  tpoint_mgist_sortsupport(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  8  tpoint_mgist_distance(internal, stbox, smallint, oid, internal);
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Lossy R-tree GiST index for temporal points with float4 keys
+ *
+ * The keys are of type stbox4, which stores the coordinates as floats and
+ * the timestamps in seconds, rounded outward, e.g.,
+ *   CREATE INDEX ON trips USING gist(trip tgeompoint_rtree_float4_ops);
+ ******************************************************************************/
+
+CREATE TYPE stbox4;
+
+CREATE FUNCTION stbox4_in(cstring)
+  RETURNS stbox4
+  AS 'MODULE_PATHNAME', 'Stbox4_in'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox4_out(stbox4)
+  RETURNS cstring
+  AS 'MODULE_PATHNAME', 'Stbox4_out'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE stbox4 (
+  internallength = 36,
+  input = stbox4_in,
+  output = stbox4_out,
+  storage = plain,
+  alignment = int4
+);
+
+CREATE FUNCTION gist4_tgeompoint_consistent(internal, tgeompoint, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Tpoint_gist4_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION gist4_tgeogpoint_consistent(internal, tgeogpoint, smallint, oid, internal)
+  RETURNS bool
+  AS 'MODULE_PATHNAME', 'Tpoint_gist4_consistent'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox4_gist_union(internal, internal)
+  RETURNS stbox4
+  AS 'MODULE_PATHNAME', 'Stbox_gist_union'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tpoint_gist4_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Tpoint_gist4_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox4_gist_decompress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Stbox4_gist_decompress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION stbox4_gist_same(stbox4, stbox4, internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Stbox_gist_same'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tgeompoint_rtree_float4_ops
+  FOR TYPE tgeompoint USING gist AS
+  STORAGE stbox4,
+  -- strictly left
+  OPERATOR  1    << (tgeompoint, stbox),
+  OPERATOR  1    << (tgeompoint, tgeompoint),
+  -- overlaps or left
+  OPERATOR  2    &< (tgeompoint, stbox),
+  OPERATOR  2    &< (tgeompoint, tgeompoint),
+  -- overlaps
+  OPERATOR  3    && (tgeompoint, tstzspan),
+  OPERATOR  3    && (tgeompoint, stbox),
+  OPERATOR  3    && (tgeompoint, tgeompoint),
+  OPERATOR  3    && (tgeompoint, stbox[]),
+  -- overlaps or right
+  OPERATOR  4    &> (tgeompoint, stbox),
+  OPERATOR  4    &> (tgeompoint, tgeompoint),
+    -- strictly right
+  OPERATOR  5    >> (tgeompoint, stbox),
+  OPERATOR  5    >> (tgeompoint, tgeompoint),
+    -- same
+  OPERATOR  6    ~= (tgeompoint, tstzspan),
+  OPERATOR  6    ~= (tgeompoint, stbox),
+  OPERATOR  6    ~= (tgeompoint, tgeompoint),
+  -- contains
+  OPERATOR  7    @> (tgeompoint, tstzspan),
+  OPERATOR  7    @> (tgeompoint, stbox),
+  OPERATOR  7    @> (tgeompoint, tgeompoint),
+  -- contained by
+  OPERATOR  8    <@ (tgeompoint, tstzspan),
+  OPERATOR  8    <@ (tgeompoint, stbox),
+  OPERATOR  8    <@ (tgeompoint, tgeompoint),
+  -- overlaps or below
+  OPERATOR  9    &<| (tgeompoint, stbox),
+  OPERATOR  9    &<| (tgeompoint, tgeompoint),
+  -- strictly below
+  OPERATOR  10    <<| (tgeompoint, stbox),
+  OPERATOR  10    <<| (tgeompoint, tgeompoint),
+  -- strictly above
+  OPERATOR  11    |>> (tgeompoint, stbox),
+  OPERATOR  11    |>> (tgeompoint, tgeompoint),
+  -- overlaps or above
+  OPERATOR  12    |&> (tgeompoint, stbox),
+  OPERATOR  12    |&> (tgeompoint, tgeompoint),
+  -- adjacent
+  OPERATOR  17    -|- (tgeompoint, tstzspan),
+  OPERATOR  17    -|- (tgeompoint, stbox),
+  OPERATOR  17    -|- (tgeompoint, tgeompoint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeompoint, tstzspan),
+  OPERATOR  28    &<# (tgeompoint, stbox),
+  OPERATOR  28    &<# (tgeompoint, tgeompoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeompoint, tstzspan),
+  OPERATOR  29    <<# (tgeompoint, stbox),
+  OPERATOR  29    <<# (tgeompoint, tgeompoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeompoint, tstzspan),
+  OPERATOR  30    #>> (tgeompoint, stbox),
+  OPERATOR  30    #>> (tgeompoint, tgeompoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeompoint, tstzspan),
+  OPERATOR  31    #&> (tgeompoint, stbox),
+  OPERATOR  31    #&> (tgeompoint, tgeompoint),
+  -- overlaps or front
+  OPERATOR  32    &</ (tgeompoint, stbox),
+  OPERATOR  32    &</ (tgeompoint, tgeompoint),
+  -- strictly front
+  OPERATOR  33    <</ (tgeompoint, stbox),
+  OPERATOR  33    <</ (tgeompoint, tgeompoint),
+  -- strictly back
+  OPERATOR  34    />> (tgeompoint, stbox),
+  OPERATOR  34    />> (tgeompoint, tgeompoint),
+  -- overlaps or back
+  OPERATOR  35    /&> (tgeompoint, stbox),
+  OPERATOR  35    /&> (tgeompoint, tgeompoint),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  -- functions
+  FUNCTION  1  gist4_tgeompoint_consistent(internal, tgeompoint, smallint, oid, internal),
+  FUNCTION  2  stbox4_gist_union(internal, internal),
+  FUNCTION  3  tpoint_gist4_compress(internal),
+  FUNCTION  4  stbox4_gist_decompress(internal),
+  FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
+  FUNCTION  6  stbox_gist_picksplit(internal, internal),
+  FUNCTION  7  stbox4_gist_same(stbox4, stbox4, internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS tgeogpoint_rtree_float4_ops
+  FOR TYPE tgeogpoint USING gist AS
+  STORAGE stbox4,
+  -- overlaps
+  OPERATOR  3    && (tgeogpoint, tstzspan),
+  OPERATOR  3    && (tgeogpoint, stbox),
+  OPERATOR  3    && (tgeogpoint, tgeogpoint),
+  OPERATOR  3    && (tgeogpoint, stbox[]),
+    -- same
+  OPERATOR  6    ~= (tgeogpoint, tstzspan),
+  OPERATOR  6    ~= (tgeogpoint, stbox),
+  OPERATOR  6    ~= (tgeogpoint, tgeogpoint),
+  -- contains
+  OPERATOR  7    @> (tgeogpoint, tstzspan),
+  OPERATOR  7    @> (tgeogpoint, stbox),
+  OPERATOR  7    @> (tgeogpoint, tgeogpoint),
+  -- contained by
+  OPERATOR  8    <@ (tgeogpoint, tstzspan),
+  OPERATOR  8    <@ (tgeogpoint, stbox),
+  OPERATOR  8    <@ (tgeogpoint, tgeogpoint),
+  -- adjacent
+  OPERATOR  17    -|- (tgeogpoint, tstzspan),
+  OPERATOR  17    -|- (tgeogpoint, stbox),
+  OPERATOR  17    -|- (tgeogpoint, tgeogpoint),
+  -- overlaps or before
+  OPERATOR  28    &<# (tgeogpoint, tstzspan),
+  OPERATOR  28    &<# (tgeogpoint, stbox),
+  OPERATOR  28    &<# (tgeogpoint, tgeogpoint),
+  -- strictly before
+  OPERATOR  29    <<# (tgeogpoint, tstzspan),
+  OPERATOR  29    <<# (tgeogpoint, stbox),
+  OPERATOR  29    <<# (tgeogpoint, tgeogpoint),
+  -- strictly after
+  OPERATOR  30    #>> (tgeogpoint, tstzspan),
+  OPERATOR  30    #>> (tgeogpoint, stbox),
+  OPERATOR  30    #>> (tgeogpoint, tgeogpoint),
+  -- overlaps or after
+  OPERATOR  31    #&> (tgeogpoint, tstzspan),
+  OPERATOR  31    #&> (tgeogpoint, stbox),
+  OPERATOR  31    #&> (tgeogpoint, tgeogpoint),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  -- functions
+  FUNCTION  1  gist4_tgeogpoint_consistent(internal, tgeogpoint, smallint, oid, internal),
+  FUNCTION  2  stbox4_gist_union(internal, internal),
+  FUNCTION  3  tpoint_gist4_compress(internal),
+  FUNCTION  4  stbox4_gist_decompress(internal),
+  FUNCTION  5  stbox_gist_penalty(internal, internal, internal),
+  FUNCTION  6  stbox_gist_picksplit(internal, internal),
+  FUNCTION  7  stbox4_gist_same(stbox4, stbox4, internal);
+
+/******************************************************************************/
+
+/******************************************************************************
+ * Index inspection
+ ******************************************************************************/
+
+CREATE FUNCTION mobilitydb_gist_probe(index regclass, query stbox,
+    OUT innerPages bigint, OUT leafPages bigint, OUT candidates bigint)
+  AS 'MODULE_PATHNAME', 'Index_gist_probe'
+  LANGUAGE C VOLATILE STRICT;
+
+/******************************************************************************/
@@ -154,6 +154,12 @@ CREATE FUNCTION stbox_kdtree_inner_consistent(internal, internal)
   RETURNS void
   AS 'MODULE_PATHNAME', 'Stbox_kdtree_inner_consistent'
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+CREATE FUNCTION stbox_kdtree_options(internal)
+  RETURNS void
+  AS 'MODULE_PATHNAME', 'Stbox_kdtree_options'
+  LANGUAGE C IMMUTABLE PARALLEL SAFE;
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
 
 /******************************************************************************/
 
@@ -236,6 +242,9 @@ CREATE OPERATOR CLASS stbox_kdtree_ops
   FUNCTION  2  stbox_kdtree_choose(internal, internal),
   FUNCTION  3  stbox_kdtree_picksplit(internal, internal),
   FUNCTION  4  stbox_kdtree_inner_consistent(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  7  stbox_kdtree_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  5  stbox_spgist_leaf_consistent(internal, internal);
 
 /******************************************************************************/
@@ -409,6 +418,9 @@ CREATE OPERATOR CLASS tgeompoint_kdtree_ops
   FUNCTION  2  stbox_kdtree_choose(internal, internal),
   FUNCTION  3  stbox_kdtree_picksplit(internal, internal),
   FUNCTION  4  stbox_kdtree_inner_consistent(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  7  stbox_kdtree_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  5  stbox_spgist_leaf_consistent(internal, internal),
   FUNCTION  6  tpoint_spgist_compress(internal);
 
@@ -510,7 +522,109 @@ CREATE OPERATOR CLASS tgeogpoint_kdtree_ops
   FUNCTION  2  stbox_kdtree_choose(internal, internal),
   FUNCTION  3  stbox_kdtree_picksplit(internal, internal),
   FUNCTION  4  stbox_kdtree_inner_consistent(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  7  stbox_kdtree_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
   FUNCTION  5  stbox_spgist_leaf_consistent(internal, internal),
   FUNCTION  6  tpoint_spgist_compress(internal);
 
 /******************************************************************************/
+
+/******************************************************************************
+ * Quad-tree and k-d tree SP-GiST indexes for spatial sets
+ ******************************************************************************/
+
+CREATE FUNCTION spatialset_spgist_compress(internal)
+  RETURNS internal
+  AS 'MODULE_PATHNAME', 'Spatialset_spgist_compress'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS geomset_quadtree_ops
+  DEFAULT FOR TYPE geomset USING spgist AS
+  -- overlaps
+  OPERATOR  3    && (geomset, geomset),
+  -- same
+  OPERATOR  6    = (geomset, geomset),
+  -- contains
+  OPERATOR  7    @> (geomset, geometry),
+  OPERATOR  7    @> (geomset, geomset),
+  -- contained by
+  OPERATOR  8    <@ (geomset, geomset),
+  -- functions
+  FUNCTION  1  stbox_spgist_config(internal, internal),
+  FUNCTION  2  stbox_quadtree_choose(internal, internal),
+  FUNCTION  3  stbox_quadtree_picksplit(internal, internal),
+  FUNCTION  4  stbox_quadtree_inner_consistent(internal, internal),
+  FUNCTION  5  stbox_spgist_leaf_consistent(internal, internal),
+  FUNCTION  6  spatialset_spgist_compress(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS geomset_kdtree_ops
+  FOR TYPE geomset USING spgist AS
+  -- overlaps
+  OPERATOR  3    && (geomset, geomset),
+  -- same
+  OPERATOR  6    = (geomset, geomset),
+  -- contains
+  OPERATOR  7    @> (geomset, geometry),
+  OPERATOR  7    @> (geomset, geomset),
+  -- contained by
+  OPERATOR  8    <@ (geomset, geomset),
+  -- functions
+  FUNCTION  1  stbox_spgist_config(internal, internal),
+  FUNCTION  2  stbox_kdtree_choose(internal, internal),
+  FUNCTION  3  stbox_kdtree_picksplit(internal, internal),
+  FUNCTION  4  stbox_kdtree_inner_consistent(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  7  stbox_kdtree_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  5  stbox_spgist_leaf_consistent(internal, internal),
+  FUNCTION  6  spatialset_spgist_compress(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS geogset_quadtree_ops
+  DEFAULT FOR TYPE geogset USING spgist AS
+  -- overlaps
+  OPERATOR  3    && (geogset, geogset),
+  -- same
+  OPERATOR  6    = (geogset, geogset),
+  -- contains
+  OPERATOR  7    @> (geogset, geography),
+  OPERATOR  7    @> (geogset, geogset),
+  -- contained by
+  OPERATOR  8    <@ (geogset, geogset),
+  -- functions
+  FUNCTION  1  stbox_spgist_config(internal, internal),
+  FUNCTION  2  stbox_quadtree_choose(internal, internal),
+  FUNCTION  3  stbox_quadtree_picksplit(internal, internal),
+  FUNCTION  4  stbox_quadtree_inner_consistent(internal, internal),
+  FUNCTION  5  stbox_spgist_leaf_consistent(internal, internal),
+  FUNCTION  6  spatialset_spgist_compress(internal);
+
+/******************************************************************************/
+
+CREATE OPERATOR CLASS geogset_kdtree_ops
+  FOR TYPE geogset USING spgist AS
+  -- overlaps
+  OPERATOR  3    && (geogset, geogset),
+  -- same
+  OPERATOR  6    = (geogset, geogset),
+  -- contains
+  OPERATOR  7    @> (geogset, geography),
+  OPERATOR  7    @> (geogset, geogset),
+  -- contained by
+  OPERATOR  8    <@ (geogset, geogset),
+  -- functions
+  FUNCTION  1  stbox_spgist_config(internal, internal),
+  FUNCTION  2  stbox_kdtree_choose(internal, internal),
+  FUNCTION  3  stbox_kdtree_picksplit(internal, internal),
+  FUNCTION  4  stbox_kdtree_inner_consistent(internal, internal),
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  7  stbox_kdtree_options(internal),
+#endif //POSTGRESQL_VERSION_NUMBER >= 140000
+  FUNCTION  5  stbox_spgist_leaf_consistent(internal, internal),
+  FUNCTION  6  spatialset_spgist_compress(internal);
+
+/******************************************************************************/
@@ -130,6 +130,45 @@ RETURNS tgeompoint
 AS 'MODULE_PATHNAME', 'Temporal_simplify_dp'
 LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+CREATE FUNCTION douglasPeuckerWeights(tfloat, boolean DEFAULT TRUE)
+RETURNS float[]
+AS 'MODULE_PATHNAME', 'Temporal_simplify_dp_weights'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION douglasPeuckerWeights(tgeompoint, boolean DEFAULT TRUE)
+RETURNS float[]
+AS 'MODULE_PATHNAME', 'Temporal_simplify_dp_weights'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION douglasPeuckerSimplify(tfloat, float[], float)
+RETURNS tfloat
+AS 'MODULE_PATHNAME', 'Temporal_simplify_dp_select'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION douglasPeuckerSimplify(tgeompoint, float[], float)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'Temporal_simplify_dp_select'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE FUNCTION numPointsSimplify(tfloat, integer, boolean DEFAULT TRUE)
+RETURNS tfloat
+AS 'MODULE_PATHNAME', 'Temporal_simplify_npoints'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION numPointsSimplify(tgeompoint, integer, boolean DEFAULT TRUE)
+RETURNS tgeompoint
+AS 'MODULE_PATHNAME', 'Temporal_simplify_npoints'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************
+ * Clustering functions
+ *****************************************************************************/
+
+CREATE FUNCTION stdbscan(tgeompoint, eps_space float, eps_time interval,
+  minpts integer)
+RETURNS integer
+AS 'MODULE_PATHNAME', 'Tpoint_stdbscan'
+LANGUAGE C IMMUTABLE WINDOW PARALLEL SAFE;
+
+/*****************************************************************************/
+
 CREATE TYPE geom_times AS (
   geom geometry,
   times bigint[]
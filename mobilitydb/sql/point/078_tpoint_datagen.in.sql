@@ -38,3 +38,41 @@ CREATE FUNCTION create_trip(record[], timestamptz, boolean, text)
   LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Random generation of temporal points
+ * These functions are the C counterpart of the PL/pgSQL generators of the
+ * datagen directory. The coordinates, the SRID, and the timestamps are bounded
+ * by the box. The SRID 4326 is used for geography points when the box has no
+ * SRID.
+ *****************************************************************************/
+
+CREATE FUNCTION tgeompointRandom(bounds stbox, maxdelta float, maxminutes int,
+    mininsts int, maxinsts int, minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'linear')
+  RETURNS tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_random'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+CREATE FUNCTION tgeogpointRandom(bounds stbox, maxdelta float, maxminutes int,
+    mininsts int, maxinsts int, minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'linear')
+  RETURNS tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_random'
+  LANGUAGE C VOLATILE STRICT PARALLEL RESTRICTED;
+
+CREATE FUNCTION tgeompointRandomBulk(count int, seed bigint, bounds stbox,
+    maxdelta float, maxminutes int, mininsts int, maxinsts int,
+    minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'linear')
+  RETURNS SETOF tgeompoint
+  AS 'MODULE_PATHNAME', 'Temporal_random_bulk'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE FUNCTION tgeogpointRandomBulk(count int, seed bigint, bounds stbox,
+    maxdelta float, maxminutes int, mininsts int, maxinsts int,
+    minseqs int DEFAULT 1, maxseqs int DEFAULT 1,
+    subtype text DEFAULT 'Sequence', interp text DEFAULT 'linear')
+  RETURNS SETOF tgeogpoint
+  AS 'MODULE_PATHNAME', 'Temporal_random_bulk'
+  LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+/*****************************************************************************/
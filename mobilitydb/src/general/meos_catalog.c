@@ -47,6 +47,12 @@
  * For MEOS operator info -> Oid we use a three-dimensional array containing
  * all possible combinations of operator/left argument/right argument.
  * The invalid combinations are initialized to 0.
+ *
+ * When the library is loaded in `shared_preload_libraries`, the caches are
+ * kept in shared memory for a number of databases given by the parameter
+ * `mobilitydb.oid_cache_databases`, so that only the first backend connected
+ * to a database scans the catalog. The caches are invalidated at the end of
+ * the transactions that create, alter, or drop an extension.
  */
 
 #include "pg_general/meos_catalog.h"
@@ -58,10 +64,12 @@
 #include <access/heapam.h>
 #include <access/htup_details.h>
 #include <access/tableam.h>
+#include <access/xact.h>
 #if POSTGRESQL_VERSION_NUMBER < 140000
 #include <catalog/indexing.h>
 #endif
 #include <catalog/namespace.h>
+#include <catalog/objectaccess.h>
 #include <catalog/pg_extension.h>
 #include <catalog/pg_type.h>
 #include <commands/extension.h>
@@ -70,6 +78,10 @@
 #else
   #include "general/pg_types.h"
 #endif
+#include <port/atomics.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
 #include <utils/fmgroids.h>
 #include <utils/syscache.h>
 #include <utils/rel.h>
@@ -83,63 +95,126 @@ extern int namestrcmp(Name name, const char *str);
 /*****************************************************************************/
 
 /**
- * @brief Structure to represent the operator cache hash table
+ * @brief Number of buckets of the hash table mapping type Oids to type
+ * numbers, which must be a power of 2
+ */
+#define TYPE_HASH_SIZE 128
+
+/**
+ * @brief Number of buckets of the hash table mapping operator Oids to
+ * operator information, which must be a power of 2 and at least twice the
+ * number of operators defined in MobilityDB
+ */
+#define OPER_HASH_SIZE 8192
+
+/**
+ * @brief Structure to represent an entry of the type cache hash table
+ */
+typedef struct
+{
+  Oid typid;         /**< Oid of the type (hashtable key), 0 if the bucket
+                          is empty */
+  meosType type;     /**< Type number */
+} oid_type_entry;
+
+/**
+ * @brief Structure to represent an entry of the operator cache hash table
  */
 typedef struct
 {
-  Oid oproid;        /**< Oid of the operator (hashtable key) */
+  Oid oproid;        /**< Oid of the operator (hashtable key), 0 if the
+                          bucket is empty */
   meosOper oper;     /**< Operator type number */
   meosType ltype;    /**< Type number of the left argument */
   meosType rtype;    /**< Type number of the right argument */
-  char status;       /* hash status */
 } oid_oper_entry;
 
 /**
- * @brief Define a hashtable mapping operator Oids to a structure containing
- * operator and type numbers
+ * @brief Structure to represent the type and operator Oid caches
+ *
+ * The structure does not contain pointers so that it can be copied as a
+ * whole from and to shared memory. The hash tables use open addressing with
+ * linear probing.
  */
-#define SH_PREFIX opertable
-#define SH_ELEMENT_TYPE oid_oper_entry
-#define SH_KEY_TYPE Oid
-#define SH_KEY oproid
-#define SH_HASH_KEY(tb, key) hash_bytes_uint32(key)
-#define SH_EQUAL(tb, a, b) a == b
-#define SH_SCOPE static inline
-#define SH_DEFINE
-#define SH_DECLARE
-#include "lib/simplehash.h"
+typedef struct
+{
+  bool typeoid_ready;   /**< True when the type Oids are filled */
+  bool operoid_ready;   /**< True when the operator Oids are filled */
+  /** Type Oids indexed by type number */
+  Oid type_oid[NO_MEOS_TYPES];
+  /** Hash table mapping type Oids to type numbers */
+  oid_type_entry type_hash[TYPE_HASH_SIZE];
+  /** Hash table mapping operator Oids to operator information */
+  oid_oper_entry oper_hash[OPER_HASH_SIZE];
+  /** Operator Oids indexed by operator and argument type numbers */
+  Oid oper_args[NO_MEOS_TYPES][NO_MEOS_TYPES][NO_MEOS_TYPES];
+} oid_cache;
+
+/**
+ * @brief Structure to represent a slot of the shared Oid cache, which keeps
+ * the caches of a database
+ */
+typedef struct
+{
+  Oid dbid;             /**< Oid of the database, 0 if the slot is free */
+  oid_cache cache;      /**< Oid caches of the database */
+} oid_cache_slot;
+
+/**
+ * @brief Structure to represent the shared Oid cache
+ */
+typedef struct
+{
+  LWLock *lock;                  /**< Lock protecting the slots */
+  pg_atomic_uint32 generation;   /**< Incremented at each invalidation */
+  int nslots;                    /**< Number of slots */
+  oid_cache_slot slots[FLEXIBLE_ARRAY_MEMBER];
+} oid_cache_shmem;
 
 /*****************************************************************************
  * Global variables
  *****************************************************************************/
 
 /**
- * @brief Global variable that states whether the type and operator Oid caches
- * have been initialized
+ * @brief Global variable that keeps the maximum number of databases whose
+ * Oid caches are kept in shared memory
  */
-static bool MOBDB_TYPEOID_CACHE_READY = false;
-static bool MOBDB_OPEROID_CACHE_READY = false;
+int MOBDB_OID_CACHE_DATABASES = 4;
 
 /**
- * @brief Global variable array that keeps the type Oids used in MobilityDB
+ * @brief Global variable that keeps the type and operator Oid caches of the
+ * backend
+ *
+ * When the library is preloaded the caches are copied from the shared
+ * memory and only filled by scanning the catalog by the first backend
+ * connected to a database.
  */
-static Oid MOBDB_TYPE_OID[NO_MEOS_TYPES];
+static oid_cache MOBDB_OID_CACHE;
 
 /**
- * @brief Global hash table that keeps the operator Oids used in MobilityDB
+ * @brief Global variable pointing to the shared Oid cache, NULL if the
+ * library is not loaded in `shared_preload_libraries`
  */
-struct opertable_hash *MOBDB_OPER_OID = NULL;
+static oid_cache_shmem *MOBDB_OID_SHMEM = NULL;
 
 /**
- * @brief Global variable 3-dimensional array that keeps the operator Oids used
- * in MobilityDB
- *
- * The first dimension corresponds to the operator class (e.g., <=), the second
- * and third dimensions correspond, respectively, to the left and right
- * arguments of the operator. A value 0 is stored in the cell of the array if
- * the operator class is not defined for the left and right types.
+ * @brief Global variable that keeps the generation of the shared Oid cache
+ * from which the caches of the backend were obtained
  */
-static Oid MOBDB_OPER_OID_ARGS[NO_MEOS_TYPES][NO_MEOS_TYPES][NO_MEOS_TYPES];
+static uint32 MOBDB_OID_CACHE_GENERATION = 0;
+
+/**
+ * @brief Global variable stating whether the current transaction creates,
+ * alters, or drops an extension so that the Oid caches must be invalidated
+ * at its end
+ */
+static bool MOBDB_OID_CACHE_PENDING_RESET = false;
+
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+static shmem_request_hook_type prev_shmem_request_hook = NULL;
+#endif
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+static object_access_hook_type prev_object_access_hook = NULL;
 
 /*****************************************************************************
  * Catalog functions
@@ -238,12 +313,61 @@ mobilitydb_nsp_oid()
   return nsp_oid;
 }
 
+/*****************************************************************************
+ * Oid cache functions
+ *****************************************************************************/
+
 /**
- * @brief Populate the type Oid cache
+ * @brief Insert a type Oid into the type hash table of a cache
+ */
+static void
+type_hash_insert(oid_cache *cache, Oid typid, meosType type)
+{
+  uint32 i = hash_bytes_uint32(typid) & (TYPE_HASH_SIZE - 1);
+  while (cache->type_hash[i].typid != InvalidOid)
+  {
+    if (cache->type_hash[i].typid == typid)
+      return;
+    i = (i + 1) & (TYPE_HASH_SIZE - 1);
+  }
+  cache->type_hash[i].typid = typid;
+  cache->type_hash[i].type = type;
+  return;
+}
+
+/**
+ * @brief Insert an operator Oid into the operator hash table of a cache
+ * @return False if the operator Oid was already in the hash table
+ */
+static bool
+oper_hash_insert(oid_cache *cache, Oid oproid, meosOper oper, meosType ltype,
+  meosType rtype)
+{
+  uint32 i = hash_bytes_uint32(oproid) & (OPER_HASH_SIZE - 1);
+  while (cache->oper_hash[i].oproid != InvalidOid)
+  {
+    if (cache->oper_hash[i].oproid == oproid)
+      return false;
+    i = (i + 1) & (OPER_HASH_SIZE - 1);
+  }
+  cache->oper_hash[i].oproid = oproid;
+  cache->oper_hash[i].oper = oper;
+  cache->oper_hash[i].ltype = ltype;
+  cache->oper_hash[i].rtype = rtype;
+  return true;
+}
+
+/**
+ * @brief Populate the type Oid cache of the backend
  */
 static void
 populate_typeoid_cache()
 {
+  StaticAssertStmt(NO_MEOS_TYPES < TYPE_HASH_SIZE,
+    "The type hash table must be larger than the number of types");
+  oid_cache *cache = &MOBDB_OID_CACHE;
+  memset(cache->type_oid, 0, sizeof(cache->type_oid));
+  memset(cache->type_hash, 0, sizeof(cache->type_hash));
   /* Fill the cache */
   Oid nsp_oid = mobilitydb_nsp_oid();
   for (int i = 0; i < NO_MEOS_TYPES; i++)
@@ -254,32 +378,32 @@ populate_typeoid_cache()
     if (name && ! internal_type(name))
     {
       /* Search for type oid in extension namespace */
-      MOBDB_TYPE_OID[i] = TypenameNspGetTypid(name, nsp_oid);
+      Oid typid = TypenameNspGetTypid(name, nsp_oid);
       /* If not found, search default namespace */
-      if (MOBDB_TYPE_OID[i] == InvalidOid)
-        MOBDB_TYPE_OID[i] = TypenameGetTypid(name);
+      if (typid == InvalidOid)
+        typid = TypenameGetTypid(name);
+      cache->type_oid[i] = typid;
+      if (typid != InvalidOid)
+        type_hash_insert(cache, typid, i);
     }
   }
   /* Mark that the cache has been initialized */
-  MOBDB_TYPEOID_CACHE_READY = true;
+  cache->typeoid_ready = true;
 }
 
 /**
- * @brief Populate the operator Oid cache from the precomputed operator cache
- * stored in table `mobilitydb_opcache`
+ * @brief Populate the operator Oid cache of the backend from the precomputed
+ * operator cache stored in table `mobilitydb_opcache`
  *
  * This table is filled by function #fill_oid_cache when the extension is created.
- * @note Due to some memory context issues, the MOBDB_OPER_OID_ARGS array should be
- * filled again even if it is already filled during the extension creation.
  */
 static void
 populate_operoid_cache()
 {
-  /* Create the operator hash table */
-  MOBDB_OPER_OID = opertable_create(CacheMemoryContext, 2048, NULL);
-
-  /* Initialize the operator array */
-  memset(MOBDB_OPER_OID_ARGS, 0, sizeof(MOBDB_OPER_OID_ARGS));
+  oid_cache *cache = &MOBDB_OID_CACHE;
+  /* Initialize the operator hash table and array */
+  memset(cache->oper_hash, 0, sizeof(cache->oper_hash));
+  memset(cache->oper_args, 0, sizeof(cache->oper_args));
   /* Fetch the rows of the table containing the MobilityDB operator cache */
   Oid nsp_oid = mobilitydb_nsp_oid();
   Oid catalog = RelnameNspGetRelid("mobilitydb_opcache", nsp_oid);
@@ -292,6 +416,7 @@ populate_operoid_cache()
   ScanKeyData scandata;
   TableScanDesc scan = table_beginscan_catalog(rel, 0, &scandata);
   HeapTuple tuple = heap_getnext(scan, ForwardScanDirection);
+  int noper = 0;
   while (HeapTupleIsValid(tuple))
   {
     bool isnull = false;
@@ -299,18 +424,15 @@ populate_operoid_cache()
     int32 j = DatumGetInt32(heap_getattr(tuple, 2, tupDesc, &isnull));
     int32 k = DatumGetInt32(heap_getattr(tuple, 3, tupDesc, &isnull));
     Oid oproid = DatumGetObjectId(heap_getattr(tuple, 4, tupDesc, &isnull));
-    /* Fill the struct to be added to the hash table */
-    bool found;
-    oid_oper_entry *entry = opertable_insert(MOBDB_OPER_OID, oproid, &found);
-    if (! found)
-    {
-      entry->oproid = oproid;
-      entry->oper = i;
-      entry->ltype = j;
-      entry->rtype = k;
-    }
+    /* Keep at least one empty bucket in the hash table */
+    if (noper == OPER_HASH_SIZE - 1)
+      ereport(ERROR, (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+        errmsg("Too many operators for the operator Oid cache")));
+    /* Fill the operator hash table */
+    if (oper_hash_insert(cache, oproid, i, j, k))
+      noper++;
     /* Fill the operator Oid array */
-    MOBDB_OPER_OID_ARGS[i][j][k] = oproid;
+    cache->oper_args[i][j][k] = oproid;
     /* Read next tuple from table */
     tuple = heap_getnext(scan, ForwardScanDirection);
   }
@@ -321,7 +443,214 @@ populate_operoid_cache()
   table_close(rel, AccessShareLock);
 #endif
   /* Mark that the cache has been initialized */
-  MOBDB_OPEROID_CACHE_READY = true;
+  cache->operoid_ready = true;
+}
+
+/**
+ * @brief Return the slot of the shared Oid cache of the current database
+ * @param[in] create True when a free slot is assigned to the database if
+ * there is none
+ * @note The lock of the shared Oid cache must be held, in exclusive mode if
+ * the argument `create` is true
+ */
+static oid_cache_slot *
+oid_cache_slot_find(bool create)
+{
+  oid_cache_slot *free_slot = NULL;
+  for (int i = 0; i < MOBDB_OID_SHMEM->nslots; i++)
+  {
+    oid_cache_slot *slot = &MOBDB_OID_SHMEM->slots[i];
+    if (slot->dbid == MyDatabaseId)
+      return slot;
+    if (! free_slot && slot->dbid == InvalidOid)
+      free_slot = slot;
+  }
+  if (! create || ! free_slot)
+    return NULL;
+  free_slot->dbid = MyDatabaseId;
+  free_slot->cache.typeoid_ready = free_slot->cache.operoid_ready = false;
+  return free_slot;
+}
+
+/**
+ * @brief Fill the Oid caches of the backend
+ *
+ * The caches are copied from the shared Oid cache when another backend
+ * connected to the same database has already filled them. Otherwise, they
+ * are filled by scanning the catalog and then published in the shared Oid
+ * cache, unless it was invalidated in the meantime.
+ * @param[in] oper True when the operator Oid cache is needed
+ */
+static void
+oid_cache_load(bool oper)
+{
+  oid_cache *cache = &MOBDB_OID_CACHE;
+  if (MOBDB_OID_SHMEM)
+  {
+    LWLockAcquire(MOBDB_OID_SHMEM->lock, LW_SHARED);
+    MOBDB_OID_CACHE_GENERATION =
+      pg_atomic_read_u32(&MOBDB_OID_SHMEM->generation);
+    oid_cache_slot *slot = oid_cache_slot_find(false);
+    if (slot && slot->cache.typeoid_ready &&
+        (! oper || slot->cache.operoid_ready))
+      memcpy(cache, &slot->cache, sizeof(oid_cache));
+    LWLockRelease(MOBDB_OID_SHMEM->lock);
+    if (cache->typeoid_ready && (! oper || cache->operoid_ready))
+      return;
+  }
+
+  if (! cache->typeoid_ready)
+    populate_typeoid_cache();
+  if (oper && ! cache->operoid_ready)
+    populate_operoid_cache();
+
+  /* The caches filled by a transaction that modifies an extension are not
+   * published since they are invalidated at the end of the transaction */
+  if (MOBDB_OID_SHMEM && ! MOBDB_OID_CACHE_PENDING_RESET)
+  {
+    LWLockAcquire(MOBDB_OID_SHMEM->lock, LW_EXCLUSIVE);
+    if (MOBDB_OID_CACHE_GENERATION ==
+        pg_atomic_read_u32(&MOBDB_OID_SHMEM->generation))
+    {
+      oid_cache_slot *slot = oid_cache_slot_find(true);
+      if (slot && (! slot->cache.typeoid_ready ||
+          (cache->operoid_ready && ! slot->cache.operoid_ready)))
+        memcpy(&slot->cache, cache, sizeof(oid_cache));
+    }
+    LWLockRelease(MOBDB_OID_SHMEM->lock);
+  }
+  return;
+}
+
+/**
+ * @brief Ensure that the Oid caches of the backend are filled and valid
+ * @param[in] oper True when the operator Oid cache is needed
+ */
+static inline void
+oid_cache_ensure(bool oper)
+{
+  oid_cache *cache = &MOBDB_OID_CACHE;
+  if (MOBDB_OID_SHMEM && MOBDB_OID_CACHE_GENERATION !=
+      pg_atomic_read_u32(&MOBDB_OID_SHMEM->generation))
+    cache->typeoid_ready = cache->operoid_ready = false;
+  if (! cache->typeoid_ready || (oper && ! cache->operoid_ready))
+    oid_cache_load(oper);
+  return;
+}
+
+/**
+ * @brief Invalidate the Oid caches of the current database at the end of a
+ * transaction that created, altered, or dropped an extension
+ */
+static void
+oid_cache_xact_callback(XactEvent event, void *arg __attribute__((unused)))
+{
+  if (! MOBDB_OID_CACHE_PENDING_RESET ||
+      (event != XACT_EVENT_COMMIT && event != XACT_EVENT_ABORT))
+    return;
+  MOBDB_OID_CACHE_PENDING_RESET = false;
+  MOBDB_OID_CACHE.typeoid_ready = MOBDB_OID_CACHE.operoid_ready = false;
+  if (MOBDB_OID_SHMEM)
+  {
+    LWLockAcquire(MOBDB_OID_SHMEM->lock, LW_EXCLUSIVE);
+    oid_cache_slot *slot = oid_cache_slot_find(false);
+    if (slot)
+      slot->dbid = InvalidOid;
+    pg_atomic_fetch_add_u32(&MOBDB_OID_SHMEM->generation, 1);
+    LWLockRelease(MOBDB_OID_SHMEM->lock);
+  }
+  return;
+}
+
+/**
+ * @brief Detect the commands that create, alter, or drop an extension, since
+ * `ALTER EXTENSION ... UPDATE` may change the type and operator Oids
+ */
+static void
+oid_cache_object_access(ObjectAccessType access, Oid classId, Oid objectId,
+  int subId, void *arg)
+{
+  if (prev_object_access_hook)
+    prev_object_access_hook(access, classId, objectId, subId, arg);
+  if (classId == ExtensionRelationId && (access == OAT_POST_CREATE ||
+      access == OAT_POST_ALTER || access == OAT_DROP))
+    MOBDB_OID_CACHE_PENDING_RESET = true;
+  return;
+}
+
+/**
+ * @brief Return the size of the shared Oid cache
+ */
+static Size
+oid_cache_shmem_size(void)
+{
+  return add_size(offsetof(oid_cache_shmem, slots),
+    mul_size(MOBDB_OID_CACHE_DATABASES, sizeof(oid_cache_slot)));
+}
+
+/**
+ * @brief Request the shared memory and the lock of the shared Oid cache
+ */
+static void
+oid_cache_shmem_request(void)
+{
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+  if (prev_shmem_request_hook)
+    prev_shmem_request_hook();
+#endif
+  RequestAddinShmemSpace(oid_cache_shmem_size());
+  RequestNamedLWLockTranche("mobilitydb_oid_cache", 1);
+  return;
+}
+
+/**
+ * @brief Create or attach to the shared Oid cache
+ */
+static void
+oid_cache_shmem_startup(void)
+{
+  if (prev_shmem_startup_hook)
+    prev_shmem_startup_hook();
+  bool found;
+  LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+  MOBDB_OID_SHMEM = ShmemInitStruct("mobilitydb_oid_cache",
+    oid_cache_shmem_size(), &found);
+  if (! found)
+  {
+    memset(MOBDB_OID_SHMEM, 0, oid_cache_shmem_size());
+    MOBDB_OID_SHMEM->lock =
+      &(GetNamedLWLockTranche("mobilitydb_oid_cache"))->lock;
+    pg_atomic_init_u32(&MOBDB_OID_SHMEM->generation, 0);
+    MOBDB_OID_SHMEM->nslots = MOBDB_OID_CACHE_DATABASES;
+  }
+  LWLockRelease(AddinShmemInitLock);
+  return;
+}
+
+/**
+ * @brief Install the hooks of the Oid caches
+ *
+ * The shared Oid cache is only created when the library is loaded in
+ * `shared_preload_libraries`, otherwise every backend fills its own caches.
+ */
+void
+oid_cache_init(void)
+{
+  prev_object_access_hook = object_access_hook;
+  object_access_hook = oid_cache_object_access;
+  RegisterXactCallback(oid_cache_xact_callback, NULL);
+  if (! process_shared_preload_libraries_in_progress ||
+      MOBDB_OID_CACHE_DATABASES == 0)
+    return;
+#if POSTGRESQL_VERSION_NUMBER >= 150000
+  prev_shmem_request_hook = shmem_request_hook;
+  shmem_request_hook = oid_cache_shmem_request;
+#else
+  oid_cache_shmem_request();
+#endif
+  prev_shmem_startup_hook = shmem_startup_hook;
+  shmem_startup_hook = oid_cache_shmem_startup;
+  return;
 }
 
 /*****************************************************************************/
@@ -333,9 +662,8 @@ populate_operoid_cache()
 Oid
 type_oid(meosType type)
 {
-  if (! MOBDB_TYPEOID_CACHE_READY)
-    populate_typeoid_cache();
-  Oid result = MOBDB_TYPE_OID[type];
+  oid_cache_ensure(false);
+  Oid result = MOBDB_OID_CACHE.type_oid[type];
   if (! result)
     ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
       errmsg("Unknown MEOS type; %d", type)));
@@ -343,7 +671,7 @@ type_oid(meosType type)
 }
 
 /**
- * @brief Fetch from the cache the type number
+ * @brief Fetch from the hash table the type number
  * @arg[in] type Type Oid
  * @note This function cannot send an error when the type is not found since
  * it is used for all types that appear in the `pg_operator` table when the
@@ -352,12 +680,16 @@ type_oid(meosType type)
 meosType
 oid_type(Oid typid)
 {
-  if (! MOBDB_TYPEOID_CACHE_READY)
-    populate_typeoid_cache();
-  for (int i = 0; i < NO_MEOS_TYPES; i++)
+  oid_cache_ensure(false);
+  if (typid == InvalidOid)
+    return T_UNKNOWN;
+  const oid_type_entry *hash = MOBDB_OID_CACHE.type_hash;
+  uint32 i = hash_bytes_uint32(typid) & (TYPE_HASH_SIZE - 1);
+  while (hash[i].typid != InvalidOid)
   {
-    if (MOBDB_TYPE_OID[i] == typid)
-      return i;
+    if (hash[i].typid == typid)
+      return hash[i].type;
+    i = (i + 1) & (TYPE_HASH_SIZE - 1);
   }
   return T_UNKNOWN;
 }
@@ -373,16 +705,15 @@ oid_type(Oid typid)
 Oid
 oper_oid(meosOper oper, meosType lt, meosType rt)
 {
-  if (! MOBDB_OPEROID_CACHE_READY)
-    populate_operoid_cache();
-  Oid result = MOBDB_OPER_OID_ARGS[oper][lt][rt];
+  oid_cache_ensure(true);
+  Oid result = MOBDB_OID_CACHE.oper_args[oper][lt][rt];
   if (! result)
   {
     ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
       errmsg("Unknown MEOS operator: %s, ltype; %s, rtype; %s",
         meosoper_name(oper), meostype_name(lt), meostype_name(rt))));
   }
-  return MOBDB_OPER_OID_ARGS[oper][lt][rt];
+  return result;
 }
 
 /**
@@ -393,23 +724,24 @@ oper_oid(meosOper oper, meosType lt, meosType rt)
 meosOper
 oid_oper(Oid oproid, meosType *ltype, meosType *rtype)
 {
-  if (! MOBDB_OPEROID_CACHE_READY)
-    populate_operoid_cache();
-  oid_oper_entry *entry = opertable_lookup(MOBDB_OPER_OID, oproid);
-  if (! entry)
-  {
-    ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
-      errmsg("Unknown operator Oid %d", oproid)));
-    return UNKNOWN_OP; /* make compiler quiet */
-  }
-  else
+  oid_cache_ensure(true);
+  const oid_oper_entry *hash = MOBDB_OID_CACHE.oper_hash;
+  uint32 i = hash_bytes_uint32(oproid) & (OPER_HASH_SIZE - 1);
+  while (oproid != InvalidOid && hash[i].oproid != InvalidOid)
   {
-    if (ltype)
-      *ltype = entry->ltype;
-    if (rtype)
-      *rtype = entry->rtype;
-    return entry->oper;
+    if (hash[i].oproid == oproid)
+    {
+      if (ltype)
+        *ltype = hash[i].ltype;
+      if (rtype)
+        *rtype = hash[i].rtype;
+      return hash[i].oper;
+    }
+    i = (i + 1) & (OPER_HASH_SIZE - 1);
   }
+  ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
+    errmsg("Unknown operator Oid %d", oproid)));
+  return UNKNOWN_OP; /* make compiler quiet */
 }
 
 /*****************************************************************************/
@@ -123,6 +123,118 @@ Set_union_transfn(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(state);
 }
 
+/**
+ * @brief Return a set from the values accumulated in the state of a union
+ * aggregate
+ * @note The values are sorted and duplicates are removed
+ */
+static Set *
+set_union_state_set(ArrayBuildState *state, meosType basetype)
+{
+  int32 count = state->nelems;
+  bool typbyval = basetype_byvalue(basetype);
+  int16 typlen = basetype_length(basetype);
+
+  Datum *values = palloc0(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+    values[i] = typlen > 0 ? state->dvalues[i] :
+      PointerGetDatum(PG_DETOAST_DATUM(state->dvalues[i]));
+
+  Set *result = set_make_exp(values, count, count, basetype, ORDER);
+
+  /* Free memory */
+  if (typbyval)
+    pfree(values);
+  else
+    pfree_array((void **) values, count);
+  return result;
+}
+
+PGDLLEXPORT Datum Set_union_combinefn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Set_union_combinefn);
+/**
+ * @ingroup mobilitydb_setspan_agg
+ * @brief Combine function for union aggregation of sets
+ * @sqlfn union()
+ */
+Datum
+Set_union_combinefn(PG_FUNCTION_ARGS)
+{
+  MemoryContext aggContext;
+  if (! AggCheckCallContext(fcinfo, &aggContext))
+    elog(ERROR, "Set_union_combinefn called in non-aggregate context");
+
+  ArrayBuildState *state1 = PG_ARGISNULL(0) ? NULL :
+    (ArrayBuildState *) PG_GETARG_POINTER(0);
+  ArrayBuildState *state2 = PG_ARGISNULL(1) ? NULL :
+    (ArrayBuildState *) PG_GETARG_POINTER(1);
+  if (! state2)
+  {
+    if (! state1)
+      PG_RETURN_NULL();
+    PG_RETURN_POINTER(state1);
+  }
+  /* The second state is copied into the aggregate context when the first
+   * one is null */
+  if (! state1)
+    state1 = initArrayResult(state2->element_type, aggContext, false);
+  for (int i = 0; i < state2->nelems; i++)
+    accumArrayResult(state1, state2->dvalues[i], false, state2->element_type,
+      aggContext);
+  PG_RETURN_POINTER(state1);
+}
+
+PGDLLEXPORT Datum Set_union_serialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Set_union_serialize);
+/**
+ * @ingroup mobilitydb_setspan_agg
+ * @brief Serialize the state of union aggregation of sets
+ * @note The state is serialized as a set, which removes the duplicates
+ * before the partial result is sent to the leader process. An empty state
+ * is serialized as an empty byte array.
+ * @sqlfn union()
+ */
+Datum
+Set_union_serialize(PG_FUNCTION_ARGS)
+{
+  ArrayBuildState *state = (ArrayBuildState *) PG_GETARG_POINTER(0);
+  if (state->nelems == 0)
+  {
+    bytea *result = palloc(VARHDRSZ);
+    SET_VARSIZE(result, VARHDRSZ);
+    PG_RETURN_BYTEA_P(result);
+  }
+  meosType basetype = oid_type(state->element_type);
+  Set *result = set_union_state_set(state, basetype);
+  PG_RETURN_BYTEA_P((bytea *) result);
+}
+
+PGDLLEXPORT Datum Set_union_deserialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Set_union_deserialize);
+/**
+ * @ingroup mobilitydb_setspan_agg
+ * @brief Deserialize the state of union aggregation of sets
+ * @sqlfn union()
+ */
+Datum
+Set_union_deserialize(PG_FUNCTION_ARGS)
+{
+  MemoryContext aggContext;
+  if (! AggCheckCallContext(fcinfo, &aggContext))
+    elog(ERROR, "Set_union_deserialize called in non-aggregate context");
+
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  /* An empty state is serialized as an empty byte array */
+  if (VARSIZE(data) == VARHDRSZ)
+    PG_RETURN_NULL();
+  Set *set = (Set *) data;
+  Oid baseoid = type_oid(set->basetype);
+  ArrayBuildState *state = initArrayResult(baseoid, aggContext, false);
+  for (int i = 0; i < set->count; i++)
+    accumArrayResult(state, SET_VAL_N(set, i), false, baseoid, aggContext);
+  PG_RETURN_POINTER(state);
+}
+
 PGDLLEXPORT Datum Set_union_finalfn(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Set_union_finalfn);
 /**
@@ -144,30 +256,13 @@ Set_union_finalfn(PG_FUNCTION_ARGS)
     PG_RETURN_NULL();
 
   /* Also return NULL if we had zero inputs, like other aggregates */
-  int32 count = state->nelems;
-  if (count == 0)
+  if (state->nelems == 0)
     PG_RETURN_NULL();
 
   Oid setoid = get_fn_expr_rettype(fcinfo->flinfo);
   meosType settype = oid_type(setoid);
   meosType basetype = settype_basetype(settype);
-  bool typbyval = basetype_byvalue(basetype);
-  int16 typlen = basetype_length(basetype);
-
-  Datum *values = palloc0(sizeof(Datum) * count);
-  for (int i = 0; i < count; i++)
-    values[i] = typlen > 0 ? state->dvalues[i] :
-      PointerGetDatum(PG_DETOAST_DATUM(state->dvalues[i]));
-
-  Set *result = set_make_exp(values, count, count, basetype, ORDER);
-
-  /* Free memory */
-  if (typbyval)
-    pfree(values);
-  else
-    pfree_array((void **) values, count);
-
-  PG_RETURN_SET_P(result);
+  PG_RETURN_SET_P(set_union_state_set(state, basetype));
 }
 
 /*****************************************************************************/
@@ -35,8 +35,7 @@
 #include "general/skiplist.h"
 
 /* PostgreSQL */
-#include <executor/spi.h>
-#include <libpq/pqformat.h>
+#include <fmgr.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -50,11 +49,15 @@
 
 /**
  * @brief Switch to the memory context for aggregation
+ * @note When the fcinfo is NULL, as for the functions on persisted aggregate
+ * states, the current memory context is kept
  */
 MemoryContext
 set_aggregation_context(FunctionCallInfo fcinfo)
 {
   MemoryContext ctx = NULL;
+  if (! fcinfo)
+    return CurrentMemoryContext;
   if (! AggCheckCallContext(fcinfo, &ctx))
     ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR),
       errmsg("Cannot switch to aggregation context")));
@@ -75,66 +78,22 @@ unset_aggregation_context(MemoryContext ctx)
  * Generic binary aggregate functions needed for parallelization
  *****************************************************************************/
 
-/**
- * @brief Write the state value into the buffer
- * @param[in] state State
- * @param[in] buf Buffer
- */
-static void
-aggstate_write(SkipList *state, StringInfo buf)
-{
-  int i;
-  void **values = skiplist_values(state);
-  pq_sendint32(buf, (uint32) state->length);
-  for (i = 0; i < state->length; i ++)
-  {
-    SPI_connect();
-    temporal_write((Temporal *) values[i], buf);
-    SPI_finish();
-  }
-  pq_sendint64(buf, state->extrasize);
-  if (state->extra)
-    pq_sendbytes(buf, state->extra, (int) state->extrasize);
-  pfree(values);
-  return;
-}
-
-/**
- * @brief Read the state value from the buffer
- * @param[in] buf Buffer
- */
-static SkipList *
-aggstate_read(StringInfo buf)
-{
-  int length = pq_getmsgint(buf, 4);
-  void **values = palloc0(sizeof(void *) * length);
-  SkipList *result = NULL; /* make compiler quiet */
-  for (int i = 0; i < length; i ++)
-    values[i] = temporal_recv(buf);
-  size_t extrasize = (size_t) pq_getmsgint64(buf);
-  result = skiplist_make(values, length);
-  if (extrasize)
-  {
-    const char *extra = pq_getmsgbytes(buf, (int) extrasize);
-    aggstate_set_extra(result, (void *) extra, extrasize);
-  }
-  pfree_array(values, length);
-  return result;
-}
-
 Datum Taggstate_serialize(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Taggstate_serialize);
 /**
  * @brief Serialize the state value
+ * @note The state is serialized in the flat form of #skiplist_serialize,
+ * which contains the values in time order but not the levels of the skiplist
  */
 Datum
 Taggstate_serialize(PG_FUNCTION_ARGS)
 {
   SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
-  StringInfoData buf;
-  pq_begintypsend(&buf);
-  aggstate_write(state, &buf);
-  PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+  size_t size = skiplist_serialize_size(state);
+  bytea *result = palloc(VARHDRSZ + size);
+  SET_VARSIZE(result, VARHDRSZ + size);
+  skiplist_serialize(state, VARDATA(result));
+  PG_RETURN_BYTEA_P(result);
 }
 
 Datum Taggstate_deserialize(PG_FUNCTION_ARGS);
@@ -146,14 +105,14 @@ Datum
 Taggstate_deserialize(PG_FUNCTION_ARGS)
 {
   bytea *data = PG_GETARG_BYTEA_P(0);
-  StringInfoData buf =
-  {
-    .cursor = 0,
-    .data = VARDATA(data),
-    .len = VARSIZE(data),
-    .maxlen = VARSIZE(data)
-  };
-  SkipList *result = aggstate_read(&buf);
+  size_t size = VARSIZE(data) - VARHDRSZ;
+  /* The data of a bytea is not aligned on a double boundary */
+  char *buf = palloc(size);
+  memcpy(buf, VARDATA(data), size);
+  /* Store fcinfo into a global variable */
+  store_fcinfo(fcinfo);
+  SkipList *result = skiplist_deserialize(buf, size);
+  pfree(buf);
   PG_RETURN_SKIPLIST_P(result);
 }
 
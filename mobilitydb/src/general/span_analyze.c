@@ -41,6 +41,10 @@
  * in the array is a valid span, even though the lower and upper bounds
  * come from different tuples. In theory, the standard scalar selectivity
  * functions could be used with the combined histogram.
+ *
+ * For a set type column, the most common elements of the sets and their
+ * frequencies are also collected, as done for arrays in array_typanalyze.c,
+ * which are used for estimating the containment and overlap operators.
  */
 #include "pg_general/span_analyze.h"
 
@@ -50,6 +54,7 @@
 #include <postgres.h>
 #include <fmgr.h>
 #include <catalog/pg_operator.h>
+#include <catalog/pg_statistic.h>
 #include <utils/typcache.h>
 #if POSTGRESQL_VERSION_NUMBER >= 160000
   #include "varatt.h"
@@ -58,6 +63,7 @@
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/set.h"
+#include "general/type_util.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
 
@@ -234,6 +240,145 @@ span_compute_stats_generic(VacAttrStats *stats, int non_null_cnt, int *slot_idx,
   return;
 }
 
+/**
+ * @brief Structure for counting the occurrences of the elements of the sample
+ * sets
+ */
+typedef struct
+{
+  Datum value;      /**< Element value */
+  int count;        /**< Number of sample sets containing the element */
+} SetElemCount;
+
+/**
+ * @brief Comparison function for sorting the elements of the sample sets
+ */
+static int
+set_elem_qsort_cmp(const void *a1, const void *a2, void *arg)
+{
+  meosType basetype = *(meosType *) arg;
+  return datum_cmp(*(const Datum *) a1, *(const Datum *) a2, basetype);
+}
+
+/**
+ * @brief Comparison function for sorting set elements in descending order of
+ * their count
+ */
+static int
+set_elem_count_qsort_cmp(const void *a1, const void *a2)
+{
+  const SetElemCount *e1 = (const SetElemCount *) a1;
+  const SetElemCount *e2 = (const SetElemCount *) a2;
+  if (e1->count > e2->count)
+    return -1;
+  else if (e1->count == e2->count)
+    return 0;
+  else
+    return 1;
+}
+
+/**
+ * @brief Comparison function for sorting set elements by their value
+ */
+static int
+set_elem_value_qsort_cmp(const void *a1, const void *a2, void *arg)
+{
+  meosType basetype = *(meosType *) arg;
+  return datum_cmp(((const SetElemCount *) a1)->value,
+    ((const SetElemCount *) a2)->value, basetype);
+}
+
+/**
+ * @brief Compute the most common elements statistics of set columns
+ *
+ * The slot stores the most common elements sorted by value, as expected by
+ * the selectivity functions, and their frequencies, which are the fractions
+ * of non-null sets containing them. As in array_typanalyze.c, the minimum and
+ * the maximum frequencies, and the frequency of null elements, which is
+ * always 0 for sets, are appended to the frequencies.
+ *
+ * @param[in] stats Structure storing statistics information
+ * @param[in] non_null_cnt Number of rows that are not null
+ * @param[in] slot_idx Index of the slot where the statistics will be stored
+ * @param[in] elems Array of the elements of all sample sets
+ * @param[in] nelems Number of elements
+ * @param[in] basetype Base type of the sets
+ */
+void
+set_compute_mcelem(VacAttrStats *stats, int non_null_cnt, int slot_idx,
+  Datum *elems, int nelems, meosType basetype)
+{
+  if (nelems == 0)
+    return;
+
+#if POSTGRESQL_VERSION_NUMBER >= 170000
+  int num_mcelem = stats->attstattarget * 10;
+#else
+  int num_mcelem = stats->attr->attstattarget * 10;
+#endif
+  if (num_mcelem <= 0)
+    return;
+
+  /* Count the occurrences of each distinct element. Since the values of a
+   * set are unique, each occurrence comes from a different set. */
+  qsort_arg(elems, (size_t) nelems, sizeof(Datum), set_elem_qsort_cmp,
+    &basetype);
+  SetElemCount *counts = palloc(sizeof(SetElemCount) * nelems);
+  int ndistinct = 0;
+  for (int i = 0; i < nelems; i++)
+  {
+    if (ndistinct > 0 &&
+        datum_eq(counts[ndistinct - 1].value, elems[i], basetype))
+      counts[ndistinct - 1].count++;
+    else
+    {
+      counts[ndistinct].value = elems[i];
+      counts[ndistinct++].count = 1;
+    }
+  }
+
+  /* Keep the most common elements and sort them back by value */
+  qsort(counts, (size_t) ndistinct, sizeof(SetElemCount),
+    set_elem_count_qsort_cmp);
+  if (num_mcelem > ndistinct)
+    num_mcelem = ndistinct;
+  int maxcount = counts[0].count, mincount = counts[num_mcelem - 1].count;
+  qsort_arg(counts, (size_t) num_mcelem, sizeof(SetElemCount),
+    set_elem_value_qsort_cmp, &basetype);
+
+  /* Must copy the target values into anl_context */
+  MemoryContext old_cxt = MemoryContextSwitchTo(stats->anl_context);
+  Datum *mcelem_values = palloc(sizeof(Datum) * num_mcelem);
+  float4 *mcelem_freqs = palloc(sizeof(float4) * (num_mcelem + 3));
+  for (int i = 0; i < num_mcelem; i++)
+  {
+    mcelem_values[i] = datum_copy(counts[i].value, basetype);
+    mcelem_freqs[i] = (float4) ((double) counts[i].count /
+      (double) non_null_cnt);
+  }
+  mcelem_freqs[num_mcelem] = (float4) ((double) mincount /
+    (double) non_null_cnt);
+  mcelem_freqs[num_mcelem + 1] = (float4) ((double) maxcount /
+    (double) non_null_cnt);
+  mcelem_freqs[num_mcelem + 2] = 0.0;
+  MemoryContextSwitchTo(old_cxt);
+
+  stats->stakind[slot_idx] = STATISTIC_KIND_MCELEM;
+  stats->staop[slot_idx] = oper_oid(EQ_OP, basetype, basetype);
+  stats->stanumbers[slot_idx] = mcelem_freqs;
+  /* See the comment in array_typanalyze.c about the extra frequencies */
+  stats->numnumbers[slot_idx] = num_mcelem + 3;
+  stats->stavalues[slot_idx] = mcelem_values;
+  stats->numvalues[slot_idx] = num_mcelem;
+  stats->statypid[slot_idx] = type_oid(basetype);
+  stats->statyplen[slot_idx] = basetype_length(basetype);
+  stats->statypbyval[slot_idx] = basetype_byvalue(basetype);
+  stats->statypalign[slot_idx] = 'd';
+
+  pfree(counts);
+  return;
+}
+
 /**
  * @brief Compute statistics for set, span, and span set columns
  * @param[in] stats Structure storing statistics information
@@ -253,6 +398,14 @@ span_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   SpanBound *lowers = palloc(sizeof(SpanBound) * samplerows);
   SpanBound *uppers = palloc(sizeof(SpanBound) * samplerows);
   float8 *lengths = palloc(sizeof(float8) * samplerows);
+  /* Allocate memory to hold the elements of the sample sets */
+  Datum *elems = NULL;
+  int nelems = 0, maxelems = 0;
+  if (set_type(type))
+  {
+    maxelems = samplerows;
+    elems = palloc(sizeof(Datum) * maxelems);
+  }
 
   /* Loop over the sample span values. */
   for (int i = 0; i < samplerows; i++)
@@ -277,6 +430,14 @@ span_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       Span sp;
       set_set_span(s, &sp);
       span_deserialize(&sp, &lower, &upper);
+      /* Remember the elements for the most common elements statistics */
+      if (nelems + s->count > maxelems)
+      {
+        maxelems = Max(maxelems * 2, nelems + s->count);
+        elems = repalloc(elems, sizeof(Datum) * maxelems);
+      }
+      for (int j = 0; j < s->count; j++)
+        elems[nelems++] = SET_VAL_N(s, j);
       /* Adjust the size */
       total_width += VARSIZE(s);
     }
@@ -326,6 +487,10 @@ span_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     int slot_idx = value ? 0 : 2;
     span_compute_stats_generic(stats, non_null_cnt, &slot_idx, lowers, uppers,
       lengths, numspan_type(type));
+    /* The most common elements of sets are stored in the last slot */
+    if (set_type(type))
+      set_compute_mcelem(stats, non_null_cnt, STATISTIC_NUM_SLOTS - 1, elems,
+        nelems, settype_basetype(type));
   }
   else if (null_cnt > 0)
   {
@@ -337,6 +502,8 @@ span_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
   }
 
   pfree(lowers); pfree(uppers); pfree(lengths);
+  if (elems)
+    pfree(elems);
   return;
 }
 
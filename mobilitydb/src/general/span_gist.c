@@ -43,16 +43,24 @@
 #include <postgres.h>
 #include <fmgr.h>
 #include <access/gist.h>
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  #include <access/reloptions.h>
+#endif
+#include <utils/array.h>
+#include <utils/sortsupport.h>
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/set.h"
 #include "general/span.h"
 #include "general/temporal.h"
+#include "general/type_util.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
 #include "pg_general/spanset.h"
 #include "pg_general/temporal.h"
+#include "pg_general/type_util.h"
 
 /*****************************************************************************
  * GiST consistent methods
@@ -162,41 +170,38 @@ span_index_recheck(StrategyNumber strategy)
 }
 
 /**
- * @brief Transform the query argument into a span
+ * @brief Transform a query value into a span
+ * @param[in] value Query value
+ * @param[in] type Type of the query value
+ * @param[out] result Resulting span
+ * @note This function is used for both GiST and BRIN indexes
  */
-static bool
-span_gist_get_span(FunctionCallInfo fcinfo, Span *result, Oid typid)
+bool
+span_index_get_span(Datum value, meosType type, Span *result)
 {
-  meosType type = oid_type(typid);
   if (span_basetype(type))
   {
-    /* Since function span_gist_consistent is strict, value is not NULL */
-    Datum value = PG_GETARG_DATUM(1);
     meosType spantype = basetype_spantype(type);
     span_set(value, value, true, true, type, spantype, result);
   }
   else if (set_type(type))
   {
-    Set *s = PG_GETARG_SET_P(1);
+    Set *s = (Set *) PG_DETOAST_DATUM(value);
     set_set_span(s, result);
   }
   else if (span_type(type))
   {
-    Span *s = PG_GETARG_SPAN_P(1);
+    Span *s = DatumGetSpanP(value);
     if (s == NULL)
-      PG_RETURN_BOOL(false);
+      return false;
     memcpy(result, s, sizeof(Span));
   }
   else if (spanset_type(type))
-  {
-    Datum psdatum = PG_GETARG_DATUM(1);
-    spanset_span_slice(psdatum, result);
-  }
+    spanset_span_slice(value, result);
   /* For temporal types whose bounding box is a timestamptz span */
   else if (talpha_type(type))
   {
-    Datum tempdatum = PG_GETARG_DATUM(1);
-    Temporal *temp = temporal_slice(tempdatum);
+    Temporal *temp = temporal_slice(value);
     temporal_set_tstzspan(temp, result);
   }
   else
@@ -204,6 +209,16 @@ span_gist_get_span(FunctionCallInfo fcinfo, Span *result, Oid typid)
   return true;
 }
 
+/**
+ * @brief Transform the query argument into a span
+ */
+static bool
+span_gist_get_span(FunctionCallInfo fcinfo, Span *result, Oid typid)
+{
+  /* Since function span_gist_consistent is strict, value is not NULL */
+  return span_index_get_span(PG_GETARG_DATUM(1), oid_type(typid), result);
+}
+
 PGDLLEXPORT Datum Span_gist_consistent(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Span_gist_consistent);
 /**
@@ -911,6 +926,487 @@ Span_gist_distance(PG_FUNCTION_ARGS)
   PG_RETURN_DATUM(distance);
 }
 
+/*****************************************************************************
+ * Multi-span GiST methods
+ *
+ * The leaf entries of the index store, instead of the bounding span of a
+ * span set, an array of up to `max_count` spans obtained with the function
+ * #spanset_spans, that is, the composing spans of the span set or, when there
+ * are too many of them, groups of consecutive composing spans merged into a
+ * single span. The internal entries store an array with a single span which
+ * is the union of the spans below. Since all the spans of a value are kept
+ * in a single index entry, no duplicate elimination is needed when scanning
+ * the index.
+ *****************************************************************************/
+
+/* Default and maximum number of spans of a leaf entry */
+#define MGIST_MAX_COUNT_DEFAULT 8
+#define MGIST_MAX_COUNT_MAX     32
+
+/**
+ * @brief Structure for the options of the multi-span GiST operator classes
+ */
+typedef struct
+{
+  int32 vl_len_;      /**< Varlena header (do not touch directly!) */
+  int max_count;      /**< Maximum number of spans of a leaf entry */
+} SpansetMGistOptions;
+
+/**
+ * @brief Return the spans of a multi-span index key
+ * @param[in] key Index key
+ * @param[out] count Number of spans
+ */
+static const Span *
+spanset_mgist_key_spans(Datum key, int *count)
+{
+  ArrayType *array = DatumGetArrayTypeP(key);
+  *count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+  return (const Span *) ARR_DATA_PTR(array);
+}
+
+/**
+ * @brief Return in the last argument the union of the spans of a multi-span
+ * index key
+ */
+static void
+spanset_mgist_key_span(Datum key, Span *result)
+{
+  int count;
+  const Span *spans = spanset_mgist_key_spans(key, &count);
+  memcpy(result, &spans[0], sizeof(Span));
+  for (int i = 1; i < count; i++)
+    span_expand(&spans[i], result);
+  return;
+}
+
+/**
+ * @brief Return a multi-span index key from an array of spans
+ */
+static Datum
+spanset_mgist_key_make(const Span *spans, int count)
+{
+  return PointerGetDatum(spanarr_to_array((Span *) spans, count));
+}
+
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+PGDLLEXPORT Datum Spanset_mgist_options(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spanset_mgist_options);
+/**
+ * @brief Multi-span GiST options method for span sets
+ */
+Datum
+Spanset_mgist_options(PG_FUNCTION_ARGS)
+{
+  local_relopts *relopts = (local_relopts *) PG_GETARG_POINTER(0);
+  init_local_reloptions(relopts, sizeof(SpansetMGistOptions));
+  add_local_int_reloption(relopts, "max_count",
+    "maximum number of spans indexed for a span set",
+    MGIST_MAX_COUNT_DEFAULT, 1, MGIST_MAX_COUNT_MAX,
+    offsetof(SpansetMGistOptions, max_count));
+  PG_RETURN_VOID();
+}
+#endif /* POSTGRESQL_VERSION_NUMBER >= 130000 */
+
+PGDLLEXPORT Datum Spanset_mgist_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spanset_mgist_compress);
+/**
+ * @brief Multi-span GiST compress method for span sets
+ */
+Datum
+Spanset_mgist_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  if (entry->leafkey)
+  {
+    int max_count = MGIST_MAX_COUNT_DEFAULT;
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+    if (PG_HAS_OPCLASS_OPTIONS())
+      max_count = ((SpansetMGistOptions *) PG_GET_OPCLASS_OPTIONS())->max_count;
+#endif /* POSTGRESQL_VERSION_NUMBER >= 130000 */
+    SpanSet *ss = (SpanSet *) PG_DETOAST_DATUM(entry->key);
+    int count;
+    Span *spans = spanset_spans(ss, max_count, &count);
+    GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+    gistentryinit(*retval, spanset_mgist_key_make(spans, count), entry->rel,
+      entry->page, entry->offset, false);
+    pfree(spans);
+    PG_RETURN_POINTER(retval);
+  }
+  PG_RETURN_POINTER(entry);
+}
+
+PGDLLEXPORT Datum Spanset_mgist_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spanset_mgist_consistent);
+/**
+ * @brief Multi-span GiST consistent method for span sets
+ * @details At the leaf level, the overlaps operator is tested against each
+ * span of the key, and so is the contains operator when the query is a value
+ * or a span, since a span contained in a span set is contained in one of its
+ * composing spans. In this way a span set is only returned when one of its
+ * spans reaches the query, instead of whenever its bounding span does. All
+ * the other operators are tested against the union of the spans, which is
+ * the bounding span of the value.
+ */
+Datum
+Spanset_mgist_consistent(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+  Oid typid = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
+  Span key, query;
+
+  /* All tests are lossy since the spans of a key may have been merged */
+  *recheck = true;
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_BOOL(false);
+
+  /* Transform the query into a span */
+  if (! span_gist_get_span(fcinfo, &query, typid))
+    PG_RETURN_BOOL(false);
+
+  if (GIST_LEAF(entry) && (strategy == RTOverlapStrategyNumber ||
+      (strategy == RTContainsStrategyNumber &&
+       ! spanset_type(oid_type(typid)))))
+  {
+    int count;
+    const Span *spans = spanset_mgist_key_spans(entry->key, &count);
+    for (int i = 0; i < count; i++)
+    {
+      if (span_index_consistent_leaf(&spans[i], &query, strategy))
+        PG_RETURN_BOOL(true);
+    }
+    PG_RETURN_BOOL(false);
+  }
+
+  spanset_mgist_key_span(entry->key, &key);
+  if (GIST_LEAF(entry))
+    result = span_index_consistent_leaf(&key, &query, strategy);
+  else
+    result = span_gist_consistent(&key, &query, strategy);
+  PG_RETURN_BOOL(result);
+}
+
+PGDLLEXPORT Datum Spanset_mgist_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spanset_mgist_union);
+/**
+ * @brief Multi-span GiST union method for span sets
+ */
+Datum
+Spanset_mgist_union(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  GISTENTRY *ent = entryvec->vector;
+  Span result, span;
+  spanset_mgist_key_span(ent[0].key, &result);
+  for (int i = 1; i < entryvec->n; i++)
+  {
+    spanset_mgist_key_span(ent[i].key, &span);
+    span_expand(&span, &result);
+  }
+  PG_RETURN_DATUM(spanset_mgist_key_make(&result, 1));
+}
+
+PGDLLEXPORT Datum Spanset_mgist_penalty(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spanset_mgist_penalty);
+/**
+ * @brief Multi-span GiST penalty method for span sets
+ * @details The penalty is the one of the GiST penalty method for spans
+ * applied to the union of the spans of the keys
+ */
+Datum
+Spanset_mgist_penalty(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  GISTENTRY *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
+  float *penalty = (float *) PG_GETARG_POINTER(2);
+  Span orig, new;
+  spanset_mgist_key_span(origentry->key, &orig);
+  spanset_mgist_key_span(newentry->key, &new);
+  SpanBound orig_lower, new_lower, orig_upper, new_upper;
+  span_deserialize(&orig, &orig_lower, &orig_upper);
+  span_deserialize(&new, &new_lower, &new_upper);
+
+  float8 diff = 0.0;
+  if (span_bound_cmp(&new_lower, &orig_lower) < 0)
+    diff += dist_double_value_value(orig.lower, new.lower, orig.basetype);
+  if (span_bound_cmp(&new_upper, &orig_upper) > 0)
+    diff += dist_double_value_value(new.upper, orig.upper, new.basetype);
+  *penalty = (float4) diff;
+  PG_RETURN_POINTER(penalty);
+}
+
+PGDLLEXPORT Datum Spanset_mgist_picksplit(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spanset_mgist_picksplit);
+/**
+ * @brief Multi-span GiST picksplit method for span sets
+ * @details The entries are replaced by their union span and split with the
+ * double sorting algorithm of the GiST picksplit method for spans
+ */
+Datum
+Spanset_mgist_picksplit(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+  GistEntryVector *spanvec = palloc(GEVHDRSZ +
+    sizeof(GISTENTRY) * entryvec->n);
+  Span *spans = palloc(sizeof(Span) * entryvec->n);
+  spanvec->n = entryvec->n;
+  for (OffsetNumber i = FirstOffsetNumber; i < entryvec->n; i++)
+  {
+    spanvec->vector[i] = entryvec->vector[i];
+    spanset_mgist_key_span(entryvec->vector[i].key, &spans[i]);
+    spanvec->vector[i].key = PointerGetDatum(&spans[i]);
+  }
+
+  size_t nbytes = entryvec->n * sizeof(OffsetNumber);
+  v->spl_left = palloc(nbytes);
+  v->spl_right = palloc(nbytes);
+  span_gist_double_sorting_split(spanvec, v);
+
+  v->spl_ldatum = spanset_mgist_key_make(DatumGetSpanP(v->spl_ldatum), 1);
+  v->spl_rdatum = spanset_mgist_key_make(DatumGetSpanP(v->spl_rdatum), 1);
+  pfree(spanvec); pfree(spans);
+  PG_RETURN_POINTER(v);
+}
+
+PGDLLEXPORT Datum Spanset_mgist_same(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spanset_mgist_same);
+/**
+ * @brief Multi-span GiST same method for span sets
+ * @details Return true only when the keys have exactly the same spans
+ */
+Datum
+Spanset_mgist_same(PG_FUNCTION_ARGS)
+{
+  ArrayType *key1 = PG_GETARG_ARRAYTYPE_P(0);
+  ArrayType *key2 = PG_GETARG_ARRAYTYPE_P(1);
+  bool *result = (bool *) PG_GETARG_POINTER(2);
+  *result = VARSIZE(key1) == VARSIZE(key2) &&
+    memcmp(key1, key2, VARSIZE(key1)) == 0;
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * GiST sortsupport method
+ *
+ * Sorted GiST builds, available since PostgreSQL 14, sort the keys before
+ * packing them into pages. The keys are ordered by the Hilbert index of the
+ * center of their bounding box, which keeps close boxes in the same pages.
+ * Each coordinate is mapped to an unsigned integer preserving its order, as
+ * done in PostGIS, so that no bounds of the data are needed.
+ *****************************************************************************/
+
+/**
+ * @brief Structure stored in the sortsupport state
+ */
+typedef struct
+{
+  uint64 (*sort_key)(Datum);  /**< Function computing the sort key */
+} BboxSortExtra;
+
+/**
+ * @brief Map a double to an unsigned 32-bit integer preserving the order
+ */
+static uint32
+double_sortable_uint32(double d)
+{
+  union { float f; uint32 u; } v;
+  v.f = (float) d;
+  /* Negative values have their order reversed */
+  if (v.u & 0x80000000)
+    v.u = ~v.u;
+  else
+    v.u |= 0x80000000;
+  return v.u;
+}
+
+/**
+ * @brief Map a double to an unsigned 64-bit integer preserving the order
+ */
+static uint64
+double_sortable_uint64(double d)
+{
+  union { double f; uint64 u; } v;
+  v.f = d;
+  if (v.u & UINT64CONST(0x8000000000000000))
+    v.u = ~v.u;
+  else
+    v.u |= UINT64CONST(0x8000000000000000);
+  return v.u;
+}
+
+/**
+ * @brief Return the Hilbert index of a point with up to 4 dimensions
+ * @param[in] coords Coordinates of the point
+ * @param[in] ndims Number of dimensions
+ * @note The index is computed with the algorithm of J. Skilling,
+ * "Programming the Hilbert curve", AIP Conference Proceedings 707, 2004,
+ * using 64 / ndims bits per dimension
+ */
+uint64
+bbox_sort_hilbert_key(const double *coords, int ndims)
+{
+  assert(ndims > 0 && ndims <= 4);
+  if (ndims == 1)
+    return double_sortable_uint64(coords[0]);
+
+  int nbits = 64 / ndims;
+  uint32 X[4], M = 1U << (nbits - 1), P, Q, t;
+  for (int i = 0; i < ndims; i++)
+    X[i] = double_sortable_uint32(coords[i]) >> (32 - nbits);
+  /* Inverse undo */
+  for (Q = M; Q > 1; Q >>= 1)
+  {
+    P = Q - 1;
+    for (int i = 0; i < ndims; i++)
+    {
+      if (X[i] & Q)
+        X[0] ^= P;
+      else
+      {
+        t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+  /* Gray encode */
+  for (int i = 1; i < ndims; i++)
+    X[i] ^= X[i - 1];
+  t = 0;
+  for (Q = M; Q > 1; Q >>= 1)
+  {
+    if (X[ndims - 1] & Q)
+      t ^= Q - 1;
+  }
+  for (int i = 0; i < ndims; i++)
+    X[i] ^= t;
+  /* Interleave the bits of the transposed index */
+  uint64 result = 0;
+  for (int b = nbits - 1; b >= 0; b--)
+  {
+    for (int i = 0; i < ndims; i++)
+      result = (result << 1) | ((X[i] >> b) & 1);
+  }
+  return result;
+}
+
+/**
+ * @brief Compare two sort keys
+ */
+static int
+bbox_sort_cmp_key(uint64 key1, uint64 key2)
+{
+  if (key1 < key2)
+    return -1;
+  if (key1 > key2)
+    return 1;
+  return 0;
+}
+
+/**
+ * @brief Compare two bounding boxes by their sort key
+ */
+static int
+bbox_sort_cmp(Datum x, Datum y, SortSupport ssup)
+{
+  BboxSortExtra *extra = (BboxSortExtra *) ssup->ssup_extra;
+  return bbox_sort_cmp_key(extra->sort_key(x), extra->sort_key(y));
+}
+
+/**
+ * @brief Compare two abbreviated sort keys
+ */
+static int
+bbox_sort_cmp_abbrev(Datum x, Datum y,
+  SortSupport ssup __attribute__((unused)))
+{
+  return bbox_sort_cmp_key((uint64) x, (uint64) y);
+}
+
+/**
+ * @brief Return the abbreviated sort key of a bounding box
+ */
+static Datum
+bbox_sort_abbrev_convert(Datum original, SortSupport ssup)
+{
+  BboxSortExtra *extra = (BboxSortExtra *) ssup->ssup_extra;
+  return (Datum) extra->sort_key(original);
+}
+
+/**
+ * @brief Never abort the abbreviation since the abbreviated key is the
+ * sort key
+ */
+static bool
+bbox_sort_abbrev_abort(int memtupcount __attribute__((unused)),
+  SortSupport ssup __attribute__((unused)))
+{
+  return false;
+}
+
+/**
+ * @brief Generic GiST sortsupport method for bounding box types
+ * @param[in] fcinfo Information about the function call
+ * @param[in] sort_key Function computing the sort key of a bounding box
+ */
+Datum
+bbox_gist_sortsupport(FunctionCallInfo fcinfo, uint64 (*sort_key)(Datum))
+{
+  SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+  BboxSortExtra *extra = MemoryContextAlloc(ssup->ssup_cxt,
+    sizeof(BboxSortExtra));
+  extra->sort_key = sort_key;
+  ssup->ssup_extra = extra;
+  ssup->comparator = &bbox_sort_cmp;
+  /* The sort key fits in an abbreviated key only for 64-bit datums */
+  if (ssup->abbreviate && SIZEOF_DATUM >= 8)
+  {
+    ssup->comparator = &bbox_sort_cmp_abbrev;
+    ssup->abbrev_converter = &bbox_sort_abbrev_convert;
+    ssup->abbrev_abort = &bbox_sort_abbrev_abort;
+    ssup->abbrev_full_comparator = &bbox_sort_cmp;
+  }
+  PG_RETURN_VOID();
+}
+
+/**
+ * @brief Return the center of a span as a double
+ */
+double
+span_center_double(const Span *s)
+{
+  if (s->basetype == T_TIMESTAMPTZ)
+    return ((double) DatumGetTimestampTz(s->lower) +
+      (double) DatumGetTimestampTz(s->upper)) / 2.0;
+  return (datum_double(s->lower, s->basetype) +
+    datum_double(s->upper, s->basetype)) / 2.0;
+}
+
+/**
+ * @brief Return the sort key of a span
+ */
+static uint64
+span_sort_key(Datum value)
+{
+  double center = span_center_double(DatumGetSpanP(value));
+  return bbox_sort_hilbert_key(&center, 1);
+}
+
+PGDLLEXPORT Datum Span_gist_sortsupport(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_gist_sortsupport);
+/**
+ * @brief GiST sortsupport method for span types
+ */
+Datum
+Span_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  return bbox_gist_sortsupport(fcinfo, &span_sort_key);
+}
+
 /*****************************************************************************
  * GiST fetch method
  *****************************************************************************/
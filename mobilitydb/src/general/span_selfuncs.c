@@ -49,6 +49,7 @@
 #include <meos_internal.h>
 #include "general/set.h"
 #include "general/span.h"
+#include "general/type_util.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
 #include "pg_general/span_analyze.h"
@@ -801,6 +802,90 @@ span_const_to_span(Node *other, Span *span)
   return;
 }
 
+/**
+ * @brief Return the frequency of an element in the most common elements
+ * statistics of a set column
+ * @param[in] value Element
+ * @param[in] sslot Statistics slot
+ * @param[in] basetype Base type of the set
+ * @note For elements that are not in the statistics, half of the minimum
+ * frequency is returned as done in array_selfuncs.c
+ */
+float8
+set_mcelem_freq(Datum value, const AttStatsSlot *sslot, meosType basetype)
+{
+  int lower = 0, upper = sslot->nvalues - 1;
+  while (lower <= upper)
+  {
+    int middle = (lower + upper) / 2;
+    int cmp = datum_cmp(sslot->values[middle], value, basetype);
+    if (cmp == 0)
+      return sslot->numbers[middle];
+    if (cmp < 0)
+      lower = middle + 1;
+    else
+      upper = middle - 1;
+  }
+  return sslot->numbers[sslot->nvalues] / 2.0;
+}
+
+/**
+ * @brief Return the selectivity of the contains and overlaps operators for a
+ * set column using the most common elements statistics, or -1 if the
+ * statistics are not available
+ * @param[in] vardata Structure storing statistics information
+ * @param[in] other Constant value or set
+ * @param[in] oper Operator
+ * @param[in] settype Type of the set column
+ * @note As in array_selfuncs.c, the occurrences of the elements are assumed
+ * to be independent
+ */
+static float8
+set_sel_mcelem(VariableStatData *vardata, Node *other, meosOper oper,
+  meosType settype)
+{
+  if (! HeapTupleIsValid(vardata->statsTuple))
+    return -1.0;
+
+  meosType basetype = settype_basetype(settype);
+  Datum constvalue = ((Const *) other)->constvalue;
+  meosType consttype = oid_type(((Const *) other)->consttype);
+  if (consttype != basetype && consttype != settype)
+    return -1.0;
+
+  AttStatsSlot sslot;
+  if (! get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_MCELEM,
+      InvalidOid, ATTSTATSSLOT_VALUES | ATTSTATSSLOT_NUMBERS))
+    return -1.0;
+  if (sslot.nvalues == 0 || sslot.nnumbers != sslot.nvalues + 3)
+  {
+    free_attstatsslot(&sslot);
+    return -1.0;
+  }
+
+  float8 selec;
+  if (consttype == basetype)
+    /* The operator is necessarily set @> value */
+    selec = set_mcelem_freq(constvalue, &sslot, basetype);
+  else
+  {
+    const Set *s = DatumGetSetP(constvalue);
+    selec = 1.0;
+    for (int i = 0; i < s->count; i++)
+    {
+      float8 freq = set_mcelem_freq(SET_VAL_N(s, i), &sslot, basetype);
+      /* For contains all the elements must be in the set, for overlaps
+       * at least one of them */
+      selec *= (oper == CONTAINS_OP) ? freq : 1.0 - freq;
+    }
+    if (oper == OVERLAPS_OP)
+      selec = 1.0 - selec;
+  }
+
+  free_attstatsslot(&sslot);
+  return selec;
+}
+
 /**
  * @brief Restriction selectivity for span operators
  */
@@ -901,13 +986,19 @@ span_sel(PlannerInfo *root, Oid operid, List *args, int varRelid)
   }
 
   /*
-   * Calculate selectivity using bound histograms. If that fails for
+   * Calculate selectivity using the most common elements for the contains
+   * and overlaps operators on sets, and using bound histograms otherwise or
+   * if the former are not available. If that fails for
    * some reason, e.g. no histogram in pg_statistic, use the default
    * constant estimate. This is still somewhat better than just
    * returning the default estimate, because this still takes into
    * account the fraction of NULL tuples, if we had statistics for them.
    */
-  float8 hist_selec = span_sel_hist(&vardata, &span, oper, value);
+  float8 hist_selec = -1.0;
+  if (set_type(ltype) && (oper == CONTAINS_OP || oper == OVERLAPS_OP))
+    hist_selec = set_sel_mcelem(&vardata, other, oper, ltype);
+  if (hist_selec < 0.0)
+    hist_selec = span_sel_hist(&vardata, &span, oper, value);
   if (hist_selec < 0.0)
     hist_selec = span_sel_default(operid);
 
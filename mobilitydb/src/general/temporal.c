@@ -46,6 +46,9 @@
   #include <access/tuptoaster.h>
 #endif
 #include <libpq/pqformat.h>
+#include <port/pg_crc32c.h>
+#include <utils/guc.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
@@ -62,6 +65,8 @@
 #include "pg_general/doxygen_mobilitydb_api.h"
 #include "pg_general/meos_catalog.h"
 #include "pg_general/type_util.h"
+#include "pg_point/tpoint_analyze.h"
+#include "pg_point/tpoint_join.h"
 #include "pg_point/tpoint_spatialfuncs.h"
 
 /* To avoid including fmgrprotos.h */
@@ -77,6 +82,50 @@ PG_MODULE_MAGIC;
  * Initialization function
  *****************************************************************************/
 
+/**
+ * @brief Global variable stating whether the send function of temporal types
+ * outputs the native binary format instead of the WKB format, and whether the
+ * receive function accepts the native binary format
+ */
+static bool MOBDB_NATIVE_BINARY = false;
+
+/**
+ * @brief Global variable stating whether the distances between temporal
+ * geography points are approximated on a sphere
+ */
+static bool MOBDB_FAST_GEODETIC = false;
+
+/**
+ * @brief Global variable stating whether the runtime statistics are tracked
+ */
+static bool MOBDB_TRACK_STATS = false;
+
+/**
+ * @brief Global variable that keeps the memory budget in kilobytes of the
+ * cache of detoasted temporal values, 0 disables the cache
+ */
+static int MOBDB_DETOAST_CACHE_SIZE = 16384;
+
+/**
+ * @brief Propagate the value of the statistics tracking to MEOS
+ */
+static void
+mobdb_track_stats_assign(bool newval, void *extra __attribute__((unused)))
+{
+  meos_set_track_stats(newval);
+  return;
+}
+
+/**
+ * @brief Propagate the value of the fast geodetic mode to MEOS
+ */
+static void
+mobdb_fast_geodetic_assign(bool newval, void *extra __attribute__((unused)))
+{
+  meos_set_fast_geodetic(newval);
+  return;
+}
+
 /**
  * @brief Initialize the MobilityDB extension
  */
@@ -85,6 +134,59 @@ _PG_init(void)
 {
   /* elog(WARNING, "This is MobilityDB."); */
   mobilitydb_init();
+  DefineCustomBoolVariable("mobilitydb.native_binary",
+    "Output and accept temporal values in the native binary format.",
+    "The native format copies the in-memory representation and can only be "
+    "read by a server with the same architecture and MobilityDB version. "
+    "The input of the native format is only accepted when the setting is on, "
+    "which only superusers can change.",
+    &MOBDB_NATIVE_BINARY, false, PGC_SUSET, 0, NULL, NULL, NULL);
+  DefineCustomIntVariable("mobilitydb.spacetime_histogram_size",
+    "Number of cells on each side of the space-time histogram of temporal "
+    "points collected by ANALYZE.",
+    "A value of 0 disables the joint histogram of the spatial and temporal "
+    "dimensions, whose selectivity is then estimated independently.",
+    &MOBDB_SPACETIME_HISTOGRAM_SIZE, 0, 0, 50, PGC_USERSET, 0, NULL, NULL,
+    NULL);
+  DefineCustomBoolVariable("mobilitydb.fast_geodetic",
+    "Approximate the distances between temporal geography points on a "
+    "sphere.",
+    "The length, cumulative length, speed, temporal distance to a point, and "
+    "temporal dwithin of temporal geography points use the haversine formula "
+    "instead of the WGS84 spheroid, with a relative error of about 0.5%.",
+    &MOBDB_FAST_GEODETIC, false, PGC_USERSET, 0, NULL,
+    &mobdb_fast_geodetic_assign, NULL);
+  DefineCustomBoolVariable("mobilitydb.track_stats",
+    "Collect runtime statistics of MobilityDB.",
+    "The statistics of the current backend, such as the instants processed "
+    "by lifted functions or the index matches that must be rechecked, are "
+    "shown by the mobilitydb_stat_counters view.",
+    &MOBDB_TRACK_STATS, false, PGC_USERSET, 0, NULL,
+    &mobdb_track_stats_assign, NULL);
+  DefineCustomIntVariable("mobilitydb.oid_cache_databases",
+    "Maximum number of databases whose type and operator Oid caches are "
+    "kept in shared memory.",
+    "The shared caches are only used when the library is loaded in "
+    "shared_preload_libraries. A value of 0 disables them and every backend "
+    "fills its own caches.",
+    &MOBDB_OID_CACHE_DATABASES, 4, 0, 64, PGC_POSTMASTER, 0, NULL, NULL,
+    NULL);
+  DefineCustomIntVariable("mobilitydb.detoast_cache_size",
+    "Memory budget of the cache of temporal values read from TOAST tables.",
+    "The functions called on the same temporal value of a row in a "
+    "transaction share a single fetch and decompression of the value. A "
+    "value of 0 disables the cache.",
+    &MOBDB_DETOAST_CACHE_SIZE, 16384, 0, MAX_KILOBYTES, PGC_USERSET,
+    GUC_UNIT_KB, NULL, NULL, NULL);
+  DefineCustomBoolVariable("mobilitydb.enable_spacetime_join",
+    "Enable the planner's use of partition-based spatiotemporal joins.",
+    "The inner joins of temporal geometry points on the &&, eIntersects, "
+    "or eDwithin predicates may be executed by partitioning the inner side "
+    "on a space-time grid and evaluating the join clauses on the pairs of "
+    "the same cells.",
+    &MOBDB_ENABLE_SPACETIME_JOIN, false, PGC_USERSET, 0, NULL, NULL, NULL);
+  tpoint_join_init();
+  oid_cache_init();
   return;
 }
 
@@ -118,11 +220,13 @@ static FunctionCallInfo MOBDB_PG_FCINFO;
 
 /**
  * @brief Fetch from the cache the fcinfo of the external function
+ * @note The fcinfo is NULL when the functions operating on the state of an
+ * aggregation are called outside of an aggregate, see
+ * #set_aggregation_context
  */
 FunctionCallInfo
 fetch_fcinfo()
 {
-  assert(MOBDB_PG_FCINFO);
   return MOBDB_PG_FCINFO;
 }
 
@@ -251,10 +355,11 @@ PG_FUNCTION_INFO_V1(Temporal_enforce_typmod);
 Datum
 Temporal_enforce_typmod(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  /* The value is returned in its storage format, which may be compressed */
+  Temporal *temp = (Temporal *) PG_DETOAST_DATUM(PG_GETARG_DATUM(0));
   int32 typmod = PG_GETARG_INT32(1);
   /* Check if temporal typmod is consistent with the supplied one */
-  temp = temporal_valid_typmod(temp, typmod);
+  temporal_valid_typmod(temp, typmod);
   PG_RETURN_TEMPORAL_P(temp);
 }
 
@@ -281,8 +386,187 @@ temporal_slice(Datum tempdatum)
   {
     /* TInstant subtype of Temporal DOES NOT keep the bounding box, so
      * we now detoast it completely */
+    pfree(result);
     result = (Temporal *) PG_DETOAST_DATUM(tempdatum);
   }
+  if (need_detoast)
+    MEOS_STAT_ADD(MEOS_STAT_DETOAST_BYTES, VARSIZE(result));
+  return result;
+}
+
+/*****************************************************************************
+ * Detoast cache
+ *****************************************************************************/
+
+/**
+ * @brief Maximum number of temporal values kept in the detoast cache
+ */
+#define DETOAST_CACHE_ENTRIES 16
+
+/**
+ * @brief Entry of the detoast cache, keyed on the TOAST pointer of the value
+ */
+typedef struct
+{
+  Oid toastrelid;      /**< Oid of the TOAST table of the value */
+  Oid valueid;         /**< Oid of the value in the TOAST table */
+  uint64 lastuse;      /**< Clock of the last access, for LRU eviction */
+  Temporal *temp;      /**< Detoasted and decompressed value */
+} DetoastCacheEntry;
+
+/**
+ * @brief Cache of the detoasted temporal values read in the current
+ * transaction
+ */
+typedef struct
+{
+  MemoryContext context; /**< Context of the cache and of its values */
+  MemoryContextCallback callback; /**< Forget the cache when it is deleted */
+  int count;           /**< Number of entries */
+  Size size;           /**< Total size in bytes of the cached values */
+  uint64 clock;        /**< Clock increased by every access */
+  DetoastCacheEntry entries[DETOAST_CACHE_ENTRIES];
+} DetoastCache;
+
+/**
+ * @brief Global variable that keeps the detoast cache of the transaction
+ */
+static DetoastCache *MOBDB_DETOAST_CACHE = NULL;
+
+/**
+ * @brief Forget the detoast cache when the context of the transaction that
+ * owns it is reset or deleted
+ */
+static void
+detoast_cache_reset(void *arg __attribute__((unused)))
+{
+  MOBDB_DETOAST_CACHE = NULL;
+  return;
+}
+
+/**
+ * @brief Return the detoast cache of the current transaction, creating it if
+ * needed
+ * @note The cache lives in a child of the transaction context. This is safe
+ * since TOAST values are never updated in place, an updated value receiving
+ * a new Oid in the TOAST table
+ */
+static DetoastCache *
+detoast_cache_get(void)
+{
+  if (MOBDB_DETOAST_CACHE)
+    return MOBDB_DETOAST_CACHE;
+  MemoryContext context = AllocSetContextCreate(TopTransactionContext,
+    "MobilityDB detoast cache", ALLOCSET_DEFAULT_SIZES);
+  DetoastCache *cache = MemoryContextAllocZero(context, sizeof(DetoastCache));
+  cache->context = context;
+  cache->callback.func = detoast_cache_reset;
+  cache->callback.arg = NULL;
+  MemoryContextRegisterResetCallback(context, &cache->callback);
+  MOBDB_DETOAST_CACHE = cache;
+  return cache;
+}
+
+/**
+ * @brief Return a copy of the temporal value with the TOAST pointer from the
+ * detoast cache, or NULL if it is not cached
+ * @note A copy is returned since the callers free their arguments with
+ * PG_FREE_IF_COPY
+ */
+static Temporal *
+detoast_cache_lookup(const struct varatt_external *toast_pointer)
+{
+  DetoastCache *cache = MOBDB_DETOAST_CACHE;
+  if (! cache)
+    return NULL;
+  for (int i = 0; i < cache->count; i++)
+  {
+    DetoastCacheEntry *entry = &cache->entries[i];
+    if (entry->valueid == toast_pointer->va_valueid &&
+        entry->toastrelid == toast_pointer->va_toastrelid)
+    {
+      entry->lastuse = ++cache->clock;
+      Size size = VARSIZE(entry->temp);
+      Temporal *result = palloc(size);
+      memcpy(result, entry->temp, size);
+      return result;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Add a copy of a detoasted temporal value to the detoast cache,
+ * evicting the least recently used values to keep within the memory budget
+ */
+static void
+detoast_cache_insert(const struct varatt_external *toast_pointer,
+  const Temporal *temp)
+{
+  Size size = VARSIZE(temp);
+  Size budget = (Size) MOBDB_DETOAST_CACHE_SIZE * 1024;
+  if (size > budget)
+    return;
+  DetoastCache *cache = detoast_cache_get();
+  while (cache->count > 0 && (cache->count == DETOAST_CACHE_ENTRIES ||
+    cache->size + size > budget))
+  {
+    int lru = 0;
+    for (int i = 1; i < cache->count; i++)
+    {
+      if (cache->entries[i].lastuse < cache->entries[lru].lastuse)
+        lru = i;
+    }
+    cache->size -= VARSIZE(cache->entries[lru].temp);
+    pfree(cache->entries[lru].temp);
+    cache->entries[lru] = cache->entries[--cache->count];
+  }
+  DetoastCacheEntry *entry = &cache->entries[cache->count++];
+  entry->toastrelid = toast_pointer->va_toastrelid;
+  entry->valueid = toast_pointer->va_valueid;
+  entry->lastuse = ++cache->clock;
+  entry->temp = MemoryContextAlloc(cache->context, size);
+  memcpy(entry->temp, temp, size);
+  cache->size += size;
+  return;
+}
+
+/**
+ * @brief Detoast a temporal datum and decompress it if it is stored in the
+ * compressed format
+ * @note The header and the bounding box of a compressed value are not
+ * compressed, so that #temporal_slice does not need to decompress it
+ * @note The values stored out of line are kept in the detoast cache, so that
+ * the functions called on the same column of a row share a single fetch and
+ * decompression of the value
+ */
+Temporal *
+temporal_detoast(Datum tempdatum)
+{
+  struct varlena *attr = (struct varlena *) DatumGetPointer(tempdatum);
+  struct varatt_external toast_pointer;
+  bool cacheable = MOBDB_DETOAST_CACHE_SIZE > 0 &&
+    VARATT_IS_EXTERNAL_ONDISK(attr);
+  if (cacheable)
+  {
+    VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+    Temporal *result = detoast_cache_lookup(&toast_pointer);
+    if (result)
+      return result;
+  }
+
+  Temporal *temp = (Temporal *) PG_DETOAST_DATUM(tempdatum);
+  if ((Pointer) temp != DatumGetPointer(tempdatum))
+    MEOS_STAT_ADD(MEOS_STAT_DETOAST_BYTES, VARSIZE(temp));
+  Temporal *result = temp;
+  if (temp->subtype != TINSTANT && MEOS_FLAGS_GET_COMPRESSED(temp->flags))
+  {
+    result = temporal_decompress(temp);
+    if ((Pointer) temp != DatumGetPointer(tempdatum))
+      pfree(temp);
+  }
+  if (cacheable)
+    detoast_cache_insert(&toast_pointer, result);
   return result;
 }
 
@@ -321,6 +605,68 @@ Mobilitydb_full_version(PG_FUNCTION_ARGS __attribute__((unused)))
   PG_RETURN_TEXT_P(result);
 }
 
+/*****************************************************************************
+ * Runtime statistics
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Mobilitydb_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Mobilitydb_stats);
+/**
+ * @ingroup mobilitydb_misc
+ * @brief Return the runtime statistics of the current backend as a set of
+ * (name, value) records
+ * @note The statistics are only tracked when the parameter
+ * `mobilitydb.track_stats` is set
+ * @sqlfn mobilitydb_stats()
+ */
+Datum
+Mobilitydb_stats(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    funcctx->max_calls = MEOS_STAT_NUMBER;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr >= funcctx->max_calls)
+    SRF_RETURN_DONE(funcctx);
+
+  meosStat stat = (meosStat) funcctx->call_cntr;
+  Datum values[2];
+  bool isnull[2] = {0, 0};
+  values[0] = PointerGetDatum(cstring2text(meos_stat_name(stat)));
+  values[1] = Int64GetDatum(meos_stat_value(stat));
+  HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+  SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+}
+
+PGDLLEXPORT Datum Mobilitydb_stats_reset(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Mobilitydb_stats_reset);
+/**
+ * @ingroup mobilitydb_misc
+ * @brief Reset the runtime statistics of the current backend
+ * @sqlfn mobilitydb_stats_reset()
+ */
+Datum
+Mobilitydb_stats_reset(PG_FUNCTION_ARGS __attribute__((unused)))
+{
+  meos_stats_reset();
+  PG_RETURN_VOID();
+}
+
 /*****************************************************************************
  * Send and receive functions
  * The send and receive functions are needed for temporal aggregation
@@ -485,6 +831,264 @@ temporal_write(const Temporal *temp, StringInfo buf)
   return;
 }
 
+/*****************************************************************************/
+
+/* Header of the native binary format: magic byte, version, endianness,
+ * size of the offsets, checksum, and size of the temporal value */
+#define MOBDB_NATIVE_MAGIC    0xFE
+#define MOBDB_NATIVE_VERSION  1
+#define MOBDB_NATIVE_HDRSIZE  (4 * sizeof(uint8) + 2 * sizeof(uint32))
+
+/**
+ * @brief Return the CRC-32C checksum of a temporal value
+ */
+static uint32
+temporal_native_checksum(const Temporal *temp)
+{
+  pg_crc32c crc;
+  INIT_CRC32C(crc);
+  COMP_CRC32C(crc, temp, VARSIZE(temp));
+  FIN_CRC32C(crc);
+  return (uint32) crc;
+}
+
+/**
+ * @brief Return the native binary representation of a temporal value
+ * @details The in-memory representation of the value is copied as is after
+ * a header stating the version, the architecture, and the checksum
+ */
+static bytea *
+temporal_native_send(const Temporal *temp)
+{
+  size_t size = VARSIZE(temp);
+  bytea *result = palloc(VARHDRSZ + MOBDB_NATIVE_HDRSIZE + size);
+  SET_VARSIZE(result, VARHDRSZ + MOBDB_NATIVE_HDRSIZE + size);
+  uint8 *ptr = (uint8 *) VARDATA(result);
+  ptr[0] = MOBDB_NATIVE_MAGIC;
+  ptr[1] = MOBDB_NATIVE_VERSION;
+  ptr[2] = MEOS_IS_BIG_ENDIAN ? XDR : NDR;
+  ptr[3] = sizeof(size_t);
+  uint32 crc = temporal_native_checksum(temp);
+  uint32 size32 = (uint32) size;
+  memcpy(ptr + 4, &crc, sizeof(uint32));
+  memcpy(ptr + 4 + sizeof(uint32), &size32, sizeof(uint32));
+  memcpy(ptr + MOBDB_NATIVE_HDRSIZE, temp, size);
+  return result;
+}
+
+/**
+ * @brief Return true if the base value of an instant of a native temporal
+ * point is a non-empty 2D or 3DZ point filling its memory and whose
+ * dimensions are those of the temporal point
+ * @param[in] gs Point
+ * @param[in] flags Flags of the temporal point
+ */
+static bool
+temporal_native_point_valid(const GSERIALIZED *gs, int16 flags)
+{
+  if (VARSIZE(gs) < offsetof(GSERIALIZED, data) || FLAGS_GET_M(gs->gflags) ||
+      FLAGS_GET_Z(gs->gflags) != MEOS_FLAGS_GET_Z(flags) ||
+      FLAGS_GET_GEODETIC(gs->gflags) != MEOS_FLAGS_GET_GEODETIC(flags))
+    return false;
+  /* The coordinates are read at the offset given by the flags of the point */
+  size_t ndims = MEOS_FLAGS_GET_Z(flags) ? 3 : 2;
+  size_t hdrsize = (size_t) (GS_POINT_PTR(gs) - (const uint8_t *) gs);
+  return VARSIZE(gs) == hdrsize + ndims * sizeof(double) &&
+    gserialized_get_type(gs) == POINTTYPE && ! gserialized_is_empty(gs);
+}
+
+/**
+ * @brief Return true if an instant of a native temporal value lies within a
+ * memory of a given size and its base value lies within the instant
+ * @param[in] inst Instant
+ * @param[in] maxsize Size of the memory available for the instant
+ * @param[in] temptype Temporal type of the value
+ * @param[in] flags Flags of the value
+ */
+static bool
+temporal_native_inst_valid(const TInstant *inst, size_t maxsize,
+  uint8 temptype, int16 flags)
+{
+  if (maxsize < sizeof(TInstant) || VARSIZE(inst) > maxsize ||
+      VARSIZE(inst) < sizeof(TInstant) || inst->temptype != temptype ||
+      inst->subtype != TINSTANT ||
+      MEOS_FLAGS_GET_Z(inst->flags) != MEOS_FLAGS_GET_Z(flags) ||
+      MEOS_FLAGS_GET_GEODETIC(inst->flags) != MEOS_FLAGS_GET_GEODETIC(flags))
+    return false;
+  meosType basetype = temptype_basetype(temptype);
+  if (basetype_byvalue(basetype))
+    return true;
+  size_t valuesize = VARSIZE(inst) - (sizeof(TInstant) - sizeof(Datum));
+  int16 typlen = basetype_length(basetype);
+  if (typlen != -1)
+    return valuesize >= (size_t) typlen;
+  /* Base values of variable length have an uncompressed 4-byte header */
+  const struct varlena *value = (const struct varlena *) &inst->value;
+  if (! VARATT_IS_4B_U(value) || VARSIZE(value) < VARHDRSZ ||
+      VARSIZE(value) > valuesize)
+    return false;
+  return ! tgeo_type(temptype) ||
+    temporal_native_point_valid((const GSERIALIZED *) value, flags);
+}
+
+/**
+ * @brief Return true if a sequence of a native temporal value lies within a
+ * memory of a given size and its instants are valid and ordered
+ * @param[in] seq Sequence
+ * @param[in] maxsize Size of the memory available for the sequence
+ * @param[in] temptype Temporal type of the value
+ * @param[in] flags Flags of the value, which determine the interpolation
+ */
+static bool
+temporal_native_seq_valid(const TSequence *seq, size_t maxsize,
+  uint8 temptype, int16 flags)
+{
+  if (maxsize < sizeof(TSequence) || VARSIZE(seq) > maxsize ||
+      VARSIZE(seq) < sizeof(TSequence))
+    return false;
+  interpType interp = MEOS_FLAGS_GET_INTERP(seq->flags);
+  if (seq->temptype != temptype ||
+      seq->subtype != TSEQUENCE || MEOS_FLAGS_GET_COMPRESSED(seq->flags) ||
+      interp != MEOS_FLAGS_GET_INTERP(flags) ||
+      (interp != DISCRETE && interp != STEP && interp != LINEAR) ||
+      (interp == LINEAR && ! temptype_continuous(temptype)) ||
+      MEOS_FLAGS_GET_Z(seq->flags) != MEOS_FLAGS_GET_Z(flags) ||
+      MEOS_FLAGS_GET_GEODETIC(seq->flags) != MEOS_FLAGS_GET_GEODETIC(flags) ||
+      seq->count <= 0 || seq->maxcount < seq->count ||
+      seq->bboxsize != (int16) DOUBLE_PAD(temporal_bbox_size(temptype)))
+    return false;
+  const size_t *offsets = TSEQUENCE_OFFSETS_PTR(seq);
+  const char *data = (const char *) offsets +
+    sizeof(size_t) * TSEQUENCE_NOFFSETS(seq);
+  const char *end = (const char *) seq + VARSIZE(seq);
+  if (data > end)
+    return false;
+  size_t avail = (size_t) (end - data);
+  bool fixed = MEOS_FLAGS_GET_FIXED(seq->flags);
+  if (fixed && (offsets[0] < sizeof(TInstant) ||
+      offsets[0] != DOUBLE_PAD(offsets[0]) ||
+      offsets[0] > avail / (size_t) seq->count))
+    return false;
+  for (int i = 0; i < seq->count; i++)
+  {
+    size_t offset = fixed ? offsets[0] * (size_t) i : offsets[i];
+    if (offset > avail || offset != DOUBLE_PAD(offset))
+      return false;
+    const TInstant *inst = (const TInstant *) (data + offset);
+    if (! temporal_native_inst_valid(inst, fixed ? offsets[0] :
+          avail - offset, temptype, flags) ||
+        (i > 0 && inst->t <= TSEQUENCE_INST_N(seq, i - 1)->t))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Return true if the sequences of a native temporal sequence set of a
+ * given size are valid and ordered
+ */
+static bool
+temporal_native_seqset_valid(const TSequenceSet *ss, size_t size)
+{
+  if (size < sizeof(TSequenceSet) || MEOS_FLAGS_GET_COMPRESSED(ss->flags) ||
+      MEOS_FLAGS_DISCRETE_INTERP(ss->flags) || ss->count <= 0 ||
+      ss->maxcount < ss->count ||
+      ss->bboxsize != (int16) DOUBLE_PAD(temporal_bbox_size(ss->temptype)))
+    return false;
+  const size_t *offsets = TSEQUENCESET_OFFSETS_PTR(ss);
+  const char *data = (const char *) offsets + sizeof(size_t) * ss->maxcount;
+  const char *end = (const char *) ss + size;
+  if (data > end)
+    return false;
+  size_t avail = (size_t) (end - data);
+  for (int i = 0; i < ss->count; i++)
+  {
+    if (offsets[i] > avail || offsets[i] != DOUBLE_PAD(offsets[i]))
+      return false;
+    const TSequence *seq = (const TSequence *) (data + offsets[i]);
+    if (! temporal_native_seq_valid(seq, avail - offsets[i], ss->temptype,
+        ss->flags))
+      return false;
+    if (i > 0)
+    {
+      const TSequence *prev = TSEQUENCESET_SEQ_N(ss, i - 1);
+      if (TSEQUENCE_INST_N(seq, 0)->t <
+          TSEQUENCE_INST_N(prev, prev->count - 1)->t)
+        return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Return true if a native temporal value is consistent with its size
+ * @details The structure of the value and every base value are checked, so
+ * that no function applied to the value reads outside its memory
+ */
+static bool
+temporal_native_valid(const Temporal *temp, size_t size)
+{
+  if (size < sizeof(TInstant) || VARSIZE(temp) != size)
+    return false;
+  if (temp->subtype == TINSTANT)
+    return temporal_native_inst_valid((const TInstant *) temp, size,
+      temp->temptype, temp->flags);
+  if (temp->subtype == TSEQUENCE)
+    return temporal_native_seq_valid((const TSequence *) temp, size,
+      temp->temptype, temp->flags);
+  if (temp->subtype == TSEQUENCESET)
+    return temporal_native_seqset_valid((const TSequenceSet *) temp, size);
+  return false;
+}
+
+/**
+ * @brief Return a temporal value of a given type from its native binary
+ * representation
+ * @details The native format is only accepted when the superuser setting
+ * mobilitydb.native_binary is on. The value is fully validated before its
+ * checksum, which only protects against accidental corruption.
+ */
+static Temporal *
+temporal_native_recv(StringInfo buf, meosType temptype)
+{
+  if (! MOBDB_NATIVE_BINARY)
+    ereport(ERROR, (errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+      errmsg("Native binary input of temporal values is disabled"),
+      errhint("A superuser can enable it by setting mobilitydb.native_binary "
+        "to on.")));
+  const uint8 *ptr = (const uint8 *) buf->data + buf->cursor;
+  size_t len = (size_t) (buf->len - buf->cursor);
+  if (len < MOBDB_NATIVE_HDRSIZE)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+      errmsg("Invalid native binary representation of a temporal value")));
+  if (ptr[1] != MOBDB_NATIVE_VERSION ||
+      ptr[2] != (MEOS_IS_BIG_ENDIAN ? XDR : NDR) || ptr[3] != sizeof(size_t))
+    ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+      errmsg("Native binary representation of a temporal value from an "
+        "incompatible version or architecture")));
+  uint32 crc, size;
+  memcpy(&crc, ptr + 4, sizeof(uint32));
+  memcpy(&size, ptr + 4 + sizeof(uint32), sizeof(uint32));
+  if (size != len - MOBDB_NATIVE_HDRSIZE || size < sizeof(TInstant))
+    ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+      errmsg("Invalid native binary representation of a temporal value")));
+  /* Copy the value to get an aligned memory before validating it */
+  Temporal *result = palloc(size);
+  memcpy(result, ptr + MOBDB_NATIVE_HDRSIZE, size);
+  if (result->temptype != temptype)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+      errmsg("Native binary representation of a temporal value of another "
+        "type than %s", meostype_name(temptype))));
+  if (! temporal_native_valid(result, size))
+    ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+      errmsg("Invalid native binary representation of a temporal value")));
+  if (temporal_native_checksum(result) != crc)
+    ereport(ERROR, (errcode(ERRCODE_DATA_CORRUPTED),
+      errmsg("Checksum mismatch in the native binary representation of a "
+        "temporal value")));
+  return result;
+}
+
 PGDLLEXPORT Datum Temporal_recv(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Temporal_recv);
 /**
@@ -497,7 +1101,12 @@ Datum
 Temporal_recv(PG_FUNCTION_ARGS)
 {
   StringInfo buf = (StringInfo) PG_GETARG_POINTER(0);
-  Temporal *result = temporal_from_wkb((uint8_t *) buf->data, buf->len);
+  Oid temptypid = PG_GETARG_OID(1);
+  /* The first byte of the WKB format is the endian flag, either 0 or 1 */
+  Temporal *result = (buf->len > 0 &&
+    (uint8) buf->data[0] == MOBDB_NATIVE_MAGIC) ?
+    temporal_native_recv(buf, oid_type(temptypid)) :
+    temporal_from_wkb((uint8_t *) buf->data, buf->len);
   /* Set cursor to the end of buffer (so the backend is happy) */
   buf->cursor = buf->len;
   PG_RETURN_TEMPORAL_P(result);
@@ -514,6 +1123,12 @@ Datum
 Temporal_send(PG_FUNCTION_ARGS)
 {
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  if (MOBDB_NATIVE_BINARY)
+  {
+    bytea *result = temporal_native_send(temp);
+    PG_FREE_IF_COPY(temp, 0);
+    PG_RETURN_BYTEA_P(result);
+  }
   /* Add SRID to binary representation */
   uint8_t variant = WKB_EXTENDED;
   size_t wkb_size = VARSIZE_ANY_EXHDR(temp);
@@ -786,7 +1401,7 @@ PG_FUNCTION_INFO_V1(Tnumber_to_span);
 Datum
 Tnumber_to_span(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(0);
   Span *result = tnumber_to_span(temp);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_SPAN_P(result);
@@ -1802,6 +2417,27 @@ Temporal_unnest(PG_FUNCTION_ARGS)
   SRF_RETURN_NEXT(funcctx, result);
 }
 
+/*****************************************************************************/
+
+PGDLLEXPORT Datum Temporal_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_compress);
+/**
+ * @ingroup mobilitydb_temporal_transf
+ * @brief Return a temporal value in the compressed storage format
+ * @note The value is transparently decompressed by every function that
+ * receives it, while the functions that only read its bounding box, such as
+ * the index support functions, do not need to decompress it
+ * @sqlfn compress()
+ */
+Datum
+Temporal_compress(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *result = temporal_compress(temp);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 /*****************************************************************************
  * Append and merge functions
  *****************************************************************************/
@@ -2572,6 +3208,39 @@ Temporal_ne(PG_FUNCTION_ARGS)
 
 /*****************************************************************************/
 
+/**
+ * @brief Return -1, 0, or 1 depending on whether the first temporal value
+ * is less than, equal to, or greater than the second temporal value
+ * @note The bounding boxes are first compared on the header slices of the
+ * arguments, which are fully detoasted only when the boxes are equal
+ */
+static int
+temporal_cmp_ext(FunctionCallInfo fcinfo)
+{
+  Temporal *temp1 = PG_GETARG_TEMPORAL_SLICE(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_SLICE(1);
+  int result = 0;
+  /* Different temporal types are reported by #temporal_cmp below */
+  if (temp1->temptype == temp2->temptype)
+  {
+    bboxunion box1, box2;
+    temporal_set_bbox(temp1, &box1);
+    temporal_set_bbox(temp2, &box2);
+    result = temporal_bbox_cmp(&box1, &box2, temp1->temptype);
+  }
+  PG_FREE_IF_COPY(temp1, 0);
+  PG_FREE_IF_COPY(temp2, 1);
+  if (result)
+    return result;
+
+  temp1 = PG_GETARG_TEMPORAL_P(0);
+  temp2 = PG_GETARG_TEMPORAL_P(1);
+  result = temporal_cmp(temp1, temp2);
+  PG_FREE_IF_COPY(temp1, 0);
+  PG_FREE_IF_COPY(temp2, 1);
+  return result;
+}
+
 PGDLLEXPORT Datum Temporal_cmp(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Temporal_cmp);
 /**
@@ -2583,12 +3252,7 @@ PG_FUNCTION_INFO_V1(Temporal_cmp);
 Datum
 Temporal_cmp(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
-  int result = temporal_cmp(temp1, temp2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
-  PG_RETURN_INT32(result);
+  PG_RETURN_INT32(temporal_cmp_ext(fcinfo));
 }
 
 PGDLLEXPORT Datum Temporal_lt(PG_FUNCTION_ARGS);
@@ -2602,12 +3266,7 @@ PG_FUNCTION_INFO_V1(Temporal_lt);
 Datum
 Temporal_lt(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
-  bool result = temporal_lt(temp1, temp2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
-  PG_RETURN_BOOL(result);
+  PG_RETURN_BOOL(temporal_cmp_ext(fcinfo) < 0);
 }
 
 PGDLLEXPORT Datum Temporal_le(PG_FUNCTION_ARGS);
@@ -2622,12 +3281,7 @@ PG_FUNCTION_INFO_V1(Temporal_le);
 Datum
 Temporal_le(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
-  bool result = temporal_le(temp1, temp2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
-  PG_RETURN_BOOL(result);
+  PG_RETURN_BOOL(temporal_cmp_ext(fcinfo) <= 0);
 }
 
 PGDLLEXPORT Datum Temporal_ge(PG_FUNCTION_ARGS);
@@ -2642,12 +3296,7 @@ PG_FUNCTION_INFO_V1(Temporal_ge);
 Datum
 Temporal_ge(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
-  bool result = temporal_ge(temp1, temp2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
-  PG_RETURN_BOOL(result);
+  PG_RETURN_BOOL(temporal_cmp_ext(fcinfo) >= 0);
 }
 
 PGDLLEXPORT Datum Temporal_gt(PG_FUNCTION_ARGS);
@@ -2661,12 +3310,7 @@ PG_FUNCTION_INFO_V1(Temporal_gt);
 Datum
 Temporal_gt(PG_FUNCTION_ARGS)
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
-  bool result = temporal_gt(temp1, temp2);
-  PG_FREE_IF_COPY(temp1, 0);
-  PG_FREE_IF_COPY(temp2, 1);
-  PG_RETURN_BOOL(result);
+  PG_RETURN_BOOL(temporal_cmp_ext(fcinfo) > 0);
 }
 
 /*****************************************************************************
@@ -2689,4 +3333,21 @@ Temporal_hash(PG_FUNCTION_ARGS)
   PG_RETURN_UINT32(result);
 }
 
+PGDLLEXPORT Datum Temporal_hash_extended(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_hash_extended);
+/**
+ * @ingroup mobilitydb_temporal_accessor
+ * @brief Return the 64-bit hash value of a temporal value using a seed
+ * @sqlfn temporal_hash_extended()
+ */
+Datum
+Temporal_hash_extended(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  uint64 seed = PG_GETARG_INT64(1);
+  uint64 result = temporal_hash_extended(temp, seed);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_UINT64(result);
+}
+
 /*****************************************************************************/
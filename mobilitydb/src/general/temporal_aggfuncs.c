@@ -36,6 +36,7 @@
 
 /* C */
 #include <assert.h>
+#include <string.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include <utils/timestamp.h>
@@ -244,6 +245,127 @@ Temporal_tcount_combinefn(PG_FUNCTION_ARGS)
   return Temporal_tagg_combinefn(fcinfo, &datum_sum_int32, false);
 }
 
+/*****************************************************************************
+ * Temporal approximate distinct count
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Temporal_tcount_distinct_transfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_tcount_distinct_transfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Transition function for approximate temporal distinct count
+ * aggregation of temporal values
+ * @sqlfn tcountDistinct()
+ */
+Datum
+Temporal_tcount_distinct_transfn(PG_FUNCTION_ARGS)
+{
+  TcountDistinctState *state = PG_ARGISNULL(0) ? NULL :
+    (TcountDistinctState *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1) || PG_ARGISNULL(2) || PG_ARGISNULL(3) ||
+      (PG_NARGS() > 4 && PG_ARGISNULL(4)))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
+  int64 id = PG_GETARG_INT64(1);
+  Temporal *temp = PG_GETARG_TEMPORAL_P(2);
+  Interval *duration = PG_GETARG_INTERVAL_P(3);
+  TimestampTz torigin = (PG_NARGS() > 4) ? PG_GETARG_TIMESTAMPTZ(4) :
+    pg_timestamptz_in("2000-01-03", -1);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  state = temporal_tcount_distinct_transfn(state, id, temp, duration,
+    torigin);
+  unset_aggregation_context(ctx);
+  PG_FREE_IF_COPY(temp, 2);
+  PG_RETURN_POINTER(state);
+}
+
+PGDLLEXPORT Datum Temporal_tcount_distinct_combinefn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_tcount_distinct_combinefn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Combine function for approximate temporal distinct count aggregation
+ * of temporal values
+ * @sqlfn tcountDistinct()
+ */
+Datum
+Temporal_tcount_distinct_combinefn(PG_FUNCTION_ARGS)
+{
+  TcountDistinctState *state1 = PG_ARGISNULL(0) ? NULL :
+    (TcountDistinctState *) PG_GETARG_POINTER(0);
+  TcountDistinctState *state2 = PG_ARGISNULL(1) ? NULL :
+    (TcountDistinctState *) PG_GETARG_POINTER(1);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  TcountDistinctState *result = temporal_tcount_distinct_combinefn(state1,
+    state2);
+  unset_aggregation_context(ctx);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Temporal_tcount_distinct_finalfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_tcount_distinct_finalfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Final function for approximate temporal distinct count aggregation of
+ * temporal values
+ * @sqlfn tcountDistinct()
+ */
+Datum
+Temporal_tcount_distinct_finalfn(PG_FUNCTION_ARGS)
+{
+  if (PG_ARGISNULL(0))
+    PG_RETURN_NULL();
+  TcountDistinctState *state = (TcountDistinctState *) PG_GETARG_POINTER(0);
+  Temporal *result = temporal_tcount_distinct_finalfn(state);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Tcount_distinct_serialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tcount_distinct_serialize);
+/**
+ * @brief Serialize the state of the approximate temporal distinct count
+ * aggregation
+ * @note Since the state is a flat varlena value only the time buckets in use
+ * are copied
+ */
+Datum
+Tcount_distinct_serialize(PG_FUNCTION_ARGS)
+{
+  TcountDistinctState *state = (TcountDistinctState *) PG_GETARG_POINTER(0);
+  size_t size = sizeof(TcountDistinctState) +
+    (size_t) state->count * (sizeof(TimestampTz) + HLL_REGISTERS);
+  TcountDistinctState *result = palloc(size);
+  memcpy(result, state, size);
+  SET_VARSIZE(result, size);
+  result->capacity = state->count;
+  PG_RETURN_BYTEA_P((bytea *) result);
+}
+
+PGDLLEXPORT Datum Tcount_distinct_deserialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tcount_distinct_deserialize);
+/**
+ * @brief Deserialize the state of the approximate temporal distinct count
+ * aggregation
+ */
+Datum
+Tcount_distinct_deserialize(PG_FUNCTION_ARGS)
+{
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  /* The data of a bytea is not aligned on a double boundary */
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  TcountDistinctState *result = palloc(VARSIZE(data));
+  unset_aggregation_context(ctx);
+  memcpy(result, data, VARSIZE(data));
+  PG_RETURN_POINTER(result);
+}
+
 /*****************************************************************************
  * Temporal extent
  *****************************************************************************/
@@ -615,6 +737,157 @@ Tnumber_tavg_finalfn(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(result);
 }
 
+/*****************************************************************************
+ * Approximate temporal count and average
+ *****************************************************************************/
+
+/**
+ * @brief Generic transition function for the approximate temporal aggregates
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Transition function
+ */
+static Datum
+Temporal_approx_transfn(FunctionCallInfo fcinfo,
+  SkipList *(*func)(SkipList *, const Temporal *, double, const Interval *,
+    TimestampTz))
+{
+  SkipList *state;
+  INPUT_AGG_TRANS_STATE(fcinfo, state);
+  if (PG_ARGISNULL(2) || PG_ARGISNULL(3) ||
+      (PG_NARGS() > 4 && PG_ARGISNULL(4)))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
+  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  double fraction = PG_GETARG_FLOAT8(2);
+  Interval *duration = PG_GETARG_INTERVAL_P(3);
+  TimestampTz torigin = (PG_NARGS() > 4) ? PG_GETARG_TIMESTAMPTZ(4) :
+    pg_timestamptz_in("2000-01-03", -1);
+  store_fcinfo(fcinfo);
+  state = func(state, temp, fraction, duration, torigin);
+  PG_FREE_IF_COPY(temp, 1);
+  if (! state)
+    PG_RETURN_NULL();
+  PG_RETURN_SKIPLIST_P(state);
+}
+
+PGDLLEXPORT Datum Temporal_tcount_approx_transfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_tcount_approx_transfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Transition function for approximate temporal count aggregation of
+ * temporal values
+ * @sqlfn tcountApprox(), tcountApproxError()
+ */
+Datum
+Temporal_tcount_approx_transfn(PG_FUNCTION_ARGS)
+{
+  return Temporal_approx_transfn(fcinfo, &temporal_tcount_approx_transfn);
+}
+
+PGDLLEXPORT Datum Temporal_tcount_approx_finalfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_tcount_approx_finalfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Final function for approximate temporal count aggregation of
+ * temporal values
+ * @sqlfn tcountApprox()
+ */
+Datum
+Temporal_tcount_approx_finalfn(PG_FUNCTION_ARGS)
+{
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  Temporal *result = temporal_tcount_approx_finalfn(state);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Temporal_tcount_approx_error_finalfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_tcount_approx_error_finalfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Final function for the error of the approximate temporal count
+ * aggregation of temporal values
+ * @sqlfn tcountApproxError()
+ */
+Datum
+Temporal_tcount_approx_error_finalfn(PG_FUNCTION_ARGS)
+{
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  Temporal *result = temporal_tcount_approx_error_finalfn(state);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Tnumber_tavg_approx_transfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_tavg_approx_transfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Transition function for approximate temporal average aggregation of
+ * temporal numbers
+ * @sqlfn tavgApprox(), tavgApproxError()
+ */
+Datum
+Tnumber_tavg_approx_transfn(PG_FUNCTION_ARGS)
+{
+  return Temporal_approx_transfn(fcinfo, &tnumber_tavg_approx_transfn);
+}
+
+PGDLLEXPORT Datum Tnumber_tavg_approx_combinefn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_tavg_approx_combinefn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Combine function for approximate temporal average aggregation of
+ * temporal numbers
+ * @sqlfn tavgApprox(), tavgApproxError()
+ */
+Datum
+Tnumber_tavg_approx_combinefn(PG_FUNCTION_ARGS)
+{
+  return Temporal_tagg_combinefn(fcinfo, &datum_sum_double3, false);
+}
+
+PGDLLEXPORT Datum Tnumber_tavg_approx_finalfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_tavg_approx_finalfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Final function for approximate temporal average aggregation of
+ * temporal numbers
+ * @sqlfn tavgApprox()
+ */
+Datum
+Tnumber_tavg_approx_finalfn(PG_FUNCTION_ARGS)
+{
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  Temporal *result = tnumber_tavg_approx_finalfn(state);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Tnumber_tavg_approx_error_finalfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_tavg_approx_error_finalfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Final function for the error of the approximate temporal average
+ * aggregation of temporal numbers
+ * @sqlfn tavgApproxError()
+ */
+Datum
+Tnumber_tavg_approx_error_finalfn(PG_FUNCTION_ARGS)
+{
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  Temporal *result = tnumber_tavg_approx_error_finalfn(state);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 /*****************************************************************************/
 
 PGDLLEXPORT Datum Temporal_merge_transfn(PG_FUNCTION_ARGS);
@@ -723,6 +996,52 @@ Temporal_app_tseq_transfn(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(state);
 }
 
+/**
+ * @brief Generic combine function for append temporal instant/sequence
+ * aggregate
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Function combining the two partial states
+ */
+static Datum
+Temporal_app_combinefn(FunctionCallInfo fcinfo,
+  Temporal * (*func)(Temporal *, Temporal *))
+{
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  Temporal *state1 = PG_ARGISNULL(0) ? NULL : PG_GETARG_TEMPORAL_P(0);
+  Temporal *state2 = PG_ARGISNULL(1) ? NULL : PG_GETARG_TEMPORAL_P(1);
+  Temporal *result = func(state1, state2);
+  unset_aggregation_context(ctx);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Temporal_app_tinst_combinefn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_app_tinst_combinefn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Combine function for append temporal instant aggregate
+ * @sqlfn appendInstant()
+ */
+Datum
+Temporal_app_tinst_combinefn(PG_FUNCTION_ARGS)
+{
+  return Temporal_app_combinefn(fcinfo, &temporal_app_tinst_combinefn);
+}
+
+PGDLLEXPORT Datum Temporal_app_tseq_combinefn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_app_tseq_combinefn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Combine function for append temporal sequence aggregate
+ * @sqlfn appendSequence()
+ */
+Datum
+Temporal_app_tseq_combinefn(PG_FUNCTION_ARGS)
+{
+  return Temporal_app_combinefn(fcinfo, &temporal_app_tseq_combinefn);
+}
+
 PGDLLEXPORT Datum Temporal_append_finalfn(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Temporal_append_finalfn);
 /**
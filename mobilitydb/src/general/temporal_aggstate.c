@@ -0,0 +1,474 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Persistent states of temporal aggregates
+ * @details The state of the temporal count and temporal centroid aggregates
+ * can be kept as a value of the @p taggstate type. Such a value can be stored
+ * in a table, merged with the state of newer values, expired before a
+ * timestamp, and finalized on demand, so that the result of an aggregation
+ * over a growing table is maintained at the cost of the new values only.
+ */
+
+/* C */
+#include <string.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <fmgr.h>
+#include <libpq/pqformat.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/skiplist.h"
+#include "general/temporal_aggfuncs.h"
+#include "general/type_util.h"
+/* MobilityDB */
+#include "pg_general/skiplist.h"
+
+/*****************************************************************************/
+
+/**
+ * @brief Enumeration of the aggregate functions whose state can be persisted
+ */
+typedef enum
+{
+  TAGG_TCOUNT = 1,
+  TAGG_TCENTROID = 2,
+} taggFunc;
+
+/**
+ * @brief Structure to represent the persisted state of a temporal aggregate
+ * @details The header is followed by the serialized state of the aggregate,
+ * which must be aligned on a double boundary
+ */
+typedef struct
+{
+  int32 vl_len_;   /**< Varlena header (do not touch directly!) */
+  int16 aggfunc;   /**< Aggregate function */
+  int16 padding1;  /**< Unused */
+  int32 padding2;  /**< Unused */
+} TaggState;
+
+#define TAGGSTATE_DATA(s)  ((char *) (s) + sizeof(TaggState))
+#define TAGGSTATE_SIZE(s)  (VARSIZE(s) - sizeof(TaggState))
+
+#define PG_GETARG_TAGGSTATE_P(X) \
+  ((TaggState *) PG_DETOAST_DATUM(PG_GETARG_DATUM(X)))
+#define PG_RETURN_TAGGSTATE_P(X)  PG_RETURN_POINTER(X)
+
+/**
+ * @brief Return the name of an aggregate function whose state is persisted
+ */
+static const char *
+taggfunc_name(int16 aggfunc)
+{
+  return (aggfunc == TAGG_TCOUNT) ? "tCount" :
+    ((aggfunc == TAGG_TCENTROID) ? "tCentroid" : "unknown");
+}
+
+/**
+ * @brief Ensure that a persisted aggregate state is of a given aggregate
+ * function
+ */
+static void
+ensure_taggstate_func(const TaggState *state, int16 aggfunc)
+{
+  if (state->aggfunc != aggfunc)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The aggregate state is a state of %s and not of %s",
+        taggfunc_name(state->aggfunc), taggfunc_name(aggfunc))));
+  return;
+}
+
+/**
+ * @brief Return a persisted aggregate state with room for a serialized state
+ * of a given size
+ */
+static TaggState *
+taggstate_make(int16 aggfunc, size_t size)
+{
+  TaggState *result = palloc0(sizeof(TaggState) + size);
+  SET_VARSIZE(result, sizeof(TaggState) + size);
+  result->aggfunc = aggfunc;
+  return result;
+}
+
+/**
+ * @brief Return the persisted state of a temporal count aggregation
+ */
+static TaggState *
+skiplist_taggstate(const SkipList *list)
+{
+  TaggState *result = taggstate_make(TAGG_TCOUNT,
+    skiplist_serialize_size(list));
+  skiplist_serialize(list, TAGGSTATE_DATA(result));
+  return result;
+}
+
+/**
+ * @brief Return the persisted state of a temporal centroid aggregation
+ */
+static TaggState *
+tcentroid_taggstate(const TCentroidState *state)
+{
+  TaggState *result = taggstate_make(TAGG_TCENTROID,
+    tcentroid_state_serialize_size(state));
+  tcentroid_state_serialize(state, TAGGSTATE_DATA(result));
+  return result;
+}
+
+/**
+ * @brief Return the skiplist of the state of a temporal count aggregation
+ * @note The skiplist is allocated in the current memory context
+ */
+static SkipList *
+taggstate_skiplist(const TaggState *state)
+{
+  ensure_taggstate_func(state, TAGG_TCOUNT);
+  store_fcinfo(NULL);
+  SkipList *result = skiplist_deserialize(TAGGSTATE_DATA(state),
+    TAGGSTATE_SIZE(state));
+  /* The values of the state are either instants or sequences of integers */
+  void **values = skiplist_values(result);
+  uint8 subtype = ((Temporal *) values[0])->subtype;
+  for (int i = 0; i < result->length; i++)
+  {
+    const Temporal *temp = (const Temporal *) values[i];
+    if (temp->temptype != T_TINT || temp->subtype != subtype ||
+        (subtype != TINSTANT && subtype != TSEQUENCE))
+      ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+        errmsg("Invalid serialized state of a temporal aggregate")));
+  }
+  pfree(values);
+  return result;
+}
+
+/**
+ * @brief Return the state of a temporal centroid aggregation
+ */
+static TCentroidState *
+taggstate_tcentroid_state(const TaggState *state)
+{
+  ensure_taggstate_func(state, TAGG_TCENTROID);
+  return tcentroid_state_deserialize(TAGGSTATE_DATA(state),
+    TAGGSTATE_SIZE(state));
+}
+
+/**
+ * @brief Return a persisted aggregate state from its representation as
+ * a sequence of bytes after ensuring its validity
+ */
+static TaggState *
+taggstate_from_bytes(const char *bytes, size_t size)
+{
+  if (size < sizeof(TaggState) - VARHDRSZ)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+      errmsg("Invalid serialized state of a temporal aggregate")));
+  TaggState *result = palloc(VARHDRSZ + size);
+  SET_VARSIZE(result, VARHDRSZ + size);
+  memcpy(VARDATA(result), bytes, size);
+  if (result->aggfunc == TAGG_TCOUNT)
+    skiplist_free(taggstate_skiplist(result));
+  else if (result->aggfunc == TAGG_TCENTROID)
+    tcentroid_state_free(taggstate_tcentroid_state(result));
+  else
+    ereport(ERROR, (errcode(ERRCODE_INVALID_BINARY_REPRESENTATION),
+      errmsg("Invalid serialized state of a temporal aggregate")));
+  return result;
+}
+
+/*****************************************************************************
+ * Input/output functions
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Taggstate_in(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Taggstate_in);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return a persisted aggregate state from its hexadecimal
+ * representation
+ * @sqlfn taggstate_in()
+ */
+Datum
+Taggstate_in(PG_FUNCTION_ARGS)
+{
+  const char *str = PG_GETARG_CSTRING(0);
+  size_t len = strlen(str);
+  if (len % 2 != 0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+      errmsg("Invalid hexadecimal representation of an aggregate state")));
+  char *bytes = palloc(len / 2 + 1);
+  for (size_t i = 0; i < len / 2; i++)
+  {
+    int byte = 0;
+    for (int j = 0; j < 2; j++)
+    {
+      char c = str[2 * i + j];
+      int digit = (c >= '0' && c <= '9') ? c - '0' :
+        ((c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+        ((c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1));
+      if (digit < 0)
+        ereport(ERROR, (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+          errmsg("Invalid hexadecimal representation of an aggregate state")));
+      byte = (byte << 4) | digit;
+    }
+    bytes[i] = (char) byte;
+  }
+  TaggState *result = taggstate_from_bytes(bytes, len / 2);
+  pfree(bytes);
+  PG_RETURN_TAGGSTATE_P(result);
+}
+
+PGDLLEXPORT Datum Taggstate_out(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Taggstate_out);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the hexadecimal representation of a persisted aggregate state
+ * @note The representation keeps the native memory layout of the state, it
+ * is meant for dumping and restoring the values on the same platform
+ * @sqlfn taggstate_out()
+ */
+Datum
+Taggstate_out(PG_FUNCTION_ARGS)
+{
+  static const char hexchr[] = "0123456789ABCDEF";
+  TaggState *state = PG_GETARG_TAGGSTATE_P(0);
+  const uint8 *bytes = (const uint8 *) VARDATA(state);
+  size_t size = VARSIZE(state) - VARHDRSZ;
+  char *result = palloc(2 * size + 1);
+  for (size_t i = 0; i < size; i++)
+  {
+    result[2 * i] = hexchr[bytes[i] >> 4];
+    result[2 * i + 1] = hexchr[bytes[i] & 0x0F];
+  }
+  result[2 * size] = '\0';
+  PG_FREE_IF_COPY(state, 0);
+  PG_RETURN_CSTRING(result);
+}
+
+PGDLLEXPORT Datum Taggstate_recv(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Taggstate_recv);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return a persisted aggregate state from its binary representation
+ * @sqlfn taggstate_recv()
+ */
+Datum
+Taggstate_recv(PG_FUNCTION_ARGS)
+{
+  StringInfo buf = (StringInfo) PG_GETARG_POINTER(0);
+  TaggState *result = taggstate_from_bytes(buf->data + buf->cursor,
+    buf->len - buf->cursor);
+  /* Set cursor to the end of buffer (so the backend is happy) */
+  buf->cursor = buf->len;
+  PG_RETURN_TAGGSTATE_P(result);
+}
+
+PGDLLEXPORT Datum Taggstate_send(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Taggstate_send);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the binary representation of a persisted aggregate state
+ * @sqlfn taggstate_send()
+ */
+Datum
+Taggstate_send(PG_FUNCTION_ARGS)
+{
+  TaggState *state = PG_GETARG_TAGGSTATE_P(0);
+  bytea *result = bstring2bytea((uint8_t *) VARDATA(state),
+    VARSIZE(state) - VARHDRSZ);
+  PG_FREE_IF_COPY(state, 0);
+  PG_RETURN_BYTEA_P(result);
+}
+
+/*****************************************************************************
+ * Final functions of the aggregates returning their state
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tcount_state_finalfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tcount_state_finalfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Final function returning the persisted state of a temporal count
+ * aggregation
+ * @sqlfn tCountState()
+ */
+Datum
+Tcount_state_finalfn(PG_FUNCTION_ARGS)
+{
+  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  if (! state || state->length == 0)
+    PG_RETURN_NULL();
+  PG_RETURN_TAGGSTATE_P(skiplist_taggstate(state));
+}
+
+PGDLLEXPORT Datum Tcentroid_state_finalfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tcentroid_state_finalfn);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Final function returning the persisted state of a temporal centroid
+ * aggregation
+ * @sqlfn tCentroidState()
+ */
+Datum
+Tcentroid_state_finalfn(PG_FUNCTION_ARGS)
+{
+  TCentroidState *state = (TCentroidState *) PG_GETARG_POINTER(0);
+  if (! state || state->nruns == 0)
+    PG_RETURN_NULL();
+  PG_RETURN_TAGGSTATE_P(tcentroid_taggstate(state));
+}
+
+/*****************************************************************************
+ * Functions on persisted aggregate states
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Taggstate_merge(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Taggstate_merge);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the merge of two persisted states of the same temporal
+ * aggregate, where a null state is ignored
+ * @sqlfn taggMerge()
+ */
+Datum
+Taggstate_merge(PG_FUNCTION_ARGS)
+{
+  if (PG_ARGISNULL(0) && PG_ARGISNULL(1))
+    PG_RETURN_NULL();
+  if (PG_ARGISNULL(0))
+    PG_RETURN_DATUM(PG_GETARG_DATUM(1));
+  if (PG_ARGISNULL(1))
+    PG_RETURN_DATUM(PG_GETARG_DATUM(0));
+  TaggState *state1 = PG_GETARG_TAGGSTATE_P(0);
+  TaggState *state2 = PG_GETARG_TAGGSTATE_P(1);
+  ensure_taggstate_func(state2, state1->aggfunc);
+  TaggState *result;
+  if (state1->aggfunc == TAGG_TCOUNT)
+  {
+    SkipList *list1 = taggstate_skiplist(state1);
+    SkipList *list2 = taggstate_skiplist(state2);
+    list1 = temporal_tagg_combinefn(list1, list2, &datum_sum_int32, false);
+    result = skiplist_taggstate(list1);
+    skiplist_free(list1); skiplist_free(list2);
+  }
+  else
+  {
+    TCentroidState *cstate1 = taggstate_tcentroid_state(state1);
+    TCentroidState *cstate2 = taggstate_tcentroid_state(state2);
+    cstate1 = tpoint_tcentroid_combinefn(cstate1, cstate2);
+    result = tcentroid_taggstate(cstate1);
+    tcentroid_state_free(cstate1); tcentroid_state_free(cstate2);
+  }
+  PG_FREE_IF_COPY(state1, 0);
+  PG_FREE_IF_COPY(state2, 1);
+  PG_RETURN_TAGGSTATE_P(result);
+}
+
+PGDLLEXPORT Datum Taggstate_expire(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Taggstate_expire);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return a persisted aggregate state without the values before a
+ * timestamp
+ * @sqlfn taggExpire()
+ */
+Datum
+Taggstate_expire(PG_FUNCTION_ARGS)
+{
+  TaggState *state = PG_GETARG_TAGGSTATE_P(0);
+  TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+  TaggState *result = NULL;
+  if (state->aggfunc == TAGG_TCOUNT)
+  {
+    SkipList *list = temporal_tagg_expire(taggstate_skiplist(state), t);
+    if (list)
+    {
+      result = skiplist_taggstate(list);
+      skiplist_free(list);
+    }
+  }
+  else
+  {
+    TCentroidState *cstate = tcentroid_state_expire(
+      taggstate_tcentroid_state(state), t);
+    if (cstate)
+    {
+      result = tcentroid_taggstate(cstate);
+      tcentroid_state_free(cstate);
+    }
+  }
+  PG_FREE_IF_COPY(state, 0);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TAGGSTATE_P(result);
+}
+
+PGDLLEXPORT Datum Taggstate_tcount(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Taggstate_tcount);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the temporal count from a persisted aggregate state
+ * @sqlfn tCountFinal()
+ */
+Datum
+Taggstate_tcount(PG_FUNCTION_ARGS)
+{
+  TaggState *state = PG_GETARG_TAGGSTATE_P(0);
+  /* The final function frees the skiplist */
+  Temporal *result = temporal_tagg_finalfn(taggstate_skiplist(state));
+  PG_FREE_IF_COPY(state, 0);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Taggstate_tcentroid(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Taggstate_tcentroid);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the temporal centroid from a persisted aggregate state
+ * @sqlfn tCentroidFinal()
+ */
+Datum
+Taggstate_tcentroid(PG_FUNCTION_ARGS)
+{
+  TaggState *state = PG_GETARG_TAGGSTATE_P(0);
+  TCentroidState *cstate = taggstate_tcentroid_state(state);
+  Temporal *result = tpoint_tcentroid_finalfn(cstate);
+  tcentroid_state_free(cstate);
+  PG_FREE_IF_COPY(state, 0);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
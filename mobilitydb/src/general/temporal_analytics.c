@@ -36,6 +36,7 @@
 
 /* C */
 #include <assert.h>
+#include <float.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include <funcapi.h>
@@ -178,12 +179,13 @@ Temporal_similarity(FunctionCallInfo fcinfo, SimFunc simfunc)
 {
   Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
   Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  int band = (PG_NARGS() > 2 && ! PG_ARGISNULL(2)) ? PG_GETARG_INT32(2) : -1;
   /* Store fcinfo into a global variable for temporal geography points */
   if (temp1->temptype == T_TGEOGPOINT)
     store_fcinfo(fcinfo);
   double result = (simfunc == HAUSDORFF) ?
     temporal_hausdorff_distance(temp1, temp2) :
-    temporal_similarity(temp1, temp2, simfunc);
+    temporal_similarity(temp1, temp2, simfunc, band, DBL_MAX);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
   PG_RETURN_FLOAT8(result);
@@ -216,6 +218,109 @@ Temporal_dyntimewarp_distance(PG_FUNCTION_ARGS)
   return Temporal_similarity(fcinfo, DYNTIMEWARP);
 }
 
+/**
+ * @brief Return true if the similarity distance between two temporal values
+ * is less than or equal to a bound
+ * @details The computation of the distance is abandoned as soon as the bound
+ * is exceeded
+ */
+static Datum
+Temporal_similarity_within(FunctionCallInfo fcinfo, SimFunc simfunc)
+{
+  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  double dist = PG_GETARG_FLOAT8(2);
+  int band = (PG_NARGS() > 3 && ! PG_ARGISNULL(3)) ? PG_GETARG_INT32(3) : -1;
+  if (dist < 0.0)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("The distance cannot be negative: %f", dist)));
+  /* Store fcinfo into a global variable for temporal geography points */
+  if (temp1->temptype == T_TGEOGPOINT)
+    store_fcinfo(fcinfo);
+  double d = (simfunc == HAUSDORFF) ?
+    temporal_hausdorff(temp1, temp2, dist) :
+    temporal_similarity(temp1, temp2, simfunc, band, dist);
+  bool result = d <= dist;
+  PG_FREE_IF_COPY(temp1, 0);
+  PG_FREE_IF_COPY(temp2, 1);
+  PG_RETURN_BOOL(result);
+}
+
+PGDLLEXPORT Datum Temporal_frechet_distance_within(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_frechet_distance_within);
+/**
+ * @ingroup mobilitydb_temporal_analytics_similarity
+ * @brief Return true if the discrete Frechet distance between two temporal
+ * values is less than or equal to a bound
+ * @sqlfn frechetDistanceWithin()
+ */
+Datum
+Temporal_frechet_distance_within(PG_FUNCTION_ARGS)
+{
+  return Temporal_similarity_within(fcinfo, FRECHET);
+}
+
+PGDLLEXPORT Datum Temporal_dyntimewarp_distance_within(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_dyntimewarp_distance_within);
+/**
+ * @ingroup mobilitydb_temporal_analytics_similarity
+ * @brief Return true if the Dynamic Time Warp (DTW) distance between two
+ * temporal values is less than or equal to a bound
+ * @sqlfn dynTimeWarpDistanceWithin()
+ */
+Datum
+Temporal_dyntimewarp_distance_within(PG_FUNCTION_ARGS)
+{
+  return Temporal_similarity_within(fcinfo, DYNTIMEWARP);
+}
+
+/**
+ * @brief Return a lower bound of the similarity distance between two
+ * temporal values
+ */
+static Datum
+Temporal_similarity_lower_bound(FunctionCallInfo fcinfo, SimFunc simfunc)
+{
+  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  int band = (PG_NARGS() > 2 && ! PG_ARGISNULL(2)) ? PG_GETARG_INT32(2) : -1;
+  /* Store fcinfo into a global variable for temporal geography points */
+  if (temp1->temptype == T_TGEOGPOINT)
+    store_fcinfo(fcinfo);
+  double result = temporal_similarity_lower_bound(temp1, temp2, simfunc, band);
+  PG_FREE_IF_COPY(temp1, 0);
+  PG_FREE_IF_COPY(temp2, 1);
+  PG_RETURN_FLOAT8(result);
+}
+
+PGDLLEXPORT Datum Temporal_frechet_lower_bound(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_frechet_lower_bound);
+/**
+ * @ingroup mobilitydb_temporal_analytics_similarity
+ * @brief Return a lower bound of the discrete Frechet distance between two
+ * temporal values
+ * @sqlfn frechetLowerBound()
+ */
+Datum
+Temporal_frechet_lower_bound(PG_FUNCTION_ARGS)
+{
+  return Temporal_similarity_lower_bound(fcinfo, FRECHET);
+}
+
+PGDLLEXPORT Datum Temporal_dyntimewarp_lower_bound(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_dyntimewarp_lower_bound);
+/**
+ * @ingroup mobilitydb_temporal_analytics_similarity
+ * @brief Return a lower bound of the Dynamic Time Warp (DTW) distance between
+ * two temporal values
+ * @sqlfn dynTimeWarpLowerBound()
+ */
+Datum
+Temporal_dyntimewarp_lower_bound(PG_FUNCTION_ARGS)
+{
+  return Temporal_similarity_lower_bound(fcinfo, DYNTIMEWARP);
+}
+
 PGDLLEXPORT Datum Temporal_hausdorff_distance(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Temporal_hausdorff_distance);
 /**
@@ -229,6 +334,20 @@ Temporal_hausdorff_distance(PG_FUNCTION_ARGS)
   return Temporal_similarity(fcinfo, HAUSDORFF);
 }
 
+PGDLLEXPORT Datum Temporal_hausdorff_distance_within(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_hausdorff_distance_within);
+/**
+ * @ingroup mobilitydb_temporal_analytics_similarity
+ * @brief Return true if the Hausdorff distance between two temporal values
+ * is less than or equal to a bound
+ * @sqlfn hausdorffDistanceWithin()
+ */
+Datum
+Temporal_hausdorff_distance_within(PG_FUNCTION_ARGS)
+{
+  return Temporal_similarity_within(fcinfo, HAUSDORFF);
+}
+
 /*****************************************************************************
  * Similarity path between two temporal values from the distance matrix
  *****************************************************************************/
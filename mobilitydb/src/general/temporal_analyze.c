@@ -109,6 +109,8 @@ TemporalAnalyzeExtraData *temporal_extra_data;
  * @param[in] samplerows Number of sample rows
  * @param[in] totalrows Only used for temporal spatial types.
  * @note Function derived from compute_span_stats of file spantypes_typanalyze.c
+ * @note All the statistics are derived from the bounding box of the values,
+ * and thus only the header of the values stored out of line is fetched
  */
 static void
 temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
@@ -151,10 +153,11 @@ temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       continue;
     }
 
-    total_width += VARSIZE(value);
+    total_width += VARSIZE_ANY(DatumGetPointer(value));
 
-    /* Get temporal value */
-    Temporal *temp = DatumGetTemporalP(value);
+    /* Get the header of the temporal value, which contains the bounding box,
+     * without detoasting nor decompressing the instants */
+    Temporal *temp = temporal_slice(value);
 
     /* Remember bounds and length for further usage in histograms */
     if (tnumber)
@@ -181,6 +184,10 @@ temporal_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     time_lengths[non_null_cnt] = distance_value_value(tstzspan_upper.val,
       tstzspan_lower.val, T_TIMESTAMPTZ);
 
+    /* Free up memory if the header was copied */
+    if ((Pointer) temp != DatumGetPointer(value))
+      pfree(temp);
+
     /* Increment non null count */
     non_null_cnt++;
   }
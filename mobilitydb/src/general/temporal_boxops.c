@@ -55,6 +55,7 @@
 #include "general/tbox.h"
 #include "general/temporal.h"
 /* MobilityDB */
+#include "pg_general/temporal.h"
 #include "pg_general/type_util.h"
 
 /*****************************************************************************/
@@ -114,7 +115,7 @@ Boxop_tstzspan_temporal(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
   Span *s = PG_GETARG_SPAN_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(1);
   bool result = boxop_temporal_tstzspan(temp, s, func, INVERT);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
@@ -130,7 +131,7 @@ Datum
 Boxop_temporal_tstzspan(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(0);
   Span *s = PG_GETARG_SPAN_P(1);
   bool result = boxop_temporal_tstzspan(temp, s, func, INVERT_NO);
   PG_FREE_IF_COPY(temp, 0);
@@ -146,8 +147,8 @@ Datum
 Boxop_temporal_temporal(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  Temporal *temp1 = PG_GETARG_TEMPORAL_SLICE(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_SLICE(1);
   bool result = boxop_temporal_temporal(temp1, temp2, func);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
@@ -402,7 +403,7 @@ Boxop_numspan_tnumber(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
   Span *s = PG_GETARG_SPAN_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(1);
   bool result = boxop_tnumber_numspan(temp, s, func, INVERT);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
@@ -417,7 +418,7 @@ Datum
 Boxop_tnumber_numspan(FunctionCallInfo fcinfo,
   bool (*func)(const Span *, const Span *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(0);
   Span *s = PG_GETARG_SPAN_P(1);
   bool result = boxop_tnumber_numspan(temp, s, func, INVERT_NO);
   PG_FREE_IF_COPY(temp, 0);
@@ -435,9 +436,7 @@ Boxop_tbox_tnumber(FunctionCallInfo fcinfo,
   bool (*func)(const TBox *, const TBox *))
 {
   TBox *box = PG_GETARG_TBOX_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  TBox box1;
-  temporal_set_bbox(temp, &box1);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(1);
   bool result = boxop_tnumber_tbox(temp, box, func, INVERT);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
@@ -453,7 +452,7 @@ Datum
 Boxop_tnumber_tbox(FunctionCallInfo fcinfo,
   bool (*func)(const TBox *, const TBox *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(0);
   TBox *box = PG_GETARG_TBOX_P(1);
   bool result = boxop_tnumber_tbox(temp, box, func, INVERT_NO);
   PG_FREE_IF_COPY(temp, 0);
@@ -469,8 +468,8 @@ Datum
 Boxop_tnumber_tnumber(FunctionCallInfo fcinfo,
   bool (*func)(const TBox *, const TBox *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  Temporal *temp1 = PG_GETARG_TEMPORAL_SLICE(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_SLICE(1);
   bool result = boxop_tnumber_tnumber(temp1, temp2, func);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
@@ -0,0 +1,432 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief BRIN indexes for span, box, and temporal types
+ *
+ * The summary of a block range is the bounding box of its values, that is,
+ * a timestamptz span, a temporal box, or a spatiotemporal box. Since the
+ * summary of a block range plays the role of an internal entry of a GiST
+ * index, the consistent functions of the GiST indexes are reused for
+ * deciding whether a block range must be scanned.
+ */
+
+#include "pg_general/temporal_brin.h"
+
+/* C */
+#include <assert.h>
+
+/* PostgreSQL */
+#include <postgres.h>
+#include <access/brin_internal.h>
+#include <access/brin_tuple.h>
+#include <access/skey.h>
+#include <utils/datum.h>
+#include <utils/typcache.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/span.h"
+#include "general/tbox.h"
+#include "general/temporal.h"
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+#include "pg_general/span_gist.h"
+#include "pg_general/temporal.h"
+#include "pg_general/tnumber_gist.h"
+
+/*****************************************************************************
+ * Generic functions
+ *****************************************************************************/
+
+/**
+ * @brief Return the size of a bounding box type
+ */
+static size_t
+bbox_brin_size(meosType bboxtype)
+{
+  if (bboxtype == T_TSTZSPAN)
+    return sizeof(Span);
+  if (bboxtype == T_TBOX)
+    return sizeof(TBox);
+  assert(bboxtype == T_STBOX);
+  return sizeof(STBox);
+}
+
+/**
+ * @brief Return the information about a BRIN operator class whose summary
+ * is a bounding box
+ * @param[in] bboxtype Type of the bounding box
+ */
+Datum
+bbox_brin_opcinfo(meosType bboxtype)
+{
+  BrinOpcInfo *result = palloc0(MAXALIGN(SizeofBrinOpcInfo(1)));
+  result->oi_nstored = 1;
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  result->oi_regular_nulls = true;
+#endif /* POSTGRESQL_VERSION_NUMBER >= 140000 */
+  result->oi_typcache[0] = lookup_type_cache(type_oid(bboxtype), 0);
+  PG_RETURN_POINTER(result);
+}
+
+/**
+ * @brief Expand the summary of a block range with a new value
+ * @param[in] fcinfo Information about the function call
+ * @param[in] bboxtype Type of the bounding box
+ * @param[in] set_bbox Function computing the bounding box of a value
+ * @param[in] bbox_adjust Function expanding a box to include another one
+ * @return True when the summary has been modified
+ */
+Datum
+bbox_brin_add_value(FunctionCallInfo fcinfo, meosType bboxtype,
+  void (*set_bbox)(Datum, void *), void (*bbox_adjust)(void *, void *))
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  Datum newval = PG_GETARG_DATUM(2);
+  bool isnull = PG_GETARG_BOOL(3);
+  size_t size = bbox_brin_size(bboxtype);
+  bboxunion box, newunion;
+
+  /* Null values are handled by the BRIN framework since PostgreSQL 14 */
+  if (isnull)
+  {
+    if (column->bv_hasnulls)
+      PG_RETURN_BOOL(false);
+    column->bv_hasnulls = true;
+    PG_RETURN_BOOL(true);
+  }
+
+  set_bbox(newval, &box);
+  /* The block range is empty, store the box of the value */
+  if (column->bv_allnulls)
+  {
+    column->bv_values[0] = datumCopy(PointerGetDatum(&box), false,
+      (int) size);
+    column->bv_allnulls = false;
+    PG_RETURN_BOOL(true);
+  }
+  /* Expand the summary unless it already contains the box of the value */
+  memcpy(&newunion, DatumGetPointer(column->bv_values[0]), size);
+  bbox_adjust(&newunion, &box);
+  if (memcmp(&newunion, DatumGetPointer(column->bv_values[0]), size) == 0)
+    PG_RETURN_BOOL(false);
+  memcpy(DatumGetPointer(column->bv_values[0]), &newunion, size);
+  PG_RETURN_BOOL(true);
+}
+
+/**
+ * @brief Determine whether a block range may contain values satisfying a
+ * scan key
+ * @param[in] fcinfo Information about the function call
+ * @param[in] bboxtype Type of the bounding box
+ * @param[in] get_query Function transforming the query into a box
+ * @param[in] consistent Internal-page consistent function of the GiST index
+ */
+Datum
+bbox_brin_consistent(FunctionCallInfo fcinfo, meosType bboxtype,
+  bool (*get_query)(Datum, meosType, void *),
+  bool (*consistent)(const void *, const void *, StrategyNumber))
+{
+  BrinValues *column = (BrinValues *) PG_GETARG_POINTER(1);
+  ScanKey key = (ScanKey) PG_GETARG_POINTER(2);
+  bboxunion query;
+
+  /* Null keys and ranges are handled by the BRIN framework since
+   * PostgreSQL 14 */
+  if (key->sk_flags & SK_ISNULL)
+  {
+    if (key->sk_flags & SK_SEARCHNULL)
+      PG_RETURN_BOOL(column->bv_allnulls || column->bv_hasnulls);
+    if (key->sk_flags & SK_SEARCHNOTNULL)
+      PG_RETURN_BOOL(! column->bv_allnulls);
+    PG_RETURN_BOOL(false);
+  }
+  if (column->bv_allnulls)
+    PG_RETURN_BOOL(false);
+
+  /* Transform the query into a box */
+  if (! get_query(key->sk_argument, oid_type(key->sk_subtype), &query))
+    PG_RETURN_BOOL(false);
+  PG_RETURN_BOOL(consistent(DatumGetPointer(column->bv_values[0]), &query,
+    key->sk_strategy));
+}
+
+/**
+ * @brief Merge the summary of the second block range into the first one
+ * @param[in] fcinfo Information about the function call
+ * @param[in] bboxtype Type of the bounding box
+ * @param[in] bbox_adjust Function expanding a box to include another one
+ */
+Datum
+bbox_brin_union(FunctionCallInfo fcinfo, meosType bboxtype,
+  void (*bbox_adjust)(void *, void *))
+{
+  BrinValues *col_a = (BrinValues *) PG_GETARG_POINTER(1);
+  BrinValues *col_b = (BrinValues *) PG_GETARG_POINTER(2);
+
+  /* Null values are handled by the BRIN framework since PostgreSQL 14 */
+  if (! col_a->bv_hasnulls && col_b->bv_hasnulls)
+    col_a->bv_hasnulls = true;
+  if (col_b->bv_allnulls)
+    PG_RETURN_VOID();
+  if (col_a->bv_allnulls)
+  {
+    col_a->bv_allnulls = false;
+    col_a->bv_values[0] = datumCopy(col_b->bv_values[0], false,
+      (int) bbox_brin_size(bboxtype));
+    PG_RETURN_VOID();
+  }
+  bbox_adjust(DatumGetPointer(col_a->bv_values[0]),
+    DatumGetPointer(col_b->bv_values[0]));
+  PG_RETURN_VOID();
+}
+
+/*****************************************************************************
+ * Callback functions for timestamptz spans and temporal boxes
+ *****************************************************************************/
+
+/**
+ * @brief Expand the first span to include the second one
+ */
+static void
+span_brin_adjust(void *bbox1, void *bbox2)
+{
+  span_expand((Span *) bbox2, (Span *) bbox1);
+  return;
+}
+
+/**
+ * @brief Set the span from a timestamptz span
+ */
+static void
+span_brin_set_span(Datum value, void *result)
+{
+  memcpy(result, DatumGetSpanP(value), sizeof(Span));
+  return;
+}
+
+/**
+ * @brief Set the span from a temporal value
+ */
+static void
+temporal_brin_set_span(Datum value, void *result)
+{
+  temporal_set_tstzspan(temporal_slice(value), (Span *) result);
+  return;
+}
+
+/**
+ * @brief Transform the query into a span
+ */
+static bool
+span_brin_get_query(Datum value, meosType type, void *result)
+{
+  return span_index_get_span(value, type, (Span *) result);
+}
+
+/**
+ * @brief Consistent function for spans
+ */
+static bool
+span_brin_consistent(const void *key, const void *query,
+  StrategyNumber strategy)
+{
+  return span_gist_consistent((const Span *) key, (const Span *) query,
+    strategy);
+}
+
+/**
+ * @brief Set the box from a temporal box
+ */
+static void
+tbox_brin_set_tbox(Datum value, void *result)
+{
+  memcpy(result, DatumGetTboxP(value), sizeof(TBox));
+  return;
+}
+
+/**
+ * @brief Set the box from a temporal number
+ */
+static void
+tnumber_brin_set_tbox(Datum value, void *result)
+{
+  tnumber_set_tbox(temporal_slice(value), (TBox *) result);
+  return;
+}
+
+/**
+ * @brief Transform the query into a temporal box
+ */
+static bool
+tbox_brin_get_query(Datum value, meosType type, void *result)
+{
+  return tnumber_index_get_tbox(value, type, (TBox *) result);
+}
+
+/**
+ * @brief Consistent function for temporal boxes
+ */
+static bool
+tbox_brin_consistent(const void *key, const void *query,
+  StrategyNumber strategy)
+{
+  return tnumber_gist_consistent((const TBox *) key, (const TBox *) query,
+    strategy);
+}
+
+/*****************************************************************************
+ * BRIN methods for timestamptz spans and temporal types whose bounding box
+ * is a timestamptz span
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Span_brin_opcinfo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_brin_opcinfo);
+/**
+ * @brief BRIN opcinfo method for timestamptz spans
+ */
+Datum
+Span_brin_opcinfo(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_opcinfo(T_TSTZSPAN);
+}
+
+PGDLLEXPORT Datum Span_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_brin_add_value);
+/**
+ * @brief BRIN add value method for timestamptz spans
+ */
+Datum
+Span_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, T_TSTZSPAN, &span_brin_set_span,
+    &span_brin_adjust);
+}
+
+PGDLLEXPORT Datum Temporal_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_brin_add_value);
+/**
+ * @brief BRIN add value method for temporal types whose bounding box is a
+ * timestamptz span
+ */
+Datum
+Temporal_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, T_TSTZSPAN, &temporal_brin_set_span,
+    &span_brin_adjust);
+}
+
+PGDLLEXPORT Datum Span_brin_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_brin_consistent);
+/**
+ * @brief BRIN consistent method for timestamptz spans
+ */
+Datum
+Span_brin_consistent(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_consistent(fcinfo, T_TSTZSPAN, &span_brin_get_query,
+    &span_brin_consistent);
+}
+
+PGDLLEXPORT Datum Span_brin_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Span_brin_union);
+/**
+ * @brief BRIN union method for timestamptz spans
+ */
+Datum
+Span_brin_union(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_union(fcinfo, T_TSTZSPAN, &span_brin_adjust);
+}
+
+/*****************************************************************************
+ * BRIN methods for temporal boxes and temporal numbers
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tbox_brin_opcinfo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_opcinfo);
+/**
+ * @brief BRIN opcinfo method for temporal boxes
+ */
+Datum
+Tbox_brin_opcinfo(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_opcinfo(T_TBOX);
+}
+
+PGDLLEXPORT Datum Tbox_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_add_value);
+/**
+ * @brief BRIN add value method for temporal boxes
+ */
+Datum
+Tbox_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, T_TBOX, &tbox_brin_set_tbox,
+    &tbox_adjust);
+}
+
+PGDLLEXPORT Datum Tnumber_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_brin_add_value);
+/**
+ * @brief BRIN add value method for temporal numbers
+ */
+Datum
+Tnumber_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, T_TBOX, &tnumber_brin_set_tbox,
+    &tbox_adjust);
+}
+
+PGDLLEXPORT Datum Tbox_brin_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_consistent);
+/**
+ * @brief BRIN consistent method for temporal boxes
+ */
+Datum
+Tbox_brin_consistent(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_consistent(fcinfo, T_TBOX, &tbox_brin_get_query,
+    &tbox_brin_consistent);
+}
+
+PGDLLEXPORT Datum Tbox_brin_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_brin_union);
+/**
+ * @brief BRIN union method for temporal boxes
+ */
+Datum
+Tbox_brin_union(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_union(fcinfo, T_TBOX, &tbox_adjust);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,247 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Random generation of temporal values
+ * @details These functions are the C counterpart of the PL/pgSQL generators
+ * of the `datagen` directory. The bounds of the values and of the timestamps
+ * are given by a bounding box or a time span.
+ */
+
+/* PostgreSQL */
+#include <postgres.h>
+#include <funcapi.h>
+#include <utils/palloc.h>
+#include <utils/timestamp.h>
+/* GSL */
+#include <gsl/gsl_rng.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/span.h"
+#include "general/tbox.h"
+#include "general/temporal.h"
+#include "general/type_util.h"
+#include "point/stbox.h"
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+
+/*****************************************************************************/
+
+/**
+ * @brief Fill the options of the random generation of temporal values from
+ * the arguments of a function
+ * @details The arguments start with the bounds of the values and of the
+ * timestamps, which depend on the temporal type, followed by the maximum
+ * minutes between two timestamps, the minimum and maximum number of instants
+ * and of sequences, the subtype, and the interpolation
+ * @param[in] fcinfo Function call information
+ * @param[in] argno Number of the first argument
+ * @param[in] temptype Temporal type
+ * @param[out] opts Options
+ */
+static void
+temporal_random_options(FunctionCallInfo fcinfo, int argno, meosType temptype,
+  temporalRandomOptions *opts)
+{
+  memset(opts, 0, sizeof(temporalRandomOptions));
+  opts->temptype = temptype;
+  const Span *period = NULL;
+  switch (temptype)
+  {
+    case T_TBOOL:
+      period = PG_GETARG_SPAN_P(argno++);
+      break;
+    case T_TINT:
+    case T_TFLOAT:
+    {
+      TBox *box = PG_GETARG_TBOX_P(argno++);
+      ensure_has_X_tbox(box);
+      ensure_has_T_tbox(box);
+      opts->lowvalue = datum_double(box->span.lower, box->span.basetype);
+      opts->highvalue = datum_double(box->span.upper, box->span.basetype);
+      /* Integer spans are canonicalized with an exclusive upper bound */
+      if (box->span.basetype == T_INT4 && ! box->span.upper_inc)
+        opts->highvalue -= 1;
+      opts->maxdelta = (temptype == T_TINT) ?
+        (double) PG_GETARG_INT32(argno++) : PG_GETARG_FLOAT8(argno++);
+      period = &box->period;
+      break;
+    }
+    case T_TTEXT:
+      period = PG_GETARG_SPAN_P(argno++);
+      opts->maxlength = PG_GETARG_INT32(argno++);
+      break;
+    case T_TGEOMPOINT:
+    case T_TGEOGPOINT:
+    {
+      STBox *box = PG_GETARG_STBOX_P(argno++);
+      ensure_has_X_stbox(box);
+      ensure_has_T_stbox(box);
+      opts->lowx = box->xmin; opts->highx = box->xmax;
+      opts->lowy = box->ymin; opts->highy = box->ymax;
+      opts->hasz = MEOS_FLAGS_GET_Z(box->flags);
+      if (opts->hasz)
+      {
+        opts->lowz = box->zmin;
+        opts->highz = box->zmax;
+      }
+      opts->srid = box->srid;
+      if (temptype == T_TGEOGPOINT && opts->srid == SRID_UNKNOWN)
+        opts->srid = SRID_DEFAULT;
+      opts->maxdelta = PG_GETARG_FLOAT8(argno++);
+      period = &box->period;
+      break;
+    }
+#if NPOINT
+    case T_TNPOINT:
+      opts->lowvalue = (double) PG_GETARG_INT64(argno++);
+      opts->highvalue = (double) PG_GETARG_INT64(argno++);
+      period = PG_GETARG_SPAN_P(argno++);
+      break;
+#endif /* NPOINT */
+    default: /* Error! */
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("Unsupported temporal type for random generation: %s",
+          meostype_name(temptype))));
+  }
+  opts->lowtime = DatumGetTimestampTz(period->lower);
+  opts->hightime = DatumGetTimestampTz(period->upper);
+  opts->maxminutes = PG_GETARG_INT32(argno++);
+  opts->mininsts = PG_GETARG_INT32(argno++);
+  opts->maxinsts = PG_GETARG_INT32(argno++);
+  opts->minseqs = PG_GETARG_INT32(argno++);
+  opts->maxseqs = PG_GETARG_INT32(argno++);
+  char *str = text2cstring(PG_GETARG_TEXT_P(argno++));
+  int16 subtype;
+  if (! tempsubtype_from_string(str, &subtype) || subtype == ANYTEMPSUBTYPE)
+    ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+      errmsg("Invalid temporal subtype: %s", str)));
+  pfree(str);
+  opts->subtype = (tempSubtype) subtype;
+  str = text2cstring(PG_GETARG_TEXT_P(argno++));
+  opts->interp = interptype_from_string(str);
+  pfree(str);
+  return;
+}
+
+PGDLLEXPORT Datum Temporal_random(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_random);
+/**
+ * @ingroup mobilitydb_temporal_constructor
+ * @brief Return a random temporal value
+ * @sqlfn tboolRandom(), tintRandom(), tfloatRandom(), ttextRandom(), ...
+ */
+Datum
+Temporal_random(PG_FUNCTION_ARGS)
+{
+  meosType temptype = oid_type(get_fn_expr_rettype(fcinfo->flinfo));
+  temporalRandomOptions opts;
+  temporal_random_options(fcinfo, 0, temptype, &opts);
+  PG_RETURN_TEMPORAL_P(temporal_random(&opts, NULL));
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Structure to represent the state of the set-returning function
+ * generating random temporal values
+ */
+typedef struct
+{
+  temporalRandomOptions opts;  /**< Options */
+  gsl_rng *rng;                /**< Random number generator of the call */
+  MemoryContextCallback cb;    /**< Callback freeing the generator */
+} RandomBulkState;
+
+/**
+ * @brief Free the random number generator of a set-returning function when
+ * its memory context is reset, which also happens when the query is aborted
+ */
+static void
+random_bulk_state_free(void *arg)
+{
+  RandomBulkState *state = (RandomBulkState *) arg;
+  if (state->rng)
+    gsl_rng_free(state->rng);
+  state->rng = NULL;
+  return;
+}
+
+PGDLLEXPORT Datum Temporal_random_bulk(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_random_bulk);
+/**
+ * @ingroup mobilitydb_temporal_constructor
+ * @brief Return a set of random temporal values generated from a seed
+ * @details The values are generated one per call with a random number
+ * generator of their own, so that the same arguments always result in the
+ * same values and the set is never materialized in memory
+ * @sqlfn tboolRandomBulk(), tintRandomBulk(), tfloatRandomBulk(), ...
+ */
+Datum
+Temporal_random_bulk(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    int32 count = PG_GETARG_INT32(0);
+    int64 seed = PG_GETARG_INT64(1);
+    meosType temptype = oid_type(get_fn_expr_rettype(fcinfo->flinfo));
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    RandomBulkState *state = palloc0(sizeof(RandomBulkState));
+    temporal_random_options(fcinfo, 2, temptype, &state->opts);
+    state->rng = gsl_rng_alloc(gsl_rng_default);
+    gsl_rng_set(state->rng, (unsigned long) seed);
+    state->cb.func = random_bulk_state_free;
+    state->cb.arg = state;
+    MemoryContextRegisterResetCallback(funcctx->multi_call_memory_ctx,
+      &state->cb);
+    funcctx->user_fctx = state;
+    funcctx->max_calls = count > 0 ? (uint64) count : 0;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr >= funcctx->max_calls)
+    SRF_RETURN_DONE(funcctx);
+
+  RandomBulkState *state = (RandomBulkState *) funcctx->user_fctx;
+  Temporal *result = temporal_random(&state->opts, state->rng);
+  SRF_RETURN_NEXT(funcctx, PointerGetDatum(result));
+}
+
+/*****************************************************************************/
@@ -0,0 +1,632 @@
+  /*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Inspection functions for the GiST and SP-GiST indexes of the span,
+ * temporal box, and spatiotemporal box operator classes
+ * @details The functions read the pages of an index and report statistics
+ * about its structure, such as the height of the tree, the fill of its pages,
+ * the size of its keys, and the overlap of the keys of sibling entries, which
+ * help deciding whether an index must be rebuilt or replaced by another
+ * kind of index
+ */
+
+/* C */
+#include <float.h>
+#include <math.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <funcapi.h>
+#include <miscadmin.h>
+#include <access/genam.h>
+#include <access/gist_private.h>
+#include <access/spgist_private.h>
+#include <catalog/pg_am_d.h>
+#include <storage/bufmgr.h>
+#include <utils/acl.h>
+#include <utils/builtins.h>
+#include <utils/lsyscache.h>
+#include <utils/rel.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "general/span.h"
+#include "general/tbox.h"
+#include "general/type_util.h"
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+#include "pg_general/tnumber_gist.h"
+#include "pg_point/tpoint_gist.h"
+
+/** Maximum number of levels of the trees inspected */
+#define INDEX_MAX_DEPTH 32
+/** Number of dimensions of the keys of the indexes: X, Y, Z, and T */
+#define INDEX_NDIMS 4
+
+/**
+ * @brief Structure to represent the statistics of a level of a GiST index
+ */
+typedef struct
+{
+  int64 pages;                /**< Number of pages */
+  int64 tuples;               /**< Number of tuples */
+  double fill;                /**< Sum of the fill ratios of the pages */
+  double volume;              /**< Sum of the sizes of the keys */
+  int64 pairs;                /**< Number of pairs of sibling keys */
+  int64 overlaps[INDEX_NDIMS]; /**< Number of pairs of sibling keys that
+                                    overlap on each dimension */
+} gist_level_stats;
+
+/**
+ * @brief Structure to represent the statistics of a GiST index
+ */
+typedef struct
+{
+  int nlevels;                /**< Number of levels */
+  bool hasdim[INDEX_NDIMS];   /**< Dimensions of the keys */
+  gist_level_stats levels[INDEX_MAX_DEPTH]; /**< Statistics of the levels,
+                                                 the root being the first */
+} gist_index_stats;
+
+/*****************************************************************************
+ * Index keys
+ *****************************************************************************/
+
+/**
+ * @brief Open an index for inspection, ensuring that the user can read the
+ * table of the index and that the index uses the given access method
+ */
+static Relation
+index_inspect_open(Oid indexoid, Oid amoid)
+{
+  Relation index = index_open(indexoid, AccessShareLock);
+  Oid heapoid = index->rd_index->indrelid;
+  AclResult aclresult = pg_class_aclcheck(heapoid, GetUserId(), ACL_SELECT);
+  if (aclresult != ACLCHECK_OK)
+    aclcheck_error(aclresult, OBJECT_TABLE, get_rel_name(heapoid));
+  if (index->rd_rel->relam != amoid)
+    ereport(ERROR, (errcode(ERRCODE_WRONG_OBJECT_TYPE),
+      errmsg("Index \"%s\" is not a%s index",
+        RelationGetRelationName(index),
+        amoid == GIST_AM_OID ? " GiST" : "n SP-GiST")));
+  return index;
+}
+
+/**
+ * @brief Return the type of the keys of a GiST index, which must be a span,
+ * a temporal box, or a spatiotemporal box
+ */
+static meosType
+gist_key_type(Relation index)
+{
+  Oid keyoid = TupleDescAttr(RelationGetDescr(index), 0)->atttypid;
+  meosType result = oid_type(keyoid);
+  if (result != T_TBOX && result != T_STBOX && ! span_type(result))
+    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+      errmsg("The keys of index \"%s\" are of an unsupported type: %s",
+        RelationGetRelationName(index), format_type_be(keyoid))));
+  return result;
+}
+
+/**
+ * @brief Return in the last arguments the extent of a key of an index on a
+ * dimension
+ * @return False if the key does not have the dimension
+ */
+static bool
+index_key_extent(const void *key, meosType keytype, int dim, double *lower,
+  double *upper)
+{
+  if (keytype == T_STBOX)
+  {
+    const STBox *box = (const STBox *) key;
+    if (dim == 3)
+    {
+      if (! MEOS_FLAGS_GET_T(box->flags))
+        return false;
+      *lower = (double) DatumGetTimestampTz(box->period.lower);
+      *upper = (double) DatumGetTimestampTz(box->period.upper);
+      return true;
+    }
+    if (! MEOS_FLAGS_GET_X(box->flags) ||
+        (dim == 2 && ! MEOS_FLAGS_GET_Z(box->flags) &&
+         ! MEOS_FLAGS_GET_GEODETIC(box->flags)))
+      return false;
+    *lower = (dim == 0) ? box->xmin : (dim == 1) ? box->ymin : box->zmin;
+    *upper = (dim == 0) ? box->xmax : (dim == 1) ? box->ymax : box->zmax;
+    return true;
+  }
+  if (keytype == T_TBOX)
+  {
+    const TBox *box = (const TBox *) key;
+    if (dim == 0 && MEOS_FLAGS_GET_X(box->flags))
+    {
+      *lower = datum_double(box->span.lower, box->span.basetype);
+      *upper = datum_double(box->span.upper, box->span.basetype);
+      return true;
+    }
+    if (dim == 3 && MEOS_FLAGS_GET_T(box->flags))
+    {
+      *lower = (double) DatumGetTimestampTz(box->period.lower);
+      *upper = (double) DatumGetTimestampTz(box->period.upper);
+      return true;
+    }
+    return false;
+  }
+  /* Span keys have either the value or the time dimension */
+  const Span *s = (const Span *) key;
+  bool time = (s->basetype == T_TIMESTAMPTZ);
+  if (dim != (time ? 3 : 0))
+    return false;
+  *lower = time ? (double) DatumGetTimestampTz(s->lower) :
+    datum_double(s->lower, s->basetype);
+  *upper = time ? (double) DatumGetTimestampTz(s->upper) :
+    datum_double(s->upper, s->basetype);
+  return true;
+}
+
+/**
+ * @brief Return the size of a key of an index, that is, its length, area, or
+ * volume depending on its dimensions
+ */
+static double
+index_key_size(const void *key, meosType keytype)
+{
+  if (keytype == T_STBOX)
+    return stbox_size((const STBox *) key);
+  if (keytype == T_TBOX)
+    return tbox_size((const TBox *) key);
+  double lower, upper;
+  const Span *s = (const Span *) key;
+  index_key_extent(key, keytype, (s->basetype == T_TIMESTAMPTZ) ? 3 : 0,
+    &lower, &upper);
+  return upper - lower;
+}
+
+/**
+ * @brief Return true if a key of an index overlaps a query of the same type
+ */
+static bool
+index_key_overlaps(const void *key, const void *query, meosType keytype)
+{
+  if (keytype == T_STBOX)
+    return overlaps_stbox_stbox((const STBox *) key, (const STBox *) query);
+  if (keytype == T_TBOX)
+    return overlaps_tbox_tbox((const TBox *) key, (const TBox *) query);
+  return overlaps_span_span((const Span *) key, (const Span *) query);
+}
+
+/**
+ * @brief Return the fraction of the usable space of a page that is used
+ */
+static double
+index_page_fill(Page page, Size special)
+{
+  Size usable = BLCKSZ - MAXALIGN(SizeOfPageHeaderData) - MAXALIGN(special);
+  Size freespace = PageGetExactFreeSpace(page);
+  return (freespace >= usable) ? 0.0 :
+    (double) (usable - freespace) / usable;
+}
+
+/*****************************************************************************
+ * GiST statistics
+ *****************************************************************************/
+
+/**
+ * @brief Collect the statistics of the levels of a GiST index by traversing
+ * it level by level from the root
+ * @param[in] index Index
+ * @param[in] keytype Type of the keys
+ * @param[out] stats Statistics
+ */
+static void
+gist_index_walk(Relation index, meosType keytype, gist_index_stats *stats)
+{
+  gist_level_stats *levels = stats->levels;
+  bool *hasdim = stats->hasdim;
+  TupleDesc tupdesc = RelationGetDescr(index);
+  int maxblocks = 64, ncur = 1, depth = 0;
+  BlockNumber *cur = palloc(sizeof(BlockNumber) * maxblocks);
+  BlockNumber *next = palloc(sizeof(BlockNumber) * maxblocks);
+  int maxkeys = 256;
+  const void **keys = palloc(sizeof(void *) * maxkeys);
+  bool first = true;
+  cur[0] = GIST_ROOT_BLKNO;
+  memset(stats, 0, sizeof(gist_index_stats));
+  while (ncur > 0 && depth < INDEX_MAX_DEPTH)
+  {
+    gist_level_stats *level = &levels[depth];
+    int nnext = 0;
+    for (int i = 0; i < ncur; i++)
+    {
+      CHECK_FOR_INTERRUPTS();
+      Buffer buffer = ReadBufferExtended(index, MAIN_FORKNUM, cur[i],
+        RBM_NORMAL, NULL);
+      LockBuffer(buffer, GIST_SHARE);
+      Page page = BufferGetPage(buffer);
+      if (GistPageIsDeleted(page))
+      {
+        UnlockReleaseBuffer(buffer);
+        continue;
+      }
+      bool leaf = GistPageIsLeaf(page);
+      level->pages++;
+      level->fill += index_page_fill(page, sizeof(GISTPageOpaqueData));
+
+      /* Collect the keys of the page and the children of inner pages */
+      OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+      int nkeys = 0;
+      for (OffsetNumber off = FirstOffsetNumber; off <= maxoff;
+           off = OffsetNumberNext(off))
+      {
+        ItemId iid = PageGetItemId(page, off);
+        if (! ItemIdIsUsed(iid) || ItemIdIsDead(iid))
+          continue;
+        IndexTuple itup = (IndexTuple) PageGetItem(page, iid);
+        bool isnull;
+        Datum key = index_getattr(itup, 1, tupdesc, &isnull);
+        if (! leaf)
+        {
+          if (nnext == maxblocks)
+          {
+            maxblocks *= 2;
+            next = repalloc(next, sizeof(BlockNumber) * maxblocks);
+            cur = repalloc(cur, sizeof(BlockNumber) * maxblocks);
+          }
+          next[nnext++] = ItemPointerGetBlockNumber(&itup->t_tid);
+        }
+        level->tuples++;
+        if (isnull)
+          continue;
+        if (nkeys == maxkeys)
+        {
+          maxkeys *= 2;
+          keys = repalloc(keys, sizeof(void *) * maxkeys);
+        }
+        keys[nkeys++] = DatumGetPointer(key);
+      }
+
+      /* The dimensions are those of the first key */
+      if (first && nkeys > 0)
+      {
+        double lower, upper;
+        for (int d = 0; d < INDEX_NDIMS; d++)
+          hasdim[d] = index_key_extent(keys[0], keytype, d, &lower, &upper);
+        first = false;
+      }
+      /* Sizes of the keys and overlap of the pairs of sibling keys */
+      for (int j = 0; j < nkeys; j++)
+      {
+        level->volume += index_key_size(keys[j], keytype);
+        for (int k = j + 1; k < nkeys; k++)
+        {
+          level->pairs++;
+          for (int d = 0; d < INDEX_NDIMS; d++)
+          {
+            double l1, u1, l2, u2;
+            if (hasdim[d] &&
+                index_key_extent(keys[j], keytype, d, &l1, &u1) &&
+                index_key_extent(keys[k], keytype, d, &l2, &u2) &&
+                l1 <= u2 && l2 <= u1)
+              level->overlaps[d]++;
+          }
+        }
+      }
+      UnlockReleaseBuffer(buffer);
+    }
+    depth++;
+    /* The children of this level become the pages of the next one */
+    BlockNumber *tmp = cur;
+    cur = next;
+    next = tmp;
+    ncur = nnext;
+  }
+  pfree(cur); pfree(next); pfree(keys);
+  stats->nlevels = depth;
+  return;
+}
+
+PGDLLEXPORT Datum Index_gist_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Index_gist_stats);
+/**
+ * @ingroup mobilitydb_misc
+ * @brief Return the statistics of the levels of a GiST index on spans,
+ * temporal boxes, or spatiotemporal boxes as a set of records
+ * @details Each record describes a level of the tree, the root being at
+ * depth 0, with its number of pages and tuples, the average fill of its
+ * pages, the average size of its keys, and for each dimension the fraction
+ * of the pairs of keys of the same page that overlap on this dimension.
+ * A high overlap of the upper levels means that a query descends into many
+ * subtrees and that the index may benefit from a REINDEX.
+ * @sqlfn mobilitydb_gist_stats()
+ */
+Datum
+Index_gist_stats(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    Oid indexoid = PG_GETARG_OID(0);
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    /* Collect the statistics of all the levels */
+    Relation index = index_inspect_open(indexoid, GIST_AM_OID);
+    meosType keytype = gist_key_type(index);
+    gist_index_stats *stats = palloc(sizeof(gist_index_stats));
+    gist_index_walk(index, keytype, stats);
+    index_close(index, AccessShareLock);
+    funcctx->max_calls = stats->nlevels;
+    funcctx->user_fctx = stats;
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  if (funcctx->call_cntr >= funcctx->max_calls)
+    SRF_RETURN_DONE(funcctx);
+
+  int depth = (int) funcctx->call_cntr;
+  const gist_index_stats *stats = (gist_index_stats *) funcctx->user_fctx;
+  const gist_level_stats *level = &stats->levels[depth];
+  Datum values[5 + INDEX_NDIMS];
+  bool isnull[5 + INDEX_NDIMS];
+  memset(isnull, 0, sizeof(isnull));
+  values[0] = Int32GetDatum(depth);
+  values[1] = Int64GetDatum(level->pages);
+  values[2] = Int64GetDatum(level->tuples);
+  values[3] = Float8GetDatum(level->pages ? level->fill / level->pages : 0.0);
+  values[4] = Float8GetDatum(level->tuples ?
+    level->volume / level->tuples : 0.0);
+  for (int d = 0; d < INDEX_NDIMS; d++)
+  {
+    if (stats->hasdim[d] && level->pairs > 0)
+      values[5 + d] = Float8GetDatum((double) level->overlaps[d] /
+        level->pairs);
+    else
+      isnull[5 + d] = true;
+  }
+  HeapTuple tuple = heap_form_tuple(funcctx->tuple_desc, values, isnull);
+  SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+}
+
+/*****************************************************************************
+ * GiST probe
+ *****************************************************************************/
+
+/**
+ * @brief Return the query of a probe converted to the type of the keys of an
+ * index
+ * @details A timestamptz span is accepted for the indexes on spatiotemporal
+ * boxes, and any span for the indexes on temporal boxes
+ */
+static void *
+gist_probe_query(Datum query, Oid queryoid, meosType keytype)
+{
+  meosType querytype = oid_type(queryoid);
+  if (querytype == keytype)
+    return DatumGetPointer(query);
+  if (querytype == T_TSTZSPAN && keytype == T_STBOX)
+    return tstzspan_to_stbox(DatumGetSpanP(query));
+  if (span_type(querytype) && keytype == T_TBOX)
+    return span_to_tbox(DatumGetSpanP(query));
+  ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+    errmsg("The query of type %s cannot be compared to the index keys",
+      format_type_be(queryoid))));
+  return NULL;
+}
+
+PGDLLEXPORT Datum Index_gist_probe(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Index_gist_probe);
+/**
+ * @ingroup mobilitydb_misc
+ * @brief Return the number of inner and leaf pages of a GiST index visited
+ * by a search of the keys overlapping a query, together with the number of
+ * leaf entries found
+ * @details Since the keys of the index are the bounding boxes of the values,
+ * every leaf entry found must be rechecked against the query, and the number
+ * of entries is therefore an estimate of the rechecks of the query
+ * @sqlfn mobilitydb_gist_probe()
+ */
+Datum
+Index_gist_probe(PG_FUNCTION_ARGS)
+{
+  Oid indexoid = PG_GETARG_OID(0);
+  Datum querydatum = PG_GETARG_DATUM(1);
+  Relation index = index_inspect_open(indexoid, GIST_AM_OID);
+  meosType keytype = gist_key_type(index);
+  const void *query = gist_probe_query(querydatum,
+    get_fn_expr_argtype(fcinfo->flinfo, 1), keytype);
+  TupleDesc tupdesc = RelationGetDescr(index);
+
+  /* Depth-first search from the root */
+  int64 innerpages = 0, leafpages = 0, candidates = 0;
+  int maxblocks = 256, nblocks = 1;
+  BlockNumber *stack = palloc(sizeof(BlockNumber) * maxblocks);
+  stack[0] = GIST_ROOT_BLKNO;
+  while (nblocks > 0)
+  {
+    CHECK_FOR_INTERRUPTS();
+    Buffer buffer = ReadBufferExtended(index, MAIN_FORKNUM, stack[--nblocks],
+      RBM_NORMAL, NULL);
+    LockBuffer(buffer, GIST_SHARE);
+    Page page = BufferGetPage(buffer);
+    if (GistPageIsDeleted(page))
+    {
+      UnlockReleaseBuffer(buffer);
+      continue;
+    }
+    bool leaf = GistPageIsLeaf(page);
+    if (leaf)
+      leafpages++;
+    else
+      innerpages++;
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+    for (OffsetNumber off = FirstOffsetNumber; off <= maxoff;
+         off = OffsetNumberNext(off))
+    {
+      ItemId iid = PageGetItemId(page, off);
+      if (! ItemIdIsUsed(iid) || ItemIdIsDead(iid))
+        continue;
+      IndexTuple itup = (IndexTuple) PageGetItem(page, iid);
+      bool isnull;
+      Datum key = index_getattr(itup, 1, tupdesc, &isnull);
+      if (isnull || ! index_key_overlaps(DatumGetPointer(key), query, keytype))
+        continue;
+      if (leaf)
+        candidates++;
+      else
+      {
+        if (nblocks == maxblocks)
+        {
+          maxblocks *= 2;
+          stack = repalloc(stack, sizeof(BlockNumber) * maxblocks);
+        }
+        stack[nblocks++] = ItemPointerGetBlockNumber(&itup->t_tid);
+      }
+    }
+    UnlockReleaseBuffer(buffer);
+  }
+  pfree(stack);
+  index_close(index, AccessShareLock);
+
+  TupleDesc resultdesc;
+  get_call_result_type(fcinfo, 0, &resultdesc);
+  BlessTupleDesc(resultdesc);
+  Datum values[3];
+  bool isnull[3] = {0, 0, 0};
+  values[0] = Int64GetDatum(innerpages);
+  values[1] = Int64GetDatum(leafpages);
+  values[2] = Int64GetDatum(candidates);
+  HeapTuple tuple = heap_form_tuple(resultdesc, values, isnull);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+/*****************************************************************************
+ * SP-GiST statistics
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Index_spgist_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Index_spgist_stats);
+/**
+ * @ingroup mobilitydb_misc
+ * @brief Return the statistics of the pages of an SP-GiST index as a record
+ * @details The record contains the number of inner and leaf pages, the
+ * number of live inner and leaf tuples, the average number of nodes of the
+ * inner tuples, which is 4 for a quadtree on two dimensions and 2 for a
+ * kd-tree, and the average fill of the inner and leaf pages
+ * @sqlfn mobilitydb_spgist_stats()
+ */
+Datum
+Index_spgist_stats(PG_FUNCTION_ARGS)
+{
+  Oid indexoid = PG_GETARG_OID(0);
+  Relation index = index_inspect_open(indexoid, SPGIST_AM_OID);
+  int64 innerpages = 0, leafpages = 0, innertuples = 0, leaftuples = 0,
+    nodes = 0;
+  double innerfill = 0.0, leaffill = 0.0;
+  BlockNumber npages = RelationGetNumberOfBlocks(index);
+  for (BlockNumber blkno = SPGIST_METAPAGE_BLKNO + 1; blkno < npages; blkno++)
+  {
+    CHECK_FOR_INTERRUPTS();
+    Buffer buffer = ReadBufferExtended(index, MAIN_FORKNUM, blkno,
+      RBM_NORMAL, NULL);
+    LockBuffer(buffer, BUFFER_LOCK_SHARE);
+    Page page = BufferGetPage(buffer);
+    if (PageIsNew(page) || SpGistPageIsDeleted(page))
+    {
+      UnlockReleaseBuffer(buffer);
+      continue;
+    }
+    bool leaf = SpGistPageIsLeaf(page);
+    double fill = index_page_fill(page, sizeof(SpGistPageOpaqueData));
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+    for (OffsetNumber off = FirstOffsetNumber; off <= maxoff;
+         off = OffsetNumberNext(off))
+    {
+      ItemId iid = PageGetItemId(page, off);
+      if (! ItemIdIsUsed(iid))
+        continue;
+      if (leaf)
+      {
+        SpGistLeafTuple lt = (SpGistLeafTuple) PageGetItem(page, iid);
+        if (lt->tupstate == SPGIST_LIVE)
+          leaftuples++;
+      }
+      else
+      {
+        SpGistInnerTuple it = (SpGistInnerTuple) PageGetItem(page, iid);
+        if (it->tupstate == SPGIST_LIVE)
+        {
+          innertuples++;
+          nodes += it->nNodes;
+        }
+      }
+    }
+    if (leaf)
+    {
+      leafpages++;
+      leaffill += fill;
+    }
+    else
+    {
+      innerpages++;
+      innerfill += fill;
+    }
+    UnlockReleaseBuffer(buffer);
+  }
+  index_close(index, AccessShareLock);
+
+  TupleDesc resultdesc;
+  get_call_result_type(fcinfo, 0, &resultdesc);
+  BlessTupleDesc(resultdesc);
+  Datum values[7];
+  bool isnull[7] = {0, 0, 0, 0, 0, 0, 0};
+  values[0] = Int64GetDatum(innerpages);
+  values[1] = Int64GetDatum(leafpages);
+  values[2] = Int64GetDatum(innertuples);
+  values[3] = Int64GetDatum(leaftuples);
+  values[4] = Float8GetDatum(innertuples ?
+    (double) nodes / innertuples : 0.0);
+  values[5] = Float8GetDatum(innerpages ? innerfill / innerpages : 0.0);
+  values[6] = Float8GetDatum(leafpages ? leaffill / leafpages : 0.0);
+  HeapTuple tuple = heap_form_tuple(resultdesc, values, isnull);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+/*****************************************************************************/
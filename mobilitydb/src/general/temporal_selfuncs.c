@@ -46,6 +46,8 @@
 /* C */
 #include <assert.h>
 /* PostgreSQL */
+#include <nodes/makefuncs.h>
+#include <nodes/nodeFuncs.h>
 #include <parser/parsetree.h>
 /* MEOS */
 #include <meos.h>
@@ -57,6 +59,7 @@
 #include "pg_general/meos_catalog.h"
 #include "pg_general/span_selfuncs.h"
 #include "pg_general/temporal_selfuncs.h"
+#include "pg_general/type_util.h"
 #include "pg_point/tpoint_selfuncs.h"
 
 /*****************************************************************************
@@ -706,33 +709,43 @@ temporal_sel(PlannerInfo *root, Oid operid, List *args, int varRelid,
 
     assert(MEOS_FLAGS_GET_X(box.flags) || MEOS_FLAGS_GET_T(box.flags));
 
-    /* Enable the multiplication of the selectivity of the spatial and time
-     * dimensions since either may be missing */
-    selec = 1.0;
+    /* Use the joint space-time histogram when the box has both dimensions
+     * and the histogram has been collected */
+    selec = -1.0;
+    if (MEOS_FLAGS_GET_X(box.flags) && MEOS_FLAGS_GET_T(box.flags) &&
+        ! MEOS_FLAGS_GET_Z(box.flags) && ! MEOS_FLAGS_GET_GEODETIC(box.flags))
+      selec = geo_time_sel(&vardata, &box, oper);
 
-    /*
-     * Estimate selectivity for the spatial dimension
-     */
-    if (MEOS_FLAGS_GET_X(box.flags))
+    if (selec < 0.0)
     {
-      /* PostGIS does not provide selectivity for the traditional
-       * comparisons <, <=, >, >= */
-      if (oper == LT_OP || oper == LE_OP || oper == GT_OP || oper == GE_OP)
-        selec *= tpoint_sel_default(oper);
-      else
-        selec *= geo_sel(&vardata, &box, oper);
-    }
-    /*
-     * Estimate selectivity for the time dimension
-     */
-    if (MEOS_FLAGS_GET_T(box.flags))
-    {
-      /* Transform the STBox into a timestamptz span */
-      Span period;
-      memcpy(&period, &box.period, sizeof(Span));
-
-      /* Compute the selectivity */
-      selec *= temporal_sel_tstzspan(&vardata, &period, oper);
+      /* Enable the multiplication of the selectivity of the spatial and time
+       * dimensions since either may be missing */
+      selec = 1.0;
+
+      /*
+       * Estimate selectivity for the spatial dimension
+       */
+      if (MEOS_FLAGS_GET_X(box.flags))
+      {
+        /* PostGIS does not provide selectivity for the traditional
+         * comparisons <, <=, >, >= */
+        if (oper == LT_OP || oper == LE_OP || oper == GT_OP || oper == GE_OP)
+          selec *= tpoint_sel_default(oper);
+        else
+          selec *= geo_sel(&vardata, &box, oper);
+      }
+      /*
+       * Estimate selectivity for the time dimension
+       */
+      if (MEOS_FLAGS_GET_T(box.flags))
+      {
+        /* Transform the STBox into a timestamptz span */
+        Span period;
+        memcpy(&period, &box.period, sizeof(Span));
+
+        /* Compute the selectivity */
+        selec *= temporal_sel_tstzspan(&vardata, &period, oper);
+      }
     }
   }
 
@@ -810,6 +823,50 @@ Tnpoint_sel(PG_FUNCTION_ARGS)
   return Float8GetDatum(temporal_sel_family(fcinfo, TNPOINTTYPE));
 }
 
+PGDLLEXPORT Datum Tpoint_stboxarr_sel(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_stboxarr_sel);
+/**
+ * @brief Estimate the restriction selectivity of the overlaps operator
+ * between a temporal point and an array of spatiotemporal boxes
+ * @details The selectivity is the sum of the selectivities of the overlaps
+ * operator for each box of the array, which is an upper bound since the
+ * boxes may overlap
+ */
+Datum
+Tpoint_stboxarr_sel(PG_FUNCTION_ARGS)
+{
+  PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+  List *args = (List *) PG_GETARG_POINTER(2);
+  int varRelid = PG_GETARG_INT32(3);
+
+  Node *arg = (Node *) linitial(args);
+  Node *other = (Node *) lsecond(args);
+  if (! IsA(other, Const))
+    PG_RETURN_FLOAT8(tpoint_sel_default(OVERLAPS_OP));
+  Const *cons = (Const *) other;
+  if (cons->constisnull)
+    PG_RETURN_FLOAT8(0.0);
+
+  /* Sum the selectivities of the && operator with each box */
+  meosType temptype = oid_type(exprType(arg));
+  Oid operid = oper_oid(OVERLAPS_OP, temptype, T_STBOX);
+  Oid boxoid = type_oid(T_STBOX);
+  int count;
+  STBox **boxes = (STBox **) datumarr_extract(
+    DatumGetArrayTypeP(cons->constvalue), &count);
+  Selectivity selec = 0.0;
+  for (int i = 0; i < count && selec < 1.0; i++)
+  {
+    Const *box = makeConst(boxoid, -1, InvalidOid, sizeof(STBox),
+      PointerGetDatum(boxes[i]), false, false);
+    selec += temporal_sel(root, operid, list_make2(arg, box), varRelid,
+      TPOINTTYPE);
+  }
+  pfree(boxes);
+  CLAMP_PROBABILITY(selec);
+  PG_RETURN_FLOAT8(selec);
+}
+
 /*****************************************************************************
  * Estimate the join selectivity
  *****************************************************************************/
@@ -905,6 +962,73 @@ tpoint_joinsel_components(meosOper oper, meosType oprleft,
   return true;
 }
 
+/**
+ * @brief Return true if the function call computes the boxes of a temporal
+ * point, as in `stboxes(t2.trip, 8)`
+ */
+static bool
+temporal_join_stboxes(FuncExpr *func)
+{
+  if (list_length(func->args) != 2)
+    return false;
+  char *name = get_func_name(func->funcid);
+  if (! name)
+    return false;
+  bool result = (strcmp(name, "stboxes") == 0);
+  pfree(name);
+  return result;
+}
+
+/**
+ * @brief Return the column underlying an argument of a join clause
+ *
+ * The argument is either a column or an expression computing the bounding
+ * box or the boxes of a column of temporal points, possibly expanded in
+ * space, such as `stbox(t2.trip)`, `stboxes(t2.trip, 8)`, or
+ * `expandSpace(t2.trip, 100)`. In the latter case, the expansion distance is
+ * returned in the last argument.
+ * @return NULL if the argument is not one of the above
+ */
+static Var *
+temporal_join_var(Node *arg, double *expand)
+{
+  *expand = 0.0;
+  if (IsA(arg, RelabelType))
+    arg = (Node *) ((RelabelType *) arg)->arg;
+  if (IsA(arg, Var))
+    return (Var *) arg;
+  if (! IsA(arg, FuncExpr))
+    return NULL;
+
+  FuncExpr *func = (FuncExpr *) arg;
+  Node *farg = (Node *) linitial(func->args);
+  /* Look through the boxes of the column, as in the multi-box condition
+   * `expandSpace(stboxes(t2.trip, 8), 100)` */
+  if (IsA(farg, FuncExpr) && temporal_join_stboxes((FuncExpr *) farg))
+    farg = (Node *) linitial(((FuncExpr *) farg)->args);
+  if (! IsA(farg, Var) || ! tspatial_type(oid_type(((Var *) farg)->vartype)))
+    return NULL;
+  if (temporal_join_stboxes(func))
+    return (Var *) farg;
+  char *name = get_func_name(func->funcid);
+  if (! name)
+    return NULL;
+  Var *result = NULL;
+  if (strcmp(name, "stbox") == 0 && list_length(func->args) == 1)
+    result = (Var *) farg;
+  else if (strcmp(name, "expandspace") == 0 && list_length(func->args) == 2)
+  {
+    Node *dist = (Node *) lsecond(func->args);
+    if (IsA(dist, Const) && ! ((Const *) dist)->constisnull)
+    {
+      *expand = DatumGetFloat8(((Const *) dist)->constvalue);
+      result = (Var *) farg;
+    }
+  }
+  pfree(name);
+  return result;
+}
+
 /**
  * @brief Return an estimate of the join selectivity for columns of temporal
  * values
@@ -921,15 +1045,17 @@ temporal_joinsel(PlannerInfo *root, Oid operid, List *args, JoinType jointype,
   assert(tempfamily == TEMPORALTYPE || tempfamily == TNUMBERTYPE ||
          tempfamily == TPOINTTYPE || tempfamily == TNPOINTTYPE);
 
-  Node *arg1 = (Node *) linitial(args);
-  Node *arg2 = (Node *) lsecond(args);
-  Var *var1 = (Var *) arg1;
-  Var *var2 = (Var *) arg2;
-
-  /* We only do column joins right now, no functional joins */
-  /* TODO: handle t1 <op> expandX(t2) */
-  if (!IsA(arg1, Var) || !IsA(arg2, Var))
+  /*
+   * We only do column joins, where a column of temporal points may be
+   * replaced by its bounding box, possibly expanded in space
+   */
+  double expand1, expand2;
+  Var *var1 = temporal_join_var((Node *) linitial(args), &expand1);
+  Var *var2 = temporal_join_var((Node *) lsecond(args), &expand2);
+  if (! var1 || ! var2)
     return DEFAULT_TEMP_JOINSEL;
+  /* The time dimension is estimated from the underlying columns */
+  List *varargs = list_make2(var1, var2);
 
   /* Determine whether we can estimate selectivity for the operator */
   meosType ltype, rtype;
@@ -979,7 +1105,7 @@ temporal_joinsel(PlannerInfo *root, Oid operid, List *args, JoinType jointype,
       selec *= span_joinsel_default(oper);
     else
       /* Estimate join selectivity for value dimension */
-      selec *= span_joinsel(root, true, oper, args, jointype, sjinfo);
+      selec *= span_joinsel(root, true, oper, varargs, jointype, sjinfo);
   }
   if (space)
   {
@@ -996,7 +1122,7 @@ temporal_joinsel(PlannerInfo *root, Oid operid, List *args, JoinType jointype,
     if (! stats1 || ! stats2)
       selec *= tpoint_joinsel_default(oper);
     else
-      selec *= geo_joinsel(stats1, stats2);
+      selec *= geo_joinsel(stats1, stats2, expand1 + expand2);
     if (stats1)
       pfree(stats1);
     if (stats2)
@@ -1017,7 +1143,7 @@ temporal_joinsel(PlannerInfo *root, Oid operid, List *args, JoinType jointype,
       selec *= span_joinsel_default(oper);
     else
       /* Estimate join selectivity for time dimension */
-      selec *= span_joinsel(root, false, oper, args, jointype, sjinfo);
+      selec *= span_joinsel(root, false, oper, varargs, jointype, sjinfo);
   }
 
   CLAMP_PROBABILITY(selec);
@@ -1090,6 +1216,34 @@ Tpoint_joinsel(PG_FUNCTION_ARGS)
   return Float8GetDatum((float8) temporal_joinsel_family(fcinfo, TPOINTTYPE));
 }
 
+PGDLLEXPORT Datum Tpoint_stboxarr_joinsel(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_stboxarr_joinsel);
+/**
+ * @brief Estimate the join selectivity of the overlaps operator between a
+ * temporal point and an array of spatiotemporal boxes
+ * @details The array is expected to be the boxes of a column of temporal
+ * points, possibly expanded in space, and the selectivity is estimated as
+ * the one of the overlaps operator between the two columns, which is an
+ * upper bound
+ */
+Datum
+Tpoint_stboxarr_joinsel(PG_FUNCTION_ARGS)
+{
+  PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+  List *args = (List *) PG_GETARG_POINTER(2);
+  JoinType jointype = (JoinType) PG_GETARG_INT16(3);
+  SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) PG_GETARG_POINTER(4);
+
+  /* Check length of args and only respond to an inner join */
+  if (list_length(args) != 2 || jointype != JOIN_INNER)
+    PG_RETURN_FLOAT8(DEFAULT_TEMP_JOINSEL);
+
+  meosType temptype = oid_type(exprType((Node *) linitial(args)));
+  Oid operid = oper_oid(OVERLAPS_OP, temptype, temptype);
+  PG_RETURN_FLOAT8(temporal_joinsel(root, operid, args, jointype, sjinfo,
+    TPOINTTYPE));
+}
+
 PGDLLEXPORT Datum Tnpoint_joinsel(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Tnpoint_joinsel);
 /**
@@ -29,23 +29,37 @@
 
 /**
  * @file
- * @brief Index support functions for temporal types
+ * @brief Index and planner support functions for temporal types
  */
 
 /* C */
 #include <assert.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <access/genam.h>
+#include <access/stratnum.h>
+#include <access/table.h>
+#include <catalog/namespace.h>
 #include <catalog/pg_opfamily.h>
 #include <catalog/pg_am_d.h>
 #include <nodes/supportnodes.h>
 #include <nodes/nodeFuncs.h>
 #include <nodes/makefuncs.h>
+#include <optimizer/cost.h>
 #include <optimizer/optimizer.h>
 #include <parser/parse_func.h>
+#include <parser/parsetree.h>
+#include <rewrite/rewriteHandler.h>
+#include <rewrite/rewriteManip.h>
+#include <utils/lsyscache.h>
+#include <utils/rel.h>
+#include <utils/relcache.h>
 #include <utils/syscache.h>
+#include <utils/typcache.h>
 /* MEOS */
 #include <meos.h>
+#include <meos_internal.h>
+#include "general/span.h"
 #include "general/temporal_boxops.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
@@ -53,6 +67,14 @@
 
 /*****************************************************************************/
 
+/*
+ * Number of instants of a temporal point covered by each box of a multi-box
+ * index condition for the "within distance" functions, and maximum number
+ * of boxes of such a condition
+ */
+#define EXPAND_BOX_INSTANTS    16
+#define EXPAND_BOX_MAX_COUNT   32
+
 /*
 * Depending on the function, we will deploy different index enhancement
 * strategies. Containment functions can use a more strict index strategy
@@ -184,6 +206,93 @@ static const IndexableFunction TNPointIndexableFunctions[] = {
 };
 #endif /* NPOINT */
 
+/*
+* The cost of the functions below is proportional to the number of instants
+* of their temporal argument, and the number of rows returned by those that
+* are set-returning is proportional to that number as well. We store the
+* factors in the CostedFunctions arrays.
+*/
+typedef struct
+{
+  const char *fn_name;  /* Name of the function */
+  double inst_cost;     /* Cost per instant in units of cpu_operator_cost */
+  double inst_rows;     /* Rows per instant for set-returning functions */
+} CostedFunction;
+
+/**
+ * @brief Approximate width in bytes of the base values passed by reference
+ * and of variable length, e.g., a 2D geometry point
+ */
+#define VARLEN_VALUE_WIDTH 32
+
+static const CostedFunction TNumberCostedFunctions[] = {
+  /* Ever/always comparison functions */
+  {"ever_eq", 1.0, 0.0},
+  {"always_eq", 1.0, 0.0},
+  /* Lifted arithmetic functions */
+  {"tnumber_add", 2.0, 0.0},
+  {"tnumber_sub", 2.0, 0.0},
+  {"tnumber_mult", 2.0, 0.0},
+  {"tnumber_div", 2.0, 0.0},
+  /* Set-returning functions */
+  {"segments", 1.0, 0.0},
+  {"unnest", 1.0, 1.0},
+  {NULL, 0.0, 0.0}
+};
+
+static const CostedFunction TPointCostedFunctions[] = {
+  /* Ever/always comparison functions */
+  {"ever_eq", 1.0, 0.0},
+  {"always_eq", 1.0, 0.0},
+  /* Ever spatial relationships */
+  {"econtains", 10.0, 0.0},
+  {"edisjoint", 10.0, 0.0},
+  {"eintersects", 10.0, 0.0},
+  {"etouches", 10.0, 0.0},
+  {"edwithin", 10.0, 0.0},
+  /* Always spatial relationships */
+  {"acontains", 10.0, 0.0},
+  {"adisjoint", 10.0, 0.0},
+  {"aintersects", 10.0, 0.0},
+  {"atouches", 10.0, 0.0},
+  {"adwithin", 10.0, 0.0},
+  /* Spatiotemporal relationships */
+  {"tcontains", 20.0, 0.0},
+  {"tdisjoint", 20.0, 0.0},
+  {"tintersects", 20.0, 0.0},
+  {"ttouches", 20.0, 0.0},
+  {"tdwithin", 20.0, 0.0},
+  /* Spatial restrictions */
+  {"atgeometry", 20.0, 0.0},
+  {"atgeometrytime", 20.0, 0.0},
+  {"minusgeometry", 20.0, 0.0},
+  {"minusgeometrytime", 20.0, 0.0},
+  /* Set-returning functions */
+  {"segments", 1.0, 0.0},
+  {"unnest", 1.0, 1.0},
+  {"spacesplit", 10.0, 1.0},
+  {"spacetimesplit", 10.0, 1.0},
+  {NULL, 0.0, 0.0}
+};
+
+#if NPOINT
+static const CostedFunction TNPointCostedFunctions[] = {
+  /* Ever spatial relationships */
+  {"econtains", 10.0, 0.0},
+  {"edisjoint", 10.0, 0.0},
+  {"eintersects", 10.0, 0.0},
+  {"etouches", 10.0, 0.0},
+  {"edwithin", 10.0, 0.0},
+  /* Always spatial relationships */
+  {"acontains", 10.0, 0.0},
+  {"adisjoint", 10.0, 0.0},
+  {"aintersects", 10.0, 0.0},
+  {"atouches", 10.0, 0.0},
+  {"adwithin", 10.0, 0.0},
+  {NULL, 0.0, 0.0}
+};
+#endif /* NPOINT */
+
 static int16
 temporal_get_strategy_by_type(meosType temptype, uint16_t index)
 {
@@ -248,6 +357,105 @@ opFamilyAmOid(Oid opfamilyoid)
   return opfamilyam;
 }
 
+/**
+ * @brief Is the function calling the support function one of those whose cost
+ * depends on the number of instants? If so, copy the metadata for the function
+ * into result and return true
+ */
+static bool
+func_has_cost(Oid funcid, const CostedFunction *costfns,
+  CostedFunction *result)
+{
+  const char *fn_name = get_func_name(funcid);
+  if (! fn_name)
+    return false;
+  for ( ; costfns->fn_name; costfns++)
+  {
+    if (strcmp(costfns->fn_name, fn_name) == 0)
+    {
+      *result = *costfns;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Return the approximate width in bytes of an instant of a temporal
+ * type, including its offset in a sequence
+ */
+static double
+temptype_instant_width(meosType temptype)
+{
+  meosType basetype = temptype_basetype(temptype);
+  size_t width = sizeof(TInstant) + sizeof(size_t);
+  if (! basetype_byvalue(basetype))
+  {
+    int16 len = basetype_length(basetype);
+    width += (len > 0) ? DOUBLE_PAD(len) : VARLEN_VALUE_WIDTH;
+  }
+  return (double) width;
+}
+
+/**
+ * @brief Return an estimate of the number of instants of the first temporal
+ * argument of a function call, or -1 if it cannot be estimated
+ * @details The number of instants is exact for constants, and is derived
+ * from the average width collected by ANALYZE for table columns
+ */
+static double
+temporal_args_instants(PlannerInfo *root, List *args)
+{
+  ListCell *lc;
+  foreach (lc, args)
+  {
+    Node *arg = (Node *) lfirst(lc);
+    meosType temptype = oid_type(exprType(arg));
+    if (! temporal_type(temptype))
+      continue;
+    if (IsA(arg, Const))
+    {
+      Const *cons = (Const *) arg;
+      if (cons->constisnull)
+        return -1.0;
+      Temporal *temp = DatumGetTemporalP(cons->constvalue);
+      return (double) temporal_num_instants(temp);
+    }
+    if (IsA(arg, Var) && root)
+    {
+      Var *var = (Var *) arg;
+      if (IS_SPECIAL_VARNO(var->varno) || var->varlevelsup != 0 ||
+          var->varattno <= 0)
+        return -1.0;
+      RangeTblEntry *rte = planner_rt_fetch(var->varno, root);
+      if (! rte || rte->rtekind != RTE_RELATION)
+        return -1.0;
+      int32 width = get_attavgwidth(rte->relid, var->varattno);
+      if (width <= 0)
+        return -1.0;
+      return Max(1.0, (double) width / temptype_instant_width(temptype));
+    }
+    return -1.0;
+  }
+  return -1.0;
+}
+
+/**
+ * @brief Return the arguments of the function call calling the support
+ * function
+ */
+static List *
+support_node_args(Node *node)
+{
+  if (! node)
+    return NIL;
+  if (IsA(node, FuncExpr))
+    return ((FuncExpr *) node)->args;
+  if (IsA(node, OpExpr))
+    return ((OpExpr *) node)->args;
+  return NIL;
+}
+
 /*****************************************************************************/
 
 /**
@@ -288,6 +496,60 @@ makeExpandExpr(Node *arg, Node *radiusarg, Oid argoid, Oid retoid,
     InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
 }
 
+/**
+ * @brief To apply the "expand for radius search" pattern with several boxes
+ * we need access to the boxes and the expand functions, so lookup the
+ * function Oids using the function names and type numbers.
+ * @details The expression built is `expandSpace(stboxes(arg, count), radius)`
+ * @return On error return @p NULL, so that a single box is used instead
+ */
+static FuncExpr *
+makeExpandBoxesExpr(Node *arg, Node *radiusarg, Oid argoid, int count,
+  Oid retoid, Oid callingfunc)
+{
+  const Oid boxesargs[2] = {argoid, INT4OID};
+  const Oid expandargs[2] = {retoid, FLOAT8OID};
+  const bool noError = true;
+  List *nspfunc;
+
+  /* Functions must be in same namespace as the caller */
+  char *nspname = get_namespace_name(get_func_namespace(callingfunc));
+  nspfunc = list_make2(makeString(nspname), makeString("stboxes"));
+  Oid boxesoid = LookupFuncName(nspfunc, 2, boxesargs, noError);
+  nspfunc = list_make2(makeString(nspname), makeString("expandspace"));
+  Oid expandoid = LookupFuncName(nspfunc, 2, expandargs, noError);
+  if (boxesoid == InvalidOid || expandoid == InvalidOid)
+    return NULL;
+
+  Node *countarg = (Node *) makeConst(INT4OID, -1, InvalidOid, sizeof(int32),
+    Int32GetDatum(count), false, true);
+  FuncExpr *boxesexpr = makeFuncExpr(boxesoid, retoid,
+    list_make2(arg, countarg), InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
+  return makeFuncExpr(expandoid, retoid, list_make2(boxesexpr, radiusarg),
+    InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
+}
+
+/**
+ * @brief Return the number of boxes into which the non-indexed argument of a
+ * "within distance" function is split for building the index condition, or
+ * 1 if a single expanded box is used
+ * @details Every box of the condition adds one comparison for each index
+ * entry visited, while a single box expanded around a long trajectory
+ * matches most of the index. The number of boxes thus grows with the
+ * estimated number of instants of the argument and is bounded by a constant.
+ */
+static int
+expand_boxes_count(PlannerInfo *root, Node *arg)
+{
+  meosType type = oid_type(exprType(arg));
+  if (type != T_TGEOMPOINT && type != T_TGEOGPOINT)
+    return 1;
+  double ninsts = temporal_args_instants(root, list_make1(arg));
+  if (ninsts < 2.0 * EXPAND_BOX_INSTANTS)
+    return 1;
+  return (int) Min(ninsts / EXPAND_BOX_INSTANTS, EXPAND_BOX_MAX_COUNT);
+}
+
 /**
  * @brief To apply the "bunding box search" pattern we need access to the
  * corresponding bbox function, so lookup the function Oid using the function
@@ -394,6 +656,58 @@ Temporal_supportfn(FunctionCallInfo fcinfo, TemporalFamily tempfamily)
     PG_RETURN_POINTER(req);
   }
 
+  /* Return estimated cost and number of rows */
+  if (IsA(rawreq, SupportRequestCost) || IsA(rawreq, SupportRequestRows))
+  {
+    const CostedFunction *costarr = NULL;
+    CostedFunction costfn = {NULL, 0.0, 0.0};
+    PlannerInfo *root;
+    Oid funcid;
+    Node *node;
+    if (IsA(rawreq, SupportRequestCost))
+    {
+      SupportRequestCost *req = (SupportRequestCost *) rawreq;
+      root = req->root;
+      funcid = req->funcid;
+      node = req->node;
+    }
+    else
+    {
+      SupportRequestRows *req = (SupportRequestRows *) rawreq;
+      root = req->root;
+      funcid = req->funcid;
+      node = req->node;
+    }
+    if (tempfamily == TNUMBERTYPE)
+      costarr = TNumberCostedFunctions;
+    else if (tempfamily == TPOINTTYPE)
+      costarr = TPointCostedFunctions;
+#if NPOINT
+    else if (tempfamily == TNPOINTTYPE)
+      costarr = TNPointCostedFunctions;
+#endif /* NPOINT */
+    if (! costarr || ! func_has_cost(funcid, costarr, &costfn))
+      PG_RETURN_POINTER((Node *) NULL);
+
+    double ninsts = temporal_args_instants(root, support_node_args(node));
+    if (ninsts < 0.0)
+      PG_RETURN_POINTER((Node *) NULL);
+
+    if (IsA(rawreq, SupportRequestCost))
+    {
+      SupportRequestCost *req = (SupportRequestCost *) rawreq;
+      req->startup = 0;
+      req->per_tuple = cpu_operator_cost * (1.0 + costfn.inst_cost * ninsts);
+      PG_RETURN_POINTER(req);
+    }
+    /* Only answer for set-returning functions */
+    if (costfn.inst_rows <= 0.0)
+      PG_RETURN_POINTER((Node *) NULL);
+    SupportRequestRows *req = (SupportRequestRows *) rawreq;
+    req->rows = Max(1.0, costfn.inst_rows * ninsts);
+    PG_RETURN_POINTER(req);
+  }
+
   /* Add index support */
   if (IsA(rawreq, SupportRequestIndexCondition))
   {
@@ -551,8 +865,30 @@ Temporal_supportfn(FunctionCallInfo fcinfo, TemporalFamily tempfamily)
       {
         Expr *expr;
         Node *radiusarg = (Node *) list_nth(args, idxfn.expand_arg - 1);
-        FuncExpr *expandexpr = makeExpandExpr(rightarg, radiusarg, rightoid,
-          exproid, funcoid);
+        FuncExpr *expandexpr = NULL;
+
+        /*
+         * A long temporal point on the non-indexed side is split into
+         * several boxes expanded by the radius when the index can test them:
+         * temp1 && expandSpace(stboxes(temp2, count), radius)
+         */
+        int count = expand_boxes_count(req->root, rightarg);
+        if (count > 1)
+        {
+          Oid boxesoid = get_array_type(type_oid(T_STBOX));
+          Oid boxesoperid = get_opfamily_member(opfamilyoid, leftoid,
+            boxesoid, strategy);
+          if (boxesoperid != InvalidOid)
+          {
+            expandexpr = makeExpandBoxesExpr(rightarg, radiusarg, rightoid,
+              count, boxesoid, funcoid);
+            if (expandexpr)
+              idxoperid = boxesoperid;
+          }
+        }
+        if (! expandexpr)
+          expandexpr = makeExpandExpr(rightarg, radiusarg, rightoid, exproid,
+            funcoid);
 
         /*
          * The comparison expression has to be a pseudo constant,
@@ -654,4 +990,296 @@ Tnpoint_supportfn(PG_FUNCTION_ARGS)
 }
 #endif /* NPOINT */
 
+/*****************************************************************************
+ * Time extent columns
+ *****************************************************************************/
+
+/**
+ * @brief Return the number of the stored generated column of a relation
+ * computing the start or the end timestamp of a column of temporal values,
+ * or @p InvalidAttrNumber if there is none
+ * @param[in] rel Relation
+ * @param[in] attnum Number of the column of temporal values
+ * @param[in] fnname Name of the function computing the generated column,
+ * which is either `starttimestamp` or `endtimestamp`
+ */
+static AttrNumber
+time_extent_column(Relation rel, AttrNumber attnum, const char *fnname)
+{
+  TupleDesc tupdesc = RelationGetDescr(rel);
+  for (int i = 0; i < tupdesc->natts; i++)
+  {
+    Form_pg_attribute att = TupleDescAttr(tupdesc, i);
+    if (att->attisdropped || att->atttypid != TIMESTAMPTZOID ||
+        att->attgenerated != ATTRIBUTE_GENERATED_STORED)
+      continue;
+    Node *expr = build_column_default(rel, att->attnum);
+    if (! expr || ! IsA(expr, FuncExpr) ||
+        list_length(((FuncExpr *) expr)->args) != 1)
+      continue;
+    Node *arg = (Node *) linitial(((FuncExpr *) expr)->args);
+    if (! IsA(arg, Var) || ((Var *) arg)->varattno != attnum)
+      continue;
+    char *name = get_func_name(((FuncExpr *) expr)->funcid);
+    bool found = name && strcmp(name, fnname) == 0;
+    if (name)
+      pfree(name);
+    if (found)
+      return att->attnum;
+  }
+  return InvalidAttrNumber;
+}
+
+/**
+ * @brief Return a comparison between a timestamptz column and a constant
+ * @param[in] var Column
+ * @param[in] strategy B-tree strategy of the comparison operator
+ * @param[in] t Constant
+ */
+static Expr *
+make_timestamptz_clause(Var *var, StrategyNumber strategy, Datum t)
+{
+  TypeCacheEntry *typentry = lookup_type_cache(TIMESTAMPTZOID,
+    TYPECACHE_BTREE_OPFAMILY);
+  Oid operid = get_opfamily_member(typentry->btree_opf, TIMESTAMPTZOID,
+    TIMESTAMPTZOID, strategy);
+  if (operid == InvalidOid)
+    return NULL;
+  Const *cons = makeConst(TIMESTAMPTZOID, -1, InvalidOid,
+    sizeof(TimestampTz), t, false, FLOAT8PASSBYVAL);
+  return make_opclause(operid, BOOLOID, false, (Expr *) var, (Expr *) cons,
+    InvalidOid, InvalidOid);
+}
+
+/**
+ * @brief Return the range predicates on the time extent columns of a column
+ * of temporal values implied by its overlap with a timestamptz span
+ * @param[in] rel Relation
+ * @param[in] var Column of temporal values
+ * @param[in] s Span
+ */
+static List *
+time_extent_quals(Relation rel, Var *var, const Span *s)
+{
+  List *result = NIL;
+  AttrNumber startatt = time_extent_column(rel, var->varattno,
+    "starttimestamp");
+  if (startatt != InvalidAttrNumber)
+  {
+    /* The value starts no later than the upper bound of the span */
+    Var *startvar = makeVar(var->varno, startatt, TIMESTAMPTZOID, -1,
+      InvalidOid, 0);
+    Expr *expr = make_timestamptz_clause(startvar, s->upper_inc ?
+      BTLessEqualStrategyNumber : BTLessStrategyNumber, s->upper);
+    if (expr)
+      result = lappend(result, expr);
+  }
+  AttrNumber endatt = time_extent_column(rel, var->varattno, "endtimestamp");
+  if (endatt != InvalidAttrNumber)
+  {
+    /* The value ends no earlier than the lower bound of the span */
+    Var *endvar = makeVar(var->varno, endatt, TIMESTAMPTZOID, -1,
+      InvalidOid, 0);
+    Expr *expr = make_timestamptz_clause(endvar, s->lower_inc ?
+      BTGreaterEqualStrategyNumber : BTGreaterStrategyNumber, s->lower);
+    if (expr)
+      result = lappend(result, expr);
+  }
+  return result;
+}
+
+/*****************************************************************************
+ * Bounding box expression indexes
+ *****************************************************************************/
+
+/**
+ * @brief Return the expression of an index whose first key is the bounding
+ * box of a column of temporal values, such as `stbox(trip)`, `tbox(temp)`,
+ * or `timeSpan(temp)`, or @p NULL otherwise
+ * @param[in] index Index relation
+ * @param[in] attnum Number of the column of temporal values
+ */
+static FuncExpr *
+bbox_index_expr(Relation index, AttrNumber attnum)
+{
+  if (index->rd_index->indkey.values[0] != 0)
+    return NULL;
+  List *exprs = RelationGetIndexExpressions(index);
+  if (exprs == NIL || ! IsA(linitial(exprs), FuncExpr))
+    return NULL;
+  FuncExpr *func = (FuncExpr *) linitial(exprs);
+  if (list_length(func->args) != 1)
+    return NULL;
+  Node *arg = (Node *) linitial(func->args);
+  if (! IsA(arg, Var) || ((Var *) arg)->varattno != attnum)
+    return NULL;
+  char *name = get_func_name(func->funcid);
+  bool found = name && (strcmp(name, "stbox") == 0 ||
+    strcmp(name, "tbox") == 0 || strcmp(name, "timespan") == 0);
+  if (name)
+    pfree(name);
+  return found ? func : NULL;
+}
+
+/**
+ * @brief Return the overlaps predicate between an index expression computing
+ * the bounding box of a column of temporal values and the bounding box of
+ * another argument, or @p NULL if the index cannot be used for it
+ * @param[in] expr Index expression
+ * @param[in] opfamily Operator family of the index
+ * @param[in] var Column of temporal values
+ * @param[in] other Other argument
+ */
+static Expr *
+make_bbox_index_clause(FuncExpr *expr, Oid opfamily, Var *var, Node *other)
+{
+  /* The bounding box function and the && operator are in the same
+   * namespace */
+  char *nspname = get_namespace_name(get_func_namespace(expr->funcid));
+  Oid bboxoid = expr->funcresulttype;
+  Oid operid = OpernameGetOprid(list_make2(makeString(nspname),
+    makeString("&&")), bboxoid, bboxoid);
+  if (operid == InvalidOid || ! op_in_opfamily(operid, opfamily))
+    return NULL;
+
+  /* Compute the bounding box of the other argument if necessary */
+  Node *otherbox = other;
+  Oid otheroid = exprType(other);
+  if (otheroid != bboxoid)
+  {
+    const Oid funcargs[1] = {otheroid};
+    List *nspfunc = list_make2(makeString(nspname),
+      makeString(get_func_name(expr->funcid)));
+    Oid funcoid = LookupFuncName(nspfunc, 1, funcargs, true);
+    if (funcoid == InvalidOid)
+      return NULL;
+    otherbox = (Node *) makeFuncExpr(funcoid, bboxoid, list_make1(other),
+      InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
+  }
+
+  /* The index expression refers to the relation as the first one */
+  Node *bboxexpr = copyObject((Node *) expr);
+  ChangeVarNodes(bboxexpr, 1, var->varno, 0);
+  return make_opclause(operid, BOOLOID, false, (Expr *) bboxexpr,
+    (Expr *) otherbox, InvalidOid, InvalidOid);
+}
+
+/**
+ * @brief Return the overlaps predicate on the bounding box of a column of
+ * temporal values implied by the overlaps predicate with another argument
+ * when the column has an expression index on its bounding box, or @p NULL
+ * otherwise
+ * @param[in] rel Relation
+ * @param[in] var Column of temporal values
+ * @param[in] other Other argument
+ */
+static Expr *
+bbox_index_clause(Relation rel, Var *var, Node *other)
+{
+  Expr *result = NULL;
+  List *indexoids = RelationGetIndexList(rel);
+  ListCell *lc;
+  foreach (lc, indexoids)
+  {
+    Relation index = index_open(lfirst_oid(lc), AccessShareLock);
+    FuncExpr *expr = bbox_index_expr(index, var->varattno);
+    if (expr)
+      result = make_bbox_index_clause(expr, index->rd_opfamily[0], var,
+        other);
+    index_close(index, AccessShareLock);
+    if (result)
+      break;
+  }
+  list_free(indexoids);
+  return result;
+}
+
+/*****************************************************************************/
+
+PGDLLEXPORT Datum Temporal_overlaps_supportfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_overlaps_supportfn);
+/**
+ * @brief Support function for the overlaps operators of temporal types
+ * @details When one argument is a column of temporal values, the predicate
+ * is simplified into the conjunction of itself and of the predicates it
+ * implies on other columns or expressions of the table:
+ * - When the other argument is a timestamptz span and the table has stored
+ *   generated columns computed by `startTimestamp` or `endTimestamp` on the
+ *   column, range predicates on these columns are added, for example
+ * @code
+ * trip && tstzspan '[2001-06-01, 2001-07-01]' AND
+ *   start_time <= '2001-07-01'
+ * @endcode
+ *   so that the partitions on the time extent columns can be pruned and
+ *   their B-tree indexes can be used.
+ * - When the table has an index on the bounding box of the column an
+ *   overlaps predicate between the bounding boxes is added, for example
+ * @code
+ * trip && q AND stbox(trip) && stbox(q)
+ * @endcode
+ *   so that the index can be used without rewriting the queries.
+ */
+Datum
+Temporal_overlaps_supportfn(PG_FUNCTION_ARGS)
+{
+  Node *rawreq = (Node *) PG_GETARG_POINTER(0);
+  if (! IsA(rawreq, SupportRequestSimplify))
+    PG_RETURN_POINTER((Node *) NULL);
+
+  SupportRequestSimplify *req = (SupportRequestSimplify *) rawreq;
+  FuncExpr *fexpr = req->fcall;
+  if (! req->root || list_length(fexpr->args) != 2)
+    PG_RETURN_POINTER((Node *) NULL);
+
+  /* One of the arguments must be a column of temporal values */
+  Node *leftarg = (Node *) linitial(fexpr->args);
+  Node *rightarg = (Node *) lsecond(fexpr->args);
+  Var *var;
+  Node *other;
+  if (IsA(leftarg, Var) && temporal_type(oid_type(exprType(leftarg))))
+  {
+    var = (Var *) leftarg;
+    other = rightarg;
+  }
+  else if (IsA(rightarg, Var) && temporal_type(oid_type(exprType(rightarg))))
+  {
+    var = (Var *) rightarg;
+    other = leftarg;
+  }
+  else
+    PG_RETURN_POINTER((Node *) NULL);
+  if (IS_SPECIAL_VARNO(var->varno) || var->varlevelsup != 0 ||
+      var->varattno <= 0)
+    PG_RETURN_POINTER((Node *) NULL);
+  RangeTblEntry *rte = planner_rt_fetch(var->varno, req->root);
+  if (! rte || rte->rtekind != RTE_RELATION)
+    PG_RETURN_POINTER((Node *) NULL);
+
+  /* Collect the implied predicates */
+  List *quals = NIL;
+  Relation rel = table_open(rte->relid, NoLock);
+  if (IsA(other, Const) && ! ((Const *) other)->constisnull &&
+      ((Const *) other)->consttype == type_oid(T_TSTZSPAN))
+    quals = time_extent_quals(rel, var,
+      DatumGetSpanP(((Const *) other)->constvalue));
+  Expr *expr = bbox_index_clause(rel, var, other);
+  if (expr)
+    quals = lappend(quals, expr);
+  table_close(rel, NoLock);
+  if (quals == NIL)
+    PG_RETURN_POINTER((Node *) NULL);
+
+  /* Keep the original predicate as an operator so that it remains
+   * indexable */
+  char *nspname = get_namespace_name(get_func_namespace(fexpr->funcid));
+  Oid operid = OpernameGetOprid(list_make2(makeString(nspname),
+    makeString("&&")), exprType(leftarg), exprType(rightarg));
+  expr = (operid != InvalidOid) ?
+    make_opclause(operid, BOOLOID, false, (Expr *) leftarg,
+      (Expr *) rightarg, InvalidOid, InvalidOid) :
+    (Expr *) makeFuncExpr(fexpr->funcid, BOOLOID, fexpr->args, InvalidOid,
+      InvalidOid, COERCE_EXPLICIT_CALL);
+  PG_RETURN_POINTER(make_andclause(lcons(expr, quals)));
+}
+
 /*****************************************************************************/
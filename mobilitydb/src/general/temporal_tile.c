@@ -42,6 +42,7 @@
 /* PostgreSQL */
 #include <postgres.h>
 #include <funcapi.h>
+#include <utils/memutils.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -50,6 +51,8 @@
 #include "general/temporal.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
+#include "pg_general/temporal.h"
+#include "pg_general/type_util.h"
 
 /*****************************************************************************
  * Number bucket functions
@@ -92,6 +95,83 @@ Timestamptz_bucket(PG_FUNCTION_ARGS)
   PG_RETURN_TIMESTAMPTZ(timestamptz_bucket(t, duration, origin));
 }
 
+/*****************************************************************************
+ * Batch bucket functions
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Numberarr_bucket(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Numberarr_bucket);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the initial values of the buckets in which the values of an
+ * array fall
+ * @sqlfn valueBucket()
+ */
+Datum
+Numberarr_bucket(PG_FUNCTION_ARGS)
+{
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+  ensure_not_empty_array(array);
+  Datum size = PG_GETARG_DATUM(1);
+  Datum origin = PG_GETARG_DATUM(2);
+  meosType basetype = oid_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+  int count;
+  Datum *values = datumarr_extract(array, &count);
+  Datum *result = palloc(sizeof(Datum) * count);
+  if (basetype == T_INT4)
+  {
+    int *ivalues = palloc(sizeof(int) * count);
+    for (int i = 0; i < count; i++)
+      ivalues[i] = DatumGetInt32(values[i]);
+    int *buckets = intarr_bucket(ivalues, count, DatumGetInt32(size),
+      DatumGetInt32(origin));
+    for (int i = 0; i < count; i++)
+      result[i] = Int32GetDatum(buckets[i]);
+    pfree(ivalues); pfree(buckets);
+  }
+  else /* basetype == T_FLOAT8 */
+  {
+    double *dvalues = palloc(sizeof(double) * count);
+    for (int i = 0; i < count; i++)
+      dvalues[i] = DatumGetFloat8(values[i]);
+    double *buckets = floatarr_bucket(dvalues, count, DatumGetFloat8(size),
+      DatumGetFloat8(origin));
+    for (int i = 0; i < count; i++)
+      result[i] = Float8GetDatum(buckets[i]);
+    pfree(dvalues); pfree(buckets);
+  }
+  ArrayType *resarr = datumarr_to_array(result, count, basetype);
+  pfree(values); pfree(result);
+  PG_FREE_IF_COPY(array, 0);
+  PG_RETURN_ARRAYTYPE_P(resarr);
+}
+
+PGDLLEXPORT Datum Timestamptzarr_bucket(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Timestamptzarr_bucket);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the initial timestamps of the buckets in which the timestamps
+ * of an array fall
+ * @sqlfn timeBucket()
+ */
+Datum
+Timestamptzarr_bucket(PG_FUNCTION_ARGS)
+{
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+  ensure_not_empty_array(array);
+  Interval *duration = PG_GETARG_INTERVAL_P(1);
+  TimestampTz origin = PG_GETARG_TIMESTAMPTZ(2);
+  int count;
+  Datum *values = datumarr_extract(array, &count);
+  TimestampTz *times = palloc(sizeof(TimestampTz) * count);
+  for (int i = 0; i < count; i++)
+    times[i] = DatumGetTimestampTz(values[i]);
+  TimestampTz *buckets = timestamptzarr_bucket(times, count, duration, origin);
+  pfree(values); pfree(times);
+  PG_FREE_IF_COPY(array, 0);
+  PG_RETURN_ARRAYTYPE_P(tstzarr_to_array(buckets, count));
+}
+
 /*****************************************************************************/
 
 /**
@@ -340,61 +420,25 @@ Tbox_tile(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************
- * Value and time split functions for temporal numbers
+ * External value and time split functions for temporal numbers
  *****************************************************************************/
 
 /**
- * @brief Create the initial state that persists across multiple calls of the
- * function
- * @param[in] size Value bucket size
- * @param[in] tunits Time bucket size
- * @param[in] value_buckets Initial values of the tiles
- * @param[in] time_buckets Initial timestamps of the tiles
- * @param[in] fragments Fragments of the input temporal value
- * @param[in] count Number of elements in the input arrays
- *
- * @pre count is greater than 0
+ * Struct for storing the state of the value and time split functions
  */
-ValueTimeSplitState *
-value_time_split_state_make(Datum size, int64 tunits, Datum *value_buckets,
-  TimestampTz *time_buckets, Temporal **fragments, int count)
+typedef struct
 {
-  assert(count > 0);
-  ValueTimeSplitState *state = palloc0(sizeof(ValueTimeSplitState));
-  /* Fill in state */
-  state->done = false;
-  state->size = size;
-  state->tunits = tunits;
-  state->value_buckets = value_buckets;
-  state->time_buckets = time_buckets;
-  state->fragments = fragments;
-  state->i = 0;
-  state->count = count;
-  return state;
-}
-
-/**
- * @brief Increment the current state to the next tile of the multidimensional
- * grid
- * @param[in] state State to increment
- */
-void
-value_time_split_state_next(ValueTimeSplitState *state)
-{
-  /* Move to the next split */
-  state->i++;
-  if (state->i == state->count)
-    state->done = true;
-  return;
-}
-
-/*****************************************************************************
- * External value and time split functions for temporal numbers
- *****************************************************************************/
+  ValueTimeSplitState *state; /**< State of the split kept across calls */
+  MemoryContext cxt;          /**< Context for the work of each call */
+} ValueTimeSplitFctx;
 
 /**
  * @brief Split a temporal value with respect to a base value and possibly a
  * temporal grid
+ * @details The fragments of the value buckets are computed in the first call
+ * and kept in the multi-call memory context. The fragments of the tiles are
+ * computed one per call in a memory context that is reset at every call, so
+ * that the memory used does not depend on the number of tiles
  */
 Datum
 Temporal_value_time_split_ext(FunctionCallInfo fcinfo, bool valuesplit,
@@ -402,7 +446,7 @@ Temporal_value_time_split_ext(FunctionCallInfo fcinfo, bool valuesplit,
 {
   assert(valuesplit || timesplit);
   FuncCallContext *funcctx;
-  ValueTimeSplitState *state;
+  ValueTimeSplitFctx *fctx;
   bool isnull[3] = {0,0,0}; /* needed to say no value is null */
   Datum tuple_arr[3]; /* used to construct the composite return value */
   HeapTuple tuple;
@@ -432,63 +476,50 @@ Temporal_value_time_split_ext(FunctionCallInfo fcinfo, bool valuesplit,
     if (timesplit)
       torigin = PG_GETARG_TIMESTAMPTZ(i++);
 
-    Datum *value_buckets = NULL;
-    TimestampTz *time_buckets = NULL;
-    int count;
-    Temporal **fragments;
-    if (valuesplit && ! timesplit)
-      fragments = tnumber_value_split(temp, size, vorigin, &value_buckets,
-        &count);
-    else if (! valuesplit && timesplit)
-      fragments = temporal_time_split(temp, duration, torigin, &time_buckets,
-        &count);
-    else /* valuesplit && timesplit */
-      fragments = tnumber_value_time_split(temp, size, duration, vorigin,
-        torigin, &value_buckets, &time_buckets, &count);
-
-    assert(count > 0);
-    int64 tunits = 0;
-    if (timesplit)
-      tunits = interval_units(duration);
-
     /* Create function state */
-    funcctx->user_fctx = value_time_split_state_make(size, tunits,
-      value_buckets, time_buckets, fragments, count);
+    fctx = palloc(sizeof(ValueTimeSplitFctx));
+    fctx->state = value_time_split_state_make(temp, valuesplit, size,
+      vorigin, duration, torigin);
+    fctx->cxt = AllocSetContextCreate(funcctx->multi_call_memory_ctx,
+      "Value and time split", ALLOCSET_DEFAULT_SIZES);
+    funcctx->user_fctx = fctx;
     /* Build a tuple description for the function output */
     get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
     BlessTupleDesc(funcctx->tuple_desc);
     MemoryContextSwitchTo(oldcontext);
-    PG_FREE_IF_COPY(temp, 0);
   }
 
   /* Stuff done on every call of the function */
   funcctx = SRF_PERCALL_SETUP();
   /* Get state */
-  state = funcctx->user_fctx;
+  fctx = funcctx->user_fctx;
+  /* Compute the next fragment in the per-call context */
+  Datum value;
+  TimestampTz t;
+  Temporal *fragment;
+  MemoryContextReset(fctx->cxt);
+  MemoryContext oldcontext = MemoryContextSwitchTo(fctx->cxt);
+  bool found = value_time_split_state_next(fctx->state, &value, &t,
+    &fragment);
+  MemoryContextSwitchTo(oldcontext);
   /* Stop when we've output all the fragments */
-  if (state->done)
+  if (! found)
   {
-    /* Switch to memory context appropriate for multiple function calls */
-    MemoryContext oldcontext =
-      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-    for (int i = 0; i < state->count; i++)
-      pfree(state->fragments[i]);
-    pfree(state);
-    MemoryContextSwitchTo(oldcontext);
+    value_time_split_state_free(fctx->state);
+    MemoryContextDelete(fctx->cxt);
     SRF_RETURN_DONE(funcctx);
   }
 
   /* Store value, timestamp, and split */
   int j = 0;
   if (valuesplit)
-    tuple_arr[j++] = state->value_buckets[state->i];
+    tuple_arr[j++] = value;
   if (timesplit)
-    tuple_arr[j++] = TimestampTzGetDatum(state->time_buckets[state->i]);
-  tuple_arr[j++] = PointerGetDatum(state->fragments[state->i]);
-  /* Advance state */
-  value_time_split_state_next(state);
-  /* Form tuple and return */
+    tuple_arr[j++] = TimestampTzGetDatum(t);
+  tuple_arr[j++] = PointerGetDatum(fragment);
+  /* Form tuple and return, the tuple contains a copy of the fragment */
   tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  pfree(fragment);
   result = HeapTupleGetDatum(tuple);
   SRF_RETURN_NEXT(funcctx, result);
 }
@@ -537,4 +568,45 @@ Tnumber_value_time_split(PG_FUNCTION_ARGS)
   return Temporal_value_time_split_ext(fcinfo, true, true);
 }
 
+/*****************************************************************************
+ * Bucketed aggregation functions
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tnumber_bucket_twavg(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_bucket_twavg);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the time-weighted average of a temporal number per time
+ * bucket
+ * @sqlfn bucketTwAvg()
+ */
+Datum
+Tnumber_bucket_twavg(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Interval *duration = PG_GETARG_INTERVAL_P(1);
+  TimestampTz origin = PG_GETARG_TIMESTAMPTZ(2);
+  Temporal *result = tnumber_bucket_twavg(temp, duration, origin);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Tnumber_bucket_max(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_bucket_max);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the maximum value of a temporal number per time bucket
+ * @sqlfn bucketMax()
+ */
+Datum
+Tnumber_bucket_max(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Interval *duration = PG_GETARG_INTERVAL_P(1);
+  TimestampTz origin = PG_GETARG_TIMESTAMPTZ(2);
+  Temporal *result = tnumber_bucket_max(temp, duration, origin);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 /*****************************************************************************/
@@ -228,4 +228,89 @@ Tnumber_wavg_transfn(PG_FUNCTION_ARGS)
     &tnumber_transform_wavg);
 }
 
+/*****************************************************************************
+ * Sliding window functions for a single temporal number
+ *****************************************************************************/
+
+/**
+ * @brief Generic sliding window function for a temporal number
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] func Window function
+ */
+static Datum
+Tnumber_window(FunctionCallInfo fcinfo,
+  Temporal * (*func)(const Temporal *, const Interval *))
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Interval *interval = PG_GETARG_INTERVAL_P(1);
+  Temporal *result = func(temp, interval);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Tnumber_wmin(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_wmin);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the sliding window minimum of a temporal number
+ * @sqlfn windowMin()
+ */
+Datum
+Tnumber_wmin(PG_FUNCTION_ARGS)
+{
+  return Tnumber_window(fcinfo, &tnumber_wmin);
+}
+
+PGDLLEXPORT Datum Tnumber_wmax(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_wmax);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the sliding window maximum of a temporal number
+ * @sqlfn windowMax()
+ */
+Datum
+Tnumber_wmax(PG_FUNCTION_ARGS)
+{
+  return Tnumber_window(fcinfo, &tnumber_wmax);
+}
+
+PGDLLEXPORT Datum Tnumber_wsum(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_wsum);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the sliding window sum of a temporal number
+ * @sqlfn windowSum()
+ */
+Datum
+Tnumber_wsum(PG_FUNCTION_ARGS)
+{
+  return Tnumber_window(fcinfo, &tnumber_wsum);
+}
+
+PGDLLEXPORT Datum Tnumber_wcount(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_wcount);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the sliding window count of a temporal number
+ * @sqlfn windowCount()
+ */
+Datum
+Tnumber_wcount(PG_FUNCTION_ARGS)
+{
+  return Tnumber_window(fcinfo, &tnumber_wcount);
+}
+
+PGDLLEXPORT Datum Tnumber_wavg(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_wavg);
+/**
+ * @ingroup mobilitydb_temporal_agg
+ * @brief Return the sliding window average of a temporal number
+ * @sqlfn windowAvg()
+ */
+Datum
+Tnumber_wavg(PG_FUNCTION_ARGS)
+{
+  return Tnumber_window(fcinfo, &tnumber_wavg);
+}
+
 /*****************************************************************************/
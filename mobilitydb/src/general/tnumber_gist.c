@@ -41,6 +41,10 @@
 #include <float.h>
 /* PostgreSQL */
 #include <postgres.h>
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  #include <access/reloptions.h>
+#endif
+#include <utils/array.h>
 #include <utils/float.h>
 #include <utils/timestamp.h>
 /* MEOS */
@@ -54,6 +58,7 @@
 #include "pg_general/meos_catalog.h"
 #include "pg_general/temporal.h"
 #include "pg_general/span_gist.h"
+#include "pg_general/type_util.h"
 
 /*****************************************************************************
  * GiST consistent methods
@@ -141,7 +146,7 @@ tbox_index_consistent_leaf(const TBox *key, const TBox *query,
  * @param[in] query Value being looked up in the index
  * @param[in] strategy Operator of the operator class being applied
  */
-static bool
+bool
 tnumber_gist_consistent(const TBox *key, const TBox *query,
   StrategyNumber strategy)
 {
@@ -194,39 +199,40 @@ tnumber_gist_consistent(const TBox *key, const TBox *query,
 }
 
 /**
- * @brief Transform the query argument into a box initializing the dimensions
+ * @brief Transform a query value into a box initializing the dimensions
  * that must not be taken into account by the operators to infinity
+ * @param[in] value Query value
+ * @param[in] type Type of the query value
+ * @param[out] result Resulting box
+ * @note This function is used for both GiST and BRIN indexes
  */
-static bool
-tnumber_gist_get_tbox(FunctionCallInfo fcinfo, TBox *result, Oid typid)
+bool
+tnumber_index_get_tbox(Datum value, meosType type, TBox *result)
 {
-  meosType type = oid_type(typid);
-  Span *s;
   if (tnumber_spantype(type))
   {
-    s = PG_GETARG_SPAN_P(1);
+    Span *s = DatumGetSpanP(value);
     if (s == NULL)
       return false;
     numspan_set_tbox(s, result);
   }
   else if (type == T_TSTZSPAN)
   {
-    s = PG_GETARG_SPAN_P(1);
+    Span *s = DatumGetSpanP(value);
     tstzspan_set_tbox(s, result);
   }
   else if (type == T_TBOX)
   {
-    TBox *box = PG_GETARG_TBOX_P(1);
+    TBox *box = DatumGetTboxP(value);
     if (box == NULL)
       return false;
     memcpy(result, box, sizeof(TBox));
   }
+  else if (tnumber_basetype(type))
+    number_set_tbox(value, type, result);
   else if (tnumber_type(type))
   {
-    if (PG_ARGISNULL(1))
-      return false;
-    Datum tempdatum = PG_GETARG_DATUM(1);
-    Temporal *temp = temporal_slice(tempdatum);
+    Temporal *temp = temporal_slice(value);
     tnumber_set_tbox(temp, result);
   }
   else
@@ -234,6 +240,18 @@ tnumber_gist_get_tbox(FunctionCallInfo fcinfo, TBox *result, Oid typid)
   return true;
 }
 
+/**
+ * @brief Transform the query argument into a box initializing the dimensions
+ * that must not be taken into account by the operators to infinity
+ */
+static bool
+tnumber_gist_get_tbox(FunctionCallInfo fcinfo, TBox *result, Oid typid)
+{
+  if (PG_ARGISNULL(1))
+    return false;
+  return tnumber_index_get_tbox(PG_GETARG_DATUM(1), oid_type(typid), result);
+}
+
 PGDLLEXPORT Datum Tnumber_gist_consistent(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Tnumber_gist_consistent);
 /**
@@ -281,7 +299,7 @@ Tnumber_gist_consistent(PG_FUNCTION_ARGS)
  * @note This function is similar to tbox_expand in file tbox.c but uses
  *   NaN-aware comparisons for the value dimension
  */
-static void
+void
 tbox_adjust(void *bbox1, void *bbox2)
 {
   TBox *box1 = (TBox *) bbox1;
@@ -378,7 +396,7 @@ tbox_union_rt(const TBox *a, const TBox *b, TBox *new)
  * @brief Return the size of a temporal box for penalty-calculation purposes
  * @note The result can be +Infinity, but not NaN
  */
-static double
+double
 tbox_size(const TBox *box)
 {
   /*
@@ -552,6 +570,16 @@ bbox_gist_consider_split(ConsiderSplitContext *context, int dimNum,
 
     overlap = (float4) ((leftUpper - rightLower) / range);
 
+    /*
+     * Express the range in units of the mean width of the entries along the
+     * axis, or of their mean spacing for degenerate entries such as
+     * instants, so that the comparison across dimensions does not depend on
+     * their units, e.g., metres and microseconds.
+     */
+    double scale = Max(context->width, range / context->entriesCount);
+    if (scale > 0.0)
+      range /= scale;
+
     /* If there is no previous selection, select this */
     if (context->first)
       selectthis = true;
@@ -588,6 +616,15 @@ bbox_gist_consider_split(ConsiderSplitContext *context, int dimNum,
         (range > context->range &&
          non_negative(overlap) <= non_negative(context->overlap)))
         selectthis = true;
+      /*
+       * Since the ranges are normalized they are often equal, e.g., for
+       * instants, in which case the split with the largest gap between the
+       * groups relative to the range of its dimension is chosen.
+       */
+      else if (range == context->range &&
+          non_negative(overlap) == non_negative(context->overlap) &&
+          overlap < context->overlap)
+        selectthis = true;
     }
 
     if (selectthis)
@@ -791,6 +828,12 @@ bbox_gist_picksplit(FunctionCallInfo fcinfo, meosType bboxtype,
       }
     }
 
+    /* Mean width of the entries along the axis */
+    context.width = 0.0;
+    for (int j = 0; j < nentries; j++)
+      context.width += intervalsLower[j].upper - intervalsLower[j].lower;
+    context.width /= nentries;
+
     /*
      * Make two arrays of intervals: one sorted by lower bound and another
      * sorted by upper bound.
@@ -914,7 +957,7 @@ bbox_gist_picksplit(FunctionCallInfo fcinfo, meosType bboxtype,
    */
   if (context.first)
   {
-    bbox_gist_fallback_split(entryvec, v, bboxtype, &tbox_adjust);
+    bbox_gist_fallback_split(entryvec, v, bboxtype, bbox_adjust);
     PG_RETURN_POINTER(v);
   }
 
@@ -1069,7 +1112,7 @@ bbox_gist_picksplit(FunctionCallInfo fcinfo, meosType bboxtype,
       else
       {
         /* Otherwise select the group by minimal penalty */
-        if (tbox_penalty(leftBox, box) < tbox_penalty(rightBox, box))
+        if (bbox_penalty(leftBox, box) < bbox_penalty(rightBox, box))
           PLACE_LEFT(box, idx);
         else
           PLACE_RIGHT(box, idx);
@@ -1131,6 +1174,24 @@ Tbox_gist_same(PG_FUNCTION_ARGS)
  * GiST distance method
  *****************************************************************************/
 
+/**
+ * @brief Return the distance between an index key and a query box used for
+ * ordering the index entries, that is, the nearest approach distance of the
+ * value spans of the boxes
+ * @note If the time spans of the boxes do not overlap, the infinite distance
+ * is returned so that the entry is returned last
+ * @note This function is also called by the SP-GiST index
+ */
+double
+tbox_index_distance(const TBox *key, const TBox *query)
+{
+  Datum dist = nad_tbox_tbox(key, query);
+  double result = (key->span.basetype == T_INT4) ?
+    (double) DatumGetInt32(dist) : DatumGetFloat8(dist);
+  /* A negative distance means that the time spans do not overlap */
+  return (result < 0.0) ? DBL_MAX : result;
+}
+
 PGDLLEXPORT Datum Tbox_gist_distance(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Tbox_gist_distance);
 /**
@@ -1160,9 +1221,335 @@ Tbox_gist_distance(PG_FUNCTION_ARGS)
 
   /* Since we only have boxes we'll return the minimum possible distance,
    * and let the recheck sort things out in the case of leaves */
-  distance = nad_tbox_tbox(key, &query);
+  distance = tbox_index_distance(key, &query);
 
   PG_RETURN_FLOAT8(distance);
 }
 
+/*****************************************************************************
+ * GiST fetch method
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tbox_gist_fetch(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_gist_fetch);
+/**
+ * @brief GiST fetch method for temporal boxes, which enables index-only
+ * scans for indexes on temporal boxes, including expression indexes such as
+ * those on tbox(temp)
+ */
+Datum
+Tbox_gist_fetch(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  PG_RETURN_POINTER(entry);
+}
+
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * @brief Return the sort key of a temporal box, which is the Hilbert index
+ * of its center
+ */
+static uint64
+tbox_sort_key(Datum value)
+{
+  const TBox *box = DatumGetTboxP(value);
+  double coords[2];
+  int ndims = 0;
+  if (MEOS_FLAGS_GET_X(box->flags))
+    coords[ndims++] = span_center_double(&box->span);
+  if (MEOS_FLAGS_GET_T(box->flags))
+    coords[ndims++] = span_center_double(&box->period);
+  return bbox_sort_hilbert_key(coords, ndims);
+}
+
+PGDLLEXPORT Datum Tbox_gist_sortsupport(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tbox_gist_sortsupport);
+/**
+ * @brief GiST sortsupport method for temporal boxes
+ */
+Datum
+Tbox_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  return bbox_gist_sortsupport(fcinfo, &tbox_sort_key);
+}
+
+/*****************************************************************************
+ * Multi-box GiST methods
+ *
+ * The leaf entries of the index store, instead of the bounding box of a
+ * temporal number, an array of up to `max_count` boxes obtained with the
+ * function #tnumber_tboxes that splits the value into tight pieces.
+ * The internal entries store an array with a single box which is the union
+ * of the boxes below.
+ *****************************************************************************/
+
+/* Default and maximum number of boxes of a leaf entry */
+#define MGIST_MAX_COUNT_DEFAULT 8
+#define MGIST_MAX_COUNT_MAX     32
+
+/**
+ * @brief Structure for the options of the multi-box GiST operator classes
+ */
+typedef struct
+{
+  int32 vl_len_;      /**< Varlena header (do not touch directly!) */
+  int max_count;      /**< Maximum number of boxes of a leaf entry */
+} TNumberMGistOptions;
+
+/**
+ * @brief Return the boxes of a multi-box index key
+ * @param[in] key Index key
+ * @param[out] count Number of boxes
+ */
+static const TBox *
+tnumber_mgist_key_boxes(Datum key, int *count)
+{
+  ArrayType *array = DatumGetArrayTypeP(key);
+  *count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+  return (const TBox *) ARR_DATA_PTR(array);
+}
+
+/**
+ * @brief Return in the last argument the union of the boxes of a multi-box
+ * index key
+ */
+static void
+tnumber_mgist_key_box(Datum key, TBox *result)
+{
+  int count;
+  const TBox *boxes = tnumber_mgist_key_boxes(key, &count);
+  memcpy(result, &boxes[0], sizeof(TBox));
+  for (int i = 1; i < count; i++)
+    tbox_adjust(result, (void *) &boxes[i]);
+  return;
+}
+
+/**
+ * @brief Return a multi-box index key from an array of boxes
+ */
+static Datum
+tnumber_mgist_key_make(const TBox *boxes, int count)
+{
+  return PointerGetDatum(tboxarr_to_array((TBox *) boxes, count));
+}
+
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+PGDLLEXPORT Datum Tnumber_mgist_options(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_mgist_options);
+/**
+ * @brief Multi-box GiST options method for temporal numbers
+ */
+Datum
+Tnumber_mgist_options(PG_FUNCTION_ARGS)
+{
+  local_relopts *relopts = (local_relopts *) PG_GETARG_POINTER(0);
+  init_local_reloptions(relopts, sizeof(TNumberMGistOptions));
+  add_local_int_reloption(relopts, "max_count",
+    "maximum number of boxes indexed for a temporal number",
+    MGIST_MAX_COUNT_DEFAULT, 1, MGIST_MAX_COUNT_MAX,
+    offsetof(TNumberMGistOptions, max_count));
+  PG_RETURN_VOID();
+}
+#endif /* POSTGRESQL_VERSION_NUMBER >= 130000 */
+
+PGDLLEXPORT Datum Tnumber_mgist_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_mgist_compress);
+/**
+ * @brief Multi-box GiST compress method for temporal numbers
+ */
+Datum
+Tnumber_mgist_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  if (entry->leafkey)
+  {
+    int max_count = MGIST_MAX_COUNT_DEFAULT;
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+    if (PG_HAS_OPCLASS_OPTIONS())
+      max_count = ((TNumberMGistOptions *) PG_GET_OPCLASS_OPTIONS())->max_count;
+#endif /* POSTGRESQL_VERSION_NUMBER >= 130000 */
+    Temporal *temp = (Temporal *) PG_DETOAST_DATUM(entry->key);
+    int count;
+    TBox *boxes = tnumber_tboxes(temp, max_count, &count);
+    GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+    gistentryinit(*retval, tnumber_mgist_key_make(boxes, count), entry->rel,
+      entry->page, entry->offset, false);
+    pfree(boxes);
+    PG_RETURN_POINTER(retval);
+  }
+  PG_RETURN_POINTER(entry);
+}
+
+PGDLLEXPORT Datum Tnumber_mgist_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_mgist_consistent);
+/**
+ * @brief Multi-box GiST consistent method for temporal numbers
+ * @details The overlaps operator at the leaf level is tested against each
+ * box of the key, so that a value is only returned when it reaches the value
+ * range of the query during its time span. All the other operators are
+ * tested against the union of the boxes, which is the bounding box of the
+ * value.
+ */
+Datum
+Tnumber_mgist_consistent(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+  Oid typid = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
+  TBox key, query;
+
+  /*
+   * All tests are lossy since boxes do not distinghish between inclusive
+   * and exclusive bounds.
+   */
+  *recheck = true;
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_BOOL(false);
+
+  /* Transform the query into a box */
+  if (! tnumber_gist_get_tbox(fcinfo, &query, typid))
+    PG_RETURN_BOOL(false);
+
+  if (GIST_LEAF(entry) && strategy == RTOverlapStrategyNumber)
+  {
+    int count;
+    const TBox *boxes = tnumber_mgist_key_boxes(entry->key, &count);
+    for (int i = 0; i < count; i++)
+    {
+      if (overlaps_tbox_tbox(&boxes[i], &query))
+        PG_RETURN_BOOL(true);
+    }
+    PG_RETURN_BOOL(false);
+  }
+
+  tnumber_mgist_key_box(entry->key, &key);
+  if (GIST_LEAF(entry))
+    result = tbox_index_consistent_leaf(&key, &query, strategy);
+  else
+    result = tnumber_gist_consistent(&key, &query, strategy);
+  PG_RETURN_BOOL(result);
+}
+
+PGDLLEXPORT Datum Tnumber_mgist_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_mgist_union);
+/**
+ * @brief Multi-box GiST union method for temporal numbers
+ */
+Datum
+Tnumber_mgist_union(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  GISTENTRY *ent = entryvec->vector;
+  TBox result, box;
+  tnumber_mgist_key_box(ent[0].key, &result);
+  for (int i = 1; i < entryvec->n; i++)
+  {
+    tnumber_mgist_key_box(ent[i].key, &box);
+    tbox_adjust(&result, &box);
+  }
+  PG_RETURN_DATUM(tnumber_mgist_key_make(&result, 1));
+}
+
+PGDLLEXPORT Datum Tnumber_mgist_penalty(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_mgist_penalty);
+/**
+ * @brief Multi-box GiST penalty method for temporal numbers
+ */
+Datum
+Tnumber_mgist_penalty(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  GISTENTRY *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
+  float *result = (float *) PG_GETARG_POINTER(2);
+  TBox origbox, newbox;
+  tnumber_mgist_key_box(origentry->key, &origbox);
+  tnumber_mgist_key_box(newentry->key, &newbox);
+  *result = (float) tbox_penalty(&origbox, &newbox);
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tnumber_mgist_picksplit(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_mgist_picksplit);
+/**
+ * @brief Multi-box GiST picksplit method for temporal numbers
+ * @details The entries are replaced by their union box and split with the
+ * algorithm of the GiST picksplit method for temporal boxes
+ */
+Datum
+Tnumber_mgist_picksplit(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+  GistEntryVector *boxvec = palloc(GEVHDRSZ + sizeof(GISTENTRY) * entryvec->n);
+  TBox *boxes = palloc(sizeof(TBox) * entryvec->n);
+  boxvec->n = entryvec->n;
+  for (OffsetNumber i = FirstOffsetNumber; i < entryvec->n; i++)
+  {
+    boxvec->vector[i] = entryvec->vector[i];
+    tnumber_mgist_key_box(entryvec->vector[i].key, &boxes[i]);
+    boxvec->vector[i].key = PointerGetDatum(&boxes[i]);
+  }
+  fcinfo->args[0].value = PointerGetDatum(boxvec);
+  bbox_gist_picksplit(fcinfo, T_TBOX, &tbox_adjust, &tbox_penalty);
+  v->spl_ldatum = tnumber_mgist_key_make(DatumGetTboxP(v->spl_ldatum), 1);
+  v->spl_rdatum = tnumber_mgist_key_make(DatumGetTboxP(v->spl_rdatum), 1);
+  pfree(boxvec); pfree(boxes);
+  PG_RETURN_POINTER(v);
+}
+
+PGDLLEXPORT Datum Tnumber_mgist_same(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_mgist_same);
+/**
+ * @brief Multi-box GiST same method for temporal numbers
+ * @details Return true only when the keys have exactly the same boxes
+ */
+Datum
+Tnumber_mgist_same(PG_FUNCTION_ARGS)
+{
+  ArrayType *key1 = PG_GETARG_ARRAYTYPE_P(0);
+  ArrayType *key2 = PG_GETARG_ARRAYTYPE_P(1);
+  bool *result = (bool *) PG_GETARG_POINTER(2);
+  *result = VARSIZE(key1) == VARSIZE(key2) &&
+    memcmp(key1, key2, VARSIZE(key1)) == 0;
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tnumber_mgist_distance(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnumber_mgist_distance);
+/**
+ * @brief Multi-box GiST distance method for temporal numbers
+ * @details The distance of a leaf entry is the minimum distance of its boxes
+ */
+Datum
+Tnumber_mgist_distance(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  Oid typid = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4);
+  TBox query;
+
+  /* The index is lossy for leaf levels */
+  if (GIST_LEAF(entry))
+    *recheck = true;
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  /* Transform the query into a box */
+  if (! tnumber_gist_get_tbox(fcinfo, &query, typid))
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  int count;
+  const TBox *boxes = tnumber_mgist_key_boxes(entry->key, &count);
+  double result = DBL_MAX;
+  for (int i = 0; i < count; i++)
+    result = Min(result, tbox_index_distance(&boxes[i], &query));
+  PG_RETURN_FLOAT8(result);
+}
+
 /*****************************************************************************/
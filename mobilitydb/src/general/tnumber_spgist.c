@@ -475,6 +475,8 @@ tnumber_spgist_get_tbox(const ScanKeyData *scankey, TBox *result)
   {
     memcpy(result, DatumGetTboxP(scankey->sk_argument), sizeof(TBox));
   }
+  else if (tnumber_basetype(type))
+    number_set_tbox(scankey->sk_argument, type, result);
   else if (tnumber_type(type))
   {
     Temporal *temp = temporal_slice(scankey->sk_argument);
@@ -1100,7 +1102,7 @@ Tbox_spgist_leaf_consistent(PG_FUNCTION_ARGS)
     {
       /* Convert the order by argument to a box and perform the test */
       tnumber_spgist_get_tbox(&in->orderbys[i], &box);
-      distances[i] = nad_tbox_tbox(&box, key);
+      distances[i] = tbox_index_distance(key, &box);
     }
     /* Recheck is necessary when computing distance with bounding boxes */
     out->recheckDistances = true;
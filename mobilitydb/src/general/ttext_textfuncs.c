@@ -29,7 +29,8 @@
 
 /**
  * @file
- * @brief Temporal text functions: `textcat`, `lower`, `upper`
+ * @brief Temporal text functions: `textcat`, `lower`, `upper`, `dictEncode`,
+ * `dictDecode`
  */
 
 /* PostgreSQL */
@@ -37,6 +38,7 @@
 #include <fmgr.h>
 /* MEOS */
 #include <meos.h>
+#include "general/set.h"
 #include "general/ttext_textfuncs.h"
 
 /*****************************************************************************
@@ -150,4 +152,46 @@ Ttext_initcap(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(result);
 }
 
+/*****************************************************************************
+ * Dictionary encoding
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Ttext_dict_encode(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Ttext_dict_encode);
+/**
+ * @ingroup mobilitydb_temporal_text
+ * @brief Return a temporal text encoded as a temporal integer whose values
+ * are the positions of the texts in a dictionary
+ * @sqlfn dictEncode()
+ */
+Datum
+Ttext_dict_encode(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Set *dict = PG_GETARG_SET_P(1);
+  Temporal *result = ttext_dict_encode(temp, dict);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(dict, 1);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Tint_dict_decode(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tint_dict_decode);
+/**
+ * @ingroup mobilitydb_temporal_text
+ * @brief Return a temporal integer of dictionary codes decoded as a temporal
+ * text
+ * @sqlfn dictDecode()
+ */
+Datum
+Tint_dict_decode(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Set *dict = PG_GETARG_SET_P(1);
+  Temporal *result = tint_dict_decode(temp, dict);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(dict, 1);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 /*****************************************************************************/
@@ -260,6 +260,25 @@ Temporal_from_wkb(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(result);
 }
 
+PGDLLEXPORT Datum Temporal_apply_delta(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_apply_delta);
+/**
+ * @ingroup mobilitydb_temporal_modif
+ * @brief Return a temporal value with the instants of a delta appended
+ * @sqlfn applyDelta()
+ */
+Datum
+Temporal_apply_delta(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  bytea *bytea_delta = PG_GETARG_BYTEA_P(1);
+  Temporal *result = temporal_apply_delta(temp,
+    (uint8_t *) VARDATA(bytea_delta), VARSIZE(bytea_delta) - VARHDRSZ, false);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(bytea_delta, 1);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 PGDLLEXPORT Datum Temporal_from_hexwkb(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Temporal_from_hexwkb);
 /**
@@ -35,6 +35,10 @@
 
 /* PostgreSQL */
 #include <postgres.h>
+#include <funcapi.h>
+#include <miscadmin.h> /* For work_mem */
+#include <catalog/pg_type_d.h>
+#include <utils/tuplestore.h>
 /* PostGIS */
 #include <liblwgeom_internal.h>
 /* MEOS */
@@ -221,6 +225,52 @@ Temporalarr_as_text(PG_FUNCTION_ARGS)
  * Output in Moving Features JSON MF-JSON representation
  *****************************************************************************/
 
+/**
+ * @brief Return the spatial reference system of a temporal point in the
+ * MF-JSON output depending on the option, @p NULL if there is none
+ * @param[in] fcinfo Function call information
+ * @param[in] temp Temporal value
+ * @param[in] option Option of the MF-JSON output
+ */
+static char *
+Temporal_mfjson_srs(FunctionCallInfo fcinfo, const Temporal *temp, int option)
+{
+  if (! tgeo_type(temp->temptype))
+    return NULL;
+
+  /* Even if the option does not request to output the crs, we output the
+   * short crs when the SRID is different from SRID_UNKNOWN. Otherwise,
+   * it is not possible to reconstruct the temporal point from the output
+   * of this function without loosing the SRID */
+  int32_t srid = tpoint_srid(temp);
+  if (srid == SRID_UNKNOWN)
+    return NULL;
+  bool shortcrs = (option & 2) || ! (option & 4);
+  char *srs = getSRSbySRID(fcinfo, srid, shortcrs);
+  if (! srs)
+    elog(ERROR, "SRID %i unknown in spatial_ref_sys table", srid);
+  return srs;
+}
+
+/**
+ * @brief Return the precision of the MF-JSON output given in an argument
+ * (default is max)
+ */
+static int
+Temporal_mfjson_precision(FunctionCallInfo fcinfo, int argno)
+{
+  int precision = OUT_DEFAULT_DECIMAL_DIGITS;
+  if (PG_NARGS() > argno && ! PG_ARGISNULL(argno))
+  {
+    precision = PG_GETARG_INT32(argno);
+    if (precision > OUT_DEFAULT_DECIMAL_DIGITS)
+      precision = OUT_DEFAULT_DECIMAL_DIGITS;
+    else if (precision < 0)
+      precision = 0;
+  }
+  return precision;
+}
+
 PGDLLEXPORT Datum Temporal_as_mfjson(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Temporal_as_mfjson);
 /**
@@ -233,15 +283,11 @@ PG_FUNCTION_INFO_V1(Temporal_as_mfjson);
 Datum
 Temporal_as_mfjson(PG_FUNCTION_ARGS)
 {
-  bool with_bbox = 0;
-  int precision = OUT_DEFAULT_DECIMAL_DIGITS;
   int option = 0;
   int flags = 0;
-  char *srs = NULL;
 
   /* Get the temporal value */
   Temporal *temp = PG_GETARG_TEMPORAL_P(0);
-  bool isgeo = tgeo_type(temp->temptype);
 
   /* Retrieve output option
    * 0 = without option (default)
@@ -251,48 +297,16 @@ Temporal_as_mfjson(PG_FUNCTION_ARGS)
    */
   if (PG_NARGS() > 1 && ! PG_ARGISNULL(1))
    option = PG_GETARG_INT32(1);
-
-  if (isgeo)
-  {
-    /* Even if the option does not request to output the crs, we output the
-     * short crs when the SRID is different from SRID_UNKNOWN. Otherwise,
-     * it is not possible to reconstruct the temporal point from the output
-     * of this function without loosing the SRID */
-    int32_t srid = tpoint_srid(temp);
-    if (srid != SRID_UNKNOWN && !(option & 2) && !(option & 4))
-      option |= 2;
-    if (srid != SRID_UNKNOWN)
-    {
-      if (option & 2)
-        srs = getSRSbySRID(fcinfo, srid, true);
-      else if (option & 4)
-        srs = getSRSbySRID(fcinfo, srid, false);
-      if (! srs)
-      {
-        elog(ERROR, "SRID %i unknown in spatial_ref_sys table", srid);
-        PG_RETURN_NULL();
-      }
-    }
-  }
-
-  if (option & 1)
-    with_bbox = 1;
+  char *srs = Temporal_mfjson_srs(fcinfo, temp, option);
 
   /* Retrieve JSON flags (e.g. for pretty print) if any (default is 0) */
   if (PG_NARGS() > 2 && ! PG_ARGISNULL(2))
     flags = PG_GETARG_INT32(2);
 
   /* Retrieve precision if any (default is max) */
-  if (PG_NARGS() > 3 && !PG_ARGISNULL(3))
-  {
-    precision = PG_GETARG_INT32(3);
-    if (precision > OUT_DEFAULT_DECIMAL_DIGITS)
-      precision = OUT_DEFAULT_DECIMAL_DIGITS;
-    else if (precision < 0)
-      precision = 0;
-  }
+  int precision = Temporal_mfjson_precision(fcinfo, 3);
 
-  char *mfjson = temporal_as_mfjson(temp, with_bbox, flags, precision, srs);
+  char *mfjson = temporal_as_mfjson(temp, option & 1, flags, precision, srs);
   text *result = cstring2text(mfjson);
   // pfree(mfjson);
   PG_FREE_IF_COPY(temp, 0);
@@ -568,6 +582,31 @@ Temporal_as_wkb(PG_FUNCTION_ARGS)
   PG_RETURN_BYTEA_P(result);
 }
 
+PGDLLEXPORT Datum Temporal_delta_since(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_delta_since);
+/**
+ * @ingroup mobilitydb_temporal_inout
+ * @brief Return the delta of the instants of a temporal value after a
+ * timestamp in a binary representation
+ * @sqlfn deltaSince()
+ */
+Datum
+Temporal_delta_since(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  TimestampTz t = PG_GETARG_TIMESTAMPTZ(1);
+  uint8_t variant = 0;
+  /* If user specified endianness, respect it */
+  if (! PG_ARGISNULL(2))
+    variant = get_endian_variant(PG_GETARG_TEXT_P(2));
+  size_t size;
+  uint8_t *delta = temporal_delta_since(temp, t, variant, &size);
+  bytea *result = bstring2bytea(delta, size);
+  pfree(delta);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_BYTEA_P(result);
+}
+
 PGDLLEXPORT Datum Tpoint_as_ewkb(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Tpoint_as_ewkb);
 /**
@@ -608,4 +647,113 @@ Temporal_as_hexwkb(PG_FUNCTION_ARGS)
   PG_RETURN_TEXT_P(result);
 }
 
+/*****************************************************************************
+ * Output in chunks
+ *****************************************************************************/
+
+/**
+ * @brief Structure to collect the chunks of a streaming writer into the
+ * tuple store of a set-returning function
+ */
+typedef struct
+{
+  Tuplestorestate *tupstore;  /**< Tuple store of the result */
+  TupleDesc tupdesc;          /**< Descriptor of the result */
+  bool istext;                /**< True for text chunks, false for bytea */
+} ChunkState;
+
+/**
+ * @brief Callback of the streaming writers adding a chunk to the tuple store
+ */
+static bool
+chunk_write_fn(const char *data, size_t size, void *arg)
+{
+  ChunkState *state = (ChunkState *) arg;
+  CHECK_FOR_INTERRUPTS();
+  void *chunk = state->istext ? (void *) cstring_to_text_with_len(data, size) :
+    (void *) bstring2bytea((const uint8_t *) data, size);
+  Datum value = PointerGetDatum(chunk);
+  bool isnull = false;
+  tuplestore_putvalues(state->tupstore, state->tupdesc, &value, &isnull);
+  pfree(chunk);
+  return true;
+}
+
+/**
+ * @brief Initialize the tuple store of a set-returning function in
+ * materialize mode whose result has a single column of the given type
+ * @note The tuple store spills to disk beyond work_mem and thus the chunks
+ * of a huge output are never kept in memory at once
+ */
+static void
+chunk_state_init(FunctionCallInfo fcinfo, ChunkState *state, bool istext)
+{
+  ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+  if (! rsinfo || ! IsA(rsinfo, ReturnSetInfo) ||
+      ! (rsinfo->allowedModes & SFRM_Materialize))
+    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+      errmsg("materialize mode required, but it is not allowed in this context")));
+
+  MemoryContext oldcontext =
+    MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+  state->tupdesc = CreateTemplateTupleDesc(1);
+  TupleDescInitEntry(state->tupdesc, (AttrNumber) 1, "chunk",
+    istext ? TEXTOID : BYTEAOID, -1, 0);
+  state->tupstore = tuplestore_begin_heap(true, false, work_mem);
+  MemoryContextSwitchTo(oldcontext);
+  state->istext = istext;
+
+  rsinfo->returnMode = SFRM_Materialize;
+  rsinfo->setResult = state->tupstore;
+  rsinfo->setDesc = state->tupdesc;
+  return;
+}
+
+PGDLLEXPORT Datum Temporal_as_mfjson_chunks(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_as_mfjson_chunks);
+/**
+ * @ingroup mobilitydb_temporal_inout
+ * @brief Return the Moving-Features JSON (MF-JSON) representation of a
+ * temporal value as a set of text chunks whose concatenation is the
+ * representation
+ * @sqlfn asMFJSONChunks()
+ */
+Datum
+Temporal_as_mfjson_chunks(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  int option = (PG_NARGS() > 1 && ! PG_ARGISNULL(1)) ? PG_GETARG_INT32(1) : 0;
+  char *srs = Temporal_mfjson_srs(fcinfo, temp, option);
+  int precision = Temporal_mfjson_precision(fcinfo, 2);
+  ChunkState state;
+  chunk_state_init(fcinfo, &state, true);
+  temporal_as_mfjson_write(temp, option & 1, precision, srs, &chunk_write_fn,
+    (void *) &state);
+  PG_FREE_IF_COPY(temp, 0);
+  return (Datum) 0;
+}
+
+PGDLLEXPORT Datum Temporal_as_wkb_chunks(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_as_wkb_chunks);
+/**
+ * @ingroup mobilitydb_temporal_inout
+ * @brief Return the Well-Known Binary (WKB) representation of a temporal
+ * value as a set of bytea chunks whose concatenation is the representation
+ * @sqlfn asBinaryChunks()
+ */
+Datum
+Temporal_as_wkb_chunks(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  uint8_t variant = 0;
+  /* If user specified endianness, respect it */
+  if (PG_NARGS() > 1 && ! PG_ARGISNULL(1))
+    variant = get_endian_variant(PG_GETARG_TEXT_P(1));
+  ChunkState state;
+  chunk_state_init(fcinfo, &state, false);
+  temporal_as_wkb_write(temp, variant, &chunk_write_fn, (void *) &state);
+  PG_FREE_IF_COPY(temp, 0);
+  return (Datum) 0;
+}
+
 /*****************************************************************************/
@@ -220,6 +220,13 @@ temparr_extract(ArrayType *array, int *count)
   Temporal **result;
   deconstruct_array(array, array->elemtype, -1, false, 'd', (Datum **) &result,
     NULL, count);
+  /* Decompress the values stored in the compressed format */
+  for (int i = 0; i < *count; i++)
+  {
+    if (result[i]->subtype != TINSTANT &&
+        MEOS_FLAGS_GET_COMPRESSED(result[i]->flags))
+      result[i] = temporal_decompress(result[i]);
+  }
   return result;
 }
 
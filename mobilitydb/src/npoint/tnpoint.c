@@ -137,6 +137,26 @@ Tgeompoint_to_tnpoint(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(result);
 }
 
+PGDLLEXPORT Datum Tgeompoint_snap_network(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tgeompoint_snap_network);
+/**
+ * @ingroup mobilitydb_temporal_conversion
+ * @brief Return a temporal geometry point snapped to the routes within a
+ * distance
+ * @sqlfn snapToNetwork()
+ */
+Datum
+Tgeompoint_snap_network(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  double tolerance = PG_GETARG_FLOAT8(1);
+  Temporal *result = tgeompoint_tnpoint_snap(temp, tolerance);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 /*****************************************************************************
  * Transformation functions
  *****************************************************************************/
@@ -159,6 +179,25 @@ Tnpoint_round(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(result);
 }
 
+PGDLLEXPORT Datum Tnpoint_pack(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnpoint_pack);
+/**
+ * @ingroup mobilitydb_temporal_transf
+ * @brief Return a temporal network point in the packed storage format, with
+ * run-length encoded routes and float4 positions
+ * @note The value is transparently unpacked by every function that receives
+ * it, except those that only read its bounding box or its routes
+ * @sqlfn pack()
+ */
+Datum
+Tnpoint_pack(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *result = tnpoint_pack(temp);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 PGDLLEXPORT Datum Npointset_round(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Npointset_round);
 /**
@@ -224,7 +263,8 @@ PG_FUNCTION_INFO_V1(Tnpoint_routes);
 Datum
 Tnpoint_routes(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  /* Values in the packed format are not unpacked */
+  Temporal *temp = (Temporal *) PG_DETOAST_DATUM(PG_GETARG_DATUM(0));
   Set *result = tnpoint_routes(temp);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_SET_P(result);
@@ -38,7 +38,6 @@
 /* MEOS */
 #include <meos.h>
 #include "general/temporal.h"
-#include "general/skiplist.h"
 #include "npoint/tnpoint_aggfuncs.h"
 /* MobilityDB */
 #include "pg_general/skiplist.h"
@@ -56,13 +55,21 @@ PG_FUNCTION_INFO_V1(Tnpoint_tcentroid_transfn);
 Datum
 Tnpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
 {
-  SkipList *state;
-  INPUT_AGG_TRANS_STATE(fcinfo, state);
+  TCentroidState *state = PG_ARGISNULL(0) ? NULL :
+    (TCentroidState *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  store_fcinfo(fcinfo);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
   state = tnpoint_tcentroid_transfn(state, temp);
+  unset_aggregation_context(ctx);
   PG_FREE_IF_COPY(temp, 1);
-  PG_RETURN_SKIPLIST_P(state);
+  PG_RETURN_POINTER(state);
 }
 
 
@@ -35,12 +35,75 @@
 
 /* PostgreSQL */
 #include <postgres.h>
+#include <catalog/pg_statistic.h>
+/* MEOS */
+#include <meos.h>
+#include "general/set.h"
+#include "npoint/tnpoint.h"
 /* MobilityDB */
+#include "pg_general/span_analyze.h"
 #include "pg_general/temporal_analyze.h"
 #include "pg_point/tpoint_analyze.h"
 
 /*****************************************************************************/
 
+/**
+ * @brief Compute the statistics for temporal network point columns (callback
+ * function)
+ *
+ * In addition to the statistics of temporal points, the most common route
+ * identifiers of the sample values and their frequencies, that is, the
+ * fraction of non-null values traversing each route, are stored in the last
+ * slot. These are used for estimating the selectivity of the route
+ * operators. The slot is only filled when it is not already used by the
+ * optional space-time histogram.
+ */
+static void
+tnpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
+  int sample_rows, double total_rows)
+{
+  tpoint_compute_stats(stats, fetchfunc, sample_rows, total_rows);
+  if (! stats->stats_valid || stats->stanullfrac >= 1.0 ||
+      stats->stakind[STATISTIC_NUM_SLOTS - 1] != 0)
+    return;
+
+  /* Collect the routes of the sample values */
+  int notnull_cnt = 0, nelems = 0, maxelems = sample_rows;
+  Datum *elems = palloc(sizeof(Datum) * maxelems);
+  for (int i = 0; i < sample_rows; i++)
+  {
+    bool is_null;
+    Datum value = fetchfunc(stats, i, &is_null);
+    if (is_null)
+      continue;
+    /* The routes are obtained from the instants and thus the value must be
+     * fully detoasted */
+    Temporal *temp = (Temporal *) PG_DETOAST_DATUM(value);
+    Set *routes = tnpoint_routes(temp);
+    if (nelems + routes->count > maxelems)
+    {
+      maxelems = Max(maxelems * 2, nelems + routes->count);
+      elems = repalloc(elems, sizeof(Datum) * maxelems);
+    }
+    for (int j = 0; j < routes->count; j++)
+      elems[nelems++] = SET_VAL_N(routes, j);
+    notnull_cnt++;
+    pfree(routes);
+    if ((Pointer) temp != DatumGetPointer(value))
+      pfree(temp);
+    /* Give backend a chance of interrupting us */
+    vacuum_delay_point();
+  }
+
+  if (notnull_cnt > 0)
+    set_compute_mcelem(stats, notnull_cnt, STATISTIC_NUM_SLOTS - 1, elems,
+      nelems, T_INT8);
+  pfree(elems);
+  return;
+}
+
+/*****************************************************************************/
+
 PGDLLEXPORT Datum Tnpoint_analyze(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Tnpoint_analyze);
 /**
@@ -49,8 +112,7 @@ PG_FUNCTION_INFO_V1(Tnpoint_analyze);
 Datum
 Tnpoint_analyze(PG_FUNCTION_ARGS)
 {
-  return temporal_analyze(fcinfo, &tpoint_compute_stats);
+  return temporal_analyze(fcinfo, &tnpoint_compute_stats);
 }
 
-
 /*****************************************************************************/
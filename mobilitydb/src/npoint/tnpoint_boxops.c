@@ -51,6 +51,7 @@
 #include "point/stbox.h"
 #include "npoint/tnpoint.h"
 /* MobilityDB */
+#include "pg_general/temporal.h"
 #include "pg_point/tpoint_boxops.h"
 
 /*****************************************************************************
@@ -154,7 +155,7 @@ PG_FUNCTION_INFO_V1(Tnpoint_to_stbox);
 Datum
 Tnpoint_to_stbox(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(0);
   STBox *result = tpoint_to_stbox(temp);
   PG_FREE_IF_COPY(temp, 0);
   PG_RETURN_STBOX_P(result);
@@ -174,7 +175,7 @@ Boxop_stbox_tnpoint(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
   STBox *box = PG_GETARG_STBOX_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(1);
   STBox box1;
   temporal_set_bbox(temp, &box1);
   bool result = func(box, &box1);
@@ -191,7 +192,7 @@ Datum
 Boxop_tnpoint_stbox(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(0);
   STBox *box = PG_GETARG_STBOX_P(1);
   STBox box1;
   temporal_set_bbox(temp, &box1);
@@ -209,8 +210,8 @@ Datum
 Boxop_tnpoint_tnpoint(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  Temporal *temp1 = PG_GETARG_TEMPORAL_SLICE(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_SLICE(1);
   STBox box1, box2;
   temporal_set_bbox(temp1, &box1);
   temporal_set_bbox(temp2, &box2);
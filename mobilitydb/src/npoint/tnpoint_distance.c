@@ -464,4 +464,87 @@ Shortestline_tnpoint_tnpoint(PG_FUNCTION_ARGS)
   PG_RETURN_GSERIALIZED_P(result);
 }
 
+/*****************************************************************************
+ * Network distance
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Network_distance_npoint_npoint(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Network_distance_npoint_npoint);
+/**
+ * @ingroup mobilitydb_temporal_dist
+ * @brief Return the network distance between two network points
+ * @sqlfn networkDistance()
+ */
+Datum
+Network_distance_npoint_npoint(PG_FUNCTION_ARGS)
+{
+  Npoint *np1 = PG_GETARG_NPOINT_P(0);
+  Npoint *np2 = PG_GETARG_NPOINT_P(1);
+  double result = npoint_network_distance(np1, np2);
+  if (result < 0)
+    PG_RETURN_NULL();
+  PG_RETURN_FLOAT8(result);
+}
+
+PGDLLEXPORT Datum Network_distance_npoint_tnpoint(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Network_distance_npoint_tnpoint);
+/**
+ * @ingroup mobilitydb_temporal_dist
+ * @brief Return the temporal network distance between a network point and a
+ * temporal network point
+ * @sqlfn networkDistance()
+ */
+Datum
+Network_distance_npoint_tnpoint(PG_FUNCTION_ARGS)
+{
+  Npoint *np = PG_GETARG_NPOINT_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Temporal *result = ndistance_tnpoint_npoint(temp, np);
+  PG_FREE_IF_COPY(temp, 1);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Network_distance_tnpoint_npoint(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Network_distance_tnpoint_npoint);
+/**
+ * @ingroup mobilitydb_temporal_dist
+ * @brief Return the temporal network distance between a temporal network
+ * point and a network point
+ * @sqlfn networkDistance()
+ */
+Datum
+Network_distance_tnpoint_npoint(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Npoint *np = PG_GETARG_NPOINT_P(1);
+  Temporal *result = ndistance_tnpoint_npoint(temp, np);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Network_distance_tnpoint_tnpoint(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Network_distance_tnpoint_tnpoint);
+/**
+ * @ingroup mobilitydb_temporal_dist
+ * @brief Return the temporal network distance between two temporal network
+ * points
+ * @sqlfn networkDistance()
+ */
+Datum
+Network_distance_tnpoint_tnpoint(PG_FUNCTION_ARGS)
+{
+  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  Temporal *result = ndistance_tnpoint_tnpoint(temp1, temp2);
+  PG_FREE_IF_COPY(temp1, 0);
+  PG_FREE_IF_COPY(temp2, 1);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 /*****************************************************************************/
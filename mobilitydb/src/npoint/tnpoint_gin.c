@@ -32,16 +32,24 @@
  * @brief GIN index for the rid of temporal network points.
 */
 
+/* C */
+#include <math.h>
 /* PostgreSQL */
 #include "postgres.h"
 #include "access/gin.h"
 #include "access/stratnum.h"
+#include "catalog/pg_statistic.h"
+#include "utils/lsyscache.h"
+#include "utils/selfuncs.h"
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
 #include "general/set.h"
 #include "general/temporal.h"
 #include "npoint/tnpoint.h"
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+#include "pg_general/span_selfuncs.h"
 
 /*****************************************************************************
  * Operator strategy numbers used in the GIN set and tnpoint opclasses
@@ -67,7 +75,8 @@ PG_FUNCTION_INFO_V1(Tnpoint_gin_extract_value);
 Datum
 Tnpoint_gin_extract_value(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  /* Values in the packed format are not unpacked */
+  Temporal *temp = (Temporal *) PG_DETOAST_DATUM(PG_GETARG_DATUM(0));
   int32 *nkeys = (int32 *) PG_GETARG_POINTER(1);
   bool **nullFlags = (bool **) PG_GETARG_POINTER(2);
   Set *routes = tnpoint_routes(temp);
@@ -121,7 +130,7 @@ Tnpoint_gin_extract_query(PG_FUNCTION_ARGS)
     case GinContainsStrategyTnpointTnpoint:
     case GinContainedStrategyTnpointTnpoint:
     case GinEqualStrategyTnpointTnpoint:
-      temp = PG_GETARG_TEMPORAL_P(0);
+      temp = (Temporal *) PG_DETOAST_DATUM(PG_GETARG_DATUM(0));
       routes = tnpoint_routes(temp);
       /* Transform the routes into Datums */
       elems = palloc(sizeof(Datum) * routes->count);
@@ -141,3 +150,218 @@ Tnpoint_gin_extract_query(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Selectivity functions for the route operators
+ *****************************************************************************/
+
+/**
+ * @brief Return the enum value associated to a route operator
+ */
+static meosOper
+tnpoint_route_oper(Oid operid)
+{
+  char *name = get_opname(operid);
+  meosOper result = UNKNOWN_OP;
+  if (! name)
+    return result;
+  if (strcmp(name, "@@") == 0)
+    result = OVERLAPS_OP;
+  else if (strcmp(name, "@?") == 0)
+    result = CONTAINS_OP;
+  else if (strcmp(name, "?@") == 0)
+    result = CONTAINED_OP;
+  else if (strcmp(name, "@=") == 0)
+    result = SAME_OP;
+  pfree(name);
+  return result;
+}
+
+/**
+ * @brief Return a default selectivity estimate for the route operators when
+ * we don't have statistics or cannot use them for some reason
+ */
+static float8
+tnpoint_route_sel_default(meosOper oper)
+{
+  switch (oper)
+  {
+    case OVERLAPS_OP:
+      return 0.005;
+    case CONTAINS_OP:
+    case CONTAINED_OP:
+      return 0.002;
+    default:
+      return 0.001;
+  }
+}
+
+/**
+ * @brief Return the routes of a constant of the route operators, or NULL if
+ * the type of the constant is not supported
+ */
+static Set *
+tnpoint_const_routes(const Const *other)
+{
+  meosType type = oid_type(other->consttype);
+  if (type == T_INT8)
+    return value_to_set(other->constvalue, T_INT8);
+  if (type == T_NPOINT)
+    return value_to_set(Int64GetDatum(DatumGetNpointP(
+      other->constvalue)->rid), T_INT8);
+  if (type == T_BIGINTSET)
+    return set_copy(DatumGetSetP(other->constvalue));
+  if (type == T_TNPOINT)
+  {
+    Temporal *temp = (Temporal *) PG_DETOAST_DATUM(other->constvalue);
+    Set *result = tnpoint_routes(temp);
+    if ((Pointer) temp != DatumGetPointer(other->constvalue))
+      pfree(temp);
+    return result;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Return the selectivity of a route operator for a temporal network
+ * point column using the most common route statistics, or -1 if the
+ * statistics are not available
+ * @param[in] vardata Structure storing statistics information
+ * @param[in] routes Routes of the constant
+ * @param[in] oper Operator, commuted so that the column is on the left
+ * @note As in array_selfuncs.c, the occurrences of the routes are assumed to
+ * be independent. For the contained operator, each value is assumed to
+ * traverse as many routes as the sum of the frequencies of the most common
+ * routes, each of them drawn according to these frequencies.
+ */
+static float8
+tnpoint_route_sel_mcelem(VariableStatData *vardata, const Set *routes,
+  meosOper oper)
+{
+  if (! HeapTupleIsValid(vardata->statsTuple))
+    return -1.0;
+
+  AttStatsSlot sslot;
+  if (! get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_MCELEM,
+      InvalidOid, ATTSTATSSLOT_VALUES | ATTSTATSSLOT_NUMBERS))
+    return -1.0;
+  if (sslot.nvalues == 0 || sslot.nnumbers != sslot.nvalues + 3)
+  {
+    free_attstatsslot(&sslot);
+    return -1.0;
+  }
+
+  /* Selectivity of containing all the routes or at least one of them */
+  float8 contains = 1.0, overlaps = 1.0, inroutes = 0.0;
+  for (int i = 0; i < routes->count; i++)
+  {
+    float8 freq = set_mcelem_freq(SET_VAL_N(routes, i), &sslot, T_INT8);
+    contains *= freq;
+    overlaps *= 1.0 - freq;
+    inroutes += freq;
+  }
+  overlaps = 1.0 - overlaps;
+
+  /* Selectivity of traversing only routes of the constant */
+  float8 contained = 0.0;
+  if (oper == CONTAINED_OP || oper == SAME_OP)
+  {
+    float8 avgroutes = 0.0;
+    for (int i = 0; i < sslot.nvalues; i++)
+      avgroutes += sslot.numbers[i];
+    avgroutes = Max(avgroutes, 1.0);
+    contained = pow(Min(inroutes / avgroutes, 1.0), avgroutes);
+  }
+  free_attstatsslot(&sslot);
+
+  switch (oper)
+  {
+    case OVERLAPS_OP:
+      return overlaps;
+    case CONTAINS_OP:
+      return contains;
+    case CONTAINED_OP:
+      return contained;
+    default: /* SAME_OP */
+      return Min(contains, contained);
+  }
+}
+
+PGDLLEXPORT Datum Tnpoint_route_sel(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tnpoint_route_sel);
+/**
+ * @brief Estimate the restriction selectivity of the route operators for
+ * temporal network points
+ */
+Datum
+Tnpoint_route_sel(PG_FUNCTION_ARGS)
+{
+  PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+  Oid operid = PG_GETARG_OID(1);
+  List *args = (List *) PG_GETARG_POINTER(2);
+  int varRelid = PG_GETARG_INT32(3);
+  VariableStatData vardata;
+  Node *other;
+  bool varonleft;
+
+  meosOper oper = tnpoint_route_oper(operid);
+  if (oper == UNKNOWN_OP)
+    PG_RETURN_FLOAT8(tnpoint_route_sel_default(oper));
+
+  /*
+   * If expression is not (variable op something) or (something op
+   * variable), then punt and return a default estimate.
+   */
+  if (! get_restriction_variable(root, args, varRelid, &vardata, &other,
+      &varonleft))
+    PG_RETURN_FLOAT8(tnpoint_route_sel_default(oper));
+
+  /*
+   * Can't do anything useful if the something is not a constant, either.
+   */
+  if (! IsA(other, Const))
+  {
+    ReleaseVariableStats(vardata);
+    PG_RETURN_FLOAT8(tnpoint_route_sel_default(oper));
+  }
+
+  /*
+   * All the route operators are strict, so we can cope with a NULL constant
+   * right away.
+   */
+  if (((Const *) other)->constisnull)
+  {
+    ReleaseVariableStats(vardata);
+    PG_RETURN_FLOAT8(0.0);
+  }
+
+  /*
+   * If var is on the right, commute the operator, so that we can assume the
+   * var is on the left in what follows.
+   */
+  if (! varonleft)
+  {
+    if (oper == CONTAINS_OP)
+      oper = CONTAINED_OP;
+    else if (oper == CONTAINED_OP)
+      oper = CONTAINS_OP;
+  }
+
+  float8 selec = -1.0;
+  if (oid_type(vardata.vartype) == T_TNPOINT)
+  {
+    Set *routes = tnpoint_const_routes((Const *) other);
+    if (routes)
+    {
+      selec = tnpoint_route_sel_mcelem(&vardata, routes, oper);
+      pfree(routes);
+    }
+  }
+  ReleaseVariableStats(vardata);
+  if (selec < 0.0)
+    selec = tnpoint_route_sel_default(oper);
+  CLAMP_PROBABILITY(selec);
+  PG_RETURN_FLOAT8(selec);
+}
+
+/*****************************************************************************/
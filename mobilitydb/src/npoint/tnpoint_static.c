@@ -38,6 +38,8 @@
 #include "npoint/tnpoint_static.h"
 
 /* PostgreSQL */
+#include <funcapi.h>
+#include <access/htup_details.h>
 #include <libpq/pqformat.h>
 /* PostGIS */
 #include <liblwgeom.h>
@@ -411,6 +413,56 @@ Nsegment_round(PG_FUNCTION_ARGS)
   PG_RETURN_NSEGMENT_P(nsegment_round(ns, size));
 }
 
+/*****************************************************************************
+ * Route cache
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Route_cache_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Route_cache_stats);
+/**
+ * @ingroup mobilitydb_temporal_accessor
+ * @brief Return the hit and miss counters and the occupancy of the route cache
+ * of the current backend
+ * @sqlfn routeCacheStats()
+ */
+Datum
+Route_cache_stats(PG_FUNCTION_ARGS)
+{
+  TupleDesc tupdesc;
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+    ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+      errmsg("function returning record called in context "
+        "that cannot accept type record")));
+  tupdesc = BlessTupleDesc(tupdesc);
+
+  int64 hits, misses;
+  int count, capacity;
+  route_cache_stats(&hits, &misses, &count, &capacity);
+  Datum values[4];
+  bool isnull[4] = {0};
+  values[0] = Int64GetDatum(hits);
+  values[1] = Int64GetDatum(misses);
+  values[2] = Int32GetDatum(count);
+  values[3] = Int32GetDatum(capacity);
+  HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+  PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+PGDLLEXPORT Datum Route_cache_reset(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Route_cache_reset);
+/**
+ * @ingroup mobilitydb_temporal_transf
+ * @brief Flush the route cache of the current backend, e.g., after updating
+ * the rows of the ways table
+ * @sqlfn routeCacheReset()
+ */
+Datum
+Route_cache_reset(PG_FUNCTION_ARGS __attribute__((unused)))
+{
+  route_cache_reset();
+  PG_RETURN_VOID();
+}
+
 /*****************************************************************************
  * Conversions between network and Euclidean space
  *****************************************************************************/
@@ -925,6 +925,40 @@ Stbox_expand_space(PG_FUNCTION_ARGS)
   PG_RETURN_STBOX_P(stbox_expand_space(box, d));
 }
 
+PGDLLEXPORT Datum Stboxarr_expand_space(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stboxarr_expand_space);
+/**
+ * @ingroup mobilitydb_box_transf
+ * @brief Return an array of spatiotemporal boxes with the space bounds of each
+ * box expanded by a double
+ * @sqlfn expandSpace()
+ */
+Datum
+Stboxarr_expand_space(PG_FUNCTION_ARGS)
+{
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+  double d = PG_GETARG_FLOAT8(1);
+  int count;
+  STBox **boxes = (STBox **) datumarr_extract(array, &count);
+  if (count == 0)
+  {
+    pfree(boxes);
+    PG_FREE_IF_COPY(array, 0);
+    PG_RETURN_NULL();
+  }
+  STBox *result = palloc(sizeof(STBox) * count);
+  for (int i = 0; i < count; i++)
+  {
+    STBox *box = stbox_expand_space(boxes[i], d);
+    result[i] = *box;
+    pfree(box);
+  }
+  ArrayType *resultarr = stboxarr_to_array(result, count);
+  pfree(boxes); pfree(result);
+  PG_FREE_IF_COPY(array, 0);
+  PG_RETURN_ARRAYTYPE_P(resultarr);
+}
+
 PGDLLEXPORT Datum Stbox_expand_time(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Stbox_expand_time);
 /**
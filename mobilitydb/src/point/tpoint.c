@@ -394,10 +394,11 @@ PG_FUNCTION_INFO_V1(Tpoint_enforce_typmod);
 Datum
 Tpoint_enforce_typmod(PG_FUNCTION_ARGS)
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  /* The value is returned in its storage format, which may be compressed */
+  Temporal *temp = (Temporal *) PG_DETOAST_DATUM(PG_GETARG_DATUM(0));
   int32 typmod = PG_GETARG_INT32(1);
   /* Check if typmod of temporal point is consistent with the supplied one */
-  temp = tpoint_valid_typmod(temp, typmod);
+  tpoint_valid_typmod(temp, typmod);
   PG_RETURN_TEMPORAL_P(temp);
 }
 
@@ -486,4 +487,29 @@ Tpoint_expand_space(PG_FUNCTION_ARGS)
   PG_RETURN_STBOX_P(result);
 }
 
+
+/*****************************************************************************
+ * Storage functions
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tpoint_quantize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_quantize);
+/**
+ * @ingroup mobilitydb_temporal_transf
+ * @brief Return a temporal point in the quantized storage format, with the
+ * coordinates rounded to a grid and stored as int32 positions in the grid
+ * @note The value is transparently converted to the standard format by every
+ * function that receives it, except those that only read its bounding box
+ * @sqlfn quantize()
+ */
+Datum
+Tpoint_quantize(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  double scale = PG_GETARG_FLOAT8(1);
+  Temporal *result = tpoint_quantize(temp, scale);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
 /*****************************************************************************/
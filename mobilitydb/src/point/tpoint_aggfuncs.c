@@ -37,11 +37,9 @@
 #include "point/tpoint_aggfuncs.h"
 
 /* C */
-#include <assert.h>
+#include <string.h>
 /* MEOS */
 #include <meos.h>
-#include "general/skiplist.h"
-#include "general/temporal_aggfuncs.h"
 #include "point/stbox.h"
 /* MobilityDB */
 #include "pg_general/skiplist.h"
@@ -83,13 +81,21 @@ PG_FUNCTION_INFO_V1(Tpoint_tcentroid_transfn);
 Datum
 Tpoint_tcentroid_transfn(PG_FUNCTION_ARGS)
 {
-  SkipList *state;
-  INPUT_AGG_TRANS_STATE(fcinfo, state);
+  TCentroidState *state = PG_ARGISNULL(0) ? NULL :
+    (TCentroidState *) PG_GETARG_POINTER(0);
+  if (PG_ARGISNULL(1))
+  {
+    if (state)
+      PG_RETURN_POINTER(state);
+    else
+      PG_RETURN_NULL();
+  }
   Temporal *temp = PG_GETARG_TEMPORAL_P(1);
-  store_fcinfo(fcinfo);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
   state = tpoint_tcentroid_transfn(state, temp);
+  unset_aggregation_context(ctx);
   PG_FREE_IF_COPY(temp, 1);
-  PG_RETURN_TEMPORAL_P(state);
+  PG_RETURN_POINTER(state);
 }
 
 /*****************************************************************************/
@@ -104,23 +110,16 @@ PG_FUNCTION_INFO_V1(Tpoint_tcentroid_combinefn);
 Datum
 Tpoint_tcentroid_combinefn(PG_FUNCTION_ARGS)
 {
-  SkipList *state1 = PG_ARGISNULL(0) ? NULL :
-    (SkipList *) PG_GETARG_POINTER(0);
-  SkipList *state2 = PG_ARGISNULL(1) ? NULL :
-    (SkipList *) PG_GETARG_POINTER(1);
-
-  store_fcinfo(fcinfo);
-  if (! ensure_geoaggstate_state(state1, state2))
-    return PointerGetDatum(NULL);
-
-  struct GeoAggregateState *extra = NULL;
-  if (state1 && state1->extra)
-    extra = state1->extra;
-  if (state2 && state2->extra)
-    extra = state2->extra;
-  assert(extra != NULL);
-  datum_func2 func = extra->hasz ? &datum_sum_double4 : &datum_sum_double3;
-  PG_RETURN_SKIPLIST_P(temporal_tagg_combinefn(state1, state2, func, false));
+  TCentroidState *state1 = PG_ARGISNULL(0) ? NULL :
+    (TCentroidState *) PG_GETARG_POINTER(0);
+  TCentroidState *state2 = PG_ARGISNULL(1) ? NULL :
+    (TCentroidState *) PG_GETARG_POINTER(1);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  TCentroidState *result = tpoint_tcentroid_combinefn(state1, state2);
+  unset_aggregation_context(ctx);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
 }
 
 /*****************************************************************************/
@@ -135,7 +134,7 @@ PG_FUNCTION_INFO_V1(Tpoint_tcentroid_finalfn);
 Datum
 Tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS)
 {
-  SkipList *state = (SkipList *) PG_GETARG_POINTER(0);
+  TCentroidState *state = (TCentroidState *) PG_GETARG_POINTER(0);
   Temporal *result = tpoint_tcentroid_finalfn(state);
   if (! result)
     PG_RETURN_NULL();
@@ -143,3 +142,41 @@ Tpoint_tcentroid_finalfn(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
+
+PGDLLEXPORT Datum Tcentroid_serialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tcentroid_serialize);
+/**
+ * @brief Serialize the state of the temporal centroid aggregation
+ */
+Datum
+Tcentroid_serialize(PG_FUNCTION_ARGS)
+{
+  TCentroidState *state = (TCentroidState *) PG_GETARG_POINTER(0);
+  size_t size = tcentroid_state_serialize_size(state);
+  bytea *result = palloc(VARHDRSZ + size);
+  SET_VARSIZE(result, VARHDRSZ + size);
+  tcentroid_state_serialize(state, VARDATA(result));
+  PG_RETURN_BYTEA_P(result);
+}
+
+PGDLLEXPORT Datum Tcentroid_deserialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tcentroid_deserialize);
+/**
+ * @brief Deserialize the state of the temporal centroid aggregation
+ */
+Datum
+Tcentroid_deserialize(PG_FUNCTION_ARGS)
+{
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  size_t size = VARSIZE(data) - VARHDRSZ;
+  /* The data of a bytea is not aligned on a double boundary */
+  char *buf = palloc(size);
+  memcpy(buf, VARDATA(data), size);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  TCentroidState *result = tcentroid_state_deserialize(buf, size);
+  unset_aggregation_context(ctx);
+  pfree(buf);
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************/
@@ -32,11 +32,18 @@
  * @brief Analytic functions for temporal points and temporal floats
  */
 
+/* PostgreSQL */
+#include <postgres.h>
+#include <utils/array.h>
+#include <utils/timestamp.h>
+#include <windowapi.h>
 /* MEOS */
 #include <meos.h>
 #include "general/temporal.h"
+#include "general/type_util.h"
 /* MobilityDB */
 #include "pg_general/temporal.h"
+#include "pg_general/type_util.h"
 
 /*****************************************************************************/
 
@@ -118,4 +125,167 @@ Temporal_simplify_dp(PG_FUNCTION_ARGS)
   PG_RETURN_TEMPORAL_P(result);
 }
 
+PGDLLEXPORT Datum Temporal_simplify_dp_weights(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_dp_weights);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return the Douglas-Peucker weights of the instants of a temporal
+ * sequence (set) float or point
+ * @sqlfn douglasPeuckerWeights()
+ */
+Datum
+Temporal_simplify_dp_weights(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  bool syncdist = true;
+  if (PG_NARGS() > 1 && ! PG_ARGISNULL(1))
+    syncdist = PG_GETARG_BOOL(1);
+  int count;
+  double *weights = temporal_simplify_dp_weights(temp, syncdist, &count);
+  Datum *values = palloc(sizeof(Datum) * count);
+  for (int i = 0; i < count; i++)
+    values[i] = Float8GetDatum(weights[i]);
+  ArrayType *result = datumarr_to_array(values, count, T_FLOAT8);
+  pfree(values); pfree(weights);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_ARRAYTYPE_P(result);
+}
+
+PGDLLEXPORT Datum Temporal_simplify_dp_select(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_dp_select);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return a temporal sequence (set) float or point simplified using a
+ * Douglas-Peucker line simplification algorithm from the weights of its
+ * instants
+ * @sqlfn douglasPeuckerSimplify()
+ */
+Datum
+Temporal_simplify_dp_select(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
+  double dist = PG_GETARG_FLOAT8(2);
+  int count;
+  Datum *values = datumarr_extract(array, &count);
+  double *weights = palloc(sizeof(double) * count);
+  for (int i = 0; i < count; i++)
+    weights[i] = DatumGetFloat8(values[i]);
+  Temporal *result = temporal_simplify_dp_select(temp, weights, count, dist);
+  pfree(values); pfree(weights);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(array, 1);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+PGDLLEXPORT Datum Temporal_simplify_npoints(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Temporal_simplify_npoints);
+/**
+ * @ingroup mobilitydb_temporal_analytics_simplify
+ * @brief Return a temporal sequence (set) float or point simplified to a
+ * number of instants by removing the less important instants first
+ * @sqlfn numPointsSimplify()
+ */
+Datum
+Temporal_simplify_npoints(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  int npoints = PG_GETARG_INT32(1);
+  bool syncdist = true;
+  if (PG_NARGS() > 2 && ! PG_ARGISNULL(2))
+    syncdist = PG_GETARG_BOOL(2);
+  Temporal *result = temporal_simplify_npoints(temp, npoints, syncdist);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
+}
+
+
+/*****************************************************************************
+ * Clustering functions
+ *****************************************************************************/
+
+/**
+ * @brief Structure to keep in the memory of a window partition the cluster
+ * numbers of its rows
+ */
+typedef struct
+{
+  bool done;        /**< True when the clusters have been computed */
+  int clusters[1];  /**< Cluster number of each row, -1 for noise */
+} StdbscanState;
+
+PGDLLEXPORT Datum Tpoint_stdbscan(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_stdbscan);
+/**
+ * @ingroup mobilitydb_temporal_analytics_cluster
+ * @brief Window function returning the cluster number of the temporal points
+ * of a window partition using the ST-DBSCAN algorithm
+ * @details The clusters are computed for the whole partition when the
+ * function is called for its first row and kept in the memory of the
+ * partition for the next rows. The rows with a null temporal point or that
+ * are not in a cluster return null.
+ * @sqlfn stdbscan()
+ */
+Datum
+Tpoint_stdbscan(PG_FUNCTION_ARGS)
+{
+  WindowObject winobj = PG_WINDOW_OBJECT();
+  int64 row = WinGetCurrentPosition(winobj);
+  int64 nrows = WinGetPartitionRowCount(winobj);
+  StdbscanState *state = WinGetPartitionLocalMemory(winobj,
+    sizeof(StdbscanState) + sizeof(int) * nrows);
+
+  /* Compute the clusters of the partition at its first row */
+  if (! state->done)
+  {
+    bool isnull;
+    Datum eps_space = WinGetFuncArgCurrent(winobj, 1, &isnull);
+    if (isnull || DatumGetFloat8(eps_space) < 0.0)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The spatial distance must be a non-negative number")));
+    Datum eps_time = WinGetFuncArgCurrent(winobj, 2, &isnull);
+    if (isnull)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The temporal distance must be a positive interval")));
+    Datum minpts = WinGetFuncArgCurrent(winobj, 3, &isnull);
+    if (isnull || DatumGetInt32(minpts) < 1)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The minimum number of points must be a positive integer")));
+
+    /* Collect the non-null temporal points of the partition */
+    Temporal **temparr = palloc(sizeof(Temporal *) * nrows);
+    int *rows = palloc(sizeof(int) * nrows);
+    int count = 0;
+    for (int64 i = 0; i < nrows; i++)
+    {
+      bool isout;
+      Datum value = WinGetFuncArgInPartition(winobj, 0, (int) i,
+        WINDOW_SEEK_HEAD, false, &isnull, &isout);
+      state->clusters[i] = -1;
+      if (isnull)
+        continue;
+      /* The value must be copied since the tuple slot is reused */
+      temparr[count] = (Temporal *) PG_DETOAST_DATUM_COPY(value);
+      rows[count++] = (int) i;
+    }
+    if (count > 0)
+    {
+      int nclusters;
+      int *clusters = tpointarr_stdbscan((const Temporal **) temparr, count,
+        DatumGetFloat8(eps_space), DatumGetIntervalP(eps_time),
+        DatumGetInt32(minpts), &nclusters);
+      for (int i = 0; i < count; i++)
+        state->clusters[rows[i]] = clusters[i];
+      pfree(clusters);
+    }
+    pfree_array((void **) temparr, count);
+    pfree(rows);
+    state->done = true;
+  }
+
+  if (state->clusters[row] < 0)
+    PG_RETURN_NULL();
+  PG_RETURN_INT32(state->clusters[row]);
+}
+
 /*****************************************************************************/
@@ -50,6 +50,14 @@
  *
  * For the time dimension, the statistics collected in Slots 3 and 4 depend on
  * the subtype. Please refer to file temporal_analyze.c for more information.
+ *
+ * For planar temporal points, a joint space-time histogram is optionally
+ * collected when the `mobilitydb.spacetime_histogram_size` parameter is
+ * greater than zero.
+ * - Slot 5
+ *     - `stakind` contains the type of statistics which is `STATISTIC_SLOT_NDT`.
+ *     - `stanumbers` stores the (X, Y, T) histogram of occurrence of features,
+ *       where the time dimension is expressed in seconds.
  */
 
 #include "pg_point/tpoint_analyze.h"
@@ -63,6 +71,7 @@
 #if POSTGRESQL_VERSION_NUMBER >= 160000
   #include "varatt.h"
 #endif
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -71,6 +80,7 @@
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
 #include "pg_general/span_analyze.h"
+#include "pg_general/temporal.h"
 #include "pg_general/temporal_analyze.h"
 
 /*****************************************************************************
@@ -89,8 +99,16 @@
  */
 #define STATISTIC_KIND_ND 102
 #define STATISTIC_KIND_2D 103
+#define STATISTIC_KIND_NDT 104
 #define STATISTIC_SLOT_ND 0
 #define STATISTIC_SLOT_2D 1
+#define STATISTIC_SLOT_NDT 4
+
+/**
+ * @brief Global variable stating the number of cells on each side of the
+ * joint space-time histogram, 0 meaning that the histogram is not collected
+ */
+int MOBDB_SPACETIME_HISTOGRAM_SIZE = 0;
 
 /**
  * @brief The SD factor restricts the side of the statistics histogram
@@ -611,11 +629,11 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     }
     else /* tspatial_type(type) */
     {
-      /* Get bounding box from temporal point */
-      Temporal *temp = DatumGetTemporalP(datum);
+      /* Get bounding box from the header of the temporal point */
+      Temporal *temp = temporal_slice(datum);
       temporal_set_bbox(temp, &box);
-      /* Free up memory if our temporal point was copied */
-      if (VARATT_IS_EXTENDED(temp))
+      /* Free up memory if the header was copied */
+      if ((Pointer) temp != DatumGetPointer(datum))
         pfree(temp);
     }
 
@@ -625,6 +643,18 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* If we're in 2D mode, zero out the higher dimensions for "safety" */
     if (mode == 2)
       gbox.zmin = gbox.zmax = gbox.mmin = gbox.mmax = 0.0;
+    /* If we're in space-time mode, put the time extent in seconds into the
+     * M dimension in place of the Z dimension */
+    else if (mode == 3)
+    {
+      gbox.zmin = gbox.zmax = 0.0;
+      FLAGS_SET_Z(gbox.flags, false);
+      gbox.mmin = (double) DatumGetTimestampTz(box.period.lower) /
+        USECS_PER_SEC;
+      gbox.mmax = (double) DatumGetTimestampTz(box.period.upper) /
+        USECS_PER_SEC;
+      FLAGS_SET_M(gbox.flags, true);
+    }
 
     /* Check bounds for validity (finite and not NaN) */
     if (! gbox_is_valid(&gbox))
@@ -674,14 +704,21 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
    * Also, if we're sampling a relatively small table, we'll try to ensure that
    * we have an average of 5 features for each cell so the histogram isn't
    * so sparse.
+   * In space-time mode the number of cells on each side is given by the
+   * `mobilitydb.spacetime_histogram_size` parameter instead.
    */
+  if (mode == 3)
+    histo_cells_target = (int) pow((double) MOBDB_SPACETIME_HISTOGRAM_SIZE,
+      (double) ndims);
+  else
 #if POSTGRESQL_VERSION_NUMBER >= 170000
   histo_cells_target = (int) pow((double) (stats->attstattarget),
 #else
   histo_cells_target = (int) pow((double) (stats->attr->attstattarget),
 #endif
     (double) ndims);
-  histo_cells_target = Min(histo_cells_target, ndims * 10000);
+  if (mode != 3)
+    histo_cells_target = Min(histo_cells_target, ndims * 10000);
   histo_cells_target = Min(histo_cells_target, (int)(total_rows/5));
 
   /*
@@ -939,6 +976,11 @@ gserialized_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     stats_slot = STATISTIC_SLOT_2D;
     stats_kind = STATISTIC_KIND_2D;
   }
+  else if (mode == 3)
+  {
+    stats_slot = STATISTIC_SLOT_NDT;
+    stats_kind = STATISTIC_KIND_NDT;
+  }
   else
   {
     stats_slot = STATISTIC_SLOT_ND;
@@ -1070,11 +1112,12 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
       continue;
     }
 
-    /* Get temporal point */
-    Temporal *temp = DatumGetTemporalP(value);
-
     /* How many bytes does this sample use? */
-    total_width += VARSIZE(temp);
+    total_width += VARSIZE_ANY(DatumGetPointer(value));
+
+    /* Get the header of the temporal point, which contains the bounding box,
+     * without detoasting nor decompressing the instants */
+    Temporal *temp = temporal_slice(value);
 
     /* Get period from temporal point */
     Span period;
@@ -1091,8 +1134,8 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* Increment our "good feature" count */
     notnull_cnt++;
 
-    /* Free up memory if our sample temporal point was copied */
-    if (VARATT_IS_EXTENDED(temp))
+    /* Free up memory if the header was copied */
+    if ((Pointer) temp != DatumGetPointer(value))
       pfree(temp);
 
     /* Give backend a chance of interrupting us */
@@ -1119,6 +1162,17 @@ tpoint_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
     /* Last argument is false to compute statistics for time dimension */
     span_compute_stats_generic(stats, notnull_cnt, &slot_idx, time_lowers,
       time_uppers, time_lengths, false);
+
+    /* Space-time mode, not available for geodetic points whose ND_BOX
+     * already uses the three dimensions of the unit sphere. The histogram is
+     * optional and thus its failure must not invalidate the other slots */
+    if (MOBDB_SPACETIME_HISTOGRAM_SIZE > 0 &&
+        oid_type(stats->attrtypid) != T_TGEOGPOINT)
+    {
+      bool stats_valid = stats->stats_valid;
+      gserialized_compute_stats(stats, fetchfunc, sample_rows, total_rows, 3);
+      stats->stats_valid = stats_valid;
+    }
   }
   else if (null_cnt > 0)
   {
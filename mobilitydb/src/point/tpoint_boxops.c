@@ -50,8 +50,9 @@
 #include "general/temporal.h"
 #include "point/stbox.h"
 /* MobilityDB */
-#include "pg_point/postgis.h"
+#include "pg_general/temporal.h"
 #include "pg_general/type_util.h"
+#include "pg_point/postgis.h"
 
 /*****************************************************************************
  * Boxes function
@@ -121,7 +122,7 @@ Boxop_stbox_tpoint(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
   STBox *box = PG_GETARG_STBOX_P(0);
-  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(1);
   bool result = boxop_tpoint_stbox(temp, box, func, INVERT);
   PG_FREE_IF_COPY(temp, 1);
   PG_RETURN_BOOL(result);
@@ -137,7 +138,7 @@ Datum
 Boxop_tpoint_stbox(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
-  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(0);
   STBox *box = PG_GETARG_STBOX_P(1);
   bool result = boxop_tpoint_stbox(temp, box, func, INVERT_NO);
   PG_FREE_IF_COPY(temp, 0);
@@ -153,8 +154,8 @@ Datum
 Boxop_tpoint_tpoint(FunctionCallInfo fcinfo,
   bool (*func)(const STBox *, const STBox *))
 {
-  Temporal *temp1 = PG_GETARG_TEMPORAL_P(0);
-  Temporal *temp2 = PG_GETARG_TEMPORAL_P(1);
+  Temporal *temp1 = PG_GETARG_TEMPORAL_SLICE(0);
+  Temporal *temp2 = PG_GETARG_TEMPORAL_SLICE(1);
   bool result = boxop_tpoint_tpoint(temp1, temp2, func);
   PG_FREE_IF_COPY(temp1, 0);
   PG_FREE_IF_COPY(temp2, 1);
@@ -195,6 +196,41 @@ Overlaps_tpoint_stbox(PG_FUNCTION_ARGS)
   return Boxop_tpoint_stbox(fcinfo, &overlaps_stbox_stbox);
 }
 
+PGDLLEXPORT Datum Overlaps_tpoint_stboxarr(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Overlaps_tpoint_stboxarr);
+/**
+ * @ingroup mobilitydb_temporal_bbox_topo
+ * @brief Return true if the spatiotemporal box of a temporal point overlaps
+ * any box of an array of spatiotemporal boxes
+ * @details This operator is used in the index conditions generated by the
+ * support function of the "within distance" functions
+ * @sqlfn overlaps_bbox()
+ * @sqlop @p &&
+ */
+Datum
+Overlaps_tpoint_stboxarr(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_SLICE(0);
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
+  int count;
+  STBox **boxes = (STBox **) datumarr_extract(array, &count);
+  STBox box;
+  temporal_set_bbox(temp, &box);
+  bool result = false;
+  for (int i = 0; i < count; i++)
+  {
+    if (overlaps_stbox_stbox(&box, boxes[i]))
+    {
+      result = true;
+      break;
+    }
+  }
+  pfree(boxes);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(array, 1);
+  PG_RETURN_BOOL(result);
+}
+
 PGDLLEXPORT Datum Overlaps_tpoint_tpoint(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Overlaps_tpoint_tpoint);
 /**
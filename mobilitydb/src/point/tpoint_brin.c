@@ -0,0 +1,153 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief BRIN indexes for spatiotemporal boxes and temporal points
+ */
+
+/* PostgreSQL */
+#include <postgres.h>
+#include <access/stratnum.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+#include "point/stbox.h"
+/* MobilityDB */
+#include "pg_general/temporal.h"
+#include "pg_general/temporal_brin.h"
+#include "pg_point/tpoint_gist.h"
+
+/*****************************************************************************
+ * Callback functions
+ *****************************************************************************/
+
+/**
+ * @brief Set the box from a spatiotemporal box
+ */
+static void
+stbox_brin_set_stbox(Datum value, void *result)
+{
+  memcpy(result, DatumGetSTboxP(value), sizeof(STBox));
+  return;
+}
+
+/**
+ * @brief Set the box from a temporal point
+ */
+static void
+tspatial_brin_set_stbox(Datum value, void *result)
+{
+  tspatial_set_stbox(temporal_slice(value), (STBox *) result);
+  return;
+}
+
+/**
+ * @brief Transform the query into a spatiotemporal box
+ */
+static bool
+stbox_brin_get_query(Datum value, meosType type, void *result)
+{
+  return tspatial_index_get_stbox(value, type, (STBox *) result);
+}
+
+/**
+ * @brief Consistent function for spatiotemporal boxes
+ */
+static bool
+stbox_brin_consistent(const void *key, const void *query,
+  StrategyNumber strategy)
+{
+  return stbox_gist_consistent((const STBox *) key, (const STBox *) query,
+    strategy);
+}
+
+/*****************************************************************************
+ * BRIN methods
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Stbox_brin_opcinfo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_opcinfo);
+/**
+ * @brief BRIN opcinfo method for spatiotemporal boxes
+ */
+Datum
+Stbox_brin_opcinfo(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_opcinfo(T_STBOX);
+}
+
+PGDLLEXPORT Datum Stbox_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_add_value);
+/**
+ * @brief BRIN add value method for spatiotemporal boxes
+ */
+Datum
+Stbox_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, T_STBOX, &stbox_brin_set_stbox,
+    &stbox_adjust);
+}
+
+PGDLLEXPORT Datum Tspatial_brin_add_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tspatial_brin_add_value);
+/**
+ * @brief BRIN add value method for temporal points
+ */
+Datum
+Tspatial_brin_add_value(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_add_value(fcinfo, T_STBOX, &tspatial_brin_set_stbox,
+    &stbox_adjust);
+}
+
+PGDLLEXPORT Datum Stbox_brin_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_consistent);
+/**
+ * @brief BRIN consistent method for spatiotemporal boxes
+ */
+Datum
+Stbox_brin_consistent(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_consistent(fcinfo, T_STBOX, &stbox_brin_get_query,
+    &stbox_brin_consistent);
+}
+
+PGDLLEXPORT Datum Stbox_brin_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_brin_union);
+/**
+ * @brief BRIN union method for spatiotemporal boxes
+ */
+Datum
+Stbox_brin_union(PG_FUNCTION_ARGS)
+{
+  return bbox_brin_union(fcinfo, T_STBOX, &stbox_adjust);
+}
+
+/*****************************************************************************/
@@ -37,9 +37,12 @@
 #include <float.h>
 /* PostgreSQL */
 #include <postgres.h>
+#include <utils/memutils.h>
+#include <windowapi.h>
 /* MEOS */
 #include <meos.h>
 #include "general/temporal.h"
+#include "general/type_util.h"
 #include "point/stbox.h"
 /* MobilityDB */
 #include "pg_point/postgis.h"
@@ -423,3 +426,101 @@ Shortestline_tpoint_tpoint(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Continuous k nearest neighbours
+ *****************************************************************************/
+
+/**
+ * @brief Structure to keep in the memory of a window partition the periods
+ * during which the temporal points of its rows are among the k nearest ones
+ */
+typedef struct
+{
+  bool done;           /**< True when the periods have been computed */
+  SpanSet **periods;   /**< Periods of each row, NULL if never a neighbour */
+} KNNState;
+
+PGDLLEXPORT Datum Tpoint_knn_periods(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_knn_periods);
+/**
+ * @ingroup mobilitydb_temporal_dist
+ * @brief Window function returning the periods during which the temporal
+ * point of a row is among the k nearest temporal points of its window
+ * partition to a reference temporal point
+ * @details The reference temporal point is taken from the first row of the
+ * partition, typically the outer side of a join whose inner candidates are
+ * fetched by an index, e.g., with `t2.trip && expandSpace(t1.trip, d)` and
+ * `PARTITION BY t1.id`. The periods are computed for the whole partition when
+ * the function is called for its first row and kept in the memory of the
+ * partition for the next rows.
+ * @sqlfn knnPeriods()
+ */
+Datum
+Tpoint_knn_periods(PG_FUNCTION_ARGS)
+{
+  WindowObject winobj = PG_WINDOW_OBJECT();
+  int64 row = WinGetCurrentPosition(winobj);
+  int64 nrows = WinGetPartitionRowCount(winobj);
+  KNNState *state = WinGetPartitionLocalMemory(winobj, sizeof(KNNState));
+
+  /* Compute the periods of the partition at its first row */
+  if (! state->done)
+  {
+    bool isnull, isout;
+    Datum k = WinGetFuncArgCurrent(winobj, 2, &isnull);
+    if (isnull || DatumGetInt32(k) < 1)
+      ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+        errmsg("The number of neighbours must be a positive integer")));
+    Datum ref = WinGetFuncArgInPartition(winobj, 1, 0, WINDOW_SEEK_HEAD,
+      false, &isnull, &isout);
+    /* The periods are kept in the memory context of the partition */
+    MemoryContext oldctx = MemoryContextSwitchTo(
+      GetMemoryChunkContext(state));
+    state->periods = palloc0(sizeof(SpanSet *) * nrows);
+    MemoryContextSwitchTo(oldctx);
+    if (! isnull)
+    {
+      /* The values must be copied since the tuple slot is reused */
+      Temporal *temp = (Temporal *) PG_DETOAST_DATUM_COPY(ref);
+      Temporal **temparr = palloc(sizeof(Temporal *) * nrows);
+      int *rows = palloc(sizeof(int) * nrows);
+      int count = 0;
+      for (int64 i = 0; i < nrows; i++)
+      {
+        Datum value = WinGetFuncArgInPartition(winobj, 0, (int) i,
+          WINDOW_SEEK_HEAD, false, &isnull, &isout);
+        if (isnull)
+          continue;
+        temparr[count] = (Temporal *) PG_DETOAST_DATUM_COPY(value);
+        rows[count++] = (int) i;
+      }
+      if (count > 0)
+      {
+        SpanSet **periods = tpointarr_knn(temp, (const Temporal **) temparr,
+          count, DatumGetInt32(k));
+        oldctx = MemoryContextSwitchTo(GetMemoryChunkContext(state));
+        for (int i = 0; i < count; i++)
+        {
+          if (periods[i])
+          {
+            state->periods[rows[i]] = spanset_copy(periods[i]);
+            pfree(periods[i]);
+          }
+        }
+        MemoryContextSwitchTo(oldctx);
+        pfree(periods);
+      }
+      pfree_array((void **) temparr, count);
+      pfree(rows);
+      pfree(temp);
+    }
+    state->done = true;
+  }
+
+  if (! state->periods[row])
+    PG_RETURN_NULL();
+  PG_RETURN_SPANSET_P(spanset_copy(state->periods[row]));
+}
+
+/*****************************************************************************/
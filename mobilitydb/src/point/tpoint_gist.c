@@ -35,22 +35,34 @@
 #include "pg_point/tpoint_gist.h"
 
 /* C */
+#include <assert.h>
 #include <float.h>
+#include <math.h>
 /* PostgreSQL */
 #include <postgres.h>
 #include <access/gist.h>
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+  #include <access/reloptions.h>
+#endif
+#include <utils/array.h>
 #include <utils/float.h>
+#include <utils/lsyscache.h>
 #include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/meos_probes.h"
+#include "general/set.h"
 #include "general/span.h"
+#include "general/type_out.h"
 #include "general/type_util.h"
 #include "point/stbox.h"
 /* MobilityDB */
 #include "pg_general/meos_catalog.h"
+#include "pg_general/span_gist.h"
 #include "pg_general/temporal.h"
 #include "pg_general/tnumber_gist.h"
+#include "pg_general/type_util.h"
 
 /*****************************************************************************
  * GiST consistent methods
@@ -161,7 +173,7 @@ stbox_index_consistent_leaf(const STBox *key, const STBox *query,
  * @param[in] query Value being looked up in the index
  * @param[in] strategy Operator of the operator class being applied
  */
-static bool
+bool
 stbox_gist_consistent(const STBox *key, const STBox *query,
   StrategyNumber strategy)
 {
@@ -268,30 +280,42 @@ tpoint_index_recheck(StrategyNumber strategy)
 }
 
 /**
- * @brief Transform the query argument into a box initializing the dimensions
- * that must not be taken into account by the operators to infinity.
+ * @brief Transform a query value into a box initializing the dimensions
+ * that must not be taken into account by the operators to infinity
+ * @param[in] value Query value
+ * @param[in] type Type of the query value
+ * @param[out] result Resulting box
+ * @note This function is used for both GiST and BRIN indexes
  */
-static bool
-tpoint_gist_get_stbox(FunctionCallInfo fcinfo, STBox *result, meosType type)
+bool
+tspatial_index_get_stbox(Datum value, meosType type, STBox *result)
 {
   if (type == T_TSTZSPAN)
   {
-    Span *s = PG_GETARG_SPAN_P(1);
+    Span *s = DatumGetSpanP(value);
     tstzspan_set_stbox(s, result);
   }
   else if (type == T_STBOX)
   {
-    STBox *box = PG_GETARG_STBOX_P(1);
+    STBox *box = DatumGetSTboxP(value);
     if (box == NULL)
       return false;
     memcpy(result, box, sizeof(STBox));
   }
-  else if (tspatial_type(type))
+  else if (geo_basetype(type))
   {
-    if (PG_ARGISNULL(1))
+    /* An empty geometry does not have a box */
+    if (! geo_set_stbox(DatumGetGserializedP(value), result))
       return false;
-    Datum tempdatum = PG_GETARG_DATUM(1);
-    Temporal *temp = temporal_slice(tempdatum);
+  }
+  else if (spatialset_type(type))
+  {
+    Set *set = DatumGetSetP(value);
+    spatialset_set_stbox(set, result);
+  }
+  else if (tspatial_type(type))
+  {
+    Temporal *temp = temporal_slice(value);
     tspatial_set_stbox(temp, result);
   }
   else
@@ -299,6 +323,51 @@ tpoint_gist_get_stbox(FunctionCallInfo fcinfo, STBox *result, meosType type)
   return true;
 }
 
+/**
+ * @brief Transform the query argument into a box initializing the dimensions
+ * that must not be taken into account by the operators to infinity.
+ */
+static bool
+tpoint_gist_get_stbox(FunctionCallInfo fcinfo, STBox *result, meosType type)
+{
+  if (PG_ARGISNULL(1))
+    return false;
+  return tspatial_index_get_stbox(PG_GETARG_DATUM(1), type, result);
+}
+
+/**
+ * @brief Return the boxes of the query argument when it is an array of
+ * spatiotemporal boxes, or @p NULL otherwise
+ * @details Such queries are built by the support function of the "within
+ * distance" functions, which split the non-indexed temporal point into
+ * several boxes expanded by the distance. They are only used with the
+ * overlaps operator.
+ */
+static const STBox *
+tpoint_gist_get_stboxes(FunctionCallInfo fcinfo, Oid typid, int *count)
+{
+  if (PG_ARGISNULL(1) || oid_type(typid) != T_UNKNOWN ||
+      get_element_type(typid) != type_oid(T_STBOX))
+    return NULL;
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
+  *count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+  return (const STBox *) ARR_DATA_PTR(array);
+}
+
+/**
+ * @brief Return true if a box overlaps any box of an array
+ */
+static bool
+stbox_overlaps_any(const STBox *box, const STBox *boxes, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    if (overlaps_stbox_stbox(box, &boxes[i]))
+      return true;
+  }
+  return false;
+}
+
 PGDLLEXPORT Datum Stbox_gist_consistent(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Stbox_gist_consistent);
 /**
@@ -315,19 +384,37 @@ Stbox_gist_consistent(PG_FUNCTION_ARGS)
 
   /* Determine whether the index is lossy depending on the strategy */
   *recheck = tpoint_index_recheck(strategy);
+  MEOS_STAT_ADD(MEOS_STAT_INDEX_CONSISTENT, 1);
 
   if (key == NULL)
     PG_RETURN_BOOL(false);
 
+  /* Test the key against each box of a multi-box query */
+  int count;
+  const STBox *boxes = tpoint_gist_get_stboxes(fcinfo, typid, &count);
+  if (boxes)
+  {
+    assert(strategy == RTOverlapStrategyNumber);
+    result = stbox_overlaps_any(key, boxes, count);
+    if (result && GIST_LEAF(entry))
+      MEOS_STAT_ADD(MEOS_STAT_INDEX_RECHECKS, 1);
+    PG_RETURN_BOOL(result);
+  }
+
   /* Transform the query into a box */
   if (! tpoint_gist_get_stbox(fcinfo, &query, oid_type(typid)))
     PG_RETURN_BOOL(false);
 
   if (GIST_LEAF(entry))
+  {
     result = stbox_index_consistent_leaf(key, &query, strategy);
+    if (result && *recheck)
+      MEOS_STAT_ADD(MEOS_STAT_INDEX_RECHECKS, 1);
+  }
   else
     result = stbox_gist_consistent(key, &query, strategy);
 
+  MEOS_PROBE_INDEX_GIST_CONSISTENT(GIST_LEAF(entry), strategy, result);
   PG_RETURN_BOOL(result);
 }
 
@@ -402,6 +489,27 @@ Tpoint_gist_compress(PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(entry);
 }
 
+PGDLLEXPORT Datum Spatialset_gist_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spatialset_gist_compress);
+/**
+ * @brief GiST compress method for spatial sets
+ */
+Datum
+Spatialset_gist_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  if (entry->leafkey)
+  {
+    GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+    STBox *box = palloc(sizeof(STBox));
+    spatialset_set_stbox(DatumGetSetP(entry->key), box);
+    gistentryinit(*retval, PointerGetDatum(box), entry->rel, entry->page,
+      entry->offset, false);
+    PG_RETURN_POINTER(retval);
+  }
+  PG_RETURN_POINTER(entry);
+}
+
 /*****************************************************************************
  * GiST penalty method
  *****************************************************************************/
@@ -415,6 +523,9 @@ static void
 stbox_union_rt(const STBox *a, const STBox *b, STBox *new)
 {
   memset(new, 0, sizeof(STBox));
+  /* The flags are needed to compute the size of the union */
+  new->flags = a->flags;
+  new->srid = a->srid;
   new->xmin = FLOAT8_MIN(a->xmin, b->xmin);
   new->xmax = FLOAT8_MAX(a->xmax, b->xmax);
   new->ymin = FLOAT8_MIN(a->ymin, b->ymin);
@@ -435,7 +546,7 @@ stbox_union_rt(const STBox *a, const STBox *b, STBox *new)
  * purposes
  * @note The result can be +Infinity, but not NaN
  */
-static double
+double
 stbox_size(const STBox *box)
 {
   double result_size = 1;
@@ -470,11 +581,11 @@ stbox_size(const STBox *box)
   {
     result_size *= (box->xmax - box->xmin) * (box->ymax - box->ymin);
     if (hasz)
-      result_size *= (box->xmax - box->xmin) * (box->ymax - box->ymin);
+      result_size *= box->zmax - box->zmin;
   }
   if (hast)
     /* Expressed in seconds */
-    result_size *= (DatumGetTimestampTz(box->period.upper) -
+    result_size *= (double) (DatumGetTimestampTz(box->period.upper) -
       DatumGetTimestampTz(box->period.lower)) / USECS_PER_SEC;
   return result_size;
 }
@@ -494,11 +605,80 @@ stbox_penalty(void *bbox1, void *bbox2)
   return stbox_size(&unionbox) - stbox_size(original);
 }
 
+/**
+ * @brief Return the enlargement of the extents of a spatiotemporal box
+ * needed to include another one, where the enlargement along each dimension
+ * is relative to the extent of the union along it
+ * @details Since the result does not depend on the units of the dimensions
+ * it is used as penalty when the volume is not enlarged, e.g., for boxes
+ * of instants that have no volume
+ */
+static double
+stbox_margin_penalty(const STBox *original, const STBox *new)
+{
+  STBox unionbox;
+  stbox_union_rt(original, new, &unionbox);
+  double extent[4], union_extent[4];
+  int ndims = 0;
+  if (MEOS_FLAGS_GET_X(original->flags))
+  {
+    extent[ndims] = original->xmax - original->xmin;
+    union_extent[ndims++] = unionbox.xmax - unionbox.xmin;
+    extent[ndims] = original->ymax - original->ymin;
+    union_extent[ndims++] = unionbox.ymax - unionbox.ymin;
+    if (MEOS_FLAGS_GET_Z(original->flags))
+    {
+      extent[ndims] = original->zmax - original->zmin;
+      union_extent[ndims++] = unionbox.zmax - unionbox.zmin;
+    }
+  }
+  if (MEOS_FLAGS_GET_T(original->flags))
+  {
+    extent[ndims] = (double) (DatumGetTimestampTz(original->period.upper) -
+      DatumGetTimestampTz(original->period.lower));
+    union_extent[ndims++] = (double) (
+      DatumGetTimestampTz(unionbox.period.upper) -
+      DatumGetTimestampTz(unionbox.period.lower));
+  }
+  double result = 0.0;
+  for (int i = 0; i < ndims; i++)
+  {
+    if (union_extent[i] > 0.0 && ! isinf(union_extent[i]))
+      result += (union_extent[i] - extent[i]) / union_extent[i];
+  }
+  return result;
+}
+
+/**
+ * @brief Pack a non-negative penalty value into a float whose highest bit
+ * after the sign states its realm, so that any value of realm 1 is larger
+ * than any value of realm 0
+ * @note Borrowed from PostGIS file gserialized_gist_2d.c
+ */
+static float
+pack_float(float value, uint8 realm)
+{
+  union
+  {
+    float f;
+    struct { unsigned value:31, sign:1; } vbits;
+    struct { unsigned value:30, realm:1, sign:1; } rbits;
+  } a;
+  a.f = value;
+  a.rbits.value = a.vbits.value >> 1;
+  a.rbits.realm = realm;
+  return a.f;
+}
+
 PGDLLEXPORT Datum Stbox_gist_penalty(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Stbox_gist_penalty);
 /**
  * @brief GiST penalty method for temporal points
- * @note As in the R-tree paper, we use change in area as our penalty metric
+ * @note As in the R-tree paper, we use change in volume as our penalty
+ * metric. When the volume is not enlarged, in particular for boxes without
+ * volume, the relative enlargement of the extents is used instead as in the
+ * R*-tree. Both metrics are packed into different realms so that any
+ * enlargement of the volume is worse than any enlargement of the extents.
  */
 Datum
 Stbox_gist_penalty(PG_FUNCTION_ARGS)
@@ -506,9 +686,13 @@ Stbox_gist_penalty(PG_FUNCTION_ARGS)
   GISTENTRY *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
   GISTENTRY *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
   float *result = (float *) PG_GETARG_POINTER(2);
-  void *origstbox = (STBox *) DatumGetPointer(origentry->key);
-  void *newbox = (STBox *) DatumGetPointer(newentry->key);
-  *result = (float) stbox_penalty(origstbox, newbox);
+  STBox *origstbox = (STBox *) DatumGetPointer(origentry->key);
+  STBox *newbox = (STBox *) DatumGetPointer(newentry->key);
+  double penalty = stbox_penalty(origstbox, newbox);
+  if (penalty > 0.0)
+    *result = pack_float((float) penalty, 1);
+  else
+    *result = pack_float((float) stbox_margin_penalty(origstbox, newbox), 0);
   PG_RETURN_POINTER(result);
 }
 
@@ -616,4 +800,732 @@ Stbox_gist_distance(PG_FUNCTION_ARGS)
   PG_RETURN_FLOAT8(distance);
 }
 
+/*****************************************************************************
+ * GiST fetch method
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Stbox_gist_fetch(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_gist_fetch);
+/**
+ * @brief GiST fetch method for spatiotemporal boxes, which enables index-only
+ * scans for indexes on spatiotemporal boxes, including expression indexes
+ * such as those on stbox(temp)
+ */
+Datum
+Stbox_gist_fetch(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  PG_RETURN_POINTER(entry);
+}
+
+/*****************************************************************************
+ * GiST sortsupport method
+ *****************************************************************************/
+
+/**
+ * @brief Return the sort key of a spatiotemporal box, which is the Hilbert
+ * index of its center
+ */
+static uint64
+stbox_sort_key(Datum value)
+{
+  const STBox *box = DatumGetSTboxP(value);
+  double coords[4];
+  int ndims = 0;
+  if (MEOS_FLAGS_GET_X(box->flags))
+  {
+    coords[ndims++] = (box->xmin + box->xmax) / 2.0;
+    coords[ndims++] = (box->ymin + box->ymax) / 2.0;
+    if (MEOS_FLAGS_GET_Z(box->flags))
+      coords[ndims++] = (box->zmin + box->zmax) / 2.0;
+  }
+  if (MEOS_FLAGS_GET_T(box->flags))
+    coords[ndims++] = span_center_double(&box->period);
+  return bbox_sort_hilbert_key(coords, ndims);
+}
+
+PGDLLEXPORT Datum Stbox_gist_sortsupport(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_gist_sortsupport);
+/**
+ * @brief GiST sortsupport method for spatiotemporal boxes
+ */
+Datum
+Stbox_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+  return bbox_gist_sortsupport(fcinfo, &stbox_sort_key);
+}
+
+/*****************************************************************************
+ * Lossy GiST methods with float4 keys
+ *
+ * The keys are STBox4 values, which take less than half of the space of an
+ * STBox. The decompress method transforms them back into STBox values, so
+ * that the union, penalty, picksplit, and same methods of the stbox opclass
+ * are reused. Since the keys are larger than the original boxes, the leaf
+ * entries are tested as internal ones and the result is always rechecked.
+ *****************************************************************************/
+
+/**
+ * @brief Return the largest float less than or equal to a double
+ */
+static float
+float_round_down(double d)
+{
+  float result = (float) d;
+  if ((double) result > d)
+    result = nextafterf(result, -FLT_MAX);
+  return result;
+}
+
+/**
+ * @brief Return the smallest float greater than or equal to a double
+ */
+static float
+float_round_up(double d)
+{
+  float result = (float) d;
+  if ((double) result < d)
+    result = nextafterf(result, FLT_MAX);
+  return result;
+}
+
+/**
+ * @brief Return the number of seconds of a timestamp rounded down, where
+ * the values out of range are mapped to the minimum integer
+ */
+static int32
+timestamp_secs_down(TimestampTz t)
+{
+  int64 secs = t / USECS_PER_SEC;
+  if (t < 0 && t % USECS_PER_SEC != 0)
+    secs--;
+  return (secs <= PG_INT32_MIN) ? PG_INT32_MIN : (int32) secs;
+}
+
+/**
+ * @brief Return the number of seconds of a timestamp rounded up, where
+ * the values out of range are mapped to the maximum integer
+ */
+static int32
+timestamp_secs_up(TimestampTz t)
+{
+  int64 secs = t / USECS_PER_SEC;
+  if (t > 0 && t % USECS_PER_SEC != 0)
+    secs++;
+  return (secs >= PG_INT32_MAX) ? PG_INT32_MAX : (int32) secs;
+}
+
+/**
+ * @brief Return a timestamp from a number of seconds, where the extreme
+ * values are mapped to infinity
+ */
+static TimestampTz
+secs_timestamp(int32 secs)
+{
+  if (secs == PG_INT32_MIN)
+    return DT_NOBEGIN;
+  if (secs == PG_INT32_MAX)
+    return DT_NOEND;
+  return (TimestampTz) secs * USECS_PER_SEC;
+}
+
+/**
+ * @brief Set a compressed box from a spatiotemporal box rounding its bounds
+ * outward
+ */
+static void
+stbox_set_stbox4(const STBox *box, STBox4 *result)
+{
+  memset(result, 0, sizeof(STBox4));
+  result->flags = box->flags;
+  if (MEOS_FLAGS_GET_X(box->flags))
+  {
+    result->xmin = float_round_down(box->xmin);
+    result->ymin = float_round_down(box->ymin);
+    result->xmax = float_round_up(box->xmax);
+    result->ymax = float_round_up(box->ymax);
+    if (MEOS_FLAGS_GET_Z(box->flags) || MEOS_FLAGS_GET_GEODETIC(box->flags))
+    {
+      result->zmin = float_round_down(box->zmin);
+      result->zmax = float_round_up(box->zmax);
+    }
+  }
+  if (MEOS_FLAGS_GET_T(box->flags))
+  {
+    result->tmin = timestamp_secs_down(DatumGetTimestampTz(box->period.lower));
+    result->tmax = timestamp_secs_up(DatumGetTimestampTz(box->period.upper));
+  }
+  return;
+}
+
+/**
+ * @brief Set a spatiotemporal box from a compressed box
+ */
+static void
+stbox4_set_stbox(const STBox4 *box, STBox *result)
+{
+  memset(result, 0, sizeof(STBox));
+  result->flags = box->flags;
+  result->xmin = box->xmin;
+  result->ymin = box->ymin;
+  result->zmin = box->zmin;
+  result->xmax = box->xmax;
+  result->ymax = box->ymax;
+  result->zmax = box->zmax;
+  if (MEOS_FLAGS_GET_T(box->flags))
+    span_set(TimestampTzGetDatum(secs_timestamp(box->tmin)),
+      TimestampTzGetDatum(secs_timestamp(box->tmax)), true, true,
+      T_TIMESTAMPTZ, T_TSTZSPAN, &result->period);
+  return;
+}
+
+PGDLLEXPORT Datum Stbox4_in(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox4_in);
+/**
+ * @brief Return a compressed box from its Well-Known Text (WKT)
+ * representation
+ */
+Datum
+Stbox4_in(PG_FUNCTION_ARGS)
+{
+  const char *input = PG_GETARG_CSTRING(0);
+  STBox *box = stbox_in(input);
+  STBox4 *result = palloc(sizeof(STBox4));
+  stbox_set_stbox4(box, result);
+  pfree(box);
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Stbox4_out(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox4_out);
+/**
+ * @brief Return the Well-Known Text (WKT) representation of a compressed box
+ */
+Datum
+Stbox4_out(PG_FUNCTION_ARGS)
+{
+  STBox4 *box = DatumGetSTbox4P(PG_GETARG_DATUM(0));
+  STBox box1;
+  stbox4_set_stbox(box, &box1);
+  PG_RETURN_CSTRING(stbox_out(&box1, OUT_DEFAULT_DECIMAL_DIGITS));
+}
+
+PGDLLEXPORT Datum Tpoint_gist4_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_gist4_consistent);
+/**
+ * @brief Lossy GiST consistent method for temporal points
+ */
+Datum
+Tpoint_gist4_consistent(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+  Oid typid = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4);
+  STBox *key = DatumGetSTboxP(entry->key), key1, query;
+
+  /* The keys are lossy */
+  *recheck = true;
+
+  if (key == NULL)
+    PG_RETURN_BOOL(false);
+
+  /* Test the key against each box of a multi-box query */
+  int count;
+  const STBox *boxes = tpoint_gist_get_stboxes(fcinfo, typid, &count);
+  if (boxes)
+  {
+    assert(strategy == RTOverlapStrategyNumber);
+    if (count == 0)
+      PG_RETURN_BOOL(false);
+    memcpy(&key1, key, sizeof(STBox));
+    key1.srid = boxes[0].srid;
+    PG_RETURN_BOOL(stbox_overlaps_any(&key1, boxes, count));
+  }
+
+  /* Transform the query into a box */
+  if (! tpoint_gist_get_stbox(fcinfo, &query, oid_type(typid)))
+    PG_RETURN_BOOL(false);
+
+  /* The key does not keep the SRID, which is that of the query */
+  memcpy(&key1, key, sizeof(STBox));
+  key1.srid = query.srid;
+  PG_RETURN_BOOL(stbox_gist_consistent(&key1, &query, strategy));
+}
+
+PGDLLEXPORT Datum Tpoint_gist4_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_gist4_compress);
+/**
+ * @brief Lossy GiST compress method for temporal points
+ * @note The internal entries to compress are the STBox values computed by
+ * the union and picksplit methods
+ */
+Datum
+Tpoint_gist4_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+  STBox4 *key = palloc(sizeof(STBox4));
+  if (entry->leafkey)
+  {
+    STBox box;
+    tspatial_set_stbox(temporal_slice(entry->key), &box);
+    stbox_set_stbox4(&box, key);
+  }
+  else
+    stbox_set_stbox4(DatumGetSTboxP(entry->key), key);
+  gistentryinit(*retval, STbox4PGetDatum(key), entry->rel, entry->page,
+    entry->offset, false);
+  PG_RETURN_POINTER(retval);
+}
+
+PGDLLEXPORT Datum Stbox4_gist_decompress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox4_gist_decompress);
+/**
+ * @brief Lossy GiST decompress method for temporal points
+ */
+Datum
+Stbox4_gist_decompress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+  STBox *box = palloc(sizeof(STBox));
+  stbox4_set_stbox(DatumGetSTbox4P(entry->key), box);
+  gistentryinit(*retval, PointerGetDatum(box), entry->rel, entry->page,
+    entry->offset, false);
+  PG_RETURN_POINTER(retval);
+}
+
+/*****************************************************************************
+ * Multi-box GiST methods
+ *
+ * The leaf entries of the index store, instead of the bounding box of a
+ * temporal point, an array of up to `max_count` boxes obtained with the
+ * function #tpoint_stboxes that splits the trajectory into tight pieces.
+ * The internal entries store an array with a single box which is the union
+ * of the boxes below. Since each row has a single index entry, no duplicate
+ * elimination is needed in the scan. The same methods index spatial sets,
+ * whose leaf entries store the boxes of their elements.
+ *****************************************************************************/
+
+/* Default and maximum number of boxes of a leaf entry */
+#define MGIST_MAX_COUNT_DEFAULT 8
+#define MGIST_MAX_COUNT_MAX     32
+
+/**
+ * @brief Structure for the options of the multi-box GiST operator classes
+ */
+typedef struct
+{
+  int32 vl_len_;      /**< Varlena header (do not touch directly!) */
+  int max_count;      /**< Maximum number of boxes of a leaf entry */
+} TPointMGistOptions;
+
+/**
+ * @brief Return the boxes of a multi-box index key
+ * @param[in] key Index key
+ * @param[out] count Number of boxes
+ */
+static const STBox *
+tpoint_mgist_key_boxes(Datum key, int *count)
+{
+  ArrayType *array = DatumGetArrayTypeP(key);
+  *count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+  return (const STBox *) ARR_DATA_PTR(array);
+}
+
+/**
+ * @brief Return in the last argument the union of the boxes of a multi-box
+ * index key
+ */
+static void
+tpoint_mgist_key_box(Datum key, STBox *result)
+{
+  int count;
+  const STBox *boxes = tpoint_mgist_key_boxes(key, &count);
+  memcpy(result, &boxes[0], sizeof(STBox));
+  for (int i = 1; i < count; i++)
+    stbox_adjust(result, (void *) &boxes[i]);
+  return;
+}
+
+/**
+ * @brief Return a multi-box index key from an array of boxes
+ */
+static Datum
+tpoint_mgist_key_make(const STBox *boxes, int count)
+{
+  return PointerGetDatum(stboxarr_to_array((STBox *) boxes, count));
+}
+
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+PGDLLEXPORT Datum Tpoint_mgist_options(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_options);
+/**
+ * @brief Multi-box GiST options method for temporal points
+ */
+Datum
+Tpoint_mgist_options(PG_FUNCTION_ARGS)
+{
+  local_relopts *relopts = (local_relopts *) PG_GETARG_POINTER(0);
+  init_local_reloptions(relopts, sizeof(TPointMGistOptions));
+  add_local_int_reloption(relopts, "max_count",
+    "maximum number of boxes indexed for a temporal point",
+    MGIST_MAX_COUNT_DEFAULT, 1, MGIST_MAX_COUNT_MAX,
+    offsetof(TPointMGistOptions, max_count));
+  PG_RETURN_VOID();
+}
+#endif /* POSTGRESQL_VERSION_NUMBER >= 130000 */
+
+PGDLLEXPORT Datum Tpoint_mgist_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_compress);
+/**
+ * @brief Multi-box GiST compress method for temporal points
+ */
+Datum
+Tpoint_mgist_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  if (entry->leafkey)
+  {
+    int max_count = MGIST_MAX_COUNT_DEFAULT;
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+    if (PG_HAS_OPCLASS_OPTIONS())
+      max_count = ((TPointMGistOptions *) PG_GET_OPCLASS_OPTIONS())->max_count;
+#endif /* POSTGRESQL_VERSION_NUMBER >= 130000 */
+    Temporal *temp = (Temporal *) PG_DETOAST_DATUM(entry->key);
+    int count;
+    STBox *boxes = tpoint_stboxes(temp, max_count, &count);
+    GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+    gistentryinit(*retval, tpoint_mgist_key_make(boxes, count), entry->rel,
+      entry->page, entry->offset, false);
+    pfree(boxes);
+    PG_RETURN_POINTER(retval);
+  }
+  PG_RETURN_POINTER(entry);
+}
+
+/**
+ * @brief Structure to sort the boxes of the elements of a spatial set
+ */
+typedef struct
+{
+  uint64 key;         /**< Hilbert index of the center of the box */
+  int i;              /**< Position of the box in the array */
+} SpatialsetBoxKey;
+
+static int
+spatialset_box_key_cmp(const void *a, const void *b)
+{
+  uint64 key1 = ((const SpatialsetBoxKey *) a)->key;
+  uint64 key2 = ((const SpatialsetBoxKey *) b)->key;
+  return (key1 < key2) ? -1 : ((key1 > key2) ? 1 : 0);
+}
+
+/**
+ * @brief Return the boxes of the elements of a spatial set, where the boxes
+ * of consecutive elements in the order of the Hilbert index of their center
+ * are merged when the set has more elements than the maximum number of boxes
+ * @param[in] set Spatial set
+ * @param[in] max_count Maximum number of boxes
+ * @param[out] count Number of boxes
+ */
+static STBox *
+spatialset_mgist_boxes(const Set *set, int max_count, int *count)
+{
+  STBox *boxes = palloc(sizeof(STBox) * set->count);
+  int nboxes = 0;
+  for (int i = 0; i < set->count; i++)
+  {
+    if (geo_set_stbox(DatumGetGserializedP(SET_VAL_N(set, i)),
+        &boxes[nboxes]))
+      nboxes++;
+  }
+  if (nboxes == 0)
+  {
+    spatialset_set_stbox(set, &boxes[0]);
+    nboxes = 1;
+  }
+  if (nboxes <= max_count)
+  {
+    *count = nboxes;
+    return boxes;
+  }
+
+  SpatialsetBoxKey *keys = palloc(sizeof(SpatialsetBoxKey) * nboxes);
+  for (int i = 0; i < nboxes; i++)
+  {
+    keys[i].key = stbox_sort_key(PointerGetDatum(&boxes[i]));
+    keys[i].i = i;
+  }
+  qsort(keys, nboxes, sizeof(SpatialsetBoxKey), &spatialset_box_key_cmp);
+  STBox *result = palloc(sizeof(STBox) * max_count);
+  for (int j = 0; j < max_count; j++)
+  {
+    int first = (int) (((int64) j * nboxes) / max_count);
+    int last = (int) (((int64) (j + 1) * nboxes) / max_count);
+    memcpy(&result[j], &boxes[keys[first].i], sizeof(STBox));
+    for (int k = first + 1; k < last; k++)
+      stbox_adjust(&result[j], &boxes[keys[k].i]);
+  }
+  pfree(boxes); pfree(keys);
+  *count = max_count;
+  return result;
+}
+
+PGDLLEXPORT Datum Spatialset_mgist_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spatialset_mgist_compress);
+/**
+ * @brief Multi-box GiST compress method for spatial sets
+ * @details The leaf entries store the boxes of the elements, so that a set
+ * of widely scattered geometries does not match the queries in the empty
+ * space between them
+ */
+Datum
+Spatialset_mgist_compress(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  if (entry->leafkey)
+  {
+    int max_count = MGIST_MAX_COUNT_DEFAULT;
+#if POSTGRESQL_VERSION_NUMBER >= 130000
+    if (PG_HAS_OPCLASS_OPTIONS())
+      max_count = ((TPointMGistOptions *) PG_GET_OPCLASS_OPTIONS())->max_count;
+#endif /* POSTGRESQL_VERSION_NUMBER >= 130000 */
+    int count;
+    STBox *boxes = spatialset_mgist_boxes(DatumGetSetP(entry->key), max_count,
+      &count);
+    GISTENTRY *retval = palloc(sizeof(GISTENTRY));
+    gistentryinit(*retval, tpoint_mgist_key_make(boxes, count), entry->rel,
+      entry->page, entry->offset, false);
+    pfree(boxes);
+    PG_RETURN_POINTER(retval);
+  }
+  PG_RETURN_POINTER(entry);
+}
+
+PGDLLEXPORT Datum Tpoint_mgist_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_consistent);
+/**
+ * @brief Multi-box GiST consistent method for temporal points
+ * @details The overlaps operator at the leaf level is tested against each
+ * box of the key, which filters out the rows whose trajectory passes around
+ * the query box without touching it. All the other operators are tested
+ * against the union of the boxes, which is the bounding box of the value.
+ */
+Datum
+Tpoint_mgist_consistent(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+  Oid typid = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4), result;
+  STBox key, query;
+
+  /* Determine whether the index is lossy depending on the strategy */
+  *recheck = tpoint_index_recheck(strategy);
+  MEOS_STAT_ADD(MEOS_STAT_INDEX_CONSISTENT, 1);
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_BOOL(false);
+
+  /* Test each box of the key against each box of a multi-box query */
+  int nquery;
+  const STBox *queries = tpoint_gist_get_stboxes(fcinfo, typid, &nquery);
+  if (queries)
+  {
+    assert(strategy == RTOverlapStrategyNumber);
+    if (GIST_LEAF(entry))
+    {
+      int count;
+      const STBox *boxes = tpoint_mgist_key_boxes(entry->key, &count);
+      for (int i = 0; i < count; i++)
+      {
+        if (stbox_overlaps_any(&boxes[i], queries, nquery))
+        {
+          MEOS_STAT_ADD(MEOS_STAT_INDEX_RECHECKS, 1);
+          PG_RETURN_BOOL(true);
+        }
+      }
+      PG_RETURN_BOOL(false);
+    }
+    tpoint_mgist_key_box(entry->key, &key);
+    PG_RETURN_BOOL(stbox_overlaps_any(&key, queries, nquery));
+  }
+
+  /* Transform the query into a box */
+  if (! tpoint_gist_get_stbox(fcinfo, &query, oid_type(typid)))
+    PG_RETURN_BOOL(false);
+
+  if (GIST_LEAF(entry) && strategy == RTOverlapStrategyNumber)
+  {
+    int count;
+    const STBox *boxes = tpoint_mgist_key_boxes(entry->key, &count);
+    for (int i = 0; i < count; i++)
+    {
+      if (overlaps_stbox_stbox(&boxes[i], &query))
+      {
+        if (*recheck)
+          MEOS_STAT_ADD(MEOS_STAT_INDEX_RECHECKS, 1);
+        PG_RETURN_BOOL(true);
+      }
+    }
+    PG_RETURN_BOOL(false);
+  }
+
+  tpoint_mgist_key_box(entry->key, &key);
+  if (GIST_LEAF(entry))
+  {
+    result = stbox_index_consistent_leaf(&key, &query, strategy);
+    if (result && *recheck)
+      MEOS_STAT_ADD(MEOS_STAT_INDEX_RECHECKS, 1);
+  }
+  else
+    result = stbox_gist_consistent(&key, &query, strategy);
+  PG_RETURN_BOOL(result);
+}
+
+PGDLLEXPORT Datum Tpoint_mgist_union(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_union);
+/**
+ * @brief Multi-box GiST union method for temporal points
+ */
+Datum
+Tpoint_mgist_union(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  GISTENTRY *ent = entryvec->vector;
+  STBox result, box;
+  tpoint_mgist_key_box(ent[0].key, &result);
+  for (int i = 1; i < entryvec->n; i++)
+  {
+    tpoint_mgist_key_box(ent[i].key, &box);
+    stbox_adjust(&result, &box);
+  }
+  PG_RETURN_DATUM(tpoint_mgist_key_make(&result, 1));
+}
+
+PGDLLEXPORT Datum Tpoint_mgist_penalty(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_penalty);
+/**
+ * @brief Multi-box GiST penalty method for temporal points
+ */
+Datum
+Tpoint_mgist_penalty(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  GISTENTRY *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
+  float *result = (float *) PG_GETARG_POINTER(2);
+  STBox origbox, newbox;
+  tpoint_mgist_key_box(origentry->key, &origbox);
+  tpoint_mgist_key_box(newentry->key, &newbox);
+  *result = (float) stbox_penalty(&origbox, &newbox);
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tpoint_mgist_picksplit(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_picksplit);
+/**
+ * @brief Multi-box GiST picksplit method for temporal points
+ * @details The entries are replaced by their union box and split with the
+ * algorithm of the GiST picksplit method for spatiotemporal boxes
+ */
+Datum
+Tpoint_mgist_picksplit(PG_FUNCTION_ARGS)
+{
+  GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+  GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+  GistEntryVector *boxvec = palloc(GEVHDRSZ + sizeof(GISTENTRY) * entryvec->n);
+  STBox *boxes = palloc(sizeof(STBox) * entryvec->n);
+  boxvec->n = entryvec->n;
+  for (OffsetNumber i = FirstOffsetNumber; i < entryvec->n; i++)
+  {
+    boxvec->vector[i] = entryvec->vector[i];
+    tpoint_mgist_key_box(entryvec->vector[i].key, &boxes[i]);
+    boxvec->vector[i].key = PointerGetDatum(&boxes[i]);
+  }
+  fcinfo->args[0].value = PointerGetDatum(boxvec);
+  bbox_gist_picksplit(fcinfo, T_STBOX, &stbox_adjust, &stbox_penalty);
+  v->spl_ldatum = tpoint_mgist_key_make(DatumGetSTboxP(v->spl_ldatum), 1);
+  v->spl_rdatum = tpoint_mgist_key_make(DatumGetSTboxP(v->spl_rdatum), 1);
+  pfree(boxvec); pfree(boxes);
+  PG_RETURN_POINTER(v);
+}
+
+PGDLLEXPORT Datum Tpoint_mgist_same(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_same);
+/**
+ * @brief Multi-box GiST same method for temporal points
+ * @details Return true only when the keys have exactly the same boxes
+ */
+Datum
+Tpoint_mgist_same(PG_FUNCTION_ARGS)
+{
+  ArrayType *key1 = PG_GETARG_ARRAYTYPE_P(0);
+  ArrayType *key2 = PG_GETARG_ARRAYTYPE_P(1);
+  bool *result = (bool *) PG_GETARG_POINTER(2);
+  *result = VARSIZE(key1) == VARSIZE(key2) &&
+    memcmp(key1, key2, VARSIZE(key1)) == 0;
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tpoint_mgist_distance(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_distance);
+/**
+ * @brief Multi-box GiST distance method for temporal points
+ * @details The distance of a leaf entry is the minimum distance of its boxes
+ */
+Datum
+Tpoint_mgist_distance(PG_FUNCTION_ARGS)
+{
+  GISTENTRY *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+  Oid typid = PG_GETARG_OID(3);
+  bool *recheck = (bool *) PG_GETARG_POINTER(4);
+  STBox query;
+
+  /* The index is lossy for leaf levels */
+  if (GIST_LEAF(entry))
+    *recheck = true;
+
+  if (DatumGetPointer(entry->key) == NULL)
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  /* Transform the query into a box */
+  if (! tpoint_gist_get_stbox(fcinfo, &query, oid_type(typid)))
+    PG_RETURN_FLOAT8(DBL_MAX);
+
+  int count;
+  const STBox *boxes = tpoint_mgist_key_boxes(entry->key, &count);
+  double result = DBL_MAX;
+  for (int i = 0; i < count; i++)
+    result = Min(result, nad_stbox_stbox(&boxes[i], &query));
+  PG_RETURN_FLOAT8(result);
+}
+
+/**
+ * @brief Return the sort key of a multi-box index key, which is the Hilbert
+ * index of the center of the union of its boxes
+ */
+static uint64
+tpoint_mgist_sort_key(Datum key)
+{
+  STBox box;
+  tpoint_mgist_key_box(key, &box);
+  return stbox_sort_key(PointerGetDatum(&box));
+}
+
+PGDLLEXPORT Datum Tpoint_mgist_sortsupport(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_mgist_sortsupport);
+/**
+ * @brief Multi-box GiST sortsupport method for temporal points
+ * @details The sorted build compresses the rows before sorting them, so that
+ * the boxes of each temporal point are computed once and the leaf pages are
+ * packed in the order of the sort keys without calling the picksplit method
+ */
+Datum
+Tpoint_mgist_sortsupport(PG_FUNCTION_ARGS)
+{
+  return bbox_gist_sortsupport(fcinfo, &tpoint_mgist_sort_key);
+}
+
 /*****************************************************************************/
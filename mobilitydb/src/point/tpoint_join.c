@@ -0,0 +1,959 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Custom scan provider for spatiotemporal joins of temporal points
+ *
+ * The provider recognizes the inner joins of temporal geometry points whose
+ * join clauses contain one of the predicates `a && b`, `eIntersects(a, b)`,
+ * or `eDwithin(a, b, d)`, where `a` and `b` only reference the two sides of
+ * the join and `d` is constant during the execution. The join is executed
+ * as a partition-based spatial join.
+ * - The inner side is read once and its tuples are assigned to the cells of
+ *   an (X, Y, T) grid covering their bounding boxes. The size of the grid
+ *   depends on the number of tuples and on the average extent of their
+ *   boxes, so that the boxes do not span too many cells.
+ * - Each outer tuple probes the cells overlapped by its bounding box,
+ *   expanded by the distance for `eDwithin`. A candidate pair is only
+ *   considered in the cell containing the lower corner of the intersection
+ *   of the two boxes, which removes the duplicates of the boxes spanning
+ *   several cells.
+ * - All the join clauses, including the exact predicate, are evaluated on
+ *   the candidate pairs.
+ *
+ * In parallel plans the outer side is a partial path and every worker
+ * builds its own grid over the complete inner side. The provider is enabled
+ * by the `mobilitydb.enable_spacetime_join` parameter, and the planner then
+ * chooses it on the basis of its cost.
+ */
+
+#include "pg_point/tpoint_join.h"
+
+/* C */
+#include <float.h>
+#include <math.h>
+/* PostgreSQL */
+#include <postgres.h>
+#include <miscadmin.h>
+#include <catalog/pg_type.h>
+#include <commands/explain.h>
+#include <executor/executor.h>
+#include <nodes/extensible.h>
+#include <nodes/makefuncs.h>
+#include <nodes/nodeFuncs.h>
+#include <optimizer/cost.h>
+#include <optimizer/optimizer.h>
+#include <optimizer/pathnode.h>
+#include <optimizer/paths.h>
+#include <optimizer/restrictinfo.h>
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+#include <utils/timestamp.h>
+/* MEOS */
+#include <meos.h>
+#include <meos_internal.h>
+/* MobilityDB */
+#include "pg_general/meos_catalog.h"
+#include "pg_general/temporal.h"
+
+/* Functions of the predicates recognized by the provider */
+extern PGDLLEXPORT Datum Overlaps_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern PGDLLEXPORT Datum Eintersects_tpoint_tpoint(PG_FUNCTION_ARGS);
+extern PGDLLEXPORT Datum Edwithin_tpoint_tpoint(PG_FUNCTION_ARGS);
+
+/**
+ * @brief Global variable stating whether the planner considers the
+ * partition-based spatiotemporal join
+ */
+bool MOBDB_ENABLE_SPACETIME_JOIN = false;
+
+/** Name of the custom scan shown by EXPLAIN */
+#define STJOIN_NAME "SpaceTimeJoin"
+/** Number of dimensions of the grid: X, Y, and T */
+#define STJOIN_DIMS 3
+/** Average number of inner tuples per cell targeted by the grid */
+#define STJOIN_TUPLES_PER_CELL 8
+/** Maximum number of cells on each side of the grid */
+#define STJOIN_MAX_CELLS_SIDE 64
+/** Ratio of candidate pairs to result pair assumed by the cost model */
+#define STJOIN_CANDIDATE_RATIO 2.0
+
+static set_join_pathlist_hook_type prev_set_join_pathlist_hook = NULL;
+
+/**
+ * @brief Bounding box of a temporal point in the grid dimensions
+ */
+typedef struct
+{
+  double min[STJOIN_DIMS];
+  double max[STJOIN_DIMS];
+} STJoinBox;
+
+/**
+ * @brief Cell of the grid with the indexes of the inner tuples overlapping it
+ */
+typedef struct
+{
+  int count;
+  int size;
+  int *ids;
+} STJoinCell;
+
+/**
+ * @brief Execution state of the spatiotemporal join
+ */
+typedef struct
+{
+  CustomScanState css;        /**< Generic custom scan state */
+  MemoryContext cxt;          /**< Context of the inner tuples and the grid */
+  int nouteratts;             /**< Number of attributes of the outer side */
+  int ninneratts;             /**< Number of attributes of the inner side */
+  ExprState *outer_key;       /**< Temporal point of the outer side */
+  ExprState *inner_key;       /**< Temporal point of the inner side */
+  ExprState *dist_expr;       /**< Distance of the predicate */
+  TupleTableSlot *innerslot;  /**< Slot of the candidate inner tuple */
+  TupleTableSlot *outerslot;  /**< Current outer tuple */
+  bool built;                 /**< True when the grid has been built */
+  double dist;                /**< Value of the distance */
+  int ntuples;                /**< Number of inner tuples */
+  int maxtuples;              /**< Allocated number of inner tuples */
+  MinimalTuple *tuples;       /**< Inner tuples */
+  STJoinBox *boxes;           /**< Bounding boxes of the inner tuples */
+  STJoinBox extent;           /**< Extent of the grid */
+  int ncells[STJOIN_DIMS];    /**< Number of cells on each side */
+  double cellsize[STJOIN_DIMS]; /**< Size of the cells on each side */
+  STJoinCell *cells;          /**< Cells of the grid */
+  bool probing;               /**< True when an outer tuple is being probed */
+  STJoinBox probe;            /**< Expanded box of the current outer tuple */
+  int lo[STJOIN_DIMS];        /**< First cell overlapped by the probe */
+  int hi[STJOIN_DIMS];        /**< Last cell overlapped by the probe */
+  int cur[STJOIN_DIMS];       /**< Current cell of the probe */
+  int pos;                    /**< Position in the current cell */
+  int64 ncandidates;          /**< Number of candidate pairs */
+} STJoinState;
+
+static CustomPathMethods stjoin_path_methods;
+static CustomScanMethods stjoin_scan_methods;
+static CustomExecMethods stjoin_exec_methods;
+
+/*****************************************************************************
+ * Planning
+ *****************************************************************************/
+
+/**
+ * @brief Return the number of arguments of the function if it is a
+ * predicate recognized by the provider, or 0 otherwise
+ */
+static int
+stjoin_predicate_nargs(Oid funcid)
+{
+  FmgrInfo flinfo;
+  fmgr_info(funcid, &flinfo);
+  if (flinfo.fn_addr == Overlaps_tpoint_tpoint ||
+      flinfo.fn_addr == Eintersects_tpoint_tpoint)
+    return 2;
+  if (flinfo.fn_addr == Edwithin_tpoint_tpoint)
+    return 3;
+  return 0;
+}
+
+/**
+ * @brief Return the relids referenced by an expression
+ */
+static Relids
+stjoin_varnos(PlannerInfo *root, Node *node)
+{
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  return pull_varnos(root, node);
+#else
+  return pull_varnos(node);
+#endif /* POSTGRESQL_VERSION_NUMBER >= 140000 */
+}
+
+/**
+ * @brief Return true if the expression is a temporal geometry point that
+ * only references the relation
+ */
+static bool
+stjoin_side_key(PlannerInfo *root, Node *expr, RelOptInfo *rel)
+{
+  if (exprType(expr) != type_oid(T_TGEOMPOINT) ||
+      contain_volatile_functions(expr))
+    return false;
+  Relids relids = stjoin_varnos(root, expr);
+  return ! bms_is_empty(relids) && bms_is_subset(relids, rel->relids);
+}
+
+/**
+ * @brief Find in the join clauses a predicate that can be evaluated by the
+ * provider and return its arguments
+ */
+static bool
+stjoin_find_predicate(PlannerInfo *root, List *restrictlist,
+  RelOptInfo *outerrel, RelOptInfo *innerrel, Expr **outer_key,
+  Expr **inner_key, Expr **dist)
+{
+  ListCell *lc;
+  foreach (lc, restrictlist)
+  {
+    RestrictInfo *rinfo = lfirst_node(RestrictInfo, lc);
+    if (rinfo->pseudoconstant)
+      continue;
+    Oid funcid;
+    List *args;
+    if (IsA(rinfo->clause, OpExpr))
+    {
+      OpExpr *op = (OpExpr *) rinfo->clause;
+      funcid = get_opcode(op->opno);
+      args = op->args;
+    }
+    else if (IsA(rinfo->clause, FuncExpr))
+    {
+      FuncExpr *func = (FuncExpr *) rinfo->clause;
+      funcid = func->funcid;
+      args = func->args;
+    }
+    else
+      continue;
+    if (! OidIsValid(funcid) || list_length(args) < 2)
+      continue;
+    int nargs = stjoin_predicate_nargs(funcid);
+    if (nargs != list_length(args))
+      continue;
+
+    Node *arg1 = linitial(args);
+    Node *arg2 = lsecond(args);
+    if (stjoin_side_key(root, arg1, outerrel) &&
+        stjoin_side_key(root, arg2, innerrel))
+    {
+      *outer_key = (Expr *) arg1;
+      *inner_key = (Expr *) arg2;
+    }
+    else if (stjoin_side_key(root, arg1, innerrel) &&
+        stjoin_side_key(root, arg2, outerrel))
+    {
+      *outer_key = (Expr *) arg2;
+      *inner_key = (Expr *) arg1;
+    }
+    else
+      continue;
+
+    if (nargs == 3)
+    {
+      Node *arg3 = lthird(args);
+      /* The distance must be computed once for the whole execution */
+      if (contain_var_clause(arg3) || contain_volatile_functions(arg3))
+        continue;
+      *dist = (Expr *) arg3;
+    }
+    else
+      *dist = (Expr *) makeConst(FLOAT8OID, -1, InvalidOid, sizeof(float8),
+        Float8GetDatum(0.0), false, FLOAT8PASSBYVAL);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Create a path for the spatiotemporal join of two paths
+ * @param[in] root Planner information
+ * @param[in] joinrel Join relation
+ * @param[in] outer_path,inner_path Paths of the two sides
+ * @param[in] extra Join information
+ * @param[in] outer_key,inner_key,dist Arguments of the predicate
+ * @param[in] rows Number of rows returned by the path
+ */
+static Path *
+stjoin_create_path(PlannerInfo *root, RelOptInfo *joinrel, Path *outer_path,
+  Path *inner_path, JoinPathExtraData *extra, Expr *outer_key,
+  Expr *inner_key, Expr *dist, double rows)
+{
+  CustomPath *cpath = makeNode(CustomPath);
+  cpath->path.pathtype = T_CustomScan;
+  cpath->path.parent = joinrel;
+  cpath->path.pathtarget = joinrel->reltarget;
+  cpath->path.param_info = NULL;
+  cpath->path.parallel_aware = false;
+  cpath->path.parallel_safe = joinrel->consider_parallel &&
+    outer_path->parallel_safe && inner_path->parallel_safe;
+  cpath->path.parallel_workers = outer_path->parallel_workers;
+  cpath->path.pathkeys = NIL;
+  cpath->path.rows = rows;
+  cpath->flags = 0;
+  cpath->custom_paths = list_make2(outer_path, inner_path);
+  cpath->custom_private = list_make4(extra->restrictlist, outer_key,
+    inner_key, dist);
+  cpath->methods = &stjoin_path_methods;
+
+  /* Building the grid reads, boxes, and copies every inner tuple */
+  QualCost qual_cost;
+  cost_qual_eval(&qual_cost, extract_actual_clauses(extra->restrictlist,
+    false), root);
+  Cost startup = inner_path->total_cost + outer_path->startup_cost +
+    qual_cost.startup +
+    inner_path->rows * (2 * cpu_operator_cost + cpu_tuple_cost);
+  /* Every outer tuple is boxed and the join clauses are evaluated on the
+   * candidate pairs, whose number is proportional to the result */
+  double candidates = Max(rows * STJOIN_CANDIDATE_RATIO, outer_path->rows);
+  Cost run = (outer_path->total_cost - outer_path->startup_cost) +
+    outer_path->rows * 2 * cpu_operator_cost +
+    candidates * (qual_cost.per_tuple + cpu_operator_cost) +
+    rows * cpu_tuple_cost;
+  cpath->path.startup_cost = startup;
+  cpath->path.total_cost = startup + run;
+  return (Path *) cpath;
+}
+
+/**
+ * @brief Add the spatiotemporal join paths to a join relation
+ */
+static void
+stjoin_set_join_pathlist(PlannerInfo *root, RelOptInfo *joinrel,
+  RelOptInfo *outerrel, RelOptInfo *innerrel, JoinType jointype,
+  JoinPathExtraData *extra)
+{
+  if (prev_set_join_pathlist_hook)
+    prev_set_join_pathlist_hook(root, joinrel, outerrel, innerrel, jointype,
+      extra);
+
+  if (! MOBDB_ENABLE_SPACETIME_JOIN || jointype != JOIN_INNER ||
+      ! bms_is_empty(joinrel->lateral_relids))
+    return;
+  Expr *outer_key, *inner_key, *dist;
+  if (! stjoin_find_predicate(root, extra->restrictlist, outerrel, innerrel,
+      &outer_key, &inner_key, &dist))
+    return;
+
+  Path *outer_path = outerrel->cheapest_total_path;
+  Path *inner_path = innerrel->cheapest_total_path;
+  if (! outer_path || ! inner_path || PATH_REQ_OUTER(outer_path) ||
+      PATH_REQ_OUTER(inner_path))
+    return;
+  add_path(joinrel, stjoin_create_path(root, joinrel, outer_path, inner_path,
+    extra, outer_key, inner_key, dist, joinrel->rows));
+
+  /* Partial path whose workers build their own grid over the inner side */
+  if (joinrel->consider_parallel && outerrel->partial_pathlist != NIL &&
+      inner_path->parallel_safe)
+  {
+    Path *partial_path = linitial(outerrel->partial_pathlist);
+    if (PATH_REQ_OUTER(partial_path) || outerrel->rows <= 0)
+      return;
+    double rows = clamp_row_est(joinrel->rows * partial_path->rows /
+      outerrel->rows);
+    add_partial_path(joinrel, stjoin_create_path(root, joinrel,
+      partial_path, inner_path, extra, outer_key, inner_key, dist, rows));
+  }
+  return;
+}
+
+/**
+ * @brief Return the scan target list made of the target lists of the two
+ * sides of the join
+ */
+static List *
+stjoin_scan_tlist(List *outer_tlist, List *inner_tlist)
+{
+  List *result = NIL;
+  AttrNumber resno = 1;
+  ListCell *lc;
+  foreach (lc, outer_tlist)
+  {
+    TargetEntry *tle = lfirst_node(TargetEntry, lc);
+    result = lappend(result, makeTargetEntry((Expr *) copyObject(tle->expr),
+      resno++, NULL, false));
+  }
+  foreach (lc, inner_tlist)
+  {
+    TargetEntry *tle = lfirst_node(TargetEntry, lc);
+    result = lappend(result, makeTargetEntry((Expr *) copyObject(tle->expr),
+      resno++, NULL, false));
+  }
+  return result;
+}
+
+/**
+ * @brief Create the plan of a spatiotemporal join path
+ * @details The join clauses are kept in the custom private list of the path
+ * since the clauses given in argument are empty for join relations. The
+ * expressions of the plan are expressed on the tuples made of the outer and
+ * the inner tuples.
+ */
+static Plan *
+stjoin_plan_path(PlannerInfo *root __attribute__((unused)),
+  RelOptInfo *rel __attribute__((unused)), CustomPath *best_path,
+  List *tlist, List *clauses __attribute__((unused)), List *custom_plans)
+{
+  List *restrictlist = (List *) linitial(best_path->custom_private);
+  Plan *outer_plan = (Plan *) linitial(custom_plans);
+  Plan *inner_plan = (Plan *) lsecond(custom_plans);
+
+  CustomScan *cscan = makeNode(CustomScan);
+  cscan->scan.plan.targetlist = tlist;
+  cscan->scan.plan.qual = list_concat(
+    extract_actual_clauses(restrictlist, false),
+    extract_actual_clauses(restrictlist, true));
+  cscan->scan.scanrelid = 0;
+  cscan->flags = best_path->flags;
+  cscan->custom_plans = custom_plans;
+  cscan->custom_exprs = list_make3(
+    copyObject(lsecond(best_path->custom_private)),
+    copyObject(lthird(best_path->custom_private)),
+    copyObject(lfourth(best_path->custom_private)));
+  cscan->custom_private = NIL;
+  cscan->custom_scan_tlist = stjoin_scan_tlist(outer_plan->targetlist,
+    inner_plan->targetlist);
+  cscan->methods = &stjoin_scan_methods;
+  return &cscan->scan.plan;
+}
+
+/**
+ * @brief Create the execution state of a spatiotemporal join
+ */
+static Node *
+stjoin_create_state(CustomScan *cscan __attribute__((unused)))
+{
+  STJoinState *state = (STJoinState *) newNode(sizeof(STJoinState),
+    T_CustomScanState);
+  state->css.methods = &stjoin_exec_methods;
+  return (Node *) state;
+}
+
+/*****************************************************************************
+ * Grid
+ *****************************************************************************/
+
+/**
+ * @brief Evaluate a temporal point key and return its box in the grid
+ * dimensions, or false if the key is null
+ */
+static bool
+stjoin_eval_box(STJoinState *state, ExprState *key, STJoinBox *result)
+{
+  ExprContext *econtext = state->css.ss.ps.ps_ExprContext;
+  econtext->ecxt_scantuple = state->css.ss.ss_ScanTupleSlot;
+  bool isnull;
+  Datum value = ExecEvalExprSwitchContext(key, econtext, &isnull);
+  if (isnull)
+    return false;
+  MemoryContext oldcxt = MemoryContextSwitchTo(
+    econtext->ecxt_per_tuple_memory);
+  STBox box;
+  tspatial_set_stbox(temporal_slice(value), &box);
+  MemoryContextSwitchTo(oldcxt);
+  result->min[0] = box.xmin;
+  result->max[0] = box.xmax;
+  result->min[1] = box.ymin;
+  result->max[1] = box.ymax;
+  result->min[2] = (double) DatumGetTimestampTz(box.period.lower);
+  result->max[2] = (double) DatumGetTimestampTz(box.period.upper);
+  return true;
+}
+
+/**
+ * @brief Store in the scan slot the outer and the inner tuples, any of them
+ * may be @p NULL
+ */
+static void
+stjoin_store(STJoinState *state, TupleTableSlot *outer, TupleTableSlot *inner)
+{
+  TupleTableSlot *slot = state->css.ss.ss_ScanTupleSlot;
+  ExecClearTuple(slot);
+  if (outer)
+  {
+    slot_getallattrs(outer);
+    memcpy(slot->tts_values, outer->tts_values,
+      sizeof(Datum) * state->nouteratts);
+    memcpy(slot->tts_isnull, outer->tts_isnull,
+      sizeof(bool) * state->nouteratts);
+  }
+  else
+    memset(slot->tts_isnull, true, sizeof(bool) * state->nouteratts);
+  if (inner)
+  {
+    slot_getallattrs(inner);
+    memcpy(slot->tts_values + state->nouteratts, inner->tts_values,
+      sizeof(Datum) * state->ninneratts);
+    memcpy(slot->tts_isnull + state->nouteratts, inner->tts_isnull,
+      sizeof(bool) * state->ninneratts);
+  }
+  else
+    memset(slot->tts_isnull + state->nouteratts, true,
+      sizeof(bool) * state->ninneratts);
+  ExecStoreVirtualTuple(slot);
+  return;
+}
+
+/**
+ * @brief Return the cell of the grid containing the value in a dimension
+ */
+static inline int
+stjoin_cell_of(const STJoinState *state, int dim, double value)
+{
+  if (state->cellsize[dim] <= 0)
+    return 0;
+  double cell = floor((value - state->extent.min[dim]) /
+    state->cellsize[dim]);
+  if (cell < 0)
+    return 0;
+  if (cell >= state->ncells[dim])
+    return state->ncells[dim] - 1;
+  return (int) cell;
+}
+
+/**
+ * @brief Return the position of a cell of the grid in the array of cells
+ */
+static inline int
+stjoin_cell_index(const STJoinState *state, const int *cell)
+{
+  return (cell[0] * state->ncells[1] + cell[1]) * state->ncells[2] + cell[2];
+}
+
+/**
+ * @brief Set the cells of the grid overlapped by a box
+ */
+static void
+stjoin_box_cells(const STJoinState *state, const STJoinBox *box, int *lo,
+  int *hi)
+{
+  for (int d = 0; d < STJOIN_DIMS; d++)
+  {
+    lo[d] = stjoin_cell_of(state, d, box->min[d]);
+    hi[d] = stjoin_cell_of(state, d, box->max[d]);
+  }
+  return;
+}
+
+/**
+ * @brief Add an inner tuple to a cell of the grid
+ */
+static void
+stjoin_cell_add(STJoinState *state, const int *cell, int id)
+{
+  STJoinCell *c = &state->cells[stjoin_cell_index(state, cell)];
+  if (c->count == c->size)
+  {
+    c->size = c->size ? c->size * 2 : 4;
+    c->ids = c->ids ?
+      repalloc_huge(c->ids, sizeof(int) * c->size) :
+      MemoryContextAllocHuge(state->cxt, sizeof(int) * c->size);
+  }
+  c->ids[c->count++] = id;
+  return;
+}
+
+/**
+ * @brief Compute the dimensions of the grid from the boxes of the inner
+ * tuples
+ * @details The target number of cells follows the number of tuples and is
+ * reduced in each dimension so that the cells are not smaller than the
+ * average extent of the boxes
+ */
+static void
+stjoin_grid_dims(STJoinState *state)
+{
+  double width[STJOIN_DIMS] = {0};
+  for (int d = 0; d < STJOIN_DIMS; d++)
+  {
+    state->extent.min[d] = DBL_MAX;
+    state->extent.max[d] = -DBL_MAX;
+  }
+  for (int i = 0; i < state->ntuples; i++)
+  {
+    for (int d = 0; d < STJOIN_DIMS; d++)
+    {
+      state->extent.min[d] = Min(state->extent.min[d], state->boxes[i].min[d]);
+      state->extent.max[d] = Max(state->extent.max[d], state->boxes[i].max[d]);
+      width[d] += state->boxes[i].max[d] - state->boxes[i].min[d];
+    }
+  }
+  int side = (int) ceil(cbrt((double) state->ntuples /
+    STJOIN_TUPLES_PER_CELL));
+  side = Max(1, Min(side, STJOIN_MAX_CELLS_SIDE));
+  for (int d = 0; d < STJOIN_DIMS; d++)
+  {
+    double extent = state->extent.max[d] - state->extent.min[d];
+    double avg = width[d] / state->ntuples;
+    int n = side;
+    if (extent <= 0)
+      n = 1;
+    else if (avg > 0)
+      n = Max(1, Min(n, (int) (extent / avg)));
+    state->ncells[d] = n;
+    state->cellsize[d] = (n > 1) ? extent / n : 0;
+  }
+  return;
+}
+
+/**
+ * @brief Read the inner side and build the grid
+ */
+static void
+stjoin_build(STJoinState *state)
+{
+  ExprContext *econtext = state->css.ss.ps.ps_ExprContext;
+  PlanState *innerps = (PlanState *) lsecond(state->css.custom_ps);
+
+  /* Evaluate the distance, which is constant during the execution */
+  bool isnull;
+  ResetExprContext(econtext);
+  econtext->ecxt_scantuple = NULL;
+  Datum dist = ExecEvalExprSwitchContext(state->dist_expr, econtext, &isnull);
+  state->dist = isnull ? 0.0 : Max(DatumGetFloat8(dist), 0.0);
+
+  state->ntuples = 0;
+  state->maxtuples = 0;
+  state->tuples = NULL;
+  state->boxes = NULL;
+  for (;;)
+  {
+    TupleTableSlot *slot = ExecProcNode(innerps);
+    if (TupIsNull(slot))
+      break;
+    ResetExprContext(econtext);
+    STJoinBox box;
+    stjoin_store(state, NULL, slot);
+    /* Strict predicates never match a null temporal point */
+    if (! stjoin_eval_box(state, state->inner_key, &box))
+      continue;
+    MemoryContext oldcxt = MemoryContextSwitchTo(state->cxt);
+    if (state->ntuples == state->maxtuples)
+    {
+      state->maxtuples = state->maxtuples ? state->maxtuples * 2 : 1024;
+      state->tuples = state->tuples ?
+        repalloc_huge(state->tuples, sizeof(MinimalTuple) * state->maxtuples) :
+        palloc_extended(sizeof(MinimalTuple) * state->maxtuples,
+          MCXT_ALLOC_HUGE);
+      state->boxes = state->boxes ?
+        repalloc_huge(state->boxes, sizeof(STJoinBox) * state->maxtuples) :
+        palloc_extended(sizeof(STJoinBox) * state->maxtuples,
+          MCXT_ALLOC_HUGE);
+    }
+    state->tuples[state->ntuples] = ExecCopySlotMinimalTuple(slot);
+    state->boxes[state->ntuples++] = box;
+    MemoryContextSwitchTo(oldcxt);
+  }
+
+  if (state->ntuples > 0)
+  {
+    stjoin_grid_dims(state);
+    int ncells = state->ncells[0] * state->ncells[1] * state->ncells[2];
+    state->cells = MemoryContextAllocHuge(state->cxt,
+      sizeof(STJoinCell) * ncells);
+    memset(state->cells, 0, sizeof(STJoinCell) * ncells);
+    for (int i = 0; i < state->ntuples; i++)
+    {
+      int lo[STJOIN_DIMS], hi[STJOIN_DIMS], cell[STJOIN_DIMS];
+      stjoin_box_cells(state, &state->boxes[i], lo, hi);
+      for (cell[0] = lo[0]; cell[0] <= hi[0]; cell[0]++)
+        for (cell[1] = lo[1]; cell[1] <= hi[1]; cell[1]++)
+          for (cell[2] = lo[2]; cell[2] <= hi[2]; cell[2]++)
+            stjoin_cell_add(state, cell, i);
+    }
+  }
+  state->built = true;
+  state->probing = false;
+  return;
+}
+
+/*****************************************************************************
+ * Probing
+ *****************************************************************************/
+
+/**
+ * @brief Read the next outer tuple whose box overlaps the grid and start
+ * probing its cells, return false when the outer side is exhausted
+ */
+static bool
+stjoin_next_outer(STJoinState *state)
+{
+  ExprContext *econtext = state->css.ss.ps.ps_ExprContext;
+  PlanState *outerps = (PlanState *) linitial(state->css.custom_ps);
+  for (;;)
+  {
+    TupleTableSlot *slot = ExecProcNode(outerps);
+    if (TupIsNull(slot))
+      return false;
+    ResetExprContext(econtext);
+    stjoin_store(state, slot, NULL);
+    STJoinBox *probe = &state->probe;
+    if (! stjoin_eval_box(state, state->outer_key, probe))
+      continue;
+    /* The distance expands the spatial dimensions */
+    for (int d = 0; d < 2; d++)
+    {
+      probe->min[d] -= state->dist;
+      probe->max[d] += state->dist;
+    }
+    bool overlaps = true;
+    for (int d = 0; d < STJOIN_DIMS; d++)
+    {
+      if (probe->max[d] < state->extent.min[d] ||
+          probe->min[d] > state->extent.max[d])
+      {
+        overlaps = false;
+        break;
+      }
+    }
+    if (! overlaps)
+      continue;
+    state->outerslot = slot;
+    stjoin_box_cells(state, probe, state->lo, state->hi);
+    memcpy(state->cur, state->lo, sizeof(state->cur));
+    state->pos = 0;
+    state->probing = true;
+    return true;
+  }
+}
+
+/**
+ * @brief Return true if the box of an inner tuple overlaps the probe and the
+ * current cell contains the lower corner of their intersection
+ */
+static inline bool
+stjoin_box_match(const STJoinState *state, int id)
+{
+  const STJoinBox *box = &state->boxes[id];
+  for (int d = 0; d < STJOIN_DIMS; d++)
+  {
+    if (state->probe.max[d] < box->min[d] ||
+        state->probe.min[d] > box->max[d])
+      return false;
+    double corner = Max(state->probe.min[d], box->min[d]);
+    if (stjoin_cell_of(state, d, corner) != state->cur[d])
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Return in the last argument the next inner tuple matching the box
+ * of the current outer tuple, return false when all cells have been probed
+ */
+static bool
+stjoin_next_candidate(STJoinState *state, int *result)
+{
+  for (;;)
+  {
+    STJoinCell *cell = &state->cells[stjoin_cell_index(state, state->cur)];
+    while (state->pos < cell->count)
+    {
+      int id = cell->ids[state->pos++];
+      if (stjoin_box_match(state, id))
+      {
+        *result = id;
+        return true;
+      }
+    }
+    /* Advance to the next cell overlapped by the probe */
+    state->pos = 0;
+    int d;
+    for (d = STJOIN_DIMS - 1; d >= 0; d--)
+    {
+      if (++state->cur[d] <= state->hi[d])
+        break;
+      state->cur[d] = state->lo[d];
+    }
+    if (d < 0)
+      return false;
+  }
+}
+
+/*****************************************************************************
+ * Execution
+ *****************************************************************************/
+
+/**
+ * @brief Initialize the execution of a spatiotemporal join
+ */
+static void
+stjoin_begin(CustomScanState *node, EState *estate, int eflags)
+{
+  STJoinState *state = (STJoinState *) node;
+  CustomScan *cscan = (CustomScan *) node->ss.ps.plan;
+  PlanState *outerps = ExecInitNode((Plan *) linitial(cscan->custom_plans),
+    estate, eflags);
+  PlanState *innerps = ExecInitNode((Plan *) lsecond(cscan->custom_plans),
+    estate, eflags);
+  node->custom_ps = list_make2(outerps, innerps);
+  state->nouteratts = ExecGetResultType(outerps)->natts;
+  state->ninneratts = ExecGetResultType(innerps)->natts;
+  state->outer_key = ExecInitExpr((Expr *) linitial(cscan->custom_exprs),
+    &node->ss.ps);
+  state->inner_key = ExecInitExpr((Expr *) lsecond(cscan->custom_exprs),
+    &node->ss.ps);
+  state->dist_expr = ExecInitExpr((Expr *) lthird(cscan->custom_exprs),
+    &node->ss.ps);
+  state->innerslot = ExecInitExtraTupleSlot(estate,
+    ExecGetResultType(innerps), &TTSOpsMinimalTuple);
+  state->cxt = AllocSetContextCreate(estate->es_query_cxt,
+    "Spatiotemporal join", ALLOCSET_DEFAULT_SIZES);
+  state->built = false;
+  state->probing = false;
+  state->ncandidates = 0;
+  return;
+}
+
+/**
+ * @brief Return the next tuple of a spatiotemporal join
+ */
+static TupleTableSlot *
+stjoin_exec(CustomScanState *node)
+{
+  STJoinState *state = (STJoinState *) node;
+  ExprContext *econtext = node->ss.ps.ps_ExprContext;
+  if (! state->built)
+    stjoin_build(state);
+  /* Inner join with an empty inner side */
+  if (state->ntuples == 0)
+    return NULL;
+
+  for (;;)
+  {
+    if (! state->probing && ! stjoin_next_outer(state))
+      return NULL;
+    int id;
+    while (stjoin_next_candidate(state, &id))
+    {
+      CHECK_FOR_INTERRUPTS();
+      state->ncandidates++;
+      ResetExprContext(econtext);
+      ExecStoreMinimalTuple(state->tuples[id], state->innerslot, false);
+      stjoin_store(state, state->outerslot, state->innerslot);
+      econtext->ecxt_scantuple = node->ss.ss_ScanTupleSlot;
+      if (ExecQual(node->ss.ps.qual, econtext))
+      {
+        if (node->ss.ps.ps_ProjInfo)
+          return ExecProject(node->ss.ps.ps_ProjInfo);
+        return node->ss.ss_ScanTupleSlot;
+      }
+    }
+    state->probing = false;
+  }
+}
+
+/**
+ * @brief End the execution of a spatiotemporal join
+ */
+static void
+stjoin_end(CustomScanState *node)
+{
+  STJoinState *state = (STJoinState *) node;
+  ExecEndNode((PlanState *) linitial(node->custom_ps));
+  ExecEndNode((PlanState *) lsecond(node->custom_ps));
+  MemoryContextDelete(state->cxt);
+  return;
+}
+
+/**
+ * @brief Restart the execution of a spatiotemporal join
+ * @details The grid is only rebuilt when the parameters of the inner side
+ * have changed
+ */
+static void
+stjoin_rescan(CustomScanState *node)
+{
+  STJoinState *state = (STJoinState *) node;
+  PlanState *outerps = (PlanState *) linitial(node->custom_ps);
+  PlanState *innerps = (PlanState *) lsecond(node->custom_ps);
+  if (node->ss.ps.chgParam != NULL)
+  {
+    UpdateChangedParamSet(outerps, node->ss.ps.chgParam);
+    UpdateChangedParamSet(innerps, node->ss.ps.chgParam);
+  }
+  /* The children with changed parameters are rescanned by ExecProcNode */
+  if (outerps->chgParam == NULL)
+    ExecReScan(outerps);
+  if (innerps->chgParam != NULL)
+  {
+    MemoryContextReset(state->cxt);
+    state->built = false;
+  }
+  state->probing = false;
+  return;
+}
+
+/**
+ * @brief Show the size of the grid and the number of candidate pairs
+ */
+static void
+stjoin_explain(CustomScanState *node, List *ancestors __attribute__((unused)),
+  ExplainState *es)
+{
+  STJoinState *state = (STJoinState *) node;
+  if (! es->analyze || ! state->built)
+    return;
+  ExplainPropertyInteger("Inner Tuples", NULL, state->ntuples, es);
+  if (state->ntuples > 0)
+    ExplainPropertyInteger("Grid Cells", NULL,
+      (int64) state->ncells[0] * state->ncells[1] * state->ncells[2], es);
+  ExplainPropertyInteger("Candidate Pairs", NULL, state->ncandidates, es);
+  return;
+}
+
+/*****************************************************************************
+ * Registration
+ *****************************************************************************/
+
+static CustomPathMethods stjoin_path_methods = {
+  .CustomName = STJOIN_NAME,
+  .PlanCustomPath = stjoin_plan_path,
+};
+
+static CustomScanMethods stjoin_scan_methods = {
+  .CustomName = STJOIN_NAME,
+  .CreateCustomScanState = stjoin_create_state,
+};
+
+static CustomExecMethods stjoin_exec_methods = {
+  .CustomName = STJOIN_NAME,
+  .BeginCustomScan = stjoin_begin,
+  .ExecCustomScan = stjoin_exec,
+  .EndCustomScan = stjoin_end,
+  .ReScanCustomScan = stjoin_rescan,
+  .ExplainCustomScan = stjoin_explain,
+};
+
+/**
+ * @brief Register the custom scan provider for spatiotemporal joins
+ * @note The scan methods are registered so that the plans can be sent to
+ * the parallel workers
+ */
+void
+tpoint_join_init(void)
+{
+  RegisterCustomScanMethods(&stjoin_scan_methods);
+  prev_set_join_pathlist_hook = set_join_pathlist_hook;
+  set_join_pathlist_hook = stjoin_set_join_pathlist;
+  return;
+}
+
+/*****************************************************************************/
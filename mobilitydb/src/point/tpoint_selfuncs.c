@@ -40,6 +40,7 @@
 #include <postgres.h>
 #include <utils/lsyscache.h>
 #include <utils/syscache.h>
+#include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
@@ -677,6 +678,114 @@ geo_sel(VariableStatData *vardata, const STBox *box, meosOper oper)
   return selec;
 }
 
+/**
+ * @brief Return an estimate of the selectivity of a spatiotemporal search box
+ * by looking at the joint space-time histogram, or -1 if the histogram is not
+ * available
+ *
+ * The histogram is only collected for planar temporal points when the
+ * `mobilitydb.spacetime_histogram_size` parameter is set. Its third dimension
+ * is the time expressed in seconds, which allows the correlation between the
+ * spatial and the temporal dimensions to be taken into account when the
+ * search box has both dimensions. Only the bounding box operators are
+ * supported.
+ */
+Selectivity
+geo_time_sel(VariableStatData *vardata, const STBox *box, meosOper oper)
+{
+  ND_STATS *nd_stats;
+  AttStatsSlot sslot;
+  int d; /* counter */
+  Selectivity selec;
+  ND_BOX nd_box;
+  ND_IBOX nd_ibox;
+  int at[ND_DIMS];
+  double cell_size[ND_DIMS];
+  double min[ND_DIMS];
+  double total_count = 0.0;
+  int ndims = 3;
+
+  if (oper != OVERLAPS_OP && oper != CONTAINS_OP && oper != CONTAINED_OP &&
+      oper != SAME_OP)
+    return -1;
+
+  /* Get statistics */
+  if (! (HeapTupleIsValid(vardata->statsTuple) &&
+      get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_NDT,
+      InvalidOid, ATTSTATSSLOT_NUMBERS)))
+    return -1;
+
+  /* Clone the stats here so we can release the attstatsslot immediately */
+  nd_stats = palloc(sizeof(float4) * sslot.nnumbers);
+  memcpy(nd_stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
+  free_attstatsslot(&sslot);
+  if ((int) nd_stats->ndims != ndims)
+  {
+    pfree(nd_stats);
+    return -1;
+  }
+
+  /* Initialize nd_box with the time dimension expressed in seconds */
+  nd_box_init(&nd_box);
+  nd_box.min[X_DIM] = (float4) box->xmin;
+  nd_box.max[X_DIM] = (float4) box->xmax;
+  nd_box.min[Y_DIM] = (float4) box->ymin;
+  nd_box.max[Y_DIM] = (float4) box->ymax;
+  nd_box.min[2] = (float4) ((double) DatumGetTimestampTz(box->period.lower) /
+    USECS_PER_SEC);
+  nd_box.max[2] = (float4) ((double) DatumGetTimestampTz(box->period.upper) /
+    USECS_PER_SEC);
+
+  /* Full histogram extent overlaps box is false or true? */
+  if (! nd_box_intersects(&(nd_stats->extent), &nd_box, ndims))
+    selec = 0.0;
+  else if (nd_box_contains(&nd_box, &(nd_stats->extent), ndims))
+    selec = 1.0;
+  /* Calculate the overlap of the box on the histogram */
+  else if (! nd_box_overlap(nd_stats, &nd_box, &nd_ibox))
+    selec = FALLBACK_ND_SEL;
+  else
+  {
+    /* Work out some measurements of the histogram */
+    for (d = 0; d < ndims; d++)
+    {
+      min[d] = nd_stats->extent.min[d];
+      cell_size[d] = (nd_stats->extent.max[d] - min[d]) / nd_stats->size[d];
+    }
+
+    /* Initialize the counter */
+    memset(at, 0, sizeof(int) * ND_DIMS);
+    for (d = 0; d < ndims; d++)
+      at[d] = nd_ibox.min[d];
+
+    /* Move through all the overlap values and sum them */
+    do
+    {
+      ND_BOX nd_cell;
+      memset(&nd_cell, 0, sizeof(ND_BOX));
+      /* We have to pro-rate partially overlapped cells. */
+      for (d = 0; d < ndims; d++)
+      {
+        nd_cell.min[d] = (float4) (min[d] + (at[d]+0) * cell_size[d]);
+        nd_cell.max[d] = (float4) (min[d] + (at[d]+1) * cell_size[d]);
+      }
+      total_count += (double)
+        nd_stats->value[nd_stats_value_index(nd_stats, at)] *
+        nd_box_ratio_overlaps(&nd_box, &nd_cell, ndims);
+    }
+    while (nd_increment(&nd_ibox, ndims, at));
+
+    /* Scale by the number of features in our histogram to get the proportion */
+    selec = total_count / nd_stats->histogram_features;
+  }
+  pfree(nd_stats);
+
+  /* Prevent rounding overflows */
+  CLAMP_PROBABILITY(selec);
+
+  return selec;
+}
+
 /*****************************************************************************
  * Join selectivity
  *****************************************************************************/
@@ -748,9 +857,15 @@ pg_get_nd_stats(const Oid tableid, AttrNumber att_num, int mode, bool only_paren
 * of one histogram, and multiply the cell value by the
 * proportion of the cells in the other histogram the cell
 * overlaps: val += val1 * ( val2 * overlap_ratio )
+*
+* When the values of one relation are expanded in space, as in
+* t1.trip && expandSpace(t2.trip, d), the cells of the first histogram
+* are expanded by the distance d before computing the overlaps. Note
+* that expanding the values of one side is equivalent to expanding those
+* of the other side.
 */
 float8
-geo_joinsel(const ND_STATS *s1, const ND_STATS *s2)
+geo_joinsel(const ND_STATS *s1, const ND_STATS *s2, double expand)
 {
   int ncells1, ncells2;
   int ndims1, ndims2, ndims;
@@ -813,6 +928,16 @@ geo_joinsel(const ND_STATS *s1, const ND_STATS *s2)
   extent1 = s1->extent;
   extent2 = s2->extent;
 
+  /* Expand the extent of the second relation */
+  if ( expand > 0.0 )
+  {
+    for ( d = 0; d < ndims2; d++ )
+    {
+      extent2.min[d] -= (float4) expand;
+      extent2.max[d] += (float4) expand;
+    }
+  }
+
   /* If relation stats do not intersect, join is very very selective. */
   if ( ! nd_box_intersects(&extent1, &extent2, ndims) )
     return 0.0;
@@ -852,8 +977,8 @@ geo_joinsel(const ND_STATS *s1, const ND_STATS *s2)
     nd_box_init(&nd_cell1);
     for ( d = 0; d < ndims1; d++ )
     {
-      nd_cell1.min[d] = (float4) (min1[d] + (at1[d]+0) * cellsize1[d]);
-      nd_cell1.max[d] = (float4) (min1[d] + (at1[d]+1) * cellsize1[d]);
+      nd_cell1.min[d] = (float4) (min1[d] + (at1[d]+0) * cellsize1[d] - expand);
+      nd_cell1.max[d] = (float4) (min1[d] + (at1[d]+1) * cellsize1[d] + expand);
     }
 
     /* Find the cells of s2 that cell1 overlaps.. */
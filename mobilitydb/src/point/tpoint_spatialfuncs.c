@@ -286,11 +286,26 @@ Tpoint_AsMVTGeom(PG_FUNCTION_ARGS)
   int32_t buffer = PG_GETARG_INT32(3);
   bool clip_geom = PG_GETARG_BOOL(4);
 
+  /* The transformation into the tile is cached across the calls of the
+   * query since all rows of a tile share the same parameters */
+  MVTState *state = (MVTState *) fcinfo->flinfo->fn_extra;
+  if (state == NULL ||
+      ! tpoint_mvt_state_eq(state, bounds, extent, buffer, clip_geom))
+  {
+    MemoryContext oldctx = MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+    MVTState *newstate = tpoint_mvt_state_make(bounds, extent, buffer,
+      clip_geom);
+    MemoryContextSwitchTo(oldctx);
+    if (state)
+      pfree(state);
+    state = newstate;
+    fcinfo->flinfo->fn_extra = state;
+  }
+
   GSERIALIZED *geom;
   int64 *times; /* Timestamps are returned in Unix time */
   int count;
-  bool found = tpoint_AsMVTGeom(temp, bounds, extent, buffer, clip_geom,
-    &geom, &times, &count);
+  bool found = tpoint_mvt_state_push(state, temp, &geom, &times, &count);
   if (! found)
   {
     PG_FREE_IF_COPY(temp, 0);
@@ -51,7 +51,9 @@
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/span.h"
 #include "general/temporal.h" /* For varfunc */
+#include "point/stbox.h"
 #include "point/tpoint_spatialfuncs.h"
 /* MobilityDB */
 #include "pg_point/postgis.h"
@@ -358,6 +360,29 @@ Aintersects_tpoint_geo(PG_FUNCTION_ARGS)
   return EAintersects_tpoint_geo(fcinfo, ALWAYS);
 }
 
+PGDLLEXPORT Datum Eintersects_tpoint_span_stbox_geo(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Eintersects_tpoint_span_stbox_geo);
+/**
+ * @ingroup mobilitydb_temporal_spatial_rel_ever
+ * @brief Return true if a temporal point restricted to a time span and to a
+ * spatiotemporal box ever intersects a geometry
+ * @sqlfn eIntersects()
+ */
+Datum
+Eintersects_tpoint_span_stbox_geo(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Span *s = PG_GETARG_SPAN_P(1);
+  STBox *box = PG_GETARG_STBOX_P(2);
+  GSERIALIZED *gs = PG_GETARG_GSERIALIZED_P(3);
+  int result = eintersects_tpoint_span_stbox_geo(temp, s, box, gs);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_FREE_IF_COPY(gs, 3);
+  if (result < 0)
+    PG_RETURN_NULL();
+  PG_RETURN_BOOL(result);
+}
+
 PGDLLEXPORT Datum Eintersects_tpoint_tpoint(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(Eintersects_tpoint_tpoint);
 /**
@@ -100,11 +100,16 @@
 /* PostgreSQL */
 #include <postgres.h>
 #include <access/spgist.h>
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  #include <access/reloptions.h>
+#endif
 #include <utils/float.h>
 #include <utils/timestamp.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/meos_probes.h"
+#include "general/set.h"
 #include "general/span.h"
 #include "general/temporal.h"
 #include "general/type_util.h"
@@ -139,10 +144,55 @@ typedef struct SortedSTbox
   int i;
 } SortedSTbox;
 
+/* Default and maximum number of levels of a k-d tree split on time */
+#define KDTREE_TIME_LEVELS_DEFAULT 0
+#define KDTREE_TIME_LEVELS_MAX     64
+
+/**
+ * @brief Structure for the options of the k-d tree SP-GiST operator classes
+ */
+typedef struct
+{
+  int32 vl_len_;      /**< Varlena header (do not touch directly!) */
+  int time_levels;    /**< Number of top levels split on time */
+} STboxKdtreeOptions;
+
 /*****************************************************************************
  * General functions
  *****************************************************************************/
 
+/**
+ * @brief Return the number of top levels of a k-d tree that are split on
+ * time from the options of the operator class
+ */
+static int
+kdtree_time_levels(FunctionCallInfo fcinfo)
+{
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+  if (PG_HAS_OPCLASS_OPTIONS())
+    return ((STboxKdtreeOptions *) PG_GET_OPCLASS_OPTIONS())->time_levels;
+#endif /* POSTGRESQL_VERSION_NUMBER >= 140000 */
+  return KDTREE_TIME_LEVELS_DEFAULT;
+}
+
+/**
+ * @brief Return the bound split at a level of a k-d tree
+ * @details The bounds are numbered xmin, xmax, ymin, ymax, [zmin, zmax,]
+ * tmin, tmax, that is, from 0 to 5 for 2D boxes and from 0 to 7 for 3D boxes.
+ * The first `time_levels` levels alternately split the lower and the upper
+ * bound of the period, which results in shallower trees for queries that
+ * are selective in time, and the following levels split all the bounds in
+ * turns.
+ */
+static int
+kdtree_level_mod(int level, bool hasz, int time_levels)
+{
+  if (level < time_levels)
+    return (hasz ? 6 : 4) + level % 2;
+  level -= time_levels;
+  return hasz ? level % 8 : level % 6;
+}
+
 /**
  * @brief Copy a STboxNode
  */
@@ -290,15 +340,14 @@ stboxnode_quadtree_next(const STboxNode *nodebox, const STBox *centroid,
 /**
  * @brief Compute the next traversal value for a k-d tree given the bounding
  * box and the centroid of the current node, the half number (0 or 1) and the
- * level.
+ * bound split at the level of the node.
  */
 static void
 stboxnode_kdtree_next(const STboxNode *nodebox, const STBox *centroid,
-  uint8 node, int level, STboxNode *next_nodebox)
+  uint8 node, int mod, STboxNode *next_nodebox)
 {
   bool hasz = MEOS_FLAGS_GET_Z(centroid->flags);
   memcpy(next_nodebox, nodebox, sizeof(STboxNode));
-  int mod = hasz ? level % 8 : level % 6 ;
   if (mod == 0)
   {
     /* Split the bounding box by lower bound  */
@@ -393,10 +442,9 @@ overlap8D(const STboxNode *nodebox, const STBox *query)
  * @brief Can any box from nodebox overlap with query?
  */
 static bool
-overlapKD(const STboxNode *nodebox, const STBox *query, int level)
+overlapKD(const STboxNode *nodebox, const STBox *query, int mod)
 {
   bool hasz = MEOS_FLAGS_GET_Z(nodebox->left.flags);
-  int mod = hasz ? level % 8 : level % 6;
   bool result = true;
   /* Result value is computed only for the dimensions of the query */
   if (MEOS_FLAGS_GET_X(query->flags))
@@ -456,10 +504,9 @@ contain8D(const STboxNode *nodebox, const STBox *query)
  * @brief Can any box from nodebox overlap with query?
  */
 static bool
-containKD(const STboxNode *nodebox, const STBox *query, int level)
+containKD(const STboxNode *nodebox, const STBox *query, int mod)
 {
   bool hasz = MEOS_FLAGS_GET_Z(nodebox->left.flags);
-  int mod = hasz ? level % 8 : level % 6;
   bool result = true;
   /* Result value is computed only for the dimensions of the query */
   if (MEOS_FLAGS_GET_X(query->flags))
@@ -697,24 +744,8 @@ distance_stbox_nodebox(const STBox *query, const STboxNode *nodebox)
 static bool
 tpoint_spgist_get_stbox(const ScanKeyData *scankey, STBox *result)
 {
-  meosType type = oid_type(scankey->sk_subtype);
-  if (type == T_TSTZSPAN)
-  {
-    Span *s = DatumGetSpanP(scankey->sk_argument);
-    tstzspan_set_stbox(s, result);
-  }
-  else if (type == T_STBOX)
-  {
-    memcpy(result, DatumGetSTboxP(scankey->sk_argument), sizeof(STBox));
-  }
-  else if (tspatial_type(type))
-  {
-    Temporal *temp = temporal_slice(scankey->sk_argument);
-    tspatial_set_stbox(temp, result);
-  }
-  else
-    elog(ERROR, "Unsupported type for indexing: %d", type);
-  return true;
+  return tspatial_index_get_stbox(scankey->sk_argument,
+    oid_type(scankey->sk_subtype), result);
 }
 
 /*****************************************************************************
@@ -903,10 +934,9 @@ stbox_tmax_cmp(const STBox *box1, const STBox *box2)
 /*****************************************************************************/
 
 static int
-stbox_level_cmp(STBox *centroid, STBox *query, int level)
+stbox_level_cmp(STBox *centroid, STBox *query, int mod)
 {
   bool hasz = MEOS_FLAGS_GET_Z(centroid->flags);
-  int mod = hasz ? level % 8 : level % 6;
   if (mod == 0)
     return stbox_xmin_cmp(query, centroid);
   else if (mod == 1)
@@ -940,8 +970,10 @@ Stbox_kdtree_choose(PG_FUNCTION_ARGS)
   centroid = DatumGetSTboxP(in->prefixDatum);
   assert(in->nNodes == 2);
   out->resultType = spgMatchNode;
+  int mod = kdtree_level_mod(in->level, MEOS_FLAGS_GET_Z(centroid->flags),
+    kdtree_time_levels(fcinfo));
   out->result.matchNode.nodeN =
-    (stbox_level_cmp(centroid, query, in->level) < 0) ? 0 : 1;
+    (stbox_level_cmp(centroid, query, mod) < 0) ? 0 : 1;
   out->result.matchNode.levelAdd = 1;
   out->result.matchNode.restDatum = STboxPGetDatum(query);
   PG_RETURN_VOID();
@@ -1079,7 +1111,7 @@ Stbox_kdtree_picksplit(PG_FUNCTION_ARGS)
     sorted[i].i = i;
   }
   bool hasz = MEOS_FLAGS_GET_Z(sorted[0].box.flags);
-  int mod = hasz ? in->level % 8 : in->level % 6;
+  int mod = kdtree_level_mod(in->level, hasz, kdtree_time_levels(fcinfo));
   qsort_comparator qsortfn;
   if (mod == 0)
     qsortfn = (qsort_comparator) &stbox_xmin_cmp;
@@ -1145,6 +1177,9 @@ stbox_spgist_inner_consistent(FunctionCallInfo fcinfo, SPGistIndexType idxtype)
   /* Fetch the centroid of this node. */
   assert(in->hasPrefix);
   centroid = DatumGetSTboxP(in->prefixDatum);
+  /* Bound split at the level of the node for k-d trees */
+  int mod = (idxtype == SPGIST_QUADTREE) ? 0 : kdtree_level_mod(in->level,
+    MEOS_FLAGS_GET_Z(centroid->flags), kdtree_time_levels(fcinfo));
 
   /*
    * We are saving the traversal value or initialize it an unbounded one, if
@@ -1241,7 +1276,7 @@ stbox_spgist_inner_consistent(FunctionCallInfo fcinfo, SPGistIndexType idxtype)
     if (idxtype == SPGIST_QUADTREE)
       stboxnode_quadtree_next(nodebox, centroid, (uint8) node, &next_nodebox);
     else
-      stboxnode_kdtree_next(nodebox, centroid, (uint8) node, in->level,
+      stboxnode_kdtree_next(nodebox, centroid, (uint8) node, mod,
         &next_nodebox);
     bool flag = true;
     for (i = 0; i < in->nkeys; i++)
@@ -1254,13 +1289,13 @@ stbox_spgist_inner_consistent(FunctionCallInfo fcinfo, SPGistIndexType idxtype)
         case RTAdjacentStrategyNumber:
           flag = (idxtype == SPGIST_QUADTREE) ?
             overlap8D(&next_nodebox, &queries[i]) :
-            overlapKD(&next_nodebox, &queries[i], in->level);
+            overlapKD(&next_nodebox, &queries[i], mod);
           break;
         case RTContainsStrategyNumber:
         case RTSameStrategyNumber:
           flag = (idxtype == SPGIST_QUADTREE) ?
             contain8D(&next_nodebox, &queries[i]) :
-            containKD(&next_nodebox, &queries[i], in->level);
+            containKD(&next_nodebox, &queries[i], mod);
           break;
         case RTLeftStrategyNumber:
           flag = ! overRight8D(&next_nodebox, &queries[i]);
@@ -1340,6 +1375,9 @@ stbox_spgist_inner_consistent(FunctionCallInfo fcinfo, SPGistIndexType idxtype)
   /* Switch back to initial memory context */
   MemoryContextSwitchTo(old_ctx);
 
+  MEOS_PROBE_INDEX_SPGIST_INNER(
+    in->nkeys > 0 ? in->scankeys[0].sk_strategy : 0, in->nNodes, out->nNodes);
+
   if (in->nkeys > 0)
     pfree(queries);
   if (in->norderbys > 0)
@@ -1370,6 +1408,28 @@ Stbox_kdtree_inner_consistent(PG_FUNCTION_ARGS)
   return stbox_spgist_inner_consistent(fcinfo, SPGIST_KDTREE);
 }
 
+#if POSTGRESQL_VERSION_NUMBER >= 140000
+PGDLLEXPORT Datum Stbox_kdtree_options(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_kdtree_options);
+/**
+ * @brief K-d tree options function for spatiotemporal boxes
+ * @details The option `time_levels` states the number of top levels of the
+ * tree that split the time dimension before splitting all the dimensions in
+ * turns. The default value 0 splits all the dimensions in turns from the root.
+ */
+Datum
+Stbox_kdtree_options(PG_FUNCTION_ARGS)
+{
+  local_relopts *relopts = (local_relopts *) PG_GETARG_POINTER(0);
+  init_local_reloptions(relopts, sizeof(STboxKdtreeOptions));
+  add_local_int_reloption(relopts, "time_levels",
+    "number of top levels of the tree split on time",
+    KDTREE_TIME_LEVELS_DEFAULT, 0, KDTREE_TIME_LEVELS_MAX,
+    offsetof(STboxKdtreeOptions, time_levels));
+  PG_RETURN_VOID();
+}
+#endif /* POSTGRESQL_VERSION_NUMBER >= 140000 */
+
 /*****************************************************************************
  * SP-GiST leaf-level consistency function
  *****************************************************************************/
@@ -1393,6 +1453,7 @@ Stbox_spgist_leaf_consistent(PG_FUNCTION_ARGS)
 
   /* leafDatum is what it is... */
   out->leafValue = in->leafDatum;
+  MEOS_STAT_ADD(MEOS_STAT_INDEX_CONSISTENT, 1);
 
   /* Perform the required comparison(s) */
   for (i = 0; i < in->nkeys; i++)
@@ -1410,6 +1471,9 @@ Stbox_spgist_leaf_consistent(PG_FUNCTION_ARGS)
       break;
   }
 
+  if (result && out->recheck)
+    MEOS_STAT_ADD(MEOS_STAT_INDEX_RECHECKS, 1);
+
   if (result && in->norderbys > 0)
   {
     /* Recheck is necessary when computing distance with bounding boxes */
@@ -1449,4 +1513,17 @@ Tpoint_spgist_compress(PG_FUNCTION_ARGS)
   PG_RETURN_STBOX_P(result);
 }
 
+PGDLLEXPORT Datum Spatialset_spgist_compress(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Spatialset_spgist_compress);
+/**
+ * @brief SP-GiST compress functions for spatial sets
+ */
+Datum
+Spatialset_spgist_compress(PG_FUNCTION_ARGS)
+{
+  Set *set = PG_GETARG_SET_P(0);
+  STBox *result = spatialset_to_stbox(set);
+  PG_RETURN_STBOX_P(result);
+}
+
 /*****************************************************************************/
@@ -44,11 +44,17 @@
 
 #include "point/tpoint_tempspatialrels.h"
 
+/* PostgreSQL */
+#include <postgres.h>
+#include <funcapi.h>
+#include <access/htup_details.h>
+#include <utils/array.h>
 /* PostGIS */
 #include <liblwgeom.h>
 /* MEOS */
 #include <meos.h>
 /* MobilityDB */
+#include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
 #include "pg_point/tpoint_spatialfuncs.h"
 
@@ -266,6 +272,88 @@ Tintersects_tpoint_tpoint(PG_FUNCTION_ARGS)
   return Tinterrel_tpoint_tpoint(fcinfo, TINTERSECTS);
 }
 
+/*****************************************************************************
+ * Temporal intersects with an array of geometries
+ *****************************************************************************/
+
+/**
+ * @brief State of the function that returns the time at which a temporal
+ * point intersects each geometry of an array
+ */
+typedef struct
+{
+  int i;               /**< Current geometry */
+  int count;           /**< Number of geometries */
+  SpanSet **spansets;  /**< Time at which each geometry is intersected */
+} TpointGeoarrState;
+
+PGDLLEXPORT Datum Tintersects_tpoint_geoarr(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tintersects_tpoint_geoarr);
+/**
+ * @ingroup mobilitydb_temporal_spatial_rel_temp
+ * @brief Return the index and the time at which a temporal point intersects
+ * each geometry of an array, the geometries that are never intersected are
+ * not returned
+ * @sqlfn whenIntersects()
+ */
+Datum
+Tintersects_tpoint_geoarr(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  TpointGeoarrState *state;
+  bool isnull[2] = {0,0}; /* needed to say no value is null */
+  Datum tuple_arr[2]; /* used to construct the composite return value */
+  HeapTuple tuple;
+  Datum result; /* the actual composite return value */
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    /* Get input parameters */
+    Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+    ArrayType *array = PG_GETARG_ARRAYTYPE_P(1);
+    int count;
+    Datum *geoarr = datumarr_extract(array, &count);
+    /* Create function state */
+    state = palloc0(sizeof(TpointGeoarrState));
+    state->count = count;
+    if (count > 0)
+      state->spansets = tintersects_tpoint_geoarr(temp,
+        (const GSERIALIZED **) geoarr, count);
+    /* We cannot use pfree_array */
+    pfree(geoarr);
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Skip the geometries that are never intersected */
+  while (state->i < state->count && ! state->spansets[state->i])
+    state->i++;
+  /* Stop when we've used up all the geometries */
+  if (state->i == state->count)
+    SRF_RETURN_DONE(funcctx);
+
+  /* Form tuple and return, the indexes of SQL arrays start at 1 */
+  tuple_arr[0] = Int32GetDatum(state->i + 1);
+  tuple_arr[1] = PointerGetDatum(state->spansets[state->i]);
+  state->i++;
+  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
 /*****************************************************************************
  * Temporal touches
  *****************************************************************************/
@@ -432,3 +520,99 @@ Tdwithin_tpoint_tpoint(PG_FUNCTION_ARGS)
 }
 
 /*****************************************************************************/
+
+/*****************************************************************************
+ * Spatiotemporal join of two arrays of temporal points
+ *****************************************************************************/
+
+/**
+ * @brief State of the function that returns the pairs of temporal points of
+ * two arrays that are within a distance
+ */
+typedef struct
+{
+  int i;               /**< Current pair */
+  int count;           /**< Number of pairs */
+  int *idx1;           /**< Positions of the first temporal points */
+  int *idx2;           /**< Positions of the second temporal points */
+  SpanSet **spansets;  /**< Time at which the pairs are within distance */
+} TpointPairsState;
+
+PGDLLEXPORT Datum Tdwithin_tpointarr_tpointarr(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tdwithin_tpointarr_tpointarr);
+/**
+ * @ingroup mobilitydb_temporal_spatial_rel_temp
+ * @brief Return the pairs of temporal points of two arrays that are within a
+ * distance at some instant and the time at which they are
+ * @note When a single array is given the pairs of temporal points of the
+ * array are returned
+ * @sqlfn dwithinPairs()
+ */
+Datum
+Tdwithin_tpointarr_tpointarr(PG_FUNCTION_ARGS)
+{
+  FuncCallContext *funcctx;
+  TpointPairsState *state;
+  bool isnull[3] = {0,0,0}; /* needed to say no value is null */
+  Datum tuple_arr[3]; /* used to construct the composite return value */
+  HeapTuple tuple;
+  Datum result; /* the actual composite return value */
+
+  /* If the function is being called for the first time */
+  if (SRF_IS_FIRSTCALL())
+  {
+    /* Initialize the FuncCallContext */
+    funcctx = SRF_FIRSTCALL_INIT();
+    /* Switch to memory context appropriate for multiple function calls */
+    MemoryContext oldcontext =
+      MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+    /* Get input parameters */
+    ArrayType *array1 = PG_GETARG_ARRAYTYPE_P(0);
+    ArrayType *array2 = NULL;
+    double dist;
+    if (PG_NARGS() == 3)
+    {
+      array2 = PG_GETARG_ARRAYTYPE_P(1);
+      dist = PG_GETARG_FLOAT8(2);
+    }
+    else
+      dist = PG_GETARG_FLOAT8(1);
+    int count1, count2 = 0;
+    Temporal **temparr1 = temparr_extract(array1, &count1);
+    Temporal **temparr2 = array2 ? temparr_extract(array2, &count2) : NULL;
+    /* Create function state */
+    state = palloc0(sizeof(TpointPairsState));
+    if (count1 > 0 && (! array2 || count2 > 0))
+      state->count = tdwithin_tpointarr_tpointarr(
+        (const Temporal **) temparr1, count1, (const Temporal **) temparr2,
+        count2, dist, &state->idx1, &state->idx2, &state->spansets);
+    /* We cannot use pfree_array */
+    pfree(temparr1);
+    if (temparr2)
+      pfree(temparr2);
+    funcctx->user_fctx = state;
+    /* Build a tuple description for the function output */
+    get_call_result_type(fcinfo, 0, &funcctx->tuple_desc);
+    BlessTupleDesc(funcctx->tuple_desc);
+    MemoryContextSwitchTo(oldcontext);
+  }
+
+  /* Stuff done on every call of the function */
+  funcctx = SRF_PERCALL_SETUP();
+  /* Get state */
+  state = funcctx->user_fctx;
+  /* Stop when we've used up all the pairs */
+  if (state->i >= state->count)
+    SRF_RETURN_DONE(funcctx);
+
+  /* Form tuple and return, the indexes of SQL arrays start at 1 */
+  tuple_arr[0] = Int32GetDatum(state->idx1[state->i] + 1);
+  tuple_arr[1] = Int32GetDatum(state->idx2[state->i] + 1);
+  tuple_arr[2] = PointerGetDatum(state->spansets[state->i]);
+  state->i++;
+  tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
+  result = HeapTupleGetDatum(tuple);
+  SRF_RETURN_NEXT(funcctx, result);
+}
+
+/*****************************************************************************/
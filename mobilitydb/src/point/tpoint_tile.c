@@ -37,18 +37,30 @@
 /* PostgreSQL */
 #include <postgres.h>
 #include <funcapi.h>
+#include <access/htup_details.h>
+#include <utils/array.h>
+#include <utils/lsyscache.h>
+#include <utils/syscache.h>
 #include <utils/timestamp.h>
+#include <utils/typcache.h>
 /* PostGIS */
 #include <liblwgeom.h>
 /* MEOS */
 #include <meos.h>
 #include <meos_internal.h>
+#include "general/set.h"
 #include "general/temporal_tile.h"
 #include "point/stbox.h"
+#include "point/tpoint.h"
 #include "point/tpoint_spatialfuncs.h"
 #include "point/tpoint_tile.h"
 /* MobilityDB */
+#include "pg_general/meos_catalog.h"
+#include "pg_general/skiplist.h"
+#include "pg_general/type_util.h"
 #include "pg_point/postgis.h"
+#include "pg_point/tpoint_analyze.h"
+#include "pg_point/tpoint_selfuncs.h"
 
 /*****************************************************************************/
 
@@ -225,6 +237,92 @@ Stbox_tile(PG_FUNCTION_ARGS)
     sorigin, torigin, hast));
 }
 
+/*****************************************************************************
+ * Grids cached across the calls of a query
+ *****************************************************************************/
+
+/**
+ * @brief Return the grid cached for a function, which is created in the
+ * memory context of the function if there is none, or updated if its
+ * parameters change
+ * @details Since the parameters of the grid are usually constant in a query,
+ * the set of tiles of the cached grid is reused across the calls of the
+ * function.
+ * @param[in] flinfo Catalog information about the function
+ * @param[in] cache Cached grid, may be NULL
+ * @param[in] params Parameters of the grid
+ */
+static STBoxGrid *
+tpoint_grid_cache(FmgrInfo *flinfo, STBoxGrid *cache, const STBoxGrid *params)
+{
+  if (cache)
+  {
+    if (! stbox_grid_eq(cache, params))
+    {
+      void *tiles = cache->tiles;
+      memcpy(cache, params, sizeof(STBoxGrid));
+      cache->tiles = tiles;
+    }
+    return cache;
+  }
+  MemoryContext oldctx = MemoryContextSwitchTo(flinfo->fn_mcxt);
+  STBoxGrid *result = stbox_grid_copy(params);
+  MemoryContextSwitchTo(oldctx);
+  return result;
+}
+
+/**
+ * Grid cached for the split functions. Since the fn_extra field of these
+ * set-returning functions is used by the set-returning function machinery,
+ * the grid is kept for the first function that needs one and it is forgotten
+ * when the memory context of this function is reset.
+ */
+static struct
+{
+  FmgrInfo *flinfo;      /**< Function for which the grid is cached */
+  STBoxGrid *grid;       /**< Grid allocated in the memory context of the
+                              function */
+} SPLIT_GRID_CACHE = {NULL, NULL};
+
+/**
+ * @brief Forget the grid cached for the split functions when the memory
+ * context in which it is allocated is reset
+ */
+static void
+split_grid_cache_reset(void *arg)
+{
+  if (SPLIT_GRID_CACHE.grid == (STBoxGrid *) arg)
+  {
+    SPLIT_GRID_CACHE.flinfo = NULL;
+    SPLIT_GRID_CACHE.grid = NULL;
+  }
+  return;
+}
+
+/**
+ * @brief Return the grid of a split function, which is the grid cached for
+ * the function, if any
+ * @note When the cache is used by another function, as when several split
+ * functions are called in the same query, the parameters are returned, so
+ * that the set of tiles is not reused
+ */
+static STBoxGrid *
+split_grid_cache(FmgrInfo *flinfo, STBoxGrid *params)
+{
+  if (SPLIT_GRID_CACHE.grid)
+    return (SPLIT_GRID_CACHE.flinfo == flinfo) ?
+      tpoint_grid_cache(flinfo, SPLIT_GRID_CACHE.grid, params) : params;
+  STBoxGrid *result = tpoint_grid_cache(flinfo, NULL, params);
+  MemoryContextCallback *callback = MemoryContextAlloc(flinfo->fn_mcxt,
+    sizeof(MemoryContextCallback));
+  callback->func = split_grid_cache_reset;
+  callback->arg = (void *) result;
+  MemoryContextRegisterResetCallback(flinfo->fn_mcxt, callback);
+  SPLIT_GRID_CACHE.flinfo = flinfo;
+  SPLIT_GRID_CACHE.grid = result;
+  return result;
+}
+
 /*****************************************************************************
  * Split functions
  *****************************************************************************/
@@ -232,9 +330,14 @@ Stbox_tile(PG_FUNCTION_ARGS)
 /**
  * @brief Split a temporal point with respect to a spatial and possibly a
  * temporal grid
+ * @param[in] fcinfo Catalog information about the external function
+ * @param[in] timesplit True when splitting with respect to a temporal grid
+ * @param[in] keys True when the tiles of the fragments are identified by
+ * their keys rather than by their buckets
  */
-Datum
-Tpoint_space_time_split_ext(FunctionCallInfo fcinfo, bool timesplit)
+static Datum
+Tpoint_space_time_split_ext(FunctionCallInfo fcinfo, bool timesplit,
+  bool keys)
 {
   FuncCallContext *funcctx;
   STboxGridState *state;
@@ -271,10 +374,15 @@ Tpoint_space_time_split_ext(FunctionCallInfo fcinfo, bool timesplit)
       bitmatrix = false;
     bool border_inc = PG_GETARG_BOOL(i++);
 
-    /* Initialize state and verify parameter validity */
+    /* Verify parameter validity and get the grid cached for the function */
+    STBoxGrid params;
+    stbox_grid_set(xsize, ysize, zsize, duration, sorigin, torigin, &params);
+    STBoxGrid *grid = split_grid_cache(fcinfo->flinfo, &params);
+
+    /* Initialize state */
     int ntiles;
-    STboxGridState *state = tpoint_space_time_split_init(temp, xsize, ysize,
-      zsize, duration, sorigin, torigin, bitmatrix, border_inc, &ntiles);
+    STboxGridState *state = tpoint_grid_split_init(temp, grid, bitmatrix,
+      border_inc, &ntiles);
 
     /* Create function state */
     funcctx->user_fctx = state;
@@ -298,9 +406,7 @@ Tpoint_space_time_split_ext(FunctionCallInfo fcinfo, bool timesplit)
       /* Switch to memory context appropriate for multiple function calls */
       MemoryContext oldcontext =
         MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-      if (state->bm)
-         pfree(state->bm);
-      pfree(state);
+      stbox_tile_state_free(state);
       MemoryContextSwitchTo(oldcontext);
       SRF_RETURN_DONE(funcctx);
     }
@@ -315,27 +421,30 @@ Tpoint_space_time_split_ext(FunctionCallInfo fcinfo, bool timesplit)
       /* Switch to memory context appropriate for multiple function calls */
       MemoryContext oldcontext =
         MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-      if (state->bm)
-        pfree(state->bm);
-      pfree(state);
+      stbox_tile_state_free(state);
       MemoryContextSwitchTo(oldcontext);
       SRF_RETURN_DONE(funcctx);
     }
-    stbox_tile_state_next(state);
 
-    /* Restrict the temporal point to the box */
-    Temporal *atstbox = tpoint_restrict_stbox(state->temp, &box, BORDER_EXC,
-      REST_AT);
+    /* Restrict the temporal point to the box and advance the state */
+    Temporal *atstbox = stbox_tile_state_restrict(state, &box);
+    int64 key = (atstbox && keys) ? stbox_tile_state_key(state) : 0;
+    stbox_tile_state_next(state);
     if (atstbox == NULL)
       continue;
 
     /* Form tuple and return */
     int i = 0;
-    hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
-    tuple_arr[i++] = PointerGetDatum(geopoint_make(box.xmin, box.ymin,
-      box.zmin, hasz, false, box.srid));
-    if (timesplit)
-      tuple_arr[i++] = box.period.lower;
+    if (keys)
+      tuple_arr[i++] = Int64GetDatum(key);
+    else
+    {
+      hasz = MEOS_FLAGS_GET_Z(state->temp->flags);
+      tuple_arr[i++] = PointerGetDatum(geopoint_make(box.xmin, box.ymin,
+        box.zmin, hasz, false, box.srid));
+      if (timesplit)
+        tuple_arr[i++] = box.period.lower;
+    }
     tuple_arr[i++] = PointerGetDatum(atstbox);
     tuple = heap_form_tuple(funcctx->tuple_desc, tuple_arr, isnull);
     result = HeapTupleGetDatum(tuple);
@@ -353,7 +462,7 @@ PG_FUNCTION_INFO_V1(Tpoint_space_split);
 Datum
 Tpoint_space_split(PG_FUNCTION_ARGS)
 {
-  return Tpoint_space_time_split_ext(fcinfo, false);
+  return Tpoint_space_time_split_ext(fcinfo, false, false);
 }
 
 PGDLLEXPORT Datum Tpoint_space_time_split(PG_FUNCTION_ARGS);
@@ -366,7 +475,611 @@ PG_FUNCTION_INFO_V1(Tpoint_space_time_split);
 Datum
 Tpoint_space_time_split(PG_FUNCTION_ARGS)
 {
-  return Tpoint_space_time_split_ext(fcinfo, true);
+  return Tpoint_space_time_split_ext(fcinfo, true, false);
+}
+
+/*****************************************************************************/
+
+/*****************************************************************************
+ * Tile identifiers
+ *****************************************************************************/
+
+/**
+ * @brief Return the set of identifiers of the tiles of a spatial and possibly
+ * a temporal grid that intersect a spatiotemporal box
+ */
+static Datum
+Stbox_space_time_tiles_ext(FunctionCallInfo fcinfo, bool timetile)
+{
+  STBox *bounds = PG_GETARG_STBOX_P(0);
+  double xsize = PG_GETARG_FLOAT8(1);
+  double ysize = PG_GETARG_FLOAT8(2);
+  double zsize = PG_GETARG_FLOAT8(3);
+  Interval *duration = NULL;
+  TimestampTz torigin = 0;
+  int i = 4;
+  if (timetile)
+    duration = PG_GETARG_INTERVAL_P(i++);
+  GSERIALIZED *sorigin = PG_GETARG_GSERIALIZED_P(i++);
+  if (timetile)
+    torigin = PG_GETARG_TIMESTAMPTZ(i++);
+  Set *result = stbox_space_time_tiles(bounds, xsize, ysize, zsize, duration,
+    sorigin, torigin);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_SET_P(result);
+}
+
+PGDLLEXPORT Datum Stbox_space_tiles(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_space_tiles);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the set of identifiers of the tiles of a spatial grid that
+ * intersect a spatiotemporal box
+ * @sqlfn spaceTiles()
+ */
+Datum
+Stbox_space_tiles(PG_FUNCTION_ARGS)
+{
+  return Stbox_space_time_tiles_ext(fcinfo, false);
+}
+
+PGDLLEXPORT Datum Stbox_space_time_tiles(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stbox_space_time_tiles);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the set of identifiers of the tiles of a spatiotemporal grid
+ * that intersect a spatiotemporal box
+ * @sqlfn spaceTimeTiles()
+ */
+Datum
+Stbox_space_time_tiles(PG_FUNCTION_ARGS)
+{
+  return Stbox_space_time_tiles_ext(fcinfo, true);
+}
+
+/**
+ * @brief Return the set of identifiers of the tiles of a spatial and possibly
+ * a temporal grid traversed by a temporal point
+ */
+static Datum
+Tpoint_space_time_tiles_ext(FunctionCallInfo fcinfo, bool timetile)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  double xsize = PG_GETARG_FLOAT8(1);
+  double ysize = PG_GETARG_FLOAT8(2);
+  double zsize = PG_GETARG_FLOAT8(3);
+  Interval *duration = NULL;
+  TimestampTz torigin = 0;
+  int i = 4;
+  if (timetile)
+    duration = PG_GETARG_INTERVAL_P(i++);
+  GSERIALIZED *sorigin = PG_GETARG_GSERIALIZED_P(i++);
+  if (timetile)
+    torigin = PG_GETARG_TIMESTAMPTZ(i++);
+
+  /* The grid is cached across the calls of the query since its parameters
+   * are usually constant */
+  STBoxGrid params;
+  stbox_grid_set(xsize, ysize, zsize, duration, sorigin, torigin, &params);
+  STBoxGrid *grid = tpoint_grid_cache(fcinfo->flinfo,
+    (STBoxGrid *) fcinfo->flinfo->fn_extra, &params);
+  fcinfo->flinfo->fn_extra = grid;
+
+  Set *result = tpoint_grid_tiles(temp, grid);
+  PG_FREE_IF_COPY(temp, 0);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_SET_P(result);
+}
+
+PGDLLEXPORT Datum Tpoint_space_tiles(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_space_tiles);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the set of identifiers of the tiles of a spatial grid
+ * traversed by a temporal point
+ * @sqlfn spaceTiles()
+ */
+Datum
+Tpoint_space_tiles(PG_FUNCTION_ARGS)
+{
+  return Tpoint_space_time_tiles_ext(fcinfo, false);
+}
+
+PGDLLEXPORT Datum Tpoint_space_time_tiles(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_space_time_tiles);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the set of identifiers of the tiles of a spatiotemporal grid
+ * traversed by a temporal point
+ * @sqlfn spaceTimeTiles()
+ */
+Datum
+Tpoint_space_time_tiles(PG_FUNCTION_ARGS)
+{
+  return Tpoint_space_time_tiles_ext(fcinfo, true);
+}
+
+/*****************************************************************************
+ * Hierarchical tile keys
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tile_key(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tile_key);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the key of the tile of a spatial and possibly a temporal grid
+ * that contains a point and possibly a timestamp
+ * @sqlfn tileKey()
+ */
+Datum
+Tile_key(PG_FUNCTION_ARGS)
+{
+  GSERIALIZED *point = PG_GETARG_GSERIALIZED_P(0);
+  double xsize, ysize, zsize;
+  GSERIALIZED *sorigin;
+  TimestampTz t = 0; /* make compiler quiet */
+  TimestampTz torigin = 0; /* make compiler quiet */
+  Interval *duration = NULL; /* make compiler quiet */
+  bool hast = false;
+  assert(PG_NARGS() == 5 || PG_NARGS() == 8);
+  if (PG_NARGS() == 5)
+  {
+    xsize = PG_GETARG_FLOAT8(1);
+    ysize = PG_GETARG_FLOAT8(2);
+    zsize = PG_GETARG_FLOAT8(3);
+    sorigin = PG_GETARG_GSERIALIZED_P(4);
+  }
+  else /* PG_NARGS() == 8 */
+  {
+    /* If time arguments are given */
+    t = PG_GETARG_TIMESTAMPTZ(1);
+    xsize = PG_GETARG_FLOAT8(2);
+    ysize = PG_GETARG_FLOAT8(3);
+    zsize = PG_GETARG_FLOAT8(4);
+    duration = PG_GETARG_INTERVAL_P(5);
+    sorigin = PG_GETARG_GSERIALIZED_P(6);
+    torigin = PG_GETARG_TIMESTAMPTZ(7);
+    hast = true;
+  }
+  PG_RETURN_INT64(stbox_tile_key(point, t, xsize, ysize, zsize, duration,
+    sorigin, torigin, hast));
+}
+
+PGDLLEXPORT Datum Tile_key_level(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tile_key_level);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the level of a tile key
+ * @sqlfn tileKeyLevel()
+ */
+Datum
+Tile_key_level(PG_FUNCTION_ARGS)
+{
+  int64 key = PG_GETARG_INT64(0);
+  PG_RETURN_INT32(tile_key_level(key));
+}
+
+PGDLLEXPORT Datum Tile_key_parent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tile_key_parent);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the key of an ancestor of a tile
+ * @sqlfn tileKeyParent()
+ */
+Datum
+Tile_key_parent(PG_FUNCTION_ARGS)
+{
+  int64 key = PG_GETARG_INT64(0);
+  int levels = PG_GETARG_INT32(1);
+  PG_RETURN_INT64(tile_key_parent(key, levels));
+}
+
+PGDLLEXPORT Datum Tile_key_children(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tile_key_children);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the set of keys of the children of a tile
+ * @sqlfn tileKeyChildren()
+ */
+Datum
+Tile_key_children(PG_FUNCTION_ARGS)
+{
+  int64 key = PG_GETARG_INT64(0);
+  PG_RETURN_SET_P(tile_key_children(key));
+}
+
+PGDLLEXPORT Datum Tpoint_space_key_split(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_space_key_split);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return a temporal point split with respect to a spatial grid, where
+ * the tiles are identified by their keys
+ * @sqlfn spaceKeySplit()
+ */
+Datum
+Tpoint_space_key_split(PG_FUNCTION_ARGS)
+{
+  return Tpoint_space_time_split_ext(fcinfo, false, true);
+}
+
+PGDLLEXPORT Datum Tpoint_space_time_key_split(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_space_time_key_split);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return a temporal point split with respect to a spatiotemporal grid,
+ * where the tiles are identified by their keys
+ * @sqlfn spaceTimeKeySplit()
+ */
+Datum
+Tpoint_space_time_key_split(PG_FUNCTION_ARGS)
+{
+  return Tpoint_space_time_split_ext(fcinfo, true, true);
+}
+
+/*****************************************************************************
+ * Tile density aggregation
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tpoint_tile_density_transfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_tile_density_transfn);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Transition function for the tile density aggregation of temporal
+ * points
+ * @sqlfn tileDensity()
+ */
+Datum
+Tpoint_tile_density_transfn(PG_FUNCTION_ARGS)
+{
+  TileDensityState *state = PG_ARGISNULL(0) ? NULL :
+    (TileDensityState *) PG_GETARG_POINTER(0);
+  for (int i = 1; i < PG_NARGS(); i++)
+  {
+    if (PG_ARGISNULL(i))
+    {
+      if (state)
+        PG_RETURN_POINTER(state);
+      else
+        PG_RETURN_NULL();
+    }
+  }
+  Temporal *temp = PG_GETARG_TEMPORAL_P(1);
+  double xsize = PG_GETARG_FLOAT8(2);
+  double ysize = PG_GETARG_FLOAT8(3);
+  Interval *duration = NULL;
+  GSERIALIZED *sorigin;
+  TimestampTz torigin = 0;
+  if (PG_NARGS() == 5)
+    sorigin = PG_GETARG_GSERIALIZED_P(4);
+  else
+  {
+    duration = PG_GETARG_INTERVAL_P(4);
+    sorigin = PG_GETARG_GSERIALIZED_P(5);
+    torigin = PG_GETARG_TIMESTAMPTZ(6);
+  }
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  state = tpoint_tile_density_transfn(state, temp, xsize, ysize, duration,
+    sorigin, torigin);
+  unset_aggregation_context(ctx);
+  PG_FREE_IF_COPY(temp, 1);
+  PG_RETURN_POINTER(state);
+}
+
+PGDLLEXPORT Datum Tpoint_tile_density_combinefn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_tile_density_combinefn);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Combine function for the tile density aggregation of temporal points
+ * @sqlfn tileDensity()
+ */
+Datum
+Tpoint_tile_density_combinefn(PG_FUNCTION_ARGS)
+{
+  TileDensityState *state1 = PG_ARGISNULL(0) ? NULL :
+    (TileDensityState *) PG_GETARG_POINTER(0);
+  TileDensityState *state2 = PG_ARGISNULL(1) ? NULL :
+    (TileDensityState *) PG_GETARG_POINTER(1);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  TileDensityState *result = tpoint_tile_density_combinefn(state1, state2);
+  unset_aggregation_context(ctx);
+  if (! result)
+    PG_RETURN_NULL();
+  PG_RETURN_POINTER(result);
+}
+
+PGDLLEXPORT Datum Tpoint_tile_density_finalfn(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_tile_density_finalfn);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Final function for the tile density aggregation of temporal points
+ * @details The result is an array of the composite type `tile_density`
+ * @sqlfn tileDensity()
+ */
+Datum
+Tpoint_tile_density_finalfn(PG_FUNCTION_ARGS)
+{
+  if (PG_ARGISNULL(0))
+    PG_RETURN_NULL();
+  TileDensityState *state = (TileDensityState *) PG_GETARG_POINTER(0);
+  int count;
+  TileDensity *tiles = tpoint_tile_density_finalfn(state, &count);
+  if (! count)
+    PG_RETURN_NULL();
+
+  /* Get the tuple descriptor of the elements of the result */
+  Oid elemtypid = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+  TupleDesc tupdesc = lookup_rowtype_tupdesc_copy(elemtypid, -1);
+  BlessTupleDesc(tupdesc);
+  Datum *values = palloc(sizeof(Datum) * count);
+  Datum tuple_arr[5];
+  bool isnull[5] = {0};
+  bool hast = (state->tunits != 0);
+  for (int i = 0; i < count; i++)
+  {
+    /* The duration is justified into days as for the difference of two
+     * timestamps */
+    Interval *duration = palloc0(sizeof(Interval));
+    duration->day = (int32) (tiles[i].duration / USECS_PER_DAY);
+    duration->time = tiles[i].duration % USECS_PER_DAY;
+    tuple_arr[0] = PointerGetDatum(geopoint_make(tiles[i].x, tiles[i].y, 0.0,
+      false, false, state->srid));
+    tuple_arr[1] = TimestampTzGetDatum(tiles[i].t);
+    isnull[1] = ! hast;
+    tuple_arr[2] = Int64GetDatum(tiles[i].count);
+    tuple_arr[3] = PointerGetDatum(duration);
+    tuple_arr[4] = Float8GetDatum(tiles[i].distance);
+    HeapTuple tuple = heap_form_tuple(tupdesc, tuple_arr, isnull);
+    values[i] = HeapTupleGetDatum(tuple);
+  }
+  ArrayType *result = construct_array(values, count, elemtypid, -1, false,
+    'd');
+  pfree(values); pfree(tiles);
+  PG_RETURN_ARRAYTYPE_P(result);
+}
+
+PGDLLEXPORT Datum Tile_density_serialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tile_density_serialize);
+/**
+ * @brief Serialize the state of the tile density aggregation
+ */
+Datum
+Tile_density_serialize(PG_FUNCTION_ARGS)
+{
+  TileDensityState *state = (TileDensityState *) PG_GETARG_POINTER(0);
+  size_t size = tile_density_state_serialize_size(state);
+  bytea *result = palloc(VARHDRSZ + size);
+  SET_VARSIZE(result, VARHDRSZ + size);
+  tile_density_state_serialize(state, VARDATA(result));
+  PG_RETURN_BYTEA_P(result);
+}
+
+PGDLLEXPORT Datum Tile_density_deserialize(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tile_density_deserialize);
+/**
+ * @brief Deserialize the state of the tile density aggregation
+ */
+Datum
+Tile_density_deserialize(PG_FUNCTION_ARGS)
+{
+  bytea *data = PG_GETARG_BYTEA_P(0);
+  size_t size = VARSIZE(data) - VARHDRSZ;
+  /* The data of a bytea is not aligned on a double boundary */
+  char *buf = palloc(size);
+  memcpy(buf, VARDATA(data), size);
+  MemoryContext ctx = set_aggregation_context(fcinfo);
+  TileDensityState *result = tile_density_state_deserialize(buf, size);
+  unset_aggregation_context(ctx);
+  pfree(buf);
+  PG_RETURN_POINTER(result);
+}
+
+/*****************************************************************************
+ * Balanced partitions
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Stboxarr_balanced_partitions(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Stboxarr_balanced_partitions);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return at most k spatiotemporal boxes partitioning an array of boxes
+ * into partitions with the same number of boxes
+ * @sqlfn balancedPartitions()
+ */
+Datum
+Stboxarr_balanced_partitions(PG_FUNCTION_ARGS)
+{
+  ArrayType *array = PG_GETARG_ARRAYTYPE_P(0);
+  int k = PG_GETARG_INT32(1);
+  int count;
+  STBox **boxes = (STBox **) datumarr_extract(array, &count);
+  if (count == 0)
+  {
+    pfree(boxes);
+    PG_FREE_IF_COPY(array, 0);
+    PG_RETURN_NULL();
+  }
+  STBox *boxarr = palloc(sizeof(STBox) * count);
+  for (int i = 0; i < count; i++)
+    boxarr[i] = *boxes[i];
+  int newcount;
+  STBox *result = stboxarr_balanced_split(boxarr, NULL, count, k, &newcount);
+  ArrayType *resultarr = stboxarr_to_array(result, newcount);
+  pfree(boxes); pfree(boxarr); pfree(result);
+  PG_FREE_IF_COPY(array, 0);
+  PG_RETURN_ARRAYTYPE_P(resultarr);
+}
+
+/**
+ * @brief Return the cells of a histogram collected by ANALYZE as boxes
+ * weighted by their number of features
+ * @param[in] stats Histogram
+ * @param[in] hast True when the third dimension is the time in seconds
+ * @param[in] srid SRID of the boxes
+ * @param[out] weights Weights of the boxes
+ * @param[out] count Number of boxes
+ */
+static STBox *
+nd_stats_stboxes(const ND_STATS *stats, bool hast, int32 srid,
+  double **weights, int *count)
+{
+  int ndims = hast ? 3 : 2;
+  int ncells = (int) stats->histogram_cells;
+  double min[ND_DIMS], cellsize[ND_DIMS];
+  for (int d = 0; d < ndims; d++)
+  {
+    min[d] = stats->extent.min[d];
+    cellsize[d] = (stats->extent.max[d] - min[d]) / stats->size[d];
+  }
+  STBox *result = palloc(sizeof(STBox) * ncells);
+  *weights = palloc(sizeof(double) * ncells);
+  int at[ND_DIMS] = {0, 0, 0, 0};
+  int n = 0;
+  for (int i = 0; i < ncells; i++)
+  {
+    /* Position of the cell, the first dimension varies the fastest */
+    int rest = i;
+    for (int d = 0; d < ndims; d++)
+    {
+      at[d] = rest % (int) stats->size[d];
+      rest /= (int) stats->size[d];
+    }
+    double value = stats->value[nd_stats_value_index(stats, at)];
+    if (value <= 0)
+      continue;
+    Span period;
+    if (hast)
+    {
+      TimestampTz lower = (TimestampTz) ((min[2] + at[2] * cellsize[2]) *
+        USECS_PER_SEC);
+      TimestampTz upper = (TimestampTz) ((min[2] + (at[2] + 1) *
+        cellsize[2]) * USECS_PER_SEC);
+      span_set(TimestampTzGetDatum(lower), TimestampTzGetDatum(upper), true,
+        true, T_TIMESTAMPTZ, T_TSTZSPAN, &period);
+    }
+    stbox_set(true, false, false, srid, min[X_DIM] + at[X_DIM] * cellsize[X_DIM],
+      min[X_DIM] + (at[X_DIM] + 1) * cellsize[X_DIM],
+      min[Y_DIM] + at[Y_DIM] * cellsize[Y_DIM],
+      min[Y_DIM] + (at[Y_DIM] + 1) * cellsize[Y_DIM], 0.0, 0.0,
+      hast ? &period : NULL, &result[n]);
+    (*weights)[n++] = value;
+  }
+  *count = n;
+  return result;
+}
+
+PGDLLEXPORT Datum Tpoint_balanced_partitions(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_balanced_partitions);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return at most k spatiotemporal boxes partitioning a temporal point
+ * column into partitions with the same number of rows according to the
+ * statistics collected by ANALYZE
+ * @details The joint space-time histogram is used when it is collected,
+ * which requires the `mobilitydb.spacetime_histogram_size` parameter to be
+ * positive, otherwise the spatial histogram is used and the partitions have
+ * no time dimension.
+ * @sqlfn balancedPartitions()
+ */
+Datum
+Tpoint_balanced_partitions(PG_FUNCTION_ARGS)
+{
+  Oid relid = PG_GETARG_OID(0);
+  text *att_text = PG_GETARG_TEXT_P(1);
+  int k = PG_GETARG_INT32(2);
+
+  /* Get the attribute and ensure it is a temporal geometry point */
+  char *att_name = text2cstring(att_text);
+  AttrNumber att_num = get_attnum(relid, att_name);
+  if (att_num == InvalidAttrNumber)
+    ereport(ERROR, (errcode(ERRCODE_UNDEFINED_COLUMN),
+      errmsg("attribute \"%s\" does not exist", att_name)));
+  Oid typid;
+  int32 typmod;
+  Oid collid;
+  get_atttypetypmodcoll(relid, att_num, &typid, &typmod, &collid);
+  if (oid_type(typid) != T_TGEOMPOINT)
+    ereport(ERROR, (errcode(ERRCODE_DATATYPE_MISMATCH),
+      errmsg("attribute \"%s\" is not a temporal geometry point", att_name)));
+  int32 srid = 0;
+  if (typmod > 0)
+  {
+    TYPMOD_DEL_SUBTYPE(typmod);
+    srid = TYPMOD_GET_SRID(typmod);
+  }
+
+  /* Get the histogram of the whole inheritance tree or of the table */
+  HeapTuple stats_tuple = SearchSysCache3(STATRELATTINH,
+    ObjectIdGetDatum(relid), Int16GetDatum(att_num), BoolGetDatum(true));
+  if (! stats_tuple)
+    stats_tuple = SearchSysCache3(STATRELATTINH, ObjectIdGetDatum(relid),
+      Int16GetDatum(att_num), BoolGetDatum(false));
+  if (! stats_tuple)
+    ereport(ERROR, (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+      errmsg("statistics for attribute \"%s\" do not exist", att_name),
+      errhint("Run ANALYZE on the table.")));
+  ND_STATS *stats = NULL;
+  bool hast = false;
+  AttStatsSlot sslot;
+  if (get_attstatsslot(&sslot, stats_tuple, STATISTIC_KIND_NDT, InvalidOid,
+      ATTSTATSSLOT_NUMBERS))
+  {
+    stats = palloc(sizeof(float4) * sslot.nnumbers);
+    memcpy(stats, sslot.numbers, sizeof(float4) * sslot.nnumbers);
+    free_attstatsslot(&sslot);
+    hast = true;
+    /* The joint histogram is only collected for (X, Y, T) */
+    if ((int) stats->ndims != 3)
+    {
+      pfree(stats);
+      stats = NULL;
+      hast = false;
+    }
+  }
+  if (! stats)
+    stats = pg_nd_stats_from_tuple(stats_tuple, 2);
+  ReleaseSysCache(stats_tuple);
+  if (! stats)
+    ereport(ERROR, (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+      errmsg("attribute \"%s\" has no spatial histogram", att_name)));
+
+  int count;
+  double *weights;
+  STBox *boxes = nd_stats_stboxes(stats, hast, srid, &weights, &count);
+  pfree(stats);
+  if (count == 0)
+  {
+    pfree(boxes); pfree(weights);
+    PG_RETURN_NULL();
+  }
+  int newcount;
+  STBox *result = stboxarr_balanced_split(boxes, weights, count, k, &newcount);
+  ArrayType *resultarr = stboxarr_to_array(result, newcount);
+  pfree(boxes); pfree(weights); pfree(result);
+  PG_RETURN_ARRAYTYPE_P(resultarr);
+}
+
+/*****************************************************************************
+ * Bucketed aggregation functions
+ *****************************************************************************/
+
+PGDLLEXPORT Datum Tpoint_bucket_length(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(Tpoint_bucket_length);
+/**
+ * @ingroup mobilitydb_temporal_analytics_tile
+ * @brief Return the length traversed by a temporal point per time bucket
+ * @sqlfn bucketLength()
+ */
+Datum
+Tpoint_bucket_length(PG_FUNCTION_ARGS)
+{
+  Temporal *temp = PG_GETARG_TEMPORAL_P(0);
+  Interval *duration = PG_GETARG_INTERVAL_P(1);
+  TimestampTz origin = PG_GETARG_TIMESTAMPTZ(2);
+  Temporal *result = tpoint_bucket_length(temp, duration, origin);
+  PG_FREE_IF_COPY(temp, 0);
+  PG_RETURN_TEMPORAL_P(result);
 }
 
 /*****************************************************************************/
@@ -0,0 +1,214 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/*
+ * berlinmod_generate.sql
+ * Generation of a BerlinMOD-like data set for the benchmark.
+ *
+ * The script is run by psql with the variables SCALEFACTOR, the BerlinMOD
+ * scale factor, and DATAGEN_DIR, the directory of the random generators.
+ * As in BerlinMOD, the number of vehicles is 2000 * sqrt(SCALEFACTOR) and the
+ * number of days is 28 * sqrt(SCALEFACTOR). Every vehicle makes a trip in
+ * the morning and a trip in the evening of every day in an area of the size
+ * of Berlin. The random generator is seeded so that the data set, and thus
+ * the query plans, are the same in every run.
+ */
+
+\i :DATAGEN_DIR/general/random_geo.sql
+\i :DATAGEN_DIR/general/random_temporal.sql
+\i :DATAGEN_DIR/point/random_tpoint.sql
+
+-------------------------------------------------------------------------------
+-- Capture of the EXPLAIN ANALYZE output
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS berlinmod_results;
+CREATE TABLE berlinmod_results(query text PRIMARY KEY, signature text,
+  usecs bigint, plan json);
+
+/**
+ * @brief Return the shape of a plan, that is, the node types and the indexes
+ * used by the nodes, in preorder
+ * @param[in] node Plan node of the JSON output of EXPLAIN
+ */
+DROP FUNCTION IF EXISTS berlinmod_plan_signature;
+CREATE FUNCTION berlinmod_plan_signature(node jsonb)
+  RETURNS text AS $$
+DECLARE
+  result text;
+  child jsonb;
+  first bool = true;
+BEGIN
+  result = node->>'Node Type';
+  IF node ? 'Index Name' THEN
+    result = result || '[' || (node->>'Index Name') || ']';
+  END IF;
+  IF node ? 'Plans' THEN
+    result = result || '(';
+    FOR child IN SELECT jsonb_array_elements(node->'Plans')
+    LOOP
+      IF NOT first THEN
+        result = result || ',';
+      END IF;
+      result = result || berlinmod_plan_signature(child);
+      first = false;
+    END LOOP;
+    result = result || ')';
+  END IF;
+  RETURN result;
+END;
+$$ LANGUAGE PLPGSQL STRICT;
+
+/**
+ * @brief Run a query with EXPLAIN ANALYZE and record its plan and its
+ * execution time
+ * @param[in] name Name of the query
+ * @param[in] query Text of the query
+ * @param[in] repeat Number of executions, the minimum execution time is kept
+ * @return Plan signature and execution time in microseconds separated by '|'
+ */
+DROP FUNCTION IF EXISTS berlinmod_explain;
+CREATE FUNCTION berlinmod_explain(name text, query text, repeat int)
+  RETURNS text AS $$
+DECLARE
+  plan json;
+  exectime float;
+  mintime float;
+  signature text;
+BEGIN
+  FOR i IN 1..greatest(repeat, 1)
+  LOOP
+    EXECUTE 'EXPLAIN (ANALYZE, FORMAT JSON) ' || query INTO plan;
+    exectime = (plan->0->>'Execution Time')::float;
+    IF mintime IS NULL OR exectime < mintime THEN
+      mintime = exectime;
+    END IF;
+  END LOOP;
+  signature = berlinmod_plan_signature((plan->0->'Plan')::jsonb);
+  INSERT INTO berlinmod_results
+  VALUES (name, signature, round(mintime * 1000)::bigint, plan)
+  ON CONFLICT (query) DO UPDATE
+  SET signature = EXCLUDED.signature, usecs = EXCLUDED.usecs,
+    plan = EXCLUDED.plan;
+  RETURN signature || '|' || round(mintime * 1000)::bigint;
+END;
+$$ LANGUAGE PLPGSQL STRICT;
+
+-------------------------------------------------------------------------------
+-- Data generation
+-------------------------------------------------------------------------------
+
+/**
+ * @brief Generate the BerlinMOD tables
+ * @param[in] scalefactor BerlinMOD scale factor
+ */
+DROP FUNCTION IF EXISTS berlinmod_generate;
+CREATE FUNCTION berlinmod_generate(scalefactor float)
+  RETURNS text AS $$
+DECLARE
+  -- Extent of Berlin in the Web Mercator projection
+  lowx float = 1475000;
+  highx float = 1510000;
+  lowy float = 6875000;
+  highy float = 6910000;
+  srid int = 3857;
+  startday timestamptz = '2020-06-01';
+  novehicles int;
+  nodays int;
+  endday timestamptz;
+BEGIN
+  novehicles = greatest(round(2000 * sqrt(scalefactor)), 1);
+  nodays = greatest(round(28 * sqrt(scalefactor)), 1);
+  endday = startday + nodays * interval '1 day';
+  PERFORM setseed(0.5);
+
+  DROP TABLE IF EXISTS Vehicles;
+  CREATE TABLE Vehicles(VehicleId int PRIMARY KEY, Licence text,
+    VehicleType text);
+  INSERT INTO Vehicles
+  SELECT k, 'B-' || chr(65 + k % 26) || chr(65 + (k / 26) % 26) || ' ' || k,
+    CASE WHEN random() < 0.9 THEN 'passenger'
+      WHEN random() < 0.5 THEN 'bus' ELSE 'truck' END
+  FROM generate_series(1, novehicles) k;
+
+  DROP TABLE IF EXISTS Trips;
+  CREATE TABLE Trips(TripId int PRIMARY KEY, VehicleId int, Trip tgeompoint,
+    Traj geometry);
+  INSERT INTO Trips(TripId, VehicleId, Trip)
+  SELECT row_number() OVER (ORDER BY v, d, h), v,
+    random_tgeompoint_contseq(lowx, highx, lowy, highy,
+      startday + d * interval '1 day' + h * interval '1 hour',
+      startday + d * interval '1 day' + (h + 2) * interval '1 hour',
+      500, 2, 10, 60, true, srid)
+  FROM generate_series(1, novehicles) v, generate_series(0, nodays - 1) d,
+    unnest(ARRAY[7, 17]) h;
+  UPDATE Trips SET Traj = trajectory(Trip);
+
+  DROP TABLE IF EXISTS Licences;
+  CREATE TABLE Licences(LicenceId int PRIMARY KEY, Licence text,
+    VehicleId int);
+  INSERT INTO Licences
+  SELECT k, Licence, VehicleId
+  FROM (SELECT row_number() OVER () AS k, Licence, VehicleId
+    FROM (SELECT Licence, VehicleId FROM Vehicles
+      ORDER BY random() LIMIT 100) t) t;
+
+  DROP TABLE IF EXISTS Points;
+  CREATE TABLE Points(PointId int PRIMARY KEY, Geom geometry);
+  INSERT INTO Points
+  SELECT k, random_geom_point(lowx, highx, lowy, highy, srid)
+  FROM generate_series(1, 100) k;
+
+  DROP TABLE IF EXISTS Regions;
+  CREATE TABLE Regions(RegionId int PRIMARY KEY, Geom geometry);
+  INSERT INTO Regions
+  SELECT k, ST_Buffer(random_geom_point(lowx, highx, lowy, highy, srid),
+    random_float(500, 2000))
+  FROM generate_series(1, 100) k;
+
+  DROP TABLE IF EXISTS Instants;
+  CREATE TABLE Instants(InstantId int PRIMARY KEY, Instant timestamptz);
+  INSERT INTO Instants
+  SELECT k, random_timestamptz(startday, endday)
+  FROM generate_series(1, 100) k;
+
+  DROP TABLE IF EXISTS Periods;
+  CREATE TABLE Periods(PeriodId int PRIMARY KEY, Period tstzspan);
+  INSERT INTO Periods
+  SELECT k, random_tstzspan(startday, endday, 240)
+  FROM generate_series(1, 100) k;
+
+  RETURN 'The BerlinMOD data set at scale factor ' || scalefactor ||
+    ' has ' || novehicles || ' vehicles and ' || nodays || ' days';
+END;
+$$ LANGUAGE PLPGSQL STRICT;
+
+SELECT berlinmod_generate(:SCALEFACTOR);
+
+-------------------------------------------------------------------------------
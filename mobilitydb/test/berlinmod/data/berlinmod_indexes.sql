@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/*
+ * berlinmod_indexes.sql
+ * Indexes of the BerlinMOD benchmark.
+ *
+ * The script is run by psql with the variable INDEX, which is the access
+ * method, either gist or spgist, of the indexes on the temporal points and
+ * on the time spans.
+ */
+
+DROP INDEX IF EXISTS Trips_Trip_idx;
+CREATE INDEX Trips_Trip_idx ON Trips USING :INDEX(Trip);
+DROP INDEX IF EXISTS Trips_Traj_idx;
+CREATE INDEX Trips_Traj_idx ON Trips USING :INDEX(Traj);
+DROP INDEX IF EXISTS Trips_VehicleId_idx;
+CREATE INDEX Trips_VehicleId_idx ON Trips USING btree(VehicleId);
+DROP INDEX IF EXISTS Periods_Period_idx;
+CREATE INDEX Periods_Period_idx ON Periods USING :INDEX(Period);
+DROP INDEX IF EXISTS Points_Geom_idx;
+CREATE INDEX Points_Geom_idx ON Points USING gist(Geom);
+DROP INDEX IF EXISTS Regions_Geom_idx;
+CREATE INDEX Regions_Geom_idx ON Regions USING gist(Geom);
+DROP INDEX IF EXISTS Instants_Instant_idx;
+CREATE INDEX Instants_Instant_idx ON Instants USING btree(Instant);
+DROP INDEX IF EXISTS Licences_Licence_idx;
+CREATE INDEX Licences_Licence_idx ON Licences USING btree(Licence);
+
+VACUUM ANALYZE Vehicles, Trips, Licences, Points, Regions, Instants,
+  Periods;
+
+-------------------------------------------------------------------------------
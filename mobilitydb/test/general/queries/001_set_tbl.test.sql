@@ -227,4 +227,21 @@ SELECT k%2, numValues(setUnion(f)) FROM tbl_floatset GROUP BY k%2 ORDER BY k%2;
 SELECT k%2, numValues(setUnion(t)) FROM tbl_textset GROUP BY k%2 ORDER BY k%2;
 SELECT k%2, numValues(setUnion(d)) FROM tbl_dateset GROUP BY k%2 ORDER BY k%2;
 
+-- encourage use of parallel plans
+set parallel_setup_cost=0;
+set parallel_tuple_cost=0;
+set min_parallel_table_scan_size=0;
+set max_parallel_workers_per_gather=2;
+
+SELECT numValues(setUnion(i)) FROM tbl_int;
+SELECT numValues(setUnion(t)) FROM tbl_text;
+SELECT k%2, numValues(setUnion(i)) FROM tbl_intset GROUP BY k%2 ORDER BY k%2;
+SELECT k%2, numValues(setUnion(t)) FROM tbl_textset GROUP BY k%2 ORDER BY k%2;
+
+-- reset to default values
+reset parallel_setup_cost;
+reset parallel_tuple_cost;
+reset min_parallel_table_scan_size;
+reset max_parallel_workers_per_gather;
+
 -------------------------------------------------------------------------------
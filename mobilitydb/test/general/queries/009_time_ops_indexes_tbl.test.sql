@@ -78,3 +78,18 @@ DROP INDEX tbl_tstzspan_big_quadtree_idx;
 DROP INDEX tbl_tstzspanset_big_quadtree_idx;
 
 -------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tstzspanset_big_mrtree_idx ON tbl_tstzspanset_big USING GIST(t tstzspanset_mrtree_ops);
+
+SELECT COUNT(*) FROM tbl_tstzspanset_big WHERE t && tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tstzspanset_big WHERE t @> tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tstzspanset_big WHERE t <@ tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tstzspanset_big WHERE t -|- tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tstzspanset_big WHERE t <<# tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tstzspanset_big WHERE t &<# tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tstzspanset_big WHERE t #>> tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tstzspanset_big WHERE t #&> tstzspan '[2001-01-01, 2001-02-01]';
+
+DROP INDEX tbl_tstzspanset_big_mrtree_idx;
+
+-------------------------------------------------------------------------------
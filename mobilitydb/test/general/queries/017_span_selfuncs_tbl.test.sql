@@ -2102,3 +2102,30 @@ END;
 $$ LANGUAGE 'plpgsql';
 
 -------------------------------------------------------------------------------
+
+-- Most common elements statistics of sets
+
+CREATE TABLE tbl_intset_mcelem AS
+SELECT k, set(ARRAY[k % 10, 100 + k % 4]) AS s FROM generate_series(1, 1000) AS k;
+ANALYZE tbl_intset_mcelem;
+
+CREATE FUNCTION plan_rows(query text)
+RETURNS BIGINT AS $$
+DECLARE
+  J JSON;
+BEGIN
+  EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO J;
+  RETURN (J->0->'Plan'->>'Plan Rows')::BIGINT;
+END;
+$$ LANGUAGE 'plpgsql';
+
+SELECT plan_rows('SELECT * FROM tbl_intset_mcelem WHERE s @> 3');
+SELECT plan_rows('SELECT * FROM tbl_intset_mcelem WHERE 3 <@ s');
+SELECT plan_rows('SELECT * FROM tbl_intset_mcelem WHERE s @> 42');
+SELECT plan_rows('SELECT * FROM tbl_intset_mcelem WHERE s @> intset ''{3, 101}''');
+SELECT plan_rows('SELECT * FROM tbl_intset_mcelem WHERE s && intset ''{3, 4}''');
+
+DROP FUNCTION plan_rows;
+DROP TABLE tbl_intset_mcelem;
+
+-------------------------------------------------------------------------------
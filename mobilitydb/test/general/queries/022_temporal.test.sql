@@ -644,6 +644,12 @@ SELECT appendSequence(tfloat '{1@2000-01-01, 2@2000-01-02}', tfloat '[2@2000-01-
 SELECT appendSequence(tfloat '{[1@2000-01-01, 1@2000-01-03]}', tfloat '[2@2000-01-02]');
 SELECT appendSequence(tfloat '{[1@2000-01-01, 1@2000-01-02]}', tfloat '[2@2000-01-02]');
 
+SELECT applyDelta(tint '[1@2000-01-01, 2@2000-01-02]', deltaSince(tint '[1@2000-01-01, 2@2000-01-02, 3@2000-01-03]', '2000-01-02'));
+SELECT applyDelta(tfloat '[1@2000-01-01, 2@2000-01-02]', deltaSince(tfloat '{[1@2000-01-01, 2@2000-01-02, 3@2000-01-03], [4@2000-01-05, 5@2000-01-06]}', '2000-01-02'));
+SELECT applyDelta(tint '[1@2000-01-01, 2@2000-01-02]', deltaSince(tint '[1@2000-01-01, 2@2000-01-02]', '2000-01-02'));
+/* Errors */
+SELECT applyDelta(tint '[1@2000-01-01]', deltaSince(tint '[1@2000-01-01, 2@2000-01-02, 3@2000-01-03]', '2000-01-02'));
+
 -------------------------------------------------------------------------------
 
 SELECT merge(tbool 't@2000-01-01', tbool 't@2000-01-02');
@@ -824,6 +830,13 @@ SELECT memSize(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}');
 SELECT memSize(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]');
 SELECT memSize(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
 
+SELECT compress(tbool 't@2000-01-01');
+SELECT compress(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]');
+SELECT compress(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}');
+SELECT compress(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}');
+SELECT compress(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]') = tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]';
+SELECT pg_column_size(compress(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]')) < pg_column_size(tfloat '[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03]');
+
 /*
 SELECT tbox(tint '1@2000-01-01');
 SELECT tbox(tfloat '1.5@2000-01-01');
@@ -2331,6 +2344,11 @@ SELECT temporal_cmp(tint '{[1@2000-01-01, 2@2000-01-02]}', '{(1@2000-01-01, 2@20
 SELECT temporal_cmp(tint '{(1@2000-01-01, 2@2000-01-02]}', '{[1@2000-01-01, 2@2000-01-02]}');
 SELECT temporal_cmp(tint 'Interp=Step;{[1@2000-01-01, 2@2000-01-02]}', '{[1@2000-01-01, 2@2000-01-02]}');
 SELECT temporal_cmp(tint '{[1@2000-01-01, 2@2000-01-02]}', 'Interp=Step;{[1@2000-01-01, 2@2000-01-02]}');
+-- The order does not depend on the subtype of equal values
+SELECT temporal_cmp(tint '{1@2000-01-01, 2@2000-01-02}', '{[1@2000-01-01], [2@2000-01-02]}');
+SELECT temporal_cmp(tint '{1@2000-01-01, 2@2000-01-02}', '[1@2000-01-01, 2@2000-01-02]');
+SELECT temporal_cmp(tint '{[1@2000-01-01], [2@2000-01-02]}', '[1@2000-01-01, 2@2000-01-02]');
+SELECT temporal_cmp(tint '[1@2000-01-01, 2@2000-01-02]', '{[1@2000-01-01], [2@2000-01-02]}');
 
 -------------------------------------------------------------------------------
 
@@ -2715,4 +2733,18 @@ SELECT temporal_hash(ttext '{AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03}');
 SELECT temporal_hash(ttext '[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03]');
 SELECT temporal_hash(ttext '{[AAA@2000-01-01, BBB@2000-01-02, AAA@2000-01-03],[CCC@2000-01-04, CCC@2000-01-05]}');
 
+
+-------------------------------------------------------------------------------
+-- Runtime statistics
+-------------------------------------------------------------------------------
+
+SELECT mobilitydb_stats_reset();
+SET mobilitydb.track_stats = on;
+SELECT numInstants(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]' + 1);
+RESET mobilitydb.track_stats;
+SELECT value > 0 FROM mobilitydb_stat_counters WHERE name = 'lifted_instants';
+SELECT count(*) FROM mobilitydb_stat_counters;
+SELECT mobilitydb_stats_reset();
+SELECT max(value) FROM mobilitydb_stat_counters;
+
 ------------------------------------------------------------------------------
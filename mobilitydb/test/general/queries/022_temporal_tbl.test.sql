@@ -61,6 +61,42 @@ DROP TABLE tbl_tint_tmp;
 DROP TABLE tbl_tfloat_tmp;
 DROP TABLE tbl_ttext_tmp;
 
+-- Native binary format
+SET mobilitydb.native_binary = on;
+
+COPY tbl_tint TO '/tmp/tbl_tint_native' (FORMAT BINARY);
+COPY tbl_ttext TO '/tmp/tbl_ttext_native' (FORMAT BINARY);
+
+CREATE TABLE tbl_tint_tmp AS TABLE tbl_tint WITH NO DATA;
+CREATE TABLE tbl_ttext_tmp AS TABLE tbl_ttext WITH NO DATA;
+
+COPY tbl_tint_tmp FROM '/tmp/tbl_tint_native' (FORMAT BINARY);
+COPY tbl_ttext_tmp FROM '/tmp/tbl_ttext_native' (FORMAT BINARY);
+
+SELECT COUNT(*) FROM tbl_tint t1, tbl_tint_tmp t2 WHERE t1.k = t2.k AND t1.temp <> t2.temp;
+SELECT COUNT(*) FROM tbl_ttext t1, tbl_ttext_tmp t2 WHERE t1.k = t2.k AND t1.temp <> t2.temp;
+
+DROP TABLE tbl_tint_tmp;
+DROP TABLE tbl_ttext_tmp;
+
+CREATE TABLE tbl_tint_native(temp tint);
+CREATE TABLE tbl_ttext_native(temp ttext);
+
+/* Errors */
+COPY (SELECT ttext 'AAA@2000-01-01') TO '/tmp/ttext_native' (FORMAT BINARY);
+COPY tbl_tint_native FROM '/tmp/ttext_native' (FORMAT BINARY);
+-- Length of the text value greater than the instant
+COPY (SELECT set_byte(temporal_send(ttext 'AAA@2000-01-01'), 31, 127)) TO '/tmp/ttext_native_corrupt' (FORMAT BINARY);
+COPY tbl_ttext_native FROM '/tmp/ttext_native_corrupt' (FORMAT BINARY);
+-- Timestamp of the instant modified
+COPY (SELECT set_byte(temporal_send(ttext 'AAA@2000-01-01'), 20, get_byte(temporal_send(ttext 'AAA@2000-01-01'), 20) # 1)) TO '/tmp/ttext_native_corrupt' (FORMAT BINARY);
+COPY tbl_ttext_native FROM '/tmp/ttext_native_corrupt' (FORMAT BINARY);
+SET mobilitydb.native_binary = off;
+COPY tbl_ttext_native FROM '/tmp/ttext_native' (FORMAT BINARY);
+
+DROP TABLE tbl_tint_native;
+DROP TABLE tbl_ttext_native;
+
 -------------------------------------------------------------------------------
 -- Cast functions
 -------------------------------------------------------------------------------
@@ -696,3 +732,21 @@ SELECT COUNT(*) FROM tbl_ttext t1, tbl_ttext t2
 WHERE t1.temp >= t2.temp;
 
 -------------------------------------------------------------------------------
+-- Hash functions
+-------------------------------------------------------------------------------
+
+-- The low-order 32 bits of the extended hash with seed 0 are the 32-bit hash
+SELECT COUNT(*) FROM tbl_tbool
+WHERE (temporal_hash_extended(temp, 0) & 4294967295) <>
+  (temporal_hash(temp)::bigint & 4294967295);
+SELECT COUNT(*) FROM tbl_tint
+WHERE (temporal_hash_extended(temp, 0) & 4294967295) <>
+  (temporal_hash(temp)::bigint & 4294967295);
+SELECT COUNT(*) FROM tbl_tfloat
+WHERE (temporal_hash_extended(temp, 0) & 4294967295) <>
+  (temporal_hash(temp)::bigint & 4294967295);
+SELECT COUNT(*) FROM tbl_ttext
+WHERE (temporal_hash_extended(temp, 0) & 4294967295) <>
+  (temporal_hash(temp)::bigint & 4294967295);
+
+-------------------------------------------------------------------------------
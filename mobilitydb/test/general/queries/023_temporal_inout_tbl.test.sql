@@ -80,4 +80,20 @@ SELECT COUNT(*) FROM tbl_tint WHERE temp IS NOT NULL AND tintFromHexWKB(asHexWKB
 SELECT COUNT(*) from tbl_tfloat WHERE temp IS NOT NULL AND tfloatFromHexWKB(asHexWKB(temp)) <> temp;
 SELECT COUNT(*) FROM tbl_ttext WHERE temp IS NOT NULL AND ttextFromHexWKB(asHexWKB(temp)) <> temp;
 
+
+SELECT COUNT(*) FROM tbl_tbool t WHERE temp IS NOT NULL AND (SELECT string_agg(c, '') FROM asMFJSONChunks(t.temp) c) <> asMFJSON(t.temp);
+SELECT COUNT(*) FROM tbl_tint t WHERE temp IS NOT NULL AND (SELECT string_agg(c, '') FROM asMFJSONChunks(t.temp) c) <> asMFJSON(t.temp);
+SELECT COUNT(*) FROM tbl_tfloat t WHERE temp IS NOT NULL AND (SELECT string_agg(c, '') FROM asMFJSONChunks(t.temp) c) <> asMFJSON(t.temp);
+SELECT COUNT(*) FROM tbl_ttext t WHERE temp IS NOT NULL AND (SELECT string_agg(c, '') FROM asMFJSONChunks(t.temp) c) <> asMFJSON(t.temp);
+
+SELECT COUNT(*) FROM tbl_tbool t WHERE temp IS NOT NULL AND (SELECT string_agg(c, '') FROM asBinaryChunks(t.temp, 'XDR') c) <> asBinary(t.temp, 'XDR');
+SELECT COUNT(*) FROM tbl_tint t WHERE temp IS NOT NULL AND (SELECT string_agg(c, '') FROM asBinaryChunks(t.temp, 'XDR') c) <> asBinary(t.temp, 'XDR');
+SELECT COUNT(*) FROM tbl_tfloat t WHERE temp IS NOT NULL AND (SELECT string_agg(c, '') FROM asBinaryChunks(t.temp, 'XDR') c) <> asBinary(t.temp, 'XDR');
+SELECT COUNT(*) FROM tbl_ttext t WHERE temp IS NOT NULL AND (SELECT string_agg(c, '') FROM asBinaryChunks(t.temp, 'XDR') c) <> asBinary(t.temp, 'XDR');
+
+SELECT COUNT(*) FROM tbl_tbool WHERE temp IS NOT NULL AND applyDelta(temp, deltaSince(temp, endTimestamp(temp))) <> temp;
+SELECT COUNT(*) FROM tbl_tint WHERE temp IS NOT NULL AND applyDelta(temp, deltaSince(temp, endTimestamp(temp))) <> temp;
+SELECT COUNT(*) FROM tbl_tfloat WHERE temp IS NOT NULL AND applyDelta(temp, deltaSince(temp, endTimestamp(temp))) <> temp;
+SELECT COUNT(*) FROM tbl_ttext WHERE temp IS NOT NULL AND applyDelta(temp, deltaSince(temp, endTimestamp(temp))) <> temp;
+
 ------------------------------------------------------------------------------
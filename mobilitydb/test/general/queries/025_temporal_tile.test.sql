@@ -56,6 +56,14 @@ SELECT valueBucket(3.5, -2.5);
 SELECT valueBucket(-2147483647, 3, 2);
 SELECT valueBucket(2147483646, 3, -2);
 
+SELECT valueBucket(ARRAY[-3, 0, 4], 2, 1);
+SELECT valueBucket(ARRAY[-3.5, 3.5, 0.3], 2.5);
+SELECT valueBucket(ARRAY[-3.5, 3.5, 0.3], 2.5, 1.5) =
+  ARRAY[valueBucket(-3.5, 2.5, 1.5), valueBucket(3.5, 2.5, 1.5), valueBucket(0.3, 2.5, 1.5)];
+/* Errors */
+SELECT valueBucket(ARRAY[1, 2147483646], 3, -2);
+SELECT valueBucket('{}'::int[], 2);
+
 SELECT spanBucket(3, 2);
 SELECT spanBucket(3, 2, 1);
 SELECT spanBucket(3.5, 2.5);
@@ -73,6 +81,14 @@ SELECT timeBucket('-infinity'::timestamptz, '1 day');
 /* Errors */
 SELECT timeBucket('2020-01-01', '1 month', timestamptz '2001-06-01');
 
+SELECT timeBucket(ARRAY[timestamptz '2020-01-01', '2020-01-09', '1999-12-31'], '1 week') =
+  ARRAY[timeBucket('2020-01-01', '1 week'), timeBucket('2020-01-09', '1 week'), timeBucket('1999-12-31', '1 week')];
+SELECT timeBucket(ARRAY[timestamptz '2020-01-01', '2020-01-09'], '1 week', timestamptz '2001-06-01') =
+  ARRAY[timeBucket('2020-01-01', '1 week', timestamptz '2001-06-01'), timeBucket('2020-01-09', '1 week', timestamptz '2001-06-01')];
+/* Errors */
+SELECT timeBucket(ARRAY[timestamptz '2020-01-01', 'infinity'], '1 day');
+SELECT timeBucket(ARRAY[timestamptz '2020-01-01'], '1 month');
+
 SELECT periodBucket('2020-01-01', '1 week');
 SELECT periodBucket('2020-01-01', '1 week', timestamptz '2001-06-01');
 
@@ -138,3 +154,11 @@ SELECT valueTimeSplit(tfloat '{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],
 SELECT valueTimeSplit(tfloat 'Interp=Step;{[1.5@2000-01-01, 2.5@2000-01-02, 1.5@2000-01-03],[3.5@2000-01-04, 3.5@2000-01-05]}', 0.5, '1 week');
 
 -------------------------------------------------------------------------------
+
+SELECT bucketTwAvg(tfloat '[1@2000-01-01, 3@2000-01-03]', interval '1 day');
+SELECT bucketTwAvg(tfloat '{[1@2000-01-01, 1@2000-01-02), [3@2000-01-04, 3@2000-01-05)}', interval '1 day');
+SELECT bucketTwAvg(tint '{1@2000-01-01, 3@2000-01-01 12:00, 4@2000-01-02}', interval '1 day');
+SELECT bucketMax(tint '[1@2000-01-01, 5@2000-01-01 12:00, 2@2000-01-02 12:00]', interval '1 day');
+SELECT bucketMax(tfloat '[1@2000-01-01, 3@2000-01-03)', interval '1 day');
+
+-------------------------------------------------------------------------------
@@ -130,4 +130,26 @@ temp2 AS (
   FROM temp1 GROUP BY k, temp )
 SELECT k FROM temp2 WHERE temp <> merge ORDER BY k;
 
+-- The fragments of the value buckets are those of valueSplit
+WITH temp1 AS (
+  SELECT k, (sp).number, (sp).tnumber AS slice
+  FROM (SELECT k, valueSplit(temp, 5) AS sp FROM tbl_tfloat) t ),
+temp2 AS (
+  SELECT k, (sp).number, merge((sp).tnumber ORDER BY (sp).time) AS slice
+  FROM (SELECT k, valueTimeSplit(temp, 5, '5 min') AS sp FROM tbl_tfloat) t
+  GROUP BY k, (sp).number )
+SELECT DISTINCT k FROM temp1 FULL OUTER JOIN temp2 USING (k, number)
+WHERE temp1.slice IS NULL OR temp2.slice IS NULL OR temp1.slice <> temp2.slice
+ORDER BY k;
+WITH temp1 AS (
+  SELECT k, (sp).number, (sp).tnumber AS slice
+  FROM (SELECT k, valueSplit(temp, 2) AS sp FROM tbl_tint) t ),
+temp2 AS (
+  SELECT k, (sp).number, merge((sp).tnumber ORDER BY (sp).time) AS slice
+  FROM (SELECT k, valueTimeSplit(temp, 2, '2 days') AS sp FROM tbl_tint) t
+  GROUP BY k, (sp).number )
+SELECT DISTINCT k FROM temp1 FULL OUTER JOIN temp2 USING (k, number)
+WHERE temp1.slice IS NULL OR temp2.slice IS NULL OR temp1.slice <> temp2.slice
+ORDER BY k;
+
 -------------------------------------------------------------------------------
@@ -76,3 +76,14 @@ SELECT initcap(ttext '[AA@2000-01-01, BB@2000-01-02, AA@2000-01-03]');
 SELECT initcap(ttext '{[AA@2000-01-01, BB@2000-01-02, AA@2000-01-03],[CC@2000-01-04, CC@2000-01-05]}');
 
 -------------------------------------------------------------------------------
+
+SELECT dictEncode(ttext '[AA@2000-01-01, BB@2000-01-02, AA@2000-01-03]', textset '{AA, BB}');
+SELECT dictDecode(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', textset '{AA, BB}');
+SELECT maxValue(dictEncode(ttext '{[AA@2000-01-01, BB@2000-01-02, AA@2000-01-03],[CC@2000-01-04, CC@2000-01-05]}', textset '{AA, BB, CC}'));
+SELECT dictDecode(dictEncode(ttext '{AA@2000-01-01, BB@2000-01-02, AA@2000-01-03}', textset '{AA, BB}'), textset '{AA, BB}');
+
+/* Errors */
+SELECT dictEncode(ttext '[AA@2000-01-01, BB@2000-01-02]', textset '{AA}');
+SELECT dictDecode(tint '[1@2000-01-01, 3@2000-01-02]', textset '{AA, BB}');
+
+-------------------------------------------------------------------------------
@@ -1258,3 +1258,26 @@ ORDER BY op, leftarg, rightarg;
 DROP TABLE test_topops;
 
 -------------------------------------------------------------------------------
+
+-- Time extent columns
+
+DROP TABLE IF EXISTS tbl_tfloat_extent;
+CREATE TABLE tbl_tfloat_extent(k int, temp tfloat,
+  starttime timestamptz GENERATED ALWAYS AS (startTimestamp(temp)) STORED,
+  endtime timestamptz GENERATED ALWAYS AS (endTimestamp(temp)) STORED);
+INSERT INTO tbl_tfloat_extent(k, temp) SELECT k, temp FROM tbl_tfloat;
+
+SELECT COUNT(*) FROM tbl_tfloat_extent WHERE temp && tstzspan '[2001-06-01, 2001-07-01]';
+SELECT COUNT(*) FROM tbl_tfloat_extent WHERE tstzspan '[2001-06-01, 2001-07-01]' && temp;
+SELECT COUNT(*) FROM tbl_tfloat_extent WHERE temp && tstzspan '[2001-06-01, 2001-07-01]' AND starttime <= '2001-07-01' AND endtime >= '2001-06-01';
+
+-- Bounding box expression indexes
+
+CREATE INDEX tbl_tfloat_extent_tbox_idx ON tbl_tfloat_extent USING gist(tbox(temp));
+
+SELECT COUNT(*) FROM tbl_tfloat_extent WHERE temp && tstzspan '[2001-06-01, 2001-07-01]';
+SELECT COUNT(*) FROM tbl_tfloat_extent WHERE temp && tbox 'TBOXFLOAT XT([1.5,2.5],[2000-01-01, 2000-01-03])';
+
+DROP TABLE tbl_tfloat_extent;
+
+-------------------------------------------------------------------------------
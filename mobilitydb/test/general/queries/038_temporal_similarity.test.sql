@@ -308,3 +308,31 @@ WITH Temp AS (
 SELECT COUNT(*) FROM Temp;
 
 -------------------------------------------------------------------------------
+-- Banded and bounded distances
+-------------------------------------------------------------------------------
+
+SELECT frechetDistance(tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 2@2000-01-02, 1@2000-01-03]', 0);
+SELECT frechetDistance(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 0);
+SELECT frechetDistance(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 1);
+SELECT dynTimeWarpDistance(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 0);
+SELECT dynTimeWarpDistance(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 1);
+SELECT frechetDistanceWithin(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 1.0);
+SELECT frechetDistanceWithin(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 2.0);
+SELECT dynTimeWarpDistanceWithin(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 1.0);
+SELECT dynTimeWarpDistanceWithin(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 2.0);
+SELECT dynTimeWarpDistanceWithin(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 2.0, 0);
+SELECT hausdorffDistanceWithin(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 0.0);
+SELECT hausdorffDistanceWithin(tfloat '[1@2000-01-01, 5@2000-01-02]', tfloat '[1@2000-01-01, 2@2000-01-02]', 2.0);
+SELECT hausdorffDistanceWithin(tfloat '[1@2000-01-01, 5@2000-01-02]', tfloat '[1@2000-01-01, 2@2000-01-02]', 3.0);
+
+-------------------------------------------------------------------------------
+-- Lower bounds
+-------------------------------------------------------------------------------
+
+SELECT frechetLowerBound(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]');
+SELECT frechetLowerBound(tfloat '[1@2000-01-01, 2@2000-01-02]', tfloat '[5@2000-01-01, 6@2000-01-02, 7@2000-01-03]');
+SELECT dynTimeWarpLowerBound(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]');
+SELECT dynTimeWarpLowerBound(tint '[1@2000-01-01, 3@2000-01-02, 1@2000-01-03]', tint '[1@2000-01-01, 1@2000-01-02, 3@2000-01-03]', 0);
+SELECT dynTimeWarpLowerBound(tfloat '[1@2000-01-01, 2@2000-01-02]', tfloat '[5@2000-01-01, 6@2000-01-02, 7@2000-01-03]');
+
+-------------------------------------------------------------------------------
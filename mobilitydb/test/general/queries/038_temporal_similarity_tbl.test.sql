@@ -61,5 +61,7 @@ SELECT COUNT(*) FROM temp;
 
 SELECT round(MAX(hausdorffDistance(t1.temp, t2.temp))::numeric, 6) FROM tbl_tint t1, tbl_tint t2 WHERE t1.k < t2.k;
 SELECT round(MAX(hausdorffDistance(t1.temp, t2.temp))::numeric, 6) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t1.k < t2.k;
+SELECT COUNT(*) FROM tbl_tint t1, tbl_tint t2 WHERE t1.k < t2.k AND hausdorffDistanceWithin(t1.temp, t2.temp, 50.0) <> (hausdorffDistance(t1.temp, t2.temp) <= 50.0);
+SELECT COUNT(*) FROM tbl_tfloat t1, tbl_tfloat t2 WHERE t1.k < t2.k AND hausdorffDistanceWithin(t1.temp, t2.temp, 50.0) <> (hausdorffDistance(t1.temp, t2.temp) <= 50.0);
 
 -------------------------------------------------------------------------------
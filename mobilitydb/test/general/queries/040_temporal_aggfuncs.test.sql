@@ -414,3 +414,56 @@ temp2(seq) AS (
 SELECT numInstants(appendSequence(seq ORDER BY seq)) FROM temp2;
 
 -------------------------------------------------------------------------------
+
+SELECT tcountDistinct(id, temp, interval '1 day') FROM (VALUES (1::bigint, tint '[1@2000-01-01, 2@2000-01-02 12:00]'), (1, tint '[3@2000-01-01, 3@2000-01-01 06:00]'), (2, tint '[1@2000-01-02, 1@2000-01-03]')) t(id, temp);
+SELECT tcountDistinct(id, temp, interval '1 day') FROM (VALUES (1::bigint, tfloat '[1@2000-01-01, 2@2000-01-02)'), (2, tfloat '{1@2000-01-05}')) t(id, temp);
+SELECT tcountDistinct(i % 10, tint(1, timestamptz '2000-01-01'), interval '1 hour') FROM generate_series(1, 20) i;
+
+WITH temp(trip) AS (
+  SELECT tint '[1@2000-01-01, 2@2000-01-02 12:00]' UNION
+  SELECT tint '[3@2000-01-01, 3@2000-01-01 06:00]' UNION
+  SELECT tint '[1@2000-01-02, 1@2000-01-03]' )
+SELECT tcountApprox(trip, 0.5, interval '1 day') =
+  tcount(tprecision(getTime(trip), interval '1 day'))::tfloat * 2.0
+FROM temp;
+WITH temp(trip) AS (
+  SELECT tfloat '[1@2000-01-01, 2@2000-01-02 12:00]' UNION
+  SELECT tfloat '[3@2000-01-01, 3@2000-01-01 06:00]' UNION
+  SELECT tfloat '[1@2000-01-02, 1@2000-01-03]' )
+SELECT tavgApprox(trip, 0.5, interval '1 day', timestamptz '2000-01-01') =
+  tavg(tprecision(trip, interval '1 day', timestamptz '2000-01-01'))
+FROM temp;
+SELECT maxValue(tcountApproxError(temp, 1.0, interval '1 day')) FROM (VALUES (tbool '[true@2000-01-01, true@2000-01-03]'), (tbool '{false@2000-01-02}')) t(temp);
+SELECT round(maxValue(tcountApproxError(temp, 0.25, interval '1 hour'))::numeric, 6) FROM (VALUES (ttext '[AA@2000-01-01, BB@2000-01-01 00:30]')) t(temp);
+SELECT maxValue(tavgApproxError(temp, 0.5, interval '1 day')) FROM (VALUES (tint '[2@2000-01-01, 2@2000-01-03]'), (tint '[2@2000-01-02, 2@2000-01-04]')) t(temp);
+/* Errors */
+SELECT tcountApprox(temp, 0.0, interval '1 day') FROM (VALUES (tint '1@2000-01-01')) t(temp);
+
+-------------------------------------------------------------------------------
+
+WITH temp(k, trip) AS (
+  SELECT 1, tint '[1@2000-01-01, 1@2000-01-03]' UNION
+  SELECT 2, tint '[1@2000-01-02, 1@2000-01-04]' UNION
+  SELECT 2, tint '[1@2000-01-03, 1@2000-01-05]' )
+SELECT tcountFinal(taggMerge(state)) = (SELECT tcount(trip) FROM temp)
+FROM (SELECT tcountState(trip) AS state FROM temp GROUP BY k) t;
+
+WITH temp(k, trip) AS (
+  SELECT 1, tint '[1@2000-01-01, 1@2000-01-03]' UNION
+  SELECT 2, tint '[1@2000-01-02, 1@2000-01-04]' UNION
+  SELECT 2, tint '[1@2000-01-03, 1@2000-01-05]' )
+SELECT tcountFinal(tcountState(trip)::text::taggstate) = tcount(trip) FROM temp;
+
+WITH temp(k, trip) AS (
+  SELECT 1, tint '[1@2000-01-01, 1@2000-01-03]' UNION
+  SELECT 2, tint '[1@2000-01-02, 1@2000-01-04]' UNION
+  SELECT 2, tint '[1@2000-01-03, 1@2000-01-05]' )
+SELECT startTimestamp(tcountFinal(taggExpire(tcountState(trip), '2000-01-02 12:00'))) FROM temp;
+
+WITH temp(k, trip) AS (
+  SELECT 1, tint '[1@2000-01-01, 1@2000-01-03]' UNION
+  SELECT 2, tint '[1@2000-01-02, 1@2000-01-04]' UNION
+  SELECT 2, tint '[1@2000-01-03, 1@2000-01-05]' )
+SELECT taggExpire(tcountState(trip), '2000-01-06') IS NULL FROM temp;
+
+-------------------------------------------------------------------------------
@@ -90,5 +90,11 @@ SELECT wsum(temp, interval '1 day') FROM (VALUES (tfloat '[1@2000-01-01, 1@2000-
 
 --------------------------------------------------
 
+SELECT windowMax(tint '[1@2000-01-01, 3@2000-01-02, 2@2000-01-03]', interval '1 day');
+SELECT windowCount(tint '{1@2000-01-01, 2@2000-01-02, 3@2000-01-05}', interval '2 days');
+SELECT windowAvg(tint '{1@2000-01-01, 2@2000-01-02, 3@2000-01-05}', interval '2 days');
 
+/* Errors */
+SELECT windowSum(tfloat '[1@2000-01-01, 2@2000-01-02]', interval '1 day');
 
+--------------------------------------------------
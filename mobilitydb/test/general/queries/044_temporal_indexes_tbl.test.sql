@@ -71,7 +71,8 @@ CREATE TABLE test_idxops(
   no_idx BIGINT,
   rtree_idx BIGINT,
   quadtree_idx BIGINT,
-  kdtree_idx BIGINT
+  kdtree_idx BIGINT,
+  mrtree_idx BIGINT
 );
 
 -------------------------------------------------------------------------------
@@ -802,6 +803,274 @@ DROP INDEX tbl_tint_big_rtree_idx;
 DROP INDEX tbl_tfloat_big_rtree_idx;
 DROP INDEX tbl_ttext_big_rtree_idx;
 
+-------------------------------------------------------------------------------
+-- Multi-box R-tree Index
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tint_big_mrtree_idx ON tbl_tint_big USING GIST(temp tint_mrtree_ops);
+CREATE INDEX tbl_tfloat_big_mrtree_idx ON tbl_tfloat_big USING GIST(temp tfloat_mrtree_ops);
+
+-------------------------------------------------------------------------------
+
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && intspan '[1,3]' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @> intspan '[1,3]' )
+WHERE op = '@>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <@ intspan '[1,3]' )
+WHERE op = '<@' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp ~= intspan '[1,3]' )
+WHERE op = '~=' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp -|- intspan '[1,3]' )
+WHERE op = '-|-' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp << intspan '[1,3]' )
+WHERE op = '<<' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &< intspan '[1,3]' )
+WHERE op = '&<' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp >> intspan '[97,100]' )
+WHERE op = '>>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &> intspan '[97,100]' )
+WHERE op = '&>' AND leftarg = 'tint' AND rightarg = 'intspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tint' AND rightarg = 'tstzspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tint' AND rightarg = 'tstzspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp #>> tstzspan '[2001-11-01, 2001-12-01]' )
+WHERE op = '#>>' AND leftarg = 'tint' AND rightarg = 'tstzspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp #&> tstzspan '[2001-11-01, 2001-12-01]' )
+WHERE op = '#&>' AND leftarg = 'tint' AND rightarg = 'tstzspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @> tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '@>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <@ tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '<@' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp ~= tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '~=' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp << tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '<<' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &< tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '&<' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp >> tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '>>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &> tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '&>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <<# tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '<<#' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &<# tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '&<#' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp #>> tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '#>>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp #&> tbox 'TBOXINT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '#&>' AND leftarg = 'tint' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp < tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <= tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<=' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp > tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '>' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp >= tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '>=' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp && tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp @> tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '@>' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <@ tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp ~= tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '~=' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp << tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<<' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &< tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '&<' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp >> tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '>>' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &> tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '&>' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp <<# tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp &<# tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp #>> tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tint' AND rightarg = 'tint';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tint_big WHERE temp #&> tint '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tint' AND rightarg = 'tint';
+
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && floatspan '[1,3]' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp @> floatspan '[1,3]' )
+WHERE op = '@>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <@ floatspan '[1,3]' )
+WHERE op = '<@' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp ~= floatspan '[1,3]' )
+WHERE op = '~=' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp -|- floatspan '[1,3]' )
+WHERE op = '-|-' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp << floatspan '[1,3]' )
+WHERE op = '<<' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &< floatspan '[1,3]' )
+WHERE op = '&<' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp >> floatspan '[97,100]' )
+WHERE op = '>>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &> floatspan '[97,100]' )
+WHERE op = '&>' AND leftarg = 'tfloat' AND rightarg = 'floatspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &<# tstzspan '[2001-01-01,2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #>> tstzspan '[2001-11-01, 2001-12-01]' )
+WHERE op = '#>>' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #&> tstzspan '[2001-11-01, 2001-12-01]' )
+WHERE op = '#&>' AND leftarg = 'tfloat' AND rightarg = 'tstzspan';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp @> tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '@>' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <@ tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '<@' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp ~= tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '~=' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp -|- tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '-|-' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp << tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '<<' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &< tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '&<' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp >> tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '>>' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &> tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '&>' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <<# tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '<<#' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &<# tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '&<#' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #>> tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '#>>' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #&> tbox 'TBOXFLOAT XT([1,50],[2001-01-01,2001-02-01])' )
+WHERE op = '#&>' AND leftarg = 'tfloat' AND rightarg = 'tbox';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp < tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <= tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<=' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp > tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '>' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp >= tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '>=' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp && tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '&&' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp @> tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '@>' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <@ tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<@' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp ~= tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '~=' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp -|- tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '-|-' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp << tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<<' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &< tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '&<' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp >> tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '>>' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &> tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '&>' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp <<# tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '<<#' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp &<# tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '&<#' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #>> tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '#>>' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+UPDATE test_idxops
+SET mrtree_idx = ( SELECT COUNT(*) FROM tbl_tfloat_big WHERE temp #&> tfloat '[1@2001-01-01, 10@2001-02-01]' )
+WHERE op = '#&>' AND leftarg = 'tfloat' AND rightarg = 'tfloat';
+
+-------------------------------------------------------------------------------
+
+DROP INDEX tbl_tint_big_mrtree_idx;
+DROP INDEX tbl_tfloat_big_mrtree_idx;
+
 -------------------------------------------------------------------------------
 -- Quad-tree Index
 -------------------------------------------------------------------------------
@@ -1669,6 +1938,7 @@ DROP INDEX tbl_ttext_big_kdtree_idx;
 
 SELECT * FROM test_idxops
 WHERE no_idx <> rtree_idx OR no_idx <> quadtree_idx OR no_idx <> kdtree_idx OR
+  no_idx <> mrtree_idx OR
   no_idx IS NULL OR rtree_idx IS NULL OR quadtree_idx IS NULL OR kdtree_idx IS NULL
 ORDER BY op, leftarg, rightarg;
 
@@ -1683,6 +1953,7 @@ CREATE INDEX tbl_tfloat_big_rtree_idx ON tbl_tfloat_big USING GIST(temp);
 -- EXPLAIN ANALYZE
 SELECT temp |=| intspan '[90,100]'::tbox FROM tbl_tint_big ORDER BY 1 LIMIT 3;
 SELECT temp |=| tint '[1@2001-06-01, 2@2001-07-01]' FROM tbl_tint_big ORDER BY 1 LIMIT 3;
+SELECT temp |=| 95 FROM tbl_tint_big ORDER BY 1 LIMIT 3;
 
 WITH test AS (
   SELECT temp |=| floatspan '[100,100]'::tbox AS distance FROM tbl_tfloat_big ORDER BY 1 LIMIT 3 )
@@ -1690,6 +1961,9 @@ SELECT round(distance::numeric, 6) FROM test;
 WITH test AS (
   SELECT temp |=| tfloat '[1.5@2001-06-01, 2.5@2001-07-01]' AS distance FROM tbl_tfloat_big ORDER BY 1 LIMIT 3 )
 SELECT round(distance::numeric, 6) FROM test;
+WITH test AS (
+  SELECT temp |=| 100.0 AS distance FROM tbl_tfloat_big ORDER BY 1 LIMIT 3 )
+SELECT round(distance::numeric, 6) FROM test;
 
 DROP INDEX tbl_tint_big_rtree_idx;
 DROP INDEX tbl_tfloat_big_rtree_idx;
@@ -1702,6 +1976,7 @@ CREATE INDEX tbl_tfloat_big_quadtree_idx ON tbl_tfloat_big USING SPGIST(temp);
 -- EXPLAIN ANALYZE
 SELECT temp |=| intspan '[90,100]'::tbox FROM tbl_tint_big ORDER BY 1 LIMIT 3;
 SELECT temp |=| tint '[1@2001-06-01, 2@2001-07-01]' FROM tbl_tint_big ORDER BY 1 LIMIT 3;
+SELECT temp |=| 95 FROM tbl_tint_big ORDER BY 1 LIMIT 3;
 
 WITH test AS (
   SELECT temp |=| floatspan '[100,100]'::tbox AS distance FROM tbl_tfloat_big ORDER BY 1 LIMIT 3 )
@@ -1709,6 +1984,9 @@ SELECT round(distance::numeric, 6) FROM test;
 WITH test AS (
   SELECT temp |=| tfloat '[1.5@2001-06-01, 2.5@2001-07-01]' AS distance FROM tbl_tfloat_big ORDER BY 1 LIMIT 3 )
 SELECT round(distance::numeric, 6) FROM test;
+WITH test AS (
+  SELECT temp |=| 100.0 AS distance FROM tbl_tfloat_big ORDER BY 1 LIMIT 3 )
+SELECT round(distance::numeric, 6) FROM test;
 
 DROP INDEX tbl_tint_big_quadtree_idx;
 DROP INDEX tbl_tfloat_big_quadtree_idx;
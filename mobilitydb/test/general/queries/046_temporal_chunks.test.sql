@@ -0,0 +1,47 @@
+-------------------------------------------------------------------------------
+--
+-- This MobilityDB code is provided under The PostgreSQL License.
+-- Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+-- contributors
+--
+-- MobilityDB includes portions of PostGIS version 3 source code released
+-- under the GNU General Public License (GPLv2 or later).
+-- Copyright (c) 2001-2024, PostGIS contributors
+--
+-- Permission to use, copy, modify, and distribute this software and its
+-- documentation for any purpose, without fee, and without a written
+-- agreement is hereby granted, provided that the above copyright notice and
+-- this paragraph and the following two paragraphs appear in all copies.
+--
+-- IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+-- DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+-- LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+-- EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+-- OF SUCH DAMAGE.
+--
+-- UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+-- INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+-- AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+-- AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+-- PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+--
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Chunked storage
+-------------------------------------------------------------------------------
+
+DROP TABLE IF EXISTS tbl_tfloat_chunks;
+CREATE TABLE tbl_tfloat_chunks(id bigint, chunk timestamptz, temp tfloat,
+  PRIMARY KEY (id, chunk));
+SELECT chunkAppendInstant('tbl_tfloat_chunks', 1, tfloat '1@2001-01-01 12:00', '1 day');
+SELECT chunkAppendInstant('tbl_tfloat_chunks', 1, tfloat '2@2001-01-01 18:00', '1 day');
+SELECT chunkAppendInstant('tbl_tfloat_chunks', 1, tfloat '3@2001-01-02 06:00', '1 day');
+SELECT chunkAppendInstant('tbl_tfloat_chunks', 1, tfloat '4@2001-01-03 06:00', '1 day');
+SELECT COUNT(*) FROM tbl_tfloat_chunks;
+SELECT merge(temp ORDER BY chunk) FROM tbl_tfloat_chunks WHERE id = 1;
+SELECT COUNT(*) FROM tbl_tfloat_chunks WHERE temp && tstzspan '[2001-01-02 12:00, 2001-01-02 18:00]';
+SELECT merge(atTime(temp, tstzspan '[2001-01-02 12:00, 2001-01-02 18:00]') ORDER BY chunk) FROM tbl_tfloat_chunks WHERE temp && tstzspan '[2001-01-02 12:00, 2001-01-02 18:00]';
+DROP TABLE tbl_tfloat_chunks;
+
+-------------------------------------------------------------------------------
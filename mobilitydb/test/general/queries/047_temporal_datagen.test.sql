@@ -0,0 +1,46 @@
+-------------------------------------------------------------------------------
+--
+-- This MobilityDB code is provided under The PostgreSQL License.
+-- Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+-- contributors
+--
+-- MobilityDB includes portions of PostGIS version 3 source code released
+-- under the GNU General Public License (GPLv2 or later).
+-- Copyright (c) 2001-2024, PostGIS contributors
+--
+-- Permission to use, copy, modify, and distribute this software and its
+-- documentation for any purpose, without fee, and without a written
+-- agreement is hereby granted, provided that the above copyright notice and
+-- this paragraph and the following two paragraphs appear in all copies.
+--
+-- IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+-- DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+-- LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+-- EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+-- OF SUCH DAMAGE.
+--
+-- UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+-- INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+-- AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+-- AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+-- PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+--
+-------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Random generation
+-------------------------------------------------------------------------------
+
+SELECT COUNT(*) FROM tfloatRandomBulk(100, 1, tbox 'TBOXFLOAT XT([1, 100],[2001-01-01, 2001-12-31])', 10, 10, 5, 10);
+SELECT bool_and(numInstants(t) BETWEEN 5 AND 10 AND t <@ tbox 'TBOXFLOAT XT([1, 100],[2001-01-01, 2001-12-31])') FROM tfloatRandomBulk(100, 1, tbox 'TBOXFLOAT XT([1, 100],[2001-01-01, 2001-12-31])', 10, 10, 5, 10) t;
+SELECT array_agg(t) = (SELECT array_agg(t) FROM tintRandomBulk(20, 7, tbox 'TBOXINT XT([1, 100],[2001-01-01, 2001-12-31])', 5, 10, 1, 10) t) FROM tintRandomBulk(20, 7, tbox 'TBOXINT XT([1, 100],[2001-01-01, 2001-12-31])', 5, 10, 1, 10) t;
+SELECT bool_and(numSequences(t) BETWEEN 2 AND 4) FROM tboolRandomBulk(50, 3, tstzspan '[2001-01-01, 2001-12-31]', 60, 2, 5, 2, 4, 'SequenceSet') t;
+SELECT bool_and(interp(t) = 'Discrete' AND numInstants(t) BETWEEN 1 AND 5) FROM ttextRandomBulk(20, 5, tstzspan '[2001-01-01, 2001-02-01]', 10, 60, 1, 5, interp := 'discrete') t;
+SELECT bool_and(tempSubtype(t) = 'Instant') FROM tintRandomBulk(20, 5, tbox 'TBOXINT XT([1, 100],[2001-01-01, 2001-12-31])', 5, 10, 1, 1, subtype := 'Instant') t;
+
+/* Errors */
+SELECT tfloatRandom(tbox 'TBOXFLOAT XT([1, 5],[2001-01-01, 2001-12-31])', 10, 10, 5, 10);
+SELECT tboolRandom(tstzspan '[2001-01-01, 2001-12-31]', 10, 5, 1);
+SELECT tintRandom(tbox 'TBOXINT XT([1, 100],[2001-01-01, 2001-12-31])', 5, 10, 1, 10, interp := 'linear');
+
+-------------------------------------------------------------------------------
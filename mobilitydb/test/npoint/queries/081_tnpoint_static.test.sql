@@ -173,4 +173,12 @@ SELECT nsegment 'nsegment(1,0.3,0.5)' >= nsegment 'nsegment(1,0.3,0.7)';
 SELECT nsegment 'nsegment(1,0.3,0.5)' >= nsegment 'nsegment(1,0.5,0.7)';
 SELECT nsegment 'nsegment(1,0.3,0.5)' >= nsegment 'nsegment(2,0.3,0.5)';
 
+-------------------------------------------------------------------------------
+-- Route cache
+-------------------------------------------------------------------------------
+
+SELECT capacity FROM routeCacheStats();
+SELECT count > 0 FROM routeCacheStats();
+SELECT hits > 0 AND misses > 0 FROM routeCacheStats();
+
 -------------------------------------------------------------------------------/
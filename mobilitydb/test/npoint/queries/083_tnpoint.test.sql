@@ -148,6 +148,9 @@ SELECT setInterp(tnpoint 'Interp=Step;{[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4
 
 SELECT round(tnpoint '{[NPoint(1, 0.123456789)@2012-01-01, NPoint(1, 0.5)@2012-01-02)}', 6);
 
+SELECT pack(tnpoint '{[NPoint(1, 0.25)@2012-01-01, NPoint(1, 0.5)@2012-01-02), [NPoint(2, 0.75)@2012-01-03]}');
+SELECT round(pack(tnpoint '[NPoint(1, 0.123456789)@2012-01-01, NPoint(1, 0.5)@2012-01-02]'), 6);
+
 -------------------------------------------------------------------------------
 -- Append functions
 -------------------------------------------------------------------------------
@@ -186,6 +189,10 @@ SELECT tgeompoint 'SRID=5676;Point(-1 -1)@2000-01-01'::tnpoint;
 SELECT tgeompoint 'SRID=5676;{POINT(48.7186629128278 77.7640705101509)@2000-01-01, POINT(48.71 77.76)@2000-01-02}'::tnpoint;
 SELECT tgeompoint 'SRID=5676;[POINT(48.7186629128278 77.7640705101509)@2000-01-01, POINT(48.71 77.76)@2000-01-02]'::tnpoint;
 SELECT tgeompoint 'SRID=5676;{[POINT(62.7866330839742 80.1435561997142)@2000-01-01, POINT(62.7866330839742 80.1435561997142)@2000-01-02],[POINT(48.7186629128278 77.7640705101509)@2000-01-03, POINT(48.71 77.76)@2000-01-04]}'::tnpoint;
+SELECT round(snapToNetwork(tnpoint '[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02, Npoint(1, 0.5)@2000-01-03]'::tgeompoint, 0.001), 6);
+SELECT round(snapToNetwork(tgeompointSeq(ARRAY[tnpoint 'Npoint(1, 0.2)@2000-01-01'::tgeompoint, tnpoint 'Npoint(1, 0.4)@2000-01-02'::tgeompoint, tnpoint 'Npoint(2, 0.6)@2000-01-03'::tgeompoint]), 0.001), 6);
+SELECT round(snapToNetwork(tgeompoint 'SRID=5676;[POINT(48.7186629128278 77.7640705101509)@2000-01-01, POINT(-1 -1)@2000-01-02]', 0.001), 6);
+SELECT snapToNetwork(tgeompoint 'SRID=5676;Point(-1 -1)@2000-01-01', 0.001);
 /* Errors */
 SELECT tgeompoint 'Point(-1 -1)@2000-01-01'::tnpoint;
 
@@ -226,6 +233,7 @@ SELECT routes(tnpoint 'Npoint(1, 0.5)@2000-01-01');
 SELECT routes(tnpoint '{Npoint(1, 0.3)@2000-01-01, Npoint(1, 0.5)@2000-01-02, Npoint(1, 0.5)@2000-01-03}');
 SELECT routes(tnpoint '[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02, Npoint(1, 0.5)@2000-01-03]');
 SELECT routes(tnpoint '{[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02, Npoint(1, 0.5)@2000-01-03], [Npoint(2, 0.6)@2000-01-04, Npoint(2, 0.6)@2000-01-05]}');
+SELECT routes(pack(tnpoint '{Npoint(1, 0.25)@2000-01-01, Npoint(2, 0.5)@2000-01-02, Npoint(1, 0.5)@2000-01-03}'));
 
 SELECT getTime(tnpoint 'Npoint(1, 0.5)@2000-01-01');
 SELECT getTime(tnpoint '{Npoint(1, 0.3)@2000-01-01, Npoint(1, 0.5)@2000-01-02, Npoint(1, 0.5)@2000-01-03}');
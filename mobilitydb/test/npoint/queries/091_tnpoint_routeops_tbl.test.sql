@@ -163,3 +163,34 @@ ORDER BY op, leftarg, rightarg;
 DROP TABLE test_tnpoint_routeops;
 
 -------------------------------------------------------------------------------
+
+-- Selectivity estimation using the most common routes
+
+CREATE TABLE tbl_tnpoint_routes AS
+SELECT k, format('{NPoint(%s,0.5)@2001-01-01, NPoint(%s,0.5)@2001-01-02}',
+  1 + k % 10, 50 + k % 4)::tnpoint AS temp
+FROM generate_series(1, 1000) AS k;
+ANALYZE tbl_tnpoint_routes;
+
+CREATE FUNCTION plan_rows(query text)
+RETURNS BIGINT AS $$
+DECLARE
+  J JSON;
+BEGIN
+  EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO J;
+  RETURN (J->0->'Plan'->>'Plan Rows')::BIGINT;
+END;
+$$ LANGUAGE 'plpgsql';
+
+SELECT plan_rows('SELECT * FROM tbl_tnpoint_routes WHERE temp @? 3');
+SELECT plan_rows('SELECT * FROM tbl_tnpoint_routes WHERE temp @? 42');
+SELECT plan_rows('SELECT * FROM tbl_tnpoint_routes WHERE temp @? npoint ''NPoint(3,0.5)''');
+SELECT plan_rows('SELECT * FROM tbl_tnpoint_routes WHERE temp @? bigintset ''{3, 51}''');
+SELECT plan_rows('SELECT * FROM tbl_tnpoint_routes WHERE temp @@ bigintset ''{3, 4}''');
+SELECT plan_rows('SELECT * FROM tbl_tnpoint_routes WHERE bigintset ''{3, 4}'' @@ temp');
+SELECT plan_rows('SELECT * FROM tbl_tnpoint_routes WHERE temp ?@ bigintset ''{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 50}''');
+
+DROP FUNCTION plan_rows;
+DROP TABLE tbl_tnpoint_routes;
+
+-------------------------------------------------------------------------------
@@ -76,5 +76,12 @@ SELECT round(tnpoint '{Npoint(1, 0.3)@2000-01-01, Npoint(1, 0.5)@2000-01-02, Npo
 SELECT round(tnpoint '[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02, Npoint(1, 0.5)@2000-01-03]' <-> tnpoint '{[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02, Npoint(1, 0.5)@2000-01-03], [Npoint(2, 0.6)@2000-01-04, Npoint(2, 0.6)@2000-01-05]}', 6);
 SELECT round(tnpoint '{[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02, Npoint(1, 0.5)@2000-01-03], [Npoint(2, 0.6)@2000-01-04, Npoint(2, 0.6)@2000-01-05]}' <-> tnpoint '{[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02, Npoint(1, 0.5)@2000-01-03], [Npoint(2, 0.6)@2000-01-04, Npoint(2, 0.6)@2000-01-05]}', 6);
 
+SELECT round(networkDistance(npoint 'Npoint(1, 0.2)', npoint 'Npoint(1, 0.5)')::numeric, 6);
+SELECT networkDistance(npoint 'Npoint(1, 0.2)', npoint 'Npoint(2, 0.5)');
+SELECT round(networkDistance(tnpoint '[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02, Npoint(1, 0.5)@2000-01-03]', tnpoint '[Npoint(1, 0.6)@2000-01-01, Npoint(1, 0.6)@2000-01-03]'), 6);
+SELECT round(networkDistance(tnpoint '[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.6)@2000-01-03]', tnpoint '[Npoint(1, 0.6)@2000-01-01, Npoint(1, 0.2)@2000-01-03]'), 6);
+SELECT round(networkDistance(tnpoint '{Npoint(1, 0.3)@2000-01-01, Npoint(2, 0.5)@2000-01-02}', npoint 'Npoint(1, 0.5)'), 6);
+SELECT networkDistance(tnpoint '[Npoint(1, 0.2)@2000-01-01, Npoint(1, 0.4)@2000-01-02]', tnpoint '[Npoint(2, 0.2)@2000-01-01, Npoint(2, 0.4)@2000-01-02]');
+
 -------------------------------------------------------------------------------
 
@@ -683,6 +683,16 @@ SELECT memSize(tgeogpoint '{Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02
 SELECT memSize(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]') > 0;
 SELECT memSize(tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}') > 0;
 
+SELECT compress(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]');
+SELECT compress(tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}') = tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}';
+SELECT stbox(compress(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'));
+SELECT asText(quantize(tgeompoint '[Point(1.234 1.234)@2000-01-01, Point(2.341 2.341)@2000-01-02, Point(1.004 1.006)@2000-01-03]', 0.01));
+SELECT stbox(quantize(tgeompoint '[Point(1.234 1.234)@2000-01-01, Point(2.341 2.341)@2000-01-02, Point(1.004 1.006)@2000-01-03]', 0.01));
+SELECT memSize(quantize(tgeompoint '[Point(1.234 1.234)@2000-01-01, Point(2.341 2.341)@2000-01-02, Point(1.004 1.006)@2000-01-03]', 0.01)) < memSize(tgeompoint '[Point(1.234 1.234)@2000-01-01, Point(2.341 2.341)@2000-01-02, Point(1.004 1.006)@2000-01-03]');
+SELECT quantize(tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02], [Point(3 3 3)@2000-01-03]}', 0.5) = tgeompoint '{[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02], [Point(3 3 3)@2000-01-03]}';
+/* Errors */
+SELECT quantize(tgeompoint '[Point(0 0)@2000-01-01, Point(1000 1000)@2000-01-02]', 1e-7);
+
 SELECT stbox(tgeompoint 'Point(1 1)@2000-01-01');
 SELECT round(stbox(tgeogpoint 'Point(1.5 1.5)@2000-01-01'), 13);
 
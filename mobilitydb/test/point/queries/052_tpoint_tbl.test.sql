@@ -49,6 +49,44 @@ SELECT COUNT(*) FROM tbl_tgeogpoint t1, tbl_tgeogpoint_tmp t2 WHERE t1.k = t2.k
 DROP TABLE tbl_tgeompoint_tmp;
 DROP TABLE tbl_tgeogpoint_tmp;
 
+-- Native binary format
+SET mobilitydb.native_binary = on;
+
+COPY tbl_tgeompoint TO '/tmp/tbl_tgeompoint_native' (FORMAT BINARY);
+COPY tbl_tgeogpoint TO '/tmp/tbl_tgeogpoint_native' (FORMAT BINARY);
+
+CREATE TABLE tbl_tgeompoint_tmp AS TABLE tbl_tgeompoint WITH NO DATA;
+CREATE TABLE tbl_tgeogpoint_tmp AS TABLE tbl_tgeogpoint WITH NO DATA;
+
+COPY tbl_tgeompoint_tmp FROM '/tmp/tbl_tgeompoint_native' (FORMAT BINARY);
+COPY tbl_tgeogpoint_tmp FROM '/tmp/tbl_tgeogpoint_native' (FORMAT BINARY);
+
+SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_tgeompoint_tmp t2 WHERE t1.k = t2.k AND t1.temp <> t2.temp;
+SELECT COUNT(*) FROM tbl_tgeogpoint t1, tbl_tgeogpoint_tmp t2 WHERE t1.k = t2.k AND t1.temp <> t2.temp;
+
+DROP TABLE tbl_tgeompoint_tmp;
+DROP TABLE tbl_tgeogpoint_tmp;
+
+CREATE TABLE tbl_tgeompoint_native(temp tgeompoint);
+CREATE TABLE tbl_tgeogpoint_native(temp tgeogpoint);
+
+/* Errors */
+COPY (SELECT tgeompoint 'Point(1 1)@2000-01-01') TO '/tmp/tgeompoint_native' (FORMAT BINARY);
+COPY tbl_tgeogpoint_native FROM '/tmp/tgeompoint_native' (FORMAT BINARY);
+-- Z flag of the temporal point set for a 2D point
+COPY (SELECT set_byte(b, 18, get_byte(b, 18) | 32) FROM (SELECT temporal_send(tgeompoint 'Point(1 1)@2000-01-01') AS b) t) TO '/tmp/tgeompoint_native_corrupt' (FORMAT BINARY);
+COPY tbl_tgeompoint_native FROM '/tmp/tgeompoint_native_corrupt' (FORMAT BINARY);
+-- Geodetic flag of the point set for a temporal geometry point
+COPY (SELECT set_byte(b, 35, get_byte(b, 35) | 8) FROM (SELECT temporal_send(tgeompoint 'Point(1 1)@2000-01-01') AS b) t) TO '/tmp/tgeompoint_native_corrupt' (FORMAT BINARY);
+COPY tbl_tgeompoint_native FROM '/tmp/tgeompoint_native_corrupt' (FORMAT BINARY);
+-- Size of the point greater than the instant
+COPY (SELECT set_byte(b, 31, 127) FROM (SELECT temporal_send(tgeompoint 'Point(1 1)@2000-01-01') AS b) t) TO '/tmp/tgeompoint_native_corrupt' (FORMAT BINARY);
+COPY tbl_tgeompoint_native FROM '/tmp/tgeompoint_native_corrupt' (FORMAT BINARY);
+SET mobilitydb.native_binary = off;
+
+DROP TABLE tbl_tgeompoint_native;
+DROP TABLE tbl_tgeogpoint_native;
+
 ------------------------------------------------------------------------------
 -- Transformation functions
 ------------------------------------------------------------------------------
@@ -497,3 +535,21 @@ SELECT COUNT(*) FROM tbl_tgeogpoint3D t1, tbl_tgeogpoint3D t2
 WHERE t1.temp >= t2.temp;
 
 -------------------------------------------------------------------------------
+-- Hash functions
+-------------------------------------------------------------------------------
+
+-- The low-order 32 bits of the extended hash with seed 0 are the 32-bit hash
+SELECT COUNT(*) FROM tbl_tgeompoint
+WHERE (temporal_hash_extended(temp, 0) & 4294967295) <>
+  (temporal_hash(temp)::bigint & 4294967295);
+SELECT COUNT(*) FROM tbl_tgeogpoint
+WHERE (temporal_hash_extended(temp, 0) & 4294967295) <>
+  (temporal_hash(temp)::bigint & 4294967295);
+SELECT COUNT(*) FROM tbl_tgeompoint3D
+WHERE (temporal_hash_extended(temp, 0) & 4294967295) <>
+  (temporal_hash(temp)::bigint & 4294967295);
+SELECT COUNT(*) FROM tbl_tgeogpoint3D
+WHERE (temporal_hash_extended(temp, 0) & 4294967295) <>
+  (temporal_hash(temp)::bigint & 4294967295);
+
+-------------------------------------------------------------------------------
@@ -428,6 +428,10 @@ SELECT round(length(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-
 SELECT round(length(tgeogpoint '{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}')::numeric, 6);
 SELECT round(length(tgeogpoint 'Interp=Step;[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]')::numeric, 6);
 SELECT round(length(tgeogpoint 'Interp=Step;{[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03],[Point(3.5 3.5)@2000-01-04, Point(3.5 3.5)@2000-01-05]}')::numeric, 6);
+SET mobilitydb.fast_geodetic = on;
+SELECT round(length(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]')::numeric, 6);
+SELECT abs(length(tgeogpoint '[Point(1.5 1.5)@2000-01-01, Point(2.5 2.5)@2000-01-02, Point(1.5 1.5)@2000-01-03]') / 313711.325313 - 1) < 0.005;
+RESET mobilitydb.fast_geodetic;
 -- 3D
 SELECT round(length(tgeompoint 'Point(1 1 1)@2000-01-01')::numeric, 6);
 SELECT round(length(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}')::numeric, 6);
@@ -818,6 +822,14 @@ SELECT asText(atGeometry(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01
 SELECT asText(atGeometry(tgeompoint '[Point(0 3)@2000-01-01, Point(1 1)@2000-01-02, Point(3 2)@2000-01-03, Point(0 3)@2000-01-04]', geometry 'Polygon((0 0,0 2,2 2,2 0,0 0))'));
 SELECT astext(atGeometry(tgeompoint '[Point(0 0)@2000-01-01, Point(3 3)@2000-01-02, Point(0 3)@2000-01-03, Point(
 3 0)@2000-01-04]', 'Polygon((1 1,2 1,2 2,1 2,1 1))'));
+WITH poly(geom) AS (SELECT ST_MakePolygon(ST_MakeLine(ARRAY(SELECT ST_Point(x, 0) FROM generate_series(0, 1000) AS x ORDER BY x) || ARRAY[ST_Point(1000, 10), ST_Point(0, 10), ST_Point(0, 0)])))
+SELECT asText(atGeometry(tgeompoint '[Point(-12 5)@2000-01-01, Point(1012 5)@2000-01-01 17:04:00]', geom)) FROM poly;
+WITH poly(geom) AS (SELECT ST_MakePolygon(ST_MakeLine(ARRAY(SELECT ST_Point(x, 0) FROM generate_series(0, 1000) AS x ORDER BY x) || ARRAY[ST_Point(1000, 10), ST_Point(0, 10), ST_Point(0, 0)])))
+SELECT asText(atGeometry(tgeompoint '[Point(-10 0)@2000-01-01, Point(1014 0)@2000-01-01 17:04:00]', geom)) FROM poly;
+WITH poly(geom) AS (SELECT ST_MakePolygon(ST_MakeLine(ARRAY(SELECT ST_Point(x, 0) FROM generate_series(0, 1000) AS x ORDER BY x) || ARRAY[ST_Point(1000, 10), ST_Point(0, 10), ST_Point(0, 0)])))
+SELECT asText(atGeometry(tgeompoint '[Point(500.5 -5)@2000-01-01, Point(500.5 15)@2000-01-01 20:00:00]', geom)) FROM poly;
+WITH poly(geom) AS (SELECT ST_MakePolygon(ST_MakeLine(ARRAY(SELECT ST_Point(x, 0) FROM generate_series(0, 1000) AS x ORDER BY x) || ARRAY[ST_Point(1000, 10), ST_Point(0, 10), ST_Point(0, 0)])))
+SELECT asText(minusGeometry(tgeompoint '[Point(-12 5)@2000-01-01, Point(1012 5)@2000-01-01 17:04:00]', geom)) FROM poly;
 SELECT asText(atGeometry(tgeompoint 'Interp=Step;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(atGeometry(tgeompoint 'Interp=Step;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', geometry 'Linestring(0 0,3 3)'));
 SELECT asText(atGeometry(tgeompoint 'Interp=Step;[Point(0 3)@2000-01-01, Point(1 1)@2000-01-02, Point(3 2)@2000-01-03, Point(0 3)@2000-01-04]', geometry 'Polygon((0 0,0 2,2 2,2 0,0 0))'));
@@ -183,3 +183,57 @@ FROM (SELECT spaceTimeSplit(tgeompoint 'Interp=Step;{[Point(1 1 1)@2000-01-01, P
 SELECT spaceTimeSplit(tgeompoint 'SRID=5676;Point(1 1 1)@2000-01-01', 2.0, interval '2 days', 'SRID=3812;Point(0.5 0.5 0.5)');
 
 -------------------------------------------------------------------------------
+
+-------------------------------------------------------------------------------
+-- Tile identifiers
+-------------------------------------------------------------------------------
+
+SELECT spaceTiles(tgeompoint '[Point(1 1)@2000-01-01, Point(5 1)@2000-01-05]', 2.0);
+SELECT spaceTiles(tgeompoint 'Point(-1 -1)@2000-01-01', 2.0);
+SELECT spaceTiles(stbox 'STBOX X((1,1),(3,3))', 2.0);
+SELECT spaceTimeTiles(tgeompoint 'Point(1 1)@2000-01-04', 2.0, interval '1 day');
+SELECT spaceTiles(tgeompoint '[Point(1 1)@2000-01-01, Point(5 1)@2000-01-05]', 2.0) && spaceTiles(stbox 'STBOX X((3,0),(3.5,0.5))', 2.0);
+-- The grid cached across the rows is updated when its parameters change
+SELECT k, spaceTiles(tgeompoint '[Point(1 1)@2000-01-01, Point(5 1)@2000-01-05]', k) FROM (VALUES (2.0::float), (4.0), (2.0)) AS t(k);
+SELECT i, COUNT(*) FROM (VALUES (1, 2.0::float), (2, 4.0), (3, 2.0)) AS t(i, k), spaceSplit(tgeompoint '[Point(1 1)@2000-01-01, Point(5 1)@2000-01-05]', k) GROUP BY i ORDER BY i;
+
+-------------------------------------------------------------------------------
+-- Hierarchical tile keys
+-------------------------------------------------------------------------------
+
+SELECT tileKey(geometry 'Point(1 1)', 2.0);
+SELECT tileKey(geometry 'Point(-1 3)', 2.0);
+SELECT tileKey(geometry 'Point(1 1 1)', 2.0);
+SELECT tileKey(geometry 'Point(1 1)', timestamptz '2000-01-04', 2.0, interval '1 day');
+SELECT tileKeyLevel(tileKey(geometry 'Point(1 1)', 2.0));
+SELECT tileKeyParent(tileKey(geometry 'Point(3 1)', 2.0)) = tileKeyParent(tileKey(geometry 'Point(1 3)', 2.0));
+SELECT tileKeyLevel(tileKeyParent(tileKey(geometry 'Point(1 1)', 2.0), 10));
+SELECT tileKeyChildren(tileKeyParent(tileKey(geometry 'Point(1 1)', 2.0)));
+SELECT (sp).key, astext((sp).tpoint) AS tpoint
+FROM (SELECT spaceKeySplit(tgeompoint '[Point(1 1)@2000-01-01, Point(5 1)@2000-01-05]', 2.0) AS sp) t;
+
+/* Errors */
+SELECT tileKeyParent(1);
+SELECT tileKeyParent(tileKey(geometry 'Point(1 1)', 2.0), 31);
+
+-------------------------------------------------------------------------------
+
+SELECT ST_AsText((td).point) AS point, (td).count, (td).duration, (td).distance
+FROM (SELECT unnest(tileDensity(trip, 2.0, 2.0, geometry 'Point(0 0)')) AS td
+  FROM (VALUES (tgeompoint '[Point(1 1)@2000-01-01, Point(5 1)@2000-01-05]'), ('[Point(1 1)@2000-01-01, Point(1 3)@2000-01-03]')) t(trip)) t;
+SELECT ST_AsText((td).point) AS point, (td).time, (td).count, (td).duration, (td).distance
+FROM (SELECT unnest(tileDensity(trip, 2.0, 2.0, interval '1 day', geometry 'Point(0 0)', timestamptz '2000-01-01')) AS td
+  FROM (VALUES (tgeompoint '[Point(1 1)@2000-01-01, Point(3 1)@2000-01-03]')) t(trip)) t;
+
+-------------------------------------------------------------------------------
+
+SELECT bucketLength(tgeompoint '[Point(0 0)@2000-01-01, Point(0 10)@2000-01-03)', interval '1 day');
+SELECT bucketLength(tgeompoint '{[Point(0 0)@2000-01-01, Point(3 4)@2000-01-01 12:00), [Point(0 0)@2000-01-02, Point(0 0)@2000-01-02 12:00)}', interval '1 day');
+
+-------------------------------------------------------------------------------
+
+SELECT balancedPartitions(ARRAY[stbox 'STBOX X((1,1),(1,1))', 'STBOX X((2,2),(2,2))', 'STBOX X((3,3),(3,3))', 'STBOX X((10,10),(10,10))'], 3);
+/* Errors */
+SELECT balancedPartitions(ARRAY[stbox 'STBOX X((1,1),(1,1))', 'STBOX X((2,2),(2,2))'], 0);
+
+-------------------------------------------------------------------------------
@@ -63,4 +63,8 @@ SELECT extent(tile(g, t, 2.5, interval '2 days', geometry 'Point(10 10 10)', '20
 
 -------------------------------------------------------------------------------
 
+SELECT array_length(balancedPartitions(array_agg(temp::stbox), 4), 1) FROM tbl_tgeompoint WHERE temp IS NOT NULL;
+ANALYZE tbl_tgeompoint;
+SELECT array_length(balancedPartitions('tbl_tgeompoint', 'temp', 4), 1);
 
+-------------------------------------------------------------------------------
@@ -244,6 +244,10 @@ SELECT expandTime(stbox 'GEODSTBOX Z((1.0,2.0,3.0),(1.0,2.0,3.0))', '1 day');
 SELECT expandSpace(geometry 'Linestring empty', 0.5);
 SELECT expandSpace(geometry 'Linestring(1 1,2 2)', 0.5);
 
+SELECT expandSpace(stboxes(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]'), 0.5);
+SELECT tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]' && stboxes(tgeompoint '[Point(3 3)@2000-01-01, Point(4 4)@2000-01-02]');
+SELECT tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]' && expandSpace(stboxes(tgeompoint '[Point(3 3)@2000-01-01, Point(4 4)@2000-01-02]'), 1.0);
+
 -------------------------------------------------------------------------------
 
 SELECT tstzspan '[2000-01-01,2000-01-02]' && tgeompoint 'Point(1 1)@2000-01-01';
@@ -210,6 +210,9 @@ SELECT asText(NearestApproachInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(2
 SELECT asText(NearestApproachInstant(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', geometry 'Linestring empty'));
 SELECT asText(NearestApproachInstant(tgeompoint 'Interp=Step;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]', geometry 'Linestring empty'));
 SELECT asText(NearestApproachInstant(tgeompoint 'Interp=Step;{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}', geometry 'Linestring empty'));
+-- Geometries with enough vertices to use an index of their edges
+SELECT asText(NearestApproachInstant(tgeompoint '[Point(20 0)@2000-01-01, Point(20 10)@2000-01-02]', ST_Buffer(geometry 'Point(0 0)', 10, 500)));
+SELECT asText(NearestApproachInstant(tgeompoint '[Point(5 0)@2000-01-01, Point(30 0)@2000-01-02]', ST_Buffer(geometry 'Point(0 0)', 10, 500)));
 
 SELECT asText(NearestApproachInstant(tgeompoint '[Point(1 1)@2000-01-01, Point(1 1)@2000-01-02]', geometry 'Linestring(1 1,3 3)'));
 
@@ -537,6 +540,8 @@ SELECT round((tgeogpoint 'Point(-90 0)@2000-01-01' |=| geography 'Linestring(90
 SELECT round((tgeogpoint '{Point(-90 0)@2000-01-01, Point(0 0)@2000-01-02, Point(-90 0)@2000-01-03}' |=| geography 'Linestring(90 0,0 90)')::numeric, 6);
 SELECT round((tgeogpoint '[Point(-90 0)@2000-01-01, Point(0 0)@2000-01-02, Point(-90 0)@2000-01-03]' |=| geography 'Linestring(90 0,0 90)')::numeric, 6);
 SELECT round((tgeogpoint '{[Point(-90 0)@2000-01-01, Point(0 0)@2000-01-02, Point(-90 0)@2000-01-03],[Point(90 90)@2000-01-04, Point(90 90)@2000-01-05]}' |=| geography 'Linestring(90 0,0 90)')::numeric, 6);
+SELECT round((tgeogpoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]' |=| geography 'Polygon((0 0,0 10,10 10,10 0,0 0))')::numeric, 6);
+SELECT COUNT(*) FROM generate_series(1, 3) i WHERE tgeogpoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]' |=| geography 'Polygon((0 0,0 10,10 10,10 0,0 0))' = 0;
 
 SELECT round((tgeogpoint 'Point(-90 0)@2000-01-01' |=| geography 'Linestring empty')::numeric, 6);
 SELECT round((tgeogpoint '{Point(-90 0)@2000-01-01, Point(0 0)@2000-01-02, Point(-90 0)@2000-01-03}' |=| geography 'Linestring empty')::numeric, 6);
@@ -819,4 +824,10 @@ SELECT shortestLine(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'Point(1 1 1)
 SELECT shortestLine(geography 'Linestring(90 0 0,0 90 100)', tgeogpoint 'Point(-90 0 100)@2000-01-01');
 SELECT shortestLine(tgeogpoint 'Point(-90 0 100)@2000-01-01', geography 'Linestring(90 0 0,0 90 100)');
 
+SELECT p FROM (SELECT id, knnPeriods(trip, tgeompoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-03]', 1) OVER () AS p FROM (VALUES (1, tgeompoint '[Point(1 0)@2000-01-01, Point(1 0)@2000-01-03]'), (2, tgeompoint '[Point(3 0)@2000-01-01, Point(-2 0)@2000-01-03]')) t(id, trip)) t WHERE id = 1;
+SELECT p FROM (SELECT id, knnPeriods(trip, tgeompoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-03]', 1) OVER () AS p FROM (VALUES (1, tgeompoint '[Point(1 0)@2000-01-01, Point(1 0)@2000-01-03]'), (2, tgeompoint '[Point(3 0)@2000-01-01, Point(-2 0)@2000-01-03]')) t(id, trip)) t WHERE id = 2;
+SELECT p FROM (SELECT id, knnPeriods(trip, tgeompoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-03]', 2) OVER () AS p FROM (VALUES (1, tgeompoint '[Point(1 0)@2000-01-01, Point(1 0)@2000-01-03]'), (2, tgeompoint '[Point(3 0)@2000-01-01, Point(-2 0)@2000-01-03]')) t(id, trip)) t WHERE id = 2;
+/* Errors */
+SELECT p FROM (SELECT id, knnPeriods(trip, tgeompoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-03]', 0) OVER () AS p FROM (VALUES (1, tgeompoint '[Point(1 0)@2000-01-01, Point(1 0)@2000-01-03]'), (2, tgeompoint '[Point(3 0)@2000-01-01, Point(-2 0)@2000-01-03]')) t(id, trip)) t WHERE id = 1;
+
 --------------------------------------------------------
@@ -61,5 +61,7 @@ SELECT COUNT(*) FROM temp;
 
 SELECT round(MAX(hausdorffDistance(t1.temp, t2.temp))::numeric, 6) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t1.k < t2.k;
 SELECT round(MAX(hausdorffDistance(t1.temp, t2.temp))::numeric, 6) FROM tbl_tgeogpoint t1, tbl_tgeogpoint t2 WHERE t1.k < t2.k;
+SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE t1.k < t2.k AND hausdorffDistanceWithin(t1.temp, t2.temp, 80.0) <> (hausdorffDistance(t1.temp, t2.temp) <= 80.0);
+SELECT COUNT(*) FROM tbl_tgeogpoint t1, tbl_tgeogpoint t2 WHERE t1.k < t2.k AND hausdorffDistanceWithin(t1.temp, t2.temp, 3000000.0) <> (hausdorffDistance(t1.temp, t2.temp) <= 3000000.0);
 
 -------------------------------------------------------------------------------
@@ -40,6 +40,9 @@ SELECT asText(tcentroid(temp)) FROM (VALUES
   (tgeompoint '[Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02)'),
   (tgeompoint '[Point(3 3 3)@2000-01-03, Point(4 4 4)@2000-01-04)'),
   (tgeompoint '[Point(2 2 2)@2000-01-02, Point(3 3 3)@2000-01-03)')) t(temp);
+SELECT asText(tcentroid(temp)) FROM (VALUES
+  (tgeompoint '[Point(0 0)@2000-01-01, Point(10 10)@2000-01-03]'),
+  (tgeompoint '[Point(10 0)@2000-01-02, Point(10 0)@2000-01-04]')) t(temp);
 
 /* Errors */
 SELECT asText(tcentroid(temp)) FROM (VALUES
@@ -187,3 +190,26 @@ temp2(seq) AS (
 SELECT numInstants(appendSequence(seq ORDER BY seq)) FROM temp2;
 
 -------------------------------------------------------------------------------
+
+WITH temp(k, trip) AS (
+  SELECT 1, tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-03]' UNION
+  SELECT 2, tgeompoint '[Point(2 0)@2000-01-02, Point(2 2)@2000-01-04]' )
+SELECT tcentroidFinal(taggMerge(state)) = (SELECT tcentroid(trip) FROM temp)
+FROM (SELECT tcentroidState(trip) AS state FROM temp GROUP BY k) t;
+
+WITH temp(k, trip) AS (
+  SELECT 1, tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-03]' UNION
+  SELECT 2, tgeompoint '[Point(2 0)@2000-01-02, Point(2 2)@2000-01-04]' )
+SELECT startTimestamp(tcentroidFinal(taggExpire(tcentroidState(trip), '2000-01-02 12:00'))) FROM temp;
+
+WITH temp(k, trip) AS (
+  SELECT 1, tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-03]' UNION
+  SELECT 2, tgeompoint '[Point(2 0)@2000-01-02, Point(2 2)@2000-01-04]' )
+SELECT tcountFinal(tcountState(trip)) = tcount(trip) FROM temp;
+
+WITH temp(k, trip) AS (
+  SELECT 1, tgeompoint '[Point(0 0)@2000-01-01, Point(2 2)@2000-01-03]' UNION
+  SELECT 2, tgeompoint '[Point(2 0)@2000-01-02, Point(2 2)@2000-01-04]' )
+SELECT taggMerge(tcountState(trip), tcentroidState(trip)) FROM temp;
+
+-------------------------------------------------------------------------------
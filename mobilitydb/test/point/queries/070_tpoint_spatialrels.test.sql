@@ -40,6 +40,8 @@ SELECT eContains(geometry 'Linestring(1 1,3 3)', tgeompoint '[Point(4 2)@2000-01
 SELECT eContains(geometry 'Linestring(1 1,3 3,1 1)', tgeompoint '[Point(4 2)@2000-01-01, Point(2 4)@2000-01-02]');
 SELECT eContains(geometry 'Polygon((1 1,1 3,3 3,3 1,1 1))', tgeompoint '[Point(0 1)@2000-01-01, Point(4 1)@2000-01-02]');
 SELECT eContains(geometry 'Polygon((1 1,1 3,3 3,3 1,1 1))', tgeompoint '[Point(1 4)@2000-01-01, Point(4 1)@2000-01-02]');
+SELECT eContains(geometry 'MultiPolygon(((0 0,1 0,1 1,0 1,0 0)),((2 0,3 0,3 1,2 1,2 0)))', tgeompoint '[Point(1 0.5)@2000-01-01, Point(2 0.5)@2000-01-02]');
+SELECT eContains(geometry 'MultiPolygon(((0 0,1 0,1 1,0 1,0 0)),((2 0,3 0,3 1,2 1,2 0)))', tgeompoint '[Point(0.5 0.5)@2000-01-01, Point(2 0.5)@2000-01-02]');
 
 SELECT eContains(geometry 'Point empty', tgeompoint 'Point(1 1)@2000-01-01');
 SELECT eContains(geometry 'Point empty', tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}');
@@ -208,6 +210,22 @@ SELECT eIntersects(tgeogpoint '{Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5
 SELECT eIntersects(tgeogpoint '[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03]',  geography 'Point Z empty');
 SELECT eIntersects(tgeogpoint '{[Point(1.5 1.5 1.5)@2000-01-01, Point(2.5 2.5 2.5)@2000-01-02, Point(1.5 1.5 1.5)@2000-01-03],[Point(3.5 3.5 3.5)@2000-01-04, Point(3.5 3.5 3.5)@2000-01-05]}',  geography 'Point Z empty');
 
+SELECT eIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(4 4)@2000-01-05]', geometry 'Polygon((2 0,4 0,4 1,2 1,2 0))');
+SELECT eIntersects(tgeompoint '[Point(2 2)@2000-01-01, Point(3 3)@2000-01-02]', geometry 'Polygon((0 0,5 0,5 5,0 5,0 0),(1 1,4 1,4 4,1 4,1 1))');
+SELECT eIntersects(tgeompoint '[Point(2 2)@2000-01-01, Point(6 2)@2000-01-02]', geometry 'Polygon((0 0,5 0,5 5,0 5,0 0),(1 1,4 1,4 4,1 4,1 1))');
+-- Trips whose bounding box contains the geometry
+SELECT eIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(10 10)@2000-01-02]', geometry 'Polygon((7 1,9 1,9 3,7 3,7 1))');
+SELECT eIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(8 0)@2000-01-02, Point(10 10)@2000-01-03]', geometry 'Polygon((7 1,9 1,9 3,7 3,7 1))');
+SELECT eIntersects(tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(8 2)@2000-01-02, Point(10 10)@2000-01-03]', geometry 'Polygon((7 1,9 1,9 3,7 3,7 1))');
+-- Restriction to a span and a box
+SELECT eIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(4 4)@2000-01-05]', tstzspan '[2000-01-02, 2000-01-03]', stbox 'STBOX X((0,0),(10,10))', geometry 'Point(1 1)');
+SELECT eIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(4 4)@2000-01-05]', tstzspan '[2000-01-03, 2000-01-04]', stbox 'STBOX X((0,0),(10,10))', geometry 'Point(1 1)');
+SELECT eIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(4 4)@2000-01-05]', tstzspan '[2000-01-01, 2000-01-05]', stbox 'STBOX X((2,2),(4,4))', geometry 'Point(1 1)');
+SELECT eIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(4 4)@2000-01-05]', tstzspan '[2000-01-01, 2000-01-05]', stbox 'STBOX XT(((0,0),(10,10)),[2000-01-03, 2000-01-05])', geometry 'Linestring(0 3,3 0)');
+SELECT eIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(4 4)@2000-01-05]', tstzspan '[2000-01-01, 2000-01-05]', stbox 'STBOX XT(((0,0),(10,10)),[2000-01-03, 2000-01-05])', geometry 'Point(3 3)');
+SELECT eIntersects(tgeompoint 'Interp=Step;[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 3)@2000-01-03]', tstzspan '[2000-01-02, 2000-01-03]', stbox 'STBOX X((0,0),(10,10))', geometry 'Point(1 1)');
+SELECT eIntersects(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02], [Point(3 3)@2000-01-04, Point(4 4)@2000-01-05]}', tstzspan '[2000-01-03, 2000-01-05]', stbox 'STBOX T([2000-01-01, 2000-01-05])', geometry 'Point(3.5 3.5)');
+
 ------------------------
 -- Temporal x Temporal
 ------------------------
@@ -379,6 +397,11 @@ SELECT eDwithin(tgeompoint 'Point(1 1)@2000-01-01',  geometry 'Linestring(1 1,2
 SELECT eDwithin(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}',  geometry 'Linestring(1 1,2 2)', 2);
 SELECT eDwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03]',  geometry 'Linestring(1 1,2 2)', 2);
 SELECT eDwithin(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03],[Point(3 3)@2000-01-04, Point(3 3)@2000-01-05]}',  geometry 'Point(1 1)', 2);
+-- Geometries with enough vertices to use an index of their edges
+SELECT eDwithin(tgeompoint '[Point(20 0)@2000-01-01, Point(20 10)@2000-01-02]', ST_Buffer(geometry 'Point(0 0)', 10, 500), 11);
+SELECT eDwithin(tgeompoint '[Point(20 0)@2000-01-01, Point(20 10)@2000-01-02]', ST_Buffer(geometry 'Point(0 0)', 10, 500), 9);
+SELECT eDwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', ST_Buffer(geometry 'Point(0 0)', 10, 500), 0);
+SELECT eDwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', ST_Boundary(ST_Buffer(geometry 'Point(0 0)', 10, 500)), 7);
 
 SELECT eDwithin(tgeompoint 'Point(1 1)@2000-01-01',  geometry 'Linestring empty', 2);
 SELECT eDwithin(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}',  geometry 'Linestring empty', 2);
@@ -442,6 +465,13 @@ SELECT eDwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(0 0)@2000-01-02]', tge
 SELECT eDwithin(tgeompoint '{[Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(1 1)@2000-01-05]}', tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-04}', 10);
 SELECT eDwithin(tgeompoint '{[Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(1 1)@2000-01-06]}', tgeompoint '[Point(1 1)@2000-01-04, Point(2 2)@2000-01-05]', 10);
 SELECT eDwithin(tgeompoint '{[Point(1 1)@2000-01-02, Point(2 2)@2000-01-03],[Point(1 1)@2000-01-06]}', tgeompoint '{[Point(1 1)@2000-01-01],[Point(1 1)@2000-01-04, Point(2 2)@2000-01-05]}', 10);
+SELECT eDwithin(tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(5 5)@2000-01-02]', tgeompoint 'Interp=Step;[Point(10 10)@2000-01-01, Point(5 5)@2000-01-02]', 1);
+SELECT eDwithin(tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02, Point(5 5)@2000-01-03]', tgeompoint 'Interp=Step;[Point(10 10)@2000-01-01, Point(5 5)@2000-01-03]', 1);
+SELECT eDwithin(tgeompoint 'Interp=Step;{[Point(0 0)@2000-01-01, Point(5 5)@2000-01-02],[Point(0 0)@2000-01-03, Point(0 0)@2000-01-04]}', tgeompoint 'Interp=Step;[Point(10 10)@2000-01-01, Point(5 5)@2000-01-02]', 1);
+SELECT eDwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02]', tgeompoint 'Interp=Step;[Point(10 10)@2000-01-01, Point(0 0)@2000-01-02]', 1);
+SELECT aDwithin(tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(10 10)@2000-01-02]', tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02]', 1);
+SELECT aDwithin(tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(10 10)@2000-01-02, Point(10 10)@2000-01-03)', tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(10 10)@2000-01-02, Point(10 10)@2000-01-03)', 1);
+SELECT aDwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(0 0)@2000-01-02]', tgeompoint 'Interp=Step;[Point(0 0)@2000-01-01, Point(10 10)@2000-01-02]', 1);
 
 SELECT eDwithin(tgeompoint 'Point(1 1 1)@2000-01-01', tgeompoint 'Point(1 1 1)@2000-01-01', 2);
 SELECT eDwithin(tgeompoint '{Point(1 1 1)@2000-01-01, Point(2 2 2)@2000-01-02, Point(1 1 1)@2000-01-03}', tgeompoint 'Point(1 1 1)@2000-01-01', 2);
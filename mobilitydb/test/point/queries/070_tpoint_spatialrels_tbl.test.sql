@@ -315,6 +315,12 @@ SELECT COUNT(*) FROM tbl_tgeogpoint WHERE aDwithin(temp, tgeogpoint '[Point(0 0)
 DROP INDEX tbl_tgeompoint_quadtree_idx;
 DROP INDEX tbl_tgeogpoint_quadtree_idx;
 
+-- Partition-based spatiotemporal join
+SET mobilitydb.enable_spacetime_join = on;
+SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE eIntersects(t1.temp, t2.temp);
+SELECT COUNT(*) FROM tbl_tgeompoint t1, tbl_tgeompoint t2 WHERE eDwithin(t1.temp, t2.temp, 10);
+RESET mobilitydb.enable_spacetime_join;
+
 -------------------------------------------------------------------------------
 
 -- END;
@@ -176,6 +176,9 @@ SELECT tIntersects(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, P
 SELECT tIntersects(tgeompoint '[Point(1 1)@2000-01-01, Point(1 1)@2000-01-02]', geometry 'Linestring(1 1,2 2)');
 SELECT tIntersects(tgeompoint '[Point(1 1)@2000-01-01, Point(4 1)@2000-01-02]', geometry 'Linestring(1 2,1 0,2 0,2 2)');
 
+SELECT * FROM whenIntersects(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', ARRAY[geometry 'Polygon((1 -1,1 1,2 1,2 -1,1 -1))', geometry 'Point(5 5)', geometry 'Point(3 0)']);
+SELECT * FROM whenIntersects(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02}', ARRAY[geometry 'Point(3 3)', geometry 'Point(1 1)']);
+
 -- Additional parameter
 SELECT tIntersects(geometry 'Point(1 1)', tgeompoint 'Point(1 1)@2000-01-01', true);
 SELECT tIntersects(geometry 'Point(1 1)', tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', true);
@@ -342,6 +345,10 @@ SELECT tDwithin(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'Point(1 1)@2000-
 SELECT tDwithin(tgeompoint '(Point(1 1)@2000-01-01, Point(2 2)@2000-01-02]', geometry 'Point(0 1)', 1);
 SELECT tDwithin(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02)', geometry 'Point(2 3)', 1);
 SELECT tDwithin(tgeompoint 'Interp=Step;[Point(1 1)@2000-01-01, Point(1 1)@2000-01-02)', geometry 'Point(2 3)', 1);
+SELECT tDwithin(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(1 1,2 2)', 2);
+SELECT tDwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', geometry 'Linestring(1 1,3 1)', 1);
+SELECT tDwithin(tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]', geometry 'Polygon((1 -1,3 -1,3 1,1 1,1 -1))', 0);
+SELECT tDwithin(tgeompoint '{[Point(2 0)@2000-01-01, Point(2 0)@2000-01-02], [Point(5 0)@2000-01-03, Point(9 0)@2000-01-07]}', geometry 'Polygon((1 -1,3 -1,3 1,1 1,1 -1))', 2);
 
 SELECT tDwithin(tgeompoint 'Point(1 1)@2000-01-01', tgeompoint 'Point(1 1)@2000-01-01', 2);
 SELECT tDwithin(tgeompoint '{Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(1 1)@2000-01-03}', tgeompoint 'Point(1 1)@2000-01-01', 2);
@@ -438,9 +445,19 @@ SELECT tDwithin(tgeompoint '{[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Poin
 SELECT tDwithin(geometry 'SRID=5676;Point(1 1)', tgeompoint 'Point(1 1)@2000-01-01', 2);
 SELECT tDwithin(tgeompoint 'Point(1 1)@2000-01-01', geometry 'SRID=5676;Point(1 1)', 2);
 SELECT tDwithin(tgeompoint 'SRID=5676;Point(1 1)@2000-01-01', tgeompoint 'Point(1 1)@2000-01-01', 2);
-SELECT tDwithin(geometry 'Linestring(1 1,2 2)', tgeompoint 'Point(1 1)@2000-01-01', 2);
-SELECT tDwithin(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Linestring(1 1,2 2)', 2);
+SELECT tDwithin(geometry 'Linestring(1 1 1,2 2 2)', tgeompoint 'Point(1 1 1)@2000-01-01', 2);
+SELECT tDwithin(tgeompoint 'Point(1 1 1)@2000-01-01', geometry 'Linestring(1 1 1,2 2 2)', 2);
 SELECT tDwithin(tgeompoint 'Point(1 1)@2000-01-01', geometry 'Point(0 0)', -1);
 SELECT tDwithin(tgeompoint 'Point(1 1 1)@2000-01-01', geometry 'Point(0 0 0)', -1);
 
 -------------------------------------------------------------------------------
+-- dwithinPairs
+-------------------------------------------------------------------------------
+
+SELECT * FROM dwithinPairs(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(10 0)@2000-01-11]', tgeompoint '[Point(0 1)@2000-01-01, Point(10 1)@2000-01-11]', tgeompoint '[Point(0 5)@2000-01-01, Point(10 5)@2000-01-11]'], 2);
+SELECT * FROM dwithinPairs(ARRAY[tgeompoint '[Point(0 0)@2000-01-01, Point(4 0)@2000-01-05]'], ARRAY[tgeompoint 'Point(5 5)@2000-01-01', tgeompoint '[Point(4 2)@2000-01-01, Point(0 2)@2000-01-05]'], 2.5);
+
+/* Errors */
+SELECT * FROM dwithinPairs(ARRAY[tgeompoint 'Point(1 1)@2000-01-01'], -1);
+
+-------------------------------------------------------------------------------
@@ -111,6 +111,10 @@ SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp #&> tgeogpoint '[Point(1 1
 SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]' <<# temp;
 SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]' &<# temp;
 
+-- Index inspection
+SELECT MIN(depth) = 0 AND SUM(tuples) > 0 AND MAX(avgFill) <= 1 FROM mobilitydb_gist_stats('tbl_tgeompoint3D_big_rtree_idx');
+SELECT candidates = (SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && tstzspan '[2001-01-01, 2001-02-01]') FROM mobilitydb_gist_probe('tbl_tgeompoint3D_big_rtree_idx', tstzspan '[2001-01-01, 2001-02-01]');
+
 -------------------------------------------------------------------------------
 
 DROP INDEX IF EXISTS tbl_tgeompoint3D_big_rtree_idx;
@@ -118,6 +122,107 @@ DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_rtree_idx;
 
 -------------------------------------------------------------------------------
 
+CREATE INDEX tbl_tgeompoint3D_big_mrtree_idx ON tbl_tgeompoint3D_big USING GIST(temp tgeompoint_mrtree_ops);
+CREATE INDEX tbl_tgeogpoint3D_big_mrtree_idx ON tbl_tgeogpoint3D_big USING GIST(temp tgeogpoint_mrtree_ops);
+
+-------------------------------------------------------------------------------
+
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <<# tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &<# tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #>> tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #&> tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp @> tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <@ tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp ~= tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp -|- tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp && tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp @> tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp <@ tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp ~= tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp -|- tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+-------------------------------------------------------------------------------
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_mrtree_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_mrtree_idx;
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tgeompoint3D_big_rtree4_idx ON tbl_tgeompoint3D_big USING GIST(temp tgeompoint_rtree_float4_ops);
+CREATE INDEX tbl_tgeogpoint3D_big_rtree4_idx ON tbl_tgeogpoint3D_big USING GIST(temp tgeogpoint_rtree_float4_ops);
+
+-------------------------------------------------------------------------------
+
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <<# tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &<# tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #>> tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #&> tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp @> tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <@ tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp ~= tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp -|- tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp && tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp @> tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp <@ tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp ~= tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp -|- tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+-------------------------------------------------------------------------------
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_rtree4_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_rtree4_idx;
+
+-------------------------------------------------------------------------------
+
+CREATE INDEX tbl_tgeompoint3D_big_brin_idx ON tbl_tgeompoint3D_big USING BRIN(temp tgeompoint_brin_inclusion_ops);
+CREATE INDEX tbl_tgeogpoint3D_big_brin_idx ON tbl_tgeogpoint3D_big USING BRIN(temp tgeogpoint_brin_inclusion_ops);
+
+-------------------------------------------------------------------------------
+
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <<# tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp &<# tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #>> tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp #&> tstzspan '[2001-01-01, 2001-02-01]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp && tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp @> tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp <@ tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp ~= tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE temp -|- tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp && tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp @> tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp <@ tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp ~= tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp -|- tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
+
+-------------------------------------------------------------------------------
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_brin_idx;
+DROP INDEX IF EXISTS tbl_tgeogpoint3D_big_brin_idx;
+
+-------------------------------------------------------------------------------
+
+-- Expression index on the bounding box, which allows index-only scans
+CREATE INDEX tbl_tgeompoint3D_big_stbox_idx ON tbl_tgeompoint3D_big USING GIST(stbox(temp));
+
+-------------------------------------------------------------------------------
+
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE stbox(temp) <<# stbox(tstzspan '[2001-01-01, 2001-02-01]');
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE stbox(temp) &<# stbox(tstzspan '[2001-01-01, 2001-02-01]');
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE stbox(temp) #>> stbox(tstzspan '[2001-01-01, 2001-02-01]');
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE stbox(temp) #&> stbox(tstzspan '[2001-01-01, 2001-02-01]');
+SELECT COUNT(*) FROM tbl_tgeompoint3D_big WHERE stbox(temp) && stbox(tgeompoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]');
+
+-------------------------------------------------------------------------------
+
+DROP INDEX IF EXISTS tbl_tgeompoint3D_big_stbox_idx;
+
+-------------------------------------------------------------------------------
+
 CREATE INDEX tbl_tgeompoint3D_big_quadtree_idx ON tbl_tgeompoint3D_big USING SPGIST(temp);
 CREATE INDEX tbl_tgeogpoint3D_big_quadtree_idx ON tbl_tgeogpoint3D_big USING SPGIST(temp);
 
@@ -167,6 +272,9 @@ SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp &<# tgeogpoint '[Point(1 1
 SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp #>> tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
 SELECT COUNT(*) FROM tbl_tgeogpoint3D_big WHERE temp #&> tgeogpoint '[Point(1 1 1)@2000-01-01, Point(10 10 10)@2000-01-02]';
 
+-- Index inspection
+SELECT leafTuples > 0 AND avgNodes > 0 FROM mobilitydb_spgist_stats('tbl_tgeompoint3D_big_quadtree_idx');
+
 -------------------------------------------------------------------------------
 
 DROP INDEX IF EXISTS tbl_tgeompoint3D_big_quadtree_idx;
@@ -282,3 +390,54 @@ DROP TABLE tbl_tgeompoint3D_big_allthesame;
 
 -------------------------------------------------------------------------------
 
+
+-------------------------------------------------------------------------------
+-- Indexes on spatial sets
+
+CREATE TABLE tbl_geomset_idx AS
+SELECT k, set(ARRAY[ST_Point(k, k), ST_Point(k + 1, k + 1)]) AS g
+FROM generate_series(1, 1000) AS k;
+
+CREATE INDEX tbl_geomset_idx_rtree_idx ON tbl_geomset_idx USING GIST(g);
+
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g && geomset '{"Point(10 10)", "Point(50 50)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g @> geometry 'Point(10 10)';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g @> geomset '{"Point(20 20)", "Point(21 21)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g <@ geomset '{"Point(1 1)", "Point(2 2)", "Point(3 3)", "Point(4 4)", "Point(5 5)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g = geomset '{"Point(30 30)", "Point(31 31)"}';
+
+DROP INDEX tbl_geomset_idx_rtree_idx;
+
+CREATE INDEX tbl_geomset_idx_mrtree_idx ON tbl_geomset_idx USING GIST(g geomset_mrtree_ops(max_count = 1));
+
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g && geomset '{"Point(10 10)", "Point(50 50)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g @> geometry 'Point(10 10)';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g @> geomset '{"Point(20 20)", "Point(21 21)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g <@ geomset '{"Point(1 1)", "Point(2 2)", "Point(3 3)", "Point(4 4)", "Point(5 5)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g = geomset '{"Point(30 30)", "Point(31 31)"}';
+
+DROP INDEX tbl_geomset_idx_mrtree_idx;
+
+CREATE INDEX tbl_geomset_idx_quadtree_idx ON tbl_geomset_idx USING SPGIST(g);
+
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g && geomset '{"Point(10 10)", "Point(50 50)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g @> geometry 'Point(10 10)';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g @> geomset '{"Point(20 20)", "Point(21 21)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g <@ geomset '{"Point(1 1)", "Point(2 2)", "Point(3 3)", "Point(4 4)", "Point(5 5)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g = geomset '{"Point(30 30)", "Point(31 31)"}';
+
+DROP INDEX tbl_geomset_idx_quadtree_idx;
+
+CREATE INDEX tbl_geomset_idx_kdtree_idx ON tbl_geomset_idx USING SPGIST(g geomset_kdtree_ops);
+
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g && geomset '{"Point(10 10)", "Point(50 50)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g @> geometry 'Point(10 10)';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g @> geomset '{"Point(20 20)", "Point(21 21)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g <@ geomset '{"Point(1 1)", "Point(2 2)", "Point(3 3)", "Point(4 4)", "Point(5 5)"}';
+SELECT COUNT(*) FROM tbl_geomset_idx WHERE g = geomset '{"Point(30 30)", "Point(31 31)"}';
+
+DROP INDEX tbl_geomset_idx_kdtree_idx;
+
+DROP TABLE tbl_geomset_idx;
+
+-------------------------------------------------------------------------------
@@ -217,6 +217,20 @@ SELECT asText(DouglasPeuckerSimplify(tgeompoint '[POINT(77 69)@2000-01-02, POINT
 SELECT asText(DouglasPeuckerSimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1));
 SELECT asText(DouglasPeuckerSimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 1, false));
 
+SELECT numInstants(numPointsSimplify(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]', 3));
+SELECT numPointsSimplify(tfloat '[4@2000-01-01, 1@2000-01-02]', 5);
+SELECT asText(numPointsSimplify(tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04]', 2));
+SELECT douglasPeuckerWeights(tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]');
+SELECT array_agg(douglasPeuckerSimplify(t, douglasPeuckerWeights(t), d) = douglasPeuckerSimplify(t, d) ORDER BY d) FROM (SELECT tfloat '[4@2000-01-01, 1@2000-01-02, 3@2000-01-03, 1@2000-01-04, 3@2000-01-05, 0@2000-01-06, 4@2000-01-07]' AS t) t, unnest(ARRAY[0.5, 1.5, 2.5, 5]) d;
+SELECT array_agg(douglasPeuckerSimplify(t, douglasPeuckerWeights(t, false), d) = douglasPeuckerSimplify(t, d, false) ORDER BY d) FROM (SELECT tgeompoint '[Point(1 1)@2000-01-01, Point(2 2)@2000-01-02, Point(3 1)@2000-01-04, Point(5 3)@2000-01-05]' AS t) t, unnest(ARRAY[0.1, 0.5, 1, 2]) d;
+SELECT douglasPeuckerWeights(tgeompoint 'Point(1 1)@2000-01-01');
+
+-------------------------------------------------------------------------------
+
+SELECT array_agg(c ORDER BY id) FROM (SELECT id, stdbscan(temp, 1.5, interval '1 day', 2) OVER () AS c FROM (VALUES (1, tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'), (2, tgeompoint '[Point(0 1)@2000-01-01, Point(1 2)@2000-01-02]'), (3, tgeompoint '[Point(10 10)@2000-01-01, Point(11 11)@2000-01-02]'), (4, tgeompoint '[Point(0 0)@2000-03-01, Point(1 1)@2000-03-02]'), (5, NULL)) t(id, temp)) t;
+SELECT array_agg(c ORDER BY id) FROM (SELECT id, stdbscan(temp, 1.5, interval '60 days', 2) OVER () AS c FROM (VALUES (1, tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'), (2, tgeompoint '[Point(0 1)@2000-01-01, Point(1 2)@2000-01-02]'), (3, tgeompoint '[Point(10 10)@2000-01-01, Point(11 11)@2000-01-02]'), (4, tgeompoint '[Point(0 0)@2000-03-01, Point(1 1)@2000-03-02]'), (5, NULL)) t(id, temp)) t;
+SELECT array_agg(c ORDER BY id) FROM (SELECT id, stdbscan(temp, 1.5, interval '1 day', 3) OVER () AS c FROM (VALUES (1, tgeompoint '[Point(0 0)@2000-01-01, Point(1 1)@2000-01-02]'), (2, tgeompoint '[Point(0 1)@2000-01-01, Point(1 2)@2000-01-02]'), (3, tgeompoint '[Point(10 10)@2000-01-01, Point(11 11)@2000-01-02]'), (4, tgeompoint '[Point(0 0)@2000-03-01, Point(1 1)@2000-03-02]'), (5, NULL)) t(id, temp)) t;
+
 -------------------------------------------------------------------------------
 
 -- PostGIS 3.3 changed the output of MULTIPOINT
@@ -259,6 +259,239 @@ elseif(TEST_OPER MATCHES "run_passfail")
     message(FATAL_ERROR "Test ${TEST_NAME} failed:\n${TEST_RESULT}\n${TEST_ERROR}")
   endif()
 
+#-------------------------------------------------------------------------------
+# Set up the BerlinMOD benchmark
+#-------------------------------------------------------------------------------
+
+elseif(TEST_OPER MATCHES "run_bench_setup")
+
+  # Ensure the test name and the test file are given
+  if(NOT TEST_NAME)
+    message(FATAL_ERROR "Argument TEST_NAME must be provided")
+  endif(NOT TEST_NAME)
+  if(NOT TEST_FILE)
+    message(FATAL_ERROR "Argument TEST_FILE must be provided")
+  endif(NOT TEST_FILE)
+
+  # Explanation of the parameters for psql (see above)
+  # -q Do not show the commands and their results
+  # --set ON_ERROR_STOP=1 Stop the script on the first SQL error so that the
+  #   failure is reported by the exit code of psql
+  # -v <name>=<value> Variables used by the script
+  execute_process(
+    COMMAND ${POSTGRESQL_BIN_DIR}/psql -X -h ${TEST_DIR_LOCK} -q --set ON_ERROR_STOP=1 -d postgres
+      -v SCALEFACTOR=${BENCH_SCALEFACTOR} -v INDEX=${BENCH_INDEX}
+      -v DATAGEN_DIR=${SOURCE_DIR}/datagen
+    INPUT_FILE ${TEST_FILE}
+    OUTPUT_FILE ${TEST_DIR_OUT}/${TEST_NAME}.out
+    ERROR_FILE ${TEST_DIR_OUT}/${TEST_NAME}.out
+    RESULT_VARIABLE TEST_RESULT
+  )
+  if(TEST_RESULT)
+    file(READ ${TEST_DIR_OUT}/${TEST_NAME}.out TEST_ERROR)
+    message(FATAL_ERROR "Test ${TEST_NAME} failed:\n${TEST_RESULT}\n${TEST_ERROR}")
+  endif()
+
+#-------------------------------------------------------------------------------
+# Run a BerlinMOD benchmark query and compare it against its baseline
+#-------------------------------------------------------------------------------
+
+elseif(TEST_OPER MATCHES "run_bench")
+
+  # Ensure the test name and the test file are given
+  if(NOT TEST_NAME)
+    message(FATAL_ERROR "Argument TEST_NAME must be provided")
+  endif(NOT TEST_NAME)
+  if(NOT TEST_FILE)
+    message(FATAL_ERROR "Argument TEST_FILE must be provided")
+  endif(NOT TEST_FILE)
+
+  # The test file contains a single query without the final semicolon
+  file(READ ${TEST_FILE} BENCH_QUERY)
+  string(STRIP "${BENCH_QUERY}" BENCH_QUERY)
+  string(REGEX REPLACE ";$" "" BENCH_QUERY "${BENCH_QUERY}")
+
+  # Explanation of the parameters for psql (see above)
+  # -A -t Unaligned output without header and footer
+  execute_process(
+    COMMAND ${POSTGRESQL_BIN_DIR}/psql -X -h ${TEST_DIR_LOCK} -q -A -t --set ON_ERROR_STOP=1 -d postgres
+      -c "SELECT berlinmod_explain('${TEST_NAME}', $bench$${BENCH_QUERY}$bench$, ${BENCH_REPEAT})"
+    OUTPUT_VARIABLE BENCH_OUTPUT
+    ERROR_VARIABLE TEST_ERROR
+    RESULT_VARIABLE TEST_RESULT
+  )
+  if(TEST_RESULT)
+    message(FATAL_ERROR "Test ${TEST_NAME} failed:\n${TEST_RESULT}\n${TEST_ERROR}")
+  endif()
+  string(STRIP "${BENCH_OUTPUT}" BENCH_OUTPUT)
+  file(WRITE ${TEST_DIR_OUT}/${TEST_NAME}.out "${BENCH_OUTPUT}\n")
+
+  # Keep the full EXPLAIN ANALYZE output for inspection
+  execute_process(
+    COMMAND ${POSTGRESQL_BIN_DIR}/psql -X -h ${TEST_DIR_LOCK} -q -A -t -d postgres
+      -c "SELECT plan FROM berlinmod_results WHERE query = '${TEST_NAME}'"
+    OUTPUT_FILE ${TEST_DIR_OUT}/${TEST_NAME}.plan.json
+  )
+
+  # The output has the form <plan signature>|<execution time in microseconds>
+  if(NOT BENCH_OUTPUT MATCHES "^(.*)\\|([0-9]+)$")
+    message(FATAL_ERROR "Test ${TEST_NAME} returned an invalid result:\n${BENCH_OUTPUT}")
+  endif()
+  set(BENCH_PLAN "${CMAKE_MATCH_1}")
+  set(BENCH_USECS "${CMAKE_MATCH_2}")
+  message(STATUS "Plan: ${BENCH_PLAN}")
+  message(STATUS "Execution time: ${BENCH_USECS} us")
+
+  set(BENCH_BASELINE_FILE "${BENCH_BASELINE}/${TEST_NAME}.out")
+  if(BENCH_UPDATE)
+    file(WRITE ${BENCH_BASELINE_FILE} "${BENCH_OUTPUT}\n")
+    message(STATUS "Baseline updated: ${BENCH_BASELINE_FILE}")
+  elseif(NOT EXISTS ${BENCH_BASELINE_FILE})
+    message(STATUS "No baseline for ${TEST_NAME}, set BENCHMARK_UPDATE_BASELINE to create it")
+  else()
+    file(READ ${BENCH_BASELINE_FILE} BENCH_EXPECTED)
+    string(STRIP "${BENCH_EXPECTED}" BENCH_EXPECTED)
+    if(NOT BENCH_EXPECTED MATCHES "^(.*)\\|([0-9]+)$")
+      message(FATAL_ERROR "Invalid baseline ${BENCH_BASELINE_FILE}:\n${BENCH_EXPECTED}")
+    endif()
+    set(BENCH_EXPECTED_PLAN "${CMAKE_MATCH_1}")
+    set(BENCH_EXPECTED_USECS "${CMAKE_MATCH_2}")
+    if(NOT BENCH_PLAN STREQUAL BENCH_EXPECTED_PLAN)
+      message(FATAL_ERROR "Test ${TEST_NAME} changed its plan\n"
+        "Expected: ${BENCH_EXPECTED_PLAN}\nActual:   ${BENCH_PLAN}")
+    endif()
+    # Times below one millisecond above the baseline are considered as noise
+    math(EXPR BENCH_LIMIT
+      "${BENCH_EXPECTED_USECS} * (100 + ${BENCH_THRESHOLD}) / 100")
+    math(EXPR BENCH_NOISE "${BENCH_EXPECTED_USECS} + 1000")
+    if(BENCH_LIMIT LESS BENCH_NOISE)
+      set(BENCH_LIMIT ${BENCH_NOISE})
+    endif()
+    if(BENCH_USECS GREATER BENCH_LIMIT)
+      message(FATAL_ERROR "Test ${TEST_NAME} is slower than its baseline\n"
+        "Expected: ${BENCH_EXPECTED_USECS} us (limit ${BENCH_LIMIT} us)\n"
+        "Actual:   ${BENCH_USECS} us")
+    endif()
+  endif()
+
+#-------------------------------------------------------------------------------
+# Set up the timing tests
+#-------------------------------------------------------------------------------
+
+elseif(TEST_OPER MATCHES "run_timing_setup")
+
+  # Ensure the test name and the test file are given
+  if(NOT TEST_NAME)
+    message(FATAL_ERROR "Argument TEST_NAME must be provided")
+  endif(NOT TEST_NAME)
+  if(NOT TEST_FILE)
+    message(FATAL_ERROR "Argument TEST_FILE must be provided")
+  endif(NOT TEST_FILE)
+
+  # Explanation of the parameters for psql (see above)
+  execute_process(
+    COMMAND ${POSTGRESQL_BIN_DIR}/psql -X -h ${TEST_DIR_LOCK} -q --set ON_ERROR_STOP=1 -d postgres
+      -v SIZE=${TIMING_SIZE} -v DATAGEN_DIR=${SOURCE_DIR}/datagen
+    INPUT_FILE ${TEST_FILE}
+    OUTPUT_FILE ${TEST_DIR_OUT}/${TEST_NAME}.out
+    ERROR_FILE ${TEST_DIR_OUT}/${TEST_NAME}.out
+    RESULT_VARIABLE TEST_RESULT
+  )
+  if(TEST_RESULT)
+    file(READ ${TEST_DIR_OUT}/${TEST_NAME}.out TEST_ERROR)
+    message(FATAL_ERROR "Test ${TEST_NAME} failed:\n${TEST_RESULT}\n${TEST_ERROR}")
+  endif()
+
+#-------------------------------------------------------------------------------
+# Run a timing query and compare it against its baseline
+#-------------------------------------------------------------------------------
+
+elseif(TEST_OPER MATCHES "run_timing")
+
+  # Ensure the test name and the test file are given
+  if(NOT TEST_NAME)
+    message(FATAL_ERROR "Argument TEST_NAME must be provided")
+  endif(NOT TEST_NAME)
+  if(NOT TEST_FILE)
+    message(FATAL_ERROR "Argument TEST_FILE must be provided")
+  endif(NOT TEST_FILE)
+
+  # The test file contains a single query without the final semicolon
+  file(READ ${TEST_FILE} TIMING_QUERY)
+  string(STRIP "${TIMING_QUERY}" TIMING_QUERY)
+  string(REGEX REPLACE ";$" "" TIMING_QUERY "${TIMING_QUERY}")
+
+  # Explanation of the parameters for psql (see above)
+  # The tables of the timing tests are in the schema timing
+  execute_process(
+    COMMAND ${POSTGRESQL_BIN_DIR}/psql -X -h ${TEST_DIR_LOCK} -q -A -t --set ON_ERROR_STOP=1 -d postgres
+      -c "SET search_path TO timing, public; SELECT timing_explain('${TEST_NAME}', $timing$${TIMING_QUERY}$timing$, ${TIMING_REPEAT})"
+    OUTPUT_VARIABLE TIMING_OUTPUT
+    ERROR_VARIABLE TEST_ERROR
+    RESULT_VARIABLE TEST_RESULT
+  )
+  if(TEST_RESULT)
+    message(FATAL_ERROR "Test ${TEST_NAME} failed:\n${TEST_RESULT}\n${TEST_ERROR}")
+  endif()
+  string(STRIP "${TIMING_OUTPUT}" TIMING_OUTPUT)
+  file(WRITE ${TEST_DIR_OUT}/${TEST_NAME}.out "${TIMING_OUTPUT}\n")
+
+  # Keep the full EXPLAIN ANALYZE output for inspection
+  execute_process(
+    COMMAND ${POSTGRESQL_BIN_DIR}/psql -X -h ${TEST_DIR_LOCK} -q -A -t -d postgres
+      -c "SELECT plan FROM timing.timing_results WHERE query = '${TEST_NAME}'"
+    OUTPUT_FILE ${TEST_DIR_OUT}/${TEST_NAME}.plan.json
+  )
+
+  # The output has the form <execution time in microseconds>|<shared blocks>
+  if(NOT TIMING_OUTPUT MATCHES "^([0-9]+)\\|([0-9]+)$")
+    message(FATAL_ERROR "Test ${TEST_NAME} returned an invalid result:\n${TIMING_OUTPUT}")
+  endif()
+  set(TIMING_USECS "${CMAKE_MATCH_1}")
+  set(TIMING_BLOCKS "${CMAKE_MATCH_2}")
+  message(STATUS "Execution time: ${TIMING_USECS} us")
+  message(STATUS "Shared blocks: ${TIMING_BLOCKS}")
+
+  set(TIMING_BASELINE_FILE "${TIMING_BASELINE}/${TEST_NAME}.out")
+  if(TIMING_UPDATE)
+    file(WRITE ${TIMING_BASELINE_FILE} "${TIMING_OUTPUT}\n")
+    message(STATUS "Baseline updated: ${TIMING_BASELINE_FILE}")
+  elseif(NOT EXISTS ${TIMING_BASELINE_FILE})
+    message(STATUS "No baseline for ${TEST_NAME}, set TIMING_UPDATE_BASELINE to create it")
+  else()
+    file(READ ${TIMING_BASELINE_FILE} TIMING_EXPECTED)
+    string(STRIP "${TIMING_EXPECTED}" TIMING_EXPECTED)
+    if(NOT TIMING_EXPECTED MATCHES "^([0-9]+)\\|([0-9]+)$")
+      message(FATAL_ERROR "Invalid baseline ${TIMING_BASELINE_FILE}:\n${TIMING_EXPECTED}")
+    endif()
+    set(TIMING_EXPECTED_USECS "${CMAKE_MATCH_1}")
+    set(TIMING_EXPECTED_BLOCKS "${CMAKE_MATCH_2}")
+    # Times below one millisecond and buffer usage below ten blocks above the
+    # baseline are considered as noise
+    math(EXPR TIMING_LIMIT
+      "${TIMING_EXPECTED_USECS} * (100 + ${TIMING_THRESHOLD}) / 100")
+    math(EXPR TIMING_NOISE "${TIMING_EXPECTED_USECS} + 1000")
+    if(TIMING_LIMIT LESS TIMING_NOISE)
+      set(TIMING_LIMIT ${TIMING_NOISE})
+    endif()
+    math(EXPR TIMING_BLOCKS_LIMIT
+      "${TIMING_EXPECTED_BLOCKS} * (100 + ${TIMING_THRESHOLD}) / 100")
+    math(EXPR TIMING_BLOCKS_NOISE "${TIMING_EXPECTED_BLOCKS} + 10")
+    if(TIMING_BLOCKS_LIMIT LESS TIMING_BLOCKS_NOISE)
+      set(TIMING_BLOCKS_LIMIT ${TIMING_BLOCKS_NOISE})
+    endif()
+    if(TIMING_USECS GREATER TIMING_LIMIT)
+      message(FATAL_ERROR "Test ${TEST_NAME} is slower than its baseline\n"
+        "Expected: ${TIMING_EXPECTED_USECS} us (limit ${TIMING_LIMIT} us)\n"
+        "Actual:   ${TIMING_USECS} us")
+    endif()
+    if(TIMING_BLOCKS GREATER TIMING_BLOCKS_LIMIT)
+      message(FATAL_ERROR "Test ${TEST_NAME} uses more buffers than its baseline\n"
+        "Expected: ${TIMING_EXPECTED_BLOCKS} blocks (limit ${TIMING_BLOCKS_LIMIT} blocks)\n"
+        "Actual:   ${TIMING_BLOCKS} blocks")
+    endif()
+  endif()
+
 #-------------------------------------------------------------------------------
 # Stop the server
 #-------------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+/*****************************************************************************
+ *
+ * This MobilityDB code is provided under The PostgreSQL License.
+ * Copyright (c) 2016-2024, Université libre de Bruxelles and MobilityDB
+ * contributors
+ *
+ * MobilityDB includes portions of PostGIS version 3 source code released
+ * under the GNU General Public License (GPLv2 or later).
+ * Copyright (c) 2001-2024, PostGIS contributors
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation for any purpose, without fee, and without a written
+ * agreement is hereby granted, provided that the above copyright notice and
+ * this paragraph and the following two paragraphs appear in all copies.
+ *
+ * IN NO EVENT SHALL UNIVERSITE LIBRE DE BRUXELLES BE LIABLE TO ANY PARTY FOR
+ * DIRECT, INDIRECT, SPECIAL, INCIDENTAL, OR CONSEQUENTIAL DAMAGES, INCLUDING
+ * LOST PROFITS, ARISING OUT OF THE USE OF THIS SOFTWARE AND ITS DOCUMENTATION,
+ * EVEN IF UNIVERSITE LIBRE DE BRUXELLES HAS BEEN ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ * UNIVERSITE LIBRE DE BRUXELLES SPECIFICALLY DISCLAIMS ANY WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY
+ * AND FITNESS FOR A PARTICULAR PURPOSE. THE SOFTWARE PROVIDED HEREUNDER IS ON
+ * AN "AS IS" BASIS, AND UNIVERSITE LIBRE DE BRUXELLES HAS NO OBLIGATIONS TO
+ * PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+ *
+ *****************************************************************************/
+
+/*
+ * timing_generate.sql
+ * Generation of the data set for the timing tests.
+ *
+ * The script is run by psql with the variables SIZE, the number of rows of
+ * the test tables, and DATAGEN_DIR, the directory of the random generators.
+ * The tables are those of the datagen function create_test_tables_tpoint,
+ * but they are created in the schema timing so that they do not replace the
+ * tables loaded for the regression tests. The random generator
+ * is seeded so that the data set, and thus the buffer usage of the queries,
+ * is the same in every run.
+ */
+
+DROP SCHEMA IF EXISTS timing CASCADE;
+CREATE SCHEMA timing;
+SET search_path TO timing, public;
+
+\i :DATAGEN_DIR/general/random_geo.sql
+\i :DATAGEN_DIR/general/random_temporal.sql
+\i :DATAGEN_DIR/point/random_tpoint.sql
+\i :DATAGEN_DIR/point/create_test_tables_tpoint.sql
+
+-------------------------------------------------------------------------------
+-- Capture of the EXPLAIN ANALYZE output
+-------------------------------------------------------------------------------
+
+CREATE TABLE timing_results(query text PRIMARY KEY, usecs bigint,
+  blocks bigint, plan json);
+
+/**
+ * @brief Run a query with EXPLAIN (ANALYZE, BUFFERS) and record its
+ * execution time and its buffer usage
+ * @param[in] name Name of the query
+ * @param[in] query Text of the query
+ * @param[in] repeat Number of executions, the minimum execution time is kept
+ * @return Execution time in microseconds and number of shared blocks hit or
+ * read separated by '|'
+ * @note The buffer usage is the one of the last execution, in which the
+ * data of the query is in the shared buffers
+ */
+CREATE FUNCTION timing_explain(name text, query text, repeat int)
+  RETURNS text AS $$
+DECLARE
+  plan json;
+  exectime float;
+  mintime float;
+  blocks bigint;
+BEGIN
+  FOR i IN 1..greatest(repeat, 1)
+  LOOP
+    EXECUTE 'EXPLAIN (ANALYZE, BUFFERS, FORMAT JSON) ' || query INTO plan;
+    exectime = (plan->0->>'Execution Time')::float;
+    IF mintime IS NULL OR exectime < mintime THEN
+      mintime = exectime;
+    END IF;
+  END LOOP;
+  blocks = (plan->0->'Plan'->>'Shared Hit Blocks')::bigint +
+    (plan->0->'Plan'->>'Shared Read Blocks')::bigint;
+  INSERT INTO timing_results
+  VALUES (name, round(mintime * 1000)::bigint, blocks, plan)
+  ON CONFLICT (query) DO UPDATE
+  SET usecs = EXCLUDED.usecs, blocks = EXCLUDED.blocks, plan = EXCLUDED.plan;
+  RETURN round(mintime * 1000)::bigint || '|' || blocks;
+END;
+$$ LANGUAGE PLPGSQL STRICT;
+
+-------------------------------------------------------------------------------
+-- Data generation
+-------------------------------------------------------------------------------
+
+SELECT setseed(0.5);
+SELECT create_test_tables_tpoint(:SIZE);
+
+CREATE INDEX tbl_tgeompoint_temp_idx ON tbl_tgeompoint USING gist(temp);
+VACUUM ANALYZE tbl_tgeompoint, tbl_geom_point, tbl_geom_polygon;
+
+-------------------------------------------------------------------------------